@@ -5,8 +5,9 @@
 #ifndef CPUPROFILE_H
 #define CPUPROFILE_H
 
+#include "stat_reader.h"
+
 #include <QObject>
-#include <QMap>
 
 class CpuProfile : public QObject
 {
@@ -30,10 +31,18 @@ public:
     /*!
      * 获取当前CPU状态
      */
-    QMap<QString, int> cpuStat();
+    const common::parser::CpuStatFields &cpuStat() const;
+
+    /*!
+     * 由前后两次CPU状态计算占用率(%)
+     * \return 两次之间没有时间片或计数回退(如虚拟机恢复)时返回-1
+     */
+    static double calcCpuUsage(const common::parser::CpuStatFields &last, const common::parser::CpuStatFields &cur);
 
 private:
-    QMap<QString, int> mLastCpuStat;
+    common::parser::StatReader mReader;
+    // 各项数值是开机后各项工作的时间片总数
+    common::parser::CpuStatFields mLastCpuStat;
     double mCpuUsage;
 };
 
@@ -5,6 +5,8 @@
 #ifndef MEMORYPROFILE_H
 #define MEMORYPROFILE_H
 
+#include "meminfo_reader.h"
+
 #include <QObject>
 
 class MemoryProfile : public QObject
@@ -26,9 +28,15 @@ public:
      * 获取内存占用率
      */
     double getMemUsage();
+    /*!
+     * 获取上次读取的内存信息(kB)
+     */
+    const common::parser::MemInfoFields &memInfo() const { return mFields; }
 
 private:
     double mMemUsage;
+    common::parser::MemInfoReader mReader;
+    common::parser::MemInfoFields mFields;
 };
 
 #endif // MEMORYPROFILE_H
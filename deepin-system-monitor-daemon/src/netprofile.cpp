@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "netprofile.h"
+#include "ddlog.h"
+#include "proc_parser.h"
+
+#include <QDebug>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace DDLog;
+using namespace common::parser;
+
+#define PROC_NET_DEV_PATH "/proc/net/dev"
+
+NetProfile::NetProfile(QObject *parent)
+    : QObject(parent), mFd(-1), mRecvBytes(0), mSentBytes(0), mRecvBps(0), mSentBps(0)
+{
+    qCDebug(app) << "NetProfile constructor";
+}
+
+NetProfile::~NetProfile()
+{
+    if (mFd >= 0)
+        close(mFd);
+}
+
+bool NetProfile::updateSystemNetStat()
+{
+    // 文件只打开一次，之后从偏移0重新读取
+    if (mFd < 0) {
+        mFd = open(PROC_NET_DEV_PATH, O_RDONLY | O_CLOEXEC);
+        if (mFd < 0) {
+            qCWarning(app) << "Failed to open" << PROC_NET_DEV_PATH << strerror(errno);
+            return false;
+        }
+    }
+
+    size_t total = 0;
+    while (total < sizeof(mBuf)) {
+        ssize_t n = pread(mFd, mBuf + total, sizeof(mBuf) - total, off_t(total));
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            qCWarning(app) << "Failed to read" << PROC_NET_DEV_PATH << strerror(errno);
+            close(mFd);
+            mFd = -1;
+            return false;
+        }
+        if (n == 0)
+            break;
+        total += size_t(n);
+    }
+
+    quint64 recvBytes = 0;
+    quint64 sentBytes = 0;
+    if (!parse(mBuf, total, recvBytes, sentBytes))
+        return false;
+
+    // 首次采样只记录基准值；计数回绕(网卡移除)时速率记为0
+    if (mClock.isValid()) {
+        double secs = mClock.restart() / 1000.;
+        if (secs > 0) {
+            mRecvBps = recvBytes >= mRecvBytes ? (recvBytes - mRecvBytes) / secs : 0;
+            mSentBps = sentBytes >= mSentBytes ? (sentBytes - mSentBytes) / secs : 0;
+        }
+    } else {
+        mClock.start();
+    }
+    mRecvBytes = recvBytes;
+    mSentBytes = sentBytes;
+    return true;
+}
+
+bool NetProfile::parse(const char *buf, size_t len, quint64 &recvBytes, quint64 &sentBytes)
+{
+    // 样例数据：
+    // Inter-|   Receive                                                |  Transmit
+    //  face |bytes    packets errs drop fifo frame compressed multicast|bytes    packets ...
+    //     lo: 1234567    1234    0    0    0     0          0         0  1234567    1234 ...
+    Tokenizer tok(buf, len);
+    // 跳过两行表头
+    if (!tok.nextLine() || !tok.nextLine())
+        return false;
+
+    recvBytes = sentBytes = 0;
+    do {
+        tok.skipBlanks();
+        const char *line = tok.pos();
+        const char *lineEnd = static_cast<const char *>(memchr(line, '\n', size_t(tok.end() - line)));
+        if (!lineEnd)
+            lineEnd = tok.end();
+        const char *colon = static_cast<const char *>(memchr(line, ':', size_t(lineEnd - line)));
+        if (!colon || colon == line || keyEquals(line, size_t(colon - line), "lo", 2))
+            continue;
+
+        // 接收字节数为第1列，发送字节数为第9列
+        Tokenizer fields(colon + 1, size_t(lineEnd - colon - 1));
+        unsigned long long recv = 0;
+        unsigned long long sent = 0;
+        if (!fields.readU64(recv) || !fields.skipTokens(7) || !fields.readU64(sent))
+            continue;
+        recvBytes += recv;
+        sentBytes += sent;
+    } while (tok.nextLine());
+    return true;
+}
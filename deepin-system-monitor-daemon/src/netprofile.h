@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NETPROFILE_H
+#define NETPROFILE_H
+
+#include <QObject>
+#include <QElapsedTimer>
+
+class NetProfile : public QObject
+{
+    Q_OBJECT
+public:
+    explicit NetProfile(QObject *parent = nullptr);
+    ~NetProfile();
+
+public:
+    /*!
+     * 更新网络收发总量及速率，回环网卡不计入
+     */
+    bool updateSystemNetStat();
+    /*!
+     * 开机以来接收/发送字节数
+     */
+    quint64 recvBytes() const { return mRecvBytes; }
+    quint64 sentBytes() const { return mSentBytes; }
+    /*!
+     * 上次更新以来的接收/发送速率(字节/秒)
+     */
+    double recvBps() const { return mRecvBps; }
+    double sentBps() const { return mSentBps; }
+
+    /*!
+     * 解析/proc/net/dev内容
+     */
+    static bool parse(const char *buf, size_t len, quint64 &recvBytes, quint64 &sentBytes);
+
+private:
+    int mFd;
+    // 每块网卡一行约百余字节
+    char mBuf[16384];
+    quint64 mRecvBytes;
+    quint64 mSentBytes;
+    double mRecvBps;
+    double mSentBps;
+    QElapsedTimer mClock;
+};
+
+#endif // NETPROFILE_H
@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "pressureprofile.h"
+#include "ddlog.h"
+
+#include <QDebug>
+#include <QSocketNotifier>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace DDLog;
+
+// 2秒窗口内至少一个任务停顿超过300ms(15%)
+// 非特权进程的窗口必须是2秒的整数倍
+#define PressureTrigger "some 300000 2000000"
+
+static const char *const kPressurePath[PressureProfile::ResourceCount] = {
+    "/proc/pressure/cpu",
+    "/proc/pressure/memory",
+};
+
+PressureProfile::PressureProfile(QObject *parent)
+    : QObject(parent)
+{
+    qCDebug(app) << "PressureProfile constructor";
+    for (int i = 0; i < ResourceCount; ++i) {
+        mFd[i] = -1;
+        mNotifier[i] = nullptr;
+    }
+}
+
+PressureProfile::~PressureProfile()
+{
+    for (int i = 0; i < ResourceCount; ++i)
+        unwatch(Resource(i));
+}
+
+bool PressureProfile::watch(Resource res)
+{
+    if (isWatching(res))
+        return true;
+
+    int fd = open(kPressurePath[res], O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        qCWarning(app) << "Failed to open" << kPressurePath[res] << strerror(errno);
+        return false;
+    }
+    // 触发器随fd存在，关闭fd即注销
+    if (write(fd, PressureTrigger, strlen(PressureTrigger) + 1) < 0) {
+        qCWarning(app) << "Failed to register pressure trigger on" << kPressurePath[res] << strerror(errno);
+        close(fd);
+        return false;
+    }
+
+    mFd[res] = fd;
+    // 触发时fd上报POLLPRI
+    mNotifier[res] = new QSocketNotifier(fd, QSocketNotifier::Exception, this);
+    connect(mNotifier[res], &QSocketNotifier::activated, this, [this, res]() {
+        qCDebug(app) << "Pressure reported on" << kPressurePath[res];
+        emit pressureReported(res);
+    });
+    qCInfo(app) << "Watching" << kPressurePath[res] << "with trigger" << PressureTrigger;
+    return true;
+}
+
+void PressureProfile::unwatch(Resource res)
+{
+    if (!isWatching(res))
+        return;
+
+    delete mNotifier[res];
+    mNotifier[res] = nullptr;
+    close(mFd[res]);
+    mFd[res] = -1;
+    qCDebug(app) << "Stopped watching" << kPressurePath[res];
+}
+
+bool PressureProfile::isWatching(Resource res) const
+{
+    return mFd[res] >= 0;
+}
@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PRESSUREPROFILE_H
+#define PRESSUREPROFILE_H
+
+#include <QObject>
+
+class QSocketNotifier;
+
+/*!
+ * 基于PSI(/proc/pressure)触发器的压力监测，内核检测到停顿时才唤醒
+ */
+class PressureProfile : public QObject
+{
+    Q_OBJECT
+public:
+    enum Resource {
+        Cpu,
+        Memory,
+
+        ResourceCount
+    };
+
+    explicit PressureProfile(QObject *parent = nullptr);
+    ~PressureProfile();
+
+public:
+    /*!
+     * 注册资源的压力触发器，内核不支持或无权限时返回false
+     */
+    bool watch(Resource res);
+    /*!
+     * 注销资源的压力触发器
+     */
+    void unwatch(Resource res);
+    /*!
+     * 资源是否由压力触发器监测
+     */
+    bool isWatching(Resource res) const;
+
+signals:
+    /*!
+     * 窗口内停顿时间超过阈值，停顿持续时每个窗口最多一次
+     */
+    void pressureReported(PressureProfile::Resource res);
+
+private:
+    int mFd[ResourceCount];
+    QSocketNotifier *mNotifier[ResourceCount];
+};
+
+#endif // PRESSUREPROFILE_H
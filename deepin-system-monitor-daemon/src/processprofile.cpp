@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "processprofile.h"
+#include "ddlog.h"
+#include "proc_parser.h"
+#include "metrics_snapshot.h"
+
+#include <QDebug>
+
+#include <algorithm>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace DDLog;
+using namespace common::parser;
+
+ProcessProfile::ProcessProfile(QObject *parent)
+    : QObject(parent), mLastTotal(0), mLastScan(0)
+{
+    qCDebug(app) << "ProcessProfile constructor";
+    long pageSize = sysconf(_SC_PAGESIZE);
+    mPageKB = pageSize > 0 ? quint64(pageSize) / 1024 : 4;
+}
+
+bool ProcessProfile::parseStat(const char *buf, size_t len, QString &name, unsigned long long &ticks, quint64 &rss)
+{
+    const char *comm = nullptr;
+    const char *rest = nullptr;
+    size_t commLen = 0;
+    if (!splitStatComm(buf, len, comm, commLen, rest))
+        return false;
+
+    // 从第3项(state)开始：第14、15项为utime、stime，第24项为rss
+    Tokenizer tok(rest, size_t(buf + len - rest));
+    unsigned long long utime = 0, stime = 0, pages = 0;
+    if (!tok.skipTokens(11) || !tok.readU64(utime) || !tok.readU64(stime)
+        || !tok.skipTokens(8) || !tok.readU64(pages))
+        return false;
+
+    name = QString::fromUtf8(comm, int(commLen));
+    ticks = utime + stime;
+    rss = pages;
+    return true;
+}
+
+void ProcessProfile::scan(unsigned long long totalJiffies)
+{
+    DIR *dir = opendir("/proc");
+    if (!dir) {
+        qCWarning(app) << "Failed to open /proc";
+        return;
+    }
+
+    unsigned long long totalDelta = totalJiffies > mLastTotal ? totalJiffies - mLastTotal : 0;
+    bool hasLast = mLastTotal > 0 && totalDelta > 0;
+    QHash<pid_t, unsigned long long> ticksMap;
+    ticksMap.reserve(mLastTicks.size());
+    mUsages.clear();
+
+    char path[32];
+    char buf[1024];
+    struct dirent *entry;
+    while ((entry = readdir(dir))) {
+        if (!isDigit(entry->d_name[0]))
+            continue;
+        pid_t pid = pid_t(atoi(entry->d_name));
+        snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            continue;
+        ssize_t n = read(fd, buf, sizeof(buf) - 1);
+        close(fd);
+        if (n <= 0)
+            continue;
+
+        Usage usage {pid, {}, 0, 0};
+        unsigned long long ticks = 0;
+        if (!parseStat(buf, size_t(n), usage.name, ticks, usage.rss))
+            continue;
+        usage.rss *= mPageKB;
+        ticksMap.insert(pid, ticks);
+        // 新出现的进程以上次扫描为起点无从计算，本次记为0
+        auto it = mLastTicks.constFind(pid);
+        if (hasLast && it != mLastTicks.constEnd() && ticks >= it.value())
+            usage.cpu = double(ticks - it.value()) * 100.0 / double(totalDelta);
+        mUsages.append(usage);
+    }
+    closedir(dir);
+
+    mLastTicks.swap(ticksMap);
+    mLastTotal = totalJiffies;
+    mLastScan = common::metrics::monotonicNow();
+
+    // 只对前几名排序
+    int count = std::min(kTopCount, int(mUsages.size()));
+    std::partial_sort(mUsages.begin(), mUsages.begin() + count, mUsages.end(),
+                      [](const Usage &a, const Usage &b) { return a.cpu > b.cpu; });
+    mTopCpu = QVector<Usage>(mUsages.begin(), mUsages.begin() + count);
+    std::partial_sort(mUsages.begin(), mUsages.begin() + count, mUsages.end(),
+                      [](const Usage &a, const Usage &b) { return a.rss > b.rss; });
+    mTopRss = QVector<Usage>(mUsages.begin(), mUsages.begin() + count);
+    qCDebug(app) << "Scanned" << mUsages.size() << "processes";
+}
@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESSPROFILE_H
+#define PROCESSPROFILE_H
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+
+#include <sys/types.h>
+
+/*!
+ * 进程占用采样，只保留CPU和内存占用最高的几个进程，用于报警时说明原因
+ */
+class ProcessProfile : public QObject
+{
+    Q_OBJECT
+public:
+    struct Usage {
+        pid_t pid;
+        QString name;
+        double cpu; // 占全部CPU的百分比
+        quint64 rss; // kB
+    };
+
+    explicit ProcessProfile(QObject *parent = nullptr);
+
+public:
+    /*!
+     * 扫描/proc下所有进程，进程CPU占用按两次扫描之间的系统时间片计算
+     * \param totalJiffies /proc/stat中的系统时间片总数
+     */
+    void scan(unsigned long long totalJiffies);
+    /*!
+     * 上次扫描时间(CLOCK_MONOTONIC ms)，未扫描过为0
+     */
+    qint64 lastScanTime() const { return mLastScan; }
+    /*!
+     * CPU占用最高的进程，首次扫描后CPU占用均为0
+     */
+    const QVector<Usage> &topByCpu() const { return mTopCpu; }
+    /*!
+     * 内存(RSS)占用最高的进程
+     */
+    const QVector<Usage> &topByRss() const { return mTopRss; }
+
+    /*!
+     * 解析/proc/[pid]/stat，ticks为utime+stime，rss为页数
+     */
+    static bool parseStat(const char *buf, size_t len, QString &name, unsigned long long &ticks, quint64 &rss);
+
+    static constexpr int kTopCount = 5;
+
+private:
+    // 上次扫描各进程的时间片，用于计算差值
+    QHash<pid_t, unsigned long long> mLastTicks;
+    unsigned long long mLastTotal;
+    qint64 mLastScan;
+    quint64 mPageKB;
+    QVector<Usage> mUsages; // 扫描缓存，重复使用
+    QVector<Usage> mTopCpu;
+    QVector<Usage> mTopRss;
+};
+
+#endif // PROCESSPROFILE_H
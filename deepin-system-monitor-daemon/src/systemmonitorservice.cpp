@@ -8,11 +8,19 @@
 #include <QDBusInterface>
 
 #include <QDebug>
-#include <QProcess>
+#include <QDBusPendingCallWatcher>
 #include <QDBusVariant>
 #include <QFile>
 #include <QDBusConnectionInterface>
 #include <QDateTime>
+#include <QDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <errno.h>
+#include <string.h>
 
 using namespace DDLog;
 
@@ -50,6 +58,16 @@ QString getNameByPid(pid_t pid)
 #define InitAlarmOn false
 #define MonitorTimeOut 1000
 #define AlarmMessageTimeOut 10000
+// 快照读取方最近一次读取在此时间内则持续采样
+#define MetricsDemandTimeOut 5000
+// 最近一次压力上报后持续检测报警的时间，触发器窗口的两倍
+#define PressureHoldTimeOut 4000
+// 占用率距报警阈值在此范围内时每次采样都扫描进程，否则按低频间隔扫描
+#define OffenderNearMargin 10
+#define OffenderScanInterval 30000
+// 报警记录条数，及提示中显示的进程个数
+#define AlarmHistoryCount 10
+#define AlarmNotifyOffenders 3
 
 SystemMonitorService::SystemMonitorService(const char *name, QObject *parent)
     : QObject(parent), mProtectionStatus(InitAlarmOn), mAlarmInterval(InitAlarmInterval), mAlarmCpuUsage(InitAlarmCpuUsage), mAlarmMemoryUsage(InitAlarmMemUsage), mCpuUsage(0), mMemoryUsage(0), mMoniterTimer(this)
@@ -57,7 +75,15 @@ SystemMonitorService::SystemMonitorService(const char *name, QObject *parent)
       ,
       mSettings(this),
       mCpu(this),
-      mMem(this)
+      mMem(this),
+      mNet(this),
+      mPressure(this),
+      mPressureUntil {},
+      mProcesses(this),
+      mAlarmHistoryLoaded(false),
+      mDemandTimer(this),
+      mLastSampleTime(0),
+      mBusName(name)
 {
     qCDebug(app) << "SystemMonitorService constructor";
     if (mSettings.isCompelted()) {
@@ -75,27 +101,32 @@ SystemMonitorService::SystemMonitorService(const char *name, QObject *parent)
         qCWarning(app) << "Failed to load settings, using default values";
     }
 
-    // 初始化Cpu占用率
-    mCpuUsage = static_cast<int>(mCpu.updateSystemCpuUsage());
-    // 初始化Memory占用率
-    mMemoryUsage = static_cast<int>(mMem.updateSystemMemoryUsage());
+    if (!mMetrics.open())
+        qCWarning(app) << "Failed to open metrics snapshot:" << strerror(errno);
+
+    // 初始化Cpu、Memory占用率及网络计数
+    sampleSystemStat();
     qCDebug(app) << "Initial system state - CPU:" << mCpuUsage << "% Memory:" << mMemoryUsage << "%";
 
     // 从配置文件，初始化： mProtectionStatus mAlarmInterval mAlarmCpuUsage mAlarmMemoryUsage
     mMoniterTimer.setInterval(MonitorTimeOut);
     connect(&mMoniterTimer, &QTimer::timeout, this, &SystemMonitorService::onMonitorTimeout);
 
-    // 启动监测定时器
-    if (mProtectionStatus) {
-        mMoniterTimer.start();
-    }
+    // 启动监测：优先由PSI压力触发器唤醒，否则启动监测定时器
+    connect(&mPressure, &PressureProfile::pressureReported, this, &SystemMonitorService::onPressureReported);
+    updateAlarmSource();
+    // 未开启监测时，由快照读取方触发采样
+    mDemandTimer.setInterval(MetricsDemandTimeOut);
+    connect(&mDemandTimer, &QTimer::timeout, this, &SystemMonitorService::onDemandTimeout);
+    if (mMetrics.isOpen())
+        mDemandTimer.start();
 
     qCInfo(app) << "Started monitoring timer with interval:" << MonitorTimeOut << "ms";
 
     QDBusConnection::RegisterOptions opts =
             QDBusConnection::ExportAllSlots | QDBusConnection::ExportAllSignals | QDBusConnection::ExportAllProperties;
 
-    QDBusConnection::connectToBus(QDBusConnection::SessionBus, QString(name))
+    QDBusConnection::connectToBus(QDBusConnection::SessionBus, mBusName)
             .registerObject("/org/deepin/SystemMonitorDaemon", this, opts);
     qCInfo(app) << "Registered DBus object at /org/deepin/SystemMonitorDaemon";
 }
@@ -122,6 +153,7 @@ void SystemMonitorService::setSystemProtectionStatus(bool status)
         mSettings.changedOptionValue(AlarmStatusOptionName, mProtectionStatus);
         // 监测设置变更，DBus信号
         emit alarmItemChanged(AlarmStatusOptionName, QDBusVariant(mProtectionStatus));
+        updateAlarmSource();
         qCInfo(app) << "System protection status changed to:" << status;
     }
 }
@@ -253,8 +285,29 @@ void SystemMonitorService::showDeepinSystemMoniter()
     PrintDBusCaller()
     qCDebug(app) << "showDeepinSystemMoniter";
 
-    QString cmd("gdbus call -e -d  com.deepin.SystemMonitorServer -o /com/deepin/SystemMonitorServer -m com.deepin.SystemMonitorServer.showDeepinSystemMoniter");
-    QTimer::singleShot(100, this, [=]() { QProcess::startDetached(cmd); });
+    QTimer::singleShot(100, this, [=]() { callAlarmServer("showDeepinSystemMoniter", {}, false); });
+}
+
+void SystemMonitorService::callAlarmServer(const QString &method, const QVariantList &args, bool retry)
+{
+    // 提示服务未运行时由总线按需激活
+    QDBusMessage msg = QDBusMessage::createMethodCall("com.deepin.SystemMonitorServer",
+                                                      "/com/deepin/SystemMonitorServer",
+                                                      "com.deepin.SystemMonitorServer",
+                                                      method);
+    msg.setArguments(args);
+    QDBusConnection bus = QDBusConnection::connectToBus(QDBusConnection::SessionBus, mBusName);
+    auto *watcher = new QDBusPendingCallWatcher(bus.asyncCall(msg), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [=](QDBusPendingCallWatcher *call) {
+        call->deleteLater();
+        if (!call->isError())
+            return;
+        qCWarning(app) << "Failed to call" << method << "-" << call->error().message();
+        if (retry) {
+            qCWarning(app) << "Retrying" << method;
+            callAlarmServer(method, args, false);
+        }
+    });
 }
 
 void SystemMonitorService::changeAlarmItem(const QString &item, const QDBusVariant &value)
@@ -265,10 +318,8 @@ void SystemMonitorService::changeAlarmItem(const QString &item, const QDBusVaria
             qCDebug(app) << "value is vaild";
             if (item == AlarmStatusOptionName) {
                 mProtectionStatus = value.variant().toBool();
-                if (mProtectionStatus) {
-                    qCDebug(app) << "mProtectionStatus value:" << mProtectionStatus;
-                    mMoniterTimer.start();
-                }
+                qCDebug(app) << "mProtectionStatus value:" << mProtectionStatus;
+                updateAlarmSource();
             } else if (item == AlarmCpuUsageOptionName) {
                 mAlarmCpuUsage = value.variant().toInt();
             } else if (item == AlarmMemUsageOptionName) {
@@ -300,23 +351,9 @@ bool SystemMonitorService::checkCpuAlarm()
     if (mCpuUsage >= mAlarmCpuUsage && diffTime >= timeGap) {
         qCInfo(app) << "CPU usage alarm triggered - Usage:" << mCpuUsage << "% Threshold:" << mAlarmCpuUsage << "%";
         mLastAlarmTimeStamp = curTimeStamp;
-        QString cmd = QString("gdbus call -e -d  com.deepin.SystemMonitorServer -o /com/deepin/SystemMonitorServer -m com.deepin.SystemMonitorServer.showCpuAlarmNotify \"%1\" ").arg(QString::number(mCpuUsage));
-        QTimer::singleShot(100, this, [=]() {
-            qCDebug(app) << "showCpuAlarmNotify";
-            QStringList args;
-            args << "call" << "-e" << "-d" << "com.deepin.SystemMonitorServer"
-                 << "-o" << "/com/deepin/SystemMonitorServer"
-                 << "-m" << "com.deepin.SystemMonitorServer.showCpuAlarmNotify"
-                 << QString::number(mCpuUsage);
-            QProcess process;
-            process.start("gdbus", args);
-            process.waitForFinished(5000);
-            if (process.exitCode() != 0) {
-                qCWarning(app) << "Failed to show CPU alarm notification, retrying...";
-                process.start("gdbus", args);
-                process.waitForFinished(5000);
-            }
-        });
+        QString offenders = recordAlarm("cpu", mCpuUsage, mAlarmCpuUsage, mProcesses.topByCpu());
+        qCDebug(app) << "showCpuAlarmNotify";
+        callAlarmServer("showCpuAlarmNotify", {QString::number(mCpuUsage), offenders});
     }
 
     return false;
@@ -332,40 +369,186 @@ bool SystemMonitorService::checkMemoryAlarm()
     if (mMemoryUsage >= mAlarmMemoryUsage && diffTime > timeGap) {
         qCInfo(app) << "Memory usage alarm triggered - Usage:" << mMemoryUsage << "% Threshold:" << mAlarmMemoryUsage << "%";
         mLastAlarmTimeStamp = curTimeStamp;
-        QString cmd = QString("gdbus call -e -d  com.deepin.SystemMonitorServer -o /com/deepin/SystemMonitorServer -m com.deepin.SystemMonitorServer.showMemoryAlarmNotify \"%1\" ").arg(QString::number(mMemoryUsage));
-        QTimer::singleShot(100, this, [=]() {
-            qCDebug(app) << "showMemoryAlarmNotify";
-            QStringList args;
-            args << "call" << "-e" << "-d" << "com.deepin.SystemMonitorServer"
-                 << "-o" << "/com/deepin/SystemMonitorServer"
-                 << "-m" << "com.deepin.SystemMonitorServer.showMemoryAlarmNotify"
-                 << QString::number(mMemoryUsage);
-            QProcess process;
-            process.start("gdbus", args);
-            process.waitForFinished(5000);
-            if (process.exitCode() != 0) {
-                qCWarning(app) << "Failed to show memory alarm notification, retrying...";
-                process.start("gdbus", args);
-                process.waitForFinished(5000);
-            }
-        });
+        QString offenders = recordAlarm("memory", mMemoryUsage, mAlarmMemoryUsage, mProcesses.topByRss());
+        qCDebug(app) << "showMemoryAlarmNotify";
+        callAlarmServer("showMemoryAlarmNotify", {QString::number(mMemoryUsage), offenders});
     }
 
     return false;
 }
 
+void SystemMonitorService::updateOffenders()
+{
+    qint64 lastScan = mProcesses.lastScanTime();
+    bool nearAlarm = mCpuUsage >= mAlarmCpuUsage - OffenderNearMargin
+            || mMemoryUsage >= mAlarmMemoryUsage - OffenderNearMargin;
+    if (!nearAlarm && lastScan > 0 && common::metrics::monotonicNow() - lastScan < OffenderScanInterval)
+        return;
+    // 接近阈值时每次都扫描，报警时进程CPU占用是最近一个采样周期的
+    mProcesses.scan(mCpu.cpuStat().total());
+}
+
+QString SystemMonitorService::recordAlarm(const QString &type, int usage, int threshold, const QVector<ProcessProfile::Usage> &top)
+{
+    loadAlarmHistory();
+
+    QJsonArray processes;
+    QStringList offenders;
+    for (const ProcessProfile::Usage &proc : top) {
+        QJsonObject item;
+        item.insert("pid", int(proc.pid));
+        item.insert("name", proc.name);
+        item.insert("cpu", qRound(proc.cpu * 10) / 10.0);
+        item.insert("rss", double(proc.rss));
+        processes.append(item);
+        if (offenders.size() < AlarmNotifyOffenders) {
+            if (type == "cpu")
+                offenders << QString("%1 %2%").arg(proc.name).arg(proc.cpu, 0, 'f', 1);
+            else
+                offenders << QString("%1 %2 MB").arg(proc.name).arg(proc.rss / 1024);
+        }
+    }
+
+    QJsonObject record;
+    record.insert("time", double(QDateTime::currentMSecsSinceEpoch()));
+    record.insert("type", type);
+    record.insert("usage", usage);
+    record.insert("threshold", threshold);
+    record.insert("processes", processes);
+    // 最新的在前，超出条数的丢弃
+    mAlarmHistory.prepend(record);
+    while (mAlarmHistory.size() > AlarmHistoryCount)
+        mAlarmHistory.removeLast();
+
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/deepin-system-monitor";
+    QDir().mkpath(dir);
+    QSaveFile file(dir + "/alarm_history.json");
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(mAlarmHistory).toJson(QJsonDocument::Compact));
+        if (!file.commit())
+            qCWarning(app) << "Failed to save alarm history:" << file.errorString();
+    } else {
+        qCWarning(app) << "Failed to open alarm history:" << file.errorString();
+    }
+    return offenders.join(", ");
+}
+
+void SystemMonitorService::loadAlarmHistory()
+{
+    if (mAlarmHistoryLoaded)
+        return;
+    mAlarmHistoryLoaded = true;
+
+    QFile file(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+               + "/deepin-system-monitor/alarm_history.json");
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+    mAlarmHistory = QJsonDocument::fromJson(file.readAll()).array();
+    qCDebug(app) << "Loaded" << mAlarmHistory.size() << "alarm records";
+}
+
+QString SystemMonitorService::getAlarmHistory()
+{
+    PrintDBusCaller()
+    loadAlarmHistory();
+    return QString::fromUtf8(QJsonDocument(mAlarmHistory).toJson(QJsonDocument::Compact));
+}
+
 void SystemMonitorService::onMonitorTimeout()
 {
     qCDebug(app) << "onMonitorTimeout";
     // 获取CPU和内存占用
-    mCpuUsage = static_cast<int>(mCpu.updateSystemCpuUsage());
-    mMemoryUsage = static_cast<int>(mMem.updateSystemMemoryUsage());
+    sampleSystemStat();
     qCDebug(app) << "System state updated - CPU:" << mCpuUsage << "% Memory:" << mMemoryUsage << "%";
 
-    // 进行警报检测
+    // 进行警报检测，由PSI监测的资源只在上报压力后检测
+    bool alarmPolled = false;
     if (mProtectionStatus) {
         qCDebug(app) << "Protection status is enabled. Checking alarms...";
-        checkCpuAlarm();
-        checkMemoryAlarm();
+        qint64 now = common::metrics::monotonicNow();
+        if (isAlarmPolled(PressureProfile::Cpu, now) || isAlarmPolled(PressureProfile::Memory, now))
+            updateOffenders();
+        if (isAlarmPolled(PressureProfile::Cpu, now)) {
+            checkCpuAlarm();
+            alarmPolled = true;
+        }
+        if (isAlarmPolled(PressureProfile::Memory, now)) {
+            checkMemoryAlarm();
+            alarmPolled = true;
+        }
+    }
+    if (!alarmPolled && !mMetrics.isDemanded(MetricsDemandTimeOut)) {
+        qCDebug(app) << "No alarm to check nor metrics reader, stop sampling";
+        mMoniterTimer.stop();
+    }
+}
+
+void SystemMonitorService::onPressureReported(PressureProfile::Resource res)
+{
+    if (!mProtectionStatus)
+        return;
+
+    mPressureUntil[res] = common::metrics::monotonicNow() + PressureHoldTimeOut;
+    if (!mMoniterTimer.isActive()) {
+        // 空闲时上次采样可能已很久，先重新建立Cpu基准，下个周期开始检测
+        qCInfo(app) << "System pressure reported, start checking alarms";
+        sampleSystemStat();
+        mMoniterTimer.start();
+    }
+}
+
+void SystemMonitorService::updateAlarmSource()
+{
+    if (!mProtectionStatus) {
+        mPressure.unwatch(PressureProfile::Cpu);
+        mPressure.unwatch(PressureProfile::Memory);
+        return;
+    }
+
+    bool cpuWatched = mPressure.watch(PressureProfile::Cpu);
+    bool memWatched = mPressure.watch(PressureProfile::Memory);
+    if (cpuWatched && memWatched) {
+        qCInfo(app) << "Alarms are driven by pressure stall triggers";
+    } else if (!mMoniterTimer.isActive()) {
+        mMoniterTimer.start();
     }
 }
+
+bool SystemMonitorService::isAlarmPolled(PressureProfile::Resource res, qint64 now) const
+{
+    return !mPressure.isWatching(res) || now < mPressureUntil[res];
+}
+
+void SystemMonitorService::onDemandTimeout()
+{
+    if (!mMoniterTimer.isActive() && mMetrics.isDemanded(MetricsDemandTimeOut)) {
+        qCDebug(app) << "Metrics snapshot is read, start sampling";
+        onMonitorTimeout();
+        mMoniterTimer.start();
+    }
+}
+
+void SystemMonitorService::sampleSystemStat()
+{
+    mCpuUsage = static_cast<int>(mCpu.updateSystemCpuUsage());
+    mMemoryUsage = static_cast<int>(mMem.updateSystemMemoryUsage());
+    mNet.updateSystemNetStat();
+    if (!mMetrics.isOpen())
+        return;
+
+    common::metrics::MetricsSample sample;
+    sample.sampledAt = common::metrics::monotonicNow();
+    sample.interval = mLastSampleTime ? sample.sampledAt - mLastSampleTime : 0;
+    mLastSampleTime = sample.sampledAt;
+    sample.cpuUsage = mCpu.getCpuUsage();
+    const common::parser::MemInfoFields &mem = mMem.memInfo();
+    sample.memTotal = mem.memTotal;
+    sample.memAvailable = mem.memAvailable;
+    sample.swapTotal = mem.swapTotal;
+    sample.swapFree = mem.swapFree;
+    sample.netRecvBytes = mNet.recvBytes();
+    sample.netSentBytes = mNet.sentBytes();
+    sample.netRecvBps = mNet.recvBps();
+    sample.netSentBps = mNet.sentBps();
+    mMetrics.publish(sample);
+}
@@ -8,6 +8,10 @@
 #include "settinghandler.h"
 #include "cpuprofile.h"
 #include "memoryprofile.h"
+#include "netprofile.h"
+#include "pressureprofile.h"
+#include "processprofile.h"
+#include "metrics_snapshot.h"
 
 #include <DSettings>
 #include <qsettingbackend.h>
@@ -16,6 +20,7 @@
 #include <QDBusContext>
 #include <QDBusVariant>
 #include <QDBusAbstractAdaptor>
+#include <QJsonArray>
 #include <QTimer>
 
 DCORE_USE_NAMESPACE
@@ -83,6 +88,10 @@ public slots:
      * \param lastTime 设置的参数值
      */
     Q_SCRIPTABLE void setAlaramLastTimeInterval(qint64 lastTime);
+    /*!
+     * DBus Adaptor接口: 获取最近的报警记录(JSON数组，最新的在前)，包含报警时占用最高的进程
+     */
+    Q_SCRIPTABLE QString getAlarmHistory();
 
 private:
     /*!
@@ -99,6 +108,34 @@ private:
      * \return 上次告警时间
      */
     qint64 getAlaramLastTimeInterval();
+    /*!
+     * 采样CPU、内存和网络，并发布到共享内存快照
+     */
+    void sampleSystemStat();
+    /*!
+     * 按监测开关注册压力触发器，不支持PSI的资源仍由计时器轮询检测
+     */
+    void updateAlarmSource();
+    /*!
+     * 资源是否需要在监测计时器中检测报警：不支持PSI，或最近上报过压力
+     */
+    bool isAlarmPolled(PressureProfile::Resource res, qint64 now) const;
+    /*!
+     * 通过已连接的会话总线异步调用提示服务，失败时重试一次，不再启动gdbus进程
+     */
+    void callAlarmServer(const QString &method, const QVariantList &args, bool retry = true);
+    /*!
+     * 按占用率扫描进程：接近报警阈值时每次采样都扫描，否则低频扫描
+     */
+    void updateOffenders();
+    /*!
+     * 记录报警及占用最高的进程到报警记录文件，返回提示中显示的进程信息
+     */
+    QString recordAlarm(const QString &type, int usage, int threshold, const QVector<ProcessProfile::Usage> &top);
+    /*!
+     * 首次使用时读取报警记录文件
+     */
+    void loadAlarmHistory();
 
 signals:
     /*!
@@ -111,6 +148,16 @@ public slots:
      * 监测由此计时器槽处理
      */
     void onMonitorTimeout();
+    /*!
+     * 检查是否有读取快照的进程，有则按读取方的频率采样
+     */
+    void onDemandTimeout();
+
+private slots:
+    /*!
+     * 内核上报压力后按计时器频率检测报警，压力消失后停止
+     */
+    void onPressureReported(PressureProfile::Resource res);
 
 private:
     /*!
@@ -142,6 +189,31 @@ private:
      * Memory数据获取类
      */
     MemoryProfile mMem;
+    /*!
+     * 网络数据获取类
+     */
+    NetProfile mNet;
+    /*!
+     * PSI压力监测类，及各资源压力检测截止时间(CLOCK_MONOTONIC ms)
+     */
+    PressureProfile mPressure;
+    qint64 mPressureUntil[PressureProfile::ResourceCount];
+    /*!
+     * 进程占用采样类，及最近的报警记录
+     */
+    ProcessProfile mProcesses;
+    QJsonArray mAlarmHistory;
+    bool mAlarmHistoryLoaded;
+    /*!
+     * 会话内共享的采样快照，托盘插件与弹窗直接读取
+     */
+    common::metrics::MetricsSnapshotWriter mMetrics;
+    QTimer mDemandTimer;
+    qint64 mLastSampleTime;
+    /*!
+     * 服务管理器为插件建立的会话总线连接名
+     */
+    QString mBusName;
 };
 
 #endif // SYSTEMMONITORSERVICE_H
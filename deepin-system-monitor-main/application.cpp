@@ -26,6 +26,7 @@ Application::Application(int &argc, char **argv)
     qCDebug(app) << "Application constructor";
     qRegisterMetaType<Application::TaskState>("Application::TaskState");
     qRegisterMetaType<pid_t>("pid_t");
+    qRegisterMetaType<QList<pid_t>>("QList<pid_t>");
     qRegisterMetaType<ErrorContext>("ErrorContext");
 
     ThreadManager::instance()->attach(new SystemMonitorThread);
@@ -0,0 +1,361 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "cgroup_stats.h"
+#include "common/proc_parser.h"
+#include "process_info_record.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace common::parser;
+
+namespace common {
+namespace cgroup {
+
+#define CGROUP2_ROOT "/sys/fs/cgroup"
+
+// a descriptor per file of a cgroup, cgroups past this are opened & closed on each sample
+const int kMaxPersistentCgroups = 64;
+
+static const char *const kCgroupFileName[] = {
+    "cpu.stat",
+    "memory.current",
+    "io.stat",
+    "pids.current",
+    "cpu.max",
+    "memory.high"
+};
+
+// one shot read of a small cgroup file, null terminated
+static ssize_t readCgroupFile(const QByteArray &controlGroup, const char *file, char *buf, size_t size)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), CGROUP2_ROOT "%s/%s", controlGroup.constData(), file);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return -1;
+    ssize_t n;
+    do {
+        n = read(fd, buf, size - 1);
+    } while (n < 0 && errno == EINTR);
+    close(fd);
+    if (n >= 0)
+        buf[n] = '\0';
+    return n;
+}
+
+CgroupStats::CgroupStats()
+{
+    m_clock.start();
+    long nr = sysconf(_SC_NPROCESSORS_ONLN);
+    m_nrCPU = nr > 0 ? int(nr) : 1;
+}
+
+CgroupStats::~CgroupStats()
+{
+    clear();
+}
+
+bool CgroupStats::isAvailable()
+{
+    // only the unified hierarchy has cgroup.controllers at its root
+    return access(CGROUP2_ROOT "/cgroup.controllers", F_OK) == 0;
+}
+
+QString CgroupStats::processCgroup(pid_t pid)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/cgroup", pid);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return {};
+
+    // a line per v1 hierarchy on hybrid setups, then the unified one
+    char buf[4096];
+    ssize_t n;
+    do {
+        n = read(fd, buf, sizeof(buf));
+    } while (n < 0 && errno == EINTR);
+    close(fd);
+
+    QString cgroup;
+    if (n <= 0 || !parseProcessCgroup(buf, size_t(n), cgroup))
+        return {};
+    return cgroup;
+}
+
+bool CgroupStats::memoryHeadroom(const QString &cgroup, quint64 &headroom)
+{
+    // a limit on a parent, e.g. the user slice, caps everything below it; the root has no memory.max
+    QByteArray path = cgroup.toLocal8Bit();
+    bool limited = false;
+    while (path.size() > 1) {
+        char buf[64];
+        quint64 limit = 0;
+        quint64 current = 0;
+        ssize_t n = readCgroupFile(path, "memory.max", buf, sizeof(buf));
+        if (n > 0 && parseMemoryMax(buf, size_t(n), limit)) {
+            n = readCgroupFile(path, "memory.current", buf, sizeof(buf));
+            if (n > 0 && Tokenizer(buf, size_t(n)).readUInt(current)) {
+                quint64 left = limit > current ? limit - current : 0;
+                headroom = limited ? qMin(headroom, left) : left;
+                limited = true;
+            }
+        }
+        path.truncate(path.lastIndexOf('/'));
+    }
+    return limited;
+}
+
+bool CgroupStats::readLimits(const QString &cgroup, resource_limits_t &limits)
+{
+    limits = {RESOURCE_LIMIT_NONE, RESOURCE_LIMIT_NONE, RESOURCE_LIMIT_NONE};
+    const QByteArray path = cgroup.toLocal8Bit();
+    char buf[256];
+    quint64 quota = 0;
+    quint64 period = 0;
+    // the files of controllers not enabled for the cgroup are missing, they have no limit then
+    ssize_t n = readCgroupFile(path, "cpu.max", buf, sizeof(buf));
+    if (n > 0 && parseCpuMax(buf, size_t(n), quota, period) && period > 0)
+        limits.cpu_quota = quota * 1000000ULL / period;
+    quint64 value = 0;
+    n = readCgroupFile(path, "memory.high", buf, sizeof(buf));
+    if (n > 0 && parseMemoryMax(buf, size_t(n), value))
+        limits.memory_high = value;
+    n = readCgroupFile(path, "io.weight", buf, sizeof(buf));
+    if (n > 0 && parseIOWeight(buf, size_t(n), value))
+        limits.io_weight = value;
+    // empty for cgroups without controllers, but there
+    return readCgroupFile(path, "cgroup.controllers", buf, sizeof(buf)) >= 0;
+}
+
+QHash<QString, cgroup_usage_t> CgroupStats::sample(const QHash<QString, QString> &controlGroups)
+{
+    // close cgroups not asked for any more, or moved
+    for (auto it = m_cgroups.begin(); it != m_cgroups.end();) {
+        auto cg = controlGroups.constFind(it.key());
+        if (cg == controlGroups.constEnd() || cg.value() != it->controlGroup) {
+            if (it->persistent)
+                --m_persistentCount;
+            closeFiles(*it);
+            it = m_cgroups.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    QHash<QString, cgroup_usage_t> usages;
+    qint64 now = m_clock.elapsed();
+    for (auto it = controlGroups.constBegin(); it != controlGroups.constEnd(); ++it) {
+        if (it.value().isEmpty())
+            continue;
+
+        auto cgroup = m_cgroups.find(it.key());
+        if (cgroup == m_cgroups.end()) {
+            cgroup_t entry {};
+            entry.controlGroup = it.value();
+            for (int i = 0; i < kCgroupFileCount; ++i)
+                entry.fds[i] = -1;
+            entry.persistent = m_persistentCount < kMaxPersistentCgroups;
+            entry.sampledAt = -1;
+            if (entry.persistent)
+                ++m_persistentCount;
+            cgroup = m_cgroups.insert(it.key(), entry);
+        }
+
+        cgroup_usage_t usage {};
+        if (sampleCgroup(*cgroup, now, usage))
+            usages.insert(it.key(), usage);
+    }
+    return usages;
+}
+
+void CgroupStats::clear()
+{
+    for (auto &cgroup : m_cgroups)
+        closeFiles(cgroup);
+    m_cgroups.clear();
+    m_persistentCount = 0;
+}
+
+bool CgroupStats::sampleCgroup(cgroup_t &cgroup, qint64 now, cgroup_usage_t &usage)
+{
+    // cpu.stat has 3 lines without the cpu controller, 6 with it
+    char buf[512];
+    ssize_t n = readFile(cgroup, kCpuStatFile, buf, sizeof(buf));
+    quint64 usageUsec = 0;
+    if (n < 0 || !parseCpuStat(buf, size_t(n), usageUsec)) {
+        // gone, or not a cgroup v2 path
+        cgroup.sampledAt = -1;
+        return false;
+    }
+
+    quint64 value = 0;
+    n = readFile(cgroup, kMemoryCurrentFile, buf, sizeof(buf));
+    if (n > 0 && Tokenizer(buf, size_t(n)).readUInt(value))
+        usage.memory = value;
+    n = readFile(cgroup, kPidsCurrentFile, buf, sizeof(buf));
+    if (n > 0 && Tokenizer(buf, size_t(n)).readUInt(value))
+        usage.tasks = value;
+    // limits set while the cgroup is sampled show up on the next sample
+    quint64 quota = 0;
+    quint64 period = 0;
+    n = readFile(cgroup, kCpuMaxFile, buf, sizeof(buf));
+    if (n > 0 && parseCpuMax(buf, size_t(n), quota, period) && period > 0)
+        usage.cpuLimit = qreal(quota) * 100. / (qreal(period) * m_nrCPU);
+    n = readFile(cgroup, kMemoryHighFile, buf, sizeof(buf));
+    if (n > 0 && parseMemoryMax(buf, size_t(n), value))
+        usage.memoryHigh = value;
+
+    // a line per device the cgroup did io on
+    char ioBuf[4096];
+    quint64 ioBytes = 0;
+    n = readFile(cgroup, kIOStatFile, ioBuf, sizeof(ioBuf));
+    bool hasIO = n >= 0 && parseIOStat(ioBuf, size_t(n), ioBytes);
+
+    // counters start over when the unit restarts in a new cgroup
+    qint64 elapsed = now - cgroup.sampledAt;
+    if (cgroup.sampledAt >= 0 && elapsed > 0) {
+        if (usageUsec >= cgroup.usageUsec)
+            usage.cpu = qreal(usageUsec - cgroup.usageUsec) * 100. / (qreal(elapsed) * 1000. * m_nrCPU);
+        if (hasIO && ioBytes >= cgroup.ioBytes)
+            usage.ioRate = qreal(ioBytes - cgroup.ioBytes) * 1000. / qreal(elapsed);
+        usage.hasRates = true;
+    }
+    cgroup.sampledAt = now;
+    cgroup.usageUsec = usageUsec;
+    cgroup.ioBytes = ioBytes;
+    return true;
+}
+
+ssize_t CgroupStats::readFile(cgroup_t &cgroup, CgroupFile file, char *buf, size_t size)
+{
+    int &fd = cgroup.fds[file];
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        if (fd < 0) {
+            char path[PATH_MAX];
+            snprintf(path, sizeof(path), CGROUP2_ROOT "%s/%s", cgroup.controlGroup.toLocal8Bit().constData(),
+                     kCgroupFileName[file]);
+            fd = open(path, O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                return -1;
+        }
+
+        ssize_t n;
+        do {
+            n = pread(fd, buf, size - 1, 0);
+        } while (n < 0 && errno == EINTR);
+        if (n >= 0) {
+            buf[n] = '\0';
+            if (!cgroup.persistent) {
+                close(fd);
+                fd = -1;
+            }
+            return n;
+        }
+
+        // the cgroup was removed (ENODEV), it may have been made again by a restart
+        close(fd);
+        fd = -1;
+    }
+    return -1;
+}
+
+void CgroupStats::closeFiles(cgroup_t &cgroup)
+{
+    for (int i = 0; i < kCgroupFileCount; ++i) {
+        if (cgroup.fds[i] >= 0) {
+            close(cgroup.fds[i]);
+            cgroup.fds[i] = -1;
+        }
+    }
+}
+
+bool CgroupStats::parseCpuStat(const char *buf, size_t len, quint64 &usageUsec)
+{
+    static const char kUsageKey[] = "usage_usec";
+    Tokenizer tok(buf, len);
+    do {
+        const char *key;
+        size_t keyLen;
+        if (tok.readToken(key, keyLen) && keyEquals(key, keyLen, kUsageKey, sizeof(kUsageKey) - 1))
+            return tok.readUInt(usageUsec);
+    } while (tok.nextLine());
+    return false;
+}
+
+bool CgroupStats::parseProcessCgroup(const char *buf, size_t len, QString &cgroup)
+{
+    static const char kUnifiedPrefix[] = "0::";
+    Tokenizer tok(buf, len);
+    do {
+        if (!tok.consume(kUnifiedPrefix, sizeof(kUnifiedPrefix) - 1))
+            continue;
+        const char *path = tok.pos();
+        const char *eol = static_cast<const char *>(memchr(path, '\n', size_t(tok.end() - path)));
+        cgroup = QString::fromLocal8Bit(path, int((eol ? eol : tok.end()) - path));
+        return !cgroup.isEmpty();
+    } while (tok.nextLine());
+    return false;
+}
+
+bool CgroupStats::parseMemoryMax(const char *buf, size_t len, quint64 &limit)
+{
+    return Tokenizer(buf, len).readUInt(limit);
+}
+
+bool CgroupStats::parseCpuMax(const char *buf, size_t len, quint64 &quota, quint64 &period)
+{
+    // "$MAX $PERIOD", $MAX is "max" without a quota
+    Tokenizer tok(buf, len);
+    return tok.readUInt(quota) && tok.readUInt(period);
+}
+
+bool CgroupStats::parseIOWeight(const char *buf, size_t len, quint64 &weight)
+{
+    // "default $WEIGHT", then a "$MAJ:$MIN $WEIGHT" line per device weighted apart
+    static const char kDefaultKey[] = "default";
+    Tokenizer tok(buf, len);
+    do {
+        const char *key;
+        size_t keyLen;
+        if (tok.readToken(key, keyLen) && keyEquals(key, keyLen, kDefaultKey, sizeof(kDefaultKey) - 1))
+            return tok.readUInt(weight);
+    } while (tok.nextLine());
+    return false;
+}
+
+bool CgroupStats::parseIOStat(const char *buf, size_t len, quint64 &bytes)
+{
+    static const char kReadKey[] = "rbytes=";
+    static const char kWriteKey[] = "wbytes=";
+    bytes = 0;
+    Tokenizer tok(buf, len);
+    do {
+        // MAJ:MIN rbytes=N wbytes=N rios=N wios=N dbytes=N dios=N
+        if (!tok.skipTokens(1))
+            continue;
+        const char *field;
+        size_t fieldLen;
+        while (tok.readToken(field, fieldLen)) {
+            const char *value = nullptr;
+            if (fieldLen > sizeof(kReadKey) - 1 && !memcmp(field, kReadKey, sizeof(kReadKey) - 1))
+                value = field + sizeof(kReadKey) - 1;
+            else if (fieldLen > sizeof(kWriteKey) - 1 && !memcmp(field, kWriteKey, sizeof(kWriteKey) - 1))
+                value = field + sizeof(kWriteKey) - 1;
+            quint64 n;
+            if (value && Tokenizer(value, size_t(field + fieldLen - value)).readUInt(n))
+                bytes += n;
+        }
+    } while (tok.nextLine());
+    return true;
+}
+
+} // namespace cgroup
+} // namespace common
@@ -0,0 +1,147 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CGROUP_STATS_H
+#define CGROUP_STATS_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+
+#include <sys/types.h>
+
+struct resource_limits_t;
+
+namespace common {
+namespace cgroup {
+
+/**
+ * @brief Resource usage of a cgroup
+ */
+struct cgroup_usage_t {
+    qreal cpu {}; // percent of all cpus, since last sample
+    quint64 memory {}; // bytes charged to the cgroup, memory.current
+    qreal ioRate {}; // bytes read & written per second, since last sample
+    quint64 tasks {}; // pids.current
+    bool hasRates {}; // false on the first sample of a cgroup, cpu & ioRate are 0 then
+    qreal cpuLimit {}; // cpu.max in percent of all cpus like cpu, 0 without a quota
+    quint64 memoryHigh {}; // memory.high in bytes, 0 without one
+};
+
+/**
+ * @brief Usage of cgroups read from the unified (v2) hierarchy
+ *
+ * cpu.stat, memory.current, io.stat, pids.current, cpu.max & memory.high of each sampled cgroup are
+ * kept open & re-read with pread, they regenerate their content from offset 0 like /proc files. A restarted unit gets a
+ * new cgroup at the same path, stale descriptors are reopened once. Not thread safe.
+ */
+class CgroupStats
+{
+public:
+    CgroupStats();
+    ~CgroupStats();
+
+    /**
+     * @brief Whether the unified cgroup hierarchy is mounted at /sys/fs/cgroup
+     */
+    static bool isAvailable();
+    /**
+     * @brief cgroup of a process in the unified hierarchy, the 0:: line of /proc/[pid]/cgroup
+     * @return Path relative to the cgroup root, empty if it can't be read
+     */
+    static QString processCgroup(pid_t pid);
+    /**
+     * @brief Memory a cgroup may still be charged before the tightest memory.max of it & its ancestors
+     * @param cgroup Path relative to the cgroup root
+     * @param headroom Set to bytes left, 0 once a limit is reached
+     * @return false if neither the cgroup nor an ancestor has a limit
+     */
+    static bool memoryHeadroom(const QString &cgroup, quint64 &headroom);
+    /**
+     * @brief Limits set on a cgroup itself, as resource_limits_t of process_info_record.h
+     * @return false if the cgroup can't be read
+     */
+    static bool readLimits(const QString &cgroup, resource_limits_t &limits);
+
+    /**
+     * @brief Sample cgroups, cgroups of keys not asked for any more are closed
+     * @param controlGroups cgroup path relative to the cgroup root, by caller's key
+     * @return Usage by key, keys whose cgroup can't be read are left out
+     */
+    QHash<QString, cgroup_usage_t> sample(const QHash<QString, QString> &controlGroups);
+    /**
+     * @brief Close all descriptors & forget previous samples
+     */
+    void clear();
+
+    /**
+     * @brief Read usage_usec of cpu.stat content
+     */
+    static bool parseCpuStat(const char *buf, size_t len, quint64 &usageUsec);
+    /**
+     * @brief Sum rbytes & wbytes of all devices in io.stat content, empty content counts as 0
+     */
+    static bool parseIOStat(const char *buf, size_t len, quint64 &bytes);
+    /**
+     * @brief Path of the unified hierarchy in /proc/[pid]/cgroup content
+     */
+    static bool parseProcessCgroup(const char *buf, size_t len, QString &cgroup);
+    /**
+     * @brief Limit of memory.max or memory.high content
+     * @return false for "max", no limit
+     */
+    static bool parseMemoryMax(const char *buf, size_t len, quint64 &limit);
+    /**
+     * @brief Quota & period of cpu.max content, both in us
+     * @return false for "max", no quota
+     */
+    static bool parseCpuMax(const char *buf, size_t len, quint64 &quota, quint64 &period);
+    /**
+     * @brief Default weight of io.weight content
+     */
+    static bool parseIOWeight(const char *buf, size_t len, quint64 &weight);
+
+private:
+    CgroupStats(const CgroupStats &) = delete;
+    CgroupStats &operator=(const CgroupStats &) = delete;
+
+    enum CgroupFile {
+        kCpuStatFile,
+        kMemoryCurrentFile,
+        kIOStatFile,
+        kPidsCurrentFile,
+        kCpuMaxFile, // missing without the cpu controller
+        kMemoryHighFile,
+
+        kCgroupFileCount
+    };
+
+    struct cgroup_t {
+        QString controlGroup;
+        int fds[kCgroupFileCount];
+        bool persistent; // descriptors kept open between samples
+        qint64 sampledAt; // m_clock msecs, -1 before the first sample
+        quint64 usageUsec;
+        quint64 ioBytes;
+    };
+
+    /**
+     * @brief Read a file of the cgroup from offset 0, null terminated
+     * @return Bytes read, or -1 if the file can't be read
+     */
+    ssize_t readFile(cgroup_t &cgroup, CgroupFile file, char *buf, size_t size);
+    bool sampleCgroup(cgroup_t &cgroup, qint64 now, cgroup_usage_t &usage);
+    static void closeFiles(cgroup_t &cgroup);
+
+private:
+    QHash<QString, cgroup_t> m_cgroups; // by caller's key
+    int m_persistentCount {};
+    QElapsedTimer m_clock;
+    int m_nrCPU {1};
+};
+
+} // namespace cgroup
+} // namespace common
+
+#endif // CGROUP_STATS_H
@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core_freq_reader.h"
+#include "proc_parser.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+namespace common {
+namespace parser {
+
+CoreFreqReader::CoreFreqReader(const char *root)
+    : m_root(root)
+{
+}
+
+CoreFreqReader::~CoreFreqReader()
+{
+    closeAll();
+}
+
+void CoreFreqReader::setCpus(const std::vector<int> &cpus)
+{
+    closeAll();
+    m_cores.reserve(cpus.size());
+    for (int cpu : cpus) {
+        core_files_t files {cpu, openFile(cpu, "cpufreq/scaling_cur_freq"),
+                            openFile(cpu, "thermal_throttle/core_throttle_count"),
+                            openFile(cpu, "thermal_throttle/package_throttle_count")};
+        if (files.freqFd < 0 && files.coreThrottleFd < 0 && files.packageThrottleFd < 0)
+            continue;
+        m_cores.push_back(files);
+    }
+}
+
+bool CoreFreqReader::hasThrottleCounters() const
+{
+    for (const core_files_t &files : m_cores) {
+        if (files.coreThrottleFd >= 0 || files.packageThrottleFd >= 0)
+            return true;
+    }
+    return false;
+}
+
+int CoreFreqReader::read(std::vector<unsigned long long> &khz, std::vector<unsigned long long> &throttles)
+{
+    int count = 0;
+    for (const core_files_t &files : m_cores) {
+        size_t i = size_t(files.cpu);
+        if (i >= khz.size())
+            khz.resize(i + 1, 0);
+        if (i >= throttles.size())
+            throttles.resize(i + 1, 0);
+
+        unsigned long long value = 0;
+        khz[i] = files.freqFd >= 0 && readValue(files.freqFd, value) ? value : 0;
+        if (khz[i] > 0)
+            ++count;
+
+        unsigned long long events = 0;
+        if (files.coreThrottleFd >= 0 && readValue(files.coreThrottleFd, value))
+            events += value;
+        if (files.packageThrottleFd >= 0 && readValue(files.packageThrottleFd, value))
+            events += value;
+        throttles[i] = events;
+    }
+    return count;
+}
+
+bool CoreFreqReader::parseValue(const char *buf, size_t len, unsigned long long &value)
+{
+    return Tokenizer(buf, len).readU64(value);
+}
+
+int CoreFreqReader::openFile(int cpu, const char *name) const
+{
+    char path[256];
+    snprintf(path, sizeof(path), "%s/cpu%d/%s", m_root.c_str(), cpu, name);
+    return open(path, O_RDONLY | O_CLOEXEC);
+}
+
+bool CoreFreqReader::readValue(int fd, unsigned long long &value) const
+{
+    // sysfs attributes regenerate their content on a read from offset 0
+    char buf[32];
+    ssize_t n;
+    do {
+        n = pread(fd, buf, sizeof(buf), 0);
+    } while (n < 0 && errno == EINTR);
+    return n > 0 && parseValue(buf, size_t(n), value);
+}
+
+void CoreFreqReader::closeAll()
+{
+    for (const core_files_t &files : m_cores) {
+        for (int fd : {files.freqFd, files.coreThrottleFd, files.packageThrottleFd}) {
+            if (fd >= 0)
+                close(fd);
+        }
+    }
+    m_cores.clear();
+}
+
+} // namespace parser
+} // namespace common
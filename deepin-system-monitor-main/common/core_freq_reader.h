@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CORE_FREQ_READER_H
+#define CORE_FREQ_READER_H
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#define SYSFS_CPU_PATH "/sys/devices/system/cpu"
+
+namespace common {
+namespace parser {
+
+/**
+ * @brief Per core cpufreq & thermal throttle counter reader
+ *
+ * scaling_cur_freq and, where the platform exposes them (x86 thermal_throttle), the core &
+ * package throttle counts of each cpu are opened once & re-read with pread, so a refresh
+ * costs one syscall per file instead of open/read/close. Not thread safe.
+ */
+class CoreFreqReader
+{
+public:
+    explicit CoreFreqReader(const char *root = SYSFS_CPU_PATH);
+    ~CoreFreqReader();
+
+    CoreFreqReader(const CoreFreqReader &) = delete;
+    CoreFreqReader &operator=(const CoreFreqReader &) = delete;
+
+    /**
+     * @brief Open the files of \a cpus, the files of previous cpus are closed
+     */
+    void setCpus(const std::vector<int> &cpus);
+    /**
+     * @brief Whether any cpu exposes throttle counters
+     */
+    bool hasThrottleCounters() const;
+
+    /**
+     * @brief Re-read all cpus, arrays are indexed by cpu id & grown as needed
+     * @param khz Current frequency in kHz, 0 if unreadable
+     * @param throttles Core + package throttle events since boot
+     * @return Number of cpus with a valid frequency
+     */
+    int read(std::vector<unsigned long long> &khz, std::vector<unsigned long long> &throttles);
+
+    /**
+     * @brief Parse a single decimal sysfs value
+     */
+    static bool parseValue(const char *buf, size_t len, unsigned long long &value);
+
+private:
+    struct core_files_t {
+        int cpu;
+        int freqFd;
+        int coreThrottleFd;
+        int packageThrottleFd;
+    };
+
+    int openFile(int cpu, const char *name) const;
+    bool readValue(int fd, unsigned long long &value) const;
+    void closeAll();
+
+    std::string m_root;
+    std::vector<core_files_t> m_cores;
+};
+
+} // namespace parser
+} // namespace common
+
+#endif // CORE_FREQ_READER_H
@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core_usage.h"
+
+#include <string.h>
+
+namespace common {
+namespace usage {
+
+void CoreJiffies::resize(int n)
+{
+    user.resize(size_t(n));
+    nice.resize(size_t(n));
+    sys.resize(size_t(n));
+    idle.resize(size_t(n));
+    iowait.resize(size_t(n));
+    hardirq.resize(size_t(n));
+    softirq.resize(size_t(n));
+    steal.resize(size_t(n));
+    guest.resize(size_t(n));
+    guest_nice.resize(size_t(n));
+}
+
+void CoreUsage::resize(int n)
+{
+    total.resize(size_t(n));
+    idle.resize(size_t(n));
+    usage.resize(size_t(n));
+    user.resize(size_t(n));
+    sys.resize(size_t(n));
+    iowait.resize(size_t(n));
+    hardirq.resize(size_t(n));
+    softirq.resize(size_t(n));
+    steal.resize(size_t(n));
+    guest.resize(size_t(n));
+}
+
+void CoreSchedStat::resize(int n)
+{
+    runTime.resize(size_t(n));
+    runDelay.resize(size_t(n));
+    timeslices.resize(size_t(n));
+}
+
+void CoreRunQueue::resize(int n)
+{
+    runnable.resize(size_t(n));
+    waiting.resize(size_t(n));
+    latency.resize(size_t(n));
+}
+
+// counters may go backwards across cpu hotplug, clamp deltas to 0
+static inline unsigned long long delta(unsigned long long prev, unsigned long long cur)
+{
+    // mask instead of a conditional, keeps the loop free of branches
+    return (cur - prev) & (0ULL - static_cast<unsigned long long>(cur > prev));
+}
+
+// packed 64 bit int to double conversion needs AVX-512, jiffies stay far below 2^52, so put
+// them into the mantissa of 2^52 & subtract it instead, which vectorizes with plain SSE2/NEON
+static inline double toDouble(unsigned long long v)
+{
+    unsigned long long bits = v | 0x4330000000000000ULL;
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d - 4503599627370496.0;
+}
+
+void computeCoreUsage(const CoreJiffies &prev, const CoreJiffies &cur, CoreUsage &out)
+{
+    const int n = cur.size();
+    if (out.size() != n)
+        out.resize(n);
+
+    // plain pointers into the field arrays
+    const unsigned long long *__restrict pUser = prev.user.data();
+    const unsigned long long *__restrict pNice = prev.nice.data();
+    const unsigned long long *__restrict pSys = prev.sys.data();
+    const unsigned long long *__restrict pIdle = prev.idle.data();
+    const unsigned long long *__restrict pIowait = prev.iowait.data();
+    const unsigned long long *__restrict pHardirq = prev.hardirq.data();
+    const unsigned long long *__restrict pSoftirq = prev.softirq.data();
+    const unsigned long long *__restrict pSteal = prev.steal.data();
+    const unsigned long long *__restrict pGuest = prev.guest.data();
+    const unsigned long long *__restrict pGuestNice = prev.guest_nice.data();
+
+    const unsigned long long *__restrict cUser = cur.user.data();
+    const unsigned long long *__restrict cNice = cur.nice.data();
+    const unsigned long long *__restrict cSys = cur.sys.data();
+    const unsigned long long *__restrict cIdle = cur.idle.data();
+    const unsigned long long *__restrict cIowait = cur.iowait.data();
+    const unsigned long long *__restrict cHardirq = cur.hardirq.data();
+    const unsigned long long *__restrict cSoftirq = cur.softirq.data();
+    const unsigned long long *__restrict cSteal = cur.steal.data();
+    const unsigned long long *__restrict cGuest = cur.guest.data();
+    const unsigned long long *__restrict cGuestNice = cur.guest_nice.data();
+
+    unsigned long long *__restrict oTotal = out.total.data();
+    unsigned long long *__restrict oIdle = out.idle.data();
+    double *__restrict oUsage = out.usage.data();
+    double *__restrict oUser = out.user.data();
+    double *__restrict oSys = out.sys.data();
+    double *__restrict oIowait = out.iowait.data();
+    double *__restrict oHardirq = out.hardirq.data();
+    double *__restrict oSoftirq = out.softirq.data();
+    double *__restrict oSteal = out.steal.data();
+    double *__restrict oGuest = out.guest.data();
+
+    // field arrays never overlap, gcc ignores restrict on locals & gives up on runtime alias checks
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC ivdep
+#elif defined(__clang__)
+#pragma clang loop vectorize(assume_safety)
+#endif
+    for (int i = 0; i < n; ++i) {
+        unsigned long long userd = delta(pUser[i] + pNice[i], cUser[i] + cNice[i]);
+        unsigned long long sysd = delta(pSys[i] + pHardirq[i] + pSoftirq[i], cSys[i] + cHardirq[i] + cSoftirq[i]);
+        unsigned long long total = cUser[i] + cNice[i] + cSys[i] + cIdle[i] + cIowait[i] + cHardirq[i] + cSoftirq[i] + cSteal[i];
+        unsigned long long prevTotal = pUser[i] + pNice[i] + pSys[i] + pIdle[i] + pIowait[i] + pHardirq[i] + pSoftirq[i] + pSteal[i];
+        unsigned long long idle = cIdle[i] + cIowait[i];
+        unsigned long long idled = delta(pIdle[i] + pIowait[i], idle);
+        unsigned long long iowaitd = delta(pIowait[i], cIowait[i]);
+        unsigned long long hardirqd = delta(pHardirq[i], cHardirq[i]);
+        unsigned long long softirqd = delta(pSoftirq[i], cSoftirq[i]);
+        unsigned long long steald = delta(pSteal[i], cSteal[i]);
+        unsigned long long guestd = delta(pGuest[i] + pGuestNice[i], cGuest[i] + cGuestNice[i]);
+
+        unsigned long long totald = delta(prevTotal, total);
+        double scale = 100. / toDouble(totald);
+        oTotal[i] = total;
+        oIdle[i] = idle;
+        oUsage[i] = toDouble(delta(idled, totald)) * scale;
+        oUser[i] = toDouble(userd) * scale;
+        oSys[i] = toDouble(sysd) * scale;
+        oIowait[i] = toDouble(iowaitd) * scale;
+        oHardirq[i] = toDouble(hardirqd) * scale;
+        oSoftirq[i] = toDouble(softirqd) * scale;
+        oSteal[i] = toDouble(steald) * scale;
+        oGuest[i] = toDouble(guestd) * scale;
+    }
+}
+
+void computeCoreRunQueue(const CoreSchedStat &prev, const CoreSchedStat &cur, double elapsedNs, CoreRunQueue &out)
+{
+    const int n = cur.size();
+    if (out.size() != n)
+        out.resize(n);
+
+    const double scale = 1. / elapsedNs;
+    for (int i = 0; i < n; ++i) {
+        size_t j = size_t(i);
+        double ran = toDouble(delta(prev.runTime[j], cur.runTime[j]));
+        double waited = toDouble(delta(prev.runDelay[j], cur.runDelay[j]));
+        unsigned long long slices = delta(prev.timeslices[j], cur.timeslices[j]);
+        out.waiting[j] = waited * scale;
+        out.runnable[j] = (ran + waited) * scale;
+        out.latency[j] = slices ? waited / toDouble(slices) / 1000000. : 0.;
+    }
+}
+
+} // namespace usage
+} // namespace common
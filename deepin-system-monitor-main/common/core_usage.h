@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CORE_USAGE_H
+#define CORE_USAGE_H
+
+#include <vector>
+
+#include <stddef.h>
+
+namespace common {
+namespace usage {
+
+/**
+ * @brief Per core jiffy counters from /proc/stat, one array per field indexed by cpu id
+ */
+struct CoreJiffies {
+    std::vector<unsigned long long> user;
+    std::vector<unsigned long long> nice;
+    std::vector<unsigned long long> sys;
+    std::vector<unsigned long long> idle;
+    std::vector<unsigned long long> iowait;
+    std::vector<unsigned long long> hardirq;
+    std::vector<unsigned long long> softirq;
+    std::vector<unsigned long long> steal;
+    std::vector<unsigned long long> guest;
+    std::vector<unsigned long long> guest_nice;
+
+    void resize(int n);
+    int size() const;
+};
+
+/**
+ * @brief Per core usage computed from two jiffy snapshots, indexed by cpu id
+ *
+ * Percentages are NaN if no time elapsed between the snapshots, like CPUUsageSampleFrame::cpupc.
+ */
+struct CoreUsage {
+    std::vector<unsigned long long> total; // total jiffies of current snapshot
+    std::vector<unsigned long long> idle; // idle + iowait jiffies of current snapshot
+    std::vector<double> usage; // busy percent
+    std::vector<double> user; // user + nice percent
+    std::vector<double> sys; // sys + hardirq + softirq percent
+    std::vector<double> iowait; // iowait percent
+    std::vector<double> hardirq; // hardirq percent
+    std::vector<double> softirq; // softirq percent
+    std::vector<double> steal; // taken by the hypervisor we run under, percent
+    std::vector<double> guest; // guest + guest nice percent, vcpus of our guests, counted in user too
+
+    void resize(int n);
+    int size() const;
+};
+
+/**
+ * @brief Compute usage of all cores in one pass
+ *
+ * Branch free loop over the field arrays so the compiler can vectorize it. All arrays must
+ * have the same size, an all zero prev gives usage since boot.
+ */
+void computeCoreUsage(const CoreJiffies &prev, const CoreJiffies &cur, CoreUsage &out);
+
+/**
+ * @brief Per core scheduler counters from the cpu lines of /proc/schedstat, indexed by cpu id
+ */
+struct CoreSchedStat {
+    std::vector<unsigned long long> runTime; // rq_cpu_time, ns tasks ran on the cpu
+    std::vector<unsigned long long> runDelay; // run_delay, ns tasks waited on its run queue
+    std::vector<unsigned long long> timeslices; // pcount, timeslices run
+
+    void resize(int n);
+    int size() const;
+};
+
+/**
+ * @brief Per core run queue between two schedstat snapshots, indexed by cpu id
+ *
+ * By Little's law the ns waited per ns elapsed is the mean count of waiting tasks, so these are
+ * averages over the interval rather than the instant counts of /proc/loadavg.
+ */
+struct CoreRunQueue {
+    std::vector<double> runnable; // mean tasks running or waiting, above 1 the cpu is oversubscribed
+    std::vector<double> waiting; // mean tasks waiting
+    std::vector<double> latency; // mean wait per timeslice, ms, 0 without timeslices
+
+    void resize(int n);
+    int size() const;
+};
+
+/**
+ * @brief Compute the run queue of all cores over elapsedNs
+ *
+ * Both snapshots must have the same size & elapsedNs must be positive.
+ */
+void computeCoreRunQueue(const CoreSchedStat &prev, const CoreSchedStat &cur, double elapsedNs, CoreRunQueue &out);
+
+inline int CoreJiffies::size() const
+{
+    return int(user.size());
+}
+
+inline int CoreUsage::size() const
+{
+    return int(total.size());
+}
+
+inline int CoreSchedStat::size() const
+{
+    return int(runTime.size());
+}
+
+inline int CoreRunQueue::size() const
+{
+    return int(runnable.size());
+}
+
+} // namespace usage
+} // namespace common
+
+#endif // CORE_USAGE_H
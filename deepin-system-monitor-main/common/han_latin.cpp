@@ -5,7 +5,10 @@
 
 #include "han_latin.h"
 #include "ddlog.h"
+#include <QCache>
 #include <QDebug>
+#include <QHash>
+#include <QMutex>
 #include <QString>
 #include <QStringList>
 
@@ -13,10 +16,10 @@
 #include "unicode/translit.h"
 #include "unicode/utypes.h"
 
-#include <memory>
-
 #define TRANSLITERATION_HAN_LATIN "Han-Latin"
 #define TRANSLITERATION_LATIN_ASCII "Latin-ASCII"
+// distinct strings kept converted
+#define TRANSLITERATION_CACHE_SIZE 4096
 
 using namespace std;
 using namespace icu;
@@ -47,42 +50,53 @@ static QString parseError(const QString &words, UErrorCode &ec, const UParseErro
     return errbuf;
 }
 
-QString convHanToLatin(const QString &words)
+// transliterators are expensive to create, built once & shared by all callers for the lifetime of the app
+static Transliterator *transliterator(const char *id, const QString &words)
 {
-    qCDebug(app) << "Converting Han characters to Latin:" << words;
-    QString result {};
+    static QHash<QByteArray, Transliterator *> instances;
+    auto it = instances.constFind(id);
+    if (it != instances.constEnd())
+        return it.value();
+
     UErrorCode ec = U_ZERO_ERROR;
     UParseError pe {};
-    unique_ptr<Transliterator> tr(Transliterator::createInstance(
-            TRANSLITERATION_HAN_LATIN, UTransDirection::UTRANS_FORWARD, pe, ec));
+    Transliterator *tr = Transliterator::createInstance(id, UTransDirection::UTRANS_FORWARD, pe, ec);
+    if (U_FAILURE(ec)) {
+        qCWarning(app) << "Failed to create transliterator" << id << ":" << parseError(words, ec, pe);
+        delete tr;
+        tr = nullptr;
+    }
+    // failures are kept too, so creation is not retried for every name
+    instances.insert(id, tr);
+    return tr;
+}
+
+QString convHanToLatin(const QString &words)
+{
+    // thousands of processes share a handful of names, convert each distinct one once
+    static QMutex mutex;
+    static QCache<QString, QString> cache(TRANSLITERATION_CACHE_SIZE);
 
-    UnicodeString ubuf = UnicodeString::fromUTF8(StringPiece(words.toStdString()));
-    // from hanzi to latin
-    tr->transliterate(ubuf);
+    QMutexLocker locker(&mutex);
+    if (const QString *cached = cache.object(words))
+        return *cached;
 
-    if (U_FAILURE(ec)) {
-        qCWarning(app) << "Failed to transliterate Han to Latin:" << parseError(words, ec, pe);
-        result = words;
-    } else {
-        qCDebug(app) << "Han to Latin success";
-        ec = U_ZERO_ERROR;
-        pe = {};
-        unique_ptr<Transliterator> tr2(Transliterator::createInstance(
-                TRANSLITERATION_LATIN_ASCII, UTransDirection::UTRANS_FORWARD, pe, ec));
-        // from latin to ascii (pinyin)
-        tr2->transliterate(ubuf);
+    qCDebug(app) << "Converting Han characters to Latin:" << words;
+    QString result = words;
+    Transliterator *han = transliterator(TRANSLITERATION_HAN_LATIN, words);
+    Transliterator *ascii = transliterator(TRANSLITERATION_LATIN_ASCII, words);
+    if (han && ascii) {
+        UnicodeString ubuf = UnicodeString::fromUTF8(StringPiece(words.toStdString()));
+        // from hanzi to latin, then from latin to ascii (pinyin)
+        han->transliterate(ubuf);
+        ascii->transliterate(ubuf);
 
-        if (U_FAILURE(ec)) {
-            qCWarning(app) << "Failed to transliterate Latin to ASCII:" << parseError(words, ec, pe);
-            result = words;
-        } else {
-            qCDebug(app) << "Latin to ASCII success";
-            std::string buffer;
-            result = QString::fromStdString(ubuf.toUTF8String(buffer));
-            qCDebug(app) << "Successfully converted to ASCII:" << result;
-        }
+        std::string buffer;
+        result = QString::fromStdString(ubuf.toUTF8String(buffer));
+        qCDebug(app) << "Successfully converted to ASCII:" << result;
     }
 
+    cache.insert(words, new QString(result));
     return result;
 }
 
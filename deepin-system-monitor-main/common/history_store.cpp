@@ -0,0 +1,688 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "history_store.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace common {
+namespace history {
+
+// partitions of the past hour may still get the last blocks of the writer for a refresh
+const int64_t kSealDelay = 60 * 1000;
+
+namespace {
+
+inline uint64_t zigzag(int64_t v)
+{
+    return (uint64_t(v) << 1) ^ uint64_t(v >> 63);
+}
+
+inline int64_t unzigzag(uint64_t v)
+{
+    return int64_t(v >> 1) ^ -int64_t(v & 1);
+}
+
+inline void writeVarint(std::string &out, uint64_t v)
+{
+    while (v >= 0x80) {
+        out.push_back(char(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(char(v));
+}
+
+inline bool readVarint(const char *&p, const char *end, uint64_t &v)
+{
+    v = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        uint8_t byte = uint8_t(*p++);
+        v |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+inline uint64_t doubleBits(double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline double bitsDouble(uint64_t bits)
+{
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// msb first bit stream appended to a string
+class BitWriter
+{
+public:
+    explicit BitWriter(std::string &out)
+        : m_out(out)
+    {
+    }
+
+    void write(uint64_t bits, int n)
+    {
+        for (int i = n - 1; i >= 0; --i) {
+            if (m_used == 0)
+                m_out.push_back(0);
+            if ((bits >> i) & 1)
+                m_out.back() = char(uint8_t(m_out.back()) | (0x80 >> m_used));
+            m_used = (m_used + 1) & 7;
+        }
+    }
+
+private:
+    std::string &m_out;
+    int m_used {0};
+};
+
+class BitReader
+{
+public:
+    BitReader(const char *data, size_t size)
+        : m_data(reinterpret_cast<const uint8_t *>(data))
+        , m_bits(size * 8)
+    {
+    }
+
+    bool read(int n, uint64_t &bits)
+    {
+        if (m_pos + size_t(n) > m_bits)
+            return false;
+        bits = 0;
+        for (int i = 0; i < n; ++i, ++m_pos)
+            bits = (bits << 1) | ((m_data[m_pos >> 3] >> (7 - (m_pos & 7))) & 1);
+        return true;
+    }
+
+private:
+    const uint8_t *m_data;
+    size_t m_bits;
+    size_t m_pos {0};
+};
+
+bool makeDirs(const std::string &dir)
+{
+    for (size_t pos = 1; pos <= dir.size(); ++pos) {
+        if (pos != dir.size() && dir[pos] != '/')
+            continue;
+        std::string part = dir.substr(0, pos);
+        if (mkdir(part.c_str(), 0700) != 0 && errno != EEXIST)
+            return false;
+    }
+    return true;
+}
+
+bool writeAll(int fd, const char *data, size_t size)
+{
+    while (size > 0) {
+        ssize_t nw = write(fd, data, size);
+        if (nw < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += nw;
+        size -= size_t(nw);
+    }
+    return true;
+}
+
+// delta of delta timestamps, zigzag & varint coded, prefixed by their size
+template<typename T>
+void writeTimes(std::string &out, const std::vector<T> &items)
+{
+    std::string times;
+    int64_t prevDelta = 0;
+    for (size_t i = 1; i < items.size(); ++i) {
+        int64_t delta = items[i].time - items[i - 1].time;
+        writeVarint(times, zigzag(delta - prevDelta));
+        prevDelta = delta;
+    }
+    writeVarint(out, times.size());
+    out += times;
+}
+
+template<typename T>
+bool readTimes(const char *&p, const char *end, int64_t firstTime, std::vector<T> &items)
+{
+    uint64_t timesSize;
+    if (!readVarint(p, end, timesSize) || timesSize > uint64_t(end - p))
+        return false;
+    const char *timesEnd = p + timesSize;
+    items[0].time = firstTime;
+    int64_t delta = 0;
+    for (size_t i = 1; i < items.size(); ++i) {
+        uint64_t dod;
+        if (!readVarint(p, timesEnd, dod))
+            return false;
+        delta += unzigzag(dod);
+        items[i].time = items[i - 1].time + delta;
+    }
+    p = timesEnd;
+    return true;
+}
+
+// Gorilla XOR stream of one double field
+template<typename T>
+void writeValues(BitWriter &bits, const std::vector<T> &items, double T::*field)
+{
+    uint64_t prev = doubleBits(items[0].*field);
+    bits.write(prev, 64);
+    int prevLeading = -1;
+    int prevTrailing = 0;
+    for (size_t i = 1; i < items.size(); ++i) {
+        uint64_t cur = doubleBits(items[i].*field);
+        uint64_t x = cur ^ prev;
+        prev = cur;
+        if (!x) {
+            bits.write(0, 1);
+            continue;
+        }
+        int leading = std::min(__builtin_clzll(x), 31);
+        int trailing = __builtin_ctzll(x);
+        if (prevLeading >= 0 && leading >= prevLeading && trailing >= prevTrailing) {
+            // fits the meaningful bits window of the previous value
+            bits.write(0b10, 2);
+            bits.write(x >> prevTrailing, 64 - prevLeading - prevTrailing);
+        } else {
+            int meaningful = 64 - leading - trailing;
+            bits.write(0b11, 2);
+            bits.write(uint64_t(leading), 5);
+            // 64 meaningful bits don't fit 6 bits, no xor has 0 of them
+            bits.write(uint64_t(meaningful & 63), 6);
+            bits.write(x >> trailing, meaningful);
+            prevLeading = leading;
+            prevTrailing = trailing;
+        }
+    }
+}
+
+template<typename T>
+bool readValues(BitReader &bits, std::vector<T> &items, double T::*field)
+{
+    uint64_t prev;
+    if (!bits.read(64, prev))
+        return false;
+    items[0].*field = bitsDouble(prev);
+    int leading = 0;
+    int trailing = 0;
+    for (size_t i = 1; i < items.size(); ++i) {
+        uint64_t control;
+        if (!bits.read(1, control))
+            return false;
+        if (control) {
+            if (!bits.read(1, control))
+                return false;
+            if (control) {
+                uint64_t lead, meaningful;
+                if (!bits.read(5, lead) || !bits.read(6, meaningful))
+                    return false;
+                leading = int(lead);
+                trailing = 64 - leading - (meaningful ? int(meaningful) : 64);
+                if (trailing < 0)
+                    return false;
+            }
+            uint64_t x;
+            if (!bits.read(64 - leading - trailing, x))
+                return false;
+            prev ^= x << trailing;
+        }
+        items[i].*field = bitsDouble(prev);
+    }
+    return true;
+}
+
+const char *const kTierSuffixes[kTierCount] = {".hist", ".10s.hist", ".1m.hist", ".10m.hist"};
+
+} // namespace
+
+void encodeSamples(const std::vector<Sample> &samples, std::string &payload)
+{
+    payload.clear();
+    if (samples.empty())
+        return;
+
+    writeTimes(payload, samples);
+    BitWriter bits(payload);
+    writeValues(bits, samples, &Sample::value);
+}
+
+bool decodeSamples(const char *payload, size_t size, uint32_t count, int64_t firstTime, std::vector<Sample> &samples)
+{
+    samples.resize(count);
+    if (count == 0)
+        return true;
+
+    const char *p = payload;
+    const char *end = payload + size;
+    if (!readTimes(p, end, firstTime, samples))
+        return false;
+    BitReader bits(p, size_t(end - p));
+    return readValues(bits, samples, &Sample::value);
+}
+
+void encodeRollups(const std::vector<Rollup> &rollups, std::string &payload)
+{
+    payload.clear();
+    if (rollups.empty())
+        return;
+
+    writeTimes(payload, rollups);
+    for (const Rollup &rollup : rollups)
+        writeVarint(payload, rollup.count);
+    BitWriter bits(payload);
+    writeValues(bits, rollups, &Rollup::min);
+    writeValues(bits, rollups, &Rollup::max);
+    writeValues(bits, rollups, &Rollup::sum);
+}
+
+bool decodeRollups(const char *payload, size_t size, uint32_t count, int64_t firstTime, std::vector<Rollup> &rollups)
+{
+    rollups.resize(count);
+    if (count == 0)
+        return true;
+
+    const char *p = payload;
+    const char *end = payload + size;
+    if (!readTimes(p, end, firstTime, rollups))
+        return false;
+    for (Rollup &rollup : rollups) {
+        uint64_t n;
+        if (!readVarint(p, end, n))
+            return false;
+        rollup.count = uint32_t(n);
+    }
+    BitReader bits(p, size_t(end - p));
+    return readValues(bits, rollups, &Rollup::min) && readValues(bits, rollups, &Rollup::max)
+           && readValues(bits, rollups, &Rollup::sum);
+}
+
+std::string partitionName(int64_t time, Tier tier)
+{
+    time_t secs = time_t(time / 1000);
+    struct tm tm {};
+    gmtime_r(&secs, &tm);
+    char name[32];
+    snprintf(name, sizeof(name), "%04d%02d%02d-%02d%s", tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour,
+             kTierSuffixes[tier]);
+    return name;
+}
+
+int64_t partitionStart(const std::string &name)
+{
+    struct tm tm {};
+    int prefix = 0;
+    if (sscanf(name.c_str(), "%4d%2d%2d-%2d%n", &tm.tm_year, &tm.tm_mon, &tm.tm_mday, &tm.tm_hour, &prefix) != 4
+        || prefix != 11)
+        return -1;
+    const char *suffix = name.c_str() + prefix;
+    if (std::none_of(std::begin(kTierSuffixes), std::end(kTierSuffixes),
+                     [suffix](const char *tierSuffix) { return strcmp(suffix, tierSuffix) == 0; }))
+        return -1;
+    tm.tm_year -= 1900;
+    tm.tm_mon -= 1;
+    time_t secs = timegm(&tm);
+    return secs < 0 ? -1 : int64_t(secs) * 1000;
+}
+
+Tier tierFor(int64_t span)
+{
+    int tier = kRawTier;
+    // two rollups per bucket at least, a rollup straddling buckets skews no more than half of one
+    while (tier + 1 < kTierCount && 2 * kTierSpans[tier + 1] <= span)
+        ++tier;
+    return Tier(tier);
+}
+
+HistoryWriter::HistoryWriter(const std::string &dir, int64_t retention)
+    : m_dir(dir)
+    , m_retention(retention)
+{
+    m_valid = makeDirs(m_dir) && access(m_dir.c_str(), W_OK) == 0;
+    m_buffers[kRawTier].reserve(64 * 1024);
+}
+
+HistoryWriter::~HistoryWriter()
+{
+    flush();
+}
+
+void HistoryWriter::append(int metric, const std::string &device, int64_t time, double value)
+{
+    if (!m_valid || time < 0)
+        return;
+
+    int64_t partition = time - time % kPartitionSpan;
+    if (partition != m_partition) {
+        // blocks never span partitions, a block of a past hour is still written to its own file,
+        // hours are whole rollup buckets of every tier
+        flush();
+        m_pending.clear();
+        if (m_partition >= 0)
+            prune(time);
+        m_partition = partition;
+    }
+
+    series_t &series = m_pending[SeriesKey {metric, device}];
+    if (series.samples.empty())
+        series.samples.reserve(kBlockSamples);
+    series.samples.push_back({time, value});
+    m_full = m_full || series.samples.size() >= kBlockSamples;
+
+    for (int tier = k10sTier; tier < kTierCount; ++tier) {
+        Rollup &open = series.open[tier];
+        int64_t bucket = time - time % kTierSpans[tier];
+        if (open.count > 0 && open.time != bucket)
+            closeRollups(series, Tier(tier));
+        if (open.count == 0) {
+            open = {bucket, value, value, value, 1};
+            continue;
+        }
+        open.min = std::min(open.min, value);
+        open.max = std::max(open.max, value);
+        open.sum += value;
+        ++open.count;
+    }
+}
+
+void HistoryWriter::closeRollups(series_t &series, Tier tier)
+{
+    Rollup &open = series.open[tier];
+    if (open.count == 0)
+        return;
+    series.rollups[tier].push_back(open);
+    open.count = 0;
+    m_full = m_full || series.rollups[tier].size() >= kBlockSamples;
+}
+
+void HistoryWriter::commit()
+{
+    if (m_full)
+        writeBlocks(false);
+}
+
+void HistoryWriter::flush()
+{
+    // open buckets are written as they are, a restart in the same bucket adds a second rollup of it
+    for (auto &entry : m_pending) {
+        for (int tier = k10sTier; tier < kTierCount; ++tier)
+            closeRollups(entry.second, Tier(tier));
+    }
+    writeBlocks(true);
+}
+
+void HistoryWriter::writeBlocks(bool all)
+{
+    m_full = false;
+    if (m_partition < 0)
+        return;
+
+    for (std::string &buffer : m_buffers)
+        buffer.clear();
+    for (auto &entry : m_pending) {
+        series_t &series = entry.second;
+        if (!series.samples.empty() && (all || series.samples.size() >= kBlockSamples)) {
+            block_header_t header {};
+            header.count = uint32_t(series.samples.size());
+            header.firstTime = series.samples.front().time;
+            header.lastTime = series.samples.back().time;
+            header.min = std::numeric_limits<double>::infinity();
+            header.max = -std::numeric_limits<double>::infinity();
+            for (const Sample &sample : series.samples) {
+                header.min = std::min(header.min, sample.value);
+                header.max = std::max(header.max, sample.value);
+                header.sum += sample.value;
+            }
+            encodeSamples(series.samples, m_payload);
+            appendHeader(entry.first, header, m_buffers[kRawTier]);
+            series.samples.clear();
+        }
+
+        for (int tier = k10sTier; tier < kTierCount; ++tier) {
+            std::vector<Rollup> &rollups = series.rollups[tier];
+            if (rollups.empty() || (!all && rollups.size() < kBlockSamples))
+                continue;
+            block_header_t header {};
+            header.count = uint32_t(rollups.size());
+            header.firstTime = rollups.front().time;
+            header.lastTime = rollups.back().time;
+            header.min = std::numeric_limits<double>::infinity();
+            header.max = -std::numeric_limits<double>::infinity();
+            for (const Rollup &rollup : rollups) {
+                header.min = std::min(header.min, rollup.min);
+                header.max = std::max(header.max, rollup.max);
+                header.sum += rollup.sum;
+            }
+            encodeRollups(rollups, m_payload);
+            appendHeader(entry.first, header, m_buffers[tier]);
+            rollups.clear();
+        }
+    }
+
+    for (int tier = kRawTier; tier < kTierCount; ++tier) {
+        const std::string &buffer = m_buffers[tier];
+        if (buffer.empty())
+            continue;
+        std::string path = m_dir + "/" + partitionName(m_partition, Tier(tier));
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0600);
+        if (fd < 0)
+            continue;
+        writeAll(fd, buffer.data(), buffer.size());
+        close(fd);
+    }
+}
+
+void HistoryWriter::appendHeader(const SeriesKey &key, block_header_t &header, std::string &out)
+{
+    // the payload was just encoded into m_payload
+    header.magic = kBlockMagic;
+    header.metric = uint16_t(key.first);
+    header.deviceSize = uint16_t(std::min(key.second.size(), size_t(std::numeric_limits<uint16_t>::max())));
+    header.payloadSize = uint32_t(m_payload.size());
+    out.append(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.append(key.second.data(), header.deviceSize);
+    out += m_payload;
+}
+
+void HistoryWriter::prune(int64_t now)
+{
+    DIR *dir = opendir(m_dir.c_str());
+    if (!dir)
+        return;
+    while (struct dirent *entry = readdir(dir)) {
+        int64_t start = partitionStart(entry->d_name);
+        if (start >= 0 && start + kPartitionSpan <= now - m_retention)
+            unlinkat(dirfd(dir), entry->d_name, 0);
+    }
+    closedir(dir);
+}
+
+HistoryReader::HistoryReader(const std::string &dir)
+    : m_dir(dir)
+{
+}
+
+HistoryReader::~HistoryReader()
+{
+    for (auto &entry : m_partitions) {
+        partition_t &part = entry.second;
+        if (part.map)
+            munmap(const_cast<char *>(part.map), part.mapSize);
+        if (part.fd >= 0)
+            close(part.fd);
+    }
+}
+
+const HistoryReader::partition_t &HistoryReader::partition(int64_t start, Tier tier, int64_t now)
+{
+    partition_t &part = m_partitions[{tier, start}];
+    if (!part.sealed) {
+        refresh(start, tier, part);
+        part.sealed = start + kPartitionSpan + kSealDelay <= now;
+    }
+    return part;
+}
+
+void HistoryReader::refresh(int64_t start, Tier tier, partition_t &part)
+{
+    if (part.fd < 0) {
+        std::string path = m_dir + "/" + partitionName(start, tier);
+        part.fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (part.fd < 0)
+            return;
+    }
+
+    struct stat st {};
+    if (fstat(part.fd, &st) != 0 || size_t(st.st_size) <= part.mapSize)
+        return;
+    if (part.map)
+        munmap(const_cast<char *>(part.map), part.mapSize);
+    void *map = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, part.fd, 0);
+    if (map == MAP_FAILED) {
+        part.map = nullptr;
+        part.mapSize = 0;
+        part.validSize = 0;
+        return;
+    }
+    part.map = static_cast<const char *>(map);
+    part.mapSize = size_t(st.st_size);
+
+    // a block still being appended is left for the next refresh
+    while (part.validSize + sizeof(block_header_t) <= part.mapSize) {
+        block_header_t header;
+        memcpy(&header, part.map + part.validSize, sizeof(header));
+        size_t blockSize = sizeof(header) + header.deviceSize + header.payloadSize;
+        if (header.magic != kBlockMagic || part.validSize + blockSize > part.mapSize)
+            break;
+        part.validSize += blockSize;
+    }
+}
+
+std::vector<double> HistoryReader::query(int metric, const std::string &device, int64_t from, int64_t to, size_t buckets,
+                                         Aggregate aggregate)
+{
+    std::vector<double> values(buckets, std::nan(""));
+    if (buckets == 0 || to <= from)
+        return values;
+
+    std::vector<double> sums(buckets, 0.);
+    std::vector<uint32_t> counts(buckets, 0);
+    double span = double(to - from) / double(buckets);
+    auto add = [&](int64_t time, double value, double sum, uint32_t count) {
+        size_t bucket = std::min(size_t(double(time - from) / span), buckets - 1);
+        sums[bucket] += sum;
+        values[bucket] = counts[bucket] ? std::max(values[bucket], value) : value;
+        counts[bucket] += count;
+    };
+
+    // adds the blocks of a tier in [lo, hi), returns the end of the last rollup bucket read
+    int64_t now = to;
+    auto scan = [&](Tier tier, int64_t lo, int64_t hi) {
+        int64_t covered = lo;
+        for (int64_t start = lo - lo % kPartitionSpan; start < hi; start += kPartitionSpan) {
+            const partition_t &part = partition(start, tier, now);
+            for (size_t offset = 0; offset < part.validSize;) {
+                block_header_t header;
+                memcpy(&header, part.map + offset, sizeof(header));
+                const char *blockDevice = part.map + offset + sizeof(header);
+                const char *payload = blockDevice + header.deviceSize;
+                offset += sizeof(header) + header.deviceSize + header.payloadSize;
+
+                if (header.metric != metric || header.deviceSize != device.size()
+                    || memcmp(blockDevice, device.data(), device.size()) != 0 || header.count == 0
+                    || header.lastTime < lo || header.firstTime >= hi)
+                    continue;
+
+                if (tier != kRawTier) {
+                    if (!decodeRollups(payload, header.payloadSize, header.count, header.firstTime, m_rollups))
+                        continue;
+                    for (const Rollup &rollup : m_rollups) {
+                        if (rollup.time >= lo && rollup.time < hi)
+                            add(rollup.time, rollup.max, rollup.sum, rollup.count);
+                    }
+                    covered = std::max(covered, header.lastTime + kTierSpans[tier]);
+                    continue;
+                }
+                if (header.firstTime >= lo && header.lastTime < hi && double(header.lastTime - header.firstTime) <= span) {
+                    add(header.firstTime + (header.lastTime - header.firstTime) / 2, header.max, header.sum, header.count);
+                    continue;
+                }
+                if (!decodeSamples(payload, header.payloadSize, header.count, header.firstTime, m_samples))
+                    continue;
+                for (const Sample &sample : m_samples) {
+                    if (sample.time >= lo && sample.time < hi)
+                        add(sample.time, sample.value, sample.value, 1);
+                }
+            }
+        }
+        return covered;
+    };
+
+    // rollups of the current hour are written in blocks of kBlockSamples, their tail comes from raw samples
+    Tier tier = tierFor(int64_t(span));
+    int64_t covered = scan(tier, from, to);
+    if (tier != kRawTier && covered < to)
+        scan(kRawTier, covered, to);
+
+    if (aggregate == kAverage) {
+        for (size_t i = 0; i < buckets; ++i) {
+            if (counts[i])
+                values[i] = sums[i] / counts[i];
+        }
+    }
+    return values;
+}
+
+void HistoryReader::scan(int64_t from, int64_t to,
+                         const std::function<void(int, const std::string &, const std::vector<Sample> &)> &visit)
+{
+    std::string device;
+    for (int64_t start = from - from % kPartitionSpan; start < to; start += kPartitionSpan) {
+        const partition_t &part = partition(start, kRawTier, to);
+        for (size_t offset = 0; offset < part.validSize;) {
+            block_header_t header;
+            memcpy(&header, part.map + offset, sizeof(header));
+            const char *blockDevice = part.map + offset + sizeof(header);
+            const char *payload = blockDevice + header.deviceSize;
+            offset += sizeof(header) + header.deviceSize + header.payloadSize;
+
+            if (header.count == 0 || header.lastTime < from || header.firstTime >= to
+                || !decodeSamples(payload, header.payloadSize, header.count, header.firstTime, m_samples))
+                continue;
+            // blocks at either end of the range are trimmed
+            if (header.firstTime < from || header.lastTime >= to) {
+                m_samples.erase(std::remove_if(m_samples.begin(), m_samples.end(), [from, to](const Sample &sample) {
+                                    return sample.time < from || sample.time >= to;
+                                }),
+                                m_samples.end());
+            }
+            device.assign(blockDevice, header.deviceSize);
+            visit(header.metric, device, m_samples);
+        }
+    }
+}
+
+} // namespace history
+} // namespace common
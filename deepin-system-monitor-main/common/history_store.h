@@ -0,0 +1,235 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef HISTORY_STORE_H
+#define HISTORY_STORE_H
+
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace common {
+namespace history {
+
+/**
+ * @brief One sample of a series, time in ms since epoch
+ */
+struct Sample {
+    int64_t time;
+    double value;
+};
+
+/**
+ * @brief Samples of a series summed over a bucket of a rollup tier, time is the bucket start
+ */
+struct Rollup {
+    int64_t time;
+    double min;
+    double max;
+    double sum;
+    uint32_t count;
+};
+
+/**
+ * @brief Resolutions kept of every series, raw samples & rollups maintained while samples are appended
+ */
+enum Tier {
+    kRawTier,
+    k10sTier,
+    k1mTier,
+    k10mTier,
+
+    kTierCount
+};
+// bucket span of each tier in ms, raw samples come at the base refresh period
+const int64_t kTierSpans[kTierCount] = {1000, 10 * 1000, 60 * 1000, 10 * 60 * 1000};
+
+/**
+ * @brief Fixed layout head of a block on disk, followed by the device name & the payload
+ *
+ * min, max & sum of the block's samples make a downsampled point, reads zoomed out further than
+ * a raw block spans never decode payloads. count is the number of samples or rollups stored.
+ */
+struct block_header_t {
+    uint32_t magic;
+    uint16_t metric;
+    uint16_t deviceSize;
+    uint32_t count;
+    uint32_t payloadSize;
+    int64_t firstTime;
+    int64_t lastTime;
+    double min;
+    double max;
+    double sum;
+};
+static_assert(sizeof(block_header_t) == 56, "block header layout is part of the file format");
+
+const uint32_t kBlockMagic = 0x31484d44; // "DMH1"
+// samples or rollups per block, two minutes of raw samples at the base refresh period
+const size_t kBlockSamples = 120;
+// one file per hour & tier, named after its UTC hour
+const int64_t kPartitionSpan = 3600 * 1000;
+const int64_t kDefaultRetention = 7 * 24 * kPartitionSpan;
+
+/**
+ * @brief Encode samples as a block payload
+ *
+ * Timestamps are delta of delta, zigzag & varint coded, a steady cadence costs a byte per sample.
+ * Values are XORed with the previous one & their meaningful bits stored Gorilla style, an unchanged
+ * value costs a bit.
+ */
+void encodeSamples(const std::vector<Sample> &samples, std::string &payload);
+/**
+ * @brief Decode count samples of a payload, firstTime is the block's first timestamp
+ * @return false if the payload is truncated or malformed
+ */
+bool decodeSamples(const char *payload, size_t size, uint32_t count, int64_t firstTime, std::vector<Sample> &samples);
+/**
+ * @brief Encode rollups as a block payload, times & counts as varints, min, max & sum as XOR streams
+ */
+void encodeRollups(const std::vector<Rollup> &rollups, std::string &payload);
+bool decodeRollups(const char *payload, size_t size, uint32_t count, int64_t firstTime, std::vector<Rollup> &rollups);
+
+/**
+ * @brief File name of the partition of a tier holding time, YYYYMMDD-HH.hist in UTC for raw samples,
+ * YYYYMMDD-HH.10s.hist & so on for rollups
+ */
+std::string partitionName(int64_t time, Tier tier = kRawTier);
+/**
+ * @brief Start time of a partition of any tier from its file name, -1 if it's not one
+ */
+int64_t partitionStart(const std::string &name);
+/**
+ * @brief Coarsest tier with at least two buckets per span
+ */
+Tier tierFor(int64_t span);
+
+/**
+ * @brief Append only writer of a history directory
+ *
+ * Samples are kept per series until a block is full or the partition hour changes, then all pending
+ * blocks of a partition are appended to its file in one write, so a crash loses at most the samples
+ * of the last blocks & leaves no torn block before the end of a file. Every sample is added to the
+ * open bucket of each rollup tier too, a bucket is closed by the first sample past it. Not thread safe.
+ */
+class HistoryWriter
+{
+public:
+    explicit HistoryWriter(const std::string &dir, int64_t retention = kDefaultRetention);
+    ~HistoryWriter();
+
+    HistoryWriter(const HistoryWriter &) = delete;
+    HistoryWriter &operator=(const HistoryWriter &) = delete;
+
+    /**
+     * @brief Whether the directory exists & can be written
+     */
+    inline bool isValid() const { return m_valid; }
+
+    /**
+     * @brief Buffer a sample, pending samples of the previous partition are written first when its hour is over
+     */
+    void append(int metric, const std::string &device, int64_t time, double value);
+    /**
+     * @brief Write the full blocks in one write, run after the samples of a refresh were appended
+     */
+    void commit();
+    /**
+     * @brief Write every pending sample, run on exit
+     */
+    void flush();
+    /**
+     * @brief Remove partitions ended before now minus the retention
+     */
+    void prune(int64_t now);
+
+private:
+    using SeriesKey = std::pair<int, std::string>;
+
+    struct series_t {
+        std::vector<Sample> samples;
+        Rollup open[kTierCount]; // open bucket of each rollup tier, raw tier unused
+        std::vector<Rollup> rollups[kTierCount];
+    };
+
+    void closeRollups(series_t &series, Tier tier);
+    void writeBlocks(bool all);
+    void appendHeader(const SeriesKey &key, block_header_t &header, std::string &out);
+
+    std::string m_dir;
+    int64_t m_retention;
+    bool m_valid {false};
+    bool m_full {false}; // a series has a full block
+    int64_t m_partition {-1}; // start of the partition pending samples belong to
+    std::map<SeriesKey, series_t> m_pending;
+    std::string m_buffers[kTierCount]; // blocks of a write, reused
+    std::string m_payload;
+};
+
+/**
+ * @brief Reader of a history directory through read only mappings
+ *
+ * Blocks are read in place from the mappings, nothing is copied or indexed. A growing partition
+ * is remapped & only its new tail validated, past partitions are mapped once. Queries read the
+ * coarsest tier with two buckets per query bucket, so a day long chart reads minute rollups instead of
+ * every sample, the span not yet rolled up is read from raw samples. Not thread safe.
+ */
+class HistoryReader
+{
+public:
+    enum Aggregate {
+        kAverage,
+        kMaximum
+    };
+
+    explicit HistoryReader(const std::string &dir);
+    ~HistoryReader();
+
+    HistoryReader(const HistoryReader &) = delete;
+    HistoryReader &operator=(const HistoryReader &) = delete;
+
+    /**
+     * @brief Series downsampled to buckets evenly spanning [from, to)
+     *
+     * A raw block spanning no more than a bucket counts as one point of its mean or max, others are decoded.
+     * @return One value per bucket, NaN for buckets without samples
+     */
+    std::vector<double> query(int metric, const std::string &device, int64_t from, int64_t to, size_t buckets,
+                              Aggregate aggregate = kAverage);
+    /**
+     * @brief Raw samples of every series in [from, to), block by block in the order they were written
+     *
+     * Samples of a series come in time order, blocks of different series interleave. \a visit gets
+     * the metric, device & samples of a block, the vector is reused for the next one.
+     */
+    void scan(int64_t from, int64_t to,
+              const std::function<void(int metric, const std::string &device, const std::vector<Sample> &samples)> &visit);
+
+private:
+    struct partition_t {
+        int fd {-1};
+        const char *map {nullptr};
+        size_t mapSize {0};
+        size_t validSize {0}; // bytes of whole blocks
+        bool sealed {false}; // past partition fully mapped, or missing
+    };
+
+    const partition_t &partition(int64_t start, Tier tier, int64_t now);
+    void refresh(int64_t start, Tier tier, partition_t &part);
+
+    std::string m_dir;
+    std::map<std::pair<int, int64_t>, partition_t> m_partitions; // by tier & start time
+    std::vector<Sample> m_samples; // decode buffers, reused
+    std::vector<Rollup> m_rollups;
+};
+
+} // namespace history
+} // namespace common
+
+#endif // HISTORY_STORE_H
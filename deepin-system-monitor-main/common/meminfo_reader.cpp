@@ -0,0 +1,147 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "meminfo_reader.h"
+#include "proc_parser.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace common {
+namespace parser {
+
+namespace {
+
+struct MemInfoField {
+    const char *key;
+    size_t len;
+    size_t offset;
+};
+
+const unsigned kSlots = 32;
+
+// collision free for the tracked keys, see kFields
+inline unsigned slotOf(const char *key, size_t len)
+{
+    return (unsigned(len) + 29u * static_cast<unsigned char>(key[0]) + 5u * static_cast<unsigned char>(key[len - 1])) & (kSlots - 1);
+}
+
+// indexed by slotOf(key)
+const MemInfoField kFields[kSlots] = {
+    {"Buffers", 7, offsetof(MemInfoFields, buffers)}, // 0
+    {nullptr, 0, 0}, // 1
+    {nullptr, 0, 0}, // 2
+    {nullptr, 0, 0}, // 3
+    {"KReclaimable", 12, offsetof(MemInfoFields, kReclaimable)}, // 4
+    {"SwapCached", 10, offsetof(MemInfoFields, swapCached)}, // 5
+    {"Inactive", 8, offsetof(MemInfoFields, inactive)}, // 6
+    {"Zswap", 5, offsetof(MemInfoFields, zswap)}, // 7
+    {"SwapFree", 8, offsetof(MemInfoFields, swapFree)}, // 8
+    {"AnonHugePages", 13, offsetof(MemInfoFields, anonHugePages)}, // 9
+    {nullptr, 0, 0}, // 10
+    {nullptr, 0, 0}, // 11
+    {"SwapTotal", 9, offsetof(MemInfoFields, swapTotal)}, // 12
+    {"Shmem", 5, offsetof(MemInfoFields, shmem)}, // 13
+    {"Zswapped", 8, offsetof(MemInfoFields, zswapped)}, // 14
+    {nullptr, 0, 0}, // 15
+    {nullptr, 0, 0}, // 16
+    {"Cached", 6, offsetof(MemInfoFields, cached)}, // 17
+    {nullptr, 0, 0}, // 18
+    {"Mapped", 6, offsetof(MemInfoFields, mapped)}, // 19
+    {"ShmemHugePages", 14, offsetof(MemInfoFields, shmemHugePages)}, // 20
+    {"Slab", 4, offsetof(MemInfoFields, slab)}, // 21
+    {"Dirty", 5, offsetof(MemInfoFields, dirty)}, // 22
+    {nullptr, 0, 0}, // 23
+    {nullptr, 0, 0}, // 24
+    {"MemFree", 7, offsetof(MemInfoFields, memFree)}, // 25
+    {"FileHugePages", 13, offsetof(MemInfoFields, fileHugePages)}, // 26
+    {"Writeback", 9, offsetof(MemInfoFields, writeback)}, // 27
+    {"Active", 6, offsetof(MemInfoFields, active)}, // 28
+    {"MemTotal", 8, offsetof(MemInfoFields, memTotal)}, // 29
+    {"MemAvailable", 12, offsetof(MemInfoFields, memAvailable)}, // 30
+    {nullptr, 0, 0}, // 31
+};
+
+inline const MemInfoField *lookup(const char *key, size_t len)
+{
+    if (len == 0)
+        return nullptr;
+    const MemInfoField &field = kFields[slotOf(key, len)];
+    return (field.key && keyEquals(key, len, field.key, field.len)) ? &field : nullptr;
+}
+
+} // namespace
+
+MemInfoReader::MemInfoReader(const char *path)
+    : m_path(path)
+    , m_fd(-1)
+{
+}
+
+MemInfoReader::~MemInfoReader()
+{
+    if (m_fd >= 0)
+        close(m_fd);
+}
+
+bool MemInfoReader::read(MemInfoFields &fields)
+{
+    if (m_fd < 0) {
+        m_fd = open(m_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (m_fd < 0)
+            return false;
+    }
+
+    size_t total = 0;
+    while (total < sizeof(m_buf)) {
+        ssize_t n = pread(m_fd, m_buf + total, sizeof(m_buf) - total, off_t(total));
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            // reopen on next read
+            int err = errno;
+            close(m_fd);
+            m_fd = -1;
+            errno = err;
+            return false;
+        }
+        if (n == 0)
+            break;
+        total += size_t(n);
+    }
+    if (total == 0)
+        return false;
+
+    parse(m_buf, total, fields);
+    return true;
+}
+
+int MemInfoReader::parse(const char *buf, size_t len, MemInfoFields &fields)
+{
+    Tokenizer tok(buf, len);
+    char *base = reinterpret_cast<char *>(&fields);
+    int found = 0;
+
+    do {
+        // "Node 0 MemTotal:  4947704 kB" in /sys/devices/system/node/node0/meminfo
+        if (tok.consume("Node ", 5) && !tok.skipTokens(1))
+            continue;
+
+        const char *key;
+        size_t keyLen;
+        if (!tok.readKey(key, keyLen))
+            continue;
+
+        const MemInfoField *field = lookup(key, keyLen);
+        if (field && tok.readU64(*reinterpret_cast<unsigned long long *>(base + field->offset)))
+            ++found;
+    } while (tok.nextLine());
+
+    return found;
+}
+
+} // namespace parser
+} // namespace common
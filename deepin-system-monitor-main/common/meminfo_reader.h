@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef MEMINFO_READER_H
+#define MEMINFO_READER_H
+
+#include <stddef.h>
+
+#include <string>
+
+#define PROC_MEMINFO_PATH "/proc/meminfo"
+
+namespace common {
+namespace parser {
+
+/**
+ * @brief Fields of /proc/meminfo we care about, in kB
+ */
+struct MemInfoFields {
+    unsigned long long memTotal {0}; // MemTotal
+    unsigned long long memFree {0}; // MemFree
+    unsigned long long memAvailable {0}; // MemAvailable
+    unsigned long long buffers {0}; // Buffers
+    unsigned long long cached {0}; // Cached
+    unsigned long long swapCached {0}; // SwapCached
+    unsigned long long active {0}; // Active
+    unsigned long long inactive {0}; // Inactive
+    unsigned long long swapTotal {0}; // SwapTotal
+    unsigned long long swapFree {0}; // SwapFree
+    unsigned long long dirty {0}; // Dirty
+    unsigned long long writeback {0}; // Writeback
+    unsigned long long anonHugePages {0}; // AnonHugePages
+    unsigned long long mapped {0}; // Mapped
+    unsigned long long shmem {0}; // Shmem
+    unsigned long long kReclaimable {0}; // KReclaimable, kernel 4.20+
+    unsigned long long slab {0}; // Slab
+    unsigned long long shmemHugePages {0}; // ShmemHugePages, shmem & tmpfs backed by huge pages
+    unsigned long long fileHugePages {0}; // FileHugePages, page cache, kernel 5.4+
+    unsigned long long zswap {0}; // Zswap, compressed pool, kernel 5.19+
+    unsigned long long zswapped {0}; // Zswapped, pages stored in it, uncompressed size
+};
+
+/**
+ * @brief Single pass /proc/meminfo reader
+ *
+ * The file is opened once & re-read with pread from offset 0, so a refresh costs one
+ * syscall. Each "Key: value kB" line is mapped to its MemInfoFields member through a
+ * precomputed perfect hash table of the keys above, lines we don't track cost one
+ * hash & compare. Reads the meminfo of numa nodes too, their lines are prefixed with
+ * "Node N". Not thread safe.
+ */
+class MemInfoReader
+{
+public:
+    explicit MemInfoReader(const char *path = PROC_MEMINFO_PATH);
+    ~MemInfoReader();
+
+    MemInfoReader(const MemInfoReader &) = delete;
+    MemInfoReader &operator=(const MemInfoReader &) = delete;
+
+    /**
+     * @brief Re-read file & update fields, fields missing from file are left untouched
+     * @return false if file can't be opened or read, errno is kept
+     */
+    bool read(MemInfoFields &fields);
+
+    /**
+     * @brief Parse meminfo content
+     * @return Number of fields found
+     */
+    static int parse(const char *buf, size_t len, MemInfoFields &fields);
+
+private:
+    std::string m_path;
+    int m_fd;
+    // meminfo is ~1.5k, leave room for fields added by newer kernels
+    char m_buf[8192];
+};
+
+} // namespace parser
+} // namespace common
+
+#endif // MEMINFO_READER_H
@@ -0,0 +1,226 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "metrics_snapshot.h"
+
+#include <algorithm>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace common {
+namespace metrics {
+
+namespace {
+
+MetricsSegment *mapSegment(int fd, int prot)
+{
+    void *addr = mmap(nullptr, sizeof(MetricsSegment), prot, MAP_SHARED, fd, 0);
+    return addr == MAP_FAILED ? nullptr : static_cast<MetricsSegment *>(addr);
+}
+
+} // namespace
+
+int64_t monotonicNow()
+{
+    timespec ts {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+std::string defaultSegmentPath()
+{
+    const char *dir = getenv("XDG_RUNTIME_DIR");
+    std::string path = (dir && *dir) ? dir : "/run/user/" + std::to_string(getuid());
+    return path + "/deepin-system-monitor-metrics";
+}
+
+MetricsSnapshotWriter::MetricsSnapshotWriter(const std::string &path)
+    : m_path(path)
+    , m_fd(-1)
+    , m_segment(nullptr)
+{
+}
+
+MetricsSnapshotWriter::~MetricsSnapshotWriter()
+{
+    if (m_segment)
+        munmap(m_segment, sizeof(MetricsSegment));
+    if (m_fd >= 0)
+        close(m_fd);
+}
+
+bool MetricsSnapshotWriter::open()
+{
+    if (m_segment)
+        return true;
+
+    m_fd = ::open(m_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (m_fd < 0)
+        return false;
+
+    struct stat st {};
+    if (fstat(m_fd, &st) == 0 && st.st_size != off_t(sizeof(MetricsSegment))
+        && ftruncate(m_fd, off_t(sizeof(MetricsSegment))) != 0) {
+        int err = errno;
+        close(m_fd);
+        m_fd = -1;
+        errno = err;
+        return false;
+    }
+
+    m_segment = mapSegment(m_fd, PROT_READ | PROT_WRITE);
+    if (!m_segment) {
+        int err = errno;
+        close(m_fd);
+        m_fd = -1;
+        errno = err;
+        return false;
+    }
+
+    // left by a sampler of another layout, readers refuse it until it's ours
+    if (m_segment->magic != kMetricsMagic || m_segment->version != kMetricsVersion) {
+        m_segment->magic = 0;
+        std::atomic_thread_fence(std::memory_order_release);
+        m_segment->seq.store(0, std::memory_order_relaxed);
+        m_segment->demandedAt.store(0, std::memory_order_relaxed);
+        m_segment->sample = MetricsSample();
+        m_segment->historyCount = 0;
+        m_segment->version = kMetricsVersion;
+        std::atomic_thread_fence(std::memory_order_release);
+        m_segment->magic = kMetricsMagic;
+    }
+    return true;
+}
+
+void MetricsSnapshotWriter::publish(const MetricsSample &sample)
+{
+    if (!m_segment)
+        return;
+
+    uint32_t seq = m_segment->seq.load(std::memory_order_relaxed);
+    // a sampler killed mid publish leaves seq odd
+    seq += (seq & 1) ? 1 : 2;
+    m_segment->seq.store(seq - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&m_segment->sample, &sample, sizeof(sample));
+    MetricsHistoryPoint &point = m_segment->history[m_segment->historyCount % kMetricsHistoryLength];
+    point.sampledAt = sample.sampledAt;
+    point.cpuUsage = sample.cpuUsage;
+    point.netRecvBps = sample.netRecvBps;
+    point.netSentBps = sample.netSentBps;
+    ++m_segment->historyCount;
+    m_segment->seq.store(seq, std::memory_order_release);
+}
+
+bool MetricsSnapshotWriter::isDemanded(int64_t maxAgeMs) const
+{
+    if (!m_segment)
+        return false;
+    int64_t demandedAt = m_segment->demandedAt.load(std::memory_order_relaxed);
+    return demandedAt > 0 && monotonicNow() - demandedAt <= maxAgeMs;
+}
+
+MetricsSnapshotReader::MetricsSnapshotReader(const std::string &path)
+    : m_path(path)
+    , m_fd(-1)
+    , m_segment(nullptr)
+    , m_nextOpen(0)
+{
+}
+
+MetricsSnapshotReader::~MetricsSnapshotReader()
+{
+    if (m_segment)
+        munmap(m_segment, sizeof(MetricsSegment));
+    if (m_fd >= 0)
+        close(m_fd);
+}
+
+bool MetricsSnapshotReader::open()
+{
+    int64_t now = monotonicNow();
+    if (now < m_nextOpen)
+        return false;
+    m_nextOpen = now + kReopenInterval;
+
+    // read write, readers stamp demandedAt
+    int fd = ::open(m_path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size < off_t(sizeof(MetricsSegment))) {
+        close(fd);
+        return false;
+    }
+    m_segment = mapSegment(fd, PROT_READ | PROT_WRITE);
+    if (!m_segment) {
+        close(fd);
+        return false;
+    }
+    m_fd = fd;
+    return true;
+}
+
+bool MetricsSnapshotReader::copySegment(MetricsSample *sample, MetricsHistoryPoint *history, uint64_t *historyCount)
+{
+    if (!m_segment && !open())
+        return false;
+
+    m_segment->demandedAt.store(monotonicNow(), std::memory_order_relaxed);
+    if (m_segment->magic != kMetricsMagic || m_segment->version != kMetricsVersion)
+        return false;
+
+    for (int i = 0; i < kMaxRetries; ++i) {
+        uint32_t begin = m_segment->seq.load(std::memory_order_acquire);
+        if (begin == 0)
+            return false;
+        if (begin & 1)
+            continue;
+        if (sample)
+            memcpy(sample, &m_segment->sample, sizeof(*sample));
+        if (history) {
+            *historyCount = m_segment->historyCount;
+            memcpy(history, m_segment->history, sizeof(m_segment->history));
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_segment->seq.load(std::memory_order_relaxed) == begin)
+            return true;
+    }
+    return false;
+}
+
+bool MetricsSnapshotReader::read(MetricsSample &sample, int64_t maxAgeMs)
+{
+    MetricsSample copy;
+    if (!copySegment(&copy, nullptr, nullptr))
+        return false;
+    if (monotonicNow() - copy.sampledAt > maxAgeMs)
+        return false;
+    sample = copy;
+    return true;
+}
+
+int MetricsSnapshotReader::readHistory(MetricsHistoryPoint *points, int max)
+{
+    MetricsHistoryPoint history[kMetricsHistoryLength];
+    uint64_t count = 0;
+    if (max <= 0 || !copySegment(nullptr, history, &count))
+        return 0;
+
+    int n = int(std::min<uint64_t>(count, uint64_t(std::min(max, kMetricsHistoryLength))));
+    for (int i = 0; i < n; ++i)
+        points[i] = history[(count - uint64_t(n - i)) % kMetricsHistoryLength];
+    return n;
+}
+
+} // namespace metrics
+} // namespace common
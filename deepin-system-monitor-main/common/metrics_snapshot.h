@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef METRICS_SNAPSHOT_H
+#define METRICS_SNAPSHOT_H
+
+#include <atomic>
+#include <string>
+
+#include <stdint.h>
+
+namespace common {
+namespace metrics {
+
+/**
+ * @brief System wide figures sampled once per session, fixed layout
+ */
+struct MetricsSample {
+    int64_t sampledAt {0}; // CLOCK_MONOTONIC ms
+    int64_t interval {0}; // ms since previous sample, rates are taken over it
+    double cpuUsage {0}; // %, all cpus
+    uint64_t memTotal {0}; // kB
+    uint64_t memAvailable {0}; // kB
+    uint64_t swapTotal {0}; // kB
+    uint64_t swapFree {0}; // kB
+    uint64_t netRecvBytes {0}; // since boot, loopback excluded
+    uint64_t netSentBytes {0};
+    double netRecvBps {0}; // bytes per second
+    double netSentBps {0};
+};
+
+/**
+ * @brief Chart figures of one sample, kept in the history ring
+ */
+struct MetricsHistoryPoint {
+    int64_t sampledAt {0}; // CLOCK_MONOTONIC ms
+    double cpuUsage {0};
+    double netRecvBps {0};
+    double netSentBps {0};
+};
+
+const uint32_t kMetricsMagic = 0x44534d4d; // "DSMM"
+// bump on any change of MetricsSegment, MetricsSample or MetricsHistoryPoint
+const uint32_t kMetricsVersion = 2;
+// two minutes at the sampler cadence
+const int kMetricsHistoryLength = 120;
+
+/**
+ * @brief Shared memory layout, guarded by a seqlock
+ *
+ * seq is odd while the sampler writes the sample. Readers copy the sample & retry if seq
+ * changed meanwhile, so neither side ever blocks. demandedAt is stamped by readers, the
+ * sampler only runs at reader cadence while someone asked recently. The history ring is
+ * written under the same seq, so charts of a reader attaching late start filled.
+ */
+struct MetricsSegment {
+    uint32_t magic;
+    uint32_t version;
+    std::atomic<uint32_t> seq;
+    uint32_t reserved;
+    std::atomic<int64_t> demandedAt; // CLOCK_MONOTONIC ms of last read
+    MetricsSample sample;
+    uint64_t historyCount; // points ever published, latest at (historyCount - 1) % length
+    MetricsHistoryPoint history[kMetricsHistoryLength];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<int64_t>::is_always_lock_free,
+              "seqlock of a process shared segment needs lock free atomics");
+
+/**
+ * @brief CLOCK_MONOTONIC in ms, comparable across processes
+ */
+int64_t monotonicNow();
+/**
+ * @brief Per session segment path, $XDG_RUNTIME_DIR/deepin-system-monitor-metrics
+ */
+std::string defaultSegmentPath();
+
+/**
+ * @brief Sampler side of the segment, one per session
+ */
+class MetricsSnapshotWriter
+{
+public:
+    explicit MetricsSnapshotWriter(const std::string &path = defaultSegmentPath());
+    ~MetricsSnapshotWriter();
+
+    MetricsSnapshotWriter(const MetricsSnapshotWriter &) = delete;
+    MetricsSnapshotWriter &operator=(const MetricsSnapshotWriter &) = delete;
+
+    /**
+     * @brief Create or take over the segment, a segment of another layout is reset
+     * @return false if it can't be mapped, errno is kept
+     */
+    bool open();
+    bool isOpen() const
+    {
+        return m_segment != nullptr;
+    }
+    /**
+     * @brief Publish a sample, readers see either the previous or this one whole
+     */
+    void publish(const MetricsSample &sample);
+    /**
+     * @brief Whether a reader read within the last maxAgeMs
+     */
+    bool isDemanded(int64_t maxAgeMs) const;
+
+private:
+    std::string m_path;
+    int m_fd;
+    MetricsSegment *m_segment;
+};
+
+/**
+ * @brief Reader side of the segment, opened on first read
+ *
+ * A missing segment is looked for again at most every kReopenInterval ms, so readers
+ * falling back to their own sampling don't pay an open() per tick.
+ */
+class MetricsSnapshotReader
+{
+public:
+    explicit MetricsSnapshotReader(const std::string &path = defaultSegmentPath());
+    ~MetricsSnapshotReader();
+
+    MetricsSnapshotReader(const MetricsSnapshotReader &) = delete;
+    MetricsSnapshotReader &operator=(const MetricsSnapshotReader &) = delete;
+
+    /**
+     * @brief Copy the latest sample & tell the sampler it's wanted
+     * @param sample Copied sample
+     * @param maxAgeMs Samples older than this are refused
+     * @return false if there's no sampler or its sample is stale, sample is left untouched
+     */
+    bool read(MetricsSample &sample, int64_t maxAgeMs);
+    /**
+     * @brief Copy the latest history points, oldest first
+     * @param points Copied points, at least max of them
+     * @param max Points wanted, up to kMetricsHistoryLength
+     * @return Points copied, 0 if there's no sampler. Samples taken on demand leave gaps,
+     * callers check sampledAt
+     */
+    int readHistory(MetricsHistoryPoint *points, int max);
+
+    static constexpr int64_t kReopenInterval = 5000;
+    // a writer stuck in the middle of publish is taken for a dead sampler
+    static constexpr int kMaxRetries = 64;
+
+private:
+    bool open();
+    /**
+     * @brief Seqlock read of the sample & or the history ring, either may be null
+     */
+    bool copySegment(MetricsSample *sample, MetricsHistoryPoint *history, uint64_t *historyCount);
+
+private:
+    std::string m_path;
+    int m_fd;
+    MetricsSegment *m_segment;
+    int64_t m_nextOpen;
+};
+
+} // namespace metrics
+} // namespace common
+
+#endif // METRICS_SNAPSHOT_H
@@ -0,0 +1,249 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "perf_trace.h"
+
+#include <mutex>
+
+#include <stdio.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace common {
+namespace trace {
+
+namespace {
+
+const char *const kStageNames[kStageCount] = {
+    "scan",
+    "dir scan",
+    "pid read",
+    "dkapture",
+    "merge",
+    "model diff",
+    "paint"
+};
+
+const char *const kCounterNames[kCounterCount] = {
+    "open",
+    "read",
+    "readdir",
+    "vanished"
+};
+
+// buffers are never freed, a reader may still walk the one of an exited thread
+std::mutex &registryLock()
+{
+    static std::mutex lock;
+    return lock;
+}
+
+std::vector<ThreadBuffer *> &registry()
+{
+    static std::vector<ThreadBuffer *> buffers;
+    return buffers;
+}
+
+thread_local ThreadBuffer *t_buffer = nullptr;
+
+void appendEscaped(std::string &out, const std::string &text)
+{
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += c;
+        }
+    }
+}
+
+// chrome trace timestamps are us
+void appendMicros(std::string &out, int64_t ns)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%lld.%03lld", static_cast<long long>(ns / 1000), static_cast<long long>(ns % 1000));
+    out += buf;
+}
+
+} // namespace
+
+const char *stageName(int stage)
+{
+    return stage >= 0 && stage < kStageCount ? kStageNames[stage] : "unknown";
+}
+
+const char *counterName(int counter)
+{
+    return counter >= 0 && counter < kCounterCount ? kCounterNames[counter] : "unknown";
+}
+
+int64_t nowNs()
+{
+    timespec ts {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+ThreadBuffer::ThreadBuffer(int tid, const std::string &name)
+    : m_tid(tid)
+    , m_name(name)
+{
+    for (auto &counter : m_counters)
+        counter.store(0, std::memory_order_relaxed);
+}
+
+void ThreadBuffer::record(int stage, int64_t begin, int64_t duration)
+{
+    if (stage < 0 || stage >= kStageCount)
+        return;
+
+    uint64_t index = m_head.load(std::memory_order_relaxed);
+    Slot &slot = m_slots[index % kCapacity];
+    slot.seq.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.begin = begin;
+    slot.duration = duration;
+    slot.stage = stage;
+    slot.seq.store(2 * index + 2, std::memory_order_release);
+    m_head.store(index + 1, std::memory_order_release);
+
+    Totals &totals = m_totals[stage];
+    uint64_t ns = duration > 0 ? uint64_t(duration) : 0;
+    totals.count.store(totals.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    totals.totalNs.store(totals.totalNs.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+    if (ns > totals.maxNs.load(std::memory_order_relaxed))
+        totals.maxNs.store(ns, std::memory_order_relaxed);
+}
+
+ThreadStats ThreadBuffer::stats() const
+{
+    ThreadStats stats;
+    stats.tid = m_tid;
+    stats.name = m_name;
+    for (int i = 0; i < kStageCount; ++i) {
+        stats.stages[i].count = m_totals[i].count.load(std::memory_order_relaxed);
+        stats.stages[i].totalNs = m_totals[i].totalNs.load(std::memory_order_relaxed);
+        stats.stages[i].maxNs = m_totals[i].maxNs.load(std::memory_order_relaxed);
+    }
+    for (int i = 0; i < kCounterCount; ++i)
+        stats.counters[i] = m_counters[i].load(std::memory_order_relaxed);
+    return stats;
+}
+
+void ThreadBuffer::copyEvents(std::vector<TraceEvent> &events) const
+{
+    uint64_t head = m_head.load(std::memory_order_acquire);
+    uint64_t first = head > uint64_t(kCapacity) ? head - kCapacity : 0;
+    for (uint64_t index = first; index < head; ++index) {
+        const Slot &slot = m_slots[index % kCapacity];
+        uint64_t seq = slot.seq.load(std::memory_order_acquire);
+        if (seq != 2 * index + 2)
+            continue;
+        TraceEvent event;
+        event.begin = slot.begin;
+        event.duration = slot.duration;
+        event.stage = slot.stage;
+        event.tid = m_tid;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // overwritten by the writer meanwhile
+        if (slot.seq.load(std::memory_order_relaxed) != seq)
+            continue;
+        events.push_back(event);
+    }
+}
+
+ThreadBuffer *localBuffer()
+{
+    if (t_buffer)
+        return t_buffer;
+
+    // Qt names its threads before run(), first record comes later
+    char name[17] {};
+    prctl(PR_GET_NAME, name, 0, 0, 0);
+    auto *buffer = new ThreadBuffer(int(syscall(SYS_gettid)), name);
+    {
+        std::lock_guard<std::mutex> guard(registryLock());
+        registry().push_back(buffer);
+    }
+    t_buffer = buffer;
+    return buffer;
+}
+
+std::vector<ThreadStats> collectStats()
+{
+    std::lock_guard<std::mutex> guard(registryLock());
+    std::vector<ThreadStats> stats;
+    stats.reserve(registry().size());
+    for (const ThreadBuffer *buffer : registry())
+        stats.push_back(buffer->stats());
+    return stats;
+}
+
+std::string chromeTraceJson()
+{
+    std::vector<const ThreadBuffer *> buffers;
+    {
+        std::lock_guard<std::mutex> guard(registryLock());
+        buffers.assign(registry().begin(), registry().end());
+    }
+
+    int pid = int(getpid());
+    std::string out = "{\"traceEvents\":[";
+    bool first = true;
+    auto separate = [&]() {
+        if (!first)
+            out += ',';
+        first = false;
+    };
+
+    std::vector<TraceEvent> events;
+    int64_t now = nowNs();
+    for (const ThreadBuffer *buffer : buffers) {
+        separate();
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + std::to_string(pid)
+               + ",\"tid\":" + std::to_string(buffer->tid()) + ",\"args\":{\"name\":\"";
+        appendEscaped(out, buffer->name());
+        out += "\"}}";
+
+        events.clear();
+        buffer->copyEvents(events);
+        for (const TraceEvent &event : events) {
+            separate();
+            out += "{\"name\":\"";
+            out += stageName(event.stage);
+            out += "\",\"cat\":\"sampling\",\"ph\":\"X\",\"ts\":";
+            appendMicros(out, event.begin);
+            out += ",\"dur\":";
+            appendMicros(out, event.duration);
+            out += ",\"pid\":" + std::to_string(pid) + ",\"tid\":" + std::to_string(event.tid) + '}';
+        }
+
+        // syscall counts as one counter track per thread, sampled at export time
+        ThreadStats stats = buffer->stats();
+        separate();
+        out += "{\"name\":\"syscalls " + std::to_string(buffer->tid()) + "\",\"ph\":\"C\",\"ts\":";
+        appendMicros(out, now);
+        out += ",\"pid\":" + std::to_string(pid) + ",\"tid\":" + std::to_string(buffer->tid()) + ",\"args\":{";
+        for (int i = 0; i < kCounterCount; ++i) {
+            if (i > 0)
+                out += ',';
+            out += '"';
+            out += counterName(i);
+            out += "\":" + std::to_string(stats.counters[i]);
+        }
+        out += "}}";
+    }
+    out += "],\"displayTimeUnit\":\"ms\"}";
+    return out;
+}
+
+} // namespace trace
+} // namespace common
@@ -0,0 +1,180 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PERF_TRACE_H
+#define PERF_TRACE_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+namespace common {
+namespace trace {
+
+/**
+ * @brief Hot path stages timed by PERF_TRACE_SCOPE / PERF_TRACE_BEGIN
+ */
+enum Stage {
+    kStageScan, // whole process scan
+    kStageDirScan, // pid list from /proc or process events
+    kStagePidRead, // per pid /proc reads
+    kStageDKapture, // system service snapshot, reply & next request
+    kStageMerge, // sampled processes merged into the set
+    kStageModelDiff, // prepared rows applied to the table model
+    kStagePaint, // table view paint
+
+    kStageCount
+};
+
+/**
+ * @brief Syscalls & events counted by PERF_TRACE_COUNT
+ */
+enum Counter {
+    kCounterOpen,
+    kCounterRead,
+    kCounterReadDir,
+    kCounterVanished, // pids gone between listing & reading
+
+    kCounterCount
+};
+
+const char *stageName(int stage);
+const char *counterName(int counter);
+
+// CLOCK_MONOTONIC ns
+int64_t nowNs();
+
+struct TraceEvent {
+    int64_t begin {0}; // CLOCK_MONOTONIC ns
+    int64_t duration {0}; // ns
+    int stage {0};
+    int tid {0};
+};
+
+struct StageStats {
+    uint64_t count {0};
+    uint64_t totalNs {0};
+    uint64_t maxNs {0};
+};
+
+/**
+ * @brief Totals of one thread since it first recorded
+ */
+struct ThreadStats {
+    int tid {0};
+    std::string name;
+    StageStats stages[kStageCount];
+    uint64_t counters[kCounterCount] {};
+};
+
+/**
+ * @brief Per thread buffer, written by its own thread only
+ *
+ * Events go to a fixed ring, each slot carries the sequence of the event in it: odd while
+ * written, 2 * index + 2 once complete. Readers copy a slot & drop it if the sequence is
+ * not the expected one before & after the copy, so the writer never waits on a reader.
+ * Totals & counters are relaxed atomics, single writer, a reader may see them one event apart.
+ */
+class ThreadBuffer
+{
+public:
+    static const int kCapacity = 4096;
+
+    ThreadBuffer(int tid, const std::string &name);
+
+    void record(int stage, int64_t begin, int64_t duration);
+    void count(int counter, uint64_t n)
+    {
+        m_counters[counter].store(m_counters[counter].load(std::memory_order_relaxed) + n,
+                                  std::memory_order_relaxed);
+    }
+
+    int tid() const { return m_tid; }
+    const std::string &name() const { return m_name; }
+    ThreadStats stats() const;
+    // events still in the ring, oldest first
+    void copyEvents(std::vector<TraceEvent> &events) const;
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq {0};
+        int64_t begin {0};
+        int64_t duration {0};
+        int stage {0};
+    };
+    struct Totals {
+        std::atomic<uint64_t> count {0};
+        std::atomic<uint64_t> totalNs {0};
+        std::atomic<uint64_t> maxNs {0};
+    };
+
+    const int m_tid;
+    const std::string m_name;
+    std::atomic<uint64_t> m_head {0};
+    Totals m_totals[kStageCount];
+    std::atomic<uint64_t> m_counters[kCounterCount];
+    Slot m_slots[kCapacity];
+};
+
+// buffer of the calling thread, registered on first use & kept until exit of the process
+ThreadBuffer *localBuffer();
+
+inline void record(int stage, int64_t begin, int64_t duration)
+{
+    localBuffer()->record(stage, begin, duration);
+}
+
+inline void count(int counter, uint64_t n)
+{
+    localBuffer()->count(counter, n);
+}
+
+// totals of every thread which recorded so far
+std::vector<ThreadStats> collectStats();
+// ring contents of every thread as Chrome trace event format, loads in chrome://tracing & Perfetto
+std::string chromeTraceJson();
+
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(int stage)
+        : m_stage(stage)
+        , m_begin(nowNs())
+    {
+    }
+    ~ScopedTimer() { record(m_stage, m_begin, nowNs() - m_begin); }
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+    const int m_stage;
+    const int64_t m_begin;
+};
+
+} // namespace trace
+} // namespace common
+
+// stage timers cost nothing unless configured with -DENABLE_PERF_TRACE=ON
+#ifdef PERF_TRACE
+#define PERF_TRACE_CONCAT_(a, b) a##b
+#define PERF_TRACE_CONCAT(a, b) PERF_TRACE_CONCAT_(a, b)
+#define PERF_TRACE_SCOPE(stage) \
+    common::trace::ScopedTimer PERF_TRACE_CONCAT(perfTraceScope_, __LINE__)(common::trace::stage)
+#define PERF_TRACE_BEGIN(stage) \
+    const int64_t perfTraceBegin_##stage = common::trace::nowNs()
+#define PERF_TRACE_END(stage) \
+    common::trace::record(common::trace::stage, perfTraceBegin_##stage, common::trace::nowNs() - perfTraceBegin_##stage)
+#define PERF_TRACE_COUNT(counter, n) \
+    common::trace::count(common::trace::counter, n)
+#else
+#define PERF_TRACE_SCOPE(stage)
+#define PERF_TRACE_BEGIN(stage)
+#define PERF_TRACE_END(stage)
+#define PERF_TRACE_COUNT(counter, n)
+#endif
+
+#endif // PERF_TRACE_H
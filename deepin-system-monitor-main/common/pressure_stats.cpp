@@ -0,0 +1,218 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "pressure_stats.h"
+#include "common/proc_parser.h"
+
+#include <QRegularExpression>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <unistd.h>
+
+using namespace common::parser;
+
+namespace common {
+namespace pressure {
+
+#define PROC_PRESSURE_DIR "/proc/pressure"
+#define CGROUP2_ROOT "/sys/fs/cgroup"
+
+static const char *const kSystemFileName[] = {
+    PROC_PRESSURE_DIR "/cpu",
+    PROC_PRESSURE_DIR "/memory",
+    PROC_PRESSURE_DIR "/io"
+};
+
+static const char *const kCgroupFileName[] = {
+    "cpu.pressure",
+    "memory.pressure",
+    "io.pressure"
+};
+
+PressureStats::PressureStats()
+{
+    m_clock.start();
+    for (int i = 0; i < kPressureResourceCount; ++i) {
+        m_system.fds[i] = -1;
+        m_cgroup.fds[i] = -1;
+    }
+    reset(m_system);
+    reset(m_cgroup);
+}
+
+PressureStats::~PressureStats()
+{
+    clear();
+}
+
+bool PressureStats::isAvailable()
+{
+    // the directory exists with psi=0 too, but reading fails with EOPNOTSUPP then
+    int fd = open(kSystemFileName[kCpuPressure], O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    char buf[256];
+    ssize_t n = pread(fd, buf, sizeof(buf), 0);
+    close(fd);
+    return n > 0;
+}
+
+QString PressureStats::sessionCgroup(const QString &cgroup)
+{
+    static const QRegularExpression kUserSlice("^(/user\\.slice/user-\\d+\\.slice)(/|$)");
+    const QRegularExpressionMatch &match = kUserSlice.match(cgroup);
+    return match.hasMatch() ? match.captured(1) : QString();
+}
+
+void PressureStats::setControlGroup(const QString &controlGroup)
+{
+    if (controlGroup == m_controlGroup)
+        return;
+    reset(m_cgroup);
+    m_controlGroup = controlGroup;
+}
+
+void PressureStats::update()
+{
+    qint64 now = m_clock.elapsed();
+    updateSource(m_system, false, now);
+    if (!m_controlGroup.isEmpty())
+        updateSource(m_cgroup, true, now);
+}
+
+void PressureStats::clear()
+{
+    reset(m_system);
+    reset(m_cgroup);
+}
+
+void PressureStats::reset(source_t &source)
+{
+    for (int i = 0; i < kPressureResourceCount; ++i) {
+        if (source.fds[i] >= 0)
+            close(source.fds[i]);
+        source.fds[i] = -1;
+        source.pressure[i] = {};
+    }
+    source.sampledAt = -1;
+}
+
+void PressureStats::updateSource(source_t &source, bool isCgroup, qint64 now)
+{
+    char buf[256];
+    for (int i = 0; i < kPressureResourceCount; ++i) {
+        PressureResource resource = PressureResource(i);
+        pressure_t &prev = source.pressure[i];
+        pressure_t pressure;
+        ssize_t n = readFile(source, isCgroup, resource, buf, sizeof(buf));
+        if (n <= 0 || !parsePressure(buf, size_t(n), pressure)) {
+            prev = {};
+            continue;
+        }
+
+        // totals are in us, the interval in ms
+        if (prev.valid && source.sampledAt >= 0 && now > source.sampledAt) {
+            qreal interval = qreal(now - source.sampledAt) * 1000.;
+            if (pressure.some.total >= prev.some.total)
+                pressure.someRate = qMin(100., qreal(pressure.some.total - prev.some.total) * 100. / interval);
+            if (pressure.full.total >= prev.full.total)
+                pressure.fullRate = qMin(100., qreal(pressure.full.total - prev.full.total) * 100. / interval);
+            pressure.hasRates = true;
+        }
+        prev = pressure;
+    }
+    source.sampledAt = now;
+}
+
+ssize_t PressureStats::readFile(source_t &source, bool isCgroup, PressureResource resource, char *buf, size_t size)
+{
+    int &fd = source.fds[resource];
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        if (fd < 0) {
+            char path[PATH_MAX];
+            if (isCgroup)
+                snprintf(path, sizeof(path), CGROUP2_ROOT "%s/%s", m_controlGroup.toLocal8Bit().constData(),
+                         kCgroupFileName[resource]);
+            else
+                snprintf(path, sizeof(path), "%s", kSystemFileName[resource]);
+            fd = open(path, O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                return -1;
+        }
+
+        ssize_t n;
+        do {
+            n = pread(fd, buf, size - 1, 0);
+        } while (n < 0 && errno == EINTR);
+        if (n >= 0) {
+            buf[n] = '\0';
+            return n;
+        }
+
+        // psi disabled at runtime, or the cgroup was removed (ENODEV) & may have been made again
+        close(fd);
+        fd = -1;
+    }
+    return -1;
+}
+
+// avgN=X.YY, the kernel prints 2 decimals
+static bool readAverage(Tokenizer &tok, const char *key, size_t keyLen, qreal &value)
+{
+    unsigned long long integer = 0;
+    unsigned long long fraction = 0;
+    if (!tok.consume(key, keyLen) || !tok.readU64(integer))
+        return false;
+
+    qreal scale = 1;
+    if (tok.consume('.')) {
+        const char *start = tok.pos();
+        if (!tok.readU64(fraction))
+            return false;
+        for (const char *p = start; p < tok.pos(); ++p)
+            scale *= 10;
+    }
+    value = qreal(integer) + qreal(fraction) / scale;
+    tok.skipBlanks();
+    return true;
+}
+
+bool PressureStats::parsePressure(const char *buf, size_t len, pressure_t &pressure)
+{
+    /*样例数据:
+        some avg10=0.00 avg60=0.12 avg300=0.05 total=2184765
+        full avg10=0.00 avg60=0.00 avg300=0.00 total=1052283
+    */
+    pressure = {};
+    bool hasSome = false;
+    Tokenizer tok(buf, len);
+    do {
+        pressure_line_t *line = nullptr;
+        if (tok.consume("some ", 5))
+            line = &pressure.some;
+        else if (tok.consume("full ", 5))
+            line = &pressure.full;
+        else
+            continue;
+
+        unsigned long long total = 0;
+        if (!readAverage(tok, "avg10=", 6, line->avg10) || !readAverage(tok, "avg60=", 6, line->avg60)
+            || !readAverage(tok, "avg300=", 7, line->avg300) || !tok.consume("total=", 6) || !tok.readU64(total))
+            return false;
+        line->total = total;
+        if (line == &pressure.some)
+            hasSome = true;
+        else
+            pressure.hasFull = true;
+    } while (tok.nextLine());
+
+    pressure.valid = hasSome;
+    return hasSome;
+}
+
+} // namespace pressure
+} // namespace common
@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PRESSURE_STATS_H
+#define PRESSURE_STATS_H
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include <sys/types.h>
+
+namespace common {
+namespace pressure {
+
+enum PressureResource {
+    kCpuPressure,
+    kMemoryPressure,
+    kIOPressure,
+
+    kPressureResourceCount
+};
+
+/**
+ * @brief One line of a pressure file, share of time tasks were stalled on the resource
+ */
+struct pressure_line_t {
+    qreal avg10 {}; // percent, kernel running averages over 10s, 60s & 300s
+    qreal avg60 {};
+    qreal avg300 {};
+    quint64 total {}; // stall time since boot, us
+};
+
+/**
+ * @brief Pressure stall information of a resource
+ */
+struct pressure_t {
+    pressure_line_t some; // at least one task stalled
+    pressure_line_t full; // all non idle tasks stalled at once
+    qreal someRate {}; // stall time since last sample, percent of the interval
+    qreal fullRate {};
+    bool hasFull {}; // no full line for system wide cpu before linux 5.13
+    bool hasRates {}; // false on the first sample
+    bool valid {}; // false without psi, e.g. psi=0 on the kernel command line
+};
+
+/**
+ * @brief Pressure stall information of the system & of one cgroup
+ *
+ * /proc/pressure/{cpu,memory,io} & the cpu.pressure, memory.pressure & io.pressure files of the
+ * cgroup are kept open & re-read with pread, they regenerate their content from offset 0.
+ * Stall rates are derived from the total counters, the kernel averages lag behind short stalls.
+ * Not thread safe.
+ */
+class PressureStats
+{
+public:
+    PressureStats();
+    ~PressureStats();
+
+    /**
+     * @brief Whether the kernel reports pressure stall information, linux 4.20 & later
+     */
+    static bool isAvailable();
+    /**
+     * @brief Session cgroup of the user, e.g. /user.slice/user-1000.slice of a process cgroup below it
+     * @return Empty if the cgroup is not in a user slice
+     */
+    static QString sessionCgroup(const QString &cgroup);
+
+    /**
+     * @brief Cgroup sampled besides the system, relative to the cgroup root, empty for none
+     */
+    void setControlGroup(const QString &controlGroup);
+    inline QString controlGroup() const { return m_controlGroup; }
+
+    /**
+     * @brief Read all pressure files, invalid figures of those that can't be read
+     */
+    void update();
+    inline const pressure_t &system(PressureResource resource) const { return m_system.pressure[resource]; }
+    inline const pressure_t &cgroup(PressureResource resource) const { return m_cgroup.pressure[resource]; }
+    /**
+     * @brief Close all descriptors & forget previous samples
+     */
+    void clear();
+
+    /**
+     * @brief Parse the some & full lines of pressure file content, rates are left alone
+     */
+    static bool parsePressure(const char *buf, size_t len, pressure_t &pressure);
+
+private:
+    PressureStats(const PressureStats &) = delete;
+    PressureStats &operator=(const PressureStats &) = delete;
+
+    struct source_t {
+        int fds[kPressureResourceCount];
+        pressure_t pressure[kPressureResourceCount];
+        qint64 sampledAt; // m_clock msecs, -1 before the first sample
+    };
+
+    void updateSource(source_t &source, bool isCgroup, qint64 now);
+    ssize_t readFile(source_t &source, bool isCgroup, PressureResource resource, char *buf, size_t size);
+    static void reset(source_t &source);
+
+private:
+    source_t m_system;
+    source_t m_cgroup;
+    QString m_controlGroup;
+    QElapsedTimer m_clock;
+};
+
+} // namespace pressure
+} // namespace common
+
+#endif // PRESSURE_STATS_H
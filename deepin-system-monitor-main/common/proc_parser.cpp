@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "proc_parser.h"
+
+namespace common {
+namespace parser {
+
+bool Tokenizer::nextLine()
+{
+    if (atEnd())
+        return false;
+
+    const char *nl = static_cast<const char *>(memchr(m_cur, '\n', size_t(m_end - m_cur)));
+    if (!nl) {
+        m_cur = m_end;
+        return false;
+    }
+    m_cur = nl + 1;
+    return m_cur < m_end;
+}
+
+bool Tokenizer::readToken(const char *&tok, size_t &len)
+{
+    skipBlanks();
+    if (m_cur >= m_end || isSpace(*m_cur))
+        return false;
+
+    tok = m_cur;
+    while (m_cur < m_end && !isSpace(*m_cur))
+        ++m_cur;
+    len = size_t(m_cur - tok);
+    return true;
+}
+
+bool Tokenizer::skipTokens(int n)
+{
+    const char *tok;
+    size_t len;
+    while (n-- > 0) {
+        if (!readToken(tok, len))
+            return false;
+    }
+    return true;
+}
+
+bool Tokenizer::readKey(const char *&key, size_t &len)
+{
+    skipSpaces();
+    if (m_cur >= m_end)
+        return false;
+
+    key = m_cur;
+    while (m_cur < m_end && *m_cur != ':' && *m_cur != '\n')
+        ++m_cur;
+    if (m_cur >= m_end || *m_cur != ':')
+        return false;
+
+    len = size_t(m_cur - key);
+    ++m_cur;
+    return true;
+}
+
+bool splitStatComm(const char *buf, size_t len, const char *&comm, size_t &commLen, const char *&rest)
+{
+    const char *begin = static_cast<const char *>(memchr(buf, '(', len));
+    if (!begin)
+        return false;
+
+    // last ')' in buffer
+    const char *end = buf + len;
+    const char *close = nullptr;
+    for (const char *p = end; p > begin;) {
+        if (*--p == ')') {
+            close = p;
+            break;
+        }
+    }
+    if (!close)
+        return false;
+
+    comm = begin + 1;
+    commLen = size_t(close - comm);
+    rest = close + 1;
+    return true;
+}
+
+} // namespace parser
+} // namespace common
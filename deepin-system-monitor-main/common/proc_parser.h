@@ -0,0 +1,215 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROC_PARSER_H
+#define PROC_PARSER_H
+
+#include <stddef.h>
+#include <string.h>
+
+namespace common {
+namespace parser {
+
+inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * @brief Zero allocation tokenizer over a fixed buffer of /proc text
+ *
+ * Number parsing is plain base 10 without locale lookups, tokens are returned
+ * as pointer & length into the source buffer. Field reads never cross a line break,
+ * use nextLine to move on.
+ */
+class Tokenizer
+{
+public:
+    Tokenizer(const char *buf, size_t len);
+    explicit Tokenizer(const char *str);
+
+    inline bool atEnd() const
+    {
+        return m_cur >= m_end;
+    }
+    inline const char *pos() const
+    {
+        return m_cur;
+    }
+    inline const char *end() const
+    {
+        return m_end;
+    }
+
+    /**
+     * @brief Skip spaces & tabs on current line
+     */
+    void skipBlanks();
+    /**
+     * @brief Skip all white spaces, line breaks included
+     */
+    void skipSpaces();
+    /**
+     * @brief Move to the beginning of next line
+     * @return false if there's no more lines
+     */
+    bool nextLine();
+    /**
+     * @brief Consume prefix if it's at current position
+     */
+    bool consume(const char *prefix, size_t len);
+    bool consume(char c);
+
+    bool readU64(unsigned long long &v);
+    bool readI64(long long &v);
+    bool readChar(char &c);
+    /**
+     * @brief Read blank separated token on current line
+     */
+    bool readToken(const char *&tok, size_t &len);
+    /**
+     * @brief Skip n blank separated tokens on current line
+     */
+    bool skipTokens(int n);
+    /**
+     * @brief Read key of "Key: value" styled line, e.g. /proc/meminfo & /proc/[pid]/io
+     */
+    bool readKey(const char *&key, size_t &len);
+
+    template<typename T>
+    inline bool readUInt(T &v)
+    {
+        unsigned long long t;
+        if (!readU64(t))
+            return false;
+        v = T(t);
+        return true;
+    }
+    template<typename T>
+    inline bool readInt(T &v)
+    {
+        long long t;
+        if (!readI64(t))
+            return false;
+        v = T(t);
+        return true;
+    }
+
+private:
+    const char *m_cur;
+    const char *m_end;
+};
+
+inline bool keyEquals(const char *key, size_t len, const char *expected, size_t expectedLen)
+{
+    return len == expectedLen && !memcmp(key, expected, len);
+}
+
+/**
+ * @brief Split /proc/[pid]/stat content around the comm field
+ *
+ * comm may contain spaces and parentheses, so it spans from the first '(' to the last ')'.
+ * @param buf Stat content
+ * @param len Content length
+ * @param comm Start of comm, without parentheses
+ * @param commLen Length of comm
+ * @param rest Start of field 3 (state)
+ * @return false if content is malformed
+ */
+bool splitStatComm(const char *buf, size_t len, const char *&comm, size_t &commLen, const char *&rest);
+
+inline Tokenizer::Tokenizer(const char *buf, size_t len)
+    : m_cur(buf)
+    , m_end(buf + len)
+{
+}
+
+inline Tokenizer::Tokenizer(const char *str)
+    : m_cur(str)
+    , m_end(str + strlen(str))
+{
+}
+
+inline void Tokenizer::skipBlanks()
+{
+    while (m_cur < m_end && isBlank(*m_cur))
+        ++m_cur;
+}
+
+inline void Tokenizer::skipSpaces()
+{
+    while (m_cur < m_end && isSpace(*m_cur))
+        ++m_cur;
+}
+
+inline bool Tokenizer::consume(const char *prefix, size_t len)
+{
+    if (size_t(m_end - m_cur) < len || memcmp(m_cur, prefix, len))
+        return false;
+    m_cur += len;
+    return true;
+}
+
+inline bool Tokenizer::consume(char c)
+{
+    if (m_cur >= m_end || *m_cur != c)
+        return false;
+    ++m_cur;
+    return true;
+}
+
+inline bool Tokenizer::readU64(unsigned long long &v)
+{
+    skipBlanks();
+    if (m_cur >= m_end || !isDigit(*m_cur))
+        return false;
+
+    unsigned long long n = 0;
+    while (m_cur < m_end && isDigit(*m_cur)) {
+        n = n * 10 + static_cast<unsigned long long>(*m_cur - '0');
+        ++m_cur;
+    }
+    v = n;
+    return true;
+}
+
+inline bool Tokenizer::readI64(long long &v)
+{
+    skipBlanks();
+    bool neg = false;
+    if (m_cur < m_end && (*m_cur == '-' || *m_cur == '+')) {
+        neg = (*m_cur == '-');
+        ++m_cur;
+    }
+
+    unsigned long long n;
+    if (!readU64(n))
+        return false;
+    v = neg ? -static_cast<long long>(n) : static_cast<long long>(n);
+    return true;
+}
+
+inline bool Tokenizer::readChar(char &c)
+{
+    skipBlanks();
+    if (m_cur >= m_end || isSpace(*m_cur))
+        return false;
+    c = *m_cur++;
+    return true;
+}
+
+} // namespace parser
+} // namespace common
+
+#endif // PROC_PARSER_H
@@ -0,0 +1,237 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "rapl_reader.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace common {
+namespace power {
+
+namespace {
+
+const char kZonePrefix[] = "intel-rapl:";
+
+// small sysfs attribute, trailing newline stripped
+bool readAttribute(const std::string &path, std::string &value)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    char buf[64];
+    ssize_t n = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (n <= 0)
+        return false;
+    while (n > 0 && (buf[n - 1] == '\n' || buf[n - 1] == ' '))
+        --n;
+    value.assign(buf, size_t(n));
+    return true;
+}
+
+bool readCounter(int fd, uint64_t &value)
+{
+    char buf[32];
+    ssize_t n = pread(fd, buf, sizeof(buf) - 1, 0);
+    if (n <= 0)
+        return false;
+    buf[n] = '\0';
+    char *end = nullptr;
+    errno = 0;
+    value = strtoull(buf, &end, 10);
+    return end != buf && errno == 0;
+}
+
+/**
+ * @brief Depth of a zone directory name, 1 for intel-rapl:0, 2 for intel-rapl:0:1, 0 for others
+ */
+int zoneDepth(const char *name)
+{
+    if (strncmp(name, kZonePrefix, sizeof(kZonePrefix) - 1) != 0)
+        return 0;
+    int depth = 1;
+    const char *p = name + sizeof(kZonePrefix) - 1;
+    if (!*p)
+        return 0;
+    for (; *p; ++p) {
+        if (*p == ':')
+            ++depth;
+        else if (*p < '0' || *p > '9')
+            return 0;
+    }
+    return depth;
+}
+
+double monotonicSeconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return double(ts.tv_sec) + double(ts.tv_nsec) / 1e9;
+}
+
+} // namespace
+
+RaplReader::RaplReader(const char *root)
+    : m_root(root)
+{
+}
+
+RaplReader::~RaplReader()
+{
+    closeZones();
+}
+
+void RaplReader::setCounterSource(const CounterSource &source)
+{
+    m_source = source;
+}
+
+bool RaplReader::isAvailable()
+{
+    // the source is only worth asking when the cpu has package zones we may not read
+    openZones();
+    bool hasPackage = false;
+    for (const zone_t &zone : m_zones) {
+        if (!zone.core && zone.fd >= 0)
+            return true;
+        hasPackage = hasPackage || !zone.core;
+    }
+    return hasPackage && m_source;
+}
+
+void RaplReader::openZones()
+{
+    if (m_opened)
+        return;
+    m_opened = true;
+
+    DIR *dir = opendir(m_root.c_str());
+    if (!dir)
+        return;
+    while (struct dirent *entry = readdir(dir)) {
+        const int depth = zoneDepth(entry->d_name);
+        if (depth != 1 && depth != 2)
+            continue;
+
+        const std::string path = m_root + "/" + entry->d_name;
+        std::string name;
+        if (!readAttribute(path + "/name", name))
+            continue;
+        // packages at the top, their cores below, psys / dram / uncore would count twice
+        const bool core = depth == 2;
+        if (core ? name != "core" : name.compare(0, 7, "package") != 0)
+            continue;
+
+        std::string range;
+        zone_t zone {entry->d_name, core, 0, -1};
+        if (readAttribute(path + "/max_energy_range_uj", range))
+            zone.range = strtoull(range.c_str(), nullptr, 10);
+        // root only since linux 5.10, the counter source is asked instead
+        zone.fd = open((path + "/energy_uj").c_str(), O_RDONLY | O_CLOEXEC);
+        m_zones.push_back(zone);
+    }
+    closedir(dir);
+}
+
+void RaplReader::closeZones()
+{
+    for (zone_t &zone : m_zones) {
+        if (zone.fd >= 0)
+            close(zone.fd);
+    }
+    m_zones.clear();
+    m_opened = false;
+}
+
+bool RaplReader::readCounters(rapl_sample_t &sample)
+{
+    openZones();
+    sample.counters.clear();
+    bool hasPackage = false;
+    for (const zone_t &zone : m_zones) {
+        rapl_counter_t counter;
+        if (zone.fd < 0 || !readCounter(zone.fd, counter.energy))
+            continue;
+        counter.name = zone.name;
+        counter.core = zone.core;
+        counter.range = zone.range;
+        hasPackage = hasPackage || !zone.core;
+        sample.counters.push_back(counter);
+    }
+    sample.time = monotonicSeconds();
+    return hasPackage;
+}
+
+bool RaplReader::read(rapl_power_t &power)
+{
+    rapl_sample_t sample;
+    if (!readCounters(sample) && !(m_source && m_source(sample))) {
+        m_last = rapl_sample_t();
+        m_hasPower = false;
+        return false;
+    }
+
+    // cached by the source, nothing new since the previous sample
+    if (m_last.time >= 0 && sample.time <= m_last.time) {
+        power = m_power;
+        return m_hasPower;
+    }
+
+    m_hasPower = m_last.time >= 0 && powerBetween(m_last, sample, m_power);
+    m_last = std::move(sample);
+    power = m_power;
+    return m_hasPower;
+}
+
+uint64_t RaplReader::energyDelta(uint64_t prev, uint64_t cur, uint64_t range)
+{
+    if (cur >= prev)
+        return cur - prev;
+    // wrapped, without a range the delta is unknown & taken as nothing
+    return range > prev ? range - prev + cur : 0;
+}
+
+bool RaplReader::powerBetween(const rapl_sample_t &prev, const rapl_sample_t &cur, rapl_power_t &power)
+{
+    const double secs = cur.time - prev.time;
+    power = rapl_power_t();
+    if (secs <= 0)
+        return false;
+
+    uint64_t package = 0;
+    uint64_t core = 0;
+    bool hasPackage = false;
+    bool hasCore = false;
+    // a handful of zones, no need for a map
+    for (const rapl_counter_t &counter : cur.counters) {
+        for (const rapl_counter_t &last : prev.counters) {
+            if (last.name != counter.name || last.core != counter.core)
+                continue;
+            const uint64_t delta = energyDelta(last.energy, counter.energy, counter.range);
+            if (counter.core) {
+                core += delta;
+                hasCore = true;
+            } else {
+                package += delta;
+                hasPackage = true;
+            }
+            break;
+        }
+    }
+    if (!hasPackage)
+        return false;
+    power.package = double(package) / 1e6 / secs;
+    if (hasCore)
+        power.core = double(core) / 1e6 / secs;
+    return true;
+}
+
+} // namespace power
+} // namespace common
@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef RAPL_READER_H
+#define RAPL_READER_H
+
+#include <stdint.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#define POWERCAP_PATH "/sys/class/powercap"
+
+namespace common {
+namespace power {
+
+/**
+ * @brief Energy counter of one RAPL zone
+ */
+struct rapl_counter_t {
+    std::string name; // zone directory, e.g. intel-rapl:0, intel-rapl:0:0 for its cores
+    bool core {false}; // core subzone of a package, the package itself otherwise
+    uint64_t energy {0}; // energy_uj
+    uint64_t range {0}; // max_energy_range_uj, energy wraps to 0 past it
+};
+
+/**
+ * @brief Counters of all zones read at once
+ */
+struct rapl_sample_t {
+    std::vector<rapl_counter_t> counters;
+    double time {-1}; // CLOCK_MONOTONIC s of the read
+};
+
+/**
+ * @brief Power drawn between two samples, W
+ */
+struct rapl_power_t {
+    double package {-1}; // all packages summed, -1 unknown
+    double core {-1}; // cores of all packages, -1 if no package reports them
+};
+
+/**
+ * @brief Package & core power from the RAPL energy counters of powercap
+ *
+ * Intel & AMD (family 17h on) cpus both report through the intel-rapl powercap zones: the top
+ * level zones are the packages, their "core" subzones the cores. psys & uncore / dram zones are
+ * left out, psys overlaps the packages. energy_uj files are kept open & re-read with pread.
+ * Since linux 5.10 energy_uj is readable by root only, a counter source, e.g. the system server,
+ * is asked then. Not thread safe.
+ */
+class RaplReader
+{
+public:
+    using CounterSource = std::function<bool(rapl_sample_t &sample)>;
+
+    explicit RaplReader(const char *root = POWERCAP_PATH);
+    ~RaplReader();
+
+    RaplReader(const RaplReader &) = delete;
+    RaplReader &operator=(const RaplReader &) = delete;
+
+    /**
+     * @brief Counters asked when the zones can't be read directly, none by default
+     */
+    void setCounterSource(const CounterSource &source);
+
+    /**
+     * @brief Whether package energy can be read, directly or from the counter source when
+     * package zones exist but aren't readable
+     */
+    bool isAvailable();
+
+    /**
+     * @brief Power since the previous sample
+     * @return false on the first sample & while no counters can be read; a source sample not
+     * newer than the previous one, e.g. cached by the server, repeats the previous power
+     */
+    bool read(rapl_power_t &power);
+
+    /**
+     * @brief Read the counters of all zones directly
+     * @return false if no package zone is readable
+     */
+    bool readCounters(rapl_sample_t &sample);
+
+    /**
+     * @brief Energy consumed from \a prev to \a cur, a counter wrapped once past \a range
+     */
+    static uint64_t energyDelta(uint64_t prev, uint64_t cur, uint64_t range);
+    /**
+     * @brief Power from counters matched by zone name, zones missing from either sample are skipped
+     */
+    static bool powerBetween(const rapl_sample_t &prev, const rapl_sample_t &cur, rapl_power_t &power);
+
+private:
+    struct zone_t {
+        std::string name;
+        bool core;
+        uint64_t range;
+        int fd;
+    };
+
+    void openZones();
+    void closeZones();
+
+    std::string m_root;
+    std::vector<zone_t> m_zones;
+    bool m_opened {false};
+    CounterSource m_source;
+    rapl_sample_t m_last;
+    rapl_power_t m_power;
+    bool m_hasPower {false};
+};
+
+} // namespace power
+} // namespace common
+
+#endif // RAPL_READER_H
@@ -0,0 +1,189 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "record_writer.h"
+
+#include <QFileInfo>
+#include <QIODevice>
+
+#include <cmath>
+
+#include <stdio.h>
+
+namespace common {
+namespace record {
+
+RecordWriter::RecordWriter(QIODevice *device, Format format, const QStringList &fields)
+    : m_device(device)
+    , m_format(format)
+{
+    m_buffer.reserve(kFlushSize + 4096);
+    for (int i = 0; i < fields.size(); ++i) {
+        const QByteArray &name = fields[i].toUtf8();
+        if (m_format == kJsonLines) {
+            QByteArray key;
+            appendJson(key, name.constData(), name.size());
+            key.append(':');
+            m_keys << key;
+            continue;
+        }
+        if (i > 0)
+            m_buffer.append(',');
+        appendCsv(m_buffer, name.constData(), name.size());
+    }
+    // the header line isn't a record
+    if (m_format == kCsv)
+        m_buffer.append('\n');
+    m_fieldCount = fields.size();
+}
+
+RecordWriter::~RecordWriter()
+{
+    finish();
+}
+
+RecordWriter::Format RecordWriter::formatOf(const QString &path)
+{
+    const QString &suffix = QFileInfo(path).suffix().toLower();
+    return suffix == "jsonl" || suffix == "ndjson" || suffix == "json" ? kJsonLines : kCsv;
+}
+
+void RecordWriter::appendCsv(QByteArray &out, const char *text, int size)
+{
+    bool quote = size > 0 && (text[0] == ' ' || text[size - 1] == ' ');
+    for (int i = 0; i < size && !quote; ++i)
+        quote = text[i] == ',' || text[i] == '"' || text[i] == '\n' || text[i] == '\r';
+    if (!quote) {
+        out.append(text, size);
+        return;
+    }
+    out.append('"');
+    for (int i = 0; i < size; ++i) {
+        if (text[i] == '"')
+            out.append('"');
+        out.append(text[i]);
+    }
+    out.append('"');
+}
+
+void RecordWriter::appendJson(QByteArray &out, const char *text, int size)
+{
+    out.append('"');
+    for (int i = 0; i < size; ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        switch (c) {
+        case '"':
+            out.append("\\\"", 2);
+            break;
+        case '\\':
+            out.append("\\\\", 2);
+            break;
+        case '\n':
+            out.append("\\n", 2);
+            break;
+        case '\r':
+            out.append("\\r", 2);
+            break;
+        case '\t':
+            out.append("\\t", 2);
+            break;
+        default:
+            if (c < 0x20) {
+                char escaped[8];
+                out.append(escaped, snprintf(escaped, sizeof(escaped), "\\u%04x", c));
+            } else {
+                // utf-8 is passed through
+                out.append(char(c));
+            }
+        }
+    }
+    out.append('"');
+}
+
+void RecordWriter::beginField()
+{
+    if (m_format == kJsonLines) {
+        m_buffer.append(m_field == 0 ? '{' : ',');
+        if (m_field < m_keys.size())
+            m_buffer.append(m_keys[m_field]);
+        else
+            m_buffer.append("\"\":", 3);
+    } else if (m_field > 0) {
+        m_buffer.append(',');
+    }
+    ++m_field;
+}
+
+void RecordWriter::add(const QString &text)
+{
+    const QByteArray &utf8 = text.toUtf8();
+    add(utf8.constData(), utf8.size());
+}
+
+void RecordWriter::add(const char *text, int size)
+{
+    beginField();
+    if (m_format == kJsonLines)
+        appendJson(m_buffer, text, size);
+    else
+        appendCsv(m_buffer, text, size);
+}
+
+void RecordWriter::appendNumber(const char *text, int size)
+{
+    beginField();
+    m_buffer.append(text, size);
+}
+
+void RecordWriter::add(qint64 value)
+{
+    char text[24];
+    appendNumber(text, snprintf(text, sizeof(text), "%lld", static_cast<long long>(value)));
+}
+
+void RecordWriter::add(double value)
+{
+    if (!std::isfinite(value)) {
+        beginField();
+        if (m_format == kJsonLines)
+            m_buffer.append("null", 4);
+        return;
+    }
+    // 12 significant digits, 12.5 rather than 12.500000000000002
+    char text[32];
+    appendNumber(text, snprintf(text, sizeof(text), "%.12g", value));
+}
+
+bool RecordWriter::endRecord()
+{
+    if (m_format == kJsonLines) {
+        m_buffer.append(m_field == 0 ? "{}\n" : "}\n");
+    } else {
+        while (m_field < m_fieldCount)
+            beginField();
+        m_buffer.append('\n');
+    }
+    m_field = 0;
+    ++m_records;
+    if (m_buffer.size() >= kFlushSize)
+        return flush();
+    return m_ok;
+}
+
+bool RecordWriter::flush()
+{
+    if (m_ok && !m_buffer.isEmpty())
+        m_ok = m_device->write(m_buffer) == m_buffer.size();
+    // keeps the reserved capacity
+    m_buffer.resize(0);
+    return m_ok;
+}
+
+bool RecordWriter::finish()
+{
+    return flush();
+}
+
+} // namespace record
+} // namespace common
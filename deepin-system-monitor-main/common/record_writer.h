@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef RECORD_WRITER_H
+#define RECORD_WRITER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QIODevice;
+
+namespace common {
+namespace record {
+
+/**
+ * @brief Streaming writer of flat records as CSV or JSON lines
+ *
+ * Fields are serialized straight into a byte buffer written to the device in large chunks,
+ * nothing is kept per record, so millions of records take as little memory as one. CSV gets
+ * a header line of the field names, JSON lines an object per record keyed by them. Text is
+ * quoted or escaped as needed, NaN numbers are empty in CSV & null in JSON. Not thread safe.
+ */
+class RecordWriter
+{
+public:
+    enum Format {
+        kCsv,
+        kJsonLines
+    };
+
+    // buffered bytes written in one go
+    static constexpr int kFlushSize = 1 << 20;
+
+    /**
+     * @brief Writer of records of \a fields to \a device, which must be open for writing
+     */
+    RecordWriter(QIODevice *device, Format format, const QStringList &fields);
+    ~RecordWriter();
+
+    RecordWriter(const RecordWriter &) = delete;
+    RecordWriter &operator=(const RecordWriter &) = delete;
+
+    /**
+     * @brief Format of a file name, JSON lines for .jsonl, .ndjson & .json, CSV otherwise
+     */
+    static Format formatOf(const QString &path);
+
+    // fields of the current record, in the order of the field names
+    void add(const QString &text);
+    void add(const char *text, int size);
+    void add(qint64 value);
+    void add(double value);
+
+    /**
+     * @brief End the current record, missing fields are left empty
+     * @return false once writing to the device failed
+     */
+    bool endRecord();
+    /**
+     * @brief Write the buffered records
+     * @return false if any write failed
+     */
+    bool finish();
+
+    inline qint64 records() const { return m_records; }
+
+    // serialized text fields, for the tests
+    static void appendCsv(QByteArray &out, const char *text, int size);
+    static void appendJson(QByteArray &out, const char *text, int size);
+
+private:
+    void beginField();
+    void appendNumber(const char *text, int size);
+    bool flush();
+
+    QIODevice *m_device;
+    Format m_format;
+    QVector<QByteArray> m_keys; // "name": of each field, JSON lines only
+    QByteArray m_buffer;
+    int m_fieldCount {0};
+    int m_field {0}; // next field of the current record
+    qint64 m_records {0};
+    bool m_ok {true};
+};
+
+} // namespace record
+} // namespace common
+
+#endif // RECORD_WRITER_H
@@ -9,8 +9,10 @@
 #include "time_period.h"
 #include "common/common.h"
 
+#include <QPair>
+
 #include <memory>
-#include <list>
+#include <vector>
 
 #include <sys/time.h>
 
@@ -73,6 +75,14 @@ struct IOPS {
     qreal outBps;
 };
 
+struct IOLatency {
+    qreal await; // average request time (ms)
+    qreal svctm; // average service time (ms)
+    qreal util; // busy time percentage
+    qreal queueDepth; // average queue depth
+    qreal discardBps; // discarded bytes per second
+};
+
 template<typename T>
 class SampleFrame
 {
@@ -276,43 +286,47 @@ public:
     qulonglong data;
 };
 
+/**
+ * @brief Fixed capacity ring buffer of sample frames
+ *
+ * Frames are stored by value in one contiguous block sized from TimePeriod::ticks,
+ * the oldest frame is overwritten once the buffer is full.
+ */
 template<typename T>
 class Sample
 {
 public:
     explicit Sample()
-        : m_samples {}
+        : m_frames {}
         , m_period {}
+        , m_head {0}
         , m_maxSamples {}
     {
         m_maxSamples = m_period.ticks();
+        m_frames.reserve(m_maxSamples);
     }
     explicit Sample(const TimePeriod &period)
-        : m_samples {}
+        : m_frames {}
         , m_period {period}
+        , m_head {0}
         , m_maxSamples {}
     {
         m_maxSamples = m_period.ticks();
+        m_frames.reserve(m_maxSamples);
     }
-    Sample(const Sample &other)
-        : m_period(other.m_period)
-        , m_maxSamples(other.m_maxSamples)
-    {
-        for (auto &item : other.m_samples) {
-            m_samples.push_back(std::make_shared<SampleFrame<T>>(*item));
-        }
-        m_maxSamples = m_period.ticks();
-    }
+    Sample(const Sample &other) = default;
 
-    inline void addSample(SampleFrame<T> *frame)
+    inline void addSample(const SampleFrame<T> &frame)
     {
-        if (frame) {
-            if (m_samples.size() >= m_maxSamples)
-                m_samples.pop_front();
+        if (m_maxSamples == 0)
+            return;
 
-            std::shared_ptr<SampleFrame<T>> framePtr;
-            framePtr.reset(frame);
-            m_samples.push_back(framePtr);
+        if (m_frames.size() < m_maxSamples) {
+            m_frames.push_back(frame);
+        } else {
+            // overwrite oldest frame in place
+            m_frames[m_head] = frame;
+            m_head = (m_head + 1) % m_frames.size();
         }
     }
 
@@ -323,24 +337,27 @@ public:
 
     inline const SampleFrame<T> *recentSample() const
     {
-        if (m_samples.size() > 0)
-            return m_samples.last().get();
-        else
-            return nullptr;
+        return sample(count() - 1);
     }
 
     inline void updateTimePeriod(const TimePeriod &newPeriod)
     {
         auto ticks = newPeriod.ticks();
-        auto old = m_period.ticks();
 
         if (timercmp(&newPeriod.interval(), &m_period.interval(), !=)) {
-            m_samples.clear();
-        } else if (ticks < old) {
-            while (m_samples.size() > ticks) {
-                m_samples.pop_front();
-            }
+            m_frames.clear();
+            m_head = 0;
+        } else if (ticks != m_maxSamples) {
+            // keep newest frames in chronological order
+            std::vector<SampleFrame<T>> frames;
+            frames.reserve(ticks);
+            size_t n = m_frames.size();
+            for (size_t i = (n > ticks) ? n - ticks : 0; i < n; ++i)
+                frames.push_back(m_frames[(m_head + i) % n]);
+            m_frames.swap(frames);
+            m_head = 0;
         }
+        m_frames.reserve(ticks);
         m_maxSamples = ticks;
         m_period = newPeriod;
     }
@@ -348,39 +365,40 @@ public:
     inline const QPair<const SampleFrame<T> *, const SampleFrame<T> *> recentSamplePair() const
     {
         QPair<const SampleFrame<T> *, const SampleFrame<T> *> pair {};
-        if (m_samples.size() > 0)
-            pair.first = m_samples[0].get();
-        if (m_samples.size() > 1)
-            pair.second = m_samples[1].get();
+        pair.first = sample(0);
+        pair.second = sample(1);
         return pair;
     }
 
     inline int count() const
     {
-        return m_samples.size();
+        return int(m_frames.size());
     }
 
     inline const SampleFrame<T> *sample(int index) const
     {
-        if (index >= 0 && index < m_samples.size()) {
-            return m_samples[index].get();
+        if (index >= 0 && index < count()) {
+            return &m_frames[(m_head + size_t(index)) % m_frames.size()];
         }
 
         return nullptr;
     }
 
 private:
-    // TODO: replace with circular buffer impl. (ref: boost/circular_buffer)
-    QList<std::shared_ptr<SampleFrame<T>>> m_samples;
+    std::vector<SampleFrame<T>> m_frames;
     TimePeriod m_period;
+    // index of the oldest frame once the buffer is full
+    size_t m_head;
     size_t m_maxSamples;
 };
 
 using IOSampleFrame = SampleFrame<IO>;
 using DISKIOSampleFrame = SampleFrame<DiskIO>;
 using IOPSSampleFrame = SampleFrame<IOPS>;
+using IOLatencySampleFrame = SampleFrame<IOLatency>;
 using IOSample = Sample<IO>;
 using DISKIOSample = Sample<DiskIO>;
 using IOPSSample = Sample<IOPS>;
+using IOLatencySample = Sample<IOLatency>;
 
 #endif // SAMPLE_H
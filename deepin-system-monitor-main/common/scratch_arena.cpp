@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "scratch_arena.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace common {
+namespace alloc {
+
+ScratchArena &ScratchArena::local()
+{
+    static thread_local ScratchArena arena;
+    return arena;
+}
+
+void *ScratchArena::allocate(size_t size, size_t align)
+{
+    while (m_current < m_blocks.size()) {
+        block_t &block = m_blocks[m_current];
+        uintptr_t base = uintptr_t(block.data.get());
+        uintptr_t aligned = (base + m_offset + align - 1) & ~(uintptr_t(align) - 1);
+        size_t start = size_t(aligned - base);
+        if (start + size <= block.size) {
+            m_used += start + size - m_offset;
+            m_offset = start + size;
+            return block.data.get() + start;
+        }
+        // rest of the block is left unused until reset
+        ++m_current;
+        m_offset = 0;
+    }
+
+    size_t blockSize = size + align > kBlockSize ? size + align : kBlockSize;
+    m_blocks.push_back({std::unique_ptr<char[]>(new char[blockSize]), blockSize});
+    m_current = m_blocks.size() - 1;
+    return allocate(size, align);
+}
+
+const char *ScratchArena::readFile(const char *path, size_t &len)
+{
+    len = 0;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return nullptr;
+
+    size_t cap = 4096;
+    char *buf = buffer(cap);
+    for (;;) {
+        ssize_t n = read(fd, buf + len, cap - len - 1);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            int err = errno;
+            close(fd);
+            errno = err;
+            return nullptr;
+        }
+        if (n == 0)
+            break;
+
+        len += size_t(n);
+        if (len + 1 == cap) {
+            char *grown = buffer(cap * 2);
+            memcpy(grown, buf, len);
+            buf = grown;
+            cap *= 2;
+        }
+    }
+    close(fd);
+    buf[len] = '\0';
+    return buf;
+}
+
+void ScratchArena::reset()
+{
+    // a pass that needed several blocks gets one block holding them all next time
+    if (m_blocks.size() > 1) {
+        size_t total = capacity();
+        m_blocks.clear();
+        m_blocks.push_back({std::unique_ptr<char[]>(new char[total]), total});
+    }
+    m_current = 0;
+    m_offset = 0;
+    m_used = 0;
+}
+
+size_t ScratchArena::capacity() const
+{
+    size_t total = 0;
+    for (const block_t &block : m_blocks)
+        total += block.size;
+    return total;
+}
+
+} // namespace alloc
+} // namespace common
@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <stddef.h>
+
+namespace common {
+namespace alloc {
+
+/**
+ * @brief Per thread monotonic arena for scratch buffers & records of one sampling pass
+ *
+ * Allocation bumps a pointer, nothing is freed until reset(), which keeps the memory for the
+ * next pass. Blocks added during a pass are merged into one on reset, so a thread settles on a
+ * single block sized for its largest pass & stops touching the heap. Memory handed out is only
+ * valid until the next reset of the thread's arena, results outliving the pass are copied out.
+ */
+class ScratchArena
+{
+public:
+    ScratchArena() = default;
+
+    /**
+     * @brief Arena of the calling thread, reset by the refresh scheduler after each producer
+     */
+    static ScratchArena &local();
+
+    void *allocate(size_t size, size_t align = alignof(max_align_t));
+    inline char *buffer(size_t size)
+    {
+        return static_cast<char *>(allocate(size, 1));
+    }
+    /**
+     * @brief Scratch record, its destructor is never run so only trivial ones are allowed
+     */
+    template<typename T, typename... Args>
+    T *create(Args &&...args)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "arena records are never destroyed");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Read a whole file, procfs files don't tell their size beforehand
+     * @param len Bytes read, the content is NUL terminated past them
+     * @return Content, null on failure with errno set
+     */
+    const char *readFile(const char *path, size_t &len);
+
+    /**
+     * @brief Drop everything allocated since last reset
+     */
+    void reset();
+
+    /**
+     * @brief Bytes handed out since last reset, alignment padding included
+     */
+    inline size_t used() const
+    {
+        return m_used;
+    }
+    size_t capacity() const;
+
+    static constexpr size_t kBlockSize = 64 << 10;
+
+private:
+    ScratchArena(const ScratchArena &) = delete;
+    ScratchArena &operator=(const ScratchArena &) = delete;
+
+    struct block_t {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    std::vector<block_t> m_blocks;
+    size_t m_current {0}; // block being filled
+    size_t m_offset {0}; // first free byte of it
+    size_t m_used {0};
+};
+
+} // namespace alloc
+} // namespace common
+
+#endif // SCRATCH_ARENA_H
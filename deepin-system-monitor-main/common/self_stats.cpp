@@ -0,0 +1,199 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "self_stats.h"
+#include "proc_parser.h"
+
+#include <algorithm>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <malloc.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace common::parser;
+
+namespace common {
+namespace selfstats {
+
+namespace {
+
+ssize_t readFile(const std::string &path, char *buf, size_t size)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return -1;
+    ssize_t nr = read(fd, buf, size - 1);
+    close(fd);
+    if (nr < 0)
+        return -1;
+    buf[nr] = '\0';
+    return nr;
+}
+
+int64_t monotonicMs()
+{
+    timespec ts {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+void sampleHeap(SelfStatsReport &report)
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 mi = mallinfo2();
+#else
+    // int fields, wrap past 2G
+    struct mallinfo mi = mallinfo();
+#endif
+    report.heapInUse = uint64_t(mi.uordblks) + uint64_t(mi.hblkhd);
+    report.heapMapped = uint64_t(mi.arena) + uint64_t(mi.hblkhd);
+}
+
+} // namespace
+
+SelfStatsSampler::SelfStatsSampler(const std::string &procDir)
+    : m_procDir(procDir)
+    , m_lastSample(0)
+{
+    long hz = sysconf(_SC_CLK_TCK);
+    m_clockTicks = hz > 0 ? hz : 100;
+    long pageSize = sysconf(_SC_PAGESIZE);
+    m_pageKB = pageSize > 0 ? uint64_t(pageSize) / 1024 : 4;
+}
+
+bool SelfStatsSampler::parseTaskStat(const char *buf, size_t len, std::string &name, unsigned long long &ticks)
+{
+    const char *comm = nullptr;
+    const char *rest = nullptr;
+    size_t commLen = 0;
+    if (!splitStatComm(buf, len, comm, commLen, rest))
+        return false;
+
+    // field 3 (state) onwards, utime & stime are fields 14 & 15
+    Tokenizer tok(rest, size_t(buf + len - rest));
+    unsigned long long utime = 0, stime = 0;
+    if (!tok.skipTokens(11) || !tok.readU64(utime) || !tok.readU64(stime))
+        return false;
+
+    name.assign(comm, commLen);
+    ticks = utime + stime;
+    return true;
+}
+
+bool SelfStatsSampler::parseVoluntarySwitches(const char *buf, size_t len, unsigned long long &switches)
+{
+    static const char kKey[] = "voluntary_ctxt_switches";
+    Tokenizer tok(buf, len);
+    do {
+        const char *key = nullptr;
+        size_t keyLen = 0;
+        if (tok.readKey(key, keyLen) && keyEquals(key, keyLen, kKey, sizeof(kKey) - 1))
+            return tok.readU64(switches);
+    } while (tok.nextLine());
+    return false;
+}
+
+bool SelfStatsSampler::sample(SelfStatsReport &report)
+{
+    std::string taskDir = m_procDir + "/task";
+    DIR *dir = opendir(taskDir.c_str());
+    if (!dir)
+        return false;
+
+    int64_t now = monotonicMs();
+    report = SelfStatsReport();
+    report.interval = m_lastSample > 0 ? now - m_lastSample : 0;
+    double seconds = double(report.interval) / 1000.;
+
+    std::unordered_map<int, TaskState> tasks;
+    tasks.reserve(m_tasks.size());
+    char buf[2048];
+    struct dirent *entry;
+    while ((entry = readdir(dir))) {
+        if (!isDigit(entry->d_name[0]))
+            continue;
+        int tid = atoi(entry->d_name);
+        std::string path = taskDir + "/" + entry->d_name;
+
+        ThreadUsage usage;
+        usage.tid = tid;
+        TaskState state {0, 0};
+        ssize_t nr = readFile(path + "/stat", buf, sizeof(buf));
+        if (nr <= 0 || !parseTaskStat(buf, size_t(nr), usage.name, state.ticks))
+            continue;
+        nr = readFile(path + "/status", buf, sizeof(buf));
+        if (nr > 0)
+            parseVoluntarySwitches(buf, size_t(nr), state.switches);
+        tasks[tid] = state;
+
+        // threads started since previous sample have no base to diff against
+        auto it = m_tasks.find(tid);
+        if (seconds > 0 && it != m_tasks.end()) {
+            if (state.ticks >= it->second.ticks)
+                usage.cpuPercent = double(state.ticks - it->second.ticks) * 100. / double(m_clockTicks) / seconds;
+            if (state.switches >= it->second.switches)
+                usage.wakeupsPerSec = double(state.switches - it->second.switches) / seconds;
+        }
+        report.cpuPercent += usage.cpuPercent;
+        report.wakeupsPerSec += usage.wakeupsPerSec;
+        report.threads.push_back(usage);
+    }
+    closedir(dir);
+
+    std::sort(report.threads.begin(), report.threads.end(), [](const ThreadUsage &a, const ThreadUsage &b) {
+        return a.cpuPercent != b.cpuPercent ? a.cpuPercent > b.cpuPercent : a.tid < b.tid;
+    });
+    m_tasks.swap(tasks);
+    m_lastSample = now;
+
+    ssize_t nr = readFile(m_procDir + "/statm", buf, sizeof(buf));
+    unsigned long long pages = 0;
+    Tokenizer tok(buf, nr > 0 ? size_t(nr) : 0);
+    if (tok.skipTokens(1) && tok.readU64(pages))
+        report.rss = pages * m_pageKB;
+
+    sampleHeap(report);
+    sampleStages(report);
+    return true;
+}
+
+void SelfStatsSampler::sampleStages(SelfStatsReport &report)
+{
+    trace::StageStats totals[trace::kStageCount];
+    for (const trace::ThreadStats &thread : trace::collectStats()) {
+        for (int i = 0; i < trace::kStageCount; ++i) {
+            totals[i].count += thread.stages[i].count;
+            totals[i].totalNs += thread.stages[i].totalNs;
+            totals[i].maxNs = std::max(totals[i].maxNs, thread.stages[i].maxNs);
+        }
+    }
+
+    for (int i = 0; i < trace::kStageCount; ++i) {
+        StageUsage &usage = report.stages[i];
+        usage.count = totals[i].count - m_stages[i].count;
+        if (usage.count > 0)
+            usage.avgMs = double(totals[i].totalNs - m_stages[i].totalNs) / double(usage.count) / 1e6;
+        usage.maxMs = double(totals[i].maxNs) / 1e6;
+        m_stages[i] = totals[i];
+    }
+}
+
+double samplingTimePerRefresh(const SelfStatsReport &report, double refreshMs, const std::string &samplerThread)
+{
+    const StageUsage &scan = report.stages[trace::kStageScan];
+    if (scan.count > 0)
+        return scan.avgMs;
+
+    for (const ThreadUsage &thread : report.threads) {
+        if (thread.name == samplerThread)
+            return thread.cpuPercent / 100. * refreshMs;
+    }
+    return 0;
+}
+
+} // namespace selfstats
+} // namespace common
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SELF_STATS_H
+#define SELF_STATS_H
+
+#include "perf_trace.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <stdint.h>
+
+namespace common {
+namespace selfstats {
+
+struct ThreadUsage {
+    int tid {0};
+    std::string name;
+    double cpuPercent {0}; // % of one cpu
+    double wakeupsPerSec {0}; // voluntary context switches, the thread slept & was woken up
+};
+
+struct StageUsage {
+    uint64_t count {0}; // calls since previous sample
+    double avgMs {0};
+    double maxMs {0}; // since the stage first ran
+};
+
+/**
+ * @brief Overhead of the monitor itself between two samples
+ */
+struct SelfStatsReport {
+    int64_t interval {0}; // ms since previous sample, rates are 0 on the first one
+    std::vector<ThreadUsage> threads; // busiest first
+    double cpuPercent {0};
+    double wakeupsPerSec {0};
+    uint64_t rss {0}; // kB
+    uint64_t heapInUse {0}; // bytes handed out by malloc
+    uint64_t heapMapped {0}; // bytes malloc got from the kernel
+    StageUsage stages[trace::kStageCount];
+};
+
+/**
+ * @brief Samples /proc/self/task & the stage tracer into a SelfStatsReport
+ */
+class SelfStatsSampler
+{
+public:
+    explicit SelfStatsSampler(const std::string &procDir = "/proc/self");
+
+    bool sample(SelfStatsReport &report);
+
+    /**
+     * @brief Parse comm & utime + stime of /proc/[pid]/task/[tid]/stat
+     */
+    static bool parseTaskStat(const char *buf, size_t len, std::string &name, unsigned long long &ticks);
+    /**
+     * @brief Parse voluntary_ctxt_switches of /proc/[pid]/task/[tid]/status
+     */
+    static bool parseVoluntarySwitches(const char *buf, size_t len, unsigned long long &switches);
+
+private:
+    struct TaskState {
+        unsigned long long ticks;
+        unsigned long long switches;
+    };
+
+    void sampleStages(SelfStatsReport &report);
+
+    std::string m_procDir;
+    std::unordered_map<int, TaskState> m_tasks;
+    trace::StageStats m_stages[trace::kStageCount];
+    int64_t m_lastSample;
+    long m_clockTicks;
+    uint64_t m_pageKB;
+};
+
+/**
+ * @brief Time spent per refresh sampling, ms
+ *
+ * The traced scan stage when the tracer is compiled in, otherwise CPU time of the sampling thread.
+ */
+double samplingTimePerRefresh(const SelfStatsReport &report, double refreshMs, const std::string &samplerThread);
+
+} // namespace selfstats
+} // namespace common
+
+#endif // SELF_STATS_H
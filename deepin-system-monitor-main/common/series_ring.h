@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SERIES_RING_H
+#define SERIES_RING_H
+
+#include <algorithm>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace common {
+namespace core {
+
+/**
+ * @brief Fixed size history of numeric samples, the oldest sample is dropped when full
+ *
+ * The running max of the held samples is kept in a monotonic deque, so push & max are amortized
+ * O(1) instead of rescanning the history on every sample. Samples are numbered by a sequence that
+ * keeps growing across evictions, consumers use it to tell how far the series shifted.
+ */
+class SeriesRing
+{
+public:
+    explicit SeriesRing(size_t capacity)
+        : m_slots(capacity > 0 ? capacity : 1)
+    {
+    }
+
+    inline size_t capacity() const { return m_slots.size(); }
+    inline size_t size() const { return m_size; }
+    inline bool empty() const { return m_size == 0; }
+
+    /**
+     * @brief Sequence number the next pushed sample gets, sample i is numbered seq() - size() + i
+     */
+    inline uint64_t seq() const { return m_seq; }
+
+    /**
+     * @brief Append sample, evicting the oldest one when full
+     */
+    inline void push(double value)
+    {
+        size_t cap = m_slots.size();
+        if (m_size == cap) {
+            m_head = (m_head + 1) % cap;
+            --m_size;
+        }
+        m_slots[(m_head + m_size) % cap] = value;
+        ++m_size;
+
+        // older samples not larger than the new one can never be the max again
+        while (!m_max.empty() && m_max.back().second <= value)
+            m_max.pop_back();
+        m_max.emplace_back(m_seq, value);
+        ++m_seq;
+        while (m_max.front().first < m_seq - m_size)
+            m_max.pop_front();
+    }
+
+    /**
+     * @brief Sample i, 0 is the oldest held
+     */
+    inline double at(size_t i) const { return m_slots[(m_head + i) % m_slots.size()]; }
+    inline double last() const { return at(m_size - 1); }
+    /**
+     * @brief Sample i steps back from the newest, 0 when not held
+     */
+    inline double recent(size_t i) const { return i < m_size ? at(m_size - 1 - i) : 0.; }
+
+    /**
+     * @brief Largest sample held, 0 when empty
+     */
+    inline double max() const { return m_max.empty() ? 0. : m_max.front().second; }
+
+    /**
+     * @brief Turn the held samples into samples of another cadence, ratio is the new interval over the old one
+     *
+     * The newest sample stays, older ones are interpolated linearly at multiples of the new interval,
+     * as many as the held span & the capacity allow. The sequence jumps past the capacity, so followers
+     * see a gap & rebuild instead of appending to what they drew at the old cadence.
+     */
+    inline void resample(double ratio)
+    {
+        if (m_size == 0 || !(ratio > 0) || ratio == 1.)
+            return;
+
+        // ages in old samples back from the newest
+        size_t count = std::min(m_slots.size(), size_t(double(m_size - 1) / ratio) + 1);
+        std::vector<double> values(count);
+        for (size_t j = 0; j < count; ++j) {
+            double age = std::min(double(m_size - 1), j * ratio);
+            size_t lo = size_t(age);
+            size_t hi = std::min(lo + 1, m_size - 1);
+            double t = age - double(lo);
+            values[j] = recent(lo) * (1. - t) + recent(hi) * t;
+        }
+
+        clear();
+        m_seq += m_slots.size();
+        for (size_t j = count; j-- > 0;)
+            push(values[j]);
+    }
+
+    inline void clear()
+    {
+        m_head = 0;
+        m_size = 0;
+        m_max.clear();
+    }
+
+private:
+    std::vector<double> m_slots;
+    size_t m_head {0};
+    size_t m_size {0};
+    uint64_t m_seq {0};
+    // (seq, value) with decreasing values, front is the max
+    std::deque<std::pair<uint64_t, double>> m_max;
+};
+
+} // namespace core
+} // namespace common
+
+#endif // SERIES_RING_H
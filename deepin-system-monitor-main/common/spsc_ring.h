@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+
+#include <stddef.h>
+
+namespace common {
+namespace core {
+
+/**
+ * @brief Bounded lock free single producer single consumer ring
+ *
+ * Slots are preallocated, T must be trivially copyable. Capacity is rounded up to a power of
+ * two. Producer & consumer indexes live on separate cache lines, each side caches the other's
+ * index so a push or pop only touches shared state when the cached view runs out.
+ */
+template<typename T>
+class SPSCRing
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SPSCRing slots must be trivially copyable");
+
+public:
+    explicit SPSCRing(size_t capacity)
+        : m_mask(roundUp(capacity) - 1)
+        , m_slots(new T[m_mask + 1])
+    {
+    }
+
+    SPSCRing(const SPSCRing &) = delete;
+    SPSCRing &operator=(const SPSCRing &) = delete;
+
+    inline size_t capacity() const { return m_mask + 1; }
+
+    /**
+     * @brief Producer side, copy item into ring
+     * @return false if ring is full
+     */
+    inline bool push(const T &item)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_headCache > m_mask) {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail - m_headCache > m_mask)
+                return false;
+        }
+        m_slots[tail & m_mask] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer side, hand every available item to fn & release their slots at once
+     * @return Number of items consumed
+     */
+    template<typename Fn>
+    inline size_t consume(Fn &&fn)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tailCache) {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if (head == m_tailCache)
+                return 0;
+        }
+        size_t n = m_tailCache - head;
+        for (size_t i = 0; i < n; ++i)
+            fn(m_slots[(head + i) & m_mask]);
+        m_head.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief Approximate, safe to call from either side
+     */
+    inline bool empty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+private:
+    static size_t roundUp(size_t n)
+    {
+        size_t cap = 2;
+        while (cap < n)
+            cap <<= 1;
+        return cap;
+    }
+
+    const size_t m_mask;
+    std::unique_ptr<T[]> m_slots;
+
+    // consumer side
+    alignas(64) std::atomic<size_t> m_head {0};
+    size_t m_tailCache {0};
+    // producer side
+    alignas(64) std::atomic<size_t> m_tail {0};
+    size_t m_headCache {0};
+};
+
+} // namespace core
+} // namespace common
+
+#endif // SPSC_RING_H
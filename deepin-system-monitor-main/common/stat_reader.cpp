@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "stat_reader.h"
+#include "proc_parser.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace common {
+namespace parser {
+
+StatReader::StatReader(const char *path)
+    : m_path(path)
+    , m_fd(-1)
+{
+}
+
+StatReader::~StatReader()
+{
+    if (m_fd >= 0)
+        close(m_fd);
+}
+
+bool StatReader::read(CpuStatFields &fields)
+{
+    if (m_fd < 0) {
+        m_fd = open(m_path, O_RDONLY | O_CLOEXEC);
+        if (m_fd < 0)
+            return false;
+    }
+
+    ssize_t n;
+    do {
+        n = pread(m_fd, m_buf, sizeof(m_buf), 0);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) {
+        // reopen on next read
+        int err = errno;
+        close(m_fd);
+        m_fd = -1;
+        errno = err;
+        return false;
+    }
+
+    return parse(m_buf, size_t(n), fields);
+}
+
+bool StatReader::parse(const char *buf, size_t len, CpuStatFields &fields)
+{
+    // fields of a line cut by the buffer end would be partial
+    const char *nl = static_cast<const char *>(memchr(buf, '\n', len));
+    if (!nl)
+        return false;
+
+    Tokenizer tok(buf, size_t(nl - buf));
+    if (!tok.consume("cpu ", 4))
+        return false;
+
+    CpuStatFields cur;
+    bool parsed = tok.readU64(cur.user)
+            && tok.readU64(cur.nice)
+            && tok.readU64(cur.sys)
+            && tok.readU64(cur.idle);
+    if (!parsed)
+        return false;
+    // missing on old kernels, left 0
+    unsigned long long *optional[] = {&cur.iowait, &cur.hardirq, &cur.softirq, &cur.steal, &cur.guest, &cur.guestNice};
+    for (unsigned long long *field : optional) {
+        if (!tok.readU64(*field))
+            break;
+    }
+
+    fields = cur;
+    return true;
+}
+
+} // namespace parser
+} // namespace common
@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef STAT_READER_H
+#define STAT_READER_H
+
+#include <stddef.h>
+
+#define PROC_STAT_PATH "/proc/stat"
+
+namespace common {
+namespace parser {
+
+/**
+ * @brief Jiffies of the aggregate "cpu" line of /proc/stat, 64 bit since boot
+ */
+struct CpuStatFields {
+    unsigned long long user {0};
+    unsigned long long nice {0};
+    unsigned long long sys {0};
+    unsigned long long idle {0};
+    unsigned long long iowait {0};
+    unsigned long long hardirq {0};
+    unsigned long long softirq {0};
+    unsigned long long steal {0};
+    unsigned long long guest {0}; // already counted in user
+    unsigned long long guestNice {0}; // already counted in nice
+
+    /**
+     * @brief All jiffies, guest time excluded as it's part of user & nice
+     */
+    inline unsigned long long total() const
+    {
+        return user + nice + sys + idle + iowait + hardirq + softirq + steal;
+    }
+    inline unsigned long long idleTotal() const
+    {
+        return idle + iowait;
+    }
+};
+
+/**
+ * @brief Reader of the aggregate cpu line of /proc/stat
+ *
+ * The file is opened once & only its head is re-read with pread from offset 0, the per cpu &
+ * interrupt lines following are never copied. Not thread safe.
+ */
+class StatReader
+{
+public:
+    explicit StatReader(const char *path = PROC_STAT_PATH);
+    ~StatReader();
+
+    StatReader(const StatReader &) = delete;
+    StatReader &operator=(const StatReader &) = delete;
+
+    /**
+     * @brief Re-read the aggregate cpu line
+     * @return false if file can't be read or the line is malformed, errno is kept on read errors
+     */
+    bool read(CpuStatFields &fields);
+
+    /**
+     * @brief Parse the "cpu " line at the start of stat content
+     */
+    static bool parse(const char *buf, size_t len, CpuStatFields &fields);
+
+private:
+    const char *m_path;
+    int m_fd;
+    // "cpu " + 10 fields of up to 20 digits
+    char m_buf[256];
+};
+
+} // namespace parser
+} // namespace common
+
+#endif // STAT_READER_H
@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "string_pool.h"
+
+#include <QMutexLocker>
+
+namespace common {
+namespace intern {
+
+Q_GLOBAL_STATIC(StringPool, theInstance)
+
+StringPool *StringPool::instance()
+{
+    return theInstance();
+}
+
+QString StringPool::fromUtf8(const char *utf8, int size)
+{
+    // raw key is only compared, it's copied when inserted
+    const QByteArray key = QByteArray::fromRawData(utf8, size);
+    QMutexLocker locker(&m_mutex);
+    auto it = m_decoded.constFind(key);
+    if (it != m_decoded.cend())
+        return it.value();
+
+    QString str = QString::fromUtf8(utf8, size);
+    m_decoded.insert(QByteArray(utf8, size), str);
+    return str;
+}
+
+QString StringPool::intern(const QString &str)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_strings.constFind(str);
+    if (it != m_strings.cend())
+        return *it;
+
+    m_strings.insert(str);
+    return str;
+}
+
+QByteArray StringPool::intern(const QByteArray &bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_bytes.constFind(bytes);
+    if (it != m_bytes.cend())
+        return *it;
+
+    // deep copy, raw data of the caller goes away
+    QByteArray copy(bytes.constData(), bytes.size());
+    m_bytes.insert(copy);
+    return copy;
+}
+
+int StringPool::prune()
+{
+    QMutexLocker locker(&m_mutex);
+    int count = m_decoded.size() + m_strings.size() + m_bytes.size();
+    // a detached string has no owner outside the pool, none can be copied from it meanwhile
+    for (auto it = m_decoded.begin(); it != m_decoded.end();)
+        it = it.value().isDetached() ? m_decoded.erase(it) : ++it;
+    for (auto it = m_strings.begin(); it != m_strings.end();)
+        it = it->isDetached() ? m_strings.erase(it) : ++it;
+    for (auto it = m_bytes.begin(); it != m_bytes.end();)
+        it = it->isDetached() ? m_bytes.erase(it) : ++it;
+    return count - (m_decoded.size() + m_strings.size() + m_bytes.size());
+}
+
+int StringPool::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_decoded.size() + m_strings.size() + m_bytes.size();
+}
+
+} // namespace intern
+} // namespace common
@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+namespace common {
+namespace intern {
+
+/**
+ * @brief Process wide pool of interned strings, for names, user names & cmdline tokens
+ *
+ * Thousands of processes share a few names (kworker/.., chrome, /usr/bin/python3), interned
+ * copies share one allocation. Equal interned strings compare at the data pointer check of
+ * QString & QByteArray ==, so hash lookups & filters over them skip the character compare.
+ * Strings held by nobody but the pool are dropped by prune(). Thread safe.
+ */
+class StringPool
+{
+public:
+    StringPool() = default;
+
+    static StringPool *instance();
+
+    /**
+     * @brief Decoded utf8, shared with strings decoded from the same bytes, nothing is allocated on a hit
+     */
+    QString fromUtf8(const char *utf8, int size);
+    inline QString fromUtf8(const QByteArray &utf8)
+    {
+        return fromUtf8(utf8.constData(), utf8.size());
+    }
+    /**
+     * @brief Copy of \a str sharing data with equal strings interned before
+     */
+    QString intern(const QString &str);
+    /**
+     * @brief Copy of \a bytes sharing data with equal arrays interned before, \a bytes may be
+     * QByteArray::fromRawData, it's copied when inserted
+     */
+    QByteArray intern(const QByteArray &bytes);
+
+    /**
+     * @brief Drop strings only the pool holds, e.g. those of exited processes
+     * @return Number of strings dropped
+     */
+    int prune();
+    /**
+     * @brief Number of strings pooled
+     */
+    int size() const;
+
+private:
+    StringPool(const StringPool &) = delete;
+    StringPool &operator=(const StringPool &) = delete;
+
+    mutable QMutex m_mutex;
+    QHash<QByteArray, QString> m_decoded; // utf8 to the string decoded from it
+    QSet<QString> m_strings;
+    QSet<QByteArray> m_bytes;
+};
+
+} // namespace intern
+} // namespace common
+
+#endif // STRING_POOL_H
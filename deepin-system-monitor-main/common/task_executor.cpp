@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "task_executor.h"
+#include "thread_priority.h"
+#include "ddlog.h"
+
+#include <QThread>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace DDLog;
+
+namespace common {
+namespace core {
+
+Q_GLOBAL_STATIC(TaskExecutor, theInstance)
+
+TaskExecutor::TaskExecutor()
+{
+    int cpus = qMax(1, QThread::idealThreadCount());
+    // leave one core for the gui thread
+    m_pools[kSamplingTask].setMaxThreadCount(qMax(1, cpus - 1));
+    m_pools[kBackgroundTask].setMaxThreadCount(qMax(1, cpus / 4));
+    // mostly blocked waiting for replies, not bound by cores
+    m_pools[kIOTask].setMaxThreadCount(qMax(4, cpus / 2));
+    qCInfo(app) << "Task executor threads, sampling:" << m_pools[kSamplingTask].maxThreadCount()
+                << "background:" << m_pools[kBackgroundTask].maxThreadCount()
+                << "io:" << m_pools[kIOTask].maxThreadCount();
+    // read the configured policy here rather than on the first pool thread
+    ThreadPriority::sampling();
+}
+
+TaskExecutor::~TaskExecutor()
+{
+    for (auto &pool : m_pools)
+        pool.waitForDone();
+}
+
+TaskExecutor *TaskExecutor::instance()
+{
+    return theInstance();
+}
+
+void TaskExecutor::setMaxThreadCount(TaskClass cls, int count)
+{
+    m_pools[cls].setMaxThreadCount(qMax(1, count));
+}
+
+int TaskExecutor::maxThreadCount(TaskClass cls) const
+{
+    return m_pools[cls].maxThreadCount();
+}
+
+int TaskExecutor::niceOf(TaskClass cls)
+{
+    switch (cls) {
+    case kBackgroundTask:
+        return 10;
+    case kIOTask:
+        return 5;
+    default:
+        return 0;
+    }
+}
+
+void TaskExecutor::applyThreadPriority(TaskClass cls)
+{
+    // pool threads only ever run tasks of their own class
+    static thread_local bool applied = false;
+    if (applied)
+        return;
+    applied = true;
+
+    // workers sample in parallel, only background enrichment shares the housekeeping cpu
+    if (cls != kIOTask)
+        ThreadPriority::sampling().apply(cls == kBackgroundTask);
+
+    // nice is per thread on linux, lowering priority needs no privilege,
+    // a process started niced already is never raised
+    id_t tid = id_t(syscall(SYS_gettid));
+    int nice = niceOf(cls);
+    errno = 0;
+    int current = getpriority(PRIO_PROCESS, tid);
+    if (errno != 0 || current >= nice)
+        return;
+    if (setpriority(PRIO_PROCESS, tid, nice) < 0)
+        qCWarning(app) << "Failed to renice task thread to" << nice << ":" << strerror(errno);
+}
+
+} // namespace core
+} // namespace common
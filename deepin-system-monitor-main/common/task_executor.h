@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef TASK_EXECUTOR_H
+#define TASK_EXECUTOR_H
+
+#include <QFuture>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <utility>
+
+namespace common {
+namespace core {
+
+/**
+ * @brief Shared executor of the short jobs of producers, one pool per task class
+ *
+ * Pools are sized to the machine & their threads niced by class the first time they run a
+ * task, so background enrichment & blocking D-Bus calls never get ahead of sampling. Long
+ * running event loops (the monitor thread, packet capture, the systemd worker) keep their own
+ * threads, only jobs that finish are submitted here. Sampling & background threads also follow
+ * the sampling_priority & sampling_cpu policy of ThreadPriority.
+ */
+class TaskExecutor
+{
+public:
+    enum TaskClass {
+        kSamplingTask, // process & device sampling, at normal priority
+        kBackgroundTask, // enrichment: names, icons, desktop entries
+        kIOTask, // blocking D-Bus & NSS calls
+
+        kTaskClassCount
+    };
+
+    TaskExecutor();
+    ~TaskExecutor();
+
+    static TaskExecutor *instance();
+
+    /**
+     * @brief Run \a job on the pool of \a cls, the future is the one of QtConcurrent::run
+     */
+    template<typename Job>
+    auto run(TaskClass cls, Job job) -> QFuture<decltype(job())>
+    {
+        return QtConcurrent::run(&m_pools[cls], [cls, job]() {
+            applyThreadPriority(cls);
+            return job();
+        });
+    }
+
+    /**
+     * @brief Bound worker threads of a class, e.g. process_sampling_workers of DConfig
+     */
+    void setMaxThreadCount(TaskClass cls, int count);
+    int maxThreadCount(TaskClass cls) const;
+
+    /**
+     * @brief Nice value the threads of \a cls run at
+     */
+    static int niceOf(TaskClass cls);
+
+private:
+    TaskExecutor(const TaskExecutor &) = delete;
+    TaskExecutor &operator=(const TaskExecutor &) = delete;
+
+    /**
+     * @brief Renice the calling pool thread for \a cls, once per thread
+     */
+    static void applyThreadPriority(TaskClass cls);
+
+    QThreadPool m_pools[kTaskClassCount];
+};
+
+} // namespace core
+} // namespace common
+
+#endif // TASK_EXECUTOR_H
@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "thread_priority.h"
+#include "ddlog.h"
+
+#include <DConfig>
+
+#include <errno.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace DDLog;
+
+namespace {
+// linux/ioprio.h isn't shipped by every libc
+const int kIOPrioClassShift = 13;
+const int kIOPrioClassBE = 2;
+const int kIOPrioClassIdle = 3;
+const int kIOPrioWhoProcess = 1;
+const int kIOPrioLowestLevel = 7;
+
+const int kLowNice = 10;
+}
+
+namespace common {
+namespace core {
+
+ThreadPriority::ThreadPriority(Priority priority, int cpu)
+    : m_priority(priority)
+    , m_cpu(cpu < 0 ? -1 : cpu)
+{
+}
+
+const ThreadPriority &ThreadPriority::sampling()
+{
+    static const ThreadPriority policy = []() {
+        Priority priority = kNormalPriority;
+        int cpu = -1;
+        auto *config = DTK_CORE_NAMESPACE::DConfig::create("deepin-system-monitor", "org.deepin.system-monitor");
+        if (config) {
+            priority = parsePriority(config->value("sampling_priority", "normal").toString());
+            cpu = config->value("sampling_cpu", -1).toInt();
+            delete config;
+        }
+        qCInfo(app) << "Sampling thread priority:" << priority << "cpu:" << cpu;
+        return ThreadPriority(priority, cpu);
+    }();
+    return policy;
+}
+
+void ThreadPriority::apply(bool pin) const
+{
+    pid_t tid = pid_t(syscall(SYS_gettid));
+
+    if (m_priority == kLowPriority) {
+        // a process started niced already is never raised
+        errno = 0;
+        int current = getpriority(PRIO_PROCESS, id_t(tid));
+        if (errno == 0 && current < kLowNice && setpriority(PRIO_PROCESS, id_t(tid), kLowNice) < 0)
+            qCWarning(app) << "Failed to renice sampling thread:" << strerror(errno);
+    } else if (m_priority == kIdlePriority) {
+        struct sched_param param {};
+        if (sched_setscheduler(tid, SCHED_IDLE, &param) < 0)
+            qCWarning(app) << "Failed to set SCHED_IDLE on sampling thread:" << strerror(errno);
+    }
+
+    int ioprio = ioPriorityOf(m_priority);
+    if (ioprio != 0 && syscall(SYS_ioprio_set, kIOPrioWhoProcess, tid, ioprio) < 0)
+        qCWarning(app) << "Failed to set io priority of sampling thread:" << strerror(errno);
+
+    if (pin && m_cpu >= 0) {
+        if (m_cpu >= CPU_SETSIZE) {
+            qCWarning(app) << "Sampling cpu out of range:" << m_cpu;
+            return;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(m_cpu, &set);
+        // fails for offline cpus & ones outside the cpuset of the process
+        if (sched_setaffinity(tid, sizeof(set), &set) < 0)
+            qCWarning(app) << "Failed to pin sampling thread to cpu" << m_cpu << ":" << strerror(errno);
+    }
+}
+
+ThreadPriority::Priority ThreadPriority::parsePriority(const QString &value)
+{
+    QString name = value.trimmed().toLower();
+    if (name == QLatin1String("low"))
+        return kLowPriority;
+    if (name == QLatin1String("idle"))
+        return kIdlePriority;
+    return kNormalPriority;
+}
+
+int ThreadPriority::ioPriorityOf(Priority priority)
+{
+    switch (priority) {
+    case kLowPriority:
+        return (kIOPrioClassBE << kIOPrioClassShift) | kIOPrioLowestLevel;
+    case kIdlePriority:
+        return kIOPrioClassIdle << kIOPrioClassShift;
+    default:
+        return 0;
+    }
+}
+
+} // namespace core
+} // namespace common
@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef THREAD_PRIORITY_H
+#define THREAD_PRIORITY_H
+
+#include <QString>
+
+namespace common {
+namespace core {
+
+/**
+ * @brief Cpu & io priority of the sampling threads, sampling_priority & sampling_cpu of DConfig
+ *
+ * Applied by each thread to itself when it starts: the monitor thread, packet capture & the
+ * sampling and background pools of the task executor. The gui thread is never touched, so with
+ * idle priority sampling only runs on cycles nothing else wants.
+ */
+class ThreadPriority
+{
+public:
+    enum Priority {
+        kNormalPriority, // inherited from the process
+        kLowPriority, // nice 10, best effort io at lowest level
+        kIdlePriority // SCHED_IDLE & idle io class
+    };
+
+    explicit ThreadPriority(Priority priority = kNormalPriority, int cpu = -1);
+
+    /**
+     * @brief Policy read from DConfig once
+     */
+    static const ThreadPriority &sampling();
+
+    /**
+     * @brief Apply to the calling thread
+     * @param pin Pin to the housekeeping cpu if one is set, off for pools that sample in parallel
+     */
+    void apply(bool pin = true) const;
+
+    inline Priority priority() const
+    {
+        return m_priority;
+    }
+    inline int cpu() const
+    {
+        return m_cpu;
+    }
+
+    /**
+     * @brief "normal", "low" or "idle", anything else is normal
+     */
+    static Priority parsePriority(const QString &value);
+    /**
+     * @brief ioprio_set value of \a priority, 0 keeps the io priority of the process
+     */
+    static int ioPriorityOf(Priority priority);
+
+private:
+    Priority m_priority;
+    int m_cpu; // housekeeping cpu, -1 for no pinning
+};
+
+} // namespace core
+} // namespace common
+
+#endif // THREAD_PRIORITY_H
@@ -0,0 +1,167 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "trace_log.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace common {
+namespace log {
+
+namespace {
+
+const char *const kLevelNames[kLevelCount] = {
+    "trace",
+    "debug",
+    "info"
+};
+
+std::atomic<Forwarder> g_forwarder {nullptr};
+
+thread_local int t_tid = 0;
+
+int64_t clockNs(clockid_t clock)
+{
+    timespec ts {};
+    clock_gettime(clock, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+void appendEscaped(std::string &out, const char *text)
+{
+    for (; *text; ++text) {
+        char c = *text;
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += c;
+        }
+    }
+}
+
+} // namespace
+
+std::atomic<int> g_minLevel {kLevelDebug};
+
+const char *levelName(int level)
+{
+    return level >= 0 && level < kLevelCount ? kLevelNames[level] : "unknown";
+}
+
+RateLimit::RateLimit(int burst, int64_t periodNs)
+    : m_burst(burst)
+    , m_period(periodNs)
+    , m_windowStart(INT64_MIN)
+    , m_count(0)
+    , m_suppressed(0)
+{
+}
+
+bool RateLimit::allow(int64_t now, uint32_t &suppressed)
+{
+    int64_t start = m_windowStart.load(std::memory_order_relaxed);
+    // the caller winning the exchange opens the next window
+    if ((start == INT64_MIN || now - start >= m_period)
+            && m_windowStart.compare_exchange_strong(start, now, std::memory_order_relaxed))
+        m_count.store(0, std::memory_order_relaxed);
+
+    if (m_count.fetch_add(1, std::memory_order_relaxed) >= m_burst) {
+        m_suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+LogRing::LogRing(int capacity)
+    : m_entries(size_t(capacity > 0 ? capacity : 1))
+{
+}
+
+void LogRing::append(const LogEntry &entry)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_entries[m_head % m_entries.size()] = entry;
+    ++m_head;
+}
+
+std::vector<LogEntry> LogRing::entries() const
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    uint64_t first = m_head > m_entries.size() ? m_head - m_entries.size() : 0;
+    std::vector<LogEntry> entries;
+    entries.reserve(size_t(m_head - first));
+    for (uint64_t index = first; index < m_head; ++index)
+        entries.push_back(m_entries[index % m_entries.size()]);
+    return entries;
+}
+
+std::string LogRing::dumpJson() const
+{
+    std::string out;
+    for (const LogEntry &entry : entries()) {
+        out += "{\"time\":" + std::to_string(entry.time / 1000000);
+        out += ",\"level\":\"";
+        out += levelName(entry.level);
+        out += "\",\"tid\":" + std::to_string(entry.tid) + ",\"site\":\"";
+        appendEscaped(out, entry.site ? entry.site : "");
+        out += "\",\"suppressed\":" + std::to_string(entry.suppressed) + ",\"message\":\"";
+        appendEscaped(out, entry.message);
+        out += "\"}\n";
+    }
+    return out;
+}
+
+LogRing &logRing()
+{
+    static LogRing ring;
+    return ring;
+}
+
+void setForwarder(Forwarder forwarder)
+{
+    g_forwarder.store(forwarder);
+}
+
+void setMinLevel(int level)
+{
+    g_minLevel.store(level < kLevelTrace ? kLevelTrace : level, std::memory_order_relaxed);
+}
+
+void write(RateLimit &limit, int level, const char *site, const char *format, ...)
+{
+    uint32_t suppressed = 0;
+    if (!limit.allow(clockNs(CLOCK_MONOTONIC), suppressed))
+        return;
+
+    LogEntry entry;
+    entry.time = clockNs(CLOCK_REALTIME);
+    entry.level = level;
+    if (!t_tid)
+        t_tid = int(syscall(SYS_gettid));
+    entry.tid = t_tid;
+    entry.site = site;
+    entry.suppressed = suppressed;
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(entry.message, sizeof(entry.message), format, args);
+    va_end(args);
+
+    logRing().append(entry);
+    if (Forwarder forwarder = g_forwarder.load())
+        forwarder(entry);
+}
+
+} // namespace log
+} // namespace common
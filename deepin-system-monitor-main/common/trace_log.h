@@ -0,0 +1,148 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef TRACE_LOG_H
+#define TRACE_LOG_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+// lowest level compiled in, 0 trace, 1 debug, 2 info, set with -DTRACE_LOG_LEVEL
+#ifndef TRACE_LOG_LEVEL
+#define TRACE_LOG_LEVEL 1
+#endif
+
+namespace common {
+namespace log {
+
+enum Level {
+    kLevelTrace,
+    kLevelDebug,
+    kLevelInfo,
+
+    kLevelCount
+};
+
+const char *levelName(int level);
+
+struct LogEntry {
+    static const int kMessageSize = 160;
+
+    int64_t time {0}; // CLOCK_REALTIME ns
+    int level {0};
+    int tid {0};
+    const char *site {nullptr}; // "file:line" literal of the call site
+    uint32_t suppressed {0}; // messages of the call site dropped by its rate limit before this one
+    char message[kMessageSize] {};
+};
+
+/**
+ * @brief Per call site limit, at most burst messages per period
+ *
+ * Fixed window of relaxed atomics, one per TRACE_LOG_* call site. Concurrent callers may let
+ * a message more or less through when the window rolls over, what's dropped is counted &
+ * reported with the next message that goes out.
+ */
+class RateLimit
+{
+public:
+    static const int kDefaultBurst = 10;
+    static const int64_t kDefaultPeriodNs = 10 * int64_t(1000000000);
+
+    explicit RateLimit(int burst = kDefaultBurst, int64_t periodNs = kDefaultPeriodNs);
+
+    /**
+     * @brief Whether a message may go out at now (CLOCK_MONOTONIC ns)
+     * @param suppressed Messages dropped since the last one let through, set when true
+     */
+    bool allow(int64_t now, uint32_t &suppressed);
+
+private:
+    const int m_burst;
+    const int64_t m_period;
+    std::atomic<int64_t> m_windowStart;
+    std::atomic<int> m_count;
+    std::atomic<uint32_t> m_suppressed;
+};
+
+/**
+ * @brief Last messages logged, kept in memory & dumped on demand
+ *
+ * Fixed ring under a mutex, writers are rate limited so it's rarely contended.
+ */
+class LogRing
+{
+public:
+    static const int kDefaultCapacity = 1024;
+
+    explicit LogRing(int capacity = kDefaultCapacity);
+
+    void append(const LogEntry &entry);
+    // oldest first
+    std::vector<LogEntry> entries() const;
+    // one JSON object per line: time (ms since epoch), level, tid, site, suppressed & message
+    std::string dumpJson() const;
+
+private:
+    mutable std::mutex m_lock;
+    std::vector<LogEntry> m_entries;
+    uint64_t m_head {0};
+};
+
+// ring all TRACE_LOG_* messages go to
+LogRing &logRing();
+
+/**
+ * @brief Called with every message let through, e.g. to pass it on to a Qt logging category
+ */
+using Forwarder = void (*)(const LogEntry &entry);
+void setForwarder(Forwarder forwarder);
+
+// lowest level recorded at runtime, levels below the compiled in one are gone anyway
+void setMinLevel(int level);
+extern std::atomic<int> g_minLevel;
+inline bool isEnabled(int level)
+{
+    return level >= g_minLevel.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Format & record a message if the call site limit lets it through
+ *
+ * Nothing is allocated, the message is formatted into the entry & truncated past LogEntry::kMessageSize.
+ */
+void write(RateLimit &limit, int level, const char *site, const char *format, ...)
+    __attribute__((format(printf, 4, 5)));
+
+} // namespace log
+} // namespace common
+
+#define TRACE_LOG_STR_(x) #x
+#define TRACE_LOG_STR(x) TRACE_LOG_STR_(x)
+// arguments are only evaluated once the level is enabled
+#define TRACE_LOG_AT(level, ...) \
+    do { \
+        if (common::log::isEnabled(common::log::level)) { \
+            static common::log::RateLimit traceLogLimit; \
+            common::log::write(traceLogLimit, common::log::level, __FILE__ ":" TRACE_LOG_STR(__LINE__), __VA_ARGS__); \
+        } \
+    } while (0)
+
+#if TRACE_LOG_LEVEL <= 0
+#define TRACE_LOG_TRACE(...) TRACE_LOG_AT(kLevelTrace, __VA_ARGS__)
+#else
+#define TRACE_LOG_TRACE(...) do {} while (0)
+#endif
+#if TRACE_LOG_LEVEL <= 1
+#define TRACE_LOG_DEBUG(...) TRACE_LOG_AT(kLevelDebug, __VA_ARGS__)
+#else
+#define TRACE_LOG_DEBUG(...) do {} while (0)
+#endif
+#define TRACE_LOG_INFO(...) TRACE_LOG_AT(kLevelInfo, __VA_ARGS__)
+
+#endif // TRACE_LOG_H
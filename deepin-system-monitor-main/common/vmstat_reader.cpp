@@ -0,0 +1,145 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "vmstat_reader.h"
+#include "proc_parser.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace common {
+namespace parser {
+
+namespace {
+
+struct VmStatField {
+    const char *key;
+    size_t len;
+    size_t offset;
+};
+
+const unsigned kSlots = 32;
+
+// collision free for the tracked keys, see kFields, most keys start with "p" or "thp_" so
+// the character before the last tells them apart
+inline unsigned slotOf(const char *key, size_t len)
+{
+    return (unsigned(len) + 2u * static_cast<unsigned char>(key[0]) + 3u * static_cast<unsigned char>(key[len - 2])) & (kSlots - 1);
+}
+
+// indexed by slotOf(key)
+const VmStatField kFields[kSlots] = {
+    {nullptr, 0, 0}, // 0
+    {"pswpin", 6, offsetof(VmStatFields, pswpin)}, // 1
+    {nullptr, 0, 0}, // 2
+    {"thp_fault_fallback", 18, offsetof(VmStatFields, thpFaultFallback)}, // 3
+    {"thp_fault_alloc", 15, offsetof(VmStatFields, thpFaultAlloc)}, // 4
+    {nullptr, 0, 0}, // 5
+    {"pswpout", 7, offsetof(VmStatFields, pswpout)}, // 6
+    {"thp_collapse_alloc", 18, offsetof(VmStatFields, thpCollapseAlloc)}, // 7
+    {nullptr, 0, 0}, // 8
+    {nullptr, 0, 0}, // 9
+    {"oom_kill", 8, offsetof(VmStatFields, oomKill)}, // 10
+    {"pgfault", 7, offsetof(VmStatFields, pgfault)}, // 11
+    {nullptr, 0, 0}, // 12
+    {nullptr, 0, 0}, // 13
+    {"pgmajfault", 10, offsetof(VmStatFields, pgmajfault)}, // 14
+    {nullptr, 0, 0}, // 15
+    {"thp_collapse_alloc_failed", 25, offsetof(VmStatFields, thpCollapseAllocFailed)}, // 16
+    {nullptr, 0, 0}, // 17
+    {nullptr, 0, 0}, // 18
+    {nullptr, 0, 0}, // 19
+    {nullptr, 0, 0}, // 20
+    {"zswpin", 6, offsetof(VmStatFields, zswpin)}, // 21
+    {"pgscan_direct", 13, offsetof(VmStatFields, pgscanDirect)}, // 22
+    {"pgsteal_direct", 14, offsetof(VmStatFields, pgstealDirect)}, // 23
+    {nullptr, 0, 0}, // 24
+    {nullptr, 0, 0}, // 25
+    {"zswpout", 7, offsetof(VmStatFields, zswpout)}, // 26
+    {nullptr, 0, 0}, // 27
+    {nullptr, 0, 0}, // 28
+    {"pgscan_kswapd", 13, offsetof(VmStatFields, pgscanKswapd)}, // 29
+    {"pgsteal_kswapd", 14, offsetof(VmStatFields, pgstealKswapd)}, // 30
+    {nullptr, 0, 0}, // 31
+};
+
+inline const VmStatField *lookup(const char *key, size_t len)
+{
+    if (len < 2)
+        return nullptr;
+    const VmStatField &field = kFields[slotOf(key, len)];
+    return (field.key && keyEquals(key, len, field.key, field.len)) ? &field : nullptr;
+}
+
+} // namespace
+
+VmStatReader::VmStatReader(const char *path)
+    : m_path(path)
+    , m_fd(-1)
+{
+}
+
+VmStatReader::~VmStatReader()
+{
+    if (m_fd >= 0)
+        close(m_fd);
+}
+
+bool VmStatReader::read(VmStatFields &fields)
+{
+    if (m_fd < 0) {
+        m_fd = open(m_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (m_fd < 0)
+            return false;
+    }
+
+    size_t total = 0;
+    while (total < sizeof(m_buf)) {
+        ssize_t n = pread(m_fd, m_buf + total, sizeof(m_buf) - total, off_t(total));
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            // reopen on next read
+            int err = errno;
+            close(m_fd);
+            m_fd = -1;
+            errno = err;
+            return false;
+        }
+        if (n == 0)
+            break;
+        total += size_t(n);
+    }
+    if (total == 0)
+        return false;
+
+    parse(m_buf, total, fields);
+    return true;
+}
+
+int VmStatReader::parse(const char *buf, size_t len, VmStatFields &fields)
+{
+    Tokenizer tok(buf, len);
+    char *base = reinterpret_cast<char *>(&fields);
+    int found = 0;
+
+    do {
+        // "pgmajfault 310", no colon after the key
+        const char *key;
+        size_t keyLen;
+        if (!tok.readToken(key, keyLen))
+            continue;
+
+        const VmStatField *field = lookup(key, keyLen);
+        if (field && tok.readU64(*reinterpret_cast<unsigned long long *>(base + field->offset)))
+            ++found;
+    } while (tok.nextLine());
+
+    return found;
+}
+
+} // namespace parser
+} // namespace common
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef VMSTAT_READER_H
+#define VMSTAT_READER_H
+
+#include <stddef.h>
+
+#include <string>
+
+#define PROC_VMSTAT_PATH "/proc/vmstat"
+
+namespace common {
+namespace parser {
+
+/**
+ * @brief Event counters of /proc/vmstat we care about, since boot
+ */
+struct VmStatFields {
+    unsigned long long pgfault {0}; // pgfault, all page faults
+    unsigned long long pgmajfault {0}; // pgmajfault, faults that waited on io
+    unsigned long long pswpin {0}; // pswpin, pages
+    unsigned long long pswpout {0}; // pswpout, pages
+    unsigned long long pgscanKswapd {0}; // pgscan_kswapd, pages scanned by background reclaim
+    unsigned long long pgscanDirect {0}; // pgscan_direct, by allocating tasks
+    unsigned long long pgstealKswapd {0}; // pgsteal_kswapd, pages reclaimed
+    unsigned long long pgstealDirect {0}; // pgsteal_direct
+    unsigned long long oomKill {0}; // oom_kill, kernel 4.13+
+    unsigned long long thpFaultAlloc {0}; // thp_fault_alloc, faults served a huge page
+    unsigned long long thpFaultFallback {0}; // thp_fault_fallback, fell back to small pages
+    unsigned long long thpCollapseAlloc {0}; // thp_collapse_alloc, huge pages collapsed by khugepaged
+    unsigned long long thpCollapseAllocFailed {0}; // thp_collapse_alloc_failed
+    unsigned long long zswpin {0}; // zswpin, pages loaded from zswap, kernel 5.19+
+    unsigned long long zswpout {0}; // zswpout, pages stored to it
+};
+
+/**
+ * @brief Single pass /proc/vmstat reader
+ *
+ * Same scheme as MemInfoReader: the file is kept open & re-read with pread from offset 0, each
+ * "key value" line is mapped to its VmStatFields member through a perfect hash table of the
+ * keys above. Reclaim counters are the node wide ones of kernel 4.8+, the per zone ones of
+ * older kernels aren't summed. Not thread safe.
+ */
+class VmStatReader
+{
+public:
+    explicit VmStatReader(const char *path = PROC_VMSTAT_PATH);
+    ~VmStatReader();
+
+    VmStatReader(const VmStatReader &) = delete;
+    VmStatReader &operator=(const VmStatReader &) = delete;
+
+    /**
+     * @brief Re-read file & update fields, fields missing from file are left untouched
+     * @return false if file can't be opened or read, errno is kept
+     */
+    bool read(VmStatFields &fields);
+
+    /**
+     * @brief Parse vmstat content
+     * @return Number of fields found
+     */
+    static int parse(const char *buf, size_t len, VmStatFields &fields);
+
+private:
+    std::string m_path;
+    int m_fd;
+    // vmstat is ~4-6k depending on config, leave room for counters added by newer kernels
+    char m_buf[16384];
+};
+
+} // namespace parser
+} // namespace common
+
+#endif // VMSTAT_READER_H
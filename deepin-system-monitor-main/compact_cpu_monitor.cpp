@@ -12,6 +12,7 @@
 #include "model/cpu_info_model.h"
 #include "model/cpu_list_model.h"
 #include "gui/base/base_commandlink_button.h"
+#include "gui/base/frame_clock.h"
 
 #include <DApplication>
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -172,7 +173,7 @@ void CompactCpuMonitor::updateStatus()
 
     cpuPercents[numCPU] = calcTotalCpuPercent;
 
-    update();
+    FrameClock::instance()->requestUpdate(this);
 }
 
 void CompactCpuMonitor::setDetailButtonVisible(bool visible)
@@ -5,9 +5,12 @@
 
 #include "compact_disk_monitor.h"
 
+#include "gui/base/frame_clock.h"
 #include "common/common.h"
-#include "system/system_monitor.h"
+#include "model/model_manager.h"
+#include "model/update_coordinator.h"
 #include "system/device_db.h"
+#include "system/device_snapshot.h"
 #include "system/diskio_info.h"
 #include "ddlog.h"
 
@@ -53,7 +56,7 @@ CompactDiskMonitor::CompactDiskMonitor(QWidget *parent)
         writeSpeeds->append(0);
     }
 
-    connect(SystemMonitor::instance(), &SystemMonitor::statInfoUpdated, this, &CompactDiskMonitor::updateStatus);
+    connect(ModelManager::instance()->updateCoordinator(), &UpdateCoordinator::updateViews, this, &CompactDiskMonitor::updateStatus);
 
     changeFont(DApplication::font());
     connect(dynamic_cast<QGuiApplication *>(DApplication::instance()), &DApplication::fontChanged,
@@ -70,8 +73,9 @@ CompactDiskMonitor::~CompactDiskMonitor()
 void CompactDiskMonitor::updateStatus()
 {
     qCDebug(app) << "updateStatus";
-    m_readBps = DeviceDB::instance()->diskIoInfo()->diskIoReadBps();
-    m_writeBps = DeviceDB::instance()->diskIoInfo()->diskIoWriteBps();
+    DeviceSnapshotPtr snapshot = DeviceDB::instance()->snapshot();
+    m_readBps = snapshot->diskReadBps;
+    m_writeBps = snapshot->diskWriteBps;
 
     // Init read path.
     readSpeeds->append(m_readBps);
@@ -100,7 +104,7 @@ void CompactDiskMonitor::updateStatus()
     getPainterPathByData(writeSpeeds, tmpWritepath, maxHeight);
     writePath = tmpWritepath;
 
-    update();
+    FrameClock::instance()->requestUpdate(this);
 }
 
 void CompactDiskMonitor::getPainterPathByData(QList<double> *listData, QPainterPath &path, qreal maxVlaue)
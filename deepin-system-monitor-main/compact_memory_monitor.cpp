@@ -7,7 +7,10 @@
 #include "common/common.h"
 #include "system/mem.h"
 #include "system/device_db.h"
-#include "system/system_monitor.h"
+#include "system/device_snapshot.h"
+#include "model/model_manager.h"
+#include "model/update_coordinator.h"
+#include "gui/base/frame_clock.h"
 
 #include <DApplication>
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -22,7 +25,6 @@
 #include <QDebug>
 #include <QPainter>
 #include <QtMath>
-#include <QPropertyAnimation>
 #include <QPainterPath>
 #include <QMouseEvent>
 
@@ -59,20 +61,13 @@ CompactMemoryMonitor::CompactMemoryMonitor(QWidget *parent)
 
     changeTheme(dAppHelper->themeType());
 
-    m_animation = new QPropertyAnimation(this, "progress", this);
-    m_animation->setDuration(10);
-    m_animation->setEasingCurve(QEasingCurve::OutQuad);
-    m_animation->setStartValue(0);
-    m_animation->setEndValue(1.0);
-    connect(m_animation, &QVariantAnimation::valueChanged, this, &CompactMemoryMonitor::onValueChanged);
-
     changeFont(DApplication::font());
     connect(dynamic_cast<QGuiApplication *>(DApplication::instance()), &DApplication::fontChanged,
             this, &CompactMemoryMonitor::changeFont);
 
-    m_memInfo = DeviceDB::instance()->memInfo();
-    connect(SystemMonitor::instance(), &SystemMonitor::statInfoUpdated, this, &CompactMemoryMonitor::onStatInfoUpdated);
-    connect(m_animation, &QPropertyAnimation::finished, this, &CompactMemoryMonitor::animationFinshed);
+    m_snapshot = DeviceDB::instance()->snapshot();
+    m_memInfo = &m_snapshot->memInfo;
+    connect(ModelManager::instance()->updateCoordinator(), &UpdateCoordinator::updateViews, this, &CompactMemoryMonitor::onStatInfoUpdated);
 }
 
 CompactMemoryMonitor::~CompactMemoryMonitor() {
@@ -93,7 +88,10 @@ void CompactMemoryMonitor::setProgress(qreal p)
 void CompactMemoryMonitor::onStatInfoUpdated()
 {
     qCDebug(app) << "onStatInfoUpdated";
-    m_animation->start();
+    m_snapshot = DeviceDB::instance()->snapshot();
+    m_memInfo = &m_snapshot->memInfo;
+    FrameClock::instance()->start(this, 10, QEasingCurve::OutQuad, [this](qreal p) { setProgress(p); },
+                                  [this]() { animationFinshed(); });
 }
 
 void CompactMemoryMonitor::animationFinshed()
@@ -8,13 +8,15 @@
 
 #include <QWidget>
 
-class QPropertyAnimation;
+#include <memory>
+
 class MemStatModel;
 class MemInfoModel;
 
 namespace core {
 namespace system {
 class MemInfo;
+struct DeviceSnapshot;
 }
 }
 
@@ -76,12 +78,13 @@ private:
     int ringCenterPointerY = 45;
     int ringWidth = 6;
 
-    core::system::MemInfo *m_memInfo {};
+    const core::system::MemInfo *m_memInfo {};
+    // published device state m_memInfo points into
+    std::shared_ptr<const core::system::DeviceSnapshot> m_snapshot;
 
     qreal m_progress {};
     qreal m_lastMemPercent = 0.;
     qreal m_lastSwapPercent = 0.;
-    QPropertyAnimation *m_animation {};
 
     QFont m_contentFont;
     QFont m_subContentFont;
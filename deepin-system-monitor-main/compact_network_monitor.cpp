@@ -6,10 +6,13 @@
 #include "compact_network_monitor.h"
 
 #include "smooth_curve_generator.h"
+#include "gui/base/frame_clock.h"
 #include "common/common.h"
+#include "model/model_manager.h"
+#include "model/sample_history.h"
 #include "system/device_db.h"
+#include "system/device_snapshot.h"
 #include "system/net_info.h"
-#include "system/system_monitor.h"
 
 #include <DApplication>
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -49,15 +52,9 @@ CompactNetworkMonitor::CompactNetworkMonitor(QWidget *parent)
     setFixedWidth(statusBarMaxWidth);
     setFixedHeight(150);
 
-    downloadSpeeds = new QList<double>();
-    for (int i = 0; i <= pointsNumber; i++) {
-        downloadSpeeds->append(0);
-    }
-
-    uploadSpeeds = new QList<double>();
-    for (int i = 0; i <= pointsNumber; i++) {
-        uploadSpeeds->append(0);
-    }
+    SampleHistory *history = ModelManager::instance()->sampleHistory();
+    downloadSpeeds = &history->series(SampleHistory::kNetRecv);
+    uploadSpeeds = &history->series(SampleHistory::kNetSent);
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     connect(dAppHelper, &DApplicationHelper::themeTypeChanged, this,
             &CompactNetworkMonitor::changeTheme);
@@ -67,7 +64,7 @@ CompactNetworkMonitor::CompactNetworkMonitor(QWidget *parent)
 #endif
     changeTheme(dAppHelper->themeType());
 
-    connect(SystemMonitor::instance(), &SystemMonitor::statInfoUpdated, this, &CompactNetworkMonitor::updateStatus);
+    connect(history, &SampleHistory::updated, this, &CompactNetworkMonitor::updateStatus);
 
     changeFont(DApplication::font());
     connect(dynamic_cast<QGuiApplication *>(DApplication::instance()),
@@ -79,20 +76,17 @@ CompactNetworkMonitor::CompactNetworkMonitor(QWidget *parent)
 CompactNetworkMonitor::~CompactNetworkMonitor()
 {
     // qCDebug(app) << "CompactNetworkMonitor destructor";
-    delete downloadSpeeds;
-    delete uploadSpeeds;
 }
 
-void CompactNetworkMonitor::getPainterPathByData(QList<double> *listData, QPainterPath &path, qreal maxVlaue)
+void CompactNetworkMonitor::getPainterPathByData(const common::core::SeriesRing *listData, QPainterPath &path, qreal maxVlaue)
 {
     qCDebug(app) << "getPainterPathByData";
     qreal offsetX = 0;
     qreal distance = (this->width() - 2) * 1.0 / pointsNumber;
-    int dataCount = listData->size();
-
-    for (int i = 0;  i < dataCount - 1; i++) {
-        QPointF sp = QPointF(offsetX, renderMaxHeight * listData->at(i) / maxVlaue);;
-        QPointF ep = QPointF(offsetX + distance, renderMaxHeight * listData->at(i + 1) / maxVlaue);;
+    // the latest pointsNumber + 1 samples, oldest first, samples not recorded yet read as 0
+    for (int i = pointsNumber;  i > 0; i--) {
+        QPointF sp = QPointF(offsetX, renderMaxHeight * listData->recent(size_t(i)) / maxVlaue);;
+        QPointF ep = QPointF(offsetX + distance, renderMaxHeight * listData->recent(size_t(i - 1)) / maxVlaue);;
 
         offsetX += distance;
 
@@ -105,28 +99,16 @@ void CompactNetworkMonitor::getPainterPathByData(QList<double> *listData, QPaint
 void CompactNetworkMonitor::updateStatus()
 {
     qCDebug(app) << "updateStatus";
-    auto netInfo = DeviceDB::instance()->netInfo();
-
-    m_totalRecvBytes = netInfo->totalRecvBytes();
-    m_totalSentBytes = netInfo->totalSentBytes();
-    m_recvBps = netInfo->recvBps();
-    m_sentBps = netInfo->sentBps();
+    DeviceSnapshotPtr snapshot = DeviceDB::instance()->snapshot();
 
-    // Init download path.
-    downloadSpeeds->append(m_recvBps);
+    m_totalRecvBytes = snapshot->netTotalRecvBytes;
+    m_totalSentBytes = snapshot->netTotalSentBytes;
+    m_recvBps = snapshot->netRecvBps;
+    m_sentBps = snapshot->netSentBps;
 
-    if (downloadSpeeds->size() > pointsNumber + 1) {
-        downloadSpeeds->pop_front();
-    }
-    double downloadMaxHeight = *std::max_element(downloadSpeeds->begin(), downloadSpeeds->end()) * 1.1;
-
-    // Init upload path.
-    uploadSpeeds->append(m_sentBps);
-
-    if (uploadSpeeds->size() > pointsNumber + 1) {
-        uploadSpeeds->pop_front();
-    }
-    double uploadMaxHeight = *std::max_element(uploadSpeeds->begin(), uploadSpeeds->end()) * 1.1;
+    // history holds just the charted samples, its running max is the max of the chart
+    double downloadMaxHeight = downloadSpeeds->max() * 1.1;
+    double uploadMaxHeight = uploadSpeeds->max() * 1.1;
 
     double maxHeight = qMax(downloadMaxHeight, uploadMaxHeight);
 
@@ -138,7 +120,7 @@ void CompactNetworkMonitor::updateStatus()
     getPainterPathByData(uploadSpeeds, tmpUploadpath, maxHeight);
     uploadPath = tmpUploadpath;
 
-    update();
+    FrameClock::instance()->requestUpdate(this);
 }
 
 void CompactNetworkMonitor::paintEvent(QPaintEvent *)
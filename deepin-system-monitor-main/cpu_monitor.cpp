@@ -11,7 +11,10 @@
 #include "common/common.h"
 #include "model/cpu_info_model.h"
 #include "model/cpu_stat_model.h"
+#include "model/model_manager.h"
+#include "model/sample_history.h"
 #include "gui/base/base_commandlink_button.h"
+#include "gui/base/frame_clock.h"
 
 #include <DApplication>
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -27,7 +30,6 @@
 #include <QIcon>
 #include <QPainter>
 #include <QtMath>
-#include <QPropertyAnimation>
 #include <QPainterPath>
 #include <QMouseEvent>
 
@@ -43,10 +45,8 @@ CpuMonitor::CpuMonitor(QWidget *parent)
     setFixedSize(statusBarMaxWidth, 240);
     waveformsRenderOffsetX = (statusBarMaxWidth - 140) / 2;
 
-    cpuPercents = new QList<double>();
-    for (int i = 0; i < pointsNumber; i++) {
-        cpuPercents->append(0);
-    }
+    SampleHistory *history = ModelManager::instance()->sampleHistory();
+    cpuPercents = &history->series(SampleHistory::kCpuTotal);
 
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     DApplicationHelper *dAppHelper = DApplicationHelper::instance();
@@ -58,16 +58,7 @@ CpuMonitor::CpuMonitor(QWidget *parent)
     changeTheme(dAppHelper->themeType());
 
     m_cpuInfomodel = CPUInfoModel::instance();
-    connect(m_cpuInfomodel, &CPUInfoModel::modelUpdated, this, &CpuMonitor::updateStatus);
-
-    m_animation = new QPropertyAnimation(this, "progress", this);
-    m_animation->setDuration(20);
-    m_animation->setStartValue(0.0);
-    m_animation->setEndValue(1.0);
-    m_animation->setEasingCurve(QEasingCurve::OutQuad);
-    connect(m_animation, &QVariantAnimation::valueChanged, [ = ]() {
-        update();
-    });
+    connect(history, &SampleHistory::updated, this, &CpuMonitor::updateStatus);
 
     m_detailButton = new BaseCommandLinkButton(tr("Details"), this);
     DFontSizeManager::instance()->bind(m_detailButton, DFontSizeManager::T8, QFont::Medium);
@@ -81,7 +72,6 @@ CpuMonitor::CpuMonitor(QWidget *parent)
 CpuMonitor::~CpuMonitor()
 {
     // qCDebug(app) << "CpuMonitor destructor";
-    delete cpuPercents;
 }
 
 void CpuMonitor::onDetailInfoClicked()
@@ -154,34 +144,35 @@ void CpuMonitor::updateStatus()
         qCWarning(app) << "cpuAllPercent is nan";
         return;
     }
-    cpuPercents->append(m_cpuInfomodel->cpuAllPercent());
 
-    if (cpuPercents->size() > pointsNumber) {
-        cpuPercents->pop_front();
+    // the latest pointsNumber samples, oldest first, samples not recorded yet read as 0
+    QList<double> percents;
+    for (int i = pointsNumber - 1; i >= 0; i--) {
+        percents.append(cpuPercents->recent(size_t(i)));
     }
 
     QList<QPointF> points;
 
     double cpuMaxHeight = 0;
-    for (int i = 0; i < cpuPercents->size(); i++) {
-        if (cpuPercents->at(i) > cpuMaxHeight) {
-            cpuMaxHeight = cpuPercents->at(i);
+    for (int i = 0; i < percents.size(); i++) {
+        if (percents.at(i) > cpuMaxHeight) {
+            cpuMaxHeight = percents.at(i);
         }
     }
 
-    for (int i = 0; i < cpuPercents->size(); i++) {
+    for (int i = 0; i < percents.size(); i++) {
         if (cpuMaxHeight < cpuRenderMaxHeight) {
-            points.append(QPointF(i * 5 - 8, cpuPercents->at(i)));
+            points.append(QPointF(i * 5 - 8, percents.at(i)));
         } else {
             // qCDebug(app) << "cpuMaxHeight >= cpuRenderMaxHeight";
             points.append(
-                QPointF(i * 5 - 8, cpuPercents->at(i) * cpuRenderMaxHeight / cpuMaxHeight));
+                QPointF(i * 5 - 8, percents.at(i) * cpuRenderMaxHeight / cpuMaxHeight));
         }
     }
 
     cpuPath = SmoothCurveGenerator::generateSmoothCurve(points);
 
-    m_animation->start();
+    FrameClock::instance()->start(this, 20, QEasingCurve::OutQuad, [this](qreal p) { setProgress(p); });
 }
 
 void CpuMonitor::changeFont(const QFont &font)
@@ -246,8 +237,8 @@ void CpuMonitor::paintEvent(QPaintEvent *)
                    iconSize, iconSize);
     m_icon.paint(&painter, iconRect);
 
-    auto cdiff = cpuPercents->last() - cpuPercents->at(cpuPercents->size() - 2);
-    double percent = (cpuPercents->at(cpuPercents->size() - 2) + m_progress * cdiff);
+    auto cdiff = cpuPercents->recent(0) - cpuPercents->recent(1);
+    double percent = (cpuPercents->recent(1) + m_progress * cdiff);
 
     painter.setFont(m_cpuUsageFont);
     painter.setPen(QPen(numberColor));
@@ -6,6 +6,8 @@
 #ifndef CpuMONITOR_H
 #define CpuMONITOR_H
 
+#include "common/series_ring.h"
+
 #include <QIcon>
 #include <QList>
 #include <QWidget>
@@ -21,7 +23,6 @@ DGUI_USE_NAMESPACE
 #include <DCommandLinkButton>
 
 class Settings;
-class QPropertyAnimation;
 class CPUInfoModel;
 class BaseCommandLinkButton;
 
@@ -79,7 +80,8 @@ protected:
 private:
     QIcon m_icon;
 
-    QList<double> *cpuPercents;
+    // overall usage history, kept by the shared sample history
+    const common::core::SeriesRing *cpuPercents;
     QPainterPath cpuPath;
     QColor numberColor;
     QColor ringBackgroundColor;
@@ -106,7 +108,6 @@ private:
     QFont m_detailFont;
 
     qreal m_progress {};
-    QPropertyAnimation *m_animation {};
     CPUInfoModel *m_cpuInfomodel;
 
     BaseCommandLinkButton *m_detailButton;
@@ -66,6 +66,22 @@ public Q_SLOTS:  // METHODS
         return {ec, msg};
     }
 
+    /**
+     * @brief asyncGetAll Ask all properties of an interface without blocking, no proxy object is made
+     * @param service Service name
+     * @param path Object path
+     * @param interfaceName Interface name
+     * @param connection DBus connection
+     * @return Pending call, replied with an a{sv} property map
+     */
+    static inline QDBusPendingCall asyncGetAll(const QString &service, const QString &path,
+                                               const QString &interfaceName, const QDBusConnection &connection)
+    {
+        auto msg = QDBusMessage::createMethodCall(service, path, staticInterfaceName(), QStringLiteral("GetAll"));
+        msg << interfaceName;
+        return connection.asyncCall(msg);
+    }
+
 Q_SIGNALS:  // SIGNALS
     /**
      * @brief PropertiesChanged Service properties changed signal
@@ -5,6 +5,8 @@
 #include "dbusforsystemomonitorpluginservce.h"
 #include "detailwidgetmanager.h"
 #include "application.h"
+#include "common/perf_trace.h"
+#include "common/trace_log.h"
 #include <QApplication>
 #include <QTimer>
 DBusForSystemoMonitorPluginServce::DBusForSystemoMonitorPluginServce(QObject *parent) : QObject (parent)
@@ -41,3 +43,17 @@ void DBusForSystemoMonitorPluginServce::slotRaiseWindow()
         gApp->raiseWindow();
     }
 }
+
+QString DBusForSystemoMonitorPluginServce::dumpPerfTrace()
+{
+#ifdef PERF_TRACE
+    return QString::fromStdString(common::trace::chromeTraceJson());
+#else
+    return QStringLiteral("{\"traceEvents\":[]}");
+#endif
+}
+
+QString DBusForSystemoMonitorPluginServce::dumpTraceLog()
+{
+    return QString::fromStdString(common::log::logRing().dumpJson());
+}
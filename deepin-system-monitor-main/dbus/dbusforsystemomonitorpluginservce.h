@@ -32,6 +32,18 @@ public slots:
     //! \brief slotRaiseWindow 窗口置顶显示
     //!
     Q_SCRIPTABLE void slotRaiseWindow();
+
+    //!
+    //! \brief dumpPerfTrace 导出采样各阶段耗时，Chrome trace JSON格式，未以ENABLE_PERF_TRACE编译时事件为空
+    //! \return JSON文本，可在chrome://tracing或Perfetto中打开
+    //!
+    Q_SCRIPTABLE QString dumpPerfTrace();
+
+    //!
+    //! \brief dumpTraceLog 导出内存中最近的采样循环日志，含被限速丢弃的条数
+    //! \return 每行一个JSON对象：time、level、tid、site、suppressed、message
+    //!
+    Q_SCRIPTABLE QString dumpTraceLog();
 };
 
 #endif // DBUSFORSYSTEMOMONITORPLUGINSERVCE_H
@@ -33,12 +33,20 @@ DGUI_USE_NAMESPACE
 const int margin = 10;
 // content spacing
 const int spacing = 10;
+// elided texts kept, a few screens of cells
+const int elidedTextCacheSize = 4096;
 
 // constructor
 BaseItemDelegate::BaseItemDelegate(QObject *parent)
     : QStyledItemDelegate(parent)
+    , m_elidedTexts(elidedTextCacheSize)
 {
     qCDebug(app) << "BaseItemDelegate constructor";
+    // icons rendered after the paint that asked for them replace their placeholders
+    if (auto *view = qobject_cast<QAbstractItemView *>(parent)) {
+        connect(core::process::ProcessIconCache::instance(), &core::process::ProcessIconCache::iconsRendered,
+                view->viewport(), QOverload<>::of(&QWidget::update));
+    }
 }
 
 // paint method for this delegate
@@ -103,10 +111,11 @@ void BaseItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opti
 #endif
 
     QPen forground;
-    if (index.data(Qt::UserRole + 2).isValid()) {
+    const QVariant &colorType = index.data(Qt::UserRole + 2);
+    if (colorType.isValid()) {
         // user provided text color (custom color used in treeview)
         // qCDebug(app) << "BaseItemDelegate paint: Using user-provided text color.";
-        forground.setColor(palette.color(cg, static_cast<DPalette::ColorType>(index.data(Qt::UserRole + 2).toInt())));
+        forground.setColor(palette.color(cg, static_cast<DPalette::ColorType>(colorType.toInt())));
     } else {
         // default text color
         // qCDebug(app) << "BaseItemDelegate paint: Using default text color.";
@@ -188,7 +197,7 @@ void BaseItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opti
             // | margin - icon - spacing - text - margin |
             textRect.setX(textRect.x() + margin + spacing + iconSize);
             textRect.setWidth(textRect.width() - margin);
-            text = fm.elidedText(opt.text, opt.textElideMode, textRect.width());
+            text = elidedText(fm, opt, textRect.width());
 
             iconRect = rect;
             iconRect.setX(rect.x() + margin);
@@ -200,7 +209,7 @@ void BaseItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opti
             textRect = rect;
             textRect.setX(textRect.x() + margin);
             textRect.setWidth(textRect.width() - margin);
-            text = fm.elidedText(opt.text, opt.textElideMode, textRect.width());
+            text = elidedText(fm, opt, textRect.width());
         }
     } else {
         // | margin - text - margin |
@@ -208,7 +217,7 @@ void BaseItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opti
         textRect = rect;
         textRect.setX(textRect.x() + margin);
         textRect.setWidth(textRect.width() - margin);
-        text = fm.elidedText(opt.text, opt.textElideMode, textRect.width());
+        text = elidedText(fm, opt, textRect.width());
     }
 
     // draw icon when decoration needed
@@ -221,35 +230,14 @@ void BaseItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opti
         auto diff = (iconRect.height() - iconSize) / 2;
         iconRect.adjust(0, diff, 0, -diff);
 
-        // Qt的QIcon::pixmap()接口返回QPixmap对象的内存不会回收，此处使用QPixmapCache类来管理进程图标内存资源
-        // 原有QPixmapCache::find接口返回的pixmap指针为空，改为返回pixmap引用对象，保证能根据进程名从缓存中获取到图标资源
+        // Qt的QIcon::pixmap()接口返回QPixmap对象的内存不会回收，此处使用ProcessIconCache来管理进程图标内存资源
         // https://pms.uniontech.com/bug-view-239575.html
-        const QString &procName = index.data(Qt::UserRole + 4).toString();
-
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        QPixmap iconPixmap;
-        core::process::ProcessIconCache::instance()->iconPixmapCache.find(procName, iconPixmap);
-        if (!iconPixmap.isNull()) {
-            // qCDebug(app) << "BaseItemDelegate paint: Drawing icon from cache for process" << procName;
-            painter->drawPixmap(iconRect, iconPixmap);
-        } else {
-            // qCDebug(app) << "BaseItemDelegate paint: Icon not in cache, generating and drawing for process" << procName;
-            const QPixmap &iconPix = icon.pixmap(iconRect.size());
-            core::process::ProcessIconCache::instance()->iconPixmapCache.insert(procName, iconPix);
-            painter->drawPixmap(iconRect, iconPix);
-        }
-#else
-        QPixmap iconPixmap;
-        if (core::process::ProcessIconCache::instance()->iconPixmapCache.find(procName, &iconPixmap)) {
-            // qCDebug(app) << "BaseItemDelegate paint: Drawing icon from cache for process" << procName;
-            painter->drawPixmap(iconRect, iconPixmap);
-        } else {
-            // qCDebug(app) << "BaseItemDelegate paint: Icon not in cache, generating and drawing for process" << procName;
-            const QPixmap &iconPix = icon.pixmap(iconRect.size());
-            core::process::ProcessIconCache::instance()->iconPixmapCache.insert(procName, iconPix);
-            painter->drawPixmap(iconRect, iconPix);
-        }
-#endif
+        // rendered once per icon & size, not on every paint
+        const QString &iconKey = index.data(Qt::UserRole + 4).toString();
+        if (iconKey.isEmpty())
+            painter->drawPixmap(iconRect, icon.pixmap(iconRect.size()));
+        else
+            painter->drawPixmap(iconRect, core::process::ProcessIconCache::instance()->pixmap(iconKey, icon, iconRect.size()));
     }
     // draw content text
     // qCDebug(app) << "BaseItemDelegate paint: Drawing text:" << text;
@@ -357,8 +345,9 @@ void BaseItemDelegate::initStyleOption(QStyleOptionViewItem *option, const QMode
     option->showDecorationSelected = true;
     bool ok = false;
     // text alignment option
-    if (index.data(Qt::TextAlignmentRole).isValid()) {
-        uint value = index.data(Qt::TextAlignmentRole).toUInt(&ok);
+    const QVariant &alignment = index.data(Qt::TextAlignmentRole);
+    if (alignment.isValid()) {
+        uint value = alignment.toUInt(&ok);
         option->displayAlignment = static_cast<Qt::Alignment>(value);
         qCDebug(app) << "BaseItemDelegate initStyleOption: TextAlignmentRole is valid, alignment set to" << option->displayAlignment;
     }
@@ -371,15 +360,29 @@ void BaseItemDelegate::initStyleOption(QStyleOptionViewItem *option, const QMode
     option->textElideMode = Qt::ElideRight;
     // has display role
     option->features = QStyleOptionViewItem::HasDisplay;
-    if (index.data(Qt::DisplayRole).isValid()) {
-        option->text = index.data().toString();
+    const QVariant &display = index.data(Qt::DisplayRole);
+    if (display.isValid()) {
+        option->text = display.toString();
         qCDebug(app) << "BaseItemDelegate initStyleOption: DisplayRole is valid, text set to" << option->text;
     }
 
     // check if has decoration role
-    if (index.data(Qt::DecorationRole).isValid()) {
+    const QVariant &decoration = index.data(Qt::DecorationRole);
+    if (decoration.isValid()) {
         option->features |= QStyleOptionViewItem::HasDecoration;
-        option->icon = qvariant_cast<QIcon>(index.data(Qt::DecorationRole));
+        option->icon = qvariant_cast<QIcon>(decoration);
         qCDebug(app) << "BaseItemDelegate initStyleOption: DecorationRole is valid.";
     }
 }
+
+// elided text of the option, cached until text, font or width changes
+QString BaseItemDelegate::elidedText(const QFontMetrics &fm, const QStyleOptionViewItem &option, int width) const
+{
+    const QString &key = QString("%1\n%2\n%3\n%4").arg(width).arg(int(option.textElideMode)).arg(option.font.key(), option.text);
+    if (const QString *text = m_elidedTexts.object(key))
+        return *text;
+
+    const QString &text = fm.elidedText(option.text, option.textElideMode, width);
+    m_elidedTexts.insert(key, new QString(text));
+    return text;
+}
@@ -6,8 +6,10 @@
 #ifndef BASE_ITEM_DELEGATE_H
 #define BASE_ITEM_DELEGATE_H
 
+#include <QCache>
 #include <QStyledItemDelegate>
 
+class QFontMetrics;
 class QModelIndex;
 class QPainter;
 class QStyleOptionViewItem;
@@ -73,6 +75,19 @@ protected:
      * @param index Index to get model data
      */
     void initStyleOption(QStyleOptionViewItem *option, const QModelIndex &index) const override;
+
+private:
+    /**
+     * @brief elidedText Elided text of the option, cached until text, font or width changes
+     * @param fm Font metrics of the option's font
+     * @param option Style option holding text & elide mode
+     * @param width Width available to the text
+     * @return Elided text
+     */
+    QString elidedText(const QFontMetrics &fm, const QStyleOptionViewItem &option, int width) const;
+
+    // elided texts keyed by width, font & text, eliding shapes the whole text on each repaint otherwise
+    mutable QCache<QString, QString> m_elidedTexts;
 };
 
 #endif  // BASE_ITEM_DELEGATE_H
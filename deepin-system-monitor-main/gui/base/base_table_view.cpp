@@ -8,6 +8,7 @@
 #include "base_header_view.h"
 #include "base_item_delegate.h"
 #include "ddlog.h"
+#include "common/perf_trace.h"
 
 #include <DApplication>
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -118,6 +119,7 @@ void BaseTableView::setModel(QAbstractItemModel *model)
 // paint event handler
 void BaseTableView::paintEvent(QPaintEvent *event)
 {
+    PERF_TRACE_SCOPE(kStagePaint);
     // qCDebug(app) << "BaseTableView paintEvent";
     // viewport's painter object
     QPainter painter(viewport());
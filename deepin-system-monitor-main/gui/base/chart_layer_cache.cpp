@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "chart_layer_cache.h"
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+#include <DApplicationHelper>
+DWIDGET_USE_NAMESPACE
+#else
+#include <DGuiApplicationHelper>
+DGUI_USE_NAMESPACE
+#endif
+
+#include <QPainter>
+#include <QPixmapCache>
+#include <QWidget>
+
+QString ChartLayerCache::cacheKey(const QWidget *widget, const QString &key)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    int themeType = DApplicationHelper::instance()->themeType();
+#else
+    int themeType = DGuiApplicationHelper::instance()->themeType();
+#endif
+    return QString("chart-layer:%1x%2@%3:%4:%5")
+        .arg(widget->width())
+        .arg(widget->height())
+        .arg(widget->devicePixelRatioF())
+        .arg(themeType)
+        .arg(key);
+}
+
+QPixmap ChartLayerCache::layer(const QString &cacheKey, const QSize &size, qreal dpr, const DrawFunction &draw)
+{
+    QPixmap pixmap;
+    if (QPixmapCache::find(cacheKey, &pixmap))
+        return pixmap;
+
+    // drawn at device resolution, stays sharp on scaled screens
+    pixmap = QPixmap(size * dpr);
+    pixmap.setDevicePixelRatio(dpr);
+    pixmap.fill(Qt::transparent);
+    {
+        QPainter painter(&pixmap);
+        draw(painter);
+    }
+    QPixmapCache::insert(cacheKey, pixmap);
+    return pixmap;
+}
@@ -0,0 +1,38 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CHART_LAYER_CACHE_H
+#define CHART_LAYER_CACHE_H
+
+#include <QPixmap>
+#include <QString>
+
+#include <functional>
+
+class QPainter;
+class QWidget;
+
+/**
+ * @brief Static chart layers (frame, grid & axis labels) drawn once & shared in QPixmapCache
+ *
+ * Layers are keyed by widget size, device pixel ratio, theme & whatever else the caller draws from,
+ * identical tiles such as the per core charts blit one pixmap and only draw their data on top.
+ */
+class ChartLayerCache
+{
+public:
+    using DrawFunction = std::function<void(QPainter &painter)>;
+
+    /**
+     * @brief Key of a layer of widget
+     * @param key What the layer depends on besides size, DPR & theme, e.g. kind, font & labels
+     */
+    static QString cacheKey(const QWidget *widget, const QString &key);
+    /**
+     * @brief Layer of cacheKey, drawn into a transparent pixmap of size & dpr on a cache miss
+     */
+    static QPixmap layer(const QString &cacheKey, const QSize &size, qreal dpr, const DrawFunction &draw);
+};
+
+#endif // CHART_LAYER_CACHE_H
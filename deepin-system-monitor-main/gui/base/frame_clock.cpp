@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "frame_clock.h"
+
+#include <QGuiApplication>
+#include <QScreen>
+
+// fallback when the screen doesn't report its refresh rate
+#define DEFAULT_FRAME_INTERVAL 16
+
+FrameClock::FrameClock(QObject *parent)
+    : QObject(parent)
+{
+    m_frameTimer.setSingleShot(true);
+    m_frameTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_frameTimer, &QTimer::timeout, this, &FrameClock::tick);
+    m_clock.start();
+}
+
+FrameClock *FrameClock::instance()
+{
+    static FrameClock clock;
+    return &clock;
+}
+
+bool FrameClock::start(QWidget *widget, int duration, const QEasingCurve &easing,
+                       const StepFunction &step, const FinishedFunction &finished)
+{
+    if (!widget || isAnimating(widget))
+        return false;
+
+    // nothing to see, settle right away instead of waking up for frames
+    if (!isShowing(widget) || duration <= 0) {
+        step(1.);
+        if (finished)
+            finished();
+        return true;
+    }
+
+    m_animations << Animation {widget, duration, m_clock.elapsed(), easing, step, finished};
+    scheduleFrame();
+    return true;
+}
+
+bool FrameClock::isAnimating(const QWidget *widget) const
+{
+    for (const Animation &animation : m_animations) {
+        if (animation.widget == widget)
+            return true;
+    }
+    return false;
+}
+
+void FrameClock::requestUpdate(QWidget *widget)
+{
+    if (!widget || !isShowing(widget))
+        return;
+
+    if (!m_dirtyWidgets.contains(widget))
+        m_dirtyWidgets << widget;
+    scheduleFrame();
+}
+
+bool FrameClock::isShowing(const QWidget *widget)
+{
+    return widget->isVisible() && !widget->window()->isMinimized();
+}
+
+void FrameClock::scheduleFrame()
+{
+    if (m_frameTimer.isActive() || (m_animations.isEmpty() && m_dirtyWidgets.isEmpty()))
+        return;
+    m_frameTimer.start(frameInterval());
+}
+
+void FrameClock::tick()
+{
+    const qint64 now = m_clock.elapsed();
+
+    // animations started from the callbacks below land in m_animations & run from the next frame
+    QList<Animation> animations;
+    animations.swap(m_animations);
+    QList<FinishedFunction> finished;
+    for (const Animation &animation : animations) {
+        if (!animation.widget)
+            continue;
+
+        qreal progress = 1.;
+        if (isShowing(animation.widget))
+            progress = qMin(1., qreal(now - animation.startTime) / animation.duration);
+        animation.step(progress < 1. ? animation.easing.valueForProgress(progress) : 1.);
+
+        if (!m_dirtyWidgets.contains(animation.widget))
+            m_dirtyWidgets << animation.widget;
+        if (progress < 1.)
+            m_animations << animation;
+        else if (animation.finished)
+            finished << animation.finished;
+    }
+
+    // one repaint per widget, Qt merges them into one paint of each window
+    QList<QPointer<QWidget>> widgets;
+    widgets.swap(m_dirtyWidgets);
+    for (const QPointer<QWidget> &widget : widgets) {
+        if (widget)
+            widget->update();
+    }
+
+    for (const FinishedFunction &function : finished)
+        function();
+
+    scheduleFrame();
+}
+
+int FrameClock::frameInterval() const
+{
+    QScreen *screen = QGuiApplication::primaryScreen();
+    if (!screen || screen->refreshRate() < 1)
+        return DEFAULT_FRAME_INTERVAL;
+    return qMax(1, int(1000 / screen->refreshRate()));
+}
@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef FRAME_CLOCK_H
+#define FRAME_CLOCK_H
+
+#include <QEasingCurve>
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QWidget>
+
+#include <functional>
+
+/**
+ * @brief One frame timer all monitor widgets animate & repaint from
+ *
+ * Animations are stepped in a single pass per frame, then every widget touched is repainted once.
+ * The timer only runs while something is animating or waiting for a repaint. Widgets hidden or in
+ * a minimized window skip to the end of their animation without waiting for a frame.
+ */
+class FrameClock : public QObject
+{
+    Q_OBJECT
+
+public:
+    using StepFunction = std::function<void(qreal progress)>;
+    using FinishedFunction = std::function<void()>;
+
+    explicit FrameClock(QObject *parent = nullptr);
+    static FrameClock *instance();
+
+    /**
+     * @brief Animate widget from progress 0 to 1 over duration, widget is repainted after each step
+     * @param step Called with the eased progress every frame, last with 1
+     * @param finished Called once after the last step
+     * @return false when widget is already animating, the running animation is kept
+     */
+    bool start(QWidget *widget, int duration, const QEasingCurve &easing,
+               const StepFunction &step, const FinishedFunction &finished = FinishedFunction());
+    bool isAnimating(const QWidget *widget) const;
+    /**
+     * @brief Repaint widget on the next frame, requests within a frame end in one repaint
+     */
+    void requestUpdate(QWidget *widget);
+
+    inline bool isActive() const { return m_frameTimer.isActive(); }
+
+private:
+    struct Animation {
+        QPointer<QWidget> widget;
+        int duration;
+        qint64 startTime;
+        QEasingCurve easing;
+        StepFunction step;
+        FinishedFunction finished;
+    };
+
+    static bool isShowing(const QWidget *widget);
+    void scheduleFrame();
+    void tick();
+    int frameInterval() const;
+
+    QList<Animation> m_animations;
+    QList<QPointer<QWidget>> m_dirtyWidgets;
+    QTimer m_frameTimer;
+    QElapsedTimer m_clock;
+};
+
+#endif // FRAME_CLOCK_H
@@ -6,12 +6,19 @@
 #include "block_dev_detail_view_widget.h"
 #include "block_dev_stat_view_widget.h"
 #include "block_dev_summary_view_widget.h"
+#include "pressure_view_widget.h"
+#include "filesystem_view_widget.h"
+#include "block_latency_heatmap_widget.h"
+#include "model/disk_health_model.h"
 #include "ddlog.h"
 
 #include <DApplication>
 
 using namespace DDLog;
 
+// disks are read by the system server every few minutes, this only picks up new results
+#define DISK_HEALTH_REFRESH_INTERVAL 10000
+
 BlockDevDetailViewWidget::BlockDevDetailViewWidget(QWidget *parent)
     : BaseDetailViewWidget(parent)
 {
@@ -21,9 +28,22 @@ BlockDevDetailViewWidget::BlockDevDetailViewWidget(QWidget *parent)
     setTitle(DApplication::translate("Process.Graph.View", "Disks"));
     m_blockStatWidget = new BlockStatViewWidget(this);
     m_blocksummaryWidget = new BlockDevSummaryViewWidget(this);
+    m_pressureWidget = new PressureViewWidget(common::pressure::kIOPressure, this);
+    m_latencyWidget = new BlockLatencyHeatmapWidget(this);
+    m_filesystemWidget = new FilesystemViewWidget(this);
     m_centralLayout->addWidget(m_blockStatWidget);
     m_centralLayout->addWidget(m_blocksummaryWidget);
+    m_centralLayout->addWidget(m_pressureWidget);
+    m_centralLayout->addWidget(m_latencyWidget);
+    m_centralLayout->addWidget(m_filesystemWidget);
     connect(m_blockStatWidget, &BlockStatViewWidget::changeInfo, m_blocksummaryWidget, &BlockDevSummaryViewWidget::chageSummaryInfo);
+    connect(m_blockStatWidget, &BlockStatViewWidget::changeInfo, m_latencyWidget, &BlockLatencyHeatmapWidget::setDevice);
+
+    m_healthModel = new DiskHealthModel(this);
+    m_blockStatWidget->setHealthModel(m_healthModel);
+    m_blocksummaryWidget->setHealthModel(m_healthModel);
+    m_healthTimer.setInterval(DISK_HEALTH_REFRESH_INTERVAL);
+    connect(&m_healthTimer, &QTimer::timeout, this, &BlockDevDetailViewWidget::refreshHealth);
 
     detailFontChanged(DApplication::font());
 }
@@ -38,4 +58,31 @@ void BlockDevDetailViewWidget::detailFontChanged(const QFont &font)
     BaseDetailViewWidget::detailFontChanged(font);
     m_blockStatWidget->fontChanged(font);
     m_blocksummaryWidget->fontChanged(font);
+    m_pressureWidget->fontChanged(font);
+    m_latencyWidget->fontChanged(font);
+    m_filesystemWidget->fontChanged(font);
+}
+
+void BlockDevDetailViewWidget::showEvent(QShowEvent *event)
+{
+    BaseDetailViewWidget::showEvent(event);
+    refreshHealth();
+    if (m_healthModel->isAvailable())
+        m_healthTimer.start();
+}
+
+void BlockDevDetailViewWidget::hideEvent(QHideEvent *event)
+{
+    m_healthTimer.stop();
+    m_healthModel->stop();
+    BaseDetailViewWidget::hideEvent(event);
+}
+
+void BlockDevDetailViewWidget::refreshHealth()
+{
+    m_healthModel->refresh();
+    if (!m_healthModel->isAvailable()) {
+        qCDebug(app) << "Disk health unavailable";
+        m_healthTimer.stop();
+    }
 }
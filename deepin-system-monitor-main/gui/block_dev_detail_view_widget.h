@@ -8,11 +8,17 @@
 
 #include "base/base_detail_view_widget.h"
 
+#include <QTimer>
+
 /**
  * @brief Block device detail view widget
  */
 class BlockStatViewWidget;
 class BlockDevSummaryViewWidget;
+class PressureViewWidget;
+class FilesystemViewWidget;
+class BlockLatencyHeatmapWidget;
+class DiskHealthModel;
 class BlockDevDetailViewWidget : public BaseDetailViewWidget
 {
     Q_OBJECT
@@ -23,9 +29,22 @@ public:
 public slots:
     void detailFontChanged(const QFont &font);
 
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void refreshHealth();
+
 private:
     BlockStatViewWidget *m_blockStatWidget;
     BlockDevSummaryViewWidget *m_blocksummaryWidget;
+    PressureViewWidget *m_pressureWidget;
+    BlockLatencyHeatmapWidget *m_latencyWidget;
+    FilesystemViewWidget *m_filesystemWidget;
+    // SMART health shown by the disk items & summary, fetched only while the page is shown
+    DiskHealthModel *m_healthModel;
+    QTimer m_healthTimer;
 
 };
 
@@ -6,6 +6,8 @@
 #include "block_dev_item_widget.h"
 #include "chart_view_widget.h"
 #include "common/common.h"
+#include "model/model_manager.h"
+#include "model/sample_history.h"
 #include "ddlog.h"
 
 #include <QPen>
@@ -36,6 +38,13 @@ BlockDevItemWidget::BlockDevItemWidget(QWidget *parent) : QWidget(parent)
     m_memChartWidget->setSpeedAxis(true);
     m_memChartWidget->setData1Color(readColor);
     m_memChartWidget->setData2Color(writeColor);
+
+    m_utilChartWidget = new ChartViewWidget(ChartViewWidget::ChartViewTypes::BLOCK_CHART, this);
+    m_utilChartWidget->setData1Color(utilColor);
+
+    SampleHistory *history = ModelManager::instance()->sampleHistory();
+    connect(history, &SampleHistory::updated, m_memChartWidget, &ChartViewWidget::updateSeries);
+    connect(history, &SampleHistory::updated, m_utilChartWidget, &ChartViewWidget::updateSeries);
 }
 
 BlockDevItemWidget::~BlockDevItemWidget()
@@ -46,6 +55,10 @@ BlockDevItemWidget::~BlockDevItemWidget()
         delete m_memChartWidget;
         m_memChartWidget = nullptr;
     }
+    if (m_utilChartWidget) {
+        delete m_utilChartWidget;
+        m_utilChartWidget = nullptr;
+    }
 }
 
 void BlockDevItemWidget::updateWidgetGeometry()
@@ -55,13 +68,21 @@ void BlockDevItemWidget::updateWidgetGeometry()
     font.setPointSizeF(font.pointSizeF() - 1);
     int fontHeight = QFontMetrics(font).height();
     int curXMargin = m_mode == TITLE_HORIZONTAL ? 0 : margin;
+    QRect chartRect;
     if (m_mode == TITLE_HORIZONTAL) {
         qCDebug(app) << "BlockDevItemWidget updateWidgetGeometry m_mode == TITLE_HORIZONTAL";
-        m_memChartWidget->setGeometry(curXMargin, TextSpacing, this->width() - 2 * curXMargin, this->height() - TextSpacing - margin);
+        chartRect = QRect(curXMargin, TextSpacing, this->width() - 2 * curXMargin, this->height() - TextSpacing - margin);
     } else {
         qCDebug(app) << "BlockDevItemWidget updateWidgetGeometry m_mode == TITLE_VERTICAL";
-        m_memChartWidget->setGeometry(curXMargin, fontHeight * 2 + TextSpacing, this->width() - 2 * curXMargin, this->height() - fontHeight * 2 - TextSpacing - margin);
+        chartRect = QRect(curXMargin, fontHeight * 2 + TextSpacing, this->width() - 2 * curXMargin, this->height() - fontHeight * 2 - TextSpacing - margin);
     }
+
+    // speed chart on top, util chart with its title takes the lower third
+    int utilHeight = qMax(0, (chartRect.height() - fontHeight - spacing) / 3);
+    int speedHeight = qMax(0, chartRect.height() - utilHeight - fontHeight - spacing);
+    m_memChartWidget->setGeometry(chartRect.x(), chartRect.y(), chartRect.width(), speedHeight);
+    m_utilTitleRect = QRect(chartRect.x(), chartRect.y() + speedHeight + spacing, chartRect.width(), fontHeight);
+    m_utilChartWidget->setGeometry(chartRect.x(), m_utilTitleRect.bottom() + 1, chartRect.width(), utilHeight);
 }
 
 void BlockDevItemWidget::fontChanged(const QFont &font)
@@ -82,13 +103,32 @@ void BlockDevItemWidget::updateData(const BlockDevice &info)
 {
     // qCDebug(app) << "BlockDevItemWidget updateData for" << info.deviceName();
     m_blokeDeviceInfo = info;
-    m_memChartWidget->addData1(info.readSpeed());
-    m_memChartWidget->addData2(info.writeSpeed());
-    m_memChartWidget->update();
+    // charts follow the device history once the device shown is known
+    if (m_seriesDevice != info.deviceName()) {
+        m_seriesDevice = info.deviceName();
+        SampleHistory *history = ModelManager::instance()->sampleHistory();
+        const QString &device = QString::fromUtf8(m_seriesDevice);
+        m_memChartWidget->setSeries1(&history->series(SampleHistory::kDiskRead, device));
+        m_memChartWidget->setSeries2(&history->series(SampleHistory::kDiskWrite, device));
+        // chart without speed axis is scaled to 0 ~ 1
+        m_utilChartWidget->setSeries1(&history->series(SampleHistory::kDiskUtil, device));
+        m_memChartWidget->setStoredSeries1(SampleHistory::kDiskRead, device);
+        m_memChartWidget->setStoredSeries2(SampleHistory::kDiskWrite, device);
+        m_utilChartWidget->setStoredSeries1(SampleHistory::kDiskUtil, device);
+    }
 
     this->update();
 }
 
+void BlockDevItemWidget::setHealth(const QString &text, bool warning)
+{
+    if (m_healthText == text && m_healthWarning == warning)
+        return;
+    m_healthText = text;
+    m_healthWarning = warning;
+    update();
+}
+
 void BlockDevItemWidget::activeItemWidget(bool isShow)
 {
     qCDebug(app) << "BlockDevItemWidget activeItemWidget" << isShow;
@@ -149,6 +189,14 @@ void BlockDevItemWidget::paintEvent(QPaintEvent *event)
     }
     painter.drawText(devtitleRect, deviceName);
     painter.setPen(textColor);
+    if (!m_healthText.isEmpty()) {
+        QRect healthRect(devtitleRect.right() + spacing * 2, devtitleRect.y(), width() - devtitleRect.right() - spacing * 2 - margin, deviceNameHeight);
+        if (m_healthWarning)
+            painter.setPen(palette.color(DPalette::TextWarning));
+        painter.drawText(healthRect, Qt::AlignLeft | Qt::AlignVCenter,
+                         painter.fontMetrics().elidedText(m_healthText, Qt::ElideRight, healthRect.width()));
+        painter.setPen(textColor);
+    }
 
     QString readTitle = QString("%1 %2")
                         .arg(tr("Read"))
@@ -203,6 +251,21 @@ void BlockDevItemWidget::paintEvent(QPaintEvent *event)
         painter.setPen(palette.color(DPalette::TextTips));
         painter.drawText(writeStrRect, writeTitle);
     }
+
+    QString utilTitle = QString("%1 %2%   %3 %4 ms   %5 %6")
+                        .arg(tr("Utilization"))
+                        .arg(m_blokeDeviceInfo.percentUtilization(), 0, 'f', 1)
+                        .arg(tr("Await"))
+                        .arg(m_blokeDeviceInfo.await(), 0, 'f', 2)
+                        .arg(tr("Queue depth"))
+                        .arg(m_blokeDeviceInfo.queueDepth(), 0, 'f', 2);
+    QRect utilStrRect = m_utilTitleRect.adjusted(spacing + sectionSize, 0, 0, 0);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(utilColor);
+    painter.drawEllipse(m_utilTitleRect.left(), m_utilTitleRect.y() + qCeil((m_utilTitleRect.height() - sectionSize) / 2.0), sectionSize, sectionSize);
+    painter.setPen(palette.color(DPalette::TextTips));
+    painter.drawText(utilStrRect, Qt::AlignLeft | Qt::AlignVCenter,
+                     painter.fontMetrics().elidedText(utilTitle, Qt::ElideRight, utilStrRect.width()));
 }
 
 void BlockDevItemWidget::setMode(int mode)
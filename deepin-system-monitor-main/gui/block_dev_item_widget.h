@@ -40,6 +40,10 @@ public slots:
 public:
     void updateData(const BlockDevice &info);
     void setMode(int mode);
+    /**
+     * @brief Temperature & SMART state drawn after the device name, empty to hide
+     */
+    void setHealth(const QString &text, bool warning);
     bool isActiveItem() { return  m_isActive;}
 
 private:
@@ -49,13 +53,18 @@ private:
     int m_mode = TITLE_HORIZONTAL;
     QColor readColor {"#8F88FF"};
     QColor writeColor {"#6AD787"};
+    QColor utilColor {"#FEA43F"};
     ChartViewWidget *m_memChartWidget;
+    // %util history, the data we look at when a disk saturates
+    ChartViewWidget *m_utilChartWidget;
+    QRect m_utilTitleRect;
 
     QFont m_font;
     BlockDevice  m_blokeDeviceInfo;
-    QList<qreal> m_listWriteSpeed;
-    QList<qreal> m_listReadSpeed;
+    QByteArray m_seriesDevice; // device the charts follow in the sample history
     bool m_isActive = false;
+    QString m_healthText;
+    bool m_healthWarning = false;
 };
 
 #endif // BLOCK_DEV_ITEM_WIDGET_H
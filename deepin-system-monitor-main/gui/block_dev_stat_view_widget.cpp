@@ -5,9 +5,12 @@
 
 #include "block_dev_stat_view_widget.h"
 #include "block_dev_item_widget.h"
-#include "system/system_monitor.h"
+#include "model/disk_health_model.h"
+#include "model/model_manager.h"
+#include "model/update_coordinator.h"
 #include "system/block_device_info_db.h"
 #include "system/device_db.h"
+#include "system/device_snapshot.h"
 #include "ddlog.h"
 #include <QThread>
 #include <QGridLayout>
@@ -24,7 +27,14 @@ BlockStatViewWidget::BlockStatViewWidget(QWidget *parent) : QScrollArea(parent)
     this->setFrameShape(QFrame::NoFrame);
 
     onUpdateData();
-    connect(SystemMonitor::instance(), &SystemMonitor::statInfoUpdated, this, &BlockStatViewWidget::onUpdateData);
+    connect(ModelManager::instance()->updateCoordinator(), &UpdateCoordinator::updateViews, this, &BlockStatViewWidget::onUpdateData);
+}
+
+void BlockStatViewWidget::setHealthModel(DiskHealthModel *model)
+{
+    m_healthModel = model;
+    connect(m_healthModel, &DiskHealthModel::updated, this, &BlockStatViewWidget::updateHealth);
+    updateHealth();
 }
 
 void BlockStatViewWidget::resizeEvent(QResizeEvent *event)
@@ -202,7 +212,7 @@ void BlockStatViewWidget::showItemLg2(int count)
 void BlockStatViewWidget::onUpdateData()
 {
     qCDebug(app) << "BlockStatViewWidget onUpdateData";
-    m_listDevice = DeviceDB::instance()->blockDeviceInfoDB()->deviceList();
+    m_listDevice = DeviceDB::instance()->snapshot()->blockDevices;
     m_mapDeviceItemWidget.clear();
 
     int deviceCount = m_listDevice.size();
@@ -214,4 +224,18 @@ void BlockStatViewWidget::onUpdateData()
         connect(item, &BlockDevItemWidget::clicked, this, &BlockStatViewWidget::onSetItemStatus);
     }
     updateWidgetGeometry();
+    updateHealth();
+}
+
+void BlockStatViewWidget::updateHealth()
+{
+    // items show the devices in list order
+    const int count = qMin(m_listDevice.size(), m_listBlockItemWidget.size());
+    for (int i = 0; i < count; ++i) {
+        disk_health_record_t rec {};
+        if (m_healthModel && m_healthModel->health(QString::fromUtf8(m_listDevice[i].deviceName()), rec))
+            m_listBlockItemWidget[i]->setHealth(DiskHealthModel::summaryText(rec), DiskHealthModel::isWarning(rec));
+        else
+            m_listBlockItemWidget[i]->setHealth(QString(), false);
+    }
 }
@@ -13,11 +13,13 @@
 using namespace core::system;
 
 class BlockDevItemWidget;
+class DiskHealthModel;
 class BlockStatViewWidget : public QScrollArea
 {
     Q_OBJECT
 public:
     explicit BlockStatViewWidget(QWidget *parent = nullptr);
+    void setHealthModel(DiskHealthModel *model);
 
 signals:
     void changeInfo(const QString &deviceName);
@@ -36,6 +38,7 @@ private:
     void showItem2();
     void showItemLg2(int count);
     void resetMapInfo();
+    void updateHealth();
 
 private:
     QList<BlockDevice> m_listDevice;
@@ -45,6 +48,7 @@ private:
 
     QWidget *m_centralWidget;
     QFont m_font;
+    DiskHealthModel *m_healthModel {nullptr};
 };
 
 #endif // BLOCK_DEV_STAT_VIEW_WIDGET_H
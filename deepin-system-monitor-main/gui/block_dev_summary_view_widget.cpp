@@ -4,7 +4,10 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "block_dev_summary_view_widget.h"
+#include "model/model_manager.h"
+#include "model/update_coordinator.h"
 #include "system/device_db.h"
+#include "system/device_snapshot.h"
 #include "common/common.h"
 #include "system/block_device_info_db.h"
 #include "common/thread_manager.h"
@@ -14,6 +17,7 @@
 #include "system/block_device_info_db.h"
 #include "system/device_db.h"
 #include "base/base_detail_item_delegate.h"
+#include "model/disk_health_model.h"
 #include "ddlog.h"
 
 #include <QHeaderView>
@@ -45,7 +49,7 @@ protected:
     int rowCount(const QModelIndex &) const
     {
         // qCDebug(app) << "DeailTableModelBlock::rowCount";
-        return 7;
+        return 11;
     }
 
     int columnCount(const QModelIndex &) const
@@ -107,6 +111,30 @@ protected:
                 else if (column == 1)
                     return QApplication::translate("DeailTableModelBlock", "Writes merged/s");
                 break;
+            case 7:
+                if (column == 0)
+                    return QApplication::translate("DeailTableModelBlock", "Utilization");
+                else if (column == 1)
+                    return QApplication::translate("DeailTableModelBlock", "Queue depth");
+                break;
+            case 8:
+                if (column == 0)
+                    return QApplication::translate("DeailTableModelBlock", "Await");
+                else if (column == 1)
+                    return QApplication::translate("DeailTableModelBlock", "Service time");
+                break;
+            case 9:
+                if (column == 0)
+                    return QApplication::translate("DeailTableModelBlock", "In flight");
+                else if (column == 1)
+                    return QApplication::translate("DeailTableModelBlock", "Discard speed");
+                break;
+            case 10:
+                if (column == 0)
+                    return QApplication::translate("DeailTableModelBlock", "Health");
+                else if (column == 1)
+                    return QApplication::translate("DeailTableModelBlock", "Temperature");
+                break;
 
             }
         } else if (role == Qt::UserRole) {
@@ -153,6 +181,31 @@ protected:
                 else if (column == 1)
                     return m_blockInfo.writeRequestMergedPerSecond();
                 break;
+            case  7:
+                if (column == 0)
+                    return QString("%1%").arg(m_blockInfo.percentUtilization(), 0, 'f', 1);
+                else if (column == 1)
+                    return QString::number(m_blockInfo.queueDepth(), 'f', 2);
+                break;
+            case  8:
+                if (column == 0)
+                    return QString("%1 ms").arg(m_blockInfo.await(), 0, 'f', 2);
+                else if (column == 1)
+                    return QString("%1 ms").arg(m_blockInfo.serviceTime(), 0, 'f', 2);
+                break;
+            case  9:
+                if (column == 0)
+                    return m_blockInfo.inFlight();
+                else if (column == 1)
+                    return formatUnit_memory_disk(m_blockInfo.discardSpeed(), B, 1, true);
+                break;
+            case  10: {
+                disk_health_record_t rec {};
+                if (!m_health || !m_health->health(currDeciveName, rec))
+                    return QString("-");
+                const QString text = column == 0 ? DiskHealthModel::stateText(rec) : DiskHealthModel::temperatureText(rec);
+                return text.isEmpty() ? QString("-") : text;
+            }
             }
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
         } else if (role == Qt::TextColorRole) {
@@ -176,6 +229,12 @@ public slots:
     void updateModel();
 
 public:
+    void setHealthModel(DiskHealthModel *model)
+    {
+        m_health = model;
+        connect(m_health, &DiskHealthModel::updated, this, &DeailTableModelBlock::updateModel);
+    }
+
     void setCurrentName(const QString &str)
     {
         // qCDebug(app) << "DeailTableModelBlock::setCurrentName:" << str;
@@ -191,12 +250,13 @@ private:
     QString currDeciveName;
     BlockDevice m_blockInfo;
     QMap<QString, BlockDevice> m_mapInfo;
+    DiskHealthModel *m_health {nullptr};
 };
 
 DeailTableModelBlock::DeailTableModelBlock(QObject *parent): QAbstractTableModel(parent)
 {
     qCDebug(app) << "DeailTableModelBlock constructor";
-    connect(SystemMonitor::instance(), &SystemMonitor::statInfoUpdated, this, &DeailTableModelBlock::updateModel);
+    connect(ModelManager::instance()->updateCoordinator(), &UpdateCoordinator::updateModels, this, &DeailTableModelBlock::updateModel);
     updateModel();
 }
 
@@ -204,7 +264,7 @@ void DeailTableModelBlock::updateModel()
 {
     qCDebug(app) << "DeailTableModelBlock::updateModel";
     beginResetModel();
-    const QList<BlockDevice> &infoDB = DeviceDB::instance()->blockDeviceInfoDB()->deviceList();
+    const QList<BlockDevice> infoDB = DeviceDB::instance()->snapshot()->blockDevices;
 
     for (int i = 0; i < infoDB.size(); ++i) {
         m_mapInfo.insert(infoDB[i].deviceName(), infoDB[i]);
@@ -264,6 +324,11 @@ BlockDevSummaryViewWidget::BlockDevSummaryViewWidget(QWidget *parent)
                 this, &BlockDevSummaryViewWidget::fontChanged);
 }
 
+void BlockDevSummaryViewWidget::setHealthModel(DiskHealthModel *model)
+{
+    m_model->setHealthModel(model);
+}
+
 void BlockDevSummaryViewWidget::chageSummaryInfo(const QString &deviceName)
 {
     qCDebug(app) << "BlockDevSummaryViewWidget::chageSummaryInfo for" << deviceName;
@@ -275,7 +340,7 @@ void BlockDevSummaryViewWidget::fontChanged(const QFont &font)
     qCDebug(app) << "BlockDevSummaryViewWidget::fontChanged";
     m_font = font;
     this->setFont(m_font);
-    setFixedHeight(260);
+    setFixedHeight(286);
 }
 void BlockDevSummaryViewWidget::paintEvent(QPaintEvent *event)
 {
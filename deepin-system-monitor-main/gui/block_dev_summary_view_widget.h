@@ -12,11 +12,13 @@ DWIDGET_USE_NAMESPACE
  * @brief Block device summary view widget
  */
 class DeailTableModelBlock;
+class DiskHealthModel;
 class BlockDevSummaryViewWidget : public DTableView
 {
     Q_OBJECT
 public:
     explicit BlockDevSummaryViewWidget(QWidget *parent = nullptr);
+    void setHealthModel(DiskHealthModel *model);
 
 signals:
 
@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "block_latency_heatmap_widget.h"
+#include "process_info_record.h"
+#include "ddlog.h"
+
+#include <DApplicationHelper>
+#include <DPalette>
+
+#include <QPainter>
+#include <QtMath>
+
+DWIDGET_USE_NAMESPACE
+using namespace DDLog;
+
+// latency totals are cached by the system server for a second
+#define BLOCK_LATENCY_REFRESH_INTERVAL 2000
+#define BLOCK_LATENCY_VIEW_HEIGHT 200
+
+namespace {
+
+const int kAxisWidth = 48;
+const int kTitleSpacing = 4;
+
+QString latencyText(qreal us)
+{
+    if (us >= 1000000)
+        return QString("%1 s").arg(us / 1000000, 0, 'f', us >= 10000000 ? 0 : 1);
+    if (us >= 1000)
+        return QString("%1 ms").arg(us / 1000, 0, 'f', us >= 10000 ? 0 : 1);
+    return QString("%1 %2s").arg(us, 0, 'f', 0).arg(QChar(0x00b5));
+}
+
+} // namespace
+
+BlockLatencyHeatmapWidget::BlockLatencyHeatmapWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    qCDebug(app) << "BlockLatencyHeatmapWidget constructor";
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    setFixedHeight(BLOCK_LATENCY_VIEW_HEIGHT);
+
+    m_model = new BlockLatencyModel(this);
+    connect(m_model, &BlockLatencyModel::updated, this, QOverload<>::of(&QWidget::update));
+    m_timer.setInterval(BLOCK_LATENCY_REFRESH_INTERVAL);
+    connect(&m_timer, &QTimer::timeout, this, &BlockLatencyHeatmapWidget::refreshLatency);
+}
+
+void BlockLatencyHeatmapWidget::setDevice(const QString &device)
+{
+    m_device = device;
+    update();
+}
+
+void BlockLatencyHeatmapWidget::fontChanged(const QFont &font)
+{
+    setFont(font);
+    update();
+}
+
+void BlockLatencyHeatmapWidget::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    // trace requests only while they are looked at
+    refreshLatency();
+    if (m_model->isAvailable())
+        m_timer.start();
+}
+
+void BlockLatencyHeatmapWidget::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    m_timer.stop();
+    m_model->stop();
+}
+
+void BlockLatencyHeatmapWidget::refreshLatency()
+{
+    m_model->refresh();
+    if (!m_model->isAvailable()) {
+        qCDebug(app) << "Block latency unavailable, heatmap hidden";
+        m_timer.stop();
+        setVisible(false);
+    }
+}
+
+void BlockLatencyHeatmapWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.setFont(font());
+    const QFontMetrics fm = painter.fontMetrics();
+    auto palette = DApplicationHelper::instance()->palette(this);
+    const int half = height() / 2;
+
+    const struct {
+        bool write;
+        QString title;
+    } maps[] = {{false, tr("Read latency")}, {true, tr("Write latency")}};
+    for (int i = 0; i < 2; ++i) {
+        const QList<BlockLatencyModel::Column> columns = m_model->history(m_device, maps[i].write);
+        const QRect area(0, i * half, width(), half);
+
+        QString title = maps[i].title;
+        if (!columns.isEmpty()) {
+            const qreal p99 = BlockLatencyModel::percentile(columns.last(), 99);
+            if (p99 > 0)
+                title += "  " + tr("p99 < %1").arg(latencyText(p99));
+        }
+        painter.setPen(palette.color(DPalette::TextTips));
+        painter.drawText(QRect(area.left(), area.top(), area.width(), fm.height()), Qt::AlignLeft | Qt::AlignVCenter, title);
+
+        const QRect plot(area.left() + kAxisWidth, area.top() + fm.height() + kTitleSpacing,
+                         area.width() - kAxisWidth, area.height() - fm.height() - 2 * kTitleSpacing);
+        // bucket lower bounds: 1us, 1ms, 1s
+        for (int bucket : {0, 10, 20}) {
+            const int y = plot.bottom() - (bucket + 1) * plot.height() / BLOCK_LATENCY_BUCKETS;
+            painter.drawText(QRect(area.left(), y, kAxisWidth - kTitleSpacing, plot.height() / BLOCK_LATENCY_BUCKETS + fm.height()),
+                             Qt::AlignRight | Qt::AlignTop, latencyText(qreal(1ULL << bucket)));
+        }
+        paintHeatmap(painter, plot, columns);
+    }
+}
+
+void BlockLatencyHeatmapWidget::paintHeatmap(QPainter &painter, const QRect &rect, const QList<BlockLatencyModel::Column> &columns)
+{
+    auto palette = DApplicationHelper::instance()->palette(this);
+    QColor background = palette.color(DPalette::ItemBackground);
+    painter.fillRect(rect, background);
+    if (columns.isEmpty())
+        return;
+
+    quint64 peak = 0;
+    for (const BlockLatencyModel::Column &column : columns) {
+        for (quint64 count : column)
+            peak = qMax(peak, count);
+    }
+    if (peak == 0)
+        return;
+
+    // log scale, a handful of slow requests stays visible next to thousands of fast ones
+    const QColor highlight = palette.color(DPalette::Highlight);
+    const qreal scale = qLn(qreal(peak) + 1);
+    const qreal cellWidth = qreal(rect.width()) / BlockLatencyModel::kHistorySize;
+    const qreal cellHeight = qreal(rect.height()) / BLOCK_LATENCY_BUCKETS;
+    // newest column on the right edge
+    const int offset = BlockLatencyModel::kHistorySize - columns.size();
+    for (int c = 0; c < columns.size(); ++c) {
+        const BlockLatencyModel::Column &column = columns[c];
+        for (int b = 0; b < column.size(); ++b) {
+            if (column[b] == 0)
+                continue;
+            QColor color = highlight;
+            color.setAlphaF(0.15 + 0.85 * qLn(qreal(column[b]) + 1) / scale);
+            const QRectF cell(rect.left() + (offset + c) * cellWidth, rect.bottom() + 1 - (b + 1) * cellHeight,
+                              cellWidth, cellHeight);
+            painter.fillRect(cell, color);
+        }
+    }
+}
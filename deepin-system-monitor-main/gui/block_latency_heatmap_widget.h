@@ -0,0 +1,45 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef BLOCK_LATENCY_HEATMAP_WIDGET_H
+#define BLOCK_LATENCY_HEATMAP_WIDGET_H
+
+#include "model/block_latency_model.h"
+
+#include <QTimer>
+#include <QWidget>
+
+/**
+ * @brief Heatmaps of the request latency of one disk, reads above writes
+ *
+ * Time runs left to right, one column per refresh, latency bottom to top in log2 buckets,
+ * the more requests completed in a bucket the stronger its cell. Tail latency shows as cells
+ * high up that averages of /proc/diskstats hide. Requests are traced only while shown, the
+ * widget hides itself when tracing is unavailable.
+ */
+class BlockLatencyHeatmapWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit BlockLatencyHeatmapWidget(QWidget *parent = nullptr);
+
+public slots:
+    void setDevice(const QString &device);
+    void fontChanged(const QFont &font);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    void refreshLatency();
+    void paintHeatmap(QPainter &painter, const QRect &rect, const QList<BlockLatencyModel::Column> &columns);
+
+    BlockLatencyModel *m_model;
+    QTimer m_timer;
+    QString m_device;
+};
+
+#endif // BLOCK_LATENCY_HEATMAP_WIDGET_H
@@ -5,9 +5,15 @@
 
 #include "chart_view_widget.h"
 #include "common/common.h"
+#include "gui/base/chart_layer_cache.h"
+#include "model/model_manager.h"
+#include "model/sample_history.h"
 #include "ddlog.h"
 
+#include <QDateTime>
 #include <QPainter>
+#include <QTransform>
+#include <QWheelEvent>
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
 #include <DApplicationHelper>
 #else
@@ -16,12 +22,22 @@
 #include <DApplication>
 #include <DFontSizeManager>
 
+#include <cmath>
+
 using namespace common::format;
 using namespace DDLog;
 
 DWIDGET_USE_NAMESPACE
 const int allDatacount = 30;
-ChartViewWidget::ChartViewWidget(ChartViewTypes types, QWidget *parent) : QWidget(parent), m_viewType(types)
+// charted span of each zoom level, ms, the first is the live series
+const qint64 kZoomSpans[] = {60 * 1000LL, 10 * 60 * 1000LL, 3600 * 1000LL, 6 * 3600 * 1000LL, 24 * 3600 * 1000LL,
+                             7 * 24 * 3600 * 1000LL};
+const int kZoomCount = int(sizeof(kZoomSpans) / sizeof(kZoomSpans[0]));
+ChartViewWidget::ChartViewWidget(ChartViewTypes types, QWidget *parent)
+    : QWidget(parent)
+    , m_data1(allDatacount + 1)
+    , m_data2(allDatacount + 1)
+    , m_viewType(types)
 {
     qCDebug(app) << "ChartViewWidget constructor, type:" << m_viewType;
     changeFont(DApplication::font());
@@ -38,7 +54,7 @@ ChartViewWidget::ChartViewWidget(ChartViewTypes types, QWidget *parent) : QWidge
 void ChartViewWidget::changeTheme()
 {
     qCDebug(app) << "ChartViewWidget::changeTheme";
-    drawBackPixmap();
+    // the layer of the new theme is picked on paint
     update();
 }
 
@@ -47,9 +63,9 @@ void ChartViewWidget::setSpeedAxis(bool speed)
     qCDebug(app) << "ChartViewWidget::setSpeedAxis:" << speed;
     m_speedAxis = speed;
     if (m_viewType == BLOCK_CHART || m_viewType == MEM_CHART)
-        setAxisTitle(formatUnit_memory_disk(qMax(m_maxData1.toLongLong(), m_maxData2.toLongLong()), B, 1, true));
+        setAxisTitle(formatUnit_memory_disk(m_maxData, B, 1, true));
     else
-        setAxisTitle(formatUnit_net(qMax(m_maxData1.toLongLong(), m_maxData2.toLongLong()), B, 1, true));
+        setAxisTitle(formatUnit_net(m_maxData, B, 1, true));
 }
 
 void ChartViewWidget::setData1Color(const QColor &color)
@@ -58,43 +74,11 @@ void ChartViewWidget::setData1Color(const QColor &color)
     m_data1Color = color;
 }
 
-void ChartViewWidget::addData1(const QVariant &data)
+void ChartViewWidget::addData1(qreal data)
 {
     // qCDebug(app) << "ChartViewWidget::addData1";
-    m_listData1 << data;
-    if (m_listData1.size() > allDatacount + 1) {
-        qCDebug(app) << "Data1 list is full, pop one";
-        m_listData1.pop_front();
-    }
-
-    auto maxElement = std::max_element(m_listData1.begin(), m_listData1.end(),
-        [](const QVariant &a, const QVariant &b) {
-            return a.toLongLong() < b.toLongLong();
-        });
-    const QVariant &maxdata = *maxElement;
-    if (maxdata.toLongLong() > 0 && maxdata != m_maxData1) {
-        qCDebug(app) << "Updating max data 1";
-        m_maxData1 = QVariant(maxdata.toLongLong() * 1.1);
-        m_maxData = qMax(m_maxData1.toLongLong(), m_maxData2.toLongLong());
-
-        // 这边需要通过当前的图标界面类型去区分, 内存和磁盘统一处理
-        if (m_speedAxis) {
-            if (m_viewType == BLOCK_CHART || m_viewType == MEM_CHART)
-                setAxisTitle(formatUnit_memory_disk(m_maxData, B, 1, true));
-            else
-                setAxisTitle(formatUnit_net(m_maxData, B, 1, true));
-        }
-
-    } else {
-        qCDebug(app) << "Data 1 is zero, setting axis to zero";
-        // when the data hold the zero num,we should set the chart max value as 0
-        if (m_speedAxis) {
-            if (m_viewType == BLOCK_CHART || m_viewType == MEM_CHART)
-                setAxisTitle(formatUnit_memory_disk(0, B, 1, true));
-            else
-                setAxisTitle(formatUnit_net(0, B, 1, true));
-        }
-    }
+    m_data1.push(data);
+    updateSeries();
 }
 
 void ChartViewWidget::setData2Color(const QColor &color)
@@ -103,41 +87,92 @@ void ChartViewWidget::setData2Color(const QColor &color)
     m_data2Color = color;
 }
 
-void ChartViewWidget::addData2(const QVariant &data)
+void ChartViewWidget::addData2(qreal data)
+{
+    m_data2.push(data);
+    updateSeries();
+}
+
+void ChartViewWidget::setSeries1(const common::core::SeriesRing *series)
+{
+    qCDebug(app) << "ChartViewWidget::setSeries1";
+    m_series1 = series ? series : &m_data1;
+    m_path1 = QPainterPath();
+    updateSeries();
+}
+
+void ChartViewWidget::setSeries2(const common::core::SeriesRing *series)
 {
-    m_listData2 << data;
-    if (m_listData2.size() > allDatacount + 1) {
-        qCDebug(app) << "Data2 list is full, pop one";
-        m_listData2.pop_front();
+    qCDebug(app) << "ChartViewWidget::setSeries2";
+    m_series2 = series ? series : &m_data2;
+    m_path2 = QPainterPath();
+    updateSeries();
+}
+
+void ChartViewWidget::setStoredSeries1(int metric, const QString &device)
+{
+    m_storedMetric1 = metric;
+    m_storedDevice1 = device;
+    if (m_zoom > 0)
+        loadStored();
+}
+
+void ChartViewWidget::setStoredSeries2(int metric, const QString &device)
+{
+    m_storedMetric2 = metric;
+    m_storedDevice2 = device;
+    if (m_zoom > 0)
+        loadStored();
+}
+
+void ChartViewWidget::updateSeries()
+{
+    appendPathSegment(*m_series1, m_path1);
+    appendPathSegment(*m_series2, m_path2);
+
+    if (m_zoom > 0) {
+        // a bucket is reread once a new one began
+        if (QDateTime::currentMSecsSinceEpoch() - m_storedAt >= kZoomSpans[m_zoom] / qMax(1, m_storedBuckets))
+            loadStored();
+        return;
     }
 
-    auto maxElement = std::max_element(m_listData2.begin(), m_listData2.end(),
-        [](const QVariant &a, const QVariant &b) {
-            return a.toDouble() < b.toDouble();
-        });
-    const QVariant &maxdata = *maxElement;
-    if (maxdata.toLongLong() > 0 && maxdata != m_maxData2) {
-        qCDebug(app) << "Updating max data 2";
-        m_maxData2 = QVariant(maxdata.toLongLong() * 1.1);
-        m_maxData = qMax(m_maxData1.toLongLong(), m_maxData2.toLongLong());
-
-        if (m_speedAxis) {
-            if (m_viewType == BLOCK_CHART || m_viewType == MEM_CHART)
-                setAxisTitle(formatUnit_memory_disk(m_maxData, B, 1, true));
-            else
-                setAxisTitle(formatUnit_net(m_maxData, B, 1, true));
-        } else {
-            qCDebug(app) << "Data 2 is zero, setting axis to zero";
-            // when the data hold the zero num,we should set the chart max value as 0
-            if (m_speedAxis) {
-                if (m_viewType == BLOCK_CHART || m_viewType == MEM_CHART)
-                    setAxisTitle(formatUnit_memory_disk(0, B, 1, true));
-                else
-                    setAxisTitle(formatUnit_net(0, B, 1, true));
-            }
-        }
+    updateSeriesMax(*m_series1, m_maxData1);
+    updateSeriesMax(*m_series2, m_maxData2);
+    updateMaxData();
+    update();
+}
 
+void ChartViewWidget::updateSeriesMax(const common::core::SeriesRing &series, qreal &maxData)
+{
+    // running max of the ring, no rescan of the history
+    qlonglong maxdata = qRound64(series.max());
+    if (maxdata > 0)
+        maxData = maxdata * 1.1;
+}
+
+void ChartViewWidget::updateMaxData()
+{
+    m_maxData = qMax(qRound64(m_maxData1), qRound64(m_maxData2));
+    if (m_viewType == POWER_CHART) {
+        setAxisTitle(QString("%1 W").arg(m_maxData));
+        return;
+    }
+    if (m_viewType == TEMPERATURE_CHART) {
+        setAxisTitle(QString("%1 °C").arg(m_maxData));
+        return;
     }
+    if (!m_speedAxis)
+        return;
+
+    // 这边需要通过当前的图标界面类型去区分, 内存和磁盘统一处理
+    // when the data hold the zero num,we should set the chart max value as 0
+    qreal dataMax = m_zoom > 0 ? m_storedMax : qMax(m_series1->max(), m_series2->max());
+    qlonglong axisMax = qRound64(dataMax) > 0 ? m_maxData : 0;
+    if (m_viewType == BLOCK_CHART || m_viewType == MEM_CHART)
+        setAxisTitle(formatUnit_memory_disk(axisMax, B, 1, true));
+    else
+        setAxisTitle(formatUnit_net(axisMax, B, 1, true));
 }
 
 void ChartViewWidget::setAxisTitle(const QString &text)
@@ -159,86 +194,200 @@ void ChartViewWidget::resizeEvent(QResizeEvent *event)
     // qCDebug(app) << "ChartViewWidget::resizeEvent";
     QWidget::resizeEvent(event);
     drawBackPixmap();
+    if (m_zoom > 0)
+        loadStored();
 }
 
-void ChartViewWidget::getPainterPathByData(const QList<QVariant> &listData, QPainterPath &path, QVariant maxYvalue)
+void ChartViewWidget::wheelEvent(QWheelEvent *event)
 {
-    // qCDebug(app) << "ChartViewWidget::getPainterPathByData";
-    qreal offsetX = 0;
-    qreal distance = m_chartRect.width() * 1.0 / allDatacount;
-    int dataCount = listData.size();
-    int startIndex = qMax(0, dataCount - allDatacount - 1);
-
-    qlonglong maxL = maxYvalue.toLongLong();
-    const QVariant &lastData = listData.last();
-    if (lastData.canConvert(QMetaType::Double))
-        path.moveTo(offsetX, -m_chartRect.height() * lastData.toDouble() * 1.0 / maxL);
-    else
-        path.moveTo(offsetX, -m_chartRect.height() * lastData.toLongLong() * 1.0 / maxL);
-
-    for (int i = dataCount - 1;  i > startIndex; i--) {
-        QPointF sp;
-        QPointF ep;
-
-        if (listData[i].canConvert(QMetaType::Double)) {
-            sp = QPointF(offsetX, -m_chartRect.height() * listData[i].toDouble() / maxL);
-            ep = QPointF(offsetX - distance, -m_chartRect.height() * listData[i - 1].toDouble() / maxL);
-        } else {
-            sp = QPointF(offsetX, -m_chartRect.height() * listData[i].toLongLong() / maxL);
-            ep = QPointF(offsetX - distance, -m_chartRect.height() * listData[i - 1].toLongLong() / maxL);
-        }
+    if (m_storedMetric1 < 0 && m_storedMetric2 < 0) {
+        QWidget::wheelEvent(event);
+        return;
+    }
 
-        offsetX -= distance;
+    int delta = event->angleDelta().y();
+    int zoom = qBound(0, m_zoom + (delta < 0 ? 1 : delta > 0 ? -1 : 0), kZoomCount - 1);
+    event->accept();
+    if (zoom == m_zoom)
+        return;
 
-        QPointF c1 = QPointF((sp.x() + ep.x()) / 2.0, sp.y());
-        QPointF c2 = QPointF((sp.x() + ep.x()) / 2.0, ep.y());
-        path.cubicTo(c1, c2, ep);
+    qCDebug(app) << "ChartViewWidget zoom" << m_zoom << "->" << zoom;
+    m_zoom = zoom;
+    // scales of the other span don't apply
+    m_maxData1 = 1;
+    m_maxData2 = 1;
+    if (m_zoom > 0) {
+        loadStored();
+    } else {
+        m_storedPath1 = QPainterPath();
+        m_storedPath2 = QPainterPath();
+        updateSeries();
     }
+}
 
+void ChartViewWidget::loadStored()
+{
+    SampleHistory *history = ModelManager::instance()->sampleHistory();
+    m_storedBuckets = qMax(1, m_chartRect.width() / 2);
+    m_storedAt = QDateTime::currentMSecsSinceEpoch();
+    qint64 from = m_storedAt - kZoomSpans[m_zoom];
+
+    std::vector<double> values;
+    qreal max1 = 0;
+    qreal max2 = 0;
+    if (m_storedMetric1 >= 0)
+        values = history->stored(SampleHistory::Metric(m_storedMetric1), m_storedDevice1, from, m_storedAt, m_storedBuckets);
+    m_storedPath1 = storedPath(values, max1);
+    values.clear();
+    if (m_storedMetric2 >= 0)
+        values = history->stored(SampleHistory::Metric(m_storedMetric2), m_storedDevice2, from, m_storedAt, m_storedBuckets);
+    m_storedPath2 = storedPath(values, max2);
+
+    m_storedMax = qMax(max1, max2);
+    m_maxData1 = 1;
+    m_maxData2 = 1;
+    if (qRound64(max1) > 0)
+        m_maxData1 = qRound64(max1) * 1.1;
+    if (qRound64(max2) > 0)
+        m_maxData2 = qRound64(max2) * 1.1;
+    updateMaxData();
+    update();
 }
 
-void ChartViewWidget::drawData1(QPainter *painter)
+QPainterPath ChartViewWidget::storedPath(const std::vector<double> &values, qreal &dataMax)
 {
-    // qCDebug(app) << "ChartViewWidget::drawData1";
-    if (m_listData1.size() <= 0) {
-        qCDebug(app) << "No data for drawData1";
-        return;
+    // buckets nothing was recorded in, e.g. while the monitor wasn't running, break the line
+    QPainterPath path;
+    bool gap = true;
+    for (size_t i = 0; i < values.size(); ++i) {
+        double value = values[i];
+        if (std::isnan(value)) {
+            gap = true;
+            continue;
+        }
+        if (gap)
+            path.moveTo(i, value);
+        else
+            path.lineTo(i, value);
+        gap = false;
+        dataMax = qMax(dataMax, value);
     }
+    return path;
+}
+
+void ChartViewWidget::drawStored(QPainter *painter, const QPainterPath &path, const QColor &color)
+{
+    if (path.isEmpty())
+        return;
 
     painter->save();
     painter->setClipRect(m_chartRect.adjusted(1, -1, 1, 1));
 
-    QPainterPath path;
     painter->setBrush(Qt::NoBrush);
-    painter->setPen(QPen(m_data1Color, 1.5, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
-    painter->translate(m_chartRect.bottomRight() + QPoint(1, 1));
+    painter->setPen(QPen(color, 1.5, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+    painter->translate(m_chartRect.bottomLeft() + QPoint(0, 1));
 
-    getPainterPathByData(m_listData1, path, m_maxData);
-    painter->drawPath(path);
+    qreal distance = m_chartRect.width() * 1.0 / m_storedBuckets;
+    qreal scale = m_maxData > 0 ? m_chartRect.height() * 1.0 / m_maxData : 0;
+    QTransform transform(distance, 0, 0, -scale, distance / 2, 0);
+    painter->drawPath(transform.map(path));
     painter->restore();
 }
 
-void ChartViewWidget::drawData2(QPainter *painter)
+QString ChartViewWidget::spanText() const
 {
-    // qCDebug(app) << "ChartViewWidget::drawData2";
-    if (m_listData2.size() <= 0) {
-        qCDebug(app) << "No data for drawData2";
+    switch (m_zoom) {
+    case 1:
+        return tr("10 minutes");
+    case 2:
+        return tr("1 hour");
+    case 3:
+        return tr("6 hours");
+    case 4:
+        return tr("24 hours");
+    case 5:
+        return tr("7 days");
+    default: {
+        // the recent samples, their span follows the refresh interval
+        SampleHistory *history = ModelManager::instance()->sampleHistory();
+        return history->interval() == SampleHistory::kDefaultInterval ? tr("60 seconds") : history->spanText();
+    }
+    }
+}
+
+void ChartViewWidget::appendPathSegment(const common::core::SeriesRing &series, QPainterPath &path)
+{
+    if (series.empty()) {
+        path = QPainterPath();
+        return;
+    }
+
+    qreal seq = series.seq() - 1;
+    if (!path.isEmpty()) {
+        qreal end = path.currentPosition().x();
+        // shared series are followed by several charts, the path may already end at the newest sample
+        if (end == seq)
+            return;
+        // segments scrolled out are clipped when drawn, drop them once they are as many as the visible ones,
+        // rebuild as well when samples were missed while the chart wasn't following
+        if (end + 1 != seq || seq - path.elementAt(0).x > 2 * series.capacity())
+            path = QPainterPath();
+    }
+
+    if (path.isEmpty()) {
+        qreal x = series.seq() - series.size();
+        path.moveTo(x, series.at(0));
+        for (size_t i = 1; i < series.size(); ++i) {
+            x += 1;
+            path.cubicTo(x - .5, series.at(i - 1), x - .5, series.at(i), x, series.at(i));
+        }
+        return;
+    }
+
+    const QPointF &ep = path.currentPosition();
+    path.cubicTo(seq - .5, ep.y(), seq - .5, series.last(), seq, series.last());
+}
+
+void ChartViewWidget::drawSeries(QPainter *painter, const common::core::SeriesRing &series, const QPainterPath &path, const QColor &color)
+{
+    if (series.empty()) {
+        qCDebug(app) << "No data for drawSeries";
         return;
     }
 
     painter->save();
     painter->setClipRect(m_chartRect.adjusted(1, -1, 1, 1));
 
-    QPainterPath path;
     painter->setBrush(Qt::NoBrush);
-    painter->setPen(QPen(m_data2Color, 1.5, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+    painter->setPen(QPen(color, 1.5, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
     painter->translate(m_chartRect.bottomRight() + QPoint(1, 1));
 
-    getPainterPathByData(m_listData2, path, m_maxData);
-    painter->drawPath(path);
+    // newest sample at the right edge, one grid distance per sample
+    qreal distance = m_chartRect.width() * 1.0 / allDatacount;
+    qreal scale = m_maxData > 0 ? m_chartRect.height() * 1.0 / m_maxData : 0;
+    QTransform transform(distance, 0, 0, -scale, -(series.seq() - 1.) * distance, 0);
+    painter->drawPath(transform.map(path));
     painter->restore();
 }
 
+void ChartViewWidget::drawData1(QPainter *painter)
+{
+    // qCDebug(app) << "ChartViewWidget::drawData1";
+    if (m_zoom > 0)
+        drawStored(painter, m_storedPath1, m_data1Color);
+    else
+        drawSeries(painter, *m_series1, m_path1, m_data1Color);
+}
+
+void ChartViewWidget::drawData2(QPainter *painter)
+{
+    // qCDebug(app) << "ChartViewWidget::drawData2";
+    if (m_zoom > 0)
+        drawStored(painter, m_storedPath2, m_data2Color);
+    else
+        drawSeries(painter, *m_series2, m_path2, m_data2Color);
+}
+
 void ChartViewWidget::drawBackPixmap()
 {
     // qCDebug(app) << "ChartViewWidget::drawBackPixmap";
@@ -247,58 +396,61 @@ void ChartViewWidget::drawBackPixmap()
         return;
     }
 
-    m_backPixmap = QPixmap(this->size());
-    m_backPixmap.fill(Qt::transparent);
-
-    QPainter painter(&m_backPixmap);
-
-    // init colors
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    auto *dAppHelper = DApplicationHelper::instance();
-#else
-    auto *dAppHelper = DGuiApplicationHelper::instance();
-#endif
-    auto palette = dAppHelper->applicationPalette();
-    QColor frameColor = palette.color(DPalette::TextTips);
-    frameColor.setAlphaF(0.3);
-
     int penSize = 1;
-    painter.setPen(QPen(frameColor, penSize));
-    painter.setBrush(palette.color(QPalette::Base));
-    painter.setFont(m_textfont);
-
     int gridX = penSize;
-    int gridY = penSize + painter.fontMetrics().height();
+    int gridY = penSize + QFontMetrics(m_textfont).height();
     int gridWidth = this->width() - 2 * penSize;
     int gridHeight = this->height() - 2 * gridY;
-
-    QPainterPath framePath;
     m_chartRect = QRect(gridX, gridY, gridWidth, gridHeight);
 
-    framePath.addRect(m_chartRect);
-    painter.drawPath(framePath);
-
-    // Draw grid.
-    QPen gridPen;
-    QVector<qreal> dashes;
-    qreal space = 2;
-    dashes << space << space;
-    gridPen.setDashPattern(dashes);
-    gridPen.setColor(frameColor);
-    //set to 0 lead to line with always 1px
-    gridPen.setWidth(0);
-    painter.setPen(gridPen);
-
-    int gridLineX = gridX;
-    while (gridLineX + gridSize + penSize < gridX + gridWidth) {
-        gridLineX += gridSize + penSize;
-        painter.drawLine(gridLineX, gridY + 1, gridLineX, gridY + gridHeight - 1);
-    }
-    int gridLineY = gridY;
-    while (gridLineY + gridSize + penSize < gridY + gridHeight) {
-        gridLineY += gridSize + penSize;
-        painter.drawLine(gridX + 1, gridLineY, gridX + gridWidth - 1, gridLineY);
-    }
+    // frame, grid & axis labels only change with size, DPR, theme, font, axis max & zoom
+    QString key = ChartLayerCache::cacheKey(this, QString("chart:%1:%2:%3").arg(m_textfont.key()).arg(m_axisTitle).arg(spanText()));
+    if (key == m_backKey && !m_backPixmap.isNull())
+        return;
+    m_backKey = key;
+    m_backPixmap = ChartLayerCache::layer(key, size(), devicePixelRatioF(), [this, penSize](QPainter &painter) {
+        // init colors
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        auto *dAppHelper = DApplicationHelper::instance();
+#else
+        auto *dAppHelper = DGuiApplicationHelper::instance();
+#endif
+        auto palette = dAppHelper->applicationPalette();
+        QColor frameColor = palette.color(DPalette::TextTips);
+        frameColor.setAlphaF(0.3);
+
+        painter.setPen(QPen(frameColor, penSize));
+        painter.setBrush(palette.color(QPalette::Base));
+
+        QPainterPath framePath;
+        framePath.addRect(m_chartRect);
+        painter.drawPath(framePath);
+
+        // Draw grid.
+        QPen gridPen;
+        QVector<qreal> dashes;
+        qreal space = 2;
+        dashes << space << space;
+        gridPen.setDashPattern(dashes);
+        gridPen.setColor(frameColor);
+        //set to 0 lead to line with always 1px
+        gridPen.setWidth(0);
+        painter.setPen(gridPen);
+
+        int gridLineX = m_chartRect.x();
+        while (gridLineX + gridSize + penSize < m_chartRect.x() + m_chartRect.width()) {
+            gridLineX += gridSize + penSize;
+            painter.drawLine(gridLineX, m_chartRect.y() + 1, gridLineX, m_chartRect.y() + m_chartRect.height() - 1);
+        }
+        int gridLineY = m_chartRect.y();
+        while (gridLineY + gridSize + penSize < m_chartRect.y() + m_chartRect.height()) {
+            gridLineY += gridSize + penSize;
+            painter.drawLine(m_chartRect.x() + 1, gridLineY, m_chartRect.x() + m_chartRect.width() - 1, gridLineY);
+        }
+
+        painter.setRenderHint(QPainter::Antialiasing);
+        drawAxisText(&painter);
+    });
 }
 
 void ChartViewWidget::drawAxisText(QPainter *painter)
@@ -318,7 +470,7 @@ void ChartViewWidget::drawAxisText(QPainter *painter)
 
     QRect bottomTextRect(0, this->height() - painter->fontMetrics().height(), this->width(), painter->fontMetrics().height());
     painter->drawText(bottomTextRect, Qt::AlignRight | Qt::AlignVCenter, "0");
-    painter->drawText(bottomTextRect, Qt::AlignLeft | Qt::AlignVCenter, tr("60 seconds"));
+    painter->drawText(bottomTextRect, Qt::AlignLeft | Qt::AlignVCenter, spanText());
 }
 
 void ChartViewWidget::paintEvent(QPaintEvent *event)
@@ -326,11 +478,12 @@ void ChartViewWidget::paintEvent(QPaintEvent *event)
     // qCDebug(app) << "ChartViewWidget::paintEvent";
     QWidget::paintEvent(event);
 
+    // one blit of the static layer, only the data is drawn per tick
+    drawBackPixmap();
     QPainter painter(this);
     painter.setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform, true);
     painter.drawPixmap(0, 0, m_backPixmap);
 
     drawData1(&painter);
     drawData2(&painter);
-    drawAxisText(&painter);
 }
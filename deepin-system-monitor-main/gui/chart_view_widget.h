@@ -6,10 +6,13 @@
 #ifndef CHART_VIEW_WIDGET_H
 #define CHART_VIEW_WIDGET_H
 
+#include "common/series_ring.h"
+
 #include <QWidget>
-#include <QVariant>
 #include <QPainterPath>
 
+#include <vector>
+
 class ChartViewWidget : public QWidget
 {
     Q_OBJECT
@@ -18,23 +21,45 @@ public:
     enum ChartViewTypes {
         MEM_CHART,      //内存
         NET_CHART,      //网络
-        BLOCK_CHART     //磁盘
+        BLOCK_CHART,    //磁盘
+        POWER_CHART,    //功耗, W
+        TEMPERATURE_CHART   //温度, °C & percent on the same axis
     };
     explicit ChartViewWidget(ChartViewWidget::ChartViewTypes types, QWidget *parent = nullptr);
 
 
 public:
     void setData1Color(const QColor &color);
-    void addData1(const QVariant &data);
+    void addData1(qreal data);
 
     void setData2Color(const QColor &color);
-    void addData2(const QVariant &data);
+    void addData2(qreal data);
+
+    /**
+     * @brief Chart a series kept elsewhere instead of the samples added to this widget, see SampleHistory
+     * @param series Series to chart, must outlive the widget
+     */
+    void setSeries1(const common::core::SeriesRing *series);
+    void setSeries2(const common::core::SeriesRing *series);
+    /**
+     * @brief Follow the charted series after they got new samples
+     */
+    void updateSeries();
+    /**
+     * @brief Series of the on-disk history charted once zoomed out past the last minute, see SampleHistory::stored
+     * @param metric SampleHistory::Metric, -1 for none
+     * @param device Device of per device metrics
+     */
+    void setStoredSeries1(int metric, const QString &device = {});
+    void setStoredSeries2(int metric, const QString &device = {});
 
     void setSpeedAxis(bool speed);
 
 protected:
     void paintEvent(QPaintEvent *);
     void resizeEvent(QResizeEvent *event);
+    // zooms out to the on-disk history, in to the live series
+    void wheelEvent(QWheelEvent *event);
 
 private slots:
     void changeFont(const QFont &font);
@@ -48,7 +73,16 @@ private:
     void drawAxisText(QPainter *painter);
 
     void setAxisTitle(const QString &text);
-    void getPainterPathByData(const QList<QVariant> &listData, QPainterPath &path,  QVariant maxYvalue);
+    void updateMaxData();
+    static void updateSeriesMax(const common::core::SeriesRing &series, qreal &maxData);
+    // path is kept in sample space (x: sample seq, y: value), a new sample only appends one segment
+    void appendPathSegment(const common::core::SeriesRing &series, QPainterPath &path);
+    void drawSeries(QPainter *painter, const common::core::SeriesRing &series, const QPainterPath &path, const QColor &color);
+    // reads the zoomed span of the stored series, one bucket every other pixel
+    void loadStored();
+    static QPainterPath storedPath(const std::vector<double> &values, qreal &dataMax);
+    void drawStored(QPainter *painter, const QPainterPath &path, const QColor &color);
+    QString spanText() const;
 
 private:
     int gridSize = 10;
@@ -56,7 +90,9 @@ private:
     QString m_axisTitle = {"100%"};
 
     QFont m_textfont;
+    // shared static layer, see ChartLayerCache
     QPixmap m_backPixmap = QPixmap();
+    QString m_backKey;
 
     QRect m_chartRect;
     QColor m_data1Color = {"#00C5C0"};
@@ -64,12 +100,29 @@ private:
 
     bool  m_speedAxis = false;
 
-    QVariant m_maxData  = 1;
-    QVariant m_maxData1 = 1;
-    QVariant m_maxData2 = 1;
-
-    QList<QVariant> m_listData1;
-    QList<QVariant> m_listData2;
+    qlonglong m_maxData = 1;
+    qreal m_maxData1 = 1;
+    qreal m_maxData2 = 1;
+
+    common::core::SeriesRing m_data1;
+    common::core::SeriesRing m_data2;
+    QPainterPath m_path1;
+    QPainterPath m_path2;
+    // charted series, the own rings unless a shared series is set
+    const common::core::SeriesRing *m_series1 = &m_data1;
+    const common::core::SeriesRing *m_series2 = &m_data2;
+
+    // zoomed out spans read from the on-disk history, 0 follows the live series
+    int m_zoom = 0;
+    int m_storedMetric1 = -1;
+    int m_storedMetric2 = -1;
+    QString m_storedDevice1;
+    QString m_storedDevice2;
+    QPainterPath m_storedPath1;
+    QPainterPath m_storedPath2;
+    int m_storedBuckets = 0;
+    qint64 m_storedAt = 0;
+    qreal m_storedMax = 0;
 
     ChartViewTypes m_viewType = ChartViewTypes::MEM_CHART;  // 图表界面类型
 };
@@ -7,12 +7,24 @@
 #include "model/cpu_info_model.h"
 #include "smooth_curve_generator.h"
 #include "common/common.h"
+#include "gui/base/chart_layer_cache.h"
 #include "process/process_db.h"
 #include "system/device_db.h"
 #include "model/cpu_info_model.h"
 #include "model/cpu_list_model.h"
+#include "model/model_manager.h"
+#include "model/sample_history.h"
 #include "system/cpu_set.h"
+#include "system/demand_tracker.h"
 #include "cpu_summary_view_widget.h"
+#include "cpu_irq_view_widget.h"
+#include "pressure_view_widget.h"
+#include "power_view_widget.h"
+#include "virtualization_view_widget.h"
+#include "sensor_view_widget.h"
+#include "wakeup_view_widget.h"
+#include "numa_view_widget.h"
+#include "cpu_freq_heatmap_widget.h"
 #include "ddlog.h"
 
 #include <DApplication>
@@ -30,6 +42,7 @@
 #include <QDebug>
 #include <QPainter>
 #include <QPainterPath>
+#include <QTransform>
 #include <QtMath>
 #include <QMouseEvent>
 #include <QGridLayout>
@@ -47,7 +60,8 @@ CPUDetailGrapTableItem::CPUDetailGrapTableItem(CPUInfoModel *model, int index, Q
 {
     qCDebug(app) << "CPUDetailGrapTableItem constructor for index" << index;
     m_cpuInfomodel = CPUInfoModel::instance();
-    connect(m_cpuInfomodel, &CPUInfoModel::modelUpdated, this, &CPUDetailGrapTableItem::updateStat);
+    bindSeries();
+    connect(ModelManager::instance()->sampleHistory(), &SampleHistory::updated, this, &CPUDetailGrapTableItem::updateStat);
 }
 
 CPUDetailGrapTableItem::~CPUDetailGrapTableItem()
@@ -82,26 +96,29 @@ void CPUDetailGrapTableItem::setColor(QColor color)
     update();
 }
 
-void CPUDetailGrapTableItem::updateStat()
+void CPUDetailGrapTableItem::setMultiCoreMode(bool isMutilCoreMode)
 {
-    qCDebug(app) << "CPUDetailGrapTableItem::updateStat";
+    m_isMutliCoreMode = isMutilCoreMode;
+    bindSeries();
+}
+
+void CPUDetailGrapTableItem::bindSeries()
+{
+    SampleHistory *history = ModelManager::instance()->sampleHistory();
     // 多核模式时保留原来逻辑
     if (m_isMutliCoreMode) {
-        if (std::isnan(m_cpuInfomodel->cpuPercentList().value(m_index))) {
-            m_cpuPercents.insert(0, 0);
-        } else {
-            m_cpuPercents.insert(0, m_cpuInfomodel->cpuPercentList().value(m_index) / 100.0);
-        }
+        // per cpu usage is listed in cpu id order, hotplug may shift the ids behind an index
+        int cpu = m_cpuInfomodel->cpuSet()->cpuIds().value(m_index, m_index);
+        m_series = &history->series(SampleHistory::kCpuCore, QString::number(cpu));
     } else {
-        if (std::isnan(m_cpuInfomodel->cpuAllPercent())) {
-            m_cpuPercents.insert(0, 0);
-        } else {
-            m_cpuPercents.insert(0, m_cpuInfomodel->cpuAllPercent() / 100.0);
-        }
+        m_series = &history->series(SampleHistory::kCpuTotal);
     }
-    while (m_cpuPercents.count() > 31)
-        m_cpuPercents.pop_back();
+}
 
+void CPUDetailGrapTableItem::updateStat()
+{
+    qCDebug(app) << "CPUDetailGrapTableItem::updateStat";
+    bindSeries();
     update();
 }
 
@@ -132,66 +149,64 @@ void CPUDetailGrapTableItem::drawNormalMode(QPainter &painter)
     midFont.setPointSizeF(font.pointSizeF() - 1);
 
     int textHeight = painter.fontMetrics().height();
-    //draw background
-    QRect graphicRect = QRect(pensize, textHeight, this->width() - 2 * pensize, this->height() - textHeight - QFontMetrics(midFont).height());
-    drawBackground(painter, graphicRect);
-
-    //draw text
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     auto *dAppHelper = DApplicationHelper::instance();
 #else
     auto *dAppHelper = DGuiApplicationHelper::instance();
 #endif
     auto palette = dAppHelper->applicationPalette();
+
+    //draw background, frame, grid & axis labels are one layer shared by all tiles of the same size
+    QRect graphicRect = QRect(pensize, textHeight, this->width() - 2 * pensize, this->height() - textHeight - QFontMetrics(midFont).height());
+    const QString &span = spanText();
+    QString key = ChartLayerCache::cacheKey(this, "cpu-normal:" + font.key() + ":" + span);
+    painter.drawPixmap(0, 0, ChartLayerCache::layer(key, size(), devicePixelRatioF(), [&](QPainter &layerPainter) {
+        drawBackground(layerPainter, graphicRect);
+
+        layerPainter.setRenderHints(QPainter::Antialiasing);
+        layerPainter.setFont(midFont);
+        int midTextHeight = layerPainter.fontMetrics().height();
+        QColor midTextColor(palette.color(DPalette::ToolTipText));
+        midTextColor.setAlphaF(0.3);
+        layerPainter.setPen(midTextColor);
+        layerPainter.drawText(QRect(pensize, 0, this->width() - 2 * pensize, textHeight), Qt::AlignRight | Qt::AlignBottom, "100%");
+        layerPainter.drawText(QRect(pensize, graphicRect.bottom() + pensize, this->width() - 2 * pensize, midTextHeight), Qt::AlignLeft | Qt::AlignVCenter, span);
+        layerPainter.drawText(QRect(pensize, graphicRect.bottom() + pensize, this->width() - 2 * pensize, midTextHeight), Qt::AlignRight | Qt::AlignVCenter, "0");
+    }));
+
+    //draw text
     painter.setPen(palette.color(DPalette::TextTips));
     painter.setRenderHints(QPainter::Antialiasing);
 
     if (m_isMutliCoreMode) {
         // qCDebug(app) << "m_isMutliCoreMode";
         painter.drawText(QRect(pensize, 0, this->width() - 2 * pensize, textHeight), Qt::AlignLeft | Qt::AlignTop, "CPU" + QString::number(m_index));
+        // runnable tasks next to the usage, flagged once they outnumber what the core can run
+        bool oversubscribed = false;
+        int cpu = m_cpuInfomodel->cpuSet()->cpuIds().value(m_index, m_index);
+        const QString &runQueue = m_cpuInfomodel->coreRunQueue(cpu, &oversubscribed);
+        if (!runQueue.isEmpty()) {
+            painter.save();
+            painter.setFont(midFont);
+            painter.setPen(palette.color(oversubscribed ? DPalette::TextWarning : DPalette::TextTips));
+            // between the cpu name & the 100% label
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+            int margin = painter.fontMetrics().width("CPU000");
+#else
+            int margin = painter.fontMetrics().horizontalAdvance("CPU000");
+#endif
+            QRect rect(margin, 0, this->width() - 2 * margin, textHeight);
+            painter.drawText(rect, Qt::AlignHCenter | Qt::AlignTop, painter.fontMetrics().elidedText(runQueue, Qt::ElideRight, rect.width()));
+            painter.restore();
+        }
     } else {
         // qCDebug(app) << "m_isMutliCoreMode not";
         painter.drawText(QRect(pensize, 0, this->width() - 2 * pensize, textHeight), Qt::AlignLeft | Qt::AlignTop, "CPU");
     }
 
-
-    painter.setFont(midFont);
-    int midTextHeight = painter.fontMetrics().height();
-
-    painter.save();
-    QColor midTextColor(palette.color(DPalette::ToolTipText));
-    midTextColor.setAlphaF(0.3);
-    QPen midTextPen = painter.pen();
-    midTextPen.setColor(midTextColor);
-    painter.setPen(midTextPen);
-    painter.drawText(QRect(pensize, 0, this->width() - 2 * pensize, textHeight), Qt::AlignRight | Qt::AlignBottom, "100%");
-    painter.drawText(QRect(pensize, graphicRect.bottom() + pensize, this->width() - 2 * pensize, midTextHeight), Qt::AlignLeft | Qt::AlignVCenter, tr("60 seconds"));
-    painter.drawText(QRect(pensize, graphicRect.bottom() + pensize, this->width() - 2 * pensize, midTextHeight), Qt::AlignRight | Qt::AlignVCenter, "0");
-    painter.restore();
-
     // draw cpu
     painter.setClipRect(graphicRect);
-    if (m_cpuPercents.count() > 0) {
-        painter.setPen(QPen(m_color, 1.5, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
-        painter.setBrush(Qt::NoBrush);
-
-        QPainterPath Painterpath;
-
-        QPointF sp = QPointF(graphicRect.width() + graphicRect.x(), (1.0 - m_cpuPercents.value(0)) * graphicRect.height() + graphicRect.y());
-        Painterpath.moveTo(sp);
-
-        for (int i = 0; i < 30; ++i) {
-            if (m_cpuPercents.count() > i) {
-                QPointF ep = QPointF((graphicRect.width() - static_cast<double>(graphicRect.width()) / (30.0 / static_cast<double>(i + 1))) + graphicRect.x(), (1.0 - m_cpuPercents.value(i + 1)) * graphicRect.height() + graphicRect.y());
-                QPointF c1 = QPointF((sp.x() + ep.x()) / 2, sp.y());
-                QPointF c2 = QPointF((sp.x() + ep.x()) / 2, ep.y());
-                Painterpath.cubicTo(c1, c2, ep);
-                sp = ep;
-            }
-        }
-
-        painter.drawPath(Painterpath);
-    }
+    drawUsageCurve(painter, graphicRect);
 }
 
 void CPUDetailGrapTableItem::drawSimpleMode(QPainter &painter)
@@ -200,33 +215,47 @@ void CPUDetailGrapTableItem::drawSimpleMode(QPainter &painter)
     //draw background
     const int pensize = 1;
     QRect graphicRect = QRect(pensize, pensize, this->width() - 2 * pensize, this->height() - 2 * pensize);
-    drawBackground(painter, graphicRect);
+    painter.drawPixmap(0, 0, ChartLayerCache::layer(ChartLayerCache::cacheKey(this, "cpu-simple"), size(), devicePixelRatioF(),
+                                                    [&](QPainter &layerPainter) { drawBackground(layerPainter, graphicRect); }));
 
     // draw cpu
     painter.setRenderHint(QPainter::Antialiasing);
     painter.setClipRect(graphicRect);
 
-    if (m_cpuPercents.count() > 0) {
-        painter.setPen(QPen(m_color, 1.5, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
-        painter.setBrush(Qt::NoBrush);
-
-        QPainterPath Painterpath;
+    drawUsageCurve(painter, graphicRect);
+}
 
-        QPointF sp = QPointF(graphicRect.width() + graphicRect.x(), (1.0 - m_cpuPercents.value(0)) * graphicRect.height() + graphicRect.y());
-        Painterpath.moveTo(sp);
+void CPUDetailGrapTableItem::updateUsagePath()
+{
+    if (m_pathSeries == m_series && m_pathSeq == m_series->seq())
+        return;
+    m_pathSeries = m_series;
+    m_pathSeq = m_series->seq();
+
+    // x: samples back from the newest, y: usage ratio
+    QPainterPath path;
+    QPointF sp(0, m_series->recent(0) / 100.0);
+    path.moveTo(sp);
+    for (int i = 0; i < 30 && m_series->size() > size_t(i); ++i) {
+        QPointF ep(-(i + 1), m_series->recent(i + 1) / 100.0);
+        path.cubicTo(QPointF((sp.x() + ep.x()) / 2, sp.y()), QPointF((sp.x() + ep.x()) / 2, ep.y()), ep);
+        sp = ep;
+    }
+    m_usagePath = path;
+}
 
-        for (int i = 0; i < 30; ++i) {
-            if (m_cpuPercents.count() > i) {
-                QPointF ep = QPointF((graphicRect.width() - static_cast<double>(graphicRect.width()) / (30.0 / static_cast<double>(i + 1))) + graphicRect.x(), (1.0 - m_cpuPercents.value(i + 1)) * graphicRect.height() + graphicRect.y());
-                QPointF c1 = QPointF((sp.x() + ep.x()) / 2, sp.y());
-                QPointF c2 = QPointF((sp.x() + ep.x()) / 2, ep.y());
-                Painterpath.cubicTo(c1, c2, ep);
-                sp = ep;
-            }
-        }
+void CPUDetailGrapTableItem::drawUsageCurve(QPainter &painter, const QRect &graphicRect)
+{
+    if (m_series->size() == 0)
+        return;
 
-        painter.drawPath(Painterpath);
-    }
+    updateUsagePath();
+    painter.setPen(QPen(m_color, 1.5, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+    painter.setBrush(Qt::NoBrush);
+    // newest sample at the right edge, 30 samples across, full usage at the top
+    QTransform transform(graphicRect.width() / 30.0, 0, 0, -graphicRect.height(),
+                         graphicRect.x() + graphicRect.width(), graphicRect.y() + graphicRect.height());
+    painter.drawPath(transform.map(m_usagePath));
 }
 
 void CPUDetailGrapTableItem::drawTextMode(QPainter &painter)
@@ -247,7 +276,7 @@ void CPUDetailGrapTableItem::drawTextMode(QPainter &painter)
     painter.drawRect(rect);
 
     painter.setPen(m_color);
-    painter.drawText(rect, Qt::AlignCenter, QString::number(m_cpuPercents.value(m_index) * 100, 'f', 1) + "%");
+    painter.drawText(rect, Qt::AlignCenter, QString::number(m_series->recent(m_index), 'f', 1) + "%");
 }
 
 void CPUDetailGrapTableItem::drawSingleCoreMode(QPainter &painter)
@@ -282,23 +311,23 @@ void CPUDetailGrapTableItem::drawSingleCoreMode(QPainter &painter)
     int midTextHeight = painter.fontMetrics().height();
 
     painter.drawText(QRect(pensize, 0, this->width() - 2 * pensize, textHeight), Qt::AlignRight | Qt::AlignBottom, "100%");
-    painter.drawText(QRect(pensize, graphicRect.bottom() + pensize, this->width() - 2 * pensize, midTextHeight), Qt::AlignLeft | Qt::AlignVCenter, tr("60 seconds"));
+    painter.drawText(QRect(pensize, graphicRect.bottom() + pensize, this->width() - 2 * pensize, midTextHeight), Qt::AlignLeft | Qt::AlignVCenter, spanText());
     painter.drawText(QRect(pensize, graphicRect.bottom() + pensize, this->width() - 2 * pensize, midTextHeight), Qt::AlignRight | Qt::AlignVCenter, "0");
 
     // draw cpu
     painter.setClipRect(graphicRect);
-    if (m_cpuPercents.count() > 0) {
+    if (m_series->size() > 0) {
         painter.setPen(QPen(m_color, 1.5, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
         painter.setBrush(Qt::NoBrush);
 
         QPainterPath Painterpath;
 
-        QPointF sp = QPointF(graphicRect.width() + graphicRect.x(), (1.0 - m_cpuPercents.value(0)) * graphicRect.height() + graphicRect.y());
+        QPointF sp = QPointF(graphicRect.width() + graphicRect.x(), (1.0 - m_series->recent(0) / 100.0) * graphicRect.height() + graphicRect.y());
         Painterpath.moveTo(sp);
 
         for (int i = 0; i < 30; ++i) {
-            if (m_cpuPercents.count() > 0) {
-                QPointF ep = QPointF((graphicRect.width() - static_cast<double>(graphicRect.width()) / (30.0 / static_cast<double>(1))) + graphicRect.x(), (1.0 - m_cpuPercents.value(1)) * graphicRect.height() + graphicRect.y());
+            if (m_series->size() > 0) {
+                QPointF ep = QPointF((graphicRect.width() - static_cast<double>(graphicRect.width()) / (30.0 / static_cast<double>(1))) + graphicRect.x(), (1.0 - m_series->recent(1) / 100.0) * graphicRect.height() + graphicRect.y());
                 QPointF c1 = QPointF((sp.x() + ep.x()) / 2, sp.y());
                 QPointF c2 = QPointF((sp.x() + ep.x()) / 2, ep.y());
                 Painterpath.cubicTo(c1, c2, ep);
@@ -310,6 +339,12 @@ void CPUDetailGrapTableItem::drawSingleCoreMode(QPainter &painter)
     }
 }
 
+QString CPUDetailGrapTableItem::spanText() const
+{
+    SampleHistory *history = ModelManager::instance()->sampleHistory();
+    return history->interval() == SampleHistory::kDefaultInterval ? tr("60 seconds") : history->spanText();
+}
+
 void CPUDetailGrapTableItem::drawBackground(QPainter &painter, const QRect &graphicRect)
 {
     // qCDebug(app) << "CPUDetailGrapTableItem::drawBackground";
@@ -358,15 +393,35 @@ CPUDetailWidget::CPUDetailWidget(QWidget *parent) : BaseDetailViewWidget(parent)
 {
     qCDebug(app) << "CPUDetailWidget constructor";
     this->setObjectName("CPUDetailWidget");
+    // the top wakers are traced while shown too
+    core::system::DemandTracker::instance()->declare(this, core::system::DemandTracker::kCpuCoreDemand
+                                                           | core::system::DemandTracker::kWakeupDemand);
 
     TimePeriod period(TimePeriod::kNoPeriod, {2, 0});
     CPUInfoModel *cpuInfomodel = CPUInfoModel::instance();
 
     m_graphicsTable = new CPUDetailGrapTable(cpuInfomodel, this);
     m_summary  = new  CPUDetailSummaryTable(cpuInfomodel, this);
+    m_irqView = new CPUIrqViewWidget(cpuInfomodel, this);
+    m_pressureView = new PressureViewWidget(common::pressure::kCpuPressure, this);
+    m_powerView = new PowerViewWidget(this);
+    m_virtualizationView = new VirtualizationViewWidget(this);
+    m_wakeupView = new WakeupViewWidget(this);
+    m_numaView = new NumaViewWidget(NumaViewWidget::kCPUMode, this);
+    m_freqHeatmap = new CPUFreqHeatmapWidget(this);
+    m_sensorView = new SensorViewWidget(this);
 
     m_centralLayout->addWidget(m_graphicsTable);
     m_centralLayout->addWidget(m_summary);
+    m_centralLayout->addWidget(m_freqHeatmap);
+    // temperature against frequency, right below the heatmap
+    m_centralLayout->addWidget(m_sensorView);
+    m_centralLayout->addWidget(m_numaView);
+    m_centralLayout->addWidget(m_irqView);
+    m_centralLayout->addWidget(m_pressureView);
+    m_centralLayout->addWidget(m_powerView);
+    m_centralLayout->addWidget(m_virtualizationView);
+    m_centralLayout->addWidget(m_wakeupView);
 
     setTitle(DApplication::translate("Process.Graph.View", "CPU"));
     setDetail(cpuInfomodel->cpuSet()->modelName());
@@ -386,6 +441,26 @@ void CPUDetailWidget::detailFontChanged(const QFont &font)
     qCDebug(app) << "CPUDetailWidget::detailFontChanged";
     BaseDetailViewWidget::detailFontChanged(font);
     m_summary->fontChanged(font);
+    m_irqView->fontChanged(font);
+    m_pressureView->fontChanged(font);
+    m_powerView->fontChanged(font);
+    m_virtualizationView->fontChanged(font);
+    m_wakeupView->fontChanged(font);
+    m_numaView->fontChanged(font);
+    m_freqHeatmap->fontChanged(font);
+    m_sensorView->fontChanged(font);
+}
+
+void CPUDetailWidget::showEvent(QShowEvent *event)
+{
+    BaseDetailViewWidget::showEvent(event);
+    core::system::DemandTracker::instance()->setVisible(this, true);
+}
+
+void CPUDetailWidget::hideEvent(QHideEvent *event)
+{
+    core::system::DemandTracker::instance()->setVisible(this, false);
+    BaseDetailViewWidget::hideEvent(event);
 }
 
 CPUDetailGrapTable::CPUDetailGrapTable(CPUInfoModel *model, QWidget *parent): QWidget(parent)
@@ -9,9 +9,16 @@
 #include <QWidget>
 #include <DPushButton>
 #include <QScrollArea>
+#include <QPainterPath>
 
 #include "base/base_detail_view_widget.h"
 
+namespace common {
+namespace core {
+class SeriesRing;
+}
+}
+
 class CPUInfoModel;
 class QScrollArea;
 class CPUDetailGrapTableItem : public QWidget
@@ -25,7 +32,7 @@ public:
 
     void setMode(int mode);
 
-    inline void setMultiCoreMode(bool isMutilCoreMode) { m_isMutliCoreMode = isMutilCoreMode; }
+    void setMultiCoreMode(bool isMutilCoreMode);
 
     void sethorizontal(bool isHorizontalLast);
 
@@ -59,8 +66,33 @@ protected:
      */
     void drawBackground(QPainter &painter, const QRect &graphicRect);
 
+    /**
+     * @brief drawUsageCurve
+     * 绘制占用率曲线, 曲线只在有新采样时重建, 绘制时按区域缩放
+     * @param painter
+     * @param graphicRect
+     */
+    void drawUsageCurve(QPainter &painter, const QRect &graphicRect);
+
+    /**
+     * @brief Time spanned by the curve, follows the refresh interval
+     */
+    QString spanText() const;
+
 private:
-    QList<qreal>  m_cpuPercents;
+    /**
+     * @brief Follow the usage history of the cpu shown, the overall usage in single core mode
+     */
+    void bindSeries();
+    void updateUsagePath();
+
+private:
+    // usage history in percent, kept by the shared sample history
+    const common::core::SeriesRing *m_series = nullptr;
+    // usage curve in sample space, rebuilt once per sample instead of on every paint
+    QPainterPath m_usagePath;
+    const common::core::SeriesRing *m_pathSeries = nullptr;
+    quint64 m_pathSeq = 0;
     CPUInfoModel *m_cpuInfomodel = nullptr;
     QColor m_color;
     int m_mode  = 1;        //1:normal 2:simple 3:text
@@ -100,6 +132,14 @@ private:
 };
 
 class CPUDetailSummaryTable;
+class CPUIrqViewWidget;
+class PressureViewWidget;
+class PowerViewWidget;
+class VirtualizationViewWidget;
+class SensorViewWidget;
+class WakeupViewWidget;
+class NumaViewWidget;
+class CPUFreqHeatmapWidget;
 class CPUDetailWidget : public BaseDetailViewWidget
 {
     Q_OBJECT
@@ -107,12 +147,25 @@ class CPUDetailWidget : public BaseDetailViewWidget
 public:
     explicit CPUDetailWidget(QWidget *parent = nullptr);
 
+protected:
+    // per core frequencies are sampled only while the detail is shown
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
 private slots:
     void detailFontChanged(const QFont &font);
 
 private:
     CPUDetailGrapTable *m_graphicsTable = nullptr;
     CPUDetailSummaryTable *m_summary = nullptr;
+    CPUIrqViewWidget *m_irqView = nullptr;
+    PressureViewWidget *m_pressureView = nullptr;
+    PowerViewWidget *m_powerView = nullptr;
+    VirtualizationViewWidget *m_virtualizationView = nullptr;
+    SensorViewWidget *m_sensorView = nullptr;
+    WakeupViewWidget *m_wakeupView = nullptr;
+    NumaViewWidget *m_numaView = nullptr;
+    CPUFreqHeatmapWidget *m_freqHeatmap = nullptr;
 };
 
 #endif // CPU_DETAIL_WIDGET_H
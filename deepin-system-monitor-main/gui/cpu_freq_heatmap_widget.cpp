@@ -0,0 +1,203 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "cpu_freq_heatmap_widget.h"
+#include "common/common.h"
+#include "model/model_manager.h"
+#include "model/update_coordinator.h"
+#include "system/cpu_set.h"
+#include "system/device_db.h"
+#include "system/device_snapshot.h"
+#include "ddlog.h"
+
+#include <DApplication>
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+#include <DApplicationHelper>
+#else
+#include <DGuiApplicationHelper>
+#endif
+#include <DPalette>
+
+#include <QHelpEvent>
+#include <QPainter>
+#include <QToolTip>
+
+#include <algorithm>
+
+DWIDGET_USE_NAMESPACE
+
+using namespace DDLog;
+using namespace common::format;
+using namespace core::system;
+
+// cell size & spacing (px)
+static const int kCellMinWidth = 24;
+static const int kCellHeight = 16;
+static const int kCellSpacing = 2;
+// title to cells spacing (px)
+static const int kTitleSpacing = 6;
+
+CPUFreqHeatmapWidget::CPUFreqHeatmapWidget(QWidget *parent)
+    : QWidget(parent)
+    , m_font(DApplication::font())
+{
+    qCDebug(app) << "CPUFreqHeatmapWidget constructor";
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    setMouseTracking(true);
+
+    onModelUpdate();
+    connect(ModelManager::instance()->updateCoordinator(), &UpdateCoordinator::updateViews, this, &CPUFreqHeatmapWidget::onModelUpdate);
+}
+
+int CPUFreqHeatmapWidget::heatLevel(qulonglong khz, qulonglong minKHz, qulonglong maxKHz)
+{
+    if (maxKHz <= minKHz || khz <= minKHz)
+        return 0;
+    if (khz >= maxKHz)
+        return kHeatLevels - 1;
+    return int((khz - minKHz) * (kHeatLevels - 1) / (maxKHz - minKHz));
+}
+
+void CPUFreqHeatmapWidget::fontChanged(const QFont &font)
+{
+    qCDebug(app) << "CPUFreqHeatmapWidget fontChanged";
+    m_font = font;
+    layoutCells();
+    update();
+}
+
+void CPUFreqHeatmapWidget::onModelUpdate()
+{
+    DeviceSnapshotPtr snapshot = DeviceDB::instance()->snapshot();
+    const CPUSet &cpuSet = snapshot->cpuSet;
+
+    const int oldCount = m_cells.size();
+    m_cells.clear();
+    qulonglong lowest = 0, highest = 0;
+    for (int cpu : cpuSet.cpuIds()) {
+        cell_t cell {cpu, cpuSet.coreFreq(cpu), cpuSet.coreThrottleEvents(cpu)};
+        if (cell.khz > 0) {
+            lowest = lowest == 0 ? cell.khz : qMin(lowest, cell.khz);
+            highest = qMax(highest, cell.khz);
+        }
+        m_cells << cell;
+    }
+    // no cpufreq, or a static frequency sampled only once by lscpu
+    if (highest == 0) {
+        m_cells.clear();
+        setVisible(false);
+        return;
+    }
+
+    // scaling range if known, turbo may exceed the reported maximum
+    m_minKHz = qulonglong(cpuSet.minFreqMHz() * 1000);
+    m_maxKHz = qMax(qulonglong(cpuSet.maxFreqMHz() * 1000), highest);
+    if (m_minKHz == 0 || m_minKHz >= m_maxKHz)
+        m_minKHz = lowest;
+    m_hasThrottleCounters = cpuSet.hasThrottleCounters();
+
+    setVisible(true);
+    if (m_cells.size() != oldCount)
+        layoutCells();
+    update();
+}
+
+bool CPUFreqHeatmapWidget::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip) {
+        auto *help = static_cast<QHelpEvent *>(event);
+        for (int i = 0; i < m_rects.size() && i < m_cells.size(); ++i) {
+            if (!m_rects[i].contains(help->pos()))
+                continue;
+            const cell_t &cell = m_cells[i];
+            QString text = QString("CPU%1  %2").arg(cell.cpu)
+                           .arg(cell.khz > 0 ? formatHz(quint32(cell.khz), KHz) : QStringLiteral("-"));
+            if (m_hasThrottleCounters)
+                text += "\n" + tr("Thermal throttling: %1 times").arg(cell.throttles);
+            QToolTip::showText(help->globalPos(), text, this);
+            return true;
+        }
+        QToolTip::hideText();
+        event->ignore();
+        return true;
+    }
+    return QWidget::event(event);
+}
+
+void CPUFreqHeatmapWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    layoutCells();
+}
+
+void CPUFreqHeatmapWidget::layoutCells()
+{
+    const int titleHeight = QFontMetrics(m_font).height() + kTitleSpacing;
+    const int count = m_cells.size();
+    const int columns = qBound(1, (width() + kCellSpacing) / (kCellMinWidth + kCellSpacing), qMax(count, 1));
+    const int rows = (count + columns - 1) / columns;
+    const qreal cellWidth = qreal(width() - kCellSpacing * (columns - 1)) / columns;
+
+    m_rects.resize(count);
+    for (int i = 0; i < count; ++i) {
+        int row = i / columns, column = i % columns;
+        m_rects[i] = QRectF(column * (cellWidth + kCellSpacing), titleHeight + row * (kCellHeight + kCellSpacing),
+                            cellWidth, kCellHeight);
+    }
+    setFixedHeight(titleHeight + rows * (kCellHeight + kCellSpacing));
+}
+
+void CPUFreqHeatmapWidget::paintEvent(QPaintEvent *)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    auto palette = DApplicationHelper::instance()->applicationPalette();
+#else
+    auto palette = DGuiApplicationHelper::instance()->applicationPalette();
+#endif
+    QPainter painter(this);
+    painter.setFont(m_font);
+
+    const QFontMetrics fm(m_font);
+    const QRect titleRect(0, 0, width(), fm.height());
+    painter.setPen(palette.color(DPalette::TextTips));
+    painter.drawText(titleRect, Qt::AlignLeft | Qt::AlignVCenter, tr("Core frequency"));
+    painter.drawText(titleRect, Qt::AlignRight | Qt::AlignVCenter,
+                     QString("%1 ~ %2").arg(formatHz(quint32(m_minKHz), KHz)).arg(formatHz(quint32(m_maxKHz), KHz)));
+
+    // cells grouped by color, one fill per bucket & one outline pass for throttled cores
+    QVector<QRectF> buckets[kHeatLevels];
+    QVector<QRectF> unknown;
+    QVector<QRectF> throttled;
+    for (int i = 0; i < m_rects.size() && i < m_cells.size(); ++i) {
+        const cell_t &cell = m_cells[i];
+        if (cell.khz == 0)
+            unknown << m_rects[i];
+        else
+            buckets[heatLevel(cell.khz, m_minKHz, m_maxKHz)] << m_rects[i];
+        if (cell.throttles > 0)
+            throttled << m_rects[i].adjusted(0.5, 0.5, -0.5, -0.5);
+    }
+
+    const QColor cool("#2CA7F8");
+    const QColor hot("#FF7B00");
+    painter.setPen(Qt::NoPen);
+    for (int level = 0; level < kHeatLevels; ++level) {
+        if (buckets[level].isEmpty())
+            continue;
+        qreal t = qreal(level) / (kHeatLevels - 1);
+        painter.setBrush(QColor::fromRgbF(cool.redF() + (hot.redF() - cool.redF()) * t,
+                                          cool.greenF() + (hot.greenF() - cool.greenF()) * t,
+                                          cool.blueF() + (hot.blueF() - cool.blueF()) * t));
+        painter.drawRects(buckets[level]);
+    }
+    if (!unknown.isEmpty()) {
+        painter.setBrush(palette.color(DPalette::ItemBackground));
+        painter.drawRects(unknown);
+    }
+    if (!throttled.isEmpty()) {
+        painter.setBrush(Qt::NoBrush);
+        painter.setPen(QPen(QColor("#FF5A5A"), 1.5));
+        painter.drawRects(throttled);
+    }
+}
@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CPU_FREQ_HEATMAP_WIDGET_H
+#define CPU_FREQ_HEATMAP_WIDGET_H
+
+#include <QFont>
+#include <QRectF>
+#include <QVector>
+#include <QWidget>
+
+/**
+ * @brief Current frequency of each core as a heatmap in the cpu detail view
+ *
+ * One cell per core colored from the minimum to the maximum scaling frequency, cores with
+ * thermal throttle events since the previous sample are outlined. Cells are bucketed by color
+ * so a repaint is one drawRects call per bucket. Hidden without cpufreq.
+ */
+class CPUFreqHeatmapWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit CPUFreqHeatmapWidget(QWidget *parent = nullptr);
+
+    /**
+     * @brief Color bucket of a frequency, 0 for the minimum up to kHeatLevels - 1 for the maximum
+     */
+    static int heatLevel(qulonglong khz, qulonglong minKHz, qulonglong maxKHz);
+
+    static const int kHeatLevels = 10;
+
+public slots:
+    void fontChanged(const QFont &font);
+    void onModelUpdate();
+
+protected:
+    bool event(QEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    struct cell_t {
+        int cpu;
+        qulonglong khz;
+        qulonglong throttles;
+    };
+
+    void layoutCells();
+
+    QFont m_font;
+    QVector<cell_t> m_cells {};
+    QVector<QRectF> m_rects {}; // cell geometry, same order as m_cells
+    qulonglong m_minKHz {0};
+    qulonglong m_maxKHz {0};
+    bool m_hasThrottleCounters {false};
+};
+
+#endif // CPU_FREQ_HEATMAP_WIDGET_H
@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "cpu_irq_view_widget.h"
+#include "ddlog.h"
+#include "model/cpu_irq_model.h"
+#include "model/irq_source_model.h"
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+#include <DApplicationHelper>
+#else
+#include <DGuiApplicationHelper>
+#endif
+
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QPainter>
+
+using namespace DDLog;
+
+#define IRQ_TABLE_LINE_ALPH 0.13
+// irq event totals are cached by the system server for a second, refresh like the process table
+#define IRQ_SOURCE_REFRESH_INTERVAL 2000
+#define IRQ_VIEW_HEIGHT 220
+
+CPUIrqTable::CPUIrqTable(QWidget *parent)
+    : DTableView(parent)
+{
+    verticalHeader()->setVisible(false);
+    horizontalHeader()->setStretchLastSection(true);
+    horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    horizontalHeader()->setDefaultAlignment(Qt::AlignLeft | Qt::AlignVCenter);
+    setGridStyle(Qt::NoPen);
+    setFrameShape(QFrame::NoFrame);
+    setSelectionMode(QAbstractItemView::NoSelection);
+    setEditTriggers(QAbstractItemView::NoEditTriggers);
+}
+
+void CPUIrqTable::paintEvent(QPaintEvent *event)
+{
+    DTableView::paintEvent(event);
+
+    QPainter painter(this->viewport());
+    painter.setRenderHint(QPainter::Antialiasing, true);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    const auto &palette = DApplicationHelper::instance()->applicationPalette();
+#else
+    const auto &palette = DGuiApplicationHelper::instance()->applicationPalette();
+#endif
+    QColor frameColor = palette.color(DPalette::FrameBorder);
+    frameColor.setAlphaF(IRQ_TABLE_LINE_ALPH);
+
+    painter.setPen(QPen(frameColor, 1, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRoundedRect(this->viewport()->rect().adjusted(1, 1, -1, -1), 6, 6);
+}
+
+CPUIrqViewWidget::CPUIrqViewWidget(CPUInfoModel *model, QWidget *parent)
+    : QWidget(parent)
+{
+    qCDebug(app) << "CPUIrqViewWidget constructor";
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+
+    m_coreModel = new CPUIrqModel(model, this);
+    m_coreTable = new CPUIrqTable(this);
+    m_coreTable->setModel(m_coreModel);
+
+    m_sourceModel = new IrqSourceModel(this);
+    m_sourceTable = new CPUIrqTable(this);
+    m_sourceTable->setModel(m_sourceModel);
+    m_sourceTable->horizontalHeader()->setSectionResizeMode(IrqSourceModel::kIrqSourceNameColumn, QHeaderView::Stretch);
+    m_sourceTable->horizontalHeader()->setSectionResizeMode(IrqSourceModel::kIrqSourceRateColumn, QHeaderView::ResizeToContents);
+    m_sourceTable->horizontalHeader()->setSectionResizeMode(IrqSourceModel::kIrqSourceTimeColumn, QHeaderView::ResizeToContents);
+
+    auto *layout = new QHBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(16);
+    layout->addWidget(m_coreTable, 2);
+    layout->addWidget(m_sourceTable, 3);
+
+    m_sourceTimer.setInterval(IRQ_SOURCE_REFRESH_INTERVAL);
+    connect(&m_sourceTimer, &QTimer::timeout, this, &CPUIrqViewWidget::refreshSources);
+}
+
+void CPUIrqViewWidget::fontChanged(const QFont &font)
+{
+    m_coreTable->setFont(font);
+    m_sourceTable->setFont(font);
+    setFixedHeight(IRQ_VIEW_HEIGHT);
+}
+
+void CPUIrqViewWidget::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    // trace irq events only while they are looked at
+    refreshSources();
+    if (m_sourceModel->isAvailable())
+        m_sourceTimer.start();
+}
+
+void CPUIrqViewWidget::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    m_sourceTimer.stop();
+    m_sourceModel->stop();
+}
+
+void CPUIrqViewWidget::refreshSources()
+{
+    m_sourceModel->refresh();
+    if (!m_sourceModel->isAvailable()) {
+        qCDebug(app) << "Irq sources unavailable, showing per core irq time only";
+        m_sourceTimer.stop();
+        m_sourceTable->setVisible(false);
+    }
+}
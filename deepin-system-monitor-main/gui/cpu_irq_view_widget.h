@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CPU_IRQ_VIEW_WIDGET_H
+#define CPU_IRQ_VIEW_WIDGET_H
+
+#include <DTableView>
+
+#include <QTimer>
+#include <QWidget>
+
+DWIDGET_USE_NAMESPACE
+
+class CPUInfoModel;
+class CPUIrqModel;
+class IrqSourceModel;
+
+/**
+ * @brief Rounded frame table of the irq view
+ */
+class CPUIrqTable : public DTableView
+{
+    Q_OBJECT
+public:
+    explicit CPUIrqTable(QWidget *parent = nullptr);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+};
+
+/**
+ * @brief Irq & softirq load of the cpu detail view
+ *
+ * Per core irq time next to the busiest irq lines & softirq vectors, the latter traced through
+ * DKapture only while the view is shown & hidden if DKapture is not usable.
+ */
+class CPUIrqViewWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit CPUIrqViewWidget(CPUInfoModel *model, QWidget *parent = nullptr);
+
+public slots:
+    void fontChanged(const QFont &font);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void refreshSources();
+
+    CPUIrqTable *m_coreTable;
+    CPUIrqTable *m_sourceTable;
+    CPUIrqModel *m_coreModel;
+    IrqSourceModel *m_sourceModel;
+    QTimer m_sourceTimer;
+};
+
+#endif // CPU_IRQ_VIEW_WIDGET_H
@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "cpu_profile_dialog.h"
+#include "flame_graph_widget.h"
+#include "ddlog.h"
+
+#include <DApplication>
+
+#include <QHBoxLayout>
+#include <QScrollArea>
+#include <QVBoxLayout>
+
+using namespace DDLog;
+
+// progress of a running profile, the fold is picked up on the same tick
+#define CPU_PROFILE_REFRESH_INTERVAL 500
+
+CpuProfileDialog::CpuProfileDialog(pid_t pid, const QString &name, QWidget *parent)
+    : DDialog(parent)
+{
+    qCDebug(app) << "CpuProfileDialog constructor for pid:" << pid;
+    setAttribute(Qt::WA_DeleteOnClose);
+    setTitle(DApplication::translate("Cpu.Profile.Dialog", "CPU profile of %1 (%2)").arg(name).arg(pid));
+
+    auto *content = new QWidget(this);
+    auto *layout = new QVBoxLayout(content);
+    layout->setContentsMargins(0, 0, 0, 0);
+    auto *header = new QHBoxLayout();
+    m_status = new DLabel(content);
+    m_status->setWordWrap(true);
+    m_resetZoomBtn = new DPushButton(DApplication::translate("Cpu.Profile.Dialog", "Reset zoom"), content);
+    m_resetZoomBtn->setEnabled(false);
+    m_profileBtn = new DPushButton(content);
+    header->addWidget(m_status, 1);
+    header->addWidget(m_resetZoomBtn);
+    header->addWidget(m_profileBtn);
+
+    auto *scroll = new QScrollArea(content);
+    scroll->setWidgetResizable(true);
+    scroll->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    m_flameGraph = new FlameGraphWidget(scroll);
+    scroll->setWidget(m_flameGraph);
+    scroll->setMinimumSize(760, 420);
+    layout->addLayout(header);
+    layout->addWidget(scroll, 1);
+    addContent(content);
+
+    m_model = new CpuProfileModel(pid, this);
+    connect(m_model, &CpuProfileModel::stateChanged, this, &CpuProfileDialog::onStateChanged);
+    connect(m_model, &CpuProfileModel::progressed, this, &CpuProfileDialog::updateStatus);
+    connect(m_flameGraph, &FlameGraphWidget::zoomChanged, m_resetZoomBtn, &DPushButton::setEnabled);
+    connect(m_resetZoomBtn, &DPushButton::clicked, m_flameGraph, &FlameGraphWidget::resetZoom);
+    connect(m_profileBtn, &DPushButton::clicked, this, [ = ]() {
+        if (m_model->state() == CpuProfileModel::kProfileRunning || m_model->state() == CpuProfileModel::kProfileStarting)
+            m_model->cancel();
+        else
+            start();
+    });
+    m_timer.setInterval(CPU_PROFILE_REFRESH_INTERVAL);
+    connect(&m_timer, &QTimer::timeout, m_model, &CpuProfileModel::refresh);
+
+    start();
+}
+
+void CpuProfileDialog::start()
+{
+    if (m_model->start(kProfileDuration))
+        m_timer.start();
+    updateStatus();
+}
+
+void CpuProfileDialog::onStateChanged(CpuProfileModel::ProfileState state)
+{
+    if (state == CpuProfileModel::kProfileFinished) {
+        m_flameGraph->setProfile(m_model->profile());
+        m_timer.stop();
+    } else if (state == CpuProfileModel::kProfileFailed) {
+        m_timer.stop();
+    }
+    updateStatus();
+}
+
+void CpuProfileDialog::updateStatus()
+{
+    if (!m_model->isAvailable()) {
+        m_status->setText(DApplication::translate("Cpu.Profile.Dialog", "CPU profiling requires the DKapture system service"));
+        m_profileBtn->setText(DApplication::translate("Cpu.Profile.Dialog", "Profile again"));
+        m_profileBtn->setEnabled(false);
+        return;
+    }
+
+    QString text;
+    const QString lost = m_model->lost() ? DApplication::translate("Cpu.Profile.Dialog", ", %1 lost").arg(m_model->lost()) : QString();
+    switch (m_model->state()) {
+    case CpuProfileModel::kProfileStarting:
+        text = DApplication::translate("Cpu.Profile.Dialog", "Starting");
+        break;
+    case CpuProfileModel::kProfileRunning:
+        text = DApplication::translate("Cpu.Profile.Dialog", "Sampling %1 of %2 s, %3 samples of %4 threads")
+               .arg(m_model->elapsed() / 1000).arg(m_model->duration() / 1000)
+               .arg(m_model->samples()).arg(m_model->threads()) + lost;
+        break;
+    case CpuProfileModel::kProfileFolding:
+        text = DApplication::translate("Cpu.Profile.Dialog", "Resolving the symbols of %1 samples").arg(m_model->samples());
+        break;
+    case CpuProfileModel::kProfileFinished:
+        text = DApplication::translate("Cpu.Profile.Dialog", "%1 samples of %2 threads in %3 s")
+               .arg(m_model->samples()).arg(m_model->threads())
+               .arg(m_model->elapsed() / 1000., 0, 'f', 1) + lost;
+        break;
+    case CpuProfileModel::kProfileFailed:
+        text = DApplication::translate("Cpu.Profile.Dialog", "Profile failed, the process may have ended or another profile is running");
+        break;
+    default:
+        break;
+    }
+    m_status->setText(text);
+
+    const bool running = m_model->state() == CpuProfileModel::kProfileRunning || m_model->state() == CpuProfileModel::kProfileStarting;
+    m_profileBtn->setText(running ? DApplication::translate("Cpu.Profile.Dialog", "Stop")
+                                  : DApplication::translate("Cpu.Profile.Dialog", "Profile again"));
+    m_profileBtn->setEnabled(m_model->state() != CpuProfileModel::kProfileFolding);
+}
@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CPU_PROFILE_DIALOG_H
+#define CPU_PROFILE_DIALOG_H
+
+#include "model/cpu_profile_model.h"
+
+#include <DDialog>
+#include <DLabel>
+#include <DPushButton>
+
+#include <QTimer>
+
+DWIDGET_USE_NAMESPACE
+
+class FlameGraphWidget;
+
+/**
+ * @brief Samples the stacks of a process for a few seconds & shows where it spent the cpu
+ *
+ * Sampling starts with the dialog & stops when it's closed, the flame graph is drawn once the
+ * stacks are folded.
+ */
+class CpuProfileDialog : public DDialog
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Dialog constructor
+     * @param pid Process profiled
+     * @param name Display name of the process, for the title
+     * @param parent Parent object
+     */
+    explicit CpuProfileDialog(pid_t pid, const QString &name, QWidget *parent = nullptr);
+
+    // sampling time of a profile, ms
+    static const int kProfileDuration = 10000;
+
+private Q_SLOTS:
+    void start();
+    void updateStatus();
+    void onStateChanged(CpuProfileModel::ProfileState state);
+
+private:
+    CpuProfileModel *m_model;
+    FlameGraphWidget *m_flameGraph {};
+    DLabel *m_status {};
+    DPushButton *m_profileBtn {};
+    DPushButton *m_resetZoomBtn {};
+    QTimer m_timer;
+};
+
+#endif // CPU_PROFILE_DIALOG_H
@@ -144,6 +144,8 @@ protected:
             case 9:
                 if (column == 0)
                     return QApplication::translate("CPUSummaryTableModel", "Version"); //版本号
+                else if (column == 1)
+                    return QApplication::translate("CPUSummaryTableModel", "Run queue wait");//任务就绪但等待CPU的时间占比
                 break;
             default:
                 break;
@@ -215,6 +217,8 @@ protected:
             case 9:
                 if (column == 0)
                     return m_model->osVersion();
+                else if (column == 1)
+                    return m_model->runQueueWait();
                 break;
             default:
                 break;
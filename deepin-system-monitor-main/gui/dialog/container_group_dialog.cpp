@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "container_group_dialog.h"
+
+#include "ddlog.h"
+#include "base/base_table_view.h"
+#include "model/container_group_model.h"
+
+#include <QApplication>
+
+using namespace DDLog;
+
+// a new scan is published at most once a second
+const int kRefreshInterval = 1000;
+
+ContainerGroupDialog::ContainerGroupDialog(QWidget *parent)
+    : DDialog(parent)
+{
+    qCDebug(app) << "ContainerGroupDialog constructor";
+    setAttribute(Qt::WA_DeleteOnClose);
+    setModal(false);
+    setTitle(QApplication::translate("Process.Container.Dialog", "Containers & apps"));
+    setMinimumSize(720, 420);
+
+    m_model = new ContainerGroupModel(this);
+    m_view = new BaseTableView(this);
+    m_view->setModel(m_model);
+    m_view->setSortingEnabled(false);
+    // groups collapsed, their processes on demand
+    m_view->setRootIsDecorated(true);
+    m_view->setItemsExpandable(true);
+
+    addContent(m_view);
+
+    m_model->refresh();
+    connect(&m_timer, &QTimer::timeout, m_model, &ContainerGroupModel::refresh);
+    m_timer.start(kRefreshInterval);
+}
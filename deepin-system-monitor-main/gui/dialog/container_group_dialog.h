@@ -0,0 +1,33 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CONTAINER_GROUP_DIALOG_H
+#define CONTAINER_GROUP_DIALOG_H
+
+#include <DDialog>
+
+#include <QTimer>
+
+DWIDGET_USE_NAMESPACE
+
+class BaseTableView;
+class ContainerGroupModel;
+
+/**
+ * @brief Usage grouped by container, sandbox & app, opened from the process table header menu
+ */
+class ContainerGroupDialog : public DDialog
+{
+    Q_OBJECT
+
+public:
+    explicit ContainerGroupDialog(QWidget *parent = nullptr);
+
+private:
+    ContainerGroupModel *m_model {};
+    BaseTableView *m_view {};
+    QTimer m_timer;
+};
+
+#endif // CONTAINER_GROUP_DIALOG_H
@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "exited_process_dialog.h"
+
+#include "ddlog.h"
+#include "base/base_table_view.h"
+#include "model/exited_process_model.h"
+
+#include <QApplication>
+
+using namespace DDLog;
+
+// process scans publish new rollups at most once a second
+const int kRefreshInterval = 1000;
+
+ExitedProcessDialog::ExitedProcessDialog(QWidget *parent)
+    : DDialog(parent)
+{
+    qCDebug(app) << "ExitedProcessDialog constructor";
+    setAttribute(Qt::WA_DeleteOnClose);
+    setModal(false);
+    setTitle(QApplication::translate("Process.Exited.Dialog", "Recently exited processes"));
+    setMinimumSize(640, 420);
+
+    m_model = new ExitedProcessModel(this);
+    m_view = new BaseTableView(this);
+    m_view->setModel(m_model);
+    m_view->setSortingEnabled(false);
+    m_hintLabel = new DLabel(QApplication::translate("Process.Exited.Dialog",
+                                                     "Exited processes are not recorded, taskstats needs the CAP_NET_ADMIN capability"),
+                             this);
+    m_hintLabel->setWordWrap(true);
+    m_hintLabel->hide();
+
+    addContent(m_view);
+    addContent(m_hintLabel);
+
+    connect(m_model, &ExitedProcessModel::recordingChanged, this, [this](bool recording) {
+        m_hintLabel->setVisible(!recording);
+    });
+    m_model->refresh();
+    m_hintLabel->setVisible(!m_model->isRecording());
+    connect(&m_timer, &QTimer::timeout, m_model, &ExitedProcessModel::refresh);
+    m_timer.start(kRefreshInterval);
+}
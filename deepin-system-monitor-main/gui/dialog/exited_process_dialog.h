@@ -0,0 +1,36 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef EXITED_PROCESS_DIALOG_H
+#define EXITED_PROCESS_DIALOG_H
+
+#include <DDialog>
+#include <DLabel>
+
+#include <QTimer>
+
+DWIDGET_USE_NAMESPACE
+
+class BaseTableView;
+class ExitedProcessModel;
+
+/**
+ * @brief Recently exited processes by name, opened from the process table header menu
+ */
+class ExitedProcessDialog : public DDialog
+{
+    Q_OBJECT
+
+public:
+    explicit ExitedProcessDialog(QWidget *parent = nullptr);
+
+private:
+    ExitedProcessModel *m_model {};
+    BaseTableView *m_view {};
+    // shown when exits can't be recorded
+    DLabel *m_hintLabel {};
+    QTimer m_timer;
+};
+
+#endif // EXITED_PROCESS_DIALOG_H
@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "export_file_dialog.h"
+#include "error_dialog.h"
+#include "ddlog.h"
+
+#include <DMessageManager>
+
+#include <QDateTime>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QPointer>
+#include <QStandardPaths>
+
+DWIDGET_USE_NAMESPACE
+using namespace DDLog;
+
+QString ExportFileDialog::getSavePath(QWidget *parent, const QString &title, const QString &baseName)
+{
+    const QString &csvFilter = tr("CSV (*.csv)");
+    const QString &jsonFilter = tr("JSON lines (*.jsonl)");
+    const QString &dir = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
+    const QString &stamp = QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss");
+    QString filter = csvFilter;
+    QString path = QFileDialog::getSaveFileName(parent, title, QString("%1/%2-%3.csv").arg(dir, baseName, stamp),
+                                                csvFilter + ";;" + jsonFilter, &filter);
+    if (!path.isEmpty() && QFileInfo(path).suffix().isEmpty())
+        path += filter == jsonFilter ? ".jsonl" : ".csv";
+    return path;
+}
+
+void ExportFileDialog::watch(QWidget *window, const QFuture<DataExport::result_t> &future, const QString &path,
+                             const QString &failure)
+{
+    auto *watcher = new QFutureWatcher<DataExport::result_t>();
+    QPointer<QWidget> guard(window);
+    QObject::connect(watcher, &QFutureWatcher<DataExport::result_t>::finished, [=]() {
+        const DataExport::result_t &result = watcher->result();
+        watcher->deleteLater();
+        // the window may be gone when a long export ends
+        if (!guard)
+            return;
+        if (result.error.isEmpty()) {
+            DMessageManager::instance()->sendMessage(guard, QIcon::fromTheme("dialog-ok"),
+                                                     tr("Exported %1 records to %2").arg(result.records).arg(path));
+        } else {
+            ErrorDialog::show(guard, failure, result.error);
+        }
+    });
+    watcher->setFuture(future);
+    qCDebug(app) << "Exporting to" << path;
+}
@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef EXPORT_FILE_DIALOG_H
+#define EXPORT_FILE_DIALOG_H
+
+#include "model/data_export.h"
+
+#include <QCoreApplication>
+#include <QFuture>
+#include <QString>
+
+class QWidget;
+
+/**
+ * @brief File choice & completion report of a DataExport
+ */
+class ExportFileDialog
+{
+    Q_DECLARE_TR_FUNCTIONS(ExportFileDialog)
+
+public:
+    /**
+     * @brief Ask for the file to export to, CSV or JSON lines, suffixed after the chosen filter
+     * @param baseName Default file name, stamped with the current time
+     * @return Empty if canceled
+     */
+    static QString getSavePath(QWidget *parent, const QString &title, const QString &baseName);
+    /**
+     * @brief Report the export running in \a future when it's done, a message in \a window or an error dialog
+     */
+    static void watch(QWidget *window, const QFuture<DataExport::result_t> &future, const QString &path,
+                      const QString &failure);
+};
+
+#endif // EXPORT_FILE_DIALOG_H
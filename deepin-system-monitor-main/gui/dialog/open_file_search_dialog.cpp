@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "open_file_search_dialog.h"
+
+#include "ddlog.h"
+#include "base/base_table_view.h"
+#include "model/open_file_search_model.h"
+
+#include <QApplication>
+#include <QHBoxLayout>
+#include <QLineEdit>
+
+using namespace DDLog;
+
+OpenFileSearchDialog::OpenFileSearchDialog(QWidget *parent)
+    : DDialog(parent)
+{
+    qCDebug(app) << "OpenFileSearchDialog constructor";
+    setAttribute(Qt::WA_DeleteOnClose);
+    setModal(false);
+    setTitle(QApplication::translate("Process.OpenFile.Dialog", "Find open files"));
+    setMinimumSize(720, 480);
+
+    m_searchEdit = new DSearchEdit(this);
+    m_searchEdit->setPlaceHolder(QApplication::translate("Process.OpenFile.Dialog", "File, directory, mount point or port"));
+    m_stopButton = new DPushButton(QApplication::translate("Process.OpenFile.Dialog", "Stop"), this);
+    m_stopButton->setEnabled(false);
+    auto *searchWidget = new QWidget(this);
+    auto *searchLayout = new QHBoxLayout(searchWidget);
+    searchLayout->setContentsMargins(0, 0, 0, 0);
+    searchLayout->addWidget(m_searchEdit, 1);
+    searchLayout->addWidget(m_stopButton);
+
+    m_model = new OpenFileSearchModel(this);
+    m_view = new BaseTableView(this);
+    m_view->setModel(m_model);
+    // rows stream in, sorting would reorder them under the pointer
+    m_view->setSortingEnabled(false);
+    m_statusLabel = new DLabel(this);
+    m_statusLabel->setWordWrap(true);
+
+    addContent(searchWidget);
+    addContent(m_view);
+    addContent(m_statusLabel);
+
+    connect(m_searchEdit->lineEdit(), &QLineEdit::returnPressed, this, &OpenFileSearchDialog::startSearch);
+    connect(m_stopButton, &DPushButton::clicked, m_model, &OpenFileSearchModel::cancel);
+    connect(m_model, &OpenFileSearchModel::progressChanged, this, &OpenFileSearchDialog::updateStatus);
+    connect(m_model, &OpenFileSearchModel::finished, this, &OpenFileSearchDialog::updateStatus);
+    updateStatus();
+}
+
+void OpenFileSearchDialog::startSearch()
+{
+    if (!m_model->search(m_searchEdit->text()))
+        qCDebug(app) << "Empty open file search";
+    updateStatus();
+}
+
+void OpenFileSearchDialog::updateStatus()
+{
+    const bool running = m_model->isRunning();
+    m_stopButton->setEnabled(running);
+    const int scanned = m_model->searcher()->scanned();
+    const int total = m_model->searcher()->total();
+    const int matches = m_model->rowCount();
+    const int processes = m_model->processCount();
+
+    if (running) {
+        m_statusLabel->setText(QApplication::translate("Process.OpenFile.Dialog", "Searching, %1 of %2 processes walked, %3 matches")
+                                   .arg(scanned)
+                                   .arg(total)
+                                   .arg(matches));
+    } else if (total == 0) {
+        m_statusLabel->setText(QApplication::translate("Process.OpenFile.Dialog",
+                                                       "Enter a path to find the processes holding it, files below a directory & files of a mount "
+                                                       "included, or a port as 443 to find the owners of its sockets"));
+    } else if (scanned < total) {
+        m_statusLabel->setText(QApplication::translate("Process.OpenFile.Dialog", "Stopped, %1 matches in %2 processes, %3 of %4 processes walked")
+                                   .arg(matches)
+                                   .arg(processes)
+                                   .arg(scanned)
+                                   .arg(total));
+    } else {
+        // fds of other users' processes are only readable with privileges
+        m_statusLabel->setText(QApplication::translate("Process.OpenFile.Dialog", "%1 matches in %2 processes, processes of other users are only searched with root privileges")
+                                   .arg(matches)
+                                   .arg(processes));
+    }
+}
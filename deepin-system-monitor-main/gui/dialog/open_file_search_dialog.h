@@ -0,0 +1,39 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef OPEN_FILE_SEARCH_DIALOG_H
+#define OPEN_FILE_SEARCH_DIALOG_H
+
+#include <DDialog>
+#include <DLabel>
+#include <DPushButton>
+#include <DSearchEdit>
+
+DWIDGET_USE_NAMESPACE
+
+class BaseTableView;
+class OpenFileSearchModel;
+
+/**
+ * @brief Which processes hold a file, mount or port, opened from the process table header menu
+ */
+class OpenFileSearchDialog : public DDialog
+{
+    Q_OBJECT
+
+public:
+    explicit OpenFileSearchDialog(QWidget *parent = nullptr);
+
+private:
+    void startSearch();
+    void updateStatus();
+
+    OpenFileSearchModel *m_model {};
+    BaseTableView *m_view {};
+    DSearchEdit *m_searchEdit {};
+    DPushButton *m_stopButton {};
+    DLabel *m_statusLabel {};
+};
+
+#endif // OPEN_FILE_SEARCH_DIALOG_H
@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "self_stats_dialog.h"
+
+#include "settings.h"
+#include "ddlog.h"
+
+#include <QApplication>
+#include <QFontDatabase>
+
+#include <unistd.h>
+
+using namespace DDLog;
+using namespace common::selfstats;
+using namespace common::trace;
+
+// SystemMonitor's basic timer, ms
+const int kRefreshInterval = 1000;
+const double kDefaultWarnRatio = 0.2;
+// os thread name of the sampling thread, see SystemMonitorThread
+const char *const kSamplerThreadName = "SystemMonitor";
+const int kShownThreads = 12;
+
+SelfStatsDialog::SelfStatsDialog(QWidget *parent)
+    : DDialog(parent)
+{
+    qCDebug(app) << "SelfStatsDialog constructor";
+    setAttribute(Qt::WA_DeleteOnClose);
+    setModal(false);
+    setTitle(QApplication::translate("SelfStats.Dialog", "Monitor overhead"));
+
+    bool ok = false;
+    m_warnRatio = Settings::instance()->getOption(kSettingKeySelfStatsWarnRatio, kDefaultWarnRatio).toDouble(&ok);
+    if (!ok || m_warnRatio <= 0)
+        m_warnRatio = kDefaultWarnRatio;
+
+    m_reportLabel = new DLabel(this);
+    m_reportLabel->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    m_reportLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    m_warningLabel = new DLabel(this);
+    m_warningLabel->setWordWrap(true);
+    m_warningLabel->setStyleSheet("color: #f04040;");
+    m_warningLabel->hide();
+
+    addContent(m_reportLabel);
+    addContent(m_warningLabel);
+
+    // first sample is the base of the rates
+    SelfStatsReport report;
+    m_sampler.sample(report);
+    connect(&m_timer, &QTimer::timeout, this, &SelfStatsDialog::refresh);
+    m_timer.start(kRefreshInterval);
+}
+
+QString SelfStatsDialog::threadLabel(const ThreadUsage &thread) const
+{
+    // gui thread is the one named after the process
+    if (thread.tid == int(getpid()))
+        return QString("GUI (%1)").arg(QString::fromStdString(thread.name));
+    return QString::fromStdString(thread.name);
+}
+
+void SelfStatsDialog::refresh()
+{
+    SelfStatsReport report;
+    if (!m_sampler.sample(report)) {
+        qCWarning(app) << "Failed to sample own overhead";
+        return;
+    }
+
+    QString text;
+    text += QString::asprintf("CPU %6.1f%%   wakeups %7.1f/s   RSS %8.1f MB   heap %8.1f MB in use / %8.1f MB\n\n",
+                              report.cpuPercent, report.wakeupsPerSec, double(report.rss) / 1024.,
+                              double(report.heapInUse) / 1048576., double(report.heapMapped) / 1048576.);
+    text += QString::asprintf("%-7s %-24s %8s %10s\n", "TID", "THREAD", "CPU%", "WAKEUPS/s");
+    int shown = 0;
+    for (const ThreadUsage &thread : report.threads) {
+        if (++shown > kShownThreads)
+            break;
+        text += QString::asprintf("%-7d %-24s %8.1f %10.1f\n", thread.tid, threadLabel(thread).toUtf8().constData(),
+                                  thread.cpuPercent, thread.wakeupsPerSec);
+    }
+
+    bool traced = false;
+    for (const StageUsage &stage : report.stages)
+        traced = traced || stage.maxMs > 0;
+    text += "\n";
+    if (traced) {
+        text += QString::asprintf("%-12s %8s %10s %10s\n", "STAGE", "CALLS/s", "AVG ms", "MAX ms");
+        for (int i = 0; i < kStageCount; ++i) {
+            const StageUsage &stage = report.stages[i];
+            double calls = report.interval > 0 ? double(stage.count) * 1000. / double(report.interval) : 0;
+            text += QString::asprintf("%-12s %8.1f %10.3f %10.3f\n", stageName(i), calls, stage.avgMs, stage.maxMs);
+        }
+    } else {
+        text += "stage timings not compiled in, configure with -DENABLE_PERF_TRACE=ON\n";
+    }
+    m_reportLabel->setText(text);
+
+    double samplingMs = samplingTimePerRefresh(report, kRefreshInterval, kSamplerThreadName);
+    bool overBudget = samplingMs > m_warnRatio * kRefreshInterval;
+    if (overBudget != m_overBudget) {
+        m_overBudget = overBudget;
+        if (overBudget)
+            qCWarning(app) << "Sampling takes" << samplingMs << "ms per refresh, over"
+                           << m_warnRatio * 100 << "% of the interval";
+    }
+    m_warningLabel->setVisible(overBudget);
+    if (overBudget)
+        m_warningLabel->setText(QApplication::translate("SelfStats.Dialog",
+                                                        "Sampling takes %1 ms per refresh, more than %2% of the %3 ms refresh interval")
+                                        .arg(samplingMs, 0, 'f', 1)
+                                        .arg(m_warnRatio * 100, 0, 'f', 0)
+                                        .arg(kRefreshInterval));
+}
@@ -0,0 +1,46 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SELF_STATS_DIALOG_H
+#define SELF_STATS_DIALOG_H
+
+#include "common/self_stats.h"
+
+#include <DDialog>
+#include <DLabel>
+
+#include <QTimer>
+
+DWIDGET_USE_NAMESPACE
+
+/**
+ * @brief Diagnostics of the monitor's own overhead, opened with --self-stats
+ */
+class SelfStatsDialog : public DDialog
+{
+    Q_OBJECT
+
+public:
+    explicit SelfStatsDialog(QWidget *parent = nullptr);
+
+private:
+    /**
+     * @brief refresh Sample own threads, memory & stage timings and update the report
+     */
+    void refresh();
+    QString threadLabel(const common::selfstats::ThreadUsage &thread) const;
+
+private:
+    common::selfstats::SelfStatsSampler m_sampler;
+    // report text label
+    DLabel *m_reportLabel {};
+    // over budget warning label
+    DLabel *m_warningLabel {};
+    QTimer m_timer;
+    // fraction of the refresh interval sampling may take
+    double m_warnRatio {};
+    bool m_overBudget {false};
+};
+
+#endif // SELF_STATS_DIALOG_H
@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "snapshot_diff_dialog.h"
+
+#include "ddlog.h"
+#include "base/base_table_view.h"
+#include "model/flight_recorder.h"
+#include "model/model_manager.h"
+#include "model/snapshot_diff_model.h"
+
+#include <QApplication>
+#include <QDateTime>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QHBoxLayout>
+
+using namespace DDLog;
+using namespace core::process;
+
+// baseline box data of the snapshot file entry, the others hold minutes back
+const int kFileBaseline = -1;
+
+SnapshotDiffDialog::SnapshotDiffDialog(QWidget *parent)
+    : DDialog(parent)
+{
+    qCDebug(app) << "SnapshotDiffDialog constructor";
+    setAttribute(Qt::WA_DeleteOnClose);
+    setModal(false);
+    setTitle(QApplication::translate("Snapshot.Diff.Dialog", "Compare snapshots"));
+    setMinimumSize(800, 480);
+
+    m_baselineBox = new DComboBox(this);
+    for (int minutes : {1, 5, 10})
+        m_baselineBox->addItem(QApplication::translate("Snapshot.Diff.Dialog", "Now vs %n minute(s) ago", nullptr, minutes), minutes);
+    m_baselineBox->addItem(QApplication::translate("Snapshot.Diff.Dialog", "Now vs a snapshot file..."), kFileBaseline);
+    m_baselineBox->setCurrentIndex(2);
+    m_modeBox = new DComboBox(this);
+    m_modeBox->addItem(QApplication::translate("Snapshot.Diff.Dialog", "Processes"), int(SnapshotDiffModel::kProcessMode));
+    m_modeBox->addItem(QApplication::translate("Snapshot.Diff.Dialog", "Services"), int(SnapshotDiffModel::kServiceMode));
+    m_unchangedBox = new DCheckBox(QApplication::translate("Snapshot.Diff.Dialog", "Show unchanged"), this);
+    auto *optionWidget = new QWidget(this);
+    auto *optionLayout = new QHBoxLayout(optionWidget);
+    optionLayout->setContentsMargins(0, 0, 0, 0);
+    optionLayout->addWidget(m_baselineBox, 1);
+    optionLayout->addWidget(m_modeBox);
+    optionLayout->addWidget(m_unchangedBox);
+
+    m_model = new SnapshotDiffModel(this);
+    m_view = new BaseTableView(this);
+    m_view->setModel(m_model);
+    m_view->setSortingEnabled(true);
+    m_view->sortByColumn(SnapshotDiffModel::kDiffCPUTimeColumn, Qt::DescendingOrder);
+    m_statusLabel = new DLabel(this);
+    m_statusLabel->setWordWrap(true);
+
+    addContent(optionWidget);
+    addContent(m_view);
+    addContent(m_statusLabel);
+
+    connect(m_baselineBox, QOverload<int>::of(&DComboBox::activated), this, &SnapshotDiffDialog::compare);
+    connect(m_modeBox, QOverload<int>::of(&DComboBox::currentIndexChanged), this, [this]() {
+        m_model->setMode(SnapshotDiffModel::Mode(m_modeBox->currentData().toInt()));
+    });
+    connect(m_unchangedBox, &DCheckBox::toggled, m_model, &SnapshotDiffModel::setShowUnchanged);
+    connect(&m_watcher, &QFutureWatcher<SnapshotDiff>::finished, this, &SnapshotDiffDialog::finishCompare);
+    compare();
+}
+
+void SnapshotDiffDialog::compare()
+{
+    FlightRecorder *recorder = ModelManager::instance()->flightRecorder();
+    const int minutes = m_baselineBox->currentData().toInt();
+    if (minutes == kFileBaseline) {
+        const QString &path = QFileDialog::getOpenFileName(this, QApplication::translate("Snapshot.Diff.Dialog", "Open snapshot"),
+                                                           QFileInfo(FlightRecorder::defaultCapturePath()).absolutePath(),
+                                                           QApplication::translate("Snapshot.Diff.Dialog", "Snapshots (*.dsmrec)"));
+        if (path.isEmpty())
+            return;
+        m_watcher.setFuture(recorder->compareFile(path));
+    } else {
+        m_watcher.setFuture(recorder->compare(QDateTime::currentMSecsSinceEpoch() - qint64(minutes) * 60 * 1000));
+    }
+    m_statusLabel->setText(QApplication::translate("Snapshot.Diff.Dialog", "Comparing..."));
+}
+
+void SnapshotDiffDialog::finishCompare()
+{
+    const SnapshotDiff diff = m_watcher.result();
+    m_model->setDiff(diff);
+    if (!diff.isValid()) {
+        m_statusLabel->setText(QApplication::translate("Snapshot.Diff.Dialog", "Nothing to compare, no frame was recorded or the snapshot can't be read"));
+        return;
+    }
+
+    int changed = 0;
+    for (const process_delta_t &delta : diff.processes())
+        changed += delta.change == process_delta_t::kKept && !SnapshotDiffModel::isUnchanged(delta);
+    // the ring starts within its window, the earliest frame may be later than asked for
+    const QString format = QStringLiteral("yyyy-MM-dd hh:mm:ss");
+    m_statusLabel->setText(QApplication::translate("Snapshot.Diff.Dialog", "From %1 to %2: %3 processes started, %4 exited, %5 changed")
+                               .arg(QDateTime::fromMSecsSinceEpoch(diff.before()->time()).toString(format))
+                               .arg(QDateTime::fromMSecsSinceEpoch(diff.after()->time()).toString(format))
+                               .arg(diff.startedCount())
+                               .arg(diff.exitedCount())
+                               .arg(changed));
+}
@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SNAPSHOT_DIFF_DIALOG_H
+#define SNAPSHOT_DIFF_DIALOG_H
+
+#include "process/process_diff.h"
+
+#include <DCheckBox>
+#include <DComboBox>
+#include <DDialog>
+#include <DLabel>
+
+#include <QFutureWatcher>
+
+DWIDGET_USE_NAMESPACE
+
+class BaseTableView;
+class SnapshotDiffModel;
+
+/**
+ * @brief Compares the latest recorded frame with an earlier one or a snapshot file, opened from the snapshot menu
+ */
+class SnapshotDiffDialog : public DDialog
+{
+    Q_OBJECT
+
+public:
+    explicit SnapshotDiffDialog(QWidget *parent = nullptr);
+
+private:
+    /**
+     * @brief Compare with what the baseline box selects, a file asks for its path first
+     */
+    void compare();
+    void finishCompare();
+
+    SnapshotDiffModel *m_model {};
+    BaseTableView *m_view {};
+    DComboBox *m_baselineBox {};
+    DComboBox *m_modeBox {};
+    DCheckBox *m_unchangedBox {};
+    DLabel *m_statusLabel {};
+    QFutureWatcher<core::process::SnapshotDiff> m_watcher;
+};
+
+#endif // SNAPSHOT_DIFF_DIALOG_H
@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "filesystem_view_widget.h"
+#include "base/base_table_view.h"
+#include "model/filesystem_model.h"
+#include "ddlog.h"
+
+#include <DFontSizeManager>
+
+#include <QHeaderView>
+#include <QSortFilterProxyModel>
+#include <QVBoxLayout>
+
+using namespace DDLog;
+
+#define FILESYSTEM_VIEW_HEIGHT 220
+
+FilesystemViewWidget::FilesystemViewWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    qCDebug(app) << "FilesystemViewWidget constructor";
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    setFixedHeight(FILESYSTEM_VIEW_HEIGHT);
+
+    m_titleLabel = new DLabel(tr("Filesystems"), this);
+    m_titleLabel->setForegroundRole(DPalette::TextTips);
+    DFontSizeManager::instance()->bind(m_titleLabel, DFontSizeManager::T8);
+
+    m_model = new FilesystemModel(this);
+    m_proxyModel = new QSortFilterProxyModel(this);
+    m_proxyModel->setSourceModel(m_model);
+    m_proxyModel->setSortRole(FilesystemModel::kSortRole);
+
+    m_view = new BaseTableView(this);
+    m_view->setModel(m_proxyModel);
+    m_view->header()->resizeSection(FilesystemModel::kFilesystemMountPointColumn, 160);
+    m_view->header()->resizeSection(FilesystemModel::kFilesystemDeviceColumn, 160);
+    m_view->setSortingEnabled(true);
+    m_view->sortByColumn(FilesystemModel::kFilesystemMountPointColumn, Qt::AscendingOrder);
+
+    auto *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(m_titleLabel);
+    layout->addWidget(m_view);
+}
+
+void FilesystemViewWidget::fontChanged(const QFont &font)
+{
+    qCDebug(app) << "FilesystemViewWidget fontChanged";
+    m_view->setFont(font);
+}
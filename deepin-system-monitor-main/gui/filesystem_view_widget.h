@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef FILESYSTEM_VIEW_WIDGET_H
+#define FILESYSTEM_VIEW_WIDGET_H
+
+#include <DLabel>
+
+#include <QWidget>
+
+DWIDGET_USE_NAMESPACE
+
+class BaseTableView;
+class FilesystemModel;
+class QSortFilterProxyModel;
+
+/**
+ * @brief Capacity of the mounted filesystems in the disk detail view, like df
+ */
+class FilesystemViewWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit FilesystemViewWidget(QWidget *parent = nullptr);
+
+public slots:
+    void fontChanged(const QFont &font);
+
+private:
+    DLabel *m_titleLabel;
+    BaseTableView *m_view;
+    FilesystemModel *m_model;
+    QSortFilterProxyModel *m_proxyModel;
+};
+
+#endif // FILESYSTEM_VIEW_WIDGET_H
@@ -0,0 +1,225 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "flame_graph_widget.h"
+#include "ddlog.h"
+
+#include <DApplicationHelper>
+#include <DPalette>
+
+#include <QHelpEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QToolTip>
+
+DWIDGET_USE_NAMESPACE
+using namespace DDLog;
+using namespace core::process;
+
+namespace {
+
+// frames narrower than this are left out, with their callees
+const qreal kMinFrameWidth = 2;
+// labels need room for a few characters
+const int kMinLabelWidth = 24;
+const int kLabelMargin = 3;
+
+} // namespace
+
+FlameGraphWidget::FlameGraphWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    qCDebug(app) << "FlameGraphWidget constructor";
+    setMouseTracking(true);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Minimum);
+    setMinimumHeight(frameHeight());
+}
+
+void FlameGraphWidget::setProfile(const CpuProfile &profile)
+{
+    m_profile = profile;
+    m_zoom = 0;
+    m_hover = -1;
+
+    // callees come after their callers
+    const QVector<CpuProfile::node_t> &nodes = m_profile.nodes();
+    QVector<int> depths(nodes.size(), 0);
+    m_depth = 0;
+    for (int i = 1; i < nodes.size(); ++i) {
+        depths[i] = depths[nodes[i].parent] + 1;
+        m_depth = qMax(m_depth, depths[i]);
+    }
+    setMinimumHeight((m_depth + 1) * frameHeight());
+    layoutFrames();
+    update();
+    emit zoomChanged(false);
+}
+
+void FlameGraphWidget::resetZoom()
+{
+    setZoom(0);
+}
+
+void FlameGraphWidget::setZoom(int node)
+{
+    if (m_zoom == node)
+        return;
+    m_zoom = node;
+    layoutFrames();
+    update();
+    emit zoomChanged(m_zoom != 0);
+}
+
+int FlameGraphWidget::frameHeight() const
+{
+    return fontMetrics().height() + 4;
+}
+
+void FlameGraphWidget::layoutFrames()
+{
+    m_frames.clear();
+    const QVector<CpuProfile::node_t> &nodes = m_profile.nodes();
+    if (nodes[m_zoom].samples == 0)
+        return;
+
+    QVector<int> callers;
+    for (int node = nodes[m_zoom].parent; node >= 0; node = nodes[node].parent)
+        callers.prepend(node);
+    for (int depth = 0; depth < callers.size(); ++depth)
+        m_frames << frame_t {QRectF(0, depth * frameHeight(), width(), frameHeight()), callers[depth], true};
+    layoutNode(m_zoom, 0, width(), callers.size());
+}
+
+void FlameGraphWidget::layoutNode(int node, qreal x, qreal width, int depth)
+{
+    if (width < kMinFrameWidth)
+        return;
+    m_frames << frame_t {QRectF(x, depth * frameHeight(), width, frameHeight()), node, false};
+
+    const CpuProfile::node_t &parent = m_profile.nodes()[node];
+    for (int child : parent.children) {
+        const qreal childWidth = width * qreal(m_profile.nodes()[child].samples) / qreal(parent.samples);
+        layoutNode(child, x, childWidth, depth + 1);
+        x += childWidth;
+    }
+}
+
+int FlameGraphWidget::frameAt(const QPoint &pos) const
+{
+    for (const frame_t &frame : m_frames) {
+        if (frame.rect.contains(pos))
+            return frame.node;
+    }
+    return -1;
+}
+
+QColor FlameGraphWidget::frameColor(const CpuProfile::node_t &node) const
+{
+    // same function, same color, across profiles too
+    const uint hash = qHash(node.function);
+    if (node.kernel)
+        return QColor::fromHsv(int(190 + hash % 40), int(90 + hash / 40 % 60), 225);
+    return QColor::fromHsv(int(hash % 50), int(150 + hash / 50 % 70), 240);
+}
+
+void FlameGraphWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.setFont(font());
+    const QFontMetrics fm = painter.fontMetrics();
+    auto palette = DApplicationHelper::instance()->palette(this);
+
+    if (m_frames.isEmpty()) {
+        painter.setPen(palette.color(DPalette::TextTips));
+        painter.drawText(rect(), Qt::AlignCenter, tr("No samples"));
+        return;
+    }
+
+    for (const frame_t &frame : m_frames) {
+        const CpuProfile::node_t &node = m_profile.nodes()[frame.node];
+        QColor color = frame.node == 0 ? palette.color(DPalette::ItemBackground).darker(120) : frameColor(node);
+        if (frame.caller)
+            color.setAlphaF(0.45);
+        const QRectF rect = frame.rect.adjusted(0, 0, -1, -1);
+        painter.fillRect(rect, color);
+        if (frame.node == m_hover) {
+            painter.setPen(palette.color(DPalette::Highlight));
+            painter.drawRect(rect.adjusted(0.5, 0.5, -0.5, -0.5));
+        }
+
+        if (rect.width() < kMinLabelWidth)
+            continue;
+        const QString label = frame.node == 0 ? tr("All samples") : node.function;
+        const QRectF text = rect.adjusted(kLabelMargin, 0, -kLabelMargin, 0);
+        painter.setPen(frame.node == 0 ? palette.color(DPalette::TextTips) : QColor(Qt::black));
+        painter.drawText(text, Qt::AlignLeft | Qt::AlignVCenter, fm.elidedText(label, Qt::ElideRight, int(text.width())));
+    }
+}
+
+bool FlameGraphWidget::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip) {
+        auto *help = static_cast<QHelpEvent *>(event);
+        const int index = frameAt(help->pos());
+        if (index >= 0 && m_profile.samples() > 0) {
+            const CpuProfile::node_t &node = m_profile.nodes()[index];
+            const qreal percent = 100. * qreal(node.samples) / qreal(m_profile.samples());
+            QString text = index == 0 ? tr("All samples") : QString("%1\n%2").arg(node.function).arg(node.module);
+            text += "\n" + tr("Samples: %1 (%2%)").arg(node.samples).arg(percent, 0, 'f', 2);
+            if (index != 0)
+                text += "\n" + tr("Self: %1").arg(node.self);
+            QToolTip::showText(help->globalPos(), text, this);
+            return true;
+        }
+        QToolTip::hideText();
+        event->ignore();
+        return true;
+    }
+    return QWidget::event(event);
+}
+
+void FlameGraphWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    layoutFrames();
+}
+
+void FlameGraphWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    QWidget::mouseMoveEvent(event);
+    const int hover = frameAt(event->pos());
+    if (hover != m_hover) {
+        m_hover = hover;
+        update();
+    }
+}
+
+void FlameGraphWidget::mouseReleaseEvent(QMouseEvent *event)
+{
+    QWidget::mouseReleaseEvent(event);
+    if (event->button() != Qt::LeftButton)
+        return;
+    // a caller or the root zooms back out
+    const int node = frameAt(event->pos());
+    if (node >= 0)
+        setZoom(node);
+}
+
+void FlameGraphWidget::leaveEvent(QEvent *event)
+{
+    QWidget::leaveEvent(event);
+    if (m_hover >= 0) {
+        m_hover = -1;
+        update();
+    }
+}
+
+void FlameGraphWidget::changeEvent(QEvent *event)
+{
+    QWidget::changeEvent(event);
+    if (event->type() == QEvent::FontChange) {
+        setMinimumHeight((m_depth + 1) * frameHeight());
+        layoutFrames();
+    }
+}
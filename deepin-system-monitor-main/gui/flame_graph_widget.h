@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef FLAME_GRAPH_WIDGET_H
+#define FLAME_GRAPH_WIDGET_H
+
+#include "process/cpu_profile.h"
+
+#include <QVector>
+#include <QWidget>
+
+/**
+ * @brief Flame graph of a cpu profile, drawn top down from the outermost frame
+ *
+ * The width of a frame is its share of the samples, its callees are below it sorted by name.
+ * Clicking a frame zooms in to it with its callers kept on top at full width, clicking one of
+ * them zooms back out. User frames are in warm colors, kernel frames in cold ones.
+ */
+class FlameGraphWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit FlameGraphWidget(QWidget *parent = nullptr);
+
+    void setProfile(const core::process::CpuProfile &profile);
+    inline bool isZoomed() const { return m_zoom != 0; }
+
+public slots:
+    void resetZoom();
+
+signals:
+    void zoomChanged(bool zoomed);
+
+protected:
+    bool event(QEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void leaveEvent(QEvent *event) override;
+    void changeEvent(QEvent *event) override;
+
+private:
+    struct frame_t {
+        QRectF rect;
+        int node;
+        bool caller; // of the zoomed frame, drawn full width
+    };
+
+    void setZoom(int node);
+    // frames of the zoomed node, its callers & the callees wide enough to be seen
+    void layoutFrames();
+    void layoutNode(int node, qreal x, qreal width, int depth);
+    int frameAt(const QPoint &pos) const;
+    int frameHeight() const;
+    QColor frameColor(const core::process::CpuProfile::node_t &node) const;
+
+    core::process::CpuProfile m_profile;
+    int m_depth {0}; // deepest stack
+    int m_zoom {0};
+    int m_hover {-1};
+    QVector<frame_t> m_frames;
+};
+
+#endif // FLAME_GRAPH_WIDGET_H
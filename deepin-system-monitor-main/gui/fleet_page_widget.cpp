@@ -0,0 +1,139 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "fleet_page_widget.h"
+#include "sparkline_item_delegate.h"
+#include "base/base_table_view.h"
+#include "model/fleet_host_model.h"
+#include "model/fleet_monitor.h"
+#include "settings.h"
+#include "ddlog.h"
+
+#include <DApplication>
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+#include <DApplicationHelper>
+#else
+#include <DGuiApplicationHelper>
+#endif
+
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QPainter>
+#include <QPainterPath>
+#include <QSortFilterProxyModel>
+#include <QVBoxLayout>
+
+using namespace DDLog;
+
+FleetPageWidget::FleetPageWidget(DWidget *parent)
+    : DFrame(parent)
+{
+    qCDebug(app) << "FleetPageWidget created";
+    // content margin
+    int margin = 10;
+
+    m_monitor = new FleetMonitor(this);
+    m_model = new FleetHostModel(m_monitor, this);
+    m_proxyModel = new QSortFilterProxyModel(this);
+    m_proxyModel->setSourceModel(m_model);
+    m_proxyModel->setSortRole(FleetHostModel::kSortRole);
+
+    m_view = new BaseTableView(this);
+    m_view->setModel(m_proxyModel);
+    for (int column : {FleetHostModel::kFleetCPUColumn, FleetHostModel::kFleetMemoryColumn,
+                       FleetHostModel::kFleetPressureColumn}) {
+        m_view->setItemDelegateForColumn(column, new SparklineItemDelegate(FleetHostModel::kHistoryRole, m_view));
+        m_view->header()->resizeSection(column, 200);
+    }
+    m_view->header()->resizeSection(FleetHostModel::kFleetHostColumn, 180);
+    m_view->setSortingEnabled(true);
+    // busiest hosts first
+    m_view->sortByColumn(FleetHostModel::kFleetCPUColumn, Qt::DescendingOrder);
+
+    m_targetEdit = new DLineEdit(this);
+    m_targetEdit->setPlaceholderText(DApplication::translate("Fleet.Page", "user@host or tcp://127.0.0.1:port"));
+    m_addBtn = new DPushButton(DApplication::translate("Fleet.Page", "Add host"), this);
+    m_removeBtn = new DPushButton(DApplication::translate("Fleet.Page", "Remove"), this);
+    m_removeBtn->setEnabled(false);
+
+    auto *controls = new QHBoxLayout();
+    controls->addWidget(m_targetEdit, 1);
+    controls->addWidget(m_addBtn);
+    controls->addWidget(m_removeBtn);
+
+    auto *layout = new QVBoxLayout(this);
+    layout->addLayout(controls);
+    layout->addWidget(m_view);
+    layout->setContentsMargins(margin, margin, margin, margin);
+    setLayout(layout);
+
+    connect(m_addBtn, &DPushButton::clicked, this, &FleetPageWidget::addHost);
+    connect(m_targetEdit, &DLineEdit::returnPressed, this, &FleetPageWidget::addHost);
+    connect(m_removeBtn, &DPushButton::clicked, this, &FleetPageWidget::removeSelectedHost);
+    connect(m_view->selectionModel(), &QItemSelectionModel::currentRowChanged, this, [=](const QModelIndex &current) {
+        m_removeBtn->setEnabled(current.isValid());
+    });
+    connect(m_view, &BaseTableView::doubleClicked, this, [=](const QModelIndex &index) {
+        const QString target = index.data(FleetHostModel::kTargetRole).toString();
+        if (!target.isEmpty())
+            Q_EMIT hostActivated(target);
+    });
+
+    for (const QString &target : Settings::instance()->getOption(kSettingKeyFleetHosts).toStringList())
+        m_monitor->addHost(target);
+}
+
+FleetPageWidget::~FleetPageWidget()
+{
+    // qCDebug(app) << "FleetPageWidget destroyed";
+}
+
+void FleetPageWidget::addHost()
+{
+    const QString target = m_targetEdit->text().trimmed();
+    if (target.isEmpty())
+        return;
+    if (!m_monitor->addHost(target)) {
+        m_targetEdit->showAlertMessage(DApplication::translate("Fleet.Page", "Not a new ssh destination or tcp://address:port"));
+        return;
+    }
+    m_targetEdit->clear();
+    saveHosts();
+}
+
+void FleetPageWidget::removeSelectedHost()
+{
+    const QString target = m_view->currentIndex().data(FleetHostModel::kTargetRole).toString();
+    if (target.isEmpty())
+        return;
+    m_monitor->removeHost(target);
+    saveHosts();
+}
+
+void FleetPageWidget::saveHosts()
+{
+    Settings::instance()->setOption(kSettingKeyFleetHosts, m_monitor->targets());
+    Settings::instance()->flush();
+}
+
+// paint event handler
+void FleetPageWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+
+    QPainterPath path;
+    path.addRect(QRectF(rect()));
+    painter.setOpacity(1);
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    auto palette = DApplicationHelper::instance()->applicationPalette();
+    auto bgColor = palette.color(DPalette::Background);
+#else
+    auto palette = DGuiApplicationHelper::instance()->applicationPalette();
+    auto bgColor = palette.color(DPalette::Window);
+#endif
+
+    // paint frame background
+    painter.fillPath(path, bgColor);
+}
@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef FLEET_PAGE_WIDGET_H
+#define FLEET_PAGE_WIDGET_H
+
+#include <DFrame>
+#include <DLineEdit>
+#include <DPushButton>
+#include <DWidget>
+
+DWIDGET_USE_NAMESPACE
+
+class BaseTableView;
+class FleetHostModel;
+class FleetMonitor;
+class QSortFilterProxyModel;
+
+/**
+ * @brief Hosts page, a row per agent of the fleet with sparklines of its recent usage
+ *
+ * Agents are only connected to once the page is first shown, their targets are kept in the
+ * settings. Activating a row asks to show that host in all other pages.
+ */
+class FleetPageWidget : public DFrame
+{
+    Q_OBJECT
+
+public:
+    explicit FleetPageWidget(DWidget *parent = nullptr);
+    ~FleetPageWidget() override;
+
+Q_SIGNALS:
+    /**
+     * @brief A host was double clicked, to attach its full stream
+     */
+    void hostActivated(const QString &target);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    void addHost();
+    void removeSelectedHost();
+    void saveHosts();
+
+    FleetMonitor *m_monitor {};
+    FleetHostModel *m_model {};
+    QSortFilterProxyModel *m_proxyModel {};
+    BaseTableView *m_view {};
+    DLineEdit *m_targetEdit {};
+    DPushButton *m_addBtn {};
+    DPushButton *m_removeBtn {};
+};
+
+#endif // FLEET_PAGE_WIDGET_H
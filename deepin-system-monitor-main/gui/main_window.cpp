@@ -7,6 +7,8 @@
 #include "application.h"
 #include "process_page_widget.h"
 #include "system_service_page_widget.h"
+#include "fleet_page_widget.h"
+#include "socket_page_widget.h"
 #include "toolbar.h"
 #include "common/common.h"
 #include "settings.h"
@@ -14,8 +16,19 @@
 #include "detailwidgetmanager.h"
 #include "gui/dialog/systemprotectionsetting.h"
 #include "process/process_set.h"
+#include "system/system_monitor.h"
+#include "system/demand_tracker.h"
+#include "model/model_manager.h"
+#include "model/update_coordinator.h"
+#include "model/flight_recorder.h"
+#include "dialog/error_dialog.h"
+#include "dialog/export_file_dialog.h"
+#include "dialog/snapshot_diff_dialog.h"
 #include "common/eventlogutils.h"
 
+#include <DDialog>
+#include <DLineEdit>
+#include <DMessageManager>
 #include <DSettingsWidgetFactory>
 #include <DTitlebar>
 #ifdef DTKCORE_CLASS_DConfigFile
@@ -29,6 +42,9 @@
 #include <QDBusConnection>
 #include <QJsonObject>
 #include <QActionGroup>
+#include <QDateTime>
+#include <QFileDialog>
+#include <QFileInfo>
 
 using namespace core::process;
 using namespace common::init;
@@ -51,6 +67,8 @@ MainWindow::MainWindow(QWidget *parent)
     setMaximumSize(QGuiApplication::primaryScreen()->size());
 #endif
     connect(this, &MainWindow::loadingStatusChanged, this, &MainWindow::onLoadStatusChanged);
+    // from now on only what the pages on screen ask for is sampled
+    core::system::DemandTracker::instance()->setTracking(true);
 #ifdef DTKCORE_CLASS_DConfigFile
     //需要查询是否支持特殊机型静音恢复，例如hw机型
     DConfig *dconfig = DConfig::create("org.deepin.system-monitor", "org.deepin.system-monitor.main");
@@ -89,6 +107,9 @@ void MainWindow::initDisplay()
     };
     EventLogUtils::get().writeLogs(obj);
 
+    // chart history is recorded from launch, so charts shown later already have it
+    ModelManager::instance();
+
     initUI();
     initConnections();
 }
@@ -176,13 +197,130 @@ void MainWindow::initUI()
         Q_EMIT displayModeChanged(kDisplayModeCompact);
     });
 
+    // refresh interval menu, the saved choice is applied at startup
+    DMenu *intervalMenu = new DMenu(DApplication::translate("Title.Bar.Context.Menu", "Refresh interval"), menu);
+    QActionGroup *intervalGroup = new QActionGroup(intervalMenu);
+    intervalGroup->setExclusive(true);
+    ModelManager *intervalManager = ModelManager::instance();
+    int interval = m_settings->getOption(kSettingKeyRefreshInterval, core::system::SystemMonitor::kDefaultRefreshInterval).toInt();
+    if (!ModelManager::kRefreshIntervals.contains(interval))
+        interval = core::system::SystemMonitor::kDefaultRefreshInterval;
+    qCDebug(app) << "Loading refresh interval:" << interval;
+    intervalManager->setRefreshInterval(interval);
+    for (int choice : ModelManager::kRefreshIntervals) {
+        auto *intervalAction = new QAction(DApplication::translate("Title.Bar.Context.Menu", "%1 s").arg(choice / 1000.), intervalGroup);
+        intervalAction->setCheckable(true);
+        intervalAction->setChecked(choice == interval);
+        intervalMenu->addAction(intervalAction);
+        connect(intervalAction, &QAction::triggered, this, [=]() {
+            m_settings->setOption(kSettingKeyRefreshInterval, choice);
+            intervalManager->setRefreshInterval(choice);
+        });
+    }
+
     // 等保需求，设置入口，1050打开
     // 构建setting menu Item Action
     QAction *settingAction(new QAction(tr("Settings"), this));
     connect(settingAction, &QAction::triggered, this, &MainWindow::popupSettingsDialog);
 
+    // snapshot menu, captures the recent minutes of samples & replays captured ones
+    FlightRecorder *recorder = ModelManager::instance()->flightRecorder();
+    DMenu *snapshotMenu = new DMenu(DApplication::translate("Title.Bar.Context.Menu", "Snapshot"), menu);
+    QAction *captureAction = new QAction(DApplication::translate("Title.Bar.Context.Menu", "Capture"), snapshotMenu);
+    QAction *openAction = new QAction(DApplication::translate("Title.Bar.Context.Menu", "Open..."), snapshotMenu);
+    QAction *compareAction = new QAction(DApplication::translate("Title.Bar.Context.Menu", "Compare..."), snapshotMenu);
+    QAction *stopAction = new QAction(DApplication::translate("Title.Bar.Context.Menu", "Back to live"), snapshotMenu);
+    stopAction->setVisible(false);
+    snapshotMenu->addAction(captureAction);
+    snapshotMenu->addAction(openAction);
+    snapshotMenu->addAction(compareAction);
+    snapshotMenu->addAction(stopAction);
+    connect(captureAction, &QAction::triggered, this, [=]() {
+        const QString &path = FlightRecorder::defaultCapturePath();
+        if (recorder->capture(path)) {
+            DMessageManager::instance()->sendMessage(this, QIcon::fromTheme("dialog-ok"),
+                                                     tr("Snapshot saved to %1").arg(path));
+        } else {
+            ErrorDialog::show(this, tr("Failed to save the snapshot"), path);
+        }
+    });
+    connect(openAction, &QAction::triggered, this, [=]() {
+        ModelManager::instance()->detachRemote();
+        const QString &path = QFileDialog::getOpenFileName(this, tr("Open snapshot"),
+                                                           QFileInfo(FlightRecorder::defaultCapturePath()).absolutePath(),
+                                                           tr("Snapshots (*.dsmrec)"));
+        if (!path.isEmpty() && !recorder->replay(path))
+            ErrorDialog::show(this, tr("Failed to open the snapshot"), path);
+    });
+    connect(compareAction, &QAction::triggered, this, [=]() {
+        (new SnapshotDiffDialog(this))->show();
+    });
+    connect(stopAction, &QAction::triggered, recorder, &FlightRecorder::stopReplay);
+    // nothing new is recorded while a snapshot is shown
+    connect(recorder, &FlightRecorder::replayStateChanged, this, [=](bool replaying) {
+        captureAction->setEnabled(!replaying);
+        stopAction->setVisible(replaying);
+    });
+
+    // export menu, samples of the on-disk history as CSV or JSON lines, written in the background
+    DMenu *exportMenu = new DMenu(DApplication::translate("Title.Bar.Context.Menu", "Export history"), menu);
+    const QList<QPair<QString, qint64>> exportSpans = {
+        {DApplication::translate("Title.Bar.Context.Menu", "Last hour..."), 3600 * 1000LL},
+        {DApplication::translate("Title.Bar.Context.Menu", "Last day..."), 24 * 3600 * 1000LL},
+        {DApplication::translate("Title.Bar.Context.Menu", "Last week..."), 7 * 24 * 3600 * 1000LL},
+    };
+    for (const auto &span : exportSpans) {
+        QAction *action = exportMenu->addAction(span.first);
+        const qint64 duration = span.second;
+        connect(action, &QAction::triggered, this, [=]() {
+            const QString &path = ExportFileDialog::getSavePath(this, tr("Export history"), "history");
+            if (path.isEmpty())
+                return;
+            const qint64 now = QDateTime::currentMSecsSinceEpoch();
+            ExportFileDialog::watch(this, DataExport::exportHistory(path, now - duration, now), path,
+                                    tr("Failed to export the history"));
+        });
+    }
+
+    // remote host menu, shows another host's agent stream instead of this one
+    ModelManager *modelManager = ModelManager::instance();
+    DMenu *remoteMenu = new DMenu(DApplication::translate("Title.Bar.Context.Menu", "Remote host"), menu);
+    QAction *attachAction = new QAction(DApplication::translate("Title.Bar.Context.Menu", "Attach..."), remoteMenu);
+    QAction *detachAction = new QAction(DApplication::translate("Title.Bar.Context.Menu", "Back to this computer"), remoteMenu);
+    detachAction->setVisible(false);
+    remoteMenu->addAction(attachAction);
+    remoteMenu->addAction(detachAction);
+    connect(attachAction, &QAction::triggered, this, [=]() {
+        DDialog dialog(this);
+        dialog.setTitle(tr("Attach to a remote host"));
+        dialog.setMessage(tr("The host runs deepin-system-monitor --headless --agent over ssh, "
+                             "or forwards its --agent-port to tcp://127.0.0.1:port"));
+        DLineEdit *edit = new DLineEdit(&dialog);
+        edit->setPlaceholderText("user@host");
+        dialog.addContent(edit);
+        dialog.addButton(DApplication::translate("Cancel", "Cancel"), false);
+        dialog.addButton(tr("Attach"), true, DDialog::ButtonRecommend);
+        if (dialog.exec() != 1 || edit->text().trimmed().isEmpty())
+            return;
+        if (!modelManager->attachRemote(edit->text()))
+            ErrorDialog::show(this, tr("Failed to attach to the remote host"), edit->text());
+    });
+    connect(detachAction, &QAction::triggered, modelManager, &ModelManager::detachRemote);
+    connect(modelManager, &ModelManager::remoteStateChanged, this, [=](bool attached, const QString &hostName) {
+        detachAction->setVisible(attached);
+        if (attached)
+            DMessageManager::instance()->sendMessage(this, QIcon::fromTheme("dialog-ok"), tr("Showing %1").arg(hostName));
+    });
+    connect(modelManager, &ModelManager::remoteFailed, this, [=](const QString &target, const QString &error) {
+        ErrorDialog::show(this, tr("Lost the remote host %1").arg(target), error);
+    });
+
     menu->addSeparator();
     menu->addMenu(modeMenu);
+    menu->addMenu(intervalMenu);
+    menu->addMenu(snapshotMenu);
+    menu->addMenu(exportMenu);
+    menu->addMenu(remoteMenu);
 
     // 等保需求，设置入口，1050打开
     // 插入 setting 菜单项
@@ -202,14 +340,11 @@ void MainWindow::initUI()
     m_tbShadow->move(0, 0);
     m_tbShadow->show();
 
+    // only the process page is shown at launch, the others are built on first switch
     m_procPage = new ProcessPageWidget(m_pages);
-    m_svcPage = new SystemServicePageWidget(m_pages);
-    m_accountProcPage = new UserPageWidget(m_pages);
 
     m_pages->setContentsMargins(0, 0, 0, 0);
     m_pages->addWidget(m_procPage);
-    m_pages->addWidget(m_svcPage);
-    m_pages->addWidget(m_accountProcPage);
     m_tbShadow->raise();
 
     installEventFilter(this);
@@ -235,7 +370,7 @@ void MainWindow::initConnections()
         PERF_PRINT_BEGIN("POINT-05", QString("switch(%1->%2)").arg(DApplication::translate("Title.Bar.Switch", "Processes")).arg(DApplication::translate("Title.Bar.Switch", "Services")));
         qCDebug(app) << "Switching to service page";
         m_toolbar->clearSearchText();
-        m_pages->setCurrentWidget(m_svcPage);
+        m_pages->setCurrentWidget(servicePage());
 
         m_tbShadow->raise();
         m_tbShadow->show();
@@ -245,12 +380,26 @@ void MainWindow::initConnections()
         PERF_PRINT_BEGIN("POINT-05", QString("switch(%1->%2)").arg(DApplication::translate("Title.Bar.Switch", "Users")).arg(DApplication::translate("Title.Bar.Switch", "Services")));
         qCDebug(app) << "Switching to account process page";
         m_toolbar->clearSearchText();
-        m_pages->setCurrentWidget(m_accountProcPage);
+        m_pages->setCurrentWidget(accountProcPage());
         m_accountProcPage->onUserChanged();
         m_tbShadow->raise();
         m_tbShadow->show();
         PERF_PRINT_END("POINT-05");
     });
+    connect(m_toolbar, &Toolbar::fleetTabButtonClicked, this, [=]() {
+        qCDebug(app) << "Switching to fleet page";
+        m_toolbar->clearSearchText();
+        m_pages->setCurrentWidget(fleetPage());
+        m_tbShadow->raise();
+        m_tbShadow->show();
+    });
+    connect(m_toolbar, &Toolbar::socketTabButtonClicked, this, [=]() {
+        qCDebug(app) << "Switching to socket page";
+        m_toolbar->clearSearchText();
+        m_pages->setCurrentWidget(socketPage());
+        m_tbShadow->raise();
+        m_tbShadow->show();
+    });
     connect(gApp, &Application::backgroundTaskStateChanged, this, [=](Application::TaskState state) {
         qCDebug(app) << "Background task state changed:" << state;
         if (state == Application::kTaskStarted) {
@@ -292,6 +441,58 @@ void MainWindow::initConnections()
     connect(this, &MainWindow::killProcessPerformed, this, &MainWindow::onKillProcess);
 }
 
+SystemServicePageWidget *MainWindow::servicePage()
+{
+    if (!m_svcPage) {
+        qCDebug(app) << "Creating service page";
+        m_svcPage = new SystemServicePageWidget(m_pages);
+        m_pages->addWidget(m_svcPage);
+        m_tbShadow->raise();
+    }
+    return m_svcPage;
+}
+
+UserPageWidget *MainWindow::accountProcPage()
+{
+    if (!m_accountProcPage) {
+        qCDebug(app) << "Creating account process page";
+        m_accountProcPage = new UserPageWidget(m_pages);
+        m_pages->addWidget(m_accountProcPage);
+        m_tbShadow->raise();
+    }
+    return m_accountProcPage;
+}
+
+FleetPageWidget *MainWindow::fleetPage()
+{
+    if (!m_fleetPage) {
+        qCDebug(app) << "Creating fleet page";
+        m_fleetPage = new FleetPageWidget(m_pages);
+        m_pages->addWidget(m_fleetPage);
+        m_tbShadow->raise();
+        // drill down, every page shows the host until it's detached again
+        connect(m_fleetPage, &FleetPageWidget::hostActivated, this, [=](const QString &target) {
+            if (!ModelManager::instance()->attachRemote(target)) {
+                ErrorDialog::show(this, tr("Failed to attach to the remote host"), target);
+                return;
+            }
+            m_toolbar->setProcessButtonChecked(true);
+        });
+    }
+    return m_fleetPage;
+}
+
+SocketPageWidget *MainWindow::socketPage()
+{
+    if (!m_socketPage) {
+        qCDebug(app) << "Creating socket page";
+        m_socketPage = new SocketPageWidget(m_pages);
+        m_pages->addWidget(m_socketPage);
+        m_tbShadow->raise();
+    }
+    return m_socketPage;
+}
+
 // resize event handler
 void MainWindow::resizeEvent(QResizeEvent *event)
 {
@@ -349,6 +550,8 @@ void MainWindow::showEvent(QShowEvent *event)
 {
     qCDebug(app) << "MainWindow show event";
     DMainWindow::showEvent(event);
+    ModelManager::instance()->updateCoordinator()->setPaused(isMinimized());
+    core::system::DemandTracker::instance()->setSuspended(isMinimized());
 
     if (!m_initLoad) {
         qCDebug(app) << "MainWindow show event, starting monitor job";
@@ -358,6 +561,27 @@ void MainWindow::showEvent(QShowEvent *event)
     }
 }
 
+void MainWindow::hideEvent(QHideEvent *event)
+{
+    qCDebug(app) << "MainWindow hide event";
+    DMainWindow::hideEvent(event);
+    // nothing is on screen, stat updates pile up & are flushed once when shown again
+    ModelManager::instance()->updateCoordinator()->setPaused(true);
+    core::system::DemandTracker::instance()->setSuspended(true);
+}
+
+void MainWindow::changeEvent(QEvent *event)
+{
+    DMainWindow::changeEvent(event);
+
+    if (event->type() == QEvent::WindowStateChange) {
+        qCDebug(app) << "MainWindow state changed, minimized:" << isMinimized();
+        core::system::SystemMonitor::instance()->setBackgroundMode(isMinimized());
+        ModelManager::instance()->updateCoordinator()->setPaused(isMinimized() || !isVisible());
+        core::system::DemandTracker::instance()->setSuspended(isMinimized() || !isVisible());
+    }
+}
+
 void MainWindow::onStartMonitorJob()
 {
     qCDebug(app) << "onStartMonitorJob";
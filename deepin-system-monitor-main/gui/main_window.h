@@ -18,6 +18,8 @@ class SystemServicePageWidget;
 class ProcessPageWidget;
 class Settings;
 class UserPageWidget;
+class FleetPageWidget;
+class SocketPageWidget;
 class MainWindow : public DMainWindow
 {
     Q_OBJECT
@@ -123,8 +125,36 @@ protected:
      * @param event Show event
      */
     void showEvent(QShowEvent *event) override;
+    /**
+     * @brief hideEvent Hide event handler, pauses view updates
+     * @param event Hide event
+     */
+    void hideEvent(QHideEvent *event) override;
+
+    /**
+     * @brief changeEvent Change event handler, slows down refresh & pauses view updates while minimized
+     * @param event Change event
+     */
+    void changeEvent(QEvent *event) override;
 
 private:
+    /**
+     * @brief Service page, created on first use since it enumerates systemd units
+     */
+    SystemServicePageWidget *servicePage();
+    /**
+     * @brief Account process page, created on first use since it sets up AccountsService proxies
+     */
+    UserPageWidget *accountProcPage();
+    /**
+     * @brief Hosts page, created on first use since it connects to the agents of the fleet
+     */
+    FleetPageWidget *fleetPage();
+    /**
+     * @brief Sockets page, created on first use
+     */
+    SocketPageWidget *socketPage();
+
     Settings *m_settings = nullptr;
 
     Toolbar *m_toolbar = nullptr;
@@ -132,6 +162,8 @@ private:
     ProcessPageWidget *m_procPage = nullptr;
     SystemServicePageWidget *m_svcPage = nullptr;
     UserPageWidget *m_accountProcPage = nullptr;
+    FleetPageWidget *m_fleetPage = nullptr;
+    SocketPageWidget *m_socketPage = nullptr;
     bool m_initLoad = false;
     DShadowLine *m_tbShadow  = nullptr;
     QWidget *m_focusedWidget = nullptr;
@@ -6,7 +6,12 @@
 #include "mem_detail_view_widget.h"
 #include "mem_stat_view_widget.h"
 #include "mem_summary_view_widget.h"
-#include "system/system_monitor.h"
+#include "pressure_view_widget.h"
+#include "numa_view_widget.h"
+#include "vm_activity_view_widget.h"
+#include "mem_tuning_view_widget.h"
+#include "model/model_manager.h"
+#include "model/update_coordinator.h"
 #include "ddlog.h"
 
 #include <DApplication>
@@ -21,15 +26,23 @@ MemDetailViewWidget::MemDetailViewWidget(QWidget *parent)
     this->setObjectName("MemDetailViewWidget");
     m_memstatWIdget = new MemStatViewWidget(this);
     m_memsummaryWidget = new MemSummaryViewWidget(this);
+    m_pressureWidget = new PressureViewWidget(common::pressure::kMemoryPressure, this);
+    m_numaWidget = new NumaViewWidget(NumaViewWidget::kMemoryMode, this);
+    m_vmActivityWidget = new VmActivityViewWidget(this);
+    m_memTuningWidget = new MemTuningViewWidget(this);
 
     setTitle(DApplication::translate("Process.Graph.Title", "Memory"));
     m_centralLayout->addWidget(m_memstatWIdget);
     m_centralLayout->addWidget(m_memsummaryWidget);
+    m_centralLayout->addWidget(m_numaWidget);
+    m_centralLayout->addWidget(m_pressureWidget);
+    m_centralLayout->addWidget(m_vmActivityWidget);
+    m_centralLayout->addWidget(m_memTuningWidget);
 
     detailFontChanged(DApplication::font());
 
     onModelUpdate();
-    connect(SystemMonitor::instance(), &SystemMonitor::statInfoUpdated, this, &MemDetailViewWidget::onModelUpdate);
+    connect(ModelManager::instance()->updateCoordinator(), &UpdateCoordinator::updateViews, this, &MemDetailViewWidget::onModelUpdate);
 
     connect(dynamic_cast<QGuiApplication *>(DApplication::instance()), &DApplication::fontChanged,
                 this, &MemDetailViewWidget::detailFontChanged);
@@ -48,4 +61,8 @@ void MemDetailViewWidget::detailFontChanged(const QFont &font)
     BaseDetailViewWidget::detailFontChanged(font);
     m_memstatWIdget->fontChanged(font);
     m_memsummaryWidget->fontChanged(font);
+    m_pressureWidget->fontChanged(font);
+    m_numaWidget->fontChanged(font);
+    m_vmActivityWidget->fontChanged(font);
+    m_memTuningWidget->fontChanged(font);
 }
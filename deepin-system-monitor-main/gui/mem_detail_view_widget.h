@@ -13,6 +13,10 @@
  */
 class MemStatViewWidget;
 class MemSummaryViewWidget;
+class PressureViewWidget;
+class NumaViewWidget;
+class VmActivityViewWidget;
+class MemTuningViewWidget;
 class MemDetailViewWidget : public BaseDetailViewWidget
 {
     Q_OBJECT
@@ -27,6 +31,10 @@ public slots:
 private:
     MemStatViewWidget *m_memstatWIdget;
     MemSummaryViewWidget *m_memsummaryWidget;
+    PressureViewWidget *m_pressureWidget;
+    NumaViewWidget *m_numaWidget;
+    VmActivityViewWidget *m_vmActivityWidget;
+    MemTuningViewWidget *m_memTuningWidget;
 };
 
 #endif // MEM_DETAIL_VIEW_WIDGET_H
@@ -6,7 +6,10 @@
 #include "mem_stat_view_widget.h"
 #include "chart_view_widget.h"
 #include "common/common.h"
+#include "model/model_manager.h"
+#include "model/sample_history.h"
 #include "system/device_db.h"
+#include "system/device_snapshot.h"
 #include "system/mem.h"
 #include "ddlog.h"
 
@@ -35,7 +38,16 @@ MemStatViewWidget::MemStatViewWidget(QWidget *parent) : QWidget(parent)
     m_memChartWidget->setData1Color(memoryColor);
     m_swapChartWidget->setData1Color(swapColor);
 
-    m_memInfo = DeviceDB::instance()->memInfo();
+    SampleHistory *history = ModelManager::instance()->sampleHistory();
+    m_memChartWidget->setSeries1(&history->series(SampleHistory::kMemoryUsage));
+    m_swapChartWidget->setSeries1(&history->series(SampleHistory::kSwapUsage));
+    m_memChartWidget->setStoredSeries1(SampleHistory::kMemoryUsage);
+    m_swapChartWidget->setStoredSeries1(SampleHistory::kSwapUsage);
+    connect(history, &SampleHistory::updated, m_memChartWidget, &ChartViewWidget::updateSeries);
+    connect(history, &SampleHistory::updated, m_swapChartWidget, &ChartViewWidget::updateSeries);
+
+    m_snapshot = DeviceDB::instance()->snapshot();
+    m_memInfo = &m_snapshot->memInfo;
 }
 
 void MemStatViewWidget::fontChanged(const QFont &font)
@@ -47,14 +59,14 @@ void MemStatViewWidget::fontChanged(const QFont &font)
 void MemStatViewWidget::onModelUpdate()
 {
     qCDebug(app) << "MemStatViewWidget onModelUpdate";
+    m_snapshot = DeviceDB::instance()->snapshot();
+    m_memInfo = &m_snapshot->memInfo;
     // After memory size text, add a space before the brackets
     QString memoryDetail = QString("%1 (%2)")
                            .arg(tr("Size"))
                            .arg(formatUnit_memory_disk(m_memInfo->memTotal() << 10, B, 1));
     parent()->setProperty("detail", memoryDetail);
 
-    m_memChartWidget->addData1((m_memInfo->memTotal() - m_memInfo->memAvailable()) * 1.0 / m_memInfo->memTotal());
-    m_swapChartWidget->addData1((m_memInfo->swapTotal() - m_memInfo->swapFree()) * 1.0 / m_memInfo->swapTotal());
     updateWidgetGeometry();
 }
 
@@ -9,9 +9,12 @@
 #include <QWidget>
 #include <DCommandLinkButton>
 
+#include <memory>
+
 namespace core {
 namespace system {
 class MemInfo;
+struct DeviceSnapshot;
 }
 }
 
@@ -41,7 +44,9 @@ private:
     ChartViewWidget *m_memChartWidget;
     ChartViewWidget *m_swapChartWidget;
 
-    core::system::MemInfo *m_memInfo;
+    const core::system::MemInfo *m_memInfo;
+    // published device state m_memInfo points into
+    std::shared_ptr<const core::system::DeviceSnapshot> m_snapshot;
 
     QFont m_font;
 };
@@ -5,6 +5,7 @@
 
 #include "mem_summary_view_widget.h"
 #include "system/device_db.h"
+#include "system/device_snapshot.h"
 #include "system/mem.h"
 #include "common/common.h"
 #include "base/base_detail_item_delegate.h"
@@ -35,8 +36,16 @@ public:
     explicit DeailTableModel(QObject *parent = nullptr);
     virtual ~DeailTableModel();
 
+    // pick up the latest published snapshot
+    void updateModel()
+    {
+        m_snapshot = DeviceDB::instance()->snapshot();
+        m_memInfo = &m_snapshot->memInfo;
+    }
+
 private:
-    MemInfo *m_memInfo;
+    DeviceSnapshotPtr m_snapshot;
+    const MemInfo *m_memInfo;
 
 protected:
     int rowCount(const QModelIndex &) const
@@ -175,7 +184,7 @@ protected:
 DeailTableModel::DeailTableModel(QObject *parent): QAbstractTableModel(parent)
 {
     qCDebug(app) << "DeailTableModel constructor";
-    m_memInfo = DeviceDB::instance()->memInfo();
+    updateModel();
 }
 
 DeailTableModel::~DeailTableModel()
@@ -222,6 +231,7 @@ MemSummaryViewWidget::MemSummaryViewWidget(QWidget *parent)
 void MemSummaryViewWidget::onModelUpdate()
 {
     // qCDebug(app) << "MemSummaryViewWidget onModelUpdate";
+    m_model->updateModel();
     this->viewport()->update();
 }
 
@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "mem_tuning_view_widget.h"
+#include "common/common.h"
+#include "model/model_manager.h"
+#include "model/update_coordinator.h"
+#include "system/device_db.h"
+#include "system/device_snapshot.h"
+#include "ddlog.h"
+
+#include <DFontSizeManager>
+
+#include <QHBoxLayout>
+#include <QStringList>
+#include <QVBoxLayout>
+
+#include <unistd.h>
+
+using namespace DDLog;
+using namespace common::format;
+using namespace core::system;
+
+static QVBoxLayout *columnLayout(QWidget *title, QWidget *body)
+{
+    auto *layout = new QVBoxLayout();
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(title);
+    layout->addWidget(body);
+    layout->addStretch();
+    return layout;
+}
+
+MemTuningViewWidget::MemTuningViewWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    qCDebug(app) << "MemTuningViewWidget constructor";
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+
+    m_thpTitleLabel = new DLabel(tr("Huge pages"), this);
+    m_thpTitleLabel->setToolTip(tr("Transparent huge pages in use & how page faults got them. Faults "
+                                   "falling back to small pages or failed collapses mean memory is too "
+                                   "fragmented to back the mode"));
+    m_zswapTitleLabel = new DLabel(tr("zswap"), this);
+    m_zswapTitleLabel->setToolTip(tr("Compressed cache in front of swap: the pool is the memory taken, "
+                                     "stored what it holds uncompressed. Older kernels only tell the "
+                                     "sizes to root through debugfs"));
+    m_zramTitleLabel = new DLabel(tr("zram"), this);
+    m_zramTitleLabel->setToolTip(tr("Compressed ram disks, the ratio is stored data per memory used, "
+                                    "allocator overhead included"));
+    m_thpLabel = new DLabel(this);
+    m_zswapLabel = new DLabel(this);
+    m_zramLabel = new DLabel(this);
+    for (DLabel *title : {m_thpTitleLabel, m_zswapTitleLabel, m_zramTitleLabel}) {
+        title->setForegroundRole(DPalette::TextTips);
+        DFontSizeManager::instance()->bind(title, DFontSizeManager::T8);
+    }
+
+    auto *layout = new QHBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(16);
+    layout->addLayout(columnLayout(m_thpTitleLabel, m_thpLabel), 1);
+    layout->addLayout(columnLayout(m_zswapTitleLabel, m_zswapLabel), 1);
+    layout->addLayout(columnLayout(m_zramTitleLabel, m_zramLabel), 1);
+
+    onModelUpdate();
+    connect(ModelManager::instance()->updateCoordinator(), &UpdateCoordinator::updateViews, this, &MemTuningViewWidget::onModelUpdate);
+}
+
+void MemTuningViewWidget::fontChanged(const QFont &font)
+{
+    qCDebug(app) << "MemTuningViewWidget fontChanged";
+    m_thpLabel->setFont(font);
+    m_zswapLabel->setFont(font);
+    m_zramLabel->setFont(font);
+}
+
+void MemTuningViewWidget::onModelUpdate()
+{
+    DeviceSnapshotPtr snapshot = DeviceDB::instance()->snapshot();
+    const mem_tuning_t &info = snapshot->memTuning;
+    // sampled slowly, kept hidden until the first sample & while a recording is replayed
+    setVisible(info.valid);
+    if (!info.valid)
+        return;
+
+    QStringList thp;
+    if (info.thpEnabled.isEmpty())
+        thp << tr("Not supported");
+    else
+        thp << tr("Mode %1, defrag %2").arg(info.thpEnabled).arg(info.thpDefrag);
+    thp << tr("Anonymous %1, shmem %2")
+               .arg(formatUnit_memory_disk(info.anonHugePages, KB))
+               .arg(formatUnit_memory_disk(info.shmemHugePages, KB));
+    if (info.fileHugePages > 0)
+        thp << tr("Page cache %1").arg(formatUnit_memory_disk(info.fileHugePages, KB));
+    if (info.ratesValid && !info.thpEnabled.isEmpty()) {
+        // share of faults that wanted a huge page & got small ones
+        const qreal faults = info.thpFaultAlloc + info.thpFaultFallback;
+        thp << tr("Faults %1/s, %2% fell back")
+                   .arg(faults, 0, 'f', 1)
+                   .arg(faults > 0 ? info.thpFaultFallback * 100. / faults : 0., 0, 'f', 0);
+        thp << tr("Collapsed %1/s, failed %2/s").arg(info.thpCollapseAlloc, 0, 'f', 2).arg(info.thpCollapseFailed, 0, 'f', 2);
+    }
+    m_thpLabel->setText(thp.join('\n'));
+
+    m_zswapTitleLabel->setVisible(info.zswapAvailable);
+    m_zswapLabel->setVisible(info.zswapAvailable);
+    if (info.zswapAvailable) {
+        QStringList zswap;
+        if (info.zswapEnabled)
+            zswap << tr("On, %1, at most %2% of memory").arg(info.zswapCompressor).arg(info.zswapMaxPoolPercent);
+        else
+            zswap << tr("Off");
+        if (info.zswapSizesKnown && info.zswapPool > 0)
+            zswap << tr("Pool %1 holds %2, ratio %3")
+                         .arg(formatUnit_memory_disk(info.zswapPool, KB))
+                         .arg(formatUnit_memory_disk(info.zswapStored, KB))
+                         .arg(qreal(info.zswapStored) / info.zswapPool, 0, 'f', 2);
+        else if (info.zswapSizesKnown)
+            zswap << tr("Pool empty");
+        else if (info.zswapEnabled)
+            zswap << tr("Pool size not readable");
+        if (info.ratesValid && (info.zswapIn > 0 || info.zswapOut > 0)) {
+            const qreal pageBytes = qreal(sysconf(_SC_PAGESIZE));
+            zswap << tr("Loaded %1, stored %2")
+                         .arg(formatUnit_memory_disk(info.zswapIn * pageBytes, B, 1, true))
+                         .arg(formatUnit_memory_disk(info.zswapOut * pageBytes, B, 1, true));
+        }
+        m_zswapLabel->setText(zswap.join('\n'));
+    }
+
+    m_zramTitleLabel->setVisible(!info.zram.isEmpty());
+    m_zramLabel->setVisible(!info.zram.isEmpty());
+    QStringList zram;
+    for (const zram_device_t &device : info.zram) {
+        if (device.memUsedTotal == 0)
+            zram << tr("%1 (%2): empty").arg(device.name).arg(device.algorithm);
+        else
+            zram << tr("%1 (%2): %3 in %4, ratio %5")
+                        .arg(device.name)
+                        .arg(device.algorithm)
+                        .arg(formatUnit_memory_disk(device.origDataSize, B))
+                        .arg(formatUnit_memory_disk(device.memUsedTotal, B))
+                        .arg(device.ratio(), 0, 'f', 2);
+    }
+    m_zramLabel->setText(zram.join('\n'));
+}
@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef MEM_TUNING_VIEW_WIDGET_H
+#define MEM_TUNING_VIEW_WIDGET_H
+
+#include <DLabel>
+
+#include <QWidget>
+
+DWIDGET_USE_NAMESPACE
+
+/**
+ * @brief Transparent huge page, zswap & zram efficiency in the memory detail view
+ *
+ * Three columns: huge pages in use & how often faults get one or fall back, the zswap pool
+ * against what it holds, & the compression ratio of each zram device. A column is left out
+ * where the kernel lacks the feature, the whole view until the first slow sample is in.
+ */
+class MemTuningViewWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit MemTuningViewWidget(QWidget *parent = nullptr);
+
+public slots:
+    void fontChanged(const QFont &font);
+    void onModelUpdate();
+
+private:
+    DLabel *m_thpTitleLabel;
+    DLabel *m_thpLabel;
+    DLabel *m_zswapTitleLabel;
+    DLabel *m_zswapLabel;
+    DLabel *m_zramTitleLabel;
+    DLabel *m_zramLabel;
+};
+
+#endif // MEM_TUNING_VIEW_WIDGET_H
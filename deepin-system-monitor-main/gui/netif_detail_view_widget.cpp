@@ -6,7 +6,10 @@
 #include "netif_detail_view_widget.h"
 #include "netif_stat_view_widget.h"
 #include "netif_summary_view_widget.h"
-#include "system/system_monitor.h"
+#include "netif_queue_view_widget.h"
+#include "model/model_manager.h"
+#include "model/update_coordinator.h"
+#include "system/demand_tracker.h"
 #include "ddlog.h"
 
 #include <DApplication>
@@ -18,16 +21,20 @@ NetifDetailViewWidget::NetifDetailViewWidget(QWidget *parent)
 {
     qCDebug(app) << "NetifDetailViewWidget constructor";
     this->setObjectName("NetifDetailViewWidget");
+    DemandTracker::instance()->declare(this, DemandTracker::kNetifDemand);
 
     m_netifstatWIdget = new NetifStatViewWidget(this);
     m_netifsummaryWidget = new NetifSummaryViewWidget(this);
+    m_queueWidget = new NetifQueueViewWidget(this);
 
-    connect(SystemMonitor::instance(), &SystemMonitor::statInfoUpdated, this, &NetifDetailViewWidget::updateData);
+    connect(ModelManager::instance()->updateCoordinator(), &UpdateCoordinator::updateViews, this, &NetifDetailViewWidget::updateData);
     connect(m_netifstatWIdget, &NetifStatViewWidget::netifItemClicked, m_netifsummaryWidget, &NetifSummaryViewWidget::onNetifItemClicked);
+    connect(m_netifstatWIdget, &NetifStatViewWidget::netifItemClicked, m_queueWidget, &NetifQueueViewWidget::onNetifItemClicked);
 
     setTitle(DApplication::translate("Process.Graph.View", "Network"));
     m_centralLayout->addWidget(m_netifstatWIdget);
     m_centralLayout->addWidget(m_netifsummaryWidget);
+    m_centralLayout->addWidget(m_queueWidget);
 
     detailFontChanged(DApplication::font());
 
@@ -46,6 +53,7 @@ void NetifDetailViewWidget::detailFontChanged(const QFont &font)
 
     m_netifstatWIdget->fontChanged(font);
     m_netifsummaryWidget->fontChanged(font);
+    m_queueWidget->fontChanged(font);
 }
 
 void NetifDetailViewWidget::updateData()
@@ -54,3 +62,15 @@ void NetifDetailViewWidget::updateData()
     m_netifstatWIdget->onModelUpdate();
     m_netifsummaryWidget->onModelUpdate();
 }
+
+void NetifDetailViewWidget::showEvent(QShowEvent *event)
+{
+    BaseDetailViewWidget::showEvent(event);
+    DemandTracker::instance()->setVisible(this, true);
+}
+
+void NetifDetailViewWidget::hideEvent(QHideEvent *event)
+{
+    DemandTracker::instance()->setVisible(this, false);
+    BaseDetailViewWidget::hideEvent(event);
+}
@@ -13,6 +13,7 @@
  */
 class NetifStatViewWidget;
 class NetifSummaryViewWidget;
+class NetifQueueViewWidget;
 class NetifDetailViewWidget : public BaseDetailViewWidget
 {
     Q_OBJECT
@@ -25,9 +26,15 @@ public slots:
     void detailFontChanged(const QFont &font);
     void updateData();   // 更新数据
 
+protected:
+    // interfaces are sampled only while the detail is shown
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
 private:
     NetifStatViewWidget *m_netifstatWIdget;
     NetifSummaryViewWidget *m_netifsummaryWidget;
+    NetifQueueViewWidget *m_queueWidget;
 
 };
 
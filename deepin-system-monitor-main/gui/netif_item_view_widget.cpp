@@ -6,6 +6,8 @@
 #include "netif_item_view_widget.h"
 #include "chart_view_widget.h"
 #include "common/common.h"
+#include "model/model_manager.h"
+#include "model/sample_history.h"
 #include "system/netif.h"
 #include "ddlog.h"
 
@@ -39,6 +41,13 @@ NetifItemViewWidget::NetifItemViewWidget(QWidget *parent, const QByteArray &mac)
     m_ChartWidget->setData1Color(m_recvColor);
     m_ChartWidget->setData2Color(m_sentColor);
     m_ChartWidget->setSpeedAxis(true);
+
+    SampleHistory *history = ModelManager::instance()->sampleHistory();
+    m_ChartWidget->setSeries1(&history->series(SampleHistory::kNetRecv, QString::fromUtf8(mac)));
+    m_ChartWidget->setSeries2(&history->series(SampleHistory::kNetSent, QString::fromUtf8(mac)));
+    m_ChartWidget->setStoredSeries1(SampleHistory::kNetRecv, QString::fromUtf8(mac));
+    m_ChartWidget->setStoredSeries2(SampleHistory::kNetSent, QString::fromUtf8(mac));
+    connect(history, &SampleHistory::updated, m_ChartWidget, &ChartViewWidget::updateSeries);
     updateWidgetGeometry();
 }
 
@@ -178,9 +187,6 @@ void NetifItemViewWidget::setMode(int mode)
 void NetifItemViewWidget::updateData(const std::shared_ptr<class core::system::NetifInfo> &netifInfo)
 {
     qCDebug(app) << "Updating data for interface:" << netifInfo->ifname();
-    m_ChartWidget->addData1(netifInfo->recv_bps());
-    m_ChartWidget->addData2(netifInfo->sent_bps());
-
     if (!netifInfo->ifname().isNull()) {m_ifname = netifInfo->ifname();}
 
     m_recv_bps = formatUnit_net(netifInfo->recv_bps() * 8, B, 1, true);
@@ -0,0 +1,224 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "netif_queue_view_widget.h"
+#include "model/netif_queue_model.h"
+#include "common/core_usage.h"
+#include "system/cpu_set.h"
+#include "system/device_db.h"
+#include "system/device_snapshot.h"
+#include "system/netif.h"
+#include "ddlog.h"
+
+#include <DApplicationHelper>
+#include <DPalette>
+
+#include <QHelpEvent>
+#include <QPainter>
+#include <QToolTip>
+#include <QtMath>
+
+DWIDGET_USE_NAMESPACE
+using namespace DDLog;
+using namespace core::system;
+
+// per queue counters move slowly enough, & /proc/interrupts is long on big machines
+#define NETIF_QUEUE_REFRESH_INTERVAL 3000
+
+namespace {
+
+const int kLabelWidth = 150;
+const int kRateWidth = 150;
+const int kSpacing = 4;
+
+QString rateText(qreal rate)
+{
+    if (rate >= 1000000)
+        return QString("%1M").arg(rate / 1000000, 0, 'f', 1);
+    if (rate >= 1000)
+        return QString("%1k").arg(rate / 1000, 0, 'f', 1);
+    return QString::number(qRound(rate));
+}
+
+} // namespace
+
+NetifQueueViewWidget::NetifQueueViewWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    qCDebug(app) << "NetifQueueViewWidget constructor";
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    setVisible(false);
+
+    m_model = new NetifQueueModel(this);
+    connect(m_model, &NetifQueueModel::updated, this, &NetifQueueViewWidget::updateHeight);
+    m_timer.setInterval(NETIF_QUEUE_REFRESH_INTERVAL);
+    connect(&m_timer, &QTimer::timeout, this, &NetifQueueViewWidget::refreshQueues);
+}
+
+void NetifQueueViewWidget::fontChanged(const QFont &font)
+{
+    setFont(font);
+    updateHeight();
+}
+
+void NetifQueueViewWidget::onNetifItemClicked(const QString &mac)
+{
+    DeviceSnapshotPtr snapshot = DeviceDB::instance()->snapshot();
+    const NetifInfoPtr netif = snapshot->netifInfo.value(mac.toUtf8());
+    const QByteArray ifname = netif ? netif->ifname() : QByteArray();
+    if (ifname == m_model->ifname())
+        return;
+    m_model->setInterface(ifname);
+    // hidden for the last interface, read once to know if this one has queues
+    refreshQueues();
+}
+
+void NetifQueueViewWidget::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    // shown by the first read of an interface, which took the base already
+    if (m_model->queues().isEmpty())
+        refreshQueues();
+    m_timer.start();
+}
+
+void NetifQueueViewWidget::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    m_timer.stop();
+    m_model->stop();
+}
+
+void NetifQueueViewWidget::refreshQueues()
+{
+    m_model->refresh();
+    if (m_model->queues().isEmpty())
+        qCDebug(app) << "No queue irqs for" << m_model->ifname() << ", queue view hidden";
+    setVisible(!m_model->queues().isEmpty());
+}
+
+int NetifQueueViewWidget::rowHeight() const
+{
+    return fontMetrics().height() + 2;
+}
+
+QRect NetifQueueViewWidget::matrixRect() const
+{
+    const int top = 2 * (fontMetrics().height() + kSpacing);
+    return QRect(kLabelWidth, top, qMax(0, width() - kLabelWidth - kRateWidth), m_model->queues().size() * rowHeight());
+}
+
+void NetifQueueViewWidget::updateHeight()
+{
+    setFixedHeight(matrixRect().bottom() + 1 + kSpacing);
+    update();
+}
+
+void NetifQueueViewWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.setFont(font());
+    const QFontMetrics fm = painter.fontMetrics();
+    auto palette = DApplicationHelper::instance()->palette(this);
+    const QList<NetifQueueModel::queue_t> &queues = m_model->queues();
+    const QVector<int> &cpus = m_model->cpus();
+
+    int saturated = 0;
+    qreal peak = 0.;
+    for (const NetifQueueModel::queue_t &queue : queues) {
+        saturated += queue.saturated ? 1 : 0;
+        for (qreal rate : queue.rates)
+            peak = qMax(peak, rate);
+    }
+    QString title = tr("Queue interrupts per CPU");
+    if (saturated > 0)
+        title += "  " + tr("%n queue(s) on saturated cores", "", saturated);
+    painter.setPen(palette.color(saturated > 0 ? DPalette::TextWarning : DPalette::TextTips));
+    painter.drawText(QRect(0, 0, width(), fm.height()), Qt::AlignLeft | Qt::AlignVCenter, title);
+
+    const QRect matrix = matrixRect();
+    if (cpus.isEmpty() || matrix.width() <= 0)
+        return;
+    const qreal cellWidth = qreal(matrix.width()) / cpus.size();
+
+    // cpu ids, every few of them when the cells are narrow
+    painter.setPen(palette.color(DPalette::TextTips));
+    const int step = qMax(1, qCeil((fm.horizontalAdvance(QString::number(cpus.last())) + kSpacing) / cellWidth));
+    const int headerTop = fm.height() + kSpacing;
+    for (int c = 0; c < cpus.size(); c += step) {
+        const QRectF cell(matrix.left() + c * cellWidth, headerTop, cellWidth * step, fm.height());
+        painter.drawText(cell, Qt::AlignLeft | Qt::AlignVCenter, QString::number(cpus[c]));
+    }
+    painter.drawText(QRect(matrix.right() + 1 + kSpacing, headerTop, kRateWidth - kSpacing, fm.height()),
+                     Qt::AlignLeft | Qt::AlignVCenter, tr("Packets/s"));
+
+    painter.fillRect(matrix, palette.color(DPalette::ItemBackground));
+    // log scale, a queue spread over many cores stays visible next to one on a single core
+    const QColor highlight = palette.color(DPalette::Highlight);
+    const QColor warning = palette.color(DPalette::TextWarning);
+    const qreal scale = qLn(peak + 1);
+    for (int r = 0; r < queues.size(); ++r) {
+        const NetifQueueModel::queue_t &queue = queues[r];
+        const int y = matrix.top() + r * rowHeight();
+
+        painter.setPen(palette.color(queue.saturated ? DPalette::TextWarning : DPalette::WindowText));
+        painter.drawText(QRect(0, y, kLabelWidth - kSpacing, rowHeight()), Qt::AlignLeft | Qt::AlignVCenter,
+                         fm.elidedText(QString::fromLocal8Bit(queue.name), Qt::ElideMiddle, kLabelWidth - kSpacing));
+
+        for (int c = 0; scale > 0 && c < cpus.size(); ++c) {
+            const int cpu = cpus[c];
+            const qreal rate = cpu < queue.rates.size() ? queue.rates[cpu] : 0.;
+            if (rate <= 0)
+                continue;
+            QColor color = queue.saturated && cpu == queue.cpu ? warning : highlight;
+            color.setAlphaF(0.15 + 0.85 * qLn(rate + 1) / scale);
+            painter.fillRect(QRectF(matrix.left() + c * cellWidth, y, cellWidth, rowHeight() - 1), color);
+        }
+
+        QStringList packets;
+        if (queue.rxPackets >= 0)
+            packets << tr("rx %1").arg(rateText(queue.rxPackets));
+        if (queue.txPackets >= 0)
+            packets << tr("tx %1").arg(rateText(queue.txPackets));
+        painter.setPen(palette.color(DPalette::TextTips));
+        painter.drawText(QRect(matrix.right() + 1 + kSpacing, y, kRateWidth - kSpacing, rowHeight()),
+                         Qt::AlignLeft | Qt::AlignVCenter, packets.isEmpty() ? QStringLiteral("-") : packets.join("  "));
+    }
+}
+
+bool NetifQueueViewWidget::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip) {
+        auto *help = static_cast<QHelpEvent *>(event);
+        const QRect matrix = matrixRect();
+        const QVector<int> &cpus = m_model->cpus();
+        if (!matrix.contains(help->pos()) || cpus.isEmpty()) {
+            QToolTip::hideText();
+            event->ignore();
+            return true;
+        }
+
+        const int row = (help->pos().y() - matrix.top()) / rowHeight();
+        const int column = int((help->pos().x() - matrix.left()) * cpus.size() / matrix.width());
+        const NetifQueueModel::queue_t &queue = m_model->queues().at(qBound(0, row, m_model->queues().size() - 1));
+        const int cpu = cpus.at(qBound(0, column, cpus.size() - 1));
+        const qreal rate = cpu < queue.rates.size() ? queue.rates[cpu] : 0.;
+        QString text = tr("IRQ %1 %2 on CPU%3: %4 interrupts/s").arg(queue.irq).arg(QString::fromLocal8Bit(queue.name))
+                       .arg(cpu).arg(rateText(rate));
+        if (!queue.affinity.contains(cpu) && !queue.affinity.isEmpty())
+            text += "\n" + tr("Not in the affinity of the IRQ");
+
+        const common::usage::CoreUsage &usage = DeviceDB::instance()->snapshot()->cpuSet.coreUsage();
+        if (cpu < usage.size()) {
+            const size_t index = size_t(cpu);
+            text += "\n" + tr("CPU%1 %2% busy, %3% in interrupt handlers").arg(cpu)
+                    .arg(usage.usage[index], 0, 'f', 1).arg(usage.hardirq[index] + usage.softirq[index], 0, 'f', 1);
+        }
+        if (queue.saturated)
+            text += "\n" + tr("The busiest CPU of this queue is saturated, spread its IRQ or use RPS");
+        QToolTip::showText(help->globalPos(), text, this);
+        return true;
+    }
+    return QWidget::event(event);
+}
@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NETIF_QUEUE_VIEW_WIDGET_H
+#define NETIF_QUEUE_VIEW_WIDGET_H
+
+#include <QTimer>
+#include <QWidget>
+
+class NetifQueueModel;
+
+/**
+ * @brief Queue × cpu matrix of the interrupts of the selected interface
+ *
+ * One row per queue irq, one column per cpu, the more interrupts a cpu took for a queue the
+ * stronger its cell, so all rx queues landing on one core shows at a glance. Rows of queues
+ * whose busiest cpu is saturated are flagged. Sampled slowly & only while shown, hidden for
+ * interfaces without queue irqs, virtual ones & most wireless.
+ */
+class NetifQueueViewWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit NetifQueueViewWidget(QWidget *parent = nullptr);
+
+public slots:
+    void fontChanged(const QFont &font);
+    /**
+     * @brief Follow the interface of a link address, as the stat view emits it
+     */
+    void onNetifItemClicked(const QString &mac);
+
+protected:
+    bool event(QEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    void refreshQueues();
+    void updateHeight();
+    int rowHeight() const;
+    // matrix area right of the labels & below the title & cpu ids
+    QRect matrixRect() const;
+
+    NetifQueueModel *m_model;
+    QTimer m_timer;
+};
+
+#endif // NETIF_QUEUE_VIEW_WIDGET_H
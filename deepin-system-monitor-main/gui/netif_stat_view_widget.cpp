@@ -7,6 +7,7 @@
 #include "netif_item_view_widget.h"
 
 #include "system/device_db.h"
+#include "system/device_snapshot.h"
 #include "system/netif_info_db.h"
 #include "ddlog.h"
 
@@ -22,7 +23,7 @@ NetifStatViewWidget::NetifStatViewWidget(QWidget *parent) : DScrollArea(parent)
     this->setWidget(m_centralWidget);
     this->setFrameShape(QFrame::NoFrame);
 
-    m_info = DeviceDB::instance()->netifInfoDB();
+    m_snapshot = DeviceDB::instance()->snapshot();
 }
 
 void NetifStatViewWidget::resizeEvent(QResizeEvent *event)
@@ -44,7 +45,8 @@ void NetifStatViewWidget::fontChanged(const QFont &font)
 void NetifStatViewWidget::onModelUpdate()
 {
     qCDebug(app) << "NetifStatViewWidget onModelUpdate";
-    const QMap<QByteArray, NetifInfoPtr> &netifInfoDB = m_info->infoDB();
+    m_snapshot = DeviceDB::instance()->snapshot();
+    const QMap<QByteArray, NetifInfoPtr> &netifInfoDB = m_snapshot->netifInfo;
     for (auto iter = netifInfoDB.begin(); iter != netifInfoDB.end(); iter++) {
         const QByteArray &mac = iter.key();
         if (!m_mapItemView.contains(mac)) {
@@ -90,7 +92,7 @@ void NetifStatViewWidget::onModelUpdate()
 void NetifStatViewWidget::onSetItemActiveStatus(const QString &mac)
 {
     qCDebug(app) << "onSetItemActiveStatus for MAC:" << mac;
-    const QMap<QByteArray, NetifInfoPtr> &netifInfoDB = m_info->infoDB();
+    const QMap<QByteArray, NetifInfoPtr> &netifInfoDB = m_snapshot->netifInfo;
     int netCount  = netifInfoDB.size();
     m_currentMac = mac.toUtf8();
 
@@ -110,7 +112,7 @@ void NetifStatViewWidget::onSetItemActiveStatus(const QString &mac)
 void NetifStatViewWidget::updateWidgetGeometry()
 {
     qCDebug(app) << "updateWidgetGeometry";
-    const QMap<QByteArray, NetifInfoPtr> &netifInfoDB = m_info->infoDB();
+    const QMap<QByteArray, NetifInfoPtr> &netifInfoDB = m_snapshot->netifInfo;
     int netCount  = netifInfoDB.size();
 
     if (netCount == 1) {
@@ -128,7 +130,7 @@ void NetifStatViewWidget::updateWidgetGeometry()
 void NetifStatViewWidget::showItemOnlyeOne()
 {
     qCDebug(app) << "showItemOnlyeOne";
-    const QMap<QByteArray, NetifInfoPtr> &netifInfoDB = m_info->infoDB();
+    const QMap<QByteArray, NetifInfoPtr> &netifInfoDB = m_snapshot->netifInfo;
     for (auto iter = m_mapItemView.begin(); iter != m_mapItemView.end(); iter++) {
         NetifItemViewWidget *itemView = iter.value();
         if (netifInfoDB.contains(iter.key())) {
@@ -152,7 +154,7 @@ void NetifStatViewWidget::showItemDouble()
     int itemHeight  = this->height();
     int itemWidth   = (this->width() - itemSpace) / 2;
 
-    const QMap<QByteArray, NetifInfoPtr> &netifInfoDB = m_info->infoDB();
+    const QMap<QByteArray, NetifInfoPtr> &netifInfoDB = m_snapshot->netifInfo;
     for (auto iter = m_mapItemView.begin(); iter != m_mapItemView.end(); iter++) {
         NetifItemViewWidget *itemView = iter.value();
         if (netifInfoDB.contains(iter.key())) {
@@ -175,7 +177,7 @@ void NetifStatViewWidget::showItemDouble()
 void NetifStatViewWidget::showItemLgDouble()
 {
     qCDebug(app) << "showItemLgDouble";
-    const QMap<QByteArray, NetifInfoPtr> &netifInfoDB = m_info->infoDB();
+    const QMap<QByteArray, NetifInfoPtr> &netifInfoDB = m_snapshot->netifInfo;
 
     int itemHeight  = this->height() / 2;
     int itemWidth   = (this->width() - itemSpace) / 2;
@@ -9,6 +9,8 @@
 #include <DScrollArea>
 #include <QMap>
 
+#include <memory>
+
 class ChartViewWidget;
 class NetifInfoModel;
 class QGridLayout;
@@ -16,7 +18,7 @@ class NetifItemViewWidget;
 
 namespace core {
 namespace system {
-class NetifInfoDB;
+struct DeviceSnapshot;
 }
 }
 
@@ -46,7 +48,8 @@ public slots:
     void onSetItemActiveStatus(const QString &mac);
 
 private:
-    core::system::NetifInfoDB *m_info;
+    // device state of last model update
+    std::shared_ptr<const core::system::DeviceSnapshot> m_snapshot;
 
     bool m_initStatus = false;
     QWidget *m_centralWidget;
@@ -25,6 +25,7 @@
 
 #include "system/netif.h"
 #include "system/device_db.h"
+#include "system/device_snapshot.h"
 #include "common/common.h"
 #include "system/netif.h"
 #include "common/thread_manager.h"
@@ -248,7 +249,8 @@ public:
      */
     void refreshNetifInfo(const QString &strKey)
     {
-        const QMap<QByteArray, NetifInfoPtr> &mapInfo = DeviceDB::instance()->netifInfoDB()->infoDB();
+        // copy, the snapshot returned is released at the end of the statement
+        const QMap<QByteArray, NetifInfoPtr> mapInfo = DeviceDB::instance()->snapshot()->netifInfo;
 
         m_listInfo.clear();
 
@@ -310,12 +312,12 @@ public:
 
                 // 信号强度
                 stInfo.strKey = QApplication::translate("NetInfoModel", "Signal strength");
-                stInfo.strValue = QString("%1 dBm").arg(stNetifInfo->signalLevel());
+                stInfo.strValue = QString("%1 dBm").arg(static_cast<qint8>(stNetifInfo->signalLevel()));
                 m_listInfo << stInfo;
 
                 // 底噪
                 stInfo.strKey = QApplication::translate("NetInfoModel", "Noise level");
-                stInfo.strValue = QString("%1 dB").arg(stNetifInfo->noiseLevel());
+                stInfo.strValue = QString("%1 dB").arg(static_cast<qint8>(stNetifInfo->noiseLevel()));
                 m_listInfo << stInfo;
             }
 
@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "numa_view_widget.h"
+#include "cpu_irq_view_widget.h"
+#include "ddlog.h"
+#include "model/cpu_info_model.h"
+#include "model/numa_node_model.h"
+
+#include <QHBoxLayout>
+#include <QHeaderView>
+
+using namespace DDLog;
+
+// header & up to 4 nodes without scrolling
+#define NUMA_VIEW_HEIGHT 160
+
+NumaViewWidget::NumaViewWidget(Mode mode, QWidget *parent)
+    : QWidget(parent)
+{
+    qCDebug(app) << "NumaViewWidget constructor, mode:" << mode;
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+
+    m_model = new NumaNodeModel(CPUInfoModel::instance(), this);
+    m_table = new CPUIrqTable(this);
+    m_table->setModel(m_model);
+    if (mode == kCPUMode) {
+        m_table->setColumnHidden(NumaNodeModel::kNumaNodeMemoryColumn, true);
+    } else {
+        m_table->setColumnHidden(NumaNodeModel::kNumaNodeCPUsColumn, true);
+        m_table->setColumnHidden(NumaNodeModel::kNumaNodeCPUColumn, true);
+    }
+
+    auto *layout = new QHBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(m_table);
+
+    connect(m_model, &NumaNodeModel::modelReset, this, &NumaViewWidget::updateVisibility);
+    updateVisibility();
+}
+
+void NumaViewWidget::fontChanged(const QFont &font)
+{
+    m_table->setFont(font);
+    setFixedHeight(NUMA_VIEW_HEIGHT);
+}
+
+void NumaViewWidget::updateVisibility()
+{
+    setVisible(m_model->rowCount() > 0);
+}
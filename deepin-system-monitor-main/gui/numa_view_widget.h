@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NUMA_VIEW_WIDGET_H
+#define NUMA_VIEW_WIDGET_H
+
+#include <QWidget>
+
+class CPUIrqTable;
+class NumaNodeModel;
+
+/**
+ * @brief Numa nodes of the cpu or memory detail view, hidden on single node systems
+ */
+class NumaViewWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    enum Mode {
+        kCPUMode, // cpus & their usage per node
+        kMemoryMode // memory per node
+    };
+
+    explicit NumaViewWidget(Mode mode, QWidget *parent = nullptr);
+
+public slots:
+    void fontChanged(const QFont &font);
+
+private:
+    void updateVisibility();
+
+    CPUIrqTable *m_table;
+    NumaNodeModel *m_model;
+};
+
+#endif // NUMA_VIEW_WIDGET_H
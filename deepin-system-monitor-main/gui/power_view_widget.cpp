@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "power_view_widget.h"
+#include "chart_view_widget.h"
+#include "model/model_manager.h"
+#include "model/sample_history.h"
+#include "model/update_coordinator.h"
+#include "process/process_db.h"
+#include "process/process_set.h"
+#include "ddlog.h"
+
+#include <DFontSizeManager>
+
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+
+using namespace DDLog;
+using namespace core::process;
+
+#define POWER_VIEW_HEIGHT 100
+
+PowerViewWidget::PowerViewWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    qCDebug(app) << "PowerViewWidget constructor";
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    setFixedHeight(POWER_VIEW_HEIGHT);
+
+    SampleHistory *history = ModelManager::instance()->sampleHistory();
+    m_chart = new ChartViewWidget(ChartViewWidget::ChartViewTypes::POWER_CHART, this);
+    m_chart->setData1Color(QColor("#FF7B00"));
+    m_chart->setData2Color(QColor("#FEDF19"));
+    m_chart->setSeries1(&history->series(SampleHistory::kPackagePower));
+    m_chart->setSeries2(&history->series(SampleHistory::kCorePower));
+    m_chart->setStoredSeries1(SampleHistory::kPackagePower);
+    m_chart->setStoredSeries2(SampleHistory::kCorePower);
+    connect(history, &SampleHistory::updated, m_chart, &ChartViewWidget::updateSeries);
+
+    m_titleLabel = new DLabel(tr("Power"), this);
+    m_titleLabel->setForegroundRole(DPalette::TextTips);
+    m_titleLabel->setToolTip(tr("Power of the CPU packages & of their cores, from the RAPL energy "
+                                "counters. Processes are estimated a share of the package power by "
+                                "their CPU time, see the Power column"));
+    m_powerLabel = new DLabel(this);
+    m_topLabel = new DLabel(this);
+    m_topLabel->setForegroundRole(DPalette::TextTips);
+    DFontSizeManager::instance()->bind(m_titleLabel, DFontSizeManager::T8);
+    DFontSizeManager::instance()->bind(m_topLabel, DFontSizeManager::T8);
+
+    auto *textLayout = new QVBoxLayout();
+    textLayout->setContentsMargins(0, 0, 0, 0);
+    textLayout->addWidget(m_titleLabel);
+    textLayout->addWidget(m_powerLabel);
+    textLayout->addWidget(m_topLabel);
+    textLayout->addStretch();
+
+    auto *layout = new QHBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(16);
+    layout->addWidget(m_chart, 4);
+    layout->addLayout(textLayout, 2);
+
+    onModelUpdate();
+    connect(ModelManager::instance()->updateCoordinator(), &UpdateCoordinator::updateViews, this, &PowerViewWidget::onModelUpdate);
+}
+
+void PowerViewWidget::fontChanged(const QFont &font)
+{
+    qCDebug(app) << "PowerViewWidget fontChanged";
+    m_powerLabel->setFont(font);
+}
+
+void PowerViewWidget::onModelUpdate()
+{
+    const ProcessSnapshotPtr snapshot = ProcessDB::instance()->processSet()->snapshot();
+    // kept hidden until two reads of the counters are in
+    setVisible(snapshot->packagePower >= 0);
+    if (snapshot->packagePower < 0)
+        return;
+
+    if (snapshot->corePower >= 0)
+        m_powerLabel->setText(tr("Package %1 W, cores %2 W").arg(snapshot->packagePower, 0, 'f', 1).arg(snapshot->corePower, 0, 'f', 1));
+    else
+        m_powerLabel->setText(tr("Package %1 W").arg(snapshot->packagePower, 0, 'f', 1));
+
+    const Process *top = nullptr;
+    for (auto it = snapshot->processes.constBegin(); it != snapshot->processes.constEnd(); ++it) {
+        if (!top || it->power() > top->power())
+            top = &it.value();
+    }
+    if (top && top->power() > 0)
+        m_topLabel->setText(tr("Most: %1, about %2 W").arg(top->displayName()).arg(top->power(), 0, 'f', 1));
+    else
+        m_topLabel->clear();
+}
@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef POWER_VIEW_WIDGET_H
+#define POWER_VIEW_WIDGET_H
+
+#include <DLabel>
+
+#include <QWidget>
+
+DWIDGET_USE_NAMESPACE
+
+class ChartViewWidget;
+
+/**
+ * @brief Cpu power in the cpu detail view
+ *
+ * Chart of the package & core power read from the RAPL energy counters, next to the power of
+ * the last interval & the process drawing the most of it. Hidden on cpus without RAPL & while
+ * the counters can't be read.
+ */
+class PowerViewWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit PowerViewWidget(QWidget *parent = nullptr);
+
+public slots:
+    void fontChanged(const QFont &font);
+    void onModelUpdate();
+
+private:
+    ChartViewWidget *m_chart;
+    DLabel *m_titleLabel;
+    DLabel *m_powerLabel;
+    DLabel *m_topLabel;
+};
+
+#endif // POWER_VIEW_WIDGET_H
@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "pressure_view_widget.h"
+#include "chart_view_widget.h"
+#include "model/model_manager.h"
+#include "model/sample_history.h"
+#include "model/update_coordinator.h"
+#include "system/device_db.h"
+#include "system/device_snapshot.h"
+#include "ddlog.h"
+
+#include <DFontSizeManager>
+
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+
+using namespace DDLog;
+using namespace common::pressure;
+using namespace core::system;
+
+#define PRESSURE_VIEW_HEIGHT 100
+
+PressureViewWidget::PressureViewWidget(PressureResource resource, QWidget *parent)
+    : QWidget(parent)
+    , m_resource(resource)
+{
+    qCDebug(app) << "PressureViewWidget constructor, resource:" << resource;
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    setFixedHeight(PRESSURE_VIEW_HEIGHT);
+
+    static const SampleHistory::Metric kMetrics[] = {SampleHistory::kCpuPressure, SampleHistory::kMemoryPressure,
+                                                     SampleHistory::kIOPressure};
+    m_chartWidget = new ChartViewWidget(ChartViewWidget::ChartViewTypes::MEM_CHART, this);
+    m_chartWidget->setData1Color(QColor("#FF7B00"));
+    SampleHistory *history = ModelManager::instance()->sampleHistory();
+    m_chartWidget->setSeries1(&history->series(kMetrics[resource]));
+    m_chartWidget->setStoredSeries1(kMetrics[resource]);
+    connect(history, &SampleHistory::updated, m_chartWidget, &ChartViewWidget::updateSeries);
+
+    m_titleLabel = new DLabel(tr("Pressure stall"), this);
+    m_titleLabel->setForegroundRole(DPalette::TextTips);
+    m_titleLabel->setToolTip(tr("Share of time tasks waited on the resource, averaged over 10s / 60s. "
+                                "Some: at least one task stalled, full: all running tasks stalled at once"));
+    m_systemLabel = new DLabel(this);
+    m_sessionLabel = new DLabel(this);
+    m_sessionLabel->setForegroundRole(DPalette::TextTips);
+    DFontSizeManager::instance()->bind(m_titleLabel, DFontSizeManager::T8);
+    DFontSizeManager::instance()->bind(m_sessionLabel, DFontSizeManager::T8);
+
+    auto *textLayout = new QVBoxLayout();
+    textLayout->setContentsMargins(0, 0, 0, 0);
+    textLayout->addWidget(m_titleLabel);
+    textLayout->addWidget(m_systemLabel);
+    textLayout->addWidget(m_sessionLabel);
+    textLayout->addStretch();
+
+    auto *layout = new QHBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(16);
+    layout->addWidget(m_chartWidget, 3);
+    layout->addLayout(textLayout, 2);
+
+    onModelUpdate();
+    connect(ModelManager::instance()->updateCoordinator(), &UpdateCoordinator::updateViews, this, &PressureViewWidget::onModelUpdate);
+}
+
+QString PressureViewWidget::averagesText(const pressure_t &pressure)
+{
+    QString text = tr("Some %1% / %2%").arg(pressure.some.avg10, 0, 'f', 2).arg(pressure.some.avg60, 0, 'f', 2);
+    if (pressure.hasFull)
+        text += "  " + tr("Full %1% / %2%").arg(pressure.full.avg10, 0, 'f', 2).arg(pressure.full.avg60, 0, 'f', 2);
+    return text;
+}
+
+void PressureViewWidget::fontChanged(const QFont &font)
+{
+    qCDebug(app) << "PressureViewWidget fontChanged";
+    m_systemLabel->setFont(font);
+}
+
+void PressureViewWidget::onModelUpdate()
+{
+    DeviceSnapshotPtr snapshot = DeviceDB::instance()->snapshot();
+    const pressure_t &system = snapshot->pressure[m_resource];
+    const pressure_t &session = snapshot->sessionPressure[m_resource];
+    // kept hidden on kernels without psi, shown once the first sample is in
+    setVisible(system.valid);
+    if (!system.valid)
+        return;
+
+    m_systemLabel->setText(averagesText(system));
+    m_sessionLabel->setVisible(session.valid);
+    if (session.valid)
+        m_sessionLabel->setText(tr("Session: %1").arg(averagesText(session)));
+}
@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PRESSURE_VIEW_WIDGET_H
+#define PRESSURE_VIEW_WIDGET_H
+
+#include "common/pressure_stats.h"
+
+#include <DLabel>
+
+#include <QWidget>
+
+DWIDGET_USE_NAMESPACE
+
+class ChartViewWidget;
+
+/**
+ * @brief Pressure stall information of one resource in its detail view
+ *
+ * Chart of the share of time some tasks stalled on the resource, next to the kernel 10s & 60s
+ * averages of the system & of the user session. Hidden if the kernel doesn't report psi.
+ */
+class PressureViewWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit PressureViewWidget(common::pressure::PressureResource resource, QWidget *parent = nullptr);
+
+    /**
+     * @brief Averages as shown, e.g. "Some 0.12% / 0.50%  Full 0.00% / 0.00%"
+     */
+    static QString averagesText(const common::pressure::pressure_t &pressure);
+
+public slots:
+    void fontChanged(const QFont &font);
+    void onModelUpdate();
+
+private:
+    common::pressure::PressureResource m_resource;
+    ChartViewWidget *m_chartWidget;
+    DLabel *m_titleLabel;
+    DLabel *m_systemLabel;
+    DLabel *m_sessionLabel;
+};
+
+#endif // PRESSURE_VIEW_WIDGET_H
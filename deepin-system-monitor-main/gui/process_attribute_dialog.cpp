@@ -6,10 +6,28 @@
 #include "process_attribute_dialog.h"
 
 #include "settings.h"
+#include "chart_view_widget.h"
 #include "common/common.h"
 #include "ddlog.h"
+#include "base/base_table_view.h"
+#include "model/process_connection_model.h"
+#include "model/process_file_activity_model.h"
+#include "model/process_memleak_model.h"
+#include "model/process_memory_map_model.h"
+#include "model/numa_node_model.h"
+#include "model/process_thread_model.h"
+#include "process/focused_sampler.h"
+#include "process/numa_maps.h"
+#include "process/process_db.h"
+#include "process/process_scheduling.h"
+#include "process/process_set.h"
+#include "process_info_record.h"
+#include "system/cpu_set.h"
+#include "system/device_db.h"
+#include "system/device_snapshot.h"
 
 #include <DApplication>
+#include <DButtonBox>
 #include <DFontSizeManager>
 #include <DFrame>
 #include <DLabel>
@@ -27,11 +45,39 @@
 #include <QVBoxLayout>
 #include <QtMath>
 #include <QScrollBar>
+#include <QSet>
+#include <QStackedWidget>
+#include <QTimer>
+
+#include <errno.h>
+#include <string.h>
 
 // prefered text width
 static const int kPreferedTextWidth = 260;
 // default icon size
 static const int kAppIconSize = 80;
+// threads refresh interval (ms)
+static const int kThreadRefreshInterval = 2000;
+// connections refresh interval (ms)
+static const int kConnectionRefreshInterval = 2000;
+// files refresh interval (ms)
+static const int kFileActivityRefreshInterval = 2000;
+// memory page refresh interval (ms), same as process table
+static const int kMemoryRefreshInterval = 2000;
+// memory map batches pick up interval (ms) while it's read
+static const int kMapsRefreshInterval = 200;
+
+// attribute pages
+enum AttributePage {
+    kGeneralPage = 0,
+    kThreadsPage,
+    kConnectionsPage,
+    kFilesPage,
+    kMemoryPage,
+    kSchedulingPage,
+    kLivePage,
+    kMapsPage
+};
 
 // constructor
 ProcessAttributeDialog::ProcessAttributeDialog(pid_t pid,
@@ -47,6 +93,7 @@ ProcessAttributeDialog::ProcessAttributeDialog(pid_t pid,
     , m_cmdline(cmdline)
     , m_startTime(startTime)
     , m_icon(icon)
+    , m_targets({pid})
     , m_pid(pid)
 {
     qCDebug(app) << "ProcessAttributeDialog constructor for pid:" << pid;
@@ -98,8 +145,44 @@ void ProcessAttributeDialog::initUI()
     m_tbShadow->raise();
     m_tbShadow->show();
 
-    // frame layout
-    auto *vlayout = new QVBoxLayout(m_frame);
+    // frame layout, page switch on top of the pages
+    auto *flayout = new QVBoxLayout(m_frame);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    flayout->setMargin(0);
+#else
+    flayout->setContentsMargins(0, 0, 0, 0);
+#endif
+    flayout->setSpacing(0);
+
+    auto *pageBox = new DButtonBox(m_frame);
+    m_generalBtn = new DButtonBoxButton(DApplication::translate("Process.Attributes.Dialog", "General"), pageBox);
+    m_generalBtn->setCheckable(true);
+    m_threadsBtn = new DButtonBoxButton(DApplication::translate("Process.Attributes.Dialog", "Threads"), pageBox);
+    m_threadsBtn->setCheckable(true);
+    m_connectionsBtn = new DButtonBoxButton(DApplication::translate("Process.Attributes.Dialog", "Connections"), pageBox);
+    m_connectionsBtn->setCheckable(true);
+    m_filesBtn = new DButtonBoxButton(DApplication::translate("Process.Attributes.Dialog", "Files"), pageBox);
+    m_filesBtn->setCheckable(true);
+    m_memoryBtn = new DButtonBoxButton(DApplication::translate("Process.Attributes.Dialog", "Memory"), pageBox);
+    m_memoryBtn->setCheckable(true);
+    m_schedulingBtn = new DButtonBoxButton(DApplication::translate("Process.Attributes.Dialog", "Scheduling"), pageBox);
+    m_schedulingBtn->setCheckable(true);
+    m_liveBtn = new DButtonBoxButton(DApplication::translate("Process.Attributes.Dialog", "Live"), pageBox);
+    m_liveBtn->setCheckable(true);
+    m_mapsBtn = new DButtonBoxButton(DApplication::translate("Process.Attributes.Dialog", "Memory map"), pageBox);
+    m_mapsBtn->setCheckable(true);
+    pageBox->setButtonList({m_generalBtn, m_threadsBtn, m_connectionsBtn, m_filesBtn, m_memoryBtn, m_schedulingBtn, m_liveBtn,
+                            m_mapsBtn}, true);
+    m_generalBtn->setChecked(true);
+    flayout->addSpacing(m_margin);
+    flayout->addWidget(pageBox, 0, Qt::AlignCenter);
+
+    m_pages = new QStackedWidget(m_frame);
+    flayout->addWidget(m_pages, 1);
+
+    // general page
+    m_generalPage = new QWidget(m_pages);
+    auto *vlayout = new QVBoxLayout(m_generalPage);
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     vlayout->setMargin(m_margin);
 #else
@@ -121,7 +204,7 @@ void ProcessAttributeDialog::initUI()
     vlayout->addWidget(m_appNameLabel, 0, Qt::AlignCenter);
 
     // background frame
-    auto *wnd = new QWidget(m_frame);
+    auto *wnd = new QWidget(m_generalPage);
     wnd->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
     wnd->setAutoFillBackground(false);
     // content grid layout
@@ -212,10 +295,526 @@ void ProcessAttributeDialog::initUI()
         m_procCmdLabel->show();
     }
 
-    m_frame->setLayout(vlayout);
+    m_generalPage->setLayout(vlayout);
+    m_pages->addWidget(m_generalPage);
+
+    // threads page, threads are only sampled while it's shown
+    auto *threadPage = new QWidget(m_pages);
+    auto *tlayout = new QVBoxLayout(threadPage);
+    tlayout->setContentsMargins(m_margin, m_margin, m_margin, m_margin);
+    m_threadModel = new ProcessThreadModel(m_pid, this);
+    m_threadView = new BaseTableView(threadPage);
+    m_threadView->setModel(m_threadModel);
+    m_threadView->setSortingEnabled(false);
+    tlayout->addWidget(m_threadView);
+    m_pages->addWidget(threadPage);
+
+    // connections page, nothing is collected until it's shown
+    auto *connPage = new QWidget(m_pages);
+    auto *clayout = new QVBoxLayout(connPage);
+    clayout->setContentsMargins(m_margin, m_margin, m_margin, m_margin);
+    m_connectionModel = new ProcessConnectionModel(m_pid, this);
+    m_connectionView = new BaseTableView(connPage);
+    m_connectionView->setModel(m_connectionModel);
+    m_connectionView->setSortingEnabled(false);
+    clayout->addWidget(m_connectionView);
+    m_pages->addWidget(connPage);
+
+    // files page, file events are only traced while it's shown
+    auto *filePage = new QWidget(m_pages);
+    auto *filayout = new QVBoxLayout(filePage);
+    filayout->setContentsMargins(m_margin, m_margin, m_margin, m_margin);
+    m_fileActivityModel = new ProcessFileActivityModel(m_pid, this);
+    m_fileActivityView = new BaseTableView(filePage);
+    m_fileActivityView->setModel(m_fileActivityModel);
+    m_fileActivityView->setSortingEnabled(false);
+    m_fileActivityHint = new DLabel(DApplication::translate("Process.Attributes.Dialog",
+                                                            "File activity requires the DKapture system service"), filePage);
+    m_fileActivityHint->setAlignment(Qt::AlignCenter);
+    m_fileActivityHint->setWordWrap(true);
+    m_fileActivityHint->hide();
+    filayout->addWidget(m_fileActivityView);
+    filayout->addWidget(m_fileActivityHint);
+    m_pages->addWidget(filePage);
+
+    // memory page, kernel allocations are only scanned on request while it's shown
+    auto *memoryPage = new QWidget(m_pages);
+    auto *mlayout = new QVBoxLayout(memoryPage);
+    mlayout->setContentsMargins(m_margin, m_margin, m_margin, m_margin);
+    auto *mheader = new QHBoxLayout();
+    m_memoryGrowthLabel = new DLabel(memoryPage);
+    m_memleakBtn = new DPushButton(DApplication::translate("Process.Attributes.Dialog", "Investigate"), memoryPage);
+    mheader->addWidget(m_memoryGrowthLabel, 1);
+    mheader->addWidget(m_memleakBtn);
+    m_numaLabel = new DLabel(memoryPage);
+    m_numaLabel->setWordWrap(true);
+    m_numaLabel->hide();
+    m_memleakStatus = new DLabel(DApplication::translate("Process.Attributes.Dialog",
+                                                         "Scan kernel allocations of this process which are not freed"), memoryPage);
+    m_memleakStatus->setWordWrap(true);
+    m_memleakModel = new ProcessMemleakModel(m_pid, this);
+    m_memleakView = new BaseTableView(memoryPage);
+    m_memleakView->setModel(m_memleakModel);
+    m_memleakView->setSortingEnabled(false);
+    m_memleakHint = new DLabel(DApplication::translate("Process.Attributes.Dialog",
+                                                       "Memory leak scan requires the DKapture system service"), memoryPage);
+    m_memleakHint->setAlignment(Qt::AlignCenter);
+    m_memleakHint->setWordWrap(true);
+    m_memleakHint->hide();
+    mlayout->addLayout(mheader);
+    mlayout->addWidget(m_numaLabel);
+    mlayout->addWidget(m_memleakStatus);
+    mlayout->addWidget(m_memleakView, 1);
+    mlayout->addWidget(m_memleakHint, 1);
+    m_pages->addWidget(memoryPage);
+
+    // scheduling page, read when shown & after each apply
+    auto *schedulingPage = new QWidget(m_pages);
+    auto *slayout = new QVBoxLayout(schedulingPage);
+    slayout->setContentsMargins(m_margin, m_margin, m_margin, m_margin);
+    slayout->setSpacing(m_margin);
+    m_schedulingLabel = new DLabel(schedulingPage);
+    m_schedulingLabel->setWordWrap(true);
+    m_affinityEdit = new DLineEdit(schedulingPage);
+    m_affinityEdit->setPlaceholderText(DApplication::translate("Process.Attributes.Dialog", "CPUs, e.g. 0-3,8"));
+    m_ioClassBox = new DComboBox(schedulingPage);
+    m_ioClassBox->addItem(DApplication::translate("Process.Attributes.Dialog", "Default"), core::process::ProcessScheduling::kIOClassNone);
+    m_ioClassBox->addItem(DApplication::translate("Process.Attributes.Dialog", "Realtime"), core::process::ProcessScheduling::kIOClassRealtime);
+    m_ioClassBox->addItem(DApplication::translate("Process.Attributes.Dialog", "Best effort"), core::process::ProcessScheduling::kIOClassBestEffort);
+    m_ioClassBox->addItem(DApplication::translate("Process.Attributes.Dialog", "Idle"), core::process::ProcessScheduling::kIOClassIdle);
+    m_ioLevelBox = new DSpinBox(schedulingPage);
+    m_ioLevelBox->setRange(0, 7);
+    m_ioLevelBox->setToolTip(DApplication::translate("Process.Attributes.Dialog", "0 is the highest io priority of the class, 7 the lowest"));
+    auto *sform = new QGridLayout();
+    sform->setHorizontalSpacing(m_margin);
+    sform->addWidget(new DLabel(QString("%1:").arg(DApplication::translate("Process.Attributes.Dialog", "CPU affinity")), schedulingPage), 0, 0, Qt::AlignRight);
+    sform->addWidget(m_affinityEdit, 0, 1, 1, 2);
+    sform->addWidget(new DLabel(QString("%1:").arg(DApplication::translate("Process.Attributes.Dialog", "IO priority")), schedulingPage), 1, 0, Qt::AlignRight);
+    sform->addWidget(m_ioClassBox, 1, 1);
+    sform->addWidget(m_ioLevelBox, 1, 2);
+    sform->setColumnStretch(1, 1);
+    m_subtreeCheck = new DCheckBox(DApplication::translate("Process.Attributes.Dialog", "Apply to child processes too"), schedulingPage);
+    m_applyBtn = new DPushButton(DApplication::translate("Process.Attributes.Dialog", "Apply"), schedulingPage);
+    auto *sfooter = new QHBoxLayout();
+    sfooter->addWidget(m_subtreeCheck, 1);
+    sfooter->addWidget(m_applyBtn);
+    m_schedulingStatus = new DLabel(schedulingPage);
+    m_schedulingStatus->setWordWrap(true);
+    slayout->addWidget(m_schedulingLabel);
+    slayout->addLayout(sform);
+    slayout->addLayout(sfooter);
+    slayout->addWidget(m_schedulingStatus);
+    slayout->addStretch(1);
+    m_pages->addWidget(schedulingPage);
+
+    // live page, the process alone is sampled at a high rate while it's shown, the global scan keeps its pace
+    auto *livePage = new QWidget(m_pages);
+    auto *lvlayout = new QVBoxLayout(livePage);
+    lvlayout->setContentsMargins(m_margin, m_margin, m_margin, m_margin);
+    lvlayout->setSpacing(m_margin);
+    m_sampler = new core::process::FocusedSampler(m_pid, this);
+    m_intervalBox = new DComboBox(livePage);
+    for (int interval : {core::process::FocusedSampler::kInterval100ms, core::process::FocusedSampler::kInterval250ms,
+                         core::process::FocusedSampler::kInterval500ms})
+        m_intervalBox->addItem(DApplication::translate("Process.Attributes.Dialog", "Every %1 ms").arg(interval), interval);
+    m_intervalBox->setCurrentIndex(m_intervalBox->findData(core::process::FocusedSampler::kInterval250ms));
+    auto *lheader = new QHBoxLayout();
+    lheader->addStretch(1);
+    lheader->addWidget(new DLabel(QString("%1:").arg(DApplication::translate("Process.Attributes.Dialog", "Sample")), livePage));
+    lheader->addWidget(m_intervalBox);
+    lvlayout->addLayout(lheader);
+    m_cpuChart = new ChartViewWidget(ChartViewWidget::ChartViewTypes::MEM_CHART, livePage);
+    m_cpuChart->setData2Color(QColor("#FF7B00"));
+    m_cpuChart->setSeries1(&m_sampler->cpuSeries());
+    m_cpuChart->setSeries2(&m_sampler->waitSeries());
+    m_memoryChart = new ChartViewWidget(ChartViewWidget::ChartViewTypes::MEM_CHART, livePage);
+    m_memoryChart->setSeries1(&m_sampler->memorySeries());
+    m_ioChart = new ChartViewWidget(ChartViewWidget::ChartViewTypes::MEM_CHART, livePage);
+    m_ioChart->setSpeedAxis(true);
+    m_ioChart->setData1Color(QColor("#8F88FF"));
+    m_ioChart->setData2Color(QColor("#6AD787"));
+    m_ioChart->setSeries1(&m_sampler->readSeries());
+    m_ioChart->setSeries2(&m_sampler->writeSeries());
+    m_cpuLiveLabel = new DLabel(livePage);
+    m_memoryLiveLabel = new DLabel(livePage);
+    m_ioLiveLabel = new DLabel(livePage);
+    for (DLabel *label : {m_cpuLiveLabel, m_memoryLiveLabel, m_ioLiveLabel})
+        DFontSizeManager::instance()->bind(label, DFontSizeManager::T8);
+    const QList<QPair<DLabel *, ChartViewWidget *>> charts {{m_cpuLiveLabel, m_cpuChart}, {m_memoryLiveLabel, m_memoryChart},
+                                                             {m_ioLiveLabel, m_ioChart}};
+    for (const auto &chart : charts) {
+        lvlayout->addWidget(chart.first);
+        lvlayout->addWidget(chart.second, 1);
+    }
+    m_pages->addWidget(livePage);
+
+    // memory map page, maps is streamed in the background when shown, smaps on request
+    auto *mapsPage = new QWidget(m_pages);
+    auto *maplayout = new QVBoxLayout(mapsPage);
+    maplayout->setContentsMargins(m_margin, m_margin, m_margin, m_margin);
+    auto *mapheader = new QHBoxLayout();
+    m_mapsStatus = new DLabel(mapsPage);
+    m_mapsStatus->setWordWrap(true);
+    m_mapsDetailBtn = new DPushButton(DApplication::translate("Process.Attributes.Dialog", "Read RSS & PSS"), mapsPage);
+    m_mapsDetailBtn->setToolTip(DApplication::translate("Process.Attributes.Dialog", "Walks the page tables of every mapping, "
+                                                        "slow for processes with many mappings"));
+    mapheader->addWidget(m_mapsStatus, 1);
+    mapheader->addWidget(m_mapsDetailBtn);
+    m_mapsModel = new ProcessMemoryMapModel(m_pid, this);
+    m_mapsView = new BaseTableView(mapsPage);
+    m_mapsView->setModel(m_mapsModel);
+    m_mapsView->setSortingEnabled(false);
+    maplayout->addLayout(mapheader);
+    maplayout->addWidget(m_mapsView, 1);
+    m_pages->addWidget(mapsPage);
+
+    m_threadTimer = new QTimer(this);
+    m_threadTimer->setInterval(kThreadRefreshInterval);
+    connect(m_threadTimer, &QTimer::timeout, m_threadModel, &ProcessThreadModel::refresh);
+    m_connectionTimer = new QTimer(this);
+    m_connectionTimer->setInterval(kConnectionRefreshInterval);
+    connect(m_connectionTimer, &QTimer::timeout, m_connectionModel, &ProcessConnectionModel::refresh);
+    m_fileActivityTimer = new QTimer(this);
+    m_fileActivityTimer->setInterval(kFileActivityRefreshInterval);
+    connect(m_fileActivityTimer, &QTimer::timeout, m_fileActivityModel, &ProcessFileActivityModel::refresh);
+    m_memoryTimer = new QTimer(this);
+    m_memoryTimer->setInterval(kMemoryRefreshInterval);
+    connect(m_memoryTimer, &QTimer::timeout, this, &ProcessAttributeDialog::updateMemoryPage);
+    m_mapsTimer = new QTimer(this);
+    m_mapsTimer->setInterval(kMapsRefreshInterval);
+    connect(m_mapsTimer, &QTimer::timeout, m_mapsModel, &ProcessMemoryMapModel::refresh);
+    connect(m_mapsModel, &ProcessMemoryMapModel::progressed, this, &ProcessAttributeDialog::updateMapsPage);
+    connect(m_mapsDetailBtn, &DPushButton::clicked, this, [ = ]() {
+        if (m_mapsModel->state() == ProcessMemoryMapModel::kScanRunning) {
+            m_mapsModel->cancel();
+        } else {
+            m_mapsModel->start(true);
+            m_mapsTimer->start();
+        }
+    });
+    connect(m_memleakBtn, &DPushButton::clicked, this, [ = ]() {
+        if (m_memleakModel->state() == ProcessMemleakModel::kScanRunning)
+            m_memleakModel->cancel();
+        else
+            m_memleakModel->start();
+        updateMemoryPage();
+    });
+    connect(m_memleakModel, &ProcessMemleakModel::stateChanged, this, &ProcessAttributeDialog::updateMemoryPage);
+    connect(m_ioClassBox, QOverload<int>::of(&DComboBox::currentIndexChanged), this, [ = ]() {
+        // none & idle have no level
+        const int ioClass = m_ioClassBox->currentData().toInt();
+        m_ioLevelBox->setEnabled(ioClass == core::process::ProcessScheduling::kIOClassRealtime
+                                 || ioClass == core::process::ProcessScheduling::kIOClassBestEffort);
+    });
+    connect(m_applyBtn, &DPushButton::clicked, this, &ProcessAttributeDialog::applyScheduling);
+    connect(m_sampler, &core::process::FocusedSampler::sampled, this, &ProcessAttributeDialog::updateLivePage);
+    connect(m_sampler, &core::process::FocusedSampler::exited, this, &ProcessAttributeDialog::updateLivePage);
+    connect(m_intervalBox, QOverload<int>::of(&DComboBox::currentIndexChanged), this, [ = ]() {
+        if (m_pages->currentIndex() == kLivePage)
+            m_sampler->start(m_intervalBox->currentData().toInt());
+    });
+    connect(ProcessDB::instance(), &ProcessDB::processesControlled, this,
+            [ = ](const QList<pid_t> &pids, int action, int, const QList<int> &errors) {
+        if ((action != PROCESS_CONTROL_AFFINITY && action != PROCESS_CONTROL_IONICE) || !m_pendingBatches.removeOne(pids))
+            return;
+        for (int error : errors) {
+            if (error)
+                ++m_schedulingFailures;
+        }
+        if (!m_pendingBatches.isEmpty())
+            return;
+
+        m_applyBtn->setEnabled(true);
+        if (m_schedulingFailures)
+            m_schedulingStatus->setText(DApplication::translate("Process.Attributes.Dialog", "Failed to apply %1 of %2 changes, "
+                                                                "other users' processes need the system service")
+                                        .arg(m_schedulingFailures).arg(pids.size() * 2));
+        else
+            m_schedulingStatus->setText(DApplication::translate("Process.Attributes.Dialog", "Applied to %n process(es)", "", pids.size()));
+        updateSchedulingPage();
+    });
+    connect(m_generalBtn, &DButtonBoxButton::toggled, this, [ = ](bool checked) {
+        if (checked)
+            showPage(kGeneralPage);
+    });
+    connect(m_threadsBtn, &DButtonBoxButton::toggled, this, [ = ](bool checked) {
+        if (checked)
+            showPage(kThreadsPage);
+    });
+    connect(m_connectionsBtn, &DButtonBoxButton::toggled, this, [ = ](bool checked) {
+        if (checked)
+            showPage(kConnectionsPage);
+    });
+    connect(m_filesBtn, &DButtonBoxButton::toggled, this, [ = ](bool checked) {
+        if (checked)
+            showPage(kFilesPage);
+    });
+    connect(m_memoryBtn, &DButtonBoxButton::toggled, this, [ = ](bool checked) {
+        if (checked)
+            showPage(kMemoryPage);
+    });
+    connect(m_schedulingBtn, &DButtonBoxButton::toggled, this, [ = ](bool checked) {
+        if (checked)
+            showPage(kSchedulingPage);
+    });
+    connect(m_liveBtn, &DButtonBoxButton::toggled, this, [ = ](bool checked) {
+        if (checked)
+            showPage(kLivePage);
+    });
+    connect(m_mapsBtn, &DButtonBoxButton::toggled, this, [ = ](bool checked) {
+        if (checked)
+            showPage(kMapsPage);
+    });
+
     setCentralWidget(m_frame);
 }
 
+void ProcessAttributeDialog::showPage(int index)
+{
+    qCDebug(app) << "ProcessAttributeDialog showPage:" << index;
+    if (index != kThreadsPage) {
+        m_threadTimer->stop();
+        m_threadModel->stop();
+    }
+    if (index != kConnectionsPage) {
+        m_connectionTimer->stop();
+        m_connectionModel->stop();
+    }
+    if (index != kFilesPage) {
+        m_fileActivityTimer->stop();
+        m_fileActivityModel->stop();
+    }
+    if (index != kMemoryPage) {
+        m_memoryTimer->stop();
+        m_memleakModel->cancel();
+    }
+    if (index != kLivePage)
+        m_sampler->stop();
+    if (index != kMapsPage) {
+        m_mapsTimer->stop();
+        m_mapsModel->cancel();
+    }
+
+    m_pages->setCurrentIndex(index);
+    if (index == kThreadsPage) {
+        m_threadModel->refresh();
+        m_threadTimer->start();
+    } else if (index == kConnectionsPage) {
+        m_connectionModel->refresh();
+        m_connectionTimer->start();
+    } else if (index == kFilesPage) {
+        m_fileActivityModel->refresh();
+        const bool available = m_fileActivityModel->isAvailable();
+        m_fileActivityView->setVisible(available);
+        m_fileActivityHint->setVisible(!available);
+        if (available)
+            m_fileActivityTimer->start();
+    } else if (index == kMemoryPage) {
+        updateMemoryPage();
+        m_memoryTimer->start();
+    } else if (index == kSchedulingPage) {
+        updateSchedulingPage();
+    } else if (index == kLivePage) {
+        m_sampler->start(m_intervalBox->currentData().toInt());
+        updateLivePage();
+    } else if (index == kMapsPage) {
+        // smaps is only read again on request
+        m_mapsModel->start(false);
+        m_mapsTimer->start();
+    }
+}
+
+void ProcessAttributeDialog::setTargets(const QList<pid_t> &pids)
+{
+    m_targets = pids.isEmpty() ? QList<pid_t> {m_pid} : pids;
+    if (m_targets.size() > 1)
+        m_schedulingStatus->setText(DApplication::translate("Process.Attributes.Dialog", "Changes apply to the %1 selected processes")
+                                    .arg(m_targets.size()));
+}
+
+void ProcessAttributeDialog::updateSchedulingPage()
+{
+    using core::process::ProcessScheduling;
+    ProcessScheduling::scheduling_t sched;
+    if (!ProcessScheduling::read(m_pid, sched)) {
+        m_schedulingLabel->setText(DApplication::translate("Process.Attributes.Dialog", "The process has exited"));
+        m_applyBtn->setEnabled(false);
+        return;
+    }
+
+    QStringList lines;
+    lines << DApplication::translate("Process.Attributes.Dialog", "Runs on CPUs %1").arg(NumaNodeModel::cpuListText(sched.affinity));
+    if (!sched.cpusetCpus.isEmpty()) {
+        const QString cgroup = sched.cpuset.isEmpty() ? QStringLiteral("/") : sched.cpuset;
+        lines << DApplication::translate("Process.Attributes.Dialog", "Cpuset %1 allows CPUs %2, affinity is limited to them")
+                         .arg(cgroup).arg(NumaNodeModel::cpuListText(sched.cpusetCpus));
+    }
+    m_schedulingLabel->setText(lines.join('\n'));
+
+    m_affinityEdit->setText(NumaNodeModel::cpuListText(sched.affinity));
+    const int index = m_ioClassBox->findData(sched.ioClass);
+    m_ioClassBox->setCurrentIndex(index >= 0 ? index : 0);
+    m_ioLevelBox->setValue(sched.ioLevel);
+    m_applyBtn->setEnabled(m_pendingBatches.isEmpty());
+}
+
+void ProcessAttributeDialog::applyScheduling()
+{
+    using core::process::ProcessScheduling;
+    const QVector<int> cpus = ProcessScheduling::parseCpuList(m_affinityEdit->text());
+    if (cpus.isEmpty()) {
+        m_schedulingStatus->setText(DApplication::translate("Process.Attributes.Dialog", "Invalid CPU list, e.g. 0-3,8"));
+        return;
+    }
+
+    // each process once, parents before their children
+    QList<pid_t> pids;
+    QSet<pid_t> seen;
+    for (pid_t target : m_targets) {
+        const QList<pid_t> tree = m_subtreeCheck->isChecked() ? ProcessDB::instance()->processSet()->getProcessTree(target)
+                                                               : QList<pid_t> {target};
+        for (pid_t pid : tree) {
+            if (!seen.contains(pid) && !ProcessDB::isCurrentProcess(pid)) {
+                seen.insert(pid);
+                pids << pid;
+            }
+        }
+    }
+    if (pids.isEmpty())
+        return;
+
+    // one batch each, processes of other users go through one authorized call of the system service
+    m_pendingBatches = {pids, pids};
+    m_schedulingFailures = 0;
+    m_applyBtn->setEnabled(false);
+    m_schedulingStatus->setText(DApplication::translate("Process.Attributes.Dialog", "Applying to %n process(es)", "", pids.size()));
+    const int ioprio = ProcessScheduling::ioPriority(m_ioClassBox->currentData().toInt(), m_ioLevelBox->value());
+    ProcessDB::instance()->setProcessesAffinity(pids, ProcessScheduling::cpuMask(cpus));
+    ProcessDB::instance()->controlProcesses(pids, PROCESS_CONTROL_IONICE, ioprio);
+}
+
+void ProcessAttributeDialog::updateLivePage()
+{
+    using common::format::formatUnit_memory_disk;
+    m_cpuChart->updateSeries();
+    m_memoryChart->updateSeries();
+    m_ioChart->updateSeries();
+
+    if (m_sampler->hasExited()) {
+        m_cpuLiveLabel->setText(DApplication::translate("Process.Attributes.Dialog", "The process has exited"));
+        m_memoryLiveLabel->clear();
+        m_ioLiveLabel->clear();
+        m_intervalBox->setEnabled(false);
+        return;
+    }
+
+    const auto &cpu = m_sampler->cpuSeries();
+    m_cpuLiveLabel->setText(DApplication::translate("Process.Attributes.Dialog", "CPU %1%, waiting for a CPU %2%")
+                            .arg(cpu.empty() ? 0. : cpu.last(), 0, 'f', 1)
+                            .arg(m_sampler->waitSeries().empty() ? 0. : m_sampler->waitSeries().last(), 0, 'f', 1));
+    m_memoryLiveLabel->setText(DApplication::translate("Process.Attributes.Dialog", "Resident memory %1")
+                               .arg(formatUnit_memory_disk(m_sampler->residentBytes(), common::format::B)));
+    if (!m_sampler->hasIO()) {
+        m_ioLiveLabel->setText(DApplication::translate("Process.Attributes.Dialog", "Disk IO of other users' processes is not readable"));
+        return;
+    }
+    const auto &read = m_sampler->readSeries();
+    const auto &write = m_sampler->writeSeries();
+    m_ioLiveLabel->setText(DApplication::translate("Process.Attributes.Dialog", "Disk read %1, write %2")
+                           .arg(formatUnit_memory_disk(read.empty() ? 0. : read.last(), common::format::B, 1, true))
+                           .arg(formatUnit_memory_disk(write.empty() ? 0. : write.last(), common::format::B, 1, true)));
+}
+
+void ProcessAttributeDialog::updateMapsPage()
+{
+    using common::format::formatUnit_memory_disk;
+    const bool running = m_mapsModel->state() == ProcessMemoryMapModel::kScanRunning;
+    if (!running)
+        m_mapsTimer->stop();
+    m_mapsDetailBtn->setText(running ? DApplication::translate("Process.Attributes.Dialog", "Stop")
+                                     : DApplication::translate("Process.Attributes.Dialog", "Read RSS & PSS"));
+
+    if (m_mapsModel->state() == ProcessMemoryMapModel::kScanFailed) {
+        m_mapsStatus->setText(m_mapsModel->error() == EACCES
+                              ? DApplication::translate("Process.Attributes.Dialog", "The memory map of other users' processes is not readable")
+                              : DApplication::translate("Process.Attributes.Dialog", "Failed to read the memory map: %1")
+                              .arg(QString::fromLocal8Bit(strerror(m_mapsModel->error()))));
+        return;
+    }
+
+    QString text = DApplication::translate("Process.Attributes.Dialog", "%n mapping(s), %1 virtual", "", m_mapsModel->mappings())
+                           .arg(formatUnit_memory_disk(m_mapsModel->totalSize(), common::format::KB));
+    if (m_mapsModel->isDetailed())
+        text += ", " + DApplication::translate("Process.Attributes.Dialog", "RSS %1, PSS %2")
+                               .arg(formatUnit_memory_disk(m_mapsModel->totalRss(), common::format::KB))
+                               .arg(formatUnit_memory_disk(m_mapsModel->totalPss(), common::format::KB));
+    if (running)
+        text += ", " + DApplication::translate("Process.Attributes.Dialog", "reading...");
+    m_mapsStatus->setText(text);
+}
+
+void ProcessAttributeDialog::updateMemoryPage()
+{
+    // growth between the last two process table scans
+    const Process proc = ProcessDB::instance()->processSet()->getProcessById(m_pid);
+    if (proc.isValid()) {
+        qreal growth = proc.memoryGrowth();
+        QString speed = common::format::formatUnit_memory_disk(qAbs(growth), common::format::KB, 1, true);
+        if (growth > 0)
+            speed.prepend('+');
+        else if (growth < 0)
+            speed.prepend('-');
+        m_memoryGrowthLabel->setText(DApplication::translate("Process.Attributes.Dialog", "Memory %1, growing %2")
+                                     .arg(common::format::formatUnit_memory_disk(proc.memory(), common::format::KB))
+                                     .arg(speed));
+    }
+
+    // numa_maps walks the page tables, only read while the page is shown on numa systems
+    QMap<int, qulonglong> nodes;
+    const bool numa = core::system::DeviceDB::instance()->snapshot()->cpuSet.numaNodes().size() > 1;
+    if (numa && core::process::NumaMaps::read(m_pid, nodes)) {
+        QStringList placement;
+        for (auto it = nodes.cbegin(); it != nodes.cend(); ++it)
+            placement << QString("Node%1 %2").arg(it.key())
+                                              .arg(common::format::formatUnit_memory_disk(it.value(), common::format::KB, 1));
+        m_numaLabel->setText(DApplication::translate("Process.Attributes.Dialog", "Resident on numa nodes: %1")
+                             .arg(placement.join(", ")));
+        m_numaLabel->show();
+    } else {
+        m_numaLabel->hide();
+    }
+
+    if (m_memleakModel->state() == ProcessMemleakModel::kScanRunning)
+        m_memleakModel->refresh();
+
+    const bool available = m_memleakModel->isAvailable();
+    m_memleakView->setVisible(available);
+    m_memleakHint->setVisible(!available);
+    m_memleakBtn->setEnabled(available);
+
+    const QString &leaked = common::format::formatUnit_memory_disk(m_memleakModel->leakedBytes(), common::format::B);
+    switch (m_memleakModel->state()) {
+    case ProcessMemleakModel::kScanRunning:
+        m_memleakBtn->setText(DApplication::translate("Process.Attributes.Dialog", "Stop"));
+        m_memleakStatus->setText(DApplication::translate("Process.Attributes.Dialog", "Scanning, %1 not freed after %2 windows")
+                                 .arg(leaked).arg(m_memleakModel->windows()));
+        break;
+    case ProcessMemleakModel::kScanFinished:
+    case ProcessMemleakModel::kScanCancelled:
+        m_memleakBtn->setText(DApplication::translate("Process.Attributes.Dialog", "Investigate"));
+        m_memleakStatus->setText(DApplication::translate("Process.Attributes.Dialog", "Scan ended, %1 not freed after %2 windows")
+                                 .arg(leaked).arg(m_memleakModel->windows()));
+        break;
+    case ProcessMemleakModel::kScanFailed:
+        m_memleakBtn->setText(DApplication::translate("Process.Attributes.Dialog", "Investigate"));
+        m_memleakStatus->setText(DApplication::translate("Process.Attributes.Dialog", "Scan failed, another scan may be running"));
+        break;
+    default:
+        m_memleakBtn->setText(DApplication::translate("Process.Attributes.Dialog", "Investigate"));
+        break;
+    }
+}
+
 // resize event handler
 void ProcessAttributeDialog::resizeEvent(QResizeEvent *event)
 {
@@ -250,7 +849,7 @@ void ProcessAttributeDialog::resizeItemWidget()
     m_procNameText->setFixedSize(qMin(kPreferedTextWidth, m_procNameText->fontMetrics().size(Qt::TextSingleLine, m_procNameText->toPlainText()).width()), procNametextH);
     m_procStartText->setFixedSize(qMin(kPreferedTextWidth, m_procStartText->fontMetrics().size(Qt::TextSingleLine, m_procStartText->toPlainText()).width()), m_procStartLabel->fontMetrics().height());
 
-    m_cmdh = m_frame->height() - (kAppIconSize + m_appNameLabel->height() + m_margin * 4) - m_procNameText->height() - m_procStartText->height();
+    m_cmdh = m_generalPage->height() - (kAppIconSize + m_appNameLabel->height() + m_margin * 4) - m_procNameText->height() - m_procStartText->height();
     if (m_cmdh > m_procCmdText->document()->size().height()) {
         m_cmdh = int(m_procCmdText->document()->size().height());
     }
@@ -263,6 +862,18 @@ void ProcessAttributeDialog::closeEvent(QCloseEvent *event)
 {
     qCDebug(app) << "ProcessAttributeDialog closeEvent";
     Q_UNUSED(event);
+    // stop sampling threads & the process, watching sockets, tracing files & reading maps as soon as dialog goes away
+    m_threadTimer->stop();
+    m_threadModel->stop();
+    m_connectionTimer->stop();
+    m_connectionModel->stop();
+    m_fileActivityTimer->stop();
+    m_fileActivityModel->stop();
+    m_memoryTimer->stop();
+    m_memleakModel->cancel();
+    m_sampler->stop();
+    m_mapsTimer->stop();
+    m_mapsModel->cancel();
     DMainWindow::closeEvent(event);
     m_settings->setOption(kSettingKeyProcessAttributeDialogWidth, width());
     m_settings->setOption(kSettingKeyProcessAttributeDialogHeight, height());
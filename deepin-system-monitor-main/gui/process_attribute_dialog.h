@@ -6,20 +6,41 @@
 #ifndef PROCESS_ATTRIBUTE_DIALOG_H
 #define PROCESS_ATTRIBUTE_DIALOG_H
 
+#include <DButtonBox>
+#include <DCheckBox>
+#include <DComboBox>
 #include <DFrame>
 #include <DLabel>
+#include <DLineEdit>
 #include <DMainWindow>
+#include <DPushButton>
 #include <DShadowLine>
+#include <DSpinBox>
 #include <DTextBrowser>
 #include <DWidget>
 
 DWIDGET_USE_NAMESPACE
 
 class Settings;
+class BaseTableView;
+class ChartViewWidget;
+class ProcessConnectionModel;
+class ProcessFileActivityModel;
+class ProcessMemoryMapModel;
+class ProcessMemleakModel;
+class ProcessThreadModel;
+class QStackedWidget;
+class QTimer;
 class QHBoxLayout;
 class QVBoxLayout;
 class QGridLayout;
 
+namespace core {
+namespace process {
+class FocusedSampler;
+}
+}
+
 /**
  * @brief Dialog shown to user when process attribute requested by user
  */
@@ -46,12 +67,41 @@ public:
                                     time_t startTime,
                                     QWidget *parent = nullptr);
 
+    /**
+     * @brief Processes the scheduling page applies to, e.g. the selected rows, the process alone by default
+     */
+    void setTargets(const QList<pid_t> &pids);
+
 private:
     /**
      * @brief Initialize ui components
      */
     void initUI();
     void resizeItemWidget();
+    /**
+     * @brief Switch between the general page & the others, all but general are only refreshed while shown
+     */
+    void showPage(int index);
+    /**
+     * @brief Update memory growth & leak scan progress of the memory page
+     */
+    void updateMemoryPage();
+    /**
+     * @brief Show the affinity, cpuset & io priority of the process
+     */
+    void updateSchedulingPage();
+    /**
+     * @brief Apply the affinity & io priority edited to the targets, with their descendants if asked
+     */
+    void applyScheduling();
+    /**
+     * @brief Show the last samples of the focused sampler
+     */
+    void updateLivePage();
+    /**
+     * @brief Show the progress & totals of the memory map scan
+     */
+    void updateMapsPage();
 
 protected:
     /**
@@ -92,6 +142,87 @@ private:
     // Shadow widget under titlebar
     DShadowLine *m_tbShadow {};
 
+    // Page switch buttons
+    DButtonBoxButton *m_generalBtn {};
+    DButtonBoxButton *m_threadsBtn {};
+    DButtonBoxButton *m_connectionsBtn {};
+    DButtonBoxButton *m_filesBtn {};
+    DButtonBoxButton *m_memoryBtn {};
+    DButtonBoxButton *m_schedulingBtn {};
+    DButtonBoxButton *m_liveBtn {};
+    DButtonBoxButton *m_mapsBtn {};
+    // General, threads, connections, files, memory, scheduling, live & memory map pages
+    QStackedWidget *m_pages {};
+    QWidget *m_generalPage {};
+    // Threads of the process
+    BaseTableView *m_threadView {};
+    ProcessThreadModel *m_threadModel {};
+    // Threads refresh timer
+    QTimer *m_threadTimer {};
+    // Connections of the process
+    BaseTableView *m_connectionView {};
+    ProcessConnectionModel *m_connectionModel {};
+    // Connections refresh timer
+    QTimer *m_connectionTimer {};
+    // Busiest files of the process
+    BaseTableView *m_fileActivityView {};
+    ProcessFileActivityModel *m_fileActivityModel {};
+    // Shown instead of files when file events can not be traced
+    DLabel *m_fileActivityHint {};
+    // Files refresh timer
+    QTimer *m_fileActivityTimer {};
+    // Memory growth of the process
+    DLabel *m_memoryGrowthLabel {};
+    // Resident memory of the process on each numa node
+    DLabel *m_numaLabel {};
+    // Leak scan progress
+    DLabel *m_memleakStatus {};
+    // Start or cancel a leak scan
+    DPushButton *m_memleakBtn {};
+    // Kernel allocations not freed by the process
+    BaseTableView *m_memleakView {};
+    ProcessMemleakModel *m_memleakModel {};
+    // Shown instead of leak sites when kmemleak can not be used
+    DLabel *m_memleakHint {};
+    // Memory page refresh timer
+    QTimer *m_memoryTimer {};
+    // Affinity, cpuset & io priority now
+    DLabel *m_schedulingLabel {};
+    // Cpu list to run on, e.g. 0-3,8
+    DLineEdit *m_affinityEdit {};
+    // Io priority class & level
+    DComboBox *m_ioClassBox {};
+    DSpinBox *m_ioLevelBox {};
+    // Apply to the descendants of the targets too
+    DCheckBox *m_subtreeCheck {};
+    DPushButton *m_applyBtn {};
+    // Progress & failures of the last apply
+    DLabel *m_schedulingStatus {};
+    // Processes applied to, the batches of the last apply running
+    QList<pid_t> m_targets;
+    QList<QList<pid_t>> m_pendingBatches;
+    int m_schedulingFailures {0};
+    // Samples the process alone at a high rate while the live page is shown
+    core::process::FocusedSampler *m_sampler {};
+    // Sample interval
+    DComboBox *m_intervalBox {};
+    // Cpu & run queue wait, resident memory, disk read & write
+    ChartViewWidget *m_cpuChart {};
+    ChartViewWidget *m_memoryChart {};
+    ChartViewWidget *m_ioChart {};
+    DLabel *m_cpuLiveLabel {};
+    DLabel *m_memoryLiveLabel {};
+    DLabel *m_ioLiveLabel {};
+    // Regions of the memory map by backing file & type
+    BaseTableView *m_mapsView {};
+    ProcessMemoryMapModel *m_mapsModel {};
+    // Scan progress & totals
+    DLabel *m_mapsStatus {};
+    // Read smaps for the rss & pss, or stop the scan
+    DPushButton *m_mapsDetailBtn {};
+    // Picks up the batches of the running scan
+    QTimer *m_mapsTimer {};
+
     // Process display name label
     DLabel *m_appNameLabel {};
     // Process name label
@@ -7,22 +7,37 @@
 
 #include <unistd.h>
 #include <climits>
+#include <signal.h>
+#include <string.h>
+#include <functional>
 
 #include "application.h"
 #include "main_window.h"
 #include "kill_process_confirm_dialog.h"
 #include "priority_slider.h"
 #include "process_attribute_dialog.h"
+#include "resource_limit_dialog.h"
+#include "cpu_profile_dialog.h"
 #include "dialog/error_dialog.h"
+#include "dialog/container_group_dialog.h"
+#include "dialog/exited_process_dialog.h"
+#include "dialog/export_file_dialog.h"
+#include "dialog/open_file_search_dialog.h"
 #include "settings.h"
 #include "toolbar.h"
 #include "ui_common.h"
 #include "common/perf.h"
 #include "common/common.h"
 #include "common/error_context.h"
+#include "common/cgroup_stats.h"
+#include "model/data_export.h"
 #include "model/process_sort_filter_proxy_model.h"
 #include "model/process_table_model.h"
 #include "process/process_db.h"
+#include "process/process_gpu_cache.h"
+#include "process/process_smaps_cache.h"
+#include "process_info_record.h"
+#include "system/demand_tracker.h"
 #include "common/eventlogutils.h"
 #include "helper.hpp"
 
@@ -55,9 +70,13 @@
 #include <QKeyEvent>
 #include <QShortcut>
 #include <QActionGroup>
+#include <QItemSelection>
+#include <QSet>
+#include <QScrollBar>
 
 using namespace DDLog;
 using namespace common::init;
+using namespace common::cgroup;
 
 // process table view backup setting key
 const QByteArray header_version = "_1.0.0";
@@ -85,6 +104,7 @@ ProcessTableView::ProcessTableView(DWidget *parent, QString userName)
     // initialize ui components & connections
     initUI(settingsLoaded);
     initConnections(settingsLoaded);
+    setTreeMode(Settings::instance()->getOption(kSettingKeyProcessTreeMode, false).toBool());
     // adjust search result tip label text color dynamically on theme type change
     onThemeTypeChanged();
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -170,12 +190,18 @@ void ProcessTableView::endProcess()
         return;
     }
 
-    qCDebug(app) << "Showing end process confirmation dialog for PID:" << m_selectedPID;
+    const QList<pid_t> pids = selectedPIDs();
+    bool bulk = pids.size() > 1;
+
+    qCDebug(app) << "Showing end process confirmation dialog for PID:" << m_selectedPID << "selected:" << pids.size();
     // kill confirm dialog title & description
     QString title = DApplication::translate("Kill.Process.Dialog", "End process");
-    QString description = DApplication::translate("Kill.Process.Dialog",
-                                                  "Ending this process may cause data "
-                                                  "loss.\nAre you sure you want to continue?");
+    QString description = bulk ? DApplication::translate("Kill.Process.Dialog",
+                                                         "Ending these %1 processes may cause data "
+                                                         "loss.\nAre you sure you want to continue?").arg(pids.size())
+                               : DApplication::translate("Kill.Process.Dialog",
+                                                         "Ending this process may cause data "
+                                                         "loss.\nAre you sure you want to continue?");
 
     KillProcessConfirmDialog dialog(this);
     dialog.setMessage(description);
@@ -183,7 +209,18 @@ void ProcessTableView::endProcess()
     dialog.addButton(DApplication::translate("Kill.Process.Dialog", "End", "button"), true,
                      DDialog::ButtonWarning);
     dialog.exec();
-    if (dialog.result() == QMessageBox::Ok) {
+    if (dialog.result() == QMessageBox::Ok && bulk) {
+        qCDebug(app) << "User confirmed ending" << pids.size() << "processes";
+        for (pid_t pid : pids) {
+            QJsonObject obj {
+                { "tid", EventLogUtils::ProcessKilled },
+                { "version", QCoreApplication::applicationVersion() },
+                { "process_name", m_model->getProcess(pid).name() }
+            };
+            EventLogUtils::get().writeLogs(obj);
+        }
+        controlSelected(pids, PROCESS_CONTROL_SIGNAL, SIGTERM);
+    } else if (dialog.result() == QMessageBox::Ok) {
         qCDebug(app) << "ProcessTableView endProcess: User confirmed ending process";
         Process proc = m_model->getProcess(qvariant_cast<pid_t>(m_selectedPID));
         qCDebug(app) << "User confirmed ending process:" << proc.name() << "(" << m_selectedPID << ")";
@@ -210,6 +247,12 @@ void ProcessTableView::pauseProcess()
         qCDebug(app) << "Cannot pause process - no selection or current process";
         return;
     }
+    const QList<pid_t> pids = selectedPIDs();
+    if (pids.size() > 1) {
+        qCDebug(app) << "Pausing" << pids.size() << "processes";
+        controlSelected(pids, PROCESS_CONTROL_SIGNAL, SIGSTOP);
+        return;
+    }
     qCDebug(app) << "Pausing process:" << pid;
     ProcessDB::instance()->pauseProcess(pid);
 }
@@ -224,6 +267,12 @@ void ProcessTableView::resumeProcess()
         qCDebug(app) << "Cannot resume process - no selection or current process";
         return;
     }
+    const QList<pid_t> pids = selectedPIDs();
+    if (pids.size() > 1) {
+        qCDebug(app) << "Resuming" << pids.size() << "processes";
+        controlSelected(pids, PROCESS_CONTROL_SIGNAL, SIGCONT);
+        return;
+    }
 
     qCDebug(app) << "Resuming process:" << pid;
     ProcessDB::instance()->resumeProcess(pid);
@@ -384,10 +433,12 @@ void ProcessTableView::showProperties()
         auto *attr = new ProcessAttributeDialog(pid,
                                                 proc.name(),
                                                 proc.displayName(),
-                                                proc.cmdlineString(),
+                                                ProcessTableModel::commandLineText(proc),
                                                 proc.icon(),
                                                 proc.startTime(),
                                                 this);
+        // scheduling changes go to all selected rows
+        attr->setTargets(selectedPIDs());
         attr->show();
     }
 }
@@ -402,12 +453,18 @@ void ProcessTableView::killProcess()
         return;
     }
 
-    qCDebug(app) << "Showing kill process confirmation dialog for PID:" << m_selectedPID;
+    const QList<pid_t> pids = selectedPIDs();
+    bool bulk = pids.size() > 1;
+
+    qCDebug(app) << "Showing kill process confirmation dialog for PID:" << m_selectedPID << "selected:" << pids.size();
     // dialog
     QString title = DApplication::translate("Kill.Process.Dialog", "End process");
-    QString description = DApplication::translate("Kill.Process.Dialog",
-                                                  "Force ending this process may cause data "
-                                                  "loss.\nAre you sure you want to continue?");
+    QString description = bulk ? DApplication::translate("Kill.Process.Dialog",
+                                                         "Force ending these %1 processes may cause data "
+                                                         "loss.\nAre you sure you want to continue?").arg(pids.size())
+                               : DApplication::translate("Kill.Process.Dialog",
+                                                         "Force ending this process may cause data "
+                                                         "loss.\nAre you sure you want to continue?");
 
     // show confirm dialog
     KillProcessConfirmDialog dialog(this);
@@ -416,7 +473,18 @@ void ProcessTableView::killProcess()
     dialog.addButton(DApplication::translate("Kill.Process.Dialog", "Force End", "button"), true,
                      DDialog::ButtonWarning);
     dialog.exec();
-    if (dialog.result() == QMessageBox::Ok) {
+    if (dialog.result() == QMessageBox::Ok && bulk) {
+        qCDebug(app) << "User confirmed killing" << pids.size() << "processes";
+        for (pid_t pid : pids) {
+            QJsonObject obj {
+                { "tid", EventLogUtils::ProcessKilled },
+                { "version", QCoreApplication::applicationVersion() },
+                { "process_name", m_model->getProcess(pid).name() }
+            };
+            EventLogUtils::get().writeLogs(obj);
+        }
+        controlSelected(pids, PROCESS_CONTROL_SIGNAL, SIGKILL);
+    } else if (dialog.result() == QMessageBox::Ok) {
         Process proc = m_model->getProcess(qvariant_cast<pid_t>(m_selectedPID));
         qCDebug(app) << "User confirmed killing process:" << proc.name() << "(" << m_selectedPID << ")";
         QJsonObject obj {
@@ -452,6 +520,19 @@ void ProcessTableView::switchDisplayMode(FilterType type)
 void ProcessTableView::changeProcessPriority(int priority)
 {
     qCDebug(app) << "Changing process priority for selected PID:" << m_selectedPID << "to" << priority;
+    // several rows selected, renice the ones not at that priority yet in one batch
+    const QList<pid_t> pids = selectedPIDs();
+    if (pids.size() > 1) {
+        QList<pid_t> changed;
+        for (pid_t pid : pids) {
+            if (m_model->getProcessPriority(pid) != priority)
+                changed << pid;
+        }
+        if (!changed.isEmpty())
+            controlSelected(changed, PROCESS_CONTROL_RENICE, priority);
+        return;
+    }
+
     // check selection first
     if (m_selectedPID.isValid()) {
         pid_t pid = qvariant_cast<pid_t>(m_selectedPID);
@@ -530,6 +611,10 @@ void ProcessTableView::initUI(bool settingsLoaded)
     palette.setColor(DPalette::Text, labelColor);
     m_notFoundLabel->setPalette(palette);
     m_notFoundLabel->setVisible(false);
+    // bulk action progress tip label, shown while a batch runs
+    m_bulkLabel = new DLabel(this);
+    DFontSizeManager::instance()->bind(m_bulkLabel, DFontSizeManager::T6);
+    m_bulkLabel->setVisible(false);
     // header view options
     // header view instance
     auto *hdr = header();
@@ -547,10 +632,12 @@ void ProcessTableView::initUI(bool settingsLoaded)
     hdr->setDefaultAlignment(Qt::AlignLeft | Qt::AlignVCenter);
     // header section context menu policy
     hdr->setContextMenuPolicy(Qt::CustomContextMenu);
+    // all rows share one height, so the view never asks the delegate to measure rows
+    setUniformRowHeights(true);
     // table options
     setSortingEnabled(true);
-    // only single row selection allowed
-    setSelectionMode(QAbstractItemView::SingleSelection);
+    // several rows can be selected with ctrl & shift, actions apply to all of them
+    setSelectionMode(QAbstractItemView::ExtendedSelection);
     // can only select whole row
     setSelectionBehavior(QAbstractItemView::SelectRows);
     // table view context menu policy
@@ -595,6 +682,16 @@ void ProcessTableView::initUI(bool settingsLoaded)
         setColumnWidth(ProcessTableModel::kProcessUploadColumn, 70);
         setColumnHidden(ProcessTableModel::kProcessUploadColumn, false);
 
+        // tcp health, shown next to download & upload
+        setColumnWidth(ProcessTableModel::kProcessTcpRttColumn, 80);
+        setColumnHidden(ProcessTableModel::kProcessTcpRttColumn, true);
+        setColumnWidth(ProcessTableModel::kProcessTcpRetransColumn, 80);
+        setColumnHidden(ProcessTableModel::kProcessTcpRetransColumn, true);
+        header()->moveSection(header()->visualIndex(ProcessTableModel::kProcessTcpRttColumn),
+                              header()->visualIndex(ProcessTableModel::kProcessUploadColumn) + 1);
+        header()->moveSection(header()->visualIndex(ProcessTableModel::kProcessTcpRetransColumn),
+                              header()->visualIndex(ProcessTableModel::kProcessTcpRttColumn) + 1);
+
         // disk read
         setColumnWidth(ProcessTableModel::kProcessDiskReadColumn, 80);
         setColumnHidden(ProcessTableModel::kProcessDiskReadColumn, true);
@@ -603,6 +700,16 @@ void ProcessTableView::initUI(bool settingsLoaded)
         setColumnWidth(ProcessTableModel::kProcessDiskWriteColumn, 80);
         setColumnHidden(ProcessTableModel::kProcessDiskWriteColumn, true);
 
+        // io wait & iops, shown next to disk read & write
+        setColumnWidth(ProcessTableModel::kProcessIOWaitColumn, 80);
+        setColumnHidden(ProcessTableModel::kProcessIOWaitColumn, true);
+        setColumnWidth(ProcessTableModel::kProcessIOPSColumn, 80);
+        setColumnHidden(ProcessTableModel::kProcessIOPSColumn, true);
+        header()->moveSection(header()->visualIndex(ProcessTableModel::kProcessIOWaitColumn),
+                              header()->visualIndex(ProcessTableModel::kProcessDiskWriteColumn) + 1);
+        header()->moveSection(header()->visualIndex(ProcessTableModel::kProcessIOPSColumn),
+                              header()->visualIndex(ProcessTableModel::kProcessIOWaitColumn) + 1);
+
         // pid
         setColumnWidth(ProcessTableModel::kProcessPIDColumn, 70);
         setColumnHidden(ProcessTableModel::kProcessPIDColumn, false);
@@ -615,6 +722,69 @@ void ProcessTableView::initUI(bool settingsLoaded)
         setColumnWidth(ProcessTableModel::kProcessPriorityColumn, 100);
         setColumnHidden(ProcessTableModel::kProcessPriorityColumn, true);
 
+        // memory growth
+        setColumnWidth(ProcessTableModel::kProcessMemoryGrowthColumn, 100);
+        setColumnHidden(ProcessTableModel::kProcessMemoryGrowthColumn, true);
+
+        // time to memory exhaustion, next to memory growth
+        setColumnWidth(ProcessTableModel::kProcessMemoryExhaustionColumn, 90);
+        setColumnHidden(ProcessTableModel::kProcessMemoryExhaustionColumn, true);
+        header()->moveSection(header()->visualIndex(ProcessTableModel::kProcessMemoryExhaustionColumn),
+                              header()->visualIndex(ProcessTableModel::kProcessMemoryGrowthColumn) + 1);
+
+        // cpu wait
+        setColumnWidth(ProcessTableModel::kProcessCPUWaitColumn, 80);
+        setColumnHidden(ProcessTableModel::kProcessCPUWaitColumn, true);
+
+        // estimated power, next to cpu
+        setColumnWidth(ProcessTableModel::kProcessPowerColumn, 80);
+        setColumnHidden(ProcessTableModel::kProcessPowerColumn, true);
+        header()->moveSection(header()->visualIndex(ProcessTableModel::kProcessPowerColumn),
+                              header()->visualIndex(ProcessTableModel::kProcessCPUColumn) + 1);
+
+        // wakeups, next to power
+        setColumnWidth(ProcessTableModel::kProcessWakeupsColumn, 120);
+        setColumnHidden(ProcessTableModel::kProcessWakeupsColumn, true);
+        header()->moveSection(header()->visualIndex(ProcessTableModel::kProcessWakeupsColumn),
+                              header()->visualIndex(ProcessTableModel::kProcessPowerColumn) + 1);
+
+        // command line, last
+        setColumnWidth(ProcessTableModel::kProcessCommandLineColumn, 300);
+        setColumnHidden(ProcessTableModel::kProcessCommandLineColumn, true);
+
+        // guest cpu, next to wakeups
+        setColumnWidth(ProcessTableModel::kProcessGuestCPUColumn, 80);
+        setColumnHidden(ProcessTableModel::kProcessGuestCPUColumn, true);
+        header()->moveSection(header()->visualIndex(ProcessTableModel::kProcessGuestCPUColumn),
+                              header()->visualIndex(ProcessTableModel::kProcessWakeupsColumn) + 1);
+
+        // pss, uss & swap
+        setColumnWidth(ProcessTableModel::kProcessPSSColumn, 80);
+        setColumnHidden(ProcessTableModel::kProcessPSSColumn, true);
+        setColumnWidth(ProcessTableModel::kProcessUSSColumn, 80);
+        setColumnHidden(ProcessTableModel::kProcessUSSColumn, true);
+        setColumnWidth(ProcessTableModel::kProcessSwapColumn, 80);
+        setColumnHidden(ProcessTableModel::kProcessSwapColumn, true);
+
+        // gpu usage & memory
+        setColumnWidth(ProcessTableModel::kProcessGPUColumn, 70);
+        setColumnHidden(ProcessTableModel::kProcessGPUColumn, true);
+        setColumnWidth(ProcessTableModel::kProcessGPUMemoryColumn, 90);
+        setColumnHidden(ProcessTableModel::kProcessGPUMemoryColumn, true);
+
+        // page fault & context switch rates
+        for (int column : {ProcessTableModel::kProcessMinorFaultsColumn, ProcessTableModel::kProcessMajorFaultsColumn,
+                           ProcessTableModel::kProcessVoluntarySwitchesColumn, ProcessTableModel::kProcessInvoluntarySwitchesColumn}) {
+            setColumnWidth(column, 100);
+            setColumnHidden(column, true);
+        }
+
+        // fd & socket counts
+        setColumnWidth(ProcessTableModel::kProcessFDsColumn, 120);
+        setColumnHidden(ProcessTableModel::kProcessFDsColumn, true);
+        setColumnWidth(ProcessTableModel::kProcessSocketsColumn, 80);
+        setColumnHidden(ProcessTableModel::kProcessSocketsColumn, true);
+
         //sort
         sortByColumn(ProcessTableModel::kProcessCPUColumn, Qt::DescendingOrder);
     }
@@ -703,6 +873,15 @@ void ProcessTableView::initConnections(bool settingsLoaded)
     setCustomPrioAction->setActionGroup(prioGroup);
     connect(setCustomPrioAction, &QAction::triggered, [=]() { customizeProcessPriority(); });
 
+    // runtime cgroup limits, moves the process into a scope of its own
+    auto *limitAction = m_contextMenu->addAction(
+            DApplication::translate("Process.Table.Context.Menu", "Limit resources..."));
+    connect(limitAction, &QAction::triggered, this, &ProcessTableView::limitProcessResources);
+    // stacks sampled by the system server, only the profiled process pays for it
+    auto *profileAction = m_contextMenu->addAction(
+            DApplication::translate("Process.Table.Context.Menu", "Profile for 10s"));
+    connect(profileAction, &QAction::triggered, this, &ProcessTableView::profileProcess);
+
     // show exec location action
     auto *openExecDirAction = m_contextMenu->addAction(
             DApplication::translate("Process.Table.Context.Menu", "View command location"));
@@ -713,6 +892,14 @@ void ProcessTableView::initConnections(bool settingsLoaded)
     // ALt + ENTER
     showAttrAction->setShortcut(QKeySequence(Qt::ALT + Qt::Key_Enter));
     connect(showAttrAction, &QAction::triggered, this, &ProcessTableView::showProperties);
+    // select process tree action
+    auto *selectTreeAction = m_contextMenu->addAction(
+            DApplication::translate("Process.Table.Context.Menu", "Select process tree"));
+    connect(selectTreeAction, &QAction::triggered, this, &ProcessTableView::selectProcessTree);
+    // filtered & sorted rows as shown, written from the process snapshot in the background
+    auto *exportAction = m_contextMenu->addAction(
+            DApplication::translate("Process.Table.Context.Menu", "Export table..."));
+    connect(exportAction, &QAction::triggered, this, &ProcessTableView::exportTable);
     m_contextMenu->addSeparator();
     // kill process
     auto *killProcAction = m_contextMenu->addAction(
@@ -768,9 +955,26 @@ void ProcessTableView::initConnections(bool settingsLoaded)
             }
 
             openExecDirAction->setEnabled(checkExecFileExists());
+            showAttrAction->setEnabled(true);
+            // systemd places cgroups of the unified hierarchy only
+            limitAction->setEnabled(CgroupStats::isAvailable() && !ProcessDB::instance()->isCurrentProcess(pid));
+            profileAction->setEnabled(!ProcessDB::instance()->isCurrentProcess(pid));
+
+            // states of several processes differ, both actions are offered
+            if (selectedPIDs().size() > 1) {
+                pauseProcAction->setEnabled(true);
+                resumeProcAction->setEnabled(true);
+                openExecDirAction->setEnabled(false);
+                showAttrAction->setEnabled(false);
+                limitAction->setEnabled(false);
+                profileAction->setEnabled(false);
+            }
         }
     });
 
+    // rows scrolled into view get their smaps read first
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, this, &ProcessTableView::updateSmapsSampling);
+
     // backup table view settings if any of the header view state changes
     auto *h = header();
     connect(h, &QHeaderView::sectionResized, this, [=]() { saveSettings(); });
@@ -860,6 +1064,21 @@ void ProcessTableView::initConnections(bool settingsLoaded)
         saveSettings();
         Q_EMIT signalHeadchanged();
     });
+    // tcp health, io wait & iops actions
+    const QList<QPair<int, const char *>> ioColumns {{ProcessTableModel::kProcessTcpRttColumn, kProcessTcpRtt},
+                                                     {ProcessTableModel::kProcessTcpRetransColumn, kProcessTcpRetrans},
+                                                     {ProcessTableModel::kProcessIOWaitColumn, kProcessIOWait},
+                                                     {ProcessTableModel::kProcessIOPSColumn, kProcessIOPS}};
+    QList<QAction *> ioHeaderActions;
+    for (const auto &column : ioColumns) {
+        auto *action = m_headerContextMenu->addAction(DApplication::translate("Process.Table.Header", column.second));
+        action->setCheckable(true);
+        connect(action, &QAction::triggered, this, [this, column](bool b) {
+            header()->setSectionHidden(column.first, !b);
+            saveSettings();
+        });
+        ioHeaderActions << action;
+    }
     // pid action
     auto *pidHeaderAction = m_headerContextMenu->addAction(
             DApplication::translate("Process.Table.Header", kProcessPID));
@@ -884,6 +1103,108 @@ void ProcessTableView::initConnections(bool settingsLoaded)
         header()->setSectionHidden(ProcessTableModel::kProcessPriorityColumn, !b);
         saveSettings();
     });
+    // memory growth action
+    auto *memGrowthHeaderAction = m_headerContextMenu->addAction(
+            DApplication::translate("Process.Table.Header", kProcessMemoryGrowth));
+    memGrowthHeaderAction->setCheckable(true);
+    connect(memGrowthHeaderAction, &QAction::triggered, this, [this](bool b) {
+        header()->setSectionHidden(ProcessTableModel::kProcessMemoryGrowthColumn, !b);
+        saveSettings();
+    });
+    // time to memory exhaustion action
+    auto *memExhaustionHeaderAction = m_headerContextMenu->addAction(
+            DApplication::translate("Process.Table.Header", kProcessMemoryExhaustion));
+    memExhaustionHeaderAction->setCheckable(true);
+    connect(memExhaustionHeaderAction, &QAction::triggered, this, [this](bool b) {
+        header()->setSectionHidden(ProcessTableModel::kProcessMemoryExhaustionColumn, !b);
+        saveSettings();
+    });
+    // cpu wait action
+    auto *cpuWaitHeaderAction = m_headerContextMenu->addAction(
+            DApplication::translate("Process.Table.Header", kProcessCPUWait));
+    cpuWaitHeaderAction->setCheckable(true);
+    connect(cpuWaitHeaderAction, &QAction::triggered, this, [this](bool b) {
+        header()->setSectionHidden(ProcessTableModel::kProcessCPUWaitColumn, !b);
+        saveSettings();
+    });
+    // power action
+    auto *powerHeaderAction = m_headerContextMenu->addAction(
+            DApplication::translate("Process.Table.Header", kProcessPower));
+    powerHeaderAction->setCheckable(true);
+    connect(powerHeaderAction, &QAction::triggered, this, [this](bool b) {
+        header()->setSectionHidden(ProcessTableModel::kProcessPowerColumn, !b);
+        saveSettings();
+    });
+    // command line action
+    auto *cmdlineHeaderAction = m_headerContextMenu->addAction(
+            DApplication::translate("Process.Table.Header", kProcessCommandLine));
+    cmdlineHeaderAction->setCheckable(true);
+    connect(cmdlineHeaderAction, &QAction::triggered, this, [this](bool b) {
+        header()->setSectionHidden(ProcessTableModel::kProcessCommandLineColumn, !b);
+        saveSettings();
+    });
+    // guest cpu, page fault & context switch rate, fd & socket count actions
+    const QList<QPair<int, const char *>> rateColumns {{ProcessTableModel::kProcessGuestCPUColumn, kProcessGuestCPU},
+                                                       {ProcessTableModel::kProcessMinorFaultsColumn, kProcessMinorFaults},
+                                                       {ProcessTableModel::kProcessMajorFaultsColumn, kProcessMajorFaults},
+                                                       {ProcessTableModel::kProcessVoluntarySwitchesColumn, kProcessVoluntarySwitches},
+                                                       {ProcessTableModel::kProcessInvoluntarySwitchesColumn, kProcessInvoluntarySwitches},
+                                                       {ProcessTableModel::kProcessFDsColumn, kProcessFDs},
+                                                       {ProcessTableModel::kProcessSocketsColumn, kProcessSockets}};
+    QList<QAction *> rateHeaderActions;
+    for (const auto &column : rateColumns) {
+        auto *action = m_headerContextMenu->addAction(DApplication::translate("Process.Table.Header", column.second));
+        action->setCheckable(true);
+        connect(action, &QAction::triggered, this, [this, column](bool b) {
+            header()->setSectionHidden(column.first, !b);
+            saveSettings();
+        });
+        rateHeaderActions << action;
+    }
+    // pss, uss & swap, gpu usage & memory, wakeups actions, all sampled only while shown
+    const QList<QPair<int, const char *>> sampledColumns {{ProcessTableModel::kProcessPSSColumn, kProcessPSS},
+                                                          {ProcessTableModel::kProcessUSSColumn, kProcessUSS},
+                                                          {ProcessTableModel::kProcessSwapColumn, kProcessSwap},
+                                                          {ProcessTableModel::kProcessGPUColumn, kProcessGPU},
+                                                          {ProcessTableModel::kProcessGPUMemoryColumn, kProcessGPUMemory},
+                                                          {ProcessTableModel::kProcessWakeupsColumn, kProcessWakeups}};
+    QList<QAction *> sampledHeaderActions;
+    for (const auto &column : sampledColumns) {
+        auto *action = m_headerContextMenu->addAction(DApplication::translate("Process.Table.Header", column.second));
+        action->setCheckable(true);
+        connect(action, &QAction::triggered, this, [this, column](bool b) {
+            header()->setSectionHidden(column.first, !b);
+            saveSettings();
+            updateSmapsSampling();
+            updateGpuSampling();
+            updateWakeupSampling();
+        });
+        sampledHeaderActions << action;
+    }
+    // nest processes under their parent
+    m_headerContextMenu->addSeparator();
+    auto *treeModeAction = m_headerContextMenu->addAction(DApplication::translate("Process.Table.Header", "Process tree"));
+    treeModeAction->setCheckable(true);
+    connect(treeModeAction, &QAction::triggered, this, [this](bool b) {
+        setTreeMode(b);
+        Settings::instance()->setOption(kSettingKeyProcessTreeMode, b);
+        Settings::instance()->flush();
+    });
+    // processes exited recently, short lived ones no scan has seen included
+    auto *exitedAction = m_headerContextMenu->addAction(DApplication::translate("Process.Table.Header", "Recently exited..."));
+    connect(exitedAction, &QAction::triggered, this, [this]() {
+        (new ExitedProcessDialog(this))->show();
+    });
+    // usage summed by container, sandbox & app
+    auto *containerAction = m_headerContextMenu->addAction(DApplication::translate("Process.Table.Header", "Group by container..."));
+    connect(containerAction, &QAction::triggered, this, [this]() {
+        (new ContainerGroupDialog(this))->show();
+    });
+    // processes holding a file, mount or port, like lsof
+    auto *openFileAction = m_headerContextMenu->addAction(DApplication::translate("Process.Table.Header", "Find open files..."));
+    connect(openFileAction, &QAction::triggered, this, [this]() {
+        (new OpenFileSearchDialog(this))->show();
+    });
 
     // set default header context menu checkable state when settings load without success
     if (!settingsLoaded) {
@@ -896,9 +1217,19 @@ void ProcessTableView::initConnections(bool settingsLoaded)
         downloadHeaderAction->setChecked(true);
         dreadHeaderAction->setChecked(false);
         dwriteHeaderAction->setChecked(false);
+        for (QAction *action : ioHeaderActions)
+            action->setChecked(false);
         pidHeaderAction->setChecked(true);
         niceHeaderAction->setChecked(true);
         priorityHeaderAction->setChecked(true);
+        memGrowthHeaderAction->setChecked(false);
+        memExhaustionHeaderAction->setChecked(false);
+        cpuWaitHeaderAction->setChecked(false);
+        powerHeaderAction->setChecked(false);
+        for (QAction *action : rateHeaderActions)
+            action->setChecked(false);
+        for (QAction *action : sampledHeaderActions)
+            action->setChecked(false);
     }
     // set header context menu checkable state based on current header section's visible state before popup
     connect(m_headerContextMenu, &QMenu::aboutToShow, this, [=]() {
@@ -919,20 +1250,41 @@ void ProcessTableView::initConnections(bool settingsLoaded)
         dreadHeaderAction->setChecked(!b);
         b = header()->isSectionHidden(ProcessTableModel::kProcessDiskWriteColumn);
         dwriteHeaderAction->setChecked(!b);
+        for (int i = 0; i < ioHeaderActions.size(); ++i)
+            ioHeaderActions[i]->setChecked(!header()->isSectionHidden(ioColumns[i].first));
         b = header()->isSectionHidden(ProcessTableModel::kProcessPIDColumn);
         pidHeaderAction->setChecked(!b);
         b = header()->isSectionHidden(ProcessTableModel::kProcessNiceColumn);
         niceHeaderAction->setChecked(!b);
         b = header()->isSectionHidden(ProcessTableModel::kProcessPriorityColumn);
         priorityHeaderAction->setChecked(!b);
+        b = header()->isSectionHidden(ProcessTableModel::kProcessMemoryGrowthColumn);
+        memGrowthHeaderAction->setChecked(!b);
+        b = header()->isSectionHidden(ProcessTableModel::kProcessMemoryExhaustionColumn);
+        memExhaustionHeaderAction->setChecked(!b);
+        b = header()->isSectionHidden(ProcessTableModel::kProcessCPUWaitColumn);
+        cpuWaitHeaderAction->setChecked(!b);
+        b = header()->isSectionHidden(ProcessTableModel::kProcessPowerColumn);
+        powerHeaderAction->setChecked(!b);
+        b = header()->isSectionHidden(ProcessTableModel::kProcessCommandLineColumn);
+        cmdlineHeaderAction->setChecked(!b);
+        for (int i = 0; i < rateHeaderActions.size(); ++i)
+            rateHeaderActions[i]->setChecked(!header()->isSectionHidden(rateColumns[i].first));
+        for (int i = 0; i < sampledHeaderActions.size(); ++i)
+            sampledHeaderActions[i]->setChecked(!header()->isSectionHidden(sampledColumns[i].first));
         b = header()->isSectionHidden(ProcessTableModel::kProcessUserColumn);
         userHeaderAction->setChecked(!b);
+        treeModeAction->setChecked(m_model->treeMode());
     });
 
     // on each model update, we restore settings, adjust search result tip lable's visibility & positon, select the same process item before update if any
     connect(m_model, &ProcessTableModel::modelUpdated, this, [&]() {
         adjustInfoLabelVisibility();
-        if (m_selectedPID.isValid()) {
+        updateSmapsSampling();
+        updateGpuSampling();
+        updateWakeupSampling();
+        // rows of a multi selection are kept by the selection model itself
+        if (m_selectedPID.isValid() && !selectionModel()->hasSelection()) {
             for (int i = 0; i < m_proxyModel->rowCount(); i++) {
                 if (m_proxyModel->data(m_proxyModel->index(i, ProcessTableModel::kProcessPIDColumn),
                                        Qt::UserRole)
@@ -977,6 +1329,9 @@ void ProcessTableView::initConnections(bool settingsLoaded)
                     ErrorDialog::show(this, ec.getErrorName(), ec.getErrorMessage());
                 }
             });
+    // bulk actions of this view, errors are shown once for the whole batch
+    connect(ProcessDB::instance(), &ProcessDB::processesControlProgress, this, &ProcessTableView::onProcessesControlProgress);
+    connect(ProcessDB::instance(), &ProcessDB::processesControlled, this, &ProcessTableView::onProcessesControlled);
     qCInfo(app) << "'processControlResultReady' signal is connect?" << m_pControlConnection;
     //The singleton object only needs to connect to the signal slot once.
     //show error dialog if sending signals to process failed
@@ -1017,10 +1372,58 @@ void ProcessTableView::resizeEvent(QResizeEvent *event)
     // qCDebug(app) << "Resizing process table view";
     // adjust search result tip label's visibility & position when resizing
     adjustInfoLabelVisibility();
+    adjustBulkLabelPosition();
 
     DTreeView::resizeEvent(event);
 }
 
+void ProcessTableView::updateSmapsSampling()
+{
+    bool shown = !header()->isSectionHidden(ProcessTableModel::kProcessPSSColumn)
+                 || !header()->isSectionHidden(ProcessTableModel::kProcessUSSColumn)
+                 || !header()->isSectionHidden(ProcessTableModel::kProcessSwapColumn);
+    ProcessSmapsCache *cache = ProcessSmapsCache::instance();
+    cache->setEnabled(shown);
+    if (!shown || !isVisible())
+        return;
+
+    // rows from the top to the bottom of the viewport
+    QList<pid_t> pids;
+    QModelIndex index = indexAt(QPoint(0, 0));
+    const int bottom = viewport()->height();
+    while (index.isValid() && visualRect(index).top() < bottom) {
+        pids << qvariant_cast<pid_t>(index.sibling(index.row(), ProcessTableModel::kProcessPIDColumn).data(Qt::UserRole));
+        index = indexBelow(index);
+    }
+    cache->setVisiblePids(pids);
+}
+
+void ProcessTableView::setTreeMode(bool enabled)
+{
+    // ancestors of the processes shown are kept, apps are mostly started by session processes
+    m_proxyModel->setRecursiveFilteringEnabled(enabled);
+    m_model->setTreeMode(enabled);
+    setRootIsDecorated(enabled);
+    setItemsExpandable(enabled);
+    // subtrees spawned later start collapsed
+    if (enabled)
+        expandAll();
+}
+
+void ProcessTableView::updateGpuSampling()
+{
+    ProcessGpuCache::instance()->setEnabled(!header()->isSectionHidden(ProcessTableModel::kProcessGPUColumn)
+                                            || !header()->isSectionHidden(ProcessTableModel::kProcessGPUMemoryColumn));
+}
+
+void ProcessTableView::updateWakeupSampling()
+{
+    // voluntary switches stand in for wakeups while the column is hidden
+    const bool shown = !header()->isSectionHidden(ProcessTableModel::kProcessWakeupsColumn);
+    core::system::DemandTracker::instance()->declare(m_model, core::system::DemandTracker::kProcessNetDemand
+                                                              | (shown ? core::system::DemandTracker::kWakeupDemand : 0));
+}
+
 // show event handler
 void ProcessTableView::showEvent(QShowEvent *)
 {
@@ -1029,6 +1432,16 @@ void ProcessTableView::showEvent(QShowEvent *)
     if (m_notFoundLabel) {
         m_notFoundLabel->hide();
     }
+    if (m_model)
+        core::system::DemandTracker::instance()->setVisible(m_model, true);
+}
+
+// hide event handler
+void ProcessTableView::hideEvent(QHideEvent *event)
+{
+    if (m_model)
+        core::system::DemandTracker::instance()->setVisible(m_model, false);
+    BaseTableView::hideEvent(event);
 }
 
 // backup current selected item's pid when selection changed
@@ -1042,7 +1455,12 @@ void ProcessTableView::selectionChanged(const QItemSelection &selected,
         return;
     }
 
-    m_selectedPID = selected.indexes().value(ProcessTableModel::kProcessPIDColumn).data();
+    // the current row stands for a multi selection in single process actions
+    const QModelIndex &current = currentIndex();
+    if (current.isValid() && selectionModel()->isRowSelected(current.row(), current.parent()))
+        m_selectedPID = current.sibling(current.row(), ProcessTableModel::kProcessPIDColumn).data(Qt::UserRole);
+    else
+        m_selectedPID = selected.indexes().value(ProcessTableModel::kProcessPIDColumn).data();
 
     DTreeView::selectionChanged(selected, deselected);
 }
@@ -1056,6 +1474,161 @@ int ProcessTableView::sizeHintForColumn(int column) const
                     DTreeView::sizeHintForColumn(column) + margin * 2);
 }
 
+// forward only the part of changed range visible in viewport, each tick touches every row & the tree view
+// otherwise walks the whole range to refresh its row height cache
+void ProcessTableView::dataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles)
+{
+    const QModelIndex &first = indexAt(QPoint(0, 0));
+    if (topLeft.row() == bottomRight.row() || topLeft.parent().isValid() || !first.isValid()) {
+        // single row, or layout not done yet
+        DTreeView::dataChanged(topLeft, bottomRight, roles);
+        return;
+    }
+
+    const QModelIndex &last = indexAt(QPoint(0, viewport()->height() - 1));
+    int top = std::max(topLeft.row(), first.row());
+    int bottom = std::min(bottomRight.row(), last.isValid() ? last.row() : bottomRight.row());
+    if (top > bottom)
+        return;
+
+    DTreeView::dataChanged(topLeft.sibling(top, topLeft.column()), bottomRight.sibling(bottom, bottomRight.column()), roles);
+}
+
+// select current process & its descendants, rows filtered out of the proxy model stay unselected
+void ProcessTableView::selectProcessTree()
+{
+    if (!m_selectedPID.isValid())
+        return;
+
+    const QList<pid_t> tree = ProcessDB::instance()->processSet()->getProcessTree(qvariant_cast<pid_t>(m_selectedPID));
+    QSet<pid_t> pids;
+    for (pid_t pid : tree)
+        pids.insert(pid);
+
+    QItemSelection selection;
+    for (int i = 0; i < m_proxyModel->rowCount(); i++) {
+        const QModelIndex &index = m_proxyModel->index(i, ProcessTableModel::kProcessPIDColumn);
+        if (pids.contains(qvariant_cast<pid_t>(index.data(Qt::UserRole))))
+            selection.select(index, index);
+    }
+    qCDebug(app) << "Selecting process tree of" << m_selectedPID << ":" << selection.size() << "of" << tree.size() << "processes shown";
+    selectionModel()->select(selection, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+}
+
+void ProcessTableView::exportTable()
+{
+    const QString &path = ExportFileDialog::getSavePath(this, DApplication::translate("Process.Table.Context.Menu", "Export table"),
+                                                        "processes");
+    if (path.isEmpty())
+        return;
+
+    const QVector<pid_t> &pids = shownPIDs();
+    qCDebug(app) << "Exporting" << pids.size() << "processes to" << path;
+    ExportFileDialog::watch(gApp->mainWindow(),
+                            DataExport::exportProcesses(path, ProcessDB::instance()->processSet()->columns(), pids),
+                            path, DApplication::translate("Process.Table.Context.Menu", "Failed to export the table"));
+}
+
+QVector<pid_t> ProcessTableView::shownPIDs() const
+{
+    // source rows through the proxy mapping, no display data is formatted
+    QVector<pid_t> pids;
+    pids.reserve(m_model->rowCount());
+    std::function<void(const QModelIndex &)> addRows = [&](const QModelIndex &parent) {
+        for (int row = 0, rows = m_proxyModel->rowCount(parent); row < rows; ++row) {
+            const QModelIndex &index = m_proxyModel->index(row, 0, parent);
+            if (pid_t pid = m_model->pidOf(m_proxyModel->mapToSource(index)))
+                pids << pid;
+            if (m_model->treeMode())
+                addRows(index);
+        }
+    };
+    addRows({});
+    return pids;
+}
+
+// pids of selected rows
+QList<pid_t> ProcessTableView::selectedPIDs() const
+{
+    QList<pid_t> pids;
+    const QModelIndexList &rows = selectionModel()->selectedRows(ProcessTableModel::kProcessPIDColumn);
+    if (rows.isEmpty() && m_selectedPID.isValid()) {
+        pids << qvariant_cast<pid_t>(m_selectedPID);
+        return pids;
+    }
+    for (const QModelIndex &index : rows) {
+        pid_t pid = qvariant_cast<pid_t>(index.data(Qt::UserRole));
+        // monitor process itself is never controlled in bulk
+        if (!ProcessDB::instance()->isCurrentProcess(pid))
+            pids << pid;
+    }
+    return pids;
+}
+
+// start a batch of this view
+bool ProcessTableView::controlSelected(const QList<pid_t> &pids, int action, int value)
+{
+    if (m_bulkAction >= 0) {
+        qCWarning(app) << "Bulk action ignored, previous one still running on" << m_bulkPids.size() << "processes";
+        return false;
+    }
+    m_bulkPids = pids;
+    m_bulkAction = action;
+    m_bulkValue = value;
+    onProcessesControlProgress(pids, action, value, 0);
+    ProcessDB::instance()->controlProcesses(pids, action, value);
+    return true;
+}
+
+void ProcessTableView::onProcessesControlProgress(const QList<pid_t> &pids, int action, int value, int done)
+{
+    if (action != m_bulkAction || value != m_bulkValue || pids != m_bulkPids)
+        return;
+
+    m_bulkLabel->setText(DApplication::translate("Process.Table.Bulk", "%1 of %2 processes done").arg(done).arg(pids.size()));
+    m_bulkLabel->adjustSize();
+    m_bulkLabel->setVisible(true);
+    adjustBulkLabelPosition();
+}
+
+void ProcessTableView::onProcessesControlled(const QList<pid_t> &pids, int action, int value, const QList<int> &errors)
+{
+    if (action != m_bulkAction || value != m_bulkValue || pids != m_bulkPids)
+        return;
+
+    m_bulkPids.clear();
+    m_bulkAction = -1;
+    m_bulkLabel->setVisible(false);
+
+    // failures listed with pid & reason, the first ones only
+    const int kMaxListed = 10;
+    QStringList failed;
+    int failures = 0;
+    for (int i = 0; i < pids.size() && i < errors.size(); i++) {
+        if (!errors[i])
+            continue;
+        if (++failures <= kMaxListed)
+            failed << QString("PID: %1, Error: [%2] %3").arg(pids[i]).arg(errors[i]).arg(strerror(errors[i]));
+    }
+    qCInfo(app) << "Bulk action" << action << value << "done," << failures << "of" << pids.size() << "processes failed";
+    if (failures == 0)
+        return;
+    if (failures > kMaxListed)
+        failed << "...";
+
+    QString title = action == PROCESS_CONTROL_RENICE
+            ? DApplication::translate("Process.Priority", "Failed to change priority of %1 of %2 processes")
+            : DApplication::translate("Process.Signal", "Failed to send signal to %1 of %2 processes");
+    ErrorDialog::show(this, title.arg(failures).arg(pids.size()), failed.join("\n"));
+}
+
+// keep bulk progress tip label at bottom center of the view
+void ProcessTableView::adjustBulkLabelPosition()
+{
+    if (m_bulkLabel && m_bulkLabel->isVisible())
+        m_bulkLabel->move((width() - m_bulkLabel->width()) / 2, height() - m_bulkLabel->height() - 10);
+}
+
 // adjust search result tip label's visibility & position
 void ProcessTableView::adjustInfoLabelVisibility()
 {
@@ -1132,6 +1705,39 @@ void ProcessTableView::customizeProcessPriority()
     prioDialog->exec();
 }
 
+void ProcessTableView::limitProcessResources()
+{
+    if (!m_selectedPID.isValid())
+        return;
+
+    pid_t pid = qvariant_cast<pid_t>(m_selectedPID);
+    // limits of a scope made for another process aren't this one's
+    resource_limits_t limits {RESOURCE_LIMIT_NONE, RESOURCE_LIMIT_NONE, RESOURCE_LIMIT_NONE};
+    const QString cgroup = CgroupStats::processCgroup(pid);
+    if (cgroup.endsWith(QString("/" RESOURCE_LIMIT_SCOPE_PREFIX "%1.scope").arg(pid)))
+        CgroupStats::readLimits(cgroup, limits);
+
+    const QString title = DApplication::translate("Resource.Limit.Dialog", "Limit resources of %1 (%2)")
+                                  .arg(m_model->getProcess(pid).displayName()).arg(pid);
+    ResourceLimitDialog dialog(title, limits, this);
+    dialog.exec();
+    if (dialog.result() != QMessageBox::Ok) {
+        qCDebug(app) << "User cancelled limiting process" << pid;
+        return;
+    }
+    ProcessDB::instance()->limitProcess(pid, dialog.limits());
+}
+
+void ProcessTableView::profileProcess()
+{
+    if (!m_selectedPID.isValid())
+        return;
+
+    pid_t pid = qvariant_cast<pid_t>(m_selectedPID);
+    auto *dialog = new CpuProfileDialog(pid, m_model->getProcess(pid).displayName(), this);
+    dialog->show();
+}
+
 void ProcessTableView::setUserModeName(const QString &userName)
 {
     qCDebug(app) << "Current user mode name:" << m_useModeName;
@@ -106,6 +106,14 @@ public Q_SLOTS:
      * @param priority Process priority
      */
     void changeProcessPriority(int priority);
+    /**
+     * @brief Select the current process & all of its descendants
+     */
+    void selectProcessTree();
+    /**
+     * @brief Export the shown rows in view order to a CSV or JSON lines file
+     */
+    void exportTable();
 
     /**
      * @brief onThemeTypeChanged
@@ -157,6 +165,11 @@ protected:
      * @param event Show event
      */
     void showEvent(QShowEvent *event) override;
+    /**
+     * @brief Hide event handler, process traffic stops being read
+     * @param event Hide event
+     */
+    void hideEvent(QHideEvent *event) override;
 
     /**
      * @brief selectionChanged Selection changed event handler
@@ -171,6 +184,14 @@ protected:
      * @return Hinted size for column
      */
     int sizeHintForColumn(int column) const override;
+    /**
+     * @brief dataChanged Clip model updates to the rows intersecting the viewport, off-screen rows
+     * are repainted with their current data when scrolled into view
+     * @param topLeft Top left index of the changed range
+     * @param bottomRight Bottom right index of the changed range
+     * @param roles Changed roles
+     */
+    void dataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles = QVector<int>()) override;
 
 private:
     /**
@@ -181,11 +202,61 @@ private:
      * @brief Customize process priority handler
      */
     void customizeProcessPriority();
+    /**
+     * @brief Limit cpu, memory & io of the selected process through a transient systemd scope
+     */
+    void limitProcessResources();
+    /**
+     * @brief Sample the stacks of the selected process for a while & show them as a flame graph
+     */
+    void profileProcess();
     /**
      * @brief Check if the executable file of selected process exists
      * @return true if file exists, false otherwise
      */
     bool checkExecFileExists();
+    /**
+     * @brief PIDs of the selected rows, the app itself excluded
+     * @return m_selectedPID alone if no row is selected
+     */
+    QList<pid_t> selectedPIDs() const;
+    /**
+     * @brief PIDs of all shown rows in view order, children after their parent in tree mode
+     */
+    QVector<pid_t> shownPIDs() const;
+    /**
+     * @brief Send one action to several processes through a single ProcessDB batch
+     * @return false if another batch of this view is still running
+     */
+    bool controlSelected(const QList<pid_t> &pids, int action, int value);
+    /**
+     * @brief Show the progress of the running batch
+     */
+    void onProcessesControlProgress(const QList<pid_t> &pids, int action, int value, int done);
+    /**
+     * @brief Hide the progress of the finished batch & show the failed processes if any
+     */
+    void onProcessesControlled(const QList<pid_t> &pids, int action, int value, const QList<int> &errors);
+    /**
+     * @brief Adjust bulk progress tip label's position
+     */
+    void adjustBulkLabelPosition();
+    /**
+     * @brief Read smaps_rollup only while a smaps column is shown, rows in view first
+     */
+    void updateSmapsSampling();
+    /**
+     * @brief Read drm fdinfo only while a gpu column is shown
+     */
+    void updateGpuSampling();
+    /**
+     * @brief Have the system server trace wakeups only while the wakeups column is shown
+     */
+    void updateWakeupSampling();
+    /**
+     * @brief Nest processes under their parent with expand & collapse, or list them flat
+     */
+    void setTreeMode(bool enabled);
 
 private:
     // Process model for process table view
@@ -207,6 +278,13 @@ private:
     // Currently selected PID
     QVariant m_selectedPID {};
 
+    // Bulk action in progress, m_bulkAction is -1 if none
+    QList<pid_t> m_bulkPids {};
+    int m_bulkAction {-1};
+    int m_bulkValue {};
+    // Bulk action progress tip label
+    DLabel *m_bulkLabel {};
+
     // End process shortcut
     QShortcut *m_endProcKP {};
     // Pause process shortcut
@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "resource_limit_dialog.h"
+#include "ddlog.h"
+
+#include <DApplication>
+
+#include <QGridLayout>
+#include <QMessageBox>
+
+#include <unistd.h>
+
+using namespace DDLog;
+
+// us of cpu time per s in a percent of a cpu
+#define CPU_QUOTA_PER_PERCENT 10000ULL
+// limits offered when none is set yet
+#define DEFAULT_CPU_PERCENT 50
+#define DEFAULT_MEMORY_MIB 1024
+#define DEFAULT_IO_WEIGHT 100
+
+ResourceLimitDialog::ResourceLimitDialog(const QString &title, const resource_limits_t &limits, DWidget *parent)
+    : DDialog(parent)
+{
+    qCDebug(app) << "ResourceLimitDialog constructor";
+    setIcon(QIcon::fromTheme("dialog-warning"));
+    setTitle(title);
+    setMessage(DApplication::translate("Resource.Limit.Dialog",
+                                       "Throttled without a restart & nothing is killed, limits are lifted when the system restarts"));
+    setWordWrapMessage(true);
+    addSpacing(10);
+
+    const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    const long pages = sysconf(_SC_PHYS_PAGES);
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    const int totalMiB = pages > 0 && pageSize > 0 ? int((quint64(pages) * quint64(pageSize)) >> 20) : DEFAULT_MEMORY_MIB;
+
+    auto *content = new QWidget(this);
+    auto *layout = new QGridLayout(content);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    m_cpuCheck = new DCheckBox(DApplication::translate("Resource.Limit.Dialog", "Limit CPU to"), content);
+    m_cpuBox = new DSpinBox(content);
+    m_cpuBox->setRange(int(RESOURCE_LIMIT_MIN_CPU_QUOTA / CPU_QUOTA_PER_PERCENT), int(qMax(1L, cpus)) * 100);
+    m_cpuBox->setSuffix(" %");
+    m_cpuBox->setToolTip(DApplication::translate("Resource.Limit.Dialog", "Percent of one CPU, 200% is two CPUs"));
+    m_memoryCheck = new DCheckBox(DApplication::translate("Resource.Limit.Dialog", "Cap memory at"), content);
+    m_memoryBox = new DSpinBox(content);
+    m_memoryBox->setRange(int(RESOURCE_LIMIT_MIN_MEMORY_HIGH >> 20), qMax(totalMiB, int(RESOURCE_LIMIT_MIN_MEMORY_HIGH >> 20)));
+    m_memoryBox->setSuffix(" MiB");
+    m_memoryBox->setToolTip(DApplication::translate("Resource.Limit.Dialog", "Memory above it is reclaimed & allocations slowed down"));
+    m_ioCheck = new DCheckBox(DApplication::translate("Resource.Limit.Dialog", "IO weight"), content);
+    m_ioBox = new DSpinBox(content);
+    m_ioBox->setRange(1, int(RESOURCE_LIMIT_MAX_IO_WEIGHT));
+    m_ioBox->setToolTip(DApplication::translate("Resource.Limit.Dialog", "Share of disk time against the others when disks are busy, 100 is the default"));
+
+    m_cpuCheck->setChecked(limits.cpu_quota != RESOURCE_LIMIT_NONE);
+    m_cpuBox->setValue(m_cpuCheck->isChecked() ? int(limits.cpu_quota / CPU_QUOTA_PER_PERCENT) : DEFAULT_CPU_PERCENT);
+    m_memoryCheck->setChecked(limits.memory_high != RESOURCE_LIMIT_NONE);
+    m_memoryBox->setValue(m_memoryCheck->isChecked() ? int(limits.memory_high >> 20) : qMin(DEFAULT_MEMORY_MIB, totalMiB));
+    m_ioCheck->setChecked(limits.io_weight != RESOURCE_LIMIT_NONE);
+    m_ioBox->setValue(m_ioCheck->isChecked() ? int(limits.io_weight) : DEFAULT_IO_WEIGHT);
+
+    const QList<QPair<DCheckBox *, DSpinBox *>> rows {{m_cpuCheck, m_cpuBox}, {m_memoryCheck, m_memoryBox}, {m_ioCheck, m_ioBox}};
+    for (int row = 0; row < rows.size(); ++row) {
+        DSpinBox *box = rows[row].second;
+        layout->addWidget(rows[row].first, row, 0);
+        layout->addWidget(box, row, 1);
+        box->setEnabled(rows[row].first->isChecked());
+        connect(rows[row].first, &DCheckBox::toggled, box, &DSpinBox::setEnabled);
+    }
+    addContent(content);
+    addSpacing(10);
+
+    addButton(DApplication::translate("Resource.Limit.Dialog", "Cancel", "button"), false, DDialog::ButtonNormal);
+    addButton(DApplication::translate("Resource.Limit.Dialog", "Apply", "button"), true, DDialog::ButtonRecommend);
+    connect(this, &ResourceLimitDialog::buttonClicked, this, &ResourceLimitDialog::onButtonClicked);
+}
+
+resource_limits_t ResourceLimitDialog::limits() const
+{
+    resource_limits_t limits {RESOURCE_LIMIT_NONE, RESOURCE_LIMIT_NONE, RESOURCE_LIMIT_NONE};
+    if (m_cpuCheck->isChecked())
+        limits.cpu_quota = quint64(m_cpuBox->value()) * CPU_QUOTA_PER_PERCENT;
+    if (m_memoryCheck->isChecked())
+        limits.memory_high = quint64(m_memoryBox->value()) << 20;
+    if (m_ioCheck->isChecked())
+        limits.io_weight = quint64(m_ioBox->value());
+    return limits;
+}
+
+void ResourceLimitDialog::onButtonClicked(int index, const QString &)
+{
+    qCDebug(app) << "button clicked, index: " << index;
+    m_result = index == 1 ? QMessageBox::Ok : QMessageBox::Cancel;
+}
@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef RESOURCE_LIMIT_DIALOG_H
+#define RESOURCE_LIMIT_DIALOG_H
+
+#include "process_info_record.h"
+
+#include <DCheckBox>
+#include <DDialog>
+#include <DSpinBox>
+#include <DWidget>
+
+DWIDGET_USE_NAMESPACE
+
+/**
+ * @brief Dialog asking runtime cpu, memory & io limits of a process or service
+ */
+class ResourceLimitDialog : public DDialog
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Dialog constructor
+     * @param title Process or service limited
+     * @param limits Limits set now, the ones not set start unchecked
+     * @param parent Parent object
+     */
+    explicit ResourceLimitDialog(const QString &title, const resource_limits_t &limits, DWidget *parent = nullptr);
+
+    /**
+     * @brief Limits chosen, RESOURCE_LIMIT_NONE for the unchecked ones
+     */
+    resource_limits_t limits() const;
+
+    /**
+     * @brief result Get standard button enum result
+     * @return Standard button enum result
+     */
+    int result() const { return m_result; }
+
+public Q_SLOTS:
+    /**
+     * @brief onButtonClicked Button clicked event handler
+     * @param index Button index
+     * @param text Button text
+     */
+    void onButtonClicked(int index, const QString &text);
+
+private:
+    // Standard button enum result
+    int m_result {0};
+    // cpu quota in percent of one cpu
+    DCheckBox *m_cpuCheck {};
+    DSpinBox *m_cpuBox {};
+    // memory high in MiB
+    DCheckBox *m_memoryCheck {};
+    DSpinBox *m_memoryBox {};
+    DCheckBox *m_ioCheck {};
+    DSpinBox *m_ioBox {};
+};
+
+#endif // RESOURCE_LIMIT_DIALOG_H
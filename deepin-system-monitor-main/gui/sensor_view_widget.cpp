@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "sensor_view_widget.h"
+#include "chart_view_widget.h"
+#include "model/model_manager.h"
+#include "model/sample_history.h"
+#include "model/update_coordinator.h"
+#include "system/device_db.h"
+#include "system/device_snapshot.h"
+#include "ddlog.h"
+
+#include <DFontSizeManager>
+
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+using namespace DDLog;
+using namespace core::system;
+
+#define SENSOR_VIEW_HEIGHT 100
+
+// other sensors listed beside the chart
+const int kListedSensors = 2;
+
+SensorViewWidget::SensorViewWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    qCDebug(app) << "SensorViewWidget constructor";
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    setFixedHeight(SENSOR_VIEW_HEIGHT);
+
+    SampleHistory *history = ModelManager::instance()->sampleHistory();
+    m_chart = new ChartViewWidget(ChartViewWidget::ChartViewTypes::TEMPERATURE_CHART, this);
+    m_chart->setData1Color(QColor("#FF4D4D"));
+    m_chart->setData2Color(QColor("#2CA7F8"));
+    m_chart->setSeries1(&history->series(SampleHistory::kCpuTemperature));
+    m_chart->setSeries2(&history->series(SampleHistory::kCpuFrequency));
+    m_chart->setStoredSeries1(SampleHistory::kCpuTemperature);
+    m_chart->setStoredSeries2(SampleHistory::kCpuFrequency);
+    connect(history, &SampleHistory::updated, m_chart, &ChartViewWidget::updateSeries);
+
+    m_titleLabel = new DLabel(tr("Sensors"), this);
+    m_titleLabel->setForegroundRole(DPalette::TextTips);
+    m_titleLabel->setToolTip(tr("Hottest CPU temperature in °C & average core frequency in percent "
+                                "of the maximum, a frequency dropping while the temperature peaks "
+                                "is thermal throttling"));
+    m_temperatureLabel = new DLabel(this);
+    m_sensorsLabel = new DLabel(this);
+    m_sensorsLabel->setForegroundRole(DPalette::TextTips);
+    DFontSizeManager::instance()->bind(m_titleLabel, DFontSizeManager::T8);
+    DFontSizeManager::instance()->bind(m_sensorsLabel, DFontSizeManager::T8);
+
+    auto *textLayout = new QVBoxLayout();
+    textLayout->setContentsMargins(0, 0, 0, 0);
+    textLayout->addWidget(m_titleLabel);
+    textLayout->addWidget(m_temperatureLabel);
+    textLayout->addWidget(m_sensorsLabel);
+    textLayout->addStretch();
+
+    auto *layout = new QHBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(16);
+    layout->addWidget(m_chart, 4);
+    layout->addLayout(textLayout, 2);
+
+    onModelUpdate();
+    connect(ModelManager::instance()->updateCoordinator(), &UpdateCoordinator::updateViews, this, &SensorViewWidget::onModelUpdate);
+}
+
+void SensorViewWidget::fontChanged(const QFont &font)
+{
+    qCDebug(app) << "SensorViewWidget fontChanged";
+    m_temperatureLabel->setFont(font);
+}
+
+void SensorViewWidget::onModelUpdate()
+{
+    DeviceSnapshotPtr snapshot = DeviceDB::instance()->snapshot();
+    setVisible(!snapshot->sensors.isEmpty());
+    if (snapshot->sensors.isEmpty())
+        return;
+
+    QList<sensor_t> temperatures;
+    QList<sensor_t> others;
+    const sensor_t *cpu = nullptr;
+    for (const sensor_t &sensor : snapshot->sensors) {
+        if (sensor.kind == sensor_t::kTemperature) {
+            temperatures << sensor;
+            if (sensor.cpu && (!cpu || sensor.value > cpu->value))
+                cpu = &sensor;
+        } else {
+            others << sensor;
+        }
+    }
+
+    if (cpu) {
+        QString text = tr("CPU %1 °C").arg(cpu->value, 0, 'f', 1);
+        if (cpu->critical > 0)
+            text += " " + tr("(critical %1 °C)").arg(cpu->critical, 0, 'f', 0);
+        m_temperatureLabel->setText(text);
+    } else {
+        m_temperatureLabel->setText(tr("No CPU temperature sensor"));
+    }
+
+    // hottest others first, a line kept for fans & power
+    std::sort(temperatures.begin(), temperatures.end(), [](const sensor_t &a, const sensor_t &b) {
+        return a.value > b.value;
+    });
+    QList<sensor_t> listed;
+    for (const sensor_t &sensor : temperatures) {
+        if (listed.size() >= kListedSensors - (others.isEmpty() ? 0 : 1))
+            break;
+        if (!cpu || sensor.chip != cpu->chip || sensor.label != cpu->label)
+            listed << sensor;
+    }
+    listed += others.mid(0, kListedSensors - listed.size());
+
+    QStringList lines;
+    for (const sensor_t &sensor : listed) {
+        const QString name = sensor.chip + " " + sensor.label;
+        if (sensor.kind == sensor_t::kTemperature)
+            lines << tr("%1: %2 °C").arg(name).arg(sensor.value, 0, 'f', 1);
+        else if (sensor.kind == sensor_t::kFan)
+            lines << tr("%1: %2 rpm").arg(name).arg(qRound(sensor.value));
+        else
+            lines << tr("%1: %2 W").arg(name).arg(sensor.value, 0, 'f', 1);
+    }
+    m_sensorsLabel->setText(lines.join("\n"));
+}
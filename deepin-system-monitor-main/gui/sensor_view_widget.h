@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SENSOR_VIEW_WIDGET_H
+#define SENSOR_VIEW_WIDGET_H
+
+#include <DLabel>
+
+#include <QWidget>
+
+DWIDGET_USE_NAMESPACE
+
+class ChartViewWidget;
+
+/**
+ * @brief Hardware sensors in the cpu detail view
+ *
+ * Chart of the hottest cpu temperature against the average core frequency, so throttling
+ * shows next to the frequency heatmap, with the hottest sensors, fans & power sensors of
+ * hwmon beside it. Hidden without sensors, e.g. in virtual machines.
+ */
+class SensorViewWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit SensorViewWidget(QWidget *parent = nullptr);
+
+public slots:
+    void fontChanged(const QFont &font);
+    void onModelUpdate();
+
+private:
+    ChartViewWidget *m_chart;
+    DLabel *m_titleLabel;
+    DLabel *m_temperatureLabel;
+    DLabel *m_sensorsLabel;
+};
+
+#endif // SENSOR_VIEW_WIDGET_H
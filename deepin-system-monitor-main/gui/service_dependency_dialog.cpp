@@ -0,0 +1,157 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "service_dependency_dialog.h"
+#include "ddlog.h"
+
+#include "service/service_dependency_graph.h"
+
+#include <DApplication>
+
+#include <QHeaderView>
+#include <QTreeWidget>
+
+using namespace DDLog;
+
+// item data, unit id & whether the children were added
+const int kUnitRole = Qt::UserRole;
+const int kPopulatedRole = Qt::UserRole + 1;
+
+ServiceDependencyDialog::ServiceDependencyDialog(const QString &unit, ServiceDependencyGraph *graph, QWidget *parent)
+    : DDialog(parent)
+    , m_graph(graph)
+{
+    qCDebug(app) << "ServiceDependencyDialog constructor for" << unit;
+    setAttribute(Qt::WA_DeleteOnClose);
+    setTitle(DApplication::translate("Service.Dependency.Dialog", "Dependencies of %1").arg(unit));
+
+    m_tree = new QTreeWidget(this);
+    m_tree->setColumnCount(kColumnCount);
+    m_tree->setHeaderLabels({DApplication::translate("Service.Dependency.Dialog", "Unit"),
+                             DApplication::translate("Service.Dependency.Dialog", "Dependency"),
+                             DApplication::translate("Service.Dependency.Dialog", "Active"),
+                             DApplication::translate("Service.Dependency.Dialog", "Startup time")});
+    m_tree->header()->setSectionResizeMode(kUnitColumn, QHeaderView::Stretch);
+    m_tree->header()->setStretchLastSection(false);
+    m_tree->setMinimumSize(620, 420);
+    addContent(m_tree);
+
+    connect(m_graph, &ServiceDependencyGraph::nodeFetched, this, &ServiceDependencyDialog::onNodeFetched);
+    connect(m_tree, &QTreeWidget::itemExpanded, this, &ServiceDependencyDialog::onItemExpanded);
+
+    QTreeWidgetItem *root = addUnitItem(nullptr, unit, {});
+    // a cached root is shown expanded at once
+    if (m_graph->node(unit))
+        m_tree->expandItem(root);
+}
+
+QString ServiceDependencyDialog::formatStartup(qint64 usec)
+{
+    if (usec < 0)
+        return {};
+    if (usec < 1000000)
+        return QString("%1ms").arg(usec / 1000);
+    return QString("%1s").arg(usec / 1000000., 0, 'f', 3);
+}
+
+void ServiceDependencyDialog::onNodeFetched(const QString &unit)
+{
+    const DependencyNode *node = m_graph->node(unit);
+    const QList<QTreeWidgetItem *> items = m_items.values(unit);
+    m_items.remove(unit);
+    for (QTreeWidgetItem *item : items) {
+        updateItem(item, node);
+        if (!node)
+            continue;
+        if (!item->parent())
+            m_tree->expandItem(item);
+        // expanded before its node came
+        if (item->isExpanded())
+            populate(item, node);
+    }
+}
+
+void ServiceDependencyDialog::onItemExpanded(QTreeWidgetItem *item)
+{
+    const DependencyNode *node = m_graph->node(item->data(kUnitColumn, kUnitRole).toString());
+    if (node)
+        populate(item, node);
+}
+
+QTreeWidgetItem *ServiceDependencyDialog::addUnitItem(QTreeWidgetItem *parent, const QString &unit, const QStringList &relations)
+{
+    auto *item = parent ? new QTreeWidgetItem(parent) : new QTreeWidgetItem(m_tree);
+    item->setText(kUnitColumn, unit);
+    item->setText(kRelationColumn, relations.join(", "));
+    item->setData(kUnitColumn, kUnitRole, unit);
+
+    // units of ordering cycles are shown, not expanded again
+    if (parent && hasAncestor(parent, unit)) {
+        item->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicator);
+        item->setData(kUnitColumn, kPopulatedRole, true);
+    } else {
+        item->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+    }
+
+    const DependencyNode *node = m_graph->node(unit);
+    if (node) {
+        updateItem(item, node);
+    } else {
+        m_items.insert(unit, item);
+        m_graph->fetch(unit);
+    }
+    return item;
+}
+
+void ServiceDependencyDialog::updateItem(QTreeWidgetItem *item, const DependencyNode *node)
+{
+    if (!node) {
+        item->setText(kStateColumn, DApplication::translate("Service.Dependency.Dialog", "Unknown"));
+        item->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicator);
+        return;
+    }
+
+    item->setText(kStateColumn, node->activeState);
+    item->setText(kStartupColumn, formatStartup(node->startupUsec));
+    item->setToolTip(kUnitColumn, node->description);
+    if (node->requires.isEmpty() && node->wants.isEmpty() && node->after.isEmpty())
+        item->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicator);
+}
+
+void ServiceDependencyDialog::populate(QTreeWidgetItem *item, const DependencyNode *node)
+{
+    if (item->data(kUnitColumn, kPopulatedRole).toBool())
+        return;
+    item->setData(kUnitColumn, kPopulatedRole, true);
+
+    // a unit both required & ordered after is shown once, with both relations
+    QStringList units;
+    QHash<QString, QStringList> relations;
+    auto add = [&](const QStringList &deps, const QString &relation) {
+        for (const QString &dep : deps) {
+            QStringList &list = relations[dep];
+            if (list.isEmpty())
+                units << dep;
+            list << relation;
+        }
+    };
+    add(node->requires, "Requires");
+    add(node->wants, "Wants");
+    add(node->after, "After");
+
+    m_tree->setUpdatesEnabled(false);
+    for (const QString &unit : units)
+        addUnitItem(item, unit, relations.value(unit));
+    m_tree->setUpdatesEnabled(true);
+    qCDebug(app) << node->unit << "expanded with" << units.size() << "dependencies";
+}
+
+bool ServiceDependencyDialog::hasAncestor(QTreeWidgetItem *item, const QString &unit)
+{
+    for (; item; item = item->parent()) {
+        if (item->data(kUnitColumn, kUnitRole).toString() == unit)
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SERVICE_DEPENDENCY_DIALOG_H
+#define SERVICE_DEPENDENCY_DIALOG_H
+
+#include <DDialog>
+
+#include <QMultiHash>
+
+DWIDGET_USE_NAMESPACE
+
+class ServiceDependencyGraph;
+struct DependencyNode;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+/**
+ * @brief Dependency tree of a service, with the startup time of each unit
+ *
+ * The children of a unit are read when it's expanded, units shown more than once are read once
+ * through the shared graph cache.
+ */
+class ServiceDependencyDialog : public DDialog
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        kUnitColumn,
+        kRelationColumn,
+        kStateColumn,
+        kStartupColumn,
+
+        kColumnCount
+    };
+
+    /**
+     * @brief Dialog constructor
+     * @param unit Unit id of the service, e.g. dbus.service
+     * @param graph Graph cache, outlives the dialog
+     * @param parent Parent object
+     */
+    explicit ServiceDependencyDialog(const QString &unit, ServiceDependencyGraph *graph, QWidget *parent = nullptr);
+
+    /**
+     * @brief Startup time text, systemd-analyze style
+     */
+    static QString formatStartup(qint64 usec);
+
+private Q_SLOTS:
+    void onNodeFetched(const QString &unit);
+    void onItemExpanded(QTreeWidgetItem *item);
+
+private:
+    QTreeWidgetItem *addUnitItem(QTreeWidgetItem *parent, const QString &unit, const QStringList &relations);
+    /**
+     * @brief Fill the columns of an item with the node of its unit
+     */
+    void updateItem(QTreeWidgetItem *item, const DependencyNode *node);
+    /**
+     * @brief Add children of an expanded item & fetch their nodes
+     */
+    void populate(QTreeWidgetItem *item, const DependencyNode *node);
+    static bool hasAncestor(QTreeWidgetItem *item, const QString &unit);
+
+private:
+    ServiceDependencyGraph *m_graph;
+    QTreeWidget *m_tree {};
+    QMultiHash<QString, QTreeWidgetItem *> m_items; // by unit, items waiting for their node
+};
+
+#endif // SERVICE_DEPENDENCY_DIALOG_H
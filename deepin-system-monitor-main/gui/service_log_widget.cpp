@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "service_log_widget.h"
+#include "model/journal_model.h"
+#include "service/journal_tail.h"
+#include "ddlog.h"
+
+#include <DApplication>
+#include <DFontSizeManager>
+
+#include <QFontDatabase>
+#include <QHBoxLayout>
+#include <QListView>
+#include <QScrollBar>
+#include <QVBoxLayout>
+
+using namespace DDLog;
+
+ServiceLogWidget::ServiceLogWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    qCDebug(app) << "ServiceLogWidget constructor";
+    m_tail = new JournalTail(this);
+    m_model = new JournalModel(this);
+
+    m_titleLabel = new DLabel(this);
+    m_statusLabel = new DLabel(this);
+    m_statusLabel->setForegroundRole(DPalette::TextTips);
+    DFontSizeManager::instance()->bind(m_statusLabel, DFontSizeManager::T8);
+    m_clearButton = new DPushButton(DApplication::translate("Service.Log", "Clear"), this);
+    m_closeButton = new DPushButton(DApplication::translate("Service.Log", "Close"), this);
+
+    // rows of one height are laid out only where the view shows them
+    m_view = new QListView(this);
+    m_view->setModel(m_model);
+    m_view->setUniformItemSizes(true);
+    m_view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_view->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_view->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    m_view->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+    auto *headerLayout = new QHBoxLayout();
+    headerLayout->setContentsMargins(0, 0, 0, 0);
+    headerLayout->addWidget(m_titleLabel);
+    headerLayout->addWidget(m_statusLabel, 1);
+    headerLayout->addWidget(m_clearButton);
+    headerLayout->addWidget(m_closeButton);
+
+    auto *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addLayout(headerLayout);
+    layout->addWidget(m_view, 1);
+
+    connect(m_tail, &JournalTail::linesAppended, m_model, [this](const QVector<JournalLine> &lines, int dropped) {
+        // stay at the newest line unless scrolled up to read
+        QScrollBar *bar = m_view->verticalScrollBar();
+        const bool atBottom = bar->value() >= bar->maximum();
+        m_model->append(lines, dropped);
+        if (atBottom)
+            m_view->scrollToBottom();
+        updateStatus();
+    });
+    connect(m_tail, &JournalTail::failed, this, [this]() {
+        m_failed = true;
+        updateStatus();
+    });
+    connect(m_clearButton, &DPushButton::clicked, this, [this]() {
+        m_model->clear();
+        updateStatus();
+    });
+    connect(m_closeButton, &DPushButton::clicked, this, &ServiceLogWidget::hide);
+}
+
+QString ServiceLogWidget::unit() const
+{
+    return m_unit;
+}
+
+void ServiceLogWidget::follow(const QString &unit)
+{
+    if (unit == m_unit && m_tail->isFollowing())
+        return;
+
+    m_unit = unit;
+    m_failed = false;
+    m_model->clear();
+    m_titleLabel->setText(DApplication::translate("Service.Log", "Log of %1").arg(unit));
+    if (isVisible())
+        m_tail->follow(unit);
+    updateStatus();
+}
+
+void ServiceLogWidget::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    // lines of while hidden are read back from the tail
+    if (!m_unit.isEmpty() && !m_tail->isFollowing()) {
+        m_model->clear();
+        m_failed = false;
+        m_tail->follow(m_unit);
+        updateStatus();
+    }
+}
+
+void ServiceLogWidget::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    m_tail->stop();
+}
+
+void ServiceLogWidget::updateStatus()
+{
+    if (m_failed) {
+        m_statusLabel->setText(DApplication::translate("Service.Log", "The journal can't be read"));
+    } else if (m_model->droppedCount() > 0) {
+        m_statusLabel->setText(DApplication::translate("Service.Log", "%1 lines skipped, logged faster than they can be shown")
+                               .arg(m_model->droppedCount()));
+    } else if (m_model->rowCount() == 0) {
+        // journals of system services are readable by the adm & systemd-journal groups only
+        m_statusLabel->setText(DApplication::translate("Service.Log", "Nothing logged, or the journal isn't readable by you"));
+    } else {
+        m_statusLabel->clear();
+    }
+}
@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SERVICE_LOG_WIDGET_H
+#define SERVICE_LOG_WIDGET_H
+
+#include <DLabel>
+#include <DPushButton>
+
+#include <QWidget>
+
+DWIDGET_USE_NAMESPACE
+
+class JournalModel;
+class JournalTail;
+class QListView;
+
+/**
+ * @brief Journal of a service followed below the service table
+ *
+ * Lines come in batches & only the rows on screen are laid out & painted, so a service logging
+ * thousands of lines a second doesn't stall the ui. Stays at the newest line unless scrolled up.
+ */
+class ServiceLogWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ServiceLogWidget(QWidget *parent = nullptr);
+
+    /**
+     * @brief Show the log of \a unit, e.g. dbus.service, & follow it while shown
+     */
+    void follow(const QString &unit);
+    QString unit() const;
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void updateStatus();
+
+    JournalTail *m_tail {};
+    JournalModel *m_model {};
+    QListView *m_view {};
+    DLabel *m_titleLabel {};
+    DLabel *m_statusLabel {};
+    DPushButton *m_clearButton {};
+    DPushButton *m_closeButton {};
+    QString m_unit;
+    bool m_failed {false};
+};
+
+#endif // SERVICE_LOG_WIDGET_H
@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "socket_page_widget.h"
+#include "application.h"
+#include "main_window.h"
+#include "toolbar.h"
+#include "base/base_table_view.h"
+#include "model/socket_table_model.h"
+#include "system/demand_tracker.h"
+#include "ddlog.h"
+
+#include <DApplication>
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+#include <DApplicationHelper>
+#else
+#include <DGuiApplicationHelper>
+#endif
+
+#include <QHeaderView>
+#include <QPainter>
+#include <QPainterPath>
+#include <QVBoxLayout>
+
+using namespace DDLog;
+using namespace core::system;
+
+// a dump of 200k sockets with tcp_info takes a while, no point in refreshing faster
+#define SOCKET_PAGE_REFRESH_INTERVAL 3000
+
+SocketPageWidget::SocketPageWidget(DWidget *parent)
+    : DFrame(parent)
+{
+    qCDebug(app) << "SocketPageWidget created";
+    // content margin
+    int margin = 10;
+
+    m_model = new SocketTableModel(this);
+
+    m_view = new BaseTableView(this);
+    // rows are laid out without asking each one for its height
+    m_view->setUniformRowHeights(true);
+    m_view->setModel(m_model);
+    m_view->header()->resizeSection(SocketTableModel::kSocketLocalAddrColumn, 220);
+    m_view->header()->resizeSection(SocketTableModel::kSocketRemoteAddrColumn, 220);
+    m_view->header()->resizeSection(SocketTableModel::kSocketProcessColumn, 180);
+    m_view->setSortingEnabled(true);
+    m_view->sortByColumn(SocketTableModel::kSocketStateColumn, Qt::AscendingOrder);
+
+    m_statusLabel = new DLabel(this);
+    m_statusLabel->setToolTip(DApplication::translate("Socket.Page", "Filter with the search box, e.g. state:listen port:443 rtt>50 nginx"));
+
+    auto *layout = new QVBoxLayout(this);
+    layout->addWidget(m_statusLabel);
+    layout->addWidget(m_view);
+    layout->setContentsMargins(margin, margin, margin, margin);
+    setLayout(layout);
+
+    connect(m_model, &SocketTableModel::refreshed, this, &SocketPageWidget::updateStatus);
+    connect(gApp->mainWindow()->toolbar(), &Toolbar::search, this, &SocketPageWidget::search);
+    m_timer.setInterval(SOCKET_PAGE_REFRESH_INTERVAL);
+    connect(&m_timer, &QTimer::timeout, m_model, &SocketTableModel::refresh);
+    updateStatus();
+}
+
+SocketPageWidget::~SocketPageWidget()
+{
+    // qCDebug(app) << "SocketPageWidget destroyed";
+}
+
+void SocketPageWidget::showEvent(QShowEvent *event)
+{
+    DFrame::showEvent(event);
+    DemandTracker::instance()->setVisible(m_model, true);
+    m_model->refresh();
+    m_timer.start();
+}
+
+void SocketPageWidget::hideEvent(QHideEvent *event)
+{
+    DFrame::hideEvent(event);
+    DemandTracker::instance()->setVisible(m_model, false);
+    m_timer.stop();
+    // a few hundred thousand rows are not kept around while nobody looks at them
+    m_model->stop();
+}
+
+void SocketPageWidget::search(const QString &pattern)
+{
+    // cheap while hidden, the table is empty then
+    m_model->setFilter(SocketTableModel::parseFilter(pattern));
+}
+
+void SocketPageWidget::updateStatus()
+{
+    if (!m_model->isAvailable()) {
+        m_statusLabel->setText(DApplication::translate("Socket.Page", "Socket diagnostics (sock_diag) are not available"));
+        return;
+    }
+    if (m_model->filter().isEmpty()) {
+        m_statusLabel->setText(DApplication::translate("Socket.Page", "%1 sockets").arg(m_model->total()));
+        return;
+    }
+    m_statusLabel->setText(DApplication::translate("Socket.Page", "%1 of %2 sockets")
+                           .arg(m_model->rowCount()).arg(m_model->total()));
+}
+
+// paint event handler
+void SocketPageWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+
+    QPainterPath path;
+    path.addRect(QRectF(rect()));
+    painter.setOpacity(1);
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    auto palette = DApplicationHelper::instance()->applicationPalette();
+    auto bgColor = palette.color(DPalette::Background);
+#else
+    auto palette = DGuiApplicationHelper::instance()->applicationPalette();
+    auto bgColor = palette.color(DPalette::Window);
+#endif
+
+    // paint frame background
+    painter.fillPath(path, bgColor);
+}
@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SOCKET_PAGE_WIDGET_H
+#define SOCKET_PAGE_WIDGET_H
+
+#include <DFrame>
+#include <DLabel>
+#include <DWidget>
+
+#include <QTimer>
+
+DWIDGET_USE_NAMESPACE
+
+class BaseTableView;
+class SocketTableModel;
+
+/**
+ * @brief Sockets page, every tcp/udp socket of the system with its owner, like ss -tuanp
+ *
+ * Dumped only while shown, the search box filters, e.g. "state:listen port:443 rtt>50 nginx".
+ */
+class SocketPageWidget : public DFrame
+{
+    Q_OBJECT
+
+public:
+    explicit SocketPageWidget(DWidget *parent = nullptr);
+    ~SocketPageWidget() override;
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    void search(const QString &pattern);
+    void updateStatus();
+
+    SocketTableModel *m_model {};
+    BaseTableView *m_view {};
+    DLabel *m_statusLabel {};
+    QTimer m_timer;
+};
+
+#endif // SOCKET_PAGE_WIDGET_H
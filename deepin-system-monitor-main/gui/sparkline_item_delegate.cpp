@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "sparkline_item_delegate.h"
+#include "model/fleet_monitor.h"
+
+#include <QPainter>
+#include <QPainterPath>
+#include <QStyle>
+#include <QStyleOptionViewItem>
+
+// space between the value & the line, & around the line
+const int kSparklineMargin = 6;
+// widest value text, the lines of a column start at the same x
+const char *const kWidestValue = "100.0%";
+
+SparklineItemDelegate::SparklineItemDelegate(int historyRole, QObject *parent)
+    : BaseItemDelegate(parent)
+    , m_historyRole(historyRole)
+{
+}
+
+void SparklineItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                                  const QModelIndex &index) const
+{
+    BaseItemDelegate::paint(painter, option, index);
+
+    const QVector<qreal> history = index.data(m_historyRole).value<QVector<qreal>>();
+    if (history.size() < 2)
+        return;
+
+    const int valueWidth = option.fontMetrics.horizontalAdvance(kWidestValue);
+    const QRectF rect = QRectF(option.rect).adjusted(valueWidth + 2 * kSparklineMargin, kSparklineMargin,
+                                                     -kSparklineMargin, -kSparklineMargin);
+    if (rect.width() < 2 * kSparklineMargin || rect.height() <= 0)
+        return;
+
+    // a full ring spans the cell, percents are drawn against 0..100
+    const qreal step = rect.width() / (FleetHostState::kHistorySize - 1);
+    const qreal x0 = rect.right() - step * (history.size() - 1);
+    QPainterPath path;
+    for (int i = 0; i < history.size(); ++i) {
+        const qreal y = rect.bottom() - rect.height() * qBound(0., history[i], 100.) / 100.;
+        const QPointF point(x0 + step * i, y);
+        if (i == 0)
+            path.moveTo(point);
+        else
+            path.lineTo(point);
+    }
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    QColor color = option.palette.highlight().color();
+    if (option.state & QStyle::State_Selected)
+        color = option.palette.highlightedText().color();
+    painter->setPen(QPen(color, 1.5));
+    painter->drawPath(path);
+    painter->restore();
+}
@@ -0,0 +1,31 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SPARKLINE_ITEM_DELEGATE_H
+#define SPARKLINE_ITEM_DELEGATE_H
+
+#include "base/base_item_delegate.h"
+
+/**
+ * @brief Item delegate painting the current value followed by a sparkline of its history
+ *
+ * The history is a QVector<qreal> of percents, oldest first, read from \a historyRole. A cell
+ * is one polyline, cheap enough for a hundred rows refreshed every second.
+ */
+class SparklineItemDelegate : public BaseItemDelegate
+{
+    Q_OBJECT
+
+public:
+    explicit SparklineItemDelegate(int historyRole, QObject *parent = nullptr);
+
+    void paint(QPainter *painter,
+               const QStyleOptionViewItem &option,
+               const QModelIndex &index) const override;
+
+private:
+    int m_historyRole;
+};
+
+#endif // SPARKLINE_ITEM_DELEGATE_H
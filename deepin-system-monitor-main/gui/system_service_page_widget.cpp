@@ -7,6 +7,7 @@
 
 #include "main_window.h"
 #include "system_service_table_view.h"
+#include "service_log_widget.h"
 #include "ddlog.h"
 
 #include <DApplication>
@@ -18,6 +19,7 @@
 #include <DStyle>
 
 #include <QHBoxLayout>
+#include <QSplitter>
 #include <QPainterPath>
 
 using namespace DDLog;
@@ -43,7 +45,26 @@ SystemServicePageWidget::SystemServicePageWidget(DWidget *parent)
     auto *layout = new QHBoxLayout(this);
     // service table view instance
     m_svcTableView = new SystemServiceTableView(this);
-    layout->addWidget(m_svcTableView);
+    // journal pane below the table
+    m_logWidget = new ServiceLogWidget(this);
+    m_logWidget->hide();
+    auto *splitter = new QSplitter(Qt::Vertical, this);
+    splitter->setChildrenCollapsible(false);
+    splitter->addWidget(m_svcTableView);
+    splitter->addWidget(m_logWidget);
+    splitter->setStretchFactor(0, 3);
+    splitter->setStretchFactor(1, 2);
+    layout->addWidget(splitter);
+
+    connect(m_svcTableView, &SystemServiceTableView::serviceLogRequested, this, [this](const QString &unit) {
+        m_logWidget->follow(unit);
+        m_logWidget->show();
+    });
+    // the shown log follows the selection
+    connect(m_svcTableView, &SystemServiceTableView::serviceSelected, this, [this](const QString &unit) {
+        if (m_logWidget->isVisible())
+            m_logWidget->follow(unit);
+    });
     layout->setContentsMargins(margin, margin, margin, margin);
     setLayout(layout);
 }
@@ -13,6 +13,7 @@ DWIDGET_USE_NAMESPACE
 
 class MainWindow;
 class SystemServiceTableView;
+class ServiceLogWidget;
 
 /**
  * @brief Service background frame widget
@@ -44,6 +45,8 @@ Q_SIGNALS:
 private:
     // Service table view instance
     SystemServiceTableView *m_svcTableView {};
+    // Journal of the selected service, hidden until asked for
+    ServiceLogWidget *m_logWidget {};
 };
 
 #endif  // SYSTEM_SERVICE_PAGE_WIDGET_H
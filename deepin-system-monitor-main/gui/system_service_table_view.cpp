@@ -9,7 +9,11 @@
 #include "main_window.h"
 #include "dialog/error_dialog.h"
 #include "service_name_sub_input_dialog.h"
+#include "service_dependency_dialog.h"
+#include "resource_limit_dialog.h"
 #include "common/error_context.h"
+#include "common/task_executor.h"
+#include "common/cgroup_stats.h"
 #include "settings.h"
 #include "toolbar.h"
 #include "ddlog.h"
@@ -19,8 +23,10 @@
 
 #include "dbus/systemd1_unit_interface.h"
 
+#include "service/service_dependency_graph.h"
 #include "service/service_manager.h"
 #include "service/system_service_entry.h"
+#include "system/demand_tracker.h"
 
 #include <DApplication>
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -37,12 +43,13 @@
 #include <DSpinner>
 
 #include <QScrollBar>
-#include <QtConcurrent>
 #include <QKeyEvent>
 #include <QShortcut>
 #include <QDebug>
 
 using namespace DDLog;
+using namespace common::cgroup;
+using common::core::TaskExecutor;
 DWIDGET_USE_NAMESPACE
 
 // service table view backup setting key
@@ -64,6 +71,7 @@ SystemServiceTableView::SystemServiceTableView(DWidget *parent)
     m_proxyModel = new SystemServiceSortFilterProxyModel(this);
     m_proxyModel->setSourceModel(m_model);
     setModel(m_proxyModel);
+    m_dependencyGraph = new ServiceDependencyGraph(this);
 
     // load backup settings
     bool settingsLoaded = loadSettings();
@@ -194,7 +202,7 @@ void SystemServiceTableView::startService()
         gApp->backgroundTaskStateChanged(Application::kTaskFinished);
         watcher->deleteLater();
     });
-    QFuture<ErrorContext> fu = QtConcurrent::run([mgr, sname]() {
+    QFuture<ErrorContext> fu = TaskExecutor::instance()->run(TaskExecutor::kIOTask, [mgr, sname]() {
         auto ec = mgr->startService(sname);
         return ec;
     });
@@ -261,7 +269,7 @@ void SystemServiceTableView::stopService()
         gApp->backgroundTaskStateChanged(Application::kTaskFinished);
         watcher->deleteLater();
     });
-    QFuture<ErrorContext> fu = QtConcurrent::run([mgr, sname]() {
+    QFuture<ErrorContext> fu = TaskExecutor::instance()->run(TaskExecutor::kIOTask, [mgr, sname]() {
         auto ec = mgr->stopService(sname);
         return ec;
     });
@@ -330,7 +338,7 @@ void SystemServiceTableView::restartService()
         gApp->backgroundTaskStateChanged(Application::kTaskFinished);
         watcher->deleteLater();
     });
-    QFuture<ErrorContext> fu = QtConcurrent::run([mgr, sname]() {
+    QFuture<ErrorContext> fu = TaskExecutor::instance()->run(TaskExecutor::kIOTask, [mgr, sname]() {
         auto ec = mgr->restartService(sname);
         return ec;
     });
@@ -371,7 +379,7 @@ void SystemServiceTableView::setServiceStartupMode(bool autoStart)
         gApp->backgroundTaskStateChanged(Application::kTaskFinished);
         watcher->deleteLater();
     });
-    QFuture<ErrorContext> fu = QtConcurrent::run([mgr, sname, autoStart]() {
+    QFuture<ErrorContext> fu = TaskExecutor::instance()->run(TaskExecutor::kIOTask, [mgr, sname, autoStart]() {
         auto ec = mgr->setServiceStartupMode(sname, autoStart);
         return ec;
     });
@@ -406,6 +414,11 @@ void SystemServiceTableView::refreshServiceStatus(const QString sname)
 
     auto sn = mgr->normalizeServiceId(sname);
     auto o = Systemd1UnitInterface::normalizeUnitPath(sn);
+    // state changes to come are told by unit signals, no need to pull them
+    if (mgr->isWatchingUnits()) {
+        mgr->refreshServiceEntry(o.path());
+        return;
+    }
     // get refreshed service entry
     auto entry = mgr->updateServiceEntry(o.path());
 
@@ -417,6 +430,23 @@ void SystemServiceTableView::refreshServiceStatus(const QString sname)
     }
 }
 
+// ask details of the rows shown before the others
+void SystemServiceTableView::prioritizeVisibleServices()
+{
+    int rows = m_proxyModel->rowCount();
+    if (rows <= 0)
+        return;
+
+    auto top = indexAt(viewport()->rect().topLeft());
+    auto bottom = indexAt(viewport()->rect().bottomLeft());
+    int first = top.isValid() ? top.row() : 0;
+    int last = bottom.isValid() ? bottom.row() : rows - 1;
+    QStringList snames;
+    for (int row = first; row <= last; ++row)
+        snames << m_proxyModel->index(row, SystemServiceTableModel::kSystemServiceNameColumn).data().toString();
+    ServiceManager::instance()->prioritizeServices(snames);
+}
+
 // filter service on specific pattern
 void SystemServiceTableView::search(const QString &pattern)
 {
@@ -446,6 +476,25 @@ void SystemServiceTableView::resizeEvent(QResizeEvent *event)
     BaseTableView::resizeEvent(event);
 }
 
+// service usage is sampled only while the services page is shown
+void SystemServiceTableView::showEvent(QShowEvent *event)
+{
+    BaseTableView::showEvent(event);
+    if (m_model) {
+        m_model->setUsageSampling(true);
+        core::system::DemandTracker::instance()->setVisible(m_model, true);
+    }
+}
+
+void SystemServiceTableView::hideEvent(QHideEvent *event)
+{
+    if (m_model) {
+        m_model->setUsageSampling(false);
+        core::system::DemandTracker::instance()->setVisible(m_model, false);
+    }
+    BaseTableView::hideEvent(event);
+}
+
 // selection changed handler
 void SystemServiceTableView::selectionChanged(const QItemSelection &selected,
                                               const QItemSelection &deselected)
@@ -461,6 +510,8 @@ void SystemServiceTableView::selectionChanged(const QItemSelection &selected,
                       .value(SystemServiceTableModel::kSystemServiceNameColumn)
                       .data();
     qCDebug(app) << "Selected service changed to:" << m_selectedSName.toString();
+    if (m_selectedSName.isValid())
+        Q_EMIT serviceSelected(ServiceManager::instance()->normalizeServiceId(m_selectedSName.toString()));
 
     BaseTableView::selectionChanged(selected, deselected);
 }
@@ -532,6 +583,14 @@ void SystemServiceTableView::initUI(bool settingsLoaded)
         setColumnHidden(SystemServiceTableModel::kSystemServiceDescriptionColumn, false);
         setColumnWidth(SystemServiceTableModel::kSystemServicePIDColumn, 100);
         setColumnHidden(SystemServiceTableModel::kSystemServicePIDColumn, true);
+        setColumnWidth(SystemServiceTableModel::kSystemServiceCPUColumn, 70);
+        setColumnHidden(SystemServiceTableModel::kSystemServiceCPUColumn, false);
+        setColumnWidth(SystemServiceTableModel::kSystemServiceMemoryColumn, 90);
+        setColumnHidden(SystemServiceTableModel::kSystemServiceMemoryColumn, false);
+        setColumnWidth(SystemServiceTableModel::kSystemServiceDiskIOColumn, 90);
+        setColumnHidden(SystemServiceTableModel::kSystemServiceDiskIOColumn, true);
+        setColumnWidth(SystemServiceTableModel::kSystemServiceTasksColumn, 70);
+        setColumnHidden(SystemServiceTableModel::kSystemServiceTasksColumn, true);
         sortByColumn(SystemServiceTableModel::kSystemServiceNameColumn, Qt::AscendingOrder);
     }
 
@@ -557,6 +616,15 @@ void SystemServiceTableView::initUI(bool settingsLoaded)
         m_contextMenu->addMenu(DApplication::translate("Service.Table.Context.Menu", "Startup type"));
     m_setAutoStartAction = m_setServiceStartupModeMenu->addAction(DApplication::translate("Service.Table.Context.Menu", "Auto"));
     m_setManualStartAction = m_setServiceStartupModeMenu->addAction(DApplication::translate("Service.Table.Context.Menu", "Manual"));
+    // service dependencies action
+    m_dependenciesAction =
+        m_contextMenu->addAction(DApplication::translate("Service.Table.Context.Menu", "Dependencies"));
+    // runtime cgroup limits action
+    m_limitAction =
+        m_contextMenu->addAction(DApplication::translate("Service.Table.Context.Menu", "Limit resources..."));
+    // service journal action
+    m_logAction =
+        m_contextMenu->addAction(DApplication::translate("Service.Table.Context.Menu", "Log"));
     // refresh context menu item
     m_refreshAction =
         m_contextMenu->addAction(DApplication::translate("Service.Table.Context.Menu", "Refresh"));
@@ -593,6 +661,22 @@ void SystemServiceTableView::initUI(bool settingsLoaded)
     m_startupModeHeaderAction = m_headerContextMenu->addAction(
                                     DApplication::translate("Service.Table.Header", kSystemServiceStartupMode));
     m_startupModeHeaderAction->setCheckable(true);
+    // cpu usage column
+    m_cpuHeaderAction = m_headerContextMenu->addAction(
+                                    DApplication::translate("Service.Table.Header", kSystemServiceCPU));
+    m_cpuHeaderAction->setCheckable(true);
+    // memory usage column
+    m_memoryHeaderAction = m_headerContextMenu->addAction(
+                                    DApplication::translate("Service.Table.Header", kSystemServiceMemory));
+    m_memoryHeaderAction->setCheckable(true);
+    // disk io rate column
+    m_diskIOHeaderAction = m_headerContextMenu->addAction(
+                                    DApplication::translate("Service.Table.Header", kSystemServiceDiskIO));
+    m_diskIOHeaderAction->setCheckable(true);
+    // task count column
+    m_tasksHeaderAction = m_headerContextMenu->addAction(
+                                    DApplication::translate("Service.Table.Header", kSystemServiceTasks));
+    m_tasksHeaderAction->setCheckable(true);
 
     // set default checkable state when backup settings load without success
     if (!settingsLoaded) {
@@ -602,6 +686,10 @@ void SystemServiceTableView::initUI(bool settingsLoaded)
         m_stateHeaderAction->setChecked(true);
         m_descriptionHeaderAction->setChecked(true);
         m_pidHeaderAction->setChecked(false);
+        m_cpuHeaderAction->setChecked(true);
+        m_memoryHeaderAction->setChecked(true);
+        m_diskIOHeaderAction->setChecked(false);
+        m_tasksHeaderAction->setChecked(false);
     }
 
     // refresh service table shortcut
@@ -690,6 +778,15 @@ void SystemServiceTableView::initConnections()
     connect(m_setManualStartAction, &QAction::triggered, this, [ = ]() { setServiceStartupMode(false); });
     // call refresh handler when refresh menu item triggered
     connect(m_refreshAction, &QAction::triggered, this, &SystemServiceTableView::refresh);
+    // show dependency tree when dependencies menu item triggered
+    connect(m_dependenciesAction, &QAction::triggered, this, &SystemServiceTableView::showDependencies);
+    // ask & set limits when limit resources menu item triggered
+    connect(m_limitAction, &QAction::triggered, this, &SystemServiceTableView::limitServiceResources);
+    // follow journal below the table when log menu item triggered
+    connect(m_logAction, &QAction::triggered, this, &SystemServiceTableView::showServiceLog);
+    // nodes of changed units are read again when shown next
+    connect(ServiceManager::instance(), &ServiceManager::serviceStatusUpdated, m_dependencyGraph,
+            [this](const SystemServiceEntry &entry) { m_dependencyGraph->invalidate(entry.getId()); });
 
     // change context menu item usable state based on service's current state when popup
     connect(m_contextMenu, &QMenu::aboutToShow, this, [ = ]() {
@@ -708,8 +805,14 @@ void SystemServiceTableView::initConnections()
                 } else {
                     m_setServiceStartupModeMenu->setEnabled(true);
                 }
+                // templates have no unit object to read dependencies from
+                m_dependenciesAction->setEnabled(!sname.endsWith("@"));
+                // nothing logs as a template
+                m_logAction->setEnabled(!sname.endsWith("@"));
 
                 auto activeState = m_model->getUnitActiveState(sourceIndex);
+                // only running services have a cgroup to limit
+                m_limitAction->setEnabled(CgroupStats::isAvailable() && !m_model->getControlGroup(sourceIndex).isEmpty());
                 if (isActiveState(activeState.toLocal8Bit())) {
                     m_startServiceAction->setEnabled(false);
                     m_stopServiceAction->setEnabled(true);
@@ -767,6 +870,26 @@ void SystemServiceTableView::initConnections()
         hdr->setSectionHidden(SystemServiceTableModel::kSystemServiceStartupModeColumn, !b);
         saveSettings();
     });
+    // swap cpu usage header section visible state, then backup setting
+    connect(m_cpuHeaderAction, &QAction::triggered, this, [ = ](bool b) {
+        hdr->setSectionHidden(SystemServiceTableModel::kSystemServiceCPUColumn, !b);
+        saveSettings();
+    });
+    // swap memory usage header section visible state, then backup setting
+    connect(m_memoryHeaderAction, &QAction::triggered, this, [ = ](bool b) {
+        hdr->setSectionHidden(SystemServiceTableModel::kSystemServiceMemoryColumn, !b);
+        saveSettings();
+    });
+    // swap disk io rate header section visible state, then backup setting
+    connect(m_diskIOHeaderAction, &QAction::triggered, this, [ = ](bool b) {
+        hdr->setSectionHidden(SystemServiceTableModel::kSystemServiceDiskIOColumn, !b);
+        saveSettings();
+    });
+    // swap task count header section visible state, then backup setting
+    connect(m_tasksHeaderAction, &QAction::triggered, this, [ = ](bool b) {
+        hdr->setSectionHidden(SystemServiceTableModel::kSystemServiceTasksColumn, !b);
+        saveSettings();
+    });
 
     // change header context menu item's checkable state based on current section's visible state
     connect(m_headerContextMenu, &QMenu::aboutToShow, this, [ = ]() {
@@ -785,6 +908,14 @@ void SystemServiceTableView::initConnections()
         m_descriptionHeaderAction->setChecked(!b);
         b = hdr->isSectionHidden(SystemServiceTableModel::kSystemServicePIDColumn);
         m_pidHeaderAction->setChecked(!b);
+        b = hdr->isSectionHidden(SystemServiceTableModel::kSystemServiceCPUColumn);
+        m_cpuHeaderAction->setChecked(!b);
+        b = hdr->isSectionHidden(SystemServiceTableModel::kSystemServiceMemoryColumn);
+        m_memoryHeaderAction->setChecked(!b);
+        b = hdr->isSectionHidden(SystemServiceTableModel::kSystemServiceDiskIOColumn);
+        m_diskIOHeaderAction->setChecked(!b);
+        b = hdr->isSectionHidden(SystemServiceTableModel::kSystemServiceTasksColumn);
+        m_tasksHeaderAction->setChecked(!b);
     });
 
     // connect refresh handler to refresh shortcut's activated signal
@@ -815,7 +946,7 @@ void SystemServiceTableView::initConnections()
         m_spinner->start();
         m_spinner->show();
     });
-    // hide tip label & spinner & reset loading state after service list updated
+    // hide tip label & spinner & reset loading state after service list updated, details are filled in later
     connect(m_model, &SystemServiceTableModel::modelReset, this, [ = ]() {
         header()->setEnabled(true);
 
@@ -824,7 +955,11 @@ void SystemServiceTableView::initConnections()
         m_spinner->stop();
 
         m_loading = false;
+        prioritizeVisibleServices();
     });
+    // rows shown get their details first
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, this, &SystemServiceTableView::prioritizeVisibleServices);
+    connect(m_proxyModel, &QAbstractItemModel::layoutChanged, this, &SystemServiceTableView::prioritizeVisibleServices);
 
     // we need override currentRowChanged method to overcome incremental service list fetch glitch, if user use [down] key
     // to move current select item and next item is right out side of tableview's viewport region, then we need call fetch
@@ -887,6 +1022,73 @@ void SystemServiceTableView::refresh()
     ServiceManager::instance()->updateServiceList();
 }
 
+// show dependency tree of the selected service
+void SystemServiceTableView::showDependencies()
+{
+    if (!m_selectedSName.isValid()) {
+        qCDebug(app) << "No service selected for dependencies";
+        return;
+    }
+
+    auto unit = ServiceManager::instance()->normalizeServiceId(m_selectedSName.toString());
+    qCDebug(app) << "Showing dependencies of" << unit;
+    auto *dialog = new ServiceDependencyDialog(unit, m_dependencyGraph, this);
+    dialog->show();
+}
+
+// follow journal of the selected service
+void SystemServiceTableView::showServiceLog()
+{
+    if (!m_selectedSName.isValid()) {
+        qCDebug(app) << "No service selected for log";
+        return;
+    }
+
+    Q_EMIT serviceLogRequested(ServiceManager::instance()->normalizeServiceId(m_selectedSName.toString()));
+}
+
+void SystemServiceTableView::limitServiceResources()
+{
+    const QModelIndexList rows = selectionModel()->selectedRows();
+    if (!m_selectedSName.isValid() || rows.isEmpty()) {
+        qCDebug(app) << "No service selected for limits";
+        return;
+    }
+
+    auto sname = m_selectedSName.toString();
+    resource_limits_t limits {RESOURCE_LIMIT_NONE, RESOURCE_LIMIT_NONE, RESOURCE_LIMIT_NONE};
+    CgroupStats::readLimits(m_model->getControlGroup(m_proxyModel->mapToSource(rows[0])), limits);
+    ResourceLimitDialog dialog(DApplication::translate("Resource.Limit.Dialog", "Limit resources of %1").arg(sname), limits, this);
+    dialog.exec();
+    if (dialog.result() != QMessageBox::Ok) {
+        qCDebug(app) << "User cancelled limiting service" << sname;
+        return;
+    }
+
+    auto *mgr = ServiceManager::instance();
+    Q_ASSERT(mgr != nullptr);
+    limits = dialog.limits();
+
+    // the authorization dialog may take a while, set limits in asynchronize way
+    auto *watcher = new QFutureWatcher<ErrorContext>();
+    connect(watcher, &QFutureWatcher<ErrorContext>::finished, this, [mgr, watcher, sname]() {
+        // the usage columns show the new limits on their next sample
+        if (watcher->result()) {
+            qCWarning(app) << "Failed to limit service:" << sname << "-" << watcher->result().getErrorName() << "-" << watcher->result().getErrorMessage();
+            Q_EMIT mgr->errorOccurred(watcher->result());
+        } else {
+            qCDebug(app) << "Limits set for service:" << sname;
+        }
+        gApp->backgroundTaskStateChanged(Application::kTaskFinished);
+        watcher->deleteLater();
+    });
+    QFuture<ErrorContext> fu = TaskExecutor::instance()->run(TaskExecutor::kIOTask, [mgr, sname, limits]() {
+        return mgr->setServiceLimits(sname, limits);
+    });
+    gApp->backgroundTaskStateChanged(Application::kTaskStarted);
+    watcher->setFuture(fu);
+}
+
 // event filter
 bool SystemServiceTableView::eventFilter(QObject *obj, QEvent *event)
 {
@@ -19,6 +19,7 @@ class SystemServiceTableModel;
 class SystemServiceEntry;
 class MainWindow;
 class ServiceManager;
+class ServiceDependencyGraph;
 class QShortcut;
 
 /**
@@ -78,6 +79,30 @@ public Q_SLOTS:
      * @brief Refresh service table
      */
     void refresh();
+    /**
+     * @brief Show dependency tree of the selected service
+     */
+    void showDependencies();
+    /**
+     * @brief Limit cpu, memory & io of the selected service without restarting it
+     */
+    void limitServiceResources();
+    /**
+     * @brief Ask for the journal of the selected service
+     */
+    void showServiceLog();
+
+Q_SIGNALS:
+    /**
+     * @brief Journal of a service asked for from the context menu
+     * @param unit Unit id, e.g. dbus.service
+     */
+    void serviceLogRequested(const QString &unit);
+    /**
+     * @brief Another service got selected
+     * @param unit Unit id
+     */
+    void serviceSelected(const QString &unit);
 
 protected Q_SLOTS:
     /**
@@ -122,6 +147,16 @@ protected:
      * @param event Resize event
      */
     void resizeEvent(QResizeEvent *event) override;
+    /**
+     * @brief showEvent Show event handler, starts sampling service usage
+     * @param event Show event
+     */
+    void showEvent(QShowEvent *event) override;
+    /**
+     * @brief hideEvent Hide event handler, stops sampling service usage
+     * @param event Hide event
+     */
+    void hideEvent(QHideEvent *event) override;
     /**
      * @brief selectionChanged Selection change event handler
      * @param selected Selected item
@@ -150,6 +185,10 @@ private:
      * @param sname Servcie name
      */
     inline void refreshServiceStatus(const QString sname);
+    /**
+     * @brief Ask details of the rows shown before the others, while the service list is filled in
+     */
+    void prioritizeVisibleServices();
 
 private:
     // Service data model
@@ -183,6 +222,12 @@ private:
     QAction *m_setManualStartAction         {};
     // Refresh service table action
     QAction *m_refreshAction                {};
+    // Service dependencies action
+    QAction *m_dependenciesAction           {};
+    // Limit service resources action
+    QAction *m_limitAction                  {};
+    // Service journal action
+    QAction *m_logAction                    {};
     // Service load state action
     QAction *m_loadStateHeaderAction        {};
     // Service active state action
@@ -197,6 +242,14 @@ private:
     QAction *m_pidHeaderAction              {};
     // Service startup mode action
     QAction *m_startupModeHeaderAction      {};
+    // Service cpu usage action
+    QAction *m_cpuHeaderAction              {};
+    // Service memory usage action
+    QAction *m_memoryHeaderAction           {};
+    // Service disk io rate action
+    QAction *m_diskIOHeaderAction           {};
+    // Service task count action
+    QAction *m_tasksHeaderAction            {};
 
     // Refresh shortcut
     QShortcut *m_refreshKP      {};
@@ -207,6 +260,9 @@ private:
     // Restart service shortcut
     QShortcut *m_restartKP      {};
 
+    // Dependency nodes read so far, shared by the dependency dialogs
+    ServiceDependencyGraph *m_dependencyGraph {};
+
     // Service loading status flag
     bool m_loading {false};
 };
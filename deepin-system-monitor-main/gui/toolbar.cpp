@@ -39,7 +39,7 @@ Toolbar::Toolbar(QWidget *parent)
 
     // tab button group
     m_switchFuncTabBtnGrp = new CustomButtonBox(this);
-    m_switchFuncTabBtnGrp->setFixedWidth(240);
+    m_switchFuncTabBtnGrp->setFixedWidth(400);
     // process tab button instance
     m_procBtn = new DButtonBoxButton(
         DApplication::translate("Title.Bar.Switch", "Processes"), m_switchFuncTabBtnGrp);
@@ -63,7 +63,20 @@ Toolbar::Toolbar(QWidget *parent)
 
     DFontSizeManager::instance()->bind(m_accountProcBtn, DFontSizeManager::T7, QFont::Medium);
     QList<DButtonBoxButton *> list;
-    list << m_procBtn << m_svcBtn << m_accountProcBtn;
+    m_fleetBtn = new DButtonBoxButton(
+        DApplication::translate("Title.Bar.Switch", "Hosts"), m_switchFuncTabBtnGrp);
+    m_fleetBtn->setCheckable(true);
+    m_fleetBtn->setFocusPolicy(Qt::TabFocus);
+
+    DFontSizeManager::instance()->bind(m_fleetBtn, DFontSizeManager::T7, QFont::Medium);
+    m_socketBtn = new DButtonBoxButton(
+        DApplication::translate("Title.Bar.Switch", "Sockets"), m_switchFuncTabBtnGrp);
+    m_socketBtn->setCheckable(true);
+    m_socketBtn->setFocusPolicy(Qt::TabFocus);
+
+    DFontSizeManager::instance()->bind(m_socketBtn, DFontSizeManager::T7, QFont::Medium);
+
+    list << m_procBtn << m_svcBtn << m_accountProcBtn << m_fleetBtn << m_socketBtn;
     m_switchFuncTabBtnGrp->setButtonList(list, true);
 
     // move focus to process tab button when toolbar got focus
@@ -73,6 +86,8 @@ Toolbar::Toolbar(QWidget *parent)
     m_procBtn->installEventFilter(this);
     m_svcBtn->installEventFilter(this);
     m_accountProcBtn->installEventFilter(this);
+    m_fleetBtn->installEventFilter(this);
+    m_socketBtn->installEventFilter(this);
 
     // emit button clicked signal when process or service tab button toggled
     connect(m_procBtn, &DButtonBoxButton::toggled, this, [ = ](bool checked) {
@@ -87,6 +102,14 @@ Toolbar::Toolbar(QWidget *parent)
         qCDebug(app) << "account process tab button toggled:" << checked;
         Q_EMIT accountProcTabButtonClicked();
     });
+    connect(m_fleetBtn, &DButtonBoxButton::toggled, this, [ = ](bool checked) {
+        qCDebug(app) << "fleet tab button toggled:" << checked;
+        Q_EMIT fleetTabButtonClicked();
+    });
+    connect(m_socketBtn, &DButtonBoxButton::toggled, this, [ = ](bool checked) {
+        qCDebug(app) << "socket tab button toggled:" << checked;
+        Q_EMIT socketTabButtonClicked();
+    });
     // search text editor instance
     searchEdit = new DSearchEdit(this);
     // set the search edit text max length
@@ -116,11 +139,15 @@ Toolbar::Toolbar(QWidget *parent)
             m_procBtn->setEnabled(false);
             m_svcBtn->setEnabled(false);
             m_accountProcBtn->setEnabled(false);
+            m_fleetBtn->setEnabled(false);
+            m_socketBtn->setEnabled(false);
             searchEdit->setEnabled(false);
         } else {
             m_procBtn->setEnabled(true);
             m_svcBtn->setEnabled(true);
             m_accountProcBtn->setEnabled(true);
+            m_fleetBtn->setEnabled(true);
+            m_socketBtn->setEnabled(true);
             searchEdit->setEnabled(true);
         }
     });
@@ -178,6 +205,22 @@ bool Toolbar::eventFilter(QObject *obj, QEvent *event)
                 m_accountProcBtn->setFocus();
                 return true;
             }
+        } else if (obj == m_fleetBtn) {
+            // set focus to account process tab button when left key pressed
+            auto *kev = dynamic_cast<QKeyEvent *>(event);
+            if (kev->key() == Qt::Key_Left) {
+                qCDebug(app) << "Left key pressed on fleet button";
+                m_accountProcBtn->setFocus();
+                return true;
+            }
+        } else if (obj == m_socketBtn) {
+            // set focus to fleet tab button when left key pressed
+            auto *kev = dynamic_cast<QKeyEvent *>(event);
+            if (kev->key() == Qt::Key_Left) {
+                qCDebug(app) << "Left key pressed on socket button";
+                m_fleetBtn->setFocus();
+                return true;
+            }
         }
     }  
 
@@ -109,6 +109,14 @@ Q_SIGNALS:
      * @brief User Procss tab button triggered signal
      */
     void accountProcTabButtonClicked();
+    /**
+     * @brief Hosts tab button triggered signal
+     */
+    void fleetTabButtonClicked();
+    /**
+     * @brief Sockets tab button triggered signal
+     */
+    void socketTabButtonClicked();
 
 private:
     // Button group
@@ -119,6 +127,10 @@ private:
     DButtonBoxButton *m_svcBtn {nullptr};
     // User Process tab button
     DButtonBoxButton *m_accountProcBtn {nullptr};
+    // Hosts tab button
+    DButtonBoxButton *m_fleetBtn {nullptr};
+    // Sockets tab button
+    DButtonBoxButton *m_socketBtn {nullptr};
     // Search text input
     DSearchEdit *searchEdit {nullptr};
 
@@ -0,0 +1,118 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "virtualization_view_widget.h"
+#include "chart_view_widget.h"
+#include "model/cpu_info_model.h"
+#include "model/model_manager.h"
+#include "model/sample_history.h"
+#include "model/update_coordinator.h"
+#include "process/process_db.h"
+#include "process/process_set.h"
+#include "system/cpu_set.h"
+#include "ddlog.h"
+
+#include <DFontSizeManager>
+
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+
+using namespace DDLog;
+using namespace core::process;
+using namespace core::system;
+
+#define VIRTUALIZATION_VIEW_HEIGHT 100
+
+VirtualizationViewWidget::VirtualizationViewWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    qCDebug(app) << "VirtualizationViewWidget constructor";
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    setFixedHeight(VIRTUALIZATION_VIEW_HEIGHT);
+
+    SampleHistory *history = ModelManager::instance()->sampleHistory();
+    m_chart = new ChartViewWidget(ChartViewWidget::ChartViewTypes::MEM_CHART, this);
+    m_chart->setData1Color(QColor("#FF5C5C"));
+    m_chart->setData2Color(QColor("#00C5C0"));
+    m_chart->setSeries1(&history->series(SampleHistory::kCpuSteal));
+    m_chart->setSeries2(&history->series(SampleHistory::kCpuGuest));
+    m_chart->setStoredSeries1(SampleHistory::kCpuSteal);
+    m_chart->setStoredSeries2(SampleHistory::kCpuGuest);
+    connect(history, &SampleHistory::updated, m_chart, &ChartViewWidget::updateSeries);
+
+    m_titleLabel = new DLabel(tr("Virtualization"), this);
+    m_titleLabel->setForegroundRole(DPalette::TextTips);
+    m_titleLabel->setToolTip(tr("Stolen: CPU time the hypervisor gave to others while this system "
+                                "wanted to run. Guests: CPU time spent running the virtual CPUs of "
+                                "guests on this host, also counted in user time, see the Guest CPU column"));
+    m_timeLabel = new DLabel(this);
+    m_topLabel = new DLabel(this);
+    m_topLabel->setForegroundRole(DPalette::TextTips);
+    DFontSizeManager::instance()->bind(m_titleLabel, DFontSizeManager::T8);
+    DFontSizeManager::instance()->bind(m_topLabel, DFontSizeManager::T8);
+
+    auto *textLayout = new QVBoxLayout();
+    textLayout->setContentsMargins(0, 0, 0, 0);
+    textLayout->addWidget(m_titleLabel);
+    textLayout->addWidget(m_timeLabel);
+    textLayout->addWidget(m_topLabel);
+    textLayout->addStretch();
+
+    auto *layout = new QHBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(16);
+    layout->addWidget(m_chart, 4);
+    layout->addLayout(textLayout, 2);
+
+    onModelUpdate();
+    connect(ModelManager::instance()->updateCoordinator(), &UpdateCoordinator::updateViews, this, &VirtualizationViewWidget::onModelUpdate);
+}
+
+void VirtualizationViewWidget::fontChanged(const QFont &font)
+{
+    qCDebug(app) << "VirtualizationViewWidget fontChanged";
+    m_timeLabel->setFont(font);
+}
+
+void VirtualizationViewWidget::onModelUpdate()
+{
+    const CPUSet *cpuSet = CPUInfoModel::instance()->cpuSet();
+    const qreal steal = cpuSet->stealPercent();
+    const qreal guest = cpuSet->guestPercent();
+    // stays once shown, guests come & go
+    m_seen = m_seen || steal > 0 || guest > 0;
+    setVisible(m_seen);
+    if (!m_seen)
+        return;
+
+    m_timeLabel->setText(tr("Stolen %1%, guests %2%").arg(steal, 0, 'f', 1).arg(guest, 0, 'f', 1));
+
+    // guests of libvirt by name, summed over their qemu processes, other qemus by process
+    const ProcessSnapshotPtr snapshot = ProcessDB::instance()->processSet()->snapshot();
+    QString topName;
+    qreal topGuest = 0;
+    for (const ContainerUsage &usage : *snapshot->containers) {
+        if (usage.identity.kind != ContainerIdentity::kVirtualMachine)
+            continue;
+        qreal sum = 0;
+        for (pid_t pid : usage.pids)
+            sum += snapshot->processes.value(pid).guestCpu();
+        if (sum > topGuest) {
+            topGuest = sum;
+            topName = usage.identity.id;
+        }
+    }
+    if (topName.isEmpty()) {
+        for (auto it = snapshot->processes.constBegin(); it != snapshot->processes.constEnd(); ++it) {
+            if (it->guestCpu() > topGuest) {
+                topGuest = it->guestCpu();
+                topName = it->displayName();
+            }
+        }
+    }
+    if (!topName.isEmpty())
+        m_topLabel->setText(tr("Most: %1, %2% guest").arg(topName).arg(topGuest, 0, 'f', 1));
+    else
+        m_topLabel->clear();
+}
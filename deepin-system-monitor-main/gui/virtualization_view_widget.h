@@ -0,0 +1,41 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef VIRTUALIZATION_VIEW_WIDGET_H
+#define VIRTUALIZATION_VIEW_WIDGET_H
+
+#include <DLabel>
+
+#include <QWidget>
+
+DWIDGET_USE_NAMESPACE
+
+class ChartViewWidget;
+
+/**
+ * @brief Steal & guest time in the cpu detail view
+ *
+ * Chart of the cpu time taken by the hypervisor this system runs under & of the time spent
+ * running the virtual cpus of our own guests, next to the guest using the most of it. Hidden
+ * until either was seen, bare metal hosts without guests never show it.
+ */
+class VirtualizationViewWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit VirtualizationViewWidget(QWidget *parent = nullptr);
+
+public slots:
+    void fontChanged(const QFont &font);
+    void onModelUpdate();
+
+private:
+    ChartViewWidget *m_chart;
+    DLabel *m_titleLabel;
+    DLabel *m_timeLabel;
+    DLabel *m_topLabel;
+    bool m_seen {false}; // steal or guest time was non zero once
+};
+
+#endif // VIRTUALIZATION_VIEW_WIDGET_H
@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "vm_activity_view_widget.h"
+#include "chart_view_widget.h"
+#include "common/common.h"
+#include "model/model_manager.h"
+#include "model/sample_history.h"
+#include "model/update_coordinator.h"
+#include "system/device_db.h"
+#include "system/device_snapshot.h"
+#include "ddlog.h"
+
+#include <DFontSizeManager>
+
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+
+using namespace DDLog;
+using namespace common::format;
+using namespace core::system;
+
+#define VM_ACTIVITY_VIEW_HEIGHT 100
+
+VmActivityViewWidget::VmActivityViewWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    qCDebug(app) << "VmActivityViewWidget constructor";
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    setFixedHeight(VM_ACTIVITY_VIEW_HEIGHT);
+
+    SampleHistory *history = ModelManager::instance()->sampleHistory();
+    m_swapChart = new ChartViewWidget(ChartViewWidget::ChartViewTypes::MEM_CHART, this);
+    m_swapChart->setSpeedAxis(true);
+    m_swapChart->setData1Color(QColor("#00C5C0"));
+    m_swapChart->setData2Color(QColor("#FEDF19"));
+    m_swapChart->setSeries1(&history->series(SampleHistory::kSwapIn));
+    m_swapChart->setSeries2(&history->series(SampleHistory::kSwapOut));
+    m_swapChart->setStoredSeries1(SampleHistory::kSwapIn);
+    m_swapChart->setStoredSeries2(SampleHistory::kSwapOut);
+    connect(history, &SampleHistory::updated, m_swapChart, &ChartViewWidget::updateSeries);
+
+    m_reclaimChart = new ChartViewWidget(ChartViewWidget::ChartViewTypes::MEM_CHART, this);
+    m_reclaimChart->setSpeedAxis(true);
+    m_reclaimChart->setData1Color(QColor("#00C5C0"));
+    m_reclaimChart->setData2Color(QColor("#FF7B00"));
+    m_reclaimChart->setSeries1(&history->series(SampleHistory::kReclaimKswapd));
+    m_reclaimChart->setSeries2(&history->series(SampleHistory::kReclaimDirect));
+    m_reclaimChart->setStoredSeries1(SampleHistory::kReclaimKswapd);
+    m_reclaimChart->setStoredSeries2(SampleHistory::kReclaimDirect);
+    connect(history, &SampleHistory::updated, m_reclaimChart, &ChartViewWidget::updateSeries);
+
+    m_titleLabel = new DLabel(tr("Paging"), this);
+    m_titleLabel->setForegroundRole(DPalette::TextTips);
+    m_titleLabel->setToolTip(tr("Left: swapped in / out. Right: scanned for reclaim by kswapd / by "
+                                "allocating tasks, which stall meanwhile. Steady swapping & direct "
+                                "reclaim mean memory is short, full memory without them is cache"));
+    m_faultLabel = new DLabel(this);
+    m_swapLabel = new DLabel(this);
+    m_reclaimLabel = new DLabel(this);
+    m_oomLabel = new DLabel(this);
+    m_oomLabel->setForegroundRole(DPalette::TextTips);
+    DFontSizeManager::instance()->bind(m_titleLabel, DFontSizeManager::T8);
+    DFontSizeManager::instance()->bind(m_oomLabel, DFontSizeManager::T8);
+
+    auto *textLayout = new QVBoxLayout();
+    textLayout->setContentsMargins(0, 0, 0, 0);
+    textLayout->addWidget(m_titleLabel);
+    textLayout->addWidget(m_faultLabel);
+    textLayout->addWidget(m_swapLabel);
+    textLayout->addWidget(m_reclaimLabel);
+    textLayout->addWidget(m_oomLabel);
+    textLayout->addStretch();
+
+    auto *layout = new QHBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(16);
+    layout->addWidget(m_swapChart, 2);
+    layout->addWidget(m_reclaimChart, 2);
+    layout->addLayout(textLayout, 2);
+
+    onModelUpdate();
+    connect(ModelManager::instance()->updateCoordinator(), &UpdateCoordinator::updateViews, this, &VmActivityViewWidget::onModelUpdate);
+}
+
+void VmActivityViewWidget::fontChanged(const QFont &font)
+{
+    qCDebug(app) << "VmActivityViewWidget fontChanged";
+    m_faultLabel->setFont(font);
+    m_swapLabel->setFont(font);
+    m_reclaimLabel->setFont(font);
+}
+
+void VmActivityViewWidget::onModelUpdate()
+{
+    DeviceSnapshotPtr snapshot = DeviceDB::instance()->snapshot();
+    const vm_rates_t vm = snapshot->memInfo.vmRates();
+    // kept hidden until two reads of vmstat are in, & while a recording is replayed
+    setVisible(vm.valid);
+    if (!vm.valid)
+        return;
+
+    const qreal pageBytes = qreal(1024ull << common::init::kb_shift);
+    m_faultLabel->setText(tr("Faults %1/s, major %2/s").arg(vm.pageFaults, 0, 'f', 0).arg(vm.majorFaults, 0, 'f', 0));
+    m_swapLabel->setText(tr("Swap in %1, out %2")
+                             .arg(formatUnit_memory_disk(vm.swapIn * pageBytes, B, 1, true))
+                             .arg(formatUnit_memory_disk(vm.swapOut * pageBytes, B, 1, true)));
+    // reclaimed of scanned, low efficiency is reclaim struggling to find pages to free
+    const qreal scanned = vm.scanKswapd + vm.scanDirect;
+    const qreal stolen = vm.stealKswapd + vm.stealDirect;
+    if (scanned > 0)
+        m_reclaimLabel->setText(tr("Reclaim %1, %2% direct, %3% efficient")
+                                    .arg(formatUnit_memory_disk(stolen * pageBytes, B, 1, true))
+                                    .arg(vm.scanDirect * 100. / scanned, 0, 'f', 0)
+                                    .arg(qMin(stolen * 100. / scanned, 100.), 0, 'f', 0));
+    else
+        m_reclaimLabel->setText(tr("No reclaim"));
+    m_oomLabel->setText(vm.oomKills > 0 ? tr("OOM kills: %1 just now, %2 since boot").arg(vm.oomKills).arg(vm.oomKillTotal)
+                                        : tr("OOM kills since boot: %1").arg(vm.oomKillTotal));
+}
@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef VM_ACTIVITY_VIEW_WIDGET_H
+#define VM_ACTIVITY_VIEW_WIDGET_H
+
+#include <DLabel>
+
+#include <QWidget>
+
+DWIDGET_USE_NAMESPACE
+
+class ChartViewWidget;
+
+/**
+ * @brief Paging, swap & reclaim activity in the memory detail view
+ *
+ * Charts of swap in / out & of pages scanned by kswapd / direct reclaim, next to the fault,
+ * reclaim & oom kill rates of the last interval. Full memory that is churned this way is
+ * thrashing, full memory without it is only cache. Hidden without /proc/vmstat.
+ */
+class VmActivityViewWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit VmActivityViewWidget(QWidget *parent = nullptr);
+
+public slots:
+    void fontChanged(const QFont &font);
+    void onModelUpdate();
+
+private:
+    ChartViewWidget *m_swapChart;
+    ChartViewWidget *m_reclaimChart;
+    DLabel *m_titleLabel;
+    DLabel *m_faultLabel;
+    DLabel *m_swapLabel;
+    DLabel *m_reclaimLabel;
+    DLabel *m_oomLabel;
+};
+
+#endif // VM_ACTIVITY_VIEW_WIDGET_H
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "wakeup_view_widget.h"
+#include "model/model_manager.h"
+#include "model/update_coordinator.h"
+#include "process/process_db.h"
+#include "process/process_set.h"
+#include "ddlog.h"
+
+#include <DFontSizeManager>
+
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+using namespace DDLog;
+using namespace core::process;
+
+WakeupViewWidget::WakeupViewWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    qCDebug(app) << "WakeupViewWidget constructor";
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+
+    m_titleLabel = new DLabel(tr("Wakeups"), this);
+    m_titleLabel->setForegroundRole(DPalette::TextTips);
+    m_titleLabel->setToolTip(tr("Times per second processes were woken from a sleep or wait, each keeps "
+                                "a CPU out of its idle state. Timer wakeups are counted by the kernel "
+                                "while DKapture is enabled, see the Wakeups column"));
+    m_totalLabel = new DLabel(this);
+    m_topLabel = new DLabel(this);
+    m_topLabel->setForegroundRole(DPalette::TextTips);
+    DFontSizeManager::instance()->bind(m_titleLabel, DFontSizeManager::T8);
+    DFontSizeManager::instance()->bind(m_topLabel, DFontSizeManager::T8);
+
+    auto *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(m_titleLabel);
+    layout->addWidget(m_totalLabel);
+    layout->addWidget(m_topLabel);
+
+    onModelUpdate();
+    connect(ModelManager::instance()->updateCoordinator(), &UpdateCoordinator::updateViews, this, &WakeupViewWidget::onModelUpdate);
+}
+
+void WakeupViewWidget::fontChanged(const QFont &font)
+{
+    qCDebug(app) << "WakeupViewWidget fontChanged";
+    m_totalLabel->setFont(font);
+}
+
+void WakeupViewWidget::onModelUpdate()
+{
+    const ProcessSnapshotPtr snapshot = ProcessDB::instance()->processSet()->snapshot();
+    qreal total = 0;
+    qreal timerTotal = 0;
+    bool traced = false;
+    QVector<const Process *> wakers;
+    wakers.reserve(snapshot->processes.size());
+    for (auto it = snapshot->processes.constBegin(); it != snapshot->processes.constEnd(); ++it) {
+        total += it->wakeupRate();
+        if (it->hasTracedWakeups()) {
+            traced = true;
+            timerTotal += it->timerWakeupRate();
+        }
+        if (it->wakeupRate() > 0)
+            wakers << &it.value();
+    }
+
+    if (traced)
+        m_totalLabel->setText(tr("%1/s, %2/s by timers").arg(qRound64(total)).arg(qRound64(timerTotal)));
+    else
+        m_totalLabel->setText(tr("About %1/s").arg(qRound64(total)));
+
+    const int count = std::min(int(wakers.size()), kTopWakers);
+    std::partial_sort(wakers.begin(), wakers.begin() + count, wakers.end(), [](const Process *a, const Process *b) {
+        return a->wakeupRate() > b->wakeupRate();
+    });
+    QStringList top;
+    for (int i = 0; i < count; ++i)
+        top << tr("%1 %2/s").arg(wakers[i]->displayName()).arg(qRound64(wakers[i]->wakeupRate()));
+    m_topLabel->setText(top.isEmpty() ? QString() : tr("Most: %1").arg(top.join(", ")));
+}
@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef WAKEUP_VIEW_WIDGET_H
+#define WAKEUP_VIEW_WIDGET_H
+
+#include <DLabel>
+
+#include <QWidget>
+
+DWIDGET_USE_NAMESPACE
+
+/**
+ * @brief Processes waking the cpus the most, in the cpu detail view
+ *
+ * Total wakeups of the last interval & the top wakers, each wakeup takes a cpu out of its idle
+ * state. Timer wakeups are told apart while the system server traces them, wakeups are
+ * estimated from voluntary context switches otherwise.
+ */
+class WakeupViewWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit WakeupViewWidget(QWidget *parent = nullptr);
+
+    // processes listed
+    static constexpr int kTopWakers = 3;
+
+public slots:
+    void fontChanged(const QFont &font);
+    void onModelUpdate();
+
+private:
+    DLabel *m_titleLabel;
+    DLabel *m_totalLabel;
+    DLabel *m_topLabel;
+};
+
+#endif // WAKEUP_VIEW_WIDGET_H
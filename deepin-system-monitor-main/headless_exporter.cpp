@@ -0,0 +1,232 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "headless_exporter.h"
+#include "ddlog.h"
+
+#include "common/thread_manager.h"
+#include "process/process_db.h"
+#include "process/process_set.h"
+#include "system/device_db.h"
+#include "system/device_snapshot.h"
+#include "system/netif_monitor_thread.h"
+#include "system/refresh_scheduler.h"
+#include "system/sys_info.h"
+#include "system/system_monitor.h"
+#include "system/system_monitor_thread.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSocketNotifier>
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace common::core;
+using namespace core::system;
+using namespace core::process;
+using namespace DDLog;
+
+// pending connections of the snapshot socket
+const int kListenBacklog = 8;
+
+HeadlessExporter::HeadlessExporter(const Options &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+{
+    qCDebug(app) << "HeadlessExporter constructor";
+    m_clock.start();
+}
+
+HeadlessExporter::~HeadlessExporter()
+{
+    for (int fd : m_clients)
+        close(fd);
+    if (m_listenFd >= 0) {
+        close(m_listenFd);
+        unlink(m_options.socketPath.toLocal8Bit().constData());
+    }
+}
+
+bool HeadlessExporter::start()
+{
+    if (!m_options.socketPath.isEmpty() && !listen())
+        return false;
+
+    auto *thread = ThreadManager::instance()->thread<SystemMonitorThread>(BaseThread::kSystemMonitorThread);
+    SystemMonitor *monitor = thread->systemMonitorInstance();
+    // built on the monitor thread, the process set is only consistent in between its refreshes
+    connect(monitor, &SystemMonitor::statInfoUpdated, this, &HeadlessExporter::onStatInfoUpdated, Qt::DirectConnection);
+    monitor->setProcessRefreshPeriod(qMax(int(kMinInterval), m_options.interval));
+
+    qCInfo(app) << "Headless export every" << m_options.interval << "ms to"
+                << (m_options.socketPath.isEmpty() ? QString("stdout") : m_options.socketPath);
+    thread->start();
+    // per process network io
+    ThreadManager::instance()->thread<NetifMonitorThread>(BaseThread::kNetifMonitorThread)->start();
+    return true;
+}
+
+bool HeadlessExporter::listen()
+{
+    QByteArray path = m_options.socketPath.toLocal8Bit();
+    struct sockaddr_un addr {};
+    if (path.size() >= int(sizeof(addr.sun_path))) {
+        qCWarning(app) << "Socket path too long:" << m_options.socketPath;
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.constData(), size_t(path.size()));
+
+    m_listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_listenFd < 0) {
+        qCWarning(app) << "Failed to create socket:" << strerror(errno);
+        return false;
+    }
+    // a socket left over by a previous run
+    unlink(path.constData());
+    if (bind(m_listenFd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0
+        || ::listen(m_listenFd, kListenBacklog) != 0) {
+        qCWarning(app) << "Failed to listen on" << m_options.socketPath << ":" << strerror(errno);
+        close(m_listenFd);
+        m_listenFd = -1;
+        return false;
+    }
+
+    m_notifier = new QSocketNotifier(m_listenFd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &HeadlessExporter::acceptClients);
+    return true;
+}
+
+void HeadlessExporter::acceptClients()
+{
+    int fd;
+    while ((fd = accept4(m_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        qCDebug(app) << "Snapshot client connected, fd" << fd;
+        m_clients << fd;
+    }
+}
+
+bool HeadlessExporter::writeLine(const QByteArray &line)
+{
+    if (m_listenFd < 0) {
+        if (fwrite(line.constData(), 1, size_t(line.size()), stdout) != size_t(line.size()) || fflush(stdout) != 0) {
+            qCWarning(app) << "Failed to write snapshot to stdout:" << strerror(errno);
+            return false;
+        }
+        return true;
+    }
+
+    for (auto it = m_clients.begin(); it != m_clients.end();) {
+        // lines are small, a partial write means the client stopped reading
+        ssize_t nr = send(*it, line.constData(), size_t(line.size()), MSG_NOSIGNAL);
+        if (nr == ssize_t(line.size())) {
+            ++it;
+            continue;
+        }
+        qCDebug(app) << "Dropping snapshot client, fd" << *it << (nr < 0 ? strerror(errno) : "partial write");
+        close(*it);
+        it = m_clients.erase(it);
+    }
+    return true;
+}
+
+bool HeadlessExporter::isDue(qint64 now) const
+{
+    return m_lastLine < 0 || now - m_lastLine + RefreshScheduler::kDueSlack >= m_options.interval;
+}
+
+double HeadlessExporter::cpuPercent(unsigned long long prevTotal, unsigned long long prevIdle,
+                                    unsigned long long total, unsigned long long idle)
+{
+    if (total <= prevTotal)
+        return 0;
+    unsigned long long totald = total - prevTotal;
+    unsigned long long idled = idle > prevIdle ? idle - prevIdle : 0;
+    return idled >= totald ? 0 : double(totald - idled) * 100. / double(totald);
+}
+
+void HeadlessExporter::onStatInfoUpdated()
+{
+    if (!m_options.lines)
+        return;
+    qint64 now = m_clock.elapsed();
+    if (!isDue(now))
+        return;
+    m_lastLine = now;
+
+    QByteArray line = snapshotLine();
+    QMetaObject::invokeMethod(this, [this, line]() {
+        bool ok = writeLine(line);
+        if (!ok || (m_options.count > 0 && ++m_written >= m_options.count))
+            QCoreApplication::quit();
+    }, Qt::QueuedConnection);
+}
+
+QByteArray HeadlessExporter::snapshotLine()
+{
+    SystemMonitor *monitor = ThreadManager::instance()->thread<SystemMonitorThread>(BaseThread::kSystemMonitorThread)->systemMonitorInstance();
+    DeviceSnapshotPtr snapshot = monitor->deviceDB()->snapshot();
+    QJsonObject root;
+    root["time"] = QDateTime::currentMSecsSinceEpoch();
+
+    QJsonObject cpu;
+    if (snapshot) {
+        const CPUSet &cpuSet = snapshot->cpuSet;
+        auto usage = cpuSet.usage();
+        if (usage) {
+            cpu["usage"] = cpuPercent(m_prevTotal, m_prevIdle, usage->total, usage->idle);
+            m_prevTotal = usage->total;
+            m_prevIdle = usage->idle;
+        }
+        QJsonArray cores;
+        for (int id : cpuSet.cpuIds())
+            cores.append(cpuSet.cpuUsagePercent(id));
+        cpu["cores"] = cores;
+
+        const MemInfo &mem = snapshot->memInfo;
+        root["memory"] = QJsonObject {{"total", qint64(mem.memTotal())}, {"available", qint64(mem.memAvailable())},
+                                      {"swapTotal", qint64(mem.swapTotal())}, {"swapFree", qint64(mem.swapFree())}};
+        root["network"] = QJsonObject {{"recvBps", snapshot->netRecvBps}, {"sentBps", snapshot->netSentBps},
+                                       {"recvBytes", qint64(snapshot->netTotalRecvBytes)},
+                                       {"sentBytes", qint64(snapshot->netTotalSentBytes)}};
+        root["disk"] = QJsonObject {{"readBps", snapshot->diskReadBps}, {"writeBps", snapshot->diskWriteBps}};
+    }
+    LoadAvg loadAvg = monitor->sysInfo()->loadAvg();
+    if (loadAvg)
+        cpu["loadavg"] = QJsonArray {double(loadAvg->lavg_1m), double(loadAvg->lavg_5m), double(loadAvg->lavg_15m)};
+    root["cpu"] = cpu;
+
+    const ProcessSnapshotPtr processSnapshot = monitor->processDB()->processSet()->snapshot();
+    root["processCount"] = processSnapshot->pids.size();
+    if (m_options.processes) {
+        QJsonArray processes;
+        for (const Process &proc : processSnapshot->processes) {
+            if (!proc.isValid())
+                continue;
+            processes.append(QJsonObject {{"pid", proc.pid()},
+                                          {"ppid", proc.ppid()},
+                                          {"name", proc.name()},
+                                          {"user", proc.userName()},
+                                          {"state", QString(QChar(proc.state()))},
+                                          {"threads", int(proc.nthreads())},
+                                          {"cpu", proc.cpu()},
+                                          {"memory", qint64(proc.memory())},
+                                          {"readBps", proc.readBps()},
+                                          {"writeBps", proc.writeBps()},
+                                          {"recvBps", proc.recvBps()},
+                                          {"sentBps", proc.sentBps()}});
+        }
+        root["processes"] = processes;
+    }
+
+    return QJsonDocument(root).toJson(QJsonDocument::Compact) + '\n';
+}
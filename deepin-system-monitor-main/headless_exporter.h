@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef HEADLESS_EXPORTER_H
+#define HEADLESS_EXPORTER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+
+class QSocketNotifier;
+
+/**
+ * @brief Streams sampled system & process state as JSON lines, run by --headless
+ *
+ * A line is built on the system monitor thread right after each refresh, while the process
+ * set is consistent, & written from the thread the exporter lives in. Output goes to stdout,
+ * or to every client of a Unix socket. A client not reading its lines is dropped, so a stuck
+ * reader never holds back sampling.
+ */
+class HeadlessExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        int interval {2000}; // ms between lines
+        QString socketPath; // stdout if empty
+        bool processes {true}; // per process rows, system figures only if false
+        int count {0}; // quit after this many lines, 0 never
+        bool lines {true}; // false when only serving metrics
+    };
+
+    explicit HeadlessExporter(const Options &options, QObject *parent = nullptr);
+    ~HeadlessExporter() override;
+
+    /**
+     * @brief Open output & start the monitor threads
+     * @return false if the socket can't be listened on
+     */
+    bool start();
+
+    /**
+     * @brief Write a line to stdout or every socket client
+     * @return false if stdout is gone
+     */
+    bool writeLine(const QByteArray &line);
+    /**
+     * @brief Snapshot of the current state as one JSON line, monitor thread only
+     */
+    QByteArray snapshotLine();
+    /**
+     * @brief Whether a line is due at now, monotonic ms
+     */
+    bool isDue(qint64 now) const;
+
+    /**
+     * @brief Busy percent of all cpus between two reads of the overall usage, in jiffies
+     */
+    static double cpuPercent(unsigned long long prevTotal, unsigned long long prevIdle,
+                             unsigned long long total, unsigned long long idle);
+
+    // the monitor's base timer ticks once a second
+    static constexpr int kMinInterval = 1000;
+
+private:
+    bool listen();
+    void acceptClients();
+    void onStatInfoUpdated();
+
+private:
+    Options m_options;
+    int m_listenFd {-1};
+    QSocketNotifier *m_notifier {};
+    QList<int> m_clients;
+    int m_written {0};
+
+    // monitor thread side
+    QElapsedTimer m_clock;
+    qint64 m_lastLine {-1};
+    unsigned long long m_prevTotal {0};
+    unsigned long long m_prevIdle {0};
+};
+
+#endif // HEADLESS_EXPORTER_H
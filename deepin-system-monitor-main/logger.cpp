@@ -6,6 +6,7 @@
 #include "dtkcore_global.h"
 #include "qglobal.h"
 #include "ddlog.h"
+#include "common/trace_log.h"
 #include <QLoggingCategory>
 #include <QObject>
 
@@ -13,6 +14,20 @@
 using namespace DDLog;
 DCORE_USE_NAMESPACE
 
+// TRACE_LOG_* messages go to the ring first, then to the journal as far as log rules let them
+static void forwardTraceLog(const common::log::LogEntry &entry)
+{
+    const bool info = entry.level >= common::log::kLevelInfo;
+    if (!(info ? app().isInfoEnabled() : app().isDebugEnabled()))
+        return;
+
+    const QString suffix = entry.suppressed ? QString(" (%1 suppressed)").arg(entry.suppressed) : QString();
+    if (info)
+        qCInfo(app).noquote() << entry.site << entry.message << suffix;
+    else
+        qCDebug(app).noquote() << entry.site << entry.message << suffix;
+}
+
 MLogger::MLogger(QObject *parent)
     : QObject(parent), m_rules(""), m_config(nullptr)
 {
@@ -28,6 +43,8 @@ MLogger::MLogger(QObject *parent)
     logRules = m_config->value("log_rules").toByteArray();
     appendRules(logRules);
     setRules(m_rules);
+    common::log::setMinLevel(m_config->value("trace_log_level", common::log::kLevelDebug).toInt());
+    common::log::setForwarder(forwardTraceLog);
 
     // watch dconfig
     connect(m_config, &DConfig::valueChanged, this, [this](const QString &key) {
@@ -35,6 +52,8 @@ MLogger::MLogger(QObject *parent)
         if (key == "log_rules") {
             qCDebug(app) << "log_rules changed, updating rules";
             setRules(m_config->value(key).toByteArray());
+        } else if (key == "trace_log_level") {
+            common::log::setMinLevel(m_config->value(key).toInt());
         }
     });
 }
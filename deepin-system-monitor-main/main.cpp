@@ -9,6 +9,12 @@
 #include "application.h"
 #include "settings.h"
 #include "gui/main_window.h"
+#include "gui/dialog/self_stats_dialog.h"
+#include "headless_exporter.h"
+#include "metrics_exporter.h"
+#include "remote_agent.h"
+#include "model/model_manager.h"
+#include "model/flight_recorder.h"
 #include "common/perf.h"
 #include "dbus/dbus_object.h"
 #include "dbus/dbusalarmnotify.h"
@@ -27,6 +33,8 @@
 #include <QApplication>
 #include <QDateTime>
 #include <QAccessible>
+
+#include <string.h>
 #include "logger.h"
 DWIDGET_USE_NAMESPACE
 DCORE_USE_NAMESPACE
@@ -55,10 +63,32 @@ int main(int argc, char *argv[])
         setenv("XDG_CURRENT_DESKTOP", "Deepin", 1);
     }
 
+    // headless runs on servers without a display, no window is ever created
+    bool headless = false;
+    for (int i = 1; i < argc; ++i)
+        headless = headless || strcmp(argv[i], "--headless") == 0;
+    if (headless)
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
     Application::setAttribute(Qt::AA_UseHighDpiPixmaps, true);
     Application app(argc, argv);
     qCDebug(DDLog::app) << "Application object created";
     QCommandLineParser parser;
+    QCommandLineOption selfStatsOption("self-stats", "Show the monitor's own CPU, memory and sampling overhead");
+    parser.addOption(selfStatsOption);
+    QCommandLineOption replayOption("replay", "Replay a captured snapshot instead of sampling live", "file");
+    parser.addOption(replayOption);
+    QCommandLineOption headlessOption("headless", "Run without a window, streaming snapshots as JSON lines");
+    QCommandLineOption intervalOption("interval", "Milliseconds between headless snapshots", "ms", "2000");
+    QCommandLineOption socketOption("socket", "Serve headless snapshots on a Unix socket instead of stdout", "path");
+    QCommandLineOption countOption("count", "Quit after this many headless snapshots", "n", "0");
+    QCommandLineOption noProcessesOption("no-processes", "Leave per process rows out of headless snapshots");
+    QCommandLineOption metricsPortOption("metrics-port", "Serve headless metrics for Prometheus on 127.0.0.1:port/metrics", "port");
+    QCommandLineOption metricsTopOption("metrics-top", "Processes with the most CPU in headless metrics", "n", "20");
+    QCommandLineOption agentOption("agent", "Stream headless snapshots to a remote system monitor on stdout, e.g. over ssh");
+    QCommandLineOption agentPortOption("agent-port", "Serve the headless agent stream on 127.0.0.1:port instead of stdout", "port");
+    parser.addOptions({headlessOption, intervalOption, socketOption, countOption, noProcessesOption,
+                       metricsPortOption, metricsTopOption, agentOption, agentPortOption});
     parser.process(app);
     QStringList allArguments = parser.positionalArguments();
     if (allArguments.size() == 3 && allArguments.first().compare("alarm", Qt::CaseInsensitive) == 0) {
@@ -68,6 +98,41 @@ int main(int argc, char *argv[])
         return 0;
     }
 
+    if (parser.isSet(headlessOption)) {
+        qCDebug(DDLog::app) << "Headless mode, skipping single instance & main window";
+        HeadlessExporter::Options options;
+        options.interval = qMax(int(HeadlessExporter::kMinInterval), parser.value(intervalOption).toInt());
+        options.socketPath = parser.value(socketOption);
+        options.count = qMax(0, parser.value(countOption).toInt());
+        options.processes = !parser.isSet(noProcessesOption);
+        // metrics alone don't write lines to stdout, unless a socket asks for them
+        options.lines = !parser.isSet(metricsPortOption) || parser.isSet(socketOption);
+        std::unique_ptr<RemoteAgent> agent;
+        if (parser.isSet(agentOption) || parser.isSet(agentPortOption)) {
+            RemoteAgent::Options agentOptions;
+            agentOptions.interval = options.interval;
+            agentOptions.port = parser.value(agentPortOption).toInt();
+            // the agent alone doesn't write lines, unless a socket asks for them
+            options.lines = parser.isSet(socketOption);
+            agent.reset(new RemoteAgent(agentOptions));
+            if (!agent->start())
+                return 1;
+        }
+        std::unique_ptr<MetricsExporter> metrics;
+        if (parser.isSet(metricsPortOption)) {
+            MetricsExporter::Options metricsOptions;
+            metricsOptions.port = parser.value(metricsPortOption).toInt();
+            metricsOptions.topProcesses = qMax(0, parser.value(metricsTopOption).toInt());
+            metrics.reset(new MetricsExporter(metricsOptions));
+            if (!metrics->start())
+                return 1;
+        }
+        HeadlessExporter exporter(options);
+        if (!exporter.start())
+            return 1;
+        return app.exec();
+    }
+
     //=======通知已经打开的进程
     if (!DBusObject::getInstance().registerOrNotify()) {
         qCDebug(DDLog::app) << "Another instance is already running, exiting.";
@@ -129,6 +194,15 @@ int main(int argc, char *argv[])
         Dtk::Widget::moveToCenter(&mw);
         qCDebug(DDLog::app) << "Showing main window";
         mw.show();
+        if (parser.isSet(selfStatsOption)) {
+            qCDebug(DDLog::app) << "Showing self stats dialog";
+            (new SelfStatsDialog(&mw))->show();
+        }
+        if (parser.isSet(replayOption)) {
+            qCDebug(DDLog::app) << "Replaying snapshot" << parser.value(replayOption);
+            if (!ModelManager::instance()->flightRecorder()->replay(parser.value(replayOption)))
+                qCWarning(DDLog::app) << "Failed to replay" << parser.value(replayOption);
+        }
 
         qCDebug(DDLog::app) << "Starting application event loop";
         return app.exec();
@@ -9,7 +9,10 @@
 #include "common/common.h"
 #include "system/mem.h"
 #include "system/device_db.h"
-#include "system/system_monitor.h"
+#include "system/device_snapshot.h"
+#include "model/model_manager.h"
+#include "model/update_coordinator.h"
+#include "gui/base/frame_clock.h"
 
 #include <DApplication>
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -23,7 +26,6 @@
 #include <QDebug>
 #include <QPainter>
 #include <QtMath>
-#include <QPropertyAnimation>
 #include <QPainterPath>
 #include <QMouseEvent>
 #include "ddlog.h"
@@ -59,15 +61,9 @@ MemoryMonitor::MemoryMonitor(QWidget *parent)
     m_themeType = dAppHelper->themeType();
     changeTheme(m_themeType);
 
-    m_animation = new QPropertyAnimation(this, "progress", this);
-    m_animation->setStartValue(0.0);
-    m_animation->setEndValue(1.0);
-    m_animation->setDuration(10);
-    connect(m_animation, &QPropertyAnimation::valueChanged, this, &MemoryMonitor::onValueChanged);
-    connect(m_animation, &QPropertyAnimation::finished, this, &MemoryMonitor::onAnimationFinished);
-
-    m_memInfo = DeviceDB::instance()->memInfo();
-    connect(SystemMonitor::instance(), &SystemMonitor::statInfoUpdated, this, &MemoryMonitor::onStatInfoUpdated);
+    m_snapshot = DeviceDB::instance()->snapshot();
+    m_memInfo = &m_snapshot->memInfo;
+    connect(ModelManager::instance()->updateCoordinator(), &UpdateCoordinator::updateViews, this, &MemoryMonitor::onStatInfoUpdated);
 
     changeFont(DApplication::font());
     connect(dynamic_cast<QGuiApplication *>(DApplication::instance()), &DApplication::fontChanged, this, &MemoryMonitor::changeFont);
@@ -81,7 +77,10 @@ MemoryMonitor::~MemoryMonitor()
 void MemoryMonitor::onStatInfoUpdated()
 {
     qCDebug(app) << "MemoryMonitor onStatInfoUpdated";
-    m_animation->start();
+    m_snapshot = DeviceDB::instance()->snapshot();
+    m_memInfo = &m_snapshot->memInfo;
+    FrameClock::instance()->start(this, 10, QEasingCurve::Linear, [this](qreal p) { setProgress(p); },
+                                  [this]() { onAnimationFinished(); });
 }
 
 void MemoryMonitor::onAnimationFinished()
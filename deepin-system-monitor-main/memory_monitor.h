@@ -9,6 +9,8 @@
 #include <QIcon>
 #include <QWidget>
 
+#include <memory>
+
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
 #include <DApplicationHelper>
 DWIDGET_USE_NAMESPACE
@@ -18,12 +20,12 @@ DGUI_USE_NAMESPACE
 #endif
 
 class Settings;
-class QPropertyAnimation;
 class MemInfoModel;
 
 namespace core {
 namespace system {
 class MemInfo;
+struct DeviceSnapshot;
 }
 }
 
@@ -100,7 +102,9 @@ private:
     int ringCenterPointerY = 77;
     int ringWidth = 6;
 
-    core::system::MemInfo *m_memInfo {};
+    const core::system::MemInfo *m_memInfo {};
+    // published device state m_memInfo points into
+    std::shared_ptr<const core::system::DeviceSnapshot> m_snapshot;
 
     QFont m_titleFont;
     QFont m_contentFont;
@@ -110,7 +114,6 @@ private:
     qreal m_progress {};
     qreal m_lastMemPercent = 0.;
     qreal m_lastSwapPercent = 0.;
-    QPropertyAnimation *m_animation {};
 
     Settings *m_settings;
 
@@ -0,0 +1,473 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "metrics_exporter.h"
+#include "headless_exporter.h"
+#include "ddlog.h"
+
+#include "common/thread_manager.h"
+#include "process/process_db.h"
+#include "process/process_set.h"
+#include "system/device_db.h"
+#include "system/device_snapshot.h"
+#include "system/netif.h"
+#include "system/sys_info.h"
+#include "system/system_monitor.h"
+#include "system/system_monitor_thread.h"
+
+#include <QDir>
+#include <QSocketNotifier>
+
+#include <algorithm>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+using namespace common::core;
+using namespace common::cgroup;
+using namespace core::system;
+using namespace core::process;
+using namespace DDLog;
+
+// pending connections of the metrics port
+const int kListenBacklog = 16;
+// scrapers served at once, the oldest is dropped for a new one
+const int kMaxClients = 8;
+// a request head longer than this is not a scrape
+const int kMaxRequestSize = 8192;
+// typical page of a desktop, grown on demand & kept
+const int kPageReserve = 64 * 1024;
+const char *const kSystemSlice = "/sys/fs/cgroup/system.slice";
+
+MetricsExporter::MetricsExporter(const Options &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+{
+    qCDebug(app) << "MetricsExporter constructor";
+    m_buffer.reserve(kPageReserve);
+    if (CgroupStats::isAvailable())
+        m_cgroupStats.reset(new CgroupStats());
+}
+
+MetricsExporter::~MetricsExporter()
+{
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it)
+        close(it.key());
+    if (m_listenFd >= 0)
+        close(m_listenFd);
+}
+
+bool MetricsExporter::start()
+{
+    if (!listen())
+        return false;
+
+    SystemMonitor *monitor = ThreadManager::instance()->thread<SystemMonitorThread>(BaseThread::kSystemMonitorThread)->systemMonitorInstance();
+    connect(monitor, &SystemMonitor::statInfoUpdated, this, &MetricsExporter::onStatInfoUpdated, Qt::DirectConnection);
+    qCInfo(app) << "Serving metrics on 127.0.0.1:" << m_options.port;
+    return true;
+}
+
+void MetricsExporter::onStatInfoUpdated()
+{
+    SystemMonitor *monitor = ThreadManager::instance()->thread<SystemMonitorThread>(BaseThread::kSystemMonitorThread)->systemMonitorInstance();
+    DeviceSnapshotPtr snapshot = monitor->deviceDB()->snapshot();
+    LoadAvg loadAvg = monitor->sysInfo()->loadAvg();
+    encode(snapshot.get(), loadAvg.get(), monitor->processDB()->processSet());
+
+    // one copy per refresh, scrapes share it
+    QByteArray page(m_buffer.constData(), m_buffer.size());
+    QMetaObject::invokeMethod(this, [this, page]() {
+        m_page = page;
+    }, Qt::QueuedConnection);
+}
+
+void MetricsExporter::encode(const DeviceSnapshot *snapshot, const load_avg_t *loadAvg, ProcessSet *processSet)
+{
+    ++m_generation;
+    // capacity is reserved, resizing to 0 keeps it
+    m_buffer.resize(0);
+
+    if (snapshot) {
+        const CPUSet &cpuSet = snapshot->cpuSet;
+        beginFamily("dsm_cpu_usage_percent", "Busy percent of a cpu since the previous sample, all for every cpu");
+        auto usage = cpuSet.usage();
+        if (usage) {
+            appendSample("dsm_cpu_usage_percent", label(kCpuLabel, QStringLiteral("all")),
+                         HeadlessExporter::cpuPercent(m_prevTotal, m_prevIdle, usage->total, usage->idle));
+            m_prevTotal = usage->total;
+            m_prevIdle = usage->idle;
+        }
+        for (int id : cpuSet.cpuIds())
+            appendSample("dsm_cpu_usage_percent", label(kCpuLabel, QString::number(id)), cpuSet.cpuUsagePercent(id));
+
+        // meminfo is in kB
+        const MemInfo &mem = snapshot->memInfo;
+        beginFamily("dsm_memory_total_bytes", "Usable physical memory");
+        appendSample("dsm_memory_total_bytes", QByteArray(), quint64(mem.memTotal()) << 10);
+        beginFamily("dsm_memory_available_bytes", "Memory available for new allocations without swapping");
+        appendSample("dsm_memory_available_bytes", QByteArray(), quint64(mem.memAvailable()) << 10);
+        beginFamily("dsm_swap_total_bytes", "Swap space");
+        appendSample("dsm_swap_total_bytes", QByteArray(), quint64(mem.swapTotal()) << 10);
+        beginFamily("dsm_swap_free_bytes", "Unused swap space");
+        appendSample("dsm_swap_free_bytes", QByteArray(), quint64(mem.swapFree()) << 10);
+
+        beginFamily("dsm_network_receive_bytes_per_second", "Received bytes per second of an interface");
+        for (const NetifInfoPtr &netif : snapshot->netifInfo)
+            appendSample("dsm_network_receive_bytes_per_second", label(kInterfaceLabel, QString::fromLocal8Bit(netif->ifname())),
+                         netif->recv_bps());
+        beginFamily("dsm_network_transmit_bytes_per_second", "Sent bytes per second of an interface");
+        for (const NetifInfoPtr &netif : snapshot->netifInfo)
+            appendSample("dsm_network_transmit_bytes_per_second", label(kInterfaceLabel, QString::fromLocal8Bit(netif->ifname())),
+                         netif->sent_bps());
+        beginFamily("dsm_network_receive_bytes_total", "Received bytes of an interface", "counter");
+        for (const NetifInfoPtr &netif : snapshot->netifInfo)
+            appendSample("dsm_network_receive_bytes_total", label(kInterfaceLabel, QString::fromLocal8Bit(netif->ifname())),
+                         quint64(netif->rxBytes()));
+        beginFamily("dsm_network_transmit_bytes_total", "Sent bytes of an interface", "counter");
+        for (const NetifInfoPtr &netif : snapshot->netifInfo)
+            appendSample("dsm_network_transmit_bytes_total", label(kInterfaceLabel, QString::fromLocal8Bit(netif->ifname())),
+                         quint64(netif->txBytes()));
+
+        beginFamily("dsm_disk_read_bytes_per_second", "Read bytes per second of a block device");
+        for (const BlockDevice &device : snapshot->blockDevices)
+            appendSample("dsm_disk_read_bytes_per_second", label(kDeviceLabel, QString::fromLocal8Bit(device.deviceName())),
+                         quint64(device.readSpeed()));
+        beginFamily("dsm_disk_write_bytes_per_second", "Written bytes per second of a block device");
+        for (const BlockDevice &device : snapshot->blockDevices)
+            appendSample("dsm_disk_write_bytes_per_second", label(kDeviceLabel, QString::fromLocal8Bit(device.deviceName())),
+                         quint64(device.writeSpeed()));
+        beginFamily("dsm_disk_utilization_percent", "Percent of time a block device was busy");
+        for (const BlockDevice &device : snapshot->blockDevices)
+            appendSample("dsm_disk_utilization_percent", label(kDeviceLabel, QString::fromLocal8Bit(device.deviceName())),
+                         device.percentUtilization());
+    }
+
+    if (loadAvg) {
+        beginFamily("dsm_load_average", "System load average");
+        appendSample("dsm_load_average", QByteArrayLiteral("{period=\"1m\"}"), qreal(loadAvg->lavg_1m));
+        appendSample("dsm_load_average", QByteArrayLiteral("{period=\"5m\"}"), qreal(loadAvg->lavg_5m));
+        appendSample("dsm_load_average", QByteArrayLiteral("{period=\"15m\"}"), qreal(loadAvg->lavg_15m));
+    }
+
+    if (processSet) {
+        // top processes are picked over the columns of last scan, no Process is copied
+        const ProcessColumnsPtr columns = processSet->columns();
+        beginFamily("dsm_processes", "Processes");
+        appendSample("dsm_processes", QByteArray(), quint64(columns->size()));
+
+        const QVector<int> top = columns->topK(ProcessColumns::kCpuRate, m_options.topProcesses);
+        beginFamily("dsm_process_cpu_percent", "Cpu percent of a process with the most cpu");
+        for (int slot : top)
+            appendSample("dsm_process_cpu_percent", processLabel(*columns, slot), columns->rate(ProcessColumns::kCpuRate, slot));
+        beginFamily("dsm_process_memory_bytes", "Resident memory of a process with the most cpu");
+        for (int slot : top)
+            appendSample("dsm_process_memory_bytes", processLabel(*columns, slot), columns->counter(ProcessColumns::kMemory, slot) << 10);
+        beginFamily("dsm_process_read_bytes_per_second", "Disk read bytes per second of a process with the most cpu");
+        for (int slot : top)
+            appendSample("dsm_process_read_bytes_per_second", processLabel(*columns, slot), columns->rate(ProcessColumns::kReadRate, slot));
+        beginFamily("dsm_process_write_bytes_per_second", "Disk written bytes per second of a process with the most cpu");
+        for (int slot : top)
+            appendSample("dsm_process_write_bytes_per_second", processLabel(*columns, slot), columns->rate(ProcessColumns::kWriteRate, slot));
+        beginFamily("dsm_process_receive_bytes_per_second", "Received bytes per second of a process with the most cpu");
+        for (int slot : top)
+            appendSample("dsm_process_receive_bytes_per_second", processLabel(*columns, slot), columns->rate(ProcessColumns::kRecvRate, slot));
+        beginFamily("dsm_process_transmit_bytes_per_second", "Sent bytes per second of a process with the most cpu");
+        for (int slot : top)
+            appendSample("dsm_process_transmit_bytes_per_second", processLabel(*columns, slot), columns->rate(ProcessColumns::kSentRate, slot));
+    }
+
+    if (m_cgroupStats) {
+        sampleServices();
+        beginFamily("dsm_service_cpu_percent", "Cpu percent of a service's cgroup");
+        for (auto it = m_serviceUsage.cbegin(); it != m_serviceUsage.cend(); ++it) {
+            if (it->hasRates)
+                appendSample("dsm_service_cpu_percent", label(kServiceLabel, it.key()), it->cpu);
+        }
+        beginFamily("dsm_service_memory_bytes", "Memory charged to a service's cgroup");
+        for (auto it = m_serviceUsage.cbegin(); it != m_serviceUsage.cend(); ++it)
+            appendSample("dsm_service_memory_bytes", label(kServiceLabel, it.key()), quint64(it->memory));
+        beginFamily("dsm_service_io_bytes_per_second", "Read & written bytes per second of a service's cgroup");
+        for (auto it = m_serviceUsage.cbegin(); it != m_serviceUsage.cend(); ++it) {
+            if (it->hasRates)
+                appendSample("dsm_service_io_bytes_per_second", label(kServiceLabel, it.key()), it->ioRate);
+        }
+        beginFamily("dsm_service_tasks", "Tasks of a service's cgroup");
+        for (auto it = m_serviceUsage.cbegin(); it != m_serviceUsage.cend(); ++it)
+            appendSample("dsm_service_tasks", label(kServiceLabel, it.key()), quint64(it->tasks));
+    }
+
+    pruneLabels();
+}
+
+void MetricsExporter::sampleServices()
+{
+    // units are cheap to list, started & stopped ones show up on the next sample
+    const QStringList units = QDir(kSystemSlice).entryList({QStringLiteral("*.service")}, QDir::Dirs | QDir::NoDotAndDotDot);
+    if (units.size() != m_serviceGroups.size()
+        || std::any_of(units.cbegin(), units.cend(), [this](const QString &unit) { return !m_serviceGroups.contains(unit); })) {
+        m_serviceGroups.clear();
+        for (const QString &unit : units)
+            m_serviceGroups.insert(unit, QStringLiteral("system.slice/") + unit);
+    }
+    m_serviceUsage = m_cgroupStats->sample(m_serviceGroups);
+}
+
+const QByteArray &MetricsExporter::label(LabelKind kind, const QString &value)
+{
+    static const char *const kLabelNames[kLabelKindCount] = {"cpu", "interface", "device", "service"};
+
+    cached_label_t &cached = m_labels[kind][value];
+    if (cached.text.isEmpty()) {
+        cached.text.append('{').append(kLabelNames[kind]).append("=\"");
+        appendEscaped(cached.text, value);
+        cached.text.append("\"}");
+    }
+    cached.generation = m_generation;
+    return cached.text;
+}
+
+const QByteArray &MetricsExporter::processLabel(const ProcessColumns &columns, int slot)
+{
+    const pid_t pid = columns.pid(slot);
+    process_label_t &cached = m_processLabels[pid];
+    // a reused pid or a renamed process
+    if (cached.text.isEmpty() || cached.name != columns.name(slot) || cached.user != columns.userName(slot)) {
+        cached.name = columns.name(slot);
+        cached.user = columns.userName(slot);
+        cached.text = "{pid=\"" + QByteArray::number(pid) + "\",name=\"";
+        appendEscaped(cached.text, cached.name);
+        cached.text.append("\",user=\"");
+        appendEscaped(cached.text, cached.user);
+        cached.text.append("\"}");
+    }
+    cached.generation = m_generation;
+    return cached.text;
+}
+
+void MetricsExporter::pruneLabels()
+{
+    for (auto &labels : m_labels) {
+        for (auto it = labels.begin(); it != labels.end();) {
+            if (it->generation == m_generation)
+                ++it;
+            else
+                it = labels.erase(it);
+        }
+    }
+    for (auto it = m_processLabels.begin(); it != m_processLabels.end();) {
+        if (it->generation == m_generation)
+            ++it;
+        else
+            it = m_processLabels.erase(it);
+    }
+}
+
+void MetricsExporter::beginFamily(const char *name, const char *help, const char *type)
+{
+    m_buffer.append("# HELP ").append(name).append(' ').append(help).append('\n');
+    m_buffer.append("# TYPE ").append(name).append(' ').append(type).append('\n');
+}
+
+void MetricsExporter::appendSample(const char *name, const QByteArray &labels, qreal value)
+{
+    m_buffer.append(name).append(labels).append(' ');
+    appendNumber(m_buffer, value);
+    m_buffer.append('\n');
+}
+
+void MetricsExporter::appendSample(const char *name, const QByteArray &labels, quint64 value)
+{
+    m_buffer.append(name).append(labels).append(' ');
+    appendNumber(m_buffer, value);
+    m_buffer.append('\n');
+}
+
+void MetricsExporter::appendEscaped(QByteArray &out, const QString &value)
+{
+    const QByteArray utf8 = value.toUtf8();
+    for (char c : utf8) {
+        if (c == '\\')
+            out.append("\\\\");
+        else if (c == '"')
+            out.append("\\\"");
+        else if (c == '\n')
+            out.append("\\n");
+        else
+            out.append(c);
+    }
+}
+
+void MetricsExporter::appendNumber(QByteArray &out, qreal value)
+{
+    if (qIsNaN(value)) {
+        out.append("NaN");
+        return;
+    }
+    if (qIsInf(value)) {
+        out.append(value > 0 ? "+Inf" : "-Inf");
+        return;
+    }
+    char buf[32];
+    int len = snprintf(buf, sizeof(buf), "%.6g", value);
+    out.append(buf, len);
+}
+
+void MetricsExporter::appendNumber(QByteArray &out, quint64 value)
+{
+    char buf[24];
+    char *p = buf + sizeof(buf);
+    do {
+        *--p = char('0' + value % 10);
+        value /= 10;
+    } while (value);
+    out.append(p, int(buf + sizeof(buf) - p));
+}
+
+bool MetricsExporter::parseRequest(const QByteArray &request, bool &isMetrics)
+{
+    if (!request.contains("\r\n\r\n") && !request.contains("\n\n"))
+        return false;
+    isMetrics = request.startsWith("GET /metrics ") || request.startsWith("GET /metrics?");
+    return true;
+}
+
+bool MetricsExporter::listen()
+{
+    m_listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_listenFd < 0) {
+        qCWarning(app) << "Failed to create socket:" << strerror(errno);
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    // scrapers are local, a remote stack goes through a local agent or a proxy
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(quint16(m_options.port));
+    if (bind(m_listenFd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0
+        || ::listen(m_listenFd, kListenBacklog) != 0) {
+        qCWarning(app) << "Failed to listen on port" << m_options.port << ":" << strerror(errno);
+        close(m_listenFd);
+        m_listenFd = -1;
+        return false;
+    }
+
+    m_notifier = new QSocketNotifier(m_listenFd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &MetricsExporter::acceptClients);
+    return true;
+}
+
+void MetricsExporter::acceptClients()
+{
+    int fd;
+    while ((fd = accept4(m_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        if (m_clients.size() >= kMaxClients) {
+            auto oldest = std::min_element(m_clients.cbegin(), m_clients.cend(),
+                                           [](const client_t &a, const client_t &b) { return a.serial < b.serial; });
+            qCDebug(app) << "Too many metrics clients, dropping fd" << oldest.key();
+            closeClient(oldest.key());
+        }
+
+        client_t client {};
+        client.notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+        client.serial = m_serial++;
+        connect(client.notifier, &QSocketNotifier::activated, this, [this, fd]() {
+            readRequest(fd);
+        });
+        m_clients.insert(fd, client);
+    }
+}
+
+void MetricsExporter::readRequest(int fd)
+{
+    auto it = m_clients.find(fd);
+    if (it == m_clients.end())
+        return;
+
+    char buf[1024];
+    ssize_t nr;
+    while ((nr = recv(fd, buf, sizeof(buf), 0)) > 0)
+        it->request.append(buf, int(nr));
+    if (nr == 0 || (nr < 0 && errno != EAGAIN && errno != EWOULDBLOCK) || it->request.size() > kMaxRequestSize) {
+        closeClient(fd);
+        return;
+    }
+
+    bool isMetrics = false;
+    if (!parseRequest(it->request, isMetrics))
+        return;
+
+    if (isMetrics) {
+        it->body = m_page;
+        it->head = "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\n";
+    } else {
+        it->body = "not found\n";
+        it->head = "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\n";
+    }
+    it->head += "Content-Length: " + QByteArray::number(it->body.size()) + "\r\nConnection: close\r\n\r\n";
+
+    it->notifier->setEnabled(false);
+    it->notifier->deleteLater();
+    it->notifier = new QSocketNotifier(fd, QSocketNotifier::Write, this);
+    it->notifier->setEnabled(false);
+    connect(it->notifier, &QSocketNotifier::activated, this, [this, fd]() {
+        writeResponse(fd);
+    });
+    writeResponse(fd);
+}
+
+void MetricsExporter::writeResponse(int fd)
+{
+    auto it = m_clients.find(fd);
+    if (it == m_clients.end())
+        return;
+
+    // head & the shared page go out without joining them
+    qint64 headSize = it->head.size();
+    qint64 total = headSize + it->body.size();
+    while (it->sent < total) {
+        struct iovec iov[2];
+        int iovcnt = 0;
+        if (it->sent < headSize) {
+            iov[iovcnt].iov_base = const_cast<char *>(it->head.constData()) + it->sent;
+            iov[iovcnt++].iov_len = size_t(headSize - it->sent);
+            iov[iovcnt].iov_base = const_cast<char *>(it->body.constData());
+            iov[iovcnt++].iov_len = size_t(it->body.size());
+        } else {
+            iov[iovcnt].iov_base = const_cast<char *>(it->body.constData()) + (it->sent - headSize);
+            iov[iovcnt++].iov_len = size_t(total - it->sent);
+        }
+        ssize_t nw = writev(fd, iov, iovcnt);
+        if (nw < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                it->notifier->setEnabled(true);
+                return;
+            }
+            qCDebug(app) << "Failed to write metrics, fd" << fd << ":" << strerror(errno);
+            break;
+        }
+        it->sent += nw;
+    }
+    closeClient(fd);
+}
+
+void MetricsExporter::closeClient(int fd)
+{
+    auto it = m_clients.find(fd);
+    if (it == m_clients.end())
+        return;
+    it->notifier->setEnabled(false);
+    it->notifier->deleteLater();
+    close(fd);
+    m_clients.erase(it);
+}
@@ -0,0 +1,152 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef METRICS_EXPORTER_H
+#define METRICS_EXPORTER_H
+
+#include "common/cgroup_stats.h"
+#include "process/process_columns.h"
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+
+#include <memory>
+
+class QSocketNotifier;
+
+namespace core {
+namespace system {
+struct DeviceSnapshot;
+struct load_avg_t;
+} // namespace system
+namespace process {
+class ProcessSet;
+} // namespace process
+} // namespace core
+
+/**
+ * @brief Serves sampled state in the Prometheus text format on a loopback HTTP /metrics endpoint
+ *
+ * The page is encoded once per refresh on the system monitor thread into a reused buffer, series
+ * label texts are kept between encodes. A scrape only sends the last page, so scrapes cost a write
+ * regardless of how often they come.
+ */
+class MetricsExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        int port {9101}; // tcp port on 127.0.0.1
+        int topProcesses {20}; // processes with the most cpu, by pid
+    };
+
+    explicit MetricsExporter(const Options &options, QObject *parent = nullptr);
+    ~MetricsExporter() override;
+
+    /**
+     * @brief Listen & encode a page after each monitor refresh, call before the monitor thread starts
+     * @return false if the port can't be listened on
+     */
+    bool start();
+
+    /**
+     * @brief Encode all families into the page buffer, monitor thread only
+     */
+    void encode(const core::system::DeviceSnapshot *snapshot, const core::system::load_avg_t *loadAvg,
+                core::process::ProcessSet *processSet);
+    /**
+     * @brief Last encoded page
+     */
+    inline const QByteArray &page() const
+    {
+        return m_page;
+    }
+
+    /**
+     * @brief Label value escaped as the text format wants: backslash, double quote & line feed
+     */
+    static void appendEscaped(QByteArray &out, const QString &value);
+    /**
+     * @brief Shortest text of value, NaN & +Inf/-Inf as spelled by the format
+     */
+    static void appendNumber(QByteArray &out, qreal value);
+    static void appendNumber(QByteArray &out, quint64 value);
+    /**
+     * @brief Whether the request head is complete, isMetrics tells a GET of /metrics
+     */
+    static bool parseRequest(const QByteArray &request, bool &isMetrics);
+
+private:
+    // label sets kept between encodes, keyed by kind & value
+    enum LabelKind {
+        kCpuLabel,
+        kInterfaceLabel,
+        kDeviceLabel,
+        kServiceLabel,
+
+        kLabelKindCount
+    };
+
+    struct cached_label_t {
+        QByteArray text; // {name="value"}
+        quint64 generation;
+    };
+
+    struct process_label_t {
+        QString name;
+        QString user;
+        QByteArray text; // {pid="",name="",user=""}
+        quint64 generation;
+    };
+
+    struct client_t {
+        QSocketNotifier *notifier;
+        QByteArray request;
+        QByteArray head;
+        QByteArray body;
+        qint64 sent;
+        quint64 serial; // to drop the oldest client first
+    };
+
+    const QByteArray &label(LabelKind kind, const QString &value);
+    const QByteArray &processLabel(const core::process::ProcessColumns &columns, int slot);
+    void beginFamily(const char *name, const char *help, const char *type = "gauge");
+    void appendSample(const char *name, const QByteArray &labels, qreal value);
+    void appendSample(const char *name, const QByteArray &labels, quint64 value);
+    void sampleServices();
+    void pruneLabels();
+
+    bool listen();
+    void acceptClients();
+    void readRequest(int fd);
+    void writeResponse(int fd);
+    void closeClient(int fd);
+    void onStatInfoUpdated();
+
+private:
+    Options m_options;
+
+    // monitor thread side
+    QByteArray m_buffer;
+    QHash<QString, cached_label_t> m_labels[kLabelKindCount];
+    QHash<pid_t, process_label_t> m_processLabels;
+    quint64 m_generation {0};
+    std::unique_ptr<common::cgroup::CgroupStats> m_cgroupStats; // null without the unified hierarchy
+    QHash<QString, QString> m_serviceGroups;
+    QHash<QString, common::cgroup::cgroup_usage_t> m_serviceUsage;
+    unsigned long long m_prevTotal {0};
+    unsigned long long m_prevIdle {0};
+
+    // exporter thread side
+    QByteArray m_page;
+    int m_listenFd {-1};
+    QSocketNotifier *m_notifier {};
+    QHash<int, client_t> m_clients;
+    quint64 m_serial {0};
+};
+
+#endif // METRICS_EXPORTER_H
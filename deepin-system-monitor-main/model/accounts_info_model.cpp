@@ -72,8 +72,20 @@ void AccountsInfoModel::updateUserList(const QStringList &userPathList)
     qDeleteAll(m_userMap.values());
     m_userMap.clear();
 
-    for (QString userPath : userPathList) {
-        QDBusInterface *userDBus = new QDBusInterface(common::systemInfo().AccountsService, userPath, common::systemInfo().UserInterface, QDBusConnection::systemBus(), this);
+    // drop proxies of removed users
+    for (auto it = m_userInters.begin(); it != m_userInters.end();) {
+        if (!userPathList.contains(it.key())) {
+            delete it.value();
+            it = m_userInters.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (const QString &userPath : userPathList) {
+        QDBusInterface *&userDBus = m_userInters[userPath];
+        if (!userDBus)
+            userDBus = new QDBusInterface(common::systemInfo().AccountsService, userPath, common::systemInfo().UserInterface, QDBusConnection::systemBus(), this);
         User *newUser = new User;
 
         newUser->setName(userDBus->property("UserName").toString());
@@ -89,8 +101,6 @@ void AccountsInfoModel::updateUserList(const QStringList &userPathList)
             qCInfo(app) << "Current user type set to:" << m_currentUserType;
         }
         m_userMap.insert(newUser->name(), newUser);
-
-        delete userDBus;
     }
 }
 
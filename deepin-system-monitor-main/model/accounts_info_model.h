@@ -85,6 +85,8 @@ public Q_SLOTS:
 private:
     QDBusInterface *m_accountsInter;
     QMap<QString, User * > m_userMap ;
+    // user path -> user proxy, kept across user list changes so they aren't introspected again
+    QHash<QString, QDBusInterface *> m_userInters;
     QStringList m_onlineUsers;
     QDBusInterface *m_LoginInter;
     QDBusInterface *m_controlInter;
@@ -6,6 +6,7 @@
 #include "block_dev_stat_model.h"
 #include "ddlog.h"
 #include "common/common.h"
+#include "system/sys_info.h"
 
 using namespace common::core;
 using namespace common::format;
@@ -16,13 +17,16 @@ BlockDevStatModel::BlockDevStatModel(const TimePeriod &period, QObject *parent)
     : QAbstractTableModel(parent)
     , m_ioSampleDB(new IOSample(period))
     , m_iopsSampleDB(new IOPSSample(period))
+    , m_latencySampleDB(new IOLatencySample(period))
 {
     qCDebug(app) << "BlockDevStatModel constructor";
 }
 
 int BlockDevStatModel::rowCount(const QModelIndex &) const
 {
-    if (m_iopsSampleDB && m_ioSampleDB && m_iopsSampleDB->count() == m_ioSampleDB->count()) {
+    if (m_iopsSampleDB && m_ioSampleDB && m_latencySampleDB
+            && m_iopsSampleDB->count() == m_ioSampleDB->count()
+            && m_latencySampleDB->count() == m_ioSampleDB->count()) {
         return m_iopsSampleDB->count();
     } else {
         qCDebug(app) << "BlockDevStatModel::rowCount invalid data, returning 0";
@@ -38,7 +42,7 @@ int BlockDevStatModel::columnCount(const QModelIndex &) const
 
 QVariant BlockDevStatModel::data(const QModelIndex &index, int role) const
 {
-    if (!index.isValid() || !m_ioSampleDB.get() || !m_iopsSampleDB.get()) {
+    if (!index.isValid() || !m_ioSampleDB.get() || !m_iopsSampleDB.get() || !m_latencySampleDB.get()) {
         qCDebug(app) << "BlockDevStatModel::data invalid index or data";
         return {};
     }
@@ -50,6 +54,7 @@ QVariant BlockDevStatModel::data(const QModelIndex &index, int role) const
 
     auto *io = m_ioSampleDB->sample(index.row());
     auto *iops = m_iopsSampleDB->sample(index.row());
+    auto *latency = m_latencySampleDB->sample(index.row());
 
     if (role == Qt::DisplayRole || role == Qt::AccessibleTextRole) {
         qCDebug(app) << "BlockDevStatModel::data Display/Accessible role for row" << index.row() << "col"
@@ -79,6 +84,36 @@ QVariant BlockDevStatModel::data(const QModelIndex &index, int role) const
 
             break;
         }
+        case kStatUtilization: {
+            if (latency)
+                return QString("%1%").arg(latency->data.util, 0, 'f', 1);
+
+            break;
+        }
+        case kStatAwait: {
+            if (latency)
+                return QString("%1 ms").arg(latency->data.await, 0, 'f', 2);
+
+            break;
+        }
+        case kStatServiceTime: {
+            if (latency)
+                return QString("%1 ms").arg(latency->data.svctm, 0, 'f', 2);
+
+            break;
+        }
+        case kStatQueueDepth: {
+            if (latency)
+                return QString::number(latency->data.queueDepth, 'f', 2);
+
+            break;
+        }
+        case kStatDiscardSpeed: {
+            if (latency)
+                return formatUnit_memory_disk(latency->data.discardBps, B, 1, true);
+
+            break;
+        }
         default:
             break;
         } // ::switch
@@ -111,6 +146,36 @@ QVariant BlockDevStatModel::data(const QModelIndex &index, int role) const
 
             break;
         }
+        case kStatUtilization: {
+            if (latency)
+                return latency->data.util;
+
+            break;
+        }
+        case kStatAwait: {
+            if (latency)
+                return latency->data.await;
+
+            break;
+        }
+        case kStatServiceTime: {
+            if (latency)
+                return latency->data.svctm;
+
+            break;
+        }
+        case kStatQueueDepth: {
+            if (latency)
+                return latency->data.queueDepth;
+
+            break;
+        }
+        case kStatDiscardSpeed: {
+            if (latency)
+                return latency->data.discardBps;
+
+            break;
+        }
         default:
             break;
         } // ::switch
@@ -118,3 +183,20 @@ QVariant BlockDevStatModel::data(const QModelIndex &index, int role) const
 
     return {};
 }
+
+void BlockDevStatModel::addSample(const core::system::BlockDevice &device)
+{
+    qCDebug(app) << "BlockDevStatModel::addSample for" << device.deviceName();
+    auto tv = core::system::SysInfo::instance()->uptime();
+
+    IO io {device.bytesRead(), device.bytesWritten()};
+    IOPS iops {qreal(device.readSpeed()), qreal(device.writeSpeed())};
+    IOLatency latency {device.await(), device.serviceTime(), device.percentUtilization(),
+                       device.queueDepth(), qreal(device.discardSpeed())};
+
+    beginResetModel();
+    m_ioSampleDB->addSample(IOSampleFrame(tv, io));
+    m_iopsSampleDB->addSample(IOPSSampleFrame(iops));
+    m_latencySampleDB->addSample(IOLatencySampleFrame(latency));
+    endResetModel();
+}
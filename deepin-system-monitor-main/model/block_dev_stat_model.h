@@ -8,6 +8,7 @@
 
 #include "common/sample.h"
 #include "common/time_period.h"
+#include "system/block_device.h"
 
 #include <QAbstractTableModel>
 
@@ -30,6 +31,11 @@ public:
         kStatTotalWrite,
         kStatReadSpeed,
         kStatWriteSpeed,
+        kStatUtilization,
+        kStatAwait,
+        kStatServiceTime,
+        kStatQueueDepth,
+        kStatDiscardSpeed,
 
         kStatPropMax
     };
@@ -49,9 +55,16 @@ public:
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
 
+    /**
+     * @brief Append a sample of device's current stats
+     * @param device Block device stats
+     */
+    void addSample(const core::system::BlockDevice &device);
+
 private:
     std::unique_ptr<IOSample> m_ioSampleDB;
     std::unique_ptr<IOPSSample> m_iopsSampleDB;
+    std::unique_ptr<IOLatencySample> m_latencySampleDB;
 
     friend class BlockDevInfoModel;
 };
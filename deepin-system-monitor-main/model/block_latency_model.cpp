@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "block_latency_model.h"
+#include "ddlog.h"
+#include "process/system_service_client.h"
+#include "process_info_record.h"
+
+#include <DConfig>
+
+#include <QFileInfo>
+#include <QScopedPointer>
+#include <QSet>
+
+using namespace DDLog;
+using namespace core::process;
+
+namespace {
+
+QString seriesKey(const QString &device, bool write)
+{
+    return QString("%1/%2").arg(device).arg(write ? BLOCK_LATENCY_WRITE : BLOCK_LATENCY_READ);
+}
+
+} // namespace
+
+BlockLatencyModel::BlockLatencyModel(QObject *parent)
+    : QObject(parent)
+{
+    qCDebug(app) << "BlockLatencyModel constructor";
+}
+
+BlockLatencyModel::~BlockLatencyModel()
+{
+    stop();
+}
+
+void BlockLatencyModel::refresh()
+{
+    if (!m_opened) {
+        if (!m_client) {
+            // kernel tracing by the system server is opt in, follow the process table setting
+            QScopedPointer<DTK_CORE_NAMESPACE::DConfig> config(DTK_CORE_NAMESPACE::DConfig::create("deepin-system-monitor", "org.deepin.system-monitor"));
+            if (!config || !config->value("enable_dkapture", false).toBool()) {
+                qCDebug(app) << "DKapture disabled, no block latency";
+                m_available = false;
+                return;
+            }
+            m_client = new SystemServiceClient(this);
+        }
+        m_opened = m_client->openBlockLatency();
+        m_available = m_opened;
+        if (!m_opened)
+            return;
+    }
+
+    QByteArray latency;
+    if (!m_client->getBlockLatency(latency))
+        return;
+    applyLatency(latency);
+}
+
+void BlockLatencyModel::stop()
+{
+    if (m_opened) {
+        m_client->closeBlockLatency();
+        m_opened = false;
+    }
+    m_series.clear();
+    m_lastTimestamp = 0;
+}
+
+void BlockLatencyModel::applyLatency(const QByteArray &latency)
+{
+    const block_latency_record_t *records = nullptr;
+    const block_latency_header_t *hdr = blockLatencyRecords(latency.constData(), size_t(latency.size()), records);
+    if (!hdr)
+        return;
+
+    // snapshots are cached by the server, same timestamp means nothing new
+    if (hdr->timestamp == m_lastTimestamp)
+        return;
+    const bool hasInterval = m_lastTimestamp && hdr->timestamp > m_lastTimestamp;
+    m_lastTimestamp = hdr->timestamp;
+
+    QSet<QString> seen;
+    for (uint32_t i = 0; i < hdr->count; ++i) {
+        const block_latency_record_t &rec = records[i];
+        auto name = m_names.constFind(rec.dev);
+        if (name == m_names.constEnd())
+            name = m_names.insert(rec.dev, deviceName(rec.dev));
+        const QString key = seriesKey(*name, rec.dir == BLOCK_LATENCY_WRITE);
+        seen.insert(key);
+
+        series_t &series = m_series[key];
+        Column totals(BLOCK_LATENCY_BUCKETS);
+        Column column(BLOCK_LATENCY_BUCKETS);
+        // totals restart when tracing is reopened, the first snapshot only sets the base
+        bool restarted = series.last.size() != BLOCK_LATENCY_BUCKETS;
+        for (int b = 0; b < BLOCK_LATENCY_BUCKETS; ++b) {
+            totals[b] = rec.buckets[b];
+            if (!restarted && totals[b] < series.last[b])
+                restarted = true;
+        }
+        if (hasInterval && !restarted) {
+            for (int b = 0; b < BLOCK_LATENCY_BUCKETS; ++b)
+                column[b] = totals[b] - series.last[b];
+        }
+        series.last = totals;
+        series.columns << column;
+        while (series.columns.size() > kHistorySize)
+            series.columns.removeFirst();
+    }
+    // disks without requests since the last snapshot aren't reported, still time passed for them
+    for (auto it = m_series.begin(); it != m_series.end(); ++it) {
+        if (seen.contains(it.key()))
+            continue;
+        it->columns << Column(BLOCK_LATENCY_BUCKETS);
+        while (it->columns.size() > kHistorySize)
+            it->columns.removeFirst();
+    }
+
+    Q_EMIT updated();
+}
+
+QList<BlockLatencyModel::Column> BlockLatencyModel::history(const QString &device, bool write) const
+{
+    return m_series.value(seriesKey(device, write)).columns;
+}
+
+qreal BlockLatencyModel::percentile(const Column &column, qreal percent)
+{
+    quint64 total = 0;
+    for (quint64 count : column)
+        total += count;
+    if (total == 0)
+        return 0.;
+
+    const qreal rank = total * percent / 100.;
+    quint64 below = 0;
+    for (int b = 0; b < column.size(); ++b) {
+        below += column[b];
+        if (below >= rank)
+            return qreal(1ULL << (b + 1));
+    }
+    return qreal(1ULL << column.size());
+}
+
+QString BlockLatencyModel::deviceName(quint32 dev)
+{
+    // kernel dev_t, not the glibc one of stat
+    const QString path = QString("/sys/dev/block/%1:%2").arg(dev >> 20).arg(dev & 0xfffff);
+    const QString target = QFileInfo(path).symLinkTarget();
+    return target.isEmpty() ? QString("%1:%2").arg(dev >> 20).arg(dev & 0xfffff) : QFileInfo(target).fileName();
+}
@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef BLOCK_LATENCY_MODEL_H
+#define BLOCK_LATENCY_MODEL_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+namespace core {
+namespace process {
+class SystemServiceClient;
+}
+}
+
+/**
+ * @brief Recent block request latency distributions of every disk, per read & write
+ *
+ * Requests are traced in the kernel by the system server & counted there in log2 buckets, see
+ * BLOCK_LATENCY_BUCKETS; each refresh() turns the totals into one column of requests completed
+ * per bucket since the last refresh. Nothing is traced until refresh() is called & tracing stops
+ * with stop(). Without the system service the model stays empty, see isAvailable().
+ */
+class BlockLatencyModel : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Column = QVector<quint64>; // requests per bucket
+
+    explicit BlockLatencyModel(QObject *parent = nullptr);
+    ~BlockLatencyModel() override;
+
+    /**
+     * @brief Start tracing if needed & append a column to every disk
+     */
+    void refresh();
+    /**
+     * @brief Stop tracing & drop history
+     */
+    void stop();
+
+    /**
+     * @brief false once tracing could not be started, DKapture disabled or the system service unusable
+     */
+    inline bool isAvailable() const { return m_available; }
+
+    /**
+     * @brief Columns of \a device, oldest first, at most kHistorySize
+     * @param write Writes, reads otherwise
+     */
+    QList<Column> history(const QString &device, bool write) const;
+    /**
+     * @brief Latency in us below which \a percent of the requests of \a column completed, 0 if none
+     *
+     * Upper bound of the bucket the percentile falls in, so at most twice the real value.
+     */
+    static qreal percentile(const Column &column, qreal percent);
+    /**
+     * @brief Disk name of a kernel dev_t, e.g. nvme0n1, from /sys/dev/block
+     */
+    static QString deviceName(quint32 dev);
+
+    // columns kept per disk & direction, two minutes at the default refresh
+    static constexpr int kHistorySize = 60;
+
+Q_SIGNALS:
+    void updated();
+
+private:
+    struct series_t {
+        Column last; // totals of the last snapshot
+        QList<Column> columns;
+    };
+
+    /**
+     * @brief Append columns from a getBlockLatency buffer
+     */
+    void applyLatency(const QByteArray &latency);
+
+    core::process::SystemServiceClient *m_client {};
+    bool m_opened {false};
+    bool m_available {true};
+    // by device name & direction, "nvme0n1/1"
+    QHash<QString, series_t> m_series {};
+    QHash<quint32, QString> m_names {};
+    quint64 m_lastTimestamp {0};
+};
+
+#endif // BLOCK_LATENCY_MODEL_H
@@ -0,0 +1,182 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "container_group_model.h"
+#include "ddlog.h"
+#include "common/common.h"
+#include "process/process_db.h"
+
+#include <QApplication>
+
+using namespace DDLog;
+using namespace common::format;
+using namespace core::process;
+
+ContainerGroupModel::ContainerGroupModel(QObject *parent)
+    : QAbstractItemModel(parent)
+    , m_snapshot(std::make_shared<const ProcessSnapshot>())
+{
+    qCDebug(app) << "ContainerGroupModel constructor";
+}
+
+void ContainerGroupModel::refresh()
+{
+    const ProcessSnapshotPtr snapshot = ProcessDB::instance()->processSet()->snapshot();
+    if (snapshot->containers == m_snapshot->containers)
+        return;
+
+    // groups & processes move between scans, persistent indexes follow their group & pid
+    Q_EMIT layoutAboutToBeChanged();
+    const QModelIndexList from = persistentIndexList();
+    QList<QPair<QString, pid_t>> keys;
+    for (const QModelIndex &index : from) {
+        const int group = index.internalId() ? int(index.internalId()) - 1 : index.row();
+        const ContainerUsage &usage = m_snapshot->containers->at(group);
+        keys << qMakePair(usage.identity.key(), index.internalId() ? usage.pids.value(index.row()) : 0);
+    }
+
+    m_snapshot = snapshot;
+    QHash<QString, int> groups;
+    for (int i = 0; i < m_snapshot->containers->size(); ++i)
+        groups.insert(m_snapshot->containers->at(i).identity.key(), i);
+    QModelIndexList to;
+    for (int i = 0; i < from.size(); ++i) {
+        const int group = groups.value(keys[i].first, -1);
+        if (group < 0) {
+            to << QModelIndex();
+        } else if (!keys[i].second) {
+            to << createIndex(group, from[i].column());
+        } else {
+            const int row = m_snapshot->containers->at(group).pids.indexOf(keys[i].second);
+            to << (row >= 0 ? createIndex(row, from[i].column(), quintptr(group + 1)) : QModelIndex());
+        }
+    }
+    changePersistentIndexList(from, to);
+    Q_EMIT layoutChanged();
+}
+
+QModelIndex ContainerGroupModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (row < 0 || column < 0 || column >= kContainerColumnCount)
+        return {};
+    // internal id is the group's row + 1 for processes, 0 for groups
+    if (!parent.isValid())
+        return row < m_snapshot->containers->size() ? createIndex(row, column) : QModelIndex();
+    if (parent.internalId() || parent.row() >= m_snapshot->containers->size())
+        return {};
+    if (row >= m_snapshot->containers->at(parent.row()).pids.size())
+        return {};
+    return createIndex(row, column, quintptr(parent.row() + 1));
+}
+
+QModelIndex ContainerGroupModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid() || !child.internalId())
+        return {};
+    return createIndex(int(child.internalId()) - 1, 0);
+}
+
+int ContainerGroupModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return m_snapshot->containers->size();
+    // only the first column of groups has children
+    if (parent.internalId() || parent.column() != 0 || parent.row() >= m_snapshot->containers->size())
+        return 0;
+    return m_snapshot->containers->at(parent.row()).pids.size();
+}
+
+int ContainerGroupModel::columnCount(const QModelIndex &) const
+{
+    return kContainerColumnCount;
+}
+
+QVariant ContainerGroupModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && (role == Qt::DisplayRole || role == Qt::AccessibleTextRole)) {
+        switch (section) {
+        case kContainerNameColumn:
+            return QApplication::translate("Process.Container.Header", kContainerName);
+        case kContainerKindColumn:
+            return QApplication::translate("Process.Container.Header", kContainerKind);
+        case kContainerProcessesColumn:
+            return QApplication::translate("Process.Container.Header", kContainerProcesses);
+        case kContainerCPUColumn:
+            return QApplication::translate("Process.Container.Header", kContainerCPU);
+        case kContainerMemoryColumn:
+            return QApplication::translate("Process.Container.Header", kContainerMemory);
+        case kContainerDiskColumn:
+            return QApplication::translate("Process.Container.Header", kContainerDisk);
+        case kContainerNetColumn:
+            return QApplication::translate("Process.Container.Header", kContainerNet);
+        default:
+            break;
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return QAbstractItemModel::headerData(section, orientation, role);
+}
+
+QVariant ContainerGroupModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return {};
+    if (role == Qt::TextAlignmentRole)
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    if (role != Qt::DisplayRole && role != Qt::AccessibleTextRole)
+        return {};
+
+    const int group = index.internalId() ? int(index.internalId()) - 1 : index.row();
+    if (group >= m_snapshot->containers->size())
+        return {};
+    const ContainerUsage &usage = m_snapshot->containers->at(group);
+    if (!index.internalId())
+        return groupData(usage, index.column());
+    if (index.row() >= usage.pids.size())
+        return {};
+    return processData(m_snapshot->processes.value(usage.pids[index.row()]), index.column());
+}
+
+QVariant ContainerGroupModel::groupData(const ContainerUsage &usage, int column) const
+{
+    switch (column) {
+    case kContainerNameColumn:
+        return usage.identity.isHost() ? ContainerIdentity::kindName(ContainerIdentity::kHost) : usage.identity.id;
+    case kContainerKindColumn:
+        return ContainerIdentity::kindName(usage.identity.kind);
+    case kContainerProcessesColumn:
+        return QString::number(usage.pids.size());
+    case kContainerCPUColumn:
+        return QString("%1%").arg(usage.cpu, 0, 'f', 1);
+    case kContainerMemoryColumn:
+        return formatUnit_memory_disk(usage.memory, KB);
+    case kContainerDiskColumn:
+        return QString("%1 / %2").arg(formatUnit_memory_disk(usage.readBps, B, 1, true)).arg(formatUnit_memory_disk(usage.writeBps, B, 1, true));
+    case kContainerNetColumn:
+        return QString("%1 / %2").arg(formatUnit_net(usage.recvBps * 8, B, 1, true)).arg(formatUnit_net(usage.sentBps * 8, B, 1, true));
+    default:
+        break;
+    }
+    return {};
+}
+
+QVariant ContainerGroupModel::processData(const Process &proc, int column) const
+{
+    switch (column) {
+    case kContainerNameColumn:
+        return QString("%1 (%2)").arg(proc.displayName()).arg(proc.pid());
+    case kContainerCPUColumn:
+        return QString("%1%").arg(proc.cpu(), 0, 'f', 1);
+    case kContainerMemoryColumn:
+        return formatUnit_memory_disk(proc.memory(), KB);
+    case kContainerDiskColumn:
+        return QString("%1 / %2").arg(formatUnit_memory_disk(proc.readBps(), B, 1, true)).arg(formatUnit_memory_disk(proc.writeBps(), B, 1, true));
+    case kContainerNetColumn:
+        return QString("%1 / %2").arg(formatUnit_net(proc.recvBps() * 8, B, 1, true)).arg(formatUnit_net(proc.sentBps() * 8, B, 1, true));
+    default:
+        break;
+    }
+    return {};
+}
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CONTAINER_GROUP_MODEL_H
+#define CONTAINER_GROUP_MODEL_H
+
+#include "process/process_set.h"
+
+#include <QAbstractItemModel>
+
+// container or app column display
+constexpr const char *kContainerName = QT_TRANSLATE_NOOP("Process.Container.Header", "Name");
+// container kind column display
+constexpr const char *kContainerKind = QT_TRANSLATE_NOOP("Process.Container.Header", "Type");
+// process count column display
+constexpr const char *kContainerProcesses = QT_TRANSLATE_NOOP("Process.Container.Header", "Processes");
+// cpu column display
+constexpr const char *kContainerCPU = QT_TRANSLATE_NOOP("Process.Container.Header", "CPU");
+// memory column display
+constexpr const char *kContainerMemory = QT_TRANSLATE_NOOP("Process.Container.Header", "Memory");
+// disk read & write column display
+constexpr const char *kContainerDisk = QT_TRANSLATE_NOOP("Process.Container.Header", "Disk read/write");
+// network download & upload column display
+constexpr const char *kContainerNet = QT_TRANSLATE_NOOP("Process.Container.Header", "Download/Upload");
+
+/**
+ * @brief Processes grouped by container, sandbox or app, with the usage of each group summed
+ *
+ * Groups are top level rows & their processes nested under them, both come from the last scan,
+ * where the own usage of each process was summed by ProcessSet. Rebuilt only for a new scan.
+ */
+class ContainerGroupModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        kContainerNameColumn = 0,
+        kContainerKindColumn,
+        kContainerProcessesColumn,
+        kContainerCPUColumn,
+        kContainerMemoryColumn,
+        kContainerDiskColumn,
+        kContainerNetColumn,
+
+        kContainerColumnCount
+    };
+
+    explicit ContainerGroupModel(QObject *parent = nullptr);
+
+    /**
+     * @brief Take the groups of the last scan, expanded groups are kept by the view
+     */
+    void refresh();
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = {}) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    QVariant groupData(const core::process::ContainerUsage &usage, int column) const;
+    QVariant processData(const core::process::Process &proc, int column) const;
+
+    core::process::ProcessSnapshotPtr m_snapshot;
+};
+
+#endif // CONTAINER_GROUP_MODEL_H
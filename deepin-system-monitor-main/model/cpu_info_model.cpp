@@ -8,6 +8,7 @@
 #include "system/cpu_set.h"
 #include "cpu_list_model.h"
 #include "system/device_db.h"
+#include "system/device_snapshot.h"
 #include "system/system_monitor.h"
 #include "system/sys_info.h"
 #include "ddlog.h"
@@ -26,7 +27,7 @@ CPUInfoModel::CPUInfoModel() : QObject(nullptr)
     m_loadAvgSampleDB.reset(new LoadAvgSample(m_period));
 
     m_sysInfo = SysInfo::instance();
-    m_cpuSet = DeviceDB::instance()->cpuSet();
+    m_snapshot = DeviceDB::instance()->snapshot();
 
     connect(SystemMonitor::instance(), &SystemMonitor::statInfoUpdated, this, &CPUInfoModel::updateModel);
 }
@@ -59,40 +60,22 @@ SysInfo *CPUInfoModel::sysInfo()
     return m_sysInfo;
 }
 
-CPUSet *CPUInfoModel::cpuSet()
+const CPUSet *CPUInfoModel::cpuSet() const
 {
     // qCDebug(app) << "CPUInfoModel::cpuSet()";
-    return m_cpuSet;
+    return &m_snapshot->cpuSet;
 }
 
 void CPUInfoModel::updateModel()
 {
     qCDebug(app) << "CPUInfoModel::updateModel()";
-    m_overallStatSample->addSample(new CPUStatSampleFrame(m_sysInfo->uptime(), std::make_shared<struct cpu_stat_t>(*m_cpuSet->stat())));
+    m_snapshot = DeviceDB::instance()->snapshot();
+    const CPUSet *cpuSet = &m_snapshot->cpuSet;
+    m_overallStatSample->addSample(CPUStatSampleFrame(m_sysInfo->uptime(), std::make_shared<struct cpu_stat_t>(*cpuSet->stat())));
 
-    m_overallUsageSample->addSample(new CPUUsageSampleFrame(m_sysInfo->uptime(), std::make_shared<struct cpu_usage_t>(*m_cpuSet->usage())));
+    m_overallUsageSample->addSample(CPUUsageSampleFrame(m_sysInfo->uptime(), std::make_shared<struct cpu_usage_t>(*cpuSet->usage())));
 
-    m_loadAvgSampleDB->addSample(new LoadAvgSampleFrame(m_sysInfo->uptime(), std::make_shared<struct load_avg_t>(*m_sysInfo->loadAvg())));
-
-    for (auto &cpuname : m_cpuSet->cpuLogicName()) {
-        if (m_singleUsageSample.contains(cpuname)) {
-            m_singleUsageSample[cpuname]->addSample(new CPUUsageSampleFrame(m_sysInfo->uptime(), std::make_shared<struct cpu_usage_t>(*m_cpuSet->usageDB(cpuname))));
-        } else {
-            // qCDebug(app) << "Creating new usage sample for cpu:" << cpuname;
-            auto smaple = std::make_shared<Sample<cpu_usage_t>>(m_period);
-            smaple->addSample(new CPUUsageSampleFrame(m_sysInfo->uptime(), std::make_shared<struct cpu_usage_t>(*m_cpuSet->usageDB(cpuname))));
-            m_singleUsageSample.insert(cpuname, smaple);
-        }
-
-//        auto model = std::make_shared<CPUStatModel>(m_period, this);
-//        if (model && model->m_statSampleDB)
-//            model->m_statSampleDB->addSample(new CPUStatSampleFrame(m_sysInfo->uptime(), std::make_shared<struct cpu_stat_t>(*m_cpuSet->statDB(cpuname))));
-
-//        if (model && model->m_usageSampleDB)
-//            model->m_usageSampleDB->addSample(new CPUUsageSampleFrame(m_sysInfo->uptime(), std::make_shared<struct cpu_usage_t>(*m_cpuSet->usageDB(cpuname))));
-
-//        m_cpuListModel->m_statModelDB[info.logicalName()] = model;
-    } // ::for
+    m_loadAvgSampleDB->addSample(LoadAvgSampleFrame(m_sysInfo->uptime(), std::make_shared<struct load_avg_t>(*m_sysInfo->loadAvg())));
 
     emit modelUpdated();
 } // ::updateModel
@@ -101,11 +84,9 @@ QList<qreal> CPUInfoModel::cpuPercentList() const
 {
     qCDebug(app) << "CPUInfoModel::cpuPercentList()";
     QList<qreal> percentList;
-    const auto &usageSampleList = m_singleUsageSample.values();
-    for (const auto &sample : usageSampleList) {
-        const auto &pair = sample->recentSamplePair();
-        percentList << CPUUsageSampleFrame::cpupc(pair.first, pair.second);
-    }
+    // per cpu usage is kept in cpu id order by CPUSet, no per cpu history needed here
+    for (int cpu : m_snapshot->cpuSet.cpuIds())
+        percentList << m_snapshot->cpuSet.cpuUsagePercent(cpu);
     return percentList;
 }
 
@@ -124,6 +105,29 @@ QString CPUInfoModel::loadavg() const
     return buffer;
 }
 
+QString CPUInfoModel::runQueueWait() const
+{
+    // qCDebug(app) << "CPUInfoModel::runQueueWait()";
+    qreal wait = m_sysInfo->runQueueWait();
+    if (wait < 0)
+        return "-";
+    return QString("%1%").arg(wait, 0, 'f', 1);
+}
+
+QString CPUInfoModel::coreRunQueue(int cpu, bool *oversubscribed) const
+{
+    const common::usage::CoreRunQueue &queue = cpuSet()->coreRunQueue();
+    if (oversubscribed)
+        *oversubscribed = false;
+    if (cpu < 0 || cpu >= queue.size())
+        return {};
+
+    const double runnable = queue.runnable[size_t(cpu)];
+    if (oversubscribed)
+        *oversubscribed = runnable > 1.;
+    return tr("%1 runnable, %2 ms wait").arg(runnable, 0, 'f', 1).arg(queue.latency[size_t(cpu)], 0, 'f', 2);
+}
+
 uint CPUInfoModel::nProcesses() const
 {
     // qCDebug(app) << "CPUInfoModel::nProcesses()";
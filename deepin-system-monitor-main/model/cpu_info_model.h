@@ -9,6 +9,7 @@
 #include "common/sample.h"
 #include "common/common.h"
 #include "system/sys_info.h"
+#include "system/device_db.h"
 #include "cpu_stat_model.h"
 
 #include <QObject>
@@ -71,9 +72,21 @@ public:
     QString osType() const;
     QString osVersion() const;
     QString uptime() const;
+    /**
+     * @brief Run queue wait of all cpus, "-" without /proc/schedstat
+     */
+    QString runQueueWait() const;
+    /**
+     * @brief Runnable tasks & their mean wait on a cpu in the last interval, empty without /proc/schedstat
+     * @param oversubscribed Set if more tasks were runnable than the cpu could run at once
+     */
+    QString coreRunQueue(int cpu, bool *oversubscribed = nullptr) const;
 
     SysInfo *sysInfo();
-    CPUSet *cpuSet();
+    /**
+     * @brief Cpu state of the snapshot taken on last update, valid until next update
+     */
+    const CPUSet *cpuSet() const;
 
 signals:
     void modelUpdated();
@@ -87,10 +100,8 @@ private:
     std::unique_ptr<Sample<cpu_usage_t>> m_overallUsageSample;
     std::unique_ptr<Sample<load_avg_t>> m_loadAvgSampleDB; // for loadavg monitoring extends
 
-    QMap<QByteArray, std::shared_ptr<Sample<cpu_usage_t>>> m_singleUsageSample;
-
     SysInfo *m_sysInfo;
-    CPUSet *m_cpuSet;
+    DeviceSnapshotPtr m_snapshot;
 };
 
 #endif // CPU_INFO_MODEL_H
@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "cpu_irq_model.h"
+#include "ddlog.h"
+#include "common/core_usage.h"
+#include "model/cpu_info_model.h"
+#include "system/cpu_set.h"
+
+#include <QApplication>
+
+#include <cmath>
+
+using namespace DDLog;
+
+CPUIrqModel::CPUIrqModel(CPUInfoModel *model, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_model(model)
+{
+    qCDebug(app) << "CPUIrqModel constructor";
+    if (m_model) {
+        connect(m_model, &CPUInfoModel::modelUpdated, this, &CPUIrqModel::onModelUpdated);
+        onModelUpdated();
+    }
+}
+
+void CPUIrqModel::onModelUpdated()
+{
+    const core::system::CPUSet *cpuSet = m_model->cpuSet();
+    if (cpuSet)
+        applyUsage(cpuSet->cpuIds(), cpuSet->coreUsage());
+}
+
+void CPUIrqModel::applyUsage(const QVector<int> &cpuIds, const common::usage::CoreUsage &usage)
+{
+    QVector<core_irq_t> cores;
+    cores.reserve(cpuIds.size());
+    for (int cpu : cpuIds) {
+        if (cpu < 0 || cpu >= usage.size())
+            continue;
+        cores << core_irq_t {cpu, usage.hardirq[size_t(cpu)], usage.softirq[size_t(cpu)]};
+    }
+
+    // cores only change across hotplug, refresh values in place otherwise
+    bool sameCores = cores.size() == m_cores.size();
+    for (int i = 0; sameCores && i < cores.size(); ++i)
+        sameCores = cores[i].cpu == m_cores[i].cpu;
+
+    if (sameCores) {
+        m_cores = cores;
+        if (!m_cores.isEmpty())
+            emit dataChanged(index(0, kCPUIrqHardColumn), index(m_cores.size() - 1, kCPUIrqSoftColumn));
+        return;
+    }
+
+    beginResetModel();
+    m_cores = cores;
+    endResetModel();
+}
+
+int CPUIrqModel::rowCount(const QModelIndex &) const
+{
+    return m_cores.size();
+}
+
+int CPUIrqModel::columnCount(const QModelIndex &) const
+{
+    return kCPUIrqColumnCount;
+}
+
+QVariant CPUIrqModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && (role == Qt::DisplayRole || role == Qt::AccessibleTextRole)) {
+        switch (section) {
+        case kCPUIrqCoreColumn:
+            return QApplication::translate("CPU.Irq.Header", kCPUIrqCore);
+        case kCPUIrqHardColumn:
+            return QApplication::translate("CPU.Irq.Header", kCPUIrqHard);
+        case kCPUIrqSoftColumn:
+            return QApplication::translate("CPU.Irq.Header", kCPUIrqSoft);
+        default:
+            break;
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+QVariant CPUIrqModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_cores.size())
+        return {};
+
+    const auto &core = m_cores[index.row()];
+    if (role == Qt::DisplayRole || role == Qt::AccessibleTextRole) {
+        // no time elapsed between the stat reads
+        auto percent = [](qreal value) {
+            return std::isnan(value) ? QStringLiteral("-") : QString("%1%").arg(value, 0, 'f', 1);
+        };
+        switch (index.column()) {
+        case kCPUIrqCoreColumn:
+            return QString("CPU%1").arg(core.cpu);
+        case kCPUIrqHardColumn:
+            return percent(core.hardirq);
+        case kCPUIrqSoftColumn:
+            return percent(core.softirq);
+        default:
+            break;
+        }
+    } else if (role == Qt::UserRole) {
+        switch (index.column()) {
+        case kCPUIrqCoreColumn:
+            return core.cpu;
+        case kCPUIrqHardColumn:
+            return core.hardirq;
+        case kCPUIrqSoftColumn:
+            return core.softirq;
+        default:
+            break;
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return {};
+}
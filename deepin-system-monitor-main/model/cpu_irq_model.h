@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CPU_IRQ_MODEL_H
+#define CPU_IRQ_MODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+
+namespace common {
+namespace usage {
+struct CoreUsage;
+}
+}
+
+class CPUInfoModel;
+
+// core column display
+constexpr const char *kCPUIrqCore = QT_TRANSLATE_NOOP("CPU.Irq.Header", "CPU");
+// hard irq column display
+constexpr const char *kCPUIrqHard = QT_TRANSLATE_NOOP("CPU.Irq.Header", "IRQ");
+// softirq column display
+constexpr const char *kCPUIrqSoft = QT_TRANSLATE_NOOP("CPU.Irq.Header", "SoftIRQ");
+
+/**
+ * @brief Share of time each core spent in hard irq & softirq handlers
+ *
+ * Follows CPUInfoModel updates, figures come from the hardirq & softirq jiffies of /proc/stat
+ * between the last two reads, so they need neither DKapture nor the system service.
+ */
+class CPUIrqModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        kCPUIrqCoreColumn = 0,
+        kCPUIrqHardColumn,
+        kCPUIrqSoftColumn,
+
+        kCPUIrqColumnCount
+    };
+
+    explicit CPUIrqModel(CPUInfoModel *model, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    struct core_irq_t {
+        int cpu;
+        qreal hardirq;
+        qreal softirq;
+    };
+
+    void onModelUpdated();
+    /**
+     * @brief Update rows of \a cpuIds from \a usage, indexed by cpu id
+     */
+    void applyUsage(const QVector<int> &cpuIds, const common::usage::CoreUsage &usage);
+
+    CPUInfoModel *m_model;
+    QVector<core_irq_t> m_cores {};
+};
+
+#endif // CPU_IRQ_MODEL_H
@@ -0,0 +1,145 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "cpu_profile_model.h"
+#include "ddlog.h"
+#include "common/task_executor.h"
+#include "process/system_service_client.h"
+#include "process_info_record.h"
+
+#include <DConfig>
+
+#include <QMutex>
+#include <QScopedPointer>
+
+using namespace DDLog;
+using namespace common::core;
+using namespace core::process;
+
+struct CpuProfileModel::fold_t {
+    QMutex mutex;
+    CpuProfile profile;
+    bool done {false};
+};
+
+CpuProfileModel::CpuProfileModel(pid_t pid, QObject *parent)
+    : QObject(parent)
+    , m_pid(pid)
+{
+    qCDebug(app) << "CpuProfileModel constructor for pid:" << pid;
+}
+
+CpuProfileModel::~CpuProfileModel()
+{
+    cancel();
+}
+
+bool CpuProfileModel::start(int duration)
+{
+    if (!m_client) {
+        // stacks are sampled by the system server, follow the process table setting
+        QScopedPointer<DTK_CORE_NAMESPACE::DConfig> config(DTK_CORE_NAMESPACE::DConfig::create("deepin-system-monitor", "org.deepin.system-monitor"));
+        if (!config || !config->value("enable_dkapture", false).toBool()) {
+            qCDebug(app) << "DKapture disabled, no cpu profile for pid:" << m_pid;
+            m_available = false;
+            return false;
+        }
+        m_client = new SystemServiceClient(this);
+        connect(m_client, &SystemServiceClient::cpuProfileStarted, this, &CpuProfileModel::onStarted);
+    }
+
+    if (!m_client->startCpuProfile(m_pid, duration, kFrequency)) {
+        qCWarning(app) << "Cpu profile of pid" << m_pid << "could not be started";
+        m_available = false;
+        setState(kProfileFailed);
+        return false;
+    }
+
+    m_fold.reset();
+    m_profile = CpuProfile();
+    m_duration = duration;
+    m_elapsed = 0;
+    m_samples = 0;
+    m_lost = 0;
+    m_threads = 0;
+    setState(kProfileStarting);
+    return true;
+}
+
+void CpuProfileModel::onStarted(pid_t pid, bool started)
+{
+    if (pid != m_pid || m_state != kProfileStarting)
+        return;
+    if (!started)
+        qCWarning(app) << "Cpu profile of pid" << m_pid << "refused, another profile may be running";
+    setState(started ? kProfileRunning : kProfileFailed);
+}
+
+void CpuProfileModel::refresh()
+{
+    if (m_state == kProfileFolding) {
+        {
+            QMutexLocker locker(&m_fold->mutex);
+            if (!m_fold->done)
+                return;
+            m_profile = m_fold->profile;
+        }
+        m_fold.reset();
+        setState(kProfileFinished);
+        return;
+    }
+    if (m_state != kProfileRunning)
+        return;
+
+    QByteArray buf;
+    if (!m_client->getCpuProfile(buf))
+        return;
+    const cpu_profile_stack_t *stacks = nullptr;
+    const cpu_profile_symbol_t *symbols = nullptr;
+    const cpu_profile_mapping_t *mappings = nullptr;
+    const cpu_profile_header_t *hdr = cpuProfileRecords(buf.constData(), size_t(buf.size()), stacks, symbols, mappings);
+    m_elapsed = int(hdr->elapsed);
+    m_samples = hdr->samples;
+    m_lost = hdr->lost;
+    m_threads = int(hdr->threads);
+    switch (hdr->state) {
+    case CPU_PROFILE_RUNNING:
+        Q_EMIT progressed();
+        return;
+    case CPU_PROFILE_FAILED:
+        setState(kProfileFailed);
+        return;
+    default:
+        break;
+    }
+
+    // the thread only shares the fold, the model may be gone before it ends
+    const pid_t pid = m_pid;
+    auto fold = std::make_shared<fold_t>();
+    m_fold = fold;
+    TaskExecutor::instance()->run(TaskExecutor::kBackgroundTask, [pid, buf, fold]() {
+        CpuProfile profile;
+        profile.fold(buf, pid);
+        QMutexLocker locker(&fold->mutex);
+        fold->profile = profile;
+        fold->done = true;
+    });
+    setState(kProfileFolding);
+}
+
+void CpuProfileModel::cancel()
+{
+    if (m_state != kProfileRunning && m_state != kProfileStarting)
+        return;
+    m_client->stopCpuProfile();
+    // sampling ends in the background, the samples so far come with the next refresh()
+}
+
+void CpuProfileModel::setState(ProfileState state)
+{
+    if (m_state == state)
+        return;
+    m_state = state;
+    emit stateChanged(state);
+}
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CPU_PROFILE_MODEL_H
+#define CPU_PROFILE_MODEL_H
+
+#include "process/cpu_profile.h"
+
+#include <QObject>
+
+#include <memory>
+
+namespace core {
+namespace process {
+class SystemServiceClient;
+}
+}
+
+/**
+ * @brief Cpu profile of a single process, sampled by the system server for a fixed time
+ *
+ * The server samples the user & kernel stacks of the threads of the process only & returns
+ * them once the time is up, refresh() polls for it. The stacks are symbolized & folded into
+ * the call tree on a background thread, the files of a large process take a while to read.
+ * Without the system service nothing can be sampled, see isAvailable().
+ */
+class CpuProfileModel : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum ProfileState {
+        kProfileIdle = 0,
+        kProfileStarting, // waiting for the server, or the authorization of another user's process
+        kProfileRunning,
+        kProfileFolding,
+        kProfileFinished,
+        kProfileFailed
+    };
+
+    explicit CpuProfileModel(pid_t pid, QObject *parent = nullptr);
+    ~CpuProfileModel() override;
+
+    /**
+     * @brief Start a profile, the previous one is dropped
+     * @param duration Sampling time, ms
+     * @return false if DKapture is disabled or the system service unusable
+     */
+    bool start(int duration);
+    /**
+     * @brief Update the progress of the running profile & pick up its call tree once folded
+     */
+    void refresh();
+    /**
+     * @brief Stop sampling early, the samples taken so far are folded
+     */
+    void cancel();
+
+    /**
+     * @brief false once a profile could not be started, DKapture disabled or the system service unusable
+     */
+    inline bool isAvailable() const { return m_available; }
+    inline ProfileState state() const { return m_state; }
+    // sampled so far & requested, ms
+    inline int elapsed() const { return m_elapsed; }
+    inline int duration() const { return m_duration; }
+    inline quint64 samples() const { return m_samples; }
+    inline quint64 lost() const { return m_lost; }
+    inline int threads() const { return m_threads; }
+    inline const core::process::CpuProfile &profile() const { return m_profile; }
+
+    // samples per second of each thread, off the timer ticks so they don't sample in lockstep
+    static const int kFrequency = 99;
+
+signals:
+    void stateChanged(CpuProfileModel::ProfileState state);
+    /**
+     * @brief Elapsed time or samples changed while running
+     */
+    void progressed();
+
+private:
+    // folded call tree, shared with the fold thread until it ends
+    struct fold_t;
+
+    void onStarted(pid_t pid, bool started);
+    void setState(ProfileState state);
+
+    pid_t m_pid;
+    core::process::SystemServiceClient *m_client {};
+    bool m_available {true};
+    ProfileState m_state {kProfileIdle};
+    int m_elapsed {0};
+    int m_duration {0};
+    quint64 m_samples {0};
+    quint64 m_lost {0};
+    int m_threads {0};
+    core::process::CpuProfile m_profile;
+    std::shared_ptr<fold_t> m_fold;
+};
+
+#endif // CPU_PROFILE_MODEL_H
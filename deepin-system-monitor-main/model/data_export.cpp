@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "data_export.h"
+#include "sample_history.h"
+#include "ddlog.h"
+#include "common/history_store.h"
+#include "common/task_executor.h"
+
+#include <QElapsedTimer>
+#include <QSaveFile>
+
+#include <functional>
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+using namespace DDLog;
+using namespace common::core;
+using namespace common::record;
+using namespace common::history;
+using namespace core::process;
+
+namespace {
+
+// ISO 8601 in UTC with ms, e.g. 2024-01-02T03:00:00.000Z
+int formatTime(qint64 ms, char *out, size_t size)
+{
+    time_t seconds = time_t(ms / 1000);
+    struct tm tm {};
+    gmtime_r(&seconds, &tm);
+    return snprintf(out, size, "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ", tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                    tm.tm_hour, tm.tm_min, tm.tm_sec, int(ms % 1000));
+}
+
+DataExport::result_t writeFile(const QString &path, const QStringList &fields,
+                               const std::function<qint64(RecordWriter &)> &write)
+{
+    QElapsedTimer timer;
+    timer.start();
+    DataExport::result_t result;
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        result.error = file.errorString();
+        qCWarning(app) << "Failed to export to" << path << result.error;
+        return result;
+    }
+
+    RecordWriter writer(&file, RecordWriter::formatOf(path), fields);
+    result.records = write(writer);
+    // replaced at once, a half written export never shows up
+    if (!writer.finish() || !file.commit()) {
+        result.error = file.errorString();
+        result.records = 0;
+        file.cancelWriting();
+        qCWarning(app) << "Failed to export to" << path << result.error;
+        return result;
+    }
+    qCInfo(app) << "Exported" << result.records << "records to" << path << "in" << timer.elapsed() << "ms";
+    return result;
+}
+
+} // namespace
+
+QStringList DataExport::processFields()
+{
+    return {"pid", "ppid", "name", "user", "uid", "state", "threads", "cpu", "memory_kb", "shared_memory_kb",
+            "virtual_memory_kb", "disk_read_bps", "disk_write_bps", "recv_bps", "sent_bps", "utime", "stime",
+            "read_bytes", "write_bytes"};
+}
+
+QStringList DataExport::historyFields()
+{
+    return {"time", "metric", "device", "value"};
+}
+
+qint64 DataExport::writeProcesses(RecordWriter &writer, const ProcessColumns &columns, const QVector<pid_t> &pids)
+{
+    qint64 records = 0;
+    for (pid_t pid : pids) {
+        // exited since the rows were shown
+        int slot = columns.slotOf(pid);
+        if (slot < 0)
+            continue;
+
+        writer.add(qint64(pid));
+        writer.add(qint64(columns.ppid(slot)));
+        writer.add(columns.name(slot));
+        writer.add(columns.userName(slot));
+        writer.add(qint64(columns.uid(slot)));
+        const char state = columns.state(slot);
+        writer.add(&state, state ? 1 : 0);
+        writer.add(qint64(columns.nthreads(slot)));
+        writer.add(double(columns.rate(ProcessColumns::kCpuRate, slot)));
+        writer.add(qint64(columns.counter(ProcessColumns::kMemory, slot)));
+        writer.add(qint64(columns.counter(ProcessColumns::kShareMemory, slot)));
+        writer.add(qint64(columns.counter(ProcessColumns::kVirtualMemory, slot)));
+        writer.add(double(columns.rate(ProcessColumns::kReadRate, slot)));
+        writer.add(double(columns.rate(ProcessColumns::kWriteRate, slot)));
+        writer.add(double(columns.rate(ProcessColumns::kRecvRate, slot)));
+        writer.add(double(columns.rate(ProcessColumns::kSentRate, slot)));
+        writer.add(qint64(columns.counter(ProcessColumns::kUtime, slot)));
+        writer.add(qint64(columns.counter(ProcessColumns::kStime, slot)));
+        writer.add(qint64(columns.counter(ProcessColumns::kReadBytes, slot)));
+        writer.add(qint64(columns.counter(ProcessColumns::kWriteBytes, slot)));
+        if (!writer.endRecord())
+            break;
+        ++records;
+    }
+    return records;
+}
+
+qint64 DataExport::writeHistory(RecordWriter &writer, HistoryReader &reader, qint64 from, qint64 to)
+{
+    qint64 records = 0;
+    bool ok = true;
+    char time[32];
+    reader.scan(from, to, [&](int metric, const std::string &device, const std::vector<Sample> &samples) {
+        const char *name = SampleHistory::metricName(metric);
+        const int nameSize = int(strlen(name));
+        for (const Sample &sample : samples) {
+            if (!ok)
+                return;
+            writer.add(time, formatTime(sample.time, time, sizeof(time)));
+            writer.add(name, nameSize);
+            writer.add(device.data(), int(device.size()));
+            writer.add(sample.value);
+            ok = writer.endRecord();
+            records += ok;
+        }
+    });
+    return records;
+}
+
+QFuture<DataExport::result_t> DataExport::exportProcesses(const QString &path, const ProcessColumnsPtr &columns,
+                                                          const QVector<pid_t> &pids)
+{
+    return TaskExecutor::instance()->run(TaskExecutor::kBackgroundTask, [path, columns, pids]() {
+        return writeFile(path, processFields(), [&columns, &pids](RecordWriter &writer) {
+            return columns ? writeProcesses(writer, *columns, pids) : 0;
+        });
+    });
+}
+
+QFuture<DataExport::result_t> DataExport::exportHistory(const QString &path, qint64 from, qint64 to)
+{
+    return TaskExecutor::instance()->run(TaskExecutor::kBackgroundTask, [path, from, to]() {
+        // a reader of its own, the one of SampleHistory belongs to the UI thread
+        HistoryReader reader(SampleHistory::storeDirectory().toStdString());
+        return writeFile(path, historyFields(), [&reader, from, to](RecordWriter &writer) {
+            return writeHistory(writer, reader, from, to);
+        });
+    });
+}
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DATA_EXPORT_H
+#define DATA_EXPORT_H
+
+#include "common/record_writer.h"
+#include "process/process_columns.h"
+
+#include <QFuture>
+#include <QString>
+#include <QVector>
+
+#include <sys/types.h>
+
+class QIODevice;
+
+namespace common {
+namespace history {
+class HistoryReader;
+}
+}
+
+/**
+ * @brief Export of the process table & of the on-disk metric history as CSV or JSON lines
+ *
+ * Records are written on a background thread straight from the columnar process snapshot & the
+ * history blocks, never through a model's data(), so a table of 50k rows or a week of samples is
+ * written in seconds & the UI keeps running. Files are replaced at once when complete, a failed
+ * export leaves nothing behind.
+ */
+class DataExport
+{
+public:
+    struct result_t {
+        qint64 records {0};
+        QString error; // empty on success
+    };
+
+    /**
+     * @brief Write the processes of \a pids, in that order, pids missing from \a columns are skipped
+     */
+    static qint64 writeProcesses(common::record::RecordWriter &writer, const core::process::ProcessColumns &columns,
+                                 const QVector<pid_t> &pids);
+    /**
+     * @brief Write the raw samples of [from, to), one record per sample
+     */
+    static qint64 writeHistory(common::record::RecordWriter &writer, common::history::HistoryReader &reader, qint64 from,
+                               qint64 to);
+    /**
+     * @brief Field names of the records, in the order they are written
+     */
+    static QStringList processFields();
+    static QStringList historyFields();
+
+    /**
+     * @brief Export rows of the process table in the background, the format is the one of the file name
+     * @param pids Shown rows in view order, taken on the UI thread
+     */
+    static QFuture<result_t> exportProcesses(const QString &path, const core::process::ProcessColumnsPtr &columns,
+                                             const QVector<pid_t> &pids);
+    /**
+     * @brief Export the stored samples of [from, to) in the background, ms since epoch
+     *
+     * Samples still buffered by the history writer, at most the last block of each series, are not on disk yet.
+     */
+    static QFuture<result_t> exportHistory(const QString &path, qint64 from, qint64 to);
+};
+
+#endif // DATA_EXPORT_H
@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "disk_health_model.h"
+#include "ddlog.h"
+#include "process/system_service_client.h"
+
+using namespace DDLog;
+using namespace core::process;
+
+DiskHealthModel::DiskHealthModel(QObject *parent)
+    : QObject(parent)
+{
+    qCDebug(app) << "DiskHealthModel constructor";
+}
+
+DiskHealthModel::~DiskHealthModel()
+{
+    stop();
+}
+
+void DiskHealthModel::refresh()
+{
+    if (!m_opened) {
+        if (!m_client)
+            m_client = new SystemServiceClient(this);
+        m_opened = m_client->openDiskHealth();
+        m_available = m_opened;
+        if (!m_opened) {
+            qCDebug(app) << "System service unusable, no disk health";
+            return;
+        }
+    }
+
+    QByteArray health;
+    if (!m_client->getDiskHealth(health))
+        return;
+    applyHealth(health);
+}
+
+void DiskHealthModel::stop()
+{
+    if (m_opened) {
+        m_client->closeDiskHealth();
+        m_opened = false;
+    }
+    m_records.clear();
+    m_last.clear();
+}
+
+void DiskHealthModel::applyHealth(const QByteArray &health)
+{
+    const disk_health_record_t *records = nullptr;
+    const disk_health_header_t *hdr = diskHealthRecords(health.constData(), size_t(health.size()), records);
+    if (!hdr)
+        return;
+
+    // disks are read every few minutes, most fetches bring the same records
+    const QByteArray body = health.mid(int(sizeof(disk_health_header_t)));
+    if (body == m_last && !m_records.isEmpty())
+        return;
+    m_last = body;
+
+    m_records.clear();
+    for (uint32_t i = 0; i < hdr->count; ++i) {
+        const disk_health_record_t &rec = records[i];
+        const QString name = QString::fromLocal8Bit(rec.name, int(qstrnlen(rec.name, DISK_HEALTH_NAME_LEN)));
+        if (!name.isEmpty())
+            m_records.insert(name, rec);
+    }
+
+    Q_EMIT updated();
+}
+
+bool DiskHealthModel::health(const QString &device, disk_health_record_t &rec) const
+{
+    auto it = m_records.constFind(device);
+    if (it == m_records.constEnd())
+        return false;
+    rec = *it;
+    return true;
+}
+
+QString DiskHealthModel::stateText(const disk_health_record_t &rec)
+{
+    switch (rec.state) {
+    case DISK_HEALTH_OK:
+        return tr("Good");
+    case DISK_HEALTH_WARNING:
+        return tr("Warning");
+    case DISK_HEALTH_FAILING:
+        return tr("Failing");
+    case DISK_HEALTH_SLEEPING:
+        return tr("Sleeping");
+    case DISK_HEALTH_ERROR:
+        return tr("Unknown");
+    default:
+        // not read yet or no SMART
+        return QString();
+    }
+}
+
+QString DiskHealthModel::temperatureText(const disk_health_record_t &rec)
+{
+    // the last value of a disk asleep or not answering is stale
+    if (rec.temperature == DISK_HEALTH_NO_TEMPERATURE || rec.state == DISK_HEALTH_SLEEPING || rec.state == DISK_HEALTH_ERROR)
+        return QString();
+    return QString("%1%2C").arg(rec.temperature).arg(QChar(0x00b0));
+}
+
+QString DiskHealthModel::summaryText(const disk_health_record_t &rec)
+{
+    const QString temperature = temperatureText(rec);
+    const QString state = stateText(rec);
+    if (temperature.isEmpty() || state.isEmpty())
+        return temperature + state;
+    return QString("%1 %2").arg(temperature).arg(state);
+}
+
+bool DiskHealthModel::isWarning(const disk_health_record_t &rec)
+{
+    return rec.state == DISK_HEALTH_WARNING || rec.state == DISK_HEALTH_FAILING;
+}
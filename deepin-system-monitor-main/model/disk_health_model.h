@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DISK_HEALTH_MODEL_H
+#define DISK_HEALTH_MODEL_H
+
+#include "process_info_record.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QString>
+
+namespace core {
+namespace process {
+class SystemServiceClient;
+}
+}
+
+/**
+ * @brief SMART / NVMe health & temperature of every disk
+ *
+ * Disks are read by the system server on its own thread every DISK_HEALTH_INTERVAL, refresh()
+ * only fetches the cached records so it never waits for a disk. Nothing is read until refresh()
+ * is called & reading stops with stop(). Without the system service the model stays empty,
+ * see isAvailable().
+ */
+class DiskHealthModel : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DiskHealthModel(QObject *parent = nullptr);
+    ~DiskHealthModel() override;
+
+    /**
+     * @brief Start reading if needed & fetch the latest records
+     */
+    void refresh();
+    /**
+     * @brief Stop reading & drop the records
+     */
+    void stop();
+
+    /**
+     * @brief false once reading could not be started, the system service unusable
+     */
+    inline bool isAvailable() const { return m_available; }
+
+    /**
+     * @brief Latest record of \a device, e.g. nvme0n1
+     * @return false if the disk wasn't reported
+     */
+    bool health(const QString &device, disk_health_record_t &rec) const;
+
+    /**
+     * @brief Short text of a record, temperature & state, empty while nothing is known
+     */
+    static QString summaryText(const disk_health_record_t &rec);
+    static QString stateText(const disk_health_record_t &rec);
+    static QString temperatureText(const disk_health_record_t &rec);
+    /**
+     * @brief Whether the disk reports a problem worth a warning color
+     */
+    static bool isWarning(const disk_health_record_t &rec);
+
+Q_SIGNALS:
+    void updated();
+
+private:
+    /**
+     * @brief Replace the records from a getDiskHealth buffer
+     */
+    void applyHealth(const QByteArray &health);
+
+    core::process::SystemServiceClient *m_client {};
+    bool m_opened {false};
+    bool m_available {true};
+    QHash<QString, disk_health_record_t> m_records {};
+    // records of the last buffer, unchanged buffers aren't applied
+    QByteArray m_last {};
+};
+
+#endif // DISK_HEALTH_MODEL_H
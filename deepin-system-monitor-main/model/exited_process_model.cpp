@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "exited_process_model.h"
+#include "ddlog.h"
+#include "common/common.h"
+#include "process/process_db.h"
+#include "process/process_set.h"
+
+#include <QApplication>
+#include <QDateTime>
+
+using namespace DDLog;
+using namespace common::format;
+using namespace core::process;
+
+ExitedProcessModel::ExitedProcessModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_rollups(std::make_shared<const ExitedProcessRollups>())
+{
+    qCDebug(app) << "ExitedProcessModel constructor";
+}
+
+void ExitedProcessModel::refresh()
+{
+    const ProcessSnapshotPtr snapshot = ProcessDB::instance()->processSet()->snapshot();
+    if (snapshot->exitsRecorded != m_recording) {
+        m_recording = snapshot->exitsRecorded;
+        Q_EMIT recordingChanged(m_recording);
+    }
+    // rollups are shared between scans until something exits
+    if (snapshot->exited == m_rollups)
+        return;
+
+    beginResetModel();
+    m_rollups = snapshot->exited;
+    endResetModel();
+}
+
+QString ExitedProcessModel::durationText(qulonglong usecs)
+{
+    if (usecs < 1000000)
+        return QApplication::translate("Process.Exited", "%1 ms").arg(qreal(usecs) / 1000., 0, 'f', 1);
+    return QApplication::translate("Process.Exited", "%1 s").arg(qreal(usecs) / 1000000., 0, 'f', 2);
+}
+
+int ExitedProcessModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rollups->size();
+}
+
+int ExitedProcessModel::columnCount(const QModelIndex &) const
+{
+    return kExitedColumnCount;
+}
+
+QVariant ExitedProcessModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && (role == Qt::DisplayRole || role == Qt::AccessibleTextRole)) {
+        switch (section) {
+        case kExitedNameColumn:
+            return QApplication::translate("Process.Exited.Header", kExitedName);
+        case kExitedCountColumn:
+            return QApplication::translate("Process.Exited.Header", kExitedCount);
+        case kExitedCPUTimeColumn:
+            return QApplication::translate("Process.Exited.Header", kExitedCPUTime);
+        case kExitedMemoryColumn:
+            return QApplication::translate("Process.Exited.Header", kExitedMemory);
+        case kExitedLifetimeColumn:
+            return QApplication::translate("Process.Exited.Header", kExitedLifetime);
+        case kExitedLastColumn:
+            return QApplication::translate("Process.Exited.Header", kExitedLast);
+        default:
+            break;
+        }
+    } else if (orientation == Qt::Horizontal && role == Qt::ToolTipRole) {
+        if (section == kExitedCPUTimeColumn)
+            return QApplication::translate("Process.Exited.Header", "User & system time of all exited threads");
+        if (section == kExitedMemoryColumn)
+            return QApplication::translate("Process.Exited.Header", "Highest resident memory of a single process");
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+QVariant ExitedProcessModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_rollups->size())
+        return {};
+
+    const ExitedProcessRollup &rollup = m_rollups->at(index.row());
+    if (role == Qt::DisplayRole || role == Qt::AccessibleTextRole) {
+        switch (index.column()) {
+        case kExitedNameColumn:
+            return rollup.name;
+        case kExitedCountColumn:
+            return QString::number(rollup.processes);
+        case kExitedCPUTimeColumn:
+            return durationText(rollup.cpuTime);
+        case kExitedMemoryColumn:
+            return formatUnit_memory_disk(rollup.maxRss, KB);
+        case kExitedLifetimeColumn:
+            return rollup.processes > 0 ? durationText(rollup.maxElapsed) : QStringLiteral("-");
+        case kExitedLastColumn:
+            return QDateTime::fromMSecsSinceEpoch(rollup.lastExit).toString("hh:mm:ss");
+        default:
+            break;
+        }
+    } else if (role == Qt::ToolTipRole && index.column() == kExitedCountColumn) {
+        return QApplication::translate("Process.Exited", "%1 threads, last pid %2").arg(rollup.tasks).arg(rollup.lastPid);
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return {};
+}
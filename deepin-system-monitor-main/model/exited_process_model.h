@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef EXITED_PROCESS_MODEL_H
+#define EXITED_PROCESS_MODEL_H
+
+#include "process/exited_process_log.h"
+
+#include <QAbstractTableModel>
+
+// name column display
+constexpr const char *kExitedName = QT_TRANSLATE_NOOP("Process.Exited.Header", "Name");
+// exited process count column display
+constexpr const char *kExitedCount = QT_TRANSLATE_NOOP("Process.Exited.Header", "Exited");
+// total cpu time column display
+constexpr const char *kExitedCPUTime = QT_TRANSLATE_NOOP("Process.Exited.Header", "CPU time");
+// peak memory column display
+constexpr const char *kExitedMemory = QT_TRANSLATE_NOOP("Process.Exited.Header", "Peak memory");
+// longest lifetime column display
+constexpr const char *kExitedLifetime = QT_TRANSLATE_NOOP("Process.Exited.Header", "Longest run");
+// last exit column display
+constexpr const char *kExitedLast = QT_TRANSLATE_NOOP("Process.Exited.Header", "Last exited");
+
+/**
+ * @brief Recently exited processes by command name, short lived ones no scan has seen included
+ *
+ * Rows are the rollups published with each process scan, most cpu time first, the model is
+ * only reset when they changed.
+ */
+class ExitedProcessModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        kExitedNameColumn = 0,
+        kExitedCountColumn,
+        kExitedCPUTimeColumn,
+        kExitedMemoryColumn,
+        kExitedLifetimeColumn,
+        kExitedLastColumn,
+
+        kExitedColumnCount
+    };
+
+    explicit ExitedProcessModel(QObject *parent = nullptr);
+
+    /**
+     * @brief Take the rollups of the last scan
+     */
+    void refresh();
+    /**
+     * @brief Whether exits are recorded at all, taskstats listeners need CAP_NET_ADMIN
+     */
+    inline bool isRecording() const
+    {
+        return m_recording;
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Readable cpu time or lifetime of \a usecs, e.g. 1.25 s
+     */
+    static QString durationText(qulonglong usecs);
+
+Q_SIGNALS:
+    void recordingChanged(bool recording);
+
+private:
+    core::process::ExitedProcessRollupsPtr m_rollups;
+    bool m_recording {false};
+};
+
+#endif // EXITED_PROCESS_MODEL_H
@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "filesystem_model.h"
+#include "model_manager.h"
+#include "update_coordinator.h"
+#include "system/device_db.h"
+#include "system/device_snapshot.h"
+#include "common/common.h"
+#include "ddlog.h"
+
+#include <DPalette>
+
+#include <QApplication>
+
+using namespace DDLog;
+using namespace common::format;
+using namespace core::system;
+
+namespace {
+
+qreal usagePercent(const filesystem_t &fs)
+{
+    // df's rounding: root reserved blocks count neither as used nor as available
+    qulonglong usable = fs.used + fs.available;
+    return usable > 0 ? fs.used * 100. / usable : 0.;
+}
+
+} // namespace
+
+FilesystemModel::FilesystemModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+    qCDebug(app) << "FilesystemModel constructor";
+    connect(ModelManager::instance()->updateCoordinator(), &UpdateCoordinator::updateViews, this, &FilesystemModel::refresh);
+    refresh();
+}
+
+void FilesystemModel::refresh()
+{
+    setFilesystems(DeviceDB::instance()->snapshot()->filesystems);
+}
+
+void FilesystemModel::setFilesystems(const QList<filesystem_t> &filesystems)
+{
+    bool sameMounts = filesystems.size() == m_filesystems.size();
+    for (int i = 0; sameMounts && i < filesystems.size(); ++i)
+        sameMounts = filesystems[i].mountPoint == m_filesystems[i].mountPoint;
+
+    if (!sameMounts) {
+        beginResetModel();
+        m_filesystems = filesystems;
+        endResetModel();
+        return;
+    }
+    m_filesystems = filesystems;
+    if (!m_filesystems.isEmpty())
+        Q_EMIT dataChanged(index(0, kFilesystemSizeColumn), index(m_filesystems.size() - 1, kFilesystemColumnCount - 1));
+}
+
+int FilesystemModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_filesystems.size();
+}
+
+int FilesystemModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : kFilesystemColumnCount;
+}
+
+QVariant FilesystemModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_filesystems.size())
+        return {};
+
+    const filesystem_t &fs = m_filesystems[index.row()];
+    // text color role, mounts not answering keep their last usage dimmed
+    if (role == Qt::UserRole + 2)
+        return fs.hung ? QVariant(int(Dtk::Gui::DPalette::TextTips)) : QVariant();
+    if (role == Qt::ToolTipRole && fs.hung)
+        return QApplication::translate("Filesystem.Header", "Not responding, usage as of before");
+
+    switch (index.column()) {
+    case kFilesystemMountPointColumn:
+        if (role == Qt::DisplayRole || role == kSortRole)
+            return fs.mountPoint;
+        break;
+    case kFilesystemDeviceColumn:
+        if (role == Qt::DisplayRole || role == kSortRole)
+            return fs.source;
+        break;
+    case kFilesystemTypeColumn:
+        if (role == Qt::DisplayRole) {
+            return fs.readOnly ? QApplication::translate("Filesystem.Header", "%1 (read-only)").arg(fs.fsType)
+                               : fs.fsType;
+        }
+        if (role == kSortRole)
+            return fs.fsType;
+        break;
+    case kFilesystemSizeColumn:
+        if (role == Qt::DisplayRole)
+            return fs.hasUsage ? formatUnit_memory_disk(fs.total, B, 1) : QString();
+        if (role == kSortRole)
+            return fs.total;
+        break;
+    case kFilesystemUsedColumn:
+        if (role == Qt::DisplayRole)
+            return fs.hasUsage ? formatUnit_memory_disk(fs.used, B, 1) : QString();
+        if (role == kSortRole)
+            return fs.used;
+        break;
+    case kFilesystemAvailableColumn:
+        if (role == Qt::DisplayRole)
+            return fs.hasUsage ? formatUnit_memory_disk(fs.available, B, 1) : QString();
+        if (role == kSortRole)
+            return fs.available;
+        break;
+    case kFilesystemUsageColumn:
+        if (role == Qt::DisplayRole) {
+            if (fs.hung)
+                return QApplication::translate("Filesystem.Header", "Not responding");
+            return fs.hasUsage ? QString("%1%").arg(usagePercent(fs), 0, 'f', 0) : QString();
+        }
+        if (role == kSortRole)
+            return usagePercent(fs);
+        break;
+    default:
+        break;
+    }
+    return {};
+}
+
+QVariant FilesystemModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return {};
+
+    switch (section) {
+    case kFilesystemMountPointColumn:
+        return QApplication::translate("Filesystem.Header", kFilesystemMountPoint);
+    case kFilesystemDeviceColumn:
+        return QApplication::translate("Filesystem.Header", kFilesystemDevice);
+    case kFilesystemTypeColumn:
+        return QApplication::translate("Filesystem.Header", kFilesystemType);
+    case kFilesystemSizeColumn:
+        return QApplication::translate("Filesystem.Header", kFilesystemSize);
+    case kFilesystemUsedColumn:
+        return QApplication::translate("Filesystem.Header", kFilesystemUsed);
+    case kFilesystemAvailableColumn:
+        return QApplication::translate("Filesystem.Header", kFilesystemAvailable);
+    case kFilesystemUsageColumn:
+        return QApplication::translate("Filesystem.Header", kFilesystemUsage);
+    default:
+        break;
+    }
+    return {};
+}
@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef FILESYSTEM_MODEL_H
+#define FILESYSTEM_MODEL_H
+
+#include "system/filesystem_info_db.h"
+
+#include <QAbstractTableModel>
+
+// mount point column display
+constexpr const char *kFilesystemMountPoint = QT_TRANSLATE_NOOP("Filesystem.Header", "Mount point");
+// source device column display
+constexpr const char *kFilesystemDevice = QT_TRANSLATE_NOOP("Filesystem.Header", "Device");
+// filesystem type column display
+constexpr const char *kFilesystemType = QT_TRANSLATE_NOOP("Filesystem.Header", "Type");
+// capacity column display
+constexpr const char *kFilesystemSize = QT_TRANSLATE_NOOP("Filesystem.Header", "Size");
+// used space column display
+constexpr const char *kFilesystemUsed = QT_TRANSLATE_NOOP("Filesystem.Header", "Used");
+// available space column display
+constexpr const char *kFilesystemAvailable = QT_TRANSLATE_NOOP("Filesystem.Header", "Available");
+// used percent column display
+constexpr const char *kFilesystemUsage = QT_TRANSLATE_NOOP("Filesystem.Header", "Use%");
+
+/**
+ * @brief One row per mounted filesystem of the published device snapshot
+ *
+ * Rows are refreshed on UpdateCoordinator::updateViews, the table is reset only when the
+ * mounts themselves change.
+ */
+class FilesystemModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        kFilesystemMountPointColumn = 0,
+        kFilesystemDeviceColumn,
+        kFilesystemTypeColumn,
+        kFilesystemSizeColumn,
+        kFilesystemUsedColumn,
+        kFilesystemAvailableColumn,
+        kFilesystemUsageColumn,
+
+        kFilesystemColumnCount
+    };
+    enum Role {
+        kSortRole = Qt::UserRole // numeric value sorted by
+    };
+
+    explicit FilesystemModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Take the filesystems of the latest device snapshot
+     */
+    void refresh();
+    /**
+     * @brief Replace the rows, rows keep their place while the mounts stay the same
+     */
+    void setFilesystems(const QList<core::system::filesystem_t> &filesystems);
+
+private:
+    QList<core::system::filesystem_t> m_filesystems;
+};
+
+#endif // FILESYSTEM_MODEL_H
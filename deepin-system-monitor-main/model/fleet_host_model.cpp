@@ -0,0 +1,175 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "fleet_host_model.h"
+#include "ddlog.h"
+
+#include <DPalette>
+
+#include <QApplication>
+
+using namespace DDLog;
+
+namespace {
+
+QString percentText(qreal value)
+{
+    return QString("%1%").arg(value, 0, 'f', 1);
+}
+
+QString statusText(const FleetHostState &state)
+{
+    switch (state.status) {
+    case FleetHostState::kOnline:
+        return QApplication::translate("Fleet.Status", "Online");
+    case FleetHostState::kOffline:
+        return QApplication::translate("Fleet.Status", "Offline");
+    case FleetHostState::kConnecting:
+        break;
+    }
+    return QApplication::translate("Fleet.Status", "Connecting");
+}
+
+qreal highestPressure(const FleetHostState &state)
+{
+    qreal highest = 0;
+    for (qreal rate : state.pressure)
+        highest = qMax(highest, rate);
+    return highest;
+}
+
+} // namespace
+
+FleetHostModel::FleetHostModel(FleetMonitor *monitor, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_monitor(monitor)
+{
+    qCDebug(app) << "FleetHostModel constructor";
+    connect(m_monitor, &FleetMonitor::updated, this, &FleetHostModel::refresh);
+    refresh();
+}
+
+void FleetHostModel::refresh()
+{
+    QList<FleetHostState> states = m_monitor->states();
+    bool sameHosts = states.size() == m_states.size();
+    for (int i = 0; sameHosts && i < states.size(); ++i)
+        sameHosts = states[i].target == m_states[i].target;
+
+    if (!sameHosts) {
+        beginResetModel();
+        m_states.swap(states);
+        endResetModel();
+        return;
+    }
+    m_states.swap(states);
+    if (!m_states.isEmpty())
+        Q_EMIT dataChanged(index(0, 0), index(m_states.size() - 1, kFleetColumnCount - 1));
+}
+
+int FleetHostModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_states.size();
+}
+
+int FleetHostModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : kFleetColumnCount;
+}
+
+QVariant FleetHostModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_states.size())
+        return {};
+
+    const FleetHostState &state = m_states[index.row()];
+    if (role == kTargetRole)
+        return state.target;
+
+    // text color role, offline hosts keep their last summary dimmed
+    if (role == Qt::UserRole + 2)
+        return state.status == FleetHostState::kOnline ? QVariant() : QVariant(int(Dtk::Gui::DPalette::TextTips));
+
+    const bool online = state.status == FleetHostState::kOnline;
+    switch (index.column()) {
+    case kFleetHostColumn:
+        if (role == Qt::DisplayRole || role == kSortRole)
+            return state.hostName;
+        if (role == Qt::ToolTipRole)
+            return state.target;
+        break;
+    case kFleetStatusColumn:
+        if (role == Qt::DisplayRole)
+            return statusText(state);
+        if (role == kSortRole)
+            return int(state.status);
+        if (role == Qt::ToolTipRole && !state.error.isEmpty())
+            return state.error;
+        break;
+    case kFleetCPUColumn:
+        if (role == Qt::DisplayRole)
+            return online ? percentText(state.cpu) : QString();
+        if (role == kSortRole)
+            return state.cpu;
+        if (role == kHistoryRole)
+            return QVariant::fromValue(state.cpuHistory);
+        break;
+    case kFleetMemoryColumn:
+        if (role == Qt::DisplayRole)
+            return online ? percentText(state.memory) : QString();
+        if (role == kSortRole)
+            return state.memory;
+        if (role == kHistoryRole)
+            return QVariant::fromValue(state.memoryHistory);
+        break;
+    case kFleetPressureColumn:
+        if (role == Qt::DisplayRole)
+            return online && state.hasPressure ? percentText(highestPressure(state)) : QString();
+        if (role == kSortRole)
+            return highestPressure(state);
+        if (role == kHistoryRole)
+            return QVariant::fromValue(state.pressureHistory);
+        if (role == Qt::ToolTipRole && state.hasPressure)
+            return QApplication::translate("Fleet.Header", "CPU %1, memory %2, IO %3")
+                .arg(percentText(state.pressure[common::pressure::kCpuPressure]))
+                .arg(percentText(state.pressure[common::pressure::kMemoryPressure]))
+                .arg(percentText(state.pressure[common::pressure::kIOPressure]));
+        break;
+    case kFleetTopProcessColumn:
+        if (role == Qt::DisplayRole)
+            return online && !state.topProcess.isEmpty()
+                ? QString("%1 (%2)").arg(state.topProcess).arg(percentText(state.topProcessCpu))
+                : QString();
+        if (role == kSortRole)
+            return state.topProcessCpu;
+        break;
+    default:
+        break;
+    }
+    return {};
+}
+
+QVariant FleetHostModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return {};
+
+    switch (section) {
+    case kFleetHostColumn:
+        return QApplication::translate("Fleet.Header", kFleetHost);
+    case kFleetStatusColumn:
+        return QApplication::translate("Fleet.Header", kFleetStatus);
+    case kFleetCPUColumn:
+        return QApplication::translate("Fleet.Header", kFleetCPU);
+    case kFleetMemoryColumn:
+        return QApplication::translate("Fleet.Header", kFleetMemory);
+    case kFleetPressureColumn:
+        return QApplication::translate("Fleet.Header", kFleetPressure);
+    case kFleetTopProcessColumn:
+        return QApplication::translate("Fleet.Header", kFleetTopProcess);
+    default:
+        break;
+    }
+    return {};
+}
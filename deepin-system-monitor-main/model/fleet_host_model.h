@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef FLEET_HOST_MODEL_H
+#define FLEET_HOST_MODEL_H
+
+#include "fleet_monitor.h"
+
+#include <QAbstractTableModel>
+
+// host name column display
+constexpr const char *kFleetHost = QT_TRANSLATE_NOOP("Fleet.Header", "Host");
+// connection status column display
+constexpr const char *kFleetStatus = QT_TRANSLATE_NOOP("Fleet.Header", "Status");
+// cpu sparkline column display
+constexpr const char *kFleetCPU = QT_TRANSLATE_NOOP("Fleet.Header", "CPU");
+// memory sparkline column display
+constexpr const char *kFleetMemory = QT_TRANSLATE_NOOP("Fleet.Header", "Memory");
+// pressure sparkline column display
+constexpr const char *kFleetPressure = QT_TRANSLATE_NOOP("Fleet.Header", "Pressure");
+// busiest process column display
+constexpr const char *kFleetTopProcess = QT_TRANSLATE_NOOP("Fleet.Header", "Top process");
+
+/**
+ * @brief One row per host of a FleetMonitor
+ *
+ * Rows are refreshed as a whole on FleetMonitor::updated(), at most once a second however
+ * many hosts there are. Sparkline columns hand their samples out with kHistoryRole.
+ */
+class FleetHostModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        kFleetHostColumn = 0,
+        kFleetStatusColumn,
+        kFleetCPUColumn,
+        kFleetMemoryColumn,
+        kFleetPressureColumn,
+        kFleetTopProcessColumn,
+
+        kFleetColumnCount
+    };
+    enum Role {
+        kSortRole = Qt::UserRole, // numeric value sorted by
+        kHistoryRole = Qt::UserRole + 0x10, // QVector<qreal> of percents, oldest first
+        kTargetRole
+    };
+
+    explicit FleetHostModel(FleetMonitor *monitor, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Take the monitor's summaries, rows keep their place while the hosts stay the same
+     */
+    void refresh();
+
+private:
+    FleetMonitor *m_monitor;
+    QList<FleetHostState> m_states;
+};
+
+#endif // FLEET_HOST_MODEL_H
@@ -0,0 +1,575 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "fleet_monitor.h"
+#include "remote_source.h"
+#include "ddlog.h"
+#include "headless_exporter.h"
+#include "remote_agent.h"
+#include "process/process_set.h"
+#include "system/device_snapshot.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QTimer>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <spawn.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+
+using namespace DDLog;
+using namespace core::system;
+using namespace core::process;
+
+// read size of an agent descriptor
+const int kReadChunk = 64 * 1024;
+// events taken per epoll_wait
+const int kMaxEvents = 64;
+// ms epoll waits at most, bounds how late a reconnect is
+const int kWaitTimeout = 1000;
+
+namespace {
+
+void pushSample(QVector<qreal> &history, qreal value)
+{
+    if (history.size() >= FleetHostState::kHistorySize)
+        history.remove(0, history.size() - FleetHostState::kHistorySize + 1);
+    history.append(value);
+}
+
+qint64 now()
+{
+    return QDateTime::currentMSecsSinceEpoch();
+}
+
+} // namespace
+
+bool FleetHostDecoder::feed(const char *data, int size, FleetHostState &state)
+{
+    m_buffer.append(data, size);
+
+    int pos = 0;
+    bool ok = true;
+    remote_frame_header_t hdr;
+    QByteArray payload;
+    while (ok) {
+        int rc = RemoteSource::nextFrame(m_buffer, pos, hdr, payload);
+        if (rc <= 0) {
+            ok = rc == 0;
+            break;
+        }
+
+        switch (hdr.type) {
+        case REMOTE_FRAME_HELLO: {
+            const remote_hello_t *hello = remoteHello(payload.constData(), size_t(payload.size()));
+            if (!hello) {
+                ok = false;
+                break;
+            }
+            QDataStream in(payload.mid(int(sizeof(remote_hello_t))));
+            in.setVersion(RemoteAgent::kStreamVersion);
+            m_cpuSet = CPUSet();
+            m_cpuSet.loadInfo(in);
+            ok = in.status() == QDataStream::Ok;
+            m_hello = ok;
+            m_prevTotal = m_prevIdle = 0;
+            m_generation = 0;
+            m_records.clear();
+            state.hostName = QString::fromUtf8(hello->hostname);
+            state.status = FleetHostState::kOnline;
+            state.error.clear();
+            break;
+        }
+        case REMOTE_FRAME_SYSTEM:
+            ok = m_hello && takeSystem(payload, state);
+            break;
+        case REMOTE_FRAME_PROCESSES:
+            ok = m_hello && takeProcesses(payload, state);
+            break;
+        default:
+            // frames of later versions, skipped
+            break;
+        }
+    }
+    m_buffer.remove(0, pos);
+    return ok;
+}
+
+void FleetHostDecoder::reset()
+{
+    m_buffer.clear();
+    m_hello = false;
+    m_records.clear();
+    m_generation = 0;
+}
+
+bool FleetHostDecoder::takeSystem(const QByteArray &payload, FleetHostState &state)
+{
+    DeviceSnapshot snapshot;
+    if (!RemoteSource::decodeSystem(payload, m_cpuSet, snapshot))
+        return false;
+
+    // the first refresh has no previous jiffies to tell usage by
+    const bool first = m_prevTotal == 0;
+    const CPUUsage usage = m_cpuSet.usage();
+    if (usage) {
+        if (!first)
+            state.cpu = HeadlessExporter::cpuPercent(m_prevTotal, m_prevIdle, usage->total, usage->idle);
+        m_prevTotal = usage->total;
+        m_prevIdle = usage->idle;
+    }
+
+    const qulonglong total = snapshot.memInfo.memTotal();
+    const qulonglong available = qMin(snapshot.memInfo.memAvailable(), total);
+    state.memory = total > 0 ? qreal(total - available) * 100. / qreal(total) : 0;
+
+    qreal highest = 0;
+    state.hasPressure = false;
+    for (int i = 0; i < common::pressure::kPressureResourceCount; ++i) {
+        const common::pressure::pressure_t &pressure = snapshot.pressure[i];
+        state.pressure[i] = pressure.valid && pressure.hasRates ? pressure.someRate : 0;
+        state.hasPressure |= pressure.valid;
+        highest = qMax(highest, state.pressure[i]);
+    }
+
+    if (!first) {
+        pushSample(state.cpuHistory, state.cpu);
+        pushSample(state.memoryHistory, state.memory);
+        pushSample(state.pressureHistory, highest);
+    }
+    state.lastUpdate = now();
+    return true;
+}
+
+bool FleetHostDecoder::takeProcesses(const QByteArray &payload, FleetHostState &state)
+{
+    process_info_delta_header_t hdr;
+    if (payload.size() < int(sizeof(hdr)))
+        return false;
+    memcpy(&hdr, payload.constData(), sizeof(hdr));
+    const size_t deltaSize = processInfoDeltaSize(hdr.count, hdr.exited);
+    if (size_t(payload.size()) < deltaSize)
+        return false;
+    // names & app types after the delta aren't shown
+    if (!ProcessSet::applyProcessInfoDelta(payload.left(int(deltaSize)), m_records, m_generation))
+        return false;
+
+    const process_info_record_t *top = nullptr;
+    for (const process_info_record_t &rec : m_records) {
+        if (!top || rec.cpu_usage > top->cpu_usage)
+            top = &rec;
+    }
+    if (top) {
+        state.topProcess = QString::fromLocal8Bit(top->comm, int(strnlen(top->comm, PROCESS_INFO_COMM_LEN)));
+        state.topProcessCpu = top->cpu_usage;
+    } else {
+        state.topProcess.clear();
+        state.topProcessCpu = 0;
+    }
+    return true;
+}
+
+FleetMonitor::FleetMonitor(QObject *parent)
+    : QObject(parent)
+    , m_publishTimer(new QTimer(this))
+{
+    qCDebug(app) << "FleetMonitor constructor";
+    m_publishTimer->setInterval(kPublishInterval);
+    connect(m_publishTimer, &QTimer::timeout, this, &FleetMonitor::publish);
+    m_publishTimer->start();
+
+    m_thread = new FleetIngestThread(this);
+    m_thread->start();
+}
+
+FleetMonitor::~FleetMonitor()
+{
+    m_thread->requestQuit();
+    m_thread->wait();
+    delete m_thread;
+}
+
+bool FleetMonitor::addHost(const QString &target)
+{
+    const QString text = target.trimmed();
+    QString destination, address;
+    int port = 0;
+    if (!RemoteSource::parseTarget(text, destination, address, port))
+        return false;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const FleetHostState &state : m_states) {
+            if (state.target == text)
+                return false;
+        }
+        FleetHostState state;
+        state.target = text;
+        state.hostName = text;
+        m_states << state;
+        m_dirty = true;
+    }
+    m_thread->addHost(text);
+    publish();
+    return true;
+}
+
+void FleetMonitor::removeHost(const QString &target)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        for (int i = 0; i < m_states.size(); ++i) {
+            if (m_states[i].target == target) {
+                m_states.removeAt(i);
+                m_dirty = true;
+                break;
+            }
+        }
+    }
+    m_thread->removeHost(target);
+    publish();
+}
+
+QStringList FleetMonitor::targets() const
+{
+    QMutexLocker locker(&m_mutex);
+    QStringList targets;
+    for (const FleetHostState &state : m_states)
+        targets << state.target;
+    return targets;
+}
+
+QList<FleetHostState> FleetMonitor::states() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_states;
+}
+
+void FleetMonitor::publish()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_dirty)
+            return;
+        m_dirty = false;
+    }
+    Q_EMIT updated();
+}
+
+FleetIngestThread::FleetIngestThread(FleetMonitor *monitor)
+    : m_monitor(monitor)
+{
+    m_epfd = epoll_create1(EPOLL_CLOEXEC);
+    m_wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_epfd < 0 || m_wakeFd < 0) {
+        qCWarning(app) << "Failed to create fleet epoll instance:" << strerror(errno);
+        return;
+    }
+    struct epoll_event ev {};
+    ev.events = EPOLLIN;
+    ev.data.fd = m_wakeFd;
+    epoll_ctl(m_epfd, EPOLL_CTL_ADD, m_wakeFd, &ev);
+}
+
+FleetIngestThread::~FleetIngestThread()
+{
+    for (host_t *host : m_hosts) {
+        disconnectHost(*host);
+        delete host;
+    }
+    if (m_wakeFd >= 0)
+        close(m_wakeFd);
+    if (m_epfd >= 0)
+        close(m_epfd);
+}
+
+void FleetIngestThread::addHost(const QString &target)
+{
+    {
+        QMutexLocker locker(&m_commandMutex);
+        m_removed.removeAll(target);
+        m_added << target;
+    }
+    wake();
+}
+
+void FleetIngestThread::removeHost(const QString &target)
+{
+    {
+        QMutexLocker locker(&m_commandMutex);
+        m_added.removeAll(target);
+        m_removed << target;
+    }
+    wake();
+}
+
+void FleetIngestThread::requestQuit()
+{
+    m_quitRequested.store(true);
+    wake();
+}
+
+void FleetIngestThread::wake()
+{
+    if (m_wakeFd < 0)
+        return;
+    uint64_t one = 1;
+    ssize_t rc = write(m_wakeFd, &one, sizeof(one));
+    Q_UNUSED(rc);
+}
+
+void FleetIngestThread::run()
+{
+    if (m_epfd < 0 || m_wakeFd < 0)
+        return;
+
+    struct epoll_event events[kMaxEvents];
+    while (!m_quitRequested.load()) {
+        applyCommands();
+
+        int n = epoll_wait(m_epfd, events, kMaxEvents, kWaitTimeout);
+        if (n < 0 && errno != EINTR) {
+            qCWarning(app) << "Fleet epoll wait failed:" << strerror(errno);
+            return;
+        }
+        for (int i = 0; i < n; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == m_wakeFd) {
+                uint64_t count;
+                ssize_t rc = read(m_wakeFd, &count, sizeof(count));
+                Q_UNUSED(rc);
+                continue;
+            }
+            host_t *host = m_hostsByFd.value(fd);
+            if (!host)
+                continue;
+
+            if (host->connecting) {
+                int error = 0;
+                socklen_t len = sizeof(error);
+                getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len);
+                if (error != 0) {
+                    failHost(*host, QString::fromLocal8Bit(strerror(error)));
+                    continue;
+                }
+                host->connecting = false;
+                struct epoll_event ev {};
+                ev.events = EPOLLIN;
+                ev.data.fd = fd;
+                epoll_ctl(m_epfd, EPOLL_CTL_MOD, fd, &ev);
+                continue;
+            }
+            readHost(*host);
+        }
+
+        const qint64 t = now();
+        for (host_t *host : m_hosts) {
+            if (host->fd < 0 && t >= host->retryAt && !connectHost(*host))
+                host->retryAt = t + FleetMonitor::kReconnectDelay;
+        }
+    }
+}
+
+void FleetIngestThread::applyCommands()
+{
+    QStringList added, removed;
+    {
+        QMutexLocker locker(&m_commandMutex);
+        added.swap(m_added);
+        removed.swap(m_removed);
+    }
+
+    for (const QString &target : removed) {
+        for (int i = 0; i < m_hosts.size(); ++i) {
+            if (m_hosts[i]->target == target) {
+                disconnectHost(*m_hosts[i]);
+                delete m_hosts.takeAt(i);
+                break;
+            }
+        }
+    }
+    for (const QString &target : added) {
+        host_t *host = new host_t;
+        host->target = target;
+        host->state.target = target;
+        host->state.hostName = target;
+        m_hosts << host;
+        // connected right after the wait, a failed one is retried later
+        host->retryAt = 0;
+    }
+}
+
+bool FleetIngestThread::connectHost(host_t &host)
+{
+    QString destination, address;
+    int port = 0;
+    if (!RemoteSource::parseTarget(host.target, destination, address, port))
+        return false;
+
+    host.decoder.reset();
+    if (!destination.isEmpty()) {
+        // spawned by hand, the pipe is waited on by epoll like every other agent
+        int out[2], err[2];
+        if (pipe2(out, O_CLOEXEC) != 0)
+            return false;
+        if (pipe2(err, O_CLOEXEC) != 0) {
+            close(out[0]);
+            close(out[1]);
+            return false;
+        }
+
+        QList<QByteArray> args {"ssh"};
+        for (const QString &arg : RemoteSource::sshArguments(destination, FleetMonitor::kAgentInterval))
+            args << arg.toLocal8Bit();
+        QVector<char *> argv;
+        for (QByteArray &arg : args)
+            argv << arg.data();
+        argv << nullptr;
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+        posix_spawn_file_actions_adddup2(&actions, out[1], STDOUT_FILENO);
+        posix_spawn_file_actions_adddup2(&actions, err[1], STDERR_FILENO);
+        pid_t pid = -1;
+        int rc = posix_spawnp(&pid, "ssh", &actions, nullptr, argv.data(), environ);
+        posix_spawn_file_actions_destroy(&actions);
+        close(out[1]);
+        close(err[1]);
+        if (rc != 0) {
+            close(out[0]);
+            close(err[0]);
+            failHost(host, QString::fromLocal8Bit(strerror(rc)));
+            return true;
+        }
+
+        fcntl(out[0], F_SETFL, fcntl(out[0], F_GETFL) | O_NONBLOCK);
+        fcntl(err[0], F_SETFL, fcntl(err[0], F_GETFL) | O_NONBLOCK);
+        host.fd = out[0];
+        host.errFd = err[0];
+        host.pid = pid;
+    } else {
+        struct sockaddr_in addr {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(quint16(port));
+        const QByteArray ip = (address == "localhost" ? QString("127.0.0.1") : address).toLatin1();
+        if (inet_pton(AF_INET, ip.constData(), &addr.sin_addr) != 1) {
+            failHost(host, QObject::tr("Not an IPv4 address"));
+            return true;
+        }
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+        if (fd < 0)
+            return false;
+        if (::connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0 && errno != EINPROGRESS) {
+            const int error = errno;
+            close(fd);
+            failHost(host, QString::fromLocal8Bit(strerror(error)));
+            return true;
+        }
+        host.fd = fd;
+        host.connecting = true;
+    }
+
+    struct epoll_event ev {};
+    ev.events = host.connecting ? EPOLLOUT : EPOLLIN;
+    ev.data.fd = host.fd;
+    epoll_ctl(m_epfd, EPOLL_CTL_ADD, host.fd, &ev);
+    m_hostsByFd.insert(host.fd, &host);
+
+    host.state.status = FleetHostState::kConnecting;
+    publishState(host);
+    return true;
+}
+
+void FleetIngestThread::disconnectHost(host_t &host)
+{
+    if (host.fd >= 0) {
+        epoll_ctl(m_epfd, EPOLL_CTL_DEL, host.fd, nullptr);
+        m_hostsByFd.remove(host.fd);
+        close(host.fd);
+        host.fd = -1;
+    }
+    if (host.errFd >= 0) {
+        close(host.errFd);
+        host.errFd = -1;
+    }
+    if (host.pid > 0) {
+        // ssh may still be up when the stream was corrupted or the host is removed
+        if (waitpid(host.pid, nullptr, WNOHANG) == 0) {
+            kill(host.pid, SIGKILL);
+            waitpid(host.pid, nullptr, 0);
+        }
+        host.pid = -1;
+    }
+    host.connecting = false;
+}
+
+void FleetIngestThread::readHost(host_t &host)
+{
+    char buf[kReadChunk];
+    bool changed = false;
+    for (;;) {
+        ssize_t n = read(host.fd, buf, sizeof(buf));
+        if (n > 0) {
+            changed = true;
+            if (!host.decoder.feed(buf, int(n), host.state)) {
+                failHost(host, QObject::tr("The remote agent sent data of an unknown version"));
+                return;
+            }
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EINTR))
+            break;
+
+        QString error = n == 0 ? QObject::tr("The remote agent closed the connection")
+                               : QString::fromLocal8Bit(strerror(errno));
+        // ssh tells why it gave up on stderr, its last line is enough
+        if (host.errFd >= 0) {
+            n = read(host.errFd, buf, sizeof(buf));
+            const QString text = n > 0 ? QString::fromLocal8Bit(buf, int(n)).trimmed().section('\n', -1) : QString();
+            if (!text.isEmpty())
+                error = text;
+        }
+        failHost(host, error);
+        return;
+    }
+    if (changed)
+        publishState(host);
+}
+
+void FleetIngestThread::failHost(host_t &host, const QString &error)
+{
+    disconnectHost(host);
+    host.decoder.reset();
+    host.retryAt = now() + FleetMonitor::kReconnectDelay;
+    if (host.state.status != FleetHostState::kOffline)
+        qCInfo(app) << "Fleet host" << host.target << "went offline:" << error;
+    host.state.status = FleetHostState::kOffline;
+    host.state.error = error;
+    publishState(host);
+}
+
+void FleetIngestThread::publishState(const host_t &host)
+{
+    QMutexLocker locker(&m_monitor->m_mutex);
+    for (FleetHostState &state : m_monitor->m_states) {
+        if (state.target == host.target) {
+            state = host.state;
+            m_monitor->m_dirty = true;
+            return;
+        }
+    }
+}
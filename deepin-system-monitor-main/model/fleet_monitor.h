@@ -0,0 +1,192 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef FLEET_MONITOR_H
+#define FLEET_MONITOR_H
+
+#include "process_info_record.h"
+#include "common/pressure_stats.h"
+#include "system/cpu_set.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+
+#include <atomic>
+
+#include <sys/types.h>
+
+class QTimer;
+class FleetIngestThread;
+
+/**
+ * @brief Summary of one host of the fleet, as of its last refresh
+ */
+struct FleetHostState {
+    enum Status {
+        kConnecting,
+        kOnline,
+        kOffline // reconnected after kReconnectDelay
+    };
+
+    QString target;
+    QString hostName; // told by the agent, the target until then
+    Status status {kConnecting};
+    QString error; // why it went offline
+    qreal cpu {}; // percent of all cpus
+    qreal memory {}; // percent of memory in use
+    qreal pressure[common::pressure::kPressureResourceCount] {}; // some stall rates, percent
+    bool hasPressure {false};
+    QString topProcess; // command name of the busiest process
+    qreal topProcessCpu {};
+    QVector<qreal> cpuHistory; // oldest first, at most kHistorySize samples
+    QVector<qreal> memoryHistory;
+    QVector<qreal> pressureHistory; // highest of the some rates
+    qint64 lastUpdate {0}; // ms since epoch
+
+    // samples kept for the sparklines, two minutes at 1 Hz
+    static constexpr int kHistorySize = 120;
+};
+
+/**
+ * @brief Decodes the agent stream of one host into its summary
+ *
+ * Lighter than RemoteSource: only the system frame & the record delta of the process frame are
+ * read, names, app types & the process tree are not built. Ingest thread only.
+ */
+class FleetHostDecoder
+{
+public:
+    /**
+     * @brief Decode stream data into \a state
+     * @return false if the stream is corrupted or of another version
+     */
+    bool feed(const char *data, int size, FleetHostState &state);
+    /**
+     * @brief Forget the stream, before a reconnect
+     */
+    void reset();
+
+private:
+    bool takeSystem(const QByteArray &payload, FleetHostState &state);
+    bool takeProcesses(const QByteArray &payload, FleetHostState &state);
+
+    QByteArray m_buffer;
+    bool m_hello {false};
+    core::system::CPUSet m_cpuSet;
+    unsigned long long m_prevTotal {0};
+    unsigned long long m_prevIdle {0};
+    quint64 m_generation {0};
+    QHash<pid_t, process_info_record_t> m_records;
+};
+
+/**
+ * @brief Summaries of many hosts, each streamed by its --headless --agent
+ *
+ * Every agent, ssh pipe or tcp socket, is read by one ingest thread waiting in epoll, so the
+ * number of hosts costs neither threads nor main thread wakeups. Decoded summaries are marked
+ * dirty & picked up by a main thread timer once a second, a view is told with one updated()
+ * however many hosts refreshed in between. Hosts that go away are reconnected after a delay.
+ */
+class FleetMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FleetMonitor(QObject *parent = nullptr);
+    ~FleetMonitor() override;
+
+    /**
+     * @brief Start watching \a target, [ssh://][user@]host or tcp://127.0.0.1:port
+     * @return false if it's not a remote target or already watched
+     */
+    bool addHost(const QString &target);
+    void removeHost(const QString &target);
+    QStringList targets() const;
+    /**
+     * @brief Summaries of all hosts, in the order they were added
+     */
+    QList<FleetHostState> states() const;
+
+    // ms between picking up dirty summaries
+    static constexpr int kPublishInterval = 1000;
+    // ms an offline host waits before it's reconnected
+    static constexpr int kReconnectDelay = 10000;
+    // refresh interval asked of the agents
+    static constexpr int kAgentInterval = 1000;
+
+Q_SIGNALS:
+    /**
+     * @brief Summaries changed since the last signal
+     */
+    void updated();
+
+private:
+    void publish();
+
+    mutable QMutex m_mutex;
+    QList<FleetHostState> m_states; // guarded by m_mutex, written by the ingest thread
+    bool m_dirty {false};
+    QTimer *m_publishTimer {};
+    FleetIngestThread *m_thread {};
+
+    friend class FleetIngestThread;
+};
+
+/**
+ * @brief Ingest thread of FleetMonitor, owns the agent processes & their descriptors
+ */
+class FleetIngestThread : public QThread
+{
+public:
+    explicit FleetIngestThread(FleetMonitor *monitor);
+    ~FleetIngestThread() override;
+
+    void addHost(const QString &target);
+    void removeHost(const QString &target);
+    void requestQuit();
+
+protected:
+    void run() override;
+
+private:
+    struct host_t {
+        QString target;
+        int fd {-1}; // ssh stdout or the socket
+        int errFd {-1}; // ssh stderr, read once it exits
+        pid_t pid {-1}; // ssh
+        bool connecting {false}; // tcp connect in progress
+        qint64 retryAt {0}; // ms since epoch, while offline
+        FleetHostDecoder decoder;
+        FleetHostState state; // copied to the monitor after each read
+    };
+
+    void applyCommands();
+    bool connectHost(host_t &host);
+    void disconnectHost(host_t &host);
+    void readHost(host_t &host);
+    void failHost(host_t &host, const QString &error);
+    void publishState(const host_t &host);
+    void wake();
+
+    FleetMonitor *m_monitor;
+    int m_epfd {-1};
+    int m_wakeFd {-1}; // eventfd, commands & quit
+    std::atomic_bool m_quitRequested {false};
+
+    QMutex m_commandMutex;
+    QStringList m_added; // guarded by m_commandMutex
+    QStringList m_removed;
+
+    QHash<int, host_t *> m_hostsByFd; // ingest thread only
+    QList<host_t *> m_hosts;
+};
+
+#endif // FLEET_MONITOR_H
@@ -0,0 +1,687 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "flight_recorder.h"
+#include "model_manager.h"
+#include "process_row_preparer.h"
+#include "sample_history.h"
+#include "update_coordinator.h"
+#include "ddlog.h"
+#include "settings.h"
+#include "common/cgroup_stats.h"
+#include "common/proc_parser.h"
+#include "common/task_executor.h"
+#include "system/device_db.h"
+#include "system/device_snapshot.h"
+#include "system/sys_info.h"
+#include "system/system_monitor.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <limits>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace DDLog;
+using namespace common::parser;
+using namespace core::system;
+using namespace core::process;
+using common::cgroup::CgroupStats;
+using common::core::TaskExecutor;
+using common::selfstats::SelfStatsReport;
+using common::selfstats::SelfStatsSampler;
+using common::selfstats::ThreadUsage;
+
+namespace {
+
+const quint32 kSnapshotMagic = 0x464d5344; // "DSMF"
+// 2 adds the detail frames of watched processes, 3 the service & socket count of each process
+const quint32 kSnapshotVersion = 3;
+const QDataStream::Version kStreamVersion = QDataStream::Qt_5_11;
+
+// replayed frames are never shown faster or slower than this, whatever the recorded pace
+const int kMinReplayInterval = 100;
+const int kMaxReplayInterval = 5000;
+
+// device part of a frame, cpu usage is computed against the jiffies cpuSet holds
+void readDeviceStats(QDataStream &in, CPUSet &cpuSet, DeviceSnapshot &snapshot, FlightRecorder::sockstat_t &sockStat)
+{
+    cpuSet.loadStats(in);
+    snapshot.cpuSet = cpuSet;
+    snapshot.memInfo.load(in);
+    in >> snapshot.diskReadBps >> snapshot.diskWriteBps >> snapshot.netRecvBps >> snapshot.netSentBps
+       >> snapshot.netTotalRecvBytes >> snapshot.netTotalSentBytes;
+
+    in >> sockStat.sockets >> sockStat.tcpInUse >> sockStat.tcpOrphan >> sockStat.tcpTimeWait >> sockStat.tcpAlloc
+       >> sockStat.tcpMem >> sockStat.udpInUse >> sockStat.udpMem >> sockStat.rawInUse >> sockStat.tcp6InUse
+       >> sockStat.udp6InUse;
+}
+
+} // namespace
+
+FlightRecorder::FlightRecorder(QObject *parent)
+    : QObject(parent)
+{
+    qCDebug(app) << "FlightRecorder constructor";
+    bool ok = false;
+    int minutes = Settings::instance()->getOption(kSettingKeyFlightRecorderMinutes, kDefaultMinutes).toInt(&ok);
+    setWindow(ok ? minutes : kDefaultMinutes);
+
+    Settings *settings = Settings::instance();
+    ProcessTriggers::rules_t rules;
+    rules.cpuPercent = settings->getOption(kSettingKeyTriggerCpuPercent, rules.cpuPercent).toDouble();
+    rules.cpuDuration = settings->getOption(kSettingKeyTriggerCpuSeconds, rules.cpuDuration / 1000).toLongLong() * 1000;
+    rules.memoryGrowth = settings->getOption(kSettingKeyTriggerMemoryGrowthMB, rules.memoryGrowth / 1024).toDouble() * 1024;
+    setRules(rules);
+
+    m_replayTimer.setSingleShot(true);
+    connect(&m_replayTimer, &QTimer::timeout, this, &FlightRecorder::replayNext);
+    m_watchTimer.setInterval(int(kWatchInterval));
+    connect(&m_watchTimer, &QTimer::timeout, this, &FlightRecorder::sampleWatches);
+}
+
+void FlightRecorder::setWindow(int minutes)
+{
+    m_window = qint64(qBound(1, minutes, 24 * 60)) * 60 * 1000;
+}
+
+void FlightRecorder::setRules(const ProcessTriggers::rules_t &rules)
+{
+    qCInfo(app) << "Trigger rules: cpu" << rules.cpuPercent << "% for" << rules.cpuDuration << "ms, memory growth"
+                << rules.memoryGrowth << "kB per minute";
+    m_triggers.setRules(rules);
+}
+
+void FlightRecorder::parseSockStat(const char *buf, size_t len, sockstat_t &stat)
+{
+    Tokenizer tok(buf, len);
+    do {
+        const char *section, *name;
+        size_t sectionLen, nameLen;
+        if (!tok.readKey(section, sectionLen))
+            continue;
+        unsigned long long value;
+        // "TCP: inuse 5 orphan 0 tw 2 alloc 7 mem 1"
+        while (tok.readToken(name, nameLen) && tok.readU64(value)) {
+            auto is = [&](const char *expected) { return keyEquals(name, nameLen, expected, strlen(expected)); };
+            quint32 *field = nullptr;
+            if (keyEquals(section, sectionLen, "sockets", 7)) {
+                field = is("used") ? &stat.sockets : nullptr;
+            } else if (keyEquals(section, sectionLen, "TCP", 3)) {
+                field = is("inuse") ? &stat.tcpInUse
+                        : is("orphan") ? &stat.tcpOrphan
+                        : is("tw") ? &stat.tcpTimeWait
+                        : is("alloc") ? &stat.tcpAlloc
+                        : is("mem") ? &stat.tcpMem : nullptr;
+            } else if (keyEquals(section, sectionLen, "UDP", 3)) {
+                field = is("inuse") ? &stat.udpInUse : is("mem") ? &stat.udpMem : nullptr;
+            } else if (keyEquals(section, sectionLen, "RAW", 3)) {
+                field = is("inuse") ? &stat.rawInUse : nullptr;
+            } else if (keyEquals(section, sectionLen, "TCP6", 4)) {
+                field = is("inuse") ? &stat.tcp6InUse : nullptr;
+            } else if (keyEquals(section, sectionLen, "UDP6", 4)) {
+                field = is("inuse") ? &stat.udp6InUse : nullptr;
+            }
+            if (field)
+                *field = quint32(value);
+        }
+    } while (tok.nextLine());
+}
+
+void FlightRecorder::readSockStat(sockstat_t &stat)
+{
+    char buf[1024];
+    for (const char *path : {"/proc/net/sockstat", "/proc/net/sockstat6"}) {
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            continue;
+        ssize_t n = read(fd, buf, sizeof(buf));
+        close(fd);
+        if (n > 0)
+            parseSockStat(buf, size_t(n), stat);
+    }
+}
+
+void FlightRecorder::record()
+{
+    auto rowTable = ModelManager::instance()->processRowPreparer()->rowTable();
+    if (m_replaying || !rowTable)
+        return;
+
+    frame_t frame;
+    frame.time = QDateTime::currentMSecsSinceEpoch();
+    frame.key = m_frames.empty() || m_sinceKey >= kKeyFrameInterval;
+    m_sinceKey = frame.key ? 1 : m_sinceKey + 1;
+
+    QByteArray raw;
+    {
+        QDataStream out(&raw, QIODevice::WriteOnly);
+        out.setVersion(kStreamVersion);
+
+        DeviceSnapshotPtr snapshot = DeviceDB::instance()->snapshot();
+        snapshot->cpuSet.saveStats(out);
+        snapshot->memInfo.save(out);
+        out << snapshot->diskReadBps << snapshot->diskWriteBps << snapshot->netRecvBps << snapshot->netSentBps
+            << snapshot->netTotalRecvBytes << snapshot->netTotalSentBytes;
+
+        sockstat_t sockStat;
+        readSockStat(sockStat);
+        out << sockStat.sockets << sockStat.tcpInUse << sockStat.tcpOrphan << sockStat.tcpTimeWait << sockStat.tcpAlloc
+            << sockStat.tcpMem << sockStat.udpInUse << sockStat.udpMem << sockStat.rawInUse << sockStat.tcp6InUse
+            << sockStat.udp6InUse;
+
+        out << rowTable->netTrafficSampled << quint32(rowTable->procs.size());
+        QSet<ProcessKey> named;
+        named.reserve(rowTable->procs.size());
+        QHash<ProcessKey, QString> units;
+        units.reserve(rowTable->procs.size());
+        for (const Process &proc : rowTable->procs) {
+            ProcessKey key {proc.pid(), proc.startTimeTicks()};
+            bool withNames = frame.key || !m_named.contains(key);
+            auto known = m_units.constFind(key);
+            const QString unit = known != m_units.constEnd() ? *known
+                                                             : DiffSnapshot::unitOfCgroup(CgroupStats::processCgroup(key.first));
+            out << key.first << key.second << withNames;
+            if (withNames) {
+                proc.saveNames(out);
+                out << unit;
+            }
+            proc.saveStats(out);
+            // as of the last fd walk, it only runs while a view shows sockets or fds
+            out << qint32(proc.fdCount() < 0 ? -1 : proc.socketCount());
+            named.insert(key);
+            units.insert(key, unit);
+        }
+        m_named.swap(named);
+        m_units.swap(units);
+    }
+    frame.data = qCompress(raw);
+    qint64 now = frame.time;
+    append(std::move(frame));
+
+    watch(m_triggers.evaluate(*rowTable, now), m_named, now);
+}
+
+void FlightRecorder::watch(const QVector<ProcessTriggers::match_t> &matches, const QSet<ProcessKey> &scanned,
+                           qint64 now)
+{
+    for (auto it = m_watches.begin(); it != m_watches.end();) {
+        if (!scanned.contains(it.key())) {
+            qCInfo(app) << "Process" << it.key().first << "exited, watch ended";
+            m_watchSockets.release(it.key().first);
+            it = m_watches.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (const ProcessTriggers::match_t &match : matches) {
+        auto it = m_watches.find(match.key);
+        if (it != m_watches.end()) {
+            it->until = now + kWatchLinger;
+            it->rules |= match.rules;
+            continue;
+        }
+        if (m_watches.size() >= kMaxWatches)
+            continue;
+
+        watch_t watch;
+        watch.until = now + kWatchLinger;
+        watch.rules = match.rules;
+        watch.sampler = std::make_shared<SelfStatsSampler>("/proc/" + std::to_string(match.key.first));
+        m_watches.insert(match.key, watch);
+        qCInfo(app) << "Process" << match.key.first << "matched trigger rules" << match.rules << ", watching it";
+        Q_EMIT watchStarted(match.key.first, match.rules);
+    }
+
+    if (m_watches.isEmpty())
+        m_watchTimer.stop();
+    else if (!m_watchTimer.isActive())
+        m_watchTimer.start();
+}
+
+int FlightRecorder::countFds(pid_t pid)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/fd", pid);
+    struct stat st;
+    if (stat(path, &st) != 0)
+        return -1;
+    // fd count of the dir, kernel 6.2+
+    if (st.st_size > 0)
+        return int(st.st_size);
+
+    DIR *dir = opendir(path);
+    if (!dir)
+        return -1;
+    int count = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir))) {
+        if (isDigit(entry->d_name[0]))
+            ++count;
+    }
+    closedir(dir);
+    return count;
+}
+
+void FlightRecorder::sampleWatches()
+{
+    frame_t frame;
+    frame.time = QDateTime::currentMSecsSinceEpoch();
+    frame.key = false;
+
+    quint32 count = 0;
+    QByteArray samples;
+    QDataStream sampleOut(&samples, QIODevice::WriteOnly);
+    sampleOut.setVersion(kStreamVersion);
+
+    for (auto it = m_watches.begin(); it != m_watches.end();) {
+        SelfStatsReport report;
+        if (frame.time > it->until || !it->sampler->sample(report)) {
+            qCInfo(app) << "Watch of process" << it.key().first << "ended";
+            m_watchSockets.release(it.key().first);
+            it = m_watches.erase(it);
+            continue;
+        }
+
+        pid_t pid = it.key().first;
+        // the fd dir is only walked again when its fd count changed
+        const QList<ino_t> &sockets = m_watchSockets.sockInodes(pid);
+        sampleOut << pid << it.key().second << qint32(it->rules) << report.cpuPercent << quint64(report.rss)
+                  << qint32(countFds(pid)) << quint32(report.threads.size());
+        // busiest first
+        quint32 threads = quint32(qMin(report.threads.size(), size_t(kMaxDetailThreads)));
+        sampleOut << threads;
+        for (quint32 i = 0; i < threads; ++i) {
+            const ThreadUsage &thread = report.threads[i];
+            sampleOut << qint32(thread.tid) << QByteArray::fromStdString(thread.name) << thread.cpuPercent
+                      << thread.wakeupsPerSec;
+        }
+        sampleOut << quint32(sockets.size());
+        quint32 inodes = quint32(qMin(int(sockets.size()), int(kMaxDetailSockets)));
+        sampleOut << inodes;
+        for (quint32 i = 0; i < inodes; ++i)
+            sampleOut << quint64(sockets[int(i)]);
+        ++count;
+        ++it;
+    }
+
+    if (m_watches.isEmpty())
+        m_watchTimer.stop();
+    if (count == 0)
+        return;
+
+    // sample count, then the samples
+    QByteArray raw;
+    QDataStream out(&raw, QIODevice::WriteOnly);
+    out.setVersion(kStreamVersion);
+    out << count;
+    raw.append(samples);
+    frame.data = qCompress(raw);
+    appendDetail(std::move(frame));
+}
+
+void FlightRecorder::appendDetail(frame_t frame)
+{
+    m_detailBytes += frame.data.size();
+    m_details.push_back(std::move(frame));
+    while (m_details.size() > 1
+           && (m_details.back().time - m_details.front().time > m_window || m_detailBytes > kMaxDetailBytes)) {
+        m_detailBytes -= m_details.front().data.size();
+        m_details.pop_front();
+    }
+}
+
+void FlightRecorder::append(frame_t frame)
+{
+    m_bytes += frame.data.size();
+    m_frames.push_back(std::move(frame));
+
+    // a frame needs the names of its key frame, so the oldest group goes once the next one alone covers the window
+    for (;;) {
+        auto next = std::find_if(m_frames.begin() + 1, m_frames.end(), [](const frame_t &f) { return f.key; });
+        if (next == m_frames.end()
+            || (m_frames.back().time - next->time < m_window && m_bytes <= kMaxBytes))
+            break;
+        for (auto it = m_frames.begin(); it != next; ++it)
+            m_bytes -= it->data.size();
+        m_frames.erase(m_frames.begin(), next);
+    }
+}
+
+QString FlightRecorder::defaultCapturePath()
+{
+    const QString &dir = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
+    const QString &stamp = QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss");
+    return QString("%1/deepin-system-monitor-%2.dsmrec").arg(dir, stamp);
+}
+
+bool FlightRecorder::capture(const QString &path) const
+{
+    if (m_frames.empty())
+        return false;
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(app) << "Failed to write snapshot" << path << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(kStreamVersion);
+    SysInfo *sysInfo = SysInfo::instance();
+    out << kSnapshotMagic << kSnapshotVersion << QDateTime::currentMSecsSinceEpoch() << sysInfo->hostname()
+        << sysInfo->version() << sysInfo->arch();
+    DeviceDB::instance()->snapshot()->cpuSet.saveInfo(out);
+    out << quint32(m_frames.size());
+    for (const frame_t &frame : m_frames)
+        out << frame.time << frame.key << frame.data;
+    out << quint32(m_details.size());
+    for (const frame_t &frame : m_details)
+        out << frame.time << frame.data;
+
+    // replaced at once, a reader never sees half a snapshot
+    if (!file.commit()) {
+        qCWarning(app) << "Failed to write snapshot" << path << file.errorString();
+        return false;
+    }
+    qCInfo(app) << "Captured" << m_frames.size() << "frames &" << m_details.size() << "detail frames to" << path;
+    return true;
+}
+
+bool FlightRecorder::readSnapshot(const QString &path, QList<frame_t> &frames, quint32 &version, CPUSet &cpuSet)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(app) << "Failed to open snapshot" << path << file.errorString();
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(kStreamVersion);
+    quint32 magic = 0, count = 0;
+    qint64 capturedAt = 0;
+    QString hostname, osVersion, arch;
+    in >> magic >> version;
+    if (magic != kSnapshotMagic || version < 1 || version > kSnapshotVersion) {
+        qCWarning(app) << "Not a snapshot of this version" << path;
+        return false;
+    }
+    in >> capturedAt >> hostname >> osVersion >> arch;
+    cpuSet.loadInfo(in);
+    in >> count;
+
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        frame_t frame;
+        in >> frame.time >> frame.key >> frame.data;
+        frames << frame;
+    }
+    // details of watched processes are kept for offline analysis, they're not shown
+    quint32 details = 0;
+    if (version >= 2 && in.status() == QDataStream::Ok) {
+        in >> details;
+        for (quint32 i = 0; i < details && in.status() == QDataStream::Ok; ++i) {
+            qint64 time;
+            QByteArray data;
+            in >> time >> data;
+        }
+    }
+    // a replay starts at a key frame, it holds the names of all processes
+    if (in.status() != QDataStream::Ok || frames.isEmpty() || !frames.first().key) {
+        qCWarning(app) << "Snapshot corrupted" << path;
+        return false;
+    }
+    qCInfo(app) << "Read" << frames.size() << "frames," << details << "detail frames of" << hostname << "captured at"
+                << QDateTime::fromMSecsSinceEpoch(capturedAt).toString(Qt::ISODate);
+    return true;
+}
+
+bool FlightRecorder::replay(const QString &path)
+{
+    QList<frame_t> frames;
+    quint32 version = 0;
+    CPUSet cpuSet;
+    if (!readSnapshot(path, frames, version, cpuSet))
+        return false;
+
+    if (!m_replaying) {
+        // watches sample live processes, nothing is recorded while replaying
+        m_watches.clear();
+        m_watchSockets.clear();
+        m_watchTimer.stop();
+        SystemMonitor::instance()->setPaused(true);
+        ModelManager::instance()->sampleHistory()->setStoring(false);
+    }
+    m_replaying = true;
+    m_replayFrames.swap(frames);
+    m_replayVersion = version;
+    m_replayPos = 0;
+    m_replayCpuSet = cpuSet;
+    m_replayProcs.clear();
+    Q_EMIT replayStateChanged(true);
+    replayNext();
+    return true;
+}
+
+void FlightRecorder::stopReplay()
+{
+    if (!m_replaying)
+        return;
+
+    m_replayTimer.stop();
+    m_replaying = false;
+    m_replayFrames.clear();
+    m_replayProcs.clear();
+    m_replayCpuSet = CPUSet();
+    // live rows & device state come with the next scan
+    ModelManager::instance()->processRowPreparer()->setReplayTable(nullptr);
+    ModelManager::instance()->sampleHistory()->setStoring(true);
+    SystemMonitor::instance()->setPaused(false);
+    Q_EMIT replayStateChanged(false);
+}
+
+void FlightRecorder::replayNext()
+{
+    if (!m_replaying || m_replayPos >= m_replayFrames.size())
+        return;
+
+    const frame_t &frame = m_replayFrames[m_replayPos];
+    if (!showFrame(frame)) {
+        qCWarning(app) << "Snapshot frame" << m_replayPos << "corrupted, replay stopped";
+        m_replayPos = m_replayFrames.size();
+        return;
+    }
+    Q_EMIT replayProgress(frame.time, m_replayPos, m_replayFrames.size());
+
+    if (++m_replayPos < m_replayFrames.size()) {
+        qint64 interval = m_replayFrames[m_replayPos].time - frame.time;
+        m_replayTimer.start(int(qBound(qint64(kMinReplayInterval), interval, qint64(kMaxReplayInterval))));
+    }
+}
+
+bool FlightRecorder::showFrame(const frame_t &frame)
+{
+    QByteArray raw = qUncompress(frame.data);
+    if (raw.isEmpty())
+        return false;
+    QDataStream in(raw);
+    in.setVersion(kStreamVersion);
+
+    std::shared_ptr<DeviceSnapshot> snapshot = std::make_shared<DeviceSnapshot>();
+    sockstat_t sockStat;
+    readDeviceStats(in, m_replayCpuSet, *snapshot, sockStat);
+
+    bool netTrafficSampled = false;
+    quint32 count = 0;
+    in >> netTrafficSampled >> count;
+    QList<Process> procs;
+    QHash<ProcessKey, Process> replayProcs;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        ProcessKey key;
+        bool withNames = false;
+        in >> key.first >> key.second >> withNames;
+        Process proc;
+        if (withNames) {
+            proc.loadNames(in);
+            // services & sockets are only compared, they're not shown
+            if (m_replayVersion >= 3) {
+                QString unit;
+                in >> unit;
+            }
+        } else {
+            // carries the sample history of the previous frame on
+            auto it = m_replayProcs.constFind(key);
+            if (it == m_replayProcs.constEnd())
+                return false;
+            proc = it->detached();
+        }
+        proc.loadStats(in);
+        if (m_replayVersion >= 3) {
+            qint32 sockets;
+            in >> sockets;
+        }
+        procs << proc;
+        replayProcs.insert(key, proc);
+    }
+    if (in.status() != QDataStream::Ok)
+        return false;
+    m_replayProcs.swap(replayProcs);
+
+    DeviceDB::instance()->publishSnapshot(DeviceSnapshotPtr(std::move(snapshot)));
+    auto table = ProcessTableModel::makeRowTable(procs, netTrafficSampled, m_nameRanks, m_userRanks);
+    ModelManager::instance()->processRowPreparer()->setReplayTable(table);
+    ModelManager::instance()->updateCoordinator()->markDirty();
+    return true;
+}
+
+QList<FlightRecorder::frame_t> FlightRecorder::framesAt(qint64 time) const
+{
+    if (m_frames.empty())
+        return {};
+
+    auto last = std::upper_bound(m_frames.begin(), m_frames.end(), time,
+                                 [](qint64 t, const frame_t &frame) { return t < frame.time; });
+    if (last != m_frames.begin())
+        --last;
+    auto first = last;
+    while (first != m_frames.begin() && !first->key)
+        --first;
+
+    // data is shared with the ring, nothing is copied
+    QList<frame_t> frames;
+    for (auto it = first; it != last + 1; ++it)
+        frames << *it;
+    return frames;
+}
+
+DiffSnapshotPtr FlightRecorder::decodeSnapshot(const QList<frame_t> &frames, quint32 version)
+{
+    if (frames.isEmpty() || !frames.first().key)
+        return nullptr;
+
+    struct names_t {
+        QString name;
+        QString unit;
+    };
+    // names of processes a frame doesn't repeat come from the frame before
+    QHash<ProcessKey, names_t> names, frameNames;
+    CPUSet cpuSet;
+    DeviceSnapshot device;
+    sockstat_t sockStat;
+    Process proc;
+    std::shared_ptr<DiffSnapshot> snapshot;
+    for (int i = 0; i < frames.size(); ++i) {
+        QByteArray raw = qUncompress(frames[i].data);
+        if (raw.isEmpty())
+            return nullptr;
+        QDataStream in(raw);
+        in.setVersion(kStreamVersion);
+        readDeviceStats(in, cpuSet, device, sockStat);
+
+        bool netTrafficSampled = false;
+        quint32 count = 0;
+        in >> netTrafficSampled >> count;
+        const bool last = i == frames.size() - 1;
+        if (last) {
+            snapshot = std::make_shared<DiffSnapshot>(frames[i].time);
+            snapshot->reserve(int(count));
+        }
+        frameNames.clear();
+        for (quint32 n = 0; n < count && in.status() == QDataStream::Ok; ++n) {
+            ProcessKey key;
+            bool withNames = false;
+            in >> key.first >> key.second >> withNames;
+            names_t procNames;
+            if (withNames) {
+                proc.loadNames(in);
+                procNames.name = proc.displayName();
+                if (version >= 3)
+                    in >> procNames.unit;
+            } else {
+                auto it = names.constFind(key);
+                if (it == names.constEnd())
+                    return nullptr;
+                procNames = *it;
+            }
+            proc.loadStats(in);
+            qint32 sockets = -1;
+            if (version >= 3)
+                in >> sockets;
+
+            if (last) {
+                snapshot->append({key.first, key.second, procNames.name, procNames.unit, proc.cpu(),
+                                  proc.utime() + proc.stime(), proc.memory(), proc.readBytes(), proc.writeBytes(),
+                                  sockets});
+            } else {
+                frameNames.insert(key, procNames);
+            }
+        }
+        if (in.status() != QDataStream::Ok)
+            return nullptr;
+        names.swap(frameNames);
+    }
+    snapshot->finish();
+    return snapshot;
+}
+
+QFuture<SnapshotDiff> FlightRecorder::compare(qint64 time) const
+{
+    const QList<frame_t> before = framesAt(time);
+    const QList<frame_t> after = framesAt(std::numeric_limits<qint64>::max());
+    return TaskExecutor::instance()->run(TaskExecutor::kBackgroundTask, [before, after]() {
+        return SnapshotDiff::compute(decodeSnapshot(before, kSnapshotVersion), decodeSnapshot(after, kSnapshotVersion));
+    });
+}
+
+QFuture<SnapshotDiff> FlightRecorder::compareFile(const QString &path) const
+{
+    const QList<frame_t> after = framesAt(std::numeric_limits<qint64>::max());
+    return TaskExecutor::instance()->run(TaskExecutor::kBackgroundTask, [path, after]() {
+        QList<frame_t> frames;
+        quint32 version = 0;
+        CPUSet cpuSet;
+        if (!readSnapshot(path, frames, version, cpuSet))
+            return SnapshotDiff();
+
+        // the last frame & the ones from its key frame on
+        int first = frames.size() - 1;
+        while (first > 0 && !frames[first].key)
+            --first;
+        DiffSnapshotPtr before = decodeSnapshot(frames.mid(first), version);
+        if (!before)
+            qCWarning(app) << "Snapshot corrupted" << path;
+        return SnapshotDiff::compute(before, decodeSnapshot(after, kSnapshotVersion));
+    });
+}
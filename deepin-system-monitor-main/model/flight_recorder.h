@@ -0,0 +1,232 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include "process_table_model.h"
+#include "process_triggers.h"
+#include "common/self_stats.h"
+#include "process/process_diff.h"
+#include "process/sock_inode_index.h"
+#include "system/cpu_set.h"
+
+#include <QFuture>
+#include <QHash>
+#include <QObject>
+#include <QPair>
+#include <QSet>
+#include <QTimer>
+
+#include <deque>
+#include <memory>
+
+/**
+ * @brief Ring of the last minutes of samples, written to a snapshot file on capture & replayed from one
+ *
+ * A frame is recorded for every published process table: cpu jiffies, memory & io rates of the device snapshot
+ * of the same scan, the processes of the table & /proc/net/sockstat. Frames are compressed as they're recorded, ids,
+ * names, command lines & the service of a process are only written in key frames & for processes new since the
+ * previous frame, whole key frame groups are dropped past the window, so the ring stays at a few hundred kB per minute.
+ * The cgroup of a process is read once, when it first shows up.
+ *
+ * A replayed snapshot is fed through DeviceDB, the process row preparer & the update coordinator while sampling is
+ * paused, every model & view shows it as if it was sampled live. Socket stats are only kept for offline analysis,
+ * per device net & disk figures are not recorded.
+ *
+ * Two frames, of the ring or the last one of a snapshot file, are compared as SnapshotDiff off the ui thread.
+ *
+ * Processes matching a trigger rule are watched: threads, fds & sockets are sampled every kWatchInterval
+ * into a ring of detail frames next to the scan frames. Nothing is read for processes no rule matches.
+ */
+class FlightRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Socket counts of /proc/net/sockstat & sockstat6, mem in pages
+     */
+    struct sockstat_t {
+        quint32 sockets {0};
+        quint32 tcpInUse {0};
+        quint32 tcpOrphan {0};
+        quint32 tcpTimeWait {0};
+        quint32 tcpAlloc {0};
+        quint32 tcpMem {0};
+        quint32 udpInUse {0};
+        quint32 udpMem {0};
+        quint32 rawInUse {0};
+        quint32 tcp6InUse {0};
+        quint32 udp6InUse {0};
+    };
+
+    // default window, kSettingKeyFlightRecorderMinutes
+    static constexpr int kDefaultMinutes = 10;
+    // frames between key frames, a minute at the default process refresh
+    static constexpr int kKeyFrameInterval = 30;
+    // ring bound whatever the window, dense process tables drop old frames first
+    static constexpr int kMaxBytes = 64 * 1024 * 1024;
+    // sampling interval of watched processes, ms
+    static constexpr int kWatchInterval = 250;
+    // a watch ends this long after its process last matched a rule, ms
+    static constexpr qint64 kWatchLinger = 60 * 1000;
+    // processes watched at a time, further matches wait for a free slot
+    static constexpr int kMaxWatches = 4;
+    // busiest threads & socket inodes kept per detail sample
+    static constexpr int kMaxDetailThreads = 32;
+    static constexpr int kMaxDetailSockets = 256;
+    // detail frames bound, on top of kMaxBytes
+    static constexpr int kMaxDetailBytes = 16 * 1024 * 1024;
+
+    explicit FlightRecorder(QObject *parent = nullptr);
+
+    /**
+     * @brief Record a frame of the latest row table & device snapshot, run by ModelManager for every published table
+     */
+    void record();
+    /**
+     * @brief Keep the frames of the last minutes
+     */
+    void setWindow(int minutes);
+    /**
+     * @brief Replace the trigger rules, running watches go on until they linger out
+     */
+    void setRules(const ProcessTriggers::rules_t &rules);
+    inline int watchCount() const { return m_watches.size(); }
+
+    /**
+     * @brief Write the ring to a snapshot file
+     * @return false if it can't be written or nothing was recorded yet
+     */
+    bool capture(const QString &path) const;
+    /**
+     * @brief New file name under the user's documents, stamped with the current time
+     */
+    static QString defaultCapturePath();
+
+    /**
+     * @brief Pause sampling & replay a snapshot file at its recorded pace, the last frame stays shown
+     * @return false if the file can't be read or isn't a snapshot
+     */
+    bool replay(const QString &path);
+    /**
+     * @brief Go back to live sampling
+     */
+    void stopReplay();
+    inline bool isReplaying() const { return m_replaying; }
+
+    /**
+     * @brief Compare the frame recorded at or before \a time with the latest one, decoded on a background thread
+     * @return Future of an invalid diff if nothing was recorded
+     */
+    QFuture<core::process::SnapshotDiff> compare(qint64 time) const;
+    /**
+     * @brief Compare the last frame of a snapshot file with the latest recorded one
+     * @return Future of an invalid diff if the file can't be read
+     */
+    QFuture<core::process::SnapshotDiff> compareFile(const QString &path) const;
+    /**
+     * @brief Recording time of the oldest frame in the ring, 0 if nothing was recorded
+     */
+    inline qint64 oldestTime() const { return m_frames.empty() ? 0 : m_frames.front().time; }
+
+    /**
+     * @brief Parse /proc/net/sockstat or sockstat6 content, unknown lines are skipped
+     */
+    static void parseSockStat(const char *buf, size_t len, sockstat_t &stat);
+
+Q_SIGNALS:
+    void replayStateChanged(bool replaying);
+    /**
+     * @brief A frame of the replay was shown
+     * @param time Recording time of the frame, ms since epoch
+     */
+    void replayProgress(qint64 time, int frame, int frames);
+    /**
+     * @brief A process matched a trigger rule & is sampled every kWatchInterval
+     * @param rules ProcessTriggers::Rule flags
+     */
+    void watchStarted(pid_t pid, int rules);
+
+private:
+    using ProcessKey = ProcessTriggers::ProcessKey;
+
+    struct frame_t {
+        qint64 time; // ms since epoch
+        bool key;
+        QByteArray data; // compressed
+    };
+
+    struct watch_t {
+        qint64 until; // ms since epoch
+        int rules; // rules matched since the watch started
+        std::shared_ptr<common::selfstats::SelfStatsSampler> sampler; // per thread rates of /proc/[pid]/task
+    };
+
+    /**
+     * @brief Add a frame, drops key frame groups past the window or the byte bound
+     */
+    void append(frame_t frame);
+    /**
+     * @brief Start or extend watches of the processes matching a rule, end those gone from the scan
+     */
+    void watch(const QVector<ProcessTriggers::match_t> &matches, const QSet<ProcessKey> &scanned, qint64 now);
+    /**
+     * @brief Sample the watched processes into a detail frame, ends lingered out watches
+     */
+    void sampleWatches();
+    void appendDetail(frame_t frame);
+    /**
+     * @brief Open fds of pid, st_size of the fd dir when the kernel reports it, -1 if it's not readable
+     */
+    static int countFds(pid_t pid);
+    /**
+     * @brief Show the next frame of the replay & schedule the one after
+     */
+    void replayNext();
+    bool showFrame(const frame_t &frame);
+    /**
+     * @brief Frames of a snapshot file, its cpu set info & format version
+     */
+    static bool readSnapshot(const QString &path, QList<frame_t> &frames, quint32 &version, core::system::CPUSet &cpuSet);
+    /**
+     * @brief The latest frame recorded at or before \a time, the oldest if none is, after the frames from its key frame on
+     */
+    QList<frame_t> framesAt(qint64 time) const;
+    /**
+     * @brief Processes of the last of \a frames, the first is a key frame & the others follow it
+     * @return null if a frame is corrupted
+     */
+    static core::process::DiffSnapshotPtr decodeSnapshot(const QList<frame_t> &frames, quint32 version);
+
+    static void readSockStat(sockstat_t &stat);
+
+    // recording
+    std::deque<frame_t> m_frames;
+    qint64 m_window;
+    qint64 m_bytes {0};
+    int m_sinceKey {0};
+    QSet<ProcessKey> m_named; // processes of the previous frame
+    QHash<ProcessKey, QString> m_units; // services of the processes of the previous frame
+    ProcessTriggers m_triggers;
+    QHash<ProcessKey, watch_t> m_watches;
+    QTimer m_watchTimer;
+    core::process::SockInodeIndex m_watchSockets;
+    std::deque<frame_t> m_details; // key unused
+    qint64 m_detailBytes {0};
+
+    // replay
+    bool m_replaying {false};
+    quint32 m_replayVersion {0};
+    QList<frame_t> m_replayFrames;
+    int m_replayPos {0};
+    QTimer m_replayTimer;
+    core::system::CPUSet m_replayCpuSet; // holds the previous jiffies, usage is computed like on a read
+    QHash<ProcessKey, Process> m_replayProcs;
+    QHash<QString, int> m_nameRanks;
+    QHash<QString, int> m_userRanks;
+};
+
+#endif // FLIGHT_RECORDER_H
@@ -0,0 +1,175 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "irq_source_model.h"
+#include "ddlog.h"
+#include "process/system_service_client.h"
+#include "process_info_record.h"
+
+#include <DConfig>
+
+#include <QApplication>
+#include <QScopedPointer>
+
+#include <algorithm>
+
+#include <string.h>
+
+using namespace DDLog;
+using namespace core::process;
+
+IrqSourceModel::IrqSourceModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+    qCDebug(app) << "IrqSourceModel constructor";
+}
+
+IrqSourceModel::~IrqSourceModel()
+{
+    stop();
+}
+
+void IrqSourceModel::refresh()
+{
+    if (!m_opened) {
+        if (!m_client) {
+            // irq events come from DKapture only, follow the process table setting
+            QScopedPointer<DTK_CORE_NAMESPACE::DConfig> config(DTK_CORE_NAMESPACE::DConfig::create("deepin-system-monitor", "org.deepin.system-monitor"));
+            if (!config || !config->value("enable_dkapture", false).toBool()) {
+                qCDebug(app) << "DKapture disabled, no irq stats";
+                m_available = false;
+                return;
+            }
+            m_client = new SystemServiceClient(this);
+        }
+        m_opened = m_client->openIrqStats();
+        m_available = m_opened;
+        if (!m_opened)
+            return;
+    }
+
+    QByteArray stats;
+    if (!m_client->getIrqStats(stats))
+        return;
+    applyStats(stats);
+}
+
+void IrqSourceModel::stop()
+{
+    if (m_opened) {
+        m_client->closeIrqStats();
+        m_opened = false;
+    }
+    m_last.clear();
+    m_lastTimestamp = 0;
+}
+
+void IrqSourceModel::applyStats(const QByteArray &stats)
+{
+    const irq_stat_record_t *records = nullptr;
+    const irq_stats_header_t *hdr = irqStatRecords(stats.constData(), size_t(stats.size()), records);
+    if (!hdr)
+        return;
+
+    // snapshots are cached by the server, same timestamp means nothing new
+    if (hdr->timestamp == m_lastTimestamp)
+        return;
+    const bool hasInterval = m_lastTimestamp && hdr->timestamp > m_lastTimestamp;
+    const qreal intervalNs = hasInterval ? qreal(hdr->timestamp - m_lastTimestamp) : 0.;
+
+    QHash<quint64, irq_sample_t> last;
+    QList<irq_source_t> sources;
+    for (uint32_t i = 0; i < hdr->count; ++i) {
+        const irq_stat_record_t &rec = records[i];
+        const quint64 key = (quint64(rec.type) << 32) | quint32(rec.vec);
+        irq_source_t source {};
+        source.type = rec.type;
+        source.vec = rec.vec;
+        source.name = QString::fromLocal8Bit(rec.name, int(strnlen(rec.name, sizeof(rec.name))));
+
+        auto prev = m_last.constFind(key);
+        // totals restart when tracing is reopened
+        if (hasInterval && prev != m_last.constEnd() && rec.count >= prev->count && rec.time_ns >= prev->time_ns) {
+            source.rate = (rec.count - prev->count) * 1e9 / intervalNs;
+            source.load = (rec.time_ns - prev->time_ns) * 100. / intervalNs;
+            source.hasRate = true;
+        }
+        last.insert(key, {rec.count, rec.time_ns});
+        sources << source;
+    }
+    m_last = last;
+    m_lastTimestamp = hdr->timestamp;
+
+    // most expensive sources first
+    std::stable_sort(sources.begin(), sources.end(), [](const irq_source_t &a, const irq_source_t &b) {
+        return a.load > b.load;
+    });
+
+    beginResetModel();
+    m_sources = sources;
+    endResetModel();
+}
+
+int IrqSourceModel::rowCount(const QModelIndex &) const
+{
+    return m_sources.size();
+}
+
+int IrqSourceModel::columnCount(const QModelIndex &) const
+{
+    return kIrqSourceColumnCount;
+}
+
+QVariant IrqSourceModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && (role == Qt::DisplayRole || role == Qt::AccessibleTextRole)) {
+        switch (section) {
+        case kIrqSourceNameColumn:
+            return QApplication::translate("CPU.Irq.Header", kIrqSourceName);
+        case kIrqSourceRateColumn:
+            return QApplication::translate("CPU.Irq.Header", kIrqSourceRate);
+        case kIrqSourceTimeColumn:
+            return QApplication::translate("CPU.Irq.Header", kIrqSourceTime);
+        default:
+            break;
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+QVariant IrqSourceModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_sources.size())
+        return {};
+
+    const auto &source = m_sources[index.row()];
+    if (role == Qt::DisplayRole || role == Qt::AccessibleTextRole) {
+        switch (index.column()) {
+        case kIrqSourceNameColumn:
+            if (source.type == IRQ_STAT_SOFT)
+                return QApplication::translate("CPU.Irq", "%1 (softirq)").arg(source.name);
+            return QApplication::translate("CPU.Irq", "%1 (IRQ %2)").arg(source.name).arg(source.vec);
+        case kIrqSourceRateColumn:
+            return source.hasRate ? QApplication::translate("CPU.Irq", "%1/s").arg(source.rate, 0, 'f', 0) : QStringLiteral("-");
+        case kIrqSourceTimeColumn:
+            return source.hasRate ? QString("%1%").arg(source.load, 0, 'f', 2) : QStringLiteral("-");
+        default:
+            break;
+        }
+    } else if (role == Qt::UserRole) {
+        switch (index.column()) {
+        case kIrqSourceRateColumn:
+            return source.rate;
+        case kIrqSourceTimeColumn:
+            return source.load;
+        default:
+            return index.data(Qt::DisplayRole);
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return {};
+}
@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef IRQ_SOURCE_MODEL_H
+#define IRQ_SOURCE_MODEL_H
+
+#include <QAbstractTableModel>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+
+namespace core {
+namespace process {
+class SystemServiceClient;
+}
+}
+
+// source column display
+constexpr const char *kIrqSourceName = QT_TRANSLATE_NOOP("CPU.Irq.Header", "Interrupt");
+// rate column display
+constexpr const char *kIrqSourceRate = QT_TRANSLATE_NOOP("CPU.Irq.Header", "Rate");
+// handler time column display
+constexpr const char *kIrqSourceTime = QT_TRANSLATE_NOOP("CPU.Irq.Header", "Handler time");
+
+/**
+ * @brief Rate & handler time of every hard irq line & softirq vector of the system
+ *
+ * Irq events are traced in the kernel by DKapture & aggregated by the system server, nothing is
+ * traced until refresh() is called & tracing stops with stop(). Handler time is the share of one
+ * cpu spent in the handler, events carry no cpu so it is not split per core. Without the DKapture
+ * system service the model stays empty, see isAvailable().
+ */
+class IrqSourceModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        kIrqSourceNameColumn = 0,
+        kIrqSourceRateColumn,
+        kIrqSourceTimeColumn,
+
+        kIrqSourceColumnCount
+    };
+
+    explicit IrqSourceModel(QObject *parent = nullptr);
+    ~IrqSourceModel() override;
+
+    /**
+     * @brief Start tracing if needed & update rates
+     */
+    void refresh();
+    /**
+     * @brief Stop tracing & drop rate history
+     */
+    void stop();
+
+    /**
+     * @brief false once tracing could not be started, DKapture disabled or the system service unusable
+     */
+    inline bool isAvailable() const { return m_available; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    struct irq_source_t {
+        quint32 type;
+        int vec;
+        QString name;
+        qreal rate; // events per second
+        qreal load; // percent of one cpu
+        bool hasRate;
+    };
+    struct irq_sample_t {
+        quint64 count;
+        quint64 time_ns;
+    };
+
+    /**
+     * @brief Update rows from a getIrqStats buffer
+     */
+    void applyStats(const QByteArray &stats);
+
+    core::process::SystemServiceClient *m_client {};
+    bool m_opened {false};
+    bool m_available {true};
+    QList<irq_source_t> m_sources {};
+    // last totals by type & vector, server snapshot time in ns
+    QHash<quint64, irq_sample_t> m_last {};
+    quint64 m_lastTimestamp {0};
+};
+
+#endif // IRQ_SOURCE_MODEL_H
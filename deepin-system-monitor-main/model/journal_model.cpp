@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "journal_model.h"
+
+#include <QBrush>
+#include <QColor>
+#include <QDateTime>
+
+// syslog levels
+const int kErrorPriority = 3;
+const int kWarningPriority = 4;
+
+JournalModel::JournalModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+void JournalModel::append(const QVector<JournalLine> &lines, int dropped)
+{
+    m_dropped += dropped;
+    if (lines.isEmpty())
+        return;
+
+    // a batch larger than what is kept only leaves its tail
+    const int incoming = qMin(lines.size(), kMaxLines);
+    const int excess = m_lines.size() + incoming - kMaxLines;
+    if (excess > 0) {
+        beginRemoveRows({}, 0, excess - 1);
+        m_lines.remove(0, excess);
+        endRemoveRows();
+    }
+
+    beginInsertRows({}, m_lines.size(), m_lines.size() + incoming - 1);
+    m_lines.reserve(m_lines.size() + incoming);
+    for (int i = lines.size() - incoming; i < lines.size(); ++i)
+        m_lines << lines[i];
+    endInsertRows();
+}
+
+void JournalModel::clear()
+{
+    beginResetModel();
+    m_lines.clear();
+    m_dropped = 0;
+    endResetModel();
+}
+
+QString JournalModel::lineText(const JournalLine &line)
+{
+    const QDateTime time = QDateTime::fromMSecsSinceEpoch(line.time / 1000);
+    QString text = time.toString("MMM dd hh:mm:ss") + " " + line.identifier;
+    if (line.pid > 0)
+        text += QString("[%1]").arg(line.pid);
+    text += ": ";
+    const int end = line.message.indexOf('\n');
+    if (end < 0)
+        return text + line.message;
+    return text + line.message.left(end) + " …";
+}
+
+int JournalModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_lines.size();
+}
+
+QVariant JournalModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_lines.size())
+        return {};
+
+    const JournalLine &line = m_lines[index.row()];
+    if (role == Qt::DisplayRole) {
+        return lineText(line);
+    } else if (role == Qt::ToolTipRole) {
+        // every line of the message
+        return line.message;
+    } else if (role == Qt::ForegroundRole) {
+        if (line.priority <= kErrorPriority)
+            return QBrush(QColor("#FF5736"));
+        if (line.priority == kWarningPriority)
+            return QBrush(QColor("#FF9900"));
+    }
+    return {};
+}
@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef JOURNAL_MODEL_H
+#define JOURNAL_MODEL_H
+
+#include "service/journal_tail.h"
+
+#include <QAbstractListModel>
+#include <QVector>
+
+/**
+ * @brief Lines of a followed journal, appended in the batches JournalTail hands over
+ *
+ * Keeps the last kMaxLines, the oldest are removed as new ones come in. Lines are formatted only
+ * when asked for, so only the rows a view shows cost anything.
+ */
+class JournalModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    // lines kept
+    static constexpr int kMaxLines = 10000;
+
+    explicit JournalModel(QObject *parent = nullptr);
+
+    void append(const QVector<JournalLine> &lines, int dropped);
+    void clear();
+    /**
+     * @brief Lines dropped since the last clear, lines removed to stay under kMaxLines aren't counted
+     */
+    inline int droppedCount() const { return m_dropped; }
+
+    /**
+     * @brief Row text like journalctl's short format, first line of the message only
+     */
+    static QString lineText(const JournalLine &line);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    QVector<JournalLine> m_lines;
+    int m_dropped {0};
+};
+
+#endif // JOURNAL_MODEL_H
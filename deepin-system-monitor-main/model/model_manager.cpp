@@ -4,15 +4,35 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "model_manager.h"
+#include "cpu_info_model.h"
+#include "flight_recorder.h"
+#include "process_row_preparer.h"
+#include "remote_source.h"
+#include "sample_history.h"
+#include "update_coordinator.h"
+#include "system/system_monitor.h"
 #include "ddlog.h"
 
 using namespace DDLog;
+using namespace core::system;
 
 Q_GLOBAL_STATIC(ModelManager, theInstance)
 ModelManager::ModelManager(QObject *parent)
     : QObject(parent)
 {
     qCDebug(app) << "ModelManager constructor";
+    m_updateCoordinator = new UpdateCoordinator(this);
+    m_sampleHistory = new SampleHistory(this);
+    connect(m_updateCoordinator, &UpdateCoordinator::updateHistory, m_sampleHistory, &SampleHistory::record);
+    // published before the stat update of the same scan, so the models flush with its rows
+    m_processRowPreparer = new ProcessRowPreparer(this);
+    m_flightRecorder = new FlightRecorder(this);
+    connect(m_processRowPreparer, &ProcessRowPreparer::rowTableUpdated, m_flightRecorder, &FlightRecorder::record);
+
+    // the cpu model is shared with the popup, which has no coordinator, so it's moved onto the flush here
+    CPUInfoModel *cpuModel = CPUInfoModel::instance();
+    disconnect(SystemMonitor::instance(), &SystemMonitor::statInfoUpdated, cpuModel, &CPUInfoModel::updateModel);
+    connect(m_updateCoordinator, &UpdateCoordinator::updateModels, cpuModel, &CPUInfoModel::updateModel);
 }
 
 ModelManager *ModelManager::instance()
@@ -20,3 +40,96 @@ ModelManager *ModelManager::instance()
     // qCDebug(app) << "ModelManager::instance()";
     return theInstance();
 }
+
+SampleHistory *ModelManager::sampleHistory() const
+{
+    return m_sampleHistory;
+}
+
+UpdateCoordinator *ModelManager::updateCoordinator() const
+{
+    return m_updateCoordinator;
+}
+
+ProcessRowPreparer *ModelManager::processRowPreparer() const
+{
+    return m_processRowPreparer;
+}
+
+FlightRecorder *ModelManager::flightRecorder() const
+{
+    return m_flightRecorder;
+}
+
+const QVector<int> ModelManager::kRefreshIntervals = {500, 1000, 2000, 5000, 10000};
+
+void ModelManager::setRefreshInterval(int intervalMs)
+{
+    if (!kRefreshIntervals.contains(intervalMs)) {
+        qCWarning(app) << "Unsupported refresh interval" << intervalMs << "ms";
+        return;
+    }
+    if (intervalMs == refreshInterval())
+        return;
+
+    qCInfo(app) << "Refresh interval set to" << intervalMs << "ms";
+    SystemMonitor::instance()->setRefreshInterval(intervalMs);
+    m_sampleHistory->setInterval(intervalMs);
+    emit refreshIntervalChanged(intervalMs);
+}
+
+int ModelManager::refreshInterval() const
+{
+    return m_sampleHistory->interval();
+}
+
+bool ModelManager::attachRemote(const QString &target)
+{
+    detachRemote();
+    m_flightRecorder->stopReplay();
+
+    auto *source = new RemoteSource(target, this);
+    if (!source->start()) {
+        delete source;
+        return false;
+    }
+    qCInfo(app) << "Attached remote source" << target;
+    m_remoteSource = source;
+    source->setAttached(true);
+    // like a replay, local samples are neither shown nor stored meanwhile
+    SystemMonitor::instance()->setPaused(true);
+    m_sampleHistory->setStoring(false);
+    connect(source, &RemoteSource::connected, this, [this](const QString &hostName) {
+        Q_EMIT remoteStateChanged(true, hostName);
+    });
+    connect(source, &RemoteSource::failed, this, [this, source](const QString &error) {
+        if (m_remoteSource != source)
+            return;
+        const QString failedTarget = source->target();
+        detachRemote();
+        Q_EMIT remoteFailed(failedTarget, error);
+    });
+    Q_EMIT remoteStateChanged(true, target);
+    return true;
+}
+
+void ModelManager::detachRemote()
+{
+    if (!m_remoteSource)
+        return;
+
+    qCInfo(app) << "Detached remote source" << m_remoteSource->target();
+    m_remoteSource->setAttached(false);
+    m_remoteSource->deleteLater();
+    m_remoteSource = nullptr;
+    // live rows & device state come with the next scan
+    m_processRowPreparer->setReplayTable(nullptr);
+    m_sampleHistory->setStoring(true);
+    SystemMonitor::instance()->setPaused(false);
+    Q_EMIT remoteStateChanged(false, QString());
+}
+
+RemoteSource *ModelManager::remoteSource() const
+{
+    return m_remoteSource;
+}
@@ -7,6 +7,13 @@
 #define MODEL_MANAGER_H
 
 #include <QObject>
+#include <QVector>
+
+class FlightRecorder;
+class ProcessRowPreparer;
+class RemoteSource;
+class SampleHistory;
+class UpdateCoordinator;
 
 class ModelManager : public QObject
 {
@@ -15,6 +22,68 @@ public:
     explicit ModelManager(QObject *parent = nullptr);
 
     static ModelManager *instance();
+
+    /**
+     * @brief Sample history shared by all chart widgets
+     */
+    SampleHistory *sampleHistory() const;
+    /**
+     * @brief Per frame flush of the stat updates, models & views refresh on its signals
+     */
+    UpdateCoordinator *updateCoordinator() const;
+    /**
+     * @brief Process table rows prepared on the monitor thread
+     */
+    ProcessRowPreparer *processRowPreparer() const;
+    /**
+     * @brief Ring of recent samples for snapshot captures & their replay
+     */
+    FlightRecorder *flightRecorder() const;
+
+    /**
+     * @brief Refresh the views every \a intervalMs, one of kRefreshIntervals, the charts keep their
+     * history resampled to the new cadence
+     */
+    void setRefreshInterval(int intervalMs);
+    int refreshInterval() const;
+    // choices offered in the menu, ms
+    static const QVector<int> kRefreshIntervals;
+
+    /**
+     * @brief Show another host, its agent's refreshes replace local sampling until detachRemote()
+     * @param target [ssh://][user@]host or tcp://127.0.0.1:port, see RemoteSource
+     * @return false if the target can't be parsed or connected to
+     */
+    bool attachRemote(const QString &target);
+    /**
+     * @brief Go back to local sampling
+     */
+    void detachRemote();
+    /**
+     * @brief Attached remote source, null when sampling locally
+     */
+    RemoteSource *remoteSource() const;
+
+Q_SIGNALS:
+    /**
+     * @brief A remote source was attached or detached, or its agent said which host it runs on
+     */
+    void remoteStateChanged(bool attached, const QString &hostName);
+    /**
+     * @brief The attached remote source failed & was detached
+     */
+    void remoteFailed(const QString &target, const QString &error);
+    /**
+     * @brief The views now refresh every intervalMs
+     */
+    void refreshIntervalChanged(int intervalMs);
+
+private:
+    UpdateCoordinator *m_updateCoordinator {nullptr};
+    SampleHistory *m_sampleHistory {nullptr};
+    ProcessRowPreparer *m_processRowPreparer {nullptr};
+    FlightRecorder *m_flightRecorder {nullptr};
+    RemoteSource *m_remoteSource {nullptr};
 };
 
 #endif // MODEL_MANAGER_H
@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "netif_queue_model.h"
+#include "ddlog.h"
+#include "common/core_usage.h"
+#include "system/cpu_set.h"
+#include "system/device_db.h"
+#include "system/device_snapshot.h"
+
+using namespace DDLog;
+using namespace core::system;
+
+NetifQueueModel::NetifQueueModel(QObject *parent)
+    : QObject(parent)
+{
+    qCDebug(app) << "NetifQueueModel constructor";
+}
+
+void NetifQueueModel::setInterface(const QByteArray &ifname)
+{
+    if (ifname == m_ifname)
+        return;
+    m_ifname = ifname;
+    stop();
+    Q_EMIT updated();
+}
+
+void NetifQueueModel::refresh()
+{
+    if (m_ifname.isEmpty())
+        return;
+
+    const QList<NetifQueues::irq_t> irqs = NetifQueues::readIrqs(m_ifname);
+    const QMap<int, NetifQueues::queue_stat_t> stats = NetifQueues::readStats(m_ifname);
+    qint64 interval = 0;
+    if (m_sampleTimer.isValid())
+        interval = m_sampleTimer.restart();
+    else
+        m_sampleTimer.start();
+
+    DeviceSnapshotPtr snapshot = DeviceDB::instance()->snapshot();
+    applySample(irqs, stats, interval, snapshot->cpuSet.cpuIds(), snapshot->cpuSet.coreUsage());
+}
+
+void NetifQueueModel::stop()
+{
+    m_queues.clear();
+    m_lastCounts.clear();
+    m_lastStats.clear();
+    m_sampleTimer.invalidate();
+}
+
+bool NetifQueueModel::isSaturated(qreal usage, qreal irq)
+{
+    // NaN when no time passed between the stat reads, not saturated
+    return usage >= kSaturatedUsage || irq >= kSaturatedIrq;
+}
+
+void NetifQueueModel::applySample(const QList<NetifQueues::irq_t> &irqs,
+                                  const QMap<int, NetifQueues::queue_stat_t> &stats,
+                                  qint64 interval, const QVector<int> &cpus, const common::usage::CoreUsage &usage)
+{
+    // counters of the first sample are only the base
+    const bool hasBase = interval > 0;
+    auto rate = [interval](quint64 now, quint64 last) {
+        // counters of a driver reset with the link
+        return now >= last ? qreal(now - last) * 1000. / qreal(interval) : 0.;
+    };
+
+    QList<queue_t> queues;
+    QHash<int, QVector<quint64>> counts;
+    for (const NetifQueues::irq_t &irq : irqs) {
+        queue_t queue;
+        queue.name = irq.name;
+        queue.irq = irq.irq;
+        queue.queue = irq.queue;
+        queue.direction = irq.direction;
+        queue.affinity = irq.affinity;
+        queue.rates.fill(0., irq.counts.size());
+
+        const QVector<quint64> last = m_lastCounts.value(irq.irq);
+        qreal peak = 0.;
+        for (int cpu = 0; hasBase && cpu < irq.counts.size() && cpu < last.size(); ++cpu) {
+            queue.rates[cpu] = rate(irq.counts[cpu], last[cpu]);
+            queue.irqRate += queue.rates[cpu];
+            if (queue.rates[cpu] > peak) {
+                peak = queue.rates[cpu];
+                queue.cpu = cpu;
+            }
+        }
+        if (queue.cpu >= 0 && queue.cpu < usage.size()) {
+            const size_t cpu = size_t(queue.cpu);
+            queue.saturated = isSaturated(usage.usage[cpu], usage.hardirq[cpu] + usage.softirq[cpu]);
+        }
+
+        auto stat = stats.constFind(irq.queue);
+        auto lastStat = m_lastStats.constFind(irq.queue);
+        if (hasBase && stat != stats.constEnd() && lastStat != m_lastStats.constEnd()) {
+            if (irq.direction & NetifQueues::kQueueRx)
+                queue.rxPackets = rate(stat->rxPackets, lastStat->rxPackets);
+            if (irq.direction & NetifQueues::kQueueTx)
+                queue.txPackets = rate(stat->txPackets, lastStat->txPackets);
+        }
+
+        counts.insert(irq.irq, irq.counts);
+        queues << queue;
+    }
+
+    m_lastCounts = counts;
+    m_lastStats = stats;
+    m_queues = queues;
+    m_cpus = cpus;
+    Q_EMIT updated();
+}
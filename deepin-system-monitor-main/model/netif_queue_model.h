@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NETIF_QUEUE_MODEL_H
+#define NETIF_QUEUE_MODEL_H
+
+#include "system/netif_queues.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+
+namespace common {
+namespace usage {
+struct CoreUsage;
+}
+}
+
+/**
+ * @brief Interrupt rate of each queue irq of one interface on each cpu, with its packet rates
+ *
+ * Rates are between the last two refresh() calls, the first one only takes the base. A queue is
+ * flagged saturated when the cpu taking most of its interrupts is busy or mostly in irq &
+ * softirq handlers, packets of the queue are then dropped or delayed however the load is spread.
+ * Everything comes from /proc & SIOCETHTOOL, no privilege needed.
+ */
+class NetifQueueModel : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct queue_t {
+        QByteArray name; // irq name
+        int irq {-1};
+        int queue {-1};
+        int direction {core::system::NetifQueues::kQueueRxTx};
+        QVector<qreal> rates; // interrupts per second by cpu id
+        qreal irqRate {0}; // all cpus
+        int cpu {-1}; // the one taking most interrupts, -1 if none came
+        QVector<int> affinity;
+        // packets per second of the queue, -1 if the driver doesn't count them per queue
+        qreal rxPackets {-1};
+        qreal txPackets {-1};
+        bool saturated {false};
+    };
+
+    explicit NetifQueueModel(QObject *parent = nullptr);
+
+    /**
+     * @brief Follow another interface, rates start over
+     */
+    void setInterface(const QByteArray &ifname);
+    inline QByteArray ifname() const { return m_ifname; }
+    /**
+     * @brief Read the irqs & counters of the interface & update the rates
+     */
+    void refresh();
+    /**
+     * @brief Drop the rates & their base, the next refresh() takes a new one
+     */
+    void stop();
+
+    inline const QList<queue_t> &queues() const { return m_queues; }
+    /**
+     * @brief Cpus of the columns, all the cpus of the last /proc/stat read
+     */
+    inline const QVector<int> &cpus() const { return m_cpus; }
+
+    /**
+     * @brief Whether a core with this usage can't keep up with more interrupts
+     * @param usage Busy percent
+     * @param irq Hard irq & softirq percent
+     */
+    static bool isSaturated(qreal usage, qreal irq);
+
+    static constexpr qreal kSaturatedUsage = 90.;
+    static constexpr qreal kSaturatedIrq = 50.;
+
+Q_SIGNALS:
+    void updated();
+
+private:
+    /**
+     * @brief Rates since the last sample, \a interval ms ago
+     * @param usage Of the cores between the last two /proc/stat reads, indexed by cpu id
+     */
+    void applySample(const QList<core::system::NetifQueues::irq_t> &irqs,
+                     const QMap<int, core::system::NetifQueues::queue_stat_t> &stats,
+                     qint64 interval, const QVector<int> &cpus, const common::usage::CoreUsage &usage);
+
+    QByteArray m_ifname;
+    QList<queue_t> m_queues {};
+    QVector<int> m_cpus {};
+    // counters of the last sample, by irq & queue
+    QHash<int, QVector<quint64>> m_lastCounts {};
+    QMap<int, core::system::NetifQueues::queue_stat_t> m_lastStats {};
+    QElapsedTimer m_sampleTimer;
+};
+
+#endif // NETIF_QUEUE_MODEL_H
@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "numa_node_model.h"
+#include "ddlog.h"
+#include "common/common.h"
+#include "model/cpu_info_model.h"
+#include "system/cpu_set.h"
+#include "system/device_db.h"
+#include "system/device_snapshot.h"
+#include "system/mem.h"
+
+#include <QApplication>
+
+#include <cmath>
+
+using namespace DDLog;
+using namespace common::format;
+using namespace core::system;
+
+NumaNodeModel::NumaNodeModel(CPUInfoModel *model, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_model(model)
+{
+    qCDebug(app) << "NumaNodeModel constructor";
+    if (m_model) {
+        connect(m_model, &CPUInfoModel::modelUpdated, this, &NumaNodeModel::onModelUpdated);
+        onModelUpdated();
+    }
+}
+
+QString NumaNodeModel::cpuListText(const QVector<int> &cpus)
+{
+    QStringList ranges;
+    for (int i = 0; i < cpus.size();) {
+        int j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1)
+            ++j;
+        ranges << (j > i ? QString("%1-%2").arg(cpus[i]).arg(cpus[j]) : QString::number(cpus[i]));
+        i = j + 1;
+    }
+    return ranges.join(',');
+}
+
+void NumaNodeModel::onModelUpdated()
+{
+    DeviceSnapshotPtr snapshot = DeviceDB::instance()->snapshot();
+    applyNodes(snapshot->cpuSet, snapshot->memInfo);
+}
+
+void NumaNodeModel::applyNodes(const CPUSet &cpuSet, const MemInfo &memInfo)
+{
+    const QMap<int, QVector<int>> &topology = cpuSet.numaNodes();
+    const QVector<node_mem_t> &memory = memInfo.nodes();
+    QVector<node_t> nodes;
+    // a single node is the whole system, shown by the views already
+    if (topology.size() > 1) {
+        nodes.reserve(topology.size());
+        for (auto it = topology.cbegin(); it != topology.cend(); ++it) {
+            node_t node {it.key(), it.value(), cpuSet.numaNodeUsagePercent(it.key()), 0, 0};
+            for (const node_mem_t &mem : memory) {
+                if (mem.node == node.node) {
+                    node.memTotal = mem.total;
+                    node.memUsed = mem.total > mem.free ? mem.total - mem.free : 0;
+                }
+            }
+            nodes << node;
+        }
+    }
+
+    // nodes only change across hotplug, refresh values in place otherwise
+    bool sameNodes = nodes.size() == m_nodes.size();
+    for (int i = 0; sameNodes && i < nodes.size(); ++i)
+        sameNodes = nodes[i].node == m_nodes[i].node && nodes[i].cpus == m_nodes[i].cpus;
+
+    if (sameNodes) {
+        m_nodes = nodes;
+        if (!m_nodes.isEmpty())
+            emit dataChanged(index(0, kNumaNodeCPUColumn), index(m_nodes.size() - 1, kNumaNodeMemoryColumn));
+        return;
+    }
+
+    beginResetModel();
+    m_nodes = nodes;
+    endResetModel();
+}
+
+int NumaNodeModel::rowCount(const QModelIndex &) const
+{
+    return m_nodes.size();
+}
+
+int NumaNodeModel::columnCount(const QModelIndex &) const
+{
+    return kNumaNodeColumnCount;
+}
+
+QVariant NumaNodeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && (role == Qt::DisplayRole || role == Qt::AccessibleTextRole)) {
+        switch (section) {
+        case kNumaNodeColumn:
+            return QApplication::translate("Numa.Node.Header", kNumaNode);
+        case kNumaNodeCPUsColumn:
+            return QApplication::translate("Numa.Node.Header", kNumaNodeCPUs);
+        case kNumaNodeCPUColumn:
+            return QApplication::translate("Numa.Node.Header", kNumaNodeCPU);
+        case kNumaNodeMemoryColumn:
+            return QApplication::translate("Numa.Node.Header", kNumaNodeMemory);
+        default:
+            break;
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+QVariant NumaNodeModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_nodes.size())
+        return {};
+
+    const auto &node = m_nodes[index.row()];
+    if (role == Qt::DisplayRole || role == Qt::AccessibleTextRole) {
+        switch (index.column()) {
+        case kNumaNodeColumn:
+            return QString("Node%1").arg(node.node);
+        case kNumaNodeCPUsColumn:
+            return cpuListText(node.cpus);
+        case kNumaNodeCPUColumn:
+            // no time elapsed between the stat reads
+            return std::isnan(node.cpuUsage) ? QStringLiteral("-") : QString("%1%").arg(node.cpuUsage, 0, 'f', 1);
+        case kNumaNodeMemoryColumn:
+            if (node.memTotal == 0)
+                return QStringLiteral("-");
+            return QString("%1 / %2").arg(formatUnit_memory_disk(node.memUsed, KB, 1))
+                                     .arg(formatUnit_memory_disk(node.memTotal, KB, 1));
+        default:
+            break;
+        }
+    } else if (role == Qt::UserRole) {
+        switch (index.column()) {
+        case kNumaNodeColumn:
+            return node.node;
+        case kNumaNodeCPUColumn:
+            return node.cpuUsage;
+        case kNumaNodeMemoryColumn:
+            return node.memUsed;
+        default:
+            return index.data(Qt::DisplayRole);
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return {};
+}
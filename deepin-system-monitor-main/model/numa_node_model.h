@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NUMA_NODE_MODEL_H
+#define NUMA_NODE_MODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+
+namespace core {
+namespace system {
+class CPUSet;
+class MemInfo;
+}
+}
+
+class CPUInfoModel;
+
+// node column display
+constexpr const char *kNumaNode = QT_TRANSLATE_NOOP("Numa.Node.Header", "Node");
+// cpus column display
+constexpr const char *kNumaNodeCPUs = QT_TRANSLATE_NOOP("Numa.Node.Header", "CPUs");
+// cpu usage column display
+constexpr const char *kNumaNodeCPU = QT_TRANSLATE_NOOP("Numa.Node.Header", "CPU");
+// memory column display
+constexpr const char *kNumaNodeMemory = QT_TRANSLATE_NOOP("Numa.Node.Header", "Memory");
+
+/**
+ * @brief Cpu usage & memory of each numa node
+ *
+ * Node cpus come from the lscpu topology, their usage is the average of the per core usage
+ * between the last two /proc/stat reads, memory from the meminfo of each node. Follows
+ * CPUInfoModel updates, empty on single node systems.
+ */
+class NumaNodeModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        kNumaNodeColumn = 0,
+        kNumaNodeCPUsColumn,
+        kNumaNodeCPUColumn,
+        kNumaNodeMemoryColumn,
+
+        kNumaNodeColumnCount
+    };
+
+    explicit NumaNodeModel(CPUInfoModel *model, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Cpu list in lscpu style, e.g. "0-7,16-23"
+     * @param cpus Logical cpu ids, ascending
+     */
+    static QString cpuListText(const QVector<int> &cpus);
+
+private:
+    struct node_t {
+        int node;
+        QVector<int> cpus;
+        qreal cpuUsage; // percent
+        qulonglong memTotal; // kB, 0 if unknown
+        qulonglong memUsed;
+    };
+
+    void onModelUpdated();
+    /**
+     * @brief Update rows from the numa topology of \a cpuSet & the node memory of \a memInfo
+     */
+    void applyNodes(const core::system::CPUSet &cpuSet, const core::system::MemInfo &memInfo);
+
+    CPUInfoModel *m_model;
+    QVector<node_t> m_nodes {};
+};
+
+#endif // NUMA_NODE_MODEL_H
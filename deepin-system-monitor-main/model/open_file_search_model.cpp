@@ -0,0 +1,152 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "open_file_search_model.h"
+#include "process_connection_model.h"
+#include "socket_table_model.h"
+#include "ddlog.h"
+
+#include <QApplication>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+using namespace DDLog;
+using namespace core::process;
+using namespace core::system;
+
+OpenFileSearchModel::OpenFileSearchModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_search(new OpenFileSearch(this))
+{
+    qCDebug(app) << "OpenFileSearchModel constructor";
+    connect(m_search, &OpenFileSearch::matchesFound, this, &OpenFileSearchModel::append);
+    connect(m_search, &OpenFileSearch::finished, this, &OpenFileSearchModel::finished);
+}
+
+bool OpenFileSearchModel::search(const QString &text)
+{
+    const OpenFileSearch::query_t query = OpenFileSearch::parseQuery(text);
+    m_search->cancel();
+    beginResetModel();
+    m_matches.clear();
+    m_pids.clear();
+    endResetModel();
+    if (query.isEmpty())
+        return false;
+
+    m_search->start(query);
+    Q_EMIT progressChanged();
+    return true;
+}
+
+void OpenFileSearchModel::cancel()
+{
+    m_search->cancel();
+    Q_EMIT progressChanged();
+}
+
+void OpenFileSearchModel::append(const QVector<OpenFileSearch::match_t> &matches)
+{
+    // rows are appended in the order found, a sorted view would move them on every batch
+    beginInsertRows({}, m_matches.size(), m_matches.size() + matches.size() - 1);
+    m_matches += matches;
+    for (const auto &match : matches)
+        m_pids.insert(match.pid);
+    endInsertRows();
+    Q_EMIT progressChanged();
+}
+
+QString OpenFileSearchModel::fdText(int fd)
+{
+    switch (fd) {
+    case OpenFileSearch::kCwdFd:
+        return QStringLiteral("cwd");
+    case OpenFileSearch::kRootFd:
+        return QStringLiteral("rtd");
+    case OpenFileSearch::kExeFd:
+        return QStringLiteral("txt");
+    case OpenFileSearch::kMapFd:
+        return QStringLiteral("mem");
+    default:
+        return QString::number(fd);
+    }
+}
+
+QString OpenFileSearchModel::targetText(const OpenFileSearch::match_t &match) const
+{
+    const SocketTable::socket_t *sock = match.socket ? m_search->socket(match.socket) : nullptr;
+    if (!sock)
+        return match.target;
+
+    // as the socket page shows it, e.g. TCP 127.0.0.1:631 LISTEN
+    QString proto = sock->proto == IPPROTO_TCP ? QStringLiteral("TCP") : QStringLiteral("UDP");
+    if (sock->family == AF_INET6)
+        proto += "6";
+    QString text = QString("%1 %2").arg(proto, ProcessConnectionModel::formatEndpoint(sock->family, &sock->laddr, sock->lport));
+    if (sock->rport)
+        text += QString(" -> %1").arg(ProcessConnectionModel::formatEndpoint(sock->family, &sock->raddr, sock->rport));
+    return text + ' ' + SocketTableModel::stateName(sock->proto, sock->state);
+}
+
+int OpenFileSearchModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_matches.size();
+}
+
+int OpenFileSearchModel::columnCount(const QModelIndex &) const
+{
+    return kOpenFileColumnCount;
+}
+
+QVariant OpenFileSearchModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && (role == Qt::DisplayRole || role == Qt::AccessibleTextRole)) {
+        switch (section) {
+        case kOpenFileProcessColumn:
+            return QApplication::translate("Process.OpenFile.Header", kOpenFileProcess);
+        case kOpenFilePidColumn:
+            return QApplication::translate("Process.OpenFile.Header", kOpenFilePid);
+        case kOpenFileFdColumn:
+            return QApplication::translate("Process.OpenFile.Header", kOpenFileFd);
+        case kOpenFileTargetColumn:
+            return QApplication::translate("Process.OpenFile.Header", kOpenFileTarget);
+        default:
+            break;
+        }
+    } else if (orientation == Qt::Horizontal && role == Qt::ToolTipRole && section == kOpenFileFdColumn) {
+        return QApplication::translate("Process.OpenFile.Header",
+                                       "Descriptor number, or cwd, rtd (root), txt (executable) & mem (mapped file)");
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+QVariant OpenFileSearchModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_matches.size())
+        return {};
+
+    const OpenFileSearch::match_t &match = m_matches[index.row()];
+    if (role == Qt::DisplayRole || role == Qt::AccessibleTextRole) {
+        switch (index.column()) {
+        case kOpenFileProcessColumn:
+            return match.name;
+        case kOpenFilePidColumn:
+            return match.pid;
+        case kOpenFileFdColumn:
+            return fdText(match.fd);
+        case kOpenFileTargetColumn:
+            return targetText(match);
+        default:
+            break;
+        }
+    } else if (role == Qt::ToolTipRole && index.column() == kOpenFileTargetColumn) {
+        return match.target;
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return {};
+}
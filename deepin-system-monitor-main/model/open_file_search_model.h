@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef OPEN_FILE_SEARCH_MODEL_H
+#define OPEN_FILE_SEARCH_MODEL_H
+
+#include "process/open_file_search.h"
+
+#include <QAbstractTableModel>
+#include <QSet>
+#include <QVector>
+
+// process name column display
+constexpr const char *kOpenFileProcess = QT_TRANSLATE_NOOP("Process.OpenFile.Header", "Process");
+// pid column display
+constexpr const char *kOpenFilePid = QT_TRANSLATE_NOOP("Process.OpenFile.Header", "PID");
+// fd column display
+constexpr const char *kOpenFileFd = QT_TRANSLATE_NOOP("Process.OpenFile.Header", "FD");
+// open file column display
+constexpr const char *kOpenFileTarget = QT_TRANSLATE_NOOP("Process.OpenFile.Header", "Name");
+
+/**
+ * @brief Processes holding a file, mount or port, rows appended as the search finds them
+ */
+class OpenFileSearchModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        kOpenFileProcessColumn = 0,
+        kOpenFilePidColumn,
+        kOpenFileFdColumn,
+        kOpenFileTargetColumn,
+
+        kOpenFileColumnCount
+    };
+
+    explicit OpenFileSearchModel(QObject *parent = nullptr);
+
+    /**
+     * @brief Drop the rows & search \a text, see OpenFileSearch::parseQuery
+     * @return false if the text is empty
+     */
+    bool search(const QString &text);
+    void cancel();
+    inline bool isRunning() const
+    {
+        return m_search->isRunning();
+    }
+    inline const core::process::OpenFileSearch *searcher() const
+    {
+        return m_search;
+    }
+    /**
+     * @brief Processes of the rows
+     */
+    inline int processCount() const
+    {
+        return int(m_pids.size());
+    }
+
+    /**
+     * @brief Column text of a pseudo fd as lsof names them, the number else
+     */
+    static QString fdText(int fd);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+Q_SIGNALS:
+    /**
+     * @brief Rows were appended or the search is done
+     */
+    void progressChanged();
+    void finished();
+
+private:
+    void append(const QVector<core::process::OpenFileSearch::match_t> &matches);
+    QString targetText(const core::process::OpenFileSearch::match_t &match) const;
+
+    core::process::OpenFileSearch *m_search {};
+    QVector<core::process::OpenFileSearch::match_t> m_matches;
+    QSet<pid_t> m_pids;
+};
+
+#endif // OPEN_FILE_SEARCH_MODEL_H
@@ -0,0 +1,230 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "process_connection_model.h"
+#include "ddlog.h"
+#include "common/common.h"
+#include "process/sock_inode_index.h"
+#include "system/netif_monitor.h"
+#include "system/sys_info.h"
+
+#include <QApplication>
+#include <QSet>
+
+#include <algorithm>
+
+#include <arpa/inet.h>
+
+using namespace DDLog;
+using namespace common::format;
+using namespace core::process;
+using namespace core::system;
+
+ProcessConnectionModel::ProcessConnectionModel(pid_t pid, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_pid(pid)
+{
+    qCDebug(app) << "ProcessConnectionModel constructor for pid:" << pid;
+    m_clock.start();
+}
+
+ProcessConnectionModel::~ProcessConnectionModel()
+{
+    stop();
+}
+
+void ProcessConnectionModel::refresh()
+{
+    QList<ino_t> inodes;
+    SockInodeIndex::scanSockInodes(m_pid, inodes);
+
+    // start keeping totals for new sockets, totals of known ones are preserved
+    auto *monitor = NetifMonitor::instance();
+    monitor->setWatchedSockets(inodes);
+    m_watching = true;
+    auto totals = monitor->watchedSockIOStats();
+    // per socket bytes only come from packet capture
+    bool hasRate = monitor->packetCaptureEnabled();
+    auto health = monitor->tcpHealth();
+
+    QSet<ino_t> wanted;
+    for (auto ino : inodes)
+        wanted.insert(ino);
+
+    SockStatMap statMap;
+    SysInfo::readSockStat(statMap);
+
+    qint64 now = m_clock.elapsed();
+    QSet<ino_t> seen;
+    QList<connection_t> connections;
+    for (auto it = statMap.cbegin(); it != statMap.cend(); ++it) {
+        const SockStat &stat = it.value();
+        // tcp sockets are mapped in both directions
+        if (!wanted.contains(stat->ino) || seen.contains(stat->ino))
+            continue;
+        seen.insert(stat->ino);
+
+        connection_t conn {};
+        conn.ino = stat->ino;
+        conn.proto = stat->proto;
+        conn.localAddr = formatEndpoint(stat->sa_family, &stat->s_addr, stat->s_port);
+        conn.remoteAddr = formatEndpoint(stat->sa_family, &stat->d_addr, stat->d_port);
+        if (health && stat->proto == IPPROTO_TCP) {
+            auto hit = health->constFind(stat->ino);
+            if (hit != health->cend()) {
+                conn.health = hit.value();
+                conn.hasHealth = true;
+            }
+        }
+
+        auto &window = m_history[stat->ino];
+        const auto &total = totals.value(stat->ino);
+        window << io_sample_t {now, total.rx_bytes, total.tx_bytes};
+        while (window.size() > kRollingWindow)
+            window.removeFirst();
+        if (hasRate && window.size() > 1 && window.last().msecs > window.first().msecs) {
+            qreal secs = (window.last().msecs - window.first().msecs) / 1000.;
+            conn.recvBps = (window.last().rx_bytes - window.first().rx_bytes) / secs;
+            conn.sendBps = (window.last().tx_bytes - window.first().tx_bytes) / secs;
+            conn.hasRate = true;
+        }
+        connections << conn;
+    }
+
+    // drop history of closed sockets
+    for (auto it = m_history.begin(); it != m_history.end();) {
+        if (seen.contains(it.key()))
+            ++it;
+        else
+            it = m_history.erase(it);
+    }
+
+    // noisiest connections first
+    std::stable_sort(connections.begin(), connections.end(), [](const connection_t &a, const connection_t &b) {
+        return a.recvBps + a.sendBps > b.recvBps + b.sendBps;
+    });
+
+    beginResetModel();
+    m_connections = connections;
+    endResetModel();
+}
+
+void ProcessConnectionModel::stop()
+{
+    if (m_watching) {
+        NetifMonitor::instance()->setWatchedSockets({});
+        m_watching = false;
+    }
+    m_history.clear();
+}
+
+int ProcessConnectionModel::rowCount(const QModelIndex &) const
+{
+    return m_connections.size();
+}
+
+int ProcessConnectionModel::columnCount(const QModelIndex &) const
+{
+    return kConnectionColumnCount;
+}
+
+QVariant ProcessConnectionModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && (role == Qt::DisplayRole || role == Qt::AccessibleTextRole)) {
+        switch (section) {
+        case kConnectionProtocolColumn:
+            return QApplication::translate("Process.Connection.Header", kConnectionProtocol);
+        case kConnectionLocalAddrColumn:
+            return QApplication::translate("Process.Connection.Header", kConnectionLocalAddr);
+        case kConnectionRemoteAddrColumn:
+            return QApplication::translate("Process.Connection.Header", kConnectionRemoteAddr);
+        case kConnectionDownloadColumn:
+            return QApplication::translate("Process.Connection.Header", kConnectionDownload);
+        case kConnectionUploadColumn:
+            return QApplication::translate("Process.Connection.Header", kConnectionUpload);
+        case kConnectionRttColumn:
+            return QApplication::translate("Process.Connection.Header", kConnectionRtt);
+        case kConnectionRetransColumn:
+            return QApplication::translate("Process.Connection.Header", kConnectionRetrans);
+        case kConnectionCwndColumn:
+            return QApplication::translate("Process.Connection.Header", kConnectionCwnd);
+        case kConnectionUnackedColumn:
+            return QApplication::translate("Process.Connection.Header", kConnectionUnacked);
+        default:
+            break;
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+QVariant ProcessConnectionModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_connections.size())
+        return {};
+
+    const auto &conn = m_connections[index.row()];
+    if (role == Qt::DisplayRole || role == Qt::AccessibleTextRole) {
+        switch (index.column()) {
+        case kConnectionProtocolColumn:
+            return conn.proto == IPPROTO_TCP ? QStringLiteral("TCP") : QStringLiteral("UDP");
+        case kConnectionLocalAddrColumn:
+            return conn.localAddr;
+        case kConnectionRemoteAddrColumn:
+            return conn.remoteAddr;
+        case kConnectionDownloadColumn:
+            return conn.hasRate ? formatUnit_net(8 * conn.recvBps, B, 1, true) : QStringLiteral("-");
+        case kConnectionUploadColumn:
+            return conn.hasRate ? formatUnit_net(8 * conn.sendBps, B, 1, true) : QStringLiteral("-");
+        case kConnectionRttColumn:
+            if (!conn.hasHealth)
+                return QStringLiteral("-");
+            return QString("%1 %2 %3 ms").arg(conn.health.rtt / 1000., 0, 'f', 1).arg(QChar(0x00b1)).arg(conn.health.rttvar / 1000., 0, 'f', 1);
+        case kConnectionRetransColumn:
+            if (!conn.hasHealth)
+                return QStringLiteral("-");
+            // share of all segments sent, unknown before kernel 4.2
+            if (conn.health.segsOut == 0)
+                return QString::number(conn.health.retrans);
+            return QString("%1 (%2%)").arg(conn.health.retrans).arg(100. * conn.health.retrans / conn.health.segsOut, 0, 'f', 1);
+        case kConnectionCwndColumn:
+            return conn.hasHealth ? QString::number(conn.health.cwnd) : QStringLiteral("-");
+        case kConnectionUnackedColumn:
+            return conn.hasHealth ? QString::number(conn.health.unacked) : QStringLiteral("-");
+        default:
+            break;
+        }
+    } else if (role == Qt::UserRole) {
+        switch (index.column()) {
+        case kConnectionDownloadColumn:
+            return conn.recvBps;
+        case kConnectionUploadColumn:
+            return conn.sendBps;
+        case kConnectionRttColumn:
+            return conn.hasHealth ? conn.health.rtt / 1000. : -1.;
+        case kConnectionRetransColumn:
+            return conn.hasHealth ? qlonglong(conn.health.retrans) : -1;
+        case kConnectionCwndColumn:
+            return conn.hasHealth ? qlonglong(conn.health.cwnd) : -1;
+        case kConnectionUnackedColumn:
+            return conn.hasHealth ? qlonglong(conn.health.unacked) : -1;
+        default:
+            return index.data(Qt::DisplayRole);
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return {};
+}
+
+QString ProcessConnectionModel::formatEndpoint(int family, const void *addr, uint port)
+{
+    char buf[INET6_ADDRSTRLEN] {};
+    if (!inet_ntop(family, addr, buf, sizeof(buf)))
+        return {};
+    if (family == AF_INET6)
+        return QString("[%1]:%2").arg(buf).arg(port);
+    return QString("%1:%2").arg(buf).arg(port);
+}
@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_CONNECTION_MODEL_H
+#define PROCESS_CONNECTION_MODEL_H
+
+#include "system/packet.h"
+#include "system/sock_diag.h"
+
+#include <QAbstractTableModel>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+
+// protocol column display
+constexpr const char *kConnectionProtocol = QT_TRANSLATE_NOOP("Process.Connection.Header", "Protocol");
+// local address column display
+constexpr const char *kConnectionLocalAddr = QT_TRANSLATE_NOOP("Process.Connection.Header", "Local address");
+// remote address column display
+constexpr const char *kConnectionRemoteAddr = QT_TRANSLATE_NOOP("Process.Connection.Header", "Remote address");
+// download column display
+constexpr const char *kConnectionDownload = QT_TRANSLATE_NOOP("Process.Connection.Header", "Download");
+// upload column display
+constexpr const char *kConnectionUpload = QT_TRANSLATE_NOOP("Process.Connection.Header", "Upload");
+// round trip time column display
+constexpr const char *kConnectionRtt = QT_TRANSLATE_NOOP("Process.Connection.Header", "RTT");
+// retransmitted segments column display
+constexpr const char *kConnectionRetrans = QT_TRANSLATE_NOOP("Process.Connection.Header", "Retransmits");
+// congestion window column display
+constexpr const char *kConnectionCwnd = QT_TRANSLATE_NOOP("Process.Connection.Header", "Cwnd");
+// unacked segments column display
+constexpr const char *kConnectionUnacked = QT_TRANSLATE_NOOP("Process.Connection.Header", "Unacked");
+
+/**
+ * @brief Live tcp/udp connections of a single process with their rolling throughput
+ *
+ * Nothing is collected until refresh() is called, socket io totals are only kept for the
+ * sockets of this process while the model is watching them, see NetifMonitor::setWatchedSockets.
+ * Tcp health comes from the tcp_info dump of the last process scan, see NetifMonitor::tcpHealth.
+ */
+class ProcessConnectionModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        kConnectionProtocolColumn = 0,
+        kConnectionLocalAddrColumn,
+        kConnectionRemoteAddrColumn,
+        kConnectionDownloadColumn,
+        kConnectionUploadColumn,
+        kConnectionRttColumn,
+        kConnectionRetransColumn,
+        kConnectionCwndColumn,
+        kConnectionUnackedColumn,
+
+        kConnectionColumnCount
+    };
+
+    explicit ProcessConnectionModel(pid_t pid, QObject *parent = nullptr);
+    ~ProcessConnectionModel() override;
+
+    /**
+     * @brief Rescan connections of the process & update throughput
+     */
+    void refresh();
+    /**
+     * @brief Stop watching sockets & drop throughput history
+     */
+    void stop();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // samples kept per connection for throughput
+    static constexpr int kRollingWindow = 5;
+
+    /**
+     * @brief Address & port as text, ipv6 addresses in brackets
+     */
+    static QString formatEndpoint(int family, const void *addr, uint port);
+
+private:
+    struct connection_t {
+        ino_t ino;
+        int proto;
+        QString localAddr;
+        QString remoteAddr;
+        qreal recvBps;
+        qreal sendBps;
+        bool hasRate;
+        bool hasHealth; // tcp connection of the last tcp_info dump
+        tcp_health_t health;
+    };
+    struct io_sample_t {
+        qint64 msecs;
+        qulonglong rx_bytes;
+        qulonglong tx_bytes;
+    };
+
+    pid_t m_pid;
+    QList<connection_t> m_connections {};
+    // rolling io samples by socket inode
+    QHash<ino_t, QList<io_sample_t>> m_history {};
+    QElapsedTimer m_clock;
+    bool m_watching {false};
+};
+
+#endif // PROCESS_CONNECTION_MODEL_H
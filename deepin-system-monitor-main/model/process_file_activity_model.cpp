@@ -0,0 +1,192 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "process_file_activity_model.h"
+#include "ddlog.h"
+#include "common/common.h"
+#include "process/system_service_client.h"
+#include "process_info_record.h"
+
+#include <DConfig>
+
+#include <QApplication>
+#include <QScopedPointer>
+
+#include <algorithm>
+
+#include <string.h>
+
+using namespace DDLog;
+using namespace common::format;
+using namespace core::process;
+
+ProcessFileActivityModel::ProcessFileActivityModel(pid_t pid, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_pid(pid)
+{
+    qCDebug(app) << "ProcessFileActivityModel constructor for pid:" << pid;
+    m_clock.start();
+}
+
+ProcessFileActivityModel::~ProcessFileActivityModel()
+{
+    stop();
+}
+
+void ProcessFileActivityModel::refresh()
+{
+    if (!m_opened) {
+        if (!m_client) {
+            // file events come from DKapture only, follow the process table setting
+            QScopedPointer<DTK_CORE_NAMESPACE::DConfig> config(DTK_CORE_NAMESPACE::DConfig::create("deepin-system-monitor", "org.deepin.system-monitor"));
+            if (!config || !config->value("enable_dkapture", false).toBool()) {
+                qCDebug(app) << "DKapture disabled, no file activity for pid:" << m_pid;
+                m_available = false;
+                return;
+            }
+            m_client = new SystemServiceClient(this);
+        }
+        m_opened = m_client->openFileActivity(m_pid);
+        m_available = m_opened;
+        if (!m_opened)
+            return;
+    }
+
+    QByteArray activity;
+    if (!m_client->getFileActivity(m_pid, activity))
+        return;
+    applyActivity(activity, m_clock.elapsed());
+}
+
+void ProcessFileActivityModel::stop()
+{
+    if (m_opened) {
+        m_client->closeFileActivity(m_pid);
+        m_opened = false;
+    }
+    m_last.clear();
+}
+
+void ProcessFileActivityModel::applyActivity(const QByteArray &activity, qint64 msecs)
+{
+    const file_activity_record_t *records = nullptr;
+    const file_activity_header_t *hdr = fileActivityRecords(activity.constData(), size_t(activity.size()), records);
+    if (!hdr)
+        return;
+    if (hdr->dropped)
+        qCDebug(app) << "File activity of pid" << m_pid << "dropped" << hdr->dropped << "events";
+
+    QHash<quint64, io_sample_t> last;
+    QList<file_activity_t> files;
+    for (uint32_t i = 0; i < hdr->count; ++i) {
+        const file_activity_record_t &rec = records[i];
+        file_activity_t file {};
+        file.ino = rec.ino;
+        file.path = QString::fromLocal8Bit(rec.path, int(strnlen(rec.path, sizeof(rec.path))));
+        file.ops = rec.reads + rec.writes + rec.other_ops;
+
+        auto prev = m_last.constFind(rec.ino);
+        // totals restart when tracing is reopened
+        if (prev != m_last.constEnd() && msecs > prev->msecs
+                && rec.read_bytes >= prev->read_bytes && rec.write_bytes >= prev->write_bytes) {
+            qreal secs = (msecs - prev->msecs) / 1000.;
+            file.readBps = (rec.read_bytes - prev->read_bytes) / secs;
+            file.writeBps = (rec.write_bytes - prev->write_bytes) / secs;
+            file.hasRate = true;
+        }
+        last.insert(rec.ino, {msecs, rec.read_bytes, rec.write_bytes});
+        // keep the path of files closed since they were first seen
+        if (file.path.isEmpty()) {
+            for (const auto &known : m_files) {
+                if (known.ino == file.ino) {
+                    file.path = known.path;
+                    break;
+                }
+            }
+        }
+        files << file;
+    }
+    m_last = last;
+
+    // busiest files right now first, the server sorts by totals
+    std::stable_sort(files.begin(), files.end(), [](const file_activity_t &a, const file_activity_t &b) {
+        return a.readBps + a.writeBps > b.readBps + b.writeBps;
+    });
+
+    beginResetModel();
+    m_files = files;
+    endResetModel();
+}
+
+int ProcessFileActivityModel::rowCount(const QModelIndex &) const
+{
+    return m_files.size();
+}
+
+int ProcessFileActivityModel::columnCount(const QModelIndex &) const
+{
+    return kFileActivityColumnCount;
+}
+
+QVariant ProcessFileActivityModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && (role == Qt::DisplayRole || role == Qt::AccessibleTextRole)) {
+        switch (section) {
+        case kFileActivityFileColumn:
+            return QApplication::translate("Process.FileActivity.Header", kFileActivityFile);
+        case kFileActivityReadColumn:
+            return QApplication::translate("Process.FileActivity.Header", kFileActivityRead);
+        case kFileActivityWriteColumn:
+            return QApplication::translate("Process.FileActivity.Header", kFileActivityWrite);
+        case kFileActivityOpsColumn:
+            return QApplication::translate("Process.FileActivity.Header", kFileActivityOps);
+        default:
+            break;
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+QVariant ProcessFileActivityModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_files.size())
+        return {};
+
+    const auto &file = m_files[index.row()];
+    if (role == Qt::DisplayRole || role == Qt::AccessibleTextRole) {
+        switch (index.column()) {
+        case kFileActivityFileColumn:
+            // file closed before its path could be resolved
+            if (file.path.isEmpty())
+                return QApplication::translate("Process.FileActivity", "inode %1").arg(file.ino);
+            return file.path;
+        case kFileActivityReadColumn:
+            return file.hasRate ? formatUnit_memory_disk(file.readBps, B, 1, true) : QStringLiteral("-");
+        case kFileActivityWriteColumn:
+            return file.hasRate ? formatUnit_memory_disk(file.writeBps, B, 1, true) : QStringLiteral("-");
+        case kFileActivityOpsColumn:
+            return QString::number(file.ops);
+        default:
+            break;
+        }
+    } else if (role == Qt::ToolTipRole && index.column() == kFileActivityFileColumn) {
+        return file.path;
+    } else if (role == Qt::UserRole) {
+        switch (index.column()) {
+        case kFileActivityReadColumn:
+            return file.readBps;
+        case kFileActivityWriteColumn:
+            return file.writeBps;
+        case kFileActivityOpsColumn:
+            return file.ops;
+        default:
+            return index.data(Qt::DisplayRole);
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return {};
+}
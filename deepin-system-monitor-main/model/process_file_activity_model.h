@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_FILE_ACTIVITY_MODEL_H
+#define PROCESS_FILE_ACTIVITY_MODEL_H
+
+#include <QAbstractTableModel>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+
+namespace core {
+namespace process {
+class SystemServiceClient;
+}
+}
+
+// file column display
+constexpr const char *kFileActivityFile = QT_TRANSLATE_NOOP("Process.FileActivity.Header", "File");
+// read column display
+constexpr const char *kFileActivityRead = QT_TRANSLATE_NOOP("Process.FileActivity.Header", "Disk read");
+// write column display
+constexpr const char *kFileActivityWrite = QT_TRANSLATE_NOOP("Process.FileActivity.Header", "Disk write");
+// operations column display
+constexpr const char *kFileActivityOps = QT_TRANSLATE_NOOP("Process.FileActivity.Header", "Operations");
+
+/**
+ * @brief Busiest files of a single process with their read & write throughput
+ *
+ * File events are traced in the kernel by DKapture & aggregated by the system server, nothing is
+ * traced until refresh() is called & tracing stops with stop(). Without the DKapture system
+ * service the model stays empty, see isAvailable().
+ */
+class ProcessFileActivityModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        kFileActivityFileColumn = 0,
+        kFileActivityReadColumn,
+        kFileActivityWriteColumn,
+        kFileActivityOpsColumn,
+
+        kFileActivityColumnCount
+    };
+
+    explicit ProcessFileActivityModel(pid_t pid, QObject *parent = nullptr);
+    ~ProcessFileActivityModel() override;
+
+    /**
+     * @brief Start tracing if needed & update the busiest files
+     */
+    void refresh();
+    /**
+     * @brief Stop tracing & drop throughput history
+     */
+    void stop();
+
+    /**
+     * @brief false once tracing could not be started, DKapture disabled or the system service unusable
+     */
+    inline bool isAvailable() const { return m_available; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    struct file_activity_t {
+        quint64 ino;
+        QString path;
+        qreal readBps;
+        qreal writeBps;
+        quint64 ops;
+        bool hasRate;
+    };
+    struct io_sample_t {
+        qint64 msecs;
+        quint64 read_bytes;
+        quint64 write_bytes;
+    };
+
+    /**
+     * @brief Update rows from a getFileActivity buffer sampled at \a msecs
+     */
+    void applyActivity(const QByteArray &activity, qint64 msecs);
+
+    pid_t m_pid;
+    core::process::SystemServiceClient *m_client {};
+    bool m_opened {false};
+    bool m_available {true};
+    QList<file_activity_t> m_files {};
+    // last io totals by inode
+    QHash<quint64, io_sample_t> m_last {};
+    QElapsedTimer m_clock;
+};
+
+#endif // PROCESS_FILE_ACTIVITY_MODEL_H
@@ -0,0 +1,234 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "process_memleak_model.h"
+#include "ddlog.h"
+#include "common/common.h"
+#include "process/system_service_client.h"
+#include "process_info_record.h"
+
+#include <DConfig>
+
+#include <QApplication>
+#include <QScopedPointer>
+
+#include <string.h>
+
+using namespace DDLog;
+using namespace common::format;
+using namespace core::process;
+
+// scan window of the system server (ms), each window reports what it left allocated
+static const int kMemleakScanWindow = 5000;
+
+// innermost frame of a stack which is not part of the kernel allocators
+static QString allocationCaller(const QStringList &frames)
+{
+    static const char *const allocators[] = {
+        "__alloc_pages", "alloc_pages", "__get_free_pages", "__kmalloc", "kmalloc", "__kmem_cache",
+        "kmem_cache_alloc", "kvmalloc", "__vmalloc", "vmalloc", "slab_", "___slab", "__slab",
+        "kmemdup", "kstrdup", "krealloc",
+    };
+    for (const QString &frame : frames) {
+        bool allocator = false;
+        for (const char *prefix : allocators) {
+            if (frame.startsWith(QLatin1String(prefix))) {
+                allocator = true;
+                break;
+            }
+        }
+        if (!allocator)
+            return frame;
+    }
+    return frames.isEmpty() ? QString() : frames.first();
+}
+
+ProcessMemleakModel::ProcessMemleakModel(pid_t pid, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_pid(pid)
+{
+    qCDebug(app) << "ProcessMemleakModel constructor for pid:" << pid;
+}
+
+ProcessMemleakModel::~ProcessMemleakModel()
+{
+    cancel();
+}
+
+bool ProcessMemleakModel::start()
+{
+    if (!m_client) {
+        // kmemleak scans come from DKapture only, follow the process table setting
+        QScopedPointer<DTK_CORE_NAMESPACE::DConfig> config(DTK_CORE_NAMESPACE::DConfig::create("deepin-system-monitor", "org.deepin.system-monitor"));
+        if (!config || !config->value("enable_dkapture", false).toBool()) {
+            qCDebug(app) << "DKapture disabled, no memleak scan for pid:" << m_pid;
+            m_available = false;
+            return false;
+        }
+        m_client = new SystemServiceClient(this);
+    }
+
+    if (!m_client->startMemleakScan(m_pid, kMemleakScanWindow)) {
+        qCWarning(app) << "Memleak scan of pid" << m_pid << "could not be started";
+        setState(kScanFailed);
+        return false;
+    }
+
+    beginResetModel();
+    m_sites.clear();
+    endResetModel();
+    m_generation = 0;
+    m_windows = 0;
+    m_bytes = 0;
+    setState(kScanRunning);
+    return true;
+}
+
+void ProcessMemleakModel::refresh()
+{
+    if (!m_client)
+        return;
+
+    QByteArray scan;
+    if (!m_client->getMemleakScan(scan))
+        return;
+    applyScan(scan);
+}
+
+void ProcessMemleakModel::cancel()
+{
+    if (m_state != kScanRunning)
+        return;
+    m_client->stopMemleakScan();
+    // the server ends the current window in the background, final state comes with refresh()
+}
+
+void ProcessMemleakModel::applyScan(const QByteArray &scan)
+{
+    const memleak_site_record_t *records = nullptr;
+    const memleak_scan_header_t *hdr = memleakScanRecords(scan.constData(), size_t(scan.size()), records);
+    if (!hdr)
+        return;
+
+    ScanState state = kScanRunning;
+    switch (hdr->state) {
+    case MEMLEAK_SCAN_FINISHED:
+        state = kScanFinished;
+        break;
+    case MEMLEAK_SCAN_CANCELLED:
+        state = kScanCancelled;
+        break;
+    case MEMLEAK_SCAN_FAILED:
+        state = kScanFailed;
+        break;
+    default:
+        break;
+    }
+
+    // sites only change when a window completes
+    if (hdr->generation != m_generation || m_sites.size() != int(hdr->count)) {
+        QList<leak_site_t> sites;
+        for (uint32_t i = 0; i < hdr->count; ++i) {
+            const memleak_site_record_t &rec = records[i];
+            const QString stack = QString::fromLatin1(rec.stack, int(strnlen(rec.stack, sizeof(rec.stack))));
+            leak_site_t site {};
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+            site.caller = allocationCaller(stack.split('\n', QString::SkipEmptyParts));
+#else
+            site.caller = allocationCaller(stack.split('\n', Qt::SkipEmptyParts));
+#endif
+            site.stack = stack.trimmed();
+            site.bytes = rec.bytes;
+            site.allocations = rec.allocations;
+            site.windows = rec.windows;
+            sites << site;
+        }
+
+        beginResetModel();
+        m_sites = sites;
+        endResetModel();
+        m_generation = hdr->generation;
+    }
+    m_windows = hdr->windows;
+    m_bytes = hdr->bytes;
+    setState(state);
+}
+
+void ProcessMemleakModel::setState(ScanState state)
+{
+    if (m_state == state)
+        return;
+    m_state = state;
+    emit stateChanged(state);
+}
+
+int ProcessMemleakModel::rowCount(const QModelIndex &) const
+{
+    return m_sites.size();
+}
+
+int ProcessMemleakModel::columnCount(const QModelIndex &) const
+{
+    return kMemleakColumnCount;
+}
+
+QVariant ProcessMemleakModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && (role == Qt::DisplayRole || role == Qt::AccessibleTextRole)) {
+        switch (section) {
+        case kMemleakSiteColumn:
+            return QApplication::translate("Process.Memleak.Header", kMemleakSite);
+        case kMemleakSizeColumn:
+            return QApplication::translate("Process.Memleak.Header", kMemleakSize);
+        case kMemleakAllocationsColumn:
+            return QApplication::translate("Process.Memleak.Header", kMemleakAllocations);
+        case kMemleakWindowsColumn:
+            return QApplication::translate("Process.Memleak.Header", kMemleakWindows);
+        default:
+            break;
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+QVariant ProcessMemleakModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_sites.size())
+        return {};
+
+    const auto &site = m_sites[index.row()];
+    if (role == Qt::DisplayRole || role == Qt::AccessibleTextRole) {
+        switch (index.column()) {
+        case kMemleakSiteColumn:
+            return site.caller;
+        case kMemleakSizeColumn:
+            return formatUnit_memory_disk(site.bytes, B);
+        case kMemleakAllocationsColumn:
+            return QString::number(site.allocations);
+        case kMemleakWindowsColumn:
+            return QString("%1/%2").arg(site.windows).arg(m_windows);
+        default:
+            break;
+        }
+    } else if (role == Qt::ToolTipRole && index.column() == kMemleakSiteColumn) {
+        // whole allocation stack
+        return site.stack;
+    } else if (role == Qt::UserRole) {
+        switch (index.column()) {
+        case kMemleakSizeColumn:
+            return site.bytes;
+        case kMemleakAllocationsColumn:
+            return site.allocations;
+        case kMemleakWindowsColumn:
+            return site.windows;
+        default:
+            return index.data(Qt::DisplayRole);
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return {};
+}
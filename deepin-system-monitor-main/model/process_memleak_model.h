@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_MEMLEAK_MODEL_H
+#define PROCESS_MEMLEAK_MODEL_H
+
+#include <QAbstractTableModel>
+#include <QByteArray>
+#include <QList>
+
+namespace core {
+namespace process {
+class SystemServiceClient;
+}
+}
+
+// leak site column display
+constexpr const char *kMemleakSite = QT_TRANSLATE_NOOP("Process.Memleak.Header", "Allocated from");
+// leaked size column display
+constexpr const char *kMemleakSize = QT_TRANSLATE_NOOP("Process.Memleak.Header", "Not freed");
+// allocations column display
+constexpr const char *kMemleakAllocations = QT_TRANSLATE_NOOP("Process.Memleak.Header", "Allocations");
+// windows column display
+constexpr const char *kMemleakWindows = QT_TRANSLATE_NOOP("Process.Memleak.Header", "Windows");
+
+/**
+ * @brief Kernel allocation stacks of a process whose memory is not freed, largest first
+ *
+ * The system server scans in the background through DKapture kmemleak in windows of a few
+ * seconds & sums what each window left allocated, refresh() picks up the results found so far
+ * without waiting for the scan to end. Sites leaking in most windows are the likely leaks.
+ * Without the DKapture system service nothing can be scanned, see isAvailable().
+ */
+class ProcessMemleakModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        kMemleakSiteColumn = 0,
+        kMemleakSizeColumn,
+        kMemleakAllocationsColumn,
+        kMemleakWindowsColumn,
+
+        kMemleakColumnCount
+    };
+
+    enum ScanState {
+        kScanIdle = 0,
+        kScanRunning,
+        kScanFinished,
+        kScanCancelled,
+        kScanFailed
+    };
+
+    explicit ProcessMemleakModel(pid_t pid, QObject *parent = nullptr);
+    ~ProcessMemleakModel() override;
+
+    /**
+     * @brief Start a scan, results of the previous one are dropped
+     * @return false if DKapture is disabled, the system service unusable or busy with another scan
+     */
+    bool start();
+    /**
+     * @brief Update leak sites while a scan is running
+     */
+    void refresh();
+    /**
+     * @brief Cancel the running scan, sites found so far are kept
+     */
+    void cancel();
+
+    /**
+     * @brief false once a scan could not be started, DKapture disabled or the system service unusable
+     */
+    inline bool isAvailable() const { return m_available; }
+    inline ScanState state() const { return m_state; }
+    // windows completed & bytes not freed of all sites so far
+    inline quint32 windows() const { return m_windows; }
+    inline quint64 leakedBytes() const { return m_bytes; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+signals:
+    void stateChanged(ProcessMemleakModel::ScanState state);
+
+private:
+    struct leak_site_t {
+        QString caller; // innermost frame outside of the allocators
+        QString stack;
+        quint64 bytes;
+        quint64 allocations;
+        quint32 windows;
+    };
+
+    /**
+     * @brief Update rows & state from a getMemleakScan buffer
+     */
+    void applyScan(const QByteArray &scan);
+    void setState(ScanState state);
+
+    pid_t m_pid;
+    core::process::SystemServiceClient *m_client {};
+    bool m_available {true};
+    ScanState m_state {kScanIdle};
+    QList<leak_site_t> m_sites {};
+    quint64 m_generation {0};
+    quint32 m_windows {0};
+    quint64 m_bytes {0};
+};
+
+#endif // PROCESS_MEMLEAK_MODEL_H
@@ -0,0 +1,278 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "process_memory_map_model.h"
+#include "ddlog.h"
+#include "common/common.h"
+#include "common/task_executor.h"
+
+#include <QApplication>
+#include <QMutex>
+
+#include <algorithm>
+#include <atomic>
+
+using namespace DDLog;
+using namespace common::core;
+using namespace common::format;
+using namespace core::process;
+
+// mappings per batch, smaps has a dozen lines per mapping & walks its page tables
+static const int kMapsBatch = 4096;
+static const int kSmapsBatch = 256;
+
+struct ProcessMemoryMapModel::scan_t {
+    QMutex mutex;
+    QList<MemoryMaps::RegionList> batches;
+    int mappings {0};
+    bool done {false};
+    int error {0};
+    std::atomic<bool> cancelled {false};
+};
+
+ProcessMemoryMapModel::ProcessMemoryMapModel(pid_t pid, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_pid(pid)
+{
+    qCDebug(app) << "ProcessMemoryMapModel constructor for pid:" << pid;
+}
+
+ProcessMemoryMapModel::~ProcessMemoryMapModel()
+{
+    if (m_scan)
+        m_scan->cancelled = true;
+}
+
+void ProcessMemoryMapModel::start(bool detailed)
+{
+    qCDebug(app) << "Reading memory map of" << m_pid << "detailed:" << detailed;
+    cancel();
+    beginResetModel();
+    m_regions.clear();
+    m_rows.clear();
+    endResetModel();
+    m_state = kScanRunning;
+    m_detailed = detailed;
+    m_error = 0;
+    m_mappings = 0;
+    m_totalSize = m_totalRss = m_totalPss = 0;
+
+    // the thread only shares the scan, the model may be gone before it ends
+    const pid_t pid = m_pid;
+    auto scan = std::make_shared<scan_t>();
+    m_scan = scan;
+    TaskExecutor::instance()->run(TaskExecutor::kBackgroundTask, [pid, detailed, scan]() {
+        MemoryMaps maps(pid, detailed);
+        bool more = maps.open();
+        while (more && !scan->cancelled) {
+            MemoryMaps::RegionList regions;
+            const int before = maps.mappings();
+            more = maps.next(regions, detailed ? kSmapsBatch : kMapsBatch);
+            QMutexLocker locker(&scan->mutex);
+            scan->batches << regions;
+            scan->mappings += maps.mappings() - before;
+        }
+        QMutexLocker locker(&scan->mutex);
+        scan->done = true;
+        scan->error = maps.error();
+    });
+    Q_EMIT progressed();
+}
+
+void ProcessMemoryMapModel::refresh()
+{
+    if (!m_scan)
+        return;
+
+    QList<MemoryMaps::RegionList> batches;
+    bool done;
+    int error;
+    {
+        QMutexLocker locker(&m_scan->mutex);
+        batches.swap(m_scan->batches);
+        m_mappings += m_scan->mappings;
+        m_scan->mappings = 0;
+        done = m_scan->done;
+        error = m_scan->error;
+    }
+    merge(batches);
+    if (done)
+        finish(error);
+    else
+        Q_EMIT progressed();
+}
+
+void ProcessMemoryMapModel::cancel()
+{
+    if (!m_scan)
+        return;
+
+    // batches still queued are dropped, the rows read so far stay
+    m_scan->cancelled = true;
+    finish(0);
+}
+
+void ProcessMemoryMapModel::merge(const QList<MemoryMaps::RegionList> &batches)
+{
+    int firstChanged = m_regions.size();
+    int lastChanged = -1;
+    QList<MemoryMaps::region_t> added;
+    for (const MemoryMaps::RegionList &regions : batches) {
+        for (const MemoryMaps::region_t &region : regions) {
+            m_totalSize += region.size;
+            m_totalRss += region.rss;
+            m_totalPss += region.pss;
+
+            const QString key = MemoryMaps::regionKey(region);
+            auto it = m_rows.constFind(key);
+            if (it == m_rows.constEnd()) {
+                m_rows.insert(key, m_regions.size() + added.size());
+                added << region;
+                continue;
+            }
+
+            // regions of the earlier batches are rows already, the ones of this call not yet
+            const int row = it.value();
+            MemoryMaps::region_t &dest = row < m_regions.size() ? m_regions[row] : added[row - m_regions.size()];
+            dest.mappings += region.mappings;
+            dest.size += region.size;
+            dest.rss += region.rss;
+            dest.pss += region.pss;
+            if (row < m_regions.size()) {
+                firstChanged = qMin(firstChanged, row);
+                lastChanged = qMax(lastChanged, row);
+            }
+        }
+    }
+
+    if (lastChanged >= 0)
+        Q_EMIT dataChanged(index(firstChanged, kMemoryMapMappingsColumn), index(lastChanged, kMemoryMapPssColumn));
+    if (!added.isEmpty()) {
+        beginInsertRows({}, m_regions.size(), m_regions.size() + added.size() - 1);
+        m_regions << added;
+        endInsertRows();
+    }
+}
+
+void ProcessMemoryMapModel::finish(int error)
+{
+    qCDebug(app) << "Memory map of" << m_pid << "read," << m_mappings << "mappings in" << m_regions.size()
+                 << "regions, error:" << error;
+    m_scan.reset();
+    m_error = error;
+    m_state = error ? kScanFailed : kScanFinished;
+
+    // largest first, rows came in the order of their first mapping
+    beginResetModel();
+    std::stable_sort(m_regions.begin(), m_regions.end(), [](const MemoryMaps::region_t &a, const MemoryMaps::region_t &b) {
+        return a.size > b.size;
+    });
+    m_rows.clear();
+    for (int row = 0; row < m_regions.size(); ++row)
+        m_rows.insert(MemoryMaps::regionKey(m_regions[row]), row);
+    endResetModel();
+    Q_EMIT progressed();
+}
+
+QString ProcessMemoryMapModel::typeName(int type)
+{
+    switch (type) {
+    case MemoryMaps::kRegionFile:
+        return QApplication::translate("Process.MemoryMap", "File");
+    case MemoryMaps::kRegionAnon:
+        return QApplication::translate("Process.MemoryMap", "Anonymous");
+    case MemoryMaps::kRegionHeap:
+        return QApplication::translate("Process.MemoryMap", "Heap");
+    case MemoryMaps::kRegionStack:
+        return QApplication::translate("Process.MemoryMap", "Stack");
+    case MemoryMaps::kRegionShm:
+        return QApplication::translate("Process.MemoryMap", "Shared memory");
+    case MemoryMaps::kRegionKernel:
+        return QApplication::translate("Process.MemoryMap", "Kernel");
+    default:
+        return {};
+    }
+}
+
+int ProcessMemoryMapModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_regions.size();
+}
+
+int ProcessMemoryMapModel::columnCount(const QModelIndex &) const
+{
+    return kMemoryMapColumnCount;
+}
+
+QVariant ProcessMemoryMapModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && (role == Qt::DisplayRole || role == Qt::AccessibleTextRole)) {
+        switch (section) {
+        case kMemoryMapRegionColumn:
+            return QApplication::translate("Process.MemoryMap.Header", kMemoryMapRegion);
+        case kMemoryMapTypeColumn:
+            return QApplication::translate("Process.MemoryMap.Header", kMemoryMapType);
+        case kMemoryMapMappingsColumn:
+            return QApplication::translate("Process.MemoryMap.Header", kMemoryMapMappings);
+        case kMemoryMapSizeColumn:
+            return QApplication::translate("Process.MemoryMap.Header", kMemoryMapSize);
+        case kMemoryMapRssColumn:
+            return QApplication::translate("Process.MemoryMap.Header", kMemoryMapRss);
+        case kMemoryMapPssColumn:
+            return QApplication::translate("Process.MemoryMap.Header", kMemoryMapPss);
+        default:
+            break;
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+QVariant ProcessMemoryMapModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_regions.size())
+        return {};
+
+    const auto &region = m_regions[index.row()];
+    if (role == Qt::DisplayRole || role == Qt::AccessibleTextRole) {
+        switch (index.column()) {
+        case kMemoryMapRegionColumn:
+            return region.name.isEmpty() ? typeName(region.type) : region.name;
+        case kMemoryMapTypeColumn:
+            return typeName(region.type);
+        case kMemoryMapMappingsColumn:
+            return region.mappings;
+        case kMemoryMapSizeColumn:
+            return formatUnit_memory_disk(region.size, KB);
+        case kMemoryMapRssColumn:
+            // maps has no page counts, only smaps
+            return m_detailed ? formatUnit_memory_disk(region.rss, KB) : QStringLiteral("-");
+        case kMemoryMapPssColumn:
+            return m_detailed ? formatUnit_memory_disk(region.pss, KB) : QStringLiteral("-");
+        default:
+            break;
+        }
+    } else if (role == Qt::ToolTipRole && index.column() == kMemoryMapRegionColumn) {
+        return region.name;
+    } else if (role == Qt::UserRole) {
+        switch (index.column()) {
+        case kMemoryMapMappingsColumn:
+            return region.mappings;
+        case kMemoryMapSizeColumn:
+            return region.size;
+        case kMemoryMapRssColumn:
+            return m_detailed ? qlonglong(region.rss) : -1;
+        case kMemoryMapPssColumn:
+            return m_detailed ? qlonglong(region.pss) : -1;
+        default:
+            return index.data(Qt::DisplayRole);
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return {};
+}
@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_MEMORY_MAP_MODEL_H
+#define PROCESS_MEMORY_MAP_MODEL_H
+
+#include "process/memory_maps.h"
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QList>
+
+#include <memory>
+
+// region column display
+constexpr const char *kMemoryMapRegion = QT_TRANSLATE_NOOP("Process.MemoryMap.Header", "Region");
+// type column display
+constexpr const char *kMemoryMapType = QT_TRANSLATE_NOOP("Process.MemoryMap.Header", "Type");
+// mappings column display
+constexpr const char *kMemoryMapMappings = QT_TRANSLATE_NOOP("Process.MemoryMap.Header", "Mappings");
+// virtual size column display
+constexpr const char *kMemoryMapSize = QT_TRANSLATE_NOOP("Process.MemoryMap.Header", "Virtual");
+// resident column display
+constexpr const char *kMemoryMapRss = QT_TRANSLATE_NOOP("Process.MemoryMap.Header", "RSS");
+// proportional column display
+constexpr const char *kMemoryMapPss = QT_TRANSLATE_NOOP("Process.MemoryMap.Header", "PSS");
+
+/**
+ * @brief Memory map of a single process, mappings added up by backing file & type
+ *
+ * maps, or smaps for the rss & pss, is streamed on a background thread & its regions queued
+ * in batches refresh() picks up, so rows come in while a process with many mappings is still
+ * being read & the gui never waits for it. Rows are ordered by virtual size once the scan ends.
+ */
+class ProcessMemoryMapModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        kMemoryMapRegionColumn = 0,
+        kMemoryMapTypeColumn,
+        kMemoryMapMappingsColumn,
+        kMemoryMapSizeColumn,
+        kMemoryMapRssColumn,
+        kMemoryMapPssColumn,
+
+        kMemoryMapColumnCount
+    };
+
+    enum ScanState {
+        kScanIdle = 0,
+        kScanRunning,
+        kScanFinished,
+        kScanFailed
+    };
+
+    explicit ProcessMemoryMapModel(pid_t pid, QObject *parent = nullptr);
+    ~ProcessMemoryMapModel() override;
+
+    /**
+     * @brief Read the memory map again, rows of the previous scan are dropped
+     * @param detailed Read smaps for the rss & pss, a page table walk of each mapping
+     */
+    void start(bool detailed);
+    /**
+     * @brief Add the batches read since the last call to the rows
+     */
+    void refresh();
+    /**
+     * @brief Stop the running scan, rows read so far are kept
+     */
+    void cancel();
+
+    inline ScanState state() const { return m_state; }
+    // whether the last scan read smaps
+    inline bool isDetailed() const { return m_detailed; }
+    // errno of the failed scan, EACCES for processes of other users
+    inline int error() const { return m_error; }
+    // mappings & totals of all rows, kB
+    inline int mappings() const { return m_mappings; }
+    inline qulonglong totalSize() const { return m_totalSize; }
+    inline qulonglong totalRss() const { return m_totalRss; }
+    inline qulonglong totalPss() const { return m_totalPss; }
+
+    /**
+     * @brief Localized name of a MemoryMaps::RegionType
+     */
+    static QString typeName(int type);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+signals:
+    /**
+     * @brief Rows were added or grew, or the scan ended
+     */
+    void progressed();
+
+private:
+    // batches the scan thread queued, shared with it until the scan ends
+    struct scan_t;
+
+    /**
+     * @brief Add the regions of the batches to the rows
+     */
+    void merge(const QList<core::process::MemoryMaps::RegionList> &batches);
+    void finish(int error);
+
+    pid_t m_pid;
+    QList<core::process::MemoryMaps::region_t> m_regions {};
+    // row of each region by type & name
+    QHash<QString, int> m_rows {};
+    ScanState m_state {kScanIdle};
+    bool m_detailed {false};
+    int m_error {0};
+    int m_mappings {0};
+    qulonglong m_totalSize {0};
+    qulonglong m_totalRss {0};
+    qulonglong m_totalPss {0};
+    // running scan, dropped on cancel so nothing more of it is merged
+    std::shared_ptr<scan_t> m_scan;
+};
+
+#endif // PROCESS_MEMORY_MAP_MODEL_H
@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "process_row_preparer.h"
+#include "ddlog.h"
+#include "process/process_db.h"
+
+using namespace DDLog;
+using namespace core::process;
+using namespace common::cgroup;
+
+ProcessRowPreparer::ProcessRowPreparer(QObject *parent)
+    : QObject(parent)
+{
+    qCDebug(app) << "ProcessRowPreparer constructor";
+    if (CgroupStats::isAvailable())
+        m_sliceStats.reset(new CgroupStats());
+    ProcessDB *processDB = ProcessDB::instance();
+    // emitted on the monitor thread right after the scan, the process set is stable until the next one
+    connect(processDB, &ProcessDB::processListUpdated, this, &ProcessRowPreparer::prepare, Qt::DirectConnection);
+    // the first scan may already be done, prepare its rows on the monitor thread as well
+    QMetaObject::invokeMethod(processDB, [this]() { prepare(); }, Qt::QueuedConnection);
+}
+
+void ProcessRowPreparer::prepare()
+{
+    ProcessSet *processSet = ProcessDB::instance()->processSet();
+    // published processes are never written again, the rows share them
+    const ProcessSnapshotPtr snapshot = processSet->snapshot();
+    QList<Process> procs;
+    procs.reserve(snapshot->processes.size());
+    for (const Process &proc : snapshot->processes) {
+        // 只处理有效进程
+        if (proc.isValid())
+            procs << proc;
+    }
+
+    auto table = ProcessTableModel::makeRowTable(procs, processSet->netTrafficSampled(), m_nameRanks, m_userRanks,
+                                                 m_sliceStats.get(), snapshot->tree);
+    qCDebug(app) << "Prepared" << table->rows.size() << "process rows";
+    QMetaObject::invokeMethod(this, [this, table]() {
+        if (m_replaying)
+            return;
+        m_rowTable = table;
+        Q_EMIT rowTableUpdated();
+    }, Qt::QueuedConnection);
+}
+
+void ProcessRowPreparer::setReplayTable(const std::shared_ptr<const ProcessTableModel::RowTable> &table)
+{
+    m_replaying = bool(table);
+    if (!table)
+        return;
+    m_rowTable = table;
+    Q_EMIT rowTableUpdated();
+}
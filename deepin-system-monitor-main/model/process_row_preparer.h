@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_ROW_PREPARER_H
+#define PROCESS_ROW_PREPARER_H
+
+#include "process_table_model.h"
+
+#include <QHash>
+#include <QObject>
+
+#include <memory>
+
+/**
+ * @brief Prepares process table rows on the monitor thread after every process scan
+ *
+ * Processes are copied out of the process set while it's not being scanned, texts, sort keys, per user
+ * rows & per user usage are made there too, user slices are sampled there as well. The table is handed
+ * to the GUI thread in one queued call and never written again, so the models only apply the diff and
+ * never read the process set the monitor thread writes.
+ */
+class ProcessRowPreparer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProcessRowPreparer(QObject *parent = nullptr);
+
+    /**
+     * @brief Rows of the last scan, null before the first one; GUI thread only
+     */
+    inline std::shared_ptr<const ProcessTableModel::RowTable> rowTable() const { return m_rowTable; }
+    /**
+     * @brief Publish rows of a replayed recording, rows of scans are dropped until it's reset; GUI thread only
+     * @param table Rows to publish, null to follow the scans again from the next one
+     */
+    void setReplayTable(const std::shared_ptr<const ProcessTableModel::RowTable> &table);
+
+Q_SIGNALS:
+    /**
+     * @brief Rows of a new scan were published
+     */
+    void rowTableUpdated();
+
+private:
+    /**
+     * @brief Build the rows of the current process set, runs on the monitor thread
+     */
+    void prepare();
+
+    // collation ranks of the previous build & slice samples, monitor thread only
+    QHash<QString, int> m_nameRanks;
+    QHash<QString, int> m_userRanks;
+    std::unique_ptr<common::cgroup::CgroupStats> m_sliceStats; // null without the unified cgroup hierarchy
+    std::shared_ptr<const ProcessTableModel::RowTable> m_rowTable;
+    bool m_replaying {false};
+};
+
+#endif // PROCESS_ROW_PREPARER_H
@@ -10,17 +10,25 @@
 #include "common/han_latin.h"
 #include "common/common.h"
 
-#include <QCollator>
 #include <QDebug>
 #include <QLocale>
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
 // proxy model constructor
 ProcessSortFilterProxyModel::ProcessSortFilterProxyModel(QObject *parent)
-    : QSortFilterProxyModel(parent)
+    : QAbstractProxyModel(parent)
 {
     qCDebug(app) << "ProcessSortFilterProxyModel created";
 }
 
+ProcessSortFilterProxyModel::~ProcessSortFilterProxyModel()
+{
+    clearMappings();
+}
+
 // set search pattern
 void ProcessSortFilterProxyModel::setSortFilterString(const QString &search)
 {
@@ -28,72 +36,196 @@ void ProcessSortFilterProxyModel::setSortFilterString(const QString &search)
     m_search = search;
 
     // in chinese locale, we convert hanzi to pinyin words to help filter out processes named with pinyin
+    m_hanwordsLower.clear();
     if (QLocale::system().language() == QLocale::Chinese) {
         qCDebug(app) << "Chinese locale, converting Hanzi to Latin";
         m_hanwords = util::common::convHanToLatin(search);
+        // pinyin in the search index has no syllable spaces
+        m_hanwordsLower = m_hanwords.toLower().remove(QLatin1Char(' '));
     }
 
+    // patterns without regex syntax are matched as substrings of the source model's search index
+    static const QString kRegexSyntax = QStringLiteral("\\^$.|?*+()[]{}");
+    m_plainSearch = std::none_of(search.cbegin(), search.cend(), [](const QChar &ch) {
+        return kRegexSyntax.contains(ch);
+    });
+    m_searchLower = search.toLower();
+
     // set search pattern & do the filter
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    setFilterRegExp(QRegExp(search, Qt::CaseInsensitive));
-#else
-    setFilterRegularExpression(QRegularExpression(search, QRegularExpression::CaseInsensitiveOption));
-#endif
+    m_filter = QRegularExpression(search, QRegularExpression::CaseInsensitiveOption);
+    if (sourceModel())
+        rebuild();
 }
 
 void ProcessSortFilterProxyModel::setFilterType(int type)
 {
     qCDebug(app) << "Set filter type:" << type;
     m_fileterType = type;
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    setFilterRegExp(filterRegExp());
-#else
-    setFilterRegularExpression(filterRegularExpression());
-#endif
+    if (sourceModel())
+        rebuild();
+}
+
+void ProcessSortFilterProxyModel::setRecursiveFilteringEnabled(bool enabled)
+{
+    if (m_recursive == enabled)
+        return;
+    m_recursive = enabled;
+    if (sourceModel())
+        rebuild();
+}
+
+int ProcessSortFilterProxyModel::sortColumn() const
+{
+    return m_sortColumn;
+}
+
+void ProcessSortFilterProxyModel::sort(int column, Qt::SortOrder order)
+{
+    if (column == m_sortColumn && order == m_sortOrder)
+        return;
+    qCDebug(app) << "Sort by column" << column << "order" << order;
+    m_sortColumn = column;
+    m_sortOrder = order;
+    if (sourceModel())
+        rebuild();
+}
+
+void ProcessSortFilterProxyModel::setSourceModel(QAbstractItemModel *model)
+{
+    beginResetModel();
+    if (sourceModel())
+        disconnect(sourceModel(), nullptr, this, nullptr);
+    clearMappings();
+    QAbstractProxyModel::setSourceModel(model);
+    m_processModel = qobject_cast<ProcessTableModel *>(model);
+
+    if (model) {
+        connect(model, &QAbstractItemModel::dataChanged, this, &ProcessSortFilterProxyModel::sourceDataChanged);
+        connect(model, &QAbstractItemModel::headerDataChanged, this, &ProcessSortFilterProxyModel::headerDataChanged);
+        connect(model, &QAbstractItemModel::rowsInserted, this, &ProcessSortFilterProxyModel::sourceRowsInserted);
+        connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, this,
+                &ProcessSortFilterProxyModel::sourceRowsAboutToBeRemoved);
+        connect(model, &QAbstractItemModel::rowsRemoved, this, &ProcessSortFilterProxyModel::sourceRowsRemoved);
+        // rows moving between parents in tree mode come as layout changes
+        connect(model, &QAbstractItemModel::layoutAboutToBeChanged, this, &ProcessSortFilterProxyModel::beginRebuild);
+        connect(model, &QAbstractItemModel::layoutChanged, this, &ProcessSortFilterProxyModel::endRebuild);
+        connect(model, &QAbstractItemModel::modelAboutToBeReset, this, [this]() {
+            beginResetModel();
+            clearMappings();
+        });
+        connect(model, &QAbstractItemModel::modelReset, this, [this]() {
+            buildMapping({});
+            endResetModel();
+        });
+        // columns of the process model are fixed
+        buildMapping({});
+    }
+    endResetModel();
+}
+
+QModelIndex ProcessSortFilterProxyModel::mapToSource(const QModelIndex &proxyIndex) const
+{
+    if (!proxyIndex.isValid() || !sourceModel())
+        return {};
+    auto *mapping = static_cast<Mapping *>(proxyIndex.internalPointer());
+    if (!mapping || proxyIndex.row() >= mapping->sourceRows.size())
+        return {};
+    return sourceModel()->index(mapping->sourceRows[proxyIndex.row()], proxyIndex.column(), mapping->sourceParent);
+}
+
+QModelIndex ProcessSortFilterProxyModel::mapFromSource(const QModelIndex &sourceIndex) const
+{
+    if (!sourceIndex.isValid() || sourceIndex.model() != sourceModel())
+        return {};
+    Mapping *mapping = m_mappings.value(sourceIndex.parent());
+    if (!mapping || sourceIndex.row() >= mapping->proxyRows.size())
+        return {};
+    int row = mapping->proxyRows[sourceIndex.row()];
+    return row < 0 ? QModelIndex() : createIndex(row, sourceIndex.column(), mapping);
+}
+
+QModelIndex ProcessSortFilterProxyModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (row < 0 || column < 0 || column >= columnCount(parent))
+        return {};
+    Mapping *mapping = mappingOf(parent);
+    if (!mapping || row >= mapping->sourceRows.size())
+        return {};
+    return createIndex(row, column, mapping);
+}
+
+QModelIndex ProcessSortFilterProxyModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid())
+        return {};
+    return proxyParentOf(static_cast<Mapping *>(child.internalPointer()));
+}
+
+int ProcessSortFilterProxyModel::rowCount(const QModelIndex &parent) const
+{
+    Mapping *mapping = mappingOf(parent);
+    return mapping ? mapping->sourceRows.size() : 0;
+}
+
+int ProcessSortFilterProxyModel::columnCount(const QModelIndex &parent) const
+{
+    if (!sourceModel())
+        return 0;
+    return sourceModel()->columnCount(parent.isValid() ? mapToSource(parent) : QModelIndex());
+}
+
+bool ProcessSortFilterProxyModel::hasChildren(const QModelIndex &parent) const
+{
+    // rows whose children are all filtered out have no expander
+    return rowCount(parent) > 0;
+}
+
+QVariant ProcessSortFilterProxyModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    // sections are columns of the source, also while no row is shown
+    if (orientation == Qt::Horizontal && sourceModel())
+        return sourceModel()->headerData(section, orientation, role);
+    return QAbstractProxyModel::headerData(section, orientation, role);
 }
 
 // filters the row of specified parent with given pattern
 bool ProcessSortFilterProxyModel::filterAcceptsRow(int row, const QModelIndex &parent) const
 {
     // qCDebug(app) << "Filtering row" << row;
-    bool filter = false;
-    const QModelIndex &pid = sourceModel()->index(row, ProcessTableModel::kProcessPIDColumn, parent);
-    int apptype = pid.data(Qt::UserRole + 3).toInt();
-    if (m_fileterType == kNoFilter) {
-        qCDebug(app) << "No filter applied";
-        filter = true;
-    } else if (m_fileterType == kFilterCurrentUser && (apptype == kFilterApps || apptype == kFilterCurrentUser)) {
-        qCDebug(app) << "Filter for current user";
-        filter = true;
-    } else if (m_fileterType == kFilterApps && apptype == kFilterApps) {
-        qCDebug(app) << "Filter for applications";
-        filter = true;
-    }
+    // every row is shown, most of the time
+    if (m_fileterType == kNoFilter && m_search.isEmpty())
+        return true;
 
-    if (!filter) {
-        qCDebug(app) << "Row" << row << "filtered out by type";
+    // tabs are partitioned by the scan, the process model keeps the tab of each row
+    const int flatRow = m_processModel ? m_processModel->flatRow(row, parent) : -1;
+    const QModelIndex &pid = sourceModel()->index(row, ProcessTableModel::kProcessPIDColumn, parent);
+    bool filter = m_processModel ? m_processModel->isInTab(flatRow, m_fileterType)
+                                 : isShownIn(m_fileterType, pid.data(Qt::UserRole + 3).toInt());
+    if (!filter)
         return false;
+    // every row of the tab is shown
+    if (m_search.isEmpty())
+        return true;
+
+    // plain pattern, substring of the index kept by the source model
+    if (m_plainSearch && m_processModel) {
+        const QString &search = m_processModel->searchText(flatRow);
+        if (search.contains(m_searchLower))
+            return true;
+        return !m_hanwordsLower.isEmpty() && search.contains(m_hanwordsLower);
     }
 
     bool rc = false;
     const QModelIndex &name = sourceModel()->index(row, ProcessTableModel::kProcessNameColumn, parent);
     // display name or name matches pattern
     if (name.isValid()) {
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        rc |= name.data().toString().contains(filterRegExp());
-#else
-        rc |= name.data().toString().contains(filterRegularExpression());
-#endif
+        rc |= name.data().toString().contains(m_filter);
         if (rc) {
             qCDebug(app) << "Filter accepted by name:" << name.data().toString();
             return rc;
         }
 
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        rc |= name.data(Qt::UserRole).toString().contains(filterRegExp());
-#else
-        rc |= name.data(Qt::UserRole).toString().contains(filterRegularExpression());
-#endif
+        rc |= name.data(Qt::UserRole).toString().contains(m_filter);
         if (rc) {
             qCDebug(app) << "Filter accepted by user role name:" << name.data(Qt::UserRole).toString();
             return rc;
@@ -111,13 +243,8 @@ bool ProcessSortFilterProxyModel::filterAcceptsRow(int row, const QModelIndex &p
     }
 
     // pid matches pattern
-    if (pid.isValid()) {
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        rc |= pid.data().toString().contains(filterRegExp());
-#else
-        rc |= pid.data().toString().contains(filterRegularExpression());
-#endif
-    }
+    if (pid.isValid())
+        rc |= pid.data().toString().contains(m_filter);
     if (rc) {
         qCDebug(app) << "Filter accepted by PID:" << pid.data().toString();
         return rc;
@@ -125,12 +252,8 @@ bool ProcessSortFilterProxyModel::filterAcceptsRow(int row, const QModelIndex &p
 
     // user name matches pattern
     const QModelIndex &user = sourceModel()->index(row, ProcessTableModel::kProcessUserColumn, parent);
-    if (user.isValid()) {   
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        rc |= user.data().toString().contains(filterRegExp());
-#else
-        rc |= user.data().toString().contains(filterRegularExpression());
-#endif
+    if (user.isValid()) {
+        rc |= user.data().toString().contains(m_filter);
         if (rc) qCDebug(app) << "Filter accepted by user name:" << user.data().toString();
     }
 
@@ -140,133 +263,485 @@ bool ProcessSortFilterProxyModel::filterAcceptsRow(int row, const QModelIndex &p
 // compare two items with the specified index
 bool ProcessSortFilterProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
 {
-    qCDebug(app) << "lessThan sorting on column:" << sortColumn();
+    return sortKey(left.row(), left.parent()) < sortKey(right.row(), right.parent());
+}
+
+ProcessSortFilterProxyModel::SortKey ProcessSortFilterProxyModel::sortKey(int row, const QModelIndex &parent) const
+{
+    // sort keys are cached by the source model once per refresh, names & users as collation ranks
+    const int flatRow = m_processModel ? m_processModel->flatRow(row, parent) : -1;
+    auto key = [this, row, flatRow, &parent](int column) -> qreal {
+        if (m_processModel)
+            return m_processModel->sortKey(flatRow, column);
+        if (!sourceModel())
+            return 0;
+        return sourceModel()->index(row, column, parent).data(ProcessTableModel::kSortKeyRole).toDouble();
+    };
+
+    SortKey sortkey;
     int sortcolumn = sortColumn();
     switch (sortcolumn) {
-    case ProcessTableModel::kProcessNameColumn: {
-        qCDebug(app) << "Sorting by process name";
-        const QString &lhs = left.data(Qt::DisplayRole).toString();
-        const QString &rhs = right.data(Qt::DisplayRole).toString();
-
-        bool lstartHz = common::startWithHanzi(lhs);
-        bool rstartHz = common::startWithHanzi(rhs);
-        if (!lstartHz && rstartHz) {
-            qCDebug(app) << "lhs does not start with Hanzi, rhs does, lhs is less";
-            return true;
+    case ProcessTableModel::kProcessNameColumn:
+    case ProcessTableModel::kProcessCommandLineColumn:
+        // process names are equal, compare by cpu
+        sortkey.primary = key(sortcolumn);
+        sortkey.secondary = key(ProcessTableModel::kProcessCPUColumn);
+        break;
+    case ProcessTableModel::kProcessUserColumn:
+    case ProcessTableModel::kProcessPIDColumn:
+    case ProcessTableModel::kProcessDiskReadColumn:
+    case ProcessTableModel::kProcessDiskWriteColumn:
+    case ProcessTableModel::kProcessIOWaitColumn:
+    case ProcessTableModel::kProcessIOPSColumn:
+    case ProcessTableModel::kProcessTcpRttColumn:
+    case ProcessTableModel::kProcessTcpRetransColumn:
+    case ProcessTableModel::kProcessMemoryExhaustionColumn:
+    case ProcessTableModel::kProcessPowerColumn:
+    case ProcessTableModel::kProcessMemoryGrowthColumn:
+    // speed of upload & download, the total bytes of Qt::UserRole + 1 are the same figure
+    case ProcessTableModel::kProcessUploadColumn:
+    case ProcessTableModel::kProcessDownloadColumn:
+        // shrinking processes last for memory growth
+        sortkey.primary = key(sortcolumn);
+        break;
+    case ProcessTableModel::kProcessMemoryColumn:
+    case ProcessTableModel::kProcessShareMemoryColumn:
+    case ProcessTableModel::kProcessVTRMemoryColumn:
+    case ProcessTableModel::kProcessPSSColumn:
+    case ProcessTableModel::kProcessUSSColumn:
+    case ProcessTableModel::kProcessSwapColumn:
+    case ProcessTableModel::kProcessGPUMemoryColumn:
+        // compare memory usage first, then by cpu time
+        sortkey.primary = key(sortcolumn);
+        sortkey.secondary = key(ProcessTableModel::kProcessCPUColumn);
+        break;
+    case ProcessTableModel::kProcessCPUColumn:
+    case ProcessTableModel::kProcessCPUWaitColumn:
+    case ProcessTableModel::kProcessGuestCPUColumn:
+    case ProcessTableModel::kProcessGPUColumn:
+    case ProcessTableModel::kProcessMinorFaultsColumn:
+    case ProcessTableModel::kProcessMajorFaultsColumn:
+    case ProcessTableModel::kProcessVoluntarySwitchesColumn:
+    case ProcessTableModel::kProcessInvoluntarySwitchesColumn:
+    case ProcessTableModel::kProcessWakeupsColumn:
+    case ProcessTableModel::kProcessFDsColumn:
+    case ProcessTableModel::kProcessSocketsColumn:
+        // compare cpu time first, then by memory usage
+        sortkey.primary = key(sortcolumn);
+        sortkey.secondary = key(ProcessTableModel::kProcessMemoryColumn);
+        break;
+    case ProcessTableModel::kProcessNiceColumn:
+    case ProcessTableModel::kProcessPriorityColumn:
+        // higher priority has negative number, priority column compares nice value instead of display name
+        sortkey.primary = -key(sortcolumn);
+        break;
+    default:
+        // unsorted, rows keep the source order
+        break;
+    }
+    return sortkey;
+}
+
+bool ProcessSortFilterProxyModel::rowLessThan(const Mapping *mapping, int a, int b) const
+{
+    const SortKey &lhs = mapping->keys[a];
+    const SortKey &rhs = mapping->keys[b];
+    if (lhs < rhs)
+        return m_sortOrder == Qt::AscendingOrder;
+    if (rhs < lhs)
+        return m_sortOrder == Qt::DescendingOrder;
+    return a < b;
+}
+
+ProcessSortFilterProxyModel::Mapping *ProcessSortFilterProxyModel::mappingOf(const QModelIndex &proxyParent) const
+{
+    if (!proxyParent.isValid())
+        return m_mappings.value({});
+    // only the first column has children
+    if (proxyParent.column() != 0)
+        return nullptr;
+    return m_mappings.value(mapToSource(proxyParent));
+}
+
+ProcessSortFilterProxyModel::Mapping *ProcessSortFilterProxyModel::mappingOfSource(const QModelIndex &sourceParent) const
+{
+    Mapping *mapping = m_mappings.value(sourceParent);
+    if (mapping && mapping->sourceParent == sourceParent)
+        return mapping;
+    // keys of nested levels are stale once rows above them were inserted or removed
+    for (Mapping *other : m_mappings) {
+        if (other->sourceParent == sourceParent)
+            return other;
+    }
+    return nullptr;
+}
+
+QModelIndex ProcessSortFilterProxyModel::proxyParentOf(const Mapping *mapping) const
+{
+    if (!mapping || !mapping->sourceParent.isValid())
+        return {};
+    return mapFromSource(mapping->sourceParent);
+}
+
+bool ProcessSortFilterProxyModel::buildMapping(const QModelIndex &sourceParent)
+{
+    auto *mapping = new Mapping;
+    mapping->sourceParent = sourceParent;
+    const int rows = sourceModel()->rowCount(sourceParent);
+    mapping->proxyRows.fill(-1, rows);
+    mapping->keys.resize(rows);
+    mapping->sourceRows.reserve(rows);
+    for (int row = 0; row < rows; ++row) {
+        // children first, a row having a shown descendant is shown when filtering recursively
+        const QModelIndex &child = sourceModel()->index(row, 0, sourceParent);
+        bool childShown = sourceModel()->hasChildren(child) && buildMapping(child);
+        if (!filterAcceptsRow(row, sourceParent) && !(m_recursive && childShown)) {
+            dropMapping(child);
+            continue;
         }
+        mapping->keys[row] = sortKey(row, sourceParent);
+        mapping->sourceRows << row;
+    }
+    std::sort(mapping->sourceRows.begin(), mapping->sourceRows.end(), [this, mapping](int a, int b) {
+        return rowLessThan(mapping, a, b);
+    });
+    updateProxyRows(mapping, 0);
+    m_mappings.insert(sourceParent, mapping);
+    return !mapping->sourceRows.isEmpty();
+}
+
+void ProcessSortFilterProxyModel::dropMapping(const QModelIndex &sourceParent)
+{
+    Mapping *mapping = m_mappings.take(sourceParent);
+    if (!mapping)
+        return;
+    for (int row = 0; row < mapping->proxyRows.size(); ++row)
+        dropMapping(sourceModel()->index(row, 0, sourceParent));
+    delete mapping;
+}
+
+void ProcessSortFilterProxyModel::clearMappings()
+{
+    qDeleteAll(m_mappings);
+    m_mappings.clear();
+}
+
+bool ProcessSortFilterProxyModel::isFlat(const QModelIndex &sourceParent, const QVector<int> &rows) const
+{
+    if (sourceParent.isValid() || m_recursive || m_mappings.size() > 1)
+        return false;
+    return std::none_of(rows.cbegin(), rows.cend(), [this](int row) {
+        return sourceModel()->hasChildren(sourceModel()->index(row, 0));
+    });
+}
+
+void ProcessSortFilterProxyModel::beginRebuild()
+{
+    Q_EMIT layoutAboutToBeChanged();
+    m_savedProxyIndexes = persistentIndexList();
+    m_savedSourceIndexes.clear();
+    for (const QModelIndex &index : m_savedProxyIndexes)
+        m_savedSourceIndexes << QPersistentModelIndex(mapToSource(index));
+}
+
+void ProcessSortFilterProxyModel::endRebuild()
+{
+    clearMappings();
+    if (sourceModel())
+        buildMapping({});
+
+    // selected & expanded rows follow their process, rows filtered out are dropped
+    QModelIndexList to;
+    to.reserve(m_savedSourceIndexes.size());
+    for (const QPersistentModelIndex &index : m_savedSourceIndexes)
+        to << mapFromSource(index);
+    changePersistentIndexList(m_savedProxyIndexes, to);
+    m_savedProxyIndexes.clear();
+    m_savedSourceIndexes.clear();
+    Q_EMIT layoutChanged();
+}
+
+void ProcessSortFilterProxyModel::insertMappedRows(Mapping *mapping, const QVector<int> &rows)
+{
+    if (rows.isEmpty())
+        return;
+    QVector<int> order;
+    order.reserve(mapping->sourceRows.size() + rows.size());
+    std::merge(mapping->sourceRows.cbegin(), mapping->sourceRows.cend(), rows.cbegin(), rows.cend(),
+               std::back_inserter(order), [this, mapping](int a, int b) {
+                   return rowLessThan(mapping, a, b);
+               });
 
-        if (lstartHz && !rstartHz) {
-            qCDebug(app) << "lhs starts with Hanzi, rhs does not, rhs is less";
-            return false;
+    // one insertion per run of rows landing next to each other, top down
+    const QModelIndex &parent = proxyParentOf(mapping);
+    for (int i = 0; i < order.size();) {
+        if (mapping->proxyRows[order[i]] >= 0) {
+            ++i;
+            continue;
         }
+        int end = i + 1;
+        while (end < order.size() && mapping->proxyRows[order[end]] < 0)
+            ++end;
+        beginInsertRows(parent, i, end - 1);
+        mapping->sourceRows.insert(i, end - i, 0);
+        std::copy(order.cbegin() + i, order.cbegin() + end, mapping->sourceRows.begin() + i);
+        updateProxyRows(mapping, i);
+        endInsertRows();
+        i = end;
+    }
+}
 
-        int rc = lhs.localeAwareCompare(rhs);
+void ProcessSortFilterProxyModel::removeMappedRows(Mapping *mapping, const QVector<int> &rows)
+{
+    if (rows.isEmpty())
+        return;
+    QVector<int> proxyRows;
+    proxyRows.reserve(rows.size());
+    for (int row : rows)
+        proxyRows << mapping->proxyRows[row];
+    std::sort(proxyRows.begin(), proxyRows.end(), std::greater<int>());
 
-        if (rc == 0) {
-            qCDebug(app) << "Process names are equal, comparing by CPU";
-            return left.sibling(left.row(), ProcessTableModel::kProcessCPUColumn)
-                   .data(Qt::UserRole).toDouble() <
-                   right.sibling(right.row(), ProcessTableModel::kProcessCPUColumn)
-                   .data(Qt::UserRole).toDouble();
-        } else
-            return rc < 0;
+    const QModelIndex &parent = proxyParentOf(mapping);
+    for (int i = 0; i < proxyRows.size();) {
+        int last = proxyRows[i];
+        int first = last;
+        for (++i; i < proxyRows.size() && proxyRows[i] == first - 1; ++i)
+            first = proxyRows[i];
+        beginRemoveRows(parent, first, last);
+        for (int row = first; row <= last; ++row)
+            mapping->proxyRows[mapping->sourceRows[row]] = -1;
+        mapping->sourceRows.remove(first, last - first + 1);
+        updateProxyRows(mapping, first);
+        endRemoveRows();
     }
-    case ProcessTableModel::kProcessUserColumn: {
-        qCDebug(app) << "Sorting by user name";
-        const QString &lhs = left.data(Qt::DisplayRole).toString();
-        const QString &rhs = right.data(Qt::DisplayRole).toString();
-        return lhs.localeAwareCompare(rhs) < 0;
+}
+
+void ProcessSortFilterProxyModel::resortRows(Mapping *mapping, const QVector<int> &changed)
+{
+    if (changed.isEmpty())
+        return;
+    auto less = [this, mapping](int a, int b) {
+        return rowLessThan(mapping, a, b);
+    };
+
+    // rows whose key is unchanged are still in order, the changed ones are merged back by key
+    QVector<char> isChanged(mapping->proxyRows.size(), 0);
+    for (int row : changed)
+        isChanged[row] = 1;
+    QVector<int> kept;
+    kept.reserve(mapping->sourceRows.size());
+    for (int row : mapping->sourceRows) {
+        if (!isChanged[row])
+            kept << row;
     }
-    case ProcessTableModel::kProcessMemoryColumn:
-    case ProcessTableModel::kProcessShareMemoryColumn:
-    case ProcessTableModel::kProcessVTRMemoryColumn: {
-        qCDebug(app) << "Sorting by memory";
-        const QVariant &lmem = left.data(Qt::UserRole);
-        const QVariant &rmem = right.data(Qt::UserRole);
+    QVector<int> moved = changed;
+    std::sort(moved.begin(), moved.end(), less);
+    QVector<int> order;
+    order.reserve(mapping->sourceRows.size());
+    std::merge(kept.cbegin(), kept.cend(), moved.cbegin(), moved.cend(), std::back_inserter(order), less);
+    if (order == mapping->sourceRows)
+        return;
 
-        // compare memory usage first, then by cpu time
-        if (lmem == rmem) {
-            qCDebug(app) << "Memory is equal, comparing by CPU";
-            return left.sibling(left.row(), ProcessTableModel::kProcessCPUColumn)
-                   .data(Qt::UserRole).toDouble() <
-                   right.sibling(right.row(), ProcessTableModel::kProcessCPUColumn)
-                   .data(Qt::UserRole).toDouble();
-        } else {
-            return lmem.toULongLong() < rmem.toULongLong();
+    // rows staying put: the longest run of the new order whose rows keep their relative order,
+    // the others are moved, at least as few rows as changed keys
+    const int count = order.size();
+    QVector<int> tails; // position in order of the last row of the best run of each length
+    QVector<int> previous(count, -1);
+    tails.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const int row = mapping->proxyRows[order[i]];
+        auto it = std::lower_bound(tails.begin(), tails.end(), row, [mapping, &order](int pos, int value) {
+            return mapping->proxyRows[order[pos]] < value;
+        });
+        if (it != tails.begin())
+            previous[i] = *(it - 1);
+        if (it == tails.end())
+            tails << i;
+        else
+            *it = i;
+    }
+    QVector<char> stays(count, 0);
+    for (int i = tails.isEmpty() ? -1 : tails.last(); i >= 0; i = previous[i])
+        stays[i] = 1;
+
+    const QModelIndex &parent = proxyParentOf(mapping);
+    if (count - tails.size() > kMaxRowMoves) {
+        // too many moves, the view relayouts once
+        QList<QPersistentModelIndex> parents;
+        if (parent.isValid())
+            parents << parent;
+        Q_EMIT layoutAboutToBeChanged(parents, QAbstractItemModel::VerticalSortHint);
+        QModelIndexList from;
+        QVector<int> fromRows;
+        for (const QModelIndex &index : persistentIndexList()) {
+            if (index.internalPointer() == mapping) {
+                from << index;
+                fromRows << mapping->sourceRows[index.row()];
+            }
         }
+        mapping->sourceRows = order;
+        updateProxyRows(mapping, 0);
+        QModelIndexList to;
+        to.reserve(from.size());
+        for (int i = 0; i < from.size(); ++i)
+            to << createIndex(mapping->proxyRows[fromRows[i]], from[i].column(), mapping);
+        changePersistentIndexList(from, to);
+        Q_EMIT layoutChanged(parents, QAbstractItemModel::VerticalSortHint);
+        return;
     }
-    case ProcessTableModel::kProcessCPUColumn: {
-        qCDebug(app) << "Sorting by CPU";
-        const QVariant &lcpu = left.data(Qt::UserRole);
-        const QVariant &rcpu = right.data(Qt::UserRole);
 
-        const QVariant &lmem = left.sibling(left.row(), ProcessTableModel::kProcessMemoryColumn).data(Qt::UserRole);
-        const QVariant &rmem = right.sibling(right.row(), ProcessTableModel::kProcessMemoryColumn).data(Qt::UserRole);
+    // each moved row goes right after the row preceding it in the new order, top down
+    for (int i = 0; i < count; ++i) {
+        if (stays[i])
+            continue;
+        const int row = order[i];
+        const int from = mapping->proxyRows[row];
+        const int to = i == 0 ? 0 : mapping->proxyRows[order[i - 1]] + 1;
+        if (to == from || to == from + 1)
+            continue;
+        beginMoveRows(parent, from, from, parent, to);
+        mapping->sourceRows.remove(from);
+        mapping->sourceRows.insert(to > from ? to - 1 : to, row);
+        updateProxyRows(mapping, qMin(from, to));
+        endMoveRows();
+    }
+}
 
-        // compare cpu time first, then by memory usage
-        if (qFuzzyCompare(lcpu.toReal(), rcpu.toReal())) {
-            qCDebug(app) << "CPU is equal, comparing by memory";
-            return lmem.toULongLong() < rmem.toULongLong();
-        } else {
-            return lcpu.toDouble() < rcpu.toDouble();
-        }
+void ProcessSortFilterProxyModel::sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                                    const QVector<int> &roles)
+{
+    if (!topLeft.isValid() || !bottomRight.isValid())
+        return;
+    const QModelIndex &sourceParent = topLeft.parent();
+    Mapping *mapping = m_mappings.value(sourceParent);
+    if (!mapping) {
+        // a child matching now may show its filtered out parent
+        if (m_recursive)
+            rebuild();
+        return;
     }
-    case ProcessTableModel::kProcessUploadColumn: {
-        qCDebug(app) << "Sorting by upload speed";
-        qreal lkbs, rkbs;
-        lkbs = left.data(Qt::UserRole).toReal();
-        rkbs = right.data(Qt::UserRole).toReal();
-
-        // compare upload speed first, then by total send bytes
-        if (qFuzzyCompare(lkbs, rkbs)) {
-            qCDebug(app) << "Upload speed is equal, comparing by total sent bytes";
-            return left.data(Qt::UserRole + 1).toULongLong() < right.data(Qt::UserRole + 1).toULongLong();
-        } else {
-            return lkbs < rkbs;
+
+    QVector<int> shown, hidden, changed;
+    const int last = qMin(bottomRight.row(), mapping->proxyRows.size() - 1);
+    for (int row = topLeft.row(); row <= last; ++row) {
+        bool accepted = filterAcceptsRow(row, sourceParent);
+        if (!accepted && m_recursive) {
+            Mapping *children = m_mappings.value(sourceModel()->index(row, 0, sourceParent));
+            accepted = children && !children->sourceRows.isEmpty();
         }
-    }
-    case ProcessTableModel::kProcessDownloadColumn: {
-        qCDebug(app) << "Sorting by download speed";
-        qreal lkbs = left.data(Qt::UserRole).toReal();
-        qreal rkbs = right.data(Qt::UserRole).toReal();
-
-        // compare download speed first, then by total download bytes
-        if (qFuzzyCompare(lkbs, rkbs)) {
-            qCDebug(app) << "Download speed is equal, comparing by total download bytes";
-            return left.data(Qt::UserRole + 1).toULongLong() < right.data(Qt::UserRole + 1).toULongLong();
-        } else {
-            return lkbs < rkbs;
+        const bool wasShown = mapping->proxyRows[row] >= 0;
+        if (accepted != wasShown) {
+            (accepted ? shown : hidden) << row;
+            continue;
+        }
+        if (!accepted)
+            continue;
+        const SortKey &key = sortKey(row, sourceParent);
+        if (key != mapping->keys[row]) {
+            mapping->keys[row] = key;
+            changed << row;
         }
     }
-    case ProcessTableModel::kProcessPIDColumn: {
-        qCDebug(app) << "Sorting by PID";
-        // compare pid
-        return left.data(Qt::UserRole).toInt() < right.data(Qt::UserRole).toInt();
+    // rows shown or hidden change their parents & children too in tree mode
+    if ((!shown.isEmpty() || !hidden.isEmpty()) && !isFlat(sourceParent, shown + hidden)) {
+        rebuild();
+        return;
     }
-    case ProcessTableModel::kProcessDiskReadColumn: {
-        qCDebug(app) << "Sorting by disk read speed";
-        // compare disk read speed
-        return left.data(Qt::UserRole).toDouble() < right.data(Qt::UserRole).toDouble();
+
+    removeMappedRows(mapping, hidden);
+    resortRows(mapping, changed);
+    for (int row : shown)
+        mapping->keys[row] = sortKey(row, sourceParent);
+    std::sort(shown.begin(), shown.end(), [this, mapping](int a, int b) {
+        return rowLessThan(mapping, a, b);
+    });
+    insertMappedRows(mapping, shown);
+
+    // the changed rows are spread over the view once sorted
+    int first = -1;
+    int lastShown = -1;
+    for (int row = topLeft.row(); row <= last; ++row) {
+        int proxyRow = mapping->proxyRows[row];
+        if (proxyRow < 0)
+            continue;
+        first = first < 0 ? proxyRow : qMin(first, proxyRow);
+        lastShown = qMax(lastShown, proxyRow);
     }
-    case ProcessTableModel::kProcessDiskWriteColumn: {
-        qCDebug(app) << "Sorting by disk write speed";
-        // compare disk write speed
-        return left.data(Qt::UserRole).toDouble() < right.data(Qt::UserRole).toDouble();
+    if (first < 0)
+        return;
+    Q_EMIT dataChanged(createIndex(first, topLeft.column(), mapping), createIndex(lastShown, bottomRight.column(), mapping),
+                       roles);
+}
+
+void ProcessSortFilterProxyModel::sourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    const int count = last - first + 1;
+    Mapping *mapping = mappingOfSource(parent);
+    if (mapping) {
+        for (int &row : mapping->sourceRows) {
+            if (row >= first)
+                row += count;
+        }
+        mapping->proxyRows.insert(first, count, -1);
+        mapping->keys.insert(first, count, SortKey());
+        updateProxyRows(mapping, 0);
     }
-    case ProcessTableModel::kProcessNiceColumn: {
-        qCDebug(app) << "Sorting by nice value";
-        // higher priority has negative number
-        return !(left.data(Qt::UserRole).toInt() < right.data(Qt::UserRole).toInt());
+
+    QVector<int> rows;
+    for (int row = first; row <= last; ++row)
+        rows << row;
+    if (!mapping || !isFlat(parent, rows)) {
+        rebuild();
+        return;
     }
-    case ProcessTableModel::kProcessPriorityColumn: {
-        qCDebug(app) << "Sorting by priority";
-        // compare priority with nice value instead of nice display name
-        return !(left.sibling(left.row(), ProcessTableModel::kProcessNiceColumn).data(Qt::UserRole).toInt() < right.sibling(right.row(), ProcessTableModel::kProcessNiceColumn).data(Qt::UserRole).toInt());
+
+    rows.erase(std::remove_if(rows.begin(), rows.end(), [this, &parent](int row) {
+        return !filterAcceptsRow(row, parent);
+    }), rows.end());
+    for (int row : rows)
+        mapping->keys[row] = sortKey(row, parent);
+    std::sort(rows.begin(), rows.end(), [this, mapping](int a, int b) {
+        return rowLessThan(mapping, a, b);
+    });
+    insertMappedRows(mapping, rows);
+}
+
+void ProcessSortFilterProxyModel::sourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    Mapping *mapping = mappingOfSource(parent);
+    QVector<int> rows;
+    for (int row = first; row <= last; ++row)
+        rows << row;
+    if (!mapping || !isFlat(parent, rows)) {
+        // rebuilt once the rows are gone
+        m_removeRebuild = true;
+        beginRebuild();
+        return;
     }
-    default:
-        qCDebug(app) << "Default sort";
-        break;
+
+    rows.erase(std::remove_if(rows.begin(), rows.end(), [mapping](int row) {
+        return mapping->proxyRows[row] < 0;
+    }), rows.end());
+    removeMappedRows(mapping, rows);
+}
+
+void ProcessSortFilterProxyModel::sourceRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (m_removeRebuild) {
+        m_removeRebuild = false;
+        endRebuild();
+        return;
     }
 
-    return QSortFilterProxyModel::lessThan(left, right);
+    Mapping *mapping = mappingOfSource(parent);
+    if (!mapping)
+        return;
+    const int count = last - first + 1;
+    for (int &row : mapping->sourceRows) {
+        if (row > last)
+            row -= count;
+    }
+    mapping->proxyRows.remove(first, count);
+    mapping->keys.remove(first, count);
+    updateProxyRows(mapping, 0);
 }
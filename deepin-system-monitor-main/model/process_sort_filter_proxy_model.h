@@ -6,21 +6,36 @@
 #ifndef PROCESS_SORT_FILTER_PROXY_MODEL_H
 #define PROCESS_SORT_FILTER_PROXY_MODEL_H
 
-#include <QSortFilterProxyModel>
+#include <QAbstractProxyModel>
+#include <QHash>
+#include <QPersistentModelIndex>
+#include <QRegularExpression>
+#include <QVector>
+
+class ProcessTableModel;
 
 /**
  * @brief Sort filter proxy model for process model
+ *
+ * Rows are kept sorted by their cached sort keys. When the source model updates rows in place, only
+ * the rows whose key changed are taken out & merged back in order: a few of them are moved one row
+ * at a time, more than kMaxRowMoves with a single layout change, & nothing happens to the view when
+ * the order holds. Changes of filter, sort column or of the tree layout rebuild the mapping at once.
  */
-class ProcessSortFilterProxyModel : public QSortFilterProxyModel
+class ProcessSortFilterProxyModel : public QAbstractProxyModel
 {
     Q_OBJECT
 
 public:
+    // moved rows signalled one by one, above that the layout is changed at once
+    static constexpr int kMaxRowMoves = 16;
+
     /**
      * @brief Proxy model constructor
      * @param parent Parent object
      */
     explicit ProcessSortFilterProxyModel(QObject *parent = nullptr);
+    ~ProcessSortFilterProxyModel() override;
 
     /**
      * @brief Set search pattern
@@ -30,6 +45,32 @@ public:
 
     void setFilterType(int type);
 
+    /**
+     * @brief Show rows having an accepted descendant in tree mode, as QSortFilterProxyModel does
+     */
+    void setRecursiveFilteringEnabled(bool enabled);
+    inline bool isRecursiveFilteringEnabled() const
+    {
+        return m_recursive;
+    }
+
+    int sortColumn() const;
+    inline Qt::SortOrder sortOrder() const
+    {
+        return m_sortOrder;
+    }
+
+    void setSourceModel(QAbstractItemModel *model) override;
+    QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
+    QModelIndex index(int row, int column, const QModelIndex &parent = {}) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = {}) const override;
+    int columnCount(const QModelIndex &parent = {}) const override;
+    bool hasChildren(const QModelIndex &parent = {}) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
 protected:
     /**
      * @brief Filters the row of specified parent with given pattern
@@ -37,7 +78,7 @@ protected:
      * @param parent Parent index of the row
      * @return Returns true if the item in the row indicated by the given row and parent should be included in the model; otherwise returns false
      */
-    bool filterAcceptsRow(int row, const QModelIndex &parent) const override;
+    bool filterAcceptsRow(int row, const QModelIndex &parent) const;
 
     /**
      * @brief Compare two items with the specified index
@@ -45,15 +86,113 @@ protected:
      * @param right Index of the item to be compared on right side
      * @return Returns true if the value of the item referred to by the given index left is less than the value of the item referred to by the given index right, otherwise returns false
      */
-    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const;
 
 private:
+    /**
+     * @brief Key of a row in the sort column, with the column breaking its ties, ascending
+     */
+    struct SortKey {
+        qreal primary {};
+        qreal secondary {};
+        inline bool operator<(const SortKey &other) const
+        {
+            return primary != other.primary ? primary < other.primary : secondary < other.secondary;
+        }
+        inline bool operator!=(const SortKey &other) const
+        {
+            return primary != other.primary || secondary != other.secondary;
+        }
+    };
+    /**
+     * @brief Shown rows under one source parent
+     */
+    struct Mapping {
+        QPersistentModelIndex sourceParent;
+        QVector<int> sourceRows; // source row of each proxy row, sorted
+        QVector<int> proxyRows; // proxy row of each source row, -1 if filtered out
+        QVector<SortKey> keys; // of each source row
+    };
+
+    SortKey sortKey(int row, const QModelIndex &parent) const;
+    /**
+     * @brief Whether source row \a a comes before \a b in the sort order, ties keep the source order
+     */
+    bool rowLessThan(const Mapping *mapping, int a, int b) const;
+    Mapping *mappingOf(const QModelIndex &proxyParent) const;
+    Mapping *mappingOfSource(const QModelIndex &sourceParent) const;
+    QModelIndex proxyParentOf(const Mapping *mapping) const;
+    inline void updateProxyRows(Mapping *mapping, int first)
+    {
+        for (int i = first; i < mapping->sourceRows.size(); ++i)
+            mapping->proxyRows[mapping->sourceRows[i]] = i;
+    }
+
+    /**
+     * @brief Map the rows of every source parent from scratch
+     * @return Whether any row under \a sourceParent is shown
+     */
+    bool buildMapping(const QModelIndex &sourceParent);
+    /**
+     * @brief Forget the mapping under \a sourceParent & below it
+     */
+    void dropMapping(const QModelIndex &sourceParent);
+    void clearMappings();
+    /**
+     * @brief Whether changes of \a rows under \a sourceParent affect no other level, true in flat mode
+     */
+    bool isFlat(const QModelIndex &sourceParent, const QVector<int> &rows) const;
+    /**
+     * @brief Rebuild the mapping within a layout change, persistent indexes follow their source rows
+     */
+    void beginRebuild();
+    void endRebuild();
+    inline void rebuild()
+    {
+        beginRebuild();
+        endRebuild();
+    }
+
+    /**
+     * @brief Merge \a rows, not mapped yet & sorted, into the shown rows of \a mapping
+     */
+    void insertMappedRows(Mapping *mapping, const QVector<int> &rows);
+    /**
+     * @brief Remove shown rows of \a mapping in contiguous proxy ranges, bottom up
+     */
+    void removeMappedRows(Mapping *mapping, const QVector<int> &rows);
+    /**
+     * @brief Put rows whose key changed back in order, with row moves or a single layout change
+     */
+    void resortRows(Mapping *mapping, const QVector<int> &changed);
+
+    void sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles);
+    void sourceRowsInserted(const QModelIndex &parent, int first, int last);
+    void sourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void sourceRowsRemoved(const QModelIndex &parent, int first, int last);
+
     // Search pattern
     QString m_search {};
+    QRegularExpression m_filter {};
     // Pinyin represented as ascii string converted from chinese hanzi
     QString m_hanwords {};
+    // Lowercased pattern & pinyin, matched against the source model's search index
+    QString m_searchLower {};
+    QString m_hanwordsLower {};
+    // Pattern has no regex syntax, so a plain substring test is enough
+    bool m_plainSearch {true};
 
     int m_fileterType = 0;
+    bool m_recursive {false};
+    int m_sortColumn {-1};
+    Qt::SortOrder m_sortOrder {Qt::AscendingOrder};
+
+    ProcessTableModel *m_processModel {nullptr}; // source, when it's the process model
+    QHash<QModelIndex, Mapping *> m_mappings; // source parent -> shown rows
+    // persistent indexes of a rebuild & their source indexes
+    QModelIndexList m_savedProxyIndexes;
+    QList<QPersistentModelIndex> m_savedSourceIndexes;
+    bool m_removeRebuild {false};
 };
 
 #endif  // PROCESS_SORT_FILTER_PROXY_MODEL_H
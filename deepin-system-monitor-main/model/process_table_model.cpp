@@ -5,29 +5,51 @@
 #include "ddlog.h"
 #include "process_table_model.h"
 #include "process/process_db.h"
+#include "system/device_db.h"
+#include "system/demand_tracker.h"
+#include "system/device_snapshot.h"
+#include "system/task_stats.h"
 #include "common/common.h"
+#include "common/han_latin.h"
+#include "common/perf_trace.h"
+#include "model_manager.h"
+#include "process_row_preparer.h"
+#include "update_coordinator.h"
+#include "process_info_record.h"
+#include "process/hung_task_sampler.h"
 
 #include <QDebug>
-#include <QTimer>
+#include <QHash>
+#include <QLocale>
+#include <QSet>
 #include <DApplication>
 #include <DGuiApplicationHelper>
 #include <DPlatformTheme>
 #include <QPointer>
+
+#include <algorithm>
+
+#include <pwd.h>
+#include <unistd.h>
+
 using namespace common;
+using namespace common::cgroup;
 using namespace common::format;
 using namespace DDLog;
 DGUI_USE_NAMESPACE   // using namespace Dtk::Gui;
 
 // model constructor
 ProcessTableModel::ProcessTableModel(QObject *parent, const QString &username)
-    : QAbstractTableModel(parent)
+    : QAbstractItemModel(parent)
 {
     setUserModeName(username);
     qCInfo(app) << "Initializing ProcessTableModel for user:" << username;
     
-    //update model's process list cache on process list updated signal
-    auto *monitor = ThreadManager::instance()->thread<SystemMonitorThread>(BaseThread::kSystemMonitorThread)->systemMonitorInstance();
-    connect(monitor, &SystemMonitor::statInfoUpdated, this, &ProcessTableModel::updateProcessList);
+    // process traffic & fds are only read while the table is shown
+    core::system::DemandTracker::instance()->declare(this, core::system::DemandTracker::kProcessNetDemand);
+
+    //update model's process list cache on process list updated signal, coalesced with the other models per frame
+    connect(ModelManager::instance()->updateCoordinator(), &UpdateCoordinator::updateModels, this, &ProcessTableModel::updateProcessList);
 
     //remove process entry from model's cache on process ended signal
     connect(ProcessDB::instance(), &ProcessDB::processEnded, this, &ProcessTableModel::removeProcess);
@@ -43,6 +65,9 @@ ProcessTableModel::ProcessTableModel(QObject *parent, const QString &username)
     //update process's priority in model's cache on process priority changed signal
     connect(ProcessDB::instance(), &ProcessDB::processPriorityChanged, this,
             &ProcessTableModel::updateProcessPriority);
+    //apply a batch of processes ended, paused, resumed or reniced together
+    connect(ProcessDB::instance(), &ProcessDB::processesControlled, this,
+            &ProcessTableModel::applyControlResult);
 
     // 由于之前获取dapplication::themetypechanged改变信号在有些平台获取不到，现通过获取DPlatformtheme方式获取
     static QPointer<DPlatformTheme> theme;
@@ -59,8 +84,10 @@ ProcessTableModel::ProcessTableModel(QObject *parent, const QString &username)
 char ProcessTableModel::getProcessState(pid_t pid) const
 {
     qCDebug(app) << "Getting process state for PID:" << pid;
-    if (m_procIdList.contains(pid)) {
-        return ProcessDB::instance()->processSet()->getProcessById(pid).state();
+    // rows hold copies from the last scan, the process set belongs to the monitor thread
+    int row = rowOf(pid);
+    if (row >= 0) {
+        return m_processList[row].state();
     }
 
     qCDebug(app) << "Process with PID" << pid << "not in the list";
@@ -70,107 +97,352 @@ char ProcessTableModel::getProcessState(pid_t pid) const
 Process ProcessTableModel::getProcess(pid_t pid) const
 {
     qCDebug(app) << "Getting process for PID:" << pid;
-    if (m_procIdList.contains(pid)) {
-        return ProcessDB::instance()->processSet()->getProcessById(pid);
+    int row = rowOf(pid);
+    if (row >= 0) {
+        return m_processList[row];
     }
 
     qCDebug(app) << "Process with PID" << pid << "not in the list";
     return Process();
 }
 
-// update process model with the data provided by list
+// update process model with the rows prepared from the last scan
 void ProcessTableModel::updateProcessList()
 {
-    qCDebug(app) << "Updating process list";
-    if (m_userModeName.isNull()) {
-        qCDebug(app) << "User mode name is null, delaying update";
-        QTimer::singleShot(0, this, SLOT(updateProcessListDelay()));
-    } else {
-        qCDebug(app) << "User mode name is set, updating for user:" << m_userModeName;
-        QTimer::singleShot(0, this, SLOT(updateProcessListWithUserSpecified()));
-    }
-}
-
-void ProcessTableModel::updateProcessListWithUserSpecified()
-{
-    qCDebug(app) << "Updating process list for specified user:" << m_userModeName;
-    ProcessSet *processSet = ProcessDB::instance()->processSet();
-    const QList<pid_t> &newpidlst = processSet->getPIDList();
-    beginRemoveRows({}, 0, m_procIdList.size());
-    endRemoveRows();
-    m_procIdList.clear();
-    m_processList.clear();
-    int raw;
-    for (const auto &pid : newpidlst) {
-        Process changedProc = processSet->getProcessById(pid);
-        // 确保进程有效且用户名匹配
-        if (changedProc.isValid() && changedProc.userName() == m_userModeName) {
-            // qCDebug(app) << "Adding process with PID:" << pid << "for user" << m_userModeName;
-            raw = m_procIdList.size();
-            beginInsertRows({}, raw, raw);
-            m_procIdList << pid;
-            m_processList << changedProc;
-            endInsertRows();
-        }
+    qCDebug(app) << "Updating process list, user mode name:" << m_userModeName;
+    // filtering, texts & keys are done on the monitor thread, only the diff is applied here
+    auto table = ModelManager::instance()->processRowPreparer()->rowTable();
+    if (!table) {
+        qCDebug(app) << "No process rows prepared yet";
+        return;
     }
+    applyRowTable(table);
 
-    qCDebug(app) << "Process list updated for user" << m_userModeName;
+    updateNetTrafficSampled(table->netTrafficSampled);
     Q_EMIT modelUpdated();
 }
 
-void ProcessTableModel::updateProcessListDelay()
+std::shared_ptr<const ProcessTableModel::RowTable> ProcessTableModel::makeRowTable(const QList<Process> &procs, bool netTrafficSampled,
+                                                                                   QHash<QString, int> &nameRanks, QHash<QString, int> &userRanks,
+                                                                                   CgroupStats *sliceStats, const ProcessTree &tree)
+{
+    auto table = std::make_shared<RowTable>();
+    table->procs = procs;
+    table->tree = tree;
+    table->rows.reserve(procs.size());
+    table->index.reserve(procs.size());
+    // per user usage is summed in the same pass, the summary doesn't rescan the rows
+    auto add = [](UserUsage &usage, const Process &proc) {
+        usage.cpu += proc.cpu();
+        usage.memory += proc.memory();
+        usage.shareMemory += proc.sharememory();
+        usage.virtualMemory += proc.vtrmemory();
+        usage.recvBps += proc.recvBps();
+        usage.sentBps += proc.sentBps();
+        usage.readBps += proc.readBps();
+        usage.writeBps += proc.writeBps();
+        ++usage.processes;
+    };
+    for (int row = 0; row < procs.size(); ++row) {
+        const Process &proc = procs[row];
+        table->rows << makeRow(proc);
+        table->index.insert(proc.pid(), row);
+        table->uidRows[proc.uid()] << row;
+        add(table->userUsages[proc.uid()], proc);
+        add(table->totalUsage, proc);
+    }
+    if (sliceStats)
+        sampleUserSlices(*table, *sliceStats);
+    QVector<ProcessRow> none;
+    rankRows(nameRanks, userRanks, table->rows, none);
+    table->nameRanks = nameRanks;
+    table->userRanks = userRanks;
+    table->netTrafficSampled = netTrafficSampled;
+    return table;
+}
+
+void ProcessTableModel::sampleUserSlices(RowTable &table, CgroupStats &sliceStats)
 {
-    qCDebug(app) << "Updating process list with delay";
-    ProcessSet *processSet = ProcessDB::instance()->processSet();
-    const QList<pid_t> &newpidlst = processSet->getPIDList();
-    QList<pid_t> oldpidlst = m_procIdList;
+    QHash<QString, QString> slices;
+    slices.reserve(table.userUsages.size());
+    for (auto it = table.userUsages.cbegin(); it != table.userUsages.cend(); ++it) {
+        // system users have no slice of their own, their processes run in system.slice
+        if (it.key() > 0)
+            slices.insert(QString::number(it.key()), QString("/user.slice/user-%1.slice").arg(it.key()));
+    }
 
-    for (const auto &pid : newpidlst) {
-        Process proc = processSet->getProcessById(pid);
-        // 只处理有效进程
-        if (!proc.isValid()) {
-            qCDebug(app) << "Skipping invalid process with PID:" << pid;
+    const QHash<QString, cgroup_usage_t> &usages = sliceStats.sample(slices);
+    for (auto it = usages.cbegin(); it != usages.cend(); ++it) {
+        if (!it.value().hasRates)
             continue;
+        UserUsage &usage = table.userUsages[it.key().toUInt()];
+        usage.cpu = it.value().cpu;
+        usage.memory = it.value().memory / 1024.;
+    }
+}
+
+void ProcessTableModel::applyRowTable(const std::shared_ptr<const RowTable> &table)
+{
+    PERF_TRACE_SCOPE(kStageModelDiff);
+    if (m_treeMode)
+        beginTreeChange();
+    m_tree = table->tree;
+    bool allUsers = m_userModeName.isNull();
+    const QVector<int> &userRows = table->uidRows.value(m_userModeUid);
+    auto shown = [&](pid_t pid) {
+        int row = table->index.value(pid, -1);
+        return row >= 0 && (allUsers || table->procs[row].uid() == m_userModeUid);
+    };
+    m_usage = allUsers ? table->totalUsage : table->userUsages.value(m_userModeUid);
+
+    // remove ended processes from the bottom up, rows above a range keep their index
+    int last = -1;
+    for (int row = m_procIdList.size() - 1; row >= 0; --row) {
+        if (!shown(m_procIdList[row])) {
+            if (last < 0)
+                last = row;
+        } else if (last >= 0) {
+            removeProcessRows(row + 1, last);
+            last = -1;
         }
-        
-        int row = m_procIdList.indexOf(pid);
-        if (row >= 0) {
-            // qCDebug(app) << "Updating process at row:" << row;
-            // update
-            m_processList[row] = proc;
-            Q_EMIT dataChanged(index(row, 0), index(row, columnCount() - 1));
-        } else {
-            // insert
-            // qCDebug(app) << "Inserting new process with PID:" << pid;
-            row = m_procIdList.size();
-            beginInsertRows({}, row, row);
-            m_procIdList << pid;
-            m_processList << proc;
-            endInsertRows();
+    }
+    if (last >= 0)
+        removeProcessRows(0, last);
+
+    m_rowIndex.clear();
+    m_rowIndex.reserve(allUsers ? table->procs.size() : userRows.size());
+    for (int row = 0; row < m_procIdList.size(); ++row)
+        m_rowIndex.insert(m_procIdList[row], row);
+
+    // rows of the table are already ranked, cached ranks only serve state & priority changes
+    m_nameRanks = table->nameRanks;
+    m_userRanks = table->userRanks;
+
+    // update survivors in place, one dataChanged across the rows touched
+    int firstChanged = -1;
+    int lastChanged = -1;
+    QList<int> spawned;
+    m_rows.resize(m_processList.size());
+    auto apply = [&](int i) {
+        int row = m_rowIndex.value(table->procs[i].pid(), -1);
+        if (row < 0) {
+            spawned << i;
+            return;
         }
+        m_processList[row] = table->procs[i];
+        m_rows[row] = table->rows[i];
+        firstChanged = firstChanged < 0 ? row : qMin(firstChanged, row);
+        lastChanged = qMax(lastChanged, row);
+    };
+    if (allUsers) {
+        for (int i = 0; i < table->procs.size(); ++i)
+            apply(i);
+    } else {
+        for (int i : userRows)
+            apply(i);
     }
+    if (firstChanged >= 0 && !m_treeMode)
+        Q_EMIT dataChanged(index(firstChanged, 0), index(lastChanged, columnCount() - 1));
 
-    // remove
-    for (const auto &pid : oldpidlst) {
-        if (!newpidlst.contains(pid)) {
-            // qCDebug(app) << "Removing process with PID:" << pid;
-            int row = m_procIdList.indexOf(pid);
-            beginRemoveRows({}, row, row);
-            m_procIdList.removeAt(row);
-            m_processList.removeAt(row);
-            endRemoveRows();
+    // append new processes in one range
+    if (!spawned.isEmpty()) {
+        int first = m_procIdList.size();
+        if (!m_treeMode)
+            beginInsertRows({}, first, first + spawned.size() - 1);
+        for (int i : spawned) {
+            m_rowIndex.insert(table->procs[i].pid(), m_procIdList.size());
+            m_procIdList << table->procs[i].pid();
+            m_processList << table->procs[i];
+            m_rows << table->rows[i];
         }
+        if (!m_treeMode)
+            endInsertRows();
     }
+    if (m_treeMode)
+        endTreeChange();
+    qCDebug(app) << "Process rows diffed," << spawned.size() << "inserted of" << m_procIdList.size();
+}
 
-    qCDebug(app) << "Delayed process list update finished";
-    Q_EMIT modelUpdated();
+void ProcessTableModel::removeProcessRows(int first, int last)
+{
+    if (!m_treeMode)
+        beginRemoveRows({}, first, last);
+    m_procIdList.erase(m_procIdList.begin() + first, m_procIdList.begin() + last + 1);
+    m_processList.erase(m_processList.begin() + first, m_processList.begin() + last + 1);
+    if (first < m_rows.size())
+        m_rows.erase(m_rows.begin() + first, m_rows.begin() + qMin(last + 1, m_rows.size()));
+    if (!m_treeMode)
+        endRemoveRows();
+}
+
+void ProcessTableModel::setTreeMode(bool enabled)
+{
+    if (enabled == m_treeMode)
+        return;
+    qCInfo(app) << "Process tree mode" << enabled;
+    // every index changes its parent, views start over
+    beginResetModel();
+    m_treeMode = enabled;
+    rebuildTree();
+    endResetModel();
+}
+
+void ProcessTableModel::rebuildTree()
+{
+    int count = m_procIdList.size();
+    m_childRows.clear();
+    m_parentRows.fill(-1, count);
+    m_childIndex.fill(0, count);
+    if (!m_treeMode)
+        return;
+
+    QHash<int, QVector<int>> children;
+    QVector<int> reached;
+    reached.reserve(count);
+    for (int row = 0; row < count; ++row) {
+        int parent = m_rowIndex.value(m_processList[row].ppid(), -1);
+        m_parentRows[row] = parent == row ? -1 : parent;
+        if (m_parentRows[row] < 0)
+            reached << row;
+        else
+            children[m_parentRows[row]] << row;
+    }
+    // walk down from the top level, rows never reached are in ppid loops of reused pids
+    QVector<bool> seen(count, false);
+    for (int row : reached)
+        seen[row] = true;
+    for (int i = 0; i < reached.size(); ++i) {
+        for (int child : children.value(reached[i])) {
+            seen[child] = true;
+            reached << child;
+        }
+    }
+    for (int row = 0; row < count; ++row) {
+        if (!seen[row])
+            m_parentRows[row] = -1;
+        QVector<int> &siblings = m_childRows[m_parentRows[row]];
+        m_childIndex[row] = siblings.size();
+        siblings << row;
+    }
+}
+
+void ProcessTableModel::beginTreeChange()
+{
+    Q_EMIT layoutAboutToBeChanged();
+    m_persistentPids.clear();
+    for (const QModelIndex &index : persistentIndexList()) {
+        int row = flatRow(index);
+        m_persistentPids << (row >= 0 ? m_procIdList[row] : 0);
+    }
+}
+
+void ProcessTableModel::endTreeChange()
+{
+    m_rowIndex.clear();
+    for (int row = 0; row < m_procIdList.size(); ++row)
+        m_rowIndex.insert(m_procIdList[row], row);
+    rebuildTree();
+
+    const QModelIndexList &from = persistentIndexList();
+    QModelIndexList to;
+    to.reserve(from.size());
+    for (int i = 0; i < from.size(); ++i) {
+        int row = i < m_persistentPids.size() ? rowOf(m_persistentPids[i]) : -1;
+        to << (row >= 0 ? indexOf(row, from[i].column()) : QModelIndex());
+    }
+    changePersistentIndexList(from, to);
+    m_persistentPids.clear();
+    Q_EMIT layoutChanged();
+}
+
+QModelIndex ProcessTableModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (row < 0 || column < 0 || column >= kProcessColumnCount)
+        return {};
+    if (!m_treeMode) {
+        if (parent.isValid() || row >= m_procIdList.size())
+            return {};
+        return createIndex(row, column);
+    }
+    // internal id is the parent's row + 1, 0 for the top level
+    int parentRow = parent.isValid() ? flatRow(parent) : -1;
+    if (parent.isValid() && parentRow < 0)
+        return {};
+    auto it = m_childRows.constFind(parentRow);
+    if (it == m_childRows.cend() || row >= it->size())
+        return {};
+    return createIndex(row, column, quintptr(parentRow + 1));
+}
+
+QModelIndex ProcessTableModel::parent(const QModelIndex &child) const
+{
+    if (!m_treeMode || !child.isValid())
+        return {};
+    int parentRow = int(child.internalId()) - 1;
+    if (parentRow < 0 || parentRow >= m_parentRows.size())
+        return {};
+    return createIndex(m_childIndex[parentRow], 0, quintptr(m_parentRows[parentRow] + 1));
+}
+
+int ProcessTableModel::flatRow(int row, const QModelIndex &parent) const
+{
+    if (!m_treeMode)
+        return !parent.isValid() && row >= 0 && row < m_procIdList.size() ? row : -1;
+    int parentRow = parent.isValid() ? flatRow(parent) : -1;
+    if (parent.isValid() && parentRow < 0)
+        return -1;
+    auto it = m_childRows.constFind(parentRow);
+    if (it == m_childRows.cend() || row < 0 || row >= it->size())
+        return -1;
+    return it->at(row);
+}
+
+QModelIndex ProcessTableModel::indexOf(int row, int column) const
+{
+    if (!m_treeMode)
+        return index(row, column);
+    if (row < 0 || row >= m_parentRows.size())
+        return {};
+    return createIndex(m_childIndex[row], column, quintptr(m_parentRows[row] + 1));
+}
+
+void ProcessTableModel::refreshRow(int row)
+{
+    if (row >= m_rows.size())
+        return;
+    m_rows[row] = makeRow(m_processList[row]);
+    QVector<ProcessRow> none;
+    updateRanks(none);
+}
+
+int ProcessTableModel::rowOf(pid_t pid) const
+{
+    return m_rowIndex.value(pid, -1);
+}
+
+void ProcessTableModel::updateNetTrafficSampled(bool sampled)
+{
+    if (sampled == m_netTrafficSampled)
+        return;
+
+    m_netTrafficSampled = sampled;
+    Q_EMIT headerDataChanged(Qt::Horizontal, kProcessUploadColumn, kProcessDownloadColumn);
 }
 
 // returns the number of rows under the given parent
-int ProcessTableModel::rowCount(const QModelIndex &) const
+int ProcessTableModel::rowCount(const QModelIndex &parent) const
 {
     // qCDebug(app) << "Getting row count:" << m_procIdList.size();
-    return m_procIdList.size();
+    if (!m_treeMode)
+        return parent.isValid() ? 0 : m_procIdList.size();
+    // only the first column has children
+    if (parent.isValid() && parent.column() != 0)
+        return 0;
+    int parentRow = parent.isValid() ? flatRow(parent) : -1;
+    if (parent.isValid() && parentRow < 0)
+        return 0;
+    auto it = m_childRows.constFind(parentRow);
+    return it != m_childRows.cend() ? it->size() : 0;
 }
 
 // returns the number of columns for the children of the given parent
@@ -207,10 +479,14 @@ QVariant ProcessTableModel::headerData(int section, Qt::Orientation orientation,
             // memory column display text
             return QApplication::translate("Process.Table.Header", kProcessVtrMemory);
         case kProcessUploadColumn:
-            // upload column display text
+            // upload column display text, marked while figures are sampled
+            if (m_netTrafficSampled)
+                return QString("%1*").arg(QApplication::translate("Process.Table.Header", kProcessUpload));
             return QApplication::translate("Process.Table.Header", kProcessUpload);
         case kProcessDownloadColumn:
-            // download column display text
+            // download column display text, marked while figures are sampled
+            if (m_netTrafficSampled)
+                return QString("%1*").arg(QApplication::translate("Process.Table.Header", kProcessDownload));
             return QApplication::translate("Process.Table.Header", kProcessDownload);
         case kProcessDiskReadColumn:
             // disk read column display text
@@ -227,9 +503,106 @@ QVariant ProcessTableModel::headerData(int section, Qt::Orientation orientation,
         case kProcessPriorityColumn:
             // priority column display text
             return QApplication::translate("Process.Table.Header", kProcessPriority);
+        case kProcessMemoryGrowthColumn:
+            // memory growth column display text
+            return QApplication::translate("Process.Table.Header", kProcessMemoryGrowth);
+        case kProcessCPUWaitColumn:
+            // cpu wait column display text
+            return QApplication::translate("Process.Table.Header", kProcessCPUWait);
+        case kProcessPSSColumn:
+            // pss column display text
+            return QApplication::translate("Process.Table.Header", kProcessPSS);
+        case kProcessUSSColumn:
+            // uss column display text
+            return QApplication::translate("Process.Table.Header", kProcessUSS);
+        case kProcessSwapColumn:
+            // swap column display text
+            return QApplication::translate("Process.Table.Header", kProcessSwap);
+        case kProcessGPUColumn:
+            // gpu column display text
+            return QApplication::translate("Process.Table.Header", kProcessGPU);
+        case kProcessGPUMemoryColumn:
+            // gpu memory column display text
+            return QApplication::translate("Process.Table.Header", kProcessGPUMemory);
+        case kProcessMinorFaultsColumn:
+            // fault & context switch rate columns display text
+            return QApplication::translate("Process.Table.Header", kProcessMinorFaults);
+        case kProcessMajorFaultsColumn:
+            return QApplication::translate("Process.Table.Header", kProcessMajorFaults);
+        case kProcessVoluntarySwitchesColumn:
+            return QApplication::translate("Process.Table.Header", kProcessVoluntarySwitches);
+        case kProcessInvoluntarySwitchesColumn:
+            return QApplication::translate("Process.Table.Header", kProcessInvoluntarySwitches);
+        case kProcessFDsColumn:
+            // fd & socket count columns display text
+            return QApplication::translate("Process.Table.Header", kProcessFDs);
+        case kProcessSocketsColumn:
+            return QApplication::translate("Process.Table.Header", kProcessSockets);
+        case kProcessIOWaitColumn:
+            // io delay & syscall rate columns display text
+            return QApplication::translate("Process.Table.Header", kProcessIOWait);
+        case kProcessIOPSColumn:
+            return QApplication::translate("Process.Table.Header", kProcessIOPS);
+        case kProcessTcpRttColumn:
+            // tcp health columns display text
+            return QApplication::translate("Process.Table.Header", kProcessTcpRtt);
+        case kProcessTcpRetransColumn:
+            return QApplication::translate("Process.Table.Header", kProcessTcpRetrans);
+        case kProcessMemoryExhaustionColumn:
+            return QApplication::translate("Process.Table.Header", kProcessMemoryExhaustion);
+        case kProcessPowerColumn:
+            return QApplication::translate("Process.Table.Header", kProcessPower);
+        case kProcessWakeupsColumn:
+            return QApplication::translate("Process.Table.Header", kProcessWakeups);
+        case kProcessGuestCPUColumn:
+            return QApplication::translate("Process.Table.Header", kProcessGuestCPU);
+        case kProcessCommandLineColumn:
+            return QApplication::translate("Process.Table.Header", kProcessCommandLine);
         default:
             break;
         }
+    } else if (role == Qt::ToolTipRole) {
+        if (m_netTrafficSampled && (section == kProcessUploadColumn || section == kProcessDownloadColumn))
+            return QApplication::translate("Process.Table.Header", kProcessNetSampled);
+        if (section == kProcessCPUWaitColumn)
+            return QApplication::translate("Process.Table.Header", kProcessCPUWaitTip);
+        if (section == kProcessMajorFaultsColumn)
+            return QApplication::translate("Process.Table.Header", kProcessMajorFaultsTip);
+        if (section == kProcessInvoluntarySwitchesColumn)
+            return QApplication::translate("Process.Table.Header", kProcessInvoluntarySwitchesTip);
+        if (section == kProcessFDsColumn)
+            return QApplication::translate("Process.Table.Header", kProcessFDsTip);
+        if (section == kProcessIOWaitColumn)
+            return QApplication::translate("Process.Table.Header", kProcessIOWaitTip);
+        if (section == kProcessIOPSColumn)
+            return QApplication::translate("Process.Table.Header", kProcessIOPSTip);
+        if (section == kProcessTcpRttColumn)
+            return QApplication::translate("Process.Table.Header", kProcessTcpRttTip);
+        if (section == kProcessTcpRetransColumn)
+            return QApplication::translate("Process.Table.Header", kProcessTcpRetransTip);
+        if (section == kProcessMemoryExhaustionColumn)
+            return QApplication::translate("Process.Table.Header", kProcessMemoryExhaustionTip);
+        if (section == kProcessPowerColumn)
+            return QApplication::translate("Process.Table.Header", kProcessPowerTip);
+        if (section == kProcessWakeupsColumn)
+            return QApplication::translate("Process.Table.Header", kProcessWakeupsTip);
+        if (section == kProcessGuestCPUColumn)
+            return QApplication::translate("Process.Table.Header", kProcessGuestCPUTip);
+        if (section == kProcessPSSColumn || section == kProcessUSSColumn || section == kProcessSwapColumn)
+            return QApplication::translate("Process.Table.Header", kProcessSmapsTip);
+        if (section == kProcessGPUColumn || section == kProcessGPUMemoryColumn) {
+            // device level utilization where the driver exposes it in sysfs
+            QStringList lines {QApplication::translate("Process.Table.Header", kProcessGPUTip)};
+            for (const auto &gpu : core::system::DeviceDB::instance()->snapshot()->gpus) {
+                QString line = QString("%1 (%2)").arg(gpu.name).arg(gpu.driver);
+                if (gpu.hasUsage)
+                    line += QString("  %1%").arg(gpu.usage, 0, 'f', 1);
+                if (gpu.hasMemory)
+                    line += QString("  %1 / %2").arg(formatUnit_memory_disk(gpu.memUsed, KB)).arg(formatUnit_memory_disk(gpu.memTotal, KB));
+                lines << line;
+            }
+            return lines.join('\n');
+        }
     } else if (role == Qt::TextAlignmentRole) {
         qCDebug(app) << "Returning text alignment for header";
         // default header section alignment
@@ -239,7 +612,419 @@ QVariant ProcessTableModel::headerData(int section, Qt::Orientation orientation,
         // sort section descending by default
         return QVariant::fromValue(Qt::DescendingOrder);
     }
-    return QAbstractTableModel::headerData(section, orientation, role);
+    return QAbstractItemModel::headerData(section, orientation, role);
+}
+
+// formatted display text of a process column
+QString ProcessTableModel::exhaustionText(qreal seconds)
+{
+    if (seconds < 0)
+        return QStringLiteral("-");
+    if (seconds < 60)
+        return QApplication::translate("Process.Table.Header", "< 1 min");
+    if (seconds < 3600)
+        return QApplication::translate("Process.Table.Header", "%1 min").arg(qRound(seconds / 60));
+    if (seconds < 48 * 3600)
+        return QApplication::translate("Process.Table.Header", "%1 h").arg(seconds / 3600, 0, 'f', 1);
+    return QApplication::translate("Process.Table.Header", "%1 d").arg(qRound(seconds / 86400));
+}
+
+QString ProcessTableModel::commandLineText(const Process &proc)
+{
+    const QString &text = proc.cmdlineText();
+    if (!text.endsWith(QChar(0x2026)))
+        return text;
+    // a pid taken by another process since or one of a recording doesn't start the same
+    const QString full = Process::readFullCmdline(proc.pid());
+    return full.startsWith(text.left(text.size() - 1)) ? full : text;
+}
+
+QString ProcessTableModel::hungTaskText(const Process &proc)
+{
+    if (!proc.hangSuspected())
+        return {};
+
+    const timeval uptime = proc.procuptime();
+    const int seconds = qRound(uptime.tv_sec + uptime.tv_usec / 1000000. - proc.blockedSince());
+    const QByteArray function = proc.blockingFunction();
+    if (function.isEmpty())
+        return QApplication::translate("Process.Table", "In uninterruptible sleep for %1 s").arg(seconds);
+
+    QString text = QApplication::translate("Process.Table", "Blocked in %1 for %2 s")
+                       .arg(QString::fromLatin1(function))
+                       .arg(seconds);
+    QString wait;
+    switch (proc.blockingWait()) {
+    case core::process::HungTaskSampler::kWaitDisk:
+        wait = QApplication::translate("Process.Table", "waiting on a disk");
+        break;
+    case core::process::HungTaskSampler::kWaitNfs:
+        wait = QApplication::translate("Process.Table", "waiting on an NFS server");
+        break;
+    case core::process::HungTaskSampler::kWaitNetworkFs:
+        wait = QApplication::translate("Process.Table", "waiting on a network file server");
+        break;
+    case core::process::HungTaskSampler::kWaitFuse:
+        wait = QApplication::translate("Process.Table", "waiting on the daemon of a FUSE filesystem");
+        break;
+    case core::process::HungTaskSampler::kWaitMemory:
+        wait = QApplication::translate("Process.Table", "reclaiming memory");
+        break;
+    case core::process::HungTaskSampler::kWaitLock:
+        wait = QApplication::translate("Process.Table", "waiting on a kernel lock held by another task");
+        break;
+    default:
+        return text;
+    }
+    return QString("%1, %2").arg(text).arg(wait);
+}
+
+QString ProcessTableModel::processText(const Process &proc, int column)
+{
+    QString name;
+    switch (column) {
+    case kProcessNameColumn: {
+        // prepended tag based on process state
+        name = proc.displayName();
+        switch (proc.state()) {
+        case 'Z':
+            qCDebug(app) << "Process state is Zombie";
+            name = QString("(%1) %2")
+                           .arg(QApplication::translate("Process.Table", "No response"))
+                           .arg(name);
+            break;
+        case 'T':
+            qCDebug(app) << "Process state is Suspended";
+            name = QString("(%1) %2")
+                           .arg(QApplication::translate("Process.Table", "Suspend"))
+                           .arg(name);
+            break;
+        case 'D':
+            // a moment of io is no hang, only the ones staying in D are tagged
+            if (proc.hangSuspected())
+                name = QString("(%1) %2")
+                               .arg(QApplication::translate("Process.Table", "Blocked"))
+                               .arg(name);
+            break;
+        }
+        return name;
+    }
+    case kProcessCPUColumn:
+        // formated cpu percent utilization
+        return QString("%1%").arg(proc.cpu(), 0, 'f', 1);
+    case kProcessUserColumn:
+        // process's user name
+        return proc.userName();
+    case kProcessMemoryColumn:
+        // formatted memory usage
+        return formatUnit_memory_disk(proc.memory(), KB);
+    case kProcessShareMemoryColumn:
+        // formatted memory usage
+        return formatUnit_memory_disk(proc.sharememory(), KB);
+    case kProcessVTRMemoryColumn:
+        // formatted memory usage
+        return formatUnit_memory_disk(proc.vtrmemory(), KB);
+    case kProcessUploadColumn:
+        // formatted upload speed text
+        return formatUnit_net(8 * proc.sentBps(), B, 1, true);
+    case kProcessDownloadColumn:
+        // formated download speed text
+        return formatUnit_net(8 * proc.recvBps(), B, 1, true);
+    case kProcessDiskReadColumn:
+        // formatted disk read speed text
+        return formatUnit_memory_disk(proc.readBps(), B, 1, true);
+    case kProcessDiskWriteColumn:
+        // formatted disk write speed text
+        return formatUnit_memory_disk(proc.writeBps(), B, 1, true);
+    case kProcessPIDColumn: {
+        // process pid text
+        return QString("%1").arg(proc.pid());
+    }
+    case kProcessNiceColumn: {
+        // process priority text
+        return QString("%1").arg(proc.priority());
+    }
+    case kProcessPriorityColumn: {
+        // process priority enum text representation
+        return getPriorityName(proc.priority());
+    }
+    case kProcessMemoryGrowthColumn: {
+        // formatted memory growth speed, signed
+        qreal growth = proc.memoryGrowth();
+        const QString &speed = formatUnit_memory_disk(qAbs(growth), KB, 1, true);
+        if (growth > 0)
+            return QString("+%1").arg(speed);
+        if (growth < 0)
+            return QString("-%1").arg(speed);
+        return speed;
+    }
+    case kProcessCPUWaitColumn:
+        // run queue wait in percent
+        return QString("%1%").arg(proc.cpuWait(), 0, 'f', 1);
+    case kProcessPSSColumn:
+        // formatted smaps figures, "-" until read
+        return proc.hasSmaps() ? formatUnit_memory_disk(proc.pss(), KB) : QStringLiteral("-");
+    case kProcessUSSColumn:
+        return proc.hasSmaps() ? formatUnit_memory_disk(proc.uss(), KB) : QStringLiteral("-");
+    case kProcessSwapColumn:
+        return proc.hasSmaps() ? formatUnit_memory_disk(proc.swap(), KB) : QStringLiteral("-");
+    case kProcessGPUColumn:
+        // processes without drm clients show "-"
+        return proc.hasGpu() ? QString("%1%").arg(proc.gpuUsage(), 0, 'f', 1) : QStringLiteral("-");
+    case kProcessGPUMemoryColumn:
+        return proc.hasGpu() ? formatUnit_memory_disk(proc.gpuMemory(), KB) : QStringLiteral("-");
+    case kProcessMinorFaultsColumn:
+        // events per second of the last interval
+        return QString("%1/s").arg(qRound64(proc.minorFaultRate()));
+    case kProcessMajorFaultsColumn:
+        return QString("%1/s").arg(qRound64(proc.majorFaultRate()));
+    case kProcessVoluntarySwitchesColumn:
+        return QString("%1/s").arg(qRound64(proc.voluntarySwitchRate()));
+    case kProcessInvoluntarySwitchesColumn:
+        return QString("%1/s").arg(qRound64(proc.involuntarySwitchRate()));
+    case kProcessFDsColumn:
+        // fd dir of other users' processes is not readable, suspected leaks tell their growth
+        if (proc.fdCount() < 0)
+            return QStringLiteral("-");
+        if (proc.fdLeakSuspected())
+            return QString("%1 (+%2/min)").arg(proc.fdCount()).arg(proc.fdGrowth(), 0, 'f', 1);
+        return QString::number(proc.fdCount());
+    case kProcessSocketsColumn:
+        return proc.fdCount() < 0 ? QStringLiteral("-") : QString::number(proc.socketCount());
+    case kProcessIOWaitColumn: {
+        // delays stay 0 when not accounted, tell it apart from a process not waiting
+        static const bool delayAccounting = core::system::TaskStats::isDelayAccountingEnabled();
+        return delayAccounting ? QString("%1%").arg(proc.ioWait(), 0, 'f', 1) : QStringLiteral("-");
+    }
+    case kProcessIOPSColumn:
+        return QString("%1/s").arg(qRound64(proc.ioSyscallRate()));
+    // processes without tcp connections, udp only ones included
+    case kProcessTcpRttColumn:
+        return proc.hasTcpHealth() ? QString("%1 ms").arg(proc.tcpRtt(), 0, 'f', 1) : QStringLiteral("-");
+    case kProcessTcpRetransColumn:
+        return proc.hasTcpHealth() ? QString("%1%").arg(proc.tcpRetransRate(), 0, 'f', 1) : QStringLiteral("-");
+    case kProcessMemoryExhaustionColumn:
+        return exhaustionText(proc.timeToMemoryExhaustion());
+    // cpus without readable RAPL counters
+    case kProcessPowerColumn:
+        return proc.power() >= 0 ? QString("%1 W").arg(proc.power(), 0, 'f', 1) : QStringLiteral("-");
+    // timer wakeups only while traced by the system server
+    case kProcessWakeupsColumn:
+        if (proc.hasTracedWakeups())
+            return QApplication::translate("Process.Table.Header", "%1/s, %2 timer").arg(qRound64(proc.wakeupRate())).arg(qRound64(proc.timerWakeupRate()));
+        return QString("%1/s").arg(qRound64(proc.wakeupRate()));
+    case kProcessGuestCPUColumn:
+        return QString("%1%").arg(proc.guestCpu(), 0, 'f', 1);
+    // prefix of the command line, the full one is read for the tooltip
+    case kProcessCommandLineColumn:
+        return proc.cmdlineText();
+    default:
+        break;
+    }
+    return {};
+}
+
+// numeric sort key of a process column, names & users are ranked separately
+qreal ProcessTableModel::processSortKey(const Process &proc, int column)
+{
+    switch (column) {
+    case kProcessCPUColumn:
+        return proc.cpu();
+    case kProcessMemoryColumn:
+        return proc.memory();
+    case kProcessShareMemoryColumn:
+        return proc.sharememory();
+    case kProcessVTRMemoryColumn:
+        return proc.vtrmemory();
+    case kProcessUploadColumn:
+        return proc.sentBps();
+    case kProcessDownloadColumn:
+        return proc.recvBps();
+    case kProcessDiskReadColumn:
+        return proc.readBps();
+    case kProcessDiskWriteColumn:
+        return proc.writeBps();
+    case kProcessPIDColumn:
+        return proc.pid();
+    case kProcessNiceColumn:
+    case kProcessPriorityColumn:
+        return proc.priority();
+    case kProcessMemoryGrowthColumn:
+        return proc.memoryGrowth();
+    case kProcessCPUWaitColumn:
+        return proc.cpuWait();
+    // processes not read yet sort below empty ones
+    case kProcessPSSColumn:
+        return proc.hasSmaps() ? qreal(proc.pss()) : -1;
+    case kProcessUSSColumn:
+        return proc.hasSmaps() ? qreal(proc.uss()) : -1;
+    case kProcessSwapColumn:
+        return proc.hasSmaps() ? qreal(proc.swap()) : -1;
+    case kProcessGPUColumn:
+        return proc.hasGpu() ? proc.gpuUsage() : -1;
+    case kProcessGPUMemoryColumn:
+        return proc.hasGpu() ? qreal(proc.gpuMemory()) : -1;
+    case kProcessMinorFaultsColumn:
+        return proc.minorFaultRate();
+    case kProcessMajorFaultsColumn:
+        return proc.majorFaultRate();
+    case kProcessVoluntarySwitchesColumn:
+        return proc.voluntarySwitchRate();
+    case kProcessInvoluntarySwitchesColumn:
+        return proc.involuntarySwitchRate();
+    case kProcessFDsColumn:
+        return proc.fdCount();
+    case kProcessSocketsColumn:
+        return proc.fdCount() < 0 ? -1 : proc.socketCount();
+    case kProcessIOWaitColumn:
+        return proc.ioWait();
+    case kProcessIOPSColumn:
+        return proc.ioSyscallRate();
+    case kProcessTcpRttColumn:
+        return proc.hasTcpHealth() ? proc.tcpRtt() : -1;
+    case kProcessTcpRetransColumn:
+        return proc.hasTcpHealth() ? proc.tcpRetransRate() : -1;
+    // soonest first when sorted descending, not growing ones last, suspected leaks above all
+    case kProcessMemoryExhaustionColumn: {
+        qreal seconds = proc.timeToMemoryExhaustion();
+        if (seconds < 0)
+            return -1;
+        return (proc.memoryLeakSuspected() ? 1. : 0.) + 1. / (1. + seconds);
+    }
+    case kProcessPowerColumn:
+        return proc.power();
+    case kProcessWakeupsColumn:
+        return proc.wakeupRate();
+    case kProcessGuestCPUColumn:
+        return proc.guestCpu();
+    // byte order of the first six bytes, exact in a double, equal ones are compared by cpu
+    case kProcessCommandLineColumn: {
+        const QByteArray prefix = proc.cmdlineText().toUtf8().left(6);
+        qreal key = 0;
+        for (int i = 0; i < 6; ++i)
+            key = key * 256 + (i < prefix.size() ? uchar(prefix[i]) : 0);
+        return key;
+    }
+    default:
+        return 0;
+    }
+}
+
+ProcessTableModel::ProcessRow ProcessTableModel::makeRow(const Process &proc)
+{
+    ProcessRow row;
+    for (int column = 0; column < kProcessColumnCount; ++column) {
+        row.text[column] = processText(proc, column);
+        row.key[column] = processSortKey(proc, column);
+    }
+
+    // transliterations are memoized per distinct name
+    QString pinyin;
+    if (QLocale::system().language() == QLocale::Chinese) {
+        const QString &displayName = proc.displayName();
+        pinyin = util::common::convHanToLatin(displayName).toLower().remove(QLatin1Char(' '));
+        // latin names need no pinyin
+        if (pinyin == displayName.toLower())
+            pinyin.clear();
+    }
+    row.search = makeSearchText(proc, row.text[kProcessNameColumn], pinyin);
+    row.appType = proc.appType();
+    return row;
+}
+
+QString ProcessTableModel::makeSearchText(const Process &proc, const QString &displayName, const QString &pinyin)
+{
+    QString search = QString("%1\n%2\n%3\n%4").arg(displayName, proc.name(), QString::number(proc.pid()), proc.userName());
+    if (!pinyin.isEmpty())
+        search.append(QLatin1Char('\n')).append(pinyin);
+    return search.toLower();
+}
+
+QString ProcessTableModel::searchText(int row) const
+{
+    if (row < 0 || row >= m_processList.size())
+        return {};
+    if (row < m_rows.size())
+        return m_rows[row].search;
+    return makeSearchText(m_processList[row], processText(m_processList[row], kProcessNameColumn), {});
+}
+
+qreal ProcessTableModel::sortKey(int row, int column) const
+{
+    if (row < 0 || row >= m_processList.size() || column < 0 || column >= kProcessColumnCount)
+        return 0;
+    if (row < m_rows.size())
+        return m_rows[row].key[column];
+    return processSortKey(m_processList[row], column);
+}
+
+bool ProcessTableModel::isInTab(int row, int filterType) const
+{
+    if (row < 0 || row >= m_processList.size())
+        return false;
+    return isShownIn(filterType, row < m_rows.size() ? m_rows[row].appType : m_processList[row].appType());
+}
+
+void ProcessTableModel::updateRanks(QVector<ProcessRow> &spawned)
+{
+    rankRows(m_nameRanks, m_userRanks, m_rows, spawned);
+}
+
+void ProcessTableModel::rankRows(QHash<QString, int> &nameRanks, QHash<QString, int> &userRanks,
+                                 QVector<ProcessRow> &rows, QVector<ProcessRow> &spawned)
+{
+    // ranks only need rebuilding when a name or user not ranked yet shows up
+    bool ranked = true;
+    auto isRanked = [&](const ProcessRow &row) {
+        return nameRanks.contains(row.text[kProcessNameColumn]) && userRanks.contains(row.text[kProcessUserColumn]);
+    };
+    for (const auto &row : rows)
+        ranked = ranked && isRanked(row);
+    for (const auto &row : spawned)
+        ranked = ranked && isRanked(row);
+
+    if (!ranked) {
+        QSet<QString> names, users;
+        for (const auto &row : rows) {
+            names.insert(row.text[kProcessNameColumn]);
+            users.insert(row.text[kProcessUserColumn]);
+        }
+        for (const auto &row : spawned) {
+            names.insert(row.text[kProcessNameColumn]);
+            users.insert(row.text[kProcessUserColumn]);
+        }
+
+        // names starting with hanzi go after latin ones
+        QVector<QString> sorted(names.begin(), names.end());
+        std::sort(sorted.begin(), sorted.end(), [](const QString &lhs, const QString &rhs) {
+            bool lstartHz = common::startWithHanzi(lhs);
+            bool rstartHz = common::startWithHanzi(rhs);
+            if (lstartHz != rstartHz)
+                return rstartHz;
+            return lhs.localeAwareCompare(rhs) < 0;
+        });
+        nameRanks.clear();
+        for (int i = 0; i < sorted.size(); ++i)
+            nameRanks.insert(sorted[i], i);
+
+        sorted = QVector<QString>(users.begin(), users.end());
+        std::sort(sorted.begin(), sorted.end(), [](const QString &lhs, const QString &rhs) {
+            return lhs.localeAwareCompare(rhs) < 0;
+        });
+        userRanks.clear();
+        for (int i = 0; i < sorted.size(); ++i)
+            userRanks.insert(sorted[i], i);
+        qCDebug(app) << "Ranked" << nameRanks.size() << "names &" << userRanks.size() << "users";
+    }
+
+    auto rank = [&](ProcessRow &row) {
+        row.key[kProcessNameColumn] = nameRanks.value(row.text[kProcessNameColumn]);
+        row.key[kProcessUserColumn] = userRanks.value(row.text[kProcessUserColumn]);
+    };
+    for (auto &row : rows)
+        rank(row);
+    for (auto &row : spawned)
+        rank(row);
 }
 
 // returns the data stored under the given role for the item referred to by the index
@@ -251,12 +1036,12 @@ QVariant ProcessTableModel::data(const QModelIndex &index, int role) const
     }
 
     // validate index
-    if (index.row() < 0 || index.row() >= m_processList.size()) {
+    int row = flatRow(index);
+    if (row < 0 || row >= m_processList.size()) {
         qCDebug(app) << "Index out of bounds, returning empty QVariant";
         return {};
     }
 
-    int row = index.row();
     const Process &proc = m_processList[row];
     if (!proc.isValid()) {
         qCDebug(app) << "Process at row" << row << "is invalid";
@@ -265,69 +1050,14 @@ QVariant ProcessTableModel::data(const QModelIndex &index, int role) const
 
     // qCDebug(app) << "Getting data for row:" << row << "column:" << index.column() << "role:" << role;
     if (role == Qt::DisplayRole || role == Qt::AccessibleTextRole) {
-        QString name;
-        switch (index.column()) {
-        case kProcessNameColumn: {
-            // prepended tag based on process state
-            name = proc.displayName();
-            switch (proc.state()) {
-            case 'Z':
-                qCDebug(app) << "Process state is Zombie";
-                name = QString("(%1) %2")
-                               .arg(QApplication::translate("Process.Table", "No response"))
-                               .arg(name);
-                break;
-            case 'T':
-                qCDebug(app) << "Process state is Suspended";
-                name = QString("(%1) %2")
-                               .arg(QApplication::translate("Process.Table", "Suspend"))
-                               .arg(name);
-                break;
-            }
-            return name;
-        }
-        case kProcessCPUColumn:
-            // formated cpu percent utilization
-            return QString("%1%").arg(proc.cpu(), 0, 'f', 1);
-        case kProcessUserColumn:
-            // process's user name
-            return proc.userName();
-        case kProcessMemoryColumn:
-            // formatted memory usage
-            return formatUnit_memory_disk(proc.memory(), KB);
-        case kProcessShareMemoryColumn:
-            // formatted memory usage
-            return formatUnit_memory_disk(proc.sharememory(), KB);
-        case kProcessVTRMemoryColumn:
-            // formatted memory usage
-            return formatUnit_memory_disk(proc.vtrmemory(), KB);
-        case kProcessUploadColumn:
-            // formatted upload speed text
-            return formatUnit_net(8 * proc.sentBps(), B, 1, true);
-        case kProcessDownloadColumn:
-            // formated download speed text
-            return formatUnit_net(8 * proc.recvBps(), B, 1, true);
-        case kProcessDiskReadColumn:
-            // formatted disk read speed text
-            return formatUnit_memory_disk(proc.readBps(), B, 1, true);
-        case kProcessDiskWriteColumn:
-            // formatted disk write speed text
-            return formatUnit_memory_disk(proc.writeBps(), B, 1, true);
-        case kProcessPIDColumn: {
-            // process pid text
-            return QString("%1").arg(proc.pid());
-        }
-        case kProcessNiceColumn: {
-            // process priority text
-            return QString("%1").arg(proc.priority());
-        }
-        case kProcessPriorityColumn: {
-            // process priority enum text representation
-            return getPriorityName(proc.priority());
-        }
-        default:
-            break;
-        }
+        // texts are formatted once per refresh, rows set without one are formatted here
+        if (row < m_rows.size() && index.column() >= 0 && index.column() < kProcessColumnCount)
+            return m_rows[row].text[index.column()];
+        return processText(proc, index.column());
+    } else if (role == kSortKeyRole) {
+        if (row < m_rows.size() && index.column() >= 0 && index.column() < kProcessColumnCount)
+            return m_rows[row].key[index.column()];
+        return processSortKey(proc, index.column());
     } else if (role == Qt::DecorationRole) {
         switch (index.column()) {
         case kProcessNameColumn:
@@ -363,6 +1093,48 @@ QVariant ProcessTableModel::data(const QModelIndex &index, int role) const
             return proc.writeBps();
         case kProcessNiceColumn:
             return proc.priority();
+        case kProcessMemoryGrowthColumn:
+            return proc.memoryGrowth();
+        case kProcessCPUWaitColumn:
+            return proc.cpuWait();
+        case kProcessPSSColumn:
+            return proc.pss();
+        case kProcessUSSColumn:
+            return proc.uss();
+        case kProcessSwapColumn:
+            return proc.swap();
+        case kProcessGPUColumn:
+            return proc.gpuUsage();
+        case kProcessGPUMemoryColumn:
+            return proc.gpuMemory();
+        case kProcessMinorFaultsColumn:
+            return proc.minorFaultRate();
+        case kProcessMajorFaultsColumn:
+            return proc.majorFaultRate();
+        case kProcessVoluntarySwitchesColumn:
+            return proc.voluntarySwitchRate();
+        case kProcessInvoluntarySwitchesColumn:
+            return proc.involuntarySwitchRate();
+        case kProcessFDsColumn:
+            return proc.fdCount();
+        case kProcessSocketsColumn:
+            return proc.socketCount();
+        case kProcessIOWaitColumn:
+            return proc.ioWait();
+        case kProcessIOPSColumn:
+            return proc.ioSyscallRate();
+        case kProcessTcpRttColumn:
+            return proc.tcpRtt();
+        case kProcessTcpRetransColumn:
+            return proc.tcpRetransRate();
+        case kProcessMemoryExhaustionColumn:
+            return proc.timeToMemoryExhaustion();
+        case kProcessPowerColumn:
+            return proc.power();
+        case kProcessWakeupsColumn:
+            return proc.wakeupRate();
+        case kProcessGuestCPUColumn:
+            return proc.guestCpu();
         default:
             return {};
         }
@@ -386,22 +1158,36 @@ QVariant ProcessTableModel::data(const QModelIndex &index, int role) const
         // text color role based on process's state
         if (index.column() == kProcessNameColumn) {
             char state = proc.state();
-            if (state == 'Z' || state == 'T') {
+            if (state == 'Z' || state == 'T' || (state == 'D' && proc.hangSuspected())) {
                 qCDebug(app) << "Returning warning color for process state:" << state;
                 return QVariant(int(Dtk::Gui::DPalette::TextWarning));
             }
         }
+        if (index.column() == kProcessMemoryExhaustionColumn && proc.memoryLeakSuspected())
+            return QVariant(int(Dtk::Gui::DPalette::TextWarning));
         return {};
     } else if (role == Qt::UserRole + 3) {
         qCDebug(app) << "Returning app type";
         return proc.appType();
     } else if (role == Qt::UserRole + 4) {
-        qCDebug(app) << "Returning cmdline string";
-        QString cmdlineStr = proc.cmdlineString();
-        if (!cmdlineStr.isEmpty())
-            return cmdlineStr;
-        else
-            return QString("%1").arg(proc.name());
+        qCDebug(app) << "Returning icon key";
+        // processes showing the same icon share its rendered pixmaps
+        return proc.iconKey();
+    } else if (role == Qt::ToolTipRole && index.column() == kProcessNameColumn && proc.hangSuspected()) {
+        return hungTaskText(proc);
+    } else if (role == Qt::ToolTipRole && index.column() == kProcessCommandLineColumn) {
+        return commandLineText(proc);
+    } else if (role == Qt::ToolTipRole && m_treeMode) {
+        // usage of the whole subtree, summed by the process tree of the scan
+        if (index.column() != kProcessCPUColumn && index.column() != kProcessMemoryColumn)
+            return {};
+        const ProcessTreeUsage &usage = m_tree.subtreeUsage(proc.pid());
+        if (usage.processes <= 1)
+            return {};
+        const QString &total = index.column() == kProcessCPUColumn
+                                   ? QString("%1%").arg(usage.cpu, 0, 'f', 1)
+                                   : formatUnit_memory_disk(usage.memory, KB);
+        return QApplication::translate("Process.Table", "%1 with %2 child processes").arg(total).arg(usage.processes - 1);
     }
     return {};
 }
@@ -415,6 +1201,8 @@ Qt::ItemFlags ProcessTableModel::flags(const QModelIndex &index) const
     }
 
     qCDebug(app) << "Returning item flags for index";
+    if (m_treeMode)
+        return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
     return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemNeverHasChildren;
 }
 
@@ -422,9 +1210,9 @@ Qt::ItemFlags ProcessTableModel::flags(const QModelIndex &index) const
 ProcessPriority ProcessTableModel::getProcessPriority(pid_t pid) const
 {
     qCDebug(app) << "Getting process priority for PID:" << pid;
-    int row = m_procIdList.indexOf(pid);
+    int row = rowOf(pid);
     if (row >= 0) {
-        int prio = ProcessDB::instance()->processSet()->getProcessById(pid).priority();
+        int prio = m_processList[row].priority();
         qCDebug(app) << "Process found, priority value:" << prio;
         return getProcessPriorityStub(prio);
     }
@@ -436,8 +1224,8 @@ ProcessPriority ProcessTableModel::getProcessPriority(pid_t pid) const
 int ProcessTableModel::getProcessPriorityValue(pid_t pid) const
 {
     qCDebug(app) << "Getting process priority value for PID:" << pid;
-    int row = m_procIdList.indexOf(pid);
-    int priority = row >= 0 ? ProcessDB::instance()->processSet()->getProcessById(pid).priority() : kNormalPriority;
+    int row = rowOf(pid);
+    int priority = row >= 0 ? m_processList[row].priority() : kNormalPriority;
     qCDebug(app) << "Priority value for PID" << pid << "is" << priority;
     return priority;
 }
@@ -446,13 +1234,18 @@ int ProcessTableModel::getProcessPriorityValue(pid_t pid) const
 void ProcessTableModel::removeProcess(pid_t pid)
 {
     qCInfo(app) << "Removing process with PID:" << pid;
-    int row = m_procIdList.indexOf(pid);
+    int row = rowOf(pid);
     if (row >= 0) {
         qCDebug(app) << "Process with PID" << pid << "found at row" << row << ", removing";
-        beginRemoveRows(QModelIndex(), row, row);
-        m_procIdList.removeAt(row);
-        m_processList.removeAt(row);
-        endRemoveRows();
+        if (m_treeMode)
+            beginTreeChange();
+        removeProcessRows(row, row);
+        // rows below moved up
+        m_rowIndex.remove(pid);
+        for (int i = row; i < m_procIdList.size(); ++i)
+            m_rowIndex[m_procIdList[i]] = i;
+        if (m_treeMode)
+            endTreeChange();
         qCInfo(app) << "Process removed successfully";
     } else {
         qCWarning(app) << "Failed to remove process: PID" << pid << "not found";
@@ -463,11 +1256,14 @@ void ProcessTableModel::removeProcess(pid_t pid)
 void ProcessTableModel::updateProcessState(pid_t pid, char state)
 {
     qCInfo(app) << "Updating process state. PID:" << pid << "New state:" << state;
-    int row = m_procIdList.indexOf(pid);
+    int row = rowOf(pid);
     if (row >= 0) {
         qCDebug(app) << "Process with PID" << pid << "found at row" << row << ", updating state";
+        // copies of the published table are shared, detach before writing
+        m_processList[row] = m_processList[row].detached();
         m_processList[row].setState(state);
-        Q_EMIT dataChanged(index(row, 0), index(row, columnCount() - 1));
+        refreshRow(row);
+        Q_EMIT dataChanged(indexOf(row, 0), indexOf(row, columnCount() - 1));
         qCInfo(app) << "Process state updated successfully";
     } else {
         qCWarning(app) << "Failed to update process state: PID" << pid << "not found";
@@ -478,97 +1274,135 @@ void ProcessTableModel::updateProcessState(pid_t pid, char state)
 void ProcessTableModel::updateProcessPriority(pid_t pid, int priority)
 {
     qCInfo(app) << "Updating process priority. PID:" << pid << "New priority:" << priority;
-    int row = m_procIdList.indexOf(pid);
+    int row = rowOf(pid);
     if (row >= 0) {
         qCDebug(app) << "Process with PID" << pid << "found at row" << row << ", updating priority";
+        m_processList[row] = m_processList[row].detached();
         m_processList[row].setPriority(priority);
-        Q_EMIT dataChanged(index(row, 0), index(row, columnCount() - 1));
+        refreshRow(row);
+        Q_EMIT dataChanged(indexOf(row, 0), indexOf(row, columnCount() - 1));
         qCInfo(app) << "Process priority updated successfully";
     } else {
         qCWarning(app) << "Failed to update process priority: PID" << pid << "not found";
     }
 }
 
+void ProcessTableModel::applyControlResult(const QList<pid_t> &pids, int action, int value, const QList<int> &errors)
+{
+    // io priority & affinity aren't shown
+    if (action != PROCESS_CONTROL_SIGNAL && action != PROCESS_CONTROL_RENICE)
+        return;
+
+    QVector<int> rows;
+    for (int i = 0; i < pids.size() && i < errors.size(); ++i) {
+        int row = errors[i] == 0 ? rowOf(pids[i]) : -1;
+        if (row >= 0)
+            rows << row;
+    }
+    if (rows.isEmpty())
+        return;
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    qCInfo(app) << "Applying control result, action" << action << "value" << value << "to" << rows.size() << "rows";
+
+    if (action == PROCESS_CONTROL_SIGNAL && (value == SIGTERM || value == SIGKILL)) {
+        // remove from the bottom up, rows above a range keep their index
+        if (m_treeMode)
+            beginTreeChange();
+        int last = rows.last();
+        int first = last;
+        for (int i = rows.size() - 2; i >= 0; --i) {
+            if (rows[i] == first - 1) {
+                first = rows[i];
+                continue;
+            }
+            removeProcessRows(first, last);
+            first = last = rows[i];
+        }
+        removeProcessRows(first, last);
+
+        m_rowIndex.clear();
+        for (int row = 0; row < m_procIdList.size(); ++row)
+            m_rowIndex.insert(m_procIdList[row], row);
+        if (m_treeMode)
+            endTreeChange();
+        return;
+    }
+
+    for (int row : rows) {
+        m_processList[row] = m_processList[row].detached();
+        if (action == PROCESS_CONTROL_RENICE)
+            m_processList[row].setPriority(value);
+        else if (value == SIGSTOP)
+            m_processList[row].setState('T');
+        else if (value == SIGCONT)
+            m_processList[row].setState('R');
+        if (row < m_rows.size())
+            m_rows[row] = makeRow(m_processList[row]);
+    }
+    QVector<ProcessRow> none;
+    updateRanks(none);
+    if (m_treeMode) {
+        // rows of a batch are under different parents
+        for (int row : rows)
+            Q_EMIT dataChanged(indexOf(row, 0), indexOf(row, columnCount() - 1));
+        return;
+    }
+    Q_EMIT dataChanged(index(rows.first(), 0), index(rows.last(), columnCount() - 1));
+}
+
 void ProcessTableModel::setUserModeName(const QString &userName)
 {
     qCDebug(app) << "Setting user mode name to:" << userName;
     if (userName != m_userModeName) {
         qCInfo(app) << "Changing user mode from" << m_userModeName << "to" << userName;
         m_userModeName = userName;
-        updateProcessListWithUserSpecified();
+        // rows are filtered by uid, the name is looked up once here instead of compared per row
+        m_userModeUid = uid_t(-1);
+        if (!userName.isNull()) {
+            long size = sysconf(_SC_GETPW_R_SIZE_MAX);
+            QByteArray buf(size > 0 ? int(size) : 16384, Qt::Uninitialized);
+            struct passwd pwd;
+            struct passwd *result = nullptr;
+            if (getpwnam_r(userName.toLocal8Bit().constData(), &pwd, buf.data(), size_t(buf.size()), &result) == 0 && result)
+                m_userModeUid = result->pw_uid;
+            else
+                qCWarning(app) << "Failed to look up uid of user" << userName;
+        }
+        updateProcessList();
     }
 }
 
 qreal ProcessTableModel::getTotalCPUUsage()
 {
-    qCDebug(app) << "Calculating total CPU usage";
-    qreal cpuUsage = 0;
-    for (const auto &proc : m_processList) {
-        cpuUsage += proc.cpu();
-    }
-    return cpuUsage;
+    return m_usage.cpu;
 }
 qreal ProcessTableModel::getTotalMemoryUsage()
 {
-    qCDebug(app) << "Calculating total memory usage";
-    qreal memUsage = 0;
-    for (const auto &proc : m_processList) {
-        memUsage += proc.memory();
-    }
-    return memUsage;
+    return m_usage.memory;
 }
 qreal ProcessTableModel::getTotalDownload()
 {
-    qCDebug(app) << "Calculating total download";
-    qreal download = 0;
-    for (const auto &proc : m_processList) {
-        download += proc.recvBps();
-    }
-    return download;
+    return m_usage.recvBps;
 }
 qreal ProcessTableModel::getTotalUpload()
 {
-    qCDebug(app) << "Calculating total upload";
-    qlonglong upload = 0;
-    for (const auto &proc : m_processList) {
-        upload += proc.sentBps();
-    }
-    return upload;
+    return m_usage.sentBps;
 }
 
 qreal ProcessTableModel::getTotalVirtualMemoryUsage()
 {
-    qCDebug(app) << "Calculating total virtual memory usage";
-    qlonglong vtmem = 0;
-    for (const auto &proc : m_processList) {
-        vtmem += proc.vtrmemory();
-    }
-    return vtmem;
+    return m_usage.virtualMemory;
 }
 qreal ProcessTableModel::getTotalSharedMemoryUsage()
 {
-    qCDebug(app) << "Calculating total shared memory usage";
-    qlonglong smem = 0;
-    for (const auto &proc : m_processList) {
-        smem += proc.sharememory();
-    }
-    return smem;
+    return m_usage.shareMemory;
 }
 qreal ProcessTableModel::getTotalDiskRead()
 {
-    qCDebug(app) << "Calculating total disk read";
-    qlonglong diskread = 0;
-    for (const auto &proc : m_processList) {
-        diskread += proc.readBps();
-    }
-    return diskread;
+    return m_usage.readBps;
 }
 qreal ProcessTableModel::getTotalDiskWrite()
 {
-    qCDebug(app) << "Calculating total disk write";
-    qlonglong diskwrite = 0;
-    for (const auto &proc : m_processList) {
-        diskwrite += proc.writeBps();
-    }
-    return diskwrite;
+    return m_usage.writeBps;
 }
@@ -8,9 +8,13 @@
 
 #include "process/process_set.h"
 
-#include <QAbstractTableModel>
+#include <QAbstractItemModel>
+#include <QHash>
 #include <QList>
 #include <QMap>
+#include <QVector>
+
+#include <memory>
 
 // name column display
 constexpr const char *kProcessName = QT_TRANSLATE_NOOP("Process.Table.Header", "Name");
@@ -22,10 +26,84 @@ constexpr const char *kProcessUser = QT_TRANSLATE_NOOP("Process.Table.Header", "
 constexpr const char *kProcessMemory = QT_TRANSLATE_NOOP("Process.Table.Header", "Memory");
 constexpr const char *kProcessShareMemory = QT_TRANSLATE_NOOP("Process.Table.Header", "Shared memory");
 constexpr const char *kProcessVtrMemory = QT_TRANSLATE_NOOP("Process.Table.Header", "Virtual memory");
+// memory growth column display
+constexpr const char *kProcessMemoryGrowth = QT_TRANSLATE_NOOP("Process.Table.Header", "Memory growth");
+// time to memory exhaustion column display
+constexpr const char *kProcessMemoryExhaustion = QT_TRANSLATE_NOOP("Process.Table.Header", "Time to OOM");
+// time to memory exhaustion column tooltip
+constexpr const char *kProcessMemoryExhaustionTip = QT_TRANSLATE_NOOP("Process.Table.Header", "When available memory or the cgroup memory limit runs out if the process keeps growing at its trend of the last minutes, leaking processes are highlighted");
+// power column display
+constexpr const char *kProcessPower = QT_TRANSLATE_NOOP("Process.Table.Header", "Power");
+// power column tooltip
+constexpr const char *kProcessPowerTip = QT_TRANSLATE_NOOP("Process.Table.Header", "Estimated share of the CPU package power by CPU time, from the RAPL energy counters");
+// wakeups column display
+constexpr const char *kProcessWakeups = QT_TRANSLATE_NOOP("Process.Table.Header", "Wakeups");
+// wakeups column tooltip
+constexpr const char *kProcessWakeupsTip = QT_TRANSLATE_NOOP("Process.Table.Header", "Times per second the process was woken from a sleep or wait, keeping CPUs out of idle states. Counted by the kernel with the timer wakeups while DKapture is enabled, estimated from voluntary context switches otherwise");
+// guest cpu column display
+constexpr const char *kProcessGuestCPU = QT_TRANSLATE_NOOP("Process.Table.Header", "Guest CPU");
+// guest cpu column tooltip
+constexpr const char *kProcessGuestCPUTip = QT_TRANSLATE_NOOP("Process.Table.Header", "Time spent running the virtual CPUs of a guest, e.g. by qemu with kvm. Already counted in CPU, on the same base");
+// command line column display
+constexpr const char *kProcessCommandLine = QT_TRANSLATE_NOOP("Process.Table.Header", "Command line");
+// cpu wait column display
+constexpr const char *kProcessCPUWait = QT_TRANSLATE_NOOP("Process.Table.Header", "CPU wait");
+// cpu wait column tooltip
+constexpr const char *kProcessCPUWaitTip = QT_TRANSLATE_NOOP("Process.Table.Header", "Time the process was runnable but waiting for a CPU");
+// proportional set size column display
+constexpr const char *kProcessPSS = QT_TRANSLATE_NOOP("Process.Table.Header", "PSS");
+// unique set size column display
+constexpr const char *kProcessUSS = QT_TRANSLATE_NOOP("Process.Table.Header", "USS");
+// swap column display
+constexpr const char *kProcessSwap = QT_TRANSLATE_NOOP("Process.Table.Header", "Swap");
+// smaps columns tooltip
+constexpr const char *kProcessSmapsTip = QT_TRANSLATE_NOOP("Process.Table.Header", "Refreshed a few processes at a time, processes in view first");
+// gpu column display
+constexpr const char *kProcessGPU = QT_TRANSLATE_NOOP("Process.Table.Header", "GPU");
+// gpu memory column display
+constexpr const char *kProcessGPUMemory = QT_TRANSLATE_NOOP("Process.Table.Header", "GPU memory");
+// gpu columns tooltip
+constexpr const char *kProcessGPUTip = QT_TRANSLATE_NOOP("Process.Table.Header", "Busiest GPU engine & GPU memory of the process, as told by the driver");
+// minor page fault rate column display
+constexpr const char *kProcessMinorFaults = QT_TRANSLATE_NOOP("Process.Table.Header", "Minor faults");
+// major page fault rate column display
+constexpr const char *kProcessMajorFaults = QT_TRANSLATE_NOOP("Process.Table.Header", "Major faults");
+// major page fault rate column tooltip
+constexpr const char *kProcessMajorFaultsTip = QT_TRANSLATE_NOOP("Process.Table.Header", "Page faults per second that had to wait for the disk, high when memory is short");
+// voluntary context switch rate column display
+constexpr const char *kProcessVoluntarySwitches = QT_TRANSLATE_NOOP("Process.Table.Header", "Voluntary switches");
+// involuntary context switch rate column display
+constexpr const char *kProcessInvoluntarySwitches = QT_TRANSLATE_NOOP("Process.Table.Header", "Involuntary switches");
+// involuntary context switch rate column tooltip
+constexpr const char *kProcessInvoluntarySwitchesTip = QT_TRANSLATE_NOOP("Process.Table.Header", "Times per second the process was preempted, high when CPUs are contended");
+// fd count column display
+constexpr const char *kProcessFDs = QT_TRANSLATE_NOOP("Process.Table.Header", "FDs");
+// fd count column tooltip
+constexpr const char *kProcessFDsTip = QT_TRANSLATE_NOOP("Process.Table.Header", "Open file descriptors, the growth per minute is shown when the count keeps growing without ever dropping");
+// socket count column display
+constexpr const char *kProcessSockets = QT_TRANSLATE_NOOP("Process.Table.Header", "Sockets");
+// io wait column display
+constexpr const char *kProcessIOWait = QT_TRANSLATE_NOOP("Process.Table.Header", "IO wait");
+// io wait column tooltip
+constexpr const char *kProcessIOWaitTip = QT_TRANSLATE_NOOP("Process.Table.Header", "Time spent waiting for disk reads, writes & swapin, summed over threads like CPU. Shown as - unless the kernel accounts delays (kernel.task_delayacct)");
+// io operations column display
+constexpr const char *kProcessIOPS = QT_TRANSLATE_NOOP("Process.Table.Header", "IOPS");
+// io operations column tooltip
+constexpr const char *kProcessIOPSTip = QT_TRANSLATE_NOOP("Process.Table.Header", "Read & write syscalls per second, files, pipes & sockets alike");
+// tcp round trip time column display
+constexpr const char *kProcessTcpRtt = QT_TRANSLATE_NOOP("Process.Table.Header", "TCP RTT");
+// tcp round trip time column tooltip
+constexpr const char *kProcessTcpRttTip = QT_TRANSLATE_NOOP("Process.Table.Header", "Smoothed round trip time of the slowest TCP connection of the process");
+// tcp retransmits column display
+constexpr const char *kProcessTcpRetrans = QT_TRANSLATE_NOOP("Process.Table.Header", "Retransmits");
+// tcp retransmits column tooltip
+constexpr const char *kProcessTcpRetransTip = QT_TRANSLATE_NOOP("Process.Table.Header", "Share of the TCP segments sent in the last interval that were retransmitted, high on lossy or congested paths");
 // upload column display
 constexpr const char *kProcessUpload = QT_TRANSLATE_NOOP("Process.Table.Header", "Upload");
 // download column display
 constexpr const char *kProcessDownload = QT_TRANSLATE_NOOP("Process.Table.Header", "Download");
+// upload & download column tooltip while packet capture is sampling
+constexpr const char *kProcessNetSampled = QT_TRANSLATE_NOOP("Process.Table.Header", "Network traffic is heavy, figures are estimated from sampled packets");
 // disk read column display
 constexpr const char *kProcessDiskRead = QT_TRANSLATE_NOOP("Process.Table.Header", "Disk read");
 // disk write column display
@@ -41,8 +119,11 @@ using namespace core::process;
 
 /**
  * @brief Process table model class
+ *
+ * Flat by default. In tree mode rows are nested under their parent process, rows whose parent
+ * isn't shown are top level, so the proxy & view don't change between the two modes.
  */
-class ProcessTableModel : public QAbstractTableModel
+class ProcessTableModel : public QAbstractItemModel
 {
     Q_OBJECT
 
@@ -64,10 +145,91 @@ public:
         kProcessPIDColumn, // pid column index
         kProcessNiceColumn, // nice column index
         kProcessPriorityColumn, // priority column index
+        kProcessMemoryGrowthColumn, // memory growth column index
+        kProcessCPUWaitColumn, // run queue wait column index
+        kProcessPSSColumn, // proportional set size column index
+        kProcessUSSColumn, // unique set size column index
+        kProcessSwapColumn, // swap column index
+        kProcessGPUColumn, // gpu usage column index
+        kProcessGPUMemoryColumn, // gpu memory column index
+        kProcessMinorFaultsColumn, // minor page fault rate column index
+        kProcessMajorFaultsColumn, // major page fault rate column index
+        kProcessVoluntarySwitchesColumn, // voluntary context switch rate column index
+        kProcessInvoluntarySwitchesColumn, // involuntary context switch rate column index
+        kProcessFDsColumn, // open fd count column index
+        kProcessSocketsColumn, // socket fd count column index
+        kProcessIOWaitColumn, // io delay column index
+        kProcessIOPSColumn, // io syscall rate column index
+        kProcessTcpRttColumn, // worst tcp rtt column index
+        kProcessTcpRetransColumn, // tcp retransmit rate column index
+        kProcessMemoryExhaustionColumn, // time to memory exhaustion column index
+        kProcessPowerColumn, // estimated power column index
+        kProcessWakeupsColumn, // wakeup rate column index
+        kProcessGuestCPUColumn, // guest cpu column index
+        kProcessCommandLineColumn, // command line column index
 
         kProcessColumnCount // total number of columns
     };
 
+    // raw sort key of a column as double, names & users as their collation rank
+    static constexpr int kSortKeyRole = Qt::UserRole + 5;
+
+    /**
+     * @brief Display texts & sort keys of a row, made once per refresh instead of on every paint or compare
+     */
+    struct ProcessRow {
+        QString text[kProcessColumnCount];
+        qreal key[kProcessColumnCount] {};
+        QString search; // see searchText()
+        int appType {kNoFilter}; // FilterType of the process
+    };
+    /**
+     * @brief Resource usage summed over the processes of a user, or of all users
+     */
+    struct UserUsage {
+        qreal cpu {}; // percent
+        qreal memory {}; // kB
+        qreal shareMemory {}; // kB
+        qreal virtualMemory {}; // kB
+        qreal recvBps {};
+        qreal sentBps {};
+        qreal readBps {};
+        qreal writeBps {};
+        int processes {};
+    };
+    /**
+     * @brief Rows of one process scan, prepared on the monitor thread & never written once published
+     */
+    struct RowTable {
+        QList<Process> procs; // detached copies, in sampling order
+        QVector<ProcessRow> rows; // parallel to procs, name & user keys ranked
+        QHash<pid_t, int> index; // pid -> row
+        QHash<uid_t, QVector<int>> uidRows; // uid -> rows
+        QHash<uid_t, UserUsage> userUsages; // uid -> usage, cpu & memory from user-<uid>.slice when sampled
+        UserUsage totalUsage;
+        QHash<QString, int> nameRanks;
+        QHash<QString, int> userRanks;
+        bool netTrafficSampled {false};
+        ProcessTree tree; // of the scan, links & subtree usage
+    };
+    /**
+     * @brief Build the row table of \a procs, safe to run on any thread
+     * @param procs Valid processes, detached from the process set
+     * @param netTrafficSampled Whether network figures of the scan are estimated
+     * @param nameRanks Name ranks of the previous build, rebuilt when unranked names show up
+     * @param userRanks User ranks of the previous build, same as \a nameRanks
+     * @param sliceStats Sampler of user slices, per user usage is summed from the rows only when null
+     * @param tree Process tree of the scan, subtree usage of tree mode
+     */
+    static std::shared_ptr<const RowTable> makeRowTable(const QList<Process> &procs, bool netTrafficSampled,
+                                                        QHash<QString, int> &nameRanks, QHash<QString, int> &userRanks,
+                                                        common::cgroup::CgroupStats *sliceStats = nullptr,
+                                                        const ProcessTree &tree = ProcessTree());
+    /**
+     * @brief Whole command line of a truncated one, read from /proc only when asked for
+     */
+    static QString commandLineText(const Process &proc);
+
     /**
      * @brief Model constructor
      * @param parent Parent object
@@ -75,11 +237,21 @@ public:
     explicit ProcessTableModel(QObject *parent = nullptr, const QString &username = nullptr);
 
     /**
-     * @brief Update process model with the data provided by list
-     * @param list Process entry list
+     * @brief Update process model with the rows prepared from the last scan
      */
     void updateProcessList();
 
+    /**
+     * @brief Nest rows under their parent process, or list them flat
+     */
+    void setTreeMode(bool enabled);
+    inline bool treeMode() const
+    {
+        return m_treeMode;
+    }
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = {}) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
     /**
      * @brief Returns the number of rows under the given parent
      * @param parent Parent index
@@ -141,6 +313,14 @@ public:
      * @return Process entry item
      */
     Process getProcess(pid_t pid) const;
+    /**
+     * @brief Pid of a row of this model, 0 if out of range
+     */
+    inline pid_t pidOf(const QModelIndex &index) const
+    {
+        int row = index.isValid() ? flatRow(index) : -1;
+        return row >= 0 && row < m_procIdList.size() ? m_procIdList[row] : 0;
+    }
    void setUserModeName(const QString &userName);
     qreal getTotalCPUUsage();
     qreal getTotalMemoryUsage();
@@ -150,6 +330,26 @@ public:
     qreal getTotalSharedMemoryUsage();
     qreal getTotalDiskRead();
     qreal getTotalDiskWrite();
+    /**
+     * @brief Lowercased search index of a row: display name, name, pid, user & pinyin of the display name,
+     * fields separated by newlines so a plain substring never matches across them
+     * @param row Row in this model
+     */
+    QString searchText(int row) const;
+    /**
+     * @brief Sort key of a row in \a column, the same as kSortKeyRole without going through QVariant
+     * @param row Row in this model
+     */
+    qreal sortKey(int row, int column) const;
+    /**
+     * @brief Whether a row is listed in the tab of \a filterType, see isShownIn()
+     * @param row Row in this model
+     */
+    bool isInTab(int row, int filterType) const;
+    /**
+     * @brief Row in this model's lists of \a row under \a parent, the same in flat mode, -1 if out of range
+     */
+    int flatRow(int row, const QModelIndex &parent) const;
 
 Q_SIGNALS:
     /**
@@ -175,15 +375,105 @@ private Q_SLOTS:
      * @param priority Process priority
      */
     void updateProcessPriority(pid_t pid, int priority);
+    /**
+     * @brief Apply a controlProcesses batch at once: ended processes are removed in contiguous ranges,
+     * states & priorities of the others updated with a single dataChanged
+     * @param pids Processes of the batch
+     * @param action process_control_action_t
+     * @param value Signal, nice or ioprio of the batch
+     * @param errors errno of each pid, only the ones that succeeded are applied
+     */
+    void applyControlResult(const QList<pid_t> &pids, int action, int value, const QList<int> &errors);
 
-    void updateProcessListDelay();
-
-    void updateProcessListWithUserSpecified();
 private:
+    /**
+     * @brief Follow sampling state of packet capture, network column headers are marked while sampling
+     * @param sampled Whether network figures of the applied scan are estimated
+     */
+    void updateNetTrafficSampled(bool sampled);
+    /**
+     * @brief Diff rows against \a table: ended processes are removed & new ones appended in contiguous
+     * ranges, the others updated in place with a single dataChanged, so the proxy resorts once per update
+     * @param table Prepared rows, only those of the user mode name if set
+     */
+    void applyRowTable(const std::shared_ptr<const RowTable> &table);
+    /**
+     * @brief Per user usage of \a table: cpu & memory of user-<uid>.slice replace the sums of the rows
+     * once the slice has been sampled twice, the slice also holds exited & kernel-accounted memory
+     */
+    static void sampleUserSlices(RowTable &table, common::cgroup::CgroupStats &sliceStats);
+    /**
+     * @brief Remove rows first to last, row index is rebuilt by the caller
+     */
+    void removeProcessRows(int first, int last);
+    /**
+     * @brief Row of the process with specified pid, -1 if not in the model
+     */
+    int rowOf(pid_t pid) const;
+    inline int flatRow(const QModelIndex &index) const
+    {
+        return m_treeMode ? flatRow(index.row(), parent(index)) : index.row();
+    }
+    /**
+     * @brief Index of a row of this model's lists, nested under its parent in tree mode
+     */
+    QModelIndex indexOf(int row, int column) const;
+    /**
+     * @brief Wrap changes of rows in tree mode, rows may move to other parents
+     *
+     * The layout is rebuilt once, persistent indexes (expanded & selected rows) follow their pid.
+     * Rows are not inserted or removed one range at a time then.
+     */
+    void beginTreeChange();
+    void endTreeChange();
+    /**
+     * @brief Nest rows under the row of their ppid, processes in ppid loops are top level
+     */
+    void rebuildTree();
+
+    static QString processText(const Process &proc, int column);
+    static qreal processSortKey(const Process &proc, int column);
+    /**
+     * @brief Readable time to memory exhaustion, e.g. 3.5 h, "-" if not growing
+     */
+    static QString exhaustionText(qreal seconds);
+    /**
+     * @brief What a hung process waits on, from the kernel function it blocks in, empty if not hung
+     */
+    static QString hungTaskText(const Process &proc);
+    static ProcessRow makeRow(const Process &proc);
+    static QString makeSearchText(const Process &proc, const QString &displayName, const QString &pinyin);
+    /**
+     * @brief Set name & user sort keys, collation ranks are rebuilt only when unranked texts show up
+     * @param rows Rows ranked so far
+     * @param spawned Rows about to be added
+     */
+    static void rankRows(QHash<QString, int> &nameRanks, QHash<QString, int> &userRanks,
+                         QVector<ProcessRow> &rows, QVector<ProcessRow> &spawned);
+    void updateRanks(QVector<ProcessRow> &spawned);
+    /**
+     * @brief Remake cached row after a state or priority change
+     */
+    void refreshRow(int row);
+
     QList<pid_t> m_procIdList; // pid list
     QList<Process> m_processList; // pid list
+    QHash<pid_t, int> m_rowIndex; // pid -> row
+    QVector<ProcessRow> m_rows; // cached texts & keys, parallel to m_processList
+    QHash<QString, int> m_nameRanks; // display name -> collation rank
+    QHash<QString, int> m_userRanks; // user name -> collation rank
+    bool m_netTrafficSampled {false};
+
+    bool m_treeMode {false};
+    ProcessTree m_tree; // of the applied table, subtree usage shown in tree mode
+    QVector<int> m_parentRows; // parent row of each row, -1 at top level
+    QVector<int> m_childIndex; // row under its parent of each row
+    QHash<int, QVector<int>> m_childRows; // rows nested under each row, -1 for the top level
+    QList<pid_t> m_persistentPids; // see beginTreeChange()
 
     QString m_userModeName {};
+    uid_t m_userModeUid {}; // uid of m_userModeName, resolved once when it's set
+    UserUsage m_usage; // usage of the shown user, or of all users
 };
 
 #endif  // PROCESS_TABLE_MODEL_H
@@ -0,0 +1,230 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "process_thread_model.h"
+#include "ddlog.h"
+#include "common/proc_parser.h"
+
+#include <QApplication>
+
+#include <algorithm>
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace DDLog;
+using namespace common::parser;
+using namespace core::process;
+
+ProcessThreadModel::ProcessThreadModel(pid_t pid, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_pid(pid)
+    , m_fdCache(pid)
+{
+    qCDebug(app) << "ProcessThreadModel constructor for pid:" << pid;
+    long hz = sysconf(_SC_CLK_TCK);
+    m_clockTicks = hz > 0 ? hz : 100;
+    m_clock.start();
+}
+
+bool ProcessThreadModel::parseTaskStat(const char *buf, size_t len, task_stat_t &stat)
+{
+    const char *comm = nullptr;
+    const char *rest = nullptr;
+    size_t commLen = 0;
+    if (!splitStatComm(buf, len, comm, commLen, rest))
+        return false;
+
+    // field 3 (state) onwards, utime & stime are fields 14 & 15, processor is field 39
+    Tokenizer tok(rest, size_t(buf + len - rest));
+    unsigned long long utime = 0, stime = 0;
+    int processor = -1;
+    if (!tok.readChar(stat.state) || !tok.skipTokens(10) || !tok.readU64(utime) || !tok.readU64(stime)
+        || !tok.skipTokens(23) || !tok.readInt(processor))
+        return false;
+
+    stat.name = QString::fromUtf8(comm, int(commLen));
+    stat.ticks = utime + stime;
+    stat.processor = processor;
+    return true;
+}
+
+bool ProcessThreadModel::parseSchedStat(const char *buf, size_t len, unsigned long long &wtime)
+{
+    // on cpu time, run queue wait time, timeslices
+    Tokenizer tok(buf, len);
+    return tok.skipTokens(1) && tok.readU64(wtime);
+}
+
+QString ProcessThreadModel::stateText(char state)
+{
+    switch (state) {
+    case 'R':
+        return QApplication::translate("Process.Thread.State", "Running");
+    case 'S':
+        return QApplication::translate("Process.Thread.State", "Sleeping");
+    case 'D':
+        return QApplication::translate("Process.Thread.State", "Uninterruptible");
+    case 'T':
+    case 't':
+        return QApplication::translate("Process.Thread.State", "Stopped");
+    case 'Z':
+        return QApplication::translate("Process.Thread.State", "Zombie");
+    case 'I':
+        return QApplication::translate("Process.Thread.State", "Idle");
+    default:
+        return QString(QChar(state));
+    }
+}
+
+void ProcessThreadModel::refresh()
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/task", m_pid);
+    DIR *dir = opendir(path);
+    QList<thread_t> threads;
+    QHash<pid_t, sample_t> samples;
+    if (dir) {
+        qint64 now = m_clock.elapsed();
+        samples.reserve(m_samples.size());
+        char buf[1024];
+        struct dirent *entry;
+        while ((entry = readdir(dir))) {
+            if (!isDigit(entry->d_name[0]))
+                continue;
+            pid_t tid = pid_t(atoi(entry->d_name));
+
+            thread_t thread {};
+            thread.tid = tid;
+            ssize_t nr = m_fdCache.read(tid, ProcFdCache::kStatFile, buf, sizeof(buf));
+            if (nr <= 0 || !parseTaskStat(buf, size_t(nr), thread.stat))
+                continue;
+            nr = m_fdCache.read(tid, ProcFdCache::kSchedStatFile, buf, sizeof(buf));
+            bool hasWait = nr > 0 && parseSchedStat(buf, size_t(nr), thread.stat.wtime);
+
+            // threads started since the previous refresh have no base to diff against
+            auto it = m_samples.constFind(tid);
+            if (it != m_samples.constEnd() && now > it->msecs) {
+                qreal secs = (now - it->msecs) / 1000.;
+                if (thread.stat.ticks >= it->ticks) {
+                    thread.cpu = qreal(thread.stat.ticks - it->ticks) * 100. / m_clockTicks / secs;
+                    thread.hasRate = true;
+                }
+                if (hasWait && it->hasWait && thread.stat.wtime >= it->wtime) {
+                    thread.wait = qreal(thread.stat.wtime - it->wtime) / 1e7 / secs;
+                    thread.hasWait = true;
+                }
+            }
+            samples.insert(tid, {now, thread.stat.ticks, thread.stat.wtime, hasWait});
+            threads << thread;
+        }
+        closedir(dir);
+    }
+
+    // close the fds of exited threads
+    for (auto it = m_samples.cbegin(); it != m_samples.cend(); ++it) {
+        if (!samples.contains(it.key()))
+            m_fdCache.release(it.key());
+    }
+    m_samples.swap(samples);
+
+    // busiest threads first
+    std::stable_sort(threads.begin(), threads.end(), [](const thread_t &a, const thread_t &b) {
+        return a.cpu != b.cpu ? a.cpu > b.cpu : a.tid < b.tid;
+    });
+
+    beginResetModel();
+    m_threads = threads;
+    endResetModel();
+}
+
+void ProcessThreadModel::stop()
+{
+    m_fdCache.clear();
+    m_samples.clear();
+}
+
+int ProcessThreadModel::rowCount(const QModelIndex &) const
+{
+    return m_threads.size();
+}
+
+int ProcessThreadModel::columnCount(const QModelIndex &) const
+{
+    return kThreadColumnCount;
+}
+
+QVariant ProcessThreadModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && (role == Qt::DisplayRole || role == Qt::AccessibleTextRole)) {
+        switch (section) {
+        case kThreadIdColumn:
+            return QApplication::translate("Process.Thread.Header", kThreadId);
+        case kThreadNameColumn:
+            return QApplication::translate("Process.Thread.Header", kThreadName);
+        case kThreadCPUColumn:
+            return QApplication::translate("Process.Thread.Header", kThreadCPU);
+        case kThreadStateColumn:
+            return QApplication::translate("Process.Thread.Header", kThreadState);
+        case kThreadProcessorColumn:
+            return QApplication::translate("Process.Thread.Header", kThreadProcessor);
+        case kThreadWaitColumn:
+            return QApplication::translate("Process.Thread.Header", kThreadWait);
+        default:
+            break;
+        }
+    } else if (orientation == Qt::Horizontal && role == Qt::ToolTipRole) {
+        if (section == kThreadCPUColumn)
+            return QApplication::translate("Process.Thread.Header", "Percent of one CPU");
+        if (section == kThreadWaitColumn)
+            return QApplication::translate("Process.Thread.Header", "Time the thread was runnable but waiting for a CPU");
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+QVariant ProcessThreadModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_threads.size())
+        return {};
+
+    const auto &thread = m_threads[index.row()];
+    if (role == Qt::DisplayRole || role == Qt::AccessibleTextRole) {
+        switch (index.column()) {
+        case kThreadIdColumn:
+            return QString::number(thread.tid);
+        case kThreadNameColumn:
+            return thread.stat.name;
+        case kThreadCPUColumn:
+            return thread.hasRate ? QString("%1%").arg(thread.cpu, 0, 'f', 1) : QStringLiteral("-");
+        case kThreadStateColumn:
+            return stateText(thread.stat.state);
+        case kThreadProcessorColumn:
+            return thread.stat.processor >= 0 ? QString::number(thread.stat.processor) : QStringLiteral("-");
+        case kThreadWaitColumn:
+            return thread.hasWait ? QString("%1%").arg(thread.wait, 0, 'f', 1) : QStringLiteral("-");
+        default:
+            break;
+        }
+    } else if (role == Qt::UserRole) {
+        switch (index.column()) {
+        case kThreadIdColumn:
+            return thread.tid;
+        case kThreadCPUColumn:
+            return thread.cpu;
+        case kThreadProcessorColumn:
+            return thread.stat.processor;
+        case kThreadWaitColumn:
+            return thread.wait;
+        default:
+            return index.data(Qt::DisplayRole);
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return {};
+}
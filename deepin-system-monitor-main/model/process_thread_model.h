@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_THREAD_MODEL_H
+#define PROCESS_THREAD_MODEL_H
+
+#include "process/proc_fd_cache.h"
+
+#include <QAbstractTableModel>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+
+// thread id column display
+constexpr const char *kThreadId = QT_TRANSLATE_NOOP("Process.Thread.Header", "TID");
+// thread name column display
+constexpr const char *kThreadName = QT_TRANSLATE_NOOP("Process.Thread.Header", "Name");
+// cpu column display
+constexpr const char *kThreadCPU = QT_TRANSLATE_NOOP("Process.Thread.Header", "CPU");
+// state column display
+constexpr const char *kThreadState = QT_TRANSLATE_NOOP("Process.Thread.Header", "State");
+// last cpu column display
+constexpr const char *kThreadProcessor = QT_TRANSLATE_NOOP("Process.Thread.Header", "Last CPU");
+// run queue wait column display
+constexpr const char *kThreadWait = QT_TRANSLATE_NOOP("Process.Thread.Header", "Run queue wait");
+
+/**
+ * @brief Threads of a single process with their cpu usage & run queue wait
+ *
+ * /proc/[pid]/task/[tid]/stat & schedstat are only read on refresh(), through a fd cache of the
+ * process' threads, so nothing is sampled per thread unless the threads of a process are shown.
+ */
+class ProcessThreadModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        kThreadIdColumn = 0,
+        kThreadNameColumn,
+        kThreadCPUColumn,
+        kThreadStateColumn,
+        kThreadProcessorColumn,
+        kThreadWaitColumn,
+
+        kThreadColumnCount
+    };
+
+    /**
+     * @brief Fields of /proc/[pid]/task/[tid]/stat & schedstat
+     */
+    struct task_stat_t {
+        QString name;
+        char state {'\0'};
+        unsigned long long ticks {0}; // utime + stime
+        int processor {-1};
+        unsigned long long wtime {0}; // run queue wait, ns
+    };
+
+    explicit ProcessThreadModel(pid_t pid, QObject *parent = nullptr);
+
+    /**
+     * @brief Rescan threads of the process & update their rates
+     */
+    void refresh();
+    /**
+     * @brief Close the thread fds & drop rates
+     */
+    void stop();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Parse name, state, utime + stime & processor of a task stat
+     */
+    static bool parseTaskStat(const char *buf, size_t len, task_stat_t &stat);
+    /**
+     * @brief Parse run queue wait of a task schedstat, missing without CONFIG_SCHED_INFO
+     */
+    static bool parseSchedStat(const char *buf, size_t len, unsigned long long &wtime);
+    /**
+     * @brief Readable state of a stat state letter
+     */
+    static QString stateText(char state);
+
+private:
+    struct thread_t {
+        pid_t tid;
+        task_stat_t stat;
+        qreal cpu; // % of one cpu
+        qreal wait; // % of the interval spent runnable but waiting for a cpu
+        bool hasRate;
+        bool hasWait;
+    };
+    struct sample_t {
+        qint64 msecs;
+        unsigned long long ticks;
+        unsigned long long wtime;
+        bool hasWait;
+    };
+
+    pid_t m_pid;
+    core::process::ProcFdCache m_fdCache;
+    QList<thread_t> m_threads {};
+    // previous sample by tid
+    QHash<pid_t, sample_t> m_samples {};
+    QElapsedTimer m_clock;
+    long m_clockTicks;
+};
+
+#endif // PROCESS_THREAD_MODEL_H
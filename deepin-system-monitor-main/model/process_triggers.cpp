@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "process_triggers.h"
+
+void ProcessTriggers::setRules(const rules_t &rules)
+{
+    m_rules = rules;
+    m_states.clear();
+}
+
+QVector<ProcessTriggers::match_t> ProcessTriggers::evaluate(const ProcessTableModel::RowTable &table, qint64 now)
+{
+    QVector<match_t> matches;
+    QHash<ProcessKey, state_t> states;
+    states.reserve(table.procs.size());
+
+    for (int i = 0; i < table.procs.size() && i < table.rows.size(); ++i) {
+        const Process &proc = table.procs[i];
+        const qreal *key = table.rows[i].key;
+        qreal cpu = key[ProcessTableModel::kProcessCPUColumn];
+        qreal memory = key[ProcessTableModel::kProcessMemoryColumn];
+
+        ProcessKey processKey {proc.pid(), proc.startTimeTicks()};
+        auto it = m_states.constFind(processKey);
+        state_t state;
+        if (it != m_states.constEnd()) {
+            state = *it;
+        } else {
+            state.windowStart = now;
+            state.windowMemory = memory;
+        }
+
+        int rules = 0;
+        if (cpu >= m_rules.cpuPercent) {
+            if (state.cpuSince < 0)
+                state.cpuSince = now;
+            if (now - state.cpuSince >= m_rules.cpuDuration)
+                rules |= kCpuRule;
+        } else {
+            state.cpuSince = -1;
+        }
+
+        // growth is measured in consecutive windows, each from the memory at its start
+        if (now - state.windowStart >= kGrowthWindow) {
+            state.windowStart = now;
+            state.windowMemory = memory;
+        } else if (memory - state.windowMemory >= m_rules.memoryGrowth) {
+            rules |= kMemoryGrowthRule;
+        }
+
+        if (rules)
+            matches.append({processKey, rules});
+        states.insert(processKey, state);
+    }
+    m_states.swap(states);
+    return matches;
+}
@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_TRIGGERS_H
+#define PROCESS_TRIGGERS_H
+
+#include "process_table_model.h"
+
+#include <QHash>
+#include <QPair>
+#include <QVector>
+
+/**
+ * @brief Recording time rules over the rows of each process scan, matching processes are watched closely
+ *
+ * Rules are predicates over the cpu & memory sort keys of the rows, a scan costs a hash lookup
+ * per process, nothing is read from /proc here.
+ */
+class ProcessTriggers
+{
+public:
+    enum Rule {
+        kCpuRule = 0x1, // cpu above cpuPercent for cpuDuration
+        kMemoryGrowthRule = 0x2, // memory grown by memoryGrowth within a minute
+    };
+
+    struct rules_t {
+        qreal cpuPercent {90};
+        qint64 cpuDuration {30 * 1000}; // ms
+        qreal memoryGrowth {1024 * 1024}; // kB per minute
+    };
+
+    using ProcessKey = QPair<pid_t, qulonglong>; // pid & start time tell reused pids apart
+
+    struct match_t {
+        ProcessKey key;
+        int rules; // Rule flags
+    };
+
+    // memory growth is measured over windows of this span, ms
+    static constexpr qint64 kGrowthWindow = 60 * 1000;
+
+    void setRules(const rules_t &rules);
+    inline const rules_t &rules() const { return m_rules; }
+
+    /**
+     * @brief Processes of the scan matching a rule, every scan for as long as they do
+     * @param now Time of the scan, ms
+     */
+    QVector<match_t> evaluate(const ProcessTableModel::RowTable &table, qint64 now);
+
+private:
+    struct state_t {
+        qint64 cpuSince {-1}; // first scan of the current run above cpuPercent
+        qint64 windowStart {0};
+        qreal windowMemory {0}; // memory at windowStart, kB
+    };
+
+    rules_t m_rules;
+    QHash<ProcessKey, state_t> m_states; // processes of the previous scan
+};
+
+#endif // PROCESS_TRIGGERS_H
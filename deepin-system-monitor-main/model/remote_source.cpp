@@ -0,0 +1,352 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "remote_source.h"
+#include "model_manager.h"
+#include "process_row_preparer.h"
+#include "process_table_model.h"
+#include "update_coordinator.h"
+#include "ddlog.h"
+#include "remote_agent.h"
+#include "process/process_set.h"
+#include "system/device_db.h"
+#include "system/device_snapshot.h"
+
+#include <QDataStream>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QSocketNotifier>
+#include <QUrl>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace DDLog;
+using namespace core::system;
+using namespace core::process;
+
+// read size of the agent socket
+const int kReadChunk = 64 * 1024;
+
+RemoteSource::RemoteSource(const QString &target, QObject *parent)
+    : QObject(parent)
+    , m_target(target.trimmed())
+{
+    qCDebug(app) << "RemoteSource constructor" << m_target;
+}
+
+RemoteSource::~RemoteSource()
+{
+    if (m_ssh) {
+        m_ssh->disconnect(this);
+        m_ssh->kill();
+        m_ssh->waitForFinished(1000);
+    }
+    if (m_fd >= 0)
+        close(m_fd);
+}
+
+bool RemoteSource::parseTarget(const QString &target, QString &sshDestination, QString &address, int &port)
+{
+    sshDestination.clear();
+    address.clear();
+    port = 0;
+    const QString text = target.trimmed();
+    if (text.startsWith("tcp://")) {
+        QUrl url(text);
+        if (!url.isValid() || url.host().isEmpty() || url.port() <= 0)
+            return false;
+        address = url.host();
+        port = url.port();
+        return true;
+    }
+
+    QString destination = text.startsWith("ssh://") ? text.mid(6) : text;
+    // whitespace or a leading dash would be taken as ssh options
+    if (destination.isEmpty() || destination.startsWith('-') || destination.contains(QRegularExpression("\\s")))
+        return false;
+    sshDestination = text.startsWith("ssh://") ? text : destination;
+    return true;
+}
+
+QStringList RemoteSource::sshArguments(const QString &destination, int interval)
+{
+    // batch mode, a password prompt has no terminal to go to
+    return {"-T", "-o", "BatchMode=yes", "-o", "ServerAliveInterval=15", destination,
+            "deepin-system-monitor", "--headless", "--agent", "--interval", QString::number(interval)};
+}
+
+int RemoteSource::nextFrame(const QByteArray &buffer, int &pos, remote_frame_header_t &hdr, QByteArray &payload)
+{
+    if (buffer.size() - pos < int(sizeof(hdr)))
+        return 0;
+    memcpy(&hdr, buffer.constData() + pos, sizeof(hdr));
+    if (hdr.magic != REMOTE_AGENT_MAGIC || hdr.length > REMOTE_AGENT_MAX_FRAME)
+        return -1;
+    if (buffer.size() - pos - int(sizeof(hdr)) < int(hdr.length))
+        return 0;
+
+    // a copy of its own, records are read in place & need the allocation's alignment
+    payload = buffer.mid(pos + int(sizeof(hdr)), int(hdr.length));
+    pos += int(sizeof(hdr)) + int(hdr.length);
+    if (hdr.flags & REMOTE_FRAME_COMPRESSED) {
+        payload = qUncompress(payload);
+        if (payload.isEmpty())
+            return -1;
+    }
+    return 1;
+}
+
+bool RemoteSource::decodeSystem(const QByteArray &payload, CPUSet &cpuSet, DeviceSnapshot &snapshot)
+{
+    QDataStream in(payload);
+    in.setVersion(RemoteAgent::kStreamVersion);
+    cpuSet.loadStats(in);
+    snapshot.cpuSet = cpuSet;
+    snapshot.memInfo.load(in);
+    in >> snapshot.diskReadBps >> snapshot.diskWriteBps >> snapshot.netRecvBps >> snapshot.netSentBps
+       >> snapshot.netTotalRecvBytes >> snapshot.netTotalSentBytes;
+    // stall rates, missing from agents before they were streamed
+    for (int i = 0; i < common::pressure::kPressureResourceCount && !in.atEnd(); ++i) {
+        common::pressure::pressure_t &pressure = snapshot.pressure[i];
+        in >> pressure.valid >> pressure.hasRates >> pressure.someRate >> pressure.fullRate;
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+bool RemoteSource::start()
+{
+    QString destination, address;
+    int port = 0;
+    if (!parseTarget(m_target, destination, address, port)) {
+        qCWarning(app) << "Not a remote target:" << m_target;
+        return false;
+    }
+
+    if (!destination.isEmpty()) {
+        m_ssh = new QProcess(this);
+        m_ssh->start("ssh", sshArguments(destination));
+        connect(m_ssh, &QProcess::readyReadStandardOutput, this, [this]() {
+            feed(m_ssh->readAllStandardOutput());
+        });
+        connect(m_ssh, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [this](int code) {
+            const QString error = QString::fromLocal8Bit(m_ssh->readAllStandardError()).trimmed().section('\n', -1);
+            fail(error.isEmpty() ? tr("ssh exited with code %1").arg(code) : error);
+        });
+        connect(m_ssh, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart)
+                fail(tr("ssh could not be started"));
+        });
+        qCInfo(app) << "Attaching to remote agent over ssh" << destination;
+        return true;
+    }
+
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(quint16(port));
+    const QByteArray host = (address == "localhost" ? QString("127.0.0.1") : address).toLatin1();
+    if (inet_pton(AF_INET, host.constData(), &addr.sin_addr) != 1) {
+        qCWarning(app) << "Remote agent address is not an IPv4 address:" << address;
+        return false;
+    }
+    m_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_fd < 0 || ::connect(m_fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0) {
+        qCWarning(app) << "Failed to connect to remote agent" << m_target << ":" << strerror(errno);
+        if (m_fd >= 0)
+            close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+    fcntl(m_fd, F_SETFL, fcntl(m_fd, F_GETFL) | O_NONBLOCK);
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &RemoteSource::readSocket);
+    qCInfo(app) << "Attached to remote agent at" << m_target;
+    return true;
+}
+
+void RemoteSource::readSocket()
+{
+    char buf[kReadChunk];
+    for (;;) {
+        ssize_t n = read(m_fd, buf, sizeof(buf));
+        if (n > 0) {
+            if (!feed(QByteArray(buf, int(n))))
+                return;
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EINTR))
+            return;
+        fail(n == 0 ? tr("The remote agent closed the connection") : QString::fromLocal8Bit(strerror(errno)));
+        return;
+    }
+}
+
+void RemoteSource::fail(const QString &error)
+{
+    if (m_failed)
+        return;
+    m_failed = true;
+    if (m_notifier)
+        m_notifier->setEnabled(false);
+    qCWarning(app) << "Remote source" << m_target << "failed:" << error;
+    Q_EMIT failed(error);
+}
+
+bool RemoteSource::feed(const QByteArray &data)
+{
+    if (m_failed)
+        return false;
+    m_bytesReceived += quint64(data.size());
+    m_buffer.append(data);
+
+    int pos = 0;
+    bool ok = true;
+    remote_frame_header_t hdr;
+    QByteArray payload;
+    while (ok) {
+        int rc = nextFrame(m_buffer, pos, hdr, payload);
+        if (rc <= 0) {
+            ok = rc == 0;
+            break;
+        }
+
+        switch (hdr.type) {
+        case REMOTE_FRAME_HELLO:
+            ok = takeHello(payload);
+            break;
+        case REMOTE_FRAME_SYSTEM:
+            ok = m_hello && takeSystem(payload);
+            break;
+        case REMOTE_FRAME_PROCESSES:
+            ok = m_hello && m_device && takeProcesses(payload);
+            if (ok) {
+                if (m_attached)
+                    show();
+                Q_EMIT updated();
+            }
+            break;
+        default:
+            // frames of later versions, skipped
+            break;
+        }
+    }
+    m_buffer.remove(0, pos);
+
+    if (!ok)
+        fail(tr("The remote agent sent data of an unknown version"));
+    return ok;
+}
+
+bool RemoteSource::takeHello(const QByteArray &payload)
+{
+    const remote_hello_t *hello = remoteHello(payload.constData(), size_t(payload.size()));
+    if (!hello)
+        return false;
+
+    m_hostName = QString::fromUtf8(hello->hostname);
+    QDataStream in(payload.mid(int(sizeof(remote_hello_t))));
+    in.setVersion(RemoteAgent::kStreamVersion);
+    m_cpuSet = CPUSet();
+    m_cpuSet.loadInfo(in);
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    m_hello = true;
+    m_device.reset();
+    m_generation = 0;
+    m_records.clear();
+    m_procs.clear();
+    m_tree = ProcessTree();
+    qCInfo(app) << "Remote agent of" << m_hostName << "every" << hello->interval << "ms";
+    Q_EMIT connected(m_hostName);
+    return true;
+}
+
+bool RemoteSource::takeSystem(const QByteArray &payload)
+{
+    std::shared_ptr<DeviceSnapshot> snapshot = std::make_shared<DeviceSnapshot>();
+    if (!decodeSystem(payload, m_cpuSet, *snapshot))
+        return false;
+    m_device = std::move(snapshot);
+    return true;
+}
+
+bool RemoteSource::takeProcesses(const QByteArray &payload)
+{
+    process_info_delta_header_t hdr;
+    if (payload.size() < int(sizeof(hdr)))
+        return false;
+    memcpy(&hdr, payload.constData(), sizeof(hdr));
+    const size_t deltaSize = processInfoDeltaSize(hdr.count, hdr.exited);
+    if (size_t(payload.size()) < deltaSize + sizeof(quint32))
+        return false;
+    // the stream is reliable, a gap in generations means it can't be followed any more
+    if (!ProcessSet::applyProcessInfoDelta(payload.left(int(deltaSize)), m_records, m_generation))
+        return false;
+
+    quint32 count = 0;
+    memcpy(&count, payload.constData() + deltaSize, sizeof(count));
+    QDataStream in(payload.mid(int(deltaSize + sizeof(count))));
+    in.setVersion(RemoteAgent::kStreamVersion);
+    QHash<pid_t, Process> named;
+    QHash<pid_t, int> appTypes;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        qint32 pid = 0, appType = 0;
+        bool withNames = false;
+        in >> pid >> appType >> withNames;
+        if (withNames) {
+            Process proc;
+            proc.loadNames(in);
+            named.insert(pid, proc);
+        }
+        appTypes.insert(pid, appType);
+    }
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    // carries the sample history of the previous refresh on, detached as its rows may still be read
+    QHash<pid_t, Process> procs;
+    procs.reserve(m_records.size());
+    for (auto it = m_records.cbegin(); it != m_records.cend(); ++it) {
+        Process proc;
+        auto fresh = named.constFind(it.key());
+        if (fresh != named.constEnd()) {
+            proc = *fresh;
+        } else {
+            auto prev = m_procs.constFind(it.key());
+            if (prev == m_procs.constEnd())
+                return false;
+            proc = prev->detached();
+        }
+        proc.loadRecord(it.value());
+        auto type = appTypes.constFind(it.key());
+        if (type != appTypes.constEnd())
+            proc.setAppType(*type);
+        procs.insert(it.key(), proc);
+    }
+    for (auto it = m_procs.cbegin(); it != m_procs.cend(); ++it) {
+        if (!m_records.contains(it.key()))
+            m_tree.remove(it.key());
+    }
+    for (const Process &proc : procs) {
+        m_tree.insert(proc.pid(), proc.ppid());
+        m_tree.setUsage(proc.pid(), {proc.cpu(), proc.memory(), proc.recvBps(), proc.sentBps(), 1});
+    }
+    m_tree.accumulate();
+    m_procs.swap(procs);
+    return true;
+}
+
+void RemoteSource::show()
+{
+    DeviceDB::instance()->publishSnapshot(DeviceSnapshotPtr(m_device));
+    auto table = ProcessTableModel::makeRowTable(m_procs.values(), true, m_nameRanks, m_userRanks, nullptr, m_tree);
+    ModelManager::instance()->processRowPreparer()->setReplayTable(table);
+    ModelManager::instance()->updateCoordinator()->markDirty();
+}
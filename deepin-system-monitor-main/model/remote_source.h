@@ -0,0 +1,129 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef REMOTE_SOURCE_H
+#define REMOTE_SOURCE_H
+
+#include "process_info_record.h"
+#include "process/process.h"
+#include "process/process_tree.h"
+#include "system/cpu_set.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+
+class QProcess;
+class QSocketNotifier;
+
+namespace core {
+namespace system {
+struct DeviceSnapshot;
+} // namespace system
+} // namespace core
+
+/**
+ * @brief Sampled state of another host, read from the stream of its --headless --agent
+ *
+ * The agent is run over ssh, [ssh://][user@]host, or reached on a port forwarded to its loopback
+ * one, tcp://127.0.0.1:port. Frames are decoded as they arrive; once attached by ModelManager a
+ * refresh is fed through DeviceDB, the process row preparer & the update coordinator like a
+ * replayed recording, so every model & view shows the remote host while local sampling is paused.
+ */
+class RemoteSource : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RemoteSource(const QString &target, QObject *parent = nullptr);
+    ~RemoteSource() override;
+
+    /**
+     * @brief Run ssh or connect to the port of the target
+     * @return false if the target can't be parsed or connected to
+     */
+    bool start();
+    /**
+     * @brief Feed the decoded refreshes to the models
+     */
+    inline void setAttached(bool attached) { m_attached = attached; }
+
+    /**
+     * @brief Decode stream data, emits updated() for every complete refresh
+     * @return false if the stream is corrupted or of another version, it can't be resumed then
+     */
+    bool feed(const QByteArray &data);
+
+    inline const QString &target() const { return m_target; }
+    inline const QString &hostName() const { return m_hostName; }
+    inline quint64 bytesReceived() const { return m_bytesReceived; }
+    inline const QHash<pid_t, core::process::Process> &processes() const { return m_procs; }
+    inline const std::shared_ptr<core::system::DeviceSnapshot> &deviceSnapshot() const { return m_device; }
+
+    /**
+     * @brief Split a target into an ssh destination or a tcp address
+     * @return false if it's neither
+     */
+    static bool parseTarget(const QString &target, QString &sshDestination, QString &address, int &port);
+    /**
+     * @brief Arguments of ssh running the agent at \a destination, refreshing every \a interval ms
+     */
+    static QStringList sshArguments(const QString &destination, int interval = kDefaultInterval);
+    /**
+     * @brief Take the frame at \a pos of \a buffer, uncompressed
+     * @return 1 & \a pos moved past it, 0 if it's not complete yet, -1 if the stream is corrupted
+     */
+    static int nextFrame(const QByteArray &buffer, int &pos, remote_frame_header_t &hdr, QByteArray &payload);
+    /**
+     * @brief Decode a system frame into \a snapshot, \a cpuSet holds the info & previous jiffies
+     */
+    static bool decodeSystem(const QByteArray &payload, core::system::CPUSet &cpuSet,
+                             core::system::DeviceSnapshot &snapshot);
+
+    // the agent's refresh interval asked for over ssh
+    static constexpr int kDefaultInterval = 2000;
+
+Q_SIGNALS:
+    void connected(const QString &hostName);
+    void updated();
+    /**
+     * @brief The stream ended, ssh failed or the agent went away
+     */
+    void failed(const QString &error);
+
+private:
+    bool takeHello(const QByteArray &payload);
+    bool takeSystem(const QByteArray &payload);
+    bool takeProcesses(const QByteArray &payload);
+    void show();
+    void readSocket();
+    void fail(const QString &error);
+
+private:
+    QString m_target;
+    bool m_attached {false};
+    QProcess *m_ssh {};
+    int m_fd {-1};
+    QSocketNotifier *m_notifier {};
+
+    QByteArray m_buffer;
+    quint64 m_bytesReceived {0};
+    bool m_hello {false};
+    bool m_failed {false};
+    QString m_hostName;
+    core::system::CPUSet m_cpuSet; // holds the previous jiffies, usage is computed like on a read
+    std::shared_ptr<core::system::DeviceSnapshot> m_device;
+    quint64 m_generation {0};
+    QHash<pid_t, process_info_record_t> m_records;
+    QHash<pid_t, core::process::Process> m_procs;
+    core::process::ProcessTree m_tree;
+    QHash<QString, int> m_nameRanks;
+    QHash<QString, int> m_userRanks;
+};
+
+#endif // REMOTE_SOURCE_H
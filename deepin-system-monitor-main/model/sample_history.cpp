@@ -0,0 +1,240 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "sample_history.h"
+#include "cpu_info_model.h"
+#include "model_manager.h"
+#include "process_row_preparer.h"
+#include "ddlog.h"
+#include "common/common.h"
+#include "system/demand_tracker.h"
+#include "system/device_db.h"
+#include "system/device_snapshot.h"
+#include "system/netif.h"
+#include "process/process_db.h"
+#include "process/process_set.h"
+
+#include <QDateTime>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace DDLog;
+using namespace common::core;
+using namespace core::system;
+using namespace common::history;
+
+// processes with the most cpu recorded on each update
+const int kStoredProcesses = 5;
+
+SampleHistory::SampleHistory(QObject *parent)
+    : QObject(parent)
+{
+    qCDebug(app) << "SampleHistory constructor";
+    const QString &dir = storeDirectory();
+    m_writer.reset(new HistoryWriter(dir.toStdString()));
+    if (m_writer->isValid()) {
+        m_writer->prune(QDateTime::currentMSecsSinceEpoch());
+        m_reader.reset(new HistoryReader(dir.toStdString()));
+    } else {
+        qCWarning(app) << "History directory can't be written, charts keep the last minute only:" << dir;
+        m_writer.reset();
+    }
+}
+
+QString SampleHistory::storeDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + "/deepin/deepin-system-monitor/history";
+}
+
+const char *SampleHistory::metricName(int metric)
+{
+    // in the order of Metric, names are part of the export format
+    static const char *const names[kMetricCount] = {
+        "cpu_total", "cpu_core", "memory_usage", "swap_usage", "net_recv", "net_sent", "disk_read",
+        "disk_write", "disk_util", "process_cpu", "process_memory", "cpu_pressure", "memory_pressure",
+        "io_pressure", "swap_in", "swap_out", "reclaim_kswapd", "reclaim_direct", "package_power", "core_power",
+        "cpu_temperature", "cpu_frequency", "sensor_temperature", "fan_speed", "cpu_steal", "cpu_guest",
+    };
+    return metric >= 0 && metric < kMetricCount ? names[metric] : "";
+}
+
+const SeriesRing &SampleHistory::series(Metric metric, const QString &device)
+{
+    return ring(metric, device);
+}
+
+SeriesRing &SampleHistory::ring(Metric metric, const QString &device)
+{
+    auto it = m_series.find({metric, device});
+    if (it == m_series.end())
+        it = m_series.emplace(SeriesKey {metric, device}, SeriesRing(kHistorySize)).first;
+    return it->second;
+}
+
+void SampleHistory::setInterval(int intervalMs)
+{
+    if (intervalMs <= 0 || intervalMs == m_interval)
+        return;
+
+    qCInfo(app) << "Resampling chart history from" << m_interval << "ms to" << intervalMs << "ms";
+    const double ratio = double(intervalMs) / m_interval;
+    for (auto &entry : m_series)
+        entry.second.resample(ratio);
+    m_interval = intervalMs;
+    emit updated();
+}
+
+QString SampleHistory::spanText() const
+{
+    const int seconds = qRound(double(kHistorySize - 1) * m_interval / 1000);
+    if (seconds == 60)
+        return tr("60 seconds");
+    if (seconds < 60 || seconds % 60)
+        return tr("%1 seconds").arg(seconds);
+    return tr("%1 minutes").arg(seconds / 60);
+}
+
+void SampleHistory::push(Metric metric, const QString &device, double value)
+{
+    SeriesRing &ring = this->ring(metric, device);
+    m_recorded.insert(&ring);
+    // invalid samples, e.g. the first cpu usage, read as idle like the cpu charts always did
+    ring.push(std::isnan(value) ? 0. : value);
+    if (m_storing && m_writer && !std::isnan(value))
+        m_writer->append(metric, device.toStdString(), m_recordTime, value);
+}
+
+void SampleHistory::recordProcesses()
+{
+    auto rowTable = ModelManager::instance()->processRowPreparer()->rowTable();
+    if (!m_storing || !m_writer || !rowTable)
+        return;
+
+    QVector<int> rows(rowTable->procs.size());
+    std::iota(rows.begin(), rows.end(), 0);
+    int top = qMin(kStoredProcesses, rows.size());
+    std::partial_sort(rows.begin(), rows.begin() + top, rows.end(), [&rowTable](int a, int b) {
+        return rowTable->procs[a].cpu() > rowTable->procs[b].cpu();
+    });
+    for (int i = 0; i < top; ++i) {
+        const Process &proc = rowTable->procs[rows[i]];
+        const std::string device = QString("%1 (%2)").arg(proc.name()).arg(proc.pid()).toStdString();
+        m_writer->append(kProcessCpu, device, m_recordTime, proc.cpu());
+        m_writer->append(kProcessMemory, device, m_recordTime, proc.memory());
+    }
+}
+
+std::vector<double> SampleHistory::stored(Metric metric, const QString &device, qint64 from, qint64 to, int buckets,
+                                          bool maximum)
+{
+    if (!m_reader || buckets <= 0)
+        return {};
+    return m_reader->query(metric, device.toStdString(), from, to, size_t(buckets),
+                           maximum ? HistoryReader::kMaximum : HistoryReader::kAverage);
+}
+
+void SampleHistory::record()
+{
+    m_recorded.clear();
+    m_recordTime = QDateTime::currentMSecsSinceEpoch();
+    DeviceSnapshotPtr snapshot = DeviceDB::instance()->snapshot();
+    CPUInfoModel *cpuModel = CPUInfoModel::instance();
+
+    push(kCpuTotal, {}, cpuModel->cpuAllPercent());
+    const QList<qreal> &percents = cpuModel->cpuPercentList();
+    const auto &cpuIds = snapshot->cpuSet.cpuIds();
+    for (int i = 0; i < percents.size() && i < cpuIds.size(); ++i)
+        push(kCpuCore, QString::number(cpuIds[i]), percents[i]);
+
+    const MemInfo &mem = snapshot->memInfo;
+    if (mem.memTotal() > 0)
+        push(kMemoryUsage, {}, (mem.memTotal() - mem.memAvailable()) * 1.0 / mem.memTotal());
+    if (mem.swapTotal() > 0)
+        push(kSwapUsage, {}, (mem.swapTotal() - mem.swapFree()) * 1.0 / mem.swapTotal());
+    const vm_rates_t vm = mem.vmRates();
+    if (vm.valid) {
+        // pages to bytes, the charts share the disk speed axis
+        const qreal pageBytes = qreal(1024ull << common::init::kb_shift);
+        push(kSwapIn, {}, vm.swapIn * pageBytes);
+        push(kSwapOut, {}, vm.swapOut * pageBytes);
+        push(kReclaimKswapd, {}, vm.scanKswapd * pageBytes);
+        push(kReclaimDirect, {}, vm.scanDirect * pageBytes);
+    }
+
+    push(kNetRecv, {}, snapshot->netRecvBps);
+    push(kNetSent, {}, snapshot->netSentBps);
+    for (auto it = snapshot->netifInfo.constBegin(); it != snapshot->netifInfo.constEnd(); ++it) {
+        const QString &mac = QString::fromUtf8(it.key());
+        push(kNetRecv, mac, it.value()->recv_bps());
+        push(kNetSent, mac, it.value()->sent_bps());
+    }
+
+    for (const BlockDevice &dev : snapshot->blockDevices) {
+        const QString &name = QString::fromUtf8(dev.deviceName());
+        push(kDiskRead, name, dev.readSpeed());
+        push(kDiskWrite, name, dev.writeSpeed());
+        push(kDiskUtil, name, dev.percentUtilization() / 100.);
+    }
+
+    // stall rates since the previous sample, nothing until psi reported twice
+    const SampleHistory::Metric pressureMetrics[] = {kCpuPressure, kMemoryPressure, kIOPressure};
+    for (int i = 0; i < common::pressure::kPressureResourceCount; ++i) {
+        if (snapshot->pressure[i].hasRates)
+            push(pressureMetrics[i], {}, snapshot->pressure[i].someRate / 100.);
+    }
+
+    // estimated by the process scan, nothing without RAPL
+    const core::process::ProcessSnapshotPtr processSnapshot = core::process::ProcessDB::instance()->processSet()->snapshot();
+    if (processSnapshot->packagePower >= 0)
+        push(kPackagePower, {}, processSnapshot->packagePower);
+    if (processSnapshot->corePower >= 0)
+        push(kCorePower, {}, processSnapshot->corePower);
+
+    qreal cpuTemperature = -1;
+    for (const sensor_t &sensor : snapshot->sensors) {
+        const QString &device = sensor.chip + "/" + sensor.label;
+        if (sensor.kind == sensor_t::kTemperature) {
+            push(kSensorTemperature, device, sensor.value);
+            if (sensor.cpu)
+                cpuTemperature = qMax(cpuTemperature, sensor.value);
+        } else if (sensor.kind == sensor_t::kFan) {
+            push(kFanSpeed, device, sensor.value);
+        }
+    }
+    if (cpuTemperature >= 0)
+        push(kCpuTemperature, {}, cpuTemperature);
+
+    const CPUSet &cpuSet = snapshot->cpuSet;
+    push(kCpuSteal, {}, cpuSet.stealPercent());
+    push(kCpuGuest, {}, cpuSet.guestPercent());
+
+    // charted against the cpu temperature, frequencies are only sampled while the heatmap shows
+    if (DemandTracker::instance()->isDemanded(DemandTracker::kCpuCoreDemand) && cpuSet.maxFreqMHz() > 0) {
+        qulonglong sum = 0;
+        int cores = 0;
+        for (int cpu : cpuIds) {
+            if (qulonglong khz = cpuSet.coreFreq(cpu)) {
+                sum += khz;
+                ++cores;
+            }
+        }
+        if (cores > 0)
+            push(kCpuFrequency, {}, qreal(sum) / cores / (cpuSet.maxFreqMHz() * 10));
+    }
+
+    // cores gone offline & removed devices read as idle, keeps every series aligned to the same ticks
+    for (auto &entry : m_series) {
+        if (!m_recorded.contains(&entry.second))
+            entry.second.push(0);
+    }
+
+    recordProcesses();
+    if (m_storing && m_writer)
+        m_writer->commit();
+
+    emit updated();
+}
@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SAMPLE_HISTORY_H
+#define SAMPLE_HISTORY_H
+
+#include "common/series_ring.h"
+#include "common/history_store.h"
+
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Recent samples of every charted metric, shared by all chart widgets
+ *
+ * One sample per metric & device is recorded on each stat update, so all charts stay aligned in
+ * time & keep their history when views are switched or recreated. Widgets hold read only views.
+ */
+class SampleHistory : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Metric {
+        kCpuTotal = 0, // overall cpu usage, percent
+        kCpuCore, // per logical cpu usage, percent, device is the cpu id
+        kMemoryUsage, // used memory ratio, 0 ~ 1
+        kSwapUsage, // used swap ratio, 0 ~ 1
+        kNetRecv, // bytes per second, device is the link address, empty for the total
+        kNetSent,
+        kDiskRead, // bytes per second, device is the block device name
+        kDiskWrite,
+        kDiskUtil, // utilization ratio, 0 ~ 1
+        kProcessCpu, // on disk only, cpu percent of a top process, device is "name (pid)"
+        kProcessMemory, // on disk only, memory of a top process in kB
+        kCpuPressure, // ratio of time some tasks stalled on cpu, 0 ~ 1
+        kMemoryPressure, // same for memory
+        kIOPressure, // same for io
+        kSwapIn, // bytes per second swapped in
+        kSwapOut,
+        kReclaimKswapd, // bytes per second scanned by background reclaim
+        kReclaimDirect, // by allocating tasks
+        kPackagePower, // RAPL power of all cpu packages, W
+        kCorePower, // of their cores
+        kCpuTemperature, // hottest cpu sensor, °C
+        kCpuFrequency, // average core frequency, percent of the maximum, while per core frequencies are demanded
+        kSensorTemperature, // °C, device is "chip/label" of the sensor
+        kFanSpeed, // rpm, same devices
+        kCpuSteal, // percent of all cpu time stolen by the hypervisor we run under
+        kCpuGuest, // percent of all cpu time running the vcpus of our guests
+
+        kMetricCount
+    };
+
+    // samples kept per series, the widest chart shows 30 intervals
+    static constexpr size_t kHistorySize = 31;
+    // ms between samples unless the refresh interval was changed
+    static constexpr int kDefaultInterval = 2000;
+
+    explicit SampleHistory(QObject *parent = nullptr);
+
+    /**
+     * @brief Directory of the on-disk history
+     */
+    static QString storeDirectory();
+    /**
+     * @brief Stable name of a metric in exports, e.g. cpu_total, empty for unknown ones
+     */
+    static const char *metricName(int metric);
+
+    /**
+     * @brief Read only view of a series, created empty so widgets can bind before the first sample
+     * @param metric Metric
+     * @param device Device of per device metrics
+     * @return Series, valid for the lifetime of the store
+     */
+    const common::core::SeriesRing &series(Metric metric, const QString &device = {});
+
+    /**
+     * @brief Record one sample of every metric from the latest device snapshot & cpu model,
+     * run by ModelManager after the models refreshed
+     */
+    void record();
+    /**
+     * @brief Samples now come every \a intervalMs, held series are resampled to the new cadence
+     * so charts keep their shape instead of being cleared
+     */
+    void setInterval(int intervalMs);
+    inline int interval() const { return m_interval; }
+    /**
+     * @brief Time spanned by a full series, e.g. "60 seconds", shown under the charts
+     */
+    QString spanText() const;
+    /**
+     * @brief Stop or resume appending samples to the on-disk history, e.g. while a recording is replayed
+     */
+    inline void setStoring(bool storing) { m_storing = storing; }
+
+    /**
+     * @brief Series read back from the on-disk history, downsampled to buckets evenly spanning [from, to)
+     * @param from Start, ms since epoch
+     * @param to End, ms since epoch
+     * @return One value per bucket, NaN where nothing was recorded, empty without a history
+     */
+    std::vector<double> stored(Metric metric, const QString &device, qint64 from, qint64 to, int buckets,
+                               bool maximum = false);
+
+Q_SIGNALS:
+    /**
+     * @brief All series got the sample of this update
+     */
+    void updated();
+
+private:
+    using SeriesKey = std::pair<int, QString>;
+
+    common::core::SeriesRing &ring(Metric metric, const QString &device);
+    void push(Metric metric, const QString &device, double value);
+    void recordProcesses();
+
+    // std::map nodes never move, views handed out stay valid
+    std::map<SeriesKey, common::core::SeriesRing> m_series;
+    QSet<common::core::SeriesRing *> m_recorded;
+
+    // every sample is appended to the on-disk history too, null if its directory can't be written
+    std::unique_ptr<common::history::HistoryWriter> m_writer;
+    std::unique_ptr<common::history::HistoryReader> m_reader;
+    qint64 m_recordTime {0};
+    int m_interval {kDefaultInterval}; // ms between samples
+    bool m_storing {true};
+};
+
+#endif // SAMPLE_HISTORY_H
@@ -0,0 +1,302 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "snapshot_diff_model.h"
+#include "ddlog.h"
+#include "common/common.h"
+
+#include <QApplication>
+
+#include <algorithm>
+
+#include <unistd.h>
+
+using namespace DDLog;
+using namespace common::format;
+using namespace core::process;
+
+template<typename T>
+static int compareNumber(T a, T b)
+{
+    return a < b ? -1 : a > b ? 1 : 0;
+}
+
+SnapshotDiffModel::SnapshotDiffModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_ticksPerSecond(qMax(1L, sysconf(_SC_CLK_TCK)))
+{
+    qCDebug(app) << "SnapshotDiffModel constructor";
+}
+
+void SnapshotDiffModel::setDiff(const SnapshotDiff &diff)
+{
+    beginResetModel();
+    m_diff = diff;
+    m_order = ordered();
+    endResetModel();
+}
+
+void SnapshotDiffModel::setMode(Mode mode)
+{
+    if (mode == m_mode)
+        return;
+    beginResetModel();
+    m_mode = mode;
+    m_order = ordered();
+    endResetModel();
+}
+
+void SnapshotDiffModel::setShowUnchanged(bool show)
+{
+    if (show == m_showUnchanged)
+        return;
+    beginResetModel();
+    m_showUnchanged = show;
+    m_order = ordered();
+    endResetModel();
+}
+
+bool SnapshotDiffModel::isUnchanged(const process_delta_t &delta)
+{
+    return delta.change == process_delta_t::kKept && delta.cpuTicks == 0 && delta.memory == 0 && delta.readBytes == 0
+           && delta.writeBytes == 0 && delta.sockets == 0;
+}
+
+QString SnapshotDiffModel::signedText(qlonglong delta, const QString &magnitude)
+{
+    if (delta == 0)
+        return {};
+    return (delta > 0 ? QStringLiteral("+") : QStringLiteral("-")) + magnitude;
+}
+
+QVector<int> SnapshotDiffModel::ordered() const
+{
+    QVector<int> order;
+    if (!m_diff.isValid())
+        return order;
+
+    const QVector<process_delta_t> &processes = m_diff.processes();
+    const QVector<service_delta_t> &services = m_diff.services();
+    if (m_mode == kProcessMode) {
+        order.reserve(processes.size());
+        for (int i = 0; i < processes.size(); ++i) {
+            if (m_showUnchanged || !isUnchanged(processes[i]))
+                order << i;
+        }
+    } else {
+        order.reserve(services.size());
+        for (int i = 0; i < services.size(); ++i) {
+            const service_delta_t &service = services[i];
+            if (m_showUnchanged || service.started || service.exited || service.cpuTicks || service.memory
+                || service.readBytes || service.writeBytes || service.sockets)
+                order << i;
+        }
+    }
+
+    auto compareProcesses = [&](int a, int b) -> int {
+        const process_delta_t &x = processes[a];
+        const process_delta_t &y = processes[b];
+        switch (m_sortColumn) {
+        case kDiffNameColumn:
+            return m_diff.name(x).compare(m_diff.name(y), Qt::CaseInsensitive);
+        case kDiffPidColumn:
+            return compareNumber(m_diff.pid(x), m_diff.pid(y));
+        case kDiffChangeColumn:
+            return compareNumber(int(x.change), int(y.change));
+        case kDiffCPUColumn:
+            return compareNumber(x.cpuAfter - x.cpuBefore, y.cpuAfter - y.cpuBefore);
+        case kDiffCPUTimeColumn:
+            return compareNumber(x.cpuTicks, y.cpuTicks);
+        case kDiffMemoryColumn:
+            return compareNumber(x.memory, y.memory);
+        case kDiffReadColumn:
+            return compareNumber(x.readBytes, y.readBytes);
+        case kDiffWriteColumn:
+            return compareNumber(x.writeBytes, y.writeBytes);
+        case kDiffSocketsColumn:
+            return compareNumber(x.sockets, y.sockets);
+        default:
+            return 0;
+        }
+    };
+    auto compareServices = [&](int a, int b) -> int {
+        const service_delta_t &x = services[a];
+        const service_delta_t &y = services[b];
+        switch (m_sortColumn) {
+        case kDiffNameColumn:
+            return x.unit.compare(y.unit, Qt::CaseInsensitive);
+        case kDiffPidColumn:
+            return compareNumber(x.processesAfter - x.processesBefore, y.processesAfter - y.processesBefore);
+        case kDiffChangeColumn:
+            return compareNumber(x.started + x.exited, y.started + y.exited);
+        case kDiffCPUColumn:
+            return compareNumber(x.cpuAfter - x.cpuBefore, y.cpuAfter - y.cpuBefore);
+        case kDiffCPUTimeColumn:
+            return compareNumber(x.cpuTicks, y.cpuTicks);
+        case kDiffMemoryColumn:
+            return compareNumber(x.memory, y.memory);
+        case kDiffReadColumn:
+            return compareNumber(x.readBytes, y.readBytes);
+        case kDiffWriteColumn:
+            return compareNumber(x.writeBytes, y.writeBytes);
+        case kDiffSocketsColumn:
+            return compareNumber(x.sockets, y.sockets);
+        default:
+            return 0;
+        }
+    };
+    const bool descending = m_sortOrder == Qt::DescendingOrder;
+    // deltas are in pid or unit order, equal keys keep it
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        const int cmp = m_mode == kProcessMode ? compareProcesses(a, b) : compareServices(a, b);
+        return descending ? cmp > 0 : cmp < 0;
+    });
+    return order;
+}
+
+void SnapshotDiffModel::sort(int column, Qt::SortOrder order)
+{
+    if (column < 0 || column >= kDiffColumnCount)
+        return;
+    // a report, nothing to keep selected across a sort
+    beginResetModel();
+    m_sortColumn = column;
+    m_sortOrder = order;
+    m_order = ordered();
+    endResetModel();
+}
+
+int SnapshotDiffModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_order.size();
+}
+
+int SnapshotDiffModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : kDiffColumnCount;
+}
+
+QVariant SnapshotDiffModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && (role == Qt::DisplayRole || role == Qt::AccessibleTextRole)) {
+        switch (section) {
+        case kDiffNameColumn:
+            return QApplication::translate("Snapshot.Diff.Header", kDiffName);
+        case kDiffPidColumn:
+            return m_mode == kProcessMode ? QApplication::translate("Snapshot.Diff.Header", kDiffPid)
+                                          : QApplication::translate("Snapshot.Diff.Header", kDiffProcesses);
+        case kDiffChangeColumn:
+            return QApplication::translate("Snapshot.Diff.Header", kDiffChange);
+        case kDiffCPUColumn:
+            return QApplication::translate("Snapshot.Diff.Header", kDiffCPU);
+        case kDiffCPUTimeColumn:
+            return QApplication::translate("Snapshot.Diff.Header", kDiffCPUTime);
+        case kDiffMemoryColumn:
+            return QApplication::translate("Snapshot.Diff.Header", kDiffMemory);
+        case kDiffReadColumn:
+            return QApplication::translate("Snapshot.Diff.Header", kDiffRead);
+        case kDiffWriteColumn:
+            return QApplication::translate("Snapshot.Diff.Header", kDiffWrite);
+        case kDiffSocketsColumn:
+            return QApplication::translate("Snapshot.Diff.Header", kDiffSockets);
+        default:
+            break;
+        }
+    } else if (orientation == Qt::Horizontal && role == Qt::ToolTipRole) {
+        if (section == kDiffCPUTimeColumn || section == kDiffReadColumn || section == kDiffWriteColumn)
+            return QApplication::translate("Snapshot.Diff.Header", "Used between the two points in time, all of it for a started process");
+        if (section == kDiffSocketsColumn)
+            return QApplication::translate("Snapshot.Diff.Header", "Socket fds are only counted while a view shows sockets or fds");
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+QVariant SnapshotDiffModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_order.size())
+        return {};
+
+    const int row = m_order[index.row()];
+    if (m_mode == kProcessMode)
+        return processData(m_diff.processes()[row], index.column(), role);
+    return serviceData(m_diff.services()[row], index.column(), role);
+}
+
+QVariant SnapshotDiffModel::processData(const process_delta_t &delta, int column, int role) const
+{
+    if (role == Qt::DisplayRole || role == Qt::AccessibleTextRole) {
+        switch (column) {
+        case kDiffNameColumn:
+            return m_diff.name(delta);
+        case kDiffPidColumn:
+            return QString::number(m_diff.pid(delta));
+        case kDiffChangeColumn:
+            if (delta.change == process_delta_t::kStarted)
+                return QApplication::translate("Snapshot.Diff", "Started");
+            if (delta.change == process_delta_t::kExited)
+                return QApplication::translate("Snapshot.Diff", "Exited");
+            return QString();
+        case kDiffCPUColumn:
+            if (delta.change == process_delta_t::kStarted)
+                return QString("→ %1%").arg(delta.cpuAfter, 0, 'f', 1);
+            if (delta.change == process_delta_t::kExited)
+                return QString("%1% →").arg(delta.cpuBefore, 0, 'f', 1);
+            return QString("%1% → %2%").arg(delta.cpuBefore, 0, 'f', 1).arg(delta.cpuAfter, 0, 'f', 1);
+        case kDiffCPUTimeColumn:
+            return delta.cpuTicks ? QApplication::translate("Snapshot.Diff", "%1 s").arg(delta.cpuTicks / m_ticksPerSecond, 0, 'f', 2)
+                                  : QString();
+        case kDiffMemoryColumn:
+            return signedText(delta.memory, formatUnit_memory_disk(qAbs(delta.memory), KB));
+        case kDiffReadColumn:
+            return signedText(delta.readBytes, formatUnit_memory_disk(delta.readBytes, B));
+        case kDiffWriteColumn:
+            return signedText(delta.writeBytes, formatUnit_memory_disk(delta.writeBytes, B));
+        case kDiffSocketsColumn:
+            return signedText(delta.sockets, QString::number(qAbs(delta.sockets)));
+        default:
+            break;
+        }
+    } else if (role == Qt::ToolTipRole && column == kDiffNameColumn) {
+        return m_diff.unit(delta);
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return {};
+}
+
+QVariant SnapshotDiffModel::serviceData(const service_delta_t &delta, int column, int role) const
+{
+    if (role == Qt::DisplayRole || role == Qt::AccessibleTextRole) {
+        switch (column) {
+        case kDiffNameColumn:
+            return delta.unit;
+        case kDiffPidColumn:
+            return QString("%1 → %2").arg(delta.processesBefore).arg(delta.processesAfter);
+        case kDiffChangeColumn:
+            if (!delta.started && !delta.exited)
+                return QString();
+            return QApplication::translate("Snapshot.Diff", "%1 started, %2 exited").arg(delta.started).arg(delta.exited);
+        case kDiffCPUColumn:
+            return QString("%1% → %2%").arg(delta.cpuBefore, 0, 'f', 1).arg(delta.cpuAfter, 0, 'f', 1);
+        case kDiffCPUTimeColumn:
+            return delta.cpuTicks ? QApplication::translate("Snapshot.Diff", "%1 s").arg(delta.cpuTicks / m_ticksPerSecond, 0, 'f', 2)
+                                  : QString();
+        case kDiffMemoryColumn:
+            return signedText(delta.memory, formatUnit_memory_disk(qAbs(delta.memory), KB));
+        case kDiffReadColumn:
+            return signedText(delta.readBytes, formatUnit_memory_disk(delta.readBytes, B));
+        case kDiffWriteColumn:
+            return signedText(delta.writeBytes, formatUnit_memory_disk(delta.writeBytes, B));
+        case kDiffSocketsColumn:
+            return signedText(delta.sockets, QString::number(qAbs(delta.sockets)));
+        default:
+            break;
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return {};
+}
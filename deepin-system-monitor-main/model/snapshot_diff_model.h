@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SNAPSHOT_DIFF_MODEL_H
+#define SNAPSHOT_DIFF_MODEL_H
+
+#include "process/process_diff.h"
+
+#include <QAbstractTableModel>
+#include <QVector>
+
+// process or service name column display
+constexpr const char *kDiffName = QT_TRANSLATE_NOOP("Snapshot.Diff.Header", "Name");
+// pid or process count column display
+constexpr const char *kDiffPid = QT_TRANSLATE_NOOP("Snapshot.Diff.Header", "PID");
+constexpr const char *kDiffProcesses = QT_TRANSLATE_NOOP("Snapshot.Diff.Header", "Processes");
+// started, exited column display
+constexpr const char *kDiffChange = QT_TRANSLATE_NOOP("Snapshot.Diff.Header", "Change");
+// cpu usage before & after column display
+constexpr const char *kDiffCPU = QT_TRANSLATE_NOOP("Snapshot.Diff.Header", "CPU");
+// cpu time used in between column display
+constexpr const char *kDiffCPUTime = QT_TRANSLATE_NOOP("Snapshot.Diff.Header", "CPU time");
+// memory delta column display
+constexpr const char *kDiffMemory = QT_TRANSLATE_NOOP("Snapshot.Diff.Header", "Memory");
+// disk read in between column display
+constexpr const char *kDiffRead = QT_TRANSLATE_NOOP("Snapshot.Diff.Header", "Disk read");
+// disk written in between column display
+constexpr const char *kDiffWrite = QT_TRANSLATE_NOOP("Snapshot.Diff.Header", "Disk write");
+// socket count delta column display
+constexpr const char *kDiffSockets = QT_TRANSLATE_NOOP("Snapshot.Diff.Header", "Sockets");
+
+/**
+ * @brief Per process or per service rows of a SnapshotDiff
+ *
+ * Rows are indexes into the deltas of the diff in sort order, processes that didn't change
+ * are left out unless asked for, so a diff of two large tables lists what moved.
+ */
+class SnapshotDiffModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        kDiffNameColumn = 0,
+        kDiffPidColumn, // process count of a service
+        kDiffChangeColumn,
+        kDiffCPUColumn,
+        kDiffCPUTimeColumn,
+        kDiffMemoryColumn,
+        kDiffReadColumn,
+        kDiffWriteColumn,
+        kDiffSocketsColumn,
+
+        kDiffColumnCount
+    };
+
+    enum Mode {
+        kProcessMode = 0,
+        kServiceMode
+    };
+
+    explicit SnapshotDiffModel(QObject *parent = nullptr);
+
+    void setDiff(const core::process::SnapshotDiff &diff);
+    inline const core::process::SnapshotDiff &diff() const { return m_diff; }
+    void setMode(Mode mode);
+    inline Mode mode() const { return m_mode; }
+    /**
+     * @brief List kept processes & services with no delta at all too
+     */
+    void setShowUnchanged(bool show);
+
+    /**
+     * @brief Whether a kept process' cpu time, memory, io & sockets stayed the same
+     */
+    static bool isUnchanged(const core::process::process_delta_t &delta);
+    /**
+     * @brief Signed text of a delta, e.g. +1.5 MB, or empty for 0
+     */
+    static QString signedText(qlonglong delta, const QString &magnitude);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+private:
+    /**
+     * @brief Deltas shown in the current mode, in sort order
+     */
+    QVector<int> ordered() const;
+    QVariant processData(const core::process::process_delta_t &delta, int column, int role) const;
+    QVariant serviceData(const core::process::service_delta_t &delta, int column, int role) const;
+
+    core::process::SnapshotDiff m_diff;
+    Mode m_mode {kProcessMode};
+    bool m_showUnchanged {false};
+    // deltas shown, in sort order
+    QVector<int> m_order;
+    int m_sortColumn {kDiffCPUTimeColumn};
+    Qt::SortOrder m_sortOrder {Qt::DescendingOrder};
+    qreal m_ticksPerSecond;
+};
+
+#endif // SNAPSHOT_DIFF_MODEL_H
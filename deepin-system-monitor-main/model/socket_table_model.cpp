@@ -0,0 +1,453 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "socket_table_model.h"
+#include "process_connection_model.h"
+#include "ddlog.h"
+#include "common/task_executor.h"
+#include "process/process.h"
+#include "process/process_db.h"
+#include "process/process_set.h"
+#include "system/demand_tracker.h"
+
+#include <QApplication>
+#include <QRegularExpression>
+#include <QSet>
+
+#include <algorithm>
+
+#include <netinet/tcp.h>
+#include <string.h>
+#include <sys/socket.h>
+
+using namespace DDLog;
+using namespace common::core;
+using namespace core::process;
+using namespace core::system;
+
+namespace {
+
+// by tcp state, as ss names them
+const char *const kStateNames[] = {
+    "UNKNOWN", "ESTAB", "SYN-SENT", "SYN-RECV", "FIN-WAIT-1", "FIN-WAIT-2", "TIME-WAIT",
+    "UNCONN", "CLOSE-WAIT", "LAST-ACK", "LISTEN", "CLOSING", "NEW-SYN-RECV",
+};
+const int kStateCount = int(sizeof(kStateNames) / sizeof(kStateNames[0]));
+
+// state of a filter word, e.g. estab, syn_sent, timewait, -1 if unknown
+int stateOf(QString word)
+{
+    word.remove('-').remove('_');
+    if (word == "established")
+        return TCP_ESTABLISHED;
+    if (word == "close")
+        return TCP_CLOSE;
+    for (int state = 1; state < kStateCount; ++state) {
+        if (word == QString::fromLatin1(kStateNames[state]).remove('-').toLower())
+            return state;
+    }
+    return -1;
+}
+
+int compareEndpoint(int familyA, const in6_addr &a, uint16_t portA, int familyB, const in6_addr &b, uint16_t portB)
+{
+    if (familyA != familyB)
+        return familyA - familyB;
+    if (int cmp = memcmp(&a, &b, sizeof(in6_addr)))
+        return cmp;
+    return int(portA) - int(portB);
+}
+
+int compareNumber(uint64_t a, uint64_t b)
+{
+    return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+} // namespace
+
+bool SocketTableModel::filter_t::isEmpty() const
+{
+    return states == ~0u && port < 0 && pid == 0 && names.isEmpty() && minRtt == 0;
+}
+
+SocketTableModel::SocketTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+    qCDebug(app) << "SocketTableModel constructor";
+    // owners come from the socket inodes of the process scan, which only walks fds on demand
+    DemandTracker::instance()->declare(this, DemandTracker::kProcessNetDemand);
+    connect(&m_watcher, &QFutureWatcher<dump_t>::finished, this, &SocketTableModel::finishRefresh);
+}
+
+SocketTableModel::~SocketTableModel()
+{
+    // the job shares nothing with the model, a dump still running is dropped
+}
+
+void SocketTableModel::refresh()
+{
+    if (m_refreshing)
+        return;
+    m_refreshing = true;
+
+    const ProcessSnapshotPtr processes = ProcessDB::instance()->processSet()->snapshot();
+    m_watcher.setFuture(TaskExecutor::instance()->run(TaskExecutor::kBackgroundTask, [processes]() {
+        dump_t dump;
+        SockDiag diag;
+        dump.ok = diag.dumpSockets(dump.sockets);
+        if (!dump.ok || !processes)
+            return dump;
+
+        QHash<ino_t, pid_t> owners;
+        owners.reserve(int(dump.sockets.size()));
+        for (const Process &proc : processes->processes) {
+            const QList<ino_t> inodes = proc.sockInodes();
+            if (inodes.isEmpty())
+                continue;
+            dump.names.insert(proc.pid(), proc.name());
+            for (ino_t ino : inodes)
+                owners.insert(ino, proc.pid());
+        }
+        for (auto &sock : dump.sockets) {
+            if (sock.ino)
+                sock.pid = owners.value(sock.ino, 0);
+        }
+        return dump;
+    }));
+}
+
+void SocketTableModel::stop()
+{
+    beginResetModel();
+    m_table.clear();
+    m_order.clear();
+    m_names.clear();
+    endResetModel();
+}
+
+void SocketTableModel::finishRefresh()
+{
+    m_refreshing = false;
+    const dump_t dump = m_watcher.result();
+    m_available = dump.ok;
+    if (!dump.ok) {
+        qCWarning(app) << "Socket dump failed, sock_diag not available";
+        stop();
+    } else {
+        merge(dump.sockets, dump.names);
+    }
+    Q_EMIT refreshed();
+}
+
+void SocketTableModel::merge(const std::vector<SocketTable::socket_t> &sockets, const QHash<pid_t, QString> &names)
+{
+    m_table.beginGeneration();
+    for (const auto &sock : sockets)
+        m_table.update(sock);
+    const size_t closed = m_table.evictStale();
+    m_names = names;
+    qCDebug(app) << "Socket table merged:" << m_table.size() << "sockets," << closed << "closed";
+    patch(ordered());
+}
+
+void SocketTableModel::setFilter(const filter_t &filter)
+{
+    beginResetModel();
+    m_filter = filter;
+    m_order = ordered();
+    endResetModel();
+    Q_EMIT refreshed();
+}
+
+SocketTableModel::filter_t SocketTableModel::parseFilter(const QString &pattern)
+{
+    filter_t filter;
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    const QStringList words = pattern.toLower().split(QRegularExpression("\\s+"), QString::SkipEmptyParts);
+#else
+    const QStringList words = pattern.toLower().split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+#endif
+    for (const QString &word : words) {
+        bool ok = false;
+        if (word.startsWith("state:")) {
+            // states named are shown, an unknown name shows nothing rather than everything
+            filter.states = 0;
+            for (const QString &name : word.mid(6).split(',')) {
+                const int state = stateOf(name);
+                if (state > 0)
+                    filter.states |= 1u << state;
+            }
+        } else if (word.startsWith("port:")) {
+            const int port = word.mid(5).toInt(&ok);
+            filter.port = ok ? port : -1;
+        } else if (word.startsWith("pid:")) {
+            const pid_t pid = pid_t(word.mid(4).toInt(&ok));
+            filter.pid = ok ? pid : 0;
+        } else if (word.startsWith("rtt>") || word.startsWith("rtt:")) {
+            const double ms = word.mid(4).toDouble(&ok);
+            filter.minRtt = ok && ms > 0 ? uint32_t(ms * 1000) : 0;
+        } else if (word.toUInt(&ok) <= 65535 && ok) {
+            filter.port = word.toInt();
+        } else {
+            filter.names << word;
+        }
+    }
+    return filter;
+}
+
+QString SocketTableModel::stateName(int proto, int state)
+{
+    if (proto == IPPROTO_UDP)
+        return QString::fromLatin1(kStateNames[state == TCP_ESTABLISHED ? TCP_ESTABLISHED : TCP_CLOSE]);
+    return QString::fromLatin1(kStateNames[state > 0 && state < kStateCount ? state : 0]);
+}
+
+QVector<int> SocketTableModel::ordered() const
+{
+    // owners matching the name words, looked up once instead of per socket
+    QSet<pid_t> namedPids;
+    for (auto it = m_names.cbegin(); !m_filter.names.isEmpty() && it != m_names.cend(); ++it) {
+        const QString name = it.value().toLower();
+        if (std::all_of(m_filter.names.cbegin(), m_filter.names.cend(), [&](const QString &word) { return name.contains(word); }))
+            namedPids.insert(it.key());
+    }
+
+    QVector<int> order;
+    order.reserve(int(m_table.size()));
+    for (int row = 0; row < m_table.rows(); ++row) {
+        if (!m_table.isUsed(row) || !(m_filter.states & (1u << m_table.state(row))))
+            continue;
+        if (m_filter.port >= 0 && m_table.lport(row) != m_filter.port && m_table.rport(row) != m_filter.port)
+            continue;
+        if ((m_filter.pid && m_table.pid(row) != m_filter.pid) || m_table.rtt(row) < m_filter.minRtt)
+            continue;
+        if (!m_filter.names.isEmpty() && !namedPids.contains(m_table.pid(row)))
+            continue;
+        order << row;
+    }
+
+    // owner names ranked once, comparing strings per pair is too slow for this many rows
+    std::vector<int> ranks;
+    if (m_sortColumn == kSocketProcessColumn) {
+        QList<pid_t> pids = m_names.keys();
+        std::sort(pids.begin(), pids.end(), [this](pid_t a, pid_t b) {
+            const int cmp = m_names.value(a).compare(m_names.value(b), Qt::CaseInsensitive);
+            return cmp != 0 ? cmp < 0 : a < b;
+        });
+        QHash<pid_t, int> rankOf;
+        for (int i = 0; i < pids.size(); ++i)
+            rankOf.insert(pids[i], i + 1);
+        ranks.resize(size_t(m_table.rows()));
+        for (int row : order)
+            ranks[size_t(row)] = rankOf.value(m_table.pid(row), 0);
+    }
+
+    auto compare = [&](int a, int b) -> int {
+        switch (m_sortColumn) {
+        case kSocketProtocolColumn:
+            return compareNumber(uint64_t(m_table.proto(a)) << 8 | m_table.family(a), uint64_t(m_table.proto(b)) << 8 | m_table.family(b));
+        case kSocketStateColumn:
+            return compareNumber(m_table.state(a), m_table.state(b));
+        case kSocketLocalAddrColumn:
+            return compareEndpoint(m_table.family(a), m_table.laddr(a), m_table.lport(a), m_table.family(b), m_table.laddr(b), m_table.lport(b));
+        case kSocketRemoteAddrColumn:
+            return compareEndpoint(m_table.family(a), m_table.raddr(a), m_table.rport(a), m_table.family(b), m_table.raddr(b), m_table.rport(b));
+        case kSocketProcessColumn:
+            return compareNumber(uint64_t(ranks[size_t(a)]), uint64_t(ranks[size_t(b)]));
+        case kSocketRecvQColumn:
+            return compareNumber(m_table.rxQueue(a), m_table.rxQueue(b));
+        case kSocketSendQColumn:
+            return compareNumber(m_table.txQueue(a), m_table.txQueue(b));
+        case kSocketRttColumn:
+            return compareNumber(m_table.rtt(a), m_table.rtt(b));
+        default:
+            return 0;
+        }
+    };
+    const bool descending = m_sortOrder == Qt::DescendingOrder;
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        const int cmp = compare(a, b);
+        if (cmp != 0)
+            return descending ? cmp > 0 : cmp < 0;
+        // sockets with equal keys keep their place between refreshes
+        return m_table.cookie(a) < m_table.cookie(b);
+    });
+    return order;
+}
+
+void SocketTableModel::patch(const QVector<int> &order)
+{
+    std::vector<int> newPos(size_t(m_table.rows()), -1);
+    for (int i = 0; i < order.size(); ++i)
+        newPos[size_t(order[i])] = i;
+
+    // runs of shown rows going away, closed or filtered out now
+    QVector<QPair<int, int>> removed;
+    for (int i = 0; i < m_order.size(); ++i) {
+        if (newPos[size_t(m_order[i])] >= 0)
+            continue;
+        if (!removed.isEmpty() && removed.last().second == i - 1)
+            removed.last().second = i;
+        else
+            removed << qMakePair(i, i);
+    }
+    if (removed.size() > kMaxPatchRanges) {
+        qCDebug(app) << "Socket table reset," << removed.size() << "runs of rows removed";
+        beginResetModel();
+        m_order = order;
+        endResetModel();
+        return;
+    }
+
+    for (int r = removed.size() - 1; r >= 0; --r) {
+        beginRemoveRows(QModelIndex(), removed[r].first, removed[r].second);
+        m_order.remove(removed[r].first, removed[r].second - removed[r].first + 1);
+        endRemoveRows();
+    }
+
+    // new rows are appended & moved into place by the relayout below
+    std::vector<bool> shown(newPos.size(), false);
+    for (int row : m_order)
+        shown[size_t(row)] = true;
+    QVector<int> inserted;
+    for (int row : order) {
+        if (!shown[size_t(row)])
+            inserted << row;
+    }
+    if (!inserted.isEmpty()) {
+        beginInsertRows(QModelIndex(), m_order.size(), m_order.size() + inserted.size() - 1);
+        m_order << inserted;
+        endInsertRows();
+    }
+
+    if (m_order != order) {
+        relayout(order);
+        return;
+    }
+
+    // same rows in the same order, only fields changed in this generation are repainted
+    const uint32_t generation = m_table.generation();
+    int first = -1;
+    int last = -1;
+    for (int i = 0; i < m_order.size(); ++i) {
+        if (m_table.changed(m_order[i]) != generation)
+            continue;
+        if (first < 0)
+            first = i;
+        last = i;
+    }
+    if (first >= 0)
+        Q_EMIT dataChanged(index(first, 0), index(last, kSocketColumnCount - 1));
+}
+
+void SocketTableModel::relayout(const QVector<int> &order)
+{
+    Q_EMIT layoutAboutToBeChanged();
+    std::vector<int> newPos(size_t(m_table.rows()), -1);
+    for (int i = 0; i < order.size(); ++i)
+        newPos[size_t(order[i])] = i;
+    const QModelIndexList from = persistentIndexList();
+    QModelIndexList to;
+    to.reserve(from.size());
+    for (const QModelIndex &idx : from) {
+        const int pos = idx.row() < m_order.size() ? newPos[size_t(m_order[idx.row()])] : -1;
+        to << (pos >= 0 ? index(pos, idx.column()) : QModelIndex());
+    }
+    m_order = order;
+    changePersistentIndexList(from, to);
+    Q_EMIT layoutChanged();
+}
+
+void SocketTableModel::sort(int column, Qt::SortOrder order)
+{
+    if (column < 0 || column >= kSocketColumnCount)
+        return;
+    m_sortColumn = column;
+    m_sortOrder = order;
+    relayout(ordered());
+}
+
+int SocketTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_order.size();
+}
+
+int SocketTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : kSocketColumnCount;
+}
+
+QVariant SocketTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && (role == Qt::DisplayRole || role == Qt::AccessibleTextRole)) {
+        switch (section) {
+        case kSocketProtocolColumn:
+            return QApplication::translate("Socket.Table.Header", kSocketProtocol);
+        case kSocketStateColumn:
+            return QApplication::translate("Socket.Table.Header", kSocketState);
+        case kSocketLocalAddrColumn:
+            return QApplication::translate("Socket.Table.Header", kSocketLocalAddr);
+        case kSocketRemoteAddrColumn:
+            return QApplication::translate("Socket.Table.Header", kSocketRemoteAddr);
+        case kSocketProcessColumn:
+            return QApplication::translate("Socket.Table.Header", kSocketProcess);
+        case kSocketRecvQColumn:
+            return QApplication::translate("Socket.Table.Header", kSocketRecvQ);
+        case kSocketSendQColumn:
+            return QApplication::translate("Socket.Table.Header", kSocketSendQ);
+        case kSocketRttColumn:
+            return QApplication::translate("Socket.Table.Header", kSocketRtt);
+        default:
+            break;
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+QVariant SocketTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_order.size())
+        return {};
+
+    // cells are formatted on paint, only for the rows on screen
+    const int row = m_order[index.row()];
+    if (role == Qt::DisplayRole || role == Qt::AccessibleTextRole) {
+        switch (index.column()) {
+        case kSocketProtocolColumn: {
+            const QString proto = m_table.proto(row) == IPPROTO_TCP ? QStringLiteral("TCP") : QStringLiteral("UDP");
+            return m_table.family(row) == AF_INET6 ? proto + "6" : proto;
+        }
+        case kSocketStateColumn:
+            return stateName(m_table.proto(row), m_table.state(row));
+        case kSocketLocalAddrColumn:
+            return ProcessConnectionModel::formatEndpoint(m_table.family(row), &m_table.laddr(row), m_table.lport(row));
+        case kSocketRemoteAddrColumn:
+            // listening & unconnected sockets have no peer
+            if (m_table.rport(row) == 0)
+                return QStringLiteral("*");
+            return ProcessConnectionModel::formatEndpoint(m_table.family(row), &m_table.raddr(row), m_table.rport(row));
+        case kSocketProcessColumn: {
+            const pid_t pid = m_table.pid(row);
+            if (pid == 0)
+                return QString();
+            return QString("%1 (%2)").arg(m_names.value(pid)).arg(pid);
+        }
+        case kSocketRecvQColumn:
+            return QString::number(m_table.rxQueue(row));
+        case kSocketSendQColumn:
+            return QString::number(m_table.txQueue(row));
+        case kSocketRttColumn:
+            if (m_table.rtt(row) == 0)
+                return QStringLiteral("-");
+            return QString("%1 ms").arg(m_table.rtt(row) / 1000., 0, 'f', 1);
+        default:
+            break;
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        return QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    return {};
+}
@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SOCKET_TABLE_MODEL_H
+#define SOCKET_TABLE_MODEL_H
+
+#include "system/sock_diag.h"
+
+#include <QAbstractTableModel>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+
+#include <vector>
+
+// protocol column display
+constexpr const char *kSocketProtocol = QT_TRANSLATE_NOOP("Socket.Table.Header", "Protocol");
+// state column display
+constexpr const char *kSocketState = QT_TRANSLATE_NOOP("Socket.Table.Header", "State");
+// local address column display
+constexpr const char *kSocketLocalAddr = QT_TRANSLATE_NOOP("Socket.Table.Header", "Local address");
+// remote address column display
+constexpr const char *kSocketRemoteAddr = QT_TRANSLATE_NOOP("Socket.Table.Header", "Remote address");
+// owner process column display
+constexpr const char *kSocketProcess = QT_TRANSLATE_NOOP("Socket.Table.Header", "Process");
+// receive queue column display
+constexpr const char *kSocketRecvQ = QT_TRANSLATE_NOOP("Socket.Table.Header", "Recv-Q");
+// send queue column display
+constexpr const char *kSocketSendQ = QT_TRANSLATE_NOOP("Socket.Table.Header", "Send-Q");
+// round trip time column display
+constexpr const char *kSocketRtt = QT_TRANSLATE_NOOP("Socket.Table.Header", "RTT");
+
+/**
+ * @brief Every tcp/udp socket of the system, like ss -tuanp, for hundreds of thousands of rows
+ *
+ * Sockets live in a columnar SocketTable, the model only keeps the rows shown in sort order,
+ * so filtering & sorting scan plain arrays & no QSortFilterProxyModel wraps 200k rows. The
+ * dump & the owner lookup run in the background, the owners come from the socket inodes of the
+ * last process scan instead of an fd walk of their own, which is what makes ss -p slow. A refresh
+ * only patches rows: closed & new sockets are removed & inserted, rows whose fields changed in
+ * the generation of the dump are reported changed.
+ */
+class SocketTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        kSocketProtocolColumn = 0,
+        kSocketStateColumn,
+        kSocketLocalAddrColumn,
+        kSocketRemoteAddrColumn,
+        kSocketProcessColumn,
+        kSocketRecvQColumn,
+        kSocketSendQColumn,
+        kSocketRttColumn,
+
+        kSocketColumnCount
+    };
+
+    /**
+     * @brief What rows are shown, all conditions must hold
+     */
+    struct filter_t {
+        uint32_t states {~0u}; // bits of tcp states, udp sockets are TCP_ESTABLISHED or TCP_CLOSE
+        int port {-1}; // local or remote port, -1 any
+        pid_t pid {0}; // owner, 0 any
+        QStringList names; // owner name substrings, case insensitive
+        uint32_t minRtt {0}; // us
+
+        bool isEmpty() const;
+    };
+
+    explicit SocketTableModel(QObject *parent = nullptr);
+    ~SocketTableModel() override;
+
+    /**
+     * @brief Start a dump in the background unless one is running, its rows are patched in when done
+     */
+    void refresh();
+    /**
+     * @brief Drop all sockets, e.g. while the page is hidden
+     */
+    void stop();
+
+    inline bool isRefreshing() const { return m_refreshing; }
+    /**
+     * @brief Whether the last dump succeeded, there is no /proc/net fallback for the full list
+     */
+    inline bool isAvailable() const { return m_available; }
+    /**
+     * @brief Sockets of the last dump, shown or not
+     */
+    inline int total() const { return int(m_table.size()); }
+
+    void setFilter(const filter_t &filter);
+    inline const filter_t &filter() const { return m_filter; }
+    /**
+     * @brief Filter of a search text, e.g. "state:estab,syn-sent port:443 rtt>50 nginx"
+     *
+     * rtt is in ms, pid:N matches an owner, a bare number matches a port, other words owner names.
+     */
+    static filter_t parseFilter(const QString &pattern);
+    /**
+     * @brief ss like name of a socket state, udp sockets are UNCONN or ESTAB
+     */
+    static QString stateName(int proto, int state);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    // scattered removals that are still signalled one by one, beyond that the model is reset
+    static constexpr int kMaxPatchRanges = 64;
+
+Q_SIGNALS:
+    /**
+     * @brief A dump was patched in, or the filter changed
+     */
+    void refreshed();
+
+private:
+    struct dump_t {
+        std::vector<core::system::SocketTable::socket_t> sockets;
+        QHash<pid_t, QString> names; // of the owners
+        bool ok {false};
+    };
+
+    void finishRefresh();
+    /**
+     * @brief Patch the sockets of a dump into the table & the shown rows
+     */
+    void merge(const std::vector<core::system::SocketTable::socket_t> &sockets, const QHash<pid_t, QString> &names);
+    /**
+     * @brief Table rows passing the filter, in sort order
+     */
+    QVector<int> ordered() const;
+    /**
+     * @brief Turn the shown rows into \a order with as few signals as possible
+     */
+    void patch(const QVector<int> &order);
+    /**
+     * @brief Reorder the shown rows, same set of rows, persistent indexes follow their socket
+     */
+    void relayout(const QVector<int> &order);
+
+    core::system::SocketTable m_table;
+    // table rows shown, in sort order
+    QVector<int> m_order;
+    QHash<pid_t, QString> m_names;
+    filter_t m_filter;
+    int m_sortColumn {kSocketStateColumn};
+    Qt::SortOrder m_sortOrder {Qt::AscendingOrder};
+
+    QFutureWatcher<dump_t> m_watcher;
+    bool m_refreshing {false};
+    bool m_available {true};
+};
+
+#endif // SOCKET_TABLE_MODEL_H
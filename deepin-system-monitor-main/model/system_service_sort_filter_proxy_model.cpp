@@ -115,6 +115,12 @@ bool SystemServiceSortFilterProxyModel::lessThan(const QModelIndex &left,
         qCDebug(app) << "Sorting by PID";
         // sort pid column with integer comparision
         return left.data().toUInt() < right.data().toUInt();
+    case SystemServiceTableModel::kSystemServiceCPUColumn:
+    case SystemServiceTableModel::kSystemServiceMemoryColumn:
+    case SystemServiceTableModel::kSystemServiceDiskIOColumn:
+    case SystemServiceTableModel::kSystemServiceTasksColumn:
+        // sort usage columns with raw values, services without a cgroup come first
+        return left.data(Qt::UserRole).toDouble() < right.data(Qt::UserRole).toDouble();
     case SystemServiceTableModel::kSystemServiceNameColumn:
     case SystemServiceTableModel::kSystemServiceDescriptionColumn: {
         qCDebug(app) << "Sorting by Name or Description";
@@ -8,6 +8,7 @@
 
 #include "service/service_manager.h"
 #include "common/common.h"
+#include "system/demand_tracker.h"
 
 #include <DApplication>
 
@@ -15,9 +16,15 @@
 #include <QDebug>
 #include <QFont>
 #include <QFontMetrics>
+#include <QTimer>
 
 DWIDGET_USE_NAMESPACE
 using namespace common;
+using namespace common::format;
+using namespace common::cgroup;
+
+// cgroup usage sampling interval while services are shown, in msecs
+const int kUsageSampleInterval = 2000;
 
 // model constructor
 SystemServiceTableModel::SystemServiceTableModel(QObject *parent)
@@ -30,6 +37,49 @@ SystemServiceTableModel::SystemServiceTableModel(QObject *parent)
     // conenct service list & status update slots
     connect(mgr, &ServiceManager::serviceListUpdated, this, &SystemServiceTableModel::updateServiceList);
     connect(mgr, &ServiceManager::serviceStatusUpdated, this, &SystemServiceTableModel::updateServiceEntry);
+    connect(mgr, &ServiceManager::serviceRemoved, this, &SystemServiceTableModel::removeServiceEntry);
+    connect(mgr, &ServiceManager::serviceEntriesUpdated, this, &SystemServiceTableModel::updateServiceEntries);
+    connect(mgr, &ServiceManager::serviceEntriesDropped, this, &SystemServiceTableModel::dropServiceEntries);
+    // unit changes arriving while hidden are asked when the list is shown again
+    core::system::DemandTracker::instance()->declare(this, core::system::DemandTracker::kServiceDemand);
+
+    m_usageTimer = new QTimer(this);
+    m_usageTimer->setInterval(kUsageSampleInterval);
+    connect(m_usageTimer, &QTimer::timeout, this, &SystemServiceTableModel::sampleUsage);
+}
+
+// sample cgroup usage only while someone looks at it
+void SystemServiceTableModel::setUsageSampling(bool enabled)
+{
+    if (!enabled) {
+        m_usageTimer->stop();
+        return;
+    }
+    if (m_usageTimer->isActive())
+        return;
+    if (!CgroupStats::isAvailable()) {
+        qCDebug(app) << "No unified cgroup hierarchy, service usage not sampled";
+        return;
+    }
+
+    sampleUsage();
+    m_usageTimer->start();
+}
+
+void SystemServiceTableModel::sampleUsage()
+{
+    // rows not fetched yet are neither shown nor sorted
+    QHash<QString, QString> controlGroups;
+    controlGroups.reserve(m_nr);
+    for (int row = 0; row < m_nr; ++row) {
+        const auto &entry = m_svcMap[m_svcList[row]];
+        if (!entry.getControlGroup().isEmpty())
+            controlGroups.insert(entry.getSName(), entry.getControlGroup());
+    }
+    m_usage = m_cgroupStats.sample(controlGroups);
+
+    if (m_nr > 0)
+        Q_EMIT dataChanged(index(0, kSystemServiceCPUColumn), index(m_nr - 1, kSystemServiceTasksColumn));
 }
 
 // update the model with the data provided by entry
@@ -56,9 +106,10 @@ void SystemServiceTableModel::updateServiceEntry(const SystemServiceEntry &entry
         }
         // otherwise add the entry to the model
         qCDebug(app) << "Service" << sname << "is new, adding";
-        auto row = m_svcList.size();
+        // right after the loaded rows, rows still to be fetched stay behind
+        auto row = m_nr;
         beginInsertRows({}, row, row);
-        m_svcList << sname;
+        m_svcList.insert(row, sname);
         m_svcMap[sname] = entry;
         ++m_nr;
         endInsertRows();
@@ -66,6 +117,85 @@ void SystemServiceTableModel::updateServiceEntry(const SystemServiceEntry &entry
     }
 }
 
+// patch the model after a unit got unloaded by systemd
+void SystemServiceTableModel::removeServiceEntry(const QString &sname)
+{
+    auto it = m_svcMap.find(sname);
+    if (it == m_svcMap.end())
+        return;
+
+    int row = m_svcList.indexOf(sname);
+    // services with a unit file are still listed, as the full list does with units not loaded
+    if (!it->getState().isEmpty()) {
+        qCDebug(app) << "Service" << sname << "unloaded, keeping its unit file";
+        it->setActiveState("inactive");
+        it->setSubState("dead");
+        it->setMainPID(0);
+        it->setControlGroup({});
+        if (row < m_nr)
+            Q_EMIT dataChanged(index(row, 0), index(row, columnCount() - 1));
+        return;
+    }
+
+    qCDebug(app) << "Service" << sname << "removed";
+    takeServiceRow(row);
+}
+
+// patch rows with details of the services listed, services not listed yet are appended
+void SystemServiceTableModel::updateServiceEntries(const QList<SystemServiceEntry> &list)
+{
+    bool allLoaded = (m_nr == m_svcList.size());
+    int first = m_nr, last = -1;
+    for (const auto &entry : list) {
+        auto sname = entry.getSName();
+        if (sname.isEmpty())
+            continue;
+        auto it = m_svcMap.find(sname);
+        if (it == m_svcMap.end()) {
+            m_svcList << sname;
+            m_svcMap[sname] = entry;
+            continue;
+        }
+        *it = entry;
+        int row = m_svcList.indexOf(sname);
+        if (row < m_nr) {
+            first = qMin(first, row);
+            last = qMax(last, row);
+        }
+    }
+    // one notification for the batch, rows not loaded yet are told by fetchMore
+    if (last >= 0)
+        Q_EMIT dataChanged(index(first, 0), index(last, columnCount() - 1));
+    // the view asks for more rows only while scrolling
+    if (allLoaded && m_nr < m_svcList.size())
+        fetchMore({});
+}
+
+// drop rows of services listed by mistake
+void SystemServiceTableModel::dropServiceEntries(const QStringList &snames)
+{
+    for (const auto &sname : snames) {
+        if (m_svcMap.contains(sname))
+            takeServiceRow(m_svcList.indexOf(sname));
+    }
+}
+
+void SystemServiceTableModel::takeServiceRow(int row)
+{
+    if (row < 0 || row >= m_svcList.size())
+        return;
+
+    m_usage.remove(m_svcList[row]);
+    if (row < m_nr) {
+        beginRemoveRows({}, row, row);
+        m_svcMap.remove(m_svcList.takeAt(row));
+        --m_nr;
+        endRemoveRows();
+    } else {
+        m_svcMap.remove(m_svcList.takeAt(row));
+    }
+}
+
 // Returns the data stored under the given role for the item referred to by the index
 QVariant SystemServiceTableModel::data(const QModelIndex &index, int role) const
 {
@@ -116,6 +246,44 @@ QVariant SystemServiceTableModel::data(const QModelIndex &index, int role) const
             auto va = (pid == 0) ? QVariant() : QVariant(pid);
             return va;
         }
+        case kSystemServiceCPUColumn:
+        case kSystemServiceMemoryColumn:
+        case kSystemServiceDiskIOColumn:
+        case kSystemServiceTasksColumn: {
+            // cgroup usage, empty for services without a running cgroup
+            auto it = m_usage.constFind(m_svcList[row]);
+            if (it == m_usage.constEnd())
+                return {};
+            // limits set at runtime are shown next to the usage they cap
+            if (index.column() == kSystemServiceCPUColumn && it->cpuLimit > 0)
+                return QString("%1% / %2%").arg(it->cpu, 0, 'f', 1).arg(it->cpuLimit, 0, 'f', 1);
+            if (index.column() == kSystemServiceCPUColumn)
+                return QString("%1%").arg(it->cpu, 0, 'f', 1);
+            if (index.column() == kSystemServiceMemoryColumn && it->memoryHigh > 0)
+                return QString("%1 / %2").arg(formatUnit_memory_disk(it->memory, B)).arg(formatUnit_memory_disk(it->memoryHigh, B));
+            if (index.column() == kSystemServiceMemoryColumn)
+                return formatUnit_memory_disk(it->memory, B);
+            if (index.column() == kSystemServiceDiskIOColumn)
+                return formatUnit_memory_disk(it->ioRate, B, 1, true);
+            return it->tasks;
+        }
+        default:
+            break;
+        }
+    } else if (role == Qt::UserRole) {
+        // raw usage values for sorting
+        auto it = m_usage.constFind(m_svcList[row]);
+        if (it == m_usage.constEnd())
+            return {};
+        switch (index.column()) {
+        case kSystemServiceCPUColumn:
+            return it->cpu;
+        case kSystemServiceMemoryColumn:
+            return it->memory;
+        case kSystemServiceDiskIOColumn:
+            return it->ioRate;
+        case kSystemServiceTasksColumn:
+            return it->tasks;
         default:
             break;
         }
@@ -183,6 +351,18 @@ QVariant SystemServiceTableModel::headerData(int section,
         case kSystemServiceStartupModeColumn:
             // service startup mode column display text
             return DApplication::translate("Service.Table.Header", kSystemServiceStartupMode);
+        case kSystemServiceCPUColumn:
+            // service cpu usage column display text
+            return DApplication::translate("Service.Table.Header", kSystemServiceCPU);
+        case kSystemServiceMemoryColumn:
+            // service memory usage column display text
+            return DApplication::translate("Service.Table.Header", kSystemServiceMemory);
+        case kSystemServiceDiskIOColumn:
+            // service disk io rate column display text
+            return DApplication::translate("Service.Table.Header", kSystemServiceDiskIO);
+        case kSystemServiceTasksColumn:
+            // service task count column display text
+            return DApplication::translate("Service.Table.Header", kSystemServiceTasks);
         default:
             break;
         }
@@ -257,6 +437,7 @@ void SystemServiceTableModel::updateServiceList(const QList<SystemServiceEntry>
     // reset
     m_svcList.clear();
     m_svcMap.clear();
+    m_usage.clear();
     m_nr = 0;
     // feed with new data from list
     for (auto &ent : list) {
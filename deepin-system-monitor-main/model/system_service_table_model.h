@@ -7,11 +7,14 @@
 #define SYSTEM_SERVICE_TABLE_MODEL_H
 
 #include "service/system_service_entry.h"
+#include "common/cgroup_stats.h"
 
 #include <QAbstractTableModel>
 #include <QList>
 #include <QHash>
 
+class QTimer;
+
 // Service name text
 constexpr const char *kSystemServiceName = QT_TRANSLATE_NOOP("Service.Table.Header", "Name");
 // Service load state text
@@ -30,6 +33,14 @@ constexpr const char *kSystemServiceDescription =
     QT_TRANSLATE_NOOP("Service.Table.Header", "Description");
 // Service pid text
 constexpr const char *kSystemServicePID = QT_TRANSLATE_NOOP("Service.Table.Header", "PID");
+// Service cpu usage text
+constexpr const char *kSystemServiceCPU = QT_TRANSLATE_NOOP("Service.Table.Header", "CPU");
+// Service memory usage text
+constexpr const char *kSystemServiceMemory = QT_TRANSLATE_NOOP("Service.Table.Header", "Memory");
+// Service disk io rate text
+constexpr const char *kSystemServiceDiskIO = QT_TRANSLATE_NOOP("Service.Table.Header", "Disk I/O");
+// Service task count text
+constexpr const char *kSystemServiceTasks = QT_TRANSLATE_NOOP("Service.Table.Header", "Tasks");
 
 class SystemServiceEntry;
 
@@ -53,6 +64,10 @@ public:
         kSystemServiceDescriptionColumn, // description column
         kSystemServicePIDColumn, // pid column
         kSystemServiceStartupModeColumn, // startup mode column
+        kSystemServiceCPUColumn, // cgroup cpu usage column
+        kSystemServiceMemoryColumn, // cgroup memory usage column
+        kSystemServiceDiskIOColumn, // cgroup disk io rate column
+        kSystemServiceTasksColumn, // cgroup task count column
 
         kSystemServiceTableColumnCount // total number of columns
     };
@@ -74,6 +89,18 @@ public:
      */
     void updateServiceEntry(const SystemServiceEntry &entry);
 
+    /**
+     * @brief Drop the entry of a service unloaded by systemd, the one of a unit file is kept as inactive
+     * @param sname Service name
+     */
+    void removeServiceEntry(const QString &sname);
+
+    /**
+     * @brief Sample cgroup usage of loaded services periodically, while services are shown
+     * @param enabled Start or stop sampling
+     */
+    void setUsageSampling(bool enabled);
+
     /**
      * @brief Get unit file's state
      * @param index Model index
@@ -95,6 +122,13 @@ public:
      */
     QString getUnitActiveState(const QModelIndex &index);
 
+    /**
+     * @brief Get unit's cgroup
+     * @param index Model index
+     * @return Return cgroup path relative to the cgroup root, empty if the unit isn't running
+     */
+    QString getControlGroup(const QModelIndex &index);
+
     /**
      * @brief data Returns the data stored under the given role for the item referred to by the index
      * @param index Index of the data
@@ -155,6 +189,28 @@ private Q_SLOTS:
      * @param list Updated service's list
      */
     void updateServiceList(const QList<SystemServiceEntry> &list);
+    /**
+     * @brief Patch the model with details of listed services
+     * @param list Services listed later or with details filled in since
+     */
+    void updateServiceEntries(const QList<SystemServiceEntry> &list);
+    /**
+     * @brief Drop services listed by mistake
+     * @param snames Service names
+     */
+    void dropServiceEntries(const QStringList &snames);
+
+    /**
+     * @brief Read cgroup usage of the loaded services with a cgroup
+     */
+    void sampleUsage();
+
+private:
+    /**
+     * @brief Remove a row, told to views when it's loaded
+     * @param row Row of m_svcList
+     */
+    void takeServiceRow(int row);
 
 private:
     // Service name list
@@ -163,6 +219,11 @@ private:
     QHash<QString, SystemServiceEntry>  m_svcMap    {};
     // current loaded items (into the model)
     int m_nr {};
+
+    // cgroup usage of loaded services by service name, services without cgroup are left out
+    QHash<QString, common::cgroup::cgroup_usage_t> m_usage {};
+    common::cgroup::CgroupStats m_cgroupStats;
+    QTimer *m_usageTimer {};
 };
 
 inline void SystemServiceTableModel::reset()
@@ -170,6 +231,7 @@ inline void SystemServiceTableModel::reset()
     beginRemoveRows({}, 0, m_svcList.size() - 1);
     m_svcList.clear();
     m_svcMap.clear();
+    m_usage.clear();
     endRemoveRows();
 }
 
@@ -197,4 +259,12 @@ inline QString SystemServiceTableModel::getUnitActiveState(const QModelIndex &in
     return m_svcMap[m_svcList[index.row()]].getActiveState();
 }
 
+inline QString SystemServiceTableModel::getControlGroup(const QModelIndex &index)
+{
+    if (!index.isValid())
+        return {};
+
+    return m_svcMap[m_svcList[index.row()]].getControlGroup();
+}
+
 #endif  // SYSTEM_SERVICE_TABLE_MODEL_H
@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "update_coordinator.h"
+#include "ddlog.h"
+#include "system/system_monitor.h"
+
+#include <QGuiApplication>
+#include <QScreen>
+
+using namespace DDLog;
+using namespace core::system;
+
+// fallback when the screen doesn't report its refresh rate
+#define DEFAULT_FRAME_INTERVAL 16
+
+UpdateCoordinator::UpdateCoordinator(QObject *parent)
+    : QObject(parent)
+{
+    qCDebug(app) << "UpdateCoordinator constructor";
+    m_frameTimer.setSingleShot(true);
+    m_frameTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_frameTimer, &QTimer::timeout, this, &UpdateCoordinator::flush);
+
+    // stat is published from the monitor thread, everything depending on it refreshes in one flush
+    connect(SystemMonitor::instance(), &SystemMonitor::statInfoUpdated, this, [this]() { markDirty(); });
+}
+
+void UpdateCoordinator::markDirty(int stages)
+{
+    m_dirty |= stages & kAllStages;
+    // stages marked while flushing are picked up by the running flush or scheduled after it
+    if (!m_flushing)
+        scheduleFlush();
+}
+
+void UpdateCoordinator::setPaused(bool paused)
+{
+    if (m_paused == paused)
+        return;
+
+    qCDebug(app) << "UpdateCoordinator paused:" << paused;
+    m_paused = paused;
+    if (m_paused)
+        m_frameTimer.stop();
+    else
+        scheduleFlush();
+}
+
+void UpdateCoordinator::scheduleFlush()
+{
+    if (m_paused || !m_dirty || m_frameTimer.isActive())
+        return;
+
+    // at most one flush per frame
+    int wait = 0;
+    if (m_lastFlush.isValid())
+        wait = qMax(0, frameInterval() - int(m_lastFlush.elapsed()));
+    m_frameTimer.start(wait);
+}
+
+void UpdateCoordinator::flush()
+{
+    m_flushing = true;
+    m_lastFlush.restart();
+
+    // fixed order, each stage sees what the previous ones refreshed
+    if (m_dirty & kModelStage) {
+        m_dirty &= ~kModelStage;
+        emit updateModels();
+    }
+    if (m_dirty & kHistoryStage) {
+        m_dirty &= ~kHistoryStage;
+        emit updateHistory();
+    }
+    if (m_dirty & kViewStage) {
+        m_dirty &= ~kViewStage;
+        emit updateViews();
+    }
+
+    m_flushing = false;
+    scheduleFlush();
+}
+
+int UpdateCoordinator::frameInterval() const
+{
+    QScreen *screen = QGuiApplication::primaryScreen();
+    if (!screen || screen->refreshRate() < 1)
+        return DEFAULT_FRAME_INTERVAL;
+    return qMax(1, int(1000 / screen->refreshRate()));
+}
@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef UPDATE_COORDINATOR_H
+#define UPDATE_COORDINATOR_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+/**
+ * @brief Coalesces stat updates of the models & views into one flush per display frame
+ *
+ * Sources mark stages dirty, the flush runs them once in a fixed order: models, chart history, views.
+ * Notifications landing within one frame end in a single refresh of everything listening. Flushing
+ * is paused while the window is hidden or minimized, pending stages run once when it's shown again.
+ */
+class UpdateCoordinator : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Stage {
+        kModelStage = 0x1, // data models refresh from the latest stat
+        kHistoryStage = 0x2, // chart history records the refreshed models
+        kViewStage = 0x4, // summary, detail & compact views refresh
+
+        kAllStages = kModelStage | kHistoryStage | kViewStage
+    };
+
+    explicit UpdateCoordinator(QObject *parent = nullptr);
+
+    /**
+     * @brief Request a flush of stages on the next frame
+     * @param stages Stage bits
+     */
+    void markDirty(int stages = kAllStages);
+    /**
+     * @brief Stop or resume flushing, e.g. while the main window is minimized
+     */
+    void setPaused(bool paused);
+    inline bool isPaused() const { return m_paused; }
+
+Q_SIGNALS:
+    void updateModels();
+    void updateHistory();
+    void updateViews();
+
+private:
+    void scheduleFlush();
+    void flush();
+    int frameInterval() const;
+
+    int m_dirty {0};
+    bool m_paused {false};
+    bool m_flushing {false};
+    QTimer m_frameTimer;
+    QElapsedTimer m_lastFlush;
+};
+
+#endif // UPDATE_COORDINATOR_H
@@ -7,10 +7,13 @@
 #include "ddlog.h"
 
 #include "gui/ui_common.h"
+#include "gui/base/frame_clock.h"
 #include "common/common.h"
+#include "model/model_manager.h"
+#include "model/sample_history.h"
 #include "system/device_db.h"
+#include "system/device_snapshot.h"
 #include "system/net_info.h"
-#include "system/system_monitor.h"
 
 #include <DApplication>
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -41,15 +44,9 @@ NetworkMonitor::NetworkMonitor(QWidget *parent)
     setFixedWidth(statusBarMaxWidth);
     setFixedHeight(180);
 
-    downloadSpeeds = new QList<double>();
-    for (int i = 0; i <= pointsNumber; i++) {
-        downloadSpeeds->append(0);
-    }
-
-    uploadSpeeds = new QList<double>();
-    for (int i = 0; i <= pointsNumber; i++) {
-        uploadSpeeds->append(0);
-    }
+    SampleHistory *history = ModelManager::instance()->sampleHistory();
+    downloadSpeeds = &history->series(SampleHistory::kNetRecv);
+    uploadSpeeds = &history->series(SampleHistory::kNetSent);
 
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     auto *dAppHelper = DApplicationHelper::instance();
@@ -60,7 +57,7 @@ NetworkMonitor::NetworkMonitor(QWidget *parent)
 #endif
     changeTheme(dAppHelper->themeType());
 
-    connect(SystemMonitor::instance(), &SystemMonitor::statInfoUpdated, this, &NetworkMonitor::updateStatus);
+    connect(history, &SampleHistory::updated, this, &NetworkMonitor::updateStatus);
 
     changeFont(DApplication::font());
     connect(dynamic_cast<QGuiApplication *>(DApplication::instance()), &DApplication::fontChanged,
@@ -70,8 +67,6 @@ NetworkMonitor::NetworkMonitor(QWidget *parent)
 NetworkMonitor::~NetworkMonitor()
 {
     qCDebug(app) << "NetworkMonitor destroyed";
-    delete downloadSpeeds;
-    delete uploadSpeeds;
 }
 
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -122,16 +117,15 @@ void NetworkMonitor::changeTheme(DGuiApplicationHelper::ColorType themeType)
     m_frameColor.setAlphaF(0.3);
 }
 
-void NetworkMonitor::getPainterPathByData(QList<double> *listData, QPainterPath &path, qreal maxVlaue)
+void NetworkMonitor::getPainterPathByData(const common::core::SeriesRing *listData, QPainterPath &path, qreal maxVlaue)
 {
     qCDebug(app) << "Getting painter path from data";
     qreal offsetX = 0;
     qreal distance = (this->width() - 2) * 1.0 / pointsNumber;
-    int dataCount = listData->size();
-
-    for (int i = 0;  i < dataCount - 1; i++) {
-        QPointF sp = QPointF(offsetX, renderMaxHeight * listData->at(i) / maxVlaue);;
-        QPointF ep = QPointF(offsetX + distance, renderMaxHeight * listData->at(i + 1) / maxVlaue);;
+    // the latest pointsNumber + 1 samples, oldest first, samples not recorded yet read as 0
+    for (int i = pointsNumber;  i > 0; i--) {
+        QPointF sp = QPointF(offsetX, renderMaxHeight * listData->recent(size_t(i)) / maxVlaue);;
+        QPointF ep = QPointF(offsetX + distance, renderMaxHeight * listData->recent(size_t(i - 1)) / maxVlaue);;
 
         offsetX += distance;
 
@@ -144,30 +138,16 @@ void NetworkMonitor::getPainterPathByData(QList<double> *listData, QPainterPath
 void NetworkMonitor::updateStatus()
 {
     qCDebug(app) << "Updating network status";
-    auto netInfo = DeviceDB::instance()->netInfo();
-
-    m_totalRecvBytes = netInfo->totalRecvBytes();
-    m_totalSentBytes = netInfo->totalSentBytes();
-    m_recvBps = netInfo->recvBps();
-    m_sentBps = netInfo->sentBps();
+    DeviceSnapshotPtr snapshot = DeviceDB::instance()->snapshot();
 
-    // Init download path.
-    downloadSpeeds->append(m_recvBps);
+    m_totalRecvBytes = snapshot->netTotalRecvBytes;
+    m_totalSentBytes = snapshot->netTotalSentBytes;
+    m_recvBps = snapshot->netRecvBps;
+    m_sentBps = snapshot->netSentBps;
 
-    if (downloadSpeeds->size() > pointsNumber + 1) {
-        qCDebug(app) << "Download speeds list is full, removing oldest";
-        downloadSpeeds->pop_front();
-    }
-    double downloadMaxHeight = *std::max_element(downloadSpeeds->begin(), downloadSpeeds->end()) * 1.1;
-
-    // Init upload path.
-    uploadSpeeds->append(m_sentBps);
-
-    if (uploadSpeeds->size() > pointsNumber + 1) {
-        qCDebug(app) << "Upload speeds list is full, removing oldest";
-        uploadSpeeds->pop_front();
-    }
-    double uploadMaxHeight = *std::max_element(uploadSpeeds->begin(), uploadSpeeds->end()) * 1.1;
+    // history holds just the charted samples, its running max is the max of the chart
+    double downloadMaxHeight = downloadSpeeds->max() * 1.1;
+    double uploadMaxHeight = uploadSpeeds->max() * 1.1;
 
     double maxHeight = qMax(downloadMaxHeight, uploadMaxHeight);
 
@@ -179,7 +159,7 @@ void NetworkMonitor::updateStatus()
     getPainterPathByData(uploadSpeeds, tmpUploadpath, maxHeight);
     uploadPath = tmpUploadpath;
 
-    update();
+    FrameClock::instance()->requestUpdate(this);
 }
 
 void NetworkMonitor::paintEvent(QPaintEvent *)
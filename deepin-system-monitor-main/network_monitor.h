@@ -6,6 +6,8 @@
 #ifndef NETWORKMONITOR_H
 #define NETWORKMONITOR_H
 
+#include "common/series_ring.h"
+
 #include <QIcon>
 #include <QWidget>
 #include <QPainterPath>
@@ -49,13 +51,14 @@ private:
     void changeTheme(DGuiApplicationHelper::ColorType themeType);
 #endif
     void changeFont(const QFont &font);
-    void getPainterPathByData(QList<double> *listData, QPainterPath &path, qreal maxVlaue);
+    void getPainterPathByData(const common::core::SeriesRing *listData, QPainterPath &path, qreal maxVlaue);
 
 private:
     QIcon m_icon;
 
-    QList<double> *downloadSpeeds;
-    QList<double> *uploadSpeeds;
+    // total speed history, kept by the shared sample history
+    const common::core::SeriesRing *downloadSpeeds;
+    const common::core::SeriesRing *uploadSpeeds;
     QPainterPath downloadPath;
     QPainterPath uploadPath;
 
@@ -0,0 +1,210 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "container_identity.h"
+#include "common/cgroup_stats.h"
+
+#include <QCoreApplication>
+#include <QRegularExpression>
+#include <QStringList>
+
+#include <stdio.h>
+#include <unistd.h>
+
+namespace core {
+namespace process {
+
+namespace {
+
+// runtimes name their scopes after the full container id, its first 12 digits are shown
+const int kShortIdLength = 12;
+
+// systemd cgroup driver
+const QRegularExpression kRuntimeScope("^(docker|libpod|cri-containerd|crio)-([0-9a-f]{12,64})\\.scope$");
+// cgroupfs driver, a bare container id under the runtime's parent
+const QRegularExpression kContainerId("^[0-9a-f]{64}$");
+// snap.<snap>.<app>-<uuid>.scope
+const QRegularExpression kSnapScope("^snap\\.([^.]+)\\..+\\.scope$");
+// dbus activated services, app-dbus-:1.2-org.freedesktop.portal.Desktop
+const QRegularExpression kDBusPrefix("^dbus-:[0-9.]+-");
+// machined scopes of libvirt, machine-qemu\x2d<domain id>\x2d<name>.scope, dashes unescaped
+const QRegularExpression kMachineScope("^machine-(qemu|lxc)-[0-9]+-(.+)\\.scope$");
+
+ContainerIdentity::Kind runtimeKind(const QString &runtime)
+{
+    if (runtime == "docker")
+        return ContainerIdentity::kDocker;
+    if (runtime == "libpod")
+        return ContainerIdentity::kPodman;
+    return ContainerIdentity::kContainerd;
+}
+
+/**
+ * @brief App id of a unit following systemd's app naming, app[-<launcher>]-<app id>[@<instance>].service
+ * or app[-<launcher>]-<app id>-<random>.scope
+ */
+bool parseAppUnit(const QString &unit, ContainerIdentity &identity)
+{
+    if (!unit.startsWith("app-"))
+        return false;
+
+    QString name = unit.mid(4);
+    if (name.endsWith(".scope")) {
+        name.chop(6);
+        int dash = name.lastIndexOf('-');
+        if (dash > 0)
+            name.truncate(dash);
+    } else if (name.endsWith(".service")) {
+        name.chop(8);
+        int at = name.indexOf('@');
+        if (at >= 0)
+            name.truncate(at);
+    } else {
+        return false;
+    }
+
+    // a launcher has no dots, app ids are reverse dns names, dashes in them are escaped
+    QString launcher;
+    int dash = name.indexOf('-');
+    if (dash > 0 && !name.left(dash).contains('.')) {
+        launcher = name.left(dash).toLower();
+        name = name.mid(dash + 1);
+    }
+    name.replace("\\x2d", "-");
+    name.remove(kDBusPrefix);
+    if (name.isEmpty())
+        return false;
+
+    if (launcher == "flatpak")
+        identity.kind = ContainerIdentity::kFlatpak;
+    else if (launcher == "linglong")
+        identity.kind = ContainerIdentity::kLinglong;
+    else
+        identity.kind = ContainerIdentity::kApp;
+    identity.id = name;
+    return true;
+}
+
+} // namespace
+
+ContainerIdentity ContainerIdentity::fromCgroup(const QString &cgroup)
+{
+    ContainerIdentity identity;
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    const QStringList segments = cgroup.split('/', QString::SkipEmptyParts);
+#else
+    const QStringList segments = cgroup.split('/', Qt::SkipEmptyParts);
+#endif
+    // innermost first, an app started inside a container belongs to the container's leaf unit
+    for (int i = segments.size() - 1; i >= 0; --i) {
+        const QString &segment = segments[i];
+        const QString parent = i > 0 ? segments[i - 1] : QString();
+
+        QRegularExpressionMatch match = kRuntimeScope.match(segment);
+        if (match.hasMatch()) {
+            identity.kind = runtimeKind(match.captured(1));
+            identity.id = match.captured(2).left(kShortIdLength);
+            return identity;
+        }
+        if (kContainerId.match(segment).hasMatch()) {
+            if (parent == "docker") {
+                identity.kind = kDocker;
+            } else if (parent.startsWith("kubepods") || parent.startsWith("pod")) {
+                identity.kind = kContainerd;
+            } else {
+                continue;
+            }
+            identity.id = segment.left(kShortIdLength);
+            return identity;
+        }
+        if (segment.startsWith("lxc.payload.")) {
+            identity.kind = kLxc;
+            identity.id = segment.mid(12);
+            return identity;
+        }
+        if (parent == "lxc" && !segment.isEmpty()) {
+            identity.kind = kLxc;
+            identity.id = segment;
+            return identity;
+        }
+        if (parent == "machine.slice") {
+            // vcpu & emulator threads sit in sub groups of the scope, nspawn machines are left to
+            // the pid namespace check
+            match = kMachineScope.match(QString(segment).replace("\\x2d", "-"));
+            if (!match.hasMatch())
+                continue;
+            identity.kind = match.captured(1) == "qemu" ? kVirtualMachine : kLxc;
+            identity.id = match.captured(2);
+            return identity;
+        }
+        match = kSnapScope.match(segment);
+        if (match.hasMatch()) {
+            identity.kind = kSnap;
+            identity.id = match.captured(1);
+            return identity;
+        }
+        if (parseAppUnit(segment, identity))
+            return identity;
+    }
+    return {};
+}
+
+ContainerIdentity ContainerIdentity::read(pid_t pid, const QString &hostPidNamespace)
+{
+    ContainerIdentity identity = fromCgroup(common::cgroup::CgroupStats::processCgroup(pid));
+    if (!identity.isHost())
+        return identity;
+
+    // sandboxes without a unit of their own still run in their own pid namespace
+    const QString ns = pidNamespace(pid);
+    if (!ns.isEmpty() && !hostPidNamespace.isEmpty() && ns != hostPidNamespace) {
+        identity.kind = kSandbox;
+        identity.id = ns.section('[', 1).section(']', 0, 0);
+    }
+    return identity;
+}
+
+QString ContainerIdentity::pidNamespace(pid_t pid)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/ns/pid", pid);
+    char link[64];
+    // needs ptrace read access, processes of other users are left on the host
+    ssize_t n = readlink(path, link, sizeof(link) - 1);
+    if (n <= 0)
+        return {};
+    return QString::fromLatin1(link, int(n));
+}
+
+QString ContainerIdentity::kindName(Kind kind)
+{
+    switch (kind) {
+    case kApp:
+        return QCoreApplication::translate("Process.Container", "App");
+    case kFlatpak:
+        return QStringLiteral("Flatpak");
+    case kLinglong:
+        return QCoreApplication::translate("Process.Container", "Linglong");
+    case kSnap:
+        return QStringLiteral("Snap");
+    case kDocker:
+        return QStringLiteral("Docker");
+    case kPodman:
+        return QStringLiteral("Podman");
+    case kContainerd:
+        return QCoreApplication::translate("Process.Container", "Kubernetes");
+    case kLxc:
+        return QStringLiteral("LXC");
+    case kSandbox:
+        return QCoreApplication::translate("Process.Container", "Sandbox");
+    case kVirtualMachine:
+        return QCoreApplication::translate("Process.Container", "Virtual machine");
+    case kHost:
+        break;
+    }
+    return QCoreApplication::translate("Process.Container", "Host");
+}
+
+} // namespace process
+} // namespace core
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CONTAINER_IDENTITY_H
+#define CONTAINER_IDENTITY_H
+
+#include <QList>
+#include <QString>
+
+#include <memory>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Container, sandbox or app a process belongs to, derived from its cgroup & pid namespace
+ *
+ * Read once per process, the cgroup of a process only changes when it's moved by its manager,
+ * which happens right after it's spawned if at all.
+ */
+struct ContainerIdentity {
+    enum Kind {
+        kHost, // none of the below
+        kApp, // systemd app unit of a launcher, e.g. app-DDE-org.deepin.editor@1.service
+        kFlatpak,
+        kLinglong,
+        kSnap,
+        kDocker,
+        kPodman,
+        kContainerd, // containerd, cri-o & other kubernetes runtimes
+        kLxc,
+        kSandbox, // own pid namespace but no known cgroup layout, e.g. bwrap
+        kVirtualMachine // qemu of a libvirt guest, machine.slice
+    };
+
+    Kind kind {kHost};
+    QString id; // app id, container or guest name or short container id, pid namespace inode for kSandbox
+
+    inline bool isHost() const
+    {
+        return kind == kHost;
+    }
+    /**
+     * @brief Whether the process runs isolated from the host, with pids & windows of its own
+     *
+     * A guest's qemu is a host process, only what runs inside the guest is isolated.
+     */
+    inline bool isSandboxed() const
+    {
+        return kind != kHost && kind != kApp && kind != kVirtualMachine;
+    }
+    /**
+     * @brief Key the processes of a container are grouped by
+     */
+    inline QString key() const
+    {
+        return QString("%1:%2").arg(int(kind)).arg(id);
+    }
+    inline bool operator==(const ContainerIdentity &other) const
+    {
+        return kind == other.kind && id == other.id;
+    }
+
+    /**
+     * @brief Identity told by a cgroup path of the unified hierarchy, the innermost known unit wins
+     */
+    static ContainerIdentity fromCgroup(const QString &cgroup);
+    /**
+     * @brief Identity of a process, from /proc/[pid]/cgroup & /proc/[pid]/ns/pid
+     * @param hostPidNamespace Pid namespace of this monitor, see pidNamespace()
+     */
+    static ContainerIdentity read(pid_t pid, const QString &hostPidNamespace);
+    /**
+     * @brief Link target of /proc/[pid]/ns/pid, e.g. pid:[4026531836], empty if not permitted
+     */
+    static QString pidNamespace(pid_t pid);
+    /**
+     * @brief Readable kind, e.g. Docker
+     */
+    static QString kindName(Kind kind);
+};
+
+/**
+ * @brief Usage of the processes of one container or app at a scan
+ */
+struct ContainerUsage {
+    ContainerIdentity identity;
+    qreal cpu {}; // percent
+    qulonglong memory {}; // resident memory in kB
+    qreal readBps {};
+    qreal writeBps {};
+    qreal recvBps {};
+    qreal sentBps {};
+    QList<pid_t> pids;
+};
+using ContainerUsages = QList<ContainerUsage>;
+using ContainerUsagesPtr = std::shared_ptr<const ContainerUsages>;
+
+} // namespace process
+} // namespace core
+
+#endif // CONTAINER_IDENTITY_H
@@ -0,0 +1,132 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "cpu_profile.h"
+#include "symbolizer.h"
+#include "process_info_record.h"
+#include "ddlog.h"
+
+#include <QHash>
+
+#include <algorithm>
+
+#include <string.h>
+
+using namespace DDLog;
+
+namespace core {
+namespace process {
+
+CpuProfile::CpuProfile()
+    : m_nodes(1)
+{
+}
+
+void CpuProfile::addStack(const QVector<frame_t> &frames, quint64 count)
+{
+    int node = 0;
+    m_nodes[0].samples += count;
+    for (const frame_t &frame : frames) {
+        int child = -1;
+        for (int index : m_nodes[node].children) {
+            const node_t &candidate = m_nodes[index];
+            if (candidate.function == frame.function && candidate.module == frame.module && candidate.kernel == frame.kernel) {
+                child = index;
+                break;
+            }
+        }
+        if (child < 0) {
+            node_t added;
+            added.function = frame.function;
+            added.module = frame.module;
+            added.kernel = frame.kernel;
+            added.parent = node;
+            child = m_nodes.size();
+            m_nodes << added;
+            m_nodes[node].children << child;
+        }
+        m_nodes[child].samples += count;
+        node = child;
+    }
+    m_nodes[node].self += count;
+}
+
+void CpuProfile::finish()
+{
+    for (node_t &node : m_nodes) {
+        std::sort(node.children.begin(), node.children.end(), [this](int a, int b) {
+            return m_nodes[a].function < m_nodes[b].function;
+        });
+    }
+}
+
+bool CpuProfile::fold(const QByteArray &profile, pid_t pid)
+{
+    const cpu_profile_stack_t *stacks = nullptr;
+    const cpu_profile_symbol_t *symbols = nullptr;
+    const cpu_profile_mapping_t *mappings = nullptr;
+    const cpu_profile_header_t *hdr = cpuProfileRecords(profile.constData(), size_t(profile.size()), stacks, symbols, mappings);
+    if (!hdr || hdr->state == CPU_PROFILE_RUNNING)
+        return false;
+
+    Symbolizer symbolizer(pid);
+    for (uint32_t i = 0; i < hdr->mappings; ++i) {
+        const cpu_profile_mapping_t &rec = mappings[i];
+        symbolizer.addMapping({rec.start, rec.end, rec.offset,
+                               QString::fromLocal8Bit(rec.path, int(strnlen(rec.path, sizeof(rec.path))))});
+    }
+    const cpu_profile_symbol_t *symbolsEnd = symbols + hdr->symbols;
+
+    // a function is seen in many stacks, each address is resolved once
+    QHash<quint64, frame_t> kernelFrames;
+    QHash<quint64, frame_t> userFrames;
+    for (uint32_t i = 0; i < hdr->stacks; ++i) {
+        const cpu_profile_stack_t &rec = stacks[i];
+        QVector<frame_t> frames;
+        frames.reserve(int(rec.depth));
+        for (uint32_t j = rec.depth; j-- > 0;) {
+            const quint64 ip = rec.ips[j];
+            if (j < rec.kernel_depth) {
+                auto it = kernelFrames.find(ip);
+                if (it == kernelFrames.end()) {
+                    frame_t frame {QString("0x%1").arg(ip, 0, 16), QStringLiteral("[kernel]"), true};
+                    auto sym = std::lower_bound(symbols, symbolsEnd, ip, [](const cpu_profile_symbol_t &s, quint64 ip) {
+                        return s.addr < ip;
+                    });
+                    if (sym != symbolsEnd && sym->addr == ip) {
+                        // "name [module]" for modules
+                        const QString name = QString::fromLatin1(sym->name, int(strnlen(sym->name, sizeof(sym->name))));
+                        const int space = name.indexOf(' ');
+                        frame.function = name.left(space);
+                        if (space > 0)
+                            frame.module = name.mid(space + 1).remove('[').remove(']');
+                    }
+                    it = kernelFrames.insert(ip, frame);
+                }
+                frames << it.value();
+                continue;
+            }
+
+            auto it = userFrames.find(ip);
+            if (it == userFrames.end()) {
+                // callers are at their return address, which may be past the end of the function
+                QString module;
+                QString function = symbolizer.symbolize(j > rec.kernel_depth ? ip - 1 : ip, &module);
+                if (function.isEmpty())
+                    function = QString("0x%1").arg(ip, 0, 16);
+                if (module.isEmpty())
+                    module = QStringLiteral("[unknown]");
+                it = userFrames.insert(ip, {function, module, false});
+            }
+            frames << it.value();
+        }
+        addStack(frames, rec.count);
+    }
+    finish();
+    qCDebug(app) << "Folded" << hdr->stacks << "stacks of" << hdr->samples << "samples into" << m_nodes.size() << "nodes";
+    return true;
+}
+
+} // namespace process
+} // namespace core
@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CPU_PROFILE_H
+#define CPU_PROFILE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Call chains of a cpu profile folded into a call tree, what a flame graph draws
+ *
+ * Frames are merged by function & module from the root down, so a function gets a node for
+ * each path it's called by. The root is the whole profile, its samples are all samples taken.
+ */
+class CpuProfile
+{
+public:
+    struct frame_t {
+        QString function;
+        QString module; // file name or kernel module, "[kernel]" for the kernel itself
+        bool kernel;
+    };
+
+    struct node_t {
+        QString function;
+        QString module;
+        bool kernel {false};
+        quint64 samples {0}; // of the node & its callees
+        quint64 self {0}; // of the node alone, on top of the stack
+        int parent {-1};
+        QVector<int> children;
+    };
+
+    CpuProfile();
+
+    /**
+     * @brief Count a call chain
+     * @param frames Outermost first
+     */
+    void addStack(const QVector<frame_t> &frames, quint64 count);
+    /**
+     * @brief Sort the children of each node by function, the order flame graphs are drawn in
+     */
+    void finish();
+
+    /**
+     * @brief Fold a getCpuProfile buffer, user frames are resolved from the files of its mappings
+     * @param pid Profiled process, its root is tried first for the files
+     * @return false if the buffer is malformed or of a profile still running
+     */
+    bool fold(const QByteArray &profile, pid_t pid);
+
+    inline const QVector<node_t> &nodes() const { return m_nodes; }
+    inline const node_t &root() const { return m_nodes.first(); }
+    inline quint64 samples() const { return m_nodes.first().samples; }
+
+private:
+    // node 0 is the root
+    QVector<node_t> m_nodes;
+};
+
+} // namespace process
+} // namespace core
+
+#endif // CPU_PROFILE_H
@@ -7,14 +7,24 @@
 #include "ddlog.h"
 
 #include "desktop_entry_cache_updater.h"
+#include "common/task_executor.h"
 
 #include <QFileInfo>
 #include <QDir>
 #include <DDesktopEntry>
 #include <QDebug>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
 
 DCORE_USE_NAMESPACE
 using namespace DDLog;
+using common::core::TaskExecutor;
 
 namespace core {
 namespace process {
@@ -22,9 +32,32 @@ namespace process {
 #define DESKTOP_ENTRY_PATH "/usr/share/applications"
 #define DESKTOP_ENTRY_SUFFIX ".desktop"
 
+// bump when desktop_entry_t or the parsing rules change, older caches are dropped
+const quint32 DiskCacheMagic = 0x44534d44; // DSMD
+const quint32 DiskCacheVersion = 2;
+
+// exec of sandboxed & wrapped apps, telling nothing of the app run
+static const QStringList ExecLaunchers = {"env", "flatpak", "ll-cli", "sh", "bash"};
+
+static QString execName(const QString &exec)
+{
+    return exec.mid(exec.lastIndexOf('/') + 1).toLower();
+}
+
 DesktopEntryCache::DesktopEntryCache()
 {
     qCDebug(app) << "DesktopEntryCache created";
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd < 0)
+        qCWarning(app) << "inotify unavailable, application dirs are only rescanned periodically:" << strerror(errno);
+    loadDiskCache();
+}
+
+DesktopEntryCache::~DesktopEntryCache()
+{
+    // lookups still running finish on the pool, their results are dropped
+    if (m_inotifyFd >= 0)
+        close(m_inotifyFd);
 }
 
 const DesktopEntry DesktopEntryCache::entryWithDesktopFile(const QString &desktopFile)
@@ -36,47 +69,296 @@ const DesktopEntry DesktopEntryCache::entryWithDesktopFile(const QString &deskto
         return {};
     }
 
-    auto entry = DesktopEntryCacheUpdater::createEntry(fileInfo);
+    auto entry = fileEntry(fileInfo);
     if (entry) {
         qCDebug(app) << "Entry created, updating cache for:" << fileInfo.fileName();
-        m_cache[fileInfo.fileName()] = entry;
-        m_cache[entry->name] = entry;
+        insertEntry(fileInfo.fileName(), entry);
     }
+    saveDiskCache();
     return entry;
 }
 
-QHash<QString, DesktopEntry> DesktopEntryCache::getCache()
+const DesktopEntry DesktopEntryCache::fileEntry(const QFileInfo &fileInfo)
 {
-    // qCDebug(app) << "Getting cache";
-    return m_cache;
+    auto path = fileInfo.filePath();
+    auto mtime = fileInfo.lastModified().toMSecsSinceEpoch();
+    auto it = m_files.find(path);
+    if (it != m_files.end() && it->mtime == mtime)
+        return it->entry;
+
+    cached_file_t file {mtime, {}, {}};
+    file.entry = DesktopEntryCacheUpdater::createEntry(fileInfo, &file.linglongId);
+    m_files[path] = file;
+    m_filesDirty = true;
+    if (file.entry && !file.linglongId.isEmpty())
+        lookupLinglongName(path, file.linglongId);
+    return file.entry;
 }
 
-void DesktopEntryCache::updateCache()
+void DesktopEntryCache::insertEntry(const QString &fileName, const DesktopEntry &entry)
 {
-    qCDebug(app) << "Updating cache";
+    ++m_generation;
+    m_cache[fileName] = entry;
+    m_keyIndex[fileName.toLower()] = entry;
+    if (!entry)
+        return;
+
+    // linglong apps are named once ll-cli answered
+    if (!entry->name.isEmpty()) {
+        m_cache[entry->name] = entry;
+        m_keyIndex[entry->name.toLower()] = entry;
+    }
+    if (!entry->exec.isEmpty()) {
+        auto exec = execName(entry->exec.first());
+        if (!exec.isEmpty() && !ExecLaunchers.contains(exec))
+            m_execIndex[exec] = entry;
+    }
+    if (!entry->startup_wm_class.isEmpty())
+        m_wmClassIndex[entry->startup_wm_class] = entry;
+    if (!entry->app_id.isEmpty())
+        m_appIdIndex[entry->app_id] = entry;
+    if (m_fileManagerKey.isEmpty() && fileName.contains("dde-file-manager") && entry->icon.contains("dde-file-manager"))
+        m_fileManagerKey = fileName;
+}
+
+void DesktopEntryCache::clearEntries()
+{
+    ++m_generation;
     m_cache.clear();
+    m_keyIndex.clear();
+    m_execIndex.clear();
+    m_wmClassIndex.clear();
+    m_appIdIndex.clear();
+    m_fileManagerKey.clear();
+}
+
+const DesktopEntry DesktopEntryCache::entryWithSubName(const QString &subName) const
+{
+    auto it = m_keyIndex.constFind(subName);
+    if (it != m_keyIndex.cend())
+        return *it;
+    auto entry = entryWithExec(subName);
+    if (entry)
+        return entry;
+    for (it = m_keyIndex.cbegin(); it != m_keyIndex.cend(); ++it) {
+        if (it.key().contains(subName))
+            return *it;
+    }
+    return {};
+}
+
+const DesktopEntry DesktopEntryCache::entryWithExec(const QString &exec) const
+{
+    return m_execIndex.value(execName(exec));
+}
+
+void DesktopEntryCache::lookupLinglongName(const QString &path, const QString &linglongId)
+{
+    for (const auto &lookup : m_linglongLookups) {
+        if (lookup.path == path)
+            return;
+    }
+    qCDebug(app) << "Asking ll-cli for the name of" << linglongId;
+    auto name = TaskExecutor::instance()->run(TaskExecutor::kBackgroundTask, [linglongId]() {
+        return DesktopEntryCacheUpdater::linglongAppName(linglongId);
+    });
+    m_linglongLookups << linglong_lookup_t {path, name};
+}
 
+void DesktopEntryCache::takeLinglongNames()
+{
+    for (auto it = m_linglongLookups.begin(); it != m_linglongLookups.end();) {
+        if (!it->name.isFinished()) {
+            ++it;
+            continue;
+        }
+        auto name = it->name.result();
+        auto file = m_files.find(it->path);
+        // files changed meanwhile are looked up again
+        if (file != m_files.end() && file->entry && !file->linglongId.isEmpty()) {
+            file->linglongId.clear();
+            file->entry->name = name;
+            insertEntry(QFileInfo(it->path).fileName(), file->entry);
+            m_filesDirty = true;
+        }
+        it = m_linglongLookups.erase(it);
+    }
+}
+
+QStringList DesktopEntryCache::applicationDirs() const
+{
     QString xdgDataDirPath(getenv("XDG_DATA_DIRS"));
     if (xdgDataDirPath.isEmpty()) {
         qCDebug(app) << "XDG_DATA_DIRS is empty, using default path";
-        auto fileInfoList = QDir(DESKTOP_ENTRY_PATH).entryInfoList(QDir::Files);
-        for (auto &fileInfo : fileInfoList) {
-            entryWithDesktopFile(fileInfo.filePath());
-        }
-    } else {
-        qCDebug(app) << "XDG_DATA_DIRS is set, using it:" << xdgDataDirPath;
+        return {DESKTOP_ENTRY_PATH};
+    }
+
+    qCDebug(app) << "XDG_DATA_DIRS is set, using it:" << xdgDataDirPath;
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        QStringList xdgDataDirPaths = xdgDataDirPath.split(":", QString::SkipEmptyParts);
+    QStringList xdgDataDirPaths = xdgDataDirPath.split(":", QString::SkipEmptyParts);
 #else
-        QStringList xdgDataDirPaths = xdgDataDirPath.split(":", Qt::SkipEmptyParts);
+    QStringList xdgDataDirPaths = xdgDataDirPath.split(":", Qt::SkipEmptyParts);
 #endif
-        for (auto path : xdgDataDirPaths) {
-            auto fileInfoList = QDir(path.trimmed() + "/applications").entryInfoList(QDir::Files);
-            for (auto &fileInfo : fileInfoList) {
-                entryWithDesktopFile(fileInfo.filePath());
-            }
+    QStringList dirs;
+    for (auto path : xdgDataDirPaths)
+        dirs << path.trimmed() + "/applications";
+    return dirs;
+}
+
+void DesktopEntryCache::updateCache()
+{
+    qCDebug(app) << "Updating cache";
+    takeLinglongNames();
+    clearEntries();
+
+    auto dirs = applicationDirs();
+    watchDirs(dirs);
+
+    // files gone since the last scan are forgotten
+    QHash<QString, cached_file_t> files;
+    for (auto &dir : dirs) {
+        auto fileInfoList = QDir(dir).entryInfoList(QDir::Files);
+        for (auto &fileInfo : fileInfoList) {
+            auto entry = fileEntry(fileInfo);
+            files[fileInfo.filePath()] = m_files[fileInfo.filePath()];
+            if (entry)
+                insertEntry(fileInfo.fileName(), entry);
+        }
+    }
+    if (files.size() != m_files.size())
+        m_filesDirty = true;
+    m_files.swap(files);
+
+    saveDiskCache();
+}
+
+void DesktopEntryCache::updateChanged()
+{
+    takeLinglongNames();
+    if (drainDirEvents()) {
+        qCDebug(app) << "Application dirs changed";
+        updateCache();
+    }
+    saveDiskCache();
+}
+
+void DesktopEntryCache::watchDirs(const QStringList &dirs)
+{
+    if (m_inotifyFd < 0)
+        return;
+
+    for (auto &dir : dirs) {
+        // dirs that don't exist yet are tried again with the next full scan
+        if (m_watchedDirs.contains(dir) || !QFileInfo(dir).isDir())
+            continue;
+        int wd = inotify_add_watch(m_inotifyFd, dir.toLocal8Bit().constData(),
+                                   IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB);
+        if (wd < 0) {
+            qCWarning(app) << "Failed to watch" << dir << strerror(errno);
+            continue;
+        }
+        m_watchedDirs << dir;
+    }
+}
+
+bool DesktopEntryCache::drainDirEvents()
+{
+    if (m_inotifyFd < 0)
+        return false;
+
+    // no need to tell events apart, any of them asks for a rescan
+    bool changed = false;
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    while (read(m_inotifyFd, buf, sizeof(buf)) > 0)
+        changed = true;
+    return changed;
+}
+
+QString DesktopEntryCache::diskCachePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/deepin/deepin-system-monitor/desktop_entry.cache";
+}
+
+void DesktopEntryCache::loadDiskCache()
+{
+    QFile file(diskCachePath());
+    if (!file.open(QIODevice::ReadOnly) || file.size() <= 0)
+        return;
+
+    // mapped instead of read, entries are copied out while parsing
+    uchar *data = file.map(0, file.size());
+    if (!data) {
+        qCWarning(app) << "Failed to map desktop entry cache" << file.errorString();
+        return;
+    }
+    QByteArray raw = QByteArray::fromRawData(reinterpret_cast<const char *>(data), int(file.size()));
+    QDataStream in(raw);
+    in.setVersion(QDataStream::Qt_5_11);
+
+    quint32 magic = 0, version = 0, count = 0;
+    in >> magic >> version >> count;
+    if (magic != DiskCacheMagic || version != DiskCacheVersion) {
+        qCDebug(app) << "Desktop entry cache outdated, dropped";
+        file.unmap(data);
+        return;
+    }
+
+    QHash<QString, cached_file_t> files;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString path;
+        cached_file_t cached {};
+        bool hasEntry = false;
+        in >> path >> cached.mtime >> cached.linglongId >> hasEntry;
+        if (hasEntry) {
+            cached.entry = std::make_shared<struct desktop_entry_t>();
+            in >> cached.entry->name >> cached.entry->displayName >> cached.entry->exec
+               >> cached.entry->icon >> cached.entry->startup_wm_class >> cached.entry->app_id;
+        }
+        files[path] = cached;
+    }
+    file.unmap(data);
+
+    if (in.status() != QDataStream::Ok) {
+        qCWarning(app) << "Desktop entry cache corrupted, dropped";
+        return;
+    }
+    m_files.swap(files);
+    qCDebug(app) << "Loaded" << m_files.size() << "cached desktop files";
+
+    // lookups of the last run that didn't finish
+    for (auto it = m_files.cbegin(); it != m_files.cend(); ++it) {
+        if (it->entry && !it->linglongId.isEmpty())
+            lookupLinglongName(it.key(), it->linglongId);
+    }
+}
+
+void DesktopEntryCache::saveDiskCache()
+{
+    if (!m_filesDirty)
+        return;
+    m_filesDirty = false;
+
+    auto path = diskCachePath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(app) << "Failed to write desktop entry cache" << file.errorString();
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_11);
+    out << DiskCacheMagic << DiskCacheVersion << quint32(m_files.size());
+    for (auto it = m_files.cbegin(); it != m_files.cend(); ++it) {
+        out << it.key() << it->mtime << it->linglongId << bool(it->entry);
+        if (it->entry) {
+            out << it->entry->name << it->entry->displayName << it->entry->exec
+                << it->entry->icon << it->entry->startup_wm_class << it->entry->app_id;
         }
     }
+    // replaced at once, a reader never sees half a cache
+    if (!file.commit())
+        qCWarning(app) << "Failed to write desktop entry cache" << file.errorString();
 }
 
 } // namespace process
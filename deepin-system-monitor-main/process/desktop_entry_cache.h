@@ -6,7 +6,10 @@
 #ifndef DESKTOP_ENTRY_CACHE_H
 #define DESKTOP_ENTRY_CACHE_H
 
+#include <QFileInfo>
+#include <QFuture>
 #include <QHash>
+#include <QStringList>
 
 #include <memory>
 
@@ -19,6 +22,7 @@ struct desktop_entry_t {
     QStringList exec;
     QString icon;
     QString startup_wm_class;
+    QString app_id; // flatpak or linglong app id
 };
 using DesktopEntry = std::shared_ptr<struct desktop_entry_t>;
 
@@ -26,50 +30,105 @@ class DesktopEntryCache
 {
 public:
     explicit DesktopEntryCache();
-    virtual ~DesktopEntryCache() = default;
+    virtual ~DesktopEntryCache();
 
     bool contains(const QString &name) const;
     const DesktopEntry entry(const QString &name) const;
     const DesktopEntry entryWithDesktopFile(const QString &desktopFile);
+    /**
+     * @brief Entry named subName, or whose exec is subName, or the first one with subName in its name
+     */
     const DesktopEntry entryWithSubName(const QString &subName) const;
-    QHash<QString, DesktopEntry> getCache();
+    /**
+     * @brief Entry whose exec file name is the one of exec, launchers like flatpak aren't matched
+     */
+    const DesktopEntry entryWithExec(const QString &exec) const;
+    const DesktopEntry entryWithWMClass(const QString &wmClass) const;
+    const DesktopEntry entryWithAppId(const QString &appId) const;
+    /**
+     * @brief Key of the file manager's entry, which shares its name with the home dir entry
+     */
+    inline QString fileManagerKey() const { return m_fileManagerKey; }
+    inline const QHash<QString, DesktopEntry> &getCache() const { return m_cache; }
+    /**
+     * @brief Bumped whenever entries change, names resolved from older entries are stale
+     */
+    inline quint64 generation() const { return m_generation; }
 
+    /**
+     * @brief Rescan all application dirs, only desktop files added or modified since they were cached get parsed
+     */
     void updateCache();
+    /**
+     * @brief Rescan when application dirs changed & pick up finished linglong lookups, nothing is waited for
+     */
+    void updateChanged();
 
+private:
+    // desktop file as parsed at mtime, entry is null when the file describes no app
+    struct cached_file_t {
+        qint64 mtime;
+        DesktopEntry entry;
+        QString linglongId; // set while the app name is to be asked from ll-cli
+    };
+    struct linglong_lookup_t {
+        QString path;
+        QFuture<QString> name;
+    };
+
+    QStringList applicationDirs() const;
+    const DesktopEntry fileEntry(const QFileInfo &fileInfo);
+    void insertEntry(const QString &fileName, const DesktopEntry &entry);
+    void clearEntries();
+    void lookupLinglongName(const QString &path, const QString &linglongId);
+    void takeLinglongNames();
+    void watchDirs(const QStringList &dirs);
+    /**
+     * @brief Read queued inotify events without blocking
+     * @return true if any application dir changed
+     */
+    bool drainDirEvents();
+    void loadDiskCache();
+    void saveDiskCache();
+    static QString diskCachePath();
 
 private:
     QHash<QString, DesktopEntry> m_cache;
+    // reverse indexes of m_cache, kept along with it
+    QHash<QString, DesktopEntry> m_keyIndex; // lower cased key
+    QHash<QString, DesktopEntry> m_execIndex; // file name of exec
+    QHash<QString, DesktopEntry> m_wmClassIndex;
+    QHash<QString, DesktopEntry> m_appIdIndex;
+    QString m_fileManagerKey;
+    QHash<QString, cached_file_t> m_files; // by desktop file path
+    QList<linglong_lookup_t> m_linglongLookups;
+    bool m_filesDirty {false};
+    quint64 m_generation {0};
+    int m_inotifyFd {-1};
+    QStringList m_watchedDirs;
 };
 
 inline bool DesktopEntryCache::contains(const QString &name) const
 {
-    for (auto &key : m_cache.keys()) {
-        if (key.toLower() == name.toLower())
-            return true;
-    }
-    return false;
+    return m_keyIndex.contains(name.toLower());
 }
 
 inline const DesktopEntry DesktopEntryCache::entry(const QString &name) const
 {
-    for (auto &key : m_cache.keys()) {
-        if (key.toLower() == name.toLower())
-            return m_cache[key];
-    }
+    auto it = m_keyIndex.constFind(name.toLower());
+    if (it != m_keyIndex.cend())
+        return *it;
     return std::make_shared<struct desktop_entry_t>();
 }
 
-inline const DesktopEntry DesktopEntryCache::entryWithSubName(const QString &subName) const
+inline const DesktopEntry DesktopEntryCache::entryWithWMClass(const QString &wmClass) const
+{
+    return m_wmClassIndex.value(wmClass.toLower());
+}
+
+inline const DesktopEntry DesktopEntryCache::entryWithAppId(const QString &appId) const
 {
-    for (auto &key : m_cache.keys()) {
-        if (key.toLower().compare(subName) == 0)
-            return m_cache[key];
-    }
-    for (auto &key : m_cache.keys()) {
-        if (key.toLower().contains(subName))
-            return m_cache[key];
-    }
-    return {};
+    return m_appIdIndex.value(appId);
 }
 
 } // namespace process
@@ -24,7 +24,7 @@ DesktopEntryCacheUpdater::DesktopEntryCacheUpdater(QObject *parent)
 {
 }
 
-DesktopEntry DesktopEntryCacheUpdater::createEntry(const QFileInfo &fileInfo)
+DesktopEntry DesktopEntryCacheUpdater::createEntry(const QFileInfo &fileInfo, QString *linglongId)
 {
     qCDebug(app) << "Creating desktop entry for file:" << fileInfo.filePath();
     if (!fileInfo.exists()) {
@@ -59,22 +59,11 @@ DesktopEntry DesktopEntryCacheUpdater::createEntry(const QFileInfo &fileInfo)
         auto linglongStr = dde.stringValue("X-linglong");
         if (!linglongStr.isEmpty()) {
             qCDebug(app) << "linglong string:" << linglongStr;
-            // Use QProcess to get application info
-            QProcess process;
-            process.start("/usr/bin/ll-cli", QStringList() << "info" << linglongStr);
-            process.waitForFinished(5000);
-            QString output = QString::fromUtf8(process.readAllStandardOutput());
-
-            // Parse JSON output to get name field
-            QJsonDocument jsonDoc = QJsonDocument::fromJson(output.toUtf8());
-            if (!jsonDoc.isNull() && jsonDoc.isObject()) {
-                qCDebug(app) << "Parsing linglong info json";
-                QJsonObject jsonObj = jsonDoc.object();
-                if (jsonObj.contains("name")) {
-                    entry->name = jsonObj["name"].toString();
-                    qCDebug(app) << "Found name in linglong json:" << entry->name;
-                }
-            }
+            entry->app_id = linglongStr;
+            if (linglongId)
+                *linglongId = linglongStr;
+            else
+                entry->name = linglongAppName(linglongStr);
 
             if (!exec.isEmpty()) {
                 qCDebug(app) << "Exec is not empty, use exec";
@@ -96,6 +85,10 @@ DesktopEntry DesktopEntryCacheUpdater::createEntry(const QFileInfo &fileInfo)
         qCDebug(app) << "Using dde.name():" << dde.name();
         entry->name = dde.name().toLower();
     }
+    // sandboxed flatpak apps run with their app id, not with the exec of the desktop file
+    auto flatpakId = dde.stringValue("X-Flatpak");
+    if (!flatpakId.isEmpty())
+        entry->app_id = flatpakId;
     // dde-file-manager plugins
     if (execStr.contains("dde-file-manager") && execStr.contains("plugin")) {
         qCDebug(app) << "Found dde-file-manager plugin";
@@ -119,10 +112,34 @@ DesktopEntry DesktopEntryCacheUpdater::createEntry(const QFileInfo &fileInfo)
         entry->startup_wm_class = wmclass;
         entry->name = wmclass;
     }
+    // named already, nothing to ask ll-cli for
+    if (linglongId && !entry->name.isEmpty())
+        linglongId->clear();
 
     qCDebug(app) << "Desktop entry created:" << entry->name;
     return entry;
 }
 
+QString DesktopEntryCacheUpdater::linglongAppName(const QString &linglongId)
+{
+    // Use QProcess to get application info
+    QProcess process;
+    process.start("/usr/bin/ll-cli", QStringList() << "info" << linglongId);
+    process.waitForFinished(5000);
+    QString output = QString::fromUtf8(process.readAllStandardOutput());
+
+    // Parse JSON output to get name field
+    QJsonDocument jsonDoc = QJsonDocument::fromJson(output.toUtf8());
+    if (!jsonDoc.isNull() && jsonDoc.isObject()) {
+        qCDebug(app) << "Parsing linglong info json";
+        QJsonObject jsonObj = jsonDoc.object();
+        if (jsonObj.contains("name")) {
+            qCDebug(app) << "Found name in linglong json:" << jsonObj["name"].toString();
+            return jsonObj["name"].toString();
+        }
+    }
+    return {};
+}
+
 } // namespace process
 } // namespace core
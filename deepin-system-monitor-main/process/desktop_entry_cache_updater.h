@@ -23,7 +23,15 @@ public:
     explicit DesktopEntryCacheUpdater(QObject *parent = nullptr);
     ~DesktopEntryCacheUpdater() override = default;
 
-    static DesktopEntry createEntry(const QFileInfo &fileInfo);
+    /**
+     * @brief Parse a desktop file
+     * @param linglongId when given, the name of a linglong app isn't asked from ll-cli but its app id returned here
+     */
+    static DesktopEntry createEntry(const QFileInfo &fileInfo, QString *linglongId = nullptr);
+    /**
+     * @brief Ask ll-cli for the name of a linglong app, blocks for up to 5s
+     */
+    static QString linglongAppName(const QString &linglongId);
 };
 
 } // namespace process
@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "exited_process_log.h"
+
+#include <algorithm>
+
+namespace core {
+namespace process {
+
+ExitedProcessLog::ExitedProcessLog(int capacity, qint64 window)
+    : m_ring(qMax(1, capacity))
+    , m_window(window)
+{
+}
+
+void ExitedProcessLog::add(const core::system::task_exit_t &exit, qint64 msecs)
+{
+    if (m_count == m_ring.size())
+        evictOldest();
+
+    record_t &record = m_ring[(m_head + m_count) % m_ring.size()];
+    record.name = exit.name;
+    record.cpuTime = exit.cpuTime;
+    record.msecs = msecs;
+    record.process = exit.isProcess();
+    ++m_count;
+
+    ExitedProcessRollup &rollup = m_rollups[exit.name];
+    rollup.name = exit.name;
+    ++rollup.tasks;
+    rollup.cpuTime += exit.cpuTime;
+    rollup.maxRss = qMax(rollup.maxRss, exit.maxRss);
+    if (record.process) {
+        ++rollup.processes;
+        rollup.maxElapsed = qMax(rollup.maxElapsed, exit.elapsed);
+        rollup.lastPid = exit.pid;
+    }
+    rollup.lastExit = msecs;
+    ++m_generation;
+}
+
+void ExitedProcessLog::expire(qint64 msecs)
+{
+    while (m_count > 0 && msecs - m_ring[m_head].msecs > m_window)
+        evictOldest();
+}
+
+void ExitedProcessLog::evictOldest()
+{
+    record_t &record = m_ring[m_head];
+    auto it = m_rollups.find(record.name);
+    if (it != m_rollups.end()) {
+        if (--it->tasks <= 0) {
+            m_rollups.erase(it);
+        } else {
+            it->cpuTime -= qMin(it->cpuTime, record.cpuTime);
+            if (record.process)
+                --it->processes;
+        }
+    }
+    record.name.clear();
+    m_head = (m_head + 1) % m_ring.size();
+    --m_count;
+    ++m_generation;
+}
+
+ExitedProcessRollups ExitedProcessLog::rollups() const
+{
+    ExitedProcessRollups rollups;
+    rollups.reserve(m_rollups.size());
+    for (const ExitedProcessRollup &rollup : m_rollups)
+        rollups << rollup;
+    std::sort(rollups.begin(), rollups.end(), [](const ExitedProcessRollup &a, const ExitedProcessRollup &b) {
+        return a.cpuTime > b.cpuTime || (a.cpuTime == b.cpuTime && a.name < b.name);
+    });
+    return rollups;
+}
+
+} // namespace process
+} // namespace core
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef EXITED_PROCESS_LOG_H
+#define EXITED_PROCESS_LOG_H
+
+#include "system/task_exit_monitor.h"
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+#include <memory>
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Tasks of one command name that exited recently
+ */
+struct ExitedProcessRollup {
+    QString name;
+    int processes {0}; // thread groups exited
+    int tasks {0}; // threads included
+    qulonglong cpuTime {0}; // utime + stime of all tasks, us
+    qulonglong maxRss {0}; // highest rss watermark, kB
+    qulonglong maxElapsed {0}; // longest lifetime, us
+    pid_t lastPid {0};
+    qint64 lastExit {0}; // ms since epoch
+};
+using ExitedProcessRollups = QList<ExitedProcessRollup>;
+using ExitedProcessRollupsPtr = std::shared_ptr<const ExitedProcessRollups>;
+
+/**
+ * @brief Recently exited tasks, rolled up by command name
+ *
+ * Exit records are kept in a ring of fixed capacity & summed into per name rollups, a record
+ * falling out of the ring or its time window is subtracted again. Memory is bounded by the
+ * ring whatever the exit rate, during an exec storm the oldest records go first. Peaks only
+ * restart once every record of a name has gone. Sampling thread only.
+ */
+class ExitedProcessLog
+{
+public:
+    explicit ExitedProcessLog(int capacity = kDefaultCapacity, qint64 window = kDefaultWindow);
+
+    /**
+     * @brief Record an exit at \a msecs, evicting the oldest record when the ring is full
+     */
+    void add(const core::system::task_exit_t &exit, qint64 msecs);
+    /**
+     * @brief Drop records older than the window at \a msecs
+     */
+    void expire(qint64 msecs);
+
+    inline int size() const
+    {
+        return m_count;
+    }
+    inline int capacity() const
+    {
+        return m_ring.size();
+    }
+    /**
+     * @brief Changes of the rollups so far, to tell whether they need to be published again
+     */
+    inline quint64 generation() const
+    {
+        return m_generation;
+    }
+    /**
+     * @brief Rollups of the records kept, most cpu time first
+     */
+    ExitedProcessRollups rollups() const;
+
+    static constexpr int kDefaultCapacity = 4096;
+    // ms records are kept for
+    static constexpr qint64 kDefaultWindow = 10 * 60 * 1000;
+
+private:
+    struct record_t {
+        QString name;
+        qulonglong cpuTime;
+        qint64 msecs;
+        bool process;
+    };
+
+    void evictOldest();
+
+    QVector<record_t> m_ring;
+    int m_head {0}; // oldest record
+    int m_count {0};
+    qint64 m_window;
+    QHash<QString, ExitedProcessRollup> m_rollups; // by name, records of the ring only
+    quint64 m_generation {0};
+};
+
+} // namespace process
+} // namespace core
+
+#endif // EXITED_PROCESS_LOG_H
@@ -0,0 +1,183 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "focused_sampler.h"
+#include "ddlog.h"
+#include "common/common.h"
+#include "common/proc_parser.h"
+
+#include <QTimer>
+
+#include <errno.h>
+#include <unistd.h>
+
+using namespace DDLog;
+using namespace common::init;
+using namespace common::parser;
+
+namespace core {
+namespace process {
+
+// a chart shows the last 30 samples
+static const size_t kHistorySize = 31;
+
+FocusedSampler::FocusedSampler(pid_t pid, QObject *parent)
+    : QObject(parent)
+    , m_pid(pid)
+    , m_fds()
+    , m_timer(new QTimer(this))
+    , m_cpus(qMax(1L, sysconf(_SC_NPROCESSORS_ONLN)))
+    , m_pageSize(qMax(1L, sysconf(_SC_PAGESIZE)))
+    , m_totalMemory(qMax(1L, sysconf(_SC_PHYS_PAGES)) * m_pageSize)
+    , m_cpu(kHistorySize)
+    , m_wait(kHistorySize)
+    , m_memory(kHistorySize)
+    , m_read(kHistorySize)
+    , m_write(kHistorySize)
+{
+    // a late tick would stretch the rate over a longer span than it's drawn at
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &FocusedSampler::sample);
+    m_clock.start();
+}
+
+void FocusedSampler::start(int interval)
+{
+    if (m_exited)
+        return;
+
+    qCDebug(app) << "Focused sampling of" << m_pid << "every" << interval << "ms";
+    // samples of an earlier run would be drawn right next to the new ones
+    m_interval = interval;
+    m_cpu.clear();
+    m_wait.clear();
+    m_memory.clear();
+    m_read.clear();
+    m_write.clear();
+    // the first tick only takes the counters rates start from
+    m_hasLast = false;
+    m_timer->start(m_interval);
+    sample();
+}
+
+void FocusedSampler::stop()
+{
+    m_timer->stop();
+    // nothing stays open for a dialog left on another page
+    m_fds.release(m_pid);
+}
+
+bool FocusedSampler::isActive() const
+{
+    return m_timer->isActive();
+}
+
+void FocusedSampler::sample()
+{
+    counters_t counters;
+    const bool ok = read(counters);
+    const qint64 now = m_clock.nsecsElapsed();
+    if (ok && !m_startTime)
+        m_startTime = counters.startTime;
+    // descriptors are reopened by pid, another process may have got it since
+    if (!ok || counters.startTime != m_startTime) {
+        qCDebug(app) << "Focused process" << m_pid << "exited";
+        m_exited = true;
+        stop();
+        Q_EMIT exited();
+        return;
+    }
+
+    if (m_hasLast && now > m_lastAt) {
+        const qreal secs = (now - m_lastAt) / 1e9;
+        // schedstat is in ns, ticks are too coarse at a tenth of a second
+        qreal run = counters.hasSchedStat ? (counters.runTime - m_last.runTime) / 1e9
+                                          : qreal(counters.cpuTicks - m_last.cpuTicks) / HZ;
+        qreal wait = counters.hasSchedStat ? (counters.waitTime - m_last.waitTime) / 1e9 : 0.;
+        m_cpu.push(qMax(0., run) / secs / m_cpus * 100);
+        m_wait.push(qMax(0., wait) / secs / m_cpus * 100);
+        m_memory.push(qreal(counters.residentPages * m_pageSize) / m_totalMemory * 100);
+        // write_bytes may drop once a write is cancelled, read as no io
+        m_read.push(counters.hasIO && counters.readBytes >= m_last.readBytes ? (counters.readBytes - m_last.readBytes) / secs : 0.);
+        m_write.push(counters.hasIO && counters.writeBytes >= m_last.writeBytes ? (counters.writeBytes - m_last.writeBytes) / secs : 0.);
+    }
+
+    m_last = counters;
+    m_lastAt = now;
+    const bool pushed = m_hasLast;
+    m_hasLast = true;
+    if (pushed)
+        Q_EMIT sampled();
+}
+
+bool FocusedSampler::read(counters_t &counters)
+{
+    char buf[1025];
+    ssize_t nr = m_fds.read(m_pid, ProcFdCache::kStatFile, buf, sizeof(buf));
+    if (nr < 0 || !parseStat(buf, size_t(nr), counters))
+        return false;
+    nr = m_fds.read(m_pid, ProcFdCache::kStatmFile, buf, sizeof(buf));
+    if (nr < 0 || !parseStatm(buf, size_t(nr), counters))
+        return false;
+    // both are optional, io needs ptrace access & schedstat CONFIG_SCHED_INFO
+    nr = m_fds.read(m_pid, ProcFdCache::kIOFile, buf, sizeof(buf));
+    counters.hasIO = nr >= 0 && parseIO(buf, size_t(nr), counters);
+    nr = m_fds.read(m_pid, ProcFdCache::kSchedStatFile, buf, sizeof(buf));
+    counters.hasSchedStat = nr >= 0 && parseSchedStat(buf, size_t(nr), counters);
+    return true;
+}
+
+bool FocusedSampler::parseStat(const char *buf, size_t len, counters_t &counters)
+{
+    const char *comm, *rest;
+    size_t commLen;
+    if (!splitStatComm(buf, len, comm, commLen, rest))
+        return false;
+
+    unsigned long long utime, stime;
+    Tokenizer tok(rest, size_t(buf + len - rest));
+    if (!(tok.skipTokens(11) // 3 ~ 13
+          && tok.readU64(utime) // 14
+          && tok.readU64(stime) // 15
+          && tok.skipTokens(6) // 16 ~ 21
+          && tok.readU64(counters.startTime))) // 22
+        return false;
+    counters.cpuTicks = utime + stime;
+    return true;
+}
+
+bool FocusedSampler::parseStatm(const char *buf, size_t len, counters_t &counters)
+{
+    // size, resident, shared... in pages
+    Tokenizer tok(buf, len);
+    return tok.skipTokens(1) && tok.readU64(counters.residentPages);
+}
+
+bool FocusedSampler::parseIO(const char *buf, size_t len, counters_t &counters)
+{
+    Tokenizer tok(buf, len);
+    const char *key;
+    size_t keyLen;
+    int found = 0;
+    do {
+        if (!tok.readKey(key, keyLen))
+            continue;
+
+        if (keyEquals(key, keyLen, "read_bytes", 10) && tok.readU64(counters.readBytes))
+            ++found;
+        else if (keyEquals(key, keyLen, "write_bytes", 11) && tok.readU64(counters.writeBytes))
+            ++found;
+    } while (found < 2 && tok.nextLine());
+    return found == 2;
+}
+
+bool FocusedSampler::parseSchedStat(const char *buf, size_t len, counters_t &counters)
+{
+    // on cpu time, run queue wait time, timeslices
+    Tokenizer tok(buf, len);
+    return tok.readU64(counters.runTime) && tok.readU64(counters.waitTime);
+}
+
+} // namespace process
+} // namespace core
@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef FOCUSED_SAMPLER_H
+#define FOCUSED_SAMPLER_H
+
+#include "proc_fd_cache.h"
+#include "common/series_ring.h"
+
+#include <QElapsedTimer>
+#include <QObject>
+
+#include <stddef.h>
+#include <sys/types.h>
+
+class QTimer;
+
+namespace core {
+namespace process {
+
+/**
+ * @brief High rate sampler of a single process, e.g. for the process attributes dialog
+ *
+ * Reads stat, statm, io & schedstat of the process alone through descriptors kept open,
+ * a few preads per tick, so the global scan & the other processes are left alone. Samples
+ * are rates over the last tick, kept in series charts follow.
+ */
+class FocusedSampler : public QObject
+{
+    Q_OBJECT
+
+public:
+    // intervals offered, ms
+    enum Interval {
+        kInterval100ms = 100,
+        kInterval250ms = 250,
+        kInterval500ms = 500
+    };
+
+    // counters of one read, rates are taken between two of them
+    struct counters_t {
+        unsigned long long cpuTicks {0}; // utime + stime
+        unsigned long long startTime {0}; // ticks after boot, tells a recycled pid
+        unsigned long long runTime {0}; // ns on cpu, 0 without schedstat
+        unsigned long long waitTime {0}; // ns waiting on a run queue
+        unsigned long long residentPages {0};
+        unsigned long long readBytes {0};
+        unsigned long long writeBytes {0};
+        bool hasSchedStat {false};
+        bool hasIO {false}; // io of other users' processes isn't readable
+    };
+
+    explicit FocusedSampler(pid_t pid, QObject *parent = nullptr);
+
+    /**
+     * @brief Start sampling every interval ms, over from empty series
+     */
+    void start(int interval = kInterval250ms);
+    void stop();
+    bool isActive() const;
+    inline int interval() const
+    {
+        return m_interval;
+    }
+    inline bool hasExited() const
+    {
+        return m_exited;
+    }
+    inline bool hasIO() const
+    {
+        return m_last.hasIO;
+    }
+
+    // cpu time & run queue wait, percent of all cpus
+    inline const common::core::SeriesRing &cpuSeries() const
+    {
+        return m_cpu;
+    }
+    inline const common::core::SeriesRing &waitSeries() const
+    {
+        return m_wait;
+    }
+    // resident memory, percent of the physical memory
+    inline const common::core::SeriesRing &memorySeries() const
+    {
+        return m_memory;
+    }
+    // disk read & write, bytes per second
+    inline const common::core::SeriesRing &readSeries() const
+    {
+        return m_read;
+    }
+    inline const common::core::SeriesRing &writeSeries() const
+    {
+        return m_write;
+    }
+    /**
+     * @brief Resident memory of the last read, bytes
+     */
+    inline unsigned long long residentBytes() const
+    {
+        return m_last.residentPages * m_pageSize;
+    }
+
+    /**
+     * @brief Parse cpu ticks (fields 14 & 15) & start time (field 22) of /proc/[pid]/stat
+     */
+    static bool parseStat(const char *buf, size_t len, counters_t &counters);
+    static bool parseStatm(const char *buf, size_t len, counters_t &counters);
+    static bool parseIO(const char *buf, size_t len, counters_t &counters);
+    static bool parseSchedStat(const char *buf, size_t len, counters_t &counters);
+
+Q_SIGNALS:
+    /**
+     * @brief New samples were pushed to the series
+     */
+    void sampled();
+    /**
+     * @brief The process exited or its pid got recycled, sampling stopped
+     */
+    void exited();
+
+public Q_SLOTS:
+    void sample();
+
+private:
+    bool read(counters_t &counters);
+
+    pid_t m_pid;
+    ProcFdCache m_fds;
+    QTimer *m_timer;
+    int m_interval {kInterval250ms};
+    QElapsedTimer m_clock;
+    qint64 m_lastAt {0};
+    counters_t m_last;
+    bool m_hasLast {false};
+    bool m_exited {false};
+    // start time of the process first read
+    unsigned long long m_startTime {0};
+    long m_cpus;
+    unsigned long long m_pageSize;
+    unsigned long long m_totalMemory;
+
+    common::core::SeriesRing m_cpu;
+    common::core::SeriesRing m_wait;
+    common::core::SeriesRing m_memory;
+    common::core::SeriesRing m_read;
+    common::core::SeriesRing m_write;
+};
+
+} // namespace process
+} // namespace core
+
+#endif // FOCUSED_SAMPLER_H
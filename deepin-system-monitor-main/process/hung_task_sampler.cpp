@@ -0,0 +1,203 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "hung_task_sampler.h"
+#include "system_service_client.h"
+#include "process_info_record.h"
+#include "ddlog.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PROC_WCHAN_PATH "/proc/%d/wchan"
+
+using namespace DDLog;
+
+namespace core {
+namespace process {
+
+namespace {
+
+struct wait_prefix_t {
+    const char *prefix;
+    HungTaskSampler::WaitKind wait;
+};
+
+// frames every sleeping task has on top, the caller tells what it waits for
+const char *const kGenericFrames[] = {
+    "__schedule", "schedule", "preempt_schedule", "io_schedule", "bit_wait", "__wait_on_bit",
+    "out_of_line_wait_on_bit", "wait_for_completion", "__wait_for_common", "do_wait_for_common",
+    "wait_on_page_bit", "folio_wait_bit", "__folio_lock", "__lock_page", "rwsem_down_", "down_read",
+    "down_write", "__down", "__mutex_lock", "mutex_lock", "__rt_mutex", "rt_mutex",
+};
+
+// most specific first, an nfs page wait ends in io_schedule like a local disk's
+const wait_prefix_t kWaitPrefixes[] = {
+    {"nfs_", HungTaskSampler::kWaitNfs},
+    {"nfs4_", HungTaskSampler::kWaitNfs},
+    {"rpc_", HungTaskSampler::kWaitNfs},
+    {"__rpc_", HungTaskSampler::kWaitNfs},
+    {"xprt_", HungTaskSampler::kWaitNfs},
+    {"cifs_", HungTaskSampler::kWaitNetworkFs},
+    {"smb2_", HungTaskSampler::kWaitNetworkFs},
+    {"ceph_", HungTaskSampler::kWaitNetworkFs},
+    {"fuse_", HungTaskSampler::kWaitFuse},
+    {"request_wait_answer", HungTaskSampler::kWaitFuse},
+    {"shrink_", HungTaskSampler::kWaitMemory},
+    {"try_to_free_", HungTaskSampler::kWaitMemory},
+    {"__alloc_pages_slowpath", HungTaskSampler::kWaitMemory},
+    {"compact_", HungTaskSampler::kWaitMemory},
+    {"io_schedule", HungTaskSampler::kWaitDisk},
+    {"blk_", HungTaskSampler::kWaitDisk},
+    {"submit_bio", HungTaskSampler::kWaitDisk},
+    {"jbd2_", HungTaskSampler::kWaitDisk},
+    {"balance_dirty_pages", HungTaskSampler::kWaitDisk},
+    {"__wait_on_buffer", HungTaskSampler::kWaitDisk},
+    {"folio_wait_writeback", HungTaskSampler::kWaitDisk},
+    {"wait_on_page_writeback", HungTaskSampler::kWaitDisk},
+    {"rwsem_down_", HungTaskSampler::kWaitLock},
+    {"__mutex_lock", HungTaskSampler::kWaitLock},
+    {"__rt_mutex", HungTaskSampler::kWaitLock},
+};
+
+} // namespace
+
+HungTaskSampler::HungTaskSampler(SystemServiceClient *client)
+    : m_client(client)
+{
+}
+
+void HungTaskSampler::sample(const QList<task_t> &tasks)
+{
+    QList<pid_t> pids;
+    QHash<pid_t, entry_t> entries;
+    for (const task_t &task : tasks) {
+        if (pids.size() >= KERNEL_STACKS_MAX_PIDS)
+            break;
+        pids << task.pid;
+        entry_t entry = m_entries.value(task.pid);
+        // pid reused since the last sample
+        if (entry.startTime != task.startTime) {
+            entry = entry_t();
+            entry.startTime = task.startTime;
+        }
+        entries.insert(task.pid, entry);
+    }
+    m_entries.swap(entries);
+    if (pids.isEmpty())
+        return;
+    qCDebug(app) << "Sampling kernel stacks of" << pids.size() << "hung processes";
+
+    // processes woken meanwhile are left out by the server & keep their counts
+    QByteArray stacks;
+    if (m_client && m_client->getKernelStacks(pids, stacks)) {
+        const kernel_stack_record_t *records = nullptr;
+        const kernel_stacks_header_t *hdr = kernelStackRecords(stacks.constData(), size_t(stacks.size()), records);
+        for (uint32_t i = 0; i < hdr->count; ++i) {
+            const kernel_stack_record_t &rec = records[i];
+            auto it = m_entries.find(pid_t(rec.pid));
+            if (it == m_entries.end())
+                continue;
+            const QByteArray stack(rec.stack, int(strnlen(rec.stack, sizeof(rec.stack))));
+            record(it.value(), stack.split('\n'));
+        }
+        return;
+    }
+
+    // a single frame, the function the process sleeps in
+    for (pid_t pid : pids) {
+        const QByteArray wchan = readWchan(pid);
+        if (!wchan.isEmpty())
+            record(m_entries[pid], {wchan});
+    }
+}
+
+void HungTaskSampler::record(entry_t &entry, const QByteArrayList &frames)
+{
+    const QByteArray function = blockingFunction(frames);
+    if (function.isEmpty())
+        return;
+
+    const int count = ++entry.counts[function];
+    entry.waits[function] = waitKind(frames);
+    ++entry.hint.total;
+    if (count >= entry.hint.samples) {
+        entry.hint.function = function;
+        entry.hint.samples = count;
+    }
+    entry.hint.wait = WaitKind(entry.waits.value(entry.hint.function));
+}
+
+bool HungTaskSampler::lookup(pid_t pid, qulonglong startTime, hint_t &hint) const
+{
+    auto it = m_entries.constFind(pid);
+    if (it == m_entries.constEnd() || it->startTime != startTime || !it->hint.samples)
+        return false;
+    hint = it->hint;
+    return true;
+}
+
+QByteArray HungTaskSampler::blockingFunction(const QByteArrayList &frames)
+{
+    for (const QByteArray &frame : frames) {
+        if (frame.isEmpty())
+            continue;
+        bool generic = false;
+        for (const char *prefix : kGenericFrames) {
+            if (frame.startsWith(prefix)) {
+                generic = true;
+                break;
+            }
+        }
+        if (!generic)
+            return frame;
+    }
+    // nothing but waits, e.g. wchan alone
+    for (const QByteArray &frame : frames) {
+        if (!frame.isEmpty())
+            return frame;
+    }
+    return {};
+}
+
+HungTaskSampler::WaitKind HungTaskSampler::waitKind(const QByteArrayList &frames)
+{
+    for (const wait_prefix_t &wait : kWaitPrefixes) {
+        for (const QByteArray &frame : frames) {
+            if (frame.startsWith(wait.prefix))
+                return wait.wait;
+        }
+    }
+    return kWaitUnknown;
+}
+
+QByteArray HungTaskSampler::readWchan(pid_t pid)
+{
+    char path[64];
+    snprintf(path, sizeof(path), PROC_WCHAN_PATH, pid);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return {};
+
+    char buf[128];
+    ssize_t nr;
+    do {
+        nr = read(fd, buf, sizeof(buf) - 1);
+    } while (nr < 0 && errno == EINTR);
+    close(fd);
+    if (nr <= 0)
+        return {};
+
+    // "0" when the process is running or wchan is hidden from the reader
+    QByteArray wchan = QByteArray(buf, int(nr)).trimmed();
+    if (wchan.isEmpty() || wchan == "0")
+        return {};
+    return wchan;
+}
+
+} // namespace process
+} // namespace core
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef HUNG_TASK_SAMPLER_H
+#define HUNG_TASK_SAMPLER_H
+
+#include <QByteArray>
+#include <QByteArrayList>
+#include <QHash>
+#include <QList>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+class SystemServiceClient;
+
+/**
+ * @brief Where processes stuck in uninterruptible sleep (D) wait, from their kernel stacks
+ *
+ * ProcessSet tells the hung processes from the state of stat, nothing is read for the others.
+ * Each scan the kernel stacks of those are taken through the system server, /proc/[pid]/stack
+ * is root only, or their wchan without it. The blocking function seen most over the samples of
+ * a process is its hint, a single sample may catch it anywhere on its way.
+ */
+class HungTaskSampler
+{
+public:
+    // what the blocking functions point at, by kernel subsystem
+    enum WaitKind {
+        kWaitUnknown = 0,
+        kWaitDisk, // block io, page & buffer writeback of local filesystems
+        kWaitNfs, // an nfs server, or the rpc transport to it
+        kWaitNetworkFs, // cifs/smb & ceph servers
+        kWaitFuse, // the daemon of a fuse filesystem
+        kWaitMemory, // direct reclaim & compaction
+        kWaitLock // a kernel mutex or rw semaphore held by another task
+    };
+
+    struct task_t {
+        pid_t pid;
+        qulonglong startTime; // tells a reused pid apart
+    };
+
+    struct hint_t {
+        QByteArray function; // blocking function seen most, e.g. nfs_wait_bit_killable
+        WaitKind wait {kWaitUnknown};
+        int samples {0}; // stacks the function was seen in
+        int total {0}; // stacks sampled
+    };
+
+    explicit HungTaskSampler(SystemServiceClient *client = nullptr);
+
+    /**
+     * @brief Sample the stacks of hung processes, the ones sampled before & missing are dropped
+     * @param tasks Longest blocked first, only the first KERNEL_STACKS_MAX_PIDS are sampled
+     */
+    void sample(const QList<task_t> &tasks);
+    bool lookup(pid_t pid, qulonglong startTime, hint_t &hint) const;
+
+    /**
+     * @brief Innermost frame that isn't the scheduler or a generic wait primitive
+     * @param frames Function names, innermost first
+     */
+    static QByteArray blockingFunction(const QByteArrayList &frames);
+    static WaitKind waitKind(const QByteArrayList &frames);
+    /**
+     * @brief Read /proc/[pid]/wchan, empty if not permitted or the process is running
+     */
+    static QByteArray readWchan(pid_t pid);
+
+private:
+    struct entry_t {
+        qulonglong startTime {0};
+        QHash<QByteArray, int> counts; // samples by blocking function
+        QHash<QByteArray, int> waits; // WaitKind of the last stack of each function
+        hint_t hint;
+    };
+    void record(entry_t &entry, const QByteArrayList &frames);
+
+    SystemServiceClient *m_client;
+    QHash<pid_t, entry_t> m_entries;
+};
+
+} // namespace process
+} // namespace core
+
+#endif // HUNG_TASK_SAMPLER_H
@@ -0,0 +1,224 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "memory_maps.h"
+#include "common/proc_parser.h"
+#include "ddlog.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PROC_MAPS_PATH "/proc/%d/maps"
+#define PROC_SMAPS_PATH "/proc/%d/smaps"
+
+using namespace common::parser;
+using namespace DDLog;
+
+namespace core {
+namespace process {
+
+// bytes read at a time, a few hundred mappings
+static const int kChunkSize = 64 * 1024;
+
+static inline bool startsWith(const char *str, size_t len, const char *prefix)
+{
+    size_t n = strlen(prefix);
+    return len >= n && !memcmp(str, prefix, n);
+}
+
+static bool readHex(const char *&p, const char *end, unsigned long long &v)
+{
+    const char *begin = p;
+    v = 0;
+    for (; p < end; ++p) {
+        char c = *p;
+        if (isDigit(c))
+            v = (v << 4) | (unsigned long long)(c - '0');
+        else if (c >= 'a' && c <= 'f')
+            v = (v << 4) | (unsigned long long)(c - 'a' + 10);
+        else
+            break;
+    }
+    return p > begin;
+}
+
+MemoryMaps::MemoryMaps(pid_t pid, bool detailed)
+    : m_pid(pid)
+    , m_detailed(detailed)
+{
+}
+
+MemoryMaps::~MemoryMaps()
+{
+    if (m_fd >= 0)
+        close(m_fd);
+}
+
+bool MemoryMaps::open()
+{
+    char path[64];
+    snprintf(path, sizeof(path), m_detailed ? PROC_SMAPS_PATH : PROC_MAPS_PATH, m_pid);
+    m_fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (m_fd < 0) {
+        m_error = errno;
+        qCDebug(app) << "Failed to open" << path << strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool MemoryMaps::next(RegionList &regions, int maxMappings)
+{
+    if (m_fd < 0)
+        return false;
+
+    // regions are merged within a call, the caller merges the calls
+    QHash<QString, int> index;
+    const int first = m_mappings;
+    while (m_mappings - first < maxMappings) {
+        const int kept = m_buffer.size();
+        m_buffer.resize(kept + kChunkSize);
+        ssize_t nr;
+        do {
+            nr = ::read(m_fd, m_buffer.data() + kept, kChunkSize);
+        } while (nr < 0 && errno == EINTR);
+        if (nr <= 0) {
+            m_error = nr < 0 ? errno : 0;
+            m_buffer.resize(kept);
+            // the last line may come without a line break
+            if (nr == 0 && kept > 0) {
+                m_buffer.append('\n');
+                parseLines(m_buffer.constData(), size_t(m_buffer.size()), regions, index);
+            }
+            m_buffer.clear();
+            if (m_pending)
+                flush(regions, index);
+            close(m_fd);
+            m_fd = -1;
+            return false;
+        }
+
+        m_buffer.resize(kept + int(nr));
+        size_t used = parseLines(m_buffer.constData(), size_t(m_buffer.size()), regions, index);
+        m_buffer.remove(0, int(used));
+    }
+    return true;
+}
+
+size_t MemoryMaps::parseLines(const char *buf, size_t len, RegionList &regions, QHash<QString, int> &index)
+{
+    const char *line = buf;
+    const char *end = buf + len;
+    const char *eol;
+    while (line < end && (eol = static_cast<const char *>(memchr(line, '\n', size_t(end - line))))) {
+        const size_t lineLen = size_t(eol - line);
+        mapping_t mapping;
+        if (parseMapping(line, lineLen, mapping)) {
+            if (m_pending)
+                flush(regions, index);
+            const RegionType type = regionType(mapping);
+            m_current = region_t();
+            // anonymous mappings are one region, unless named with PR_SET_VMA_ANON_NAME
+            if (type != kRegionAnon || mapping.pathLen)
+                m_current.name = QString::fromLocal8Bit(mapping.path, int(mapping.pathLen));
+            m_current.type = type;
+            m_current.mappings = 1;
+            m_current.size = (mapping.end - mapping.start) >> 10;
+            m_pending = true;
+            ++m_mappings;
+            if (!m_detailed)
+                flush(regions, index);
+        } else if (m_pending) {
+            // Rss & Pss lines of the mapping above, in kB
+            Tokenizer tok(line, lineLen);
+            const char *key;
+            size_t keyLen;
+            if (tok.readKey(key, keyLen)) {
+                if (keyEquals(key, keyLen, "Rss", 3))
+                    tok.readU64(m_current.rss);
+                else if (keyEquals(key, keyLen, "Pss", 3))
+                    tok.readU64(m_current.pss);
+            }
+        }
+        line = eol + 1;
+    }
+    return size_t(line - buf);
+}
+
+void MemoryMaps::flush(RegionList &regions, QHash<QString, int> &index)
+{
+    m_pending = false;
+    const QString key = regionKey(m_current);
+    auto it = index.constFind(key);
+    if (it == index.constEnd()) {
+        index.insert(key, regions.size());
+        regions << m_current;
+        return;
+    }
+
+    region_t &region = regions[it.value()];
+    region.mappings += m_current.mappings;
+    region.size += m_current.size;
+    region.rss += m_current.rss;
+    region.pss += m_current.pss;
+}
+
+bool MemoryMaps::parseMapping(const char *line, size_t len, mapping_t &mapping)
+{
+    // start-end perms offset dev inode path
+    const char *p = line;
+    const char *end = line + len;
+    if (!readHex(p, end, mapping.start) || p >= end || *p != '-')
+        return false;
+    ++p;
+    if (!readHex(p, end, mapping.end) || p >= end || *p != ' ' || mapping.end < mapping.start)
+        return false;
+    ++p;
+    if (end - p < 4)
+        return false;
+    mapping.shared = p[3] == 's';
+    p += 4;
+
+    Tokenizer tok(p, size_t(end - p));
+    if (!(tok.skipTokens(2) && tok.readU64(mapping.inode)))
+        return false;
+    tok.skipBlanks();
+    // paths may have spaces, e.g. "/memfd:name (deleted)"
+    mapping.path = tok.pos();
+    mapping.pathLen = size_t(end - tok.pos());
+    while (mapping.pathLen && isSpace(mapping.path[mapping.pathLen - 1]))
+        --mapping.pathLen;
+    return true;
+}
+
+MemoryMaps::RegionType MemoryMaps::regionType(const mapping_t &mapping)
+{
+    const char *path = mapping.path;
+    const size_t len = mapping.pathLen;
+    if (!len)
+        return mapping.shared ? kRegionShm : kRegionAnon;
+
+    if (path[0] == '[') {
+        if (startsWith(path, len, "[heap]"))
+            return kRegionHeap;
+        // [stack:tid] of threads before linux 4.5
+        if (startsWith(path, len, "[stack"))
+            return kRegionStack;
+        if (startsWith(path, len, "[anon_shmem:"))
+            return kRegionShm;
+        if (startsWith(path, len, "[anon:"))
+            return kRegionAnon;
+        return kRegionKernel;
+    }
+    // posix shm, memfd & sysv shm segments are shown as files
+    if (startsWith(path, len, "/dev/shm/") || startsWith(path, len, "/memfd:") || startsWith(path, len, "/SYSV"))
+        return kRegionShm;
+    return kRegionFile;
+}
+
+} // namespace process
+} // namespace core
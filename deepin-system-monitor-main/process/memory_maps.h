@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef MEMORY_MAPS_H
+#define MEMORY_MAPS_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include <stddef.h>
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Streaming reader of /proc/[pid]/maps or smaps, mappings aggregated into regions
+ *
+ * maps is read a chunk at a time & parsed as it comes, so a process with 100k mappings never
+ * has its whole maps in memory, each call of next() hands over the regions of the mappings it
+ * parsed. smaps walks the page tables of every mapping for the rss & pss, it's only read on
+ * request. Both fail for processes of other users.
+ */
+class MemoryMaps
+{
+public:
+    enum RegionType {
+        kRegionFile = 0, // file backed, by path
+        kRegionAnon, // anonymous private mappings, all in one region
+        kRegionHeap, // [heap], brk area
+        kRegionStack, // [stack] of the main thread
+        kRegionShm, // shared anonymous, shm & memfd
+        kRegionKernel, // [vdso], [vvar], [vsyscall]...
+
+        kRegionTypeCount
+    };
+
+    // a line of maps, the path points into the parsed buffer
+    struct mapping_t {
+        unsigned long long start {0};
+        unsigned long long end {0};
+        bool shared {false};
+        unsigned long long inode {0};
+        const char *path {nullptr};
+        size_t pathLen {0};
+    };
+
+    // mappings of one backing file or type, sizes in kB
+    struct region_t {
+        QString name; // path, [heap]... empty for anonymous mappings
+        int type {kRegionAnon};
+        int mappings {0};
+        qulonglong size {0};
+        qulonglong rss {0};
+        qulonglong pss {0};
+    };
+    typedef QList<region_t> RegionList;
+
+    /**
+     * @param detailed Read smaps for the rss & pss of each mapping instead of maps
+     */
+    MemoryMaps(pid_t pid, bool detailed);
+    ~MemoryMaps();
+
+    /**
+     * @return false with errno set if the file can't be opened
+     */
+    bool open();
+    /**
+     * @brief Parse the next chunks, at least \a maxMappings mappings unless the end is reached
+     * @param regions Regions of the mappings parsed, a region may come again in later calls
+     * @return false once the end was reached or reading failed, see error()
+     */
+    bool next(RegionList &regions, int maxMappings);
+    /**
+     * @brief errno of the failed read, 0 at the end of the file
+     */
+    inline int error() const
+    {
+        return m_error;
+    }
+    // mappings parsed so far
+    inline int mappings() const
+    {
+        return m_mappings;
+    }
+
+    /**
+     * @brief Parse a mapping line of maps, e.g. 7f2b5c000000-7f2b5c021000 rw-p 00000000 00:00 0   [heap]
+     * @return false for the Key: value lines of smaps & malformed lines
+     */
+    static bool parseMapping(const char *line, size_t len, mapping_t &mapping);
+    static RegionType regionType(const mapping_t &mapping);
+    /**
+     * @brief Key mappings of the same region share, type & name
+     */
+    static inline QString regionKey(const region_t &region)
+    {
+        return QString::number(region.type) + ':' + region.name;
+    }
+
+private:
+    MemoryMaps(const MemoryMaps &) = delete;
+    MemoryMaps &operator=(const MemoryMaps &) = delete;
+
+    // parse the complete lines of the buffer, returns the bytes consumed
+    size_t parseLines(const char *buf, size_t len, RegionList &regions, QHash<QString, int> &index);
+    void flush(RegionList &regions, QHash<QString, int> &index);
+
+    pid_t m_pid;
+    bool m_detailed;
+    int m_fd {-1};
+    int m_error {0};
+    int m_mappings {0};
+    // chunks read but not parsed yet, ends with the line cut by the last one
+    QByteArray m_buffer;
+    // mapping parsed last, kept until the smaps lines after it are read
+    bool m_pending {false};
+    region_t m_current;
+};
+
+} // namespace process
+} // namespace core
+
+#endif // MEMORY_MAPS_H
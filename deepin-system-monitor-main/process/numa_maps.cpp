@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "numa_maps.h"
+#include "common/proc_parser.h"
+#include "ddlog.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PROC_NUMA_MAPS_PATH "/proc/%d/numa_maps"
+
+using namespace common::parser;
+using namespace DDLog;
+
+namespace core {
+namespace process {
+
+bool NumaMaps::parse(const char *buf, size_t len, QMap<int, qulonglong> &nodes)
+{
+    /*样例数据:
+        55d4c2a00000 default file=/usr/bin/bash mapped=44 mapcount=3 N0=40 N1=4 kernelpagesize_kB=4
+        7f2b5c000000 default anon=1536 dirty=1536 active=0 N1=1536 kernelpagesize_kB=4
+    */
+    static const char kPageSizeKey[] = "kernelpagesize_kB=";
+    bool found = false;
+    Tokenizer tok(buf, len);
+    do {
+        const char *field;
+        size_t fieldLen;
+        if (!tok.readToken(field, fieldLen))
+            continue;
+        found = true;
+
+        // pages per node come before the page size of the mapping
+        QMap<int, qulonglong> pages;
+        unsigned long long pageSize = 4;
+        while (tok.readToken(field, fieldLen)) {
+            if (fieldLen > 2 && field[0] == 'N' && isDigit(field[1])) {
+                Tokenizer value(field + 1, fieldLen - 1);
+                unsigned long long node = 0, count = 0;
+                if (value.readU64(node) && value.consume('=') && value.readU64(count))
+                    pages[int(node)] += count;
+            } else if (fieldLen > sizeof(kPageSizeKey) - 1 && !memcmp(field, kPageSizeKey, sizeof(kPageSizeKey) - 1)) {
+                Tokenizer(field + sizeof(kPageSizeKey) - 1, fieldLen - (sizeof(kPageSizeKey) - 1)).readU64(pageSize);
+            }
+        }
+        for (auto it = pages.cbegin(); it != pages.cend(); ++it)
+            nodes[it.key()] += it.value() * pageSize;
+    } while (tok.nextLine());
+    return found;
+}
+
+bool NumaMaps::read(pid_t pid, QMap<int, qulonglong> &nodes)
+{
+    char path[64];
+    snprintf(path, sizeof(path), PROC_NUMA_MAPS_PATH, pid);
+
+    errno = 0;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        // missing without CONFIG_NUMA, other users' processes need ptrace access
+        if (errno != EACCES && errno != ENOENT && errno != ESRCH)
+            qCWarning(app) << "Failed to open" << path << ":" << strerror(errno);
+        return false;
+    }
+
+    nodes.clear();
+    // a line per mapping, parsed in chunks cut at the last complete line
+    bool found = false;
+    char buf[16384];
+    size_t kept = 0;
+    for (;;) {
+        ssize_t nr = ::read(fd, buf + kept, sizeof(buf) - kept);
+        if (nr < 0 && errno == EINTR)
+            continue;
+        if (nr <= 0)
+            break;
+
+        size_t len = kept + size_t(nr);
+        const char *eol = static_cast<const char *>(memrchr(buf, '\n', len));
+        if (!eol) {
+            // a line longer than the buffer, drop it
+            kept = 0;
+            continue;
+        }
+        size_t complete = size_t(eol - buf) + 1;
+        found |= parse(buf, complete, nodes);
+        kept = len - complete;
+        memmove(buf, buf + complete, kept);
+    }
+    if (kept > 0)
+        found |= parse(buf, kept, nodes);
+    close(fd);
+    return found;
+}
+
+} // namespace process
+} // namespace core
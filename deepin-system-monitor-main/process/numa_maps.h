@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NUMA_MAPS_H
+#define NUMA_MAPS_H
+
+#include <QMap>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Numa placement of the memory of a process, read from /proc/[pid]/numa_maps
+ *
+ * numa_maps walks the page tables of every mapping, as slow as smaps, so it's only read
+ * on request for one process at a time, e.g. while its attributes are shown.
+ */
+class NumaMaps
+{
+public:
+    /**
+     * @brief Add up the N<node>=<pages> fields of numa_maps content
+     * @param nodes kB resident on each node, added to
+     * @return false if no mapping line was found
+     */
+    static bool parse(const char *buf, size_t len, QMap<int, qulonglong> &nodes);
+    /**
+     * @brief Read & parse numa_maps of a process, fails for processes of other users
+     * @param nodes kB resident on each node
+     */
+    static bool read(pid_t pid, QMap<int, qulonglong> &nodes);
+};
+
+} // namespace process
+} // namespace core
+
+#endif // NUMA_MAPS_H
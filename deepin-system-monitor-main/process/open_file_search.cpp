@@ -0,0 +1,386 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "open_file_search.h"
+#include "common/common.h"
+#include "common/task_executor.h"
+#include "ddlog.h"
+
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QSet>
+
+#include <atomic>
+
+#include <ctype.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <unistd.h>
+
+using namespace common::alloc;
+using namespace common::core;
+using namespace core::system;
+using namespace DDLog;
+
+namespace core {
+namespace process {
+
+namespace {
+
+/**
+ * @brief What a fd must point to, prepared once per search
+ */
+struct matcher_t {
+    OpenFileSearch::query_t query;
+    QByteArray path; // encoded query path
+    QByteArray prefix; // of the files below it
+    QByteArray deleted; // link of the path once unlinked
+    // the file the path names, matched through any other name
+    bool hasFile {false};
+    dev_t dev {0};
+    ino_t ino {0};
+    // the path is the root of a mount, every file on it matches
+    bool isMount {false};
+    QHash<ino_t, SocketTable::socket_t> sockets; // of the port
+};
+
+void prepare(matcher_t &matcher)
+{
+    const OpenFileSearch::query_t &query = matcher.query;
+    if (query.port >= 0) {
+        std::vector<SocketTable::socket_t> sockets;
+        SockDiag diag;
+        if (!diag.dumpSockets(sockets)) {
+            qCWarning(app) << "Failed to dump sockets, port" << query.port << "can't be looked up";
+            return;
+        }
+        for (const auto &sock : sockets) {
+            // time wait & orphaned sockets belong to no process
+            if (sock.ino && (sock.lport == query.port || sock.rport == query.port))
+                matcher.sockets.insert(sock.ino, sock);
+        }
+        return;
+    }
+
+    matcher.path = QFile::encodeName(query.path);
+    matcher.prefix = matcher.path.endsWith('/') ? matcher.path : matcher.path + '/';
+    matcher.deleted = matcher.path + " (deleted)";
+    struct stat sbuf {};
+    if (stat(matcher.path.constData(), &sbuf) != 0)
+        return;
+    matcher.hasFile = true;
+    matcher.dev = sbuf.st_dev;
+    matcher.ino = sbuf.st_ino;
+    struct stat parent {};
+    if (S_ISDIR(sbuf.st_mode) && stat((matcher.prefix + "..").constData(), &parent) == 0)
+        matcher.isMount = parent.st_dev != sbuf.st_dev || parent.st_ino == sbuf.st_ino;
+}
+
+inline bool matchesName(const matcher_t &matcher, const char *target, size_t size)
+{
+    const int len = matcher.path.size();
+    const int prefixLen = matcher.prefix.size();
+    if (size == size_t(len) && memcmp(target, matcher.path.constData(), size) == 0)
+        return true;
+    if (size >= size_t(prefixLen) && memcmp(target, matcher.prefix.constData(), size_t(prefixLen)) == 0)
+        return true;
+    return size == size_t(matcher.deleted.size()) && memcmp(target, matcher.deleted.constData(), size) == 0;
+}
+
+inline bool matchesFile(const matcher_t &matcher, dev_t dev, ino_t ino)
+{
+    return (matcher.hasFile && dev == matcher.dev && ino == matcher.ino) || (matcher.isMount && dev == matcher.dev);
+}
+
+/**
+ * @brief Match a link of /proc/[pid]/..., name relative to dfd
+ * @param socket Set to the inode of a socket matched by port
+ */
+bool matchLink(const matcher_t &matcher, int dfd, const char *name, QByteArray &target, ino_t &socket)
+{
+    char link[PATH_MAX];
+    ssize_t size = readlinkat(dfd, name, link, sizeof(link));
+    if (size <= 0)
+        return false;
+    target = QByteArray(link, int(size));
+
+    if (matcher.query.port >= 0) {
+        // socket:[inode], no stat needed
+        if (size < 9 || memcmp(link, "socket:[", 8) != 0)
+            return false;
+        socket = ino_t(strtoull(link + 8, nullptr, 10));
+        return matcher.sockets.contains(socket);
+    }
+    if (matchesName(matcher, link, size_t(size)))
+        return true;
+    // pipes, sockets & anon inodes are never files of a path
+    struct stat sbuf {};
+    return link[0] == '/' && (matcher.hasFile || matcher.isMount) && fstatat(dfd, name, &sbuf, 0) == 0
+        && matchesFile(matcher, sbuf.st_dev, sbuf.st_ino);
+}
+
+/**
+ * @brief Files mapped by a process, each once, its maps tell their device & inode
+ */
+void matchMaps(const matcher_t &matcher, pid_t pid, QVector<OpenFileSearch::match_t> &matches)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/maps", pid);
+    uFile fp(fopen(path, "re"));
+    if (!fp)
+        return;
+
+    QSet<QByteArray> seen;
+    char line[PATH_MAX + 128];
+    while (fgets(line, sizeof(line), fp.get())) {
+        unsigned int major = 0, minor = 0;
+        unsigned long long ino = 0;
+        int offset = 0;
+        // address perms offset dev inode pathname
+        if (sscanf(line, "%*s %*s %*s %x:%x %llu %n", &major, &minor, &ino, &offset) < 3 || ino == 0)
+            continue;
+        char *file = line + offset;
+        size_t size = strcspn(file, "\n");
+        if (size == 0 || file[0] != '/')
+            continue;
+        if (!matchesName(matcher, file, size) && !matchesFile(matcher, makedev(major, minor), ino_t(ino)))
+            continue;
+        QByteArray target(file, int(size));
+        if (seen.contains(target))
+            continue;
+        seen.insert(target);
+        matches.append({pid, {}, OpenFileSearch::kMapFd, QFile::decodeName(target), 0});
+    }
+}
+
+QVector<OpenFileSearch::match_t> searchPid(const matcher_t &matcher, pid_t pid)
+{
+    QVector<OpenFileSearch::match_t> matches;
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d", pid);
+    int pidfd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (pidfd < 0)
+        return matches;
+
+    QByteArray target;
+    ino_t socket = 0;
+    if (matcher.query.port < 0) {
+        const QPair<int, const char *> pseudoFds[] = {{OpenFileSearch::kCwdFd, "cwd"},
+                                                      {OpenFileSearch::kRootFd, "root"},
+                                                      {OpenFileSearch::kExeFd, "exe"}};
+        for (const auto &pseudo : pseudoFds) {
+            if (matchLink(matcher, pidfd, pseudo.second, target, socket))
+                matches.append({pid, {}, pseudo.first, QFile::decodeName(target), 0});
+        }
+    }
+
+    // fd dir of other users' processes is not readable
+    int dfd = openat(pidfd, "fd", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    uDir dir(dfd >= 0 ? fdopendir(dfd) : nullptr);
+    if (!dir && dfd >= 0)
+        close(dfd);
+    while (dir) {
+        struct dirent *dp = readdir(dir.get());
+        if (!dp)
+            break;
+        if (!isdigit(dp->d_name[0]))
+            continue;
+        socket = 0;
+        if (matchLink(matcher, dirfd(dir.get()), dp->d_name, target, socket))
+            matches.append({pid, {}, atoi(dp->d_name), QFile::decodeName(target), socket});
+    }
+    close(pidfd);
+
+    if (matcher.query.port < 0)
+        matchMaps(matcher, pid, matches);
+    if (matches.isEmpty())
+        return matches;
+
+    // named as in the process table, only for processes holding something
+    char comm[64] {};
+    snprintf(path, sizeof(path), "/proc/%d/comm", pid);
+    if (uFile fp {fopen(path, "re")}) {
+        if (fgets(comm, sizeof(comm), fp.get()))
+            comm[strcspn(comm, "\n")] = '\0';
+    }
+    const QString name = QString::fromUtf8(comm);
+    for (auto &match : matches)
+        match.name = name;
+    return matches;
+}
+
+QVector<pid_t> listPids()
+{
+    QVector<pid_t> pids;
+    uDir dir(opendir("/proc"));
+    while (dir) {
+        struct dirent *dp = readdir(dir.get());
+        if (!dp)
+            break;
+        if (isdigit(dp->d_name[0]))
+            pids << pid_t(atoi(dp->d_name));
+    }
+    return pids;
+}
+
+} // namespace
+
+struct OpenFileSearch::job_t {
+    matcher_t matcher;
+    std::atomic<bool> cancelled {false};
+    std::atomic<int> scanned {0};
+    std::atomic<int> total {0};
+    // walks not done yet, the one planning them included
+    std::atomic<int> pending {1};
+
+    QMutex mutex;
+    QVector<match_t> matches; // not delivered yet
+};
+
+OpenFileSearch::OpenFileSearch(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setInterval(kDeliverInterval);
+    connect(&m_timer, &QTimer::timeout, this, &OpenFileSearch::deliver);
+}
+
+OpenFileSearch::~OpenFileSearch()
+{
+    // workers only hold the job, they stop at the next pid
+    cancel();
+}
+
+OpenFileSearch::query_t OpenFileSearch::parseQuery(const QString &text)
+{
+    query_t query;
+    const QString pattern = text.trimmed();
+    if (pattern.isEmpty())
+        return query;
+
+    static const QRegularExpression portPattern("^(?:port:|:)?(\\d{1,5})$", QRegularExpression::CaseInsensitiveOption);
+    const QRegularExpressionMatch match = portPattern.match(pattern);
+    if (match.hasMatch() && match.captured(1).toInt() <= 65535) {
+        query.port = match.captured(1).toInt();
+        return query;
+    }
+
+    QString path = pattern;
+    if (path == "~" || path.startsWith("~/"))
+        path.replace(0, 1, QDir::homePath());
+    query.path = QDir::cleanPath(path);
+    return query;
+}
+
+QVector<OpenFileSearch::match_t> OpenFileSearch::searchProcess(pid_t pid, const query_t &query)
+{
+    if (query.isEmpty())
+        return {};
+    matcher_t matcher;
+    matcher.query = query;
+    prepare(matcher);
+    return searchPid(matcher, pid);
+}
+
+void OpenFileSearch::start(const query_t &query)
+{
+    cancel();
+    m_job.reset();
+    if (query.isEmpty())
+        return;
+
+    qCDebug(app) << "Searching open files of" << (query.port >= 0 ? QString("port %1").arg(query.port) : query.path);
+    auto job = std::make_shared<job_t>();
+    job->matcher.query = query;
+    m_job = job;
+    m_timer.start();
+
+    // the socket dump & the pid list are read off the UI thread too, then the pids are walked in parallel
+    TaskExecutor::instance()->run(TaskExecutor::kBackgroundTask, [job]() {
+        prepare(job->matcher);
+        const QVector<pid_t> pids = listPids();
+        job->total = int(pids.size());
+        for (int first = 0; first < pids.size() && !job->cancelled; first += kPidsPerJob) {
+            const QVector<pid_t> chunk = pids.mid(first, kPidsPerJob);
+            ++job->pending;
+            TaskExecutor::instance()->run(TaskExecutor::kBackgroundTask, [job, chunk]() {
+                for (pid_t pid : chunk) {
+                    if (job->cancelled)
+                        break;
+                    QVector<match_t> matches = searchPid(job->matcher, pid);
+                    ++job->scanned;
+                    if (!matches.isEmpty()) {
+                        QMutexLocker locker(&job->mutex);
+                        job->matches += matches;
+                    }
+                }
+                --job->pending;
+            });
+        }
+        --job->pending;
+    });
+}
+
+void OpenFileSearch::cancel()
+{
+    m_timer.stop();
+    if (m_job)
+        m_job->cancelled = true;
+}
+
+bool OpenFileSearch::isRunning() const
+{
+    return m_timer.isActive();
+}
+
+int OpenFileSearch::scanned() const
+{
+    return m_job ? m_job->scanned.load() : 0;
+}
+
+int OpenFileSearch::total() const
+{
+    return m_job ? m_job->total.load() : 0;
+}
+
+const SocketTable::socket_t *OpenFileSearch::socket(ino_t ino) const
+{
+    // filled before any walk started, read only since
+    if (!m_job)
+        return nullptr;
+    auto it = m_job->matcher.sockets.constFind(ino);
+    return it != m_job->matcher.sockets.constEnd() ? &it.value() : nullptr;
+}
+
+void OpenFileSearch::deliver()
+{
+    if (!m_job)
+        return;
+    // walks append before they are done, checked first so no match is left behind
+    const bool done = m_job->pending == 0;
+    QVector<match_t> matches;
+    {
+        QMutexLocker locker(&m_job->mutex);
+        matches.swap(m_job->matches);
+    }
+    if (!matches.isEmpty())
+        Q_EMIT matchesFound(matches);
+    if (done) {
+        m_timer.stop();
+        qCDebug(app) << "Open file search done," << m_job->scanned << "processes walked";
+        Q_EMIT finished();
+    }
+}
+
+} // namespace process
+} // namespace core
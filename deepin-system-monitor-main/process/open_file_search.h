@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef OPEN_FILE_SEARCH_H
+#define OPEN_FILE_SEARCH_H
+
+#include "system/sock_diag.h"
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+#include <memory>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Which processes hold a file, a deleted file, a mount or a port, like lsof
+ *
+ * The fds, cwd, root, exe & file mappings of every process are walked on background workers,
+ * a few dozen pids per job, & matches are streamed to the UI thread while the walk goes on. A
+ * path matches the fds linked to it or below it, the file it names through any other name (hard
+ * links, bind mounts) & the files of the mount it is the root of. A port is looked up in the
+ * sock_diag socket dump first, only the fds of its socket inodes match then.
+ */
+class OpenFileSearch : public QObject
+{
+    Q_OBJECT
+
+public:
+    // pseudo fds of the files a process holds besides its descriptors, named as lsof does
+    enum {
+        kCwdFd = -1,
+        kRootFd = -2,
+        kExeFd = -3,
+        kMapFd = -4, // mapped file, libraries included
+    };
+
+    struct query_t {
+        QString path; // absolute, no trailing slash
+        int port {-1}; // local or remote tcp/udp port
+
+        inline bool isEmpty() const
+        {
+            return path.isEmpty() && port < 0;
+        }
+    };
+    struct match_t {
+        pid_t pid {0};
+        QString name; // command name
+        int fd {0}; // or a pseudo fd
+        QString target; // of the fd link, e.g. /tmp/x (deleted) or socket:[1234]
+        ino_t socket {0}; // inode of a socket matched by port
+    };
+
+    // pids walked by a single job
+    static constexpr int kPidsPerJob = 32;
+    // matches are handed to the UI thread at most this often, ms
+    static constexpr int kDeliverInterval = 100;
+
+    explicit OpenFileSearch(QObject *parent = nullptr);
+    ~OpenFileSearch() override;
+
+    /**
+     * @brief Query of a search text, a port as 443, :443 or port:443, anything else a path
+     */
+    static query_t parseQuery(const QString &text);
+    /**
+     * @brief Matches of one process, walked on the calling thread
+     */
+    static QVector<match_t> searchProcess(pid_t pid, const query_t &query);
+
+    /**
+     * @brief Start a search, a running one is cancelled first
+     */
+    void start(const query_t &query);
+    /**
+     * @brief Stop the workers, matches not delivered yet are dropped
+     */
+    void cancel();
+    bool isRunning() const;
+
+    /**
+     * @brief Processes walked so far & to walk, of the running or last search
+     */
+    int scanned() const;
+    int total() const;
+    /**
+     * @brief Socket a match of the last port query is for, null unless found
+     */
+    const core::system::SocketTable::socket_t *socket(ino_t ino) const;
+
+Q_SIGNALS:
+    void matchesFound(const QVector<core::process::OpenFileSearch::match_t> &matches);
+    /**
+     * @brief All processes were walked, not sent when cancelled
+     */
+    void finished();
+
+private:
+    struct job_t;
+
+    void deliver();
+
+    std::shared_ptr<job_t> m_job;
+    QTimer m_timer;
+};
+
+} // namespace process
+} // namespace core
+
+#endif // OPEN_FILE_SEARCH_H
@@ -29,6 +29,52 @@ using CPUUsageSampleFrame = SampleFrame<qreal>;
 
 class Process;
 
+/**
+ * @brief Page fault, context switch & io syscall rates of a process, per second
+ */
+struct EventRates {
+    qreal minorFaults;
+    qreal majorFaults; // had to wait for disk, thrashing when high
+    qreal voluntarySwitches; // blocked on io, locks or sleep
+    qreal involuntarySwitches; // preempted, contended cpu when high
+    qreal ioSyscalls; // read & write syscalls, io operations issued
+};
+using EventRatesSample = Sample<EventRates>;
+using EventRatesSampleFrame = SampleFrame<EventRates>;
+
+/**
+ * @brief Sample history of a process
+ *
+ * Shared between copies of ProcessPrivate & only cloned when a copy is about to add
+ * new samples, see ProcessPrivate::mutableSamples
+ */
+struct ProcessSamples {
+    ProcessSamples()
+        : cpuTimeSample(TimePeriod(TimePeriod::kNoPeriod, default_interval()))
+        , cpuUsageSample(TimePeriod(TimePeriod::kNoPeriod, default_interval()))
+        , cpuWaitSample(TimePeriod(TimePeriod::kNoPeriod, default_interval()))
+        , ioWaitSample(TimePeriod(TimePeriod::kNoPeriod, default_interval()))
+        , networkIOSample(TimePeriod(TimePeriod::kNoPeriod, default_interval()))
+        , networkBandwidthSample(TimePeriod(TimePeriod::kNoPeriod, default_interval()))
+        , diskIOSample(TimePeriod(TimePeriod::kNoPeriod, default_interval()))
+        , diskIOSpeedSample(TimePeriod(TimePeriod::kNoPeriod, default_interval()))
+        , eventRatesSample(TimePeriod(TimePeriod::kNoPeriod, default_interval()))
+    {
+    }
+
+    // only 2 samples are kept here for each process, to avoid too much memory
+    // consumption if there're too many processes
+    CPUTimeSample cpuTimeSample;
+    CPUUsageSample cpuUsageSample;
+    CPUUsageSample cpuWaitSample; // run queue wait, same base as cpuUsageSample
+    CPUUsageSample ioWaitSample; // block io & swapin delay, % of the interval
+    IOSample networkIOSample;
+    IOPSSample networkBandwidthSample;
+    DISKIOSample diskIOSample;
+    IOPSSample diskIOSpeedSample;
+    EventRatesSample eventRatesSample;
+};
+
 /**
  * @brief The proc_info_t struct
  */
@@ -38,6 +84,7 @@ public:
     ProcessPrivate()
         : QSharedData()
         , valid {false}
+        , vanished {false}
         , state {'\0'}
         , apptype {2}
         , pid {0}
@@ -68,28 +115,69 @@ public:
         , guest_time {0}
         , cguest_time {0}
         , wtime {0}
+        , minflt {0}
+        , majflt {0}
+        , nvcsw {0}
+        , nivcsw {0}
         , read_bytes {0}
         , write_bytes {0}
         , cancelled_write_bytes {0}
+        , blkio_delay {0}
+        , swapin_delay {0}
+        , io_syscalls {0}
         , usrerName {}
         , name {}
         , proc_name{}
         , proc_icon{}
         , cmdline {}
-        , environ {}
+        , cmdline_text {}
+        , bare_shell {false}
         , uptime {timeval {0, 0}}
         , sockInodes {}
-        , cpuTimeSample(new CPUTimeSample(TimePeriod(TimePeriod::kNoPeriod, default_interval())))
-        , cpuUsageSample(new CPUUsageSample(TimePeriod(TimePeriod::kNoPeriod, default_interval())))
-        , networkIOSample(new IOSample(TimePeriod(TimePeriod::kNoPeriod, default_interval())))
-        , networkBandwidthSample(new IOPSSample(TimePeriod(TimePeriod::kNoPeriod, default_interval())))
-        , diskIOSample(new DISKIOSample(TimePeriod(TimePeriod::kNoPeriod, default_interval())))
-        , diskIOSpeedSample(new IOPSSample(TimePeriod(TimePeriod::kNoPeriod, default_interval())))
+        , fd_count {-1}
+        , sock_count {0}
+        , fd_growth_since {0}
+        , fd_growth_base {0}
+        , fd_growth {0}
+        , fd_leak {false}
+        , has_net_counters {false}
+        , net_rx_bytes {0}
+        , net_tx_bytes {0}
+        , has_tcp_health {false}
+        , tcp_rtt {0}
+        , tcp_retrans {0}
+        , tcp_segs_out {0}
+        , tcp_retrans_rate {0}
+        , guest_cpu {0}
+        , memory_growth {0}
+        , memory_trend {0}
+        , memory_leak_since {0}
+        , memory_leak_base {0}
+        , memory_exhaustion {-1}
+        , memory_leak {false}
+        , power {-1}
+        , wakeup_rate {-1}
+        , timer_wakeup_rate {-1}
+        , blocked_since {0}
+        , hung {false}
+        , blocking_function {}
+        , blocking_wait {0}
+        , group_memory {0}
+        , has_smaps {false}
+        , pss {0}
+        , uss {0}
+        , swap {0}
+        , drmFds {}
+        , has_gpu {false}
+        , gpu_usage {0}
+        , gpu_memory {0}
+        , samples(emptySamples())
     {
     }
     ProcessPrivate(const ProcessPrivate &other)
         : QSharedData(other)
         , valid(other.valid)
+        , vanished(other.vanished)
         , state(other.state)
         , apptype(other.apptype)
         , pid(other.pid)
@@ -120,23 +208,63 @@ public:
         , guest_time(other.guest_time)
         , cguest_time(other.cguest_time)
         , wtime(other.wtime)
+        , minflt(other.minflt)
+        , majflt(other.majflt)
+        , nvcsw(other.nvcsw)
+        , nivcsw(other.nivcsw)
         , read_bytes(other.read_bytes)
         , write_bytes(other.write_bytes)
         , cancelled_write_bytes(other.cancelled_write_bytes)
-        , usrerName(other.name)
+        , blkio_delay(other.blkio_delay)
+        , swapin_delay(other.swapin_delay)
+        , io_syscalls(other.io_syscalls)
+        , usrerName(other.usrerName)
         , name(other.name)
         , proc_name(other.proc_name)
         , proc_icon(other.proc_icon)
         , cmdline(other.cmdline)
-        , environ(other.environ)
+        , cmdline_text(other.cmdline_text)
+        , bare_shell(other.bare_shell)
         , uptime {other.uptime}
         , sockInodes(other.sockInodes)
-        , cpuTimeSample(std::unique_ptr<CPUTimeSample>(new CPUTimeSample(*(other.cpuTimeSample))))
-        , cpuUsageSample(std::unique_ptr<CPUUsageSample>(new CPUUsageSample(*(other.cpuUsageSample))))
-        , networkIOSample(std::unique_ptr<IOSample>(new IOSample(*(other.networkIOSample))))
-        , networkBandwidthSample(std::unique_ptr<IOPSSample>(new IOPSSample(*(other.networkBandwidthSample))))
-        , diskIOSample(std::unique_ptr<DISKIOSample>(new DISKIOSample(*(other.diskIOSample))))
-        , diskIOSpeedSample(std::unique_ptr<IOPSSample>(new IOPSSample(*(other.diskIOSpeedSample))))
+        , fd_count(other.fd_count)
+        , sock_count(other.sock_count)
+        , fd_growth_since(other.fd_growth_since)
+        , fd_growth_base(other.fd_growth_base)
+        , fd_growth(other.fd_growth)
+        , fd_leak(other.fd_leak)
+        , has_net_counters(other.has_net_counters)
+        , net_rx_bytes(other.net_rx_bytes)
+        , net_tx_bytes(other.net_tx_bytes)
+        , has_tcp_health(other.has_tcp_health)
+        , tcp_rtt(other.tcp_rtt)
+        , tcp_retrans(other.tcp_retrans)
+        , tcp_segs_out(other.tcp_segs_out)
+        , tcp_retrans_rate(other.tcp_retrans_rate)
+        , guest_cpu(other.guest_cpu)
+        , memory_growth(other.memory_growth)
+        , memory_trend(other.memory_trend)
+        , memory_leak_since(other.memory_leak_since)
+        , memory_leak_base(other.memory_leak_base)
+        , memory_exhaustion(other.memory_exhaustion)
+        , memory_leak(other.memory_leak)
+        , power(other.power)
+        , wakeup_rate(other.wakeup_rate)
+        , timer_wakeup_rate(other.timer_wakeup_rate)
+        , blocked_since(other.blocked_since)
+        , hung(other.hung)
+        , blocking_function(other.blocking_function)
+        , blocking_wait(other.blocking_wait)
+        , group_memory(other.group_memory)
+        , has_smaps(other.has_smaps)
+        , pss(other.pss)
+        , uss(other.uss)
+        , swap(other.swap)
+        , drmFds(other.drmFds)
+        , has_gpu(other.has_gpu)
+        , gpu_usage(other.gpu_usage)
+        , gpu_memory(other.gpu_memory)
+        , samples(other.samples)
     {
     }
     ~ProcessPrivate() {}
@@ -146,8 +274,28 @@ public:
         return valid;
     }
 
+    /**
+     * @brief Sample history for writing, detached from other owners first
+     */
+    inline ProcessSamples &mutableSamples()
+    {
+        if (samples.use_count() > 1)
+            samples = std::make_shared<ProcessSamples>(*samples);
+        return *samples;
+    }
+
+    /**
+     * @brief Empty history shared by all processes that never got sampled
+     */
+    static const std::shared_ptr<ProcessSamples> &emptySamples()
+    {
+        static const std::shared_ptr<ProcessSamples> empty = std::make_shared<ProcessSamples>();
+        return empty;
+    }
+
 private:
     bool valid;
+    bool vanished; // pid exited while it was read
     char state; // process state
 
     int apptype;
@@ -182,31 +330,86 @@ private:
 
     unsigned long long wtime; // time spent waiting on a runqueue
 
+    // cumulative counters, from stat & status
+    unsigned long long minflt; // minor faults
+    unsigned long long majflt; // major faults, needed a disk read
+    unsigned long long nvcsw; // voluntary context switches
+    unsigned long long nivcsw; // involuntary context switches
+
     // blockdev io
     unsigned long long read_bytes; // disk read bytes
     unsigned long long write_bytes; // disk write bytes
     unsigned long long cancelled_write_bytes; // cancelled write bytes
 
+    // delay accounting, from taskstats or stat & io, see Process::setTaskStats
+    unsigned long long blkio_delay; // ns waited for block io
+    unsigned long long swapin_delay; // ns waited for swapin, taskstats only
+    unsigned long long io_syscalls; // read & write syscalls
+
     QString usrerName;
 
     QString name; // raw name
     ProcessName proc_name; // process name object
     ProcessIcon proc_icon; // process icon object
     QByteArrayList cmdline; // process cmdline
-    QHash<QString, QString> environ; // environment cache
+    QString cmdline_text; // truncated for display, see Process::cmdlineText
+    bool bare_shell; // cmdline is just /bin/bash
 
     struct timeval uptime;
 
     QList<ino_t> sockInodes; // socket inodes opened by this process
 
-    // only 2 samples are kept here for each process, to avoid too much memory
-    // consumption if there're too many processes
-    std::unique_ptr<CPUTimeSample> cpuTimeSample;
-    std::unique_ptr<CPUUsageSample> cpuUsageSample;
-    std::unique_ptr<IOSample> networkIOSample;
-    std::unique_ptr<IOPSSample> networkBandwidthSample;
-    std::unique_ptr<DISKIOSample> diskIOSample;
-    std::unique_ptr<IOPSSample> diskIOSpeedSample;
+    // fd counts of the fd walk, see Process::fdLeakSuspected
+    int fd_count; // -1 if the fd dir is not readable
+    int sock_count;
+    qreal fd_growth_since; // uptime in s when the fd count last dropped
+    int fd_growth_base; // fd count then
+    qreal fd_growth; // fds per minute since fd_growth_since
+    bool fd_leak;
+
+    // per process traffic accounted in kernel (DKapture), replaces socket inode lookup when set
+    bool has_net_counters;
+    unsigned long long net_rx_bytes; // cumulative received bytes
+    unsigned long long net_tx_bytes; // cumulative sent bytes
+
+    // tcp_info of the sockets in sockInodes, see Process::setTcpHealth
+    bool has_tcp_health; // any of them is a connected tcp socket
+    unsigned int tcp_rtt; // worst smoothed rtt in us
+    unsigned long long tcp_retrans; // retransmitted segments, summed over connections
+    unsigned long long tcp_segs_out; // sent segments
+    qreal tcp_retrans_rate; // % of the segments sent since the previous scan
+
+    qreal guest_cpu; // guest time since the previous scan, % like cpu usage
+
+    qreal memory_growth; // resident memory growth since the previous scan in kB/s
+    qreal memory_trend; // memory_growth smoothed over ProcessSet::kMemoryTrendWindow, kB/s
+    qreal memory_leak_since; // uptime in s since memory_trend stays above ProcessSet::kMemoryLeakMinRate, 0 if not
+    qulonglong memory_leak_base; // memory() in kB then
+    qreal memory_exhaustion; // s until the system or a cgroup limit runs out at memory_trend, -1 if not growing
+    bool memory_leak;
+    qreal power; // share of package power by cpu time in W, -1 unknown, see ProcessSet::updateEnergy
+    qreal wakeup_rate; // wakeups/s counted by the kernel, -1 unless traced, see ProcessSet::updateWakeups
+    qreal timer_wakeup_rate; // of those, by an expiring timer
+    qreal blocked_since; // uptime in s since consecutive scans found it in D state, 0 if not
+    bool hung; // in D for ProcessSet::hungTaskWindow
+    QByteArray blocking_function; // kernel function it blocks in most, see HungTaskSampler
+    int blocking_wait; // HungTaskSampler::WaitKind of it
+    unsigned long long group_memory; // memory charged to the app's own cgroup in kB, 0 if not grouped by cgroup
+
+    // smaps_rollup figures in kB, cached between reads, see ProcessSmapsCache
+    bool has_smaps;
+    unsigned long long pss;
+    unsigned long long uss;
+    unsigned long long swap;
+
+    // drm fds from the fd walk & their fdinfo figures, see ProcessGpuCache
+    QList<int> drmFds;
+    bool has_gpu;
+    qreal gpu_usage; // busiest engine in percent
+    unsigned long long gpu_memory; // kB
+
+    // copy on write sample history, the empty one is never written, see mutableSamples
+    std::shared_ptr<ProcessSamples> samples;
 
     friend class Process;
 };
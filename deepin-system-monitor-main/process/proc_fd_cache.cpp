@@ -0,0 +1,143 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "proc_fd_cache.h"
+#include "ddlog.h"
+#include "common/perf_trace.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+using namespace DDLog;
+
+namespace core {
+namespace process {
+
+static const char *const kProcFileName[ProcFdCache::kProcFileCount] = {
+    "stat",
+    "statm",
+    "io",
+    "schedstat",
+    "status"
+};
+
+ProcFdCache::ProcFdCache(pid_t tgid)
+    : m_tgid(tgid)
+    , m_fds {}
+    , m_sockInodes {}
+{
+}
+
+ProcFdCache::~ProcFdCache()
+{
+    clear();
+}
+
+int ProcFdCache::openFile(pid_t tgid, pid_t pid, ProcFile file)
+{
+    char path[64];
+    if (tgid > 0)
+        snprintf(path, sizeof(path), "/proc/%d/task/%d/%s", tgid, pid, kProcFileName[file]);
+    else
+        snprintf(path, sizeof(path), "/proc/%d/%s", pid, kProcFileName[file]);
+    PERF_TRACE_COUNT(kCounterOpen, 1);
+    return open(path, O_RDONLY | O_CLOEXEC);
+}
+
+ssize_t ProcFdCache::read(pid_t pid, ProcFile file, char *buf, size_t size)
+{
+    if (!buf || size == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    auto it = m_fds.find(pid);
+    if (it == m_fds.end()) {
+        FdEntry entry;
+        for (int i = 0; i < kProcFileCount; ++i)
+            entry.fds[i] = -1;
+        it = m_fds.insert(pid, entry);
+    }
+
+    int &fd = it->fds[file];
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        if (fd < 0) {
+            fd = openFile(m_tgid, pid, file);
+            if (fd < 0)
+                return -1;
+        }
+
+        ssize_t nr = pread(fd, buf, size - 1, 0);
+        PERF_TRACE_COUNT(kCounterRead, 1);
+        if (nr > 0) {
+            buf[nr] = '\0';
+            return nr;
+        }
+
+        // the process behind a cached fd is gone (ESRCH or empty read), pid may
+        // have been recycled since last scan, so reopen once before giving up
+        int err = (nr < 0) ? errno : ESRCH;
+        close(fd);
+        fd = -1;
+        errno = err;
+    }
+
+    return -1;
+}
+
+void ProcFdCache::release(pid_t pid)
+{
+    m_sockInodes.release(pid);
+
+    auto it = m_fds.find(pid);
+    if (it == m_fds.end())
+        return;
+
+    for (int i = 0; i < kProcFileCount; ++i) {
+        if (it->fds[i] >= 0)
+            close(it->fds[i]);
+    }
+    m_fds.erase(it);
+}
+
+void ProcFdCache::clear()
+{
+    for (auto it = m_fds.begin(); it != m_fds.end(); ++it) {
+        for (int i = 0; i < kProcFileCount; ++i) {
+            if (it->fds[i] >= 0)
+                close(it->fds[i]);
+        }
+    }
+    m_fds.clear();
+    m_sockInodes.clear();
+}
+
+ssize_t ProcFdCache::readOnce(pid_t pid, ProcFile file, char *buf, size_t size)
+{
+    if (!buf || size == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    int fd = openFile(0, pid, file);
+    if (fd < 0)
+        return -1;
+
+    ssize_t nr = ::read(fd, buf, size - 1);
+    PERF_TRACE_COUNT(kCounterRead, 1);
+    int err = errno;
+    close(fd);
+    if (nr < 0) {
+        errno = err;
+        return -1;
+    }
+
+    buf[nr] = '\0';
+    return nr;
+}
+
+} // namespace process
+} // namespace core
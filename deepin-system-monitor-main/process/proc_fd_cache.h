@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROC_FD_CACHE_H
+#define PROC_FD_CACHE_H
+
+#include "sock_inode_index.h"
+
+#include <QHash>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Persistent /proc/[pid]/xxx file descriptors, re-read with pread
+ *
+ * Files under /proc/[pid] regenerate their content on every read from offset 0,
+ * so keeping them open saves the open/close syscalls on each refresh. A cache made
+ * for the threads of a process reads /proc/[tgid]/task/[tid]/xxx, keyed by tid.
+ */
+class ProcFdCache
+{
+public:
+    enum ProcFile {
+        kStatFile,
+        kStatmFile,
+        kIOFile,
+        kSchedStatFile,
+        kStatusFile,
+
+        kProcFileCount
+    };
+
+    /**
+     * @param tgid Process the threads of which are read, ids passed in are its tids, 0 for processes
+     */
+    explicit ProcFdCache(pid_t tgid = 0);
+    ~ProcFdCache();
+
+    /**
+     * @brief Read whole content of /proc/[pid]/file from offset 0
+     * @param pid Process id
+     * @param file Which file to read
+     * @param buf Destination buffer, null terminated on success
+     * @param size Buffer size, including the terminating null character
+     * @return Bytes read, or -1 on failure with errno set
+     */
+    ssize_t read(pid_t pid, ProcFile file, char *buf, size_t size);
+
+    /**
+     * @brief Socket inode index of pids in this cache shard
+     */
+    inline SockInodeIndex *sockInodeIndex()
+    {
+        return &m_sockInodes;
+    }
+
+    /**
+     * @brief Close all descriptors & drop socket inodes held for pid, called when pid exits
+     */
+    void release(pid_t pid);
+    void clear();
+
+    int count() const;
+
+    /**
+     * @brief One-shot open/read/close, used when no cache is available
+     */
+    static ssize_t readOnce(pid_t pid, ProcFile file, char *buf, size_t size);
+
+private:
+    ProcFdCache(const ProcFdCache &) = delete;
+    ProcFdCache &operator=(const ProcFdCache &) = delete;
+
+    static int openFile(pid_t tgid, pid_t pid, ProcFile file);
+
+    struct FdEntry {
+        int fds[kProcFileCount];
+    };
+    pid_t m_tgid;
+    QHash<pid_t, FdEntry> m_fds;
+    SockInodeIndex m_sockInodes;
+};
+
+inline int ProcFdCache::count() const
+{
+    return m_fds.size();
+}
+
+} // namespace process
+} // namespace core
+
+#endif // PROC_FD_CACHE_H
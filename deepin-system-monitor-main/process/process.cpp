@@ -8,16 +8,28 @@
 #include "private/process_p.h"
 #include "system/device_db.h"
 #include "process/process_db.h"
+#include "process/proc_fd_cache.h"
+#include "process/process_environ_cache.h"
+#include "common/perf_trace.h"
+#include "common/trace_log.h"
+#include "common/proc_parser.h"
+#include "common/string_pool.h"
 #include "system/sys_info.h"
+#include "system/user_name_cache.h"
 #include "system/cpu_set.h"
 #include "system/netif_info_db.h"
+#include "system/task_stats.h"
 #include "wm/wm_window_list.h"
+#include "process_info_record.h"
 
 #include <QMap>
 #include <QList>
 #include <QDebug>
 #include <QApplication>
 #include <QVariantMap>
+#include <QDataStream>
+#include <QFile>
+#include <QUrl>
 
 #include <memory>
 
@@ -29,26 +41,74 @@
 #include <fcntl.h>
 
 #define PROC_PATH "/proc"
-#define PROC_STAT_PATH "/proc/%u/stat"
-#define PROC_STATUS_PATH "/proc/%u/status"
-#define PROC_STATM_PATH "/proc/%u/statm"
 #define PROC_CMDLINE_PATH "/proc/%u/cmdline"
-#define PROC_ENVIRON_PATH "/proc/%u/environ"
-#define PROC_IO_PATH "/proc/%u/io"
-#define PROC_FD_PATH "/proc/%u/fd"
-#define PROC_FD_NAME_PATH "/proc/%u/fd/%s"
-#define PROC_SCHEDSTAT_PATH "/proc/%u/schedstat"
 
 using namespace common::alloc;
 using namespace common::init;
 using namespace common::core;
 using namespace common::error;
+using namespace common::parser;
+using namespace common::intern;
 using namespace core::system;
 using namespace DDLog;
 
 namespace core {
 namespace process {
 
+static inline ssize_t readProcFile(ProcFdCache *fdCache, pid_t pid, ProcFdCache::ProcFile file, char *buf, size_t size)
+{
+    return fdCache ? fdCache->read(pid, file, buf, size) : ProcFdCache::readOnce(pid, file, buf, size);
+}
+
+// pid exited between listing & reading, expected on busy hosts, so counted instead of logged
+static inline bool checkVanished(int err, bool &vanished)
+{
+    if (err != ENOENT && err != ESRCH)
+        return false;
+    if (!vanished)
+        PERF_TRACE_COUNT(kCounterVanished, 1);
+    vanished = true;
+    return true;
+}
+
+// seconds elapsed since the previous scan
+static inline qreal secondsSince(const RecentProcStage &recent, const timeval &uptime)
+{
+    return (uptime.tv_sec - recent.uptime.tv_sec) + (uptime.tv_usec - recent.uptime.tv_usec) / 1000000.;
+}
+
+// resident memory growth since the previous scan in kB/s
+static inline qreal memoryGrowthSince(const RecentProcStage &recent, qulonglong memory, const timeval &uptime)
+{
+    qreal secs = secondsSince(recent, uptime);
+    if (secs <= 0)
+        return 0;
+    return (qreal(memory) - qreal(recent.memory)) / secs;
+}
+
+// per second increase of a cumulative counter, 0 if it went backwards
+static inline qreal rateSince(qulonglong counter, qulonglong previous, qreal secs)
+{
+    if (secs <= 0 || counter < previous)
+        return 0;
+    return qreal(counter - previous) / secs;
+}
+
+// retransmitted share of the segments sent since the previous scan in %, connections closed in
+// between take their counts along, the interval reads as 0 then
+static inline qreal retransRateSince(const RecentProcStage &recent, qulonglong retrans, qulonglong segsOut)
+{
+    if (segsOut <= recent.tcp_segs_out || retrans < recent.tcp_retrans)
+        return 0;
+    return qMin(100., 100. * (retrans - recent.tcp_retrans) / (segsOut - recent.tcp_segs_out));
+}
+
+// io delay in ns per second of the interval as %, summed over threads like cpu time
+static inline qreal ioWaitSince(const RecentProcStage &recent, qulonglong blkioDelay, qulonglong swapinDelay, qreal secs)
+{
+    return rateSince(blkioDelay + swapinDelay, recent.blkio_delay + recent.swapin_delay, secs) / 10000000.;
+}
+
 QString getPriorityName(int prio)
 {
     qCDebug(app) << "Getting priority name for value:" << prio;
@@ -90,18 +150,18 @@ ProcessPriority getProcessPriorityStub(int prio)
 Process::Process()
     : d(new ProcessPrivate())
 {
-    qCDebug(app) << "Process object created";
+    TRACE_LOG_TRACE("Process object created");
 }
 Process::Process(pid_t pid)
     : d(new ProcessPrivate())
 {
-    qCDebug(app) << "Process object created for pid" << pid;
+    TRACE_LOG_TRACE("Process object created for pid %d", pid);
     d->pid = pid;
 }
 Process::Process(const Process &other)
     : d(other.d)
 {
-    qCDebug(app) << "Process object copied from pid" << other.d->pid;
+    TRACE_LOG_TRACE("Process object copied from pid %d", other.d->pid);
 }
 Process &Process::operator=(const Process &rhs)
 {
@@ -115,51 +175,82 @@ Process &Process::operator=(const Process &rhs)
 
 Process::~Process()
 {
-    qCDebug(app) << "Process object destroyed for pid" << (d ? d->pid : -1);
+    TRACE_LOG_TRACE("Process object destroyed for pid %d", d ? d->pid : -1);
+}
+
+Process Process::detached() const
+{
+    Process proc;
+    proc.d = QExplicitlySharedDataPointer<ProcessPrivate>(new ProcessPrivate(*d));
+    return proc;
 }
 
 time_t Process::startTime() const
 {
     auto *monitor = ThreadManager::instance()->thread<SystemMonitorThread>(BaseThread::kSystemMonitorThread)->systemMonitorInstance();
     time_t st = monitor->sysInfo()->btime().tv_sec + time_t(d->start_time / HZ);
-    qCDebug(app) << "Start time for pid" << d->pid << "is" << st;
+    TRACE_LOG_TRACE("Start time for pid %d is %lld", d->pid, static_cast<long long>(st));
     return st;
 }
 
+qulonglong Process::startTimeTicks() const
+{
+    return d->start_time;
+}
+
 timeval Process::procuptime() const
 {
-    qCDebug(app) << "Process uptime for pid" << d->pid << "is" << d->uptime.tv_sec << "s";
+    TRACE_LOG_TRACE("Process uptime for pid %d is %llds", d->pid, static_cast<long long>(d->uptime.tv_sec));
     return d->uptime;
 }
 
-void Process::readProcessVariableInfo()
+void Process::readProcessVariableInfo(ProcFdCache *fdCache)
 {
-    qCDebug(app) << "Reading variable info for pid" << d->pid;
-    d->valid = true;
+    TRACE_LOG_TRACE("Reading variable info for pid %d", d->pid);
+    readProcessVariableStats(fdCache);
+    updateProcessVariableMetrics();
+    TRACE_LOG_TRACE("Finished reading variable info for pid %d valid: %d", d->pid, int(d->valid));
+}
 
-    bool ok = true;
-    ok = ok && readStat();
-    readSchedStat();
-    ok = ok && readStatm();
+bool Process::readProcessVariableStats(ProcFdCache *fdCache, bool readFds)
+{
+    // stops at the first file that fails, a pid gone since listing fails them all
+    d->vanished = false;
+    bool ok = readStat(fdCache);
+    if (ok) {
+        // context switch counters, uid changes are picked up on the way
+        readStatus(fdCache);
+        ok = !d->vanished;
+    }
+    if (ok) {
+        readSchedStat(fdCache);
+        ok = readStatm(fdCache);
+    }
+    if (ok) {
+        readIO(fdCache);
+        if (readFds)
+            readSockInodes(fdCache);
+    }
 
-    readIO();
-    readSockInodes();
+    d->valid = ok;
+    return ok;
+}
 
+void Process::updateProcessVariableMetrics()
+{
     d->proc_name.refreashProcessName(this);
     d->uptime = SysInfo::instance()->uptime();
+    readTcpHealth();
 
     calculateProcessMetrics();
-
-    d->valid = d->valid && ok;
-    qCDebug(app) << "Finished reading variable info for pid" << d->pid << "valid:" << d->valid;
 }
 
 void Process::readProcessSimpleInfo(bool skipStatReading)
 {
-    qCDebug(app) << "Reading simple info for pid" << d->pid;
+    TRACE_LOG_TRACE("Reading simple info for pid %d", d->pid);
     d->valid = true;
+    d->vanished = false;
     bool ok = true;
-    readEnviron();
 
     // 在DKapture模式下跳过stat读取，因为DKapture已提供这些数据
     if (!skipStatReading) {
@@ -168,8 +259,13 @@ void Process::readProcessSimpleInfo(bool skipStatReading)
     }
 
     ok = ok && readCmdline(); // cmdline - DKapture无法提供，两种模式都需要
+    // gone since listing, skip the name, icon & window lookups
+    if (d->vanished) {
+        d->valid = false;
+        return;
+    }
 
-    d->usrerName = SysInfo::userName(d->uid);
+    d->usrerName = StringPool::instance()->fromUtf8(UserNameCache::instance()->userName(d->uid));
     d->proc_name.refreashProcessName(this);
     d->proc_icon.refreashProcessIcon(this);
 
@@ -180,60 +276,82 @@ void Process::readProcessSimpleInfo(bool skipStatReading)
     if (euid == d->uid && (wmwindowList->isGuiApp(d->pid)
                            || wmwindowList->isTrayApp(d->pid)
                            || wmwindowList->isDesktopEntryApp(d->pid))) {
-        qCDebug(app) << "Process" << d->pid << "is a GUI/Tray/Desktop app";
+        TRACE_LOG_TRACE("Process %d is a GUI/Tray/Desktop app", d->pid);
         d->apptype = kFilterApps;
     } else if (euid == d->uid) {
-        qCDebug(app) << "Process" << d->pid << "is a current user app";
+        TRACE_LOG_TRACE("Process %d is a current user app", d->pid);
         d->apptype = kFilterCurrentUser;
     }
 
     d->valid = d->valid && ok;
-    qCDebug(app) << "Finished reading simple info for pid" << d->pid << "valid:" << d->valid;
+    TRACE_LOG_TRACE("Finished reading simple info for pid %d valid: %d", d->pid, int(d->valid));
 }
 
 void Process::readProcessInfo()
 {
-    qCDebug(app) << "Reading full process info for pid" << d->pid;
+    TRACE_LOG_TRACE("Reading full process info for pid %d", d->pid);
     d->valid = true;
+    d->vanished = false;
 
     bool ok = true;
 
     ok = ok && readStat();
     ok = ok && readCmdline();
-    readEnviron();
-    readSchedStat();
+    if (ok)
+        readSchedStat();
     ok = ok && readStatus();
     ok = ok && readStatm();
+    // gone since listing, nothing left to sample
+    if (d->vanished) {
+        d->valid = false;
+        return;
+    }
     readIO();
     readSockInodes();
+    readTcpHealth();
 
-    d->usrerName = SysInfo::userName(d->uid);
+    d->usrerName = StringPool::instance()->fromUtf8(UserNameCache::instance()->userName(d->uid));
     d->proc_name.refreashProcessName(this);
     d->proc_icon.refreashProcessIcon(this);
     d->uptime = SysInfo::instance()->uptime();
 
-    CPUSet *cpuset = DeviceDB::instance()->cpuSet();
     ProcessSet *procset =  ProcessDB::instance()->processSet();
 
-    auto recentProcptr = procset->getRecentProcStage(d->pid);
+    auto recentProcptr = procset->getRecentProcStage(d->pid, d->start_time);
     auto validrecentPtr = recentProcptr.lock();
+    ProcessSamples &samples = d->mutableSamples();
     qreal timedelta = d->stime + d->utime;
     if (validrecentPtr) {
-        qCDebug(app) << "Found recent process stage for pid" << d->pid;
+        TRACE_LOG_TRACE("Found recent process stage for pid %d", d->pid);
         timedelta = timedelta - validrecentPtr->ptime;
         struct DiskIO io = {validrecentPtr->read_bytes, validrecentPtr->write_bytes, validrecentPtr->cancelled_write_bytes};
-        d->diskIOSample->addSample(new DISKIOSampleFrame(validrecentPtr->uptime, io));
-
-        d->networkIOSample->addSample(new IOSampleFrame(validrecentPtr->uptime, {0, 0}));
-    }
-    d->cpuUsageSample->addSample(new CPUUsageSampleFrame(qMax(0., timedelta) / cpuset->getUsageTotalDelta() * 100));
+        samples.diskIOSample.addSample(DISKIOSampleFrame(validrecentPtr->uptime, io));
+
+        samples.networkIOSample.addSample(IOSampleFrame(validrecentPtr->uptime, {0, 0}));
+        d->memory_growth = memoryGrowthSince(*validrecentPtr, memory(), d->uptime);
+        // same base as cpu usage, run queue wait is in clock ticks too
+        qreal waitdelta = qreal(d->wtime) - qreal(validrecentPtr->wtime);
+        samples.cpuWaitSample.addSample(CPUUsageSampleFrame(qMax(0., waitdelta) / procset->cpuUsageTotalDelta() * 100));
+        // vcpu threads of kvm guests, on the same base too
+        qreal guestdelta = qreal(d->guest_time) - qreal(validrecentPtr->gtime);
+        d->guest_cpu = qMax(0., guestdelta) / procset->cpuUsageTotalDelta() * 100;
+        qreal secs = secondsSince(*validrecentPtr, d->uptime);
+        samples.eventRatesSample.addSample(EventRatesSampleFrame({rateSince(d->minflt, validrecentPtr->minflt, secs),
+                                                                  rateSince(d->majflt, validrecentPtr->majflt, secs),
+                                                                  rateSince(d->nvcsw, validrecentPtr->nvcsw, secs),
+                                                                  rateSince(d->nivcsw, validrecentPtr->nivcsw, secs),
+                                                                  rateSince(d->io_syscalls, validrecentPtr->io_syscalls, secs)}));
+        samples.ioWaitSample.addSample(CPUUsageSampleFrame(ioWaitSince(*validrecentPtr, d->blkio_delay, d->swapin_delay, secs)));
+        d->tcp_retrans_rate = retransRateSince(*validrecentPtr, d->tcp_retrans, d->tcp_segs_out);
+    }
+    samples.cpuUsageSample.addSample(CPUUsageSampleFrame(qMax(0., timedelta) / procset->cpuUsageTotalDelta() * 100));
 
     struct DiskIO io = {d->read_bytes, d->write_bytes, d->cancelled_write_bytes};
-    d->diskIOSample->addSample(new DISKIOSampleFrame(d->uptime, io));
+    samples.diskIOSample.addSample(DISKIOSampleFrame(d->uptime, io));
 
-    auto pair = d->diskIOSample->recentSamplePair();
+    auto pair = samples.diskIOSample.recentSamplePair();
     struct IOPS iops = DISKIOSampleFrame::diskiops(pair.first, pair.second);
-    d->diskIOSpeedSample->addSample(new IOPSSampleFrame(iops));
+    samples.diskIOSpeedSample.addSample(IOPSSampleFrame(iops));
 
     d->apptype = kNoFilter;
     const QVariant &euid = ProcessDB::instance()->processEuid();
@@ -242,10 +360,10 @@ void Process::readProcessInfo()
     if (euid == d->uid && (wmwindowList->isGuiApp(d->pid)
                            || wmwindowList->isTrayApp(d->pid)
                            || wmwindowList->isDesktopEntryApp(d->pid))) {
-        qCDebug(app) << "Process" << d->pid << "is a GUI/Tray/Desktop app";
+        TRACE_LOG_TRACE("Process %d is a GUI/Tray/Desktop app", d->pid);
         d->apptype = kFilterApps;
     } else if (euid == d->uid) {
-        qCDebug(app) << "Process" << d->pid << "is a current user app";
+        TRACE_LOG_TRACE("Process %d is a current user app", d->pid);
         d->apptype = kFilterCurrentUser;
     }
 
@@ -260,107 +378,91 @@ void Process::readProcessInfo()
             sum_send += sockIOStat->tx_bytes;
         }
     }
-    d->networkIOSample->addSample(new IOSampleFrame(d->uptime, {sum_recv, sum_send}));
+    samples.networkIOSample.addSample(IOSampleFrame(d->uptime, {sum_recv, sum_send}));
 
-    auto netpair = d->networkIOSample->recentSamplePair();
+    auto netpair = samples.networkIOSample.recentSamplePair();
     struct IOPS netiops = IOSampleFrame::iops(netpair.first, netpair.second);
-    d->networkBandwidthSample->addSample(new IOPSSampleFrame(netiops));
+    samples.networkBandwidthSample.addSample(IOPSSampleFrame(netiops));
 
     d->valid = d->valid && ok;
-    qCDebug(app) << "Finished reading full info for pid" << d->pid << "valid:" << d->valid;
+    TRACE_LOG_TRACE("Finished reading full info for pid %d valid: %d", d->pid, int(d->valid));
 }
 
 // read /proc/[pid]/stat
-bool Process::readStat()
+bool Process::readStat(ProcFdCache *fdCache)
 {
-    qCDebug(app) << "Reading stat for pid" << d->pid;
+    TRACE_LOG_TRACE("Reading stat for pid %d", d->pid);
     bool ok {true};
-    char path[256];
-    QByteArray buf;
-    int fd, rc;
+    char buf[1025];
     ssize_t sz;
-    char *pos, *begin;
-
-    buf.reserve(1025);
+    const char *comm, *rest;
+    size_t commLen;
 
     errno = 0;
-    sprintf(path, PROC_STAT_PATH, d->pid);
-    if(access(path, R_OK) != 0) {
-        qCWarning(app) << "Cannot access stat file for process" << d->pid;
-        return !ok;
-    }
-        
-    // open /proc/[pid]/stat
-    if ((fd = open(path, O_RDONLY)) < 0) {
-        qCWarning(app) << "Failed to open stat file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("open %1 failed").arg(path));
-        return !ok;
-    }
-
-    // read data
-    sz = read(fd, buf.data(), 1024);
-    close(fd);
+    sz = readProcFile(fdCache, d->pid, ProcFdCache::kStatFile, buf, sizeof(buf));
     if (sz < 0) {
-        qCWarning(app) << "Failed to read stat file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("read %1 failed").arg(path));
+        // process exited between scan & read, not an error worth warning
+        if (!checkVanished(errno, d->vanished)) {
+            qCWarning(app) << "Failed to read stat file for process" << d->pid << "Error:" << strerror(errno);
+            print_errno(errno, QString("read /proc/%1/stat failed").arg(d->pid));
+        }
         return !ok;
     }
-    buf.data()[sz] = '\0';
 
     // get process name between (...)
-    begin = strchr(buf.data(), '(');
-    begin += 1;
-
-    pos = strrchr(buf.data(), ')');
-    if (!pos) {
+    if (!splitStatComm(buf, size_t(sz), comm, commLen, rest)) {
         qCWarning(app) << "Invalid stat file format for process" << d->pid;
         return !ok;
     }
-
-    *pos = '\0';
-    // process name (may be truncated by kernel if it's too long)
-    d->name = QByteArray(begin);
-
-    pos += 2;
-
-    //****************3**4**5***********************************14***15**
-    rc = sscanf(pos, "%c %d %d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu"
-                //*16***17******19*20******22************************************
-                " %lld %lld %*d %d %u %*u %llu %*u %*u %*u %*u %*u %*u %*u %*u"
-                //********************************39*40*41******43***44**********
-                " %*u %*u %*u %*u %*u %*u %*u %*u %u %u %u %*u %llu %lld\n",
-                &d->state, // 3
-                &d->ppid, // 4
-                &d->pgid, // 5
-                &d->utime, // 14
-                &d->stime, // 15
-                &d->cutime, // 16
-                &d->cstime, // 17
-                &d->nice, // 19
-                &d->nthreads, // 20
-                &d->start_time, // 22
-                &d->processor, // 39
-                &d->rt_prio, // 40
-                &d->policy, // 41
-                &d->guest_time, // 43
-                &d->cguest_time); // 44
-    if (rc < 15) {
-        qCWarning(app) << "Failed to parse stat file for process" << d->pid << "Parsed fields:" << rc;
+    // process name (may be truncated by kernel if it's too long), kept as is unless renamed,
+    // a latin1 compare of the same length only matches ascii names
+    if (d->name.size() != int(commLen) || d->name != QLatin1String(comm, int(commLen)))
+        d->name = StringPool::instance()->fromUtf8(comm, int(commLen));
+
+    Tokenizer tok(rest, size_t(buf + sz - rest));
+    bool parsed = tok.readChar(d->state) // 3
+            && tok.readInt(d->ppid) // 4
+            && tok.readInt(d->pgid) // 5
+            && tok.skipTokens(4) // 6 ~ 9
+            && tok.readU64(d->minflt) // 10
+            && tok.skipTokens(1) // 11
+            && tok.readU64(d->majflt) // 12
+            && tok.skipTokens(1) // 13
+            && tok.readUInt(d->utime) // 14
+            && tok.readUInt(d->stime) // 15
+            && tok.readInt(d->cutime) // 16
+            && tok.readInt(d->cstime) // 17
+            && tok.skipTokens(1) // 18
+            && tok.readInt(d->nice) // 19
+            && tok.readUInt(d->nthreads) // 20
+            && tok.skipTokens(1) // 21
+            && tok.readUInt(d->start_time) // 22
+            && tok.skipTokens(16) // 23 ~ 38
+            && tok.readUInt(d->processor) // 39
+            && tok.readUInt(d->rt_prio) // 40
+            && tok.readUInt(d->policy); // 41
+    if (!parsed) {
+        qCWarning(app) << "Failed to parse stat file for process" << d->pid;
         return !ok;
     }
-    // have guest & cguest time
-    if (rc < 17) {
+    // have block io delay, guest & cguest time
+    unsigned long long blkioTicks = 0;
+    if (!(tok.readU64(blkioTicks) // 42
+          && tok.readUInt(d->guest_time) // 43
+          && tok.readInt(d->cguest_time))) { // 44
         d->guest_time = d->cguest_time = 0;
     }
+    // replaced by the ns of taskstats when permitted, see setTaskStats
+    d->blkio_delay = blkioTicks * 1000000000 / HZ;
 
-    qCDebug(app) << "Successfully read stat for pid" << d->pid;
+    TRACE_LOG_TRACE("Successfully read stat for pid %d", d->pid);
     return ok;
 }
 
 // read /proc/[pid]/cmdline
 bool Process::readCmdline()
 {
-    qCDebug(app) << "Reading cmdline for pid" << d->pid;
+    TRACE_LOG_TRACE("Reading cmdline for pid %d", d->pid);
     bool ok = true;
     char path[128] {};
     const size_t bsiz = 4096;
@@ -370,17 +472,15 @@ bool Process::readCmdline()
     char *begin, *cur, *end;
 
     sprintf(path, PROC_CMDLINE_PATH, d->pid);
-    if(access(path, R_OK) != 0) {
-        qCWarning(app) << "Cannot access cmdline file for process" << d->pid;
-        return !ok;
-    }
 
     errno = 0;
     // open /proc/[pid]/cmdline
     uFile fp(fopen(path, "r"));
     if (!fp) {
-        qCWarning(app) << "Failed to open cmdline file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("open %1 failed").arg(path));
+        if (!checkVanished(errno, d->vanished)) {
+            qCWarning(app) << "Failed to open cmdline file for process" << d->pid << "Error:" << strerror(errno);
+            print_errno(errno, QString("open %1 failed").arg(path));
+        }
         return !ok;
     }
 
@@ -398,214 +498,158 @@ bool Process::readCmdline()
     while (cur < end) {
         // cmdline may sperarted by null character
         if (*cur == '\0') {
-            QByteArray buf(begin);
-            d->cmdline << buf;
+            d->cmdline << StringPool::instance()->intern(QByteArray::fromRawData(begin, int(cur - begin)));
             begin = cur + 1;
         }
         ++cur;
     }
-    if (begin < end) {
-        QByteArray buf(begin);
-        d->cmdline << buf;
-    }
+    if (begin < end)
+        d->cmdline << StringPool::instance()->intern(QByteArray::fromRawData(begin, int(end - begin)));
+    digestCmdline();
 
-    qCDebug(app) << "Successfully read cmdline for pid" << d->pid;
+    TRACE_LOG_TRACE("Successfully read cmdline for pid %d", d->pid);
     return ok;
 }
 
-// read /proc/[pid]/environ
-void Process::readEnviron()
+void Process::digestCmdline()
 {
-    qCDebug(app) << "Reading environ for pid" << d->pid;
-    const size_t sz = 1024;
-    char path[128] {};
-    ssize_t nb;
-    QByteArray sbuf {};
-    char buf[sz + 1] {};
-    int fd;
-
-    sprintf(path, PROC_ENVIRON_PATH, d->pid);
-    if(access(path, R_OK) != 0) {
-        // qCWarning(app) << "Cannot access environment file for process" << d->pid;
-        return;
-    }
-
-    errno = 0;
-    // open /proc/[pid]/environ
-    fd = open(path, O_RDONLY);
-    if (fd < 0) {
-        qCWarning(app) << "Failed to open environment file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("open %1 failed").arg(path));
-        return;
-    }
-
-    while ((nb = read(fd, buf, sz))) {
-        buf[nb] = '\0';
-        sbuf.append(buf, int(nb));
-    }
-    close(fd);
+    // joined once per process, not on every scan that looks at it
+    const QByteArray joined = d->cmdline.join(' ');
+    d->cmdline_text = StringPool::instance()->intern(truncatedCmdline(joined, kCmdlineTextBytes));
+    d->bare_shell = joined == "/bin/bash";
+}
 
-    if (nb == 0 && errno != 0) {
-        qCWarning(app) << "Failed to read environment file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("read %1 failed").arg(path));
-        return;
-    }
+QString Process::truncatedCmdline(const QByteArray &joined, int maxBytes)
+{
+    if (joined.size() <= maxBytes)
+        return QUrl::fromPercentEncoding(joined);
+
+    int size = maxBytes;
+    // the first byte left out mustn't continue a sequence started before it
+    while (size > 0 && (uchar(joined[size]) & 0xC0) == 0x80)
+        --size;
+    if (size >= 1 && joined[size - 1] == '%')
+        size -= 1;
+    else if (size >= 2 && joined[size - 2] == '%')
+        size -= 2;
+    return QUrl::fromPercentEncoding(joined.left(size)) + QChar(0x2026);
+}
 
-    if (sbuf.size() > 0) {
-        qCDebug(app) << "Processing environment variables for pid" << d->pid;
-        auto elist = sbuf.split('\0');
-        for (auto it : elist) {
-            // it: name=value pair
-            auto kvp = it.split('=');
-            if (kvp.size() == 2) {
-                d->environ[kvp[0]] = kvp[1];
-            }
-        }
-    }
-    qCDebug(app) << "Finished reading environ for pid" << d->pid;
+QString Process::readFullCmdline(pid_t pid)
+{
+    char path[128] {};
+    sprintf(path, PROC_CMDLINE_PATH, pid);
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    // procfs reports no size, read to the end
+    QByteArray cmd = file.readAll();
+    if (cmd.endsWith('\0'))
+        cmd.chop(1);
+    cmd.replace('\0', ' ');
+    return QUrl::fromPercentEncoding(cmd);
 }
 
 // read /proc/[pid]/schedstat
-void Process::readSchedStat()
+void Process::readSchedStat(ProcFdCache *fdCache)
 {
-    qCDebug(app) << "Reading schedstat for pid" << d->pid;
-    const size_t bsiz = 1024;
-    QByteArray buf;
-    char path[128];
-    int fd, rc;
+    TRACE_LOG_TRACE("Reading schedstat for pid %d", d->pid);
+    char buf[128];
     ssize_t n;
     unsigned long long wtime = 0;
 
-    buf.reserve(bsiz);
-    sprintf(path, PROC_SCHEDSTAT_PATH, d->pid);
-    if(access(path, R_OK) != 0) {
-        qCWarning(app) << "Cannot access schedstat file for process" << d->pid;
-        return;
-    }
-
     errno = 0;
-    // open /proc/[pid]/schedstat
-    if ((fd = open(path, O_RDONLY)) < 0) {
-        qCWarning(app) << "Failed to open schedstat file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("open %1 failed").arg(path));
-        return;
-    }
-
-    n = read(fd, buf.data(), bsiz - 1);
-    close(fd);
-
+    n = readProcFile(fdCache, d->pid, ProcFdCache::kSchedStatFile, buf, sizeof(buf));
     if (n < 0) {
-        qCWarning(app) << "Failed to read schedstat file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("read %1 failed").arg(path));
+        // schedstat is missing when kernel built without CONFIG_SCHED_INFO
+        if (errno != ENOENT && errno != ESRCH) {
+            qCWarning(app) << "Failed to read schedstat file for process" << d->pid << "Error:" << strerror(errno);
+            print_errno(errno, QString("read /proc/%1/schedstat failed").arg(d->pid));
+        }
         return;
     }
 
-    buf.data()[n] = '\0';
-    rc = sscanf(buf.data(), "%*u %llu %*d", &wtime);
-    if (rc == 1) {
+    // on cpu time, run queue wait time, timeslices
+    Tokenizer tok(buf, size_t(n));
+    if (tok.skipTokens(1) && tok.readU64(wtime)) {
         d->wtime = wtime * HZ / 1000000000;
-        qCDebug(app) << "Successfully parsed schedstat for pid" << d->pid;
+        TRACE_LOG_TRACE("Successfully parsed schedstat for pid %d", d->pid);
     } else {
         qCWarning(app) << "Failed to parse schedstat file for process" << d->pid;
     }
-    qCDebug(app) << "Finished reading schedstat for pid" << d->pid;
+    TRACE_LOG_TRACE("Finished reading schedstat for pid %d", d->pid);
 }
 
 // read /proc/[pid]/status
-bool Process::readStatus()
+bool Process::readStatus(ProcFdCache *fdCache)
 {
     bool ok {true};
-    const size_t bsiz = 256;
-    QByteArray buf;
-    char path[128];
-
-    buf.reserve(bsiz);
-    sprintf(path, PROC_STATUS_PATH, d->pid);
-    if(access(path, R_OK) != 0) {
-        qCWarning(app) << "Cannot access status file for process" << d->pid;
-        return !ok;
-    }
+    char buf[4096];
+    ssize_t nr;
 
     errno = 0;
-    uFile fp(fopen(path, "r"));
-    // open /proc/[pid]/status
-    if (!fp) {
-        qCWarning(app) << "Failed to open status file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("open %1 failed").arg(path));
+    nr = readProcFile(fdCache, d->pid, ProcFdCache::kStatusFile, buf, sizeof(buf));
+    if (nr < 0) {
+        if (!checkVanished(errno, d->vanished)) {
+            qCWarning(app) << "Failed to read status file for process" << d->pid << "Error:" << strerror(errno);
+            print_errno(errno, QString("read /proc/%1/status failed").arg(d->pid));
+        }
         return !ok;
     }
 
     // scan each line
-    while (fgets(buf.data(), bsiz, fp.get())) {
-        if (!strncmp(buf.data(), "Umask:", 6)) {
-            sscanf(buf.data() + 7, "%u", &d->mask);
-        } else if (!strncmp(buf.data(), "State:", 6)) {
-            sscanf(buf.data() + 7, "%c %*s", &d->state);
-        } else if (!strncmp(buf.data(), "Uid:", 4)) {
-            sscanf(buf.data() + 5, "%u %u %u %u",
-                   &d->uid,
-                   &d->euid,
-                   &d->suid,
-                   &d->fuid);
-        } else if (!strncmp(buf.data(), "Gid:", 4)) {
-            sscanf(buf.data() + 5, "%u %u %u %u",
-                   &d->gid,
-                   &d->egid,
-                   &d->sgid,
-                   &d->fgid);
+    Tokenizer tok(buf, size_t(nr));
+    const char *key;
+    size_t len;
+    do {
+        if (!tok.readKey(key, len))
+            continue;
+
+        if (keyEquals(key, len, "Umask", 5)) {
+            tok.readUInt(d->mask);
+        } else if (keyEquals(key, len, "State", 5)) {
+            tok.readChar(d->state);
+        } else if (keyEquals(key, len, "Uid", 3)) {
+            tok.readUInt(d->uid) && tok.readUInt(d->euid) && tok.readUInt(d->suid) && tok.readUInt(d->fuid);
+        } else if (keyEquals(key, len, "Gid", 3)) {
+            tok.readUInt(d->gid) && tok.readUInt(d->egid) && tok.readUInt(d->sgid) && tok.readUInt(d->fgid);
+        } else if (keyEquals(key, len, "voluntary_ctxt_switches", 23)) {
+            tok.readU64(d->nvcsw);
+        } else if (keyEquals(key, len, "nonvoluntary_ctxt_switches", 26)) {
+            tok.readU64(d->nivcsw);
+            // last line
+            break;
         }
-    }
+    } while (tok.nextLine());
 
-    if (ferror(fp.get())) {
-        qCWarning(app) << "Failed to read status file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("read %1 failed").arg(path));
-        return !ok;
-    }
-
-    qCDebug(app) << "Successfully read status for pid" << d->pid;
+    TRACE_LOG_TRACE("Successfully read status for pid %d", d->pid);
     return ok;
 }
 
 // read /proc/[pid]/statm
-bool Process::readStatm()
+bool Process::readStatm(ProcFdCache *fdCache)
 {
     bool ok {true};
-    int fd;
-    const size_t bsiz = 1024;
-    char path[128] {}, buf[bsiz + 1] {};
+    char buf[256];
     ssize_t nr;
 
-    sprintf(path, PROC_STATM_PATH, d->pid);
-    if(access(path, R_OK) != 0) {
-        qCWarning(app) << "Cannot access statm file for process" << d->pid;
-        return !ok;
-    }
-
     errno = 0;
-    // open /proc/[pid]/statm
-    if ((fd = open(path, O_RDONLY)) < 0) {
-        qCWarning(app) << "Failed to open statm file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("open %1 failed").arg(path));
-        return !ok;
-    }
-
-    nr = read(fd, buf, bsiz);
-    close(fd);
+    nr = readProcFile(fdCache, d->pid, ProcFdCache::kStatmFile, buf, sizeof(buf));
     if (nr < 0) {
-        qCWarning(app) << "Failed to read statm file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("read %1 failed").arg(path));
+        if (!checkVanished(errno, d->vanished)) {
+            qCWarning(app) << "Failed to read statm file for process" << d->pid << "Error:" << strerror(errno);
+            print_errno(errno, QString("read /proc/%1/statm failed").arg(d->pid));
+        }
         return !ok;
     }
 
-    buf[nr] = '\0';
     // get resident set size & resident shared size in pages
-    nr = sscanf(buf, "%llu %llu %llu", &d->vmsize, &d->rss, &d->shm);
-    if (nr != 3) {
+    Tokenizer tok(buf, size_t(nr));
+    if (!(tok.readU64(d->vmsize) && tok.readU64(d->rss) && tok.readU64(d->shm))) {
         d->vmsize = 0;
         d->rss = 0;
         d->shm = 0;
         qCWarning(app) << "Failed to parse statm file for process" << d->pid;
-        print_errno(errno, QString("read %1 failed").arg(path));
     } else {
         // convert to kB
         d->vmsize <<= kb_shift;
@@ -616,87 +660,61 @@ bool Process::readStatm()
 }
 
 // read /proc/[pid]/io
-void Process::readIO()
+void Process::readIO(ProcFdCache *fdCache)
 {
-    const size_t bsiz = 128;
-    char path[128], buf[bsiz];
-
-    sprintf(path, PROC_IO_PATH, d->pid);
-    if(access(path, R_OK) != 0) {
-        // qCWarning(app) << "Cannot access IO file for process" << d->pid;
-        return;
-    }
+    char buf[512];
+    ssize_t nr;
 
     errno = 0;
-    // open /proc/[pid]/io
-    uFile fp(fopen(path, "r"));
-    if (!fp) {
-        qCWarning(app) << "Failed to open IO file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("open %1 failed").arg(path));
+    nr = readProcFile(fdCache, d->pid, ProcFdCache::kIOFile, buf, sizeof(buf));
+    if (nr < 0) {
+        // io of other users' processes is not readable without privilege
+        if (errno != EACCES && errno != ENOENT && errno != ESRCH) {
+            qCWarning(app) << "Failed to read IO file for process" << d->pid << "Error:" << strerror(errno);
+            print_errno(errno, QString("read /proc/%1/io failed").arg(d->pid));
+        }
         return;
     }
 
     // scan each line
-    while (fgets(buf, bsiz, fp.get())) {
-        if (!strncmp(buf, "read_bytes", 10)) {
-            sscanf(buf + 12, "%llu", &d->read_bytes);
-        } else if (!strncmp(buf, "write_bytes", 11)) {
-            sscanf(buf + 13, "%llu", &d->write_bytes);
-        } else if (!strncmp(buf, "cancelled_write_bytes", 21)) {
-            sscanf(buf + 23, "%llu", &d->cancelled_write_bytes);
+    Tokenizer tok(buf, size_t(nr));
+    const char *key;
+    size_t len;
+    unsigned long long syscr = 0, syscw = 0;
+    do {
+        if (!tok.readKey(key, len))
+            continue;
+
+        if (keyEquals(key, len, "syscr", 5)) {
+            tok.readU64(syscr);
+        } else if (keyEquals(key, len, "syscw", 5)) {
+            tok.readU64(syscw);
+        } else if (keyEquals(key, len, "read_bytes", 10)) {
+            tok.readU64(d->read_bytes);
+        } else if (keyEquals(key, len, "write_bytes", 11)) {
+            tok.readU64(d->write_bytes);
+        } else if (keyEquals(key, len, "cancelled_write_bytes", 21)) {
+            tok.readU64(d->cancelled_write_bytes);
         }
-    }
-    if (ferror(fp.get())) {
-        qCWarning(app) << "Failed to read IO file for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("read %1 failed").arg(path));
-    }
+    } while (tok.nextLine());
+    d->io_syscalls = syscr + syscw;
 
-    qCDebug(app) << "Finished reading IO for pid" << d->pid;
+    TRACE_LOG_TRACE("Finished reading IO for pid %d", d->pid);
 }
 
 // read /proc/[pid]/fd
-void Process::readSockInodes()
+void Process::readSockInodes(ProcFdCache *fdCache)
 {
-    struct dirent *dp;
-    char path[128], fdp[256 + 32];
-    struct stat sbuf;
-
-    sprintf(path, PROC_FD_PATH, d->pid);
-    if(access(path, R_OK) != 0) {
-        // qCWarning(app) << "Cannot access fd directory for process" << d->pid;
-        return;
-    }
-
-    errno = 0;
-    // open /proc/[pid]/fd dir
-    uDir dir(opendir(path));
-    if (!dir) {
-        qCWarning(app) << "Failed to open fd directory for process" << d->pid << "Error:" << strerror(errno);
-        print_errno(errno, QString("open %1 failed").arg(path));
-        return;
+    fd_stats_t stats;
+    if (fdCache) {
+        d->sockInodes = fdCache->sockInodeIndex()->sockInodes(d->pid, &stats);
+    } else {
+        d->sockInodes.clear();
+        SockInodeIndex::scanSockInodes(d->pid, d->sockInodes, &stats);
     }
-
-    // enumerate each entry
-    while ((dp = readdir(dir.get()))) {
-        // only if entry name starts with a digit
-        if (isdigit(dp->d_name[0])) {
-            // open /proc/[pid]/fd/[fd]
-            sprintf(fdp, PROC_FD_NAME_PATH, d->pid, dp->d_name);
-            memset(&sbuf, 0, sizeof(struct stat));
-            if (!stat(fdp, &sbuf)) {
-                // get inode if it's a socket descriptor
-                if (S_ISSOCK(sbuf.st_mode)) {
-                    // not append repeat data, may memory leak.
-                    if (!d->sockInodes.contains(sbuf.st_ino)) {
-                        d->sockInodes << sbuf.st_ino;
-                    }
-                }
-            } // ::if(stat)
-        } // ::if(isdigit)
-    } // ::while(readdir)
-    // if (errno) {
-    //     print_errno(errno, QString("read %1 failed").arg(path));
-    // }
+    d->fd_count = stats.fds;
+    d->sock_count = stats.sockets;
+    d->drmFds = stats.drmFds;
 }
 
 bool Process::isValid() const
@@ -704,6 +722,11 @@ bool Process::isValid() const
     return d && d->isValid();
 }
 
+bool Process::vanished() const
+{
+    return d && d->vanished;
+}
+
 pid_t Process::ppid() const
 {
     return d->ppid;
@@ -732,7 +755,8 @@ QString Process::name() const
 void Process::setName(const QString &name)
 {
     // qCDebug(app) << "Set name for pid" << d->pid << "to" << name;
-    d->name = name;
+    if (d->name != name)
+        d->name = StringPool::instance()->intern(name);
 }
 
 QString Process::displayName() const
@@ -742,57 +766,86 @@ QString Process::displayName() const
 
 void Process::calculateProcessMetrics()
 {
-    CPUSet *cpuset = DeviceDB::instance()->cpuSet();
     ProcessSet *procset =  ProcessDB::instance()->processSet();
 
-    auto recentProcptr = procset->getRecentProcStage(d->pid);
+    auto recentProcptr = procset->getRecentProcStage(d->pid, d->start_time);
     auto validrecentPtr = recentProcptr.lock();
+    ProcessSamples &samples = d->mutableSamples();
     qreal timedelta = d->stime + d->utime;
     if (validrecentPtr) {
-        qCDebug(app) << "Found recent process stage for pid" << d->pid;
-        qreal previousTime = validrecentPtr->ptime;
-        timedelta = timedelta - previousTime;
-        
-        // Check for abnormal time delta that might indicate data corruption
-        // If current time is much smaller than previous time, it suggests the current data was corrected
-        if (timedelta < -1000) { // If delta is very negative (more than 1000 jiffies)
-            qCInfo(app) << "Detected corrected CPU time for PID" << d->pid 
-                       << "- current:" << (d->stime + d->utime) << "previous:" << previousTime
-                       << "delta:" << timedelta << ". Using current time as baseline.";
-            // Use current time as the baseline, effectively treating this as a new process
-            timedelta = d->stime + d->utime;
-        }
-        
+        TRACE_LOG_TRACE("Found recent process stage for pid %d", d->pid);
+        timedelta = timedelta - validrecentPtr->ptime;
         struct DiskIO io = {validrecentPtr->read_bytes, validrecentPtr->write_bytes, validrecentPtr->cancelled_write_bytes};
-        d->diskIOSample->addSample(new DISKIOSampleFrame(validrecentPtr->uptime, io));
-
-        d->networkIOSample->addSample(new IOSampleFrame(validrecentPtr->uptime, {0, 0}));
-    }
-    d->cpuUsageSample->addSample(new CPUUsageSampleFrame(qMax(0., timedelta) / cpuset->getUsageTotalDelta() * 100));
+        samples.diskIOSample.addSample(DISKIOSampleFrame(validrecentPtr->uptime, io));
+
+        samples.networkIOSample.addSample(IOSampleFrame(validrecentPtr->uptime, {0, 0}));
+        d->memory_growth = memoryGrowthSince(*validrecentPtr, memory(), d->uptime);
+        // same base as cpu usage, run queue wait is in clock ticks too
+        qreal waitdelta = qreal(d->wtime) - qreal(validrecentPtr->wtime);
+        samples.cpuWaitSample.addSample(CPUUsageSampleFrame(qMax(0., waitdelta) / procset->cpuUsageTotalDelta() * 100));
+        // vcpu threads of kvm guests, on the same base too
+        qreal guestdelta = qreal(d->guest_time) - qreal(validrecentPtr->gtime);
+        d->guest_cpu = qMax(0., guestdelta) / procset->cpuUsageTotalDelta() * 100;
+        qreal secs = secondsSince(*validrecentPtr, d->uptime);
+        samples.eventRatesSample.addSample(EventRatesSampleFrame({rateSince(d->minflt, validrecentPtr->minflt, secs),
+                                                                  rateSince(d->majflt, validrecentPtr->majflt, secs),
+                                                                  rateSince(d->nvcsw, validrecentPtr->nvcsw, secs),
+                                                                  rateSince(d->nivcsw, validrecentPtr->nivcsw, secs),
+                                                                  rateSince(d->io_syscalls, validrecentPtr->io_syscalls, secs)}));
+        samples.ioWaitSample.addSample(CPUUsageSampleFrame(ioWaitSince(*validrecentPtr, d->blkio_delay, d->swapin_delay, secs)));
+        d->tcp_retrans_rate = retransRateSince(*validrecentPtr, d->tcp_retrans, d->tcp_segs_out);
+    }
+    samples.cpuUsageSample.addSample(CPUUsageSampleFrame(qMax(0., timedelta) / procset->cpuUsageTotalDelta() * 100));
 
     struct DiskIO io = {d->read_bytes, d->write_bytes, d->cancelled_write_bytes};
-    d->diskIOSample->addSample(new DISKIOSampleFrame(d->uptime, io));
+    samples.diskIOSample.addSample(DISKIOSampleFrame(d->uptime, io));
 
-    auto pair = d->diskIOSample->recentSamplePair();
+    auto pair = samples.diskIOSample.recentSamplePair();
     struct IOPS iops = DISKIOSampleFrame::diskiops(pair.first, pair.second);
-    d->diskIOSpeedSample->addSample(new IOPSSampleFrame(iops));
+    samples.diskIOSpeedSample.addSample(IOPSSampleFrame(iops));
+
+    // a leaking process keeps opening fds without the count ever dropping, a run restarts on each drop
+    qreal now = d->uptime.tv_sec + d->uptime.tv_usec / 1000000.;
+    d->fd_growth_since = now;
+    d->fd_growth_base = d->fd_count;
+    d->fd_growth = 0;
+    d->fd_leak = false;
+    if (validrecentPtr && d->fd_count >= 0 && validrecentPtr->fd_count >= 0 && d->fd_count >= validrecentPtr->fd_count) {
+        d->fd_growth_since = validrecentPtr->fd_growth_since;
+        d->fd_growth_base = validrecentPtr->fd_growth_base;
+        qreal secs = now - d->fd_growth_since;
+        int grown = d->fd_count - d->fd_growth_base;
+        if (secs > 0)
+            d->fd_growth = grown * 60 / secs;
+        d->fd_leak = secs >= procset->fdLeakWindow() && grown >= ProcessSet::kFdLeakMinGrowth;
+    }
 
     qulonglong sum_recv = 0;
     qulonglong sum_send = 0;
 
-    for (int i = 0; i < d->sockInodes.size(); ++i) {
-        SockIOStat sockIOStat;
-        bool result = NetifMonitor::instance()->getSockIOStatByInode(d->sockInodes[i], sockIOStat);
-        if (result) {
-            sum_recv += sockIOStat->rx_bytes;
-            sum_send += sockIOStat->tx_bytes;
+    if (d->has_net_counters) {
+        // kernel counters are cumulative, samples hold bytes of this interval
+        if (validrecentPtr && validrecentPtr->has_net_counters) {
+            if (d->net_rx_bytes >= validrecentPtr->net_rx_bytes)
+                sum_recv = d->net_rx_bytes - validrecentPtr->net_rx_bytes;
+            if (d->net_tx_bytes >= validrecentPtr->net_tx_bytes)
+                sum_send = d->net_tx_bytes - validrecentPtr->net_tx_bytes;
+        }
+    } else {
+        for (int i = 0; i < d->sockInodes.size(); ++i) {
+            SockIOStat sockIOStat;
+            bool result = NetifMonitor::instance()->getSockIOStatByInode(d->sockInodes[i], sockIOStat);
+            if (result) {
+                sum_recv += sockIOStat->rx_bytes;
+                sum_send += sockIOStat->tx_bytes;
+            }
         }
     }
-    d->networkIOSample->addSample(new IOSampleFrame(d->uptime, {sum_recv, sum_send}));
+    samples.networkIOSample.addSample(IOSampleFrame(d->uptime, {sum_recv, sum_send}));
 
-    auto netpair = d->networkIOSample->recentSamplePair();
+    auto netpair = samples.networkIOSample.recentSamplePair();
     struct IOPS netiops = IOSampleFrame::iops(netpair.first, netpair.second);
-    d->networkBandwidthSample->addSample(new IOPSSampleFrame(netiops));
+    samples.networkBandwidthSample.addSample(IOPSSampleFrame(netiops));
 }
 
 QIcon Process::icon() const
@@ -800,25 +853,141 @@ QIcon Process::icon() const
     return d->proc_icon.icon();
 }
 
+QString Process::iconKey() const
+{
+    return d->proc_icon.pixmapKey();
+}
+
 qreal Process::cpu() const
 {
-    auto *sample = d->cpuUsageSample->recentSample();
+    auto *sample = d->samples->cpuUsageSample.recentSample();
     if (sample)
         return sample->data;
     else
         return {};
 }
 
+qreal Process::cpuWait() const
+{
+    auto *sample = d->samples->cpuWaitSample.recentSample();
+    if (sample)
+        return sample->data;
+    else
+        return {};
+}
+
+qulonglong Process::wtime() const
+{
+    return d->wtime;
+}
+
+qreal Process::guestCpu() const
+{
+    return d->guest_cpu;
+}
+
+qulonglong Process::guestTime() const
+{
+    return d->guest_time;
+}
+
+qreal Process::minorFaultRate() const
+{
+    auto *sample = d->samples->eventRatesSample.recentSample();
+    return sample ? sample->data.minorFaults : 0;
+}
+
+qreal Process::majorFaultRate() const
+{
+    auto *sample = d->samples->eventRatesSample.recentSample();
+    return sample ? sample->data.majorFaults : 0;
+}
+
+qreal Process::voluntarySwitchRate() const
+{
+    auto *sample = d->samples->eventRatesSample.recentSample();
+    return sample ? sample->data.voluntarySwitches : 0;
+}
+
+qreal Process::involuntarySwitchRate() const
+{
+    auto *sample = d->samples->eventRatesSample.recentSample();
+    return sample ? sample->data.involuntarySwitches : 0;
+}
+
+qulonglong Process::minorFaults() const
+{
+    return d->minflt;
+}
+
+qulonglong Process::majorFaults() const
+{
+    return d->majflt;
+}
+
+qulonglong Process::voluntarySwitches() const
+{
+    return d->nvcsw;
+}
+
+qulonglong Process::involuntarySwitches() const
+{
+    return d->nivcsw;
+}
+
 void Process::setCpu(qreal cpu)
 {
-    d->cpuUsageSample->addSample(new CPUUsageSampleFrame(cpu));
+    d->mutableSamples().cpuUsageSample.addSample(CPUUsageSampleFrame(cpu));
+}
+
+qreal Process::power() const
+{
+    return d->power;
+}
+
+void Process::setPower(qreal watts)
+{
+    d->power = watts;
+}
+
+qreal Process::wakeupRate() const
+{
+    return hasTracedWakeups() ? d->wakeup_rate : voluntarySwitchRate();
+}
+
+qreal Process::timerWakeupRate() const
+{
+    return d->timer_wakeup_rate;
+}
+
+bool Process::hasTracedWakeups() const
+{
+    return d->wakeup_rate >= 0;
+}
+
+void Process::setWakeups(qreal rate, qreal timerRate)
+{
+    d->wakeup_rate = rate;
+    d->timer_wakeup_rate = timerRate;
 }
 
 qulonglong Process::memory() const
 {
+    if (d->group_memory)
+        return d->group_memory;
     return d->rss - d->shm;
 }
 
+void Process::setGroupMemory(qulonglong memory)
+{
+    d->group_memory = memory;
+    // last scan kept memory() of this app, the group's one as long as it stays grouped
+    ProcessSet *procset = ProcessDB::instance()->processSet();
+    auto recent = procset->getRecentProcStage(d->pid, d->start_time).lock();
+    if (recent)
+        d->memory_growth = memoryGrowthSince(*recent, memory, d->uptime);
+}
+
 qulonglong Process::vtrmemory() const
 {
     return d->vmsize;
@@ -829,6 +998,139 @@ qulonglong Process::sharememory() const
     return d->shm;
 }
 
+qreal Process::memoryGrowth() const
+{
+    return d->memory_growth;
+}
+
+qreal Process::memoryTrend() const
+{
+    return d->memory_trend;
+}
+
+qreal Process::timeToMemoryExhaustion() const
+{
+    return d->memory_exhaustion;
+}
+
+bool Process::memoryLeakSuspected() const
+{
+    return d->memory_leak;
+}
+
+qreal Process::memoryLeakSince() const
+{
+    return d->memory_leak_since;
+}
+
+qulonglong Process::memoryLeakBase() const
+{
+    return d->memory_leak_base;
+}
+
+void Process::setMemoryTrend(qreal trend, qreal leakSince, qulonglong leakBase)
+{
+    d->memory_trend = trend;
+    d->memory_leak_since = leakSince;
+    d->memory_leak_base = leakBase;
+}
+
+void Process::setMemoryExhaustion(qreal seconds, bool leak)
+{
+    d->memory_exhaustion = seconds;
+    d->memory_leak = leak;
+}
+
+bool Process::hasSmaps() const
+{
+    return d->has_smaps;
+}
+
+qulonglong Process::pss() const
+{
+    return d->pss;
+}
+
+qulonglong Process::uss() const
+{
+    return d->uss;
+}
+
+qulonglong Process::swap() const
+{
+    return d->swap;
+}
+
+void Process::setSmaps(qulonglong pss, qulonglong uss, qulonglong swap)
+{
+    d->has_smaps = true;
+    d->pss = pss;
+    d->uss = uss;
+    d->swap = swap;
+}
+
+int Process::fdCount() const
+{
+    return d->fd_count;
+}
+
+int Process::socketCount() const
+{
+    return d->sock_count;
+}
+
+QList<ino_t> Process::sockInodes() const
+{
+    return d->sockInodes;
+}
+
+qreal Process::fdGrowth() const
+{
+    return d->fd_growth;
+}
+
+bool Process::fdLeakSuspected() const
+{
+    return d->fd_leak;
+}
+
+qreal Process::fdGrowthSince() const
+{
+    return d->fd_growth_since;
+}
+
+int Process::fdGrowthBase() const
+{
+    return d->fd_growth_base;
+}
+
+QList<int> Process::drmFds() const
+{
+    return d->drmFds;
+}
+
+bool Process::hasGpu() const
+{
+    return d->has_gpu;
+}
+
+qreal Process::gpuUsage() const
+{
+    return d->gpu_usage;
+}
+
+qulonglong Process::gpuMemory() const
+{
+    return d->gpu_memory;
+}
+
+void Process::setGpu(qreal usage, qulonglong memory)
+{
+    d->has_gpu = true;
+    d->gpu_usage = usage;
+    d->gpu_memory = memory;
+}
+
 int Process::priority() const
 {
     return d->nice;
@@ -844,11 +1146,48 @@ char Process::state() const
     return d->state;
 }
 
+unsigned int Process::nthreads() const
+{
+    return d->nthreads;
+}
+
 void Process::setState(char state)
 {
     d->state = state;
 }
 
+qreal Process::blockedSince() const
+{
+    return d->blocked_since;
+}
+
+bool Process::hangSuspected() const
+{
+    return d->hung;
+}
+
+void Process::setBlocked(qreal since, bool hung)
+{
+    d->blocked_since = since;
+    d->hung = hung;
+}
+
+QByteArray Process::blockingFunction() const
+{
+    return d->blocking_function;
+}
+
+int Process::blockingWait() const
+{
+    return d->blocking_wait;
+}
+
+void Process::setBlockingFunction(const QByteArray &function, int wait)
+{
+    d->blocking_function = function;
+    d->blocking_wait = wait;
+}
+
 QByteArrayList Process::cmdline() const
 {
     return d->cmdline;
@@ -859,9 +1198,20 @@ QString Process::cmdlineString() const
     return QUrl::fromPercentEncoding(d->cmdline.join(' '));
 }
 
+QString Process::cmdlineText() const
+{
+    return d->cmdline_text;
+}
+
+bool Process::isBareShell() const
+{
+    return d->bare_shell;
+}
+
 QHash<QString, QString> Process::environ() const
 {
-    return d->environ;
+    // loaded on first request, bounded by ProcessEnvironCache
+    return ProcessEnvironCache::instance()->environ(d->pid, d->start_time);
 }
 
 uid_t Process::uid() const
@@ -886,7 +1236,7 @@ QString Process::groupName() const
 
 qreal Process::readBps() const
 {
-    auto *sample = d->diskIOSpeedSample->recentSample();
+    auto *sample = d->samples->diskIOSpeedSample.recentSample();
     if (sample)
         return sample->data.inBps;
     else
@@ -895,7 +1245,7 @@ qreal Process::readBps() const
 
 qreal Process::writeBps() const
 {
-    auto *sample = d->diskIOSpeedSample->recentSample();
+    auto *sample = d->samples->diskIOSpeedSample.recentSample();
     if (sample)
         return sample->data.outBps;
     else
@@ -917,9 +1267,109 @@ qulonglong Process::cancelledWriteBytes() const
     return d->cancelled_write_bytes;
 }
 
+qreal Process::ioWait() const
+{
+    auto *sample = d->samples->ioWaitSample.recentSample();
+    return sample ? sample->data : 0;
+}
+
+qreal Process::ioSyscallRate() const
+{
+    auto *sample = d->samples->eventRatesSample.recentSample();
+    return sample ? sample->data.ioSyscalls : 0;
+}
+
+qulonglong Process::blkioDelay() const
+{
+    return d->blkio_delay;
+}
+
+qulonglong Process::swapinDelay() const
+{
+    return d->swapin_delay;
+}
+
+qulonglong Process::ioSyscalls() const
+{
+    return d->io_syscalls;
+}
+
+void Process::setTaskStats(const task_io_t &io)
+{
+    d->blkio_delay = io.blkioDelay;
+    d->swapin_delay = io.swapinDelay;
+    d->io_syscalls = io.syscalls;
+}
+
+bool Process::hasNetCounters() const
+{
+    return d->has_net_counters;
+}
+
+qulonglong Process::netRxBytes() const
+{
+    return d->net_rx_bytes;
+}
+
+qulonglong Process::netTxBytes() const
+{
+    return d->net_tx_bytes;
+}
+
+bool Process::hasTcpHealth() const
+{
+    return d->has_tcp_health;
+}
+
+qreal Process::tcpRtt() const
+{
+    return d->tcp_rtt / 1000.;
+}
+
+qreal Process::tcpRetransRate() const
+{
+    return d->tcp_retrans_rate;
+}
+
+qulonglong Process::tcpRetrans() const
+{
+    return d->tcp_retrans;
+}
+
+qulonglong Process::tcpSegsOut() const
+{
+    return d->tcp_segs_out;
+}
+
+void Process::readTcpHealth()
+{
+    d->has_tcp_health = false;
+    d->tcp_rtt = 0;
+    d->tcp_retrans = 0;
+    d->tcp_segs_out = 0;
+    d->tcp_retrans_rate = 0;
+    if (d->sockInodes.isEmpty())
+        return;
+
+    // dumped once per scan, see ProcessDB::update
+    auto health = NetifMonitor::instance()->tcpHealth();
+    if (!health || health->isEmpty())
+        return;
+
+    for (ino_t ino : d->sockInodes) {
+        auto it = health->constFind(ino);
+        if (it == health->cend())
+            continue;
+        d->has_tcp_health = true;
+        d->tcp_rtt = qMax(d->tcp_rtt, it->rtt);
+        d->tcp_retrans += it->retrans;
+        d->tcp_segs_out += it->segsOut;
+    }
+}
+
 qreal Process::recvBps() const
 {
-    auto *sample = d->networkBandwidthSample->recentSample();
+    auto *sample = d->samples->networkBandwidthSample.recentSample();
     if (sample)
         return sample->data.inBps;
     else
@@ -928,7 +1378,7 @@ qreal Process::recvBps() const
 
 qreal Process::sentBps() const
 {
-    auto *sample = d->networkBandwidthSample->recentSample();
+    auto *sample = d->samples->networkBandwidthSample.recentSample();
     if (sample)
         return sample->data.outBps;
     else
@@ -938,12 +1388,12 @@ qreal Process::sentBps() const
 void Process::setNetIoBps(qreal recvBps, qreal sendBps)
 {
     struct IOPS netIo = {recvBps, sendBps};
-    d->networkBandwidthSample->addSample(new IOPSSampleFrame(netIo));
+    d->mutableSamples().networkBandwidthSample.addSample(IOPSSampleFrame(netIo));
 }
 
 qulonglong Process::recvBytes() const
 {
-    auto *sample = d->networkIOSample->recentSample();
+    auto *sample = d->samples->networkIOSample.recentSample();
     if (sample)
         return sample->data.inBytes;
     else
@@ -952,7 +1402,7 @@ qulonglong Process::recvBytes() const
 
 qulonglong Process::sentBytes() const
 {
-    auto *sample = d->networkIOSample->recentSample();
+    auto *sample = d->samples->networkIOSample.recentSample();
     if (sample)
         return sample->data.outBytes;
     else
@@ -988,7 +1438,7 @@ void Process::refreashProcessIcon()
 
 void Process::setUserName(const QString &userName)
 {
-    d->usrerName = userName;
+    d->usrerName = StringPool::instance()->intern(userName);
 }
 
 void Process::applyDKaptureData(const QVariantMap &data)
@@ -1091,32 +1541,208 @@ void Process::applyDKaptureData(const QVariantMap &data)
         // DKapture提供纳秒单位数据，需要转换为时钟滴答数（与传统方式一致）
         qulonglong rq_wait_time_ns = data["rq_wait_time"].toULongLong();
         d->wtime = rq_wait_time_ns * HZ / 1000000000;  // 纳秒转时钟滴答数
-        qCDebug(app) << "✅ Applied SCHEDSTAT data for PID" << d->pid 
-                    << "- rq_wait_time_ns:" << rq_wait_time_ns << "-> wtime:" << d->wtime;
-    }
-
-    // 网络流量数据改为使用传统方式获取 - 避免DKapture系统级vs用户态数据差异
-    // 后端已禁用网络数据发送，前端使用传统socket inode方式获取网络流量
-    // if (data.contains("network_rx_bytes")) {
-    //     network_rx = data["network_rx_bytes"].toULongLong();
-    // }
-    // if (data.contains("network_tx_bytes")) {
-    //     network_tx = data["network_tx_bytes"].toULongLong();
-    // }
+        TRACE_LOG_TRACE("Applied SCHEDSTAT data for PID %d - rq_wait_time_ns: %llu -> wtime: %llu",
+                        d->pid, static_cast<unsigned long long>(rq_wait_time_ns), d->wtime);
+    }
+
+    // 内核按进程统计的累计网络流量，有则不再需要socket inode映射
+    d->has_net_counters = data.contains("network_rx_bytes") && data.contains("network_tx_bytes");
+    if (d->has_net_counters) {
+        d->net_rx_bytes = data["network_rx_bytes"].toULongLong();
+        d->net_tx_bytes = data["network_tx_bytes"].toULongLong();
+    }
     
+    applyDKaptureDerived();
+    // 服务端已按批次计算速率，旧版本服务没有速率时在本地计算
+    if (data.contains("cpu_usage") && data.contains("network_rx_bps")) {
+        applyServerRates(data["cpu_usage"].toDouble(), data["read_bps"].toDouble(), data["write_bps"].toDouble(),
+                         data["network_rx_bps"].toDouble(), data["network_tx_bps"].toDouble());
+    } else {
+        calculateProcessMetrics();
+    }
+}
+
+void Process::applyDKaptureRecord(const process_info_record_t &rec)
+{
+    // 与 applyDKaptureData 的转换一致，只是字段直接取自定长记录
+    setName(QString::fromUtf8(rec.comm, int(qstrnlen(rec.comm, sizeof(rec.comm)))));
+    if (rec.sections & kProcessInfoStat) {
+        if (rec.state)
+            setState(rec.state);
+        setPriority(rec.priority);
+        d->utime = rec.utime;
+        d->stime = rec.stime;
+        d->cutime = rec.cutime;
+        d->cstime = rec.cstime;
+        d->rss = rec.rss >> 10; // 字节转KB
+        d->vmsize = rec.vsize >> 10; // 字节转KB
+        d->ppid = rec.ppid;
+        d->nthreads = rec.num_threads;
+        d->nice = rec.nice;
+        d->start_time = rec.start_time;
+    }
+    if (rec.sections & kProcessInfoStatm) {
+        // 页数转KB，与readStatm()一致
+        d->rss = rec.memory_resident << kb_shift;
+        d->vmsize = rec.memory_size << kb_shift;
+        d->shm = rec.memory_shared << kb_shift;
+    }
+    if (rec.sections & kProcessInfoIO) {
+        d->read_bytes = rec.read_bytes;
+        d->write_bytes = rec.write_bytes;
+        d->cancelled_write_bytes = rec.cancelled_write_bytes;
+    }
+    if (rec.sections & kProcessInfoStatus) {
+        d->uid = rec.uid;
+        d->gid = rec.gid;
+        d->euid = rec.euid;
+        d->egid = rec.egid;
+    }
+    if (rec.sections & kProcessInfoSchedStat) {
+        d->wtime = rec.rq_wait_time * HZ / 1000000000;  // 纳秒转时钟滴答数
+    }
+    d->has_net_counters = rec.sections & kProcessInfoTraffic;
+    if (d->has_net_counters) {
+        d->net_rx_bytes = rec.net_rx_bytes;
+        d->net_tx_bytes = rec.net_tx_bytes;
+    }
+
+    applyDKaptureDerived();
+    // 没有内核网络流量时仍需按socket统计网络速率
+    if ((rec.sections & kProcessInfoRates) && d->has_net_counters)
+        applyServerRates(rec.cpu_usage, rec.read_bps, rec.write_bps, rec.net_rx_bps, rec.net_tx_bps);
+    else
+        calculateProcessMetrics();
+}
+
+void Process::saveNames(QDataStream &out) const
+{
+    out << d->pid << d->ppid << d->uid << d->gid << d->euid << d->egid << d->start_time;
+    out << d->name << d->proc_name.name() << d->proc_name.displayName() << d->usrerName << d->cmdline;
+}
+
+void Process::loadNames(QDataStream &in)
+{
+    QString procName, displayName;
+    in >> d->pid >> d->ppid >> d->uid >> d->gid >> d->euid >> d->egid >> d->start_time;
+    in >> d->name >> procName >> displayName >> d->usrerName >> d->cmdline;
+    d->proc_name.setNames(procName, displayName);
+    digestCmdline();
+}
+
+void Process::saveStats(QDataStream &out) const
+{
+    out << qint8(d->state) << qint32(d->apptype) << qint32(d->nice) << quint32(d->nthreads);
+    out << d->utime << d->stime << d->vmsize << d->rss << d->shm << d->group_memory << d->read_bytes << d->write_bytes;
+    out << d->memory_growth << cpu() << readBps() << writeBps() << recvBps() << sentBps();
+}
+
+void Process::loadStats(QDataStream &in)
+{
+    qint8 state {};
+    qint32 apptype {}, nice {};
+    quint32 nthreads {};
+    qreal cpu {}, readBps {}, writeBps {}, recvBps {}, sentBps {};
+    in >> state >> apptype >> nice >> nthreads;
+    in >> d->utime >> d->stime >> d->vmsize >> d->rss >> d->shm >> d->group_memory >> d->read_bytes >> d->write_bytes;
+    in >> d->memory_growth >> cpu >> readBps >> writeBps >> recvBps >> sentBps;
+
+    d->state = char(state);
+    d->apptype = apptype;
+    d->nice = nice;
+    d->nthreads = nthreads;
+    // rates are taken as they were sampled, like the system server ones
+    ProcessSamples &samples = d->mutableSamples();
+    samples.cpuUsageSample.addSample(CPUUsageSampleFrame(cpu));
+    struct IOPS iops = {readBps, writeBps};
+    samples.diskIOSpeedSample.addSample(IOPSSampleFrame(iops));
+    struct IOPS netiops = {recvBps, sentBps};
+    samples.networkBandwidthSample.addSample(IOPSSampleFrame(netiops));
+    d->valid = in.status() == QDataStream::Ok;
+}
+
+void Process::saveRecord(process_info_record_t &rec) const
+{
+    memset(&rec, 0, sizeof(rec));
+    rec.pid = d->pid;
+    rec.tgid = d->pid;
+    rec.ppid = d->ppid;
+    rec.nice = d->nice;
+    rec.num_threads = int32_t(d->nthreads);
+    rec.uid = d->uid;
+    rec.euid = d->euid;
+    rec.gid = d->gid;
+    rec.egid = d->egid;
+    rec.utime = d->utime;
+    rec.stime = d->stime;
+    rec.start_time = d->start_time;
+    rec.rss = memory() << 10;
+    rec.vsize = d->vmsize << 10;
+    rec.read_bytes = d->read_bytes;
+    rec.write_bytes = d->write_bytes;
+    rec.cancelled_write_bytes = d->cancelled_write_bytes;
+    rec.state = d->state;
+    QByteArray comm = d->name.toUtf8().left(PROCESS_INFO_COMM_LEN - 1);
+    memcpy(rec.comm, comm.constData(), size_t(comm.size()));
+    rec.sections = kProcessInfoStat | kProcessInfoIO | kProcessInfoStatus | kProcessInfoRates;
+    rec.cpu_usage = cpu();
+    rec.read_bps = readBps();
+    rec.write_bps = writeBps();
+    rec.net_rx_bps = recvBps();
+    rec.net_tx_bps = sentBps();
+}
+
+void Process::loadRecord(const process_info_record_t &rec)
+{
+    d->pid = rec.pid;
+    d->ppid = rec.ppid;
+    d->nice = rec.nice;
+    d->nthreads = quint32(rec.num_threads);
+    d->uid = rec.uid;
+    d->euid = rec.euid;
+    d->gid = rec.gid;
+    d->egid = rec.egid;
+    d->utime = rec.utime;
+    d->stime = rec.stime;
+    d->start_time = rec.start_time;
+    // memory() of the remote host, without a shared part to subtract
+    d->rss = rec.rss >> 10;
+    d->shm = 0;
+    d->group_memory = 0;
+    d->vmsize = rec.vsize >> 10;
+    d->read_bytes = rec.read_bytes;
+    d->write_bytes = rec.write_bytes;
+    d->cancelled_write_bytes = rec.cancelled_write_bytes;
+    if (rec.state)
+        d->state = rec.state;
+
+    ProcessSamples &samples = d->mutableSamples();
+    samples.cpuUsageSample.addSample(CPUUsageSampleFrame(rec.cpu_usage));
+    struct IOPS iops = {rec.read_bps, rec.write_bps};
+    samples.diskIOSpeedSample.addSample(IOPSSampleFrame(iops));
+    struct IOPS netiops = {rec.net_rx_bps, rec.net_tx_bps};
+    samples.networkBandwidthSample.addSample(IOPSSampleFrame(netiops));
+    d->valid = true;
+}
+
+void Process::applyDKaptureDerived()
+{
     // 标记进程为有效，但需要检查关键数据读取是否成功
     d->valid = true;
     bool ok = true;
 
     // 读取关键信息并检查成功性
     ok = ok && readCmdline();    // cmdline是必需的，失败则进程无效
-    readEnviron();             // environ失败可以容忍
-    readSockInodes();          // sockInodes失败可以容忍
+    if (d->has_net_counters) {
+        d->sockInodes.clear();
+    } else {
+        readSockInodes();          // sockInodes失败可以容忍
+    }
 
     // 只有关键操作都成功才保持进程有效
     d->valid = d->valid && ok;
     
-    d->usrerName = SysInfo::userName(d->uid);
+    d->usrerName = StringPool::instance()->fromUtf8(UserNameCache::instance()->userName(d->uid));
     d->proc_name.refreashProcessName(this);
     d->proc_icon.refreashProcessIcon(this);
     d->uptime = SysInfo::instance()->uptime();
@@ -1129,20 +1755,32 @@ void Process::applyDKaptureData(const QVariantMap &data)
     if (euid == d->uid && (wmwindowList->isGuiApp(d->pid)
                            || wmwindowList->isTrayApp(d->pid)
                            || wmwindowList->isDesktopEntryApp(d->pid))) {
-        qCDebug(app) << "Process" << d->pid << "is a GUI/Tray/Desktop app";
+        TRACE_LOG_TRACE("Process %d is a GUI/Tray/Desktop app", d->pid);
         d->apptype = kFilterApps;
     } else if (euid == d->uid) {
-        qCDebug(app) << "Process" << d->pid << "is a current user app";
+        TRACE_LOG_TRACE("Process %d is a current user app", d->pid);
         d->apptype = kFilterCurrentUser;
     }
 
-    calculateProcessMetrics();
-
     // qCInfo(app) << "Applied DKapture data to process" << pid() 
     //             << "- rss:" << (d->rss / 1024) << "KB"
     //             << "- vmsize:" << (d->vmsize / 1024) << "KB"
     //             << "- cpu_time:" << (d->utime + d->stime);
 }
 
+void Process::applyServerRates(qreal cpu, qreal readBps, qreal writeBps, qreal recvBps, qreal sendBps)
+{
+    ProcessSamples &samples = d->mutableSamples();
+    samples.cpuUsageSample.addSample(CPUUsageSampleFrame(cpu));
+    struct IOPS iops = {readBps, writeBps};
+    samples.diskIOSpeedSample.addSample(IOPSSampleFrame(iops));
+    struct IOPS netiops = {recvBps, sendBps};
+    samples.networkBandwidthSample.addSample(IOPSSampleFrame(netiops));
+
+    auto validrecentPtr = ProcessDB::instance()->processSet()->getRecentProcStage(d->pid, d->start_time).lock();
+    if (validrecentPtr)
+        d->memory_growth = memoryGrowthSince(*validrecentPtr, memory(), d->uptime);
+}
+
 } // namespace process
 } // namespace core
@@ -16,11 +16,23 @@
 
 #include <sys/types.h>
 
+class QDataStream;
+
+struct process_info_record_t;
+
+namespace core {
+namespace system {
+struct task_io_t;
+}
+}
+
 using namespace core::system;
 
 namespace core {
 namespace process {
 
+class ProcFdCache;
+
 enum ProcessPriority {
     kInvalidPriority = INT_MAX,
     kVeryHighPriority = -20, // default veryhigh priority
@@ -40,6 +52,9 @@ static const int kLowPriorityMin = 10;
 static const int kVeryLowPriorityMax = 11;
 static const int kVeryLowPriorityMin = 19;
 
+// bytes of the joined command line kept for display, see Process::cmdlineText
+static const int kCmdlineTextBytes = 256;
+
 QString getPriorityName(int prio);
 ProcessPriority getProcessPriorityStub(int prio);
 
@@ -57,6 +72,14 @@ public:
     ~Process();
 
     bool isValid() const;
+    /**
+     * @brief Whether the last read found the pid gone, the process is invalid then & dropped quietly
+     */
+    bool vanished() const;
+    /**
+     * @brief Deep copy, copies share their data otherwise, so one handed to another thread is detached first
+     */
+    Process detached() const;
 
     pid_t pid() const;
     pid_t ppid() const;
@@ -72,26 +95,200 @@ public:
     QString displayName() const;
 
     QIcon icon() const;
+    QString iconKey() const;
 
     qreal cpu() const;
     void setCpu(qreal cpu);
+    /**
+     * @brief Estimated power in W, the package power of the last interval split by cpu(), -1 unknown
+     */
+    qreal power() const;
+    void setPower(qreal watts);
+    /**
+     * @brief Wakeups per second in the last interval, counted by the kernel while traced,
+     * voluntarySwitchRate() otherwise: each voluntary switch is a sleep some wakeup ended
+     */
+    qreal wakeupRate() const;
+    /**
+     * @brief Wakeups per second by an expiring timer, -1 unless traced
+     */
+    qreal timerWakeupRate() const;
+    bool hasTracedWakeups() const;
+    void setWakeups(qreal rate, qreal timerRate);
+    /**
+     * @brief Time spent runnable but waiting for a cpu in the last interval, in % like cpu()
+     */
+    qreal cpuWait() const;
+    /**
+     * @brief Run queue wait since the process started, in clock ticks
+     */
+    qulonglong wtime() const;
+    /**
+     * @brief Time spent running guest vcpus in the last interval, in % like cpu() & part of it
+     */
+    qreal guestCpu() const;
+    /**
+     * @brief Guest time since the process started, in clock ticks, 0 but for vm processes like qemu
+     */
+    qulonglong guestTime() const;
+    /**
+     * @brief Page faults & context switches per second in the last interval
+     */
+    qreal minorFaultRate() const;
+    qreal majorFaultRate() const;
+    qreal voluntarySwitchRate() const;
+    qreal involuntarySwitchRate() const;
+    /**
+     * @brief Cumulative counters since the process started
+     */
+    qulonglong minorFaults() const;
+    qulonglong majorFaults() const;
+    qulonglong voluntarySwitches() const;
+    qulonglong involuntarySwitches() const;
 
     qulonglong memory() const;
+    /**
+     * @brief Account memory of the app's own cgroup in kB to memory(), instead of the process' resident memory
+     */
+    void setGroupMemory(qulonglong memory);
     qulonglong vtrmemory() const;
     qulonglong sharememory() const;
+    /**
+     * @brief Growth of memory() since the previous scan in kB/s, negative when it shrinks
+     */
+    qreal memoryGrowth() const;
+    /**
+     * @brief memoryGrowth() smoothed over ProcessSet::kMemoryTrendWindow, kB/s
+     */
+    qreal memoryTrend() const;
+    /**
+     * @brief Seconds until MemAvailable or the tightest cgroup memory.max runs out at memoryTrend(),
+     * -1 unless the trend stays above ProcessSet::kMemoryLeakMinRate
+     */
+    qreal timeToMemoryExhaustion() const;
+    /**
+     * @brief Whether memory kept growing for ProcessSet::kMemoryLeakWindow by at least
+     * ProcessSet::kMemoryLeakMinGrowth, a single large allocation isn't enough
+     */
+    bool memoryLeakSuspected() const;
+    /**
+     * @brief Uptime in s since the trend stays above ProcessSet::kMemoryLeakMinRate, 0 if not, & memory() then
+     */
+    qreal memoryLeakSince() const;
+    qulonglong memoryLeakBase() const;
+    /**
+     * @brief Trend state carried on from the previous scan by ProcessSet::updateMemoryTrends
+     */
+    void setMemoryTrend(qreal trend, qreal leakSince, qulonglong leakBase);
+    void setMemoryExhaustion(qreal seconds, bool leak);
+    /**
+     * @brief Whether pss(), uss() & swap() were read from smaps_rollup, see ProcessSmapsCache
+     */
+    bool hasSmaps() const;
+    /**
+     * @brief Proportional set size in kB, shared pages split among the processes mapping them
+     */
+    qulonglong pss() const;
+    /**
+     * @brief Unique set size in kB, memory freed if the process exits
+     */
+    qulonglong uss() const;
+    /**
+     * @brief Swapped out memory in kB
+     */
+    qulonglong swap() const;
+    void setSmaps(qulonglong pss, qulonglong uss, qulonglong swap);
+    /**
+     * @brief Open fds & socket fds found by the fd walk, -1 & 0 if the fd dir is not readable
+     */
+    int fdCount() const;
+    int socketCount() const;
+    /**
+     * @brief Socket inodes found by the last fd walk
+     */
+    QList<ino_t> sockInodes() const;
+    /**
+     * @brief Fds opened per minute since the fd count last dropped
+     */
+    qreal fdGrowth() const;
+    /**
+     * @brief Whether the fd count kept growing without ever dropping for ProcessSet::fdLeakWindow
+     */
+    bool fdLeakSuspected() const;
+    /**
+     * @brief Uptime in s when the fd count last dropped, or was first seen, & the fd count then
+     */
+    qreal fdGrowthSince() const;
+    int fdGrowthBase() const;
+    /**
+     * @brief Fds of drm devices found by the fd walk
+     */
+    QList<int> drmFds() const;
+    /**
+     * @brief Whether gpuUsage() & gpuMemory() were read from drm fdinfo, see ProcessGpuCache
+     */
+    bool hasGpu() const;
+    /**
+     * @brief Busy percent of the busiest gpu engine used by the process
+     */
+    qreal gpuUsage() const;
+    /**
+     * @brief Gpu memory of the drm clients of the process in kB
+     */
+    qulonglong gpuMemory() const;
+    void setGpu(qreal usage, qulonglong memory);
 
     int priority() const;
     void setPriority(int priority);
 
     char state() const;
     void setState(char state);
+    /**
+     * @brief Uptime in s since consecutive scans found the process in uninterruptible sleep (D), 0 if not
+     */
+    qreal blockedSince() const;
+    /**
+     * @brief Whether it stays in D for ProcessSet::hungTaskWindow
+     */
+    bool hangSuspected() const;
+    void setBlocked(qreal since, bool hung);
+    /**
+     * @brief Kernel function a hung process was found blocking in most, empty unless sampled,
+     * & the HungTaskSampler::WaitKind it points at
+     */
+    QByteArray blockingFunction() const;
+    int blockingWait() const;
+    void setBlockingFunction(const QByteArray &function, int wait);
+
+    unsigned int nthreads() const;
 
     QByteArrayList cmdline() const;
     QString cmdlineString() const;
+    /**
+     * @brief Command line for display, its first kCmdlineTextBytes joined & decoded once, interned
+     */
+    QString cmdlineText() const;
+    /**
+     * @brief Whether the command line is just /bin/bash, e.g. the shell of a terminal tab
+     */
+    bool isBareShell() const;
+    /**
+     * @brief Whole command line of \a pid read again, not cut at 4K like cmdline(), empty if it's gone
+     */
+    static QString readFullCmdline(pid_t pid);
+    /**
+     * @brief Percent decoded \a joined, cut at \a maxBytes with an ellipsis but never within a utf8
+     * sequence or an escape
+     */
+    static QString truncatedCmdline(const QByteArray &joined, int maxBytes);
 
     QHash<QString, QString> environ() const;
 
     time_t startTime() const;
+    /**
+     * @brief Start time in clock ticks since boot, 0 until stat is read
+     */
+    qulonglong startTimeTicks() const;
     timeval procuptime() const;
 
     uid_t uid() const;
@@ -106,6 +303,46 @@ public:
     qulonglong readBytes() const;
     qulonglong writeBytes() const;
     qulonglong cancelledWriteBytes() const;
+    /**
+     * @brief Time spent waiting for block io & swapin in the last interval, in % of it
+     */
+    qreal ioWait() const;
+    /**
+     * @brief Read & write syscalls per second in the last interval
+     */
+    qreal ioSyscallRate() const;
+    /**
+     * @brief Cumulative block io & swapin delays in ns, read & write syscalls since the process started
+     */
+    qulonglong blkioDelay() const;
+    qulonglong swapinDelay() const;
+    qulonglong ioSyscalls() const;
+    /**
+     * @brief Take delay accounting of the thread group from taskstats, over the one of stat & io
+     */
+    void setTaskStats(const core::system::task_io_t &io);
+
+    bool hasNetCounters() const;
+    qulonglong netRxBytes() const;
+    qulonglong netTxBytes() const;
+
+    /**
+     * @brief Whether any socket of the process is a connected tcp socket with known health
+     */
+    bool hasTcpHealth() const;
+    /**
+     * @brief Worst smoothed round trip time over the tcp connections of the process, in ms
+     */
+    qreal tcpRtt() const;
+    /**
+     * @brief Retransmitted share of the tcp segments sent in the last interval, in %
+     */
+    qreal tcpRetransRate() const;
+    /**
+     * @brief Retransmitted & sent tcp segments, summed over the open connections
+     */
+    qulonglong tcpRetrans() const;
+    qulonglong tcpSegsOut() const;
 
     qreal recvBps() const;
     qreal sentBps() const;
@@ -116,7 +353,20 @@ public:
 
     void readProcessInfo();
     void readProcessSimpleInfo(bool skipStatReading = false); // 统一方法，可选择跳过stat读取
-    void readProcessVariableInfo();
+    /**
+     * @brief Read frequently changing info, through fdCache if provided
+     */
+    void readProcessVariableInfo(ProcFdCache *fdCache = nullptr);
+    /**
+     * @brief Raw /proc reads part of readProcessVariableInfo, safe to run in worker threads
+     * @param readFds Walk /proc/[pid]/fd, off while no view shows sockets or fds, the last counts are kept
+     * @return true: success; false: failure
+     */
+    bool readProcessVariableStats(ProcFdCache *fdCache = nullptr, bool readFds = true);
+    /**
+     * @brief Name & sample updates part of readProcessVariableInfo, must run on sampling thread
+     */
+    void updateProcessVariableMetrics();
 
     void calculateProcessMetrics();
     
@@ -128,45 +378,84 @@ public:
     
     // DKapture data application method
     void applyDKaptureData(const QVariantMap &pidData);
+    // same as applyDKaptureData, from a fixed layout record of getProcessInfoRecords
+    void applyDKaptureRecord(const process_info_record_t &rec);
+
+    /**
+     * @brief Write ids, names & command line, for flight recordings
+     */
+    void saveNames(QDataStream &out) const;
+    void loadNames(QDataStream &in);
+    /**
+     * @brief Write the figures the process table shows, for flight recordings
+     */
+    void saveStats(QDataStream &out) const;
+    /**
+     * @brief Take figures written by saveStats(), nothing is read from /proc, the process is valid afterwards
+     */
+    void loadStats(QDataStream &in);
+    /**
+     * @brief Fill a record of the process info delta format, for remote agent streams
+     *
+     * Memory is carried as memory() in rss, rates as sampled, names & app type go separately.
+     */
+    void saveRecord(process_info_record_t &rec) const;
+    /**
+     * @brief Take a record written by saveRecord(), nothing is read from /proc, call after loadNames()
+     */
+    void loadRecord(const process_info_record_t &rec);
+
 private:
+    /**
+     * @brief Validity, cmdline, user, name & app type updates after DKapture data is applied
+     */
+    void applyDKaptureDerived();
+    /**
+     * @brief Samples from rates the system server computed, replaces calculateProcessMetrics
+     * @param cpu cpu usage in percent of all cpus
+     */
+    void applyServerRates(qreal cpu, qreal readBps, qreal writeBps, qreal recvBps, qreal sendBps);
     /**
      * @brief Read /proc/[pid]/stat
      * @return true: success; false: failure
      */
-    bool readStat();
+    bool readStat(ProcFdCache *fdCache = nullptr);
     /**
      * @brief Read /proc/[pid]/cmdline
      * @return true: success; false: failure
      */
     bool readCmdline();
     /**
-     * @brief Read /proc/[pid]/environ
+     * @brief Display text & flags of the command line, once it's read or loaded
      */
-    void readEnviron();
+    void digestCmdline();
     /**
      * @brief Read /proc/[pid]/schedstat
      */
-    void readSchedStat();
+    void readSchedStat(ProcFdCache *fdCache = nullptr);
     /**
      * @brief Read /proc/[pid]/status
      * @return true: success; false: failure
      */
-    bool readStatus();
+    bool readStatus(ProcFdCache *fdCache = nullptr);
     /**
      * @brief Read /proc/[pid]/statm
      * @return true: success; false: failure
      */
-    bool readStatm();
+    bool readStatm(ProcFdCache *fdCache = nullptr);
     /**
      * @brief Read /proc/[pid]/io
      * @return true: success; false: failure
      */
-    void readIO();
+    void readIO(ProcFdCache *fdCache = nullptr);
     /**
-     * @brief Read /proc/[pid]/fd
-     * @return true: success; false: failure
+     * @brief Read socket inodes of /proc/[pid]/fd, through fd cache's socket inode index if given
+     */
+    void readSockInodes(ProcFdCache *fdCache = nullptr);
+    /**
+     * @brief Join the sockets found by the fd walk to the tcp health of the last dump
      */
-    void readSockInodes();
+    void readTcpHealth();
 
 private:
 //    QSharedDataPointer<ProcessPrivate> d;
@@ -0,0 +1,263 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_CACHE_H
+#define PROCESS_CACHE_H
+
+#include <QDebug>
+#include <QHash>
+
+#include <iterator>
+#include <list>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Usage figures of a ProcessCache, logged with the process caches for debugging
+ */
+struct ProcessCacheStats {
+    int count {};
+    int maxCount {};
+    qint64 bytes {}; // estimated, as told on insert
+    quint64 hits {};
+    quint64 misses {};
+    quint64 reused {}; // entries dropped since their pid was taken by another process
+    quint64 evictions {};
+};
+
+inline QDebug operator<<(QDebug debug, const ProcessCacheStats &stats)
+{
+    QDebugStateSaver saver(debug);
+    debug.nospace() << stats.count << "/" << stats.maxCount << " entries, " << stats.bytes << " bytes, "
+                    << stats.hits << " hits, " << stats.misses << " misses, " << stats.reused << " reused, "
+                    << stats.evictions << " evicted";
+    return debug;
+}
+
+/**
+ * @brief Bounded LRU of per process data, keyed by pid & validated with process start time
+ *
+ * A pid taken by a new process never sees data of the exited one, lookups with another start time
+ * miss & drop the entry. Start time 0 stands for not read yet, the first known one is adopted then.
+ * Least recently used entries are evicted past maxCount. Not thread safe.
+ */
+template<typename T>
+class ProcessCache
+{
+public:
+    explicit ProcessCache(int maxCount);
+    ProcessCache(const ProcessCache &other);
+    ProcessCache &operator=(const ProcessCache &other);
+
+    /**
+     * @brief Entry of pid whatever process it was inserted for, marked as recently used
+     */
+    T *object(pid_t pid);
+    /**
+     * @brief Entry of the process started at startTime, marked as recently used
+     * @return nullptr on miss, entries of an earlier process with the same pid are dropped
+     */
+    T *object(pid_t pid, qulonglong startTime);
+    /**
+     * @brief Like object() without reordering, for const readers
+     */
+    const T *peek(pid_t pid, qulonglong startTime) const;
+    /**
+     * @brief Insert or replace the entry of pid, evicting least recently used ones past maxCount
+     * @param bytes Estimated memory held by value
+     */
+    T *insert(pid_t pid, qulonglong startTime, const T &value, qint64 bytes = sizeof(T));
+    bool remove(pid_t pid);
+    void clear();
+
+    inline bool contains(pid_t pid) const { return m_index.contains(pid); }
+    inline int count() const { return m_index.size(); }
+    inline int maxCount() const { return m_maxCount; }
+    void setMaxCount(int maxCount);
+    ProcessCacheStats stats() const;
+
+private:
+    struct Node {
+        pid_t pid;
+        qulonglong startTime;
+        qint64 bytes;
+        T value;
+    };
+    using NodeList = std::list<Node>;
+
+    static inline bool sameProcess(qulonglong cached, qulonglong startTime)
+    {
+        return !cached || !startTime || cached == startTime;
+    }
+    void erase(typename NodeList::iterator it);
+    void trim();
+    void reindex();
+
+    NodeList m_nodes; // most recently used first
+    QHash<pid_t, typename NodeList::iterator> m_index;
+    int m_maxCount;
+    qint64 m_bytes {};
+    mutable quint64 m_hits {};
+    mutable quint64 m_misses {};
+    quint64 m_reused {};
+    quint64 m_evictions {};
+};
+
+template<typename T>
+ProcessCache<T>::ProcessCache(int maxCount)
+    : m_maxCount(qMax(maxCount, 1))
+{
+}
+
+template<typename T>
+ProcessCache<T>::ProcessCache(const ProcessCache &other)
+    : m_nodes(other.m_nodes)
+    , m_maxCount(other.m_maxCount)
+    , m_bytes(other.m_bytes)
+{
+    reindex();
+}
+
+template<typename T>
+ProcessCache<T> &ProcessCache<T>::operator=(const ProcessCache &other)
+{
+    if (this != &other) {
+        m_nodes = other.m_nodes;
+        m_maxCount = other.m_maxCount;
+        m_bytes = other.m_bytes;
+        reindex();
+    }
+    return *this;
+}
+
+template<typename T>
+T *ProcessCache<T>::object(pid_t pid)
+{
+    auto it = m_index.find(pid);
+    if (it == m_index.end()) {
+        ++m_misses;
+        return nullptr;
+    }
+
+    ++m_hits;
+    m_nodes.splice(m_nodes.begin(), m_nodes, it.value());
+    return &it.value()->value;
+}
+
+template<typename T>
+T *ProcessCache<T>::object(pid_t pid, qulonglong startTime)
+{
+    auto it = m_index.find(pid);
+    if (it == m_index.end()) {
+        ++m_misses;
+        return nullptr;
+    }
+
+    auto node = it.value();
+    if (!sameProcess(node->startTime, startTime)) {
+        ++m_misses;
+        ++m_reused;
+        erase(node);
+        return nullptr;
+    }
+
+    ++m_hits;
+    if (!node->startTime)
+        node->startTime = startTime;
+    m_nodes.splice(m_nodes.begin(), m_nodes, node);
+    return &node->value;
+}
+
+template<typename T>
+const T *ProcessCache<T>::peek(pid_t pid, qulonglong startTime) const
+{
+    auto it = m_index.find(pid);
+    if (it == m_index.end() || !sameProcess(it.value()->startTime, startTime)) {
+        ++m_misses;
+        return nullptr;
+    }
+
+    ++m_hits;
+    return &it.value()->value;
+}
+
+template<typename T>
+T *ProcessCache<T>::insert(pid_t pid, qulonglong startTime, const T &value, qint64 bytes)
+{
+    auto it = m_index.find(pid);
+    if (it != m_index.end())
+        erase(it.value());
+
+    m_nodes.push_front(Node {pid, startTime, bytes, value});
+    m_index.insert(pid, m_nodes.begin());
+    m_bytes += bytes;
+    trim();
+    return &m_nodes.front().value;
+}
+
+template<typename T>
+bool ProcessCache<T>::remove(pid_t pid)
+{
+    auto it = m_index.find(pid);
+    if (it == m_index.end())
+        return false;
+
+    erase(it.value());
+    return true;
+}
+
+template<typename T>
+void ProcessCache<T>::clear()
+{
+    m_nodes.clear();
+    m_index.clear();
+    m_bytes = 0;
+}
+
+template<typename T>
+void ProcessCache<T>::setMaxCount(int maxCount)
+{
+    m_maxCount = qMax(maxCount, 1);
+    trim();
+}
+
+template<typename T>
+ProcessCacheStats ProcessCache<T>::stats() const
+{
+    return {count(), m_maxCount, m_bytes, m_hits, m_misses, m_reused, m_evictions};
+}
+
+template<typename T>
+void ProcessCache<T>::erase(typename NodeList::iterator it)
+{
+    m_bytes -= it->bytes;
+    m_index.remove(it->pid);
+    m_nodes.erase(it);
+}
+
+template<typename T>
+void ProcessCache<T>::trim()
+{
+    while (m_index.size() > m_maxCount) {
+        erase(std::prev(m_nodes.end()));
+        ++m_evictions;
+    }
+}
+
+template<typename T>
+void ProcessCache<T>::reindex()
+{
+    m_index.clear();
+    m_index.reserve(int(m_nodes.size()));
+    for (auto it = m_nodes.begin(); it != m_nodes.end(); ++it)
+        m_index.insert(it->pid, it);
+}
+
+} // namespace process
+} // namespace core
+
+#endif // PROCESS_CACHE_H
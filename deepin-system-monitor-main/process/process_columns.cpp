@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "process_columns.h"
+#include "process.h"
+#include "process_set.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace core {
+namespace process {
+
+ProcessColumns::ProcessColumns(const QMap<pid_t, Process> &set)
+{
+    const int n = set.size();
+    m_pid.reserve(n);
+    m_ppid.reserve(n);
+    m_uid.reserve(n);
+    m_appType.reserve(n);
+    m_state.reserve(n);
+    m_nthreads.reserve(n);
+    m_name.reserve(n);
+    m_userName.reserve(n);
+    for (auto &column : m_rates)
+        column.reserve(n);
+    for (auto &column : m_counters)
+        column.reserve(n);
+
+    // map iterates in pid order, slotOf relies on it
+    for (auto it = set.cbegin(); it != set.cend(); ++it) {
+        const Process &proc = it.value();
+        if (!proc.isValid())
+            continue;
+
+        m_pid << proc.pid();
+        m_ppid << proc.ppid();
+        m_uid << proc.uid();
+        m_appType << proc.appType();
+        m_state << proc.state();
+        m_nthreads << proc.nthreads();
+        m_name << intern(proc.name());
+        m_userName << intern(proc.userName());
+
+        m_rates[kCpuRate] << proc.cpu();
+        m_rates[kReadRate] << proc.readBps();
+        m_rates[kWriteRate] << proc.writeBps();
+        m_rates[kRecvRate] << proc.recvBps();
+        m_rates[kSentRate] << proc.sentBps();
+
+        m_counters[kUtime] << proc.utime();
+        m_counters[kStime] << proc.stime();
+        m_counters[kMemory] << proc.memory();
+        m_counters[kShareMemory] << proc.sharememory();
+        m_counters[kVirtualMemory] << proc.vtrmemory();
+        m_counters[kReadBytes] << proc.readBytes();
+        m_counters[kWriteBytes] << proc.writeBytes();
+
+        for (int filterType = 0; filterType < kMemberSetCount; ++filterType) {
+            if (isShownIn(filterType, proc.appType()))
+                m_members[filterType] << proc.pid();
+        }
+    }
+    // lookups are done building, only the strings are kept
+    m_stringIndex.clear();
+    m_stringIndex.squeeze();
+}
+
+int ProcessColumns::intern(const QString &str)
+{
+    auto it = m_stringIndex.constFind(str);
+    if (it != m_stringIndex.cend())
+        return it.value();
+
+    int index = m_strings.size();
+    m_strings << str;
+    m_stringIndex.insert(str, index);
+    return index;
+}
+
+int ProcessColumns::slotOf(pid_t pid) const
+{
+    auto it = std::lower_bound(m_pid.cbegin(), m_pid.cend(), pid);
+    if (it == m_pid.cend() || *it != pid)
+        return -1;
+    return int(it - m_pid.cbegin());
+}
+
+qreal ProcessColumns::sum(RateColumn column) const
+{
+    const QVector<qreal> &values = m_rates[column];
+    return std::accumulate(values.cbegin(), values.cend(), qreal(0));
+}
+
+qulonglong ProcessColumns::sum(CounterColumn column) const
+{
+    const QVector<qulonglong> &values = m_counters[column];
+    return std::accumulate(values.cbegin(), values.cend(), qulonglong(0));
+}
+
+int ProcessColumns::countOf(int appType) const
+{
+    // sizes of the nested tabs
+    switch (appType) {
+    case kFilterApps:
+        return int(m_members[kFilterApps].size());
+    case kFilterCurrentUser:
+        return int(m_members[kFilterCurrentUser].size() - m_members[kFilterApps].size());
+    case kNoFilter:
+        return size() - int(m_members[kFilterCurrentUser].size());
+    default:
+        return int(std::count(m_appType.cbegin(), m_appType.cend(), appType));
+    }
+}
+
+bool ProcessColumns::isMember(int filterType, pid_t pid) const
+{
+    const QVector<pid_t> &pids = members(filterType);
+    return std::binary_search(pids.cbegin(), pids.cend(), pid);
+}
+
+QVector<int> ProcessColumns::topK(RateColumn column, int k) const
+{
+    QVector<int> slots(size());
+    std::iota(slots.begin(), slots.end(), 0);
+    k = qBound(0, k, slots.size());
+
+    const QVector<qreal> &values = m_rates[column];
+    std::partial_sort(slots.begin(), slots.begin() + k, slots.end(), [&values](int a, int b) {
+        return values[a] > values[b] || (values[a] == values[b] && a < b);
+    });
+    slots.resize(k);
+    return slots;
+}
+
+QVector<int> ProcessColumns::filter(const std::function<bool(const ProcessColumns &, int)> &pred) const
+{
+    QVector<int> slots;
+    for (int slot = 0; slot < size(); ++slot) {
+        if (pred(*this, slot))
+            slots << slot;
+    }
+    return slots;
+}
+
+QVector<int> ProcessColumns::sorted(RateColumn column, Qt::SortOrder order) const
+{
+    QVector<int> slots(size());
+    std::iota(slots.begin(), slots.end(), 0);
+
+    const QVector<qreal> &values = m_rates[column];
+    if (order == Qt::AscendingOrder)
+        std::stable_sort(slots.begin(), slots.end(), [&values](int a, int b) { return values[a] < values[b]; });
+    else
+        std::stable_sort(slots.begin(), slots.end(), [&values](int a, int b) { return values[a] > values[b]; });
+    return slots;
+}
+
+} // namespace process
+} // namespace core
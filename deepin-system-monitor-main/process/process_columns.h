@@ -0,0 +1,183 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_COLUMNS_H
+#define PROCESS_COLUMNS_H
+
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+#include <memory>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+class Process;
+
+/**
+ * @brief Columnar snapshot of the hot numeric fields of one process scan
+ *
+ * Fields are kept in flat arrays indexed by slot, slots in pid order, so that sorting,
+ * filtering, sums & top-K walk a few contiguous arrays instead of every Process & its
+ * private data. Names & user names are interned in a side table, a slot holds their index.
+ * Built once per scan by ProcessSet & never changed after, shared read only between threads.
+ */
+class ProcessColumns
+{
+public:
+    /**
+     * @brief Rates, in the units of the Process getters they're taken from
+     */
+    enum RateColumn {
+        kCpuRate, // percent
+        kReadRate, // disk read B/s
+        kWriteRate, // disk written B/s
+        kRecvRate, // received B/s
+        kSentRate, // sent B/s
+        kRateColumnCount
+    };
+
+    /**
+     * @brief Cumulative counters & sizes
+     */
+    enum CounterColumn {
+        kUtime, // clock ticks
+        kStime,
+        kMemory, // resident memory in kB
+        kShareMemory, // kB
+        kVirtualMemory, // kB
+        kReadBytes, // disk read bytes
+        kWriteBytes, // disk written bytes
+        kCounterColumnCount
+    };
+
+    explicit ProcessColumns() = default;
+
+    /**
+     * @brief Snapshot of \a set, invalid processes are left out
+     */
+    explicit ProcessColumns(const QMap<pid_t, Process> &set);
+
+    inline int size() const
+    {
+        return m_pid.size();
+    }
+
+    /**
+     * @brief Slot of pid, -1 if it's not in the snapshot
+     */
+    int slotOf(pid_t pid) const;
+
+    inline pid_t pid(int slot) const
+    {
+        return m_pid[slot];
+    }
+    inline pid_t ppid(int slot) const
+    {
+        return m_ppid[slot];
+    }
+    inline uid_t uid(int slot) const
+    {
+        return m_uid[slot];
+    }
+    inline int appType(int slot) const
+    {
+        return m_appType[slot];
+    }
+    inline char state(int slot) const
+    {
+        return m_state[slot];
+    }
+    inline uint nthreads(int slot) const
+    {
+        return m_nthreads[slot];
+    }
+    inline const QString &name(int slot) const
+    {
+        return m_strings[m_name[slot]];
+    }
+    inline const QString &userName(int slot) const
+    {
+        return m_strings[m_userName[slot]];
+    }
+    inline qreal rate(RateColumn column, int slot) const
+    {
+        return m_rates[column][slot];
+    }
+    inline qulonglong counter(CounterColumn column, int slot) const
+    {
+        return m_counters[column][slot];
+    }
+
+    /**
+     * @brief Distinct names & user names of the snapshot
+     */
+    inline int internedCount() const
+    {
+        return m_strings.size();
+    }
+
+    qreal sum(RateColumn column) const;
+    qulonglong sum(CounterColumn column) const;
+    /**
+     * @brief Number of processes of a FilterType
+     */
+    int countOf(int appType) const;
+    /**
+     * @brief Pids listed in the tab of a FilterType, ascending, see isShownIn()
+     *
+     * Partitioned once per scan, the tabs nest: applications within my processes within all.
+     */
+    inline const QVector<pid_t> &members(int filterType) const
+    {
+        return filterType >= 0 && filterType < kMemberSetCount ? m_members[filterType] : m_pid;
+    }
+    bool isMember(int filterType, pid_t pid) const;
+    /**
+     * @brief Slots of the \a k highest values of \a column, highest first
+     */
+    QVector<int> topK(RateColumn column, int k) const;
+    /**
+     * @brief Slots matching \a pred, in pid order
+     */
+    QVector<int> filter(const std::function<bool(const ProcessColumns &, int)> &pred) const;
+    /**
+     * @brief Slots of all processes sorted by \a column, ties in pid order
+     */
+    QVector<int> sorted(RateColumn column, Qt::SortOrder order) const;
+
+private:
+    // tabs of kFilterApps & kFilterCurrentUser, the one of kNoFilter lists every pid
+    static constexpr int kMemberSetCount = 2;
+
+    int intern(const QString &str);
+
+    QVector<pid_t> m_pid;
+    QVector<pid_t> m_ppid;
+    QVector<uid_t> m_uid;
+    QVector<int> m_appType;
+    QVector<char> m_state;
+    QVector<uint> m_nthreads;
+    QVector<int> m_name; // indexes of m_strings
+    QVector<int> m_userName;
+    QVector<qreal> m_rates[kRateColumnCount];
+    QVector<qulonglong> m_counters[kCounterColumnCount];
+    QVector<pid_t> m_members[kMemberSetCount];
+
+    // interned strings, few distinct user names & many processes share a name
+    QVector<QString> m_strings;
+    QHash<QString, int> m_stringIndex;
+};
+
+using ProcessColumnsPtr = std::shared_ptr<const ProcessColumns>;
+
+} // namespace process
+} // namespace core
+
+#endif // PROCESS_COLUMNS_H
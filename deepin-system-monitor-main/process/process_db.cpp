@@ -7,6 +7,11 @@
 #include "ddlog.h"
 
 #include "wm/wm_window_list.h"
+#include "system/netif_monitor.h"
+#include "system/device_db.h"
+#include "system/device_snapshot.h"
+#include "system/netif.h"
+#include "system/demand_tracker.h"
 #include "desktop_entry_cache.h"
 #include "process_icon.h"
 #include "process_icon_cache.h"
@@ -14,13 +19,23 @@
 #include "process_name_cache.h"
 #include "process_controller.h"
 #include "priority_controller.h"
+#include "system_service_client.h"
+#include "process_info_record.h"
 
 #include <QReadLocker>
 #include <QWriteLocker>
 #include <QApplication>
 #include <QDebug>
+#include <QDir>
 
+#include <DConfig>
+
+#include <memory>
+
+#include <sched.h>
 #include <sys/resource.h>
+#include <sys/syscall.h>
+#include <net/if.h>
 
 using namespace core::wm;
 using namespace DDLog;
@@ -40,7 +55,19 @@ ProcessDB::ProcessDB(QObject *parent)
     m_desktopEntryTimeCount = DesktopEntryTimeCount;
 
     m_euid = geteuid();
+
+    std::unique_ptr<DTK_CORE_NAMESPACE::DConfig> config(DTK_CORE_NAMESPACE::DConfig::create("deepin-system-monitor", "org.deepin.system-monitor"));
+    if (config && config->isValid())
+        m_netSelfCheck = config->value("network_accounting_self_check", false).toBool();
+    if (m_netSelfCheck) {
+        // compares process traffic with interface rates whatever is on screen
+        core::system::DemandTracker *tracker = core::system::DemandTracker::instance();
+        tracker->declare(this, core::system::DemandTracker::kProcessNetDemand | core::system::DemandTracker::kNetifDemand);
+        tracker->setVisible(this, true);
+    }
+
     connect(this, &ProcessDB::signalProcessPrioritysetChanged, this, &ProcessDB::onProcessPrioritysetChanged);
+    connect(this, &ProcessDB::signalProcessesControlRequested, this, &ProcessDB::onProcessesControlRequested);
 }
 
 ProcessDB::~ProcessDB()
@@ -131,10 +158,55 @@ void ProcessDB::update()
         qCDebug(app) << "Updating desktop entry cache";
         m_desktopEntryTimeCount = 0;
         m_desktopEntryCache->updateCache();
+        m_procSet->logCacheStats();
+    } else {
+        // desktop files changed in between are picked up through inotify
+        m_desktopEntryCache->updateChanged();
     }
 
     m_windowList->updateWindowListCache();
+    const bool netDemanded = core::system::DemandTracker::instance()->isDemanded(core::system::DemandTracker::kProcessNetDemand);
+    // tcp health is joined to processes by the socket inodes the scan finds
+    if (netDemanded)
+        core::system::NetifMonitor::instance()->refreshTcpHealth();
+    else
+        core::system::NetifMonitor::instance()->clearTcpHealth();
     m_procSet->refresh();
+
+    // per process traffic accounted in kernel, no need to capture packets, nor while no view shows it
+    core::system::NetifMonitor::instance()->setPacketCaptureEnabled(!m_procSet->hasKernelNetCounters() && netDemanded);
+    // capture is overloaded, views mark network figures as estimates
+    m_procSet->setNetTrafficSampled(core::system::NetifMonitor::instance()->packetSampling());
+
+    if (m_netSelfCheck)
+        checkNetworkAccounting();
+
+    // emitted on the monitor thread, direct receivers read the process set before the next scan
+    Q_EMIT processListUpdated();
+}
+
+void ProcessDB::checkNetworkAccounting()
+{
+    const ProcessColumnsPtr columns = m_procSet->columns();
+    qreal procRecv = columns->sum(ProcessColumns::kRecvRate);
+    qreal procSent = columns->sum(ProcessColumns::kSentRate);
+
+    // interface rates of last published snapshot, loopback traffic is never attributed to processes
+    qreal ifRecv = 0, ifSent = 0;
+    auto snapshot = core::system::DeviceDB::instance()->snapshot();
+    if (snapshot) {
+        for (const auto &netif : snapshot->netifInfo) {
+            if (!netif || (netif->flags() & IFF_LOOPBACK))
+                continue;
+            ifRecv += netif->recv_bps();
+            ifSent += netif->sent_bps();
+        }
+    }
+
+    // coverage below 1 is traffic not matched to any socket, above 1 is over counting
+    qCInfo(app) << "Network accounting self check: processes recv" << procRecv << "sent" << procSent
+                << "B/s, interfaces recv" << ifRecv << "sent" << ifSent << "B/s, coverage recv"
+                << (ifRecv > 0 ? procRecv / ifRecv : 0.) << "sent" << (ifSent > 0 ? procSent / ifSent : 0.);
 }
 
 void ProcessDB::setProcessPriority(pid_t pid, int priority)
@@ -181,30 +253,8 @@ void ProcessDB::onProcessPrioritysetChanged(pid_t pid, int priority)
         if (rc == -1 && errno != 0) {
             qCDebug(app) << "setpriority failed with errno" << errno;
             if (errno == EACCES || errno == EPERM) {
-                qCInfo(app) << "Permission denied, attempting to change priority using pkexec. PID:" << pid;
-                // call pkexec to change priority
-                auto *ctrl = new PriorityController(pid, priority, this);
-                connect(ctrl, &PriorityController::resultReady, this, [ = ](int code) {
-                    if (code == 0) {
-                        qCInfo(app) << "Successfully changed process priority using pkexec. PID:" << pid;
-                        Q_EMIT processPriorityChanged(pid, priority);
-                    } else {
-                        qCWarning(app) << "Failed to change process priority using pkexec. PID:" << pid << "Error:" << strerror(code);
-                        ErrorContext ec1 {};
-                        ec1.setCode(ErrorContext::kErrorTypeSystem);
-                        ec1.setSubCode(code);
-                        ec1.setErrorName(QApplication::translate("Process.Priority",
-                                                                 "Failed to change process priority"));
-                        ec1.setErrorMessage(
-                            QApplication::translate("Process.Priority", "PID: %1, Error: [%2] %3")
-                            .arg(pid)
-                            .arg(code)
-                            .arg(strerror(code)));
-                        Q_EMIT priorityPromoteResultReady(ec);
-                    }
-                });
-                connect(ctrl, &PriorityController::finished, ctrl, &QObject::deleteLater);
-                ctrl->execute();
+                qCInfo(app) << "Permission denied, changing priority through the system service. PID:" << pid;
+                Q_EMIT signalProcessesControlRequested({pid}, PROCESS_CONTROL_RENICE, priority, true, {});
                 return;
             } else {
                 qCWarning(app) << "Failed to change process priority. PID:" << pid << "Error:" << strerror(errno);
@@ -277,22 +327,8 @@ void ProcessDB::sendSignalToProcess(pid_t pid, int signal)
         }
     };
     auto pctl = [ = ](pid_t pid, int signal) {
-        // call pkexec to promote
-        auto *ctrl = new ProcessController(pid, signal, this);
-        connect(ctrl, &ProcessController::resultReady, this,
-        [this, errfmt, emitSignal, pid, signal, fmsg](int code) {
-            if (code != 0) {
-                qCWarning(app) << "Failed to send signal using pkexec. PID:" << pid << "Signal:" << signal << "Error:" << strerror(code);
-                ErrorContext ec1 = {};
-                ec1 = errfmt(code, fmsg(signal), pid, signal, ec1);
-                Q_EMIT processControlResultReady(ec1);
-            } else {
-                qCDebug(app) << "Successfully sent signal using pkexec. PID:" << pid << "Signal:" << signal;
-                emitSignal(signal);
-            }
-        });
-        connect(ctrl, &ProcessController::finished, ctrl, &QObject::deleteLater);
-        ctrl->execute();
+        // promoted through the system service, pkexec if it's unavailable
+        Q_EMIT signalProcessesControlRequested({pid}, PROCESS_CONTROL_SIGNAL, signal, true, {});
     };
     auto pkill = [this, pctl, errfmt, emitSignal, fmsg](pid_t pid, int signal) {
         int rc = 0;
@@ -348,5 +384,293 @@ void ProcessDB::sendSignalToProcess(pid_t pid, int signal)
     }
 }
 
+void ProcessDB::controlProcesses(const QList<pid_t> &pids, int action, int value)
+{
+    qCDebug(app) << "controlProcesses called for" << pids.size() << "pids, action" << action << "value" << value;
+    emit signalProcessesControlRequested(pids, action, value, false, {});
+}
+
+void ProcessDB::setProcessesAffinity(const QList<pid_t> &pids, const QByteArray &cpus)
+{
+    const int count = processAffinityCpus(cpus.constData(), size_t(cpus.size()));
+    qCDebug(app) << "setProcessesAffinity called for" << pids.size() << "pids," << count << "cpus";
+    emit signalProcessesControlRequested(pids, PROCESS_CONTROL_AFFINITY, count, false, cpus);
+}
+
+void ProcessDB::onProcessesControlRequested(const QList<pid_t> &pids, int action, int value, bool notifyEach, const QByteArray &cpus)
+{
+    if (action == PROCESS_CONTROL_RENICE)
+        value = qBound(kVeryHighPriorityMax, value, kVeryLowPriorityMin);
+
+    const quint64 batchId = ++m_lastControlBatch;
+    ControlBatch &batch = m_controlBatches[batchId];
+    batch.pids = pids;
+    batch.action = action;
+    batch.value = value;
+    batch.notifyEach = notifyEach;
+    batch.cpus = cpus;
+    batch.errors.reserve(pids.size());
+    const bool valid = processControlValid(action, value);
+    for (pid_t pid : pids) {
+        int err = valid ? controlProcess(pid, action, value, cpus) : EINVAL;
+        if (err == EPERM || err == EACCES)
+            batch.privileged << pid;
+        batch.errors << err;
+    }
+    qCInfo(app) << "Process control action" << action << "value" << value << "on" << pids.size()
+                << "processes," << batch.privileged.size() << "need privileges";
+
+    if (batch.privileged.isEmpty()) {
+        finishControlBatch(batchId);
+        return;
+    }
+    Q_EMIT processesControlProgress(pids, action, value, pids.size() - batch.privileged.size());
+    controlPrivileged(batchId);
+}
+
+int ProcessDB::controlProcess(pid_t pid, int action, int value, const QByteArray &cpus)
+{
+    errno = 0;
+    switch (action) {
+    case PROCESS_CONTROL_SIGNAL:
+        // send SIGCONT first, otherwise signal will hang
+        if ((value == SIGTERM || value == SIGKILL) && kill(pid, SIGCONT) == -1)
+            return errno;
+        return kill(pid, value) == -1 ? errno : 0;
+    case PROCESS_CONTROL_RENICE: {
+        // we dont support adjust realtime sched process's priority
+        sched_param param {};
+        if (sched_getparam(pid, &param) == -1)
+            return errno;
+        if (param.sched_priority != 0)
+            return EINVAL;
+        return setpriority(PRIO_PROCESS, id_t(pid), value) == -1 ? errno : 0;
+    }
+    case PROCESS_CONTROL_IONICE:
+        // IOPRIO_WHO_PROCESS
+        return syscall(SYS_ioprio_set, 1, pid, value) == -1 ? errno : 0;
+    case PROCESS_CONTROL_AFFINITY:
+        return cpus.isEmpty() ? EINVAL : setAffinity(pid, cpus);
+    default:
+        return EINVAL;
+    }
+}
+
+int ProcessDB::setAffinity(pid_t pid, const QByteArray &cpus)
+{
+    const QStringList tids = QDir(QString("/proc/%1/task").arg(pid)).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    if (tids.isEmpty())
+        return ESRCH;
+
+    // threads exiting meanwhile are skipped, the first other error is reported
+    int err = 0;
+    const auto *set = reinterpret_cast<const cpu_set_t *>(cpus.constData());
+    for (const QString &tid : tids) {
+        if (sched_setaffinity(tid.toInt(), size_t(cpus.size()), set) == -1 && errno != ESRCH && !err)
+            err = errno;
+    }
+    return err;
+}
+
+void ProcessDB::controlPrivileged(quint64 batchId)
+{
+    ControlBatch &batch = m_controlBatches[batchId];
+    batch.pending = batch.privileged.size();
+    SystemServiceClient *client = controlClient();
+
+    // one authorized call per chunk, instead of one pkexec dialog & fork per process
+    const QList<pid_t> privileged = batch.privileged;
+    const int action = batch.action;
+    const int value = batch.value;
+    const QByteArray cpus = batch.cpus;
+    for (int i = 0; i < privileged.size(); i += PROCESS_CONTROL_MAX_PIDS) {
+        const QList<pid_t> chunk = privileged.mid(i, PROCESS_CONTROL_MAX_PIDS);
+        const bool sent = action == PROCESS_CONTROL_AFFINITY ? client->setProcessesAffinity(chunk, cpus)
+                                                             : client->controlProcesses(chunk, action, value);
+        if (!sent)
+            controlWithPkexec(batchId, chunk);
+    }
+}
+
+SystemServiceClient *ProcessDB::controlClient()
+{
+    if (!m_controlClient) {
+        m_controlClient = new SystemServiceClient(this);
+        connect(m_controlClient, &SystemServiceClient::processesControlled, this, &ProcessDB::onProcessesControlledByService);
+        connect(m_controlClient, &SystemServiceClient::processLimited, this, &ProcessDB::onProcessLimited);
+    }
+    return m_controlClient;
+}
+
+void ProcessDB::limitProcess(pid_t pid, const resource_limits_t &limits)
+{
+    qCDebug(app) << "limitProcess called for pid" << pid << "cpu" << limits.cpu_quota << "memory" << limits.memory_high
+                 << "io" << limits.io_weight;
+    // systemd moves the process, so there's nothing to do without privileges
+    if (!controlClient()->limitProcess(pid, limits))
+        onProcessLimited(pid, QApplication::translate("Process.Limits", "The system monitor service is unavailable"));
+}
+
+void ProcessDB::onProcessLimited(pid_t pid, const QString &error)
+{
+    if (error.isEmpty()) {
+        qCInfo(app) << "Limits of process" << pid << "set";
+        return;
+    }
+    ErrorContext ec {};
+    ec.setCode(ErrorContext::kErrorTypeSystem);
+    ec.setErrorName(QApplication::translate("Process.Limits", "Failed to limit process resources"));
+    ec.setErrorMessage(QString("PID: %1, Error: %2").arg(pid).arg(error));
+    Q_EMIT processControlResultReady(ec);
+}
+
+void ProcessDB::onProcessesControlledByService(const QList<pid_t> &pids, int action, int value, const QList<int> &errors)
+{
+    if (pids.isEmpty())
+        return;
+
+    // replies carry the pids asked for, find the batch they belong to
+    for (auto it = m_controlBatches.begin(); it != m_controlBatches.end(); ++it) {
+        const ControlBatch &batch = it.value();
+        const int index = batch.privileged.indexOf(pids.first());
+        if (batch.action != action || batch.value != value || index < 0 || batch.privileged.mid(index, pids.size()) != pids)
+            continue;
+
+        const quint64 batchId = it.key();
+        if (errors.isEmpty()) {
+            qCInfo(app) << "System service can't control processes, using pkexec";
+            controlWithPkexec(batchId, pids);
+            return;
+        }
+        for (int i = 0; i < pids.size(); ++i)
+            setControlResult(batchId, pids[i], errors[i]);
+        updateControlBatch(batchId);
+        return;
+    }
+}
+
+void ProcessDB::controlWithPkexec(quint64 batchId, QList<pid_t> pids)
+{
+    auto it = m_controlBatches.constFind(batchId);
+    if (it == m_controlBatches.cend())
+        return;
+    const int action = it->action;
+    const int value = it->value;
+
+    for (pid_t pid : pids) {
+        if (action == PROCESS_CONTROL_SIGNAL) {
+            auto *ctrl = new ProcessController(pid, value, this);
+            connect(ctrl, &ProcessController::resultReady, this, [this, batchId, pid](int code) {
+                setControlResult(batchId, pid, code);
+                updateControlBatch(batchId);
+            });
+            connect(ctrl, &ProcessController::finished, ctrl, &QObject::deleteLater);
+            ctrl->execute();
+        } else if (action == PROCESS_CONTROL_RENICE) {
+            auto *ctrl = new PriorityController(pid, value, this);
+            connect(ctrl, &PriorityController::resultReady, this, [this, batchId, pid](int code) {
+                setControlResult(batchId, pid, code);
+                updateControlBatch(batchId);
+            });
+            connect(ctrl, &PriorityController::finished, ctrl, &QObject::deleteLater);
+            ctrl->execute();
+        } else {
+            // there's no ionice or taskset helper allowed through pkexec
+            setControlResult(batchId, pid, EPERM);
+            updateControlBatch(batchId);
+        }
+    }
+}
+
+void ProcessDB::setControlResult(quint64 batchId, pid_t pid, int error)
+{
+    auto it = m_controlBatches.find(batchId);
+    if (it == m_controlBatches.end())
+        return;
+    const int index = it->pids.indexOf(pid);
+    if (index >= 0)
+        it->errors[index] = error;
+    --it->pending;
+}
+
+void ProcessDB::updateControlBatch(quint64 batchId)
+{
+    auto it = m_controlBatches.constFind(batchId);
+    if (it == m_controlBatches.cend())
+        return;
+    if (it->pending <= 0)
+        finishControlBatch(batchId);
+    else
+        Q_EMIT processesControlProgress(it->pids, it->action, it->value, it->pids.size() - it->pending);
+}
+
+void ProcessDB::finishControlBatch(quint64 batchId)
+{
+    const ControlBatch batch = m_controlBatches.take(batchId);
+    int failed = 0;
+    int firstFailed = -1;
+    for (int i = 0; i < batch.pids.size(); ++i) {
+        const pid_t pid = batch.pids[i];
+        if (batch.errors[i] != 0) {
+            qCDebug(app) << "Failed to control process. PID:" << pid << "Error:" << strerror(batch.errors[i]);
+            if (firstFailed < 0)
+                firstFailed = i;
+            ++failed;
+            continue;
+        }
+        if (!batch.notifyEach)
+            continue;
+        if (batch.action == PROCESS_CONTROL_RENICE)
+            Q_EMIT processPriorityChanged(pid, batch.value);
+        else if (batch.action == PROCESS_CONTROL_SIGNAL && batch.value == SIGTERM)
+            Q_EMIT processEnded(pid);
+        else if (batch.action == PROCESS_CONTROL_SIGNAL && batch.value == SIGSTOP)
+            Q_EMIT processPaused(pid, 'T');
+        else if (batch.action == PROCESS_CONTROL_SIGNAL && batch.value == SIGCONT)
+            Q_EMIT processResumed(pid, 'R');
+        else if (batch.action == PROCESS_CONTROL_SIGNAL && batch.value == SIGKILL)
+            Q_EMIT processKilled(pid);
+    }
+    qCInfo(app) << "Process control action" << batch.action << "value" << batch.value << "done,"
+                << batch.pids.size() - failed << "of" << batch.pids.size() << "succeeded";
+
+    if (batch.notifyEach && firstFailed >= 0) {
+        const pid_t pid = batch.pids[firstFailed];
+        const int err = batch.errors[firstFailed];
+        ErrorContext ec {};
+        ec.setCode(ErrorContext::kErrorTypeSystem);
+        ec.setSubCode(err);
+        ec.setErrorName(controlErrorName(batch.action, batch.value));
+        if (batch.action == PROCESS_CONTROL_SIGNAL)
+            ec.setErrorMessage(QString("PID: %1, Signal: [%2], Error: [%3] %4").arg(pid).arg(batch.value).arg(err).arg(strerror(err)));
+        else
+            ec.setErrorMessage(QString("PID: %1, Error: [%2] %3").arg(pid).arg(err).arg(strerror(err)));
+        if (batch.action == PROCESS_CONTROL_RENICE)
+            Q_EMIT priorityPromoteResultReady(ec);
+        else
+            Q_EMIT processControlResultReady(ec);
+    }
+    Q_EMIT processesControlled(batch.pids, batch.action, batch.value, batch.errors);
+}
+
+QString ProcessDB::controlErrorName(int action, int value)
+{
+    if (action == PROCESS_CONTROL_RENICE)
+        return QApplication::translate("Process.Priority", "Failed to change process priority");
+    if (action == PROCESS_CONTROL_IONICE)
+        return QApplication::translate("Process.Priority", "Failed to change process io priority");
+    if (action == PROCESS_CONTROL_AFFINITY)
+        return QApplication::translate("Process.Priority", "Failed to change process cpu affinity");
+    if (value == SIGTERM)
+        return QApplication::translate("Process.Signal", "Failed to end process");
+    if (value == SIGSTOP)
+        return QApplication::translate("Process.Signal", "Failed to pause process");
+    if (value == SIGCONT)
+        return QApplication::translate("Process.Signal", "Failed to resume process");
+    if (value == SIGKILL)
+        return QApplication::translate("Process.Signal", "Failed to kill process");
+    return QApplication::translate("Process.Signal", "Unknown error");
+}
+
 } // namespace process
 } // namespace core
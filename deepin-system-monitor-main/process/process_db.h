@@ -12,6 +12,7 @@
 #include "system/system_monitor.h"
 #include "process_set.h"
 
+#include <QHash>
 #include <QReadWriteLock>
 #include <QObject>
 
@@ -20,6 +21,8 @@
 #include <unistd.h>
 #include <signal.h>
 
+struct resource_limits_t;
+
 namespace core {
 namespace wm {
 class WMWindowList;
@@ -33,6 +36,7 @@ namespace process {
 
 class DesktopEntryCache;
 class ProcessSet;
+class SystemServiceClient;
 
 class ProcessDB : public QObject
 {
@@ -58,6 +62,28 @@ public slots:
     void resumeProcess(pid_t pid);
     void killProcess(pid_t pid);
     void setProcessPriority(pid_t pid, int priority);
+    /**
+     * @brief Send a signal to, renice or ionice a list of processes
+     *
+     * Processes the user owns are controlled directly, the rest with one authorized call of the
+     * system service, or pkexec one by one if the service can't be used.
+     * @param action process_control_action_t, see process_info_record.h for values
+     */
+    void controlProcesses(const QList<pid_t> &pids, int action, int value);
+    /**
+     * @brief Set every thread of a list of processes to run on the cpus of a cpu_set_t mask
+     *
+     * A controlProcesses batch of PROCESS_CONTROL_AFFINITY, its value is the number of cpus.
+     * There's no pkexec fallback, processes of other users need the system service.
+     */
+    void setProcessesAffinity(const QList<pid_t> &pids, const QByteArray &cpus);
+    /**
+     * @brief Limit cpu, memory & io of a process, which is moved into a transient systemd scope of its own
+     *
+     * Needs the system service, whoever owns the process. Failures are told by processControlResultReady.
+     * @param limits see process_info_record.h, RESOURCE_LIMIT_NONE lifts a limit set before
+     */
+    void limitProcess(pid_t pid, const resource_limits_t &limits);
 
 Q_SIGNALS:
     void processListUpdated();
@@ -70,16 +96,45 @@ Q_SIGNALS:
     void processControlResultReady(const ErrorContext &ec);
     void filterTypeChanged(FilterType filter);
 
+    /**
+     * @brief All processes of a controlProcesses batch done, errno of each pid in errors, 0 if it succeeded
+     */
+    void processesControlled(const QList<pid_t> &pids, int action, int value, const QList<int> &errors);
+    /**
+     * @brief Processes of a controlProcesses batch answered so far, sent while privileged ones are pending
+     */
+    void processesControlProgress(const QList<pid_t> &pids, int action, int value, int done);
+
     void signalProcessPrioritysetChanged(pid_t pid, int priority);
+    void signalProcessesControlRequested(const QList<pid_t> &pids, int action, int value, bool notifyEach, const QByteArray &cpus);
 
 public:
     void update();
 
 private:
     void sendSignalToProcess(pid_t pid, int signal);
+    // log per process traffic sums against interface counters
+    void checkNetworkAccounting();
+    // control a process without privileges, errno on failure
+    static int controlProcess(pid_t pid, int action, int value, const QByteArray &cpus);
+    // set all threads of a process, sched_setaffinity sets a single thread
+    static int setAffinity(pid_t pid, const QByteArray &cpus);
+    // ask the privileged pids of a batch through the system service, pkexec if it's unavailable
+    void controlPrivileged(quint64 batchId);
+    SystemServiceClient *controlClient();
+    // pids copied, the batch may finish while they're asked
+    void controlWithPkexec(quint64 batchId, QList<pid_t> pids);
+    void setControlResult(quint64 batchId, pid_t pid, int error);
+    // report progress of a batch after results were set, finish it once all are answered
+    void updateControlBatch(quint64 batchId);
+    void finishControlBatch(quint64 batchId);
+    static QString controlErrorName(int action, int value);
 
 private slots:
     void onProcessPrioritysetChanged(pid_t pid, int priority);
+    void onProcessesControlRequested(const QList<pid_t> &pids, int action, int value, bool notifyEach, const QByteArray &cpus);
+    void onProcessesControlledByService(const QList<pid_t> &pids, int action, int value, const QList<int> &errors);
+    void onProcessLimited(pid_t pid, const QString &error);
 
 private:
     WMWindowList *m_windowList;
@@ -89,6 +144,23 @@ private:
     int m_desktopEntryTimeCount;
 
     uid_t m_euid;
+    // network_accounting_self_check dconfig
+    bool m_netSelfCheck {false};
+
+    struct ControlBatch {
+        QList<pid_t> pids;
+        int action {0};
+        int value {0};
+        QList<int> errors; // by index of pids
+        QList<pid_t> privileged; // denied without privileges, asked for in one go
+        int pending {0}; // privileged pids not answered yet
+        bool notifyEach {false}; // single process requests, per process signals & error dialog
+        QByteArray cpus; // cpu_set_t mask of PROCESS_CONTROL_AFFINITY
+    };
+    QHash<quint64, ControlBatch> m_controlBatches;
+    quint64 m_lastControlBatch {0};
+    // created when privileges are first needed
+    SystemServiceClient *m_controlClient {};
 };
 
 } // namespace process
@@ -0,0 +1,249 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "process_diff.h"
+
+#include <QStringList>
+
+#include <algorithm>
+#include <numeric>
+
+namespace core {
+namespace process {
+
+// counters of a process only grow, a lower later value is read as no change
+static qlonglong grown(qulonglong after, qulonglong before)
+{
+    return after > before ? qlonglong(after - before) : 0;
+}
+
+// order of slot i of a & slot j of b by pid & start time
+static int compareKeys(const DiffSnapshot &a, int i, const DiffSnapshot &b, int j)
+{
+    if (a.pid(i) != b.pid(j))
+        return a.pid(i) < b.pid(j) ? -1 : 1;
+    if (a.startTicks(i) != b.startTicks(j))
+        return a.startTicks(i) < b.startTicks(j) ? -1 : 1;
+    return 0;
+}
+
+template<typename T>
+static void permute(QVector<T> &column, const QVector<int> &order)
+{
+    QVector<T> sorted;
+    sorted.reserve(column.size());
+    for (int slot : order)
+        sorted << column[slot];
+    column.swap(sorted);
+}
+
+DiffSnapshot::DiffSnapshot(qint64 time)
+    : m_time(time)
+{
+    intern(QString());
+}
+
+void DiffSnapshot::reserve(int size)
+{
+    m_pid.reserve(size);
+    m_startTicks.reserve(size);
+    m_name.reserve(size);
+    m_unit.reserve(size);
+    m_cpu.reserve(size);
+    m_cpuTicks.reserve(size);
+    m_memory.reserve(size);
+    m_readBytes.reserve(size);
+    m_writeBytes.reserve(size);
+    m_sockets.reserve(size);
+}
+
+void DiffSnapshot::append(const diff_row_t &row)
+{
+    m_pid << row.pid;
+    m_startTicks << row.startTicks;
+    m_name << intern(row.name);
+    m_unit << intern(row.unit);
+    m_cpu << row.cpu;
+    m_cpuTicks << row.cpuTicks;
+    m_memory << row.memory;
+    m_readBytes << row.readBytes;
+    m_writeBytes << row.writeBytes;
+    m_sockets << row.sockets;
+}
+
+void DiffSnapshot::finish()
+{
+    m_stringIndex.clear();
+    m_stringIndex.squeeze();
+
+    auto less = [this](int a, int b) {
+        return m_pid[a] != m_pid[b] ? m_pid[a] < m_pid[b] : m_startTicks[a] < m_startTicks[b];
+    };
+    QVector<int> order(m_pid.size());
+    std::iota(order.begin(), order.end(), 0);
+    // scans list processes in pid order already
+    if (std::is_sorted(order.cbegin(), order.cend(), less))
+        return;
+    std::sort(order.begin(), order.end(), less);
+
+    permute(m_pid, order);
+    permute(m_startTicks, order);
+    permute(m_name, order);
+    permute(m_unit, order);
+    permute(m_cpu, order);
+    permute(m_cpuTicks, order);
+    permute(m_memory, order);
+    permute(m_readBytes, order);
+    permute(m_writeBytes, order);
+    permute(m_sockets, order);
+}
+
+int DiffSnapshot::intern(const QString &str)
+{
+    auto it = m_stringIndex.constFind(str);
+    if (it != m_stringIndex.cend())
+        return it.value();
+
+    int index = m_strings.size();
+    m_strings << str;
+    m_stringIndex.insert(str, index);
+    return index;
+}
+
+QString DiffSnapshot::unitOfCgroup(const QString &cgroup)
+{
+    // /user.slice/user-1000.slice/user@1000.service/app.slice/dbus.service
+    const QStringList parts = cgroup.split('/');
+    for (auto it = parts.crbegin(); it != parts.crend(); ++it) {
+        if (it->endsWith(".service"))
+            return *it;
+    }
+    return {};
+}
+
+SnapshotDiff SnapshotDiff::compute(const DiffSnapshotPtr &before, const DiffSnapshotPtr &after)
+{
+    SnapshotDiff diff;
+    diff.m_before = before;
+    diff.m_after = after;
+    if (!before || !after)
+        return diff;
+
+    const DiffSnapshot &a = *before;
+    const DiffSnapshot &b = *after;
+    diff.m_processes.reserve(qMax(a.size(), b.size()));
+
+    // service of each interned unit, resolved on first use: -2 not yet, -1 none
+    QHash<QString, int> serviceIndex;
+    QVector<int> servicesOfA(a.internedCount(), -2);
+    QVector<int> servicesOfB(b.internedCount(), -2);
+    auto serviceOf = [&diff, &serviceIndex](const DiffSnapshot &snapshot, QVector<int> &services, int slot) {
+        if (slot < 0)
+            return -1;
+        int &service = services[snapshot.unitIndex(slot)];
+        if (service == -2) {
+            const QString &unit = snapshot.unit(slot);
+            if (unit.isEmpty()) {
+                service = -1;
+            } else {
+                auto it = serviceIndex.constFind(unit);
+                if (it == serviceIndex.cend()) {
+                    it = serviceIndex.insert(unit, diff.m_services.size());
+                    diff.m_services << service_delta_t {};
+                    diff.m_services.last().unit = unit;
+                }
+                service = it.value();
+            }
+        }
+        return service;
+    };
+
+    int i = 0, j = 0;
+    while (i < a.size() || j < b.size()) {
+        // a pid reused in between is an exited & a started process
+        const int order = j >= b.size() ? -1 : i >= a.size() ? 1 : compareKeys(a, i, b, j);
+        process_delta_t delta;
+        if (order < 0) {
+            delta.change = process_delta_t::kExited;
+            delta.before = i++;
+        } else if (order > 0) {
+            delta.change = process_delta_t::kStarted;
+            delta.after = j++;
+        } else {
+            delta.before = i++;
+            delta.after = j++;
+        }
+
+        if (delta.change == process_delta_t::kKept) {
+            delta.cpuBefore = a.cpu(delta.before);
+            delta.cpuAfter = b.cpu(delta.after);
+            delta.cpuTicks = grown(b.cpuTicks(delta.after), a.cpuTicks(delta.before));
+            delta.memory = qlonglong(b.memory(delta.after)) - qlonglong(a.memory(delta.before));
+            delta.readBytes = grown(b.readBytes(delta.after), a.readBytes(delta.before));
+            delta.writeBytes = grown(b.writeBytes(delta.after), a.writeBytes(delta.before));
+            if (a.sockets(delta.before) >= 0 && b.sockets(delta.after) >= 0)
+                delta.sockets = b.sockets(delta.after) - a.sockets(delta.before);
+        } else if (delta.change == process_delta_t::kStarted) {
+            delta.cpuAfter = b.cpu(delta.after);
+            delta.cpuTicks = qlonglong(b.cpuTicks(delta.after));
+            delta.memory = qlonglong(b.memory(delta.after));
+            delta.readBytes = qlonglong(b.readBytes(delta.after));
+            delta.writeBytes = qlonglong(b.writeBytes(delta.after));
+            delta.sockets = qMax(b.sockets(delta.after), 0);
+            ++diff.m_started;
+        } else {
+            delta.cpuBefore = a.cpu(delta.before);
+            delta.memory = -qlonglong(a.memory(delta.before));
+            delta.sockets = -qMax(a.sockets(delta.before), 0);
+            ++diff.m_exited;
+        }
+
+        // deltas count for the later unit, an exited process' for its last one
+        const int serviceBefore = serviceOf(a, servicesOfA, delta.before);
+        const int serviceAfter = serviceOf(b, servicesOfB, delta.after);
+        if (serviceBefore >= 0) {
+            ++diff.m_services[serviceBefore].processesBefore;
+            diff.m_services[serviceBefore].cpuBefore += delta.cpuBefore;
+        }
+        if (serviceAfter >= 0) {
+            ++diff.m_services[serviceAfter].processesAfter;
+            diff.m_services[serviceAfter].cpuAfter += delta.cpuAfter;
+        }
+        const int service = delta.after >= 0 ? serviceAfter : serviceBefore;
+        if (service >= 0) {
+            service_delta_t &sum = diff.m_services[service];
+            sum.started += delta.change == process_delta_t::kStarted;
+            sum.exited += delta.change == process_delta_t::kExited;
+            sum.cpuTicks += delta.cpuTicks;
+            sum.memory += delta.memory;
+            sum.readBytes += delta.readBytes;
+            sum.writeBytes += delta.writeBytes;
+            sum.sockets += delta.sockets;
+        }
+        diff.m_processes << delta;
+    }
+
+    std::sort(diff.m_services.begin(), diff.m_services.end(), [](const service_delta_t &x, const service_delta_t &y) {
+        return x.unit < y.unit;
+    });
+    return diff;
+}
+
+pid_t SnapshotDiff::pid(const process_delta_t &delta) const
+{
+    return delta.after >= 0 ? m_after->pid(delta.after) : m_before->pid(delta.before);
+}
+
+const QString &SnapshotDiff::name(const process_delta_t &delta) const
+{
+    return delta.after >= 0 ? m_after->name(delta.after) : m_before->name(delta.before);
+}
+
+const QString &SnapshotDiff::unit(const process_delta_t &delta) const
+{
+    return delta.after >= 0 ? m_after->unit(delta.after) : m_before->unit(delta.before);
+}
+
+} // namespace process
+} // namespace core
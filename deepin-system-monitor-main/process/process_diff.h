@@ -0,0 +1,192 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_DIFF_H
+#define PROCESS_DIFF_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include <memory>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Process of a diff snapshot, as it's added
+ */
+struct diff_row_t {
+    pid_t pid {0};
+    qulonglong startTicks {0}; // start time, tells a reused pid apart
+    QString name;
+    QString unit; // systemd service of the process' cgroup, empty if it's in none
+    qreal cpu {0}; // percent
+    qulonglong cpuTicks {0}; // utime + stime
+    qulonglong memory {0}; // kB
+    qulonglong readBytes {0};
+    qulonglong writeBytes {0};
+    int sockets {-1}; // socket fds of the last fd walk, -1 if unknown
+};
+
+/**
+ * @brief Process table of one point in time, columnar & sorted by pid & start time
+ *
+ * Fields are kept in flat arrays indexed by slot like ProcessColumns, names & units are
+ * interned. Rows may be added in any order, finish() sorts them once. Read only after that,
+ * shared between threads.
+ */
+class DiffSnapshot
+{
+public:
+    explicit DiffSnapshot(qint64 time = 0);
+
+    void reserve(int size);
+    void append(const diff_row_t &row);
+    /**
+     * @brief Sort the rows by pid & start time, a no-op for rows added in that order
+     */
+    void finish();
+
+    /**
+     * @brief Time the snapshot was taken, ms since epoch
+     */
+    inline qint64 time() const { return m_time; }
+    inline int size() const { return m_pid.size(); }
+
+    inline pid_t pid(int slot) const { return m_pid[slot]; }
+    inline qulonglong startTicks(int slot) const { return m_startTicks[slot]; }
+    inline const QString &name(int slot) const { return m_strings[m_name[slot]]; }
+    inline const QString &unit(int slot) const { return m_strings[m_unit[slot]]; }
+    /**
+     * @brief Index of the unit in the interned strings, the same for all processes of a unit
+     */
+    inline int unitIndex(int slot) const { return m_unit[slot]; }
+    inline const QString &interned(int index) const { return m_strings[index]; }
+    inline int internedCount() const { return m_strings.size(); }
+    inline qreal cpu(int slot) const { return m_cpu[slot]; }
+    inline qulonglong cpuTicks(int slot) const { return m_cpuTicks[slot]; }
+    inline qulonglong memory(int slot) const { return m_memory[slot]; }
+    inline qulonglong readBytes(int slot) const { return m_readBytes[slot]; }
+    inline qulonglong writeBytes(int slot) const { return m_writeBytes[slot]; }
+    inline int sockets(int slot) const { return m_sockets[slot]; }
+
+    /**
+     * @brief Systemd service a cgroup belongs to, e.g. cron.service of /system.slice/cron.service
+     * @return The innermost .service of the path, empty for scopes & slices only
+     */
+    static QString unitOfCgroup(const QString &cgroup);
+
+private:
+    int intern(const QString &str);
+
+    qint64 m_time;
+    QVector<pid_t> m_pid;
+    QVector<qulonglong> m_startTicks;
+    QVector<int> m_name; // indexes of m_strings
+    QVector<int> m_unit;
+    QVector<qreal> m_cpu;
+    QVector<qulonglong> m_cpuTicks;
+    QVector<qulonglong> m_memory;
+    QVector<qulonglong> m_readBytes;
+    QVector<qulonglong> m_writeBytes;
+    QVector<int> m_sockets;
+
+    QVector<QString> m_strings; // the empty string first, no unit
+    QHash<QString, int> m_stringIndex;
+};
+
+using DiffSnapshotPtr = std::shared_ptr<const DiffSnapshot>;
+
+/**
+ * @brief Change of a process between two snapshots
+ */
+struct process_delta_t {
+    enum Change {
+        kKept = 0, // in both
+        kStarted, // only in the later one
+        kExited // only in the earlier one
+    };
+
+    Change change {kKept};
+    int before {-1}; // slot in the earlier snapshot, -1 if started
+    int after {-1}; // slot in the later snapshot, -1 if exited
+    qreal cpuBefore {0}; // percent
+    qreal cpuAfter {0};
+    qlonglong cpuTicks {0}; // used in between, all of a started process
+    qlonglong memory {0}; // kB
+    qlonglong readBytes {0}; // read in between, 0 for an exited process
+    qlonglong writeBytes {0};
+    int sockets {0}; // 0 if unknown in either snapshot
+};
+
+/**
+ * @brief Change of the processes of a systemd service between two snapshots
+ */
+struct service_delta_t {
+    QString unit;
+    int processesBefore {0};
+    int processesAfter {0};
+    int started {0};
+    int exited {0};
+    qreal cpuBefore {0}; // percent, summed over its processes
+    qreal cpuAfter {0};
+    qlonglong cpuTicks {0};
+    qlonglong memory {0}; // kB
+    qlonglong readBytes {0};
+    qlonglong writeBytes {0};
+    int sockets {0};
+};
+
+/**
+ * @brief Per process & per service deltas between two snapshots
+ *
+ * Processes are matched by pid & start time in one sorted merge over the columnar arrays,
+ * so the cost is linear in the processes of both & nothing is hashed per process. Services
+ * are summed up on the same pass, by interned unit index.
+ */
+class SnapshotDiff
+{
+public:
+    SnapshotDiff() = default;
+
+    /**
+     * @brief Compare \a before with the later snapshot \a after, both finished
+     */
+    static SnapshotDiff compute(const DiffSnapshotPtr &before, const DiffSnapshotPtr &after);
+
+    inline bool isValid() const { return m_before && m_after; }
+    inline const DiffSnapshotPtr &before() const { return m_before; }
+    inline const DiffSnapshotPtr &after() const { return m_after; }
+
+    /**
+     * @brief Every process of either snapshot, in pid order
+     */
+    inline const QVector<process_delta_t> &processes() const { return m_processes; }
+    /**
+     * @brief Services of either snapshot, in unit name order
+     */
+    inline const QVector<service_delta_t> &services() const { return m_services; }
+    inline int startedCount() const { return m_started; }
+    inline int exitedCount() const { return m_exited; }
+
+    pid_t pid(const process_delta_t &delta) const;
+    const QString &name(const process_delta_t &delta) const;
+    const QString &unit(const process_delta_t &delta) const;
+
+private:
+    DiffSnapshotPtr m_before;
+    DiffSnapshotPtr m_after;
+    QVector<process_delta_t> m_processes;
+    QVector<service_delta_t> m_services;
+    int m_started {0};
+    int m_exited {0};
+};
+
+} // namespace process
+} // namespace core
+
+#endif // PROCESS_DIFF_H
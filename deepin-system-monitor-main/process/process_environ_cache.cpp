@@ -0,0 +1,150 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "process_environ_cache.h"
+#include "common/common.h"
+#include "ddlog.h"
+
+#include <QByteArray>
+#include <QMutexLocker>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PROC_ENVIRON_PATH "/proc/%u/environ"
+
+using namespace common::error;
+using namespace DDLog;
+
+namespace core {
+namespace process {
+
+ProcessEnvironCache *ProcessEnvironCache::instance()
+{
+    static ProcessEnvironCache cache;
+    return &cache;
+}
+
+ProcessEnvironCache::ProcessEnvironCache()
+    : m_cache(kMaxCacheSize)
+{
+}
+
+ProcessEnvironCache::Environ ProcessEnvironCache::environ(pid_t pid, qulonglong startTime)
+{
+    Environ env;
+    if (lookup(pid, startTime, env))
+        return env;
+
+    // read without holding the lock, slow /proc reads must not block gui thread
+    env = readEnviron(pid);
+    insert(pid, startTime, env);
+    return env;
+}
+
+bool ProcessEnvironCache::lookup(pid_t pid, qulonglong startTime, Environ &env) const
+{
+    QMutexLocker locker(&m_mutex);
+    const Environ *cached = m_cache.object(pid, startTime);
+    if (!cached)
+        return false;
+
+    env = *cached;
+    return true;
+}
+
+void ProcessEnvironCache::insert(pid_t pid, qulonglong startTime, const Environ &env)
+{
+    // implicitly shared strings, account for their payload
+    qint64 bytes = sizeof(Environ);
+    for (auto it = env.cbegin(); it != env.cend(); ++it)
+        bytes += (it.key().size() + it.value().size()) * qint64(sizeof(QChar));
+
+    QMutexLocker locker(&m_mutex);
+    m_cache.insert(pid, startTime, env, bytes);
+}
+
+void ProcessEnvironCache::remove(pid_t pid)
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.remove(pid);
+}
+
+void ProcessEnvironCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+}
+
+int ProcessEnvironCache::count() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.count();
+}
+
+ProcessCacheStats ProcessEnvironCache::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.stats();
+}
+
+ProcessEnvironCache::Environ ProcessEnvironCache::readEnviron(pid_t pid)
+{
+    qCDebug(app) << "Reading environ for pid" << pid;
+    Environ env;
+    char path[128] {};
+    char buf[1024];
+    QByteArray sbuf {};
+    ssize_t nb;
+    int fd;
+
+    sprintf(path, PROC_ENVIRON_PATH, pid);
+
+    errno = 0;
+    // open /proc/[pid]/environ
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        // environ of other users' processes is not readable
+        if (errno == EACCES || errno == ENOENT)
+            return env;
+        qCWarning(app) << "Failed to open environment file for process" << pid << "Error:" << strerror(errno);
+        print_errno(errno, QString("open %1 failed").arg(path));
+        return env;
+    }
+
+    while ((nb = read(fd, buf, sizeof(buf))) > 0)
+        sbuf.append(buf, int(nb));
+    int err = errno;
+    close(fd);
+
+    if (nb < 0) {
+        qCWarning(app) << "Failed to read environment file for process" << pid << "Error:" << strerror(err);
+        print_errno(err, QString("read %1 failed").arg(path));
+        return env;
+    }
+
+    // name=value pairs separated by null character, value may contain '='
+    const char *cur = sbuf.constData();
+    const char *end = cur + sbuf.size();
+    while (cur < end) {
+        const char *next = static_cast<const char *>(memchr(cur, '\0', size_t(end - cur)));
+        if (!next)
+            next = end;
+
+        const char *eq = static_cast<const char *>(memchr(cur, '=', size_t(next - cur)));
+        if (eq && eq > cur)
+            env.insert(QString::fromUtf8(cur, int(eq - cur)), QString::fromUtf8(eq + 1, int(next - eq - 1)));
+
+        cur = next + 1;
+    }
+
+    qCDebug(app) << "Finished reading environ for pid" << pid;
+    return env;
+}
+
+} // namespace process
+} // namespace core
@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_ENVIRON_CACHE_H
+#define PROCESS_ENVIRON_CACHE_H
+
+#include "process_cache.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Bounded LRU of parsed /proc/[pid]/environ
+ *
+ * Environment is only needed by naming & icon heuristics and the attribute dialog,
+ * so it's loaded on first request and kept for a limited number of processes.
+ * Entries are keyed by pid and validated with process start time to survive pid reuse, see ProcessCache.
+ * Accessed from both the sampling thread and the gui thread.
+ */
+class ProcessEnvironCache
+{
+public:
+    using Environ = QHash<QString, QString>;
+
+    static ProcessEnvironCache *instance();
+
+    /**
+     * @brief Load environ of process from cache, read & insert it on cache miss
+     * @param pid Process id
+     * @param startTime Process start time, in clock ticks since boot
+     * @return Environment variables, empty if it's not readable
+     */
+    Environ environ(pid_t pid, qulonglong startTime);
+
+    bool lookup(pid_t pid, qulonglong startTime, Environ &env) const;
+    void insert(pid_t pid, qulonglong startTime, const Environ &env);
+    void remove(pid_t pid);
+    void clear();
+    int count() const;
+    ProcessCacheStats stats() const;
+
+    /**
+     * @brief Read & parse /proc/[pid]/environ without touching the cache
+     */
+    static Environ readEnviron(pid_t pid);
+
+    // max number of processes with environ cached
+    static constexpr int kMaxCacheSize = 128;
+
+private:
+    ProcessEnvironCache();
+    Q_DISABLE_COPY(ProcessEnvironCache)
+
+    mutable QMutex m_mutex;
+    // lookups reorder entries, so it's mutated by const readers too
+    mutable ProcessCache<Environ> m_cache;
+};
+
+} // namespace process
+} // namespace core
+
+#endif // PROCESS_ENVIRON_CACHE_H
@@ -0,0 +1,269 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "process_gpu_cache.h"
+#include "process.h"
+#include "common/proc_parser.h"
+#include "ddlog.h"
+
+#include <QMutexLocker>
+#include <QSet>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PROC_FDINFO_PATH "/proc/%d/fdinfo/%d"
+
+using namespace common::parser;
+using namespace DDLog;
+
+namespace core {
+namespace process {
+
+// same bound as the other per process caches of ProcessSet
+static constexpr int kMaxCachedProcesses = 1 << 16;
+
+ProcessGpuCache *ProcessGpuCache::instance()
+{
+    static ProcessGpuCache cache;
+    return &cache;
+}
+
+ProcessGpuCache::ProcessGpuCache()
+    : m_cache(kMaxCachedProcesses)
+    , m_enabled(false)
+{
+    m_clock.start();
+}
+
+void ProcessGpuCache::setEnabled(bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_enabled != enabled)
+        qCInfo(app) << "drm fdinfo sampling" << (enabled ? "enabled" : "disabled");
+    m_enabled = enabled;
+}
+
+bool ProcessGpuCache::isEnabled() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_enabled;
+}
+
+int ProcessGpuCache::refresh(const QMap<pid_t, Process> &set)
+{
+    return refresh(set, m_clock.elapsed());
+}
+
+int ProcessGpuCache::refresh(const QMap<pid_t, Process> &set, qint64 now)
+{
+    if (!isEnabled())
+        return 0;
+
+    int nread = 0;
+    for (auto it = set.cbegin(); it != set.cend(); ++it) {
+        if (it->drmFds().isEmpty()) {
+            // closed its last drm fd, or never had one
+            QMutexLocker locker(&m_mutex);
+            if (m_cache.peek(it.key(), it->startTimeTicks()))
+                m_cache.remove(it.key());
+            continue;
+        }
+        read(it.value(), now);
+        ++nread;
+    }
+
+    qCDebug(app) << "Read drm fdinfo of" << nread << "processes";
+    return nread;
+}
+
+void ProcessGpuCache::read(const Process &proc, qint64 now)
+{
+    // read without holding the lock, slow /proc reads must not block gui thread
+    QList<drm_client_t> clients;
+    if (!readClients(proc.pid(), proc.drmFds(), clients)) {
+        remove(proc.pid());
+        return;
+    }
+
+    entry_t entry {};
+    entry.refreshed = now;
+    QMap<QByteArray, qulonglong> capacity;
+    for (const drm_client_t &client : clients) {
+        for (auto it = client.engines.cbegin(); it != client.engines.cend(); ++it)
+            entry.busy[it.key()] += it.value();
+        for (auto it = client.capacity.cbegin(); it != client.capacity.cend(); ++it)
+            capacity[it.key()] = it.value();
+        entry.usage.memory += client.memory;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    const entry_t *last = m_cache.peek(proc.pid(), proc.startTimeTicks());
+    if (last && now > last->refreshed) {
+        const qreal elapsed = qreal(now - last->refreshed) * 1000 * 1000;
+        for (auto it = entry.busy.cbegin(); it != entry.busy.cend(); ++it) {
+            qulonglong previous = last->busy.value(it.key());
+            // counters restart with a new client
+            if (it.value() < previous)
+                continue;
+            qreal usage = qreal(it.value() - previous) * 100 / (elapsed * qMax(qulonglong(1), capacity.value(it.key(), 1)));
+            entry.usage.usage = qMax(entry.usage.usage, qMin(usage, qreal(100)));
+        }
+    }
+    m_cache.insert(proc.pid(), proc.startTimeTicks(), entry);
+}
+
+bool ProcessGpuCache::lookup(pid_t pid, qulonglong startTime, gpu_usage_t &usage) const
+{
+    QMutexLocker locker(&m_mutex);
+    const entry_t *entry = m_cache.object(pid, startTime);
+    if (!entry)
+        return false;
+
+    usage = entry->usage;
+    return true;
+}
+
+void ProcessGpuCache::remove(pid_t pid)
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.remove(pid);
+}
+
+void ProcessGpuCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+}
+
+int ProcessGpuCache::count() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.count();
+}
+
+ProcessCacheStats ProcessGpuCache::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.stats();
+}
+
+bool ProcessGpuCache::parseFdInfo(const char *buf, size_t len, drm_client_t &client)
+{
+    /*样例数据:
+        pos:    0
+        flags:  02100002
+        drm-driver:     amdgpu
+        drm-client-id:  15
+        drm-pdev:       0000:03:00.0
+        drm-memory-vram:        114064 KiB
+        drm-memory-gtt:         4848 KiB
+        drm-engine-gfx: 1704185088 ns
+        drm-engine-compute:     0 ns
+        drm-engine-capacity-gfx:        2
+    i915 & xe tell drm-total-* & drm-resident-* instead of drm-memory-*
+    */
+    client = {};
+    QByteArray pdev;
+    QByteArray clientId;
+    QMap<QByteArray, qulonglong> engines;
+    QMap<QByteArray, qulonglong> capacity;
+    QMap<QByteArray, qulonglong> resident;
+    QMap<QByteArray, qulonglong> memory;
+
+    Tokenizer tok(buf, len);
+    const char *key;
+    size_t keyLen;
+    do {
+        if (!tok.readKey(key, keyLen) || keyLen < 4 || memcmp(key, "drm-", 4))
+            continue;
+
+        const char *value;
+        size_t valueLen;
+        unsigned long long number = 0;
+        if (keyEquals(key, keyLen, "drm-pdev", 8)) {
+            if (tok.readToken(value, valueLen))
+                pdev = QByteArray(value, int(valueLen));
+        } else if (keyEquals(key, keyLen, "drm-client-id", 13)) {
+            if (tok.readToken(value, valueLen))
+                clientId = QByteArray(value, int(valueLen));
+        } else if (keyLen > 20 && !memcmp(key, "drm-engine-capacity-", 20)) {
+            if (tok.readU64(number))
+                capacity[QByteArray(key + 20, int(keyLen - 20))] = number;
+        } else if (keyLen > 11 && !memcmp(key, "drm-engine-", 11)) {
+            if (tok.readU64(number))
+                engines[QByteArray(key + 11, int(keyLen - 11))] = number;
+        } else if ((keyLen > 13 && !memcmp(key, "drm-resident-", 13)) || (keyLen > 11 && !memcmp(key, "drm-memory-", 11))) {
+            if (!tok.readU64(number))
+                continue;
+            // bytes without a unit
+            if (tok.readToken(value, valueLen)) {
+                if (keyEquals(value, valueLen, "KiB", 3))
+                    number *= 1024;
+                else if (keyEquals(value, valueLen, "MiB", 3))
+                    number *= 1024 * 1024;
+                else if (keyEquals(value, valueLen, "GiB", 3))
+                    number *= 1024ull * 1024 * 1024;
+            }
+            if (key[4] == 'r')
+                resident[QByteArray(key + 13, int(keyLen - 13))] = number;
+            else
+                memory[QByteArray(key + 11, int(keyLen - 11))] = number;
+        }
+    } while (tok.nextLine());
+
+    if (clientId.isEmpty())
+        return false;
+
+    client.id = pdev + '/' + clientId;
+    for (auto it = engines.cbegin(); it != engines.cend(); ++it) {
+        client.engines[pdev + '/' + it.key()] = it.value();
+        client.capacity[pdev + '/' + it.key()] = capacity.value(it.key(), 1);
+    }
+    // drm-memory-* is the older name of drm-resident-*
+    for (auto it = memory.cbegin(); it != memory.cend(); ++it) {
+        if (!resident.contains(it.key()))
+            resident.insert(it.key(), it.value());
+    }
+    qulonglong bytes = 0;
+    for (auto it = resident.cbegin(); it != resident.cend(); ++it)
+        bytes += it.value();
+    client.memory = bytes / 1024;
+    return true;
+}
+
+bool ProcessGpuCache::readClients(pid_t pid, const QList<int> &fds, QList<drm_client_t> &clients)
+{
+    clients.clear();
+    QSet<QByteArray> seen;
+    char path[64];
+    char buf[4096];
+    for (int fd : fds) {
+        snprintf(path, sizeof(path), PROC_FDINFO_PATH, pid, fd);
+        int infoFd = open(path, O_RDONLY | O_CLOEXEC);
+        if (infoFd < 0) {
+            // closed since the fd walk, other users' processes need ptrace access
+            if (errno != EACCES && errno != ENOENT && errno != ESRCH)
+                qCWarning(app) << "Failed to open" << path << ":" << strerror(errno);
+            continue;
+        }
+        ssize_t nr = ::read(infoFd, buf, sizeof(buf));
+        close(infoFd);
+        if (nr <= 0)
+            continue;
+
+        drm_client_t client;
+        if (!parseFdInfo(buf, size_t(nr), client) || seen.contains(client.id))
+            continue;
+        seen.insert(client.id);
+        clients << client;
+    }
+    return !clients.isEmpty();
+}
+
+} // namespace process
+} // namespace core
@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_GPU_CACHE_H
+#define PROCESS_GPU_CACHE_H
+
+#include "process_cache.h"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+class Process;
+
+/**
+ * @brief Gpu usage of a process between two fdinfo reads
+ */
+struct gpu_usage_t {
+    qreal usage {0}; // busiest engine in percent of its capacity
+    qulonglong memory {0}; // kB resident in the memory regions of the drm clients
+};
+
+/**
+ * @brief drm-* fields of /proc/[pid]/fdinfo/[fd] of a drm device fd
+ */
+struct drm_client_t {
+    QByteArray id; // drm-pdev & drm-client-id, dup'ed & inherited fds share the client
+    QMap<QByteArray, qulonglong> engines; // busy time in ns by drm-pdev/engine
+    QMap<QByteArray, qulonglong> capacity; // engine instances by drm-pdev/engine, 1 if not told
+    qulonglong memory {0}; // kB
+};
+
+/**
+ * @brief Cached gpu usage of processes, read from drm fdinfo
+ *
+ * Processes holding drm fds are known from the fd walk of the scan (SockInodeIndex), only
+ * those fds get their fdinfo read, usually a handful of processes. Usage is the busy time
+ * delta of the busiest engine since the previous read, as reported by drivers following
+ * the drm usage stats format (amdgpu, i915, xe, msm, panfrost, v3d ...). Nothing is read
+ * while the gpu columns are hidden. Refreshed on the sampling thread.
+ */
+class ProcessGpuCache
+{
+public:
+    static ProcessGpuCache *instance();
+
+    /**
+     * @brief Read fdinfo on refresh, off by default
+     */
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    /**
+     * @brief Read fdinfo of the processes of a scan holding drm fds
+     * @param set Processes of the scan by pid
+     * @param now Monotonic time in ms
+     * @return Number of processes read
+     */
+    int refresh(const QMap<pid_t, Process> &set, qint64 now);
+    int refresh(const QMap<pid_t, Process> &set);
+
+    bool lookup(pid_t pid, qulonglong startTime, gpu_usage_t &usage) const;
+    void remove(pid_t pid);
+    void clear();
+    int count() const;
+    ProcessCacheStats stats() const;
+
+    /**
+     * @brief Parse the drm-* fields of fdinfo content
+     * @return false if it's not a drm client fd, e.g. drivers without usage stats
+     */
+    static bool parseFdInfo(const char *buf, size_t len, drm_client_t &client);
+    /**
+     * @brief Read fdinfo of drm fds of a process, one drm_client_t per distinct client
+     */
+    static bool readClients(pid_t pid, const QList<int> &fds, QList<drm_client_t> &clients);
+
+private:
+    ProcessGpuCache();
+    Q_DISABLE_COPY(ProcessGpuCache)
+
+    struct entry_t {
+        QMap<QByteArray, qulonglong> busy; // ns by drm-pdev/engine, summed over clients
+        gpu_usage_t usage;
+        qint64 refreshed;
+    };
+    void read(const Process &proc, qint64 now);
+
+    mutable QMutex m_mutex;
+    mutable ProcessCache<entry_t> m_cache;
+    bool m_enabled;
+    QElapsedTimer m_clock;
+};
+
+} // namespace process
+} // namespace core
+
+#endif // PROCESS_GPU_CACHE_H
@@ -35,7 +35,11 @@ struct icon_data_t {
     icon_data_type_t type;
     char __pad__[4];
     QString proc_name;
+    QString identity;
     bool desktopentry = false;
+    // built on first use from the gui thread
+    mutable QIcon icon;
+    mutable bool iconBuilt = false;
 
     virtual ~icon_data_t() {}
 };
@@ -61,17 +65,19 @@ void ProcessIcon::refreashProcessIcon(Process *proc)
 {
     if (proc) {
         qCDebug(app) << "Refreshing process icon for pid" << proc->pid();
+        auto identity = identityKey(proc);
+        if (m_data && m_data->identity == identity) {
+            qCDebug(app) << "Icon unchanged for pid" << proc->pid();
+            if (m_data->desktopentry)
+                ProcessDB::instance()->windowList()->addDesktopEntryApp(proc);
+            return;
+        }
+
+        // new pids of the same binary resolve once
         ProcessIconCache *cache = ProcessIconCache::instance();
-        if (cache->contains(proc->pid())) {
-            auto *procIcon = cache->getProcessIcon(proc->pid());
-            if (proc->name().compare(procIcon->m_data->proc_name, Qt::CaseInsensitive) == 0) {
-                qCDebug(app) << "Icon cache hit for pid" << proc->pid();
-                m_data = procIcon->m_data;
-            } else {
-                qCDebug(app) << "Icon cache hit but name mismatch, regenerating icon for pid" << proc->pid();
-                m_data = getIcon(proc);
-                procIcon->m_data = m_data;
-            }
+        if (cache->contains(identity)) {
+            qCDebug(app) << "Icon cache hit for pid" << proc->pid();
+            m_data = cache->getProcessIcon(identity)->m_data;
 
             if (m_data->desktopentry)
                 ProcessDB::instance()->windowList()->addDesktopEntryApp(proc);
@@ -79,20 +85,40 @@ void ProcessIcon::refreashProcessIcon(Process *proc)
             qCDebug(app) << "Icon cache miss for pid" << proc->pid();
             auto *procIcon = new ProcessIcon();
             m_data = getIcon(proc);
+            m_data->identity = identity;
             procIcon->m_data = m_data;
-            cache->addProcessIcon(proc->pid(), procIcon);
+            cache->addProcessIcon(identity, procIcon);
         }
     } else {
         qCWarning(app) << "proc is null in refreashProcessIcon";
     }
 }
 
+QString ProcessIcon::identityKey(Process *proc) const
+{
+    WMWindowList *windowList = ProcessDB::instance()->windowList();
+    QString window;
+    // window icons may differ between processes of one binary, e.g. web apps
+    if (windowList->isGuiApp(proc->pid()))
+        window = QString("gui:%1").arg(proc->pid());
+    else if (windowList->isTrayApp(proc->pid()))
+        window = "tray";
+
+    const QByteArrayList &cmdline = proc->cmdline();
+    QString exe = cmdline.isEmpty() ? QString() : QString::fromLocal8Bit(cmdline[0]);
+    QString desktopFile = cmdline.isEmpty() ? QString() : proc->environ().value("GIO_LAUNCHED_DESKTOP_FILE");
+    return QStringList({proc->name(), exe, desktopFile, window}).join('\n');
+}
+
 QIcon ProcessIcon::icon() const
 {
-    QIcon icon;
     qCDebug(app) << "Getting icon from ProcessIcon object";
 
     if (m_data) {
+        if (m_data->iconBuilt)
+            return m_data->icon;
+
+        QIcon icon;
         if (m_data->type == kIconDataNameType) {
             auto *iconData = reinterpret_cast<struct icon_data_name_type *>(m_data.get());
             if (iconData) {
@@ -106,9 +132,22 @@ QIcon ProcessIcon::icon() const
                 icon.addPixmap(QPixmap::fromImage(iconData->image));
             } // ::if(iconData)
         }
+        m_data->icon = icon;
+        m_data->iconBuilt = true;
+        return icon;
     } // ::if(m_data)
 
-    return icon;
+    return QIcon();
+}
+
+QString ProcessIcon::pixmapKey() const
+{
+    if (!m_data)
+        return {};
+    // themed icons are shared by name, window icons by process
+    if (m_data->type == kIconDataNameType)
+        return "theme:" + reinterpret_cast<struct icon_data_name_type *>(m_data.get())->icon_name;
+    return "image:" + m_data->identity;
 }
 
 struct icon_data_t *ProcessIcon::defaultIconData(const QString &procname) const {
@@ -132,16 +171,10 @@ struct icon_data_t *ProcessIcon::terminalIconData(const QString &procname) const
 QString ProcessIcon::getFileManagerString()
 {
     qCDebug(app) << "Getting file manager string";
-    DesktopEntryCache *desktopEntryCache = ProcessDB::instance()->desktopEntryCache();
-    QList<QString> desktopEntryKeys = desktopEntryCache->getCache().keys();
-    for (auto it = desktopEntryKeys.begin(); it != desktopEntryKeys.end(); it++) {
-        if ((*it).contains("dde-file-manager") && desktopEntryCache->getCache().value((*it))->icon.contains("dde-file-manager")) {
-            qCDebug(app) << "Found file manager string:" << *it;
-            return (*it);
-        }
-    }
-    qCDebug(app) << "File manager string not found";
-    return "";
+    auto key = ProcessDB::instance()->desktopEntryCache()->fileManagerKey();
+    if (key.isEmpty())
+        qCDebug(app) << "File manager string not found";
+    return key;
 }
 
 std::shared_ptr<icon_data_t> ProcessIcon::getIcon(Process *proc)
@@ -237,6 +270,23 @@ std::shared_ptr<icon_data_t> ProcessIcon::getIcon(Process *proc)
             }
         }
 
+        // sandboxed apps are told by their app id
+        auto appId = allEnviron.value("FLATPAK_ID", allEnviron.value("LINGLONG_APPID"));
+        if (!appId.isEmpty()) {
+            auto entry = desktopEntryCache->entryWithAppId(appId);
+            if (entry && !entry->icon.isEmpty()) {
+                qCDebug(app) << "Found icon from app id" << appId << ":" << entry->icon;
+                auto *iconData = new struct icon_data_name_type();
+                iconData->desktopentry = true;
+                iconData->type = kIconDataNameType;
+                iconData->proc_name = proc->name();
+                iconData->icon_name = entry->icon;
+                iconDataPtr.reset(iconData);
+                windowList->addDesktopEntryApp(proc);
+                return iconDataPtr;
+            }
+        }
+
         if (shellList.contains(proc->name())) {
             qCDebug(app) << "Process is a shell, using terminal icon";
             iconDataPtr.reset(terminalIconData(proc->name()));
@@ -23,9 +23,17 @@ public:
     ~ProcessIcon();
 
     QIcon icon() const;
+    /**
+     * @brief Key of the rendered icon, processes showing the same icon share it
+     */
+    QString pixmapKey() const;
     void refreashProcessIcon(Process *proc);
 
 private:
+    /**
+     * @brief What the icon of a process is resolved from: name, executable, launching desktop file & window
+     */
+    QString identityKey(Process *proc) const;
     std::shared_ptr<struct icon_data_t> getIcon(Process *proc);
     struct icon_data_t *defaultIconData(const QString &procname) const;
     struct icon_data_t *terminalIconData(const QString &procname) const;
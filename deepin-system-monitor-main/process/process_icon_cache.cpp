@@ -9,6 +9,7 @@
 #include <DGuiApplicationHelper>
 #include <DPlatformTheme>
 #include <QPointer>
+#include <QTimer>
 
 DWIDGET_USE_NAMESPACE
 using namespace DDLog;
@@ -16,12 +17,19 @@ using namespace DDLog;
 namespace core {
 namespace process {
 
+// icons rendered per event loop pass, keeps scrolling over many new icons responsive
+const int RenderBatch = 16;
+
 ProcessIconCache *ProcessIconCache::m_instance = nullptr;
 
 ProcessIconCache::ProcessIconCache(QObject *parent)
     : QObject(parent)
 {
     qCDebug(app) << "ProcessIconCache object created";
+    // first asked for on the monitor thread, pixmaps are rendered on the gui thread
+    if (qApp && thread() != qApp->thread())
+        moveToThread(qApp->thread());
+
     // 由于之前获取dapplication::themetypechanged改变信号在有些平台获取不到，现通过获取DPlatformtheme方式获取
     static QPointer<DPlatformTheme> theme;
 
@@ -31,9 +39,73 @@ ProcessIconCache::ProcessIconCache(QObject *parent)
         connect(theme, &DPlatformTheme::iconThemeNameChanged, this, [ = ]() {
             qCDebug(app) << "Icon theme changed, clearing pixmap cache";
             iconPixmapCache.clear();
+            onIconThemeChanged();
         });
     }
 }
 
+QString ProcessIconCache::pixmapKey(const QString &iconKey, const QSize &size)
+{
+    return QString("%1@%2x%3").arg(iconKey).arg(size.width()).arg(size.height());
+}
+
+QPixmap ProcessIconCache::pixmap(const QString &iconKey, const QIcon &icon, const QSize &size)
+{
+    auto key = pixmapKey(iconKey, size);
+    auto *rendered = m_pixmaps.object(key);
+    if (rendered && !rendered->stale)
+        return rendered->pixmap;
+
+    bool queued = false;
+    for (const auto &pending : m_pending) {
+        if (pending.key == key) {
+            queued = true;
+            break;
+        }
+    }
+    if (!queued) {
+        if (m_pending.isEmpty())
+            QTimer::singleShot(0, this, &ProcessIconCache::renderPending);
+        // see ProcessIcon::pixmapKey
+        m_pending << pending_icon_t {key, icon, size, iconKey.startsWith("theme:")};
+    }
+
+    // icons of a replaced theme are kept until rendered again
+    if (rendered)
+        return rendered->pixmap;
+
+    auto placeholderKey = pixmapKey("[::placeholder::]", size);
+    rendered = m_pixmaps.object(placeholderKey);
+    if (!rendered || rendered->stale) {
+        rendered = new rendered_icon_t {QIcon::fromTheme("application-x-executable").pixmap(size), true, false};
+        m_pixmaps.insert(placeholderKey, rendered);
+    }
+    return rendered->pixmap;
+}
+
+void ProcessIconCache::renderPending()
+{
+    int count = 0;
+    while (!m_pending.isEmpty() && count++ < RenderBatch) {
+        auto pending = m_pending.takeFirst();
+        m_pixmaps.insert(pending.key, new rendered_icon_t {pending.icon.pixmap(pending.size), pending.themed, false});
+    }
+    if (!m_pending.isEmpty())
+        QTimer::singleShot(0, this, &ProcessIconCache::renderPending);
+
+    Q_EMIT iconsRendered();
+}
+
+void ProcessIconCache::onIconThemeChanged()
+{
+    // window icons don't depend on the theme, only themed ones are rendered again
+    for (const auto &key : m_pixmaps.keys()) {
+        auto *rendered = m_pixmaps.object(key);
+        if (rendered->themed)
+            rendered->stale = true;
+    }
+    Q_EMIT iconsRendered();
+}
+
 } // namespace process
 } // namespace core
@@ -9,6 +9,7 @@
 #include <QCache>
 #include <QThread>
 #include <QPixmapCache>
+#include <QSize>
 
 #include "process_icon.h"
 
@@ -22,21 +23,51 @@ class ProcessIconCache : public QObject
 public:
     static ProcessIconCache *instance();
 
-    ProcessIcon *getProcessIcon(pid_t pid) const;
-    void addProcessIcon(pid_t pid, ProcessIcon *procIcon);
-    void removeProcessIcon(pid_t pid);
-    bool contains(pid_t pid) const;
+    // icon data by process identity, see ProcessIcon::identityKey, monitor thread only
+    ProcessIcon *getProcessIcon(const QString &identity) const;
+    void addProcessIcon(const QString &identity, ProcessIcon *procIcon);
+    void removeProcessIcon(const QString &identity);
+    bool contains(const QString &identity) const;
     void clear();
     void setMaxCost(int cost);
 
+    /**
+     * @brief Icon rendered at size, gui thread only
+     *
+     * Icons not rendered yet are rendered after the current paint, a placeholder is returned meanwhile
+     * and iconsRendered() tells when to repaint.
+     */
+    QPixmap pixmap(const QString &iconKey, const QIcon &icon, const QSize &size);
+
+Q_SIGNALS:
+    void iconsRendered();
+
 public:
     QPixmapCache iconPixmapCache;
 
 private:
     explicit ProcessIconCache(QObject *parent = nullptr);
 
+    struct rendered_icon_t {
+        QPixmap pixmap;
+        bool themed; // rendered from the icon theme
+        bool stale;  // icon theme changed since
+    };
+    struct pending_icon_t {
+        QString key;
+        QIcon icon;
+        QSize size;
+        bool themed;
+    };
+
+    static QString pixmapKey(const QString &iconKey, const QSize &size);
+    void renderPending();
+    void onIconThemeChanged();
+
 private:
-    QCache<pid_t, ProcessIcon> m_cache {200};
+    QCache<QString, ProcessIcon> m_cache {200};
+    QCache<QString, rendered_icon_t> m_pixmaps {1000};
+    QList<pending_icon_t> m_pending;
 
     static ProcessIconCache *m_instance;
 };
@@ -49,27 +80,27 @@ inline ProcessIconCache *ProcessIconCache::instance()
     return m_instance;
 }
 
-inline ProcessIcon *ProcessIconCache::getProcessIcon(pid_t pid) const
+inline ProcessIcon *ProcessIconCache::getProcessIcon(const QString &identity) const
 {
-    if (m_cache.contains(pid))
-        return m_cache[pid];
+    if (m_cache.contains(identity))
+        return m_cache[identity];
 
     return nullptr;
 }
 
-inline void ProcessIconCache::addProcessIcon(pid_t pid, ProcessIcon *procIcon)
+inline void ProcessIconCache::addProcessIcon(const QString &identity, ProcessIcon *procIcon)
 {
-    m_cache.insert(pid, procIcon);
+    m_cache.insert(identity, procIcon);
 }
 
-inline void ProcessIconCache::removeProcessIcon(pid_t pid)
+inline void ProcessIconCache::removeProcessIcon(const QString &identity)
 {
-    m_cache.remove(pid);
+    m_cache.remove(identity);
 }
 
-inline bool ProcessIconCache::contains(pid_t pid) const
+inline bool ProcessIconCache::contains(const QString &identity) const
 {
-    return m_cache.contains(pid);
+    return m_cache.contains(identity);
 }
 
 inline void ProcessIconCache::clear()
@@ -11,6 +11,7 @@
 #include "desktop_entry_cache.h"
 #include "common/common.h"
 #include "common/thread_manager.h"
+#include "common/string_pool.h"
 #include "system/system_monitor_thread.h"
 #include "system/system_monitor.h"
 #include "wm/wm_window_list.h"
@@ -21,6 +22,7 @@
 
 using namespace common::init;
 using namespace common::core;
+using namespace common::intern;
 using namespace core::wm;
 using namespace core::system;
 using namespace core::process;
@@ -28,6 +30,21 @@ using namespace core::process;
 namespace core {
 namespace process {
 
+// 64 bit FNV-1a, lengths are hashed too so "ab" + "c" & "a" + "bc" differ
+static inline quint64 hashBytes(quint64 hash, const char *data, int size)
+{
+    for (int i = 0; i < int(sizeof(size)); ++i)
+        hash = (hash ^ quint8(size >> (i * 8))) * 1099511628211ull;
+    for (int i = 0; i < size; ++i)
+        hash = (hash ^ quint8(data[i])) * 1099511628211ull;
+    return hash;
+}
+
+static inline quint64 hashString(quint64 hash, const QString &text)
+{
+    return hashBytes(hash, reinterpret_cast<const char *>(text.constData()), int(text.size() * int(sizeof(QChar))));
+}
+
 ProcessName::ProcessName()
 {
 
@@ -39,11 +56,57 @@ void ProcessName::refreashProcessName(Process *proc)
         qCDebug(app) << "Refreshing process name for pid" << proc->pid();
         proc->setName(ProcessName::normalizeProcessName(proc->name(), proc->cmdline()));
         m_name = proc->name();
-        // display name
-        m_displayName = getDisplayName(proc);
+        // display name, shared by the processes of an app, resolved once per identity
+        quint64 identity = identityKey(proc);
+        if (identity == m_identity && !m_displayName.isNull())
+            return;
+
+        m_identity = identity;
+        ProcessNameCache *cache = ProcessNameCache::instance();
+        if (const QString *displayName = cache->displayName(identity)) {
+            m_displayName = *displayName;
+            return;
+        }
+        m_displayName = StringPool::instance()->intern(getDisplayName(proc));
+        cache->insertDisplayName(identity, m_displayName);
     }
 }
 
+quint64 ProcessName::identityKey(Process *proc) const
+{
+    auto processDB = ProcessDB::instance();
+    WMWindowList *windowList = processDB->windowList();
+
+    quint64 hash = 14695981039346656037ull;
+    quint64 generation = processDB->desktopEntryCache()->generation();
+    hash = hashBytes(hash, reinterpret_cast<const char *>(&generation), int(sizeof(generation)));
+    hash = hashString(hash, proc->name());
+    // shells show their whole cmdline & documents their last arg, so all of it counts
+    const QByteArrayList &cmdline = proc->cmdline();
+    for (const QByteArray &arg : cmdline)
+        hash = hashBytes(hash, arg.constData(), int(arg.size()));
+    if (cmdline.isEmpty())
+        return hash;
+
+    // titles of window apps change while they run
+    char window = 0;
+    if (windowList->isTrayApp(proc->pid()))
+        window = 't';
+    else if (windowList->isGuiApp(proc->pid()))
+        window = 'g';
+    hash = hashBytes(hash, &window, 1);
+    if (window)
+        hash = hashString(hash, windowList->getWindowTitle(proc->pid()));
+
+    // desktop file only counts for the launched process, not for its children
+    const QHash<QString, QString> environ = proc->environ();
+    QString desktopFile = environ.value("GIO_LAUNCHED_DESKTOP_FILE");
+    char launched = environ.value("GIO_LAUNCHED_DESKTOP_FILE_PID").toInt() == proc->pid();
+    hash = hashString(hash, desktopFile);
+    hash = hashBytes(hash, &launched, 1);
+    return hashString(hash, environ.value("FLATPAK_ID", environ.value("LINGLONG_APPID")));
+}
+
 QString ProcessName::normalizeProcessName(const QString &source, const QByteArrayList &cmdline)
 {
     qCDebug(app) << "Normalizing process name" << source << "with cmdline size" << cmdline.size();
@@ -175,6 +238,17 @@ QString ProcessName::getDisplayName(Process *proc)
             }
         }
 
+        // sandboxed apps are told by their app id
+        auto procEnviron = proc->environ();
+        auto appId = procEnviron.value("FLATPAK_ID", procEnviron.value("LINGLONG_APPID"));
+        if (!appId.isEmpty()) {
+            auto entry = desktopEntryCache->entryWithAppId(appId);
+            if (entry && !entry->displayName.isEmpty()) {
+                qCDebug(app) << "Found display name from app id" << appId << ":" << entry->displayName;
+                return entry->displayName;
+            }
+        }
+
         if (proc->cmdline()[0].startsWith("/opt")) {
             qCDebug(app) << "Process path starts with /opt";
             QString fname = QFileInfo(QString(proc->cmdline()[0]).split(' ')[0]).fileName();
@@ -26,15 +26,27 @@ public:
 
     QString name() const;
     QString displayName() const;
+    /**
+     * @brief Names as resolved elsewhere, e.g. of a replayed recording
+     */
+    void setNames(const QString &name, const QString &displayName);
 
     static QString normalizeProcessName(const QString &name, const QByteArrayList &cmdline);
 
 private:
     QString getDisplayName(Process *proc);
+    /**
+     * @brief Fingerprint of what the display name is resolved from
+     *
+     * Name, cmdline, desktop file & app id of the environment, window title & the desktop
+     * entry generation, processes of one program launched the same way share it.
+     */
+    quint64 identityKey(Process *proc) const;
 
 private:
     QString m_name {};
     QString m_displayName {};
+    quint64 m_identity {0}; // of m_displayName
 };
 
 inline QString ProcessName::name() const
@@ -47,6 +59,12 @@ inline QString ProcessName::displayName() const
     return m_displayName;
 }
 
+inline void ProcessName::setNames(const QString &name, const QString &displayName)
+{
+    m_name = name;
+    m_displayName = displayName;
+}
+
 } // namespace process
 } // namespace core
 
@@ -7,6 +7,7 @@
 #define PROCESS_NAME_CACHE_H
 
 #include "process_name.h"
+#include "process_cache.h"
 
 #include <QCache>
 #include <QObject>
@@ -16,6 +17,9 @@ namespace process {
 
 /**
  * @brief The ProcessNameCache class
+ *
+ * Names are keyed by pid & validated with process start time, see ProcessCache. Display names
+ * are also kept by identity, see ProcessName::identityKey, so new pids of a program resolve once.
  */
 class ProcessNameCache : public QObject
 {
@@ -24,18 +28,26 @@ class ProcessNameCache : public QObject
 public:
     static ProcessNameCache *instance();
 
-    void insert(pid_t pid, ProcessName *name);
+    void insert(pid_t pid, qulonglong startTime, const ProcessName &name);
     void remove(pid_t pid);
     void clear();
 
-    const ProcessName *processName(pid_t pid) const;
+    const ProcessName *processName(pid_t pid, qulonglong startTime) const;
     bool contains(pid_t pid) const;
+    ProcessCacheStats stats() const;
+
+    void insertDisplayName(quint64 identity, const QString &displayName);
+    const QString *displayName(quint64 identity) const;
+
+    // max number of processes with names cached
+    static constexpr int kMaxCacheSize = 1024;
 
 protected:
     explicit ProcessNameCache(QObject *parent = nullptr);
 
 private:
-    QCache<pid_t, ProcessName> m_cache;
+    ProcessCache<ProcessName> m_cache {kMaxCacheSize};
+    QCache<quint64, QString> m_displayNames {kMaxCacheSize};
 
     static ProcessNameCache *m_instance;
 };
@@ -48,9 +60,10 @@ inline ProcessNameCache *ProcessNameCache::instance()
     return m_instance;
 }
 
-inline void ProcessNameCache::insert(pid_t pid, ProcessName *name)
+inline void ProcessNameCache::insert(pid_t pid, qulonglong startTime, const ProcessName &name)
 {
-    m_cache.insert(pid, name);
+    qint64 bytes = sizeof(ProcessName) + (name.name().size() + name.displayName().size()) * qint64(sizeof(QChar));
+    m_cache.insert(pid, startTime, name, bytes);
 }
 
 inline void ProcessNameCache::remove(pid_t pid)
@@ -61,11 +74,12 @@ inline void ProcessNameCache::remove(pid_t pid)
 inline void ProcessNameCache::clear()
 {
     m_cache.clear();
+    m_displayNames.clear();
 }
 
-inline const ProcessName *ProcessNameCache::processName(pid_t pid) const
+inline const ProcessName *ProcessNameCache::processName(pid_t pid, qulonglong startTime) const
 {
-    return m_cache[pid];
+    return m_cache.peek(pid, startTime);
 }
 
 inline bool ProcessNameCache::contains(pid_t pid) const
@@ -73,6 +87,21 @@ inline bool ProcessNameCache::contains(pid_t pid) const
     return m_cache.contains(pid);
 }
 
+inline ProcessCacheStats ProcessNameCache::stats() const
+{
+    return m_cache.stats();
+}
+
+inline void ProcessNameCache::insertDisplayName(quint64 identity, const QString &displayName)
+{
+    m_displayNames.insert(identity, new QString(displayName));
+}
+
+inline const QString *ProcessNameCache::displayName(quint64 identity) const
+{
+    return m_displayNames.object(identity);
+}
+
 } // namespace process
 } // namespace core
 
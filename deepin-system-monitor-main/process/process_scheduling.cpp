@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "process_scheduling.h"
+#include "process_info_record.h"
+#include "ddlog.h"
+
+#include <QFile>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace DDLog;
+
+namespace {
+// linux/ioprio.h isn't shipped by every libc
+const int kIOPrioWhoProcess = 1;
+const int kIOPrioLevels = 8;
+// cpus the system server takes
+const int kMaxCpus = PROCESS_AFFINITY_MAX_BYTES * 8;
+
+QByteArray readFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return file.readAll();
+}
+} // namespace
+
+namespace core {
+namespace process {
+
+QVector<int> ProcessScheduling::parseCpuList(const QString &text)
+{
+    QVector<bool> set;
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    const QStringList ranges = text.trimmed().split(',', QString::SkipEmptyParts);
+#else
+    const QStringList ranges = text.trimmed().split(',', Qt::SkipEmptyParts);
+#endif
+    for (const QString &range : ranges) {
+        const QStringList bounds = range.trimmed().split('-');
+        bool ok = false;
+        const int first = bounds.first().trimmed().toInt(&ok);
+        int last = first;
+        if (ok && bounds.size() == 2)
+            last = bounds.last().trimmed().toInt(&ok);
+        if (!ok || bounds.size() > 2 || first < 0 || last < first || last >= kMaxCpus)
+            return {};
+        if (set.size() <= last)
+            set.resize(last + 1);
+        for (int cpu = first; cpu <= last; ++cpu)
+            set[cpu] = true;
+    }
+
+    QVector<int> cpus;
+    for (int cpu = 0; cpu < set.size(); ++cpu) {
+        if (set[cpu])
+            cpus << cpu;
+    }
+    return cpus;
+}
+
+QByteArray ProcessScheduling::cpuMask(const QVector<int> &cpus)
+{
+    int last = -1;
+    for (int cpu : cpus)
+        last = qMax(last, cpu);
+    if (last < 0)
+        return {};
+
+    // whole longs, the kernel copies cpu_set_t as unsigned longs
+    const int bytes = (last / 8 / int(sizeof(unsigned long)) + 1) * int(sizeof(unsigned long));
+    QByteArray mask(bytes, '\0');
+    for (int cpu : cpus) {
+        if (cpu >= 0)
+            mask[cpu / 8] = char(uchar(mask[cpu / 8]) | (1u << (cpu % 8)));
+    }
+    return mask;
+}
+
+int ProcessScheduling::ioPriority(int ioClass, int level)
+{
+    if (ioClass == kIOClassNone || ioClass == kIOClassIdle)
+        level = 0;
+    return ioClass << PROCESS_CONTROL_IOPRIO_CLASS_SHIFT | qBound(0, level, kIOPrioLevels - 1);
+}
+
+bool ProcessScheduling::read(pid_t pid, scheduling_t &sched)
+{
+    sched = {};
+    // Cpus_allowed_list is the affinity of the main thread
+    const QByteArray status = readFile(QString("/proc/%1/status").arg(pid));
+    if (status.isEmpty())
+        return false;
+    const int pos = status.indexOf("\nCpus_allowed_list:");
+    if (pos >= 0) {
+        const int begin = pos + int(sizeof("\nCpus_allowed_list:")) - 1;
+        sched.affinity = parseCpuList(QString::fromLatin1(status.mid(begin, status.indexOf('\n', begin) - begin)));
+    }
+
+    errno = 0;
+    const long ioprio = syscall(SYS_ioprio_get, kIOPrioWhoProcess, pid);
+    if (ioprio >= 0) {
+        sched.ioClass = int(ioprio >> PROCESS_CONTROL_IOPRIO_CLASS_SHIFT);
+        sched.ioLevel = int(ioprio & ((1 << PROCESS_CONTROL_IOPRIO_CLASS_SHIFT) - 1));
+    } else if (errno != ESRCH) {
+        qCDebug(app) << "ioprio_get failed for pid" << pid << ":" << strerror(errno);
+    }
+
+    readCpuset(readFile(QString("/proc/%1/cgroup").arg(pid)), QStringLiteral("/sys/fs/cgroup"),
+               sched.cpuset, sched.cpusetCpus);
+    return true;
+}
+
+bool ProcessScheduling::readCpuset(const QByteArray &cgroup, const QString &root, QString &path, QVector<int> &cpus)
+{
+    path.clear();
+    cpus.clear();
+    for (const QByteArray &line : cgroup.split('\n')) {
+        // hierarchy-ID:controllers:path
+        const QList<QByteArray> fields = line.split(':');
+        if (fields.size() < 3)
+            continue;
+        const QString group = QString::fromUtf8(line.mid(fields[0].size() + fields[1].size() + 2));
+        QString dir;
+        QString file;
+        if (fields[0] == "0" && fields[1].isEmpty()) {
+            // v2, cpuset.cpus.effective exists where the controller is enabled & at the root
+            dir = root;
+            file = QStringLiteral("cpuset.cpus.effective");
+        } else if (fields[1].split(',').contains("cpuset")) {
+            dir = root + QStringLiteral("/cpuset");
+            file = QStringLiteral("cpuset.effective_cpus");
+        } else {
+            continue;
+        }
+
+        // closest ancestor with the controller
+        QString current = group;
+        for (;;) {
+            const QByteArray content = readFile(dir + current + '/' + file);
+            if (!content.isEmpty()) {
+                path = current;
+                cpus = parseCpuList(QString::fromLatin1(content));
+                return !cpus.isEmpty();
+            }
+            if (current.isEmpty() || current == QLatin1String("/"))
+                break;
+            current.truncate(qMax(0, current.lastIndexOf('/')));
+        }
+    }
+    return false;
+}
+
+} // namespace process
+} // namespace core
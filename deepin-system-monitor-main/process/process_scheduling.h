@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_SCHEDULING_H
+#define PROCESS_SCHEDULING_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Cpu affinity, io priority & cpuset of a process, read on request for one process at a time
+ *
+ * All of it is readable for processes of other users. Affinity is the one of the main thread,
+ * threads set apart with taskset -p aren't told.
+ */
+class ProcessScheduling
+{
+public:
+    // ioprio classes, as ioprio_set(2) takes them
+    enum IOClass {
+        kIOClassNone = 0, // derived from the nice value
+        kIOClassRealtime = 1,
+        kIOClassBestEffort = 2,
+        kIOClassIdle = 3
+    };
+
+    struct scheduling_t {
+        QVector<int> affinity; // cpus the process may run on, sorted
+        int ioClass {-1}; // IOClass, -1 if unknown
+        int ioLevel {0}; // 0 highest ~ 7 lowest, realtime & best effort only
+        QString cpuset; // cgroup giving the cpus, empty without a cpuset controller
+        QVector<int> cpusetCpus; // cpus of that cgroup, affinity is always within them
+    };
+
+    /**
+     * @brief Parse a cpu list as the kernel prints it, e.g. "0-3,8"
+     * @return Sorted cpus, empty if the list is empty or malformed
+     */
+    static QVector<int> parseCpuList(const QString &text);
+    /**
+     * @brief cpu_set_t bit mask of cpus, as sched_setaffinity(2) & the system server take it
+     */
+    static QByteArray cpuMask(const QVector<int> &cpus);
+    /**
+     * @brief ioprio value of a class & level, the level is ignored for none & idle
+     */
+    static int ioPriority(int ioClass, int level);
+    /**
+     * @brief Read the scheduling of a process
+     * @return false if it exited
+     */
+    static bool read(pid_t pid, scheduling_t &sched);
+    /**
+     * @brief Cgroup path of the cpuset controller & its effective cpus
+     * @param cgroup Content of /proc/[pid]/cgroup
+     * @param root Mount point of the cgroup hierarchies, /sys/fs/cgroup
+     */
+    static bool readCpuset(const QByteArray &cgroup, const QString &root, QString &path, QVector<int> &cpus);
+};
+
+} // namespace process
+} // namespace core
+
+#endif // PROCESS_SCHEDULING_H
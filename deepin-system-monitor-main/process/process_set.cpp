@@ -10,30 +10,68 @@
 #include "wm/wm_window_list.h"
 #include "system_service_client.h"
 #include "process/private/process_p.h"
+#include "process/process_environ_cache.h"
+#include "process/process_name_cache.h"
+#include "process/process_gpu_cache.h"
+#include "process/process_smaps_cache.h"
+#include "system/proc_connector.h"
+#include "system/task_stats.h"
+#include "system/task_exit_monitor.h"
+#include "system/device_db.h"
+#include "system/cpu_set.h"
+#include "system/sys_info.h"
+#include "system/demand_tracker.h"
+#include "process_info_record.h"
+#include "common/perf_trace.h"
+#include "common/trace_log.h"
+#include "common/task_executor.h"
+#include "common/string_pool.h"
 // #include "settings.h"
 
+#include <QDateTime>
 #include <QDebug>
 #include <QFile>
 #include <QElapsedTimer>
+#include <QThread>
+#include <QtConcurrent>
 #include <DConfig>
 
+#include <algorithm>
+#include <cmath>
+
 #include <errno.h>
+#include <string.h>
+#include <unistd.h>
 
 #define PROC_PATH "/proc"
 
+// below this many processes the thread hand-off costs more than it saves
+const int kParallelSamplingThreshold = 512;
+// more shards than workers, so an idle worker picks up the next shard instead of waiting
+const int kSamplingShardsPerWorker = 4;
+const int kMaxSamplingWorkers = 16;
+// full /proc rescan every this many ticks when pid set is tracked by proc connector events
+const int kFullRescanTicks = 30;
+
 using namespace common::error;
+using common::core::TaskExecutor;
 
 namespace core {
 namespace process {
 
 ProcessSet::ProcessSet()
     : m_set {}
-    , m_recentProcStage {}
-    , m_pidCtoPMapping {}
-    , m_pidPtoCMapping {}
+    , m_snapshot(std::make_shared<const ProcessSnapshot>())
     , m_systemServiceClient(nullptr)
     , m_useSystemService(false)
+    , m_kernelNetCounters(false)
+    , m_netTrafficSampled(false)
+    , m_dkaptureGeneration(0)
     , m_config(nullptr)
+    , m_parallelSampling(false)
+    , m_samplingWorkers(1)
+    , m_ticksSinceRescan(kFullRescanTicks)
+    , m_cpuUsageTotal {}
 {
     qCDebug(app) << "ProcessSet object created";
     
@@ -61,40 +99,70 @@ ProcessSet::ProcessSet()
             m_systemServiceClient->startSystemService();
         }
 
-        // 检测DKapture可用性并设置使用标志
-        m_useSystemService = m_systemServiceClient 
-                             && m_systemServiceClient->isServiceAvailable() 
-                             && m_systemServiceClient->isDKaptureAvailable();
-        
-        if (m_useSystemService) {
-            qCInfo(app) << "DKapture system service detected and enabled";
-        } else {
-            qCInfo(app) << "DKapture not available, will use traditional /proc scanning";
-        }
+        // DKapture可用性由客户端异步检测，结果返回前使用传统方式读取
+        QObject::connect(m_systemServiceClient, &SystemServiceClient::dkaptureAvailabilityChanged,
+                         m_systemServiceClient, [this](bool available) {
+            m_useSystemService = available;
+            if (m_useSystemService) {
+                qCInfo(app) << "DKapture system service detected and enabled";
+                m_systemServiceClient->requestProcessInfo(m_dkaptureGeneration, m_pidList);
+            } else {
+                qCInfo(app) << "DKapture not available, will use traditional /proc scanning";
+            }
+        });
     } else {
         qCInfo(app) << "DKapture disabled in configuration, using traditional /proc scanning";
         m_useSystemService = false;
     }
+
+    initSampling();
+    initGrouping();
+    initPidEventSource();
+    initTaskStats();
+    initTaskExitMonitor();
+    initEnergy();
+    m_hungTasks.reset(new HungTaskSampler(m_systemServiceClient));
+    m_hostPidNamespace = ContainerIdentity::pidNamespace(getpid());
+
+    if (m_config) {
+        int minutes = m_config->value("fd_leak_window_minutes", 10).toInt();
+        m_fdLeakWindow = qBound(1, minutes, 24 * 60) * 60;
+        int seconds = m_config->value("hung_task_seconds", 10).toInt();
+        m_hungTaskWindow = qBound(2, seconds, 3600);
+    }
 }
 
 ProcessSet::ProcessSet(const ProcessSet &other)
     : m_set(other.m_set)
     , m_recentProcStage(other.m_recentProcStage)
-    , m_pidCtoPMapping(other.m_pidCtoPMapping)
-    , m_pidPtoCMapping(other.m_pidPtoCMapping)
+    , m_snapshot(other.snapshot())
+    , m_tree(other.m_tree)
     , m_systemServiceClient(nullptr)
     , m_useSystemService(other.m_useSystemService)
+    , m_kernelNetCounters(other.m_kernelNetCounters)
+    , m_netTrafficSampled(other.m_netTrafficSampled)
+    , m_dkaptureGeneration(0)
     , m_config(nullptr)
+    , m_parallelSampling(false)
+    , m_samplingWorkers(1)
+    , m_ticksSinceRescan(0)
+    , m_cpuUsageTotal {other.m_cpuUsageTotal[0], other.m_cpuUsageTotal[1]}
 {
     qCDebug(app) << "ProcessSet object copied";
+    m_pidList.clear();
     m_prePid.clear();
-    m_curPid.clear();
     m_pidMyApps.clear();
     m_simpleSet.clear();
+    m_fdLeakWindow = other.m_fdLeakWindow;
+    m_hungTaskWindow = other.m_hungTaskWindow;
+    m_hungTasks.reset(new HungTaskSampler());
     
     // Note: We don't copy the system service client or config, 
     // as they should be managed by the original instance
     // m_settings = Settings::instance();
+
+    // fd caches are bound to the sampling state of the original instance, copies sample serially
+    m_fdCaches.emplace_back(new ProcFdCache());
 }
 
 ProcessSet::~ProcessSet()
@@ -112,29 +180,388 @@ ProcessSet::~ProcessSet()
 
 void ProcessSet::mergeSubProcNetIO(pid_t ppid, qreal &recvBps, qreal &sendBps)
 {
-    qCDebug(app) << "Merging sub-process net IO for ppid" << ppid;
-    auto it = m_pidPtoCMapping.find(ppid);
-    while (it != m_pidPtoCMapping.end() && it.key() == ppid) {
-        mergeSubProcNetIO(it.value(), recvBps, sendBps);
-        ++it;
+    const ProcessTreeUsage &usage = m_tree.subtreeUsage(ppid);
+    recvBps += usage.recvBps;
+    sendBps += usage.sentBps;
+}
+
+void ProcessSet::mergeSubProcCpu(pid_t ppid, qreal &cpu)
+{
+    cpu += m_tree.subtreeUsage(ppid).cpu;
+}
+
+QSet<pid_t> ProcessSet::mergeAppCgroups()
+{
+    QSet<pid_t> merged;
+    if (m_grouping != kGroupByCgroup || !m_cgroupStats)
+        return merged;
+
+    // app pid by cgroup, cgroups shared by several apps are dropped
+    QHash<QString, pid_t> owners;
+    QSet<QString> shared;
+    for (const pid_t &pid : m_pidMyApps) {
+        if (!m_set.contains(pid))
+            continue;
+        QString cgroup = common::cgroup::CgroupStats::processCgroup(pid);
+        if (!isAppCgroup(cgroup))
+            continue;
+        if (owners.contains(cgroup))
+            shared.insert(cgroup);
+        else
+            owners.insert(cgroup, pid);
     }
 
-    const Process &proc = m_set[ppid];
-    recvBps += proc.recvBps();
-    sendBps += proc.sentBps();
+    QHash<QString, QString> controlGroups;
+    for (auto it = owners.constBegin(); it != owners.constEnd(); ++it) {
+        if (!shared.contains(it.key()))
+            controlGroups.insert(it.key(), it.key());
+    }
+
+    const auto usages = m_cgroupStats->sample(controlGroups);
+    for (auto it = usages.constBegin(); it != usages.constEnd(); ++it) {
+        // no cpu rate before a second sample, the tree is walked once more
+        if (!it->hasRates)
+            continue;
+        pid_t pid = owners.value(it.key());
+        Process &proc = m_set[pid];
+        proc.setCpu(it->cpu);
+        proc.setGroupMemory(it->memory / 1024);
+        merged.insert(pid);
+    }
+    qCDebug(app) << "Accounted" << merged.size() << "of" << m_pidMyApps.size() << "apps by cgroup";
+    return merged;
 }
 
-void ProcessSet::mergeSubProcCpu(pid_t ppid, qreal &cpu)
+bool ProcessSet::isAppCgroup(const QString &cgroup)
+{
+    QString leaf = cgroup.section('/', -1);
+    if (!leaf.endsWith(".scope") && !leaf.endsWith(".service"))
+        return false;
+    // a login session holds everything started from the session, the init scope a whole manager's own processes
+    return !leaf.startsWith("session-") && leaf != "init.scope";
+}
+
+void ProcessSet::updateMemoryTrends()
+{
+    const qreal available = qreal(core::system::DeviceDB::instance()->memInfo()->memAvailable());
+    const bool hasCgroups = common::cgroup::CgroupStats::isAvailable();
+    for (auto it = m_set.begin(); it != m_set.end(); ++it) {
+        Process &proc = it.value();
+        const timeval uptime = proc.procuptime();
+        const qreal now = uptime.tv_sec + uptime.tv_usec / 1000000.;
+        const qreal memory = qreal(proc.memory());
+
+        // first scan of the process, or the same uptime read twice
+        auto recent = getRecentProcStage(it.key(), proc.startTimeTicks()).lock();
+        qreal secs = recent ? now - (recent->uptime.tv_sec + recent->uptime.tv_usec / 1000000.) : 0;
+        if (!recent || secs <= 0) {
+            if (recent)
+                proc.setMemoryTrend(recent->memory_trend, recent->memory_leak_since, recent->memory_leak_base);
+            continue;
+        }
+
+        // irregular scan intervals weigh by the time they cover
+        qreal alpha = 1 - std::exp(-secs / kMemoryTrendWindow);
+        qreal trend = recent->memory_trend + alpha * ((memory - qreal(recent->memory)) / secs - recent->memory_trend);
+
+        // a run starts at the memory of the scan the trend rose, a single allocation grows nothing past it
+        qreal since = 0;
+        qulonglong base = 0;
+        if (trend >= kMemoryLeakMinRate) {
+            since = recent->memory_leak_since > 0 ? recent->memory_leak_since : now;
+            base = recent->memory_leak_since > 0 ? recent->memory_leak_base : proc.memory();
+        }
+        proc.setMemoryTrend(trend, since, base);
+        if (since <= 0) {
+            proc.setMemoryExhaustion(-1, false);
+            continue;
+        }
+
+        qreal headroom = available;
+        quint64 cgroupHeadroom = 0;
+        if (hasCgroups && common::cgroup::CgroupStats::memoryHeadroom(common::cgroup::CgroupStats::processCgroup(it.key()), cgroupHeadroom))
+            headroom = qMin(headroom, qreal(cgroupHeadroom / 1024));
+        bool leak = now - since >= kMemoryLeakWindow && proc.memory() >= base + kMemoryLeakMinGrowth;
+        proc.setMemoryExhaustion(headroom / trend, leak);
+    }
+}
+
+void ProcessSet::initEnergy()
+{
+    m_rapl.reset(new common::power::RaplReader());
+    // energy_uj is readable by root only, the system service reads it then
+    if (m_systemServiceClient) {
+        SystemServiceClient *client = m_systemServiceClient;
+        m_rapl->setCounterSource([client](common::power::rapl_sample_t &sample) {
+            QByteArray counters;
+            if (!client->getEnergyCounters(counters))
+                return false;
+            const energy_counter_record_t *records = nullptr;
+            const energy_counters_header_t *hdr = energyCounterRecords(counters.constData(), size_t(counters.size()), records);
+            sample.counters.clear();
+            for (uint32_t i = 0; i < hdr->count; ++i) {
+                const energy_counter_record_t &rec = records[i];
+                sample.counters.push_back({std::string(rec.name, strnlen(rec.name, sizeof(rec.name))),
+                                           rec.core != 0, rec.energy, rec.range});
+            }
+            sample.time = hdr->timestamp / 1e9;
+            return true;
+        });
+    }
+    if (!m_rapl->isAvailable()) {
+        qCInfo(app) << "No readable RAPL energy counters, process power is not estimated";
+        m_rapl.reset();
+    }
+}
+
+void ProcessSet::updateEnergy()
 {
-    qCDebug(app) << "Merging sub-process CPU for ppid" << ppid;
-    auto it = m_pidPtoCMapping.find(ppid);
-    while (it != m_pidPtoCMapping.end() && it.key() == ppid) {
-        mergeSubProcCpu(it.value(), cpu);
-        ++it;
+    common::power::rapl_power_t power;
+    if (!m_rapl || !m_rapl->read(power)) {
+        m_power = {};
+        return;
     }
 
-    const Process &proc = m_set[ppid];
-    cpu += proc.cpu();
+    m_power = power;
+    const qreal wattsPerPercent = power.package / 100;
+    for (auto it = m_set.begin(); it != m_set.end(); ++it)
+        it->setPower(it->cpu() * wattsPerPercent);
+}
+
+void ProcessSet::updateWakeups()
+{
+    QByteArray wakeups;
+    const bool demanded = core::system::DemandTracker::instance()->isDemanded(core::system::DemandTracker::kWakeupDemand);
+    if (!m_systemServiceClient || !demanded || !m_systemServiceClient->openWakeups()
+            || !m_systemServiceClient->getWakeups(wakeups)) {
+        if (m_systemServiceClient && !demanded)
+            m_systemServiceClient->closeWakeups();
+        m_wakeupCounts.clear();
+        m_wakeupRates.clear();
+        m_wakeupTime = 0;
+        return;
+    }
+
+    const wakeup_record_t *records = nullptr;
+    const wakeups_header_t *hdr = wakeupRecords(wakeups.constData(), size_t(wakeups.size()), records);
+    if (!hdr)
+        return;
+    // served from the cache of the server, the rates stay those of the previous read
+    if (hdr->timestamp > m_wakeupTime) {
+        const qreal secs = m_wakeupTime ? (hdr->timestamp - m_wakeupTime) / 1e9 : 0;
+        QHash<pid_t, wakeup_record_t> counts;
+        counts.reserve(int(hdr->count));
+        m_wakeupRates.clear();
+        for (uint32_t i = 0; i < hdr->count; ++i) {
+            const wakeup_record_t &rec = records[i];
+            counts.insert(pid_t(rec.pid), rec);
+            auto prev = m_wakeupCounts.constFind(pid_t(rec.pid));
+            if (secs <= 0 || prev == m_wakeupCounts.constEnd() || rec.wakeups < prev->wakeups)
+                continue;
+            m_wakeupRates.insert(pid_t(rec.pid), {(rec.wakeups - prev->wakeups) / secs,
+                                                  (rec.timer_wakeups - prev->timer_wakeups) / secs});
+        }
+        m_wakeupCounts.swap(counts);
+        m_wakeupTime = hdr->timestamp;
+    }
+
+    // no rates before the second read, processes missing from them weren't woken meanwhile
+    const qreal missing = m_wakeupRates.isEmpty() ? -1 : 0;
+    for (auto it = m_set.begin(); it != m_set.end(); ++it) {
+        const QPair<qreal, qreal> rates = m_wakeupRates.value(it.key(), {missing, missing});
+        it->setWakeups(rates.first, rates.second);
+    }
+}
+
+void ProcessSet::initGrouping()
+{
+    if (!m_config || m_config->value("process_grouping", "process_tree").toString() != "cgroup")
+        return;
+
+    if (!common::cgroup::CgroupStats::isAvailable()) {
+        qCInfo(app) << "No unified cgroup hierarchy, apps are grouped by process tree";
+        return;
+    }
+    qCInfo(app) << "Apps are grouped by cgroup";
+    m_grouping = kGroupByCgroup;
+    m_cgroupStats.reset(new common::cgroup::CgroupStats());
+}
+
+void ProcessSet::initSampling()
+{
+    int workers = 0;
+    if (m_config)
+        workers = m_config->value("process_sampling_workers", 0).toInt();
+    if (workers <= 0) {
+        // leave one core for the gui thread
+        workers = QThread::idealThreadCount() - 1;
+    }
+    m_samplingWorkers = qBound(1, workers, kMaxSamplingWorkers);
+
+    int shards = (m_samplingWorkers > 1) ? m_samplingWorkers * kSamplingShardsPerWorker : 1;
+    for (int i = 0; i < shards; ++i)
+        m_fdCaches.emplace_back(new ProcFdCache());
+
+    if (m_samplingWorkers > 1) {
+        m_parallelSampling = true;
+        TaskExecutor::instance()->setMaxThreadCount(TaskExecutor::kSamplingTask, m_samplingWorkers);
+    }
+    qCInfo(app) << "Process sampling workers:" << m_samplingWorkers << "fd cache shards:" << shards;
+}
+
+void ProcessSet::initPidEventSource()
+{
+    bool enabled = true;
+    if (m_config)
+        enabled = m_config->value("process_event_source", true).toBool();
+    if (!enabled) {
+        qCInfo(app) << "Process event source disabled in configuration";
+        return;
+    }
+
+    m_procConnector.reset(new core::system::ProcConnector());
+    if (!m_procConnector->isActive())
+        m_procConnector.reset();
+}
+
+void ProcessSet::initTaskStats()
+{
+    m_taskStats.reset(new core::system::TaskStats());
+    if (!m_taskStats->isActive())
+        m_taskStats.reset();
+}
+
+void ProcessSet::readTaskStats(QList<Process> &procs)
+{
+    if (!m_taskStats || procs.isEmpty())
+        return;
+
+    QList<pid_t> tgids;
+    tgids.reserve(procs.size());
+    for (const auto &proc : procs)
+        tgids << proc.pid();
+
+    QHash<pid_t, core::system::task_io_t> stats;
+    m_taskStats->query(tgids, stats);
+    for (auto &proc : procs) {
+        auto it = stats.constFind(proc.pid());
+        if (it != stats.constEnd())
+            proc.setTaskStats(it.value());
+    }
+    // permission dropped, e.g. capability removed at runtime
+    if (!m_taskStats->isActive())
+        m_taskStats.reset();
+}
+
+void ProcessSet::initTaskExitMonitor()
+{
+    m_taskExitMonitor.reset(new core::system::TaskExitMonitor());
+    if (!m_taskExitMonitor->isActive())
+        m_taskExitMonitor.reset();
+}
+
+void ProcessSet::readTaskExits()
+{
+    if (m_taskExitMonitor) {
+        QList<core::system::task_exit_t> exits;
+        if (!m_taskExitMonitor->poll(exits))
+            qCDebug(app) << "Taskstats exit records lost since last scan";
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        for (const auto &exit : exits)
+            m_exitedLog.add(exit, now);
+        m_exitedLog.expire(now);
+    }
+    // rolled up only when something exited or aged out, the snapshots share the last one meanwhile
+    if (m_exitedLog.generation() != m_exitedGeneration) {
+        m_exitedGeneration = m_exitedLog.generation();
+        m_exited = std::make_shared<const ExitedProcessRollups>(m_exitedLog.rollups());
+    }
+}
+
+void ProcessSet::collectPidList()
+{
+    PERF_TRACE_SCOPE(kStageDirScan);
+    bool rescan = true;
+    if (m_procConnector) {
+        // events lost or socket broken, rebuild from /proc
+        bool intact = m_procConnector->poll(m_livePids);
+        rescan = !intact || ++m_ticksSinceRescan >= kFullRescanTicks;
+        if (!m_procConnector->isActive()) {
+            qCInfo(app) << "Process event source went inactive, fall back to /proc scanning";
+            m_procConnector.reset();
+        }
+    }
+
+    m_pidList.clear();
+    if (!rescan) {
+        // live pid set is kept up to date by fork & exit events
+        m_pidList.reserve(m_livePids.size());
+        for (const pid_t &pid : m_livePids)
+            m_pidList.append(pid);
+        std::sort(m_pidList.begin(), m_pidList.end());
+        return;
+    }
+
+    Iterator iter;
+    m_pidList.reserve(m_prePid.size());
+    while (iter.hasNext()) {
+        m_pidList.append(iter.nextPid());
+    }
+
+    if (m_procConnector) {
+        m_livePids.clear();
+        m_livePids.reserve(m_pidList.size());
+        for (const pid_t &pid : m_pidList)
+            m_livePids.insert(pid);
+        m_ticksSinceRescan = 0;
+    }
+}
+
+ProcFdCache *ProcessSet::fdCacheOf(pid_t pid) const
+{
+    return m_fdCaches[size_t(pid) % m_fdCaches.size()].get();
+}
+
+void ProcessSet::readProcessesVariableInfo(QList<Process> &procs)
+{
+    PERF_TRACE_SCOPE(kStagePidRead);
+    // fd walks feed socket matching & fd columns only, skipped while no view shows them
+    const bool readFds = core::system::DemandTracker::instance()->isDemanded(core::system::DemandTracker::kProcessNetDemand);
+    // serial fallback for small machines or few processes
+    if (!m_parallelSampling || procs.size() < kParallelSamplingThreshold) {
+        for (auto &proc : procs)
+            proc.readProcessVariableStats(fdCacheOf(proc.pid()), readFds);
+        readTaskStats(procs);
+        for (auto &proc : procs)
+            proc.updateProcessVariableMetrics();
+        return;
+    }
+
+    // shard by pid, each shard is read by exactly one worker with its own fd cache,
+    // Process copies share private data, so results land in procs directly
+    std::vector<QList<Process>> shards(m_fdCaches.size());
+    for (const auto &proc : procs)
+        shards[size_t(proc.pid()) % shards.size()] << proc;
+
+    QList<QFuture<void>> futures;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        if (shards[i].isEmpty())
+            continue;
+
+        QList<Process> *shard = &shards[i];
+        ProcFdCache *fdCache = m_fdCaches[i].get();
+        futures << TaskExecutor::instance()->run(TaskExecutor::kSamplingTask, [shard, fdCache, readFds]() {
+            for (auto &proc : *shard)
+                proc.readProcessVariableStats(fdCache, readFds);
+        });
+    }
+    for (auto &future : futures)
+        future.waitForFinished();
+    readTaskStats(procs);
+
+    // name refresh & sample history updates touch shared caches, merge them serially
+    for (auto &proc : procs)
+        proc.updateProcessVariableMetrics();
 }
 
 void ProcessSet::refresh()
@@ -143,189 +570,299 @@ void ProcessSet::refresh()
     scanProcess();
 }
 
+void ProcessSet::updateHungTasks()
+{
+    QList<QPair<qreal, HungTaskSampler::task_t>> hung;
+    for (auto it = m_set.begin(); it != m_set.end(); ++it) {
+        Process &proc = it.value();
+        if (proc.state() != 'D')
+            continue;
+
+        // woken between two scans goes unnoticed, a hang is never woken
+        const timeval uptime = proc.procuptime();
+        const qreal now = uptime.tv_sec + uptime.tv_usec / 1000000.;
+        auto recent = getRecentProcStage(it.key(), proc.startTimeTicks()).lock();
+        const qreal since = recent && recent->blocked_since > 0 ? recent->blocked_since : now;
+        const bool isHung = now - since >= m_hungTaskWindow;
+        proc.setBlocked(since, isHung);
+        if (isHung)
+            hung.append({since, {it.key(), proc.startTimeTicks()}});
+    }
+
+    // longest blocked first, the sampler takes a bounded number
+    std::sort(hung.begin(), hung.end(), [](const QPair<qreal, HungTaskSampler::task_t> &a, const QPair<qreal, HungTaskSampler::task_t> &b) {
+        return a.first < b.first;
+    });
+    QList<HungTaskSampler::task_t> tasks;
+    tasks.reserve(hung.size());
+    for (const auto &task : hung)
+        tasks << task.second;
+    m_hungTasks->sample(tasks);
+
+    HungTaskSampler::hint_t hint;
+    for (const HungTaskSampler::task_t &task : tasks) {
+        if (m_hungTasks->lookup(task.pid, task.startTime, hint))
+            m_set[task.pid].setBlockingFunction(hint.function, hint.wait);
+    }
+}
+
 void ProcessSet::scanProcess()
 {
+    PERF_TRACE_SCOPE(kStageScan);
     QElapsedTimer timer;
     timer.start();
 
-    qCDebug(app) << "Scanning processes";
-    
-    if (m_useSystemService) {
-        qCDebug(app) << "Using DKapture enhanced scanning";
-    } else {
-        qCDebug(app) << "Using traditional /proc scanning";
-    }
-    
-    for (auto iter = m_set.begin(); iter != m_set.end(); iter++) {
-        qCDebug(app) << "Storing recent stage for pid" << iter->pid();
+    TRACE_LOG_DEBUG("Scanning processes using %s", m_useSystemService ? "DKapture enhanced scanning" : "traditional /proc scanning");
+
+    // m_set is shared with the published snapshot, read it without detaching
+    for (auto iter = m_set.cbegin(); iter != m_set.cend(); iter++) {
+        TRACE_LOG_TRACE("Storing recent stage for pid %d", iter->pid());
         std::shared_ptr<RecentProcStage> procstage = std::make_shared<RecentProcStage>();
+        procstage->start_time = iter->startTimeTicks();
         procstage->ptime = iter->utime() + iter->stime();
         procstage->read_bytes = iter->readBytes();
         procstage->write_bytes = iter->writeBytes();
         procstage->cancelled_write_bytes = iter->cancelledWriteBytes();
+        procstage->has_net_counters = iter->hasNetCounters();
+        procstage->net_rx_bytes = iter->netRxBytes();
+        procstage->net_tx_bytes = iter->netTxBytes();
+        procstage->memory = iter->memory();
+        procstage->wtime = iter->wtime();
+        procstage->gtime = iter->guestTime();
+        procstage->fd_count = iter->fdCount();
+        procstage->fd_growth_since = iter->fdGrowthSince();
+        procstage->fd_growth_base = iter->fdGrowthBase();
+        procstage->minflt = iter->minorFaults();
+        procstage->majflt = iter->majorFaults();
+        procstage->nvcsw = iter->voluntarySwitches();
+        procstage->nivcsw = iter->involuntarySwitches();
+        procstage->blkio_delay = iter->blkioDelay();
+        procstage->swapin_delay = iter->swapinDelay();
+        procstage->io_syscalls = iter->ioSyscalls();
+        procstage->tcp_retrans = iter->tcpRetrans();
+        procstage->tcp_segs_out = iter->tcpSegsOut();
+        procstage->memory_trend = iter->memoryTrend();
+        procstage->memory_leak_since = iter->memoryLeakSince();
+        procstage->memory_leak_base = iter->memoryLeakBase();
+        procstage->blocked_since = iter->blockedSince();
         procstage->uptime = iter->procuptime();
-        m_recentProcStage[iter->pid()] = procstage;
+        m_recentProcStage.insert(iter->pid(), procstage->start_time, procstage, sizeof(RecentProcStage));
     }
-    m_curPid.clear();
     m_set.clear();
-    m_pidPtoCMapping.clear();
-    m_pidCtoPMapping.clear();
+    m_cpuUsageTotal[0] = m_cpuUsageTotal[1];
+    m_cpuUsageTotal[1] = core::system::DeviceDB::instance()->cpuSet()->usageTotal();
     WMWindowList *wmwindowList = ProcessDB::instance()->windowList();
 
-    Iterator iter;
-    QList<pid_t> appLst;
-    while (iter.hasNext()) {
-        Process proc = iter.next();
+    collectPidList();
+    readTaskExits();
 
-        if(!m_curPid.contains(proc.pid())) {
-            qCDebug(app) << "Found process with pid" << proc.pid();
-            m_curPid.append(proc.pid());
-        }
+    m_pidDiff = diffPidSets(m_prePid, m_pidList);
 
-    }
+    if (m_pidDiff.changed()) {
+        TRACE_LOG_DEBUG("Process list changed, spawned: %d exited: %d", int(m_pidDiff.spawned.size()), int(m_pidDiff.exited.size()));
+        for (const pid_t &pid : m_pidDiff.exited)
+            forgetPid(pid);
 
-    if(m_prePid != m_curPid) {
-        qCDebug(app) << "Process list changed";
-        for (auto it = m_prePid.begin(); it != m_prePid.end();) {
-            if (!m_curPid.contains(*it)) {
-                // qCDebug(app) << "Removing obsolete pid" << *it;
-                if (m_simpleSet.contains(*it))
-                    m_simpleSet.remove(*it);
-                if (m_pidMyApps.contains(*it))
-                    m_pidMyApps.removeOne(*it);
-                it = m_prePid.erase(it);
-            } else {
-                ++it;
+        for (const pid_t &pid : m_pidDiff.spawned) {
+            Process proc = readSimpleProcess(pid);
+            // exited right after it was listed, dropped from this scan
+            if (proc.vanished()) {
+                ++m_vanishedCount;
+                continue;
+            }
+            // start time is 0 when stat is skipped, the first one read is adopted
+            m_simpleSet.insert(pid, proc.startTimeTicks(), proc);
+            m_prePid.insert(pid);
+
+            if (proc.appType() == kFilterApps) {
+                if (!wmwindowList->isTrayApp(pid)) {
+                    TRACE_LOG_DEBUG("Adding new app process to list: %d", pid);
+                    m_pidMyApps.insert(pid);
+                } else {
+                    TRACE_LOG_TRACE("Process %d is a tray app, not adding to applications list", pid);
+                }
             }
         }
+    }
 
-        for (const pid_t &pid : m_curPid) {
-            Process proc;
-            bool isNewProcess = !m_prePid.contains(pid);
+    // windows mapped or closed by running processes are picked up too
+    if (m_pidDiff.changed() || wmwindowList->windowsChanged()) {
+        for (const pid_t &pid : m_pidDiff.survived) {
+            Process *it = m_simpleSet.object(pid);
+            if (!it || it->appType() != kFilterCurrentUser)
+                continue;
 
-            if (isNewProcess) {
-                proc = Process(pid);
+            bool isGuiApp = wmwindowList->isGuiApp(pid);
+            bool isTrayApp = wmwindowList->isTrayApp(pid);
+            bool isDesktopEntryApp = wmwindowList->isDesktopEntryApp(pid);
 
-                // 优化：在DKapture模式下跳过stat读取，避免冗余读取/proc/[pid]/stat
-                if (m_useSystemService) {
-                    qCDebug(app) << "Using lightweight initialization for DKapture mode for pid" << pid;
-                    proc.readProcessSimpleInfo(true); // skipStatReading = true
-                } else {
-                    qCDebug(app) << "Using full initialization for traditional mode for pid" << pid;
-                    proc.readProcessSimpleInfo(false); // skipStatReading = false (默认值)
-                }
+            TRACE_LOG_TRACE("Reevaluating pid %d: isGuiApp=%d isTrayApp=%d isDesktopEntryApp=%d currently in m_pidMyApps: %d",
+                            pid, int(isGuiApp), int(isTrayApp), int(isDesktopEntryApp), int(m_pidMyApps.contains(pid)));
 
-                if(!m_simpleSet.contains(pid))
-                     m_simpleSet.insert(proc.pid(), proc);
-            } else {
-                proc = m_simpleSet.value(pid);
-            }
+            if (isGuiApp || isTrayApp || isDesktopEntryApp) {
+                TRACE_LOG_DEBUG("Process %d now has window, reclassifying as app", pid);
+                it->setAppType(kFilterApps);
 
-            if (proc.appType() == kFilterApps) {
-                bool isTrayApp = wmwindowList->isTrayApp(proc.pid());
-                if (!isTrayApp) {
-                    if (!m_pidMyApps.contains(proc.pid())) {
-                        qCDebug(app) << "Adding" << (isNewProcess ? "new" : "existing") << "app process to list:" << proc.pid();
-                        m_pidMyApps << proc.pid();
-                    }
-                } else {
-                    qCDebug(app) << "Process" << proc.pid() << "is a tray app, not adding to applications list";
-                }
-            }
-            else if (proc.appType() == kFilterCurrentUser) {
-                bool isGuiApp = wmwindowList->isGuiApp(proc.pid());
-                bool isTrayApp = wmwindowList->isTrayApp(proc.pid());
-                bool isDesktopEntryApp = wmwindowList->isDesktopEntryApp(proc.pid());
-
-                qCDebug(app) << "Reevaluating pid" << proc.pid() << ":"
-                             << "isGuiApp=" << isGuiApp
-                             << "isTrayApp=" << isTrayApp
-                             << "isDesktopEntryApp=" << isDesktopEntryApp
-                             << "currently in m_pidMyApps:" << m_pidMyApps.contains(proc.pid());
-
-                if (isGuiApp || isTrayApp || isDesktopEntryApp) {
-                    qCDebug(app) << "Process" << proc.pid() << "now has window, reclassifying as app";
-                    proc.setAppType(kFilterApps);
-                    if (!isNewProcess) {
-                        m_simpleSet.insert(pid, proc);
-                    }
-
-                    if (isTrayApp) {
-                        if (m_pidMyApps.contains(proc.pid())) {
-                            qCInfo(app) << "Removing tray app process from list:" << proc.pid();
-                            m_pidMyApps.removeOne(proc.pid());
-                        }
-                    } else {
-                        if (!m_pidMyApps.contains(proc.pid())) {
-                            qCInfo(app) << "Adding reevaluated app process to list:" << proc.pid();
-                            m_pidMyApps << proc.pid();
-                        }
-                    }
-                } else {
-                    if (m_pidMyApps.contains(proc.pid())) {
-                        qCInfo(app) << "Removing non-window process from applications list:" << proc.pid();
-                        m_pidMyApps.removeOne(proc.pid());
-                    }
+                if (isTrayApp) {
+                    if (m_pidMyApps.remove(pid))
+                        qCInfo(app) << "Removing tray app process from list:" << pid;
+                } else if (!m_pidMyApps.contains(pid)) {
+                    qCInfo(app) << "Adding reevaluated app process to list:" << pid;
+                    m_pidMyApps.insert(pid);
                 }
+            } else if (m_pidMyApps.remove(pid)) {
+                qCInfo(app) << "Removing non-window process from applications list:" << pid;
             }
         }
-        m_prePid = m_curPid;
     }
 
     // const QVariant &vindex = m_settings->getOption(kSettingKeyProcessTabIndex, kFilterApps);
     // int index = vindex.toInt();
 
-    // 尝试获取DKapture数据
+    // 尝试获取DKapture数据，优先读取共享内存快照，其次为上一次采样异步请求的增量更新、定长记录数组，旧版本服务回退到QVariantMap
     QVariantMap dkaptureData;
-    
-    if (m_useSystemService) {
-        QVariantMap response = m_systemServiceClient->getProcessInfoBatch(m_prePid);
-        if (response["success"].toBool()) {
-            dkaptureData = response["data"].toMap();
-            qCInfo(app) << "Successfully got DKapture data for" << dkaptureData.size() << "processes";
-        } else {
-            qCWarning(app) << "Failed to get DKapture data:" << response["error"].toString();
-            qCWarning(app) << "Falling back to traditional /proc scanning";
+    QByteArray dkaptureRecords;
+    QHash<pid_t, const process_info_record_t *> dkaptureRecordIndex;
+
+    PERF_TRACE_BEGIN(kStageDKapture);
+    if (m_useSystemService && m_systemServiceClient->readProcessInfoSnapshot(dkaptureRecords)) {
+        // 快照包含全部进程，快照之后新建的进程按传统方式读取
+        uint32_t count = 0;
+        const process_info_record_t *records = processInfoRecords(dkaptureRecords.constData(), size_t(dkaptureRecords.size()), count);
+        dkaptureRecordIndex.reserve(int(count));
+        for (uint32_t i = 0; i < count; ++i)
+            dkaptureRecordIndex.insert(records[i].pid, &records[i]);
+        TRACE_LOG_INFO("Successfully got DKapture snapshot for %u processes", count);
+    } else if (m_useSystemService) {
+        // 取回上一次采样发出的请求，未按时返回的本次直接读取 /proc
+        switch (m_systemServiceClient->takeProcessInfo(dkaptureRecords, dkaptureData)) {
+        case SystemServiceClient::kProcessInfoDeltaReply:
+            if (applyProcessInfoDelta(dkaptureRecords, m_dkaptureRecords, m_dkaptureGeneration)) {
+                dkaptureRecordIndex.reserve(m_dkaptureRecords.size());
+                for (auto it = m_dkaptureRecords.cbegin(); it != m_dkaptureRecords.cend(); ++it)
+                    dkaptureRecordIndex.insert(it.key(), &it.value());
+                TRACE_LOG_INFO("Successfully applied DKapture delta, generation %llu", static_cast<unsigned long long>(m_dkaptureGeneration));
+            }
+            break;
+        case SystemServiceClient::kProcessInfoRecordsReply: {
+            uint32_t count = 0;
+            const process_info_record_t *records = processInfoRecords(dkaptureRecords.constData(), size_t(dkaptureRecords.size()), count);
+            dkaptureRecordIndex.reserve(int(count));
+            for (uint32_t i = 0; i < count; ++i)
+                dkaptureRecordIndex.insert(records[i].pid, &records[i]);
+            TRACE_LOG_INFO("Successfully got DKapture records for %u processes", count);
+            break;
+        }
+        case SystemServiceClient::kProcessInfoBatchReply:
+            if (dkaptureData["success"].toBool()) {
+                dkaptureData = dkaptureData["data"].toMap();
+                TRACE_LOG_INFO("Successfully got DKapture data for %d processes", int(dkaptureData.size()));
+            } else {
+                qCWarning(app) << "Failed to get DKapture data:" << dkaptureData["error"].toString();
+                dkaptureData.clear();
+            }
+            break;
+        default:
+            TRACE_LOG_DEBUG("No DKapture data this tick, using traditional /proc scanning");
+            break;
         }
     }
+    if (m_useSystemService) {
+        // 合并本次数据的同时请求下一次采样的数据
+        m_systemServiceClient->requestProcessInfo(m_dkaptureGeneration, m_pidList);
+        PERF_TRACE_END(kStageDKapture);
+    }
     
     // 统一处理所有进程
-    for (const pid_t &pid : m_prePid) {
-        Process proc = m_simpleSet[pid];
-        
-        if (dkaptureData.contains(QString::number(pid))) {
+    QList<Process> procs;
+    QList<Process> pending;
+    bool kernelNetCounters = false;
+    procs.reserve(m_pidList.size());
+    for (const pid_t &pid : m_pidList) {
+        Process *simple = m_simpleSet.object(pid);
+        if (!simple) {
+            // evicted past kMaxCachedProcesses or gone when spawned, read once more
+            Process proc = readSimpleProcess(pid);
+            if (proc.vanished()) {
+                ++m_vanishedCount;
+                continue;
+            }
+            simple = m_simpleSet.insert(pid, proc.startTimeTicks(), proc);
+        }
+        Process proc = *simple;
+        procs << proc;
+
+        if (const process_info_record_t *rec = dkaptureRecordIndex.value(pid)) {
+            proc.applyDKaptureRecord(*rec);
+            kernelNetCounters = kernelNetCounters || proc.hasNetCounters();
+        } else if (dkaptureData.contains(QString::number(pid))) {
             // 使用DKapture数据
             QVariantMap pidData = dkaptureData[QString::number(pid)].toMap();
-            qCDebug(app) << "Applying DKapture data to process" << pid;
+            TRACE_LOG_TRACE("Applying DKapture data to process %d", pid);
             proc.applyDKaptureData(pidData);
+            kernelNetCounters = kernelNetCounters || proc.hasNetCounters();
         } else {
             // 使用传统方式（包括DKapture获取失败或没有该进程数据的情况）
-            qCDebug(app) << "Using traditional /proc reading for process" << pid;
-            proc.readProcessVariableInfo();
+            TRACE_LOG_TRACE("Using traditional /proc reading for process %d", pid);
+            pending << proc;
         }
+    }
+    readProcessesVariableInfo(pending);
+    m_kernelNetCounters = kernelNetCounters;
 
+    // merge sampled processes in one step
+    PERF_TRACE_BEGIN(kStageMerge);
+    quint32 nthreads = 0;
+    QHash<QString, ContainerUsage> containers;
+    for (const Process &proc : procs) {
         if (!proc.isValid()) {
-            qCWarning(app) << "Process" << pid << "invalid application, skipping";
+            if (proc.vanished())
+                ++m_vanishedCount;
+            else
+                qCWarning(app) << "Process" << proc.pid() << "invalid application, skipping";
+            m_tree.remove(proc.pid());
+            continue;
+        }
+
+        // pid exited & was taken by a new process between two scans, what was read once
+        // belongs to the exited one, the new one is picked up as spawned by next scan
+        if (!m_simpleSet.object(proc.pid(), proc.startTimeTicks())) {
+            TRACE_LOG_DEBUG("Pid %d was reused since last scan, skipping", proc.pid());
+            forgetPid(proc.pid());
             continue;
         }
 
+        nthreads += proc.nthreads();
         m_set.insert(proc.pid(), proc);
-        m_pidPtoCMapping.insert(proc.ppid(), proc.pid());
-        m_pidCtoPMapping.insert(proc.pid(), proc.ppid());
+        // links only change for spawned & reparented processes
+        m_tree.insert(proc.pid(), proc.ppid());
+        m_tree.setUsage(proc.pid(), {proc.cpu(), proc.memory(), proc.recvBps(), proc.sentBps(), 1});
+
+        const container_t &container = containerOf(proc);
+        ContainerUsage &usage = containers[container.key];
+        usage.identity = container.identity;
+        usage.cpu += proc.cpu();
+        usage.memory += proc.memory();
+        usage.readBps += proc.readBps();
+        usage.writeBps += proc.writeBps();
+        usage.recvBps += proc.recvBps();
+        usage.sentBps += proc.sentBps();
+        usage.pids << proc.pid();
     }
+    // own usage before apps take their descendants' below
+    m_tree.accumulate();
+    ContainerUsages containerUsages = containers.values();
+    std::sort(containerUsages.begin(), containerUsages.end(), [](const ContainerUsage &a, const ContainerUsage &b) {
+        if (a.identity.isHost() != b.identity.isHost())
+            return b.identity.isHost();
+        return a.cpu > b.cpu;
+    });
+    m_containerUsages = std::make_shared<const ContainerUsages>(std::move(containerUsages));
 
-    std::function<bool(pid_t ppid)> anyRootIsGuiProc;
-    // find if any ancestor processes is gui application
-    anyRootIsGuiProc = [&](pid_t ppid) -> bool {
-        bool b;
-        b = wmwindowList->isGuiApp(ppid);
-        if (!b && m_pidCtoPMapping.contains(ppid))
-        {
-            qCDebug(app) << "Recursively checking for GUI ancestor for ppid" << ppid;
-            b = anyRootIsGuiProc(m_pidCtoPMapping[ppid]);
-        }
-        return b;
-    };
+    // In DKapture mode, each subprocess is displayed separately, so no need to merge CPU
+    QSet<pid_t> cgroupApps;
+    if (!m_useSystemService)
+        cgroupApps = mergeAppCgroups();
 
     for (const pid_t &pid : m_pidMyApps) {
         // qCDebug(app) << "Merging stats for my app with pid" << pid;
@@ -334,41 +871,35 @@ void ProcessSet::scanProcess()
         mergeSubProcNetIO(pid, recvBps, sendBps);
         m_set[pid].setNetIoBps(recvBps, sendBps);
 
-        // In DKapture mode, each subprocess is displayed separately, so no need to merge CPU
-        if (!m_useSystemService) {
+        if (cgroupApps.contains(pid)) {
+            TRACE_LOG_TRACE("Cgroup mode: CPU of PID %d read from its cgroup: %f", pid, m_set[pid].cpu());
+        } else if (!m_useSystemService) {
             qreal ptotalCpu = 0.;
             mergeSubProcCpu(pid, ptotalCpu);
             m_set[pid].setCpu(ptotalCpu);
-            qCDebug(app) << "Traditional mode: merged CPU for PID" << pid << "total:" << ptotalCpu;
+            TRACE_LOG_TRACE("Traditional mode: merged CPU for PID %d total: %f", pid, ptotalCpu);
         } else {
-            qCDebug(app) << "DKapture mode: skipping CPU merge for PID" << pid << "current CPU:" << m_set[pid].cpu();
+            TRACE_LOG_TRACE("DKapture mode: skipping CPU merge for PID %d current CPU: %f", pid, m_set[pid].cpu());
         }
 
         if (!wmwindowList->isGuiApp(pid))
         {
-            qCDebug(app) << "Process is not a GUI app, checking for GUI ancestor. Pid:" << pid;
+            TRACE_LOG_TRACE("Process is not a GUI app, checking for GUI ancestor. Pid: %d", pid);
             // only if no ancestor process is gui app we keep this process
-            if (m_pidCtoPMapping.contains(pid) &&
-                    anyRootIsGuiProc(m_pidCtoPMapping[pid])) {
-                qCDebug(app) << "Found GUI ancestor for pid" << pid;
+            if (m_tree.anyAncestor(pid, [wmwindowList](pid_t ppid) { return wmwindowList->isGuiApp(ppid); })) {
+                TRACE_LOG_TRACE("Found GUI ancestor for pid %d", pid);
 
+                // sandboxed apps (linglong, flatpak) report window pids of their own pid namespace,
+                // the app isn't among the gui apps then & must not be taken for a child of its launcher
+                if (containerOf(m_set[pid]).identity.isSandboxed()) {
+                    TRACE_LOG_TRACE("Sandboxed app, skipping app type change for pid %d", pid);
+                    continue;
+                }
                 // when we start app with deepin-terminal, we should skip setting apptype as CurrentUser
-                const Process parentProc = getProcessById(m_pidCtoPMapping[pid]);
-                QString parentCmdLineString = parentProc.cmdlineString();
-
-                /* 通过窗管接口获取到玲珑版本浏览器，wid 对应的 pid
-                 * 与玲珑浏览器本身的 pid 不一致，GuiApps 变量里
-                 * 没有该浏览器进程，因此进入到了这段代码被覆写了 appType 变量。
-                 * 而这段代码本身用于对“应用列表”内的浏览器进程进行去重，
-                 * 下面的代码原本条件是 ==，用于处理另一个 Bug
-                 * https://pms.uniontech.com/zentao/bug-view-82161.html
-                 * 此处兼容沿用该代码，放宽一点判定条件，改为 contains
-                 * 进行判定。玲珑应用也是通过 /bin/bash 启动的，因此需要
-                 * 兼容。
-                 */
-                if (parentCmdLineString.contains(QString("/bin/bash"))) {
-                  qCDebug(app) << "Parent process is bash, skipping app type change for pid" << pid;
-                  continue;
+                // https://pms.uniontech.com/zentao/bug-view-82161.html
+                if (m_set.value(m_tree.parentOf(pid)).isBareShell()) {
+                    TRACE_LOG_TRACE("Parent process is bash, skipping app type change for pid %d", pid);
+                    continue;
                 }
 
                 m_set[pid].setAppType(kFilterCurrentUser);
@@ -377,12 +908,74 @@ void ProcessSet::scanProcess()
         }
     }
 
+    PERF_TRACE_END(kStageMerge);
+
+    // smaps_rollup is read a few processes per scan, the others keep their cached figures
+    ProcessSmapsCache *smapsCache = ProcessSmapsCache::instance();
+    if (smapsCache->isEnabled()) {
+        smapsCache->refresh(m_set);
+        smaps_t smaps;
+        for (auto it = m_set.begin(); it != m_set.end(); ++it) {
+            if (smapsCache->lookup(it.key(), it->startTimeTicks(), smaps))
+                it->setSmaps(smaps.pss, smaps.uss, smaps.swap);
+        }
+    }
+
+    // drm fdinfo of the few processes holding gpu fds, only while the gpu columns are shown
+    ProcessGpuCache *gpuCache = ProcessGpuCache::instance();
+    if (gpuCache->isEnabled()) {
+        gpuCache->refresh(m_set);
+        gpu_usage_t gpu;
+        for (auto it = m_set.begin(); it != m_set.end(); ++it) {
+            if (!it->drmFds().isEmpty() && gpuCache->lookup(it.key(), it->startTimeTicks(), gpu))
+                it->setGpu(gpu.usage, gpu.memory);
+        }
+    }
+
+    updateMemoryTrends();
+    updateEnergy();
+    updateWakeups();
+    updateHungTasks();
+
     m_recentProcStage.clear();
+    publishSnapshot();
+    // names & cmdline tokens of exited processes, once the views dropped them too
+    if (!m_pidDiff.exited.isEmpty())
+        common::intern::StringPool::instance()->prune();
+
+    // system wide counts fall out of the scan, no need to walk /proc & every task dir again
+    core::system::SysInfo *sysInfo = core::system::SysInfo::instance();
+    if (sysInfo) {
+        sysInfo->set_nprocesses(quint32(m_set.size()));
+        sysInfo->set_nthreads(nthreads);
+    }
 
     // 性能统计
-    qint64 elapsed = timer.elapsed();
-    QString mode = m_useSystemService ? "DKapture" : "Traditional";
-    qCInfo(app) << QString("OK! scanProcess completed in %1ms using %2 mode").arg(elapsed).arg(mode);
+    TRACE_LOG_INFO("OK! scanProcess completed in %lldms using %s mode", static_cast<long long>(timer.elapsed()),
+                   m_useSystemService ? "DKapture" : "Traditional");
+}
+
+PidSetDiff ProcessSet::diffPidSets(const QSet<pid_t> &prev, const QList<pid_t> &cur)
+{
+    PidSetDiff diff {};
+    QSet<pid_t> curSet;
+    curSet.reserve(cur.size());
+
+    for (const pid_t &pid : cur) {
+        curSet.insert(pid);
+
+        if (prev.contains(pid))
+            diff.survived << pid;
+        else
+            diff.spawned << pid;
+    }
+
+    for (const pid_t &pid : prev) {
+        if (!curSet.contains(pid))
+            diff.exited << pid;
+    }
+
+    return diff;
 }
 
 ProcessSet::Iterator::Iterator()
@@ -419,9 +1012,21 @@ Process ProcessSet::Iterator::next()
     return Process();
 }
 
+pid_t ProcessSet::Iterator::nextPid()
+{
+    pid_t pid = 0;
+    if (m_dirent && isdigit(m_dirent->d_name[0])) {
+        pid = pid_t(atoi(m_dirent->d_name));
+        advance();
+    }
+
+    return pid;
+}
+
 void ProcessSet::Iterator::advance()
 {
     while ((m_dirent = readdir(m_dir.get()))) {
+        PERF_TRACE_COUNT(kCounterReadDir, 1);
         if (isdigit(m_dirent->d_name[0]))
         if(pid_t(atoi(m_dirent->d_name)) < 10)
                 continue;
@@ -434,52 +1039,219 @@ void ProcessSet::Iterator::advance()
     }
 }
 
-std::weak_ptr<RecentProcStage> ProcessSet::getRecentProcStage(pid_t pid) const
+std::weak_ptr<RecentProcStage> ProcessSet::getRecentProcStage(pid_t pid, qulonglong startTime) const
 {
-    return m_recentProcStage[pid];
+    const std::shared_ptr<RecentProcStage> *stage = m_recentProcStage.peek(pid, startTime);
+    return stage ? *stage : std::weak_ptr<RecentProcStage>();
+}
+
+void ProcessSet::logCacheStats() const
+{
+    qCDebug(app) << "Process caches, simple set:" << m_simpleSet.stats()
+                 << "recent stage:" << m_recentProcStage.stats()
+                 << "containers:" << m_containers.stats()
+                 << "environ:" << ProcessEnvironCache::instance()->stats()
+                 << "name:" << ProcessNameCache::instance()->stats()
+                 << "smaps:" << ProcessSmapsCache::instance()->stats()
+                 << "gpu:" << ProcessGpuCache::instance()->stats()
+                 << "interned strings:" << common::intern::StringPool::instance()->size()
+                 << "vanished pids:" << m_vanishedCount;
+}
+
+Process ProcessSet::readSimpleProcess(pid_t pid) const
+{
+    PERF_TRACE_SCOPE(kStagePidRead);
+    Process proc(pid);
+
+    // 优化：在DKapture模式下跳过stat读取，避免冗余读取/proc/[pid]/stat
+    if (m_useSystemService) {
+        TRACE_LOG_TRACE("Using lightweight initialization for DKapture mode for pid %d", pid);
+        proc.readProcessSimpleInfo(true); // skipStatReading = true
+    } else {
+        TRACE_LOG_TRACE("Using full initialization for traditional mode for pid %d", pid);
+        proc.readProcessSimpleInfo(false); // skipStatReading = false (默认值)
+    }
+    return proc;
+}
+
+const ProcessSet::container_t &ProcessSet::containerOf(const Process &proc)
+{
+    container_t *container = m_containers.object(proc.pid(), proc.startTimeTicks());
+    if (!container) {
+        container_t read;
+        read.identity = ContainerIdentity::read(proc.pid(), m_hostPidNamespace);
+        read.key = read.identity.key();
+        container = m_containers.insert(proc.pid(), proc.startTimeTicks(), read);
+    }
+    return *container;
+}
+
+void ProcessSet::forgetPid(pid_t pid)
+{
+    m_simpleSet.remove(pid);
+    m_pidMyApps.remove(pid);
+    m_prePid.remove(pid);
+    m_tree.remove(pid);
+    m_containers.remove(pid);
+    fdCacheOf(pid)->release(pid);
+    ProcessEnvironCache::instance()->remove(pid);
+    ProcessNameCache::instance()->remove(pid);
+    ProcessSmapsCache::instance()->remove(pid);
+    ProcessGpuCache::instance()->remove(pid);
+    // desktop entry apps are kept across window list refreshes, pids may be reused
+    ProcessDB::instance()->windowList()->removeDesktopEntryApp(pid);
+}
+
+void ProcessSet::publishSnapshot()
+{
+    // scanned processes share their data with m_simpleSet, which next scan writes again
+    for (auto it = m_set.begin(); it != m_set.end(); ++it)
+        *it = it->detached();
+
+    auto next = std::make_shared<ProcessSnapshot>();
+    next->generation = snapshot()->generation + 1;
+    next->processes = m_set;
+    next->pids = m_set.keys();
+    next->tree = m_tree;
+    next->exited = m_exited;
+    next->containers = m_containerUsages;
+    next->exitsRecorded = m_taskExitMonitor != nullptr;
+    next->columns = std::make_shared<const ProcessColumns>(m_set);
+    next->packagePower = m_power.package;
+    next->corePower = m_power.core;
+    std::atomic_store(&m_snapshot, ProcessSnapshotPtr(std::move(next)));
+}
+
+void ProcessSet::updateSnapshot(const std::function<void(ProcessSnapshot &)> &change)
+{
+    // a scan published meanwhile is changed again rather than overwritten
+    ProcessSnapshotPtr current = snapshot();
+    ProcessSnapshotPtr next;
+    do {
+        auto copy = std::make_shared<ProcessSnapshot>(*current);
+        change(*copy);
+        next = std::move(copy);
+    } while (!std::atomic_compare_exchange_weak(&m_snapshot, &current, next));
+}
+
+ProcessSnapshotPtr ProcessSet::snapshot() const
+{
+    return std::atomic_load(&m_snapshot);
+}
+
+const PidSetDiff &ProcessSet::pidSetDiff() const
+{
+    return m_pidDiff;
+}
+
+bool ProcessSet::applyProcessInfoDelta(const QByteArray &delta, QHash<pid_t, process_info_record_t> &records, quint64 &generation)
+{
+    const process_info_record_t *changed = nullptr;
+    const int32_t *exited = nullptr;
+    const process_info_delta_header_t *hdr = processInfoDelta(delta.constData(), size_t(delta.size()), changed, exited);
+    const bool baseline = hdr && (hdr->flags & kProcessInfoDeltaBaseline);
+    if (!hdr || (!baseline && hdr->generation != generation + 1)) {
+        // 下次请求时服务端重发全部进程
+        qCWarning(app) << "Unexpected process info delta, requesting baseline";
+        records.clear();
+        generation = 0;
+        return false;
+    }
+
+    if (baseline) {
+        records.clear();
+        records.reserve(int(hdr->count));
+    }
+    for (uint32_t i = 0; i < hdr->count; ++i)
+        records.insert(changed[i].pid, changed[i]);
+    for (uint32_t i = 0; i < hdr->exited; ++i)
+        records.remove(exited[i]);
+    generation = hdr->generation;
+    return true;
+}
+
+quint64 ProcessSet::vanishedCount() const
+{
+    return m_vanishedCount;
+}
+
+bool ProcessSet::hasKernelNetCounters() const
+{
+    return m_kernelNetCounters;
+}
+
+bool ProcessSet::netTrafficSampled() const
+{
+    return m_netTrafficSampled;
+}
+
+void ProcessSet::setNetTrafficSampled(bool sampled)
+{
+    m_netTrafficSampled = sampled;
+}
+
+qulonglong ProcessSet::cpuUsageTotalDelta() const
+{
+    if (m_cpuUsageTotal[1] <= m_cpuUsageTotal[0])
+        return 1;
+
+    return m_cpuUsageTotal[1] - m_cpuUsageTotal[0];
 }
 
 const Process ProcessSet::getProcessById(pid_t pid) const
 {
-    return m_set[pid];
+    return snapshot()->processes.value(pid);
+}
+
+QList<pid_t> ProcessSet::getProcessTree(pid_t pid) const
+{
+    return snapshot()->tree.subtree(pid);
 }
 
 QList<pid_t> ProcessSet::getPIDList() const
 {
-    // 当系统读取到的m_set为空时,通过keys()函数返回会造成段错误 原因是keys函数效率低下,会造成大量的内存拷贝
-    // 替换方案是
     qCDebug(app) << "Getting PID list";
-    QList<pid_t> pidList {};
-    pidList.clear();
-    int size = m_set.size();
-    QMap<pid_t, Process>::key_iterator iterBegin = m_set.keyBegin();
-    for (;iterBegin != m_set.keyEnd(); ++iterBegin) {
-        pid_t tmpKey = *iterBegin;
-        pidList.append(tmpKey);
-        if (size != m_set.size())
-            break;
-    }
-    return pidList;
+    return snapshot()->pids;
 }
 
 void ProcessSet::removeProcess(pid_t pid)
 {
     // qCDebug(app) << "Removing process with pid" << pid;
-    m_set.remove(pid);
+    if (!snapshot()->processes.contains(pid))
+        return;
+    updateSnapshot([pid](ProcessSnapshot &next) {
+        if (next.processes.remove(pid))
+            next.pids.removeOne(pid);
+    });
 }
 
 void ProcessSet::updateProcessState(pid_t pid, char state)
 {
     qCDebug(app) << "Updating process state for pid" << pid << "to" << state;
-    if (m_set.contains(pid))
-        m_set[pid].setState(state);
+    if (!snapshot()->processes.contains(pid))
+        return;
+    updateSnapshot([pid, state](ProcessSnapshot &next) {
+        auto it = next.processes.find(pid);
+        if (it == next.processes.end())
+            return;
+        // still shared with the previous generation
+        *it = it->detached();
+        it->setState(state);
+    });
 }
 
 void ProcessSet::updateProcessPriority(pid_t pid, int priority)
 {
     qCDebug(app) << "Updating process priority for pid" << pid << "to" << priority;
-    if (m_set.contains(pid))
-        m_set[pid].setPriority(priority);
+    if (!snapshot()->processes.contains(pid))
+        return;
+    updateSnapshot([pid, priority](ProcessSnapshot &next) {
+        auto it = next.processes.find(pid);
+        if (it == next.processes.end())
+            return;
+        *it = it->detached();
+        it->setPriority(priority);
+    });
 }
 
 
@@ -7,13 +7,37 @@
 #define PROCESS_SET_H
 
 #include "process.h"
+#include "process_cache.h"
+#include "process_columns.h"
+#include "process_tree.h"
+#include "exited_process_log.h"
+#include "container_identity.h"
+#include "proc_fd_cache.h"
+#include "hung_task_sampler.h"
 #include "common/common.h"
+#include "common/cgroup_stats.h"
+#include "common/rapl_reader.h"
+#include "process_info_record.h"
 
+#include <QHash>
 #include <QMap>
+#include <QSet>
 #include <DConfig>
 
+#include <functional>
+#include <memory>
+#include <vector>
+
 #include <dirent.h>
 
+namespace core {
+namespace system {
+class ProcConnector;
+class TaskStats;
+class TaskExitMonitor;
+}
+}
+
 using namespace common::alloc;
 
 // class Settings;
@@ -27,14 +51,92 @@ enum FilterType { kFilterApps,
                   kNoFilter
                 };
 
+/**
+ * @brief Whether a process of \a appType is listed in the tab of \a filterType: applications,
+ * my processes (applications included) or all processes
+ */
+inline bool isShownIn(int filterType, int appType)
+{
+    return filterType == kNoFilter || appType == kFilterApps
+           || (filterType == kFilterCurrentUser && appType == kFilterCurrentUser);
+}
+
 struct RecentProcStage {
+    qulonglong start_time = 0; // clock ticks since boot, tells a reused pid apart
     qulonglong ptime = 0;
     qulonglong read_bytes = 0; // disk read bytes
     qulonglong write_bytes = 0; // disk write bytes
     qulonglong cancelled_write_bytes = 0;
+    bool has_net_counters = false;
+    qulonglong net_rx_bytes = 0; // kernel accounted traffic, see Process::hasNetCounters
+    qulonglong net_tx_bytes = 0;
+    qulonglong memory = 0; // resident memory in kB, see Process::memory
+    qulonglong wtime = 0; // run queue wait in clock ticks
+    qulonglong gtime = 0; // guest time in clock ticks
+    int fd_count = -1; // open fds, -1 if unknown
+    qreal fd_growth_since = 0; // see Process::fdGrowthSince
+    int fd_growth_base = 0;
+    qulonglong minflt = 0; // page fault & context switch counters
+    qulonglong majflt = 0;
+    qulonglong nvcsw = 0;
+    qulonglong nivcsw = 0;
+    qulonglong blkio_delay = 0; // delay accounting, see Process::ioWait
+    qulonglong swapin_delay = 0;
+    qulonglong io_syscalls = 0;
+    qulonglong tcp_retrans = 0; // tcp segments, see Process::tcpRetransRate
+    qulonglong tcp_segs_out = 0;
+    qreal memory_trend = 0; // see Process::memoryTrend
+    qreal memory_leak_since = 0;
+    qulonglong memory_leak_base = 0;
+    qreal blocked_since = 0; // see Process::blockedSince
     timeval uptime = {0, 0};
 };
 
+/**
+ * @brief How descendants of the apps listed are accounted to them
+ */
+enum ProcessGrouping {
+    kGroupByProcessTree, // sum descendants found through parent pids
+    kGroupByCgroup // read the app's own cgroup (unit, app scope, container), falls back to the tree
+};
+
+/**
+ * @brief Pid changes between two consecutive scans
+ */
+struct PidSetDiff {
+    QList<pid_t> spawned; // pids appeared since last scan
+    QList<pid_t> exited; // pids gone since last scan
+    QList<pid_t> survived; // pids present in both scans
+
+    inline bool changed() const
+    {
+        return !spawned.isEmpty() || !exited.isEmpty();
+    }
+};
+
+/**
+ * @brief Result of one scan, never changed once published
+ *
+ * The scanner publishes a new generation atomically, readers on any thread hold the pointer
+ * for as long as they need a consistent view, lookups & the pid list then come from the same scan.
+ */
+struct ProcessSnapshot {
+    quint64 generation = 0; // scans published so far
+    QMap<pid_t, Process> processes; // detached from the scanner's processes
+    QList<pid_t> pids; // keys of processes, ascending
+    ProcessTree tree; // parent & child links, subtree usage summed
+    ProcessColumnsPtr columns {std::make_shared<const ProcessColumns>()};
+    // tasks exited recently by command name, shared until they change
+    ExitedProcessRollupsPtr exited {std::make_shared<const ExitedProcessRollups>()};
+    bool exitsRecorded = false; // whether taskstats exit records are permitted
+    // own usage summed by container & app, most cpu first, host processes last
+    ContainerUsagesPtr containers {std::make_shared<const ContainerUsages>()};
+    // RAPL power of the last interval in W, -1 unknown, see ProcessSet::updateEnergy
+    qreal packagePower = -1;
+    qreal corePower = -1;
+};
+using ProcessSnapshotPtr = std::shared_ptr<const ProcessSnapshot>;
+
 // Forward declaration
 class Process;
 
@@ -45,19 +147,210 @@ public:
     ProcessSet(const ProcessSet &other);
     ~ProcessSet();
 
+    /**
+     * @brief Last published scan, safe to call from any thread
+     */
+    ProcessSnapshotPtr snapshot() const;
+    /**
+     * @brief Lookups in the last published scan, hold snapshot() instead for several related lookups
+     */
     const Process getProcessById(pid_t pid) const;
     QList<pid_t> getPIDList() const;
+    /**
+     * @brief Pid with all its descendants found through parent pids, parents before their children
+     */
+    QList<pid_t> getProcessTree(pid_t pid) const;
+    /**
+     * @brief Publish a copy of the last scan with one process changed, until next scan replaces it
+     */
     void removeProcess(pid_t pid);
     void updateProcessState(pid_t pid, char state);
     void updateProcessPriority(pid_t pid, int priority);
-    std::weak_ptr<RecentProcStage> getRecentProcStage(pid_t pid) const;
+    /**
+     * @brief Counters of the process at last scan, empty if pid was taken by another process since
+     *
+     * Only valid during a scan, on the monitor thread.
+     */
+    std::weak_ptr<RecentProcStage> getRecentProcStage(pid_t pid, qulonglong startTime) const;
+    const PidSetDiff &pidSetDiff() const;
+    inline ProcessGrouping grouping() const
+    {
+        return m_grouping;
+    }
+    /**
+     * @brief Total cpu time elapsed between the last two process scans
+     *
+     * Cpu stats are refreshed on their own cadence, so process cpu usage is relative to
+     * the totals sampled at scan time instead of the last two cpu stat reads.
+     */
+    qulonglong cpuUsageTotalDelta() const;
+    /**
+     * @brief Columnar snapshot of last scan, for sums & top-K without copying every Process
+     *
+     * Later state & priority updates of single processes are not reflected until next scan.
+     */
+    inline ProcessColumnsPtr columns() const
+    {
+        return snapshot()->columns;
+    }
+    /**
+     * @brief Whether last scan got per process traffic from kernel accounting (DKapture)
+     *
+     * Packet capture & socket inode mapping are not needed then.
+     */
+    bool hasKernelNetCounters() const;
+    /**
+     * @brief Pids that exited between listing & reading since start, dropped from their scan without logging
+     */
+    quint64 vanishedCount() const;
+    /**
+     * @brief Whether per process traffic of last scan was estimated from sampled packets
+     */
+    bool netTrafficSampled() const;
+    void setNetTrafficSampled(bool sampled);
+    /**
+     * @brief Seconds the fd count of a process must grow without dropping to be flagged as leaking
+     *
+     * From fd_leak_window_minutes of DConfig, see Process::fdLeakSuspected
+     */
+    inline qreal fdLeakWindow() const
+    {
+        return m_fdLeakWindow;
+    }
+    /**
+     * @brief Seconds a process must stay in uninterruptible sleep across scans to be flagged as hung
+     *
+     * From hung_task_seconds of DConfig, see Process::hangSuspected
+     */
+    inline qreal hungTaskWindow() const
+    {
+        return m_hungTaskWindow;
+    }
+    // fds a process must have grown by over the window to be flagged
+    static constexpr int kFdLeakMinGrowth = 16;
+    // s memory growth is smoothed over, a spike decays to a third of its rate in that time
+    static constexpr int kMemoryTrendWindow = 10 * 60;
+    // kB/s the trend must stay above for a process to count as growing, ~3.5 MB an hour
+    static constexpr qreal kMemoryLeakMinRate = 1;
+    // s a process must keep growing to be flagged as leaking
+    static constexpr int kMemoryLeakWindow = 30 * 60;
+    // kB a process must have grown by over its run to be flagged
+    static constexpr qulonglong kMemoryLeakMinGrowth = 64 * 1024;
 
     void refresh();
+    /**
+     * @brief Log usage of per process caches, for debugging memory growth on busy hosts
+     */
+    void logCacheStats() const;
+
+    /**
+     * @brief Diff current pid list against previous pid set in O(n)
+     * @param prev Pid set of previous scan
+     * @param cur Pid list of current scan
+     * @return Spawned, exited & survived pids
+     */
+    static PidSetDiff diffPidSets(const QSet<pid_t> &prev, const QList<pid_t> &cur);
+    /**
+     * @brief Apply a getProcessInfoDelta reply in place to the records of previous replies
+     * @param delta Reply of SystemServiceClient::getProcessInfoDelta
+     * @param records Records of all processes, by pid
+     * @param generation Generation of \a records, updated to the one of \a delta
+     * @return false if \a delta is malformed or does not follow \a generation, \a records
+     * are dropped then & generation reset so that the server resends a baseline
+     */
+    static bool applyProcessInfoDelta(const QByteArray &delta, QHash<pid_t, process_info_record_t> &records, quint64 &generation);
 
 private:
+    struct container_t {
+        ContainerIdentity identity;
+        QString key; // see ContainerIdentity::key
+    };
+
     void scanProcess();
+    /**
+     * @brief Add traffic & cpu of \a ppid & its descendants, summed by the process tree at this scan
+     */
     void mergeSubProcNetIO(pid_t ppid, qreal &recvBps, qreal &sendBps);
     void mergeSubProcCpu(pid_t ppid, qreal &cpu);
+    /**
+     * @brief Take cpu & memory of apps from their own cgroups, in kGroupByCgroup mode
+     *
+     * The kernel accounts everything in the cgroup, reparented & container processes included,
+     * so no walk over descendants is needed. A cgroup shared by several apps, e.g. the login
+     * session, tells them apart no better than the process tree & is left to it.
+     * @return Apps accounted, cpu of the others is summed through the process tree
+     */
+    QSet<pid_t> mergeAppCgroups();
+    /**
+     * @brief Whether a cgroup may be owned by a single app, login sessions & the init scope are not
+     */
+    static bool isAppCgroup(const QString &cgroup);
+    /**
+     * @brief Carry the memory trend of each process on by one scan & estimate when it runs out
+     *
+     * O(1) per process: an exponentially weighted average of the growth rate, no history is
+     * kept. Headroom is MemAvailable, or what's left under the tightest cgroup memory.max for
+     * processes that keep growing, only those have their cgroup read.
+     */
+    void updateMemoryTrends();
+    void initEnergy();
+    /**
+     * @brief Split the package power of the last interval over processes by cpu time
+     *
+     * cpu() is the share of all cpu time, so a process gets that share of the package power &
+     * idle time keeps the rest, one multiply per process. Power stays unknown (-1) without RAPL.
+     */
+    void updateEnergy();
+    /**
+     * @brief Wakeup rates of the processes from the kernel counts of the system server, only
+     * while demanded, Process::wakeupRate falls back to voluntary context switches otherwise
+     */
+    void updateWakeups();
+    /**
+     * @brief Carry on since when processes are in D state, the state letter of stat only, & sample
+     * the kernel stacks of the ones blocked for hungTaskWindow
+     */
+    void updateHungTasks();
+    void initSampling();
+    void initGrouping();
+    void readProcessesVariableInfo(QList<Process> &procs);
+    void initTaskStats();
+    /**
+     * @brief Take delay accounting of \a procs from taskstats, in a few batched requests
+     */
+    void readTaskStats(QList<Process> &procs);
+    void initTaskExitMonitor();
+    /**
+     * @brief Roll up the tasks exited since last scan, short lived ones never seen by a scan included
+     */
+    void readTaskExits();
+    ProcFdCache *fdCacheOf(pid_t pid) const;
+    /**
+     * @brief New process with the data read once per process (name, cmdline, uid...)
+     */
+    Process readSimpleProcess(pid_t pid) const;
+    /**
+     * @brief Container of \a proc, read once per process
+     */
+    const container_t &containerOf(const Process &proc);
+    /**
+     * @brief Drop everything kept for an exited pid
+     */
+    void forgetPid(pid_t pid);
+    void initPidEventSource();
+    /**
+     * @brief Fill m_pidList from proc connector events, or a full /proc scan when
+     * events are unavailable, lost or a consistency rescan is due
+     */
+    void collectPidList();
+    /**
+     * @brief Detach the processes of the scan & publish them as the next generation
+     */
+    void publishSnapshot();
+    /**
+     * @brief Replace the published snapshot with \a change applied to a copy of it
+     */
+    void updateSnapshot(const std::function<void(ProcessSnapshot &)> &change);
 
     class Iterator
     {
@@ -66,6 +359,7 @@ private:
 
         bool hasNext();
         Process next();
+        pid_t nextPid();
 
     private:
         void advance();
@@ -76,23 +370,70 @@ private:
 
 private:
     // Settings *m_settings = nullptr;
-    QMap<pid_t, Process> m_simpleSet;
-    QMap<pid_t, Process> m_set;
-    QMap<pid_t, std::shared_ptr<RecentProcStage>> m_recentProcStage {};
-
-    QMap<pid_t, pid_t> m_pidCtoPMapping {}; // child to parent pid mapping
-    QMultiMap<pid_t, pid_t> m_pidPtoCMapping {}; // parent to child pid mapping
-    QList<pid_t> m_prePid;
-    QList<pid_t> m_curPid;
-    QList<pid_t> m_pidMyApps;
+    // bound of per process caches, far above live processes of any desktop
+    static constexpr int kMaxCachedProcesses = 1 << 16;
+
+    ProcessCache<Process> m_simpleSet {kMaxCachedProcesses}; // processes of current scan, read once
+    QMap<pid_t, Process> m_set; // processes being scanned, monitor thread only
+    ProcessCache<std::shared_ptr<RecentProcStage>> m_recentProcStage {kMaxCachedProcesses}; // counters of last scan
+    // last published scan, only accessed through std::atomic_load & std::atomic_store
+    ProcessSnapshotPtr m_snapshot;
+
+    ProcessTree m_tree; // processes of current scan, links kept across scans
+    ProcessCache<container_t> m_containers {kMaxCachedProcesses};
+    QString m_hostPidNamespace; // of this monitor, processes elsewhere are sandboxed
+    ContainerUsagesPtr m_containerUsages {std::make_shared<const ContainerUsages>()};
+    QList<pid_t> m_pidList; // pids of current scan, in /proc order
+    QSet<pid_t> m_prePid; // pids of previous scan
+    QSet<pid_t> m_pidMyApps;
+    PidSetDiff m_pidDiff {};
+    // per pid /proc fds, sharded by pid so that each sampling worker owns its shard,
+    // fds are released when pid exits
+    std::vector<std::unique_ptr<ProcFdCache>> m_fdCaches;
+    bool m_parallelSampling; // workers of the executor's sampling pool read shards
+    int m_samplingWorkers;
+    // optional event driven pid tracking, null if proc connector is not permitted
+    std::unique_ptr<core::system::ProcConnector> m_procConnector;
+    QSet<pid_t> m_livePids;
+    // optional taskstats delay accounting, null if not permitted, stat & io are used then
+    std::unique_ptr<core::system::TaskStats> m_taskStats;
+    // optional taskstats exit records, null if not permitted
+    std::unique_ptr<core::system::TaskExitMonitor> m_taskExitMonitor;
+    ExitedProcessLog m_exitedLog;
+    quint64 m_exitedGeneration {0}; // of m_exitedLog when m_exited was rolled up
+    ExitedProcessRollupsPtr m_exited {std::make_shared<const ExitedProcessRollups>()};
+    int m_ticksSinceRescan;
+    // cpu usage total sampled at the last two scans
+    qulonglong m_cpuUsageTotal[2];
     
     // System service client for DKapture data
     SystemServiceClient *m_systemServiceClient;
     bool m_useSystemService;
+    bool m_kernelNetCounters;
+    bool m_netTrafficSampled;
+    quint64 m_vanishedCount {0};
+    // all process records kept up to date by DKapture deltas
+    QHash<pid_t, process_info_record_t> m_dkaptureRecords;
+    quint64 m_dkaptureGeneration;
     
     // DConfig for configuration management
     DTK_CORE_NAMESPACE::DConfig *m_config;
 
+    ProcessGrouping m_grouping {kGroupByProcessTree};
+    // cgroups of apps sampled last scan, null unless grouped by cgroup
+    std::unique_ptr<common::cgroup::CgroupStats> m_cgroupStats;
+    qreal m_fdLeakWindow {10 * 60};
+    qreal m_hungTaskWindow {10};
+    // stacks of hung processes, sampled on the monitor thread
+    std::unique_ptr<HungTaskSampler> m_hungTasks;
+    // RAPL energy counters, null if the cpu has none
+    std::unique_ptr<common::power::RaplReader> m_rapl;
+    common::power::rapl_power_t m_power;
+    // wakeup counts of the last read of the system server & the rates since the one before
+    QHash<pid_t, wakeup_record_t> m_wakeupCounts;
+    QHash<pid_t, QPair<qreal, qreal>> m_wakeupRates;
+    quint64 m_wakeupTime {0}; // CLOCK_MONOTONIC ns
+
     friend class Iterator;
 };
 
@@ -0,0 +1,241 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "process_smaps_cache.h"
+#include "process.h"
+#include "common/proc_parser.h"
+#include "ddlog.h"
+
+#include <QMutexLocker>
+#include <QVector>
+
+#include <algorithm>
+#include <functional>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#define PROC_SMAPS_ROLLUP_PATH "/proc/%d/smaps_rollup"
+
+using namespace common::parser;
+using namespace DDLog;
+
+namespace core {
+namespace process {
+
+// same bound as the other per process caches of ProcessSet
+static constexpr int kMaxCachedProcesses = 1 << 16;
+
+ProcessSmapsCache *ProcessSmapsCache::instance()
+{
+    static ProcessSmapsCache cache;
+    return &cache;
+}
+
+ProcessSmapsCache::ProcessSmapsCache()
+    : m_cache(kMaxCachedProcesses)
+    , m_enabled(false)
+    , m_cursor(0)
+{
+    m_clock.start();
+}
+
+void ProcessSmapsCache::setEnabled(bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_enabled != enabled)
+        qCInfo(app) << "smaps_rollup sampling" << (enabled ? "enabled" : "disabled");
+    m_enabled = enabled;
+}
+
+bool ProcessSmapsCache::isEnabled() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_enabled;
+}
+
+void ProcessSmapsCache::setVisiblePids(const QList<pid_t> &pids)
+{
+    QMutexLocker locker(&m_mutex);
+    m_visiblePids = pids;
+}
+
+int ProcessSmapsCache::refresh(const QMap<pid_t, Process> &set)
+{
+    return refresh(set, m_clock.elapsed());
+}
+
+int ProcessSmapsCache::refresh(const QMap<pid_t, Process> &set, qint64 now)
+{
+    QList<pid_t> visible;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_enabled)
+            return 0;
+        visible = m_visiblePids;
+    }
+    if (set.isEmpty())
+        return 0;
+
+    int nread = 0;
+    QSet<pid_t> done;
+    auto take = [&](const Process &proc) {
+        if (done.contains(proc.pid()) || !isDue(proc.pid(), proc.startTimeTicks(), now, kRefreshAge))
+            return;
+        read(proc, now);
+        done.insert(proc.pid());
+        ++nread;
+    };
+
+    // rows in view first
+    for (const pid_t &pid : visible) {
+        if (nread >= kRefreshPerScan)
+            break;
+        auto it = set.constFind(pid);
+        if (it != set.constEnd())
+            take(it.value());
+    }
+
+    // then the largest resident processes, likely to be sorted on top
+    if (nread < kRefreshPerScan) {
+        QVector<QPair<qulonglong, pid_t>> sizes;
+        sizes.reserve(set.size());
+        for (auto it = set.cbegin(); it != set.cend(); ++it)
+            sizes << qMakePair(it->memory(), it.key());
+        auto top = sizes.begin() + qMin(int(kTopCount), int(sizes.size()));
+        std::partial_sort(sizes.begin(), top, sizes.end(), std::greater<QPair<qulonglong, pid_t>>());
+        for (auto it = sizes.begin(); it != top && nread < kRefreshPerScan; ++it)
+            take(set[it->second]);
+    }
+
+    // everything else round robin by pid, from where the previous refresh stopped
+    auto it = set.upperBound(m_cursor);
+    for (int i = 0; i < set.size() && nread < kRefreshPerScan; ++i, ++it) {
+        if (it == set.cend())
+            it = set.cbegin();
+        take(it.value());
+        m_cursor = it.key();
+    }
+
+    qCDebug(app) << "Read smaps_rollup of" << nread << "processes";
+    return nread;
+}
+
+bool ProcessSmapsCache::isDue(pid_t pid, qulonglong startTime, qint64 now, qint64 age) const
+{
+    QMutexLocker locker(&m_mutex);
+    const entry_t *entry = m_cache.peek(pid, startTime);
+    return !entry || now - entry->refreshed >= age;
+}
+
+void ProcessSmapsCache::read(const Process &proc, qint64 now)
+{
+    // read without holding the lock, slow /proc reads must not block gui thread
+    entry_t entry {};
+    entry.valid = readSmapsRollup(proc.pid(), entry.smaps);
+    entry.refreshed = now;
+
+    QMutexLocker locker(&m_mutex);
+    m_cache.insert(proc.pid(), proc.startTimeTicks(), entry);
+}
+
+bool ProcessSmapsCache::lookup(pid_t pid, qulonglong startTime, smaps_t &smaps) const
+{
+    QMutexLocker locker(&m_mutex);
+    const entry_t *entry = m_cache.object(pid, startTime);
+    if (!entry || !entry->valid)
+        return false;
+
+    smaps = entry->smaps;
+    return true;
+}
+
+void ProcessSmapsCache::remove(pid_t pid)
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.remove(pid);
+}
+
+void ProcessSmapsCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+}
+
+int ProcessSmapsCache::count() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.count();
+}
+
+ProcessCacheStats ProcessSmapsCache::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.stats();
+}
+
+bool ProcessSmapsCache::parseSmapsRollup(const char *buf, size_t len, smaps_t &smaps)
+{
+    /*样例数据:
+        55a2af68a000-7ffcb55e7000 ---p 00000000 00:00 0                          [rollup]
+        Rss:                1412 kB
+        Pss:                 475 kB
+        ...
+        Private_Clean:        40 kB
+        Private_Dirty:       104 kB
+        ...
+        Swap:                  0 kB
+    */
+    smaps = {};
+    bool hasPss = false;
+    Tokenizer tok(buf, len);
+    const char *key;
+    size_t keyLen;
+    do {
+        if (!tok.readKey(key, keyLen))
+            continue;
+
+        unsigned long long value = 0;
+        if (keyEquals(key, keyLen, "Pss", 3)) {
+            hasPss = tok.readU64(value);
+            smaps.pss = value;
+        } else if (keyEquals(key, keyLen, "Private_Clean", 13) || keyEquals(key, keyLen, "Private_Dirty", 13)
+                   || keyEquals(key, keyLen, "Private_Hugetlb", 15)) {
+            if (tok.readU64(value))
+                smaps.uss += value;
+        } else if (keyEquals(key, keyLen, "Swap", 4)) {
+            if (tok.readU64(value))
+                smaps.swap = value;
+        }
+    } while (tok.nextLine());
+    return hasPss;
+}
+
+bool ProcessSmapsCache::readSmapsRollup(pid_t pid, smaps_t &smaps)
+{
+    char path[64];
+    snprintf(path, sizeof(path), PROC_SMAPS_ROLLUP_PATH, pid);
+
+    errno = 0;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        // other users' processes need ptrace access, missing before linux 4.14
+        if (errno != EACCES && errno != ENOENT && errno != ESRCH)
+            qCWarning(app) << "Failed to open" << path << ":" << strerror(errno);
+        return false;
+    }
+    char buf[2048];
+    ssize_t nr = ::read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (nr <= 0)
+        return false;
+
+    buf[nr] = '\0';
+    return parseSmapsRollup(buf, size_t(nr), smaps);
+}
+
+} // namespace process
+} // namespace core
@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_SMAPS_CACHE_H
+#define PROCESS_SMAPS_CACHE_H
+
+#include "process_cache.h"
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QSet>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+class Process;
+
+/**
+ * @brief Figures of /proc/[pid]/smaps_rollup, in kB
+ */
+struct smaps_t {
+    qulonglong pss {0}; // proportional set size, shared pages split among their users
+    qulonglong uss {0}; // unique set size, private clean & dirty pages
+    qulonglong swap {0}; // swapped out anonymous memory
+};
+
+/**
+ * @brief Cached smaps_rollup of processes, refreshed a few processes per scan
+ *
+ * smaps_rollup walks every mapping of a process in the kernel, far too slow to be read for
+ * all processes on every scan. Each refresh reads at most kRefreshPerScan of them, rows in view
+ * & the largest resident ones first once their figures are kRefreshAge old, the others round robin
+ * by pid. Values are kept between refreshes & nothing is read while the columns are hidden.
+ * Refreshed on the sampling thread, visible pids are set from the gui thread.
+ */
+class ProcessSmapsCache
+{
+public:
+    static ProcessSmapsCache *instance();
+
+    /**
+     * @brief Read smaps_rollup on refresh, off by default
+     */
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+    /**
+     * @brief Pids of the rows in view, refreshed before the others
+     */
+    void setVisiblePids(const QList<pid_t> &pids);
+
+    /**
+     * @brief Read smaps_rollup of the next processes due among those of a scan
+     * @param set Processes of the scan by pid
+     * @param now Monotonic time in ms
+     * @return Number of processes read
+     */
+    int refresh(const QMap<pid_t, Process> &set, qint64 now);
+    int refresh(const QMap<pid_t, Process> &set);
+
+    bool lookup(pid_t pid, qulonglong startTime, smaps_t &smaps) const;
+    void remove(pid_t pid);
+    void clear();
+    int count() const;
+    ProcessCacheStats stats() const;
+
+    /**
+     * @brief Parse Pss, Private_Clean, Private_Dirty & Swap of smaps_rollup content
+     */
+    static bool parseSmapsRollup(const char *buf, size_t len, smaps_t &smaps);
+    /**
+     * @brief Read & parse /proc/[pid]/smaps_rollup, fails for processes of other users
+     */
+    static bool readSmapsRollup(pid_t pid, smaps_t &smaps);
+
+    // smaps_rollup reads per refresh
+    static constexpr int kRefreshPerScan = 8;
+    // largest resident processes refreshed like the visible ones
+    static constexpr int kTopCount = 16;
+    // age in ms past which visible & largest processes are read again
+    static constexpr qint64 kRefreshAge = 10 * 1000;
+
+private:
+    ProcessSmapsCache();
+    Q_DISABLE_COPY(ProcessSmapsCache)
+
+    struct entry_t {
+        smaps_t smaps;
+        qint64 refreshed; // time of last read, failed reads too
+        bool valid;
+    };
+    // whether pid has no entry or one older than age
+    bool isDue(pid_t pid, qulonglong startTime, qint64 now, qint64 age) const;
+    void read(const Process &proc, qint64 now);
+
+    mutable QMutex m_mutex;
+    mutable ProcessCache<entry_t> m_cache;
+    bool m_enabled;
+    QList<pid_t> m_visiblePids;
+    // last pid the round robin read
+    pid_t m_cursor;
+    QElapsedTimer m_clock;
+};
+
+} // namespace process
+} // namespace core
+
+#endif // PROCESS_SMAPS_CACHE_H
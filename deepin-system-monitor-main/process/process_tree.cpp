@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "process_tree.h"
+
+namespace core {
+namespace process {
+
+void ProcessTree::insert(pid_t pid, pid_t ppid)
+{
+    auto it = m_nodes.find(pid);
+    if (it != m_nodes.end()) {
+        if (it->ppid == ppid)
+            return;
+        unlink(pid, it->ppid);
+        it->ppid = ppid;
+    } else {
+        node_t node;
+        node.ppid = ppid;
+        m_nodes.insert(pid, node);
+    }
+    m_children[ppid] << pid;
+    m_orderDirty = true;
+}
+
+void ProcessTree::remove(pid_t pid)
+{
+    auto it = m_nodes.find(pid);
+    if (it == m_nodes.end())
+        return;
+    unlink(pid, it->ppid);
+    m_nodes.erase(it);
+    m_orderDirty = true;
+}
+
+void ProcessTree::unlink(pid_t pid, pid_t ppid)
+{
+    auto it = m_children.find(ppid);
+    if (it == m_children.end())
+        return;
+    it->removeOne(pid);
+    if (it->isEmpty())
+        m_children.erase(it);
+}
+
+pid_t ProcessTree::parentOf(pid_t pid) const
+{
+    auto it = m_nodes.constFind(pid);
+    return it != m_nodes.cend() ? it->ppid : 0;
+}
+
+QVector<pid_t> ProcessTree::children(pid_t ppid) const
+{
+    return m_children.value(ppid);
+}
+
+QList<pid_t> ProcessTree::subtree(pid_t pid) const
+{
+    QList<pid_t> tree {pid};
+    QSet<pid_t> seen {pid};
+    for (int i = 0; i < tree.size(); ++i) {
+        auto it = m_children.constFind(tree[i]);
+        if (it == m_children.cend())
+            continue;
+        for (pid_t child : *it) {
+            if (seen.contains(child))
+                continue;
+            seen.insert(child);
+            tree << child;
+        }
+    }
+    return tree;
+}
+
+void ProcessTree::setUsage(pid_t pid, const ProcessTreeUsage &usage)
+{
+    auto it = m_nodes.find(pid);
+    if (it == m_nodes.end())
+        return;
+    it->self = usage;
+    it->self.processes = 1;
+}
+
+void ProcessTree::accumulate()
+{
+    if (m_orderDirty)
+        rebuildOrder();
+
+    for (auto it = m_nodes.begin(); it != m_nodes.end(); ++it)
+        it->total = it->self;
+    // children come after their parents, walking backwards a subtree is complete before it is added up
+    for (int i = m_order.size() - 1; i >= 0; --i) {
+        const node_t &node = m_nodes[m_order[i]];
+        auto parent = m_nodes.find(node.ppid);
+        if (parent == m_nodes.end())
+            continue;
+        parent->total.cpu += node.total.cpu;
+        parent->total.memory += node.total.memory;
+        parent->total.recvBps += node.total.recvBps;
+        parent->total.sentBps += node.total.sentBps;
+        parent->total.processes += node.total.processes;
+    }
+}
+
+ProcessTreeUsage ProcessTree::subtreeUsage(pid_t pid) const
+{
+    auto it = m_nodes.constFind(pid);
+    return it != m_nodes.cend() ? it->total : ProcessTreeUsage {};
+}
+
+void ProcessTree::rebuildOrder()
+{
+    m_order.clear();
+    m_order.reserve(m_nodes.size());
+    // roots have no parent in the tree, processes in ppid loops are never reached from them
+    for (auto it = m_nodes.cbegin(); it != m_nodes.cend(); ++it) {
+        if (!m_nodes.contains(it->ppid) || it->ppid == it.key())
+            m_order << it.key();
+    }
+    for (int i = 0; i < m_order.size(); ++i) {
+        auto it = m_children.constFind(m_order[i]);
+        if (it == m_children.cend())
+            continue;
+        for (pid_t child : *it) {
+            if (child != m_order[i])
+                m_order << child;
+        }
+    }
+    m_orderDirty = false;
+}
+
+} // namespace process
+} // namespace core
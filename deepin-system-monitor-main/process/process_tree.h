@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_TREE_H
+#define PROCESS_TREE_H
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QVector>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Usage summed over a process & its descendants
+ */
+struct ProcessTreeUsage {
+    qreal cpu {}; // percent
+    qulonglong memory {}; // resident memory in kB
+    qreal recvBps {};
+    qreal sentBps {};
+    int processes {};
+};
+
+/**
+ * @brief Parent & child links of scanned processes, kept across scans
+ *
+ * Links change only with pid spawns, exits & reparenting, instead of being rebuilt every scan.
+ * Children are linked to their ppid even when the parent isn't scanned, as the kernel reports
+ * them. Own usage is set per scan & summed bottom up by accumulate() in one pass over a
+ * parents first order, which is only rebuilt after links changed, subtree usage is then O(1).
+ * Copies share their data until written, the scanner's tree is published with each snapshot.
+ */
+class ProcessTree
+{
+public:
+    explicit ProcessTree() = default;
+
+    /**
+     * @brief Add \a pid under \a ppid, or move it there if its parent changed, e.g. to a subreaper
+     */
+    void insert(pid_t pid, pid_t ppid);
+    /**
+     * @brief Drop \a pid, its children stay linked to it until reparented by next scan
+     */
+    void remove(pid_t pid);
+
+    inline bool contains(pid_t pid) const
+    {
+        return m_nodes.contains(pid);
+    }
+    inline int size() const
+    {
+        return m_nodes.size();
+    }
+    /**
+     * @brief Parent of \a pid, 0 if \a pid isn't in the tree
+     */
+    pid_t parentOf(pid_t pid) const;
+    /**
+     * @brief Children linked to \a ppid, whether or not \a ppid is in the tree
+     */
+    QVector<pid_t> children(pid_t ppid) const;
+    /**
+     * @brief \a pid with all its descendants, parents before their children, loops of reused pids cut
+     */
+    QList<pid_t> subtree(pid_t pid) const;
+    /**
+     * @brief Whether \a pred holds for any ancestor of \a pid, nearest first
+     */
+    template<typename Pred>
+    bool anyAncestor(pid_t pid, Pred pred) const
+    {
+        // ppid loops of reused pids end the walk
+        QSet<pid_t> seen {pid};
+        for (pid_t ppid = parentOf(pid); ppid > 0 && !seen.contains(ppid); ppid = parentOf(ppid)) {
+            if (pred(ppid))
+                return true;
+            seen.insert(ppid);
+        }
+        return false;
+    }
+
+    /**
+     * @brief Own usage of \a pid at this scan, summed into subtrees by next accumulate()
+     */
+    void setUsage(pid_t pid, const ProcessTreeUsage &usage);
+    /**
+     * @brief Sum own usage into subtree usage, once per scan after every usage is set
+     */
+    void accumulate();
+    /**
+     * @brief Usage of \a pid & its descendants at last accumulate(), own usage only for processes in ppid loops
+     */
+    ProcessTreeUsage subtreeUsage(pid_t pid) const;
+
+private:
+    struct node_t {
+        pid_t ppid {0};
+        ProcessTreeUsage self;
+        ProcessTreeUsage total;
+    };
+
+    void unlink(pid_t pid, pid_t ppid);
+    /**
+     * @brief Parents first order of the processes reachable from the roots
+     */
+    void rebuildOrder();
+
+    QHash<pid_t, node_t> m_nodes;
+    QHash<pid_t, QVector<pid_t>> m_children; // by ppid
+    QVector<pid_t> m_order; // see rebuildOrder()
+    bool m_orderDirty {false};
+};
+
+} // namespace process
+} // namespace core
+
+#endif // PROCESS_TREE_H
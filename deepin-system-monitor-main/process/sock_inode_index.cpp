@@ -0,0 +1,141 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "sock_inode_index.h"
+#include "common/common.h"
+#include "ddlog.h"
+
+#include <QSet>
+
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+#define PROC_FD_PATH "/proc/%u/fd"
+// char device major of drm cards & render nodes
+#define DRM_MAJOR 226
+
+using namespace common::error;
+using namespace common::alloc;
+using namespace DDLog;
+
+namespace core {
+namespace process {
+
+SockInodeIndex::SockInodeIndex()
+    : m_entries {}
+{
+}
+
+QList<ino_t> SockInodeIndex::sockInodes(pid_t pid, fd_stats_t *stats)
+{
+    char path[128];
+    struct stat sbuf {};
+
+    sprintf(path, PROC_FD_PATH, pid);
+    // st_size of fd dir is the number of open fds on kernel 6.2+, 0 on older kernels
+    if (stat(path, &sbuf)) {
+        m_entries.remove(pid);
+        if (stats)
+            *stats = {};
+        return {};
+    }
+
+    auto it = m_entries.find(pid);
+    if (it != m_entries.end()) {
+        int maxAge = (sbuf.st_size > 0) ? kMaxAge : kMaxAgeWithoutCount;
+        if (it->fdCount == sbuf.st_size && ++it->age < maxAge) {
+            if (stats)
+                *stats = it->stats;
+            return it->inodes;
+        }
+    } else {
+        it = m_entries.insert(pid, {});
+    }
+
+    it->fdCount = sbuf.st_size;
+    it->age = 0;
+    it->inodes.clear();
+    if (!scanSockInodes(pid, it->inodes, &it->stats)) {
+        m_entries.erase(it);
+        if (stats)
+            *stats = {};
+        return {};
+    }
+    if (stats)
+        *stats = it->stats;
+    return it->inodes;
+}
+
+void SockInodeIndex::release(pid_t pid)
+{
+    m_entries.remove(pid);
+}
+
+void SockInodeIndex::clear()
+{
+    m_entries.clear();
+}
+
+bool SockInodeIndex::scanSockInodes(pid_t pid, QList<ino_t> &inodes, fd_stats_t *stats)
+{
+    struct dirent *dp;
+    char path[128];
+    struct stat sbuf;
+
+    sprintf(path, PROC_FD_PATH, pid);
+
+    errno = 0;
+    // open /proc/[pid]/fd dir
+    uDir dir(opendir(path));
+    if (!dir) {
+        // fd dir of other users' processes is not readable
+        if (errno == EACCES || errno == ENOENT)
+            return false;
+        qCWarning(app) << "Failed to open fd directory for process" << pid << "Error:" << strerror(errno);
+        print_errno(errno, QString("open %1 failed").arg(path));
+        return false;
+    }
+
+    int dfd = dirfd(dir.get());
+    QSet<ino_t> seen;
+    fd_stats_t found;
+    found.fds = 0;
+    // enumerate each entry
+    while ((dp = readdir(dir.get()))) {
+        // only if entry name starts with a digit
+        if (!isdigit(dp->d_name[0]))
+            continue;
+        ++found.fds;
+
+        // follow /proc/[pid]/fd/[fd] link relative to fd dir
+        if (fstatat(dfd, dp->d_name, &sbuf, 0))
+            continue;
+
+        // get inode if it's a socket descriptor, dup'ed fds share inode
+        if (S_ISSOCK(sbuf.st_mode)) {
+            ++found.sockets;
+            if (!seen.contains(sbuf.st_ino)) {
+                seen.insert(sbuf.st_ino);
+                inodes << sbuf.st_ino;
+            }
+        } else if (S_ISCHR(sbuf.st_mode) && major(sbuf.st_rdev) == DRM_MAJOR) {
+            // fdinfo is per fd, dup'ed fds are told apart by drm-client-id
+            found.drmFds << atoi(dp->d_name);
+        }
+    } // ::while(readdir)
+
+    if (stats)
+        *stats = found;
+    return true;
+}
+
+} // namespace process
+} // namespace core
@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SOCK_INODE_INDEX_H
+#define SOCK_INODE_INDEX_H
+
+#include <QHash>
+#include <QList>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+/**
+ * @brief What the fd walk of a process found besides socket inodes
+ */
+struct fd_stats_t {
+    int fds {-1}; // open fds, -1 if the fd dir is not readable
+    int sockets {0}; // socket fds, dup'ed ones counted each
+    QList<int> drmFds; // fds of drm devices
+};
+
+/**
+ * @brief Socket inodes, fd counts & drm fds owned by each pid, rescanned incrementally
+ *
+ * Walking /proc/[pid]/fd & stat'ing every descriptor is expensive for processes with
+ * thousands of fds, so the result is kept per pid and the fd dir is only walked again
+ * when its fd count changed (st_size of /proc/[pid]/fd, kernel 6.2+), or when the
+ * cached result got too old. The same walk picks up the fds of drm devices, whose fdinfo
+ * tells the gpu usage of the process. Not thread safe, owned by one sampling shard.
+ */
+class SockInodeIndex
+{
+public:
+    explicit SockInodeIndex();
+
+    /**
+     * @brief Socket inodes of pid, from index or a fresh fd dir scan
+     * @param stats Set to the fd counts & drm fds if given
+     */
+    QList<ino_t> sockInodes(pid_t pid, fd_stats_t *stats = nullptr);
+
+    void release(pid_t pid);
+    void clear();
+    int count() const;
+
+    /**
+     * @brief Walk /proc/[pid]/fd for socket inodes, without touching the index
+     * @param stats Filled with the fd counts & the fds of drm devices (char major 226) if given
+     * @return false if fd dir is not readable
+     */
+    static bool scanSockInodes(pid_t pid, QList<ino_t> &inodes, fd_stats_t *stats = nullptr);
+
+    // rescan anyway after this many lookups, fds can be replaced without changing count
+    static constexpr int kMaxAge = 10;
+    // rescan interval when kernel doesn't report fd count
+    static constexpr int kMaxAgeWithoutCount = 3;
+
+private:
+    struct Entry {
+        off_t fdCount;
+        int age;
+        QList<ino_t> inodes;
+        fd_stats_t stats;
+    };
+    QHash<pid_t, Entry> m_entries;
+};
+
+inline int SockInodeIndex::count() const
+{
+    return m_entries.size();
+}
+
+} // namespace process
+} // namespace core
+
+#endif // SOCK_INODE_INDEX_H
@@ -0,0 +1,178 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "symbolizer.h"
+#include "ddlog.h"
+
+#include <QFileInfo>
+
+#include <algorithm>
+
+#include <cxxabi.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace DDLog;
+
+namespace core {
+namespace process {
+
+namespace {
+
+// a file of the range [offset, offset + size)
+inline bool inFile(size_t fileSize, quint64 offset, quint64 size)
+{
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+} // namespace
+
+Symbolizer::Symbolizer(pid_t pid)
+    : m_pid(pid)
+{
+}
+
+void Symbolizer::addMapping(const mapping_t &mapping)
+{
+    auto it = std::upper_bound(m_mappings.begin(), m_mappings.end(), mapping.start, [](quint64 start, const mapping_t &m) {
+        return start < m.start;
+    });
+    m_mappings.insert(it, mapping);
+}
+
+QString Symbolizer::symbolize(quint64 ip, QString *module)
+{
+    auto it = std::upper_bound(m_mappings.cbegin(), m_mappings.cend(), ip, [](quint64 ip, const mapping_t &m) {
+        return ip < m.start;
+    });
+    if (module)
+        module->clear();
+    if (it == m_mappings.cbegin() || ip >= (it - 1)->end)
+        return {};
+    const mapping_t &mapping = *(it - 1);
+    if (module)
+        *module = QFileInfo(mapping.path).fileName();
+
+    // address in the file as linked, shared objects are linked at 0
+    const file_t &elf = file(mapping.path);
+    const quint64 offset = ip - mapping.start + mapping.offset;
+    quint64 addr = offset;
+    for (const segment_t &segment : elf.segments) {
+        if (offset >= segment.offset && offset < segment.offset + segment.size) {
+            addr = offset - segment.offset + segment.vaddr;
+            break;
+        }
+    }
+
+    auto sym = std::upper_bound(elf.symbols.cbegin(), elf.symbols.cend(), addr, [](quint64 addr, const symbol_t &s) {
+        return addr < s.addr;
+    });
+    if (sym != elf.symbols.cbegin()) {
+        --sym;
+        // symbols without a size are taken up to the next one
+        if (!sym->size || addr < sym->addr + sym->size)
+            return demangle(elf.strings.constData() + sym->name);
+    }
+    return QString("0x%1").arg(offset, 0, 16);
+}
+
+QString Symbolizer::demangle(const char *name)
+{
+    if (strncmp(name, "_Z", 2) != 0)
+        return QString::fromLatin1(name);
+
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (!demangled)
+        return QString::fromLatin1(name);
+    const QString result = QString::fromLatin1(demangled);
+    free(demangled);
+    return result;
+}
+
+const Symbolizer::file_t &Symbolizer::file(const QString &path)
+{
+    auto it = m_files.find(path);
+    if (it != m_files.end())
+        return it.value();
+
+    it = m_files.insert(path, file_t());
+    // the process may be of a container, its files are under its root
+    if (!(m_pid > 0 && loadElf(QString("/proc/%1/root%2").arg(m_pid).arg(path), it.value())))
+        loadElf(path, it.value());
+    return it.value();
+}
+
+bool Symbolizer::loadElf(const QString &path, file_t &file)
+{
+    int fd = open(path.toLocal8Bit().constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < off_t(sizeof(Elf64_Ehdr))) {
+        close(fd);
+        return false;
+    }
+    const size_t size = size_t(st.st_size);
+    void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return false;
+
+    const char *data = static_cast<const char *>(map);
+    const auto *ehdr = reinterpret_cast<const Elf64_Ehdr *>(data);
+    bool loaded = false;
+    if (memcmp(ehdr->e_ident, ELFMAG, SELFMAG) == 0 && ehdr->e_ident[EI_CLASS] == ELFCLASS64
+            && ehdr->e_phentsize == sizeof(Elf64_Phdr) && ehdr->e_shentsize == sizeof(Elf64_Shdr)
+            && inFile(size, ehdr->e_phoff, quint64(ehdr->e_phnum) * sizeof(Elf64_Phdr))
+            && inFile(size, ehdr->e_shoff, quint64(ehdr->e_shnum) * sizeof(Elf64_Shdr))) {
+        const auto *phdrs = reinterpret_cast<const Elf64_Phdr *>(data + ehdr->e_phoff);
+        for (int i = 0; i < ehdr->e_phnum; ++i) {
+            if (phdrs[i].p_type == PT_LOAD)
+                file.segments.push_back({phdrs[i].p_offset, phdrs[i].p_vaddr, phdrs[i].p_filesz});
+        }
+
+        // .symtab has the local functions too, .dynsym only the exported ones
+        const auto *shdrs = reinterpret_cast<const Elf64_Shdr *>(data + ehdr->e_shoff);
+        const Elf64_Shdr *symtab = nullptr;
+        for (int i = 0; i < ehdr->e_shnum; ++i) {
+            if (shdrs[i].sh_type == SHT_SYMTAB || (shdrs[i].sh_type == SHT_DYNSYM && !symtab))
+                symtab = &shdrs[i];
+        }
+        if (symtab && symtab->sh_link < ehdr->e_shnum && symtab->sh_entsize == sizeof(Elf64_Sym)
+                && inFile(size, symtab->sh_offset, symtab->sh_size)) {
+            const Elf64_Shdr &strtab = shdrs[symtab->sh_link];
+            if (inFile(size, strtab.sh_offset, strtab.sh_size) && strtab.sh_size) {
+                // names are kept nul terminated, the table may not end with one
+                file.strings = QByteArray(data + strtab.sh_offset, int(strtab.sh_size));
+                file.strings.append('\0');
+                const auto *syms = reinterpret_cast<const Elf64_Sym *>(data + symtab->sh_offset);
+                const size_t count = size_t(symtab->sh_size / sizeof(Elf64_Sym));
+                for (size_t i = 0; i < count; ++i) {
+                    const Elf64_Sym &sym = syms[i];
+                    const int type = ELF64_ST_TYPE(sym.st_info);
+                    if ((type != STT_FUNC && type != STT_GNU_IFUNC) || sym.st_shndx == SHN_UNDEF || !sym.st_value
+                            || sym.st_name >= strtab.sh_size)
+                        continue;
+                    file.symbols.push_back({sym.st_value, sym.st_size, sym.st_name});
+                }
+                std::stable_sort(file.symbols.begin(), file.symbols.end(), [](const symbol_t &a, const symbol_t &b) {
+                    return a.addr < b.addr;
+                });
+            }
+        }
+        loaded = true;
+    }
+    munmap(map, size);
+    qCDebug(app) << "Read" << file.symbols.size() << "symbols of" << path;
+    return loaded;
+}
+
+} // namespace process
+} // namespace core
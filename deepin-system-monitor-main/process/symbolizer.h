@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SYMBOLIZER_H
+#define SYMBOLIZER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include <vector>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Function names of the user space addresses of a process, from the symbol tables of its files
+ *
+ * Each mapped file is read once, .symtab unless it's stripped & .dynsym then, the load bias
+ * of a mapping comes from the PT_LOAD segment holding its file offset. Files of another mount
+ * namespace are read through /proc/[pid]/root when it's accessible. Only 64 bit ELF files are
+ * read, the others are shown as module+offset.
+ */
+class Symbolizer
+{
+public:
+    struct mapping_t {
+        quint64 start;
+        quint64 end;
+        quint64 offset; // file offset of start
+        QString path;
+    };
+
+    explicit Symbolizer(pid_t pid = 0);
+
+    void addMapping(const mapping_t &mapping);
+
+    /**
+     * @brief Function holding \a ip, demangled
+     * @param module Set to the file name of the mapping holding ip, empty if none does
+     * @return Empty if no mapping holds ip, "0x1f0" offset in the file if it has no symbol for it
+     */
+    QString symbolize(quint64 ip, QString *module = nullptr);
+
+    /**
+     * @brief Demangled name of a c++ symbol, other names as they are
+     */
+    static QString demangle(const char *name);
+
+private:
+    struct symbol_t {
+        quint64 addr;
+        quint64 size;
+        quint32 name; // offset into the string table
+    };
+    struct segment_t {
+        quint64 offset;
+        quint64 vaddr;
+        quint64 size;
+    };
+    struct file_t {
+        QByteArray strings;
+        std::vector<symbol_t> symbols; // by address
+        std::vector<segment_t> segments;
+    };
+
+    const file_t &file(const QString &path);
+    bool loadElf(const QString &path, file_t &file);
+
+    pid_t m_pid;
+    QList<mapping_t> m_mappings; // by start
+    QHash<QString, file_t> m_files;
+};
+
+} // namespace process
+} // namespace core
+
+#endif // SYMBOLIZER_H
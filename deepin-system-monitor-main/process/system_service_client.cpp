@@ -5,16 +5,39 @@
 
 #include "system_service_client.h"
 #include "ddlog.h"
+#include "process_info_record.h"
 
 #include <QDBusConnection>
+#include <QDBusMessage>
 #include <QDBusReply>
 #include <QDBusArgument>
+#include <QDBusError>
+#include <QDBusUnixFileDescriptor>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
 #include <QProcess>
 #include <QStandardPaths>
 #include <QFileInfo>
 
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 using namespace DDLog;
 
+// 与进程表采样间隔一致
+const int kProcessSnapshotInterval = 2000;
+// 超过这么多个间隔未更新的快照视为过期
+const int kProcessSnapshotStaleIntervals = 3;
+// D-Bus 调用超时，毫秒
+const int kProcessInfoCallTimeout = 3000;
+// 进程控制需等待用户在鉴权对话框中输入密码
+const int kProcessControlCallTimeout = 5 * 60 * 1000;
+
 namespace core {
 namespace process {
 
@@ -29,6 +52,24 @@ SystemServiceClient::SystemServiceClient(QObject *parent)
     , m_connectionTimer(nullptr)
     , m_serviceAvailable(false)
     , m_dkaptureAvailable(false)
+    , m_recordsSupported(true)
+    , m_deltaSupported(true)
+    , m_snapshot(nullptr)
+    , m_snapshotSize(0)
+    , m_snapshotSupported(true)
+    , m_pendingProcessInfo(nullptr)
+    , m_pendingKind(kNoProcessInfo)
+    , m_irqStatsOpened(false)
+    , m_blockLatencyOpened(false)
+    , m_wakeupsOpened(false)
+    , m_diskHealthOpened(false)
+    , m_memleakScanStarted(false)
+    , m_cpuProfileStarted(false)
+    , m_processControlSupported(true)
+    , m_affinitySupported(true)
+    , m_limitSupported(true)
+    , m_kernelStacksSupported(true)
+    , m_cpuProfileSupported(true)
 {
     qCDebug(app) << "SystemServiceClient created";
     
@@ -58,6 +99,19 @@ SystemServiceClient::SystemServiceClient(QObject *parent)
 SystemServiceClient::~SystemServiceClient()
 {
     qCDebug(app) << "SystemServiceClient destroyed";
+    if (m_snapshot && isServiceAvailable())
+        m_interface->call(QDBus::NoBlock, "closeProcessInfoSnapshots");
+    while (!m_fileActivityPids.isEmpty())
+        closeFileActivity(m_fileActivityPids.first());
+    closeIrqStats();
+    closeBlockLatency();
+    closeWakeups();
+    closeDiskHealth();
+    stopMemleakScan();
+    stopCpuProfile();
+    // 释放租约，服务空闲超时后退出
+    if (isServiceAvailable())
+        m_interface->call(QDBus::NoBlock, "releaseLease");
     disconnectFromService();
 }
 
@@ -94,55 +148,766 @@ QVariantMap SystemServiceClient::getProcessInfoBatch(const QList<int> &pids)
     
     qCInfo(app) << "Calling getProcessInfoBatch with" << pids.size() << "PIDs";
     QDBusReply<QVariantMap> reply = m_interface->call("getProcessInfoBatch", QVariant::fromValue(pids));
-    if (reply.isValid()) {
-        QVariantMap data = reply.value();
-        qCInfo(app) << "D-Bus call successful, received data with keys:" << data.keys();
-        qCInfo(app) << "success field:" << data["success"];
-        if (data.contains("data")) {
-            QVariant dataField = data["data"];
-            QVariantMap processData;
-            
-            // 处理 QDBusArgument 类型
-            if (dataField.canConvert<QDBusArgument>()) {
-                // qCInfo(app) << "Converting QDBusArgument to QVariantMap";
-                QDBusArgument arg = dataField.value<QDBusArgument>();
-                arg >> processData;
-                 
-                 // 直接转换所有QDBusArgument数据，无需预检查
-                 QVariantMap fixedProcessData;
-                 for (auto it = processData.begin(); it != processData.end(); ++it) {
-                     QVariant pVar = it.value();
-                     if (pVar.canConvert<QDBusArgument>()) {
-                         QDBusArgument pArg = pVar.value<QDBusArgument>();
-                         QVariantMap pMap;
-                         pArg >> pMap;
-                         fixedProcessData[it.key()] = pMap;
-                     } else {
-                         // 已经是QVariantMap或其他格式，直接使用
-                         fixedProcessData[it.key()] = pVar;
-                     }
+    if (reply.isValid())
+        return decodeProcessInfoBatch(reply.value());
+    
+    result["error"] = QString("D-Bus call failed: %1").arg(reply.error().message());
+    qCWarning(app) << "getProcessInfoBatch failed:" << reply.error().message();
+    return result;
+}
+
+QVariantMap SystemServiceClient::decodeProcessInfoBatch(const QVariantMap &data)
+{
+    qCInfo(app) << "D-Bus call successful, received data with keys:" << data.keys();
+    qCInfo(app) << "success field:" << data["success"];
+    if (data.contains("data")) {
+        QVariant dataField = data["data"];
+        QVariantMap processData;
+        
+        // 处理 QDBusArgument 类型
+        if (dataField.canConvert<QDBusArgument>()) {
+            // qCInfo(app) << "Converting QDBusArgument to QVariantMap";
+            QDBusArgument arg = dataField.value<QDBusArgument>();
+            arg >> processData;
+             
+             // 直接转换所有QDBusArgument数据，无需预检查
+             QVariantMap fixedProcessData;
+             for (auto it = processData.begin(); it != processData.end(); ++it) {
+                 QVariant pVar = it.value();
+                 if (pVar.canConvert<QDBusArgument>()) {
+                     QDBusArgument pArg = pVar.value<QDBusArgument>();
+                     QVariantMap pMap;
+                     pArg >> pMap;
+                     fixedProcessData[it.key()] = pMap;
+                 } else {
+                     // 已经是QVariantMap或其他格式，直接使用
+                     fixedProcessData[it.key()] = pVar;
                  }
-                 processData = fixedProcessData;
-                 qCInfo(app) << "Converted process data, total processes:" << processData.size();
-                
-                // 更新返回数据中的 data 字段
-                QVariantMap result = data;
-                result["data"] = processData;
-                return result;
+             }
+             processData = fixedProcessData;
+             qCInfo(app) << "Converted process data, total processes:" << processData.size();
+            
+            // 更新返回数据中的 data 字段
+            QVariantMap result = data;
+            result["data"] = processData;
+            return result;
+        } else {
+            processData = dataField.toMap();
+            qCInfo(app) << "Direct conversion - Process data has" << processData.size() << "entries";
+        }
+    }
+    return data;
+}
+
+bool SystemServiceClient::getProcessInfoRecords(const QList<int> &pids, QByteArray &records)
+{
+    records.clear();
+    if (!m_recordsSupported || !isServiceAvailable())
+        return false;
+
+    QDBusReply<QByteArray> reply = m_interface->call("getProcessInfoRecords", QVariant::fromValue(pids));
+    if (!reply.isValid()) {
+        processInfoCallFailed(kProcessInfoRecordsReply, reply.error());
+        return false;
+    }
+
+    records = reply.value();
+    return acceptProcessInfoRecords(records);
+}
+
+bool SystemServiceClient::acceptProcessInfoRecords(QByteArray &records)
+{
+    uint32_t count = 0;
+    if (!processInfoRecords(records.constData(), size_t(records.size()), count)) {
+        // 空数组表示服务端读取失败，其他情况为格式不匹配
+        if (!records.isEmpty()) {
+            qCWarning(app) << "Unknown process records format, using getProcessInfoBatch";
+            m_recordsSupported = false;
+        }
+        records.clear();
+        return false;
+    }
+    qCDebug(app) << "Received" << count << "process records";
+    return true;
+}
+
+bool SystemServiceClient::getProcessInfoDelta(quint64 generation, QByteArray &delta)
+{
+    delta.clear();
+    if (!m_deltaSupported || !isServiceAvailable())
+        return false;
+
+    QDBusReply<QByteArray> reply = m_interface->call("getProcessInfoDelta", QVariant::fromValue<qulonglong>(generation));
+    if (!reply.isValid()) {
+        processInfoCallFailed(kProcessInfoDeltaReply, reply.error());
+        return false;
+    }
+
+    delta = reply.value();
+    return acceptProcessInfoDelta(delta);
+}
+
+bool SystemServiceClient::acceptProcessInfoDelta(QByteArray &delta)
+{
+    // 空数组表示服务端读取失败，其他情况为格式不匹配
+    if (delta.isEmpty())
+        return false;
+    const process_info_record_t *records = nullptr;
+    const int32_t *exited = nullptr;
+    if (!processInfoDelta(delta.constData(), size_t(delta.size()), records, exited)) {
+        qCWarning(app) << "Unknown process delta format, using getProcessInfoRecords";
+        m_deltaSupported = false;
+        delta.clear();
+        return false;
+    }
+    return true;
+}
+
+void SystemServiceClient::processInfoCallFailed(ProcessInfoReply kind, const QDBusError &error)
+{
+    const bool unknownMethod = error.type() == QDBusError::UnknownMethod;
+    switch (kind) {
+    case kProcessInfoDeltaReply:
+        if (unknownMethod) {
+            qCInfo(app) << "System service has no getProcessInfoDelta, using getProcessInfoRecords";
+            m_deltaSupported = false;
+            return;
+        }
+        qCWarning(app) << "getProcessInfoDelta failed:" << error.message();
+        break;
+    case kProcessInfoRecordsReply:
+        if (unknownMethod) {
+            qCInfo(app) << "System service has no getProcessInfoRecords, using getProcessInfoBatch";
+            m_recordsSupported = false;
+            return;
+        }
+        qCWarning(app) << "getProcessInfoRecords failed:" << error.message();
+        break;
+    default:
+        qCWarning(app) << "getProcessInfoBatch failed:" << error.message();
+        break;
+    }
+}
+
+void SystemServiceClient::requestProcessInfo(quint64 generation, const QList<int> &pids)
+{
+    if (m_pendingProcessInfo || !isServiceAvailable())
+        return;
+
+    QDBusPendingCall call = m_deltaSupported
+            ? m_interface->asyncCall("getProcessInfoDelta", QVariant::fromValue<qulonglong>(generation))
+            : m_recordsSupported
+                ? m_interface->asyncCall("getProcessInfoRecords", QVariant::fromValue(pids))
+                : m_interface->asyncCall("getProcessInfoBatch", QVariant::fromValue(pids));
+    m_pendingKind = m_deltaSupported ? kProcessInfoDeltaReply
+                                     : m_recordsSupported ? kProcessInfoRecordsReply : kProcessInfoBatchReply;
+    m_pendingProcessInfo = new QDBusPendingCallWatcher(call, this);
+    m_pendingClock.start();
+    connect(m_pendingProcessInfo, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *watcher) {
+        if (watcher == m_pendingProcessInfo)
+            qCDebug(app) << "Process info reply received after" << m_pendingClock.elapsed() << "ms";
+    });
+}
+
+bool SystemServiceClient::openFileActivity(pid_t pid)
+{
+    if (!isServiceAvailable())
+        return false;
+
+    QDBusReply<bool> reply = m_interface->call("openFileActivity", int(pid));
+    if (!reply.isValid()) {
+        qCWarning(app) << "openFileActivity failed:" << reply.error().message();
+        return false;
+    }
+    if (reply.value())
+        m_fileActivityPids << pid;
+    return reply.value();
+}
+
+bool SystemServiceClient::getFileActivity(pid_t pid, QByteArray &activity)
+{
+    activity.clear();
+    if (!m_fileActivityPids.contains(pid) || !isServiceAvailable())
+        return false;
+
+    QDBusReply<QByteArray> reply = m_interface->call("getFileActivity", int(pid));
+    if (!reply.isValid()) {
+        qCWarning(app) << "getFileActivity failed:" << reply.error().message();
+        return false;
+    }
+
+    activity = reply.value();
+    const file_activity_record_t *records = nullptr;
+    if (!fileActivityRecords(activity.constData(), size_t(activity.size()), records)) {
+        if (!activity.isEmpty())
+            qCWarning(app) << "Unknown file activity format";
+        activity.clear();
+        return false;
+    }
+    return true;
+}
+
+void SystemServiceClient::closeFileActivity(pid_t pid)
+{
+    if (m_fileActivityPids.removeOne(pid) && isServiceAvailable())
+        m_interface->call(QDBus::NoBlock, "closeFileActivity", int(pid));
+}
+
+bool SystemServiceClient::openIrqStats()
+{
+    if (m_irqStatsOpened)
+        return true;
+    if (!isServiceAvailable())
+        return false;
+
+    QDBusReply<bool> reply = m_interface->call("openIrqStats");
+    if (!reply.isValid()) {
+        qCWarning(app) << "openIrqStats failed:" << reply.error().message();
+        return false;
+    }
+    m_irqStatsOpened = reply.value();
+    return m_irqStatsOpened;
+}
+
+bool SystemServiceClient::getIrqStats(QByteArray &stats)
+{
+    stats.clear();
+    if (!m_irqStatsOpened || !isServiceAvailable())
+        return false;
+
+    QDBusReply<QByteArray> reply = m_interface->call("getIrqStats");
+    if (!reply.isValid()) {
+        qCWarning(app) << "getIrqStats failed:" << reply.error().message();
+        return false;
+    }
+
+    stats = reply.value();
+    const irq_stat_record_t *records = nullptr;
+    if (!irqStatRecords(stats.constData(), size_t(stats.size()), records)) {
+        if (!stats.isEmpty())
+            qCWarning(app) << "Unknown irq stats format";
+        stats.clear();
+        return false;
+    }
+    return true;
+}
+
+void SystemServiceClient::closeIrqStats()
+{
+    if (m_irqStatsOpened && isServiceAvailable())
+        m_interface->call(QDBus::NoBlock, "closeIrqStats");
+    m_irqStatsOpened = false;
+}
+
+bool SystemServiceClient::openBlockLatency()
+{
+    if (m_blockLatencyOpened)
+        return true;
+    if (!isServiceAvailable())
+        return false;
+
+    QDBusReply<bool> reply = m_interface->call("openBlockLatency");
+    if (!reply.isValid()) {
+        qCWarning(app) << "openBlockLatency failed:" << reply.error().message();
+        return false;
+    }
+    m_blockLatencyOpened = reply.value();
+    return m_blockLatencyOpened;
+}
+
+bool SystemServiceClient::getBlockLatency(QByteArray &latency)
+{
+    latency.clear();
+    if (!m_blockLatencyOpened || !isServiceAvailable())
+        return false;
+
+    QDBusReply<QByteArray> reply = m_interface->call("getBlockLatency");
+    if (!reply.isValid()) {
+        qCWarning(app) << "getBlockLatency failed:" << reply.error().message();
+        return false;
+    }
+
+    latency = reply.value();
+    const block_latency_record_t *records = nullptr;
+    if (!blockLatencyRecords(latency.constData(), size_t(latency.size()), records)) {
+        if (!latency.isEmpty())
+            qCWarning(app) << "Unknown block latency format";
+        latency.clear();
+        return false;
+    }
+    return true;
+}
+
+void SystemServiceClient::closeBlockLatency()
+{
+    if (m_blockLatencyOpened && isServiceAvailable())
+        m_interface->call(QDBus::NoBlock, "closeBlockLatency");
+    m_blockLatencyOpened = false;
+}
+
+bool SystemServiceClient::openWakeups()
+{
+    if (m_wakeupsOpened)
+        return true;
+    if (!isServiceAvailable())
+        return false;
+
+    QDBusReply<bool> reply = m_interface->call("openWakeups");
+    if (!reply.isValid()) {
+        qCWarning(app) << "openWakeups failed:" << reply.error().message();
+        return false;
+    }
+    m_wakeupsOpened = reply.value();
+    return m_wakeupsOpened;
+}
+
+bool SystemServiceClient::getWakeups(QByteArray &wakeups)
+{
+    wakeups.clear();
+    if (!m_wakeupsOpened || !isServiceAvailable())
+        return false;
+
+    QDBusReply<QByteArray> reply = m_interface->call("getWakeups");
+    if (!reply.isValid()) {
+        qCWarning(app) << "getWakeups failed:" << reply.error().message();
+        return false;
+    }
+
+    wakeups = reply.value();
+    const wakeup_record_t *records = nullptr;
+    if (!wakeupRecords(wakeups.constData(), size_t(wakeups.size()), records)) {
+        if (!wakeups.isEmpty())
+            qCWarning(app) << "Unknown wakeups format";
+        wakeups.clear();
+        return false;
+    }
+    return true;
+}
+
+void SystemServiceClient::closeWakeups()
+{
+    if (m_wakeupsOpened && isServiceAvailable())
+        m_interface->call(QDBus::NoBlock, "closeWakeups");
+    m_wakeupsOpened = false;
+}
+
+bool SystemServiceClient::openDiskHealth()
+{
+    if (m_diskHealthOpened)
+        return true;
+    if (!isServiceAvailable())
+        return false;
+
+    QDBusReply<bool> reply = m_interface->call("openDiskHealth");
+    if (!reply.isValid()) {
+        qCWarning(app) << "openDiskHealth failed:" << reply.error().message();
+        return false;
+    }
+    m_diskHealthOpened = reply.value();
+    return m_diskHealthOpened;
+}
+
+bool SystemServiceClient::getDiskHealth(QByteArray &health)
+{
+    health.clear();
+    if (!m_diskHealthOpened || !isServiceAvailable())
+        return false;
+
+    QDBusReply<QByteArray> reply = m_interface->call("getDiskHealth");
+    if (!reply.isValid()) {
+        qCWarning(app) << "getDiskHealth failed:" << reply.error().message();
+        return false;
+    }
+
+    health = reply.value();
+    const disk_health_record_t *records = nullptr;
+    if (!diskHealthRecords(health.constData(), size_t(health.size()), records)) {
+        if (!health.isEmpty())
+            qCWarning(app) << "Unknown disk health format";
+        health.clear();
+        return false;
+    }
+    return true;
+}
+
+void SystemServiceClient::closeDiskHealth()
+{
+    if (m_diskHealthOpened && isServiceAvailable())
+        m_interface->call(QDBus::NoBlock, "closeDiskHealth");
+    m_diskHealthOpened = false;
+}
+
+bool SystemServiceClient::getEnergyCounters(QByteArray &counters)
+{
+    counters.clear();
+    if (!isServiceAvailable())
+        return false;
+
+    QDBusReply<QByteArray> reply = m_interface->call("getEnergyCounters");
+    if (!reply.isValid()) {
+        qCWarning(app) << "getEnergyCounters failed:" << reply.error().message();
+        return false;
+    }
+
+    counters = reply.value();
+    const energy_counter_record_t *records = nullptr;
+    if (!energyCounterRecords(counters.constData(), size_t(counters.size()), records)) {
+        if (!counters.isEmpty())
+            qCWarning(app) << "Unknown energy counters format";
+        counters.clear();
+        return false;
+    }
+    return true;
+}
+
+bool SystemServiceClient::getKernelStacks(const QList<pid_t> &pids, QByteArray &stacks)
+{
+    stacks.clear();
+    if (!m_kernelStacksSupported || !isServiceAvailable() || pids.isEmpty() || pids.size() > KERNEL_STACKS_MAX_PIDS)
+        return false;
+
+    QDBusReply<QByteArray> reply = m_interface->call("getKernelStacks", QVariant::fromValue(pids));
+    if (!reply.isValid()) {
+        if (reply.error().type() == QDBusError::UnknownMethod)
+            m_kernelStacksSupported = false;
+        qCWarning(app) << "getKernelStacks failed:" << reply.error().message();
+        return false;
+    }
+
+    stacks = reply.value();
+    const kernel_stack_record_t *records = nullptr;
+    if (!kernelStackRecords(stacks.constData(), size_t(stacks.size()), records)) {
+        if (!stacks.isEmpty())
+            qCWarning(app) << "Unknown kernel stacks format";
+        stacks.clear();
+        return false;
+    }
+    return true;
+}
+
+bool SystemServiceClient::startMemleakScan(pid_t pid, int window)
+{
+    if (!isServiceAvailable())
+        return false;
+
+    QDBusReply<bool> reply = m_interface->call("startMemleakScan", int(pid), window);
+    if (!reply.isValid()) {
+        qCWarning(app) << "startMemleakScan failed:" << reply.error().message();
+        return false;
+    }
+    m_memleakScanStarted = reply.value();
+    return m_memleakScanStarted;
+}
+
+bool SystemServiceClient::controlProcesses(const QList<pid_t> &pids, int action, int value)
+{
+    if (!m_processControlSupported || !isServiceAvailable() || pids.isEmpty() || pids.size() > PROCESS_CONTROL_MAX_PIDS)
+        return false;
+
+    QList<int> args;
+    args.reserve(pids.size());
+    for (pid_t pid : pids)
+        args << int(pid);
+    QDBusMessage msg = QDBusMessage::createMethodCall(SERVICE_NAME, SERVICE_PATH, SERVICE_INTERFACE, "controlProcesses");
+    msg << QVariant::fromValue(args) << action << value;
+    callProcessControl(msg, pids, action, value, m_processControlSupported);
+    return true;
+}
+
+bool SystemServiceClient::setProcessesAffinity(const QList<pid_t> &pids, const QByteArray &cpus)
+{
+    const int count = processAffinityCpus(cpus.constData(), size_t(cpus.size()));
+    if (!m_affinitySupported || !isServiceAvailable() || pids.isEmpty() || pids.size() > PROCESS_CONTROL_MAX_PIDS || count < 0)
+        return false;
+
+    QList<int> args;
+    args.reserve(pids.size());
+    for (pid_t pid : pids)
+        args << int(pid);
+    QDBusMessage msg = QDBusMessage::createMethodCall(SERVICE_NAME, SERVICE_PATH, SERVICE_INTERFACE, "setProcessesAffinity");
+    msg << QVariant::fromValue(args) << cpus;
+    callProcessControl(msg, pids, PROCESS_CONTROL_AFFINITY, count, m_affinitySupported);
+    return true;
+}
+
+bool SystemServiceClient::limitProcess(pid_t pid, const resource_limits_t &limits)
+{
+    if (!m_limitSupported || !isServiceAvailable() || !resourceLimitsValid(limits))
+        return false;
+
+    QDBusMessage msg = QDBusMessage::createMethodCall(SERVICE_NAME, SERVICE_PATH, SERVICE_INTERFACE, "limitProcess");
+    msg << int(pid) << qulonglong(limits.cpu_quota) << qulonglong(limits.memory_high) << qulonglong(limits.io_weight);
+    // 鉴权与 controlProcesses 共用，对话框打开期间调用不返回
+    auto *watcher = new QDBusPendingCallWatcher(m_interface->connection().asyncCall(msg, kProcessControlCallTimeout), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, pid](QDBusPendingCallWatcher *watcher) {
+        QDBusPendingReply<QString> reply = *watcher;
+        watcher->deleteLater();
+        QString error;
+        if (reply.isError()) {
+            if (reply.error().type() == QDBusError::UnknownMethod)
+                m_limitSupported = false;
+            qCWarning(app) << "limitProcess failed:" << reply.error().message();
+            error = reply.error().message();
+        } else {
+            error = reply.value();
+        }
+        Q_EMIT processLimited(pid, error);
+    });
+    return true;
+}
+
+void SystemServiceClient::callProcessControl(const QDBusMessage &msg, const QList<pid_t> &pids, int action, int value, bool &supported)
+{
+    // 不使用接口的超时，鉴权对话框打开期间调用不返回
+    auto *watcher = new QDBusPendingCallWatcher(m_interface->connection().asyncCall(msg, kProcessControlCallTimeout), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, pids, action, value, &supported, method = msg.member()](QDBusPendingCallWatcher *watcher) {
+        QDBusPendingReply<QList<int>> reply = *watcher;
+        watcher->deleteLater();
+        QList<int> errors;
+        if (reply.isError()) {
+            if (reply.error().type() == QDBusError::UnknownMethod) {
+                qCInfo(app) << "System service has no" << method << ", falling back";
+                supported = false;
             } else {
-                processData = dataField.toMap();
-                qCInfo(app) << "Direct conversion - Process data has" << processData.size() << "entries";
+                qCWarning(app) << method << "failed:" << reply.error().message();
             }
+        } else if (reply.value().size() == pids.size()) {
+            errors = reply.value();
         }
-        return data;
+        Q_EMIT processesControlled(pids, action, value, errors);
+    });
+}
+
+bool SystemServiceClient::getMemleakScan(QByteArray &scan)
+{
+    scan.clear();
+    if (!m_memleakScanStarted || !isServiceAvailable())
+        return false;
+
+    QDBusReply<QByteArray> reply = m_interface->call("getMemleakScan");
+    if (!reply.isValid()) {
+        qCWarning(app) << "getMemleakScan failed:" << reply.error().message();
+        return false;
     }
-    
-    result["error"] = QString("D-Bus call failed: %1").arg(reply.error().message());
-    qCWarning(app) << "getProcessInfoBatch failed:" << reply.error().message();
-    return result;
+
+    scan = reply.value();
+    const memleak_site_record_t *records = nullptr;
+    if (!memleakScanRecords(scan.constData(), size_t(scan.size()), records)) {
+        if (!scan.isEmpty())
+            qCWarning(app) << "Unknown memleak scan format";
+        scan.clear();
+        return false;
+    }
+    return true;
+}
+
+void SystemServiceClient::stopMemleakScan()
+{
+    // 结果保留在服务端，停止后仍可获取
+    if (m_memleakScanStarted && isServiceAvailable())
+        m_interface->call(QDBus::NoBlock, "stopMemleakScan");
+}
+
+bool SystemServiceClient::startCpuProfile(pid_t pid, int duration, int frequency)
+{
+    if (!m_cpuProfileSupported || !isServiceAvailable())
+        return false;
+
+    QDBusMessage msg = QDBusMessage::createMethodCall(SERVICE_NAME, SERVICE_PATH, SERVICE_INTERFACE, "startCpuProfile");
+    msg << int(pid) << duration << frequency;
+    // 其他用户的进程与 controlProcesses 共用鉴权，对话框打开期间调用不返回
+    auto *watcher = new QDBusPendingCallWatcher(m_interface->connection().asyncCall(msg, kProcessControlCallTimeout), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, pid](QDBusPendingCallWatcher *watcher) {
+        QDBusPendingReply<bool> reply = *watcher;
+        watcher->deleteLater();
+        bool started = false;
+        if (reply.isError()) {
+            if (reply.error().type() == QDBusError::UnknownMethod)
+                m_cpuProfileSupported = false;
+            qCWarning(app) << "startCpuProfile failed:" << reply.error().message();
+        } else {
+            started = reply.value();
+        }
+        if (started)
+            m_cpuProfileStarted = true;
+        Q_EMIT cpuProfileStarted(pid, started);
+    });
+    return true;
+}
+
+bool SystemServiceClient::getCpuProfile(QByteArray &profile)
+{
+    profile.clear();
+    if (!m_cpuProfileStarted || !isServiceAvailable())
+        return false;
+
+    QDBusReply<QByteArray> reply = m_interface->call("getCpuProfile");
+    if (!reply.isValid()) {
+        qCWarning(app) << "getCpuProfile failed:" << reply.error().message();
+        return false;
+    }
+
+    profile = reply.value();
+    const cpu_profile_stack_t *stacks = nullptr;
+    const cpu_profile_symbol_t *symbols = nullptr;
+    const cpu_profile_mapping_t *mappings = nullptr;
+    if (!cpuProfileRecords(profile.constData(), size_t(profile.size()), stacks, symbols, mappings)) {
+        if (!profile.isEmpty())
+            qCWarning(app) << "Unknown cpu profile format";
+        profile.clear();
+        return false;
+    }
+    return true;
+}
+
+void SystemServiceClient::stopCpuProfile()
+{
+    // 已采到的结果保留在服务端，停止后仍可获取
+    if (m_cpuProfileStarted && isServiceAvailable())
+        m_interface->call(QDBus::NoBlock, "stopCpuProfile");
+}
+
+void SystemServiceClient::cancelProcessInfoRequest()
+{
+    delete m_pendingProcessInfo;
+    m_pendingProcessInfo = nullptr;
+}
+
+SystemServiceClient::ProcessInfoReply SystemServiceClient::takeProcessInfo(QByteArray &payload, QVariantMap &batch)
+{
+    payload.clear();
+    batch.clear();
+    if (!m_pendingProcessInfo)
+        return kNoProcessInfo;
+
+    // 上一次采样时发出的请求仍未返回，本次放弃该请求，回退到 /proc
+    QDBusPendingCallWatcher *watcher = m_pendingProcessInfo;
+    m_pendingProcessInfo = nullptr;
+    watcher->deleteLater();
+    if (!watcher->isFinished()) {
+        qCWarning(app) << "Process info reply not ready after" << m_pendingClock.elapsed() << "ms, reading /proc this tick";
+        return kNoProcessInfo;
+    }
+    if (watcher->isError()) {
+        processInfoCallFailed(m_pendingKind, watcher->error());
+        return kNoProcessInfo;
+    }
+
+    switch (m_pendingKind) {
+    case kProcessInfoDeltaReply:
+        payload = QDBusPendingReply<QByteArray>(*watcher).value();
+        return acceptProcessInfoDelta(payload) ? kProcessInfoDeltaReply : kNoProcessInfo;
+    case kProcessInfoRecordsReply:
+        payload = QDBusPendingReply<QByteArray>(*watcher).value();
+        return acceptProcessInfoRecords(payload) ? kProcessInfoRecordsReply : kNoProcessInfo;
+    case kProcessInfoBatchReply:
+        batch = decodeProcessInfoBatch(QDBusPendingReply<QVariantMap>(*watcher).value());
+        return kProcessInfoBatchReply;
+    default:
+        return kNoProcessInfo;
+    }
+}
+
+bool SystemServiceClient::readProcessInfoSnapshot(QByteArray &records)
+{
+    records.clear();
+    if (!m_snapshot && (!m_snapshotSupported || !isServiceAvailable() || !openProcessInfoSnapshots()))
+        return false;
+
+    m_snapshotRecords.resize(int(sizeof(process_info_records_header_t) + size_t(m_snapshot->capacity) * sizeof(process_info_record_t)));
+    auto *hdr = reinterpret_cast<process_info_records_header_t *>(m_snapshotRecords.data());
+    uint32_t count = 0;
+    uint64_t timestamp = 0;
+    if (!copyProcessInfoSnapshot(m_snapshot, reinterpret_cast<process_info_record_t *>(hdr + 1), count, timestamp))
+        return false;
+
+    // 服务端停止写入时回退到 D-Bus 调用
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t now = uint64_t(ts.tv_sec) * 1000000000ULL + uint64_t(ts.tv_nsec);
+    uint64_t interval = qMax<uint64_t>(m_snapshot->interval, kProcessSnapshotInterval);
+    if (now > timestamp && now - timestamp > kProcessSnapshotStaleIntervals * interval * 1000000ULL) {
+        qCDebug(app) << "Process snapshot is stale, published" << (now - timestamp) / 1000000 << "ms ago";
+        return false;
+    }
+
+    hdr->magic = PROCESS_INFO_RECORDS_MAGIC;
+    hdr->version = PROCESS_INFO_RECORDS_VERSION;
+    hdr->record_size = sizeof(process_info_record_t);
+    hdr->count = count;
+    hdr->reserved = 0;
+    m_snapshotRecords.resize(int(sizeof(*hdr) + count * sizeof(process_info_record_t)));
+    records = m_snapshotRecords;
+    return true;
 }
 
+bool SystemServiceClient::openProcessInfoSnapshots()
+{
+    if (!(m_interface->connection().connectionCapabilities() & QDBusConnection::UnixFileDescriptorPassing)) {
+        qCInfo(app) << "System bus can not pass file descriptors, process snapshots disabled";
+        m_snapshotSupported = false;
+        return false;
+    }
+
+    QDBusReply<QDBusUnixFileDescriptor> reply = m_interface->call("openProcessInfoSnapshots", kProcessSnapshotInterval);
+    // 失败后重新连接服务前不再尝试
+    m_snapshotSupported = false;
+    if (!reply.isValid()) {
+        if (reply.error().type() == QDBusError::UnknownMethod)
+            qCInfo(app) << "System service has no process snapshots";
+        else
+            qCWarning(app) << "openProcessInfoSnapshots failed:" << reply.error().message();
+        return false;
+    }
+
+    int fd = reply.value().fileDescriptor();
+    if (fd < 0) {
+        qCInfo(app) << "System service refused process snapshots";
+        return false;
+    }
+
+    // 大小被密封后映射期间不会被截断
+    int seals = fcntl(fd, F_GET_SEALS);
+    struct stat st;
+    if (seals < 0 || (seals & (F_SEAL_SHRINK | F_SEAL_GROW)) != (F_SEAL_SHRINK | F_SEAL_GROW)
+            || fstat(fd, &st) < 0 || size_t(st.st_size) < sizeof(process_info_shm_header_t)) {
+        qCWarning(app) << "Process snapshot segment is not sealed";
+        return false;
+    }
+
+    size_t size = size_t(st.st_size);
+    void *addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        qCWarning(app) << "Failed to map process snapshot segment:" << strerror(errno);
+        return false;
+    }
 
+    auto *hdr = static_cast<const process_info_shm_header_t *>(addr);
+    if (hdr->magic != PROCESS_INFO_SHM_MAGIC
+            || hdr->version != PROCESS_INFO_SHM_VERSION
+            || hdr->record_size != sizeof(process_info_record_t)
+            || processInfoShmSize(hdr->capacity) > size) {
+        qCWarning(app) << "Unknown process snapshot format";
+        munmap(addr, size);
+        return false;
+    }
+
+    m_snapshot = hdr;
+    m_snapshotSize = size;
+    m_snapshotSupported = true;
+    qCInfo(app) << "Mapped process snapshots," << hdr->capacity << "records per buffer";
+    return true;
+}
+
+void SystemServiceClient::closeProcessInfoSnapshots()
+{
+    if (m_snapshot) {
+        munmap(const_cast<process_info_shm_header_t *>(m_snapshot), m_snapshotSize);
+        m_snapshot = nullptr;
+        m_snapshotSize = 0;
+    }
+    m_snapshotRecords.clear();
+}
 
 bool SystemServiceClient::startSystemService()
 {
@@ -231,18 +996,50 @@ void SystemServiceClient::connectToService()
         return;
     }
     
+    closeProcessInfoSnapshots();
+    cancelProcessInfoRequest();
+    m_fileActivityPids.clear();
+    m_irqStatsOpened = false;
+    m_blockLatencyOpened = false;
+    m_wakeupsOpened = false;
+    m_diskHealthOpened = false;
+    m_memleakScanStarted = false;
+    m_cpuProfileStarted = false;
+    m_processControlSupported = true;
+    m_affinitySupported = true;
+    m_limitSupported = true;
+    m_kernelStacksSupported = true;
+    m_cpuProfileSupported = true;
     m_interface = new QDBusInterface(SERVICE_NAME, SERVICE_PATH, SERVICE_INTERFACE, bus, this);
+    // 服务无响应时不长时间阻塞采样线程
+    m_interface->setTimeout(kProcessInfoCallTimeout);
+    m_recordsSupported = true;
+    m_deltaSupported = true;
+    m_snapshotSupported = true;
     
     if (m_interface->isValid()) {
         m_serviceAvailable = true;
         qCInfo(app) << "Successfully connected to system service";
         emit serviceConnectionChanged(true);
+
+        // 程序运行期间持有租约，服务不因采样暂停而空闲退出，旧版本服务忽略该调用
+        m_interface->call(QDBus::NoBlock, "acquireLease");
         
-        // 检查 DKapture 可用性
-        if (isDKaptureAvailable()) {
-            qCInfo(app) << "DKapture is available in system service";
-            emit dkaptureAvailabilityChanged(true);
-        }
+        // 异步检查 DKapture 可用性，服务按需启动时不阻塞调用线程
+        auto *watcher = new QDBusPendingCallWatcher(m_interface->asyncCall("isDKaptureAvailable"), m_interface);
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *watcher) {
+            QDBusPendingReply<bool> reply = *watcher;
+            watcher->deleteLater();
+            if (reply.isError()) {
+                qCWarning(app) << "isDKaptureAvailable failed:" << reply.error().message();
+                return;
+            }
+            m_dkaptureAvailable = reply.value();
+            if (m_dkaptureAvailable) {
+                qCInfo(app) << "DKapture is available in system service";
+                emit dkaptureAvailabilityChanged(true);
+            }
+        });
     } else {
         qCWarning(app) << "Failed to connect to system service:" << m_interface->lastError().message();
         m_serviceAvailable = false;
@@ -252,6 +1049,8 @@ void SystemServiceClient::connectToService()
 
 void SystemServiceClient::disconnectFromService()
 {
+    closeProcessInfoSnapshots();
+    cancelProcessInfoRequest();
     if (m_interface) {
         delete m_interface;
         m_interface = nullptr;
@@ -11,6 +11,13 @@
 #include <QDBusServiceWatcher>
 #include <QTimer>
 #include <QVariantMap>
+#include <QByteArray>
+#include <QElapsedTimer>
+
+class QDBusPendingCallWatcher;
+class QDBusError;
+struct process_info_shm_header_t;
+struct resource_limits_t;
 
 namespace core {
 namespace process {
@@ -20,6 +27,13 @@ class SystemServiceClient : public QObject
     Q_OBJECT
 
 public:
+    enum ProcessInfoReply {
+        kNoProcessInfo,
+        kProcessInfoDeltaReply,    // payload 为 getProcessInfoDelta 格式
+        kProcessInfoRecordsReply,  // payload 为 getProcessInfoRecords 格式
+        kProcessInfoBatchReply,    // batch 为 getProcessInfoBatch 格式
+    };
+
     explicit SystemServiceClient(QObject *parent = nullptr);
     ~SystemServiceClient();
 
@@ -31,6 +45,177 @@ public:
     
     // 批量获取进程信息
     QVariantMap getProcessInfoBatch(const QList<int> &pids);
+
+    /**
+     * @brief 批量获取进程信息，定长记录数组，格式见 process_info_record.h
+     * @param pids 目标进程
+     * @param records 服务返回的记录数组
+     * @return false: 服务不支持或调用失败，调用方应回退到 getProcessInfoBatch
+     */
+    bool getProcessInfoRecords(const QList<int> &pids, QByteArray &records);
+
+    /**
+     * @brief 读取共享内存中的最新进程快照，格式与 getProcessInfoRecords 相同，不发起 D-Bus 调用
+     * @param records 快照中的全部进程记录
+     * @return false: 服务不支持、快照尚未写入或已过期，调用方应回退到 getProcessInfoRecords
+     */
+    bool readProcessInfoSnapshot(QByteArray &records);
+
+    /**
+     * @brief 增量获取全部进程信息，格式见 process_info_record.h
+     * @param generation 上次应用的增量代数，首次为 0
+     * @param delta 服务返回的增量
+     * @return false: 服务不支持或调用失败，调用方应回退到 getProcessInfoRecords
+     */
+    bool getProcessInfoDelta(quint64 generation, QByteArray &delta);
+
+    /**
+     * @brief 异步请求下一次采样的进程信息，按 delta/records/batch 顺序选用服务支持的接口
+     * @param generation 上次应用的增量代数，首次为 0
+     * @param pids 目标进程，增量接口不使用
+     */
+    void requestProcessInfo(quint64 generation, const QList<int> &pids);
+
+    /**
+     * @brief 取回 requestProcessInfo 的结果，不阻塞；请求尚未返回时放弃该请求
+     * @param payload delta/records 格式的结果
+     * @param batch batch 格式的结果
+     * @return kNoProcessInfo: 没有可用结果，调用方本次应直接读取 /proc
+     */
+    ProcessInfoReply takeProcessInfo(QByteArray &payload, QVariantMap &batch);
+
+    /**
+     * @brief 请求服务开始统计进程的文件读写，每次成功调用需对应一次 closeFileActivity
+     * @return false: 服务不支持、DKapture 不可用或调用失败
+     */
+    bool openFileActivity(pid_t pid);
+
+    /**
+     * @brief 获取进程最繁忙的文件，格式见 process_info_record.h
+     * @param activity 服务返回的统计，读写总量自 openFileActivity 起累计
+     * @return false: 未开始统计或调用失败
+     */
+    bool getFileActivity(pid_t pid, QByteArray &activity);
+    void closeFileActivity(pid_t pid);
+
+    /**
+     * @brief 请求服务开始统计硬中断与软中断，每次成功调用需对应一次 closeIrqStats
+     * @return false: 服务不支持、DKapture 不可用或调用失败
+     */
+    bool openIrqStats();
+
+    /**
+     * @brief 获取各中断线与软中断向量的统计，格式见 process_info_record.h
+     * @param stats 服务返回的统计，次数与耗时自 openIrqStats 起累计
+     * @return false: 未开始统计或调用失败
+     */
+    bool getIrqStats(QByteArray &stats);
+    void closeIrqStats();
+
+    /**
+     * @brief 请求服务开始统计各磁盘块请求的延迟，每次成功调用需对应一次 closeBlockLatency
+     * @return false: 服务不支持、内核不支持 eBPF 跟踪或调用失败
+     */
+    bool openBlockLatency();
+
+    /**
+     * @brief 获取各磁盘读写请求的延迟直方图，格式见 process_info_record.h
+     * @param latency 服务返回的直方图，请求数自 openBlockLatency 起累计
+     * @return false: 未开始统计或调用失败
+     */
+    bool getBlockLatency(QByteArray &latency);
+    void closeBlockLatency();
+
+    /**
+     * @brief 请求服务开始统计各进程被唤醒的次数，每次成功调用需对应一次 closeWakeups
+     * @return false: 服务不支持或调用失败
+     */
+    bool openWakeups();
+
+    /**
+     * @brief 获取各进程的唤醒次数，格式见 process_info_record.h
+     * @param wakeups 服务返回的记录，次数自 openWakeups 起累计
+     * @return false: 未开始统计或调用失败
+     */
+    bool getWakeups(QByteArray &wakeups);
+    void closeWakeups();
+
+    /**
+     * @brief 请求服务开始定期读取各磁盘的 SMART 健康状态，每次成功调用需对应一次 closeDiskHealth
+     * @return false: 服务不支持或调用失败
+     */
+    bool openDiskHealth();
+
+    /**
+     * @brief 获取各磁盘最近一次读取的健康状态与温度，格式见 process_info_record.h
+     * @param health 服务返回的记录，服务端每 DISK_HEALTH_INTERVAL 读取一次
+     * @return false: 未开始读取或调用失败
+     */
+    bool getDiskHealth(QByteArray &health);
+    void closeDiskHealth();
+
+    /**
+     * @brief 获取 RAPL 能耗计数，供无权限读取 energy_uj 时使用，格式见 process_info_record.h
+     * @param counters 服务返回的记录，服务端每 ENERGY_COUNTERS_MIN_INTERVAL 最多读取一次
+     * @return false: 服务不支持或调用失败
+     */
+    bool getEnergyCounters(QByteArray &counters);
+
+    /**
+     * @brief 获取不可中断睡眠中进程的内核调用栈，其他状态的进程不返回，格式见 process_info_record.h
+     * @param pids 目标进程，不超过 KERNEL_STACKS_MAX_PIDS 个
+     * @return false: 服务不支持或调用失败，调用方应回退到 wchan
+     */
+    bool getKernelStacks(const QList<pid_t> &pids, QByteArray &stacks);
+
+    /**
+     * @brief 请求服务在后台扫描进程的内核内存泄漏，扫描结束前可随时取消
+     * @param pid 被扫描的进程，0 为全部进程
+     * @param window 汇总间隔，毫秒
+     * @return false: 服务不支持、DKapture 不可用、已有扫描进行中或调用失败
+     */
+    bool startMemleakScan(pid_t pid, int window);
+
+    /**
+     * @brief 获取扫描状态与目前最大的泄漏点，格式见 process_info_record.h
+     * @return false: 未发起扫描或调用失败
+     */
+    bool getMemleakScan(QByteArray &scan);
+    void stopMemleakScan();
+
+    /**
+     * @brief 异步请求服务采样进程的用户与内核调用栈，其他用户的进程需要鉴权，结果由 cpuProfileStarted 通知
+     * @param duration 采样时间，毫秒，不超过 CPU_PROFILE_MAX_DURATION
+     * @param frequency 每个线程每秒的采样次数
+     * @return false: 服务不可用或不支持
+     */
+    bool startCpuProfile(pid_t pid, int duration, int frequency);
+    /**
+     * @brief 获取采样状态，采样结束后附带调用栈、内核符号与可执行映射，格式见 process_info_record.h
+     * @return false: 未发起采样或调用失败
+     */
+    bool getCpuProfile(QByteArray &profile);
+    void stopCpuProfile();
+
+    /**
+     * @brief 异步批量控制进程，整批只发起一次调用、鉴权一次，结果由 processesControlled 通知
+     * @param pids 目标进程，不超过 PROCESS_CONTROL_MAX_PIDS 个
+     * @param action process_control_action_t，参数 value 的取值见 process_info_record.h
+     * @return false: 服务不可用或不支持，调用方应回退到 pkexec
+     */
+    bool controlProcesses(const QList<pid_t> &pids, int action, int value);
+    /**
+     * @brief 异步批量设置进程全部线程的 CPU 亲和性，结果以 PROCESS_CONTROL_AFFINITY 由 processesControlled 通知
+     * @param cpus cpu_set_t 位图，value 为其中的 CPU 数
+     * @return false: 服务不可用或不支持
+     */
+    bool setProcessesAffinity(const QList<pid_t> &pids, const QByteArray &cpus);
+    /**
+     * @brief 异步限制进程的 CPU、内存与 IO 权重，进程被移入独立的临时 scope，结果由 processLimited 通知
+     * @param limits 各项的单位与取值见 process_info_record.h，RESOURCE_LIMIT_NONE 为不限制
+     * @return false: 服务不可用或不支持
+     */
+    bool limitProcess(pid_t pid, const resource_limits_t &limits);
     
     // 启动系统服务
     bool startSystemService();
@@ -38,6 +223,11 @@ public:
 signals:
     void serviceConnectionChanged(bool connected);
     void dkaptureAvailabilityChanged(bool available);
+    // errors 与 pids 一一对应，调用失败时为空，调用方应回退到 pkexec
+    void processesControlled(const QList<pid_t> &pids, int action, int value, const QList<int> &errors);
+    // error 为空表示成功
+    void processLimited(pid_t pid, const QString &error);
+    void cpuProfileStarted(pid_t pid, bool started);
 
 private slots:
     void onServiceRegistered(const QString &serviceName);
@@ -47,12 +237,55 @@ private slots:
 private:
     void connectToService();
     void disconnectFromService();
+    // 订阅并映射共享内存进程快照
+    bool openProcessInfoSnapshots();
+    void closeProcessInfoSnapshots();
+    void cancelProcessInfoRequest();
+    // 整理接口返回值，校验失败时关闭对应接口
+    QVariantMap decodeProcessInfoBatch(const QVariantMap &data);
+    bool acceptProcessInfoRecords(QByteArray &records);
+    bool acceptProcessInfoDelta(QByteArray &delta);
+    void processInfoCallFailed(ProcessInfoReply kind, const QDBusError &error);
+    // 异步调用进程控制接口，结果由 processesControlled 通知，supported 在服务没有该接口时置为 false
+    void callProcessControl(const QDBusMessage &msg, const QList<pid_t> &pids, int action, int value, bool &supported);
 
     QDBusInterface *m_interface;
     QDBusServiceWatcher *m_serviceWatcher;
     QTimer *m_connectionTimer;
     bool m_serviceAvailable;
     bool m_dkaptureAvailable;
+    // 旧版本服务没有 getProcessInfoRecords，重新连接前不再尝试
+    bool m_recordsSupported;
+    bool m_deltaSupported;
+    // 共享内存进程快照，只读映射
+    const process_info_shm_header_t *m_snapshot;
+    size_t m_snapshotSize;
+    bool m_snapshotSupported;
+    QByteArray m_snapshotRecords;
+    // 进行中的异步进程信息请求
+    QDBusPendingCallWatcher *m_pendingProcessInfo;
+    ProcessInfoReply m_pendingKind;
+    QElapsedTimer m_pendingClock;
+    // openFileActivity 成功的进程，断开连接后服务端已清理
+    QList<pid_t> m_fileActivityPids;
+    // openIrqStats 成功，断开连接后服务端已清理
+    bool m_irqStatsOpened;
+    // openBlockLatency 成功，断开连接后服务端已清理
+    bool m_blockLatencyOpened;
+    // openWakeups 成功，断开连接后服务端已清理
+    bool m_wakeupsOpened;
+    // openDiskHealth 成功，断开连接后服务端已清理
+    bool m_diskHealthOpened;
+    // startMemleakScan 成功，断开连接后服务端已取消扫描
+    bool m_memleakScanStarted;
+    // startCpuProfile 成功，断开连接后服务端已取消采样
+    bool m_cpuProfileStarted;
+    // 旧版本服务没有 controlProcesses，重新连接前不再尝试
+    bool m_processControlSupported;
+    bool m_affinitySupported;
+    bool m_limitSupported;
+    bool m_kernelStacksSupported;
+    bool m_cpuProfileSupported;
     
     static const QString SERVICE_NAME;
     static const QString SERVICE_PATH;
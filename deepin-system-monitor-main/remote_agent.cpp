@@ -0,0 +1,328 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "remote_agent.h"
+#include "ddlog.h"
+
+#include "common/thread_manager.h"
+#include "process/process_db.h"
+#include "process/process_set.h"
+#include "system/device_db.h"
+#include "system/device_snapshot.h"
+#include "system/refresh_scheduler.h"
+#include "system/system_monitor.h"
+#include "system/system_monitor_thread.h"
+
+#include <QCoreApplication>
+#include <QSet>
+#include <QSocketNotifier>
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace common::core;
+using namespace core::system;
+using namespace core::process;
+using namespace DDLog;
+
+// pending connections of the agent port
+const int kListenBacklog = 8;
+// ms a client may stall a write before it's dropped
+const int kSendTimeout = 2000;
+
+RemoteAgent::RemoteAgent(const Options &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+{
+    qCDebug(app) << "RemoteAgent constructor";
+    m_clock.start();
+}
+
+RemoteAgent::~RemoteAgent()
+{
+    for (const client_t &client : m_clients) {
+        if (client.fd != STDOUT_FILENO)
+            close(client.fd);
+    }
+    if (m_listenFd >= 0)
+        close(m_listenFd);
+}
+
+bool RemoteAgent::start()
+{
+    if (m_options.port > 0 && !listen())
+        return false;
+
+    SystemMonitor *monitor = ThreadManager::instance()->thread<SystemMonitorThread>(BaseThread::kSystemMonitorThread)->systemMonitorInstance();
+    // built on the monitor thread, the process set is only consistent in between its refreshes
+    connect(monitor, &SystemMonitor::statInfoUpdated, this, &RemoteAgent::onStatInfoUpdated, Qt::DirectConnection);
+    // stdout is the only client then
+    if (m_options.port <= 0)
+        m_clients << client_t {STDOUT_FILENO, true};
+    qCInfo(app) << "Remote agent every" << m_options.interval << "ms to"
+                << (m_options.port > 0 ? QString("127.0.0.1:%1").arg(m_options.port) : QString("stdout"));
+    return true;
+}
+
+bool RemoteAgent::listen()
+{
+    m_listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_listenFd < 0) {
+        qCWarning(app) << "Failed to create agent socket:" << strerror(errno);
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    // loopback only, there's no transport security, remote GUIs reach it through an ssh tunnel
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(quint16(m_options.port));
+    if (bind(m_listenFd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0
+        || ::listen(m_listenFd, kListenBacklog) != 0) {
+        qCWarning(app) << "Failed to listen on agent port" << m_options.port << ":" << strerror(errno);
+        close(m_listenFd);
+        m_listenFd = -1;
+        return false;
+    }
+
+    m_notifier = new QSocketNotifier(m_listenFd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &RemoteAgent::acceptClients);
+    return true;
+}
+
+void RemoteAgent::acceptClients()
+{
+    int fd;
+    while ((fd = accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC)) >= 0) {
+        // a baseline may exceed the socket buffer, writes block until it drains or time out
+        struct timeval timeout {kSendTimeout / 1000, 0};
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        qCDebug(app) << "Agent client connected, fd" << fd;
+        m_clients << client_t {fd, true};
+        m_baselineWanted = true;
+    }
+}
+
+bool RemoteAgent::writeAll(int fd, const QByteArray &data)
+{
+    if (fd == STDOUT_FILENO) {
+        // ssh applies the backpressure, a slow link slows the agent's writes, not its sampling
+        if (fwrite(data.constData(), 1, size_t(data.size()), stdout) != size_t(data.size()) || fflush(stdout) != 0) {
+            qCWarning(app) << "Failed to write agent stream to stdout:" << strerror(errno);
+            return false;
+        }
+        return true;
+    }
+    // a timed out write means the client stopped reading, frames can't be dropped from a stream
+    ssize_t nr = send(fd, data.constData(), size_t(data.size()), MSG_NOSIGNAL);
+    if (nr == ssize_t(data.size()))
+        return true;
+    qCDebug(app) << "Dropping agent client, fd" << fd << (nr < 0 ? strerror(errno) : "partial write");
+    return false;
+}
+
+void RemoteAgent::writeFrames(const QByteArray &hello, const QByteArray &system, const QByteArray &delta,
+                              const QByteArray &baseline)
+{
+    for (auto it = m_clients.begin(); it != m_clients.end();) {
+        if (it->baseline && baseline.isEmpty()) {
+            // joined after this refresh was built, the next one brings its baseline
+            ++it;
+            continue;
+        }
+        // a stream opens with the hello, right ahead of its baseline
+        if (writeAll(it->fd, it->baseline ? hello + system + baseline : system + delta)) {
+            it->baseline = false;
+            ++it;
+            continue;
+        }
+        if (it->fd == STDOUT_FILENO) {
+            QCoreApplication::quit();
+            return;
+        }
+        close(it->fd);
+        it = m_clients.erase(it);
+    }
+}
+
+QByteArray RemoteAgent::encodeFrame(remote_frame_type_t type, const QByteArray &payload)
+{
+    remote_frame_header_t hdr {};
+    hdr.magic = REMOTE_AGENT_MAGIC;
+    hdr.type = type;
+    QByteArray body = payload;
+    if (payload.size() >= kCompressThreshold) {
+        QByteArray compressed = qCompress(payload);
+        if (compressed.size() < payload.size()) {
+            body = compressed;
+            hdr.flags |= REMOTE_FRAME_COMPRESSED;
+        }
+    }
+    hdr.length = uint32_t(body.size());
+
+    QByteArray frame;
+    frame.reserve(int(sizeof(hdr)) + body.size());
+    frame.append(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+    frame.append(body);
+    return frame;
+}
+
+QByteArray RemoteAgent::encodeDelta(const QHash<pid_t, process_info_record_t> &previous,
+                                    const QHash<pid_t, process_info_record_t> &current,
+                                    quint64 generation, bool baseline, QList<pid_t> &created)
+{
+    // same as the system server's getProcessInfoDelta, changes are detected per record
+    QList<const process_info_record_t *> changed;
+    QList<int32_t> exited;
+    created.clear();
+    for (auto it = current.cbegin(); it != current.cend(); ++it) {
+        auto prev = baseline ? previous.cend() : previous.constFind(it.key());
+        if (prev == previous.cend() || prev->start_time != it->start_time)
+            created << it.key();
+        if (prev == previous.cend() || memcmp(&prev.value(), &it.value(), sizeof(process_info_record_t)) != 0)
+            changed << &it.value();
+    }
+    if (!baseline) {
+        for (auto it = previous.cbegin(); it != previous.cend(); ++it) {
+            if (!current.contains(it.key()))
+                exited << it.key();
+        }
+    }
+
+    process_info_delta_header_t hdr {};
+    hdr.magic = PROCESS_INFO_DELTA_MAGIC;
+    hdr.version = PROCESS_INFO_DELTA_VERSION;
+    hdr.record_size = sizeof(process_info_record_t);
+    hdr.generation = generation;
+    hdr.flags = baseline ? kProcessInfoDeltaBaseline : 0;
+    hdr.count = uint32_t(changed.size());
+    hdr.exited = uint32_t(exited.size());
+
+    QByteArray result;
+    result.reserve(int(processInfoDeltaSize(hdr.count, hdr.exited)));
+    result.append(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+    for (const process_info_record_t *rec : changed)
+        result.append(reinterpret_cast<const char *>(rec), sizeof(*rec));
+    for (int32_t pid : exited)
+        result.append(reinterpret_cast<const char *>(&pid), sizeof(pid));
+    return result;
+}
+
+QByteArray RemoteAgent::helloFrame(int interval)
+{
+    remote_hello_t hello {};
+    hello.version = REMOTE_AGENT_VERSION;
+    hello.byte_order = REMOTE_AGENT_BYTE_ORDER;
+    hello.record_size = sizeof(process_info_record_t);
+    hello.interval = uint32_t(interval);
+    gethostname(hello.hostname, sizeof(hello.hostname) - 1);
+
+    QByteArray payload(reinterpret_cast<const char *>(&hello), sizeof(hello));
+    {
+        QByteArray info;
+        QDataStream out(&info, QIODevice::WriteOnly);
+        out.setVersion(kStreamVersion);
+        DeviceSnapshotPtr snapshot = DeviceDB::instance()->snapshot();
+        if (snapshot)
+            snapshot->cpuSet.saveInfo(out);
+        else
+            CPUSet().saveInfo(out);
+        payload.append(info);
+    }
+    return encodeFrame(REMOTE_FRAME_HELLO, payload);
+}
+
+QByteArray RemoteAgent::systemPayload()
+{
+    // the head of a flight recorder frame, read back the same way
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(kStreamVersion);
+    DeviceSnapshotPtr snapshot = DeviceDB::instance()->snapshot();
+    snapshot->cpuSet.saveStats(out);
+    snapshot->memInfo.save(out);
+    out << snapshot->diskReadBps << snapshot->diskWriteBps << snapshot->netRecvBps << snapshot->netSentBps
+        << snapshot->netTotalRecvBytes << snapshot->netTotalSentBytes;
+    // stall rates of cpu, memory & io, not part of a recorder frame
+    for (const common::pressure::pressure_t &pressure : snapshot->pressure)
+        out << pressure.valid << pressure.hasRates << pressure.someRate << pressure.fullRate;
+    return payload;
+}
+
+QByteArray RemoteAgent::processesFrame(const QMap<pid_t, Process> &procs,
+                                       const QHash<pid_t, process_info_record_t> &previous,
+                                       const QHash<pid_t, process_info_record_t> &current, bool baseline)
+{
+    QList<pid_t> created;
+    QByteArray payload = encodeDelta(previous, current, m_generation, baseline, created);
+
+    // names of created processes, app types whenever they're new or changed
+    QByteArray names;
+    QDataStream out(&names, QIODevice::WriteOnly);
+    out.setVersion(kStreamVersion);
+    quint32 count = 0;
+    QSet<pid_t> named;
+    for (pid_t pid : created)
+        named.insert(pid);
+    for (auto it = current.cbegin(); it != current.cend(); ++it) {
+        const Process &proc = procs[it.key()];
+        bool withNames = named.contains(it.key());
+        auto type = m_appTypes.constFind(it.key());
+        if (!withNames && !baseline && type != m_appTypes.cend() && *type == proc.appType())
+            continue;
+        out << qint32(it.key()) << qint32(proc.appType()) << withNames;
+        if (withNames)
+            proc.saveNames(out);
+        ++count;
+    }
+    payload.append(reinterpret_cast<const char *>(&count), sizeof(count));
+    payload.append(names);
+    return encodeFrame(REMOTE_FRAME_PROCESSES, payload);
+}
+
+void RemoteAgent::onStatInfoUpdated()
+{
+    qint64 now = m_clock.elapsed();
+    if (m_lastFrame >= 0 && now - m_lastFrame + RefreshScheduler::kDueSlack < m_options.interval)
+        return;
+    m_lastFrame = now;
+
+    SystemMonitor *monitor = ThreadManager::instance()->thread<SystemMonitorThread>(BaseThread::kSystemMonitorThread)->systemMonitorInstance();
+    const ProcessSnapshotPtr snapshot = monitor->processDB()->processSet()->snapshot();
+    QHash<pid_t, process_info_record_t> current;
+    current.reserve(snapshot->processes.size());
+    for (const Process &proc : snapshot->processes) {
+        if (!proc.isValid())
+            continue;
+        proc.saveRecord(current[proc.pid()]);
+    }
+
+    ++m_generation;
+    QByteArray delta = processesFrame(snapshot->processes, m_sent, current, false);
+    QByteArray baseline;
+    if (m_baselineWanted.exchange(false)) {
+        baseline = processesFrame(snapshot->processes, {}, current, true);
+        // the cpu info is read along with the first refresh
+        if (m_hello.isEmpty())
+            m_hello = helloFrame(m_options.interval);
+    }
+    QHash<pid_t, int> appTypes;
+    appTypes.reserve(current.size());
+    for (auto it = current.cbegin(); it != current.cend(); ++it)
+        appTypes.insert(it.key(), snapshot->processes[it.key()].appType());
+    m_appTypes.swap(appTypes);
+    m_sent.swap(current);
+
+    QByteArray system = encodeFrame(REMOTE_FRAME_SYSTEM, systemPayload());
+    QByteArray hello = baseline.isEmpty() ? QByteArray() : m_hello;
+    QMetaObject::invokeMethod(this, [this, hello, system, delta, baseline]() {
+        writeFrames(hello, system, delta, baseline);
+    }, Qt::QueuedConnection);
+}
@@ -0,0 +1,118 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef REMOTE_AGENT_H
+#define REMOTE_AGENT_H
+
+#include "process_info_record.h"
+
+#include <QObject>
+#include <QByteArray>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMap>
+
+#include <atomic>
+
+class QSocketNotifier;
+
+namespace core {
+namespace process {
+class Process;
+} // namespace process
+} // namespace core
+
+/**
+ * @brief Streams sampled state to a remote GUI, run by --headless --agent
+ *
+ * Frames are built on the system monitor thread right after each refresh & written from the
+ * thread the agent lives in. Processes are sent as process info deltas, only records that changed
+ * since the previous refresh & pids that exited, names once per process; frames are compressed,
+ * so an idle host costs a few hundred bytes a refresh. The stream goes to stdout, to be run over
+ * ssh, or to every client of a loopback tcp port, a client joining later starts with a baseline.
+ */
+class RemoteAgent : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        int interval {2000}; // ms between refreshes
+        int port {0}; // tcp port on 127.0.0.1, stdout if 0
+    };
+
+    explicit RemoteAgent(const Options &options, QObject *parent = nullptr);
+    ~RemoteAgent() override;
+
+    /**
+     * @brief Listen & build frames after each monitor refresh, call before the monitor thread starts
+     * @return false if the port can't be listened on
+     */
+    bool start();
+
+    /**
+     * @brief Frame of a payload, compressed if that makes it smaller
+     */
+    static QByteArray encodeFrame(remote_frame_type_t type, const QByteArray &payload);
+    /**
+     * @brief Process info delta of current against previous, all of current for a baseline
+     * @param created Pids new since previous, all pids for a baseline
+     */
+    static QByteArray encodeDelta(const QHash<pid_t, process_info_record_t> &previous,
+                                  const QHash<pid_t, process_info_record_t> &current,
+                                  quint64 generation, bool baseline, QList<pid_t> &created);
+    /**
+     * @brief Hello frame opening a stream, with the cpu info of this host
+     */
+    static QByteArray helloFrame(int interval);
+
+    // payloads smaller than this are sent as is
+    static constexpr int kCompressThreshold = 256;
+    // stream version of the QDataStream parts of frames
+    static constexpr QDataStream::Version kStreamVersion = QDataStream::Qt_5_11;
+
+private:
+    struct client_t {
+        int fd;
+        bool baseline; // waits for a baseline, nothing else is sent until then
+    };
+
+    bool listen();
+    void acceptClients();
+    /**
+     * @brief Write frames of a refresh, the hello & a baseline to the clients waiting for one
+     */
+    void writeFrames(const QByteArray &hello, const QByteArray &system, const QByteArray &delta,
+                     const QByteArray &baseline);
+    bool writeAll(int fd, const QByteArray &data);
+    void onStatInfoUpdated();
+    QByteArray systemPayload();
+    /**
+     * @brief Processes frame of current against previous, with the names of created processes
+     * & the app types that changed
+     */
+    QByteArray processesFrame(const QMap<pid_t, core::process::Process> &procs,
+                              const QHash<pid_t, process_info_record_t> &previous,
+                              const QHash<pid_t, process_info_record_t> &current, bool baseline);
+
+private:
+    Options m_options;
+    int m_listenFd {-1};
+    QSocketNotifier *m_notifier {};
+    QList<client_t> m_clients;
+    // set by the agent thread when a client waits, taken by the monitor thread
+    std::atomic<bool> m_baselineWanted {true};
+
+    // monitor thread side
+    QElapsedTimer m_clock;
+    QByteArray m_hello;
+    qint64 m_lastFrame {-1};
+    quint64 m_generation {0};
+    QHash<pid_t, process_info_record_t> m_sent; // records as of the last delta
+    QHash<pid_t, int> m_appTypes; // app type last sent by pid
+};
+
+#endif // REMOTE_AGENT_H
@@ -0,0 +1,195 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "journal_tail.h"
+#include "ddlog.h"
+
+#include <QMutexLocker>
+#include <QTimer>
+
+#include <systemd/sd-journal.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace DDLog;
+
+// usecs sd_journal_wait blocks at most, bounds how long a stopped worker lingers
+const quint64 kWaitTimeout = 250 * 1000;
+
+static QString fieldOf(sd_journal *journal, const char *field)
+{
+    const void *data = nullptr;
+    size_t length = 0;
+    if (sd_journal_get_data(journal, field, &data, &length) < 0)
+        return {};
+    // FIELD=value
+    const size_t prefix = strlen(field) + 1;
+    if (length < prefix)
+        return {};
+    return QString::fromUtf8(static_cast<const char *>(data) + prefix, int(length - prefix));
+}
+
+static JournalLine lineOf(sd_journal *journal)
+{
+    JournalLine line;
+    uint64_t usec = 0;
+    if (sd_journal_get_realtime_usec(journal, &usec) >= 0)
+        line.time = qint64(usec);
+    bool ok = false;
+    int priority = fieldOf(journal, "PRIORITY").toInt(&ok);
+    if (ok)
+        line.priority = priority;
+    line.pid = fieldOf(journal, "_PID").toInt();
+    line.identifier = fieldOf(journal, "SYSLOG_IDENTIFIER");
+    if (line.identifier.isEmpty())
+        line.identifier = fieldOf(journal, "_COMM");
+    line.message = fieldOf(journal, "MESSAGE");
+    return line;
+}
+
+JournalTailWorker::JournalTailWorker(const QString &unit, int backlog)
+    : m_unit(unit)
+    , m_backlog(backlog)
+{
+}
+
+QVector<JournalLine> JournalTailWorker::takeLines(int &dropped)
+{
+    QMutexLocker locker(&m_mutex);
+    QVector<JournalLine> lines;
+    lines.swap(m_lines);
+    dropped = m_dropped;
+    m_dropped = 0;
+    return lines;
+}
+
+void JournalTailWorker::append(const JournalLine &line)
+{
+    QMutexLocker locker(&m_mutex);
+    // nobody takes them, the older half goes
+    if (m_lines.size() >= JournalTail::kMaxPendingLines) {
+        const int half = m_lines.size() / 2;
+        m_lines.remove(0, half);
+        m_dropped += half;
+    }
+    m_lines << line;
+}
+
+void JournalTailWorker::run()
+{
+    sd_journal *journal = nullptr;
+    bool readCurrent = false;
+    while (!m_quitRequested.load()) {
+        if (!journal) {
+            int r = sd_journal_open(&journal, SD_JOURNAL_LOCAL_ONLY);
+            if (r < 0) {
+                qCWarning(app) << "Journal can't be opened:" << strerror(-r);
+                m_failed.store(true);
+                return;
+            }
+            for (const QByteArray &match : JournalTail::matchesOf(m_unit)) {
+                if (match.isEmpty())
+                    sd_journal_add_disjunction(journal);
+                else
+                    sd_journal_add_match(journal, match.constData(), size_t(match.size()));
+            }
+
+            // unless resumed, the last lines come first
+            if (!m_cursor.isEmpty() && sd_journal_seek_cursor(journal, m_cursor.constData()) >= 0) {
+                readCurrent = sd_journal_next(journal) > 0 && sd_journal_test_cursor(journal, m_cursor.constData()) <= 0;
+            } else {
+                sd_journal_seek_tail(journal);
+                readCurrent = sd_journal_previous_skip(journal, uint64_t(m_backlog)) > 0;
+            }
+        }
+
+        int r = readCurrent ? 1 : sd_journal_next(journal);
+        readCurrent = false;
+        if (r == 0) {
+            // caught up, woken by new entries or the timeout to see if we should quit
+            r = sd_journal_wait(journal, kWaitTimeout);
+            if (r >= 0)
+                continue;
+        }
+        if (r < 0) {
+            // e.g. journal files deleted under it, opened again past the cursor
+            qCWarning(app) << "Journal of" << m_unit << "failed, reopening:" << strerror(-r);
+            sd_journal_close(journal);
+            journal = nullptr;
+            msleep(kWaitTimeout / 1000);
+            continue;
+        }
+        append(lineOf(journal));
+        char *cursor = nullptr;
+        if (sd_journal_get_cursor(journal, &cursor) >= 0) {
+            m_cursor = cursor;
+            free(cursor);
+        }
+    }
+    if (journal)
+        sd_journal_close(journal);
+}
+
+JournalTail::JournalTail(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+{
+    m_timer->setInterval(kDeliverInterval);
+    connect(m_timer, &QTimer::timeout, this, &JournalTail::deliver);
+}
+
+JournalTail::~JournalTail()
+{
+    if (m_worker) {
+        m_worker->requestQuit();
+        m_worker->wait();
+        delete m_worker;
+    }
+}
+
+QList<QByteArray> JournalTail::matchesOf(const QString &unit)
+{
+    // journalctl -u: what its processes log, or what systemd logs about it
+    const QByteArray name = unit.toUtf8();
+    return {"_SYSTEMD_UNIT=" + name, QByteArray(), "_PID=1", "UNIT=" + name};
+}
+
+void JournalTail::follow(const QString &unit)
+{
+    stop();
+    qCDebug(app) << "Following journal of" << unit;
+    m_unit = unit;
+    m_worker = new JournalTailWorker(unit, kBacklogLines);
+    m_worker->start(QThread::LowPriority);
+    m_timer->start();
+}
+
+void JournalTail::stop()
+{
+    m_timer->stop();
+    if (!m_worker)
+        return;
+    // quits within kWaitTimeout & deletes itself, nothing waits on it
+    m_worker->requestQuit();
+    connect(m_worker, &QThread::finished, m_worker, &QObject::deleteLater);
+    if (m_worker->isFinished())
+        m_worker->deleteLater();
+    m_worker = nullptr;
+}
+
+void JournalTail::deliver()
+{
+    if (!m_worker)
+        return;
+
+    int dropped = 0;
+    const QVector<JournalLine> lines = m_worker->takeLines(dropped);
+    if (!lines.isEmpty() || dropped > 0)
+        emit linesAppended(lines, dropped);
+    if (m_worker->failed()) {
+        stop();
+        emit failed();
+    }
+}
@@ -0,0 +1,118 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef JOURNAL_TAIL_H
+#define JOURNAL_TAIL_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QThread>
+#include <QVector>
+
+#include <atomic>
+
+class QTimer;
+
+/**
+ * @brief Journal entry of a followed unit
+ */
+struct JournalLine {
+    qint64 time {0}; // realtime, usecs since epoch
+    int priority {6}; // syslog level, 0 emerg ~ 7 debug
+    int pid {0};
+    QString identifier; // SYSLOG_IDENTIFIER, the command name without one
+    QString message;
+};
+
+/**
+ * @brief Reads the journal of a unit on its own thread, see JournalTail
+ */
+class JournalTailWorker : public QThread
+{
+public:
+    JournalTailWorker(const QString &unit, int backlog);
+
+    /**
+     * @brief Lines read since the last call, removed from the worker
+     * @param dropped Set to lines dropped meanwhile since nobody took them in time
+     */
+    QVector<JournalLine> takeLines(int &dropped);
+    bool failed() const { return m_failed.load(); }
+    void requestQuit() { m_quitRequested.store(true); }
+
+protected:
+    void run() override;
+
+private:
+    void append(const JournalLine &line);
+
+    QString m_unit;
+    int m_backlog;
+    QMutex m_mutex;
+    QVector<JournalLine> m_lines; // guarded by m_mutex
+    int m_dropped {0};
+    QByteArray m_cursor; // of the last entry read, worker thread only
+    std::atomic_bool m_quitRequested {false};
+    std::atomic_bool m_failed {false};
+};
+
+/**
+ * @brief Follows the journal of a unit like journalctl -f -u
+ *
+ * Entries of the unit's processes (_SYSTEMD_UNIT) & the messages systemd logs about it are
+ * read from the tail on a worker that waits in sd_journal_wait, so a busy journal never blocks
+ * the ui. The last kBacklogLines come first. Lines are handed over in one batch every
+ * kDeliverInterval, lines of a unit logging faster than can be taken are dropped & counted.
+ * The worker resumes from the cursor of its last entry if the journal has to be opened again.
+ */
+class JournalTail : public QObject
+{
+    Q_OBJECT
+
+public:
+    // lines read back from the tail when following starts
+    static constexpr int kBacklogLines = 500;
+    // ms between batches
+    static constexpr int kDeliverInterval = 100;
+    // lines held for the next batch at most
+    static constexpr int kMaxPendingLines = 20000;
+
+    explicit JournalTail(QObject *parent = nullptr);
+    ~JournalTail() override;
+
+    /**
+     * @brief Stop following the previous unit & follow \a unit, e.g. dbus.service
+     */
+    void follow(const QString &unit);
+    void stop();
+    inline QString unit() const { return m_unit; }
+    inline bool isFollowing() const { return m_worker != nullptr; }
+
+    /**
+     * @brief Match terms of sd_journal_add_match for \a unit, groups separated by an empty term
+     */
+    static QList<QByteArray> matchesOf(const QString &unit);
+
+Q_SIGNALS:
+    /**
+     * @brief Lines read since the last batch, oldest first
+     * @param dropped Lines dropped before these
+     */
+    void linesAppended(const QVector<JournalLine> &lines, int dropped);
+    /**
+     * @brief The journal can't be read, e.g. without permission
+     */
+    void failed();
+
+private:
+    void deliver();
+
+    QString m_unit;
+    JournalTailWorker *m_worker {};
+    QTimer *m_timer {};
+};
+
+#endif // JOURNAL_TAIL_H
@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "service_dependency_graph.h"
+#include "ddlog.h"
+#include "dbus/dbus_common.h"
+#include "dbus/dbus_properties_interface.h"
+#include "dbus/systemd1_service_interface.h"
+#include "dbus/systemd1_unit_interface.h"
+
+#include <QDBusConnection>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+
+using namespace DDLog;
+
+ServiceDependencyGraph::ServiceDependencyGraph(QObject *parent)
+    : QObject(parent)
+{
+}
+
+const DependencyNode *ServiceDependencyGraph::node(const QString &unit) const
+{
+    auto it = m_nodes.constFind(unit);
+    return it != m_nodes.cend() ? &it.value() : nullptr;
+}
+
+void ServiceDependencyGraph::fetch(const QString &unit)
+{
+    if (m_nodes.contains(unit) || m_pendingUnits.contains(unit))
+        return;
+    m_pendingUnits << unit;
+
+    auto bus = QDBusConnection::systemBus();
+    auto opath = Systemd1UnitInterface::normalizeUnitPath(unit).path();
+    auto unitCall = DBusPropertiesInterface::asyncGetAll(DBUS_SYSTEMD1_SERVICE, opath, Systemd1UnitInterface::staticInterfaceName(), bus);
+    // ExecMainStartTimestamp is a property of services only
+    bool isService = unit.endsWith(UnitTypeServiceSuffix);
+    auto lastCall = isService ? DBusPropertiesInterface::asyncGetAll(DBUS_SYSTEMD1_SERVICE, opath, Systemd1ServiceInterface::staticInterfaceName(), bus)
+                              : unitCall;
+    auto *watcher = new QDBusPendingCallWatcher(lastCall, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, unit, unitCall, isService](QDBusPendingCallWatcher *call) {
+        call->deleteLater();
+        m_pendingUnits.remove(unit);
+        if (m_staleUnits.remove(unit)) {
+            fetch(unit);
+            return;
+        }
+
+        // sent first, answered first
+        QDBusPendingReply<QVariantMap> unitReply = unitCall;
+        unitReply.waitForFinished();
+        if (unitReply.isError()) {
+            qCWarning(app) << "Failed to get dependencies of" << unit << ":" << unitReply.error().name() << unitReply.error().message();
+            Q_EMIT nodeFetched(unit);
+            return;
+        }
+        QVariantMap serviceProps;
+        if (isService) {
+            QDBusPendingReply<QVariantMap> serviceReply = *call;
+            if (!serviceReply.isError())
+                serviceProps = serviceReply.value();
+        }
+        m_nodes.insert(unit, nodeFromProperties(unit, unitReply.value(), serviceProps));
+        Q_EMIT nodeFetched(unit);
+    });
+}
+
+void ServiceDependencyGraph::invalidate(const QString &unit)
+{
+    if (m_pendingUnits.contains(unit))
+        m_staleUnits << unit;
+    m_nodes.remove(unit);
+}
+
+DependencyNode ServiceDependencyGraph::nodeFromProperties(const QString &unit, const QVariantMap &unitProps,
+                                                          const QVariantMap &serviceProps)
+{
+    DependencyNode node;
+    node.unit = unit;
+    node.description = unitProps.value("Description").toString();
+    node.activeState = unitProps.value("ActiveState").toString();
+    node.requires = unitProps.value("Requires").toStringList();
+    node.wants = unitProps.value("Wants").toStringList();
+    node.after = unitProps.value("After").toStringList();
+    // monotonic stamps, realtime ones jump with clock changes during boot
+    node.startupUsec = startupDuration(serviceProps.value("ExecMainStartTimestampMonotonic").toULongLong(),
+                                       unitProps.value("InactiveExitTimestampMonotonic").toULongLong(),
+                                       unitProps.value("ActiveEnterTimestampMonotonic").toULongLong());
+    return node;
+}
+
+qint64 ServiceDependencyGraph::startupDuration(quint64 execMainStart, quint64 inactiveExit, quint64 activeEnter)
+{
+    quint64 start = execMainStart ? execMainStart : inactiveExit;
+    if (!start || activeEnter < start)
+        return -1;
+    return qint64(activeEnter - start);
+}
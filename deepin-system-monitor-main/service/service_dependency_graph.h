@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SERVICE_DEPENDENCY_GRAPH_H
+#define SERVICE_DEPENDENCY_GRAPH_H
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QVariantMap>
+
+/**
+ * @brief Dependencies & startup time of a unit
+ */
+struct DependencyNode {
+    QString unit; // unit id, e.g. dbus.service
+    QString description;
+    QString activeState;
+    QStringList requires;
+    QStringList wants;
+    QStringList after;
+    qint64 startupUsec {-1}; // time taken to become active at its last start, -1 if unknown
+};
+
+/**
+ * @brief Unit dependency graph of systemd, fetched one node at a time
+ *
+ * Nodes are asked for with GetAll calls when the graph is expanded to them & cached until their unit
+ * changes, so only the part looked at is ever read, instead of a full systemd-analyze run.
+ */
+class ServiceDependencyGraph : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ServiceDependencyGraph(QObject *parent = nullptr);
+
+    /**
+     * @brief Cached node of a unit, null until it's fetched
+     */
+    const DependencyNode *node(const QString &unit) const;
+    /**
+     * @brief Ask a unit's properties without blocking, nodeFetched tells the result
+     *
+     * Cached nodes & units already asked for aren't asked again.
+     */
+    void fetch(const QString &unit);
+    /**
+     * @brief Forget the node of a unit, e.g. after it restarted
+     */
+    void invalidate(const QString &unit);
+
+    /**
+     * @brief Node of GetAll replies of a unit object's unit & service interfaces
+     */
+    static DependencyNode nodeFromProperties(const QString &unit, const QVariantMap &unitProps,
+                                             const QVariantMap &serviceProps);
+    /**
+     * @brief Time from exec of the main process, or from leaving the inactive state if there's none,
+     * to entering the active state, monotonic usecs
+     * @return -1 if the unit didn't become active since it last started
+     */
+    static qint64 startupDuration(quint64 execMainStart, quint64 inactiveExit, quint64 activeEnter);
+
+Q_SIGNALS:
+    /**
+     * @brief Node of a unit fetched, its cached node is null if the unit can't be read
+     */
+    void nodeFetched(const QString &unit);
+
+private:
+    QHash<QString, DependencyNode> m_nodes; // by unit id
+    QSet<QString> m_pendingUnits;
+    QSet<QString> m_staleUnits; // invalidated while asked for
+};
+
+#endif // SERVICE_DEPENDENCY_GRAPH_H
@@ -15,6 +15,8 @@
 #include "dbus/unit_info.h"
 #include "service/system_service_entry.h"
 #include "service/service_manager_worker.h"
+#include "process_info_record.h"
+#include "system/demand_tracker.h"
 
 #include <DApplication>
 #include <DLog>
@@ -70,6 +72,29 @@ static bool setServiceEnable(const QString &servieName, bool enable, QString &er
     }
 }
 
+/**
+   @brief 使用后端 DBus 服务运行时设置 systemd 服务 \a serviceName 的资源限制
+ */
+static bool setServiceLimits(const QString &serviceName, const resource_limits_t &limits, QString &errorString)
+{
+    qCDebug(app) << "Limiting service" << serviceName << "cpu" << limits.cpu_quota << "memory" << limits.memory_high
+                 << "io" << limits.io_weight;
+    QDBusInterface interface("org.deepin.SystemMonitorSystemServer",
+                             "/org/deepin/SystemMonitorSystemServer",
+                             "org.deepin.SystemMonitorSystemServer",
+                             QDBusConnection::systemBus());
+    // 鉴权对话框打开期间调用不返回
+    interface.setTimeout(5 * 60 * 1000);
+    QDBusReply<QString> retMsg = interface.call("limitService", serviceName, qulonglong(limits.cpu_quota),
+                                                qulonglong(limits.memory_high), qulonglong(limits.io_weight));
+    errorString = retMsg.isValid() ? retMsg.value() : retMsg.error().message();
+    if (!errorString.isEmpty()) {
+        qCWarning(app) << "Limit service" << serviceName << "failed, error" << errorString;
+        return false;
+    }
+    return true;
+}
+
 CustomTimer::CustomTimer(ServiceManager *mgr, QObject *parent)
     : QObject(parent), m_mgr(mgr)
 {
@@ -110,8 +135,17 @@ ServiceManager::ServiceManager(QObject *parent)
     connect(this, &ServiceManager::beginUpdateList, m_worker, &ServiceManagerWorker::startJob);
     connect(&m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
     connect(m_worker, &ServiceManagerWorker::resultReady, this, &ServiceManager::serviceListUpdated);
+    connect(m_worker, &ServiceManagerWorker::entriesUpdated, this, &ServiceManager::serviceEntriesUpdated);
+    connect(m_worker, &ServiceManagerWorker::entriesDropped, this, &ServiceManager::serviceEntriesDropped);
+    connect(this, &ServiceManager::prioritizeRequested, m_worker, &ServiceManagerWorker::prioritize);
     qCDebug(app) << "Starting worker thread";
     m_workerThread.start();
+
+    watchUnits();
+    connect(core::system::DemandTracker::instance(), &core::system::DemandTracker::demandsChanged, this, [this](int, int gained) {
+        if (gained & core::system::DemandTracker::kServiceDemand)
+            refreshMissedEntries();
+    });
 }
 
 ServiceManager::~ServiceManager()
@@ -121,6 +155,148 @@ ServiceManager::~ServiceManager()
     m_workerThread.wait();
 }
 
+void ServiceManager::watchUnits()
+{
+    auto bus = QDBusConnection::systemBus();
+    const QString mgrInterface = Systemd1ManagerInterface::staticInterfaceName();
+    bool newWatched = bus.connect(DBUS_SYSTEMD1_SERVICE, kSystemDObjectPath.path(), mgrInterface, "UnitNew",
+                                  this, SLOT(onUnitNew(QString, QDBusObjectPath)));
+    bool removedWatched = bus.connect(DBUS_SYSTEMD1_SERVICE, kSystemDObjectPath.path(), mgrInterface, "UnitRemoved",
+                                      this, SLOT(onUnitRemoved(QString, QDBusObjectPath)));
+    // any unit object, the path is told by the message
+    bool changedWatched = bus.connect(DBUS_SYSTEMD1_SERVICE, {}, DBusPropertiesInterface::staticInterfaceName(), "PropertiesChanged",
+                                      this, SLOT(onUnitPropertiesChanged(QString, QVariantMap, QStringList, QDBusMessage)));
+    if (!newWatched || !removedWatched || !changedWatched) {
+        qCWarning(app) << "Unit changes can't be watched, services are polled after actions";
+        return;
+    }
+
+    // systemd emits unit signals to subscribed clients only
+    auto msg = QDBusMessage::createMethodCall(DBUS_SYSTEMD1_SERVICE, kSystemDObjectPath.path(), mgrInterface, "Subscribe");
+    QDBusReply<void> reply = bus.call(msg);
+    if (!reply.isValid()) {
+        qCWarning(app) << "Failed to subscribe to systemd:" << reply.error().name() << reply.error().message();
+        return;
+    }
+    m_unitsWatched = true;
+}
+
+bool ServiceManager::isServiceUnitPath(const QString &opath)
+{
+    // unit object paths are escaped unit ids, '.' being _2e
+    return opath.startsWith(SYSTEMD_UNIT_PATH) && opath.endsWith("_2eservice");
+}
+
+bool ServiceManager::takeUnitChange(const QString &opath)
+{
+    if (core::system::DemandTracker::instance()->isDemanded(core::system::DemandTracker::kServiceDemand))
+        return true;
+    // a unit changing many times while hidden is asked once when shown
+    m_missedPaths << opath;
+    return false;
+}
+
+void ServiceManager::refreshMissedEntries()
+{
+    if (m_missedPaths.isEmpty())
+        return;
+    qCDebug(app) << "Refreshing" << m_missedPaths.size() << "units changed while hidden";
+    const QSet<QString> paths = std::move(m_missedPaths);
+    m_missedPaths.clear();
+    for (const QString &opath : paths)
+        refreshServiceEntry(opath);
+}
+
+void ServiceManager::onUnitNew(const QString &id, const QDBusObjectPath &opath)
+{
+    if (!id.endsWith(UnitTypeServiceSuffix))
+        return;
+    qCDebug(app) << "Unit loaded:" << id;
+    if (takeUnitChange(opath.path()))
+        refreshServiceEntry(opath.path());
+}
+
+void ServiceManager::onUnitRemoved(const QString &id, const QDBusObjectPath &opath)
+{
+    if (!id.endsWith(UnitTypeServiceSuffix))
+        return;
+    qCDebug(app) << "Unit unloaded:" << id;
+    // not asked again, that would load the unit back
+    m_stalePaths.remove(opath.path());
+    m_missedPaths.remove(opath.path());
+    auto sname = id;
+    sname.chop(int(strlen(UnitTypeServiceSuffix)));
+    Q_EMIT serviceRemoved(sname);
+}
+
+void ServiceManager::onUnitPropertiesChanged(const QString &interfaceName, const QVariantMap &changedProperties,
+                                             const QStringList &invalidatedProperties, const QDBusMessage &msg)
+{
+    Q_UNUSED(interfaceName);
+    Q_UNUSED(changedProperties);
+    Q_UNUSED(invalidatedProperties);
+    // unit & service interfaces tell their changes apart, one refresh covers both
+    if (isServiceUnitPath(msg.path()) && takeUnitChange(msg.path()))
+        refreshServiceEntry(msg.path());
+}
+
+void ServiceManager::refreshServiceEntry(const QString &opath)
+{
+    // changes while asked for are asked again once answered
+    if (m_pendingPaths.contains(opath)) {
+        m_stalePaths << opath;
+        return;
+    }
+    m_pendingPaths << opath;
+
+    auto bus = QDBusConnection::systemBus();
+    auto unitCall = DBusPropertiesInterface::asyncGetAll(DBUS_SYSTEMD1_SERVICE, opath, Systemd1UnitInterface::staticInterfaceName(), bus);
+    auto serviceCall = DBusPropertiesInterface::asyncGetAll(DBUS_SYSTEMD1_SERVICE, opath, Systemd1ServiceInterface::staticInterfaceName(), bus);
+    auto *watcher = new QDBusPendingCallWatcher(serviceCall, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, opath, unitCall](QDBusPendingCallWatcher *call) {
+        call->deleteLater();
+        m_pendingPaths.remove(opath);
+        if (m_stalePaths.remove(opath)) {
+            refreshServiceEntry(opath);
+            return;
+        }
+
+        // sent first, answered first
+        QDBusPendingReply<QVariantMap> unitReply = unitCall;
+        unitReply.waitForFinished();
+        if (unitReply.isError()) {
+            qCWarning(app) << "Failed to get unit properties of" << opath << ":" << unitReply.error().name() << unitReply.error().message();
+            return;
+        }
+        QDBusPendingReply<QVariantMap> serviceReply = *call;
+        auto entry = entryFromProperties(opath, unitReply.value(), serviceReply.isError() ? QVariantMap {} : serviceReply.value());
+        if (entry.getId().endsWith(UnitTypeServiceSuffix))
+            Q_EMIT serviceStatusUpdated(entry);
+    });
+}
+
+SystemServiceEntry ServiceManager::entryFromProperties(const QString &opath, const QVariantMap &unitProps,
+                                                       const QVariantMap &serviceProps)
+{
+    SystemServiceEntry entry {};
+    ServiceManagerWorker::applyUnitProperties(entry, unitProps, serviceProps, true);
+    auto sname = entry.getId();
+    if (sname.endsWith(UnitTypeServiceSuffix))
+        sname.chop(int(strlen(UnitTypeServiceSuffix)));
+    entry.setSName(sname);
+    entry.setUnitObjectPath(opath);
+    entry.setState(unitProps.value("UnitFileState").toString());
+    entry.setStartupType(ServiceManager::getServiceStartupType(
+            entry.getSName(),
+            entry.getState()));
+    return entry;
+}
+
+void ServiceManager::prioritizeServices(const QStringList &snames)
+{
+    Q_EMIT prioritizeRequested(snames);
+}
+
 void ServiceManager::updateServiceList()
 {
     qCInfo(app) << "Requesting service list update";
@@ -171,7 +347,8 @@ ErrorContext ServiceManager::startService(const QString &id, const QString &para
     qCDebug(app) << "Successfully called StartUnit for" << buf;
     QDBusObjectPath o = oResult.second;
 
-    if (id.endsWith("@"))
+    // unit signals tell how the job goes
+    if (id.endsWith("@") || m_unitsWatched)
         return ErrorContext();
 
     oResult = iface.GetUnit(buf);
@@ -220,7 +397,8 @@ ErrorContext ServiceManager::stopService(const QString &id)
     qCDebug(app) << "Successfully called StopUnit for" << buf;
     QDBusObjectPath o = oResult.second;
 
-    if (id.endsWith("@"))
+    // unit signals tell how the job goes
+    if (id.endsWith("@") || m_unitsWatched)
         return ErrorContext();
 
     oResult = iface.GetUnit(buf);
@@ -269,7 +447,8 @@ ErrorContext ServiceManager::restartService(const QString &id, const QString &pa
     qCDebug(app) << "Successfully called RestartUnit for" << buf;
     QDBusObjectPath o = oResult.second;
 
-    if (id.endsWith("@"))
+    // unit signals tell how the job goes
+    if (id.endsWith("@") || m_unitsWatched)
         return ErrorContext();
 
     oResult = iface.GetUnit(buf);
@@ -298,6 +477,19 @@ ErrorContext ServiceManager::restartService(const QString &id, const QString &pa
     return ErrorContext();
 }
 
+ErrorContext ServiceManager::setServiceLimits(const QString &id, const resource_limits_t &limits)
+{
+    qCDebug(app) << "Setting limits of service" << id;
+    ErrorContext ec {};
+    QString errorString;
+    if (!::setServiceLimits(normalizeServiceId(id), limits, errorString)) {
+        ec.setCode(ErrorContext::kErrorTypeSystem);
+        ec.setErrorName(QApplication::translate("Service.Action.Limits", "Failed to limit service resources"));
+        ec.setErrorMessage(QString("Error: %1").arg(errorString));
+    }
+    return ec;
+}
+
 ErrorContext ServiceManager::setServiceStartupMode(const QString &id, bool autoStart)
 {
     qCDebug(app) << "Setting service startup mode for" << id << "to" << autoStart;
@@ -7,6 +7,7 @@
 #define SERVICE_MANAGER_H
 
 #include <QList>
+#include <QSet>
 #include <mutex>
 #include <thread>
 
@@ -16,10 +17,12 @@
 class ServiceManager;
 class SystemServiceEntry;
 class ServiceManagerWorker;
+struct resource_limits_t;
 
 using namespace dbus::common;
 
-// temporary solution to fix status column not shown final state after service start/stop/restart
+// temporary solution to fix status column not shown final state after service start/stop/restart,
+// used only when systemd's unit signals can't be followed
 class CustomTimer : public QObject
 {
     Q_OBJECT
@@ -80,23 +83,72 @@ Q_SIGNALS:
     void beginUpdateList();
     void serviceListUpdated(const QList<SystemServiceEntry> &list);
     void serviceStatusUpdated(const SystemServiceEntry &entry);
+    void serviceRemoved(const QString &sname);
+    // details of the listed services, coming in batches after serviceListUpdated
+    void serviceEntriesUpdated(const QList<SystemServiceEntry> &list);
+    void serviceEntriesDropped(const QStringList &snames);
+    void prioritizeRequested(const QStringList &snames);
 
 public:
     SystemServiceEntry updateServiceEntry(const QString &opath);
     QString normalizeServiceId(const QString &id, const QString &param = {});
+    /**
+     * @brief Whether unit changes are told by systemd's signals, services are polled after actions otherwise
+     */
+    inline bool isWatchingUnits() const { return m_unitsWatched; }
+    /**
+     * @brief Ask properties of a unit object without blocking, serviceStatusUpdated tells the result
+     */
+    void refreshServiceEntry(const QString &opath);
+    /**
+     * @brief Ask details of these services before the others, while the list is being filled in
+     */
+    void prioritizeServices(const QStringList &snames);
 
 public Q_SLOTS:
     ErrorContext startService(const QString &id, const QString &param = {});
     ErrorContext stopService(const QString &id);
     ErrorContext restartService(const QString &id, const QString &param = {});
     ErrorContext setServiceStartupMode(const QString &id, bool autoStart);
+    /**
+     * @brief Limit cpu, memory & io of a service without restarting it, through the system service
+     *
+     * Limits last until the unit is reloaded from disk or the system reboots, see process_info_record.h.
+     */
+    ErrorContext setServiceLimits(const QString &id, const resource_limits_t &limits);
+
+private Q_SLOTS:
+    void onUnitNew(const QString &id, const QDBusObjectPath &opath);
+    void onUnitRemoved(const QString &id, const QDBusObjectPath &opath);
+    void onUnitPropertiesChanged(const QString &interfaceName, const QVariantMap &changedProperties,
+                                 const QStringList &invalidatedProperties, const QDBusMessage &msg);
 
 private:
     explicit ServiceManager(QObject *parent = nullptr);
     ~ServiceManager();
 
+    /**
+     * @brief Subscribe to systemd's unit signals, so the service list is patched as units change
+     */
+    void watchUnits();
+    static bool isServiceUnitPath(const QString &opath);
+    /**
+     * @brief Whether a unit change is asked for now, changes nobody looks at are kept for later
+     */
+    bool takeUnitChange(const QString &opath);
+    /**
+     * @brief Ask changes kept while the service list was hidden
+     */
+    void refreshMissedEntries();
+    static SystemServiceEntry entryFromProperties(const QString &opath, const QVariantMap &unitProps,
+                                                  const QVariantMap &serviceProps);
+
     QThread m_workerThread;
     ServiceManagerWorker *m_worker {};
+    QSet<QString> m_pendingPaths; // unit objects asked for
+    QSet<QString> m_stalePaths; // changed again while asked for
+    QSet<QString> m_missedPaths; // changed while no service list was shown
+    bool m_unitsWatched {false};
 
     static std::atomic<ServiceManager *> m_instance;
     static std::mutex m_mutex;
@@ -6,7 +6,6 @@
 #include "ddlog.h"
 #include "dbus/dbus_common.h"
 #include "dbus/dbus_properties_interface.h"
-#include "dbus/environment_file.h"
 #include "dbus/systemd1_manager_interface.h"
 #include "dbus/systemd1_service_interface.h"
 #include "dbus/systemd1_unit_interface.h"
@@ -16,7 +15,7 @@
 #include "service_manager.h"
 
 #include <QDebug>
-#include <QtConcurrent>
+#include <QSet>
 #include <QRegularExpression>
 
 using namespace DDLog;
@@ -31,9 +30,11 @@ void ServiceManagerWorker::startJob()
 {
     qCDebug(app) << "ServiceManagerWorker starting job";
     QList<SystemServiceEntry> list;
-    // id hash, only keys are used here
-    QHash<QString, int> hash;
     ErrorContext ec;
+    // details of the previous job are dropped
+    m_entries.clear();
+    m_unitIds.clear();
+    m_requests.clear();
 
     Systemd1ManagerInterface mgrIf(DBUS_SYSTEMD1_SERVICE,
                                    kSystemDObjectPath.path(),
@@ -46,6 +47,11 @@ void ServiceManagerWorker::startJob()
         qCWarning(app) << "ListUnitFiles failed:" << ec.getErrorName() << ec.getErrorMessage();
     }
     UnitFileInfoList unitFiles = unitFilesResult.second;
+    // unit file states by unit id, instead of asking GetUnitFileState per unit
+    QHash<QString, QString> unitFileStates;
+    for (const auto &unitFile : unitFiles) {
+        unitFileStates[unitFile.getName().mid(unitFile.getName().lastIndexOf('/') + 1)] = unitFile.getStatus();
+    }
 
     auto unitsResult = mgrIf.ListUnits();
     ec = unitsResult.first;
@@ -53,135 +59,43 @@ void ServiceManagerWorker::startJob()
         qCWarning(app) << "ListUnits failed:" << ec.getErrorName() << ec.getErrorMessage();
     }
     UnitInfoList units = unitsResult.second;
-    for (auto u : units) {
-        if (u.getName().endsWith(UnitTypeServiceSuffix)) {
-            hash[u.getName()] = 0;
-        }
-    }
 
-    // filter-out non service type units
-    std::function<bool(const UnitInfo &)> fltUnits;
-    fltUnits = [](const UnitInfo &unit) -> bool {
-        return unit.getName().endsWith(UnitTypeServiceSuffix);
-    };
-    std::function<SystemServiceEntry(const UnitInfo &)> mapUnit = [&mgrIf](const UnitInfo &unit) {
-        qCDebug(app) << "Mapping unit:" << unit.getName();
-        ErrorContext ec1 {};
+    for (const auto &unit : units) {
+        // filter-out non service type units
+        if (!unit.getName().endsWith(UnitTypeServiceSuffix))
+            continue;
+        m_unitIds[unit.getName()] = 0;
+
         SystemServiceEntry entry {};
         // SName
         entry.setSName(unit.getName().left(unit.getName().lastIndexOf('.')));
-        // LoadState
         entry.setLoadState(unit.getLoadState());
-        // ActiveState
         entry.setActiveState(unit.getActiveState());
-        // subState
         entry.setSubState(unit.getSubState());
         entry.setUnitObjectPath(unit.getUnitObjectPath());
-        // Description
         entry.setDescription(unit.getDescription());
-
-        Systemd1UnitInterface unitIf(DBUS_SYSTEMD1_SERVICE,
-                                     unit.getUnitObjectPath(),
-                                     QDBusConnection::systemBus());
-        // Id
-        auto id = unitIf.getId();
-        ec1 = id.first;
-        if (ec1) {
-            qCWarning(app) << "Failed to get ID for unit" << unit.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-        } else {
-            qCDebug(app) << "Successfully got ID for unit" << unit.getName() << ":" << id.second;
-            entry.setId(id.second);
-        }
-
-        auto bStart = unitIf.canStart();
-        ec1 = bStart.first;
-        if (ec1) {
-            qCWarning(app) << "Failed to check if unit can start:" << unit.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-        } else {
-            qCDebug(app) << "Successfully checked if unit can start for unit" << unit.getName() << ":" << bStart.second;
-            entry.setCanStart(bStart.second);
-        }
-
-        auto bStop = unitIf.canStop();
-        ec1 = bStop.first;
-        if (ec1) {
-            qCWarning(app) << "Failed to check if unit can stop:" << unit.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-        } else {
-            qCDebug(app) << "Successfully checked if unit can stop for unit" << unit.getName() << ":" << bStop.second;
-            entry.setCanStop(bStop.second);
-        }
-
-        auto bReload = unitIf.canReload();
-        ec1 = bReload.first;
-        if (ec1) {
-            qCWarning(app) << "Failed to check if unit can reload:" << unit.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-        } else {
-            qCDebug(app) << "Successfully checked if unit can reload for unit" << unit.getName() << ":" << bReload.second;
-            entry.setCanReload(bReload.second);
-        }
-
-        // mainPID
-        Systemd1ServiceInterface svcIf(DBUS_SYSTEMD1_SERVICE,
-                                       unit.getUnitObjectPath(),
-                                       QDBusConnection::systemBus());
-        auto pid = svcIf.getMainPID();
-        ec1 = pid.first;
-        if (ec1) {
-            qCWarning(app) << "Failed to get main PID for unit" << unit.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-        } else {
-            qCDebug(app) << "Successfully got main PID for unit" << unit.getName() << ":" << pid.second;
-            entry.setMainPID(pid.second);
-        }
-
-        // unit state
-        auto state = mgrIf.GetUnitFileState(unit.getName());
-        ec1 = state.first;
-        if (ec1) {
-            qCWarning(app) << "Failed to get unit file state for" << unit.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-        } else {
-            qCDebug(app) << "Successfully got unit file state for unit" << unit.getName() << ":" << state.second;
-            entry.setState(state.second);
-        }
-
+        // unit state, empty as before when the unit has no unit file
+        entry.setState(unitFileStates.value(unit.getName()));
         // startupType
         entry.setStartupType(ServiceManager::getServiceStartupType(
                 entry.getSName(),
                 entry.getState()));
+        m_requests << UnitPropertiesRequest {entry.getSName(), unit.getUnitObjectPath(), {}, false};
+        m_entries[entry.getSName()] = entry;
+        list << entry;
+    }
+    // listed units are usable already, in ListUnits order
+    qCDebug(app) << "Emitting resultReady with" << list.size() << "service units";
+    Q_EMIT resultReady(list);
 
-        return entry;
-    };
-    std::function<void(QList<SystemServiceEntry> & elist, const SystemServiceEntry &entry)> addServiceEntryFromUnitInfo;
-    addServiceEntryFromUnitInfo = [](QList<SystemServiceEntry> &elist, const SystemServiceEntry &entry) {
-        elist << entry;
-    };
-    auto fltufe = QtConcurrent::filter(units, fltUnits);
-    fltufe.waitForFinished();
-    qCDebug(app) << "Finished filtering units";
-    auto ufe = QtConcurrent::mappedReduced<QList<SystemServiceEntry>>(units, mapUnit, addServiceEntryFromUnitInfo);
+    list.clear();
+    for (const auto &unf : unitFiles) {
+        auto id = unf.getName().mid(unf.getName().lastIndexOf('/') + 1);
+        // filter-out non service type unit-files & loaded ones
+        if (m_unitIds.contains(id) || !unf.getName().endsWith(UnitTypeServiceSuffix))
+            continue;
 
-    std::function<void(QList<SystemServiceEntry> & elist, const SystemServiceEntry &entry)> addServiceEntryFromUnitFileInfo;
-    addServiceEntryFromUnitFileInfo = [&hash](QList<SystemServiceEntry> &elist, const SystemServiceEntry &entry) {
-        if (!hash.contains(entry.getId())) {
-            elist << entry;
-        }
-    };
-    // filter-out non service type unit-files
-    std::function<bool(const UnitFileInfo &)> fltUnitFiles;
-    fltUnitFiles = [&hash](const UnitFileInfo &unitFile) -> bool {
-        auto id = unitFile.getName().mid(unitFile.getName().lastIndexOf('/') + 1);
-        if (hash.contains(id)) {
-            return false;
-        } else {
-            return unitFile.getName().endsWith(UnitTypeServiceSuffix);
-        }
-    };
-    std::function<SystemServiceEntry(const UnitFileInfo &)> mapUnitFiles;
-    mapUnitFiles = [](const UnitFileInfo &unf) {
-        qCDebug(app) << "Mapping unit file:" << unf.getName();
         SystemServiceEntry entry {};
-        ErrorContext ec1 {};
-
-        auto id = unf.getName().mid(unf.getName().lastIndexOf('/') + 1);
         auto sname = id;
         sname.chop(strlen(UnitTypeServiceSuffix));
 
@@ -191,91 +105,158 @@ void ServiceManagerWorker::startJob()
                 entry.getSName(),
                 entry.getState()));
         if (sname.endsWith('@')) {
-            qCDebug(app) << "Unit file is a template:" << unf.getName();
-            // read description from unit file
-            auto desc = readUnitDescriptionFromUnitFile(unf.getName());
-            entry.setDescription(desc);
+            // description is read from unit file later
+            m_requests << UnitPropertiesRequest {sname, {}, unf.getName(), true};
         } else {
-            auto o = Systemd1UnitInterface::normalizeUnitPath(id);
-            Systemd1UnitInterface unitIf(DBUS_SYSTEMD1_SERVICE,
-                                         o.path(),
-                                         QDBusConnection::systemBus());
-            Systemd1ServiceInterface svcIf(DBUS_SYSTEMD1_SERVICE,
-                                           o.path(),
-                                           QDBusConnection::systemBus());
+            m_requests << UnitPropertiesRequest {sname, Systemd1UnitInterface::normalizeUnitPath(id).path(), {}, true};
+        }
+        m_entries[sname] = entry;
+        list << entry;
+    }
+    qCDebug(app) << "Emitting" << list.size() << "unit files not loaded";
+    Q_EMIT entriesUpdated(list);
 
-            // Id
-            auto id1 = unitIf.getId();
-            ec1 = id1.first;
-            if (ec1) {
-                qCWarning(app) << "Failed to get ID for unit file" << unf.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-            } else {
-                qCDebug(app) << "Successfully got ID for unit file" << unf.getName() << ":" << id1.second;
-                entry.setId(id1.second);
-            }
+    scheduleBatch();
+}
 
-            auto desc = unitIf.getDescription();
-            ec1 = desc.first;
-            if (ec1) {
-                qCWarning(app) << "Failed to get description for unit file" << unf.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-            } else {
-                qCDebug(app) << "Successfully got description for unit file" << unf.getName();
-                entry.setDescription(desc.second);
-            }
+void ServiceManagerWorker::prioritize(const QStringList &snames)
+{
+    if (m_requests.isEmpty() || snames.isEmpty())
+        return;
+
+    // stable, asked ones keep their order ahead of the others
+    QSet<QString> wanted;
+    for (const auto &sname : snames)
+        wanted << sname;
+    QList<UnitPropertiesRequest> first, rest;
+    for (const auto &request : m_requests) {
+        if (wanted.contains(request.sname))
+            first << request;
+        else
+            rest << request;
+    }
+    m_requests = first + rest;
+}
 
-            auto actState = unitIf.getActiveState();
-            ec1 = actState.first;
-            if (ec1) {
-                qCWarning(app) << "Failed to get active state for unit file" << unf.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-            } else {
-                qCDebug(app) << "Successfully got active state for unit file" << unf.getName() << ":" << actState.second;
-                entry.setActiveState(actState.second);
-            }
+void ServiceManagerWorker::scheduleBatch()
+{
+    if (m_batchQueued || m_requests.isEmpty())
+        return;
+    m_batchQueued = true;
+    QMetaObject::invokeMethod(this, "fetchNextBatch", Qt::QueuedConnection);
+}
 
-            auto loadState = unitIf.getLoadState();
-            ec1 = loadState.first;
-            if (ec1) {
-                qCWarning(app) << "Failed to get load state for unit file" << unf.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-            } else {
-                qCDebug(app) << "Successfully got load state for unit file" << unf.getName() << ":" << loadState.second;
-                entry.setLoadState(loadState.second);
-            }
+void ServiceManagerWorker::fetchNextBatch()
+{
+    // enough to keep systemd busy without queueing thousands of calls on the bus
+    const int kBatchSize = 32;
+    m_batchQueued = false;
+
+    struct PendingRequest {
+        UnitPropertiesRequest request;
+        QDBusPendingCall unitProps;
+        QDBusPendingCall serviceProps;
+    };
+    auto conn = QDBusConnection::systemBus();
+    auto getAll = [&conn](const QString &path, const char *interfaceName) {
+        return DBusPropertiesInterface::asyncGetAll(DBUS_SYSTEMD1_SERVICE, path, interfaceName, conn);
+    };
+    auto takeReply = [](const QDBusPendingCall &call, const QString &path) {
+        QDBusPendingReply<QVariantMap> reply = call;
+        reply.waitForFinished();
+        if (reply.isError()) {
+            qCWarning(app) << "Failed to get properties of" << path << ":" << reply.error().name() << reply.error().message();
+            return QVariantMap {};
+        }
+        return reply.value();
+    };
 
-            auto subState = unitIf.getSubState();
-            ec1 = subState.first;
-            if (ec1) {
-                qCWarning(app) << "Failed to get sub state for unit file" << unf.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-            } else {
-                qCDebug(app) << "Successfully got sub state for unit file" << unf.getName() << ":" << subState.second;
-                entry.setSubState(subState.second);
-            }
+    // all calls of the batch are sent before any reply is waited for
+    QList<UnitPropertiesRequest> templates;
+    QList<PendingRequest> pendings;
+    while (!m_requests.isEmpty() && pendings.size() + templates.size() < kBatchSize) {
+        auto request = m_requests.takeFirst();
+        if (request.path.isEmpty()) {
+            templates << request;
+            continue;
+        }
+        pendings << PendingRequest {request,
+                                    getAll(request.path, Systemd1UnitInterface::staticInterfaceName()),
+                                    getAll(request.path, Systemd1ServiceInterface::staticInterfaceName())};
+    }
 
-            auto mainPID = svcIf.getMainPID();
-            ec1 = mainPID.first;
-            if (ec1) {
-                qCWarning(app) << "Failed to get main PID for unit file" << unf.getName() << ":" << ec1.getErrorName() << ec1.getErrorMessage();
-            } else {
-                qCDebug(app) << "Successfully got main PID for unit file" << unf.getName() << ":" << mainPID.second;
-                entry.setMainPID(mainPID.second);
-            }
+    QList<SystemServiceEntry> list;
+    QStringList dropped;
+    for (const auto &request : templates) {
+        auto it = m_entries.find(request.sname);
+        if (it == m_entries.end())
+            continue;
+        it->setDescription(readUnitDescriptionFromUnitFile(request.unitFile));
+        list << *it;
+    }
+    // replies are taken in the order calls were sent, systemd answers them in order too
+    for (const auto &pending : pendings) {
+        auto unitProps = takeReply(pending.unitProps, pending.request.path);
+        auto serviceProps = takeReply(pending.serviceProps, pending.request.path);
+        auto it = m_entries.find(pending.request.sname);
+        if (it == m_entries.end())
+            continue;
+        applyUnitProperties(*it, unitProps, serviceProps, pending.request.withStates);
+        // unit files aliasing a listed unit are shown by the unit already
+        if (pending.request.withStates && m_unitIds.contains(it->getId())) {
+            dropped << pending.request.sname;
+            m_entries.erase(it);
+            continue;
         }
+        list << *it;
+    }
 
-        return entry;
-    };
-    auto fltuffe = QtConcurrent::filter(unitFiles, fltUnitFiles);
-    fltuffe.waitForFinished();
-    qCDebug(app) << "Finished filtering unit files";
-    auto uffe = QtConcurrent::mappedReduced<QList<SystemServiceEntry>>(unitFiles, mapUnitFiles, addServiceEntryFromUnitFileInfo);
+    if (!list.isEmpty())
+        Q_EMIT entriesUpdated(list);
+    if (!dropped.isEmpty())
+        Q_EMIT entriesDropped(dropped);
+    if (m_requests.isEmpty())
+        qCDebug(app) << "Fetched details of" << m_entries.size() << "services";
+    scheduleBatch();
+}
 
-    ufe.waitForFinished();
-    qCDebug(app) << "Finished mapping units";
-    uffe.waitForFinished();
-    qCDebug(app) << "Finished mapping unit files";
+void ServiceManagerWorker::applyUnitProperties(SystemServiceEntry &entry, const QVariantMap &unitProps,
+                                               const QVariantMap &serviceProps, bool withStates)
+{
+    auto it = unitProps.find("Id");
+    if (it != unitProps.end())
+        entry.setId(it->toString());
+    it = unitProps.find("CanStart");
+    if (it != unitProps.end())
+        entry.setCanStart(it->toBool());
+    it = unitProps.find("CanStop");
+    if (it != unitProps.end())
+        entry.setCanStop(it->toBool());
+    it = unitProps.find("CanReload");
+    if (it != unitProps.end())
+        entry.setCanReload(it->toBool());
+    if (withStates) {
+        it = unitProps.find("Description");
+        if (it != unitProps.end())
+            entry.setDescription(it->toString());
+        it = unitProps.find("ActiveState");
+        if (it != unitProps.end())
+            entry.setActiveState(it->toString());
+        it = unitProps.find("LoadState");
+        if (it != unitProps.end())
+            entry.setLoadState(it->toString());
+        it = unitProps.find("SubState");
+        if (it != unitProps.end())
+            entry.setSubState(it->toString());
+    }
 
-    list << ufe.result();
-    list << uffe.result();
-    qCDebug(app) << "Emitting resultReady with" << list.size() << "services";
-    Q_EMIT resultReady(list);
+    // mainPID
+    it = serviceProps.find("MainPID");
+    if (it != serviceProps.end())
+        entry.setMainPID(it->toUInt());
+    it = serviceProps.find("ControlGroup");
+    if (it != serviceProps.end())
+        entry.setControlGroup(it->toString());
 }
 
 QString ServiceManagerWorker::readUnitDescriptionFromUnitFile(const QString &path)
@@ -6,10 +6,13 @@
 #ifndef SERVICE_MANAGER_WORKER_H
 #define SERVICE_MANAGER_WORKER_H
 
+#include "service/system_service_entry.h"
+
+#include <QHash>
 #include <QObject>
 #include <QList>
-
-class SystemServiceEntry;
+#include <QStringList>
+#include <QVariantMap>
 
 class ServiceManagerWorker : public QObject
 {
@@ -17,14 +20,59 @@ class ServiceManagerWorker : public QObject
 public:
     explicit ServiceManagerWorker(QObject *parent = nullptr);
 
+    /**
+     * @brief Fill an entry with GetAll replies of a unit object's unit & service interfaces
+     * @param withStates also take description, load, active & sub states
+     */
+    static void applyUnitProperties(SystemServiceEntry &entry, const QVariantMap &unitProps,
+                                    const QVariantMap &serviceProps, bool withStates);
+
 Q_SIGNALS:
+    /**
+     * @brief Services listed, with the fields told by ListUnits & ListUnitFiles only
+     */
     void resultReady(const QList<SystemServiceEntry> list);
+    /**
+     * @brief Services listed later or with details filled in since
+     */
+    void entriesUpdated(const QList<SystemServiceEntry> &list);
+    /**
+     * @brief Services listed by mistake, unit files aliasing a listed unit
+     */
+    void entriesDropped(const QStringList &snames);
 
 public Q_SLOTS:
     void startJob();
+    /**
+     * @brief Ask details of these services before the others, e.g. the rows shown
+     */
+    void prioritize(const QStringList &snames);
+
+private Q_SLOTS:
+    /**
+     * @brief Ask details of the next few services, the next batch is queued so priorities can change meanwhile
+     */
+    void fetchNextBatch();
 
 private:
+    /**
+     * @brief Details of a listed service to be asked
+     */
+    struct UnitPropertiesRequest {
+        QString sname;
+        QString path; // unit object path, empty for templates
+        QString unitFile; // templates only, the description is read from it
+        bool withStates; // listed unit files only, states & description of listed units are known already
+    };
+
+    void scheduleBatch();
     inline static QString readUnitDescriptionFromUnitFile(const QString &path);
+
+private:
+    QHash<QString, SystemServiceEntry> m_entries; // by service name, of the last job
+    QHash<QString, int> m_unitIds; // ids of listed units, only keys are used
+    QList<UnitPropertiesRequest> m_requests; // details still to be asked
+    bool m_batchQueued {false};
 };
 
 #endif // SERVICE_MANAGER_WORKER_H
@@ -43,6 +43,7 @@ public:
     inline QString getUnitObjectPath() const { return data->m_unitObjectPath; }
     inline QString getDescription() const { return data->m_description; }
     inline quint32 getMainPID() const { return data->m_mainPID; }
+    inline QString getControlGroup() const { return data->m_controlGroup; }
     inline bool getCanReload() const { return data->m_canReload; }
     inline bool getCanStart() const { return data->m_canStart; }
     inline bool getCanStop() const { return data->m_canStop; }
@@ -62,6 +63,7 @@ public:
     }
     inline void setDescription(const QString &description) { data->m_description = description; }
     inline void setMainPID(quint32 mainPID) { data->m_mainPID = mainPID; }
+    inline void setControlGroup(const QString &controlGroup) { data->m_controlGroup = controlGroup; }
     inline void setCanReload(bool canReload) { data->m_canReload = canReload; }
     inline void setCanStart(bool canStart) { data->m_canStart = canStart; }
     inline void setCanStop(bool canStop) { data->m_canStop = canStop; }
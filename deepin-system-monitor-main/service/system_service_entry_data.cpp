@@ -25,6 +25,7 @@ SystemServiceEntryData::SystemServiceEntryData(const SystemServiceEntryData &rhs
     , m_unitObjectPath(rhs.m_unitObjectPath)
     , m_description(rhs.m_description)
     , m_mainPID(rhs.m_mainPID)
+    , m_controlGroup(rhs.m_controlGroup)
     , m_canReload(rhs.m_canReload)
     , m_canStart(rhs.m_canStart)
     , m_canStop(rhs.m_canStop)
@@ -46,6 +47,7 @@ SystemServiceEntryData &SystemServiceEntryData::operator=(const SystemServiceEnt
         m_unitObjectPath = rhs.m_unitObjectPath;
         m_description.operator = (rhs.m_description);
         m_mainPID = rhs.m_mainPID;
+        m_controlGroup = rhs.m_controlGroup;
         m_canReload = rhs.m_canReload;
         m_canStart = rhs.m_canStart;
         m_canStop = rhs.m_canStop;
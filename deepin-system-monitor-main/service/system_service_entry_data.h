@@ -52,6 +52,8 @@ private:
     QString m_description {};  // org.freedesktop.systemd1.Unit
     // PID
     quint32 m_mainPID {0};  // org.freedesktop.systemd1.Service
+    // cgroup of the unit's processes, relative to the cgroup root
+    QString m_controlGroup {};  // org.freedesktop.systemd1.Service
 
     bool m_canReload {false};  // org.freedesktop.systemd1.Unit
     bool m_canStart {false};   // org.freedesktop.systemd1.Unit
@@ -16,6 +16,20 @@ const QString kSettingKeyProcessTabIndex = {"process_tab_index_new"};
 const QString kSettingKeyProcessAttributeDialogWidth = {"process_attribute_dialog_width"};
 const QString kSettingKeyProcessAttributeDialogHeight = {"process_attribute_dialog_height"};
 const QString kSettingKeyTimePeriod = {"time_period"};
+// whether the process table nests processes under their parent
+const QString kSettingKeyProcessTreeMode = {"process_tree_mode"};
+// fraction of the refresh interval sampling may take before --self-stats warns
+const QString kSettingKeySelfStatsWarnRatio = {"self_stats_warn_ratio"};
+// minutes of samples the flight recorder keeps for a snapshot capture
+const QString kSettingKeyFlightRecorderMinutes = {"flight_recorder_minutes"};
+// trigger rules of the flight recorder, a matching process is sampled in detail
+const QString kSettingKeyTriggerCpuPercent = {"trigger_cpu_percent"};
+const QString kSettingKeyTriggerCpuSeconds = {"trigger_cpu_seconds"};
+const QString kSettingKeyTriggerMemoryGrowthMB = {"trigger_memory_growth_mb"};
+// targets of the hosts page, [ssh://][user@]host or tcp://127.0.0.1:port
+const QString kSettingKeyFleetHosts = {"fleet_hosts"};
+// ms between refreshes of the views, one of ModelManager::kRefreshIntervals
+const QString kSettingKeyRefreshInterval = {"refresh_interval"};
 
 class QSettings;
 class Settings
@@ -11,9 +11,20 @@
 #include <QTextStream>
 #include "system/sys_info.h"
 #include "common/common.h"
+
+#include <sys/time.h>
+
 namespace core {
 namespace system {
 
+// seconds between two uptime readings, 1 if they're not in order
+static inline double elapsedSeconds(const timeval &prev, const timeval &cur)
+{
+    double ltime = prev.tv_sec + prev.tv_usec * 1. / 1000000;
+    double rtime = cur.tv_sec + cur.tv_usec * 1. / 1000000;
+    return rtime > ltime ? rtime - ltime : 1;
+}
+
 BlockDevice::BlockDevice()
     : d(new BlockDevicePrivate())
 {
@@ -44,6 +55,14 @@ void BlockDevice::setDeviceName(const QByteArray &deviceName)
     readDeviceInfo();
 }
 
+void BlockDevice::initDevice(const QByteArray &deviceName, quint64 capacity)
+{
+    qCDebug(app) << "Init device" << deviceName;
+    d->name = deviceName;
+    d->capacity = capacity;
+    readDeviceModel();
+}
+
 void BlockDevice::readDeviceInfo()
 {
     qCDebug(app) << "Reading device info for" << d->name;
@@ -73,41 +92,15 @@ void BlockDevice::readDeviceInfo()
         QStringList deviceInfo = strList[i];
         if (deviceInfo.size() > 16 && deviceInfo[2] == d->name) {
             qCDebug(app) << "Found device" << d->name << "in disk stats";
-            m_time_sec = QDateTime::currentSecsSinceEpoch();
-            timevalList[0] = timevalList[1];
-            timevalList[1] = SysInfo::instance()->uptime();
+            // diskstats is major, minor & name followed by fields of /sys/block/<dev>/stat
+            quint64 stat[kStatFields] {};
+            int count = 0;
+            for (int f = 3; f < deviceInfo.size() && count < kStatFields; ++f)
+                stat[count++] = deviceInfo[f].toULongLong();
 
-            qint64 interval = m_time_sec - d->_time_Sec > 0 ? m_time_sec - d->_time_Sec : 1;
-            calcDiskIoStates(deviceInfo);
             readDeviceModel();
             d->capacity = readDeviceSize(deviceInfo[2]);
-            if (d->read_iss != 0)
-                d->r_ps = (deviceInfo[3].toULongLong() - d->read_iss) / static_cast<quint64>(interval);
-            if (d->blk_read != 0)
-                d->rsec_ps = (deviceInfo[5].toULongLong() - d->blk_read) / static_cast<quint64>(interval);
-            if (d->blk_wrtn != 0)
-                d->wsec_ps = (deviceInfo[9].toULongLong() - d->blk_wrtn) / static_cast<quint64>(interval);
-            if (d->read_merged != 0)
-                d->rrqm_ps = (deviceInfo[4].toULongLong() - d->read_merged) / static_cast<quint64>(interval);
-            if (d->write_com != 0)
-                d->w_ps = (deviceInfo[7].toULongLong() - d->write_com) / static_cast<quint64>(interval);
-            if (d->write_merged != 0)
-                d->wrqm_ps = (deviceInfo[8].toULongLong() - d->write_merged) / static_cast<quint64>(interval);
-            d->blk_read = deviceInfo[5].toULongLong();
-            d->bytes_read = deviceInfo[5].toULongLong() * SECTOR_SIZE;
-            if (deviceInfo[3].toULongLong() != 0)
-                d->p_rrqm =  deviceInfo[4].toDouble() / deviceInfo[3].toDouble() * 100;
-            d->tps = deviceInfo[3].toULongLong() + deviceInfo[7].toULongLong();
-            d->blk_wrtn = deviceInfo[9].toULongLong();
-            d->bytes_wrtn = deviceInfo[9].toULongLong() * SECTOR_SIZE;
-            if (deviceInfo[7].toULongLong() != 0)
-                d->p_wrqm = deviceInfo[8].toULongLong() / deviceInfo[7].toULongLong() * 100;
-            d->read_iss = deviceInfo[3].toULongLong();
-            d->write_com = deviceInfo[7].toULongLong();
-            d->read_merged = deviceInfo[4].toULongLong();
-            d->write_merged = deviceInfo[8].toULongLong();
-            d->discard_sector = deviceInfo[16].toULongLong();
-            d->_time_Sec = QDateTime::currentSecsSinceEpoch();
+            updateStat(stat, count);
             qCDebug(app) << "Finished processing device info for" << d->name;
             break;
         }
@@ -115,6 +108,97 @@ void BlockDevice::readDeviceInfo()
 
 }
 
+void BlockDevice::updateStat(const quint64 *stat, int count)
+{
+    if (count < 11) {
+        qCWarning(app) << "Too few stat fields for" << d->name << ":" << count;
+        return;
+    }
+
+    m_time_sec = QDateTime::currentSecsSinceEpoch();
+    timevalList[0] = timevalList[1];
+    timevalList[1] = SysInfo::instance()->uptime();
+
+    // measured between the reads, refreshes need not be whole seconds apart
+    double interval = elapsedSeconds(timevalList[0], timevalList[1]);
+    calcDiskIoStates(stat, count);
+    calcIoLatency(stat, count);
+    if (d->read_iss != 0)
+        d->r_ps = (stat[0] - d->read_iss) / interval;
+    if (d->blk_read != 0)
+        d->rsec_ps = (stat[2] - d->blk_read) / interval;
+    if (d->blk_wrtn != 0)
+        d->wsec_ps = (stat[6] - d->blk_wrtn) / interval;
+    if (d->read_merged != 0)
+        d->rrqm_ps = (stat[1] - d->read_merged) / interval;
+    if (d->write_com != 0)
+        d->w_ps = (stat[4] - d->write_com) / interval;
+    if (d->write_merged != 0)
+        d->wrqm_ps = (stat[5] - d->write_merged) / interval;
+    d->blk_read = stat[2];
+    d->bytes_read = stat[2] * SECTOR_SIZE;
+    if (stat[0] != 0)
+        d->p_rrqm = double(stat[1]) / double(stat[0]) * 100;
+    d->tps = stat[0] + stat[4];
+    d->blk_wrtn = stat[6];
+    d->bytes_wrtn = stat[6] * SECTOR_SIZE;
+    if (stat[4] != 0)
+        d->p_wrqm = stat[5] / stat[4] * 100;
+    d->read_iss = stat[0];
+    d->write_com = stat[4];
+    d->read_merged = stat[1];
+    d->write_merged = stat[5];
+    d->discard_sector = count > 13 ? stat[13] : 0;
+    d->_time_Sec = QDateTime::currentSecsSinceEpoch();
+}
+
+// counters restart from 0 when device is re-added
+static inline quint64 counterDiff(quint64 cur, quint64 prev)
+{
+    return cur > prev ? cur - prev : 0;
+}
+
+void BlockDevice::calcIoLatency(const quint64 *stat, int count)
+{
+    // iostat -x style metrics, ref: sysstat#rd_stats.c#compute_ext_disk_stats
+    quint64 cur_discard_ios = count > 14 ? stat[11] : 0;
+    quint64 cur_discard_sectors = count > 14 ? stat[13] : 0;
+    quint64 cur_discard_ticks = count > 14 ? stat[14] : 0;
+    timeval cur_time = timevalList[1];
+    timeval prev_time = timevalList[0];
+
+    // interval in ms, no baseline on first update
+    auto ltime = prev_time.tv_sec * 1000. + prev_time.tv_usec / 1000.;
+    auto rtime = cur_time.tv_sec * 1000. + cur_time.tv_usec / 1000.;
+    if (timerisset(&prev_time) && rtime > ltime) {
+        auto interval = rtime - ltime;
+        quint64 rios = counterDiff(stat[0], d->read_iss);
+        quint64 wios = counterDiff(stat[4], d->write_com);
+        quint64 dios = counterDiff(cur_discard_ios, d->discard_ios);
+        quint64 nios = rios + wios + dios;
+        quint64 rticks = counterDiff(stat[3], d->read_ticks);
+        quint64 wticks = counterDiff(stat[7], d->write_ticks);
+        quint64 dticks = counterDiff(cur_discard_ticks, d->discard_ticks);
+        quint64 ioticks = counterDiff(stat[9], d->io_ticks);
+
+        d->r_await = rios > 0 ? double(rticks) / rios : 0;
+        d->w_await = wios > 0 ? double(wticks) / wios : 0;
+        d->await = nios > 0 ? double(rticks + wticks + dticks) / nios : 0;
+        d->svctm = nios > 0 ? double(ioticks) / nios : 0;
+        d->p_util = qMin(100., ioticks * 100. / interval);
+        d->aqu_sz = counterDiff(stat[10], d->time_in_queue) / interval;
+        d->discard_speed = static_cast<quint64>(counterDiff(cur_discard_sectors, d->discard_sector) * SECTOR_SIZE * 1000. / interval);
+    }
+
+    d->in_flight = stat[8];
+    d->read_ticks = stat[3];
+    d->write_ticks = stat[7];
+    d->io_ticks = stat[9];
+    d->time_in_queue = stat[10];
+    d->discard_ios = cur_discard_ios;
+    d->discard_ticks = cur_discard_ticks;
+}
+
 void BlockDevice::readDeviceModel()
 {
     QString Path = QString(SYSFS_PATH_MODEL).arg(d->name.data());
@@ -146,11 +230,20 @@ quint64 BlockDevice::readDeviceSize(const QString &deviceName)
 }
 
 void BlockDevice::calcDiskIoStates(const QStringList &diskInfo)
+{
+    quint64 stat[kStatFields] {};
+    int count = 0;
+    for (int f = 3; f < diskInfo.size() && count < kStatFields; ++f)
+        stat[count++] = diskInfo[f].toULongLong();
+    calcDiskIoStates(stat, count);
+}
+
+void BlockDevice::calcDiskIoStates(const quint64 *stat, int count)
 {
     qCDebug(app) << "Calculating disk IO states for" << d->name;
-    quint64 curr_read_sector =  diskInfo[5].toULongLong();
-    quint64 curr_write_sector = diskInfo[9].toULongLong();
-    quint64 curr_discard_sector = diskInfo[16].toULongLong();
+    quint64 curr_read_sector = stat[2];
+    quint64 curr_write_sector = stat[6];
+    quint64 curr_discard_sector = count > 13 ? stat[13] : 0;
     timeval cur_time = timevalList[1];
     timeval prev_time = timevalList[0];
 
@@ -163,13 +256,11 @@ void BlockDevice::calcDiskIoStates(const QStringList &diskInfo)
     // calculate actual size
     auto rsize = rdiff * SECTOR_SIZE;
     auto wsize = (wdiff + ddiff) * SECTOR_SIZE;
-    //  auto interval = (m_time_sec > d->_time_Sec) ? (m_time_sec - d->_time_Sec) : 1;
-    auto ltime = prev_time.tv_sec + prev_time.tv_usec * 1. / 1000000;
-    auto rtime = cur_time.tv_sec + cur_time.tv_usec * 1. / 1000000;
-    auto interval = (rtime > ltime) ? (rtime - ltime) : 1;
+    // a 0.5s refresh used to be truncated to a division by zero
+    double interval = elapsedSeconds(prev_time, cur_time);
 
-    d->read_speed = rsize / static_cast<quint64>(interval);
-    d->wirte_speed = wsize / static_cast<quint64>(interval);
+    d->read_speed = static_cast<quint64>(rsize / interval);
+    d->wirte_speed = static_cast<quint64>(wsize / interval);
     qCDebug(app) << d->name << "read speed:" << d->read_speed << "B/s, write speed:" << d->wirte_speed << "B/s";
 }
 
@@ -50,14 +50,36 @@ public:
     quint64  writeMerged() const; // 获取合并写完成次数
     quint64  readSpeed() const; // 获取读速度
     quint64  writeSpeed() const; // 获取写速度
+    qreal readAwait() const; // 平均读请求耗时 ms
+    qreal writeAwait() const; // 平均写请求耗时 ms
+    qreal await() const; // 平均请求耗时 ms
+    qreal serviceTime() const; // 平均服务时间 ms
+    qreal queueDepth() const; // 平均队列深度
+    quint64 inFlight() const; // 正在处理的请求数
+    quint64 discardSpeed() const; // 丢弃速度
 
     void setDeviceName(const QByteArray &deviceName);
+    /**
+     * @brief Set name & static attributes of a newly found device, stats come with updateStat
+     */
+    void initDevice(const QByteArray &deviceName, quint64 capacity);
+
+    // fields of /sys/block/<dev>/stat, 11 before kernel 4.18, 15 with discard & 17 with flush stats
+    static constexpr int kStatFields = 17;
 
 public:
     void readDeviceInfo();
     void readDeviceModel();
     quint64 readDeviceSize(const QString &deviceName);
     void calcDiskIoStates(const QStringList &diskInfo);
+    /**
+     * @brief Update io stats from fields of /sys/block/<dev>/stat
+     */
+    void updateStat(const quint64 *stat, int count);
+
+private:
+    void calcDiskIoStates(const quint64 *stat, int count);
+    void calcIoLatency(const quint64 *stat, int count);
 
 private:
     QSharedDataPointer<BlockDevicePrivate> d;
@@ -175,6 +197,34 @@ inline quint64  BlockDevice::writeSpeed() const
 {
     return d->wirte_speed;
 }
+inline qreal BlockDevice::readAwait() const
+{
+    return d->r_await;
+}
+inline qreal BlockDevice::writeAwait() const
+{
+    return d->w_await;
+}
+inline qreal BlockDevice::await() const
+{
+    return d->await;
+}
+inline qreal BlockDevice::serviceTime() const
+{
+    return d->svctm;
+}
+inline qreal BlockDevice::queueDepth() const
+{
+    return d->aqu_sz;
+}
+inline quint64 BlockDevice::inFlight() const
+{
+    return d->in_flight;
+}
+inline quint64 BlockDevice::discardSpeed() const
+{
+    return d->discard_speed;
+}
 
 
 
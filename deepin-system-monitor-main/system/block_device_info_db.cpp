@@ -13,16 +13,30 @@
 #include "diskio_info.h"
 #include "common/common.h"
 #include "system/sys_info.h"
-#include <QDir>
+#include "common/proc_parser.h"
+
+#include <algorithm>
+
 #include <ctype.h>
+#include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <sched.h>
+#include <string.h>
+#include <unistd.h>
 
 #include <libudev.h>
 
 using namespace DDLog;
+using namespace common::alloc;
+using namespace common::parser;
 
 #define SYSFS_PATH_VIRTUAL_BLOCK "/sys/devices/virtual/block"
+#define SYSFS_PATH_BLOCK_STAT "/sys/block/%s/stat"
+
+// rescan interval without udev monitor, in polls (update is scheduled every 2s)
+const int kRescanPolls = 15;
 
 namespace core {
 namespace system {
@@ -94,99 +108,148 @@ get_child(struct udev *udev, struct udev_device *parent, const char *subsystem)
 
 BlockDeviceInfoDB::BlockDeviceInfoDB()
     : m_deviceList {}
+    , m_udev()
+    , m_monitor(nullptr)
+    , m_pollsSinceScan(-1)
+    , m_statFds {}
 {
     qCDebug(app) << "BlockDeviceInfoDB constructor";
+    if (m_udev.handle()) {
+        // partitions are not listed in /sys/block, ignore their events
+        m_monitor = udev_monitor_new_from_netlink(m_udev.handle(), "udev");
+        if (m_monitor
+                && (udev_monitor_filter_add_match_subsystem_devtype(m_monitor, "block", "disk") < 0
+                    || udev_monitor_enable_receiving(m_monitor) < 0)) {
+            udev_monitor_unref(m_monitor);
+            m_monitor = nullptr;
+        }
+    }
+    if (!m_monitor)
+        qCInfo(app) << "udev monitor not available, rescan block devices periodically";
 }
 
 BlockDeviceInfoDB::~BlockDeviceInfoDB()
 {
     // qCDebug(app) << "BlockDeviceInfoDB destructor";
+    for (int fd : m_statFds)
+        close(fd);
+    if (m_monitor)
+        udev_monitor_unref(m_monitor);
 }
 
 void BlockDeviceInfoDB::readDiskInfo()
 {
     qCDebug(app) << "Starting to read disk info";
-    QDir dir(SYSFS_PATH_BLOCK);
-    if (!dir.exists()) {
-        qCWarning(app) << "Block device directory does not exist:" << SYSFS_PATH_BLOCK;
+    uDir dir(opendir(SYSFS_PATH_BLOCK));
+    if (!dir) {
+        qCWarning(app) << "Failed to open block device directory:" << SYSFS_PATH_BLOCK << strerror(errno);
         return;
     }
 
-    QFileInfoList list = dir.entryInfoList();
-    //获取实体磁盘
-    for (int i = 0; i < list.size(); ++i) {
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        QString t_link = list.at(i).readLink();
-#else
-        QString t_link = list.at(i).readSymLink();
-#endif
-        if (list[i].fileName() != "." && list[i].fileName() != ".." && !list[i].fileName().contains("ram") && !list[i].fileName().contains("loop") && !t_link.contains("virtual")) {
-            int index = -1;
-            //  查找当前的device是否存在
-            for (int si = 0; si < m_deviceList.size(); ++si) {
-                if (m_deviceList[si].deviceName() == list[i].fileName().toLocal8Bit()) {   // 存在
-                    index = si;
-                    break;
-                }
-            }
-            if (index == -1) {   // 不存在的话将该disk存储起来
-                qCDebug(app) << "Adding new physical disk:" << list[i].fileName();
-                BlockDevice bd;
-                if (bd.readDeviceSize(list[i].fileName()) > 0) {
-                    bd.setDeviceName(list[i].fileName().toLocal8Bit());
-                    m_deviceList << bd;
-                }
+    // /sys/block/<dev> links to ../devices/..., virtual disks live under devices/virtual
+    QList<QByteArray> physical, virtual_;
+    char link[PATH_MAX];
+    struct dirent *dp;
+    while ((dp = readdir(dir.get()))) {
+        if (dp->d_name[0] == '.' || strstr(dp->d_name, "ram") || strstr(dp->d_name, "loop"))
+            continue;
+
+        ssize_t n = readlinkat(dirfd(dir.get()), dp->d_name, link, sizeof(link) - 1);
+        link[n > 0 ? n : 0] = '\0';
+        if (strstr(link, "virtual"))
+            virtual_ << QByteArray(dp->d_name);
+        else
+            physical << QByteArray(dp->d_name);
+    }
+    // keep the sorted order of the former QDir listing
+    std::sort(physical.begin(), physical.end());
+    std::sort(virtual_.begin(), virtual_.end());
+
+    QHash<QByteArray, bool> present;
+    for (const QByteArray &name : physical + virtual_)
+        present.insert(name, true);
+
+    QHash<QByteArray, int> known;
+    QList<BlockDevice> devices;
+    {
+        QReadLocker lock(&m_rwlock);
+        // drop devices gone, existing ones keep their position
+        for (const BlockDevice &device : m_deviceList) {
+            if (present.contains(device.deviceName())) {
+                known.insert(device.deviceName(), devices.size());
+                devices << device;
             } else {
-                qCDebug(app) << "Updating existing physical disk:" << list[i].fileName();
-                m_deviceList[index].setDeviceName(list[i].fileName().toLocal8Bit());   // 更新disk数据
+                qCDebug(app) << "Removing device that no longer exists:" << device.deviceName();
+                closeStatFd(device.deviceName());
             }
         }
     }
 
-    //获取虚拟磁盘
-    for (int i = 0; i < list.size(); ++i) {
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        QString t_link = list.at(i).readLink();
-#else
-        QString t_link = list.at(i).readSymLink();
-#endif
-        if (list[i].fileName() != "." && list[i].fileName() != ".." && !list[i].fileName().contains("ram") && !list[i].fileName().contains("loop") && t_link.contains("virtual")) {
-            int index = -1;
-            //  查找当前的device是否存在
-            for (int si = 0; si < m_deviceList.size(); ++si) {
-                if (m_deviceList[si].deviceName() == list[i].fileName().toLocal8Bit()) {   // 存在
-                    index = si;
-                    break;
-                }
-            }
-            if (index == -1) {   // 不存在的话将该disk存储起来
-                qCDebug(app) << "Adding new virtual disk:" << list[i].fileName();
-                BlockDevice bd;
-                if (bd.readDeviceSize(list[i].fileName()) > 0) {
-                    bd.setDeviceName(list[i].fileName().toLocal8Bit());
-                    m_deviceList << bd;
-                }
-            } else {
-                qCDebug(app) << "Updating existing virtual disk:" << list[i].fileName();
-                m_deviceList[index].setDeviceName(list[i].fileName().toLocal8Bit());   // 更新disk数据
-            }
+    // physical disks first, then virtual ones
+    for (const QByteArray &name : physical + virtual_) {
+        if (known.contains(name))
+            continue;
+
+        BlockDevice bd;
+        quint64 capacity = bd.readDeviceSize(name);
+        if (capacity > 0) {
+            qCDebug(app) << "Adding new disk:" << name;
+            bd.initDevice(name, capacity);
+            // baseline of the io rates
+            readDeviceStat(bd);
+            devices << bd;
         }
     }
 
-    for (int i = 0; i < m_deviceList.size(); ++i) {
-        bool isFind = false;
-        for (int si = 0; si < list.size(); ++si) {
-            if (list[si].fileName().toLocal8Bit() == m_deviceList[i].deviceName()) {
-                isFind = true;
-                break;
-            }
-        }
-        if (!isFind) {
-            qCDebug(app) << "Removing device that no longer exists:" << m_deviceList[i].deviceName();
-            m_deviceList.removeAt(i);
+    QWriteLocker lock(&m_rwlock);
+    m_deviceList = devices;
+    qCDebug(app) << "Finished reading disk info";
+}
+
+bool BlockDeviceInfoDB::readDeviceStat(BlockDevice &device)
+{
+    const QByteArray name = device.deviceName();
+    auto it = m_statFds.find(name);
+    if (it == m_statFds.end()) {
+        char path[PATH_MAX];
+        snprintf(path, sizeof(path), SYSFS_PATH_BLOCK_STAT, name.constData());
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            qCWarning(app) << "Failed to open" << path << strerror(errno);
+            return false;
         }
+        it = m_statFds.insert(name, fd);
+    }
+
+    // stat is a single line of at most 17 counters
+    char buf[512];
+    ssize_t n;
+    do {
+        n = pread(it.value(), buf, sizeof(buf), 0);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0) {
+        // device gone, reopen on next read
+        close(it.value());
+        m_statFds.erase(it);
+        return false;
+    }
+
+    quint64 stat[BlockDevice::kStatFields];
+    int count = 0;
+    Tokenizer tok(buf, size_t(n));
+    while (count < BlockDevice::kStatFields && tok.readU64(stat[count]))
+        ++count;
+    device.updateStat(stat, count);
+    return true;
+}
+
+void BlockDeviceInfoDB::closeStatFd(const QByteArray &deviceName)
+{
+    auto it = m_statFds.find(deviceName);
+    if (it != m_statFds.end()) {
+        close(it.value());
+        m_statFds.erase(it);
     }
-    qCDebug(app) << "Finished reading disk info";
 }
 
 //static void enum_block()
@@ -277,22 +340,51 @@ void BlockDeviceInfoDB::readDiskInfo()
 void BlockDeviceInfoDB::update()
 {
     qCDebug(app) << "Updating BlockDeviceInfoDB";
-    readDiskInfo();
-
-    // TODO: enum device in /sys/block => phy & virtual
-
-    // TEST begin (move udev logic to udev & udevice)
-    //    enum_block();
-
-    //    struct udev *udev = udev_new();
+    bool rescan = m_pollsSinceScan < 0;
+    QList<QByteArray> changed;
+
+    if (m_monitor) {
+        // monitor socket is non-blocking, receive returns null once drained
+        struct udev_device *dev;
+        while ((dev = udev_monitor_receive_device(m_monitor))) {
+            const char *action = udev_device_get_action(dev);
+            const char *sysname = udev_device_get_sysname(dev);
+            qCDebug(app) << "block udev event:" << action << sysname;
+            if (action && strcmp(action, "change") == 0) {
+                // media change, resize etc.
+                if (sysname)
+                    changed << QByteArray(sysname);
+            } else {
+                rescan = true;
+            }
+            udev_device_unref(dev);
+        }
+    } else if (m_pollsSinceScan + 1 >= kRescanPolls) {
+        rescan = true;
+    }
 
-    //    enumerate_usb_mass_storage(udev);
+    if (rescan) {
+        readDiskInfo();
+        m_pollsSinceScan = 0;
+        return;
+    }
+    ++m_pollsSinceScan;
 
-    //    udev_unref(udev);
-    //    // TEST end
+    if (!changed.isEmpty()) {
+        QWriteLocker lock(&m_rwlock);
+        for (BlockDevice &device : m_deviceList) {
+            if (changed.contains(device.deviceName()))
+                device.initDevice(device.deviceName(), device.readDeviceSize(device.deviceName()));
+        }
+    }
+}
 
-    //    QWriteLocker lock(&m_rwlock);
-    // update device list
+void BlockDeviceInfoDB::updateDeviceStats()
+{
+    qCDebug(app) << "Updating block device stats";
+    QWriteLocker lock(&m_rwlock);
+    for (int i = 0; i < m_deviceList.size(); ++i)
+        readDeviceStat(m_deviceList[i]);
 }
 
 }   // namespace system
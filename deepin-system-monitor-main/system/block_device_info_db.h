@@ -7,9 +7,13 @@
 #define BLOCK_DEVICE_INFO_DB_H
 
 #include "block_device.h"
+#include "udev.h"
 
 #include <QReadWriteLock>
 #include <QList>
+#include <QHash>
+
+struct udev_monitor;
 
 namespace core {
 namespace system {
@@ -19,6 +23,10 @@ class DeviceDB;
 
 /**
  * @brief The BlockDeviceInfoDB class
+ *
+ * Device inventory is only rescanned on udev add/remove events of the block subsystem (or
+ * about every 30s if udev monitor is not available), stats of known devices are read from
+ * /sys/block/<dev>/stat through fds kept open between refreshes.
  */
 class BlockDeviceInfoDB
 {
@@ -28,14 +36,32 @@ public:
 
     QList<BlockDevice> deviceList();
 
+    /**
+     * @brief Drain pending udev events & refresh device inventory if it changed
+     */
     void update();
+    /**
+     * @brief Refresh io stats of known devices
+     */
+    void updateDeviceStats();
+
+    bool hasUDevMonitor() const;
 
 private:
     void readDiskInfo();
+    bool readDeviceStat(BlockDevice &device);
+    void closeStatFd(const QByteArray &deviceName);
 
 private:
     mutable QReadWriteLock m_rwlock;
     QList<BlockDevice> m_deviceList;
+
+    UDev m_udev;
+    struct udev_monitor *m_monitor;
+    // polls since last inventory scan, -1 before first scan
+    int m_pollsSinceScan;
+    // device name => open fd of /sys/block/<dev>/stat
+    QHash<QByteArray, int> m_statFds;
 };
 
 inline QList<BlockDevice> BlockDeviceInfoDB::deviceList()
@@ -44,6 +70,11 @@ inline QList<BlockDevice> BlockDeviceInfoDB::deviceList()
     return m_deviceList;
 }
 
+inline bool BlockDeviceInfoDB::hasUDevMonitor() const
+{
+    return m_monitor != nullptr;
+}
+
 } // namespace system
 } // namespace core
 
@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "cpu_hotplug_monitor.h"
+#include "ddlog.h"
+
+#include <QFile>
+
+#include <libudev.h>
+
+#define SYSFS_PATH_CPU_ONLINE "/sys/devices/system/cpu/online"
+
+using namespace DDLog;
+
+namespace core {
+namespace system {
+
+CPUHotplugMonitor::CPUHotplugMonitor()
+    : m_udev()
+    , m_monitor(nullptr)
+    , m_online {}
+{
+    if (m_udev.handle()) {
+        m_monitor = udev_monitor_new_from_netlink(m_udev.handle(), "udev");
+        if (m_monitor
+                && (udev_monitor_filter_add_match_subsystem_devtype(m_monitor, "cpu", nullptr) < 0
+                    || udev_monitor_enable_receiving(m_monitor) < 0)) {
+            udev_monitor_unref(m_monitor);
+            m_monitor = nullptr;
+        }
+    }
+    if (!m_monitor)
+        qCInfo(app) << "udev monitor not available, detect cpu hotplug by online mask";
+
+    m_online = readOnlineMask();
+}
+
+CPUHotplugMonitor::~CPUHotplugMonitor()
+{
+    if (m_monitor)
+        udev_monitor_unref(m_monitor);
+}
+
+bool CPUHotplugMonitor::poll()
+{
+    bool changed = false;
+
+    if (m_monitor) {
+        // monitor socket is non-blocking, receive returns null once drained
+        struct udev_device *dev;
+        while ((dev = udev_monitor_receive_device(m_monitor))) {
+            qCDebug(app) << "cpu udev event:" << udev_device_get_action(dev) << udev_device_get_sysname(dev);
+            udev_device_unref(dev);
+            changed = true;
+        }
+    } else {
+        QByteArray online = readOnlineMask();
+        if (online != m_online) {
+            m_online = online;
+            changed = true;
+        }
+    }
+
+    if (changed)
+        qCInfo(app) << "cpu hotplug detected";
+    return changed;
+}
+
+QByteArray CPUHotplugMonitor::readOnlineMask()
+{
+    QFile file(SYSFS_PATH_CPU_ONLINE);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return file.readAll().trimmed();
+}
+
+} // namespace system
+} // namespace core
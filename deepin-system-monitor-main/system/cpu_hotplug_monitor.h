@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CPU_HOTPLUG_MONITOR_H
+#define CPU_HOTPLUG_MONITOR_H
+
+#include "udev.h"
+
+#include <QByteArray>
+
+struct udev_monitor;
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Detects cpu hotplug, so static cpu topology only has to be read again when it changed
+ *
+ * Listens for udev events of the cpu subsystem. If udev monitor is not available (e.g. in a
+ * container), compares /sys/devices/system/cpu/online between polls instead.
+ */
+class CPUHotplugMonitor
+{
+public:
+    explicit CPUHotplugMonitor();
+    ~CPUHotplugMonitor();
+
+    /**
+     * @brief Drain pending events without blocking
+     * @return true if cpus were added, removed or brought on/offline since last poll
+     */
+    bool poll();
+
+    bool hasUDevMonitor() const;
+
+    static QByteArray readOnlineMask();
+
+private:
+    UDev m_udev;
+    struct udev_monitor *m_monitor;
+    QByteArray m_online;
+};
+
+inline bool CPUHotplugMonitor::hasUDevMonitor() const
+{
+    return m_monitor != nullptr;
+}
+
+} // namespace system
+} // namespace core
+
+#endif // CPU_HOTPLUG_MONITOR_H
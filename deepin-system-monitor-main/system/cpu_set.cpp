@@ -8,6 +8,8 @@
 
 #include "common/common.h"
 #include "common/thread_manager.h"
+#include "common/proc_parser.h"
+#include "common/scratch_arena.h"
 #include "system_monitor_thread.h"
 #include "system_monitor.h"
 #include "sys_info.h"
@@ -19,16 +21,38 @@ extern "C" {
 
 #include <QMap>
 #include <QByteArray>
+#include <QDataStream>
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <QTextStream>
 #include <QProcess>
 #include <QRegularExpression>
 #include <ctype.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/utsname.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
 
 #define PROC_PATH_STAT "/proc/stat"
 #define PROC_PATH_CPUINFO "/proc/cpuinfo"
+#define PROC_PATH_SCHEDSTAT "/proc/schedstat"
+#define PROC_PATH_BOOT_ID "/proc/sys/kernel/random/boot_id"
+#define SYSFS_PATH_PRODUCT_UUID "/sys/class/dmi/id/product_uuid"
+
+// bump when what's written by saveInfoCache changes
+const quint32 InfoCacheMagic = 0x43505543; // "CPUC"
+const quint32 InfoCacheVersion = 1;
 
 using namespace common::error;
 using namespace common::alloc;
@@ -453,6 +477,16 @@ QString CPUSet::maxFreq() const
     return common::format::formatHz(static_cast<uint>(MaxFreq), common::format::MHz);
 }
 
+qreal CPUSet::minFreqMHz() const
+{
+    return d->m_info.value(mIsEmptyModelName ? QStringLiteral("CPU 最小 MHz") : QStringLiteral("CPU min MHz")).toDouble();
+}
+
+qreal CPUSet::maxFreqMHz() const
+{
+    return d->m_info.value(mIsEmptyModelName ? QStringLiteral("CPU 最大 MHz") : QStringLiteral("CPU max MHz")).toDouble();
+}
+
 QString CPUSet::avgFreq() const
 {
     qCDebug(app) << "Getting average CPU frequency";
@@ -552,30 +586,442 @@ const CPUStat CPUSet::stat() const
 QList<QByteArray> CPUSet::cpuLogicName() const
 {
     qCDebug(app) << "Getting CPU logical names";
-    return d->m_usageDB.keys();
+    QList<QByteArray> names;
+    for (int cpu : d->m_cpuIds)
+        names << d->m_cpuNames[cpu];
+    return names;
+}
+
+// name based lookups, kept for callers outside the per tick path
+static int cpuIdOf(const QByteArray &cpu)
+{
+    bool ok = false;
+    int id = cpu.startsWith("cpu") ? cpu.mid(3).toInt(&ok) : -1;
+    return ok ? id : -1;
 }
 
 const CPUStat CPUSet::statDB(const QByteArray &cpu) const
 {
     qCDebug(app) << "Getting CPU stat for" << cpu;
-    return d->m_statDB[cpu];
+    int id = cpuIdOf(cpu);
+    if (id < 0 || id >= d->m_cpuNames.size())
+        return {};
+    return std::make_shared<cpu_stat_t>(cpuStat(id));
 }
 
 const CPUUsage CPUSet::usageDB(const QByteArray &cpu) const
 {
     qCDebug(app) << "Getting CPU usage for" << cpu;
-    return d->m_usageDB[cpu];
+    int id = cpuIdOf(cpu);
+    if (id < 0 || id >= d->m_cpuNames.size())
+        return {};
+    return std::make_shared<cpu_usage_t>(cpuUsage(id));
+}
+
+QVector<int> CPUSet::cpuIds() const
+{
+    return d->m_cpuIds;
+}
+
+cpu_stat_t CPUSet::cpuStat(int cpu) const
+{
+    if (cpu < 0 || cpu >= d->m_cpuNames.size())
+        return {};
+
+    const common::usage::CoreJiffies &jiffies = d->m_cpuJiffies[kCurrentStat];
+    cpu_stat_t stat {};
+    stat.cpu = d->m_cpuNames[cpu];
+    stat.user = jiffies.user[size_t(cpu)];
+    stat.nice = jiffies.nice[size_t(cpu)];
+    stat.sys = jiffies.sys[size_t(cpu)];
+    stat.idle = jiffies.idle[size_t(cpu)];
+    stat.iowait = jiffies.iowait[size_t(cpu)];
+    stat.hardirq = jiffies.hardirq[size_t(cpu)];
+    stat.softirq = jiffies.softirq[size_t(cpu)];
+    stat.steal = jiffies.steal[size_t(cpu)];
+    stat.guest = jiffies.guest[size_t(cpu)];
+    stat.guest_nice = jiffies.guest_nice[size_t(cpu)];
+    return stat;
+}
+
+cpu_usage_t CPUSet::cpuUsage(int cpu) const
+{
+    if (cpu < 0 || cpu >= d->m_coreUsage.size())
+        return {};
+    return {d->m_cpuNames[cpu], d->m_coreUsage.total[size_t(cpu)], d->m_coreUsage.idle[size_t(cpu)]};
+}
+
+qreal CPUSet::cpuUsagePercent(int cpu) const
+{
+    if (cpu < 0 || cpu >= d->m_coreUsage.size())
+        return 0;
+    return d->m_coreUsage.usage[size_t(cpu)];
+}
+
+const common::usage::CoreUsage &CPUSet::coreUsage() const
+{
+    return d->m_coreUsage;
+}
+
+const common::usage::CoreRunQueue &CPUSet::coreRunQueue() const
+{
+    return d->m_coreRunQueue;
+}
+
+QMap<int, QVector<int>> CPUSet::numaNodes() const
+{
+    return d->m_numaNodes;
+}
+
+qreal CPUSet::numaNodeUsagePercent(int node) const
+{
+    // offline cpus are not in the last stat read
+    qreal sum = 0;
+    int count = 0;
+    for (int cpu : d->m_numaNodes.value(node)) {
+        if (std::binary_search(d->m_cpuIds.cbegin(), d->m_cpuIds.cend(), cpu)) {
+            sum += cpuUsagePercent(cpu);
+            ++count;
+        }
+    }
+    return count > 0 ? sum / count : 0;
+}
+
+// mean of a per core percent over the cpus of the last stat read, cpus no time elapsed on are skipped
+static qreal onlineAverage(const QVector<int> &cpuIds, const std::vector<double> &percents)
+{
+    qreal sum = 0;
+    int count = 0;
+    for (int cpu : cpuIds) {
+        if (size_t(cpu) < percents.size() && !std::isnan(percents[size_t(cpu)])) {
+            sum += percents[size_t(cpu)];
+            ++count;
+        }
+    }
+    return count > 0 ? sum / count : 0;
+}
+
+qreal CPUSet::stealPercent() const
+{
+    return onlineAverage(d->m_cpuIds, d->m_coreUsage.steal);
+}
+
+qreal CPUSet::guestPercent() const
+{
+    return onlineAverage(d->m_cpuIds, d->m_coreUsage.guest);
+}
+
+qulonglong CPUSet::coreFreq(int cpu) const
+{
+    return cpu >= 0 && size_t(cpu) < d->m_coreFreq.size() ? d->m_coreFreq[size_t(cpu)] : 0;
+}
+
+qulonglong CPUSet::coreThrottleEvents(int cpu) const
+{
+    const auto &last = d->m_throttleCount[kLastStat];
+    const auto &current = d->m_throttleCount[kCurrentStat];
+    size_t i = size_t(cpu);
+    // first sample or counter reset on resume
+    if (cpu < 0 || i >= last.size() || i >= current.size() || current[i] < last[i])
+        return 0;
+    return current[i] - last[i];
+}
+
+bool CPUSet::hasThrottleCounters() const
+{
+    return d->m_hasThrottleCounters;
 }
 
 void CPUSet::update()
 {
     qCDebug(app) << "Updating CPUSet...";
+    updateStats();
+    // topology is static, read it on first update only
+    if (d->m_infos.isEmpty())
+        updateOverallInfo();
+    else
+        updateFreq();
+    qCDebug(app) << "CPUSet update finished.";
+}
+
+void CPUSet::updateStats()
+{
     read_stats();
-    read_overall_info();
+    common::usage::computeCoreUsage(d->m_cpuJiffies[kLastStat], d->m_cpuJiffies[kCurrentStat], d->m_coreUsage);
 
     d->cpusageTotal[kLastStat] = d->cpusageTotal[kCurrentStat];
     d->cpusageTotal[kCurrentStat] = d->m_usage->total;
-    qCDebug(app) << "CPUSet update finished.";
+}
+
+void CPUSet::saveInfo(QDataStream &out) const
+{
+    out << d->m_info << mIsEmptyModelName;
+}
+
+void CPUSet::loadInfo(QDataStream &in)
+{
+    in >> d->m_info >> mIsEmptyModelName;
+}
+
+void CPUSet::saveStats(QDataStream &out) const
+{
+    const cpu_stat_t &stat = *d->m_stat;
+    out << stat.user << stat.nice << stat.sys << stat.idle << stat.iowait << stat.hardirq << stat.softirq
+        << stat.steal << stat.guest << stat.guest_nice;
+    out << d->m_cpuIds;
+    const common::usage::CoreJiffies &jiffies = d->m_cpuJiffies[kCurrentStat];
+    for (int cpu : d->m_cpuIds) {
+        size_t i = size_t(cpu);
+        out << jiffies.user[i] << jiffies.nice[i] << jiffies.sys[i] << jiffies.idle[i] << jiffies.iowait[i]
+            << jiffies.hardirq[i] << jiffies.softirq[i] << jiffies.steal[i] << jiffies.guest[i] << jiffies.guest_nice[i];
+    }
+}
+
+void CPUSet::loadStats(QDataStream &in)
+{
+    // same bookkeeping as read_stats & updateStats, the figures come from the stream
+    std::swap(d->m_cpuJiffies[kLastStat], d->m_cpuJiffies[kCurrentStat]);
+
+    cpu_stat_t &stat = *d->m_stat;
+    in >> stat.user >> stat.nice >> stat.sys >> stat.idle >> stat.iowait >> stat.hardirq >> stat.softirq
+       >> stat.steal >> stat.guest >> stat.guest_nice;
+    stat.cpu = "cpu";
+    d->m_usage->cpu = stat.cpu;
+    d->m_usage->total = stat.user + stat.nice + stat.sys + stat.idle + stat.iowait + stat.hardirq + stat.softirq + stat.steal;
+    d->m_usage->idle = stat.idle + stat.iowait;
+
+    QVector<int> cpuIds;
+    in >> cpuIds;
+    d->m_cpuIds.clear();
+    for (int cpu : cpuIds) {
+        // a corrupted id must not grow the arrays without bound
+        if (cpu < 0 || cpu >= 8192 || in.status() != QDataStream::Ok)
+            break;
+        if (cpu >= d->m_cpuNames.size())
+            resizeCpuArrays(cpu + 1);
+        common::usage::CoreJiffies &jiffies = d->m_cpuJiffies[kCurrentStat];
+        size_t i = size_t(cpu);
+        in >> jiffies.user[i] >> jiffies.nice[i] >> jiffies.sys[i] >> jiffies.idle[i] >> jiffies.iowait[i]
+           >> jiffies.hardirq[i] >> jiffies.softirq[i] >> jiffies.steal[i] >> jiffies.guest[i] >> jiffies.guest_nice[i];
+        d->m_cpuIds << cpu;
+    }
+
+    common::usage::computeCoreUsage(d->m_cpuJiffies[kLastStat], d->m_cpuJiffies[kCurrentStat], d->m_coreUsage);
+    d->cpusageTotal[kLastStat] = d->cpusageTotal[kCurrentStat];
+    d->cpusageTotal[kCurrentStat] = d->m_usage->total;
+}
+
+void CPUSet::updateOverallInfo()
+{
+    read_overall_info();
+    read_lscpu();
+    saveInfoCache();
+}
+
+bool CPUSet::updateOverallInfoCached()
+{
+    // per cpu info of /proc/cpuinfo is a single read, not worth caching
+    read_overall_info();
+    if (loadInfoCache())
+        return true;
+    read_lscpu();
+    saveInfoCache();
+    return false;
+}
+
+QString CPUSet::infoCachePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/deepin/deepin-system-monitor/cpu_info.cache";
+}
+
+QByteArray CPUSet::infoCacheKey()
+{
+    QByteArray key;
+    QFile bootId(PROC_PATH_BOOT_ID);
+    if (bootId.open(QIODevice::ReadOnly))
+        key += bootId.readAll().trimmed();
+    key += '/';
+
+    struct utsname os {};
+    if (uname(&os) == 0)
+        key += os.release;
+    key += '/';
+
+    // root only, the boot id covers a board swap anyway
+    QFile uuid(SYSFS_PATH_PRODUCT_UUID);
+    if (uuid.open(QIODevice::ReadOnly))
+        key += uuid.readAll().trimmed();
+    return key;
+}
+
+bool CPUSet::loadInfoCache()
+{
+    QFile file(infoCachePath());
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_11);
+    quint32 magic = 0, version = 0;
+    QByteArray key;
+    in >> magic >> version >> key;
+    if (magic != InfoCacheMagic || version != InfoCacheVersion || key != infoCacheKey()) {
+        qCDebug(app) << "CPU info cache outdated, dropped";
+        return false;
+    }
+
+    QMap<QString, QString> info;
+    bool emptyModelName = false;
+    QMap<int, QVector<int>> numaNodes;
+    QVector<int> freqCpus;
+    in >> info >> emptyModelName >> numaNodes >> freqCpus;
+    if (in.status() != QDataStream::Ok || info.isEmpty()) {
+        qCWarning(app) << "CPU info cache corrupted, dropped";
+        return false;
+    }
+
+    d->m_info = info;
+    mIsEmptyModelName = emptyModelName;
+    d->m_numaNodes = numaNodes;
+    d->m_freqCpus = freqCpus;
+    d->m_freqReader.reset();
+    // cache figures of dmidecode are in the info already
+    read_dmi_cache = true;
+    qCInfo(app) << "Loaded CPU info cache," << d->m_info.size() << "entries";
+    return true;
+}
+
+void CPUSet::saveInfoCache() const
+{
+    // lscpu failed, keep what the last run found
+    if (d->m_info.isEmpty())
+        return;
+
+    auto path = infoCachePath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(app) << "Failed to write CPU info cache" << file.errorString();
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_11);
+    out << InfoCacheMagic << InfoCacheVersion << infoCacheKey();
+    out << d->m_info << mIsEmptyModelName << d->m_numaNodes << d->m_freqCpus;
+    // replaced at once, a reader never sees half a cache
+    if (!file.commit())
+        qCWarning(app) << "Failed to write CPU info cache" << file.errorString();
+}
+
+void CPUSet::updateFreq()
+{
+    // no cpufreq, or frequency is static (e.g. Kunpeng nominal perf), keep lscpu snapshot
+    if (d->m_freqCpus.isEmpty())
+        return;
+
+    // files are opened once per topology, read_lscpu drops the reader on hotplug
+    if (!d->m_freqReader) {
+        d->m_freqReader = std::make_shared<common::parser::CoreFreqReader>();
+        d->m_freqReader->setCpus(std::vector<int>(d->m_freqCpus.cbegin(), d->m_freqCpus.cend()));
+        d->m_hasThrottleCounters = d->m_freqReader->hasThrottleCounters();
+        d->m_coreFreq.clear();
+        d->m_throttleCount[kLastStat].clear();
+        d->m_throttleCount[kCurrentStat].clear();
+    }
+
+    std::swap(d->m_throttleCount[kLastStat], d->m_throttleCount[kCurrentStat]);
+    if (d->m_freqReader->read(d->m_coreFreq, d->m_throttleCount[kCurrentStat]) == 0)
+        return;
+
+    // same semantics as lscpu snapshot: max & average of valid frequencies
+    float maxMHz = 0.0f;
+    float sum = 0.0f;
+    int count = 0;
+    for (int cpu : d->m_freqCpus) {
+        unsigned long long khz = coreFreq(cpu);
+        if (khz == 0)
+            continue;
+        float mhz = static_cast<float>(khz) / 1000;
+        maxMHz = qMax(maxMHz, mhz);
+        sum += mhz;
+        ++count;
+    }
+    d->m_info.insert("CPU MHz", QString::number(static_cast<double>(maxMHz), 'f', 4));
+    d->m_info.insert("CPU avg MHz", QString::number(static_cast<double>(sum / count), 'f', 4));
+}
+
+bool CPUSet::parseSchedStat(const char *buf, size_t len, common::usage::CoreSchedStat &stat)
+{
+    using namespace common::parser;
+
+    /*样例数据:
+        version 15
+        timestamp 4295589574
+        cpu0 0 0 0 0 0 0 1458462335907 41795022842 2440593
+        domain0 00000003 ...
+    */
+    // offline cpus have no line & read as idle
+    std::fill(stat.runTime.begin(), stat.runTime.end(), 0);
+    std::fill(stat.runDelay.begin(), stat.runDelay.end(), 0);
+    std::fill(stat.timeslices.begin(), stat.timeslices.end(), 0);
+    bool found = false;
+    Tokenizer tok(buf, len);
+    do {
+        int cpu = 0;
+        if (!tok.consume("cpu", 3) || !tok.readUInt(cpu) || cpu >= 8192)
+            continue;
+        // yld_count, legacy, sched_count, sched_goidle, ttwu_count, ttwu_local, then rq_cpu_time, run_delay & pcount
+        unsigned long long runTime = 0, runDelay = 0, timeslices = 0;
+        if (!tok.skipTokens(6) || !tok.readU64(runTime) || !tok.readU64(runDelay) || !tok.readU64(timeslices))
+            continue;
+        if (cpu >= stat.size())
+            stat.resize(cpu + 1);
+        stat.runTime[size_t(cpu)] = runTime;
+        stat.runDelay[size_t(cpu)] = runDelay;
+        stat.timeslices[size_t(cpu)] = timeslices;
+        found = true;
+    } while (tok.nextLine());
+    return found;
+}
+
+void CPUSet::updateRunQueue()
+{
+    // missing without CONFIG_SCHEDSTATS, a line per cpu & sched domain so it's read into scratch
+    size_t len = 0;
+    const char *buf = ScratchArena::local().readFile(PROC_PATH_SCHEDSTAT, len);
+    std::swap(d->m_schedStat[kLastStat], d->m_schedStat[kCurrentStat]);
+    d->m_schedTime[kLastStat] = d->m_schedTime[kCurrentStat];
+    if (!buf || !parseSchedStat(buf, len, d->m_schedStat[kCurrentStat])) {
+        d->m_schedTime[kCurrentStat] = 0;
+        d->m_coreRunQueue.resize(0);
+        return;
+    }
+
+    struct timespec ts {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    d->m_schedTime[kCurrentStat] = qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    const qint64 elapsed = d->m_schedTime[kCurrentStat] - d->m_schedTime[kLastStat];
+    // nothing to compare against on the first read & after a cpu came online
+    if (d->m_schedTime[kLastStat] == 0 || elapsed <= 0
+        || d->m_schedStat[kLastStat].size() != d->m_schedStat[kCurrentStat].size()) {
+        d->m_coreRunQueue.resize(0);
+        return;
+    }
+    common::usage::computeCoreRunQueue(d->m_schedStat[kLastStat], d->m_schedStat[kCurrentStat], double(elapsed),
+                                       d->m_coreRunQueue);
+}
+
+void CPUSet::resizeCpuArrays(int size)
+{
+    int old = d->m_cpuNames.size();
+    d->m_cpuNames.resize(size);
+    d->m_cpuJiffies[kLastStat].resize(size);
+    d->m_cpuJiffies[kCurrentStat].resize(size);
+    d->m_coreUsage.resize(size);
+    // names are stable per cpu id, set once instead of per tick
+    for (int i = old; i < size; ++i)
+        d->m_cpuNames[i] = "cpu" + QByteArray::number(i);
 }
 
 void CPUSet::read_stats()
@@ -583,9 +1029,9 @@ void CPUSet::read_stats()
     qCDebug(app) << "Reading CPU stats from" << PROC_PATH_STAT;
     FILE *fp;
     uFile fPtr;
-    QByteArray line(BUFSIZ, '\0');
+    char line[BUFSIZ];
     int ncpu = 0;
-    int nr;
+    bool parsed;
 
     if (!(fp = fopen(PROC_PATH_STAT, "r"))) {
         qCWarning(app) << "Failed to open" << PROC_PATH_STAT << ":" << strerror(errno);
@@ -593,8 +1039,13 @@ void CPUSet::read_stats()
     }
     fPtr.reset(fp);
 
-    while (fgets(line.data(), BUFSIZ, fp)) {
-        if (!strncmp(line.data(), "cpu ", 4)) {
+    // current usage becomes previous, buffers keep their capacity across ticks
+    std::swap(d->m_cpuJiffies[kLastStat], d->m_cpuJiffies[kCurrentStat]);
+    d->m_cpuIds.clear();
+
+    while (fgets(line, BUFSIZ, fp)) {
+        common::parser::Tokenizer tok(line);
+        if (tok.consume("cpu ", 4)) {
             if (!d->m_stat) {
                 // qCDebug(app) << "Allocating overall cpu_stat_t";
                 d->m_stat = std::make_shared<struct cpu_stat_t>();
@@ -603,19 +1054,18 @@ void CPUSet::read_stats()
 
             if (d->m_stat) {
                 // all cpu stat in jiffies
-                nr = sscanf(line.data() + 5, "%llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
-                            &d->m_stat->user,
-                            &d->m_stat->nice,
-                            &d->m_stat->sys,
-                            &d->m_stat->idle,
-                            &d->m_stat->iowait,
-                            &d->m_stat->hardirq,
-                            &d->m_stat->softirq,
-                            &d->m_stat->steal,
-                            &d->m_stat->guest,
-                            &d->m_stat->guest_nice);
-
-                if (nr == 10) {
+                parsed = tok.readU64(d->m_stat->user)
+                        && tok.readU64(d->m_stat->nice)
+                        && tok.readU64(d->m_stat->sys)
+                        && tok.readU64(d->m_stat->idle)
+                        && tok.readU64(d->m_stat->iowait)
+                        && tok.readU64(d->m_stat->hardirq)
+                        && tok.readU64(d->m_stat->softirq)
+                        && tok.readU64(d->m_stat->steal)
+                        && tok.readU64(d->m_stat->guest)
+                        && tok.readU64(d->m_stat->guest_nice);
+
+                if (parsed) {
                     // qCDebug(app) << "Successfully parsed overall CPU stats.";
                     // usage calc
                     QByteArray cpu { "cpu" };
@@ -636,52 +1086,37 @@ void CPUSet::read_stats()
                     qCWarning(app) << "Failed to parse CPU stats from" << PROC_PATH_STAT;
                 }
             }
-        } else if (!strncmp(line.data(), "cpu", 3)) {
+        } else if (tok.consume("cpu", 3)) {
             // per cpu stat in jiffies
-            auto stat = std::make_shared<struct cpu_stat_t>();
-            if (stat) {
-                *stat = {};
-
-                nr = sscanf(line.data() + 3, "%d %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
-                            &ncpu,
-                            &stat->user,
-                            &stat->nice,
-                            &stat->sys,
-                            &stat->idle,
-                            &stat->iowait,
-                            &stat->hardirq,
-                            &stat->softirq,
-                            &stat->steal,
-                            &stat->guest,
-                            &stat->guest_nice);
-
-                if (nr == 11) {
-                    QByteArray cpu { "cpu" };
-                    cpu.append(QByteArray::number(ncpu));
-                    stat->cpu = cpu;
-                    // qCDebug(app) << "Successfully parsed stats for" << cpu;
-
-                    // usage calc
-                    auto usage = std::make_shared<struct cpu_usage_t>();
-                    if (usage) {
-                        *usage = {};
-                        usage->cpu = cpu;
-                        usage->total = stat->user + stat->nice + stat->sys + stat->idle + stat->iowait + stat->hardirq + stat->softirq + stat->steal;
-                        usage->idle = stat->idle + stat->iowait;
-
-                        d->m_statDB[stat->cpu] = stat;
-                        d->m_usageDB[usage->cpu] = usage;
-                    }
-                } else {
-                    qCWarning(app) << "Failed to parse CPU" << ncpu << "stats from" << PROC_PATH_STAT;
-                }
+            if (!tok.readInt(ncpu) || ncpu < 0) {
+                qCWarning(app) << "Failed to parse CPU id from" << PROC_PATH_STAT;
+                continue;
             }
-        } else if (!strncmp(line.data(), "btime", 5)) {
+            if (ncpu >= d->m_cpuNames.size())
+                resizeCpuArrays(ncpu + 1);
+
+            common::usage::CoreJiffies &jiffies = d->m_cpuJiffies[kCurrentStat];
+            size_t i = size_t(ncpu);
+            parsed = tok.readU64(jiffies.user[i])
+                    && tok.readU64(jiffies.nice[i])
+                    && tok.readU64(jiffies.sys[i])
+                    && tok.readU64(jiffies.idle[i])
+                    && tok.readU64(jiffies.iowait[i])
+                    && tok.readU64(jiffies.hardirq[i])
+                    && tok.readU64(jiffies.softirq[i])
+                    && tok.readU64(jiffies.steal[i])
+                    && tok.readU64(jiffies.guest[i])
+                    && tok.readU64(jiffies.guest_nice[i]);
+
+            if (parsed)
+                d->m_cpuIds << ncpu;
+            else
+                qCWarning(app) << "Failed to parse CPU" << ncpu << "stats from" << PROC_PATH_STAT;
+        } else if (tok.consume("btime", 5)) {
             // read boot time in seconds since epoch
             struct timeval btime {};
             long nsec {};
-            int nm = sscanf(line.data() + 5, "%ld", &nsec);
-            if (nm == 1) {
+            if (tok.readInt(nsec)) {
                 btime.tv_sec = nsec;
                 btime.tv_usec = 0;
                 // qCDebug(app) << "Parsed boot time:" << btime.tv_sec;
@@ -689,7 +1124,7 @@ void CPUSet::read_stats()
                 // set sysinfo btime
                 auto *monitor = ThreadManager::instance()->thread<SystemMonitorThread>(BaseThread::kSystemMonitorThread)->systemMonitorInstance();
                 monitor->sysInfo()->set_btime(btime);
-            }   // ::if(nm == 1)
+            }   // ::if(readInt)
         }   // ::if(btime)
     }   // ::while(fgets)
 
@@ -704,10 +1139,13 @@ void CPUSet::read_overall_info()
     qCDebug(app) << "Reading overall CPU info from /proc/cpuinfo...";
     //proc/cpuinfo
     QList<CPUInfo> infos;
-    QProcess process;
-    process.start("cat /proc/cpuinfo");
-    process.waitForFinished(3000);
-    QString cpuinfo = process.readAllStandardOutput();
+    QFile file(PROC_PATH_CPUINFO);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(app) << "Failed to open" << PROC_PATH_CPUINFO << ":" << file.errorString();
+        return;
+    }
+    QString cpuinfo = file.readAll();
+    file.close();
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     QStringList processors = cpuinfo.split("\n\n", QString::SkipEmptyParts);
 #else
@@ -769,7 +1207,6 @@ void CPUSet::read_overall_info()
     //        read_lscpu();
     //        d->m_infos = infos;
     //    }
-    read_lscpu();
     d->m_infos = infos;
     qCDebug(app) << "Finished reading overall CPU info.";
 }
@@ -907,6 +1344,8 @@ void CPUSet::read_dmi_cache_info()
 void CPUSet::read_lscpu()
 {
     qCDebug(app) << "Reading CPU info using lscpu library...";
+    d->m_freqCpus.clear();
+    d->m_freqReader.reset();
     struct lscpu_cxt *cxt;   // CPU信息
     cxt = reinterpret_cast<struct lscpu_cxt *>(xcalloc(1, sizeof(struct lscpu_cxt)));   // 初始化信息
     if (!cxt) {
@@ -950,6 +1389,15 @@ void CPUSet::read_lscpu()
     lscpu_read_archext(cxt);
     lscpu_read_vulnerabilities(cxt);
     lscpu_read_numas(cxt);
+    d->m_numaNodes.clear();
+    for (size_t i = 0; i < cxt->nnodes; i++) {
+        QVector<int> &cpus = d->m_numaNodes[cxt->idx2nodenum[i]];
+        for (int cpu = 0; cxt->nodemaps[i] && cpu < cxt->maxcpus; cpu++) {
+            if (CPU_ISSET_S(size_t(cpu), cxt->setsize, cxt->nodemaps[i]))
+                cpus << cpu;
+        }
+    }
+    qCDebug(app) << "Read" << d->m_numaNodes.size() << "numa nodes";
     lscpu_read_topology(cxt);
     qCDebug(app) << "Read topology and other extensions.";
     lscpu_decode_arm(cxt);
@@ -1090,6 +1538,16 @@ void CPUSet::read_lscpu()
             }
             d->m_info.insert("CPU MHz", nowMHz);
             d->m_info.insert("CPU avg MHz", avgMHz);
+
+            // cpus whose current frequency can be sampled directly between snapshots
+            bool nominal = ct->modelname && strstr(ct->modelname, "Kunpeng");
+            if (scal != 0.0f && !nominal) {
+                for (size_t i = 0; i < cxt->npossibles; i++) {
+                    struct lscpu_cpu *cpu = cxt->cpus[i];
+                    if (cpu && cpu->type == ct && is_cpu_present(cxt, cpu))
+                        d->m_freqCpus << cpu->logical_id;
+                }
+            }
             qCDebug(app) << "Populated frequency: Min=" << minMHz << "Max=" << maxMHz << "Current=" << nowMHz << "Average=" << avgMHz;
         } else {
             if (CurrentCPUFreq > 0) {
@@ -1199,5 +1657,10 @@ qulonglong CPUSet::getUsageTotalDelta() const
     return d->cpusageTotal[kCurrentStat] - d->cpusageTotal[kLastStat];
 }
 
+qulonglong CPUSet::usageTotal() const
+{
+    return d->cpusageTotal[kCurrentStat];
+}
+
 }   // namespace system
 }   // namespace core
@@ -6,9 +6,13 @@
 #define CPUSET_H
 
 #include "cpu.h"
+#include "common/core_usage.h"
 #include "3rdparty/dmidecode/dmidecode.h"
 #include <QList>
 #include <QSharedDataPointer>
+#include <QVector>
+
+class QDataStream;
 
 namespace core {
 namespace system {
@@ -46,6 +50,12 @@ public://info
 
     QString avgFreq() const;
 
+    /**
+     * @brief Scaling range of the cpus in MHz, 0 if unknown
+     */
+    qreal minFreqMHz() const;
+    qreal maxFreqMHz() const;
+
     QString l1dCache() const;
 
     QString l1iCache() const;
@@ -68,13 +78,131 @@ public://usage
 
     const CPUUsage usageDB(const QByteArray &cpu) const;
 
+    /**
+     * @brief Ids of cpus in the most recent stat read, ascending
+     */
+    QVector<int> cpuIds() const;
+
+    cpu_stat_t cpuStat(int cpu) const;
+
+    cpu_usage_t cpuUsage(int cpu) const;
+
+    /**
+     * @brief Usage percent of cpu between the last two stat reads
+     */
+    qreal cpuUsagePercent(int cpu) const;
+
+    /**
+     * @brief Usage of all cores between the last two stat reads, indexed by cpu id
+     */
+    const common::usage::CoreUsage &coreUsage() const;
+
+    /**
+     * @brief Run queue of all cores between the last two schedstat reads, indexed by cpu id,
+     * empty without /proc/schedstat
+     */
+    const common::usage::CoreRunQueue &coreRunQueue() const;
+
     qulonglong getUsageTotalDelta() const;
+    /**
+     * @brief Total cpu time of the most recent stat read, in jiffies
+     */
+    qulonglong usageTotal() const;
+
+    /**
+     * @brief Logical ids of the cpus of each numa node, ascending, a single node on most desktops
+     */
+    QMap<int, QVector<int>> numaNodes() const;
+    /**
+     * @brief Average usage percent of the online cpus of a numa node between the last two stat reads
+     */
+    qreal numaNodeUsagePercent(int node) const;
+    /**
+     * @brief Average percent of the online cpus stolen by the hypervisor between the last two stat reads
+     */
+    qreal stealPercent() const;
+    /**
+     * @brief Average percent of the online cpus running guest vcpus, part of the user time
+     */
+    qreal guestPercent() const;
+
+    /**
+     * @brief Current frequency of a cpu in kHz from the last freq sample, 0 if unknown
+     */
+    qulonglong coreFreq(int cpu) const;
+    /**
+     * @brief Thermal throttle events of a cpu between the last two freq samples
+     */
+    qulonglong coreThrottleEvents(int cpu) const;
+    /**
+     * @brief Whether the platform exposes thermal throttle counters, x86 only
+     */
+    bool hasThrottleCounters() const;
 
 public:
     void update();
+    /**
+     * @brief Refresh /proc/stat based usage only
+     */
+    void updateStats();
+    /**
+     * @brief Refresh static topology & cache info, only needed once & on cpu hotplug
+     *
+     * Written to the info cache afterwards, see loadInfoCache()
+     */
+    void updateOverallInfo();
+    /**
+     * @brief Take topology & cache info from the last run if nothing changed since, read it otherwise
+     * @return true if the info cache was used, updateOverallInfo() is left to revalidate it then
+     */
+    bool updateOverallInfoCached();
+
+    /**
+     * @brief Load lscpu & dmidecode results of a previous run
+     *
+     * Keyed by boot id, kernel release & dmi product uuid, no hardware or kernel change goes
+     * without changing one of them.
+     * @return false if there's no cache or it was written for another key
+     */
+    bool loadInfoCache();
+    void saveInfoCache() const;
+    static QString infoCachePath();
+    /**
+     * @brief Key of the info cache on this boot
+     */
+    static QByteArray infoCacheKey();
+    /**
+     * @brief Sample current frequency & throttle counters of each core from sysfs
+     */
+    void updateFreq();
+
+    /**
+     * @brief Sample the per core counters of /proc/schedstat, runnable tasks & their wait
+     */
+    void updateRunQueue();
+    /**
+     * @brief Parse the cpu lines of /proc/schedstat into arrays indexed by cpu id
+     * @return false without any cpu line
+     */
+    static bool parseSchedStat(const char *buf, size_t len, common::usage::CoreSchedStat &stat);
+
+    /**
+     * @brief Write model & cache info, for flight recordings
+     */
+    void saveInfo(QDataStream &out) const;
+    void loadInfo(QDataStream &in);
+    /**
+     * @brief Write the jiffies of the last stat read, for flight recordings
+     */
+    void saveStats(QDataStream &out) const;
+    /**
+     * @brief Take jiffies written by saveStats() as the next stat read, usage is computed against the previous one
+     */
+    void loadStats(QDataStream &in);
 
 private:
     void read_stats();
+    void resizeCpuArrays(int size);
     /**
      * @brief read_dmidecode 通过dmidecod读取CPU的cache信息
      */
@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "demand_tracker.h"
+#include "ddlog.h"
+
+using namespace DDLog;
+
+namespace core {
+namespace system {
+
+Q_GLOBAL_STATIC(DemandTracker, theInstance)
+
+DemandTracker::DemandTracker(QObject *parent)
+    : QObject(parent)
+{
+}
+
+DemandTracker *DemandTracker::instance()
+{
+    return theInstance();
+}
+
+void DemandTracker::declare(QObject *subscriber, int demands)
+{
+    if (!subscriber)
+        return;
+
+    bool added = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_subscribers.find(subscriber);
+        if (it == m_subscribers.end()) {
+            m_subscribers.insert(subscriber, {demands & kAllDemands, false});
+            added = true;
+        } else {
+            it->demands = demands & kAllDemands;
+        }
+    }
+    if (added)
+        connect(subscriber, &QObject::destroyed, this, [this, subscriber]() { remove(subscriber); }, Qt::DirectConnection);
+    update();
+}
+
+void DemandTracker::setVisible(QObject *subscriber, bool visible)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_subscribers.find(subscriber);
+        if (it == m_subscribers.end() || it->visible == visible)
+            return;
+        it->visible = visible;
+    }
+    update();
+}
+
+void DemandTracker::setTracking(bool tracking)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_tracking == tracking)
+            return;
+        m_tracking = tracking;
+    }
+    update();
+}
+
+void DemandTracker::setSuspended(bool suspended)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_suspended == suspended)
+            return;
+        m_suspended = suspended;
+    }
+    update();
+}
+
+void DemandTracker::remove(QObject *subscriber)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_subscribers.remove(subscriber))
+            return;
+    }
+    update();
+}
+
+void DemandTracker::update()
+{
+    int demands = 0;
+    int previous = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_tracking) {
+            demands = kAllDemands;
+        } else if (!m_suspended) {
+            for (const auto &subscriber : m_subscribers) {
+                if (subscriber.visible)
+                    demands |= subscriber.demands;
+            }
+        }
+        previous = m_demands.exchange(demands);
+    }
+    if (previous == demands)
+        return;
+
+    qCInfo(app) << "Data demanded by visible views:" << demands << "was" << previous;
+    Q_EMIT demandsChanged(demands, demands & ~previous);
+}
+
+} // namespace system
+} // namespace core
@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DEMAND_TRACKER_H
+#define DEMAND_TRACKER_H
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+
+#include <atomic>
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Data asked for by what is on screen, producers of data nobody asks for are suspended
+ *
+ * Models & views declare what they need while visible & report their visibility, the tracker
+ * keeps the union of the visible ones. Until tracking is turned on by the main window everything is
+ * demanded, so the popup & the headless exporter sample as before. While suspended (main window
+ * minimized or in the tray) nothing is. Changes are signalled with what was gained, so producers can warm up right away.
+ * Thread safe, demands() & isDemanded() are lock free.
+ */
+class DemandTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Demand {
+        kProcessNetDemand = 0x1, // fd walks, socket tables & packet capture behind process traffic & fds
+        kServiceDemand = 0x2, // systemd unit changes of the service list
+        kCpuCoreDemand = 0x4, // per core frequencies, throttling & run queues
+        kNetifDemand = 0x8, // per interface stats & addresses
+        kWakeupDemand = 0x10, // kernel tracing of process wakeups by the system server
+
+        kAllDemands = 0x1f
+    };
+
+    explicit DemandTracker(QObject *parent = nullptr);
+
+    static DemandTracker *instance();
+
+    /**
+     * @brief Declare what \a subscriber needs while visible, it starts hidden & is dropped when destroyed
+     * @param demands Demand flags
+     */
+    void declare(QObject *subscriber, int demands);
+    void setVisible(QObject *subscriber, bool visible);
+    /**
+     * @brief Demand only what subscribers ask for, everything is demanded while off
+     */
+    void setTracking(bool tracking);
+    /**
+     * @brief Demand nothing whatever is visible, e.g. while the main window is minimized
+     */
+    void setSuspended(bool suspended);
+
+    inline int demands() const
+    {
+        return m_demands.load();
+    }
+    inline bool isDemanded(Demand demand) const
+    {
+        return m_demands.load() & demand;
+    }
+
+Q_SIGNALS:
+    /**
+     * @brief Emitted on the thread of the change
+     * @param demands Demands now
+     * @param gained Demands not asked for before
+     */
+    void demandsChanged(int demands, int gained);
+
+private:
+    struct subscriber_t {
+        int demands;
+        bool visible;
+    };
+
+    void remove(QObject *subscriber);
+    /**
+     * @brief Recompute the union & signal it if it changed, called without m_mutex held
+     */
+    void update();
+
+    mutable QMutex m_mutex;
+    QHash<QObject *, subscriber_t> m_subscribers;
+    bool m_tracking {false};
+    bool m_suspended {false};
+    std::atomic<int> m_demands {kAllDemands};
+};
+
+} // namespace system
+} // namespace core
+
+#endif // DEMAND_TRACKER_H
@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "device_db.h"
+#include "device_snapshot.h"
 #include "ddlog.h"
 
 #include "cpu_set.h"
@@ -12,6 +13,12 @@
 #include "netif_info_db.h"
 #include "diskio_info.h"
 #include "net_info.h"
+#include "gpu_info_db.h"
+#include "sensor_info_db.h"
+#include "mem_tuning_info_db.h"
+#include "filesystem_info_db.h"
+#include "common/cgroup_stats.h"
+#include "common/pressure_stats.h"
 #include "common/thread_manager.h"
 #include "system/system_monitor.h"
 #include "system/system_monitor_thread.h"
@@ -20,12 +27,19 @@
 #include <QReadLocker>
 #include <QWriteLocker>
 
+#include <atomic>
+
+#include <unistd.h>
+
 using namespace DDLog;
+using namespace common::cgroup;
+using namespace common::pressure;
 
 namespace core {
 namespace system {
 
 DeviceDB::DeviceDB()
+    : m_snapshot(std::make_shared<DeviceSnapshot>())
 {
     qCDebug(app) << "DeviceDB constructor: Initializing all device info objects...";
     m_cpuSet = new CPUSet();
@@ -34,6 +48,16 @@ DeviceDB::DeviceDB()
     m_blkDevInfoDB = new BlockDeviceInfoDB();
     m_diskIoInfo = new DiskIOInfo();
     m_netInfo = new NetInfo();
+    m_gpuInfoDB.reset(new GpuInfoDB());
+    m_sensorInfoDB.reset(new SensorInfoDB());
+    m_memTuningInfoDB.reset(new MemTuningInfoDB());
+    m_filesystemInfoDB.reset(new FilesystemInfoDB());
+    if (PressureStats::isAvailable()) {
+        m_pressureStats.reset(new PressureStats());
+        // apps of the user run below the session slice, without it only the system is shown
+        m_pressureStats->setControlGroup(PressureStats::sessionCgroup(CgroupStats::processCgroup(getpid())));
+        qCInfo(app) << "Pressure stall information available, session cgroup:" << m_pressureStats->controlGroup();
+    }
     qCDebug(app) << "DeviceDB construction finished.";
 }
 
@@ -78,13 +102,88 @@ void DeviceDB::update()
     qCDebug(app) << "DeviceDB update: Triggering update on all device info objects...";
     m_cpuSet->update();
     m_memInfo->readMemInfo();
-    m_netifInfoDB->update();
+    updateNetifInfo();
+    updateGpuInfo();
+    updateSensorInfo();
+    updateMemTuningInfo();
+    updateFilesystemInfo();
+    m_blkDevInfoDB->updateDeviceStats();
     m_blkDevInfoDB->update();
     m_diskIoInfo->update();
     m_netInfo->resdNetInfo();
+    publishSnapshot();
     qCDebug(app) << "DeviceDB update finished.";
 }
 
+DeviceSnapshotPtr DeviceDB::snapshot() const
+{
+    return std::atomic_load(&m_snapshot);
+}
+
+void DeviceDB::publishSnapshot()
+{
+    std::shared_ptr<DeviceSnapshot> snapshot = std::make_shared<DeviceSnapshot>();
+    snapshot->cpuSet = *m_cpuSet;
+    snapshot->memInfo = *m_memInfo;
+    snapshot->netifInfo = m_netifInfoDB->infoDB();
+    snapshot->blockDevices = m_blkDevInfoDB->deviceList();
+    snapshot->diskReadBps = m_diskIoInfo->diskIoReadBps();
+    snapshot->diskWriteBps = m_diskIoInfo->diskIoWriteBps();
+    snapshot->netRecvBps = m_netInfo->recvBps();
+    snapshot->netSentBps = m_netInfo->sentBps();
+    snapshot->netTotalRecvBytes = m_netInfo->totalRecvBytes();
+    snapshot->netTotalSentBytes = m_netInfo->totalSentBytes();
+    if (m_pressureStats) {
+        for (int i = 0; i < kPressureResourceCount; ++i) {
+            snapshot->pressure[i] = m_pressureStats->system(PressureResource(i));
+            snapshot->sessionPressure[i] = m_pressureStats->cgroup(PressureResource(i));
+        }
+    }
+    snapshot->gpus = m_gpuInfoDB->devices();
+    snapshot->sensors = m_sensorInfoDB->sensors();
+    snapshot->memTuning = m_memTuningInfoDB->info();
+    snapshot->filesystems = m_filesystemInfoDB->filesystems();
+
+    publishSnapshot(DeviceSnapshotPtr(std::move(snapshot)));
+}
+
+void DeviceDB::publishSnapshot(const DeviceSnapshotPtr &snapshot)
+{
+    // readers holding the previous snapshot keep it alive until they drop it
+    std::atomic_store(&m_snapshot, snapshot);
+}
+
+void DeviceDB::updateNetifInfo()
+{
+    m_netifInfoDB->update();
+}
+
+void DeviceDB::updatePressure()
+{
+    if (m_pressureStats)
+        m_pressureStats->update();
+}
+
+void DeviceDB::updateGpuInfo()
+{
+    m_gpuInfoDB->update();
+}
+
+void DeviceDB::updateSensorInfo()
+{
+    m_sensorInfoDB->update();
+}
+
+void DeviceDB::updateMemTuningInfo()
+{
+    m_memTuningInfoDB->update();
+}
+
+void DeviceDB::updateFilesystemInfo()
+{
+    m_filesystemInfoDB->update();
+}
+
 DeviceDB *DeviceDB::instance()
 {
     // qCDebug(app) << "DeviceDB instance: Getting instance...";
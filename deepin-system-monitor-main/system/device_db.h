@@ -6,6 +6,14 @@
 #ifndef DEVICE_DB_H
 #define DEVICE_DB_H
 
+#include <memory>
+
+namespace common {
+namespace pressure {
+class PressureStats;
+} // namespace pressure
+} // namespace common
+
 namespace core {
 namespace system {
 
@@ -16,9 +24,19 @@ class CPUSet;
 class SystemMonitor;
 class DiskIOInfo;
 class NetInfo;
+class GpuInfoDB;
+class SensorInfoDB;
+class MemTuningInfoDB;
+class FilesystemInfoDB;
+struct DeviceSnapshot;
+
+using DeviceSnapshotPtr = std::shared_ptr<const DeviceSnapshot>;
 
 /**
  * @brief The DeviceDB class
+ *
+ * Device objects are owned & updated by the monitor thread. Other threads read the
+ * state through snapshot(), the monitor publishes a new one after each refresh.
  */
 class DeviceDB
 {
@@ -36,6 +54,40 @@ public:
     NetInfo *netInfo();
 
     void update();
+    void updateNetifInfo();
+    /**
+     * @brief Sample pressure stall information of the system & of the user session
+     */
+    void updatePressure();
+    /**
+     * @brief Sample device level gpu utilization from sysfs
+     */
+    void updateGpuInfo();
+    /**
+     * @brief Read hwmon & thermal zone sensors, enumerated again on udev events
+     */
+    void updateSensorInfo();
+    /**
+     * @brief Read huge page, zswap & zram state
+     */
+    void updateMemTuningInfo();
+    /**
+     * @brief Reread mount table if it changed & pick up filesystem capacity sampled in background
+     */
+    void updateFilesystemInfo();
+
+    /**
+     * @brief Latest published device state, never null, safe to call from any thread
+     */
+    DeviceSnapshotPtr snapshot() const;
+    /**
+     * @brief Copy current device state into a new snapshot & publish it, monitor thread only
+     */
+    void publishSnapshot();
+    /**
+     * @brief Publish a snapshot made elsewhere, e.g. of a replayed recording, sampling must be paused meanwhile
+     */
+    void publishSnapshot(const DeviceSnapshotPtr &snapshot);
 
 private:
     CPUSet *m_cpuSet;
@@ -44,6 +96,14 @@ private:
     BlockDeviceInfoDB *m_blkDevInfoDB;
     DiskIOInfo *m_diskIoInfo;
     NetInfo *m_netInfo;
+    std::unique_ptr<common::pressure::PressureStats> m_pressureStats;
+    std::unique_ptr<GpuInfoDB> m_gpuInfoDB;
+    std::unique_ptr<SensorInfoDB> m_sensorInfoDB;
+    std::unique_ptr<MemTuningInfoDB> m_memTuningInfoDB;
+    std::unique_ptr<FilesystemInfoDB> m_filesystemInfoDB;
+
+    // swapped with std::atomic_store, read with std::atomic_load
+    DeviceSnapshotPtr m_snapshot;
 };
 
 } // namespace system
@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DEVICE_SNAPSHOT_H
+#define DEVICE_SNAPSHOT_H
+
+#include "cpu_set.h"
+#include "mem.h"
+#include "block_device.h"
+#include "gpu_info_db.h"
+#include "sensor_info_db.h"
+#include "mem_tuning_info_db.h"
+#include "filesystem_info_db.h"
+#include "common/pressure_stats.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+
+#include <memory>
+
+namespace core {
+namespace system {
+class NetifInfo;
+} // namespace system
+} // namespace core
+
+using NetifInfoPtr = std::shared_ptr<class core::system::NetifInfo>;
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Copy of device state built on the monitor thread once per refresh
+ *
+ * Members are implicitly shared with the live objects in DeviceDB, the monitor detaches
+ * its side on next update, so a published snapshot is never modified & can be read from
+ * any thread without locking.
+ */
+struct DeviceSnapshot {
+    CPUSet cpuSet;
+    MemInfo memInfo;
+    QMap<QByteArray, NetifInfoPtr> netifInfo; // keyed by link address, empty in popup
+    QList<BlockDevice> blockDevices;
+
+    qreal diskReadBps {0}; // bytes per second
+    qreal diskWriteBps {0};
+
+    qreal netRecvBps {0}; // bytes per second
+    qreal netSentBps {0};
+    qulonglong netTotalRecvBytes {0};
+    qulonglong netTotalSentBytes {0};
+
+    // by common::pressure::PressureResource, invalid without psi & in popup
+    common::pressure::pressure_t pressure[common::pressure::kPressureResourceCount];
+    common::pressure::pressure_t sessionPressure[common::pressure::kPressureResourceCount]; // user session cgroup
+
+    QList<gpu_device_t> gpus; // empty in popup
+    QList<sensor_t> sensors; // hwmon & thermal zones, empty in popup
+    mem_tuning_t memTuning; // huge pages, zswap & zram, invalid in popup
+    QList<filesystem_t> filesystems; // mounted, empty in popup
+};
+
+using DeviceSnapshotPtr = std::shared_ptr<const DeviceSnapshot>;
+
+} // namespace system
+} // namespace core
+
+#endif // DEVICE_SNAPSHOT_H
@@ -7,6 +7,7 @@
 #include "ddlog.h"
 #include "common/common.h"
 #include "system/sys_info.h"
+#include "common/proc_parser.h"
 
 #include <ctype.h>
 #include <errno.h>
@@ -16,6 +17,7 @@
 
 using namespace common::error;
 using namespace common::alloc;
+using namespace common::parser;
 using namespace DDLog;
 
 namespace core {
@@ -55,21 +57,6 @@ void DiskIOInfo::readDiskIOStats()
     unsigned int major, minor;
     char dev_name[MAX_NAME_LEN + 1];
 
-    // ignore any partition stats here, ref: sysstat#common.c#is_device
-    auto is_block_dev = [ = ](char *dev_name) -> bool {
-        char syspath[PATH_MAX];
-        char *slash;
-
-        // replace any '/' characters in device names if any
-        while ((slash = strchr(dev_name, '/')))
-        {
-            *slash = '!';
-        }
-
-        snprintf(syspath, sizeof(syspath), "%s/%s", SYSFS_PATH_BLOCK, dev_name);
-        return (!access(syspath, F_OK));
-    };
-
     if ((fp = fopen(PROC_PATH_DISK, "r")) == nullptr) {
         qCWarning(app) << "Failed to open" << PROC_PATH_DISK << ":" << strerror(errno);
         return;
@@ -81,22 +68,32 @@ void DiskIOInfo::readDiskIOStats()
     m_diskIoStatMap[kCurrentStat].clear();
 
     while (fgets(line.data(), bsiz, fp)) {
-        int rc;
+        Tokenizer tok(line.data());
+        const char *name;
+        size_t len;
         auto stat = std::make_shared<disk_io_stat>();
-        //************************1**2**3****4********5********6*******7********************8********9**
-        rc = sscanf(line.data(), "%u %u %128s %llu %*u %llu %*u %llu %*u %llu %*u %*u %*u %*u %llu %*u %llu",
-                    &major,
-                    &minor,
-                    dev_name,
-                    &stat->read_ios,
-                    &stat->read_sectors,
-                    &stat->write_ios,
-                    &stat->write_sectors,
-                    &stat->discard_ios,
-                    &stat->discard_sectors);
+        bool parsed = tok.readUInt(major) // 1
+                && tok.readUInt(minor) // 2
+                && tok.readToken(name, len) // 3
+                && tok.readU64(stat->read_ios) // 4
+                && tok.skipTokens(1)
+                && tok.readU64(stat->read_sectors) // 6
+                && tok.skipTokens(1)
+                && tok.readU64(stat->write_ios) // 8
+                && tok.skipTokens(1)
+                && tok.readU64(stat->write_sectors); // 10
         // discard io stats might not be available
-        if (rc >= 7) {
-            if (is_block_dev(dev_name)) {
+        if (parsed) {
+            tok.skipTokens(4) // 11 ~ 14
+                    && tok.readU64(stat->discard_ios) // 15
+                    && tok.skipTokens(1)
+                    && tok.readU64(stat->discard_sectors); // 17
+
+            len = qMin(len, size_t(MAX_NAME_LEN));
+            memcpy(dev_name, name, len);
+            dev_name[len] = '\0';
+
+            if (isBlockDevice(major, minor, dev_name)) {
                 // per block dev stats
                 qCDebug(app) << "Parsed disk stats for device:" << dev_name;
                 timevalList[kCurrentStat] = SysInfo::instance()->uptime();
@@ -113,6 +110,32 @@ void DiskIOInfo::readDiskIOStats()
     qCDebug(app) << "Finished reading disk IO stats. Found" << m_diskIoStatMap[kCurrentStat].size() << "block devices.";
 }
 
+bool DiskIOInfo::isBlockDevice(unsigned int major, unsigned int minor, const char *dev_name)
+{
+    // sysfs is only checked once per device number, unless the number is reused by another device
+    quint64 devno = (quint64(major) << 32) | minor;
+    auto it = m_blockDevCache.find(devno);
+    if (it != m_blockDevCache.end() && it.value().first == dev_name)
+        return it.value().second;
+
+    // ignore any partition stats here, ref: sysstat#common.c#is_device
+    char syspath[PATH_MAX];
+    char name[MAX_NAME_LEN + 1];
+    char *slash;
+
+    // replace any '/' characters in device names if any
+    strncpy(name, dev_name, sizeof(name) - 1);
+    name[MAX_NAME_LEN] = '\0';
+    while ((slash = strchr(name, '/'))) {
+        *slash = '!';
+    }
+
+    snprintf(syspath, sizeof(syspath), "%s/%s", SYSFS_PATH_BLOCK, name);
+    bool isBlockDev = !access(syspath, F_OK);
+    m_blockDevCache.insert(devno, qMakePair(QByteArray(dev_name), isBlockDev));
+    return isBlockDev;
+}
+
 void DiskIOInfo::calDiskIoStates()
 {
     qCDebug(app) << "Calculating disk IO states...";
@@ -7,6 +7,8 @@
 #define DISKIO_INFO_H
 
 #include <QMap>
+#include <QHash>
+#include <QPair>
 #include <memory>
 
 namespace core {
@@ -37,6 +39,7 @@ public:
 private:
     void readDiskIOStats();
     void calDiskIoStates();
+    bool isBlockDevice(unsigned int major, unsigned int minor, const char *dev_name);
 
 private:
     QMap<QString, std::shared_ptr<disk_io_stat>> m_diskIoStatMap[kStatCount];
@@ -44,6 +47,9 @@ private:
 
     qreal m_readBps = 0;
     qreal m_writeBps = 0;
+
+    // major:minor => (device name, whole device or partition), partitions are filtered out
+    QHash<quint64, QPair<QByteArray, bool>> m_blockDevCache;
 };
 
 } // namespace system
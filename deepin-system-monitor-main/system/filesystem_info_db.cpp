@@ -0,0 +1,347 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "filesystem_info_db.h"
+#include "ddlog.h"
+
+#include <QDateTime>
+#include <QSet>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+
+using namespace DDLog;
+
+namespace core {
+namespace system {
+
+namespace {
+
+// no capacity of their own or always full, e.g. squashfs images of snaps
+const QSet<QByteArray> kPseudoTypes {
+    "autofs", "binfmt_misc", "bpf", "cgroup", "cgroup2", "configfs", "debugfs", "devpts",
+    "devtmpfs", "efivarfs", "fusectl", "hugetlbfs", "mqueue", "nfsd", "nsfs", "proc", "pstore",
+    "ramfs", "rpc_pipefs", "securityfs", "selinuxfs", "squashfs", "sysfs", "tracefs"
+};
+
+const QSet<QByteArray> kRemoteTypes {
+    "9p", "afs", "ceph", "cifs", "fuse.sshfs", "glusterfs", "lustre", "ncpfs", "nfs", "nfs4",
+    "smb3", "smbfs"
+};
+
+// kernel trees & per user runtime dirs, /dev/shm is the one tmpfs under them worth showing
+bool isPseudoMountPoint(const QByteArray &path)
+{
+    if (path == "/dev/shm")
+        return false;
+    for (const char *tree : {"/proc", "/sys", "/dev"}) {
+        if (path == tree || path.startsWith(QByteArray(tree) + '/'))
+            return true;
+    }
+    return path.startsWith("/run/user/") || path.startsWith("/run/credentials/");
+}
+
+} // namespace
+
+void FilesystemStatWorker::enqueue(const QByteArray &mountPoint)
+{
+    QMutexLocker locker(&m_mutex);
+    m_queue << mountPoint;
+    m_wakeup.wakeOne();
+}
+
+QList<FilesystemStatWorker::result_t> FilesystemStatWorker::takeResults()
+{
+    QMutexLocker locker(&m_mutex);
+    QList<result_t> results;
+    results.swap(m_results);
+    return results;
+}
+
+QList<QByteArray> FilesystemStatWorker::takeQueue()
+{
+    QMutexLocker locker(&m_mutex);
+    QList<QByteArray> queue;
+    queue.swap(m_queue);
+    return queue;
+}
+
+QByteArray FilesystemStatWorker::current(qint64 &since)
+{
+    QMutexLocker locker(&m_mutex);
+    since = m_since;
+    return m_current;
+}
+
+void FilesystemStatWorker::requestQuit()
+{
+    m_quitRequested.store(true);
+    QMutexLocker locker(&m_mutex);
+    m_wakeup.wakeAll();
+}
+
+void FilesystemStatWorker::run()
+{
+    QMutexLocker locker(&m_mutex);
+    while (!m_quitRequested.load()) {
+        if (m_queue.isEmpty()) {
+            m_wakeup.wait(&m_mutex);
+            continue;
+        }
+        m_current = m_queue.takeFirst();
+        m_since = QDateTime::currentMSecsSinceEpoch();
+        const QByteArray path = m_current;
+        locker.unlock();
+
+        struct statvfs st;
+        int rc;
+        do {
+            rc = statvfs(path.constData(), &st);
+        } while (rc < 0 && errno == EINTR);
+        result_t result {path, rc == 0, 0, 0, 0, 0, 0};
+        if (result.ok) {
+            qulonglong frsize = st.f_frsize ? st.f_frsize : st.f_bsize;
+            result.total = qulonglong(st.f_blocks) * frsize;
+            result.used = qulonglong(st.f_blocks - st.f_bfree) * frsize;
+            result.available = qulonglong(st.f_bavail) * frsize;
+            result.files = st.f_files;
+            result.filesFree = st.f_ffree;
+        }
+
+        locker.relock();
+        m_current.clear();
+        m_results << result;
+    }
+}
+
+FilesystemInfoDB::FilesystemInfoDB(const QString &mountInfo)
+    : m_mountInfo(mountInfo)
+    , m_fd(-1)
+    , m_worker(new FilesystemStatWorker)
+{
+    m_worker->start(QThread::LowPriority);
+}
+
+FilesystemInfoDB::~FilesystemInfoDB()
+{
+    if (m_fd >= 0)
+        close(m_fd);
+
+    // a worker still stuck in statvfs is leaked, deleting a running QThread aborts
+    m_worker->requestQuit();
+    if (m_worker->wait(kStatTimeout))
+        delete m_worker;
+    for (const auto &abandoned : m_abandoned) {
+        abandoned.first->requestQuit();
+        if (abandoned.first->isFinished())
+            delete abandoned.first;
+    }
+}
+
+void FilesystemInfoDB::update()
+{
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    takeResults();
+    checkWorker(now);
+    if (mountsChanged())
+        readMounts();
+    queueDue(now);
+}
+
+QList<filesystem_t> FilesystemInfoDB::filesystems() const
+{
+    QList<filesystem_t> filesystems;
+    filesystems.reserve(m_mounts.size());
+    for (const mount_t &mount : m_mounts)
+        filesystems << mount.fs;
+    return filesystems;
+}
+
+bool FilesystemInfoDB::mountsChanged()
+{
+    if (m_fd < 0) {
+        m_fd = open(m_mountInfo.toLocal8Bit().constData(), O_RDONLY | O_CLOEXEC);
+        if (m_fd < 0) {
+            qCDebug(app) << "open" << m_mountInfo << "failed:" << strerror(errno);
+            return false;
+        }
+        return true;
+    }
+
+    // the kernel flags POLLPRI | POLLERR once after each change of the mount namespace, poll
+    // acknowledges it
+    struct pollfd pfd {m_fd, POLLPRI, 0};
+    int rc;
+    do {
+        rc = poll(&pfd, 1, 0);
+    } while (rc < 0 && errno == EINTR);
+    return rc > 0 && (pfd.revents & (POLLPRI | POLLERR));
+}
+
+void FilesystemInfoDB::readMounts()
+{
+    QByteArray data;
+    char buf[65536];
+    off_t offset = 0;
+    ssize_t n;
+    for (;;) {
+        n = pread(m_fd, buf, sizeof(buf), offset);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        data.append(buf, int(n));
+        offset += n;
+    }
+    if (n < 0) {
+        qCDebug(app) << "read" << m_mountInfo << "failed:" << strerror(errno);
+        return;
+    }
+
+    // mounts still there keep their usage & schedule
+    QList<mount_t> mounts;
+    for (const filesystem_t &fs : parseMountInfo(data)) {
+        mount_t mount {fs, fs.mountPoint.toLocal8Bit(), 0, false};
+        for (const mount_t &old : m_mounts) {
+            if (old.path == mount.path && old.fs.source == fs.source && old.fs.fsType == fs.fsType) {
+                mount.fs = old.fs;
+                mount.fs.readOnly = fs.readOnly;
+                mount.nextStat = old.nextStat;
+                mount.queued = old.queued;
+                break;
+            }
+        }
+        mounts << mount;
+    }
+    m_mounts.swap(mounts);
+}
+
+void FilesystemInfoDB::takeResults()
+{
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (const FilesystemStatWorker::result_t &result : m_worker->takeResults()) {
+        for (mount_t &mount : m_mounts) {
+            if (mount.path != result.mountPoint)
+                continue;
+            mount.queued = false;
+            mount.fs.hung = false;
+            mount.nextStat = now + (mount.fs.remote ? kRemoteStatInterval : kLocalStatInterval);
+            if (result.ok) {
+                mount.fs.hasUsage = true;
+                mount.fs.total = result.total;
+                mount.fs.used = result.used;
+                mount.fs.available = result.available;
+                mount.fs.files = result.files;
+                mount.fs.filesFree = result.filesFree;
+            }
+            break;
+        }
+    }
+}
+
+void FilesystemInfoDB::checkWorker(qint64 now)
+{
+    // a stuck call returning frees its mount to be stat'ed again, by the current worker
+    for (int i = m_abandoned.size() - 1; i >= 0; --i) {
+        FilesystemStatWorker *worker = m_abandoned[i].first;
+        if (!worker->isFinished())
+            continue;
+        for (mount_t &mount : m_mounts) {
+            if (mount.path == m_abandoned[i].second) {
+                mount.queued = false;
+                mount.nextStat = now;
+            }
+        }
+        delete worker;
+        m_abandoned.removeAt(i);
+    }
+
+    qint64 since;
+    const QByteArray current = m_worker->current(since);
+    if (current.isEmpty() || now - since < kStatTimeout)
+        return;
+
+    // a thread blocked in the kernel can't be interrupted, leave it to return in its own time &
+    // carry on with a new one
+    qCDebug(app) << "statvfs" << current << "not responding for" << now - since << "ms";
+    for (mount_t &mount : m_mounts) {
+        if (mount.path == current)
+            mount.fs.hung = true;
+    }
+    const QList<QByteArray> queue = m_worker->takeQueue();
+    m_worker->requestQuit();
+    m_abandoned << qMakePair(m_worker, current);
+    m_worker = new FilesystemStatWorker;
+    m_worker->start(QThread::LowPriority);
+    for (const QByteArray &path : queue)
+        m_worker->enqueue(path);
+}
+
+void FilesystemInfoDB::queueDue(qint64 now)
+{
+    for (mount_t &mount : m_mounts) {
+        if (mount.queued || mount.nextStat > now)
+            continue;
+        mount.queued = true;
+        m_worker->enqueue(mount.path);
+    }
+}
+
+QList<filesystem_t> FilesystemInfoDB::parseMountInfo(const QByteArray &data)
+{
+    QList<filesystem_t> filesystems;
+    QSet<QByteArray> seen;
+    for (const QByteArray &line : data.split('\n')) {
+        // id parent major:minor root mount-point options [optional fields...] - type source super-options
+        const QList<QByteArray> fields = line.split(' ');
+        int separator = fields.indexOf("-", 6);
+        if (fields.size() < 7 || separator < 0 || separator + 2 >= fields.size())
+            continue;
+
+        const QByteArray &fsType = fields[separator + 1];
+        const QByteArray mountPoint = unescape(fields[4]);
+        if (kPseudoTypes.contains(fsType) || isPseudoMountPoint(mountPoint))
+            continue;
+        // bind mounts of the same tree share its capacity, the first one is shown
+        const QByteArray key = fields[2] + ' ' + fields[3];
+        if (seen.contains(key))
+            continue;
+        seen.insert(key);
+
+        filesystem_t fs;
+        fs.mountPoint = QString::fromLocal8Bit(mountPoint);
+        fs.source = QString::fromLocal8Bit(unescape(fields[separator + 2]));
+        fs.fsType = QString::fromLatin1(fsType);
+        fs.remote = kRemoteTypes.contains(fsType);
+        fs.readOnly = fields[5] == "ro" || fields[5].startsWith("ro,");
+        filesystems << fs;
+    }
+    return filesystems;
+}
+
+QByteArray FilesystemInfoDB::unescape(const QByteArray &field)
+{
+    if (!field.contains('\\'))
+        return field;
+
+    QByteArray out;
+    out.reserve(field.size());
+    for (int i = 0; i < field.size(); ++i) {
+        if (field[i] == '\\' && i + 3 < field.size() && field[i + 1] >= '0' && field[i + 1] <= '3'
+                && field[i + 2] >= '0' && field[i + 2] <= '7' && field[i + 3] >= '0' && field[i + 3] <= '7') {
+            out.append(char(((field[i + 1] - '0') << 6) | ((field[i + 2] - '0') << 3) | (field[i + 3] - '0')));
+            i += 3;
+        } else {
+            out.append(field[i]);
+        }
+    }
+    return out;
+}
+
+} // namespace system
+} // namespace core
@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef FILESYSTEM_INFO_DB_H
+#define FILESYSTEM_INFO_DB_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <atomic>
+
+#define PROC_SELF_MOUNTINFO_PATH "/proc/self/mountinfo"
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Capacity of a mounted filesystem, as of its last statvfs
+ */
+struct filesystem_t {
+    QString mountPoint;
+    QString source; // e.g. /dev/nvme0n1p2 or server:/export
+    QString fsType;
+    bool remote {false}; // network filesystem, stat'ed less often
+    bool readOnly {false};
+    bool hasUsage {false}; // statvfs answered at least once
+    bool hung {false}; // last statvfs didn't answer in time, usage is of before
+    qulonglong total {0}; // bytes
+    qulonglong used {0}; // bytes, total less free
+    qulonglong available {0}; // bytes available to unprivileged users
+    qulonglong files {0}; // inodes
+    qulonglong filesFree {0};
+};
+
+/**
+ * @brief Runs statvfs on mount points queued by FilesystemInfoDB, one at a time
+ *
+ * statvfs of a hard mounted network filesystem whose server went away waits in the kernel
+ * until the server is back, so it runs here rather than on the monitor thread. A worker stuck
+ * longer than the timeout is abandoned, see FilesystemInfoDB::update.
+ */
+class FilesystemStatWorker : public QThread
+{
+public:
+    struct result_t {
+        QByteArray mountPoint;
+        bool ok;
+        qulonglong total;
+        qulonglong used;
+        qulonglong available;
+        qulonglong files;
+        qulonglong filesFree;
+    };
+
+    void enqueue(const QByteArray &mountPoint);
+    /**
+     * @brief Results since the last call, removed from the worker
+     */
+    QList<result_t> takeResults();
+    /**
+     * @brief Queued mount points not started yet, removed from the worker
+     */
+    QList<QByteArray> takeQueue();
+    /**
+     * @brief Mount point statvfs is waiting on, empty if idle
+     * @param since Set to when it started, ms since epoch
+     */
+    QByteArray current(qint64 &since);
+    void requestQuit();
+
+protected:
+    void run() override;
+
+private:
+    QMutex m_mutex;
+    QWaitCondition m_wakeup;
+    QList<QByteArray> m_queue; // guarded by m_mutex
+    QList<result_t> m_results;
+    QByteArray m_current;
+    qint64 m_since {0};
+    std::atomic_bool m_quitRequested {false};
+};
+
+/**
+ * @brief Mounted filesystems with their capacity
+ *
+ * The mount table is read from /proc/self/mountinfo only when the kernel flags it changed, by
+ * POLLPRI on the open file, so an update costs one poll(). Capacity is sampled by statvfs on a
+ * slow cadence per mount, on FilesystemStatWorker: the monitor thread never waits on it, a
+ * mount that doesn't answer within kStatTimeout is shown as not responding with its last
+ * usage & isn't stat'ed again until the stuck call returns. Pseudo filesystems are left out.
+ * Monitor thread only.
+ */
+class FilesystemInfoDB
+{
+public:
+    explicit FilesystemInfoDB(const QString &mountInfo = PROC_SELF_MOUNTINFO_PATH);
+    ~FilesystemInfoDB();
+
+    /**
+     * @brief Pick up stat results, reread mount table if it changed & queue due mounts
+     */
+    void update();
+    QList<filesystem_t> filesystems() const;
+
+    /**
+     * @brief Filesystems of a mountinfo file, pseudo & duplicate (bind) mounts left out
+     */
+    static QList<filesystem_t> parseMountInfo(const QByteArray &data);
+    /**
+     * @brief Mount point as written in mountinfo, octal escapes of space, tab, newline & backslash undone
+     */
+    static QByteArray unescape(const QByteArray &field);
+
+    // ms between statvfs of a local filesystem
+    static constexpr int kLocalStatInterval = 10000;
+    // ms between statvfs of a network filesystem
+    static constexpr int kRemoteStatInterval = 30000;
+    // ms statvfs may take before the mount counts as not responding
+    static constexpr int kStatTimeout = 5000;
+
+private:
+    Q_DISABLE_COPY(FilesystemInfoDB)
+
+    struct mount_t {
+        filesystem_t fs;
+        QByteArray path; // mount point for statvfs
+        qint64 nextStat; // ms since epoch
+        bool queued;
+    };
+
+    bool mountsChanged();
+    void readMounts();
+    void takeResults();
+    void checkWorker(qint64 now);
+    void queueDue(qint64 now);
+
+    QString m_mountInfo;
+    int m_fd;
+    QList<mount_t> m_mounts;
+    FilesystemStatWorker *m_worker;
+    // workers stuck in statvfs & the mount each waits on, deleted once they return
+    QList<QPair<FilesystemStatWorker *, QByteArray>> m_abandoned;
+};
+
+} // namespace system
+} // namespace core
+
+#endif // FILESYSTEM_INFO_DB_H
@@ -0,0 +1,129 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "gpu_info_db.h"
+#include "common/proc_parser.h"
+#include "ddlog.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QRegularExpression>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace DDLog;
+
+namespace core {
+namespace system {
+
+static int openAttribute(const QString &path)
+{
+    return open(path.toLocal8Bit().constData(), O_RDONLY | O_CLOEXEC);
+}
+
+static bool readAttribute(int fd, qulonglong &value)
+{
+    if (fd < 0)
+        return false;
+    char buf[32];
+    ssize_t n;
+    do {
+        n = pread(fd, buf, sizeof(buf), 0);
+    } while (n < 0 && errno == EINTR);
+    unsigned long long v = 0;
+    if (n <= 0 || !common::parser::Tokenizer(buf, size_t(n)).readU64(v))
+        return false;
+    value = v;
+    return true;
+}
+
+GpuInfoDB::GpuInfoDB(const QString &root)
+    : m_root(root)
+    , m_enumerated(false)
+{
+    m_clock.start();
+}
+
+GpuInfoDB::~GpuInfoDB()
+{
+    for (const card_t &card : m_cards) {
+        for (int fd : {card.busyFd, card.rc6Fd, card.memUsedFd, card.memTotalFd}) {
+            if (fd >= 0)
+                close(fd);
+        }
+    }
+}
+
+void GpuInfoDB::enumerate()
+{
+    m_enumerated = true;
+    // card0, card1 ..., connectors (card0-HDMI-A-1) & render nodes are skipped
+    static const QRegularExpression kCardName("^card\\d+$");
+    const QStringList names = QDir(m_root).entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::System, QDir::Name);
+    for (const QString &name : names) {
+        if (!kCardName.match(name).hasMatch())
+            continue;
+
+        const QString dir = m_root + "/" + name;
+        card_t card {};
+        card.device.name = name;
+        card.device.driver = QFileInfo(QFileInfo(dir + "/device/driver").symLinkTarget()).fileName();
+        card.device.pdev = QFileInfo(QFileInfo(dir + "/device").symLinkTarget()).fileName();
+        card.busyFd = openAttribute(dir + "/device/gpu_busy_percent");
+        card.rc6Fd = openAttribute(dir + "/gt/gt0/rc6_residency_ms");
+        if (card.rc6Fd < 0)
+            card.rc6Fd = openAttribute(dir + "/power/rc6_residency_ms");
+        card.memUsedFd = openAttribute(dir + "/device/mem_info_vram_used");
+        card.memTotalFd = openAttribute(dir + "/device/mem_info_vram_total");
+        card.lastTime = -1;
+        qCInfo(app) << "Gpu" << name << "driver" << card.device.driver << "pdev" << card.device.pdev
+                    << "busy" << (card.busyFd >= 0 || card.rc6Fd >= 0) << "vram" << (card.memUsedFd >= 0);
+        m_cards << card;
+    }
+}
+
+void GpuInfoDB::update()
+{
+    if (!m_enumerated)
+        enumerate();
+
+    const qint64 now = m_clock.elapsed();
+    for (card_t &card : m_cards) {
+        qulonglong value = 0;
+        gpu_device_t &device = card.device;
+        if (readAttribute(card.busyFd, value)) {
+            device.hasUsage = true;
+            device.usage = qMin(qreal(value), qreal(100));
+        } else if (readAttribute(card.rc6Fd, value)) {
+            // share of the interval the gpu wasn't idle
+            if (card.lastTime >= 0 && now > card.lastTime && value >= card.lastRc6) {
+                qreal idle = qreal(value - card.lastRc6) * 100 / qreal(now - card.lastTime);
+                device.hasUsage = true;
+                device.usage = qBound(qreal(0), 100 - idle, qreal(100));
+            }
+            card.lastRc6 = value;
+            card.lastTime = now;
+        }
+
+        qulonglong total = 0;
+        if (readAttribute(card.memUsedFd, value) && readAttribute(card.memTotalFd, total) && total > 0) {
+            device.hasMemory = true;
+            device.memUsed = value / 1024;
+            device.memTotal = total / 1024;
+        }
+    }
+}
+
+QList<gpu_device_t> GpuInfoDB::devices() const
+{
+    QList<gpu_device_t> devices;
+    for (const card_t &card : m_cards)
+        devices << card.device;
+    return devices;
+}
+
+} // namespace system
+} // namespace core
@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef GPU_INFO_DB_H
+#define GPU_INFO_DB_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+
+#define SYSFS_DRM_PATH "/sys/class/drm"
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Device level state of a gpu
+ */
+struct gpu_device_t {
+    QString name; // drm card, e.g. card0
+    QString driver; // kernel driver, e.g. amdgpu
+    QString pdev; // pci address, matches drm-pdev of fdinfo
+    bool hasUsage {false};
+    qreal usage {0}; // busy percent
+    bool hasMemory {false};
+    qulonglong memUsed {0}; // dedicated memory in kB
+    qulonglong memTotal {0};
+};
+
+/**
+ * @brief Gpus of /sys/class/drm with the utilization their driver exposes in sysfs
+ *
+ * amdgpu reports gpu_busy_percent & vram usage, i915 the rc6 (idle) residency the busy share
+ * is derived from. Others are listed without usage, per process usage comes from drm fdinfo,
+ * see ProcessGpuCache. Files are opened once on the first update & re-read with pread.
+ * Monitor thread only.
+ */
+class GpuInfoDB
+{
+public:
+    explicit GpuInfoDB(const QString &root = SYSFS_DRM_PATH);
+    ~GpuInfoDB();
+
+    void update();
+    QList<gpu_device_t> devices() const;
+
+private:
+    Q_DISABLE_COPY(GpuInfoDB)
+
+    struct card_t {
+        gpu_device_t device;
+        int busyFd; // amdgpu gpu_busy_percent
+        int rc6Fd; // i915 rc6_residency_ms
+        int memUsedFd; // amdgpu mem_info_vram_used
+        int memTotalFd;
+        qulonglong lastRc6;
+        qint64 lastTime;
+    };
+
+    void enumerate();
+
+    QString m_root;
+    bool m_enumerated;
+    QList<card_t> m_cards;
+    QElapsedTimer m_clock;
+};
+
+} // namespace system
+} // namespace core
+
+#endif // GPU_INFO_DB_H
@@ -6,14 +6,23 @@
 #include "mem.h"
 #include "private/mem_p.h"
 #include "common/common.h"
+#include "common/proc_parser.h"
 #include "ddlog.h"
 
+#include <QDataStream>
+
+#include <dirent.h>
+#include <errno.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
 
-#define PROC_PATH_MEM "/proc/meminfo"
+#define SYSFS_NODE_PATH "/sys/devices/system/node"
 
-using namespace common::error;
-using namespace common::alloc;
+using namespace common::parser;
 using namespace DDLog;
 
 namespace core {
@@ -48,176 +57,207 @@ MemInfo::~MemInfo()
 
 qulonglong MemInfo::memTotal() const
 {
-    return d->mem_total_kb;
+    return d->fields.memTotal;
 }
 
 qulonglong MemInfo::memAvailable() const
 {
-    return d->mem_avail_kb;
+    return d->fields.memAvailable;
 }
 
 qulonglong MemInfo::buffers() const
 {
-    return d->buffers_kb;
+    return d->fields.buffers;
 }
 
 qulonglong MemInfo::cached() const
 {
-    return d->cached_kb;
+    return d->fields.cached;
 }
 
 qulonglong MemInfo::active() const
 {
-    return d->active_kb;
+    return d->fields.active;
 }
 
 qulonglong MemInfo::inactive() const
 {
-    return d->inactive_kb;
+    return d->fields.inactive;
 }
 
 qulonglong MemInfo::swapTotal() const
 {
-    return d->swap_total_kb;
+    return d->fields.swapTotal;
 }
 
 qulonglong MemInfo::swapFree() const
 {
-    return d->swap_free_kb;
+    return d->fields.swapFree;
 }
 
 qulonglong MemInfo::swapCached() const
 {
-    return d->swap_cached_kb;
+    return d->fields.swapCached;
 }
 
 qulonglong MemInfo::shmem() const
 {
-    return d->shmem_kb;
+    return d->fields.shmem;
 }
 
 qulonglong MemInfo::slab() const
 {
-    return d->slab_kb;
+    return d->fields.slab;
 }
 
 qulonglong MemInfo::dirty() const
 {
-    return d->dirty_kb;
+    return d->fields.dirty;
 }
 
 qulonglong MemInfo::mapped() const
 {
-    return d->mapped_kb;
+    return d->fields.mapped;
 }
 
-void MemInfo::readMemInfo()
+qulonglong MemInfo::writeback() const
 {
-    qCDebug(app) << "Reading memory info from" << PROC_PATH_MEM;
-    FILE *fp;
-    uFile ufp;
-    const size_t BUFLEN = 512;
-    QByteArray line(BUFLEN, '\0');
-
-    if ((fp = fopen(PROC_PATH_MEM, "r"))) {
-        ufp.reset(fp);
-
-        int nr = 0;
-        while (fgets(line.data(), BUFLEN, fp)) {
-            if (!strncmp(line.data(), "MemTotal:", 9)) {
-                nr = sscanf(line.data() + 9, "%llu", &d->mem_total_kb);
-
-                if (nr != 1)
-                    qCWarning(app) << "Failed to parse MemTotal from" << PROC_PATH_MEM;
-
-            } else if (!strncmp(line.data(), "MemFree:", 8)) {
-                nr = sscanf(line.data() + 8, "%llu", &d->mem_free_kb);
-
-                if (nr != 1)
-                    qCWarning(app) << "Failed to parse MemFree from" << PROC_PATH_MEM;
-
-            } else if (!strncmp(line.data(), "MemAvailable:", 13)) {
-                nr = sscanf(line.data() + 13, "%llu", &d->mem_avail_kb);
-
-                if (nr != 1)
-                    qCWarning(app) << "Failed to parse MemAvailable from" << PROC_PATH_MEM;
-
-            } else if (!strncmp(line.data(), "Buffers:", 8)) {
-                nr = sscanf(line.data() + 8, "%llu", &d->buffers_kb);
-
-                if (nr != 1)
-                    qCWarning(app) << "Failed to parse Buffers from" << PROC_PATH_MEM;
-
-            } else if (!strncmp(line.data(), "Cached:", 7)) {
-                nr = sscanf(line.data() + 7, "%llu", &d->cached_kb);
-
-                if (nr != 1)
-                    qCWarning(app) << "Failed to parse Cached from" << PROC_PATH_MEM;
-
-            } else if (!strncmp(line.data(), "SwapCached:", 11)) {
-                nr = sscanf(line.data() + 11, "%llu", &d->swap_cached_kb);
-
-                if (nr != 1)
-                    qCWarning(app) << "Failed to parse SwapCached from" << PROC_PATH_MEM;
-
-            } else if (!strncmp(line.data(), "Active:", 7)) {
-                nr = sscanf(line.data() + 7, "%llu", &d->active_kb);
-
-                if (nr != 1)
-                    qCWarning(app) << "Failed to parse Active from" << PROC_PATH_MEM;
-
-            } else if (!strncmp(line.data(), "Inactive:", 9)) {
-                nr = sscanf(line.data() + 9, "%llu", &d->inactive_kb);
-
-                if (nr != 1)
-                    qCWarning(app) << "Failed to parse Inactive from" << PROC_PATH_MEM;
-
-            } else if (!strncmp(line.data(), "SwapTotal:", 10)) {
-                nr = sscanf(line.data() + 10, "%llu", &d->swap_total_kb);
-
-                if (nr != 1)
-                    qCWarning(app) << "Failed to parse SwapTotal from" << PROC_PATH_MEM;
-
-            } else if (!strncmp(line.data(), "SwapFree:", 9)) {
-                nr = sscanf(line.data() + 9, "%llu", &d->swap_free_kb);
-
-                if (nr != 1)
-                    qCWarning(app) << "Failed to parse SwapFree from" << PROC_PATH_MEM;
-
-            } else if (!strncmp(line.data(), "Dirty:", 6)) {
-                nr = sscanf(line.data() + 6, "%llu", &d->dirty_kb);
+    return d->fields.writeback;
+}
 
-                if (nr != 1)
-                    qCWarning(app) << "Failed to parse Dirty from" << PROC_PATH_MEM;
+qulonglong MemInfo::anonHugePages() const
+{
+    return d->fields.anonHugePages;
+}
 
-            } else if (!strncmp(line.data(), "Shmem:", 6)) {
-                nr = sscanf(line.data() + 6, "%llu", &d->shmem_kb);
+qulonglong MemInfo::kReclaimable() const
+{
+    return d->fields.kReclaimable;
+}
 
-                if (nr != 1)
-                    qCWarning(app) << "Failed to parse Shmem from" << PROC_PATH_MEM;
+QVector<node_mem_t> MemInfo::nodes() const
+{
+    return d->nodes;
+}
 
-            } else if (!strncmp(line.data(), "Slab:", 5)) {
-                nr = sscanf(line.data() + 5, "%llu", &d->slab_kb);
+vm_rates_t MemInfo::vmRates() const
+{
+    return d->vmRates;
+}
 
-                if (nr != 1)
-                    qCWarning(app) << "Failed to parse Slab from" << PROC_PATH_MEM;
+void MemInfo::readMemInfo()
+{
+    qCDebug(app) << "Reading memory info from" << PROC_MEMINFO_PATH;
+    if (!d->reader)
+        d->reader.reset(new MemInfoReader());
 
-            } else if (!strncmp(line.data(), "Mapped:", 7)) {
-                nr = sscanf(line.data() + 7, "%llu", &d->mapped_kb);
+    if (!d->reader->read(d->fields)) {
+        qCWarning(app) << "Failed to read" << PROC_MEMINFO_PATH << ":" << strerror(errno);
+        return;
+    }
+    read_nodes();
+    read_vmstat();
+    qCDebug(app) << "Finished reading memory info.";
+}
 
-                if (nr != 1)
-                    qCWarning(app) << "Failed to parse Mapped from" << PROC_PATH_MEM;
+void MemInfo::read_nodes()
+{
+    if (!d->nodeReaders) {
+        d->nodeReaders = std::make_shared<NodeMemInfoReaders>();
+        // single node systems have node0 only, its meminfo is the one of the system
+        if (DIR *dir = opendir(SYSFS_NODE_PATH)) {
+            QVector<int> nodes;
+            struct dirent *entry;
+            while ((entry = readdir(dir))) {
+                if (!strncmp(entry->d_name, "node", 4) && isDigit(entry->d_name[4]))
+                    nodes << atoi(entry->d_name + 4);
+            }
+            closedir(dir);
+            std::sort(nodes.begin(), nodes.end());
+            if (nodes.size() > 1) {
+                char path[128];
+                for (int node : nodes) {
+                    snprintf(path, sizeof(path), SYSFS_NODE_PATH "/node%d/meminfo", node);
+                    d->nodeReaders->nodes << node;
+                    d->nodeReaders->readers.emplace_back(new MemInfoReader(path));
+                }
+                qCInfo(app) << "Reading memory of" << nodes.size() << "numa nodes";
             }
-        } // ::while(fgets)
-
-        if (ferror(fp)) {
-            qCWarning(app) << "Error reading" << PROC_PATH_MEM << ":" << strerror(errno);
         }
-        qCDebug(app) << "Finished reading memory info.";
+    }
+
+    QVector<node_mem_t> nodes;
+    for (int i = 0; i < d->nodeReaders->nodes.size(); ++i) {
+        MemInfoFields fields;
+        if (!d->nodeReaders->readers[size_t(i)]->read(fields))
+            continue;
+        node_mem_t node;
+        node.node = d->nodeReaders->nodes[i];
+        node.total = fields.memTotal;
+        node.free = fields.memFree;
+        nodes << node;
+    }
+    d->nodes = nodes;
+}
+
+void MemInfo::read_vmstat()
+{
+    if (!d->vmReader)
+        d->vmReader.reset(new VmStatReader());
+
+    VmStatFields fields = d->vmFields;
+    if (!d->vmReader->read(fields)) {
+        qCWarning(app) << "Failed to read" << PROC_VMSTAT_PATH << ":" << strerror(errno);
+        d->vmRates = vm_rates_t();
+        d->vmSampledAt = -1;
         return;
-    } // ::if(fopen)
+    }
+
+    struct timespec ts {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    qint64 now = qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+
+    vm_rates_t rates;
+    if (d->vmSampledAt >= 0 && now > d->vmSampledAt) {
+        const VmStatFields &prev = d->vmFields;
+        qreal secs = qreal(now - d->vmSampledAt) / 1e9;
+        // counters only grow, a smaller one is of a field the previous read didn't find
+        auto rate = [secs](unsigned long long cur, unsigned long long old) {
+            return cur > old ? qreal(cur - old) / secs : 0.;
+        };
+        rates.pageFaults = rate(fields.pgfault, prev.pgfault);
+        rates.majorFaults = rate(fields.pgmajfault, prev.pgmajfault);
+        rates.swapIn = rate(fields.pswpin, prev.pswpin);
+        rates.swapOut = rate(fields.pswpout, prev.pswpout);
+        rates.scanKswapd = rate(fields.pgscanKswapd, prev.pgscanKswapd);
+        rates.scanDirect = rate(fields.pgscanDirect, prev.pgscanDirect);
+        rates.stealKswapd = rate(fields.pgstealKswapd, prev.pgstealKswapd);
+        rates.stealDirect = rate(fields.pgstealDirect, prev.pgstealDirect);
+        rates.oomKills = fields.oomKill > prev.oomKill ? fields.oomKill - prev.oomKill : 0;
+        rates.oomKillTotal = fields.oomKill;
+        rates.valid = true;
+    }
+    d->vmFields = fields;
+    d->vmSampledAt = now;
+    d->vmRates = rates;
+}
+
+void MemInfo::save(QDataStream &out) const
+{
+    const MemInfoFields &f = d->fields;
+    out << f.memTotal << f.memFree << f.memAvailable << f.buffers << f.cached << f.swapCached << f.active
+        << f.inactive << f.swapTotal << f.swapFree << f.dirty << f.writeback << f.anonHugePages << f.mapped
+        << f.shmem << f.kReclaimable << f.slab;
+}
 
-    qCWarning(app) << "Failed to open" << PROC_PATH_MEM << ":" << strerror(errno);
+void MemInfo::load(QDataStream &in)
+{
+    MemInfoFields &f = d->fields;
+    in >> f.memTotal >> f.memFree >> f.memAvailable >> f.buffers >> f.cached >> f.swapCached >> f.active
+       >> f.inactive >> f.swapTotal >> f.swapFree >> f.dirty >> f.writeback >> f.anonHugePages >> f.mapped
+       >> f.shmem >> f.kReclaimable >> f.slab;
+    // vmstat counters aren't recorded
+    d->vmRates = vm_rates_t();
 }
 
 } // namespace system
@@ -7,11 +7,41 @@
 #define MEM_H
 
 #include <QSharedDataPointer>
+#include <QVector>
+
+class QDataStream;
 
 namespace core {
 namespace system {
 
 class MemInfoPrivate;
+
+/**
+ * @brief Memory of a numa node, in kB
+ */
+struct node_mem_t {
+    int node {0};
+    qulonglong total {0};
+    qulonglong free {0};
+};
+
+/**
+ * @brief Paging, swap & reclaim activity over the last refresh interval, from /proc/vmstat
+ */
+struct vm_rates_t {
+    qreal pageFaults {0}; // per second
+    qreal majorFaults {0}; // faults that waited on io, per second
+    qreal swapIn {0}; // pages per second
+    qreal swapOut {0};
+    qreal scanKswapd {0}; // pages scanned per second by kswapd
+    qreal scanDirect {0}; // by allocating tasks, they stall meanwhile
+    qreal stealKswapd {0}; // pages reclaimed per second
+    qreal stealDirect {0};
+    qulonglong oomKills {0}; // tasks killed in the interval
+    qulonglong oomKillTotal {0}; // since boot
+    bool valid {false}; // false on the first read & in replays
+};
+
 class MemInfo
 {
 public:
@@ -34,9 +64,33 @@ public:
     qulonglong slab() const;
     qulonglong dirty() const;
     qulonglong mapped() const;
+    qulonglong writeback() const;
+    qulonglong anonHugePages() const;
+    qulonglong kReclaimable() const;
+    /**
+     * @brief Memory of each numa node by node id, empty on single node systems
+     */
+    QVector<node_mem_t> nodes() const;
+    /**
+     * @brief Rates since the previous readMemInfo
+     */
+    vm_rates_t vmRates() const;
 
     void readMemInfo();
 
+    /**
+     * @brief Write the fields of the last read, for flight recordings
+     */
+    void save(QDataStream &out) const;
+    /**
+     * @brief Replace the fields with ones written by save(), e.g. when replaying a recording
+     */
+    void load(QDataStream &in);
+
+private:
+    void read_nodes();
+    void read_vmstat();
+
 private:
     QSharedDataPointer<MemInfoPrivate> d;
 };
@@ -0,0 +1,191 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "mem_tuning_info_db.h"
+#include "common/proc_parser.h"
+#include "ddlog.h"
+
+#include <QDir>
+#include <QFile>
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace DDLog;
+using namespace common::parser;
+
+namespace core {
+namespace system {
+
+// meminfo fields still at it after a read weren't found
+const unsigned long long kMissing = ~0ull;
+
+static QByteArray readFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return file.readAll();
+}
+
+static QString readText(const QString &path)
+{
+    return QString::fromUtf8(readFile(path)).trimmed();
+}
+
+static bool readNumber(const QString &path, qulonglong &value)
+{
+    bool ok = false;
+    qulonglong v = readText(path).toULongLong(&ok);
+    if (ok)
+        value = v;
+    return ok;
+}
+
+MemTuningInfoDB::MemTuningInfoDB(const QString &sysfsRoot, const QString &procRoot)
+    : m_sysfsRoot(sysfsRoot)
+    , m_memReader(new MemInfoReader((procRoot + "/meminfo").toLocal8Bit().constData()))
+    , m_vmReader(new VmStatReader((procRoot + "/vmstat").toLocal8Bit().constData()))
+    , m_sampledAt(-1)
+{
+}
+
+MemTuningInfoDB::~MemTuningInfoDB() = default;
+
+QString MemTuningInfoDB::selectedMode(const QString &text)
+{
+    const QString trimmed = text.trimmed();
+    int begin = trimmed.indexOf('[');
+    if (begin < 0)
+        return trimmed.contains(' ') ? QString() : trimmed;
+    int end = trimmed.indexOf(']', begin);
+    return end < 0 ? QString() : trimmed.mid(begin + 1, end - begin - 1);
+}
+
+bool MemTuningInfoDB::parseMmStat(const char *buf, size_t len, zram_device_t &device)
+{
+    // orig_data_size compr_data_size mem_used_total mem_limit mem_used_max same_pages pages_compacted
+    // [huge_pages [huge_pages_since]]
+    Tokenizer tok(buf, len);
+    unsigned long long fields[8] {};
+    int found = 0;
+    while (found < 8 && tok.readU64(fields[found]))
+        ++found;
+    if (found < 7)
+        return false;
+
+    device.origDataSize = fields[0];
+    device.comprDataSize = fields[1];
+    device.memUsedTotal = fields[2];
+    device.memLimit = fields[3];
+    device.samePages = fields[5];
+    device.hugePages = found > 7 ? fields[7] : 0;
+    return true;
+}
+
+void MemTuningInfoDB::update()
+{
+    mem_tuning_t info;
+
+    MemInfoFields mem;
+    mem.zswap = kMissing;
+    mem.zswapped = kMissing;
+    if (!m_memReader->read(mem)) {
+        qCWarning(app) << "Failed to read meminfo:" << strerror(errno);
+        m_info = mem_tuning_t();
+        return;
+    }
+    info.anonHugePages = mem.anonHugePages;
+    info.shmemHugePages = mem.shmemHugePages;
+    info.fileHugePages = mem.fileHugePages;
+
+    const QString thp = m_sysfsRoot + "/kernel/mm/transparent_hugepage";
+    info.thpEnabled = selectedMode(readText(thp + "/enabled"));
+    info.thpDefrag = selectedMode(readText(thp + "/defrag"));
+
+    VmStatFields vm = m_vmFields;
+    struct timespec ts {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    qint64 now = qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    if (m_vmReader->read(vm)) {
+        if (m_sampledAt >= 0 && now > m_sampledAt) {
+            qreal secs = qreal(now - m_sampledAt) / 1e9;
+            // counters only grow, a smaller one is of a field the previous read didn't find
+            auto rate = [secs](unsigned long long cur, unsigned long long old) {
+                return cur > old ? qreal(cur - old) / secs : 0.;
+            };
+            info.thpFaultAlloc = rate(vm.thpFaultAlloc, m_vmFields.thpFaultAlloc);
+            info.thpFaultFallback = rate(vm.thpFaultFallback, m_vmFields.thpFaultFallback);
+            info.thpCollapseAlloc = rate(vm.thpCollapseAlloc, m_vmFields.thpCollapseAlloc);
+            info.thpCollapseFailed = rate(vm.thpCollapseAllocFailed, m_vmFields.thpCollapseAllocFailed);
+            info.zswapIn = rate(vm.zswpin, m_vmFields.zswpin);
+            info.zswapOut = rate(vm.zswpout, m_vmFields.zswpout);
+            info.ratesValid = true;
+        }
+        m_vmFields = vm;
+        m_sampledAt = now;
+    } else {
+        m_sampledAt = -1;
+    }
+
+    m_info = info;
+    readZswap(mem);
+    readZram();
+    m_info.valid = true;
+}
+
+void MemTuningInfoDB::readZswap(const MemInfoFields &mem)
+{
+    const QString params = m_sysfsRoot + "/module/zswap/parameters";
+    m_info.zswapAvailable = QFile::exists(params);
+    if (!m_info.zswapAvailable)
+        return;
+
+    // Y or N, 1 or 0 on some kernels
+    const QString enabled = readText(params + "/enabled");
+    m_info.zswapEnabled = enabled == "Y" || enabled == "1";
+    m_info.zswapCompressor = readText(params + "/compressor");
+    m_info.zswapMaxPoolPercent = readText(params + "/max_pool_percent").toInt();
+
+    if (mem.zswap != kMissing && mem.zswapped != kMissing) {
+        m_info.zswapPool = mem.zswap;
+        m_info.zswapStored = mem.zswapped;
+        m_info.zswapSizesKnown = true;
+        return;
+    }
+    // older kernels only tell in debugfs, root only
+    const QString debug = m_sysfsRoot + "/kernel/debug/zswap";
+    qulonglong poolBytes = 0, storedPages = 0;
+    if (readNumber(debug + "/pool_total_size", poolBytes) && readNumber(debug + "/stored_pages", storedPages)) {
+        m_info.zswapPool = poolBytes >> 10;
+        m_info.zswapStored = storedPages * qulonglong(sysconf(_SC_PAGESIZE)) >> 10;
+        m_info.zswapSizesKnown = true;
+    }
+}
+
+void MemTuningInfoDB::readZram()
+{
+    const QString block = m_sysfsRoot + "/block";
+    const QStringList names = QDir(block).entryList({"zram*"}, QDir::Dirs | QDir::NoDotAndDotDot | QDir::System, QDir::Name);
+    for (const QString &name : names) {
+        const QString dir = block + "/" + name;
+        zram_device_t device;
+        device.name = name;
+        // 0 until swapon or mkfs set it up
+        if (!readNumber(dir + "/disksize", device.diskSize) || device.diskSize == 0)
+            continue;
+        const QByteArray stat = readFile(dir + "/mm_stat");
+        if (!parseMmStat(stat.constData(), size_t(stat.size()), device)) {
+            qCDebug(app) << "zram mm_stat can't be parsed:" << dir;
+            continue;
+        }
+        device.algorithm = selectedMode(readText(dir + "/comp_algorithm"));
+        m_info.zram << device;
+    }
+}
+
+} // namespace system
+} // namespace core
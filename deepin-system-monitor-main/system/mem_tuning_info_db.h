@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef MEM_TUNING_INFO_DB_H
+#define MEM_TUNING_INFO_DB_H
+
+#include "common/meminfo_reader.h"
+#include "common/vmstat_reader.h"
+
+#include <QList>
+#include <QString>
+
+#include <memory>
+
+#define SYSFS_ROOT_PATH "/sys"
+#define PROC_ROOT_PATH "/proc"
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Compressed ram block device, of /sys/block/zramN/mm_stat
+ */
+struct zram_device_t {
+    QString name; // e.g. zram0
+    QString algorithm; // selected of comp_algorithm, e.g. zstd
+    qulonglong diskSize {0}; // bytes
+    qulonglong origDataSize {0}; // bytes stored, uncompressed
+    qulonglong comprDataSize {0}; // bytes they compressed to
+    qulonglong memUsedTotal {0}; // bytes of memory used, allocator overhead included
+    qulonglong memLimit {0}; // bytes, 0 if unlimited
+    qulonglong samePages {0}; // pages filled with one value, stored without data
+    qulonglong hugePages {0}; // incompressible pages stored as is, kernel 4.19+
+
+    /**
+     * @brief Stored per used memory, what zram actually saves, 0 while empty
+     */
+    inline qreal ratio() const { return memUsedTotal ? qreal(origDataSize) / memUsedTotal : 0; }
+};
+
+/**
+ * @brief Transparent huge page, zswap & zram state
+ */
+struct mem_tuning_t {
+    // transparent huge pages, modes are empty without thp
+    QString thpEnabled; // always, madvise or never
+    QString thpDefrag; // always, defer, defer+madvise, madvise or never
+    qulonglong anonHugePages {0}; // kB
+    qulonglong shmemHugePages {0}; // kB
+    qulonglong fileHugePages {0}; // kB
+    qreal thpFaultAlloc {0}; // faults served a huge page, per second
+    qreal thpFaultFallback {0}; // faults that fell back to small pages, per second
+    qreal thpCollapseAlloc {0}; // huge pages collapsed by khugepaged, per second
+    qreal thpCollapseFailed {0}; // per second
+
+    // zswap, parameters are unknown without the module
+    bool zswapAvailable {false};
+    bool zswapEnabled {false};
+    QString zswapCompressor;
+    int zswapMaxPoolPercent {0};
+    bool zswapSizesKnown {false}; // meminfo of kernel 5.19+ or a readable debugfs
+    qulonglong zswapPool {0}; // kB of compressed pages
+    qulonglong zswapStored {0}; // kB they take uncompressed
+    qreal zswapIn {0}; // pages per second, kernel 5.19+
+    qreal zswapOut {0};
+
+    QList<zram_device_t> zram; // initialized devices
+
+    bool ratesValid {false}; // false on the first read
+    bool valid {false};
+};
+
+/**
+ * @brief Efficiency of transparent huge pages, zswap & zram
+ *
+ * Huge page & zswap levels & counters are picked out of meminfo & vmstat by the shared table
+ * driven readers, modes & parameters are read from sysfs, zswap sizes from debugfs where the
+ * kernel's meminfo lacks them & debugfs is readable. Sampled at a slow cadence, rates are over
+ * the interval between two updates. Monitor thread only.
+ */
+class MemTuningInfoDB
+{
+public:
+    explicit MemTuningInfoDB(const QString &sysfsRoot = SYSFS_ROOT_PATH, const QString &procRoot = PROC_ROOT_PATH);
+    ~MemTuningInfoDB();
+
+    void update();
+    inline const mem_tuning_t &info() const { return m_info; }
+
+    /**
+     * @brief Selected entry of a sysfs mode list, e.g. madvise of "always [madvise] never"
+     * @return The only entry of a single value file, empty if none is selected
+     */
+    static QString selectedMode(const QString &text);
+    /**
+     * @brief Parse the fields of a zram mm_stat line into \a device
+     * @return false if the line lacks any of the first seven fields
+     */
+    static bool parseMmStat(const char *buf, size_t len, zram_device_t &device);
+
+private:
+    Q_DISABLE_COPY(MemTuningInfoDB)
+
+    void readZswap(const common::parser::MemInfoFields &mem);
+    void readZram();
+
+    QString m_sysfsRoot;
+    std::unique_ptr<common::parser::MemInfoReader> m_memReader;
+    std::unique_ptr<common::parser::VmStatReader> m_vmReader;
+    common::parser::VmStatFields m_vmFields;
+    qint64 m_sampledAt; // monotonic ns, -1 before the first read
+    mem_tuning_t m_info;
+};
+
+} // namespace system
+} // namespace core
+
+#endif // MEM_TUNING_INFO_DB_H
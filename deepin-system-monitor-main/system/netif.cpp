@@ -11,7 +11,6 @@
 #include "wireless.h"
 #include "nl_hwaddr.h"
 
-#include <QProcess>
 
 #include <netlink/route/link.h>
 #include <netlink/addr.h>
@@ -113,12 +112,30 @@ void NetifInfo::updateLinkInfo(const NLLink *link)
     d->tx_carrier = link->tx_carrier();
     d->collisions = link->collisions();
 
-    this->updateWirelessInfo();
+    // wireless info is filled by NetifInfoDB, only for wireless interfaces
     this->updateBrandInfo();
     this->updateHWAddr(d->ifname);
     qCDebug(app) << "Finished updating link info for" << d->ifname;
 }
 
+void NetifInfo::updateLinkStats(const struct rtnl_link_stats64 &stats)
+{
+    d->rx_packets = stats.rx_packets;
+    d->rx_bytes = stats.rx_bytes;
+    d->rx_errors = stats.rx_errors;
+    d->rx_dropped = stats.rx_dropped;
+    d->rx_fifo = stats.rx_fifo_errors;
+    d->rx_frame = stats.rx_frame_errors;
+
+    d->tx_packets = stats.tx_packets;
+    d->tx_bytes = stats.tx_bytes;
+    d->tx_errors = stats.tx_errors;
+    d->tx_dropped = stats.tx_dropped;
+    d->tx_fifo = stats.tx_fifo_errors;
+    d->tx_carrier = stats.tx_carrier_errors;
+    d->collisions = stats.collisions;
+}
+
 void NetifInfo::updateWirelessInfo()
 {
     qCDebug(app) << "Updating wireless info for" << d->ifname;
@@ -130,33 +147,25 @@ void NetifInfo::updateWirelessInfo()
         d->iw_info->qual.qual = wireless1.link_quality();
         d->iw_info->qual.level = wireless1.signal_levle();
         d->iw_info->qual.noise = wireless1.noise_level();
-        // 速率
-        //无线网速率ioctl没有提供相关接口，目前采用调用iwlist命令的方式获取 #bug 111694
-        QProcess process;
-        QString cmd = QString("iwlist ") + d.data()->ifname + QString(" rate");
-        qCDebug(app) << "Executing command:" << cmd;
-        process.start(cmd);
-        process.waitForFinished(-1);
-        //获取输出
-        QString data = process.readAllStandardOutput();
-        qCDebug(app) << "iwlist output:" << data.trimmed();
-        QStringList datalist = data.trimmed().split(":");
-        if (datalist.size() > 0) {
-            QString speedString = datalist[datalist.size() - 1];
-            float fspeed = 0;
-            QStringList  list = speedString.split(" ");
-            if (list.size() > 0) {
-                fspeed = list[0].toFloat();
-            }
-            d->speed = static_cast<uint>(fspeed);
-            qCDebug(app) << "Parsed wireless speed:" << d->speed << "Mb/s";
-        }
+        if (wireless1.bitrate() > 0)
+            d->speed = wireless1.bitrate();
     } else {
         qCDebug(app) << d->ifname << "is not a wireless device";
         d->isWireless = false;
     }
 }
 
+void NetifInfo::updateWirelessInfo(const wireless_stat &stat)
+{
+    d->isWireless = true;
+    d->iw_info->essid = stat.essid;
+    d->iw_info->qual.qual = stat.link_quality;
+    d->iw_info->qual.level = stat.signal_level;
+    d->iw_info->qual.noise = stat.noise_level;
+    if (stat.bitrate > 0)
+        d->speed = stat.bitrate;
+}
+
 void NetifInfo::updateBrandInfo()
 {
     qCDebug(app) << "Updating brand info for" << d->ifname;
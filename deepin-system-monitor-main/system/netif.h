@@ -13,6 +13,7 @@
 #include <QList>
 
 #include <netlink/route/link.h>
+#include <linux/if_link.h>
 
 #include <memory>
 
@@ -84,6 +85,7 @@ class NetifInfoDB;
 class NLLink;
 class NLAddr;
 class wireless;
+struct wireless_stat;
 
 class NetifInfo
 {
@@ -151,7 +153,9 @@ protected:
     void updateAddr6Info(const QList<INet6Addr> &addrList);
     void updateHWAddr(const QByteArray ifname);
     void updateLinkInfo(const NLLink *link);
+    void updateLinkStats(const struct rtnl_link_stats64 &stats);
     void updateWirelessInfo(); // ioctl
+    void updateWirelessInfo(const wireless_stat &stat); // nl80211
     void updateBrandInfo(); // udev
 
 private:
@@ -20,11 +20,19 @@
 using namespace common::core;
 using namespace DDLog;
 
+// rescan interval without netlink notifications, in updates (scheduled every 2s)
+const int kRescanPolls = 15;
+// wireless query interval, in updates
+const int kWirelessPolls = 5;
+
 namespace core {
 namespace system {
 
 NetifInfoDB::NetifInfoDB()
     : m_netlink(new Netlink())
+    , m_infoValid(false)
+    , m_pollsSinceScan(0)
+    , m_pollsSinceWireless(0)
 {
     qCDebug(app) << "NetifInfoDB constructor";
 }
@@ -63,12 +71,9 @@ void NetifInfoDB::update_netif_info()
 {
     qCDebug(app) << "Updating network interface info...";
     LinkIterator iter = m_netlink->linkIterator();
-    QMap<QByteArray, NetifInfoPtr> old_infoDB = m_infoDB;
-
-    timevalList[kLastStat] = timevalList[kCurrentStat];
-    timevalList[kCurrentStat] = SysInfo::instance()->uptime();
 
     m_infoDB.clear();
+    QHash<QByteArray, bool> wirelessIfaces;
     while (iter.hasNext()) {
         auto it = iter.next();
 
@@ -81,36 +86,119 @@ void NetifInfoDB::update_netif_info()
         item->updateAddr4Info(m_addrIpv4DB.values(it->ifindex()));
         item->updateAddr6Info(m_addrIpv6DB.values(it->ifindex()));
 
+        auto iw = m_wirelessIfaces.constFind(item->ifname());
+        bool isWireless = (iw != m_wirelessIfaces.cend()) ? iw.value() : wireless::is_wireless_iface(item->ifname());
+        wirelessIfaces.insert(item->ifname(), isWireless);
+
+        m_infoDB.insert(it->addr(), item);
+    }
+    m_wirelessIfaces = wirelessIfaces;
+    qCDebug(app) << "Finished updating network interface info. Found" << m_infoDB.size() << "interfaces.";
+}
+
+void NetifInfoDB::update_netif_stats()
+{
+    qCDebug(app) << "Updating network interface stats...";
+    LinkStatsMap stats;
+    if (!m_netlink->linkStats(stats)) {
+        qCWarning(app) << "Failed to read network interface stats";
+        return;
+    }
+
+    timevalList[kLastStat] = timevalList[kCurrentStat];
+    timevalList[kCurrentStat] = SysInfo::instance()->uptime();
+
+    timeval cur_time = timevalList[kCurrentStat];
+    timeval prev_time = timevalList[kLastStat];
+    auto ltime = prev_time.tv_sec + prev_time.tv_usec * 1. / 1000000;
+    auto rtime = cur_time.tv_sec + cur_time.tv_usec * 1. / 1000000;
+    auto interval = (rtime > ltime) ? (rtime - ltime) : 1;
+
+    // items are shared with readers of infoDB(), update copies
+    QMap<QByteArray, NetifInfoPtr> infoDB;
+    QHash<int, QPair<qulonglong, qulonglong>> lastBytes;
+    for (auto it = m_infoDB.cbegin(); it != m_infoDB.cend(); ++it) {
+        auto stat = stats.constFind(it.value()->index());
+        auto iw = m_wirelessStats.constFind(it.value()->index());
+        if (stat == stats.cend() && iw == m_wirelessStats.cend()) {
+            infoDB.insert(it.key(), it.value());
+            continue;
+        }
+
+        NetifInfoPtr item = std::make_shared<NetifInfo>(*it.value());
+        if (iw != m_wirelessStats.cend())
+            item->updateWirelessInfo(iw.value());
+        if (stat == stats.cend()) {
+            infoDB.insert(it.key(), item);
+            continue;
+        }
+        item->updateLinkStats(stat.value());
+
         // 更新速率
-        if (old_infoDB.contains(it->addr())) {
-            auto old_item = old_infoDB.value(it->addr());
+        auto last = m_lastBytes.constFind(item->index());
+        if (last != m_lastBytes.cend()) {
             // receive increment between interval
-            auto rxdiff = (item->rxBytes() > old_item->rxBytes()) ? (item->rxBytes() - old_item->rxBytes()) : 0;
+            auto rxdiff = (item->rxBytes() > last.value().first) ? (item->rxBytes() - last.value().first) : 0;
             // transfer increment between interval
-            auto txdiff = (item->txBytes() > old_item->txBytes()) ? (item->txBytes() - old_item->txBytes()) : 0;
-
-            timeval cur_time = timevalList[kCurrentStat];
-            timeval prev_time = timevalList[kLastStat];
-
-            auto ltime = prev_time.tv_sec + prev_time.tv_usec * 1. / 1000000;
-            auto rtime = cur_time.tv_sec + cur_time.tv_usec * 1. / 1000000;
-            auto interval = (rtime > ltime) ? (rtime - ltime) : 1;
-            qreal recv_bps = rxdiff / interval;   // Bps
-            qreal sent_bps = txdiff / interval;
-            item->set_recv_bps(recv_bps);
-            item->set_sent_bps(sent_bps);
-            // qCDebug(app) << "Updated rate for" << it->ifname() << ": recv=" << recv_bps << "B/s, sent=" << sent_bps << "B/s";
+            auto txdiff = (item->txBytes() > last.value().second) ? (item->txBytes() - last.value().second) : 0;
+            item->set_recv_bps(rxdiff / interval);   // Bps
+            item->set_sent_bps(txdiff / interval);
         }
+        lastBytes.insert(item->index(), qMakePair(item->rxBytes(), item->txBytes()));
+        infoDB.insert(it.key(), item);
+    }
+    m_infoDB = infoDB;
+    m_lastBytes = lastBytes;
+    qCDebug(app) << "Finished updating network interface stats of" << m_infoDB.size() << "interfaces.";
+}
 
-        m_infoDB.insert(it->addr(), item);
+void NetifInfoDB::update_wireless_info()
+{
+    QHash<int, wireless_stat> wirelessStats;
+    bool nl80211 = m_wireless.has_nl80211();
+    for (auto it = m_infoDB.cbegin(); it != m_infoDB.cend(); ++it) {
+        const NetifInfoPtr &item = it.value();
+        if (!m_wirelessIfaces.value(item->ifname()))
+            continue;
+
+        wireless_stat stat;
+        if (nl80211) {
+            // not associated, keep the interface flagged wireless with empty stat
+            m_wireless.query(item->index(), stat);
+        } else {
+            wireless probe(item->ifname());
+            stat.essid = probe.essid();
+            stat.link_quality = probe.link_quality();
+            stat.signal_level = probe.signal_levle();
+            stat.noise_level = probe.noise_level();
+            stat.bitrate = probe.bitrate();
+        }
+        wirelessStats.insert(item->index(), stat);
     }
-    qCDebug(app) << "Finished updating network interface info. Found" << m_infoDB.size() << "interfaces.";
+    m_wirelessStats = wirelessStats;
+    qCDebug(app) << "Updated wireless info of" << m_wirelessStats.size() << "interfaces.";
 }
+
 void NetifInfoDB::update()
 {
     qCDebug(app) << "Updating NetifInfoDB...";
-    this->update_addr();
-    this->update_netif_info();
+    bool changed = m_netlink->readEvents();
+    if (!m_netlink->hasEventSocket() && ++m_pollsSinceScan >= kRescanPolls)
+        changed = true;
+
+    if (changed || !m_infoValid) {
+        this->update_addr();
+        this->update_netif_info();
+        m_infoValid = true;
+        m_pollsSinceScan = 0;
+        // query new interfaces right away
+        m_pollsSinceWireless = kWirelessPolls;
+    }
+    if (++m_pollsSinceWireless >= kWirelessPolls) {
+        this->update_wireless_info();
+        m_pollsSinceWireless = 0;
+    }
+    this->update_netif_stats();
     qCDebug(app) << "NetifInfoDB update finished.";
 }
 
@@ -8,9 +8,12 @@
 
 #include "netif.h"
 #include "netlink.h"
+#include "wireless.h"
 
 #include <QMultiMap>
 #include <QMap>
+#include <QHash>
+#include <QPair>
 
 #include "netif_monitor.h"
 #include <memory>
@@ -24,6 +27,14 @@ struct netif_stat {
     char iface[IF_NAMESIZE]; // interface name
 };
 
+/**
+ * @brief Network interface info & traffic
+ *
+ * Link params & addresses are only re-read on netlink link/address notifications (or
+ * about every 30s if notifications are not available), counters of all interfaces are
+ * fetched with one RTM_GETSTATS dump per update. Wireless interfaces are detected once
+ * per interface & their signal/bitrate queried through nl80211 every few updates only.
+ */
 class NetifInfoDB
 {
     enum StatIndex { kLastStat = 0, kCurrentStat = 1, kStatCount = kCurrentStat + 1 };
@@ -38,6 +49,8 @@ public:
 protected:
     void update_addr();
     void update_netif_info();
+    void update_netif_stats();
+    void update_wireless_info();
 
 private:
     std::unique_ptr<Netlink> m_netlink;
@@ -46,6 +59,21 @@ private:
     QMultiMap<int, INet6Addr> m_addrIpv6DB;
 
     QMap<QByteArray, NetifInfoPtr> m_infoDB;
+    // link & address info read at least once
+    bool m_infoValid;
+    // updates since last link & address scan, used without netlink notifications
+    int m_pollsSinceScan;
+    // ifindex => (rx bytes, tx bytes) of last stats update
+    QHash<int, QPair<qulonglong, qulonglong>> m_lastBytes;
+
+    // long lived nl80211 handle
+    wireless m_wireless;
+    // ifname => wireless interface or not, checked once per interface
+    QHash<QByteArray, bool> m_wirelessIfaces;
+    // ifindex => last wireless stat, wireless interfaces only
+    QHash<int, wireless_stat> m_wirelessStats;
+    // updates since last wireless query
+    int m_pollsSinceWireless;
 
     QMap<ino_t, SockIOStat> m_sockIOStatMap;
 
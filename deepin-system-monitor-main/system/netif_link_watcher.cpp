@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "netif_link_watcher.h"
+#include "ddlog.h"
+
+#include <QSocketNotifier>
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#define LINK_WATCHER_BUFFER_SIZE (16 << 10)   // netlink receive buffer
+
+using namespace DDLog;
+
+namespace core {
+namespace system {
+
+NetifLinkWatcher::NetifLinkWatcher(QObject *parent)
+    : QObject(parent)
+    , m_buffer(LINK_WATCHER_BUFFER_SIZE)
+{
+}
+
+NetifLinkWatcher::~NetifLinkWatcher()
+{
+    stop();
+}
+
+bool NetifLinkWatcher::start()
+{
+    if (m_fd >= 0)
+        return true;
+
+    errno = 0;
+    m_fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_ROUTE);
+    if (m_fd < 0) {
+        qCWarning(app) << "Failed to create rtnetlink socket:" << strerror(errno);
+        return false;
+    }
+
+    struct sockaddr_nl nladdr;
+    memset(&nladdr, 0, sizeof(nladdr));
+    nladdr.nl_family = AF_NETLINK;
+    nladdr.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+    if (bind(m_fd, reinterpret_cast<struct sockaddr *>(&nladdr), sizeof(nladdr)) < 0) {
+        qCWarning(app) << "Failed to bind rtnetlink socket:" << strerror(errno);
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &NetifLinkWatcher::readEvents);
+    qCDebug(app) << "Listening for rtnetlink link events";
+    return true;
+}
+
+void NetifLinkWatcher::stop()
+{
+    if (m_notifier) {
+        m_notifier->setEnabled(false);
+        delete m_notifier;
+        m_notifier = nullptr;
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+int NetifLinkWatcher::parseEvents(const char *buf, int len)
+{
+    int flags = 0;
+    for (auto *nlh = reinterpret_cast<const struct nlmsghdr *>(buf); NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+        switch (nlh->nlmsg_type) {
+        case RTM_NEWLINK:
+        case RTM_DELLINK:
+            flags |= kLinkEvent;
+            break;
+        case RTM_NEWADDR:
+        case RTM_DELADDR:
+            flags |= kAddressEvent;
+            break;
+        default:
+            break;
+        }
+    }
+    return flags;
+}
+
+void NetifLinkWatcher::readEvents()
+{
+    int flags = 0;
+    while (true) {
+        int len = int(recv(m_fd, m_buffer.data(), m_buffer.size(), 0));
+        if (len < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == ENOBUFS) {
+                // events were dropped, treat everything as changed
+                qCWarning(app) << "rtnetlink event queue overrun";
+                flags |= kLinkEvent | kAddressEvent;
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                qCWarning(app) << "rtnetlink receive failed:" << strerror(errno);
+            break;
+        }
+        if (len == 0)
+            break;
+        flags |= parseEvents(m_buffer.data(), len);
+    }
+
+    if (flags & kLinkEvent) {
+        qCDebug(app) << "Network links changed";
+        emit linksChanged();
+    }
+    if (flags & kAddressEvent) {
+        qCDebug(app) << "Interface addresses changed";
+        emit addressesChanged();
+    }
+}
+
+} // namespace system
+} // namespace core
@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NETIF_LINK_WATCHER_H
+#define NETIF_LINK_WATCHER_H
+
+#include <QObject>
+
+#include <vector>
+
+class QSocketNotifier;
+
+namespace core {
+namespace system {
+
+/**
+ * @brief rtnetlink link & interface address event listener
+ *
+ * Joins the link & ipv4/ipv6 address multicast groups, the socket is read from the event loop
+ * of the owner thread through a socket notifier, so links coming & going (bonds, vlans,
+ * tunnels, hotplugged nics) are known right away instead of being polled for.
+ */
+class NetifLinkWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum EventFlag {
+        kLinkEvent = 0x1,
+        kAddressEvent = 0x2,
+    };
+
+    explicit NetifLinkWatcher(QObject *parent = nullptr);
+    ~NetifLinkWatcher() override;
+
+    /**
+     * @brief Open rtnetlink socket & start listening, must be called from the owner thread
+     * @return false if rtnetlink socket can not be opened
+     */
+    bool start();
+    void stop();
+
+    inline bool isRunning() const { return m_fd >= 0; }
+
+    /**
+     * @brief Collect event types of a buffer of rtnetlink messages
+     * @return EventFlag bits
+     */
+    static int parseEvents(const char *buf, int len);
+
+signals:
+    void linksChanged();
+    void addressesChanged();
+
+private:
+    void readEvents();
+
+    int m_fd {-1};
+    QSocketNotifier *m_notifier {};
+    std::vector<char> m_buffer;
+};
+
+} // namespace system
+} // namespace core
+
+#endif // NETIF_LINK_WATCHER_H
@@ -7,10 +7,16 @@
 #include "ddlog.h"
 #include "common/thread_manager.h"
 #include "netif_monitor_thread.h"
+#include "common/thread_priority.h"
 
 #include <QTimerEvent>
+#include <QDateTime>
 #include <QDebug>
 
+#define PACKET_RING_CAPACITY 4096   // records per capture thread ring
+#define PACKET_RING_IDLE_WAIT 100   // idle wait (ms), bounds latency of a missed wakeup
+#define PACKET_SAMPLING_HOLD_TIME 5000   // figures count as sampled this long after last sampled record (ms)
+
 using namespace DDLog;
 
 namespace core {
@@ -21,9 +27,13 @@ NetifMonitor::NetifMonitor(QObject *parent)
     qCDebug(app) << "NetifMonitor constructor";
     // packet monitor job
     m_netifCapture = new NetifPacketCapture(this);
+    m_packetMonitorThread.setObjectName("PacketCapture");
     m_netifCapture->moveToThread(&m_packetMonitorThread);
     // delete monitor job after thread finished
     connect(&m_packetMonitorThread, &QThread::finished, m_netifCapture, &QObject::deleteLater);
+    // capture thread follows the sampling policy, applied on itself before the job starts
+    const common::core::ThreadPriority &policy = common::core::ThreadPriority::sampling();
+    connect(&m_packetMonitorThread, &QThread::started, &m_packetMonitorThread, [&policy]() { policy.apply(); }, Qt::DirectConnection);
     // start monitor job when thread started
     connect(&m_packetMonitorThread, &QThread::started, m_netifCapture, &NetifPacketCapture::startNetifMonitorJob);
 }
@@ -49,67 +59,181 @@ void NetifMonitor::startNetmonitorJob()
     m_packetMonitorThread.start();
 }
 
-void NetifMonitor::handleNetData()
+void NetifMonitor::setPacketCaptureEnabled(bool enabled)
 {
-    qCDebug(app) << "handleNetData loop started";
-    while (!m_quitRequested.load()) {
-        m_pktqLock.lock();      // +++m_pktqLock+++
-        // packets available for processing when pending queue mutex unlocked
-        // qCDebug(app) << "Waiting for packets...";
-        m_pktqWatcher.wait(&m_pktqLock);
-        // qCDebug(app) << "Woke up from wait";
-
-        // check if quit requested again after wakeup by another thread, break the loop if need
-        if (m_quitRequested.load()) {
-            // qCDebug(app) << "Quit requested, breaking handleNetData loop";
-            m_pktqLock.unlock();
-            break;
+    if (m_captureEnabled.exchange(enabled) == enabled)
+        return;
+
+    qCInfo(app) << "Packet capture" << (enabled ? "enabled" : "disabled");
+    QMetaObject::invokeMethod(m_netifCapture,
+                              enabled ? "startNetifMonitorJob" : "stopNetifMonitorJob",
+                              Qt::QueuedConnection);
+}
+
+bool NetifMonitor::packetSampling() const
+{
+    auto last = m_lastSampled.load();
+    return last > 0 && QDateTime::currentMSecsSinceEpoch() - last < PACKET_SAMPLING_HOLD_TIME;
+}
+
+void NetifMonitor::setWatchedSockets(const QList<ino_t> &inodes)
+{
+    QHash<ino_t, sock_io_stat_t> watched;
+    m_sockIOStatMapLock.lock();
+    for (auto ino : inodes) {
+        auto it = m_watchedSockIO.constFind(ino);
+        if (it != m_watchedSockIO.cend()) {
+            watched.insert(ino, it.value());
+        } else {
+            struct sock_io_stat_t stat {};
+            stat.ino = ino;
+            watched.insert(ino, stat);
         }
+    }
+    m_watchedSockIO.swap(watched);
+    m_sockIOStatMapLock.unlock();
+}
 
-        // qCDebug(app) << "Moving" << m_pendingPackets.size() << "packets from pending queue";
-        // append pending queue packets to local queue, so we dont lock the mutex for too long
-        m_localPendingPackets.append(m_pendingPackets);
-        m_pendingPackets.clear();
-        m_pktqLock.unlock();    // ---m_pktqLock---
+QHash<ino_t, sock_io_stat_t> NetifMonitor::watchedSockIOStats()
+{
+    m_sockIOStatMapLock.lock();
+    auto stats = m_watchedSockIO;
+    m_sockIOStatMapLock.unlock();
+    return stats;
+}
+
+void NetifMonitor::refreshTcpHealth()
+{
+    auto health = std::make_shared<TcpHealthTable>();
+    // not available, views show no tcp health rather than a stale one
+    if (!m_tcpHealthDiag.refreshTcpHealth(*health))
+        health->clear();
+
+    m_tcpHealthLock.lock();
+    m_tcpHealth = std::move(health);
+    m_tcpHealthLock.unlock();
+}
+
+void NetifMonitor::clearTcpHealth()
+{
+    m_tcpHealthLock.lock();
+    m_tcpHealth.reset();
+    m_tcpHealthLock.unlock();
+}
+
+std::shared_ptr<const TcpHealthTable> NetifMonitor::tcpHealth()
+{
+    m_tcpHealthLock.lock();
+    auto health = m_tcpHealth;
+    m_tcpHealthLock.unlock();
+    return health;
+}
 
-        // process payload queue
-        while (!m_localPendingPackets.isEmpty()) {
-            auto payload = m_localPendingPackets.dequeue();
-            // qCDebug(app) << "Processing packet for inode" << payload->ino << "direction" << payload->direction << "size" << payload->payload;
-
-            // lock sockiostatmap
-            m_sockIOStatMapLock.lock();     // +++m_sockIOStatMapLock+++
-
-            // sum up sock io stat by inode
-            auto ino = payload->ino;
-            if (m_sockIOStatMap.contains(ino)) {
-                // sum up sock io stat if already exists with same inode stat
-                auto &hist = m_sockIOStatMap[ino];
-                if (payload->direction == kInboundPacket) {
-                    hist->rx_bytes += payload->payload;
-                    hist->rx_packets++;
-                } else if (payload->direction == kOutboundPacket) {
-                    hist->tx_bytes += (payload->payload * 2);
-                    hist->tx_packets++;
-                }
-                // qCDebug(app) << "Updated existing stat for inode" << ino << ": rx_bytes=" << hist->rx_bytes << "tx_bytes=" << hist->tx_bytes;
-            } else {
-                // add new sock io stat if sock ino no exists in cache before
-                auto stat = QSharedPointer<struct sock_io_stat_t>::create();
-                stat->ino = payload->ino;
-                if (payload->direction == kInboundPacket) {
-                    stat->rx_bytes = payload->payload;
-                    stat->rx_packets++;
-                } else if (payload->direction == kOutboundPacket) {
-                    stat->tx_bytes = payload->payload;
-                    stat->tx_packets++;
-                }
-                m_sockIOStatMap[stat->ino] = stat;
-                // qCDebug(app) << "Created new stat for inode" << stat->ino << ": rx_bytes=" << stat->rx_bytes << "tx_bytes=" << stat->tx_bytes;
+std::shared_ptr<PacketRecordRing> NetifMonitor::createPacketRing()
+{
+    auto ring = std::make_shared<PacketRecordRing>(PACKET_RING_CAPACITY);
+    m_pktqLock.lock();
+    m_newPacketRings << ring;
+    m_pktqLock.unlock();
+    return ring;
+}
+
+void NetifMonitor::notifyPackets()
+{
+    // pairs with the fence in handleNetData: either we see the waiting flag or monitor sees the records
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!m_consumerWaiting.load(std::memory_order_relaxed))
+        return;
+
+    m_pktqLock.lock();
+    m_pktqWatcher.wakeAll();
+    m_pktqLock.unlock();
+}
+
+int NetifMonitor::drainPacketRings()
+{
+    m_pktqLock.lock();      // +++m_pktqLock+++
+    if (!m_newPacketRings.isEmpty()) {
+        m_packetRings.append(m_newPacketRings);
+        m_newPacketRings.clear();
+    }
+    m_pktqLock.unlock();    // ---m_pktqLock---
+
+    // sum up records by inode locally first, so map lock is taken once per batch
+    QHash<ino_t, sock_io_stat_t> batch;
+    int nr = 0;
+    bool sampled = false;
+
+    for (auto it = m_packetRings.begin(); it != m_packetRings.end();) {
+        auto &ring = *it;
+        nr += int(ring->consume([&batch, &sampled](const packet_record_t &rec) {
+            auto &stat = batch[rec.ino];
+            // sampled records are scaled up by the packets they stand for
+            if (rec.direction == kInboundPacket) {
+                stat.rx_bytes += rec.bytes * rec.weight;
+                stat.rx_packets += rec.weight;
+            } else if (rec.direction == kOutboundPacket) {
+                stat.tx_bytes += rec.bytes * rec.weight;
+                stat.tx_packets += rec.weight;
             }
-            m_sockIOStatMapLock.unlock();   // ---m_sockIOStatMapLock---
+            sampled = sampled || rec.weight > 1;
+        }));
+
+        // producer released its ring & nothing is left in it
+        if (ring.use_count() == 1 && ring->empty())
+            it = m_packetRings.erase(it);
+        else
+            ++it;
+    }
+
+    if (sampled)
+        m_lastSampled.store(QDateTime::currentMSecsSinceEpoch());
+    if (batch.isEmpty())
+        return nr;
+
+    // lock sockiostatmap
+    m_sockIOStatMapLock.lock();     // +++m_sockIOStatMapLock+++
+    for (auto bit = batch.cbegin(); bit != batch.cend(); ++bit) {
+        const auto &io = bit.value();
+        auto it = m_sockIOStatMap.find(bit.key());
+        if (it != m_sockIOStatMap.end()) {
+            // sum up sock io stat if already exists with same inode stat
+            auto &hist = it.value();
+            hist->rx_bytes += io.rx_bytes;
+            hist->rx_packets += io.rx_packets;
+            hist->tx_bytes += io.tx_bytes;
+            hist->tx_packets += io.tx_packets;
+        } else {
+            // add new sock io stat if sock ino no exists in cache before
+            auto stat = QSharedPointer<struct sock_io_stat_t>::create(io);
+            stat->ino = bit.key();
+            m_sockIOStatMap[stat->ino] = stat;
         }
     }
+    m_sockIOStatMapLock.unlock();   // ---m_sockIOStatMapLock---
+
+    return nr;
+}
+
+void NetifMonitor::handleNetData()
+{
+    qCDebug(app) << "handleNetData loop started";
+    while (!m_quitRequested.load()) {
+        if (drainPacketRings() > 0)
+            continue;
+
+        m_pktqLock.lock();      // +++m_pktqLock+++
+        m_consumerWaiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // records pushed before the flag got visible did not wake us, so check once more before sleeping
+        bool pending = !m_newPacketRings.isEmpty();
+        for (const auto &ring : m_packetRings)
+            pending = pending || !ring->empty();
+        if (!pending && !m_quitRequested.load())
+            m_pktqWatcher.wait(&m_pktqLock, PACKET_RING_IDLE_WAIT);
+        m_consumerWaiting.store(false, std::memory_order_relaxed);
+        m_pktqLock.unlock();    // ---m_pktqLock---
+    }
     qCDebug(app) << "handleNetData loop finished";
 }
 
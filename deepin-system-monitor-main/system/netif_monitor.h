@@ -10,10 +10,15 @@
 #include "netif_packet_capture.h"
 
 #include <QObject>
+#include <QHash>
 #include <QBasicTimer>
 #include <QMutex>
 #include <QWaitCondition>
 #include <QThread>
+#include <QList>
+
+#include <atomic>
+#include <memory>
 
 using namespace common::core;
 
@@ -52,6 +57,29 @@ public:
 
     void startNetmonitorJob();
 
+    /**
+     * @brief Start or stop packet capture (thread safe)
+     *
+     * Capture is not needed while per process traffic comes from kernel accounting.
+     */
+    void setPacketCaptureEnabled(bool enabled);
+    inline bool packetCaptureEnabled() const { return m_captureEnabled.load(); }
+    /**
+     * @brief Per socket io was recently estimated from sampled packets (thread safe)
+     */
+    bool packetSampling() const;
+
+    /**
+     * @brief Register a packet record ring for one capture thread (thread safe)
+     *
+     * Each producer thread owns its ring, ring is dropped by the monitor once released & drained.
+     */
+    std::shared_ptr<PacketRecordRing> createPacketRing();
+    /**
+     * @brief Wake monitor after records were pushed, cheap if monitor is not sleeping
+     */
+    void notifyPackets();
+
     void handleNetData();
 public:
     /**
@@ -67,38 +95,90 @@ public:
         // lock cache before access
         m_sockIOStatMapLock.lock();
 
-        // check stat data existence
-        if (m_sockIOStatMap.contains(ino)) {
-            stat = m_sockIOStatMap[ino];
-            // remove stat data from cache
-            m_sockIOStatMap.remove(ino);
+        // take stat data out of cache with a single lookup
+        auto it = m_sockIOStatMap.find(ino);
+        if (it != m_sockIOStatMap.end()) {
+            stat = it.value();
+            m_sockIOStatMap.erase(it);
             ok = true;
+
+            // keep running totals for sockets being drilled down into
+            if (!m_watchedSockIO.isEmpty()) {
+                auto wit = m_watchedSockIO.find(ino);
+                if (wit != m_watchedSockIO.end()) {
+                    wit->rx_bytes += stat->rx_bytes;
+                    wit->rx_packets += stat->rx_packets;
+                    wit->tx_bytes += stat->tx_bytes;
+                    wit->tx_packets += stat->tx_packets;
+                }
+            }
         }
 
         m_sockIOStatMapLock.unlock();
 
         return ok;
     }
+    /**
+     * @brief Set sockets to keep running io totals for, totals of sockets kept in the set are preserved
+     * @param inodes Socket inodes, empty to stop watching
+     */
+    void setWatchedSockets(const QList<ino_t> &inodes);
+    /**
+     * @brief Running io totals of watched sockets since they were first watched
+     */
+    QHash<ino_t, sock_io_stat_t> watchedSockIOStats();
+
+    /**
+     * @brief Dump tcp health of all connected tcp sockets, once per process scan while shown
+     */
+    void refreshTcpHealth();
+    /**
+     * @brief Drop tcp health, while no view shows network figures
+     */
+    void clearTcpHealth();
+    /**
+     * @brief Tcp health of the last refresh by socket inode (thread safe), null if never refreshed
+     */
+    std::shared_ptr<const TcpHealthTable> tcpHealth();
+
     // socket inode to io stat mapping
-    QMap<ino_t, SockIOStat> m_sockIOStatMap     {};
+    QHash<ino_t, SockIOStat> m_sockIOStatMap    {};
 
 private:
     NetifPacketCapture *m_netifCapture;
     // packet monitor thread object
     QThread m_packetMonitorThread;
 
-    // pending packet queue
-    PacketPayloadQueue  m_pendingPackets        {};
-    // pending packet queue locker
+    /**
+     * @brief Drain every registered ring & merge records into socket io stat map
+     * @return Number of records drained
+     */
+    int drainPacketRings();
+
+    // per capture thread packet record rings
+    QList<std::shared_ptr<PacketRecordRing>> m_packetRings {};
+    // rings registered since last drain, guarded by m_pktqLock
+    QList<std::shared_ptr<PacketRecordRing>> m_newPacketRings {};
+    // packet ring registration & watcher locker
     QMutex              m_pktqLock              {};
     // packet queue watcher
     QWaitCondition      m_pktqWatcher           {};
-    // local pending packet queue
-    PacketPayloadQueue  m_localPendingPackets   {}; // local cache
+    // monitor is (about to be) sleeping on m_pktqWatcher
+    std::atomic_bool    m_consumerWaiting       {false};
+    // when a sampled record was last drained, msecs since epoch
+    std::atomic<qint64> m_lastSampled           {0};
 
 
     // socket io stat map access locker
     QMutex                  m_sockIOStatMapLock {};
+    // running totals of watched sockets, guarded by m_sockIOStatMapLock
+    QHash<ino_t, sock_io_stat_t> m_watchedSockIO {};
+
+    // tcp_info dumper, used by the refreshing (process scan) thread only
+    SockDiag m_tcpHealthDiag {};
+    // last tcp health dump, guarded by m_tcpHealthLock
+    std::shared_ptr<const TcpHealthTable> m_tcpHealth {};
+    QMutex m_tcpHealthLock {};
 
     // packet monitor thread object
     //QThread             m_packetMonitorThread;
@@ -106,6 +186,8 @@ private:
 
     // quit atomic test flag
     std::atomic_bool m_quitRequested {false};
+    // packet capture wanted
+    std::atomic_bool m_captureEnabled {true};
 
 
 
@@ -17,6 +17,7 @@ NetifMonitorThread::NetifMonitorThread(QObject *parent)
     , m_netifMonitor(new NetifMonitor)
 {
     qCDebug(app) << "NetifMonitorThread constructor";
+    m_netIfmoniterThread.setObjectName("NetifMonitor");
     m_netifMonitor->moveToThread(&m_netIfmoniterThread);
     connect(&m_netIfmoniterThread, &QThread::finished, this, &QObject::deleteLater);
     connect(&m_netIfmoniterThread, &QThread::started, m_netifMonitor, &NetifMonitor::startNetmonitorJob);
@@ -5,8 +5,10 @@
 #include "ddlog.h"
 #include "netif_packet_capture.h"
 #include "netif_packet_parser.h"
-#include "common/hash.h"
 #include "netif_monitor.h"
+#include "netif_ring_capture.h"
+#include "netif_link_watcher.h"
+#include "common/trace_log.h"
 #include <arpa/inet.h>
 #include "device_db.h"
 #include <net/ethernet.h>
@@ -18,8 +20,10 @@
 #include <ifaddrs.h>
 #include <net/if.h>
 #include <QCoreApplication>
-#include <QProcess>
-#include <QRegularExpression>
+
+#include <DConfig>
+
+#include <memory>
 #ifndef IFNAMESZ
 #    define IFNAMESZ 16
 #endif
@@ -27,12 +31,13 @@
 //#define PACKET_DISPATCH_IDLE_TIME 200 // pcap dispatch interval
 #define PACKET_DISPATCH_IDLE_TIME 50   // pcap dispatch interval
 #define PACKET_DISPATCH_BATCH_COUNT 64   // packets to process in a batch
-#define PACKET_DISPATCH_QUEUE_LWAT 64   // queue low water mark
-#define PACKET_DISPATCH_QUEUE_HWAT 256   // queue high water mark
+#define PACKET_DISPATCH_MAX_ROUNDS 64   // dispatch rounds before yielding to the event loop
+#define PACKET_SAMPLING_DEFAULT_THRESHOLD 20000   // packets per second & capture thread before sampling
 
 #define SOCKSTAT_REFRESH_INTERVAL 2   // socket stat refresh interval (2 seconds)
 #define IFADDRS_HASH_CACHE_REFRESH_INTERVAL 10   // socket ifaddrs cache refresh interval (10 seconds)
-#define DEVICE_CHANGE_JUDGEMENT_TIME 5000   //判断网卡是否变更时间间隔
+#define NETIF_CHANGE_SETTLE_TIME 500   // link events come in bursts, wait for them to settle (ms)
+#define RING_CAPTURE_MAX_WORKERS 4   // max ring backend capture threads
 
 using namespace std;
 using namespace DDLog;
@@ -47,447 +52,394 @@ NetifPacketCapture::NetifPacketCapture(NetifMonitor *netIfmontor, QObject *paren
     m_timer->setSingleShot(true);
     // dispatch packets on timerout signal
     connect(m_timer, &QTimer::timeout, this, &NetifPacketCapture::dispatchPackets);
-    //设置定时器定时判断是否变更网卡
-    m_timerChangeDev = new QTimer(this);
-    connect(m_timerChangeDev, &QTimer::timeout, this, &NetifPacketCapture::whetherDevChanged);
-    m_timerChangeDev->start(DEVICE_CHANGE_JUDGEMENT_TIME);
+    // link & address changes are pushed by rtnetlink, listening starts with the monitor job
+    m_linkWatcher = new NetifLinkWatcher(this);
+    m_netifChangeTimer = new QTimer(this);
+    m_netifChangeTimer->setSingleShot(true);
+    m_netifChangeTimer->setInterval(NETIF_CHANGE_SETTLE_TIME);
+    connect(m_netifChangeTimer, &QTimer::timeout, this, &NetifPacketCapture::onNetifChanged);
+    connect(m_linkWatcher, &NetifLinkWatcher::linksChanged, m_netifChangeTimer, QOverload<>::of(&QTimer::start));
+    connect(m_linkWatcher, &NetifLinkWatcher::addressesChanged, m_netifChangeTimer, QOverload<>::of(&QTimer::start));
 }
 
-void NetifPacketCapture::whetherDevChanged()
+NetifPacketCapture::~NetifPacketCapture()
 {
-    qCDebug(app) << "Checking if network device has changed...";
-    if (m_devName.isEmpty()) {
-        qCInfo(app) << "No current device, starting new monitor job";
-        m_changedDev = true;
-        startNetifMonitorJob();
-    } else {
-        QString current_dev = m_devName;
-        getCurrentDevName();
-        qCDebug(app) << "Current device:" << current_dev << ", Best available device:" << m_devName;
-        //若新增网卡设备优先级高于当前使用网卡设备,则重新开始监测任务
-        if (current_dev.compare(m_devName) != 0) {
-            qCInfo(app) << "Network device changed from" << current_dev << "to" << m_devName;
-            m_changedDev = true;
-            startNetifMonitorJob();
-        }
-    }
+    // join ring workers before tables & monitor go away
+    m_ringCapture.reset();
+    closeCaptures();
 }
 
-bool NetifPacketCapture::hasDevIP()
+void NetifPacketCapture::onNetifChanged()
 {
-    if (m_devName.isEmpty()) {
-        qCWarning(app) << "hasDevIP check failed: device name is empty.";
-        return false;
+    if (!go && !m_ringCapture) {
+        return;
     }
 
-    struct sockaddr_in *addr {};
-    struct ifreq ifr {};
-    char *address {};
-    int sockfd;
-    //设备名称过长
-    if (m_devName.size() >= IFNAMSIZ) {
-        qCWarning(app) << "Device name too long:" << m_devName;
-        return false;
+    // addresses & mtus are read again on next table refresh
+    m_lastIfaddrsRefresh = 0;
+    if (m_ringCapture) {
+        // ring sockets are bound to all interfaces already
+        refreshMatchTable();
+        return;
     }
+    updateCaptureLinks();
+}
 
-    strcpy(ifr.ifr_name, m_devName.toLocal8Bit().data());
-    //创建socket
-    sockfd = socket(AF_INET, SOCK_DGRAM, 0);
+void NetifPacketCapture::readCaptureLinks(QMap<int, QByteArray> &links)
+{
+    links.clear();
+    struct if_nameindex *ifs = if_nameindex();
+    if (!ifs)
+        return;
 
-    //获取网络IP(IPv4)
-    if (ioctl(sockfd, SIOCGIFADDR, &ifr) == -1) {
-        qCWarning(app) << "Failed to get IP address for device:" << m_devName;
+    int sockfd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (sockfd >= 0) {
+        for (auto *it = ifs; it->if_index != 0 && it->if_name; ++it) {
+            struct ifreq ifr {};
+            strncpy(ifr.ifr_name, it->if_name, IFNAMSIZ - 1);
+            if (ioctl(sockfd, SIOCGIFFLAGS, &ifr) != 0)
+                continue;
+            // down links can not be activated, loopback traffic is never attributed
+            if (!(ifr.ifr_flags & IFF_UP) || (ifr.ifr_flags & IFF_LOOPBACK))
+                continue;
+            links.insert(int(it->if_index), QByteArray(it->if_name));
+        }
         close(sockfd);
-        return false;
     }
+    if_freenameindex(ifs);
+}
 
-    addr = (struct sockaddr_in *)&(ifr.ifr_addr);
-    address = inet_ntoa(addr->sin_addr);
-    if (address) {
-        qCDebug(app) << "Device" << m_devName << "has IP:" << address;
-        close(sockfd);
-        return true;
-    } else {
-        qCWarning(app) << "No IP address found for device:" << m_devName;
-        close(sockfd);
-        return false;
+void NetifPacketCapture::startNetifMonitorJob()
+{
+    qCDebug(app) << "Attempting to start network monitor job...";
+    int bufferSize = 0;
+    bool ring = false;
+    uint samplingThreshold = 0;
+    readCaptureConfig(bufferSize, ring, samplingThreshold);
+
+    if (!m_linkWatcher->isRunning() && !m_linkWatcher->start()) {
+        qCWarning(app) << "Link events not available, capture links are only read on start";
     }
+
+    if (ring && startRingCapture(bufferSize, samplingThreshold)) {
+        return;
+    }
+
+    if (!m_packetRing) {
+        m_packetRing = m_netifMonitor->createPacketRing();
+    }
+    m_bufferSize = bufferSize;
+    m_sampler = PacketSampler(samplingThreshold);
+    go = true;
+    updateCaptureLinks();
 }
 
-bool NetifPacketCapture::getCurrentDevName()
+void NetifPacketCapture::updateCaptureLinks()
 {
-    qCDebug(app) << "Getting current best network device name...";
-    QProcess process;
-    process.start("route", QStringList() << "-n");
-    process.waitForFinished(-1);
-    QString output = QString(process.readAllStandardOutput());
-    
-    // 先区分换行符号
-    QStringList outputList = output.split("\n");
-    if (outputList.size() > 0)
-        outputList.removeFirst();
-    QList<QStringList> totalList;
-    foreach (QString tmpList, outputList) {
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        QStringList lineList = tmpList.split(QRegExp("\\s{1,}"));
-#else
-        QStringList lineList = tmpList.split(QRegularExpression("\\s{1,}"));
-#endif
-        totalList.append(lineList);
-    }
-
-    // 设备和优先级列编号
-    int metricColNum = 0;
-    int devColNum = 0;
-    QList<QPair<QString, int>> metricList = {};
-    QString devName = "";
-    if (totalList.size() > 0) {
-        QStringList firstLine = totalList[0];
-        for (int j = 0; j < firstLine.size(); j++) {
-            if (firstLine[j].compare("Metric", Qt::CaseInsensitive) == 0) {
-                metricColNum = j;
-            }
-            if (firstLine[j].compare("Iface", Qt::CaseInsensitive) == 0) {
-                devColNum = j;
-            }
-        }
+    QMap<int, QByteArray> links;
+    readCaptureLinks(links);
+    if (m_ifMtus.isEmpty() || !m_lastIfaddrsRefresh) {
+        readIfMtus(m_ifMtus);
     }
 
-    if (totalList.size() > 0)
-        totalList.removeFirst();
-
-    for (int i = 0; i < totalList.size(); i++) {
-        auto list = totalList[i];
-        if (list.size() > devColNum && list.size() > metricColNum) {
-            // 默认网卡
-            if (!list.isEmpty() && list.first() == "0.0.0.0") {
-                metricList.clear();
-                metricList.append(QPair<QString, int>(list[devColNum], list[metricColNum].toInt()));
-                break;
-            } else {
-                metricList.append(QPair<QString, int>(list[devColNum], list[metricColNum].toInt()));
-            }
+    // ifindex may be reused by a new link with another name
+    for (auto it = m_captures.begin(); it != m_captures.end();) {
+        if (links.value(it.key()) == it.value()->ifname) {
+            ++it;
+            continue;
         }
+        qCInfo(app) << "Stop capturing on" << it.value()->ifname;
+        pcap_close(it.value()->handle);
+        it = m_captures.erase(it);
     }
 
-    int minMetric = 0;
-    QString perfectDev = "";
-    for (int i = 0; i < metricList.size(); i++) {
-        QPair<QString, int> pair = metricList[i];
-        if (i == 0) {
-            minMetric = pair.second;
-            perfectDev = pair.first;
-        } else {
-            if (minMetric > pair.second) {
-                minMetric = pair.second;
-                perfectDev = pair.first;
-            }
+    for (auto it = links.cbegin(); it != links.cend(); ++it) {
+        if (m_captures.contains(it.key()))
+            continue;
+        auto capture = openCapture(it.key(), it.value());
+        if (capture) {
+            qCInfo(app) << "Start capturing on" << it.value();
+            m_captures.insert(it.key(), capture);
         }
     }
-    m_devName = perfectDev;
-    qCDebug(app) << "Determined best device:" << m_devName << "with metric:" << minMetric;
 
-    //无可用设备
-    if (m_devName.isEmpty()) {
-        qCWarning(app) << "No suitable network device found";
-        return false;
+    if (m_captures.isEmpty()) {
+        qCWarning(app) << "No network interface to capture on";
+        m_timer->stop();
+        return;
+    }
+    if (!m_timer->isActive()) {
+        m_timer->start();
+        qCDebug(app) << "Packet capture job started. Dispatch timer initiated.";
     }
-    return true;
 }
 
-void NetifPacketCapture::startNetifMonitorJob()
+PcapCapture NetifPacketCapture::openCapture(int ifindex, const QByteArray &ifname)
 {
-    qCDebug(app) << "Attempting to start network monitor job...";
     int rc = 0;
     char errbuf[PCAP_ERRBUF_SIZE] {};
 
-    getCurrentDevName();
-    if (m_devName.isEmpty()) {
-        qCWarning(app) << "Cannot start monitor job: no device available";
-        return;
-    }
-    qCDebug(app) << "Starting monitor job on device:" << m_devName;
-
     // create pcap handler
-    m_handle = pcap_create(m_devName.toLocal8Bit().data(), errbuf);
-    if (!m_handle) {
-        qCWarning(app) << "Failed to create pcap handler:" << errbuf;
-        return;
+    pcap_t *handle = pcap_create(ifname.constData(), errbuf);
+    if (!handle) {
+        qCWarning(app) << "Failed to create pcap handler on" << ifname << ":" << errbuf;
+        return {};
     }
 
-    // pcap_compile crashes everytime without any reason, need researching...
-#if 0
-    char pattern[] = 0111 "TCP and UDP";
-    struct bpf_program pgm;
-
-    rc = pcap_compile(m_handle, &pgm, pattern, 1, PCAP_NETMASK_UNKNOWN);
-    if (rc == -1) {
-        qCDebug(app) << "pcap_compile failed: " << pcap_geterr(m_handle);
-        pcap_close(m_handle);
-        return;
+    // only L2-L4 headers are parsed, payload size is taken from the wire length
+    rc = pcap_set_snaplen(handle, PACKET_CAPTURE_SNAPLEN);
+    if (rc != 0) {
+        qCWarning(app) << "pcap_set_snaplen failed:" << pcap_statustostr(rc);
     }
-    rc = pcap_setfilter(m_handle, &pgm);
-    if (rc == -1) {
-        qCDebug(app) << "pcap_setfilter failed: " << pcap_geterr(m_handle);
-        pcap_close(m_handle);
-        return;
+    if (m_bufferSize > 0) {
+        rc = pcap_set_buffer_size(handle, m_bufferSize);
+        if (rc != 0) {
+            qCWarning(app) << "pcap_set_buffer_size failed:" << pcap_statustostr(rc);
+        }
     }
-#endif
 
     // activate pcap handler
-    rc = pcap_activate(m_handle);
+    rc = pcap_activate(handle);
     if (rc > 0) {
-        qCWarning(app) << "pcap_activate warning:" << pcap_statustostr(rc);
+        qCWarning(app) << "pcap_activate warning on" << ifname << ":" << pcap_statustostr(rc);
     } else if (rc < 0) {
-        qCWarning(app) << "pcap_activate failed:" << pcap_statustostr(rc);
-        pcap_close(m_handle);
-        return;
+        qCWarning(app) << "pcap_activate failed on" << ifname << ":" << pcap_statustostr(rc);
+        pcap_close(handle);
+        return {};
+    }
+
+    // parser expects ethernet frames, same as ring backend raw ip tunnels are skipped
+    if (pcap_datalink(handle) != DLT_EN10MB) {
+        qCInfo(app) << "Skip capturing on non ethernet link" << ifname;
+        pcap_close(handle);
+        return {};
     }
-    qCDebug(app) << "pcap handler activated successfully.";
 
-    // setm_timer->start(); non block dispatch mode
-    rc = pcap_setnonblock(m_handle, 1, errbuf);
+    // drop non tcp/udp frames in kernel, filter can only be compiled on an activated handler
+    struct bpf_program pgm;
+    rc = pcap_compile(handle, &pgm, PACKET_CAPTURE_FILTER, 1, PCAP_NETMASK_UNKNOWN);
+    if (rc == -1) {
+        qCWarning(app) << "pcap_compile failed:" << pcap_geterr(handle);
+    } else {
+        rc = pcap_setfilter(handle, &pgm);
+        if (rc == -1) {
+            qCWarning(app) << "pcap_setfilter failed:" << pcap_geterr(handle);
+        }
+        pcap_freecode(&pgm);
+    }
+
+    // non block dispatch mode, all handles are dispatched in turn by one timer
+    rc = pcap_setnonblock(handle, 1, errbuf);
     if (rc == -1) {
         qCWarning(app) << "Failed to set non-blocking mode:" << errbuf;
-        pcap_close(m_handle);
-        return;
+        pcap_close(handle);
+        return {};
     }
-    qCDebug(app) << "pcap handler set to non-blocking mode.";
 
-    go = true;
-    m_timer->start();
-    qCDebug(app) << "Packet capture job started. Dispatch timer initiated.";
+    auto capture = PcapCapture::create();
+    capture->capture = this;
+    capture->handle = handle;
+    capture->ifname = ifname;
+    capture->mtu = m_ifMtus.value(ifindex, PACKET_DEFAULT_MTU);
+    capture->drops = 0;
+    return capture;
 }
 
-void pcap_callback(u_char *context, const struct pcap_pkthdr *hdr, const u_char *packet)
+void NetifPacketCapture::closeCaptures()
 {
-    qCDebug(app) << "pcap_callback triggered for a packet";
-    QByteArray fmtbuf;
-    uint64_t hash {}, cchash[2] {};
-    QString pattern {};
-
-    // packet payload calc
-    if (!context)
-        return;
-
-    // get monitor & monitor job instance from user context
-    auto *netifMonitorJob = reinterpret_cast<NetifPacketCapture *>(context);
-    Q_ASSERT(netifMonitorJob != nullptr);
-    auto *netifMonitor = netifMonitorJob->m_netifMonitor;
-    Q_ASSERT(netifMonitor != nullptr);
-
-    // parse packet & calculate payload
-    PacketPayload payload = QSharedPointer<struct packet_payload_t>::create();
-    auto ok = NetifPacketParser::parsePacket(hdr, packet, payload);
-    if (!ok) {
-        qCDebug(app) << "Failed to parse packet";
-        return;
+    for (const auto &capture : m_captures) {
+        pcap_close(capture->handle);
     }
+    m_captures.clear();
+}
 
-    char dMac[256];
-    auto *eth_hdr = reinterpret_cast<const struct ether_header *>(packet);
-    sprintf(dMac, "%x:%x:%x:%x:%x:%x", (eth_hdr->ether_dhost)[0], (eth_hdr->ether_dhost)[1],
-            (eth_hdr->ether_dhost)[2], (eth_hdr->ether_dhost)[3],
-            (eth_hdr->ether_dhost)[4], (eth_hdr->ether_dhost)[5]);
-
-    // calc hash from caputured packet's src:sport-dest:dport
-    if (payload->sa_family == AF_INET) {
-        // ipv4 packet payload
-        char saddr_str[INET_ADDRSTRLEN + 1] {}, daddr_str[INET_ADDRSTRLEN + 1] {};
-        // convert ipv4 source & destination address to string format
-        inet_ntop(AF_INET, &payload->s_addr.in4, saddr_str, INET_ADDRSTRLEN);
-        inet_ntop(AF_INET, &payload->d_addr.in4, daddr_str, INET_ADDRSTRLEN);
-
-        // pattern that matches kernel sock stat table
-        pattern = QString("%1:%2-%3:%4").arg(saddr_str).arg(payload->s_port).arg(daddr_str).arg(payload->d_port);
-        uint64_t saddr_hpair[2] {}, daddr_hpair[2] {};
-        // generate source address hash
-        util::common::hash(saddr_str, int(strlen(saddr_str)), util::common::global_seed, saddr_hpair);
-        // generate destination address hash
-        util::common::hash(daddr_str, int(strlen(daddr_str)), util::common::global_seed, daddr_hpair);
-        if (netifMonitorJob->m_ifaddrsHashCache.contains(saddr_hpair[0])) {
-            payload->direction = kOutboundPacket;
-            qCDebug(app) << "Outbound packet:" << pattern;
-        } else if (netifMonitorJob->m_ifaddrsHashCache.contains(daddr_hpair[0])) {
-            payload->direction = kInboundPacket;
-            qCDebug(app) << "Inbound packet:" << pattern;
-        } else {
-            qCDebug(app) << "Packet not matching local addresses:" << pattern;
-            return;
-        }
-
-    } else if (payload->sa_family == AF_INET6) {
-        // ipv6 packet payload
-        char saddr6_str[INET6_ADDRSTRLEN + 1] {}, daddr6_str[INET6_ADDRSTRLEN + 1] {};
-        inet_ntop(AF_INET6, &payload->s_addr.in6, saddr6_str, INET6_ADDRSTRLEN);
-        inet_ntop(AF_INET6, &payload->d_addr.in6, daddr6_str, INET6_ADDRSTRLEN);
-
-        // pattern that matches kernel sock stat table
-        pattern = QString("%1:%2-%3:%4").arg(saddr6_str).arg(payload->s_port).arg(daddr6_str).arg(payload->d_port);
-        uint64_t saddr6_hpair[2] {}, daddr6_hpair[2] {};
-        // generate source address hash
-        util::common::hash(saddr6_str, int(strlen(saddr6_str)), util::common::global_seed, saddr6_hpair);
-        // generate destination address hash
-        util::common::hash(daddr6_str, int(strlen(daddr6_str)), util::common::global_seed, daddr6_hpair);
-        if (netifMonitorJob->m_ifaddrsHashCache.contains(saddr6_hpair[0])) {
-            payload->direction = kOutboundPacket;
-            qCDebug(app) << "Outbound packet:" << pattern;
-        } else if (netifMonitorJob->m_ifaddrsHashCache.contains(daddr6_hpair[0])) {
-            payload->direction = kInboundPacket;
-            qCDebug(app) << "Inbound packet:" << pattern;
-        } else {
-            qCDebug(app) << "Packet not matching local addresses:" << pattern;
-            return;
-        }
+bool NetifPacketCapture::classifyPacket(const SockTable &sockTable,
+                                        const QSet<addr_key_t> &ifaddrs,
+                                        const struct pcap_pkthdr *hdr,
+                                        const u_char *packet,
+                                        packet_payload_t &payload,
+                                        uint mtu)
+{
+    // headers are matched in place, only a matching packet is copied out
+    const packet_headers_t headers = NetifPacketParser::parseHeaders(packet, hdr->caplen, hdr->len);
+    if (!headers.valid()) {
+        TRACE_LOG_TRACE("Failed to parse packet");
+        return false;
+    }
 
+    // match against local addresses & kernel sock stat table with binary keys, no formatting per packet
+    packet_direction direction;
+    if (ifaddrs.contains(makeAddrKey(headers.sa_family, headers.s_addr))) {
+        direction = kOutboundPacket;
+    } else if (ifaddrs.contains(makeAddrKey(headers.sa_family, headers.d_addr))) {
+        direction = kInboundPacket;
     } else {
-        // unexpected here
-    }
-
-    fmtbuf = pattern.toLocal8Bit();
-    util::common::hash(fmtbuf.constData(), fmtbuf.length(), util::common::global_seed, cchash);
-    hash = cchash[0];
-    // get ino from map
-    if (netifMonitorJob->m_sockStats.contains(hash)) {
-        QMultiMap<uint64_t, SockStat>::const_iterator it = netifMonitorJob->m_sockStats.find(hash);
-        while (it != netifMonitorJob->m_sockStats.cend() && it.key() == hash) {
-            // TODO: UDP traffic identify method refine
-            // UDP socks may have same kernel hash slot (sl: hash generated with same src:port + dest:port),
-            // which means there's no way to distinguish which packet sent/received by which socket, what
-            // makes it very tricky to get the real UDP traffic for specific process, we assume
-            // socks with same sl are created by same process for temporary, need a much fine way to
-            // distinguish the traffic at a later time.
-            payload->ino = it.value()->ino;
-            break;
-        }
-    } else {
+        TRACE_LOG_TRACE("Packet not matching local addresses");
+        return false;
+    }
+
+    // get ino from socket table
+    ino_t ino {};
+    if (!sockTable.find(makeFlowKey(headers.sa_family,
+                                    headers.s_addr, headers.s_port,
+                                    headers.d_addr, headers.d_port), ino)) {
         // no matching sockets in /proc tcp/udp table, which means we cant grab inode from socket table,
         // the only thing we can do here is ignore this packet.
-        return;
+        return false;
     }
+    // TODO: UDP traffic identify method refine
+    // UDP socks may have same kernel hash slot (sl: hash generated with same src:port + dest:port),
+    // which means there's no way to distinguish which packet sent/received by which socket, what
+    // makes it very tricky to get the real UDP traffic for specific process, we assume
+    // socks with same sl are created by same process for temporary, need a much fine way to
+    // distinguish the traffic at a later time.
+    NetifPacketParser::fillPayload(hdr, headers, payload, mtu);
+    payload.direction = direction;
+    payload.ino = ino;
+    return true;
+}
 
-    netifMonitorJob->m_localPendingPackets.enqueue(payload);
-    auto npkts = netifMonitorJob->m_localPendingPackets.size();
-    if (npkts >= PACKET_DISPATCH_QUEUE_LWAT && npkts < PACKET_DISPATCH_QUEUE_HWAT) {
-        // if dispatch queue is between low & high water mark, then we can just use try lock in relax way
-        if (netifMonitor->m_pktqLock.tryLock()) {
-            netifMonitor->m_pendingPackets.append(netifMonitorJob->m_localPendingPackets);
-            netifMonitor->m_pktqLock.unlock();
+bool NetifPacketCapture::recordPacket(const SockTable &sockTable,
+                                      const QSet<addr_key_t> &ifaddrs,
+                                      const struct pcap_pkthdr *hdr,
+                                      const u_char *packet,
+                                      uint mtu,
+                                      PacketRecordRing &ring,
+                                      uint weight)
+{
+    struct packet_payload_t payload;
+    if (!classifyPacket(sockTable, ifaddrs, hdr, packet, payload, mtu))
+        return false;
 
-            // clear local pending queue after move packets to monitor instance's queue
-            netifMonitorJob->m_localPendingPackets.clear();
+    // monitor is behind, dropping is better than blocking the capture
+    if (!ring.push({payload.ino, payload.wire_len, payload.direction, weight})) {
+        TRACE_LOG_DEBUG("Packet record ring full, dropping packet");
+        return false;
+    }
+    return true;
+}
 
-            netifMonitor->m_pktqWatcher.wakeAll();
-            qCDebug(app) << "Dispatched" << npkts << "packets (relaxed mode)";
-        }
-    } else if (npkts >= PACKET_DISPATCH_QUEUE_HWAT) {
-        // otherwise we forcefully use lock instead
-        netifMonitor->m_pktqLock.lock();
-        netifMonitor->m_pendingPackets.append(netifMonitorJob->m_localPendingPackets);
-        netifMonitor->m_pktqLock.unlock();
+void pcap_callback(u_char *context, const struct pcap_pkthdr *hdr, const u_char *packet)
+{
+    TRACE_LOG_TRACE("pcap_callback triggered for a packet");
+    // packet payload calc
+    if (!context)
+        return;
 
-        // clear local pending queue after move packets to monitor instance's queue
-        netifMonitorJob->m_localPendingPackets.clear();
+    // get interface capture & monitor job instance from user context
+    auto *capture = reinterpret_cast<pcap_capture_t *>(context);
+    auto *netifMonitorJob = capture->capture;
+    Q_ASSERT(netifMonitorJob != nullptr);
+    if (!netifMonitorJob->m_packetRing)
+        return;
+    // overloaded, only 1 in rate packets is classified
+    auto &sampler = netifMonitorJob->m_sampler;
+    if (!sampler.take())
+        return;
 
-        netifMonitor->m_pktqWatcher.wakeAll();
-        qCDebug(app) << "Dispatched" << npkts << "packets (force mode)";
-    }
+    NetifPacketCapture::recordPacket(netifMonitorJob->m_sockTable, netifMonitorJob->m_ifaddrsHashCache,
+                                     hdr, packet, capture->mtu, *netifMonitorJob->m_packetRing, sampler.rate());
 }
 
 // dispatch packet handler
 void NetifPacketCapture::dispatchPackets()
 {
-    usleep(20000);
     if (!go) {
         qCDebug(app) << "Packet capture stopped";
         return;
     }
-    //无可用设备
-    if (m_devName.isEmpty()) {
+    // restarted by updateCaptureLinks once a link comes up
+    if (m_captures.isEmpty()) {
         qCWarning(app) << "No device available for packet capture";
         return;
     }
 
-    // check pending packets before dispatching packets
-    auto npkts = m_localPendingPackets.size();
-    if (npkts > 0) {
-        if (npkts >= PACKET_DISPATCH_QUEUE_LWAT && npkts < PACKET_DISPATCH_QUEUE_HWAT) {
-            // pending packets between low & high water mark
-            if (m_netifMonitor->m_pktqLock.tryLock()) {
-                m_netifMonitor->m_pendingPackets.append(m_localPendingPackets);
-                m_netifMonitor->m_pktqLock.unlock();
-
-                m_netifMonitor->m_pktqWatcher.wakeAll();
-
-                m_localPendingPackets.clear();
-                qCDebug(app) << "Dispatched" << npkts << "packets (relaxed mode)";
-            }
-        } else if (npkts >= PACKET_DISPATCH_QUEUE_HWAT) {
-            // acquire lock forcefully if too many packets pending
-            m_netifMonitor->m_pktqLock.lock();
-            m_netifMonitor->m_pendingPackets.append(m_localPendingPackets);
-            m_netifMonitor->m_pktqLock.unlock();
-
-            m_netifMonitor->m_pktqWatcher.wakeAll();
-
-            m_localPendingPackets.clear();
-            qCDebug(app) << "Dispatched" << npkts << "packets (force mode)";
-        }
-    }
-
-    time_t last_sockstat {};
-    time_t last_ifaddrs_refresh {};
-
-    do {
-        usleep(20000);
+    // classify cost is bounded by the sampler, so keep dispatching while packets are pending
+    for (int round = 0; round < PACKET_DISPATCH_MAX_ROUNDS; ++round) {
         // quit requested, break the loop then
         auto quit = m_quitRequested.load();
         if (quit) {
             qCInfo(app) << "Quit requested, stopping packet capture";
             m_timer->stop();
-            break;
+            // close pcap handles
+            closeCaptures();
+            return;
         }
 
-        // refresh m_sockStat cache every 2 seconds
-        time_t now = time(nullptr);
-        if (!last_sockstat || (now - last_sockstat) >= SOCKSTAT_REFRESH_INTERVAL) {
-            qCDebug(app) << "Refreshing socket statistics";
-            m_sockStats.clear();
-            SysInfo::readSockStat(m_sockStats);
-            last_sockstat = now;
+        // refresh timestamps are members, so idle rounds between dispatches do not force a refresh
+        refreshSockTable();
+
+        // start packet dispatching on every link in turn
+        int total = 0;
+        for (auto it = m_captures.begin(); it != m_captures.end();) {
+            const auto &capture = it.value();
+            auto nr = pcap_dispatch(capture->handle,
+                                    PACKET_DISPATCH_BATCH_COUNT,
+                                    pcap_callback,
+                                    reinterpret_cast<u_char *>(capture.data()));
+            if (nr < 0) {
+                // -1: error (e.g. link went away before its event was handled), -2: breakloop
+                qCWarning(app) << "pcap_dispatch failed on" << capture->ifname << ":" << pcap_geterr(capture->handle);
+                pcap_close(capture->handle);
+                it = m_captures.erase(it);
+                continue;
+            }
+            total += nr;
+            ++it;
         }
 
-        // refresh m_ifaddrsHashCache every 10 seconds in case user change ip address on the fly
-        if (!last_ifaddrs_refresh || (now - last_ifaddrs_refresh) >= IFADDRS_HASH_CACHE_REFRESH_INTERVAL) {
-            qCDebug(app) << "Refreshing interface address cache";
-            refreshIfAddrsHashCache();
-            last_ifaddrs_refresh = now;
+        if (m_sampler.due()) {
+            updateSampling();
         }
 
-        // start packet dispatching
-        auto nr = pcap_dispatch(m_handle,
-                                PACKET_DISPATCH_BATCH_COUNT,
-                                pcap_callback,
-                                reinterpret_cast<u_char *>(this));
-        if (nr == 0) {
+        if (total > 0) {
+            // one wakeup per dispatched round
+            m_netifMonitor->notifyPackets();
+        } else if (m_captures.isEmpty()) {
+            m_timer->stop();
+            return;
+        } else {
             // no packets are available, idle this loop for a fraction second
             m_timer->start(PACKET_DISPATCH_IDLE_TIME);
             return;
-        } else if (nr == -1) {
-            // error occurred while processing packets
-            qCWarning(app) << "pcap_dispatch failed:" << pcap_geterr(m_handle);
-            m_timer->stop();
-            break;
-        } else if (nr == -2) {
-            // breakloop requested (can only happen inside the callback function)
-            qCInfo(app) << "Break loop requested";
-            m_timer->stop();
-            break;
         }
-    } while (true);
+    }
 
-    // close pcap handle
-    pcap_close(m_handle);
+    // still busy, let link events & table refreshes through before dispatching again
+    m_timer->start(0);
+}
+
+void NetifPacketCapture::updateSampling()
+{
+    qulonglong drops = 0;
+    for (const auto &capture : m_captures) {
+        struct pcap_stat stat {};
+        if (pcap_stats(capture->handle, &stat) != 0)
+            continue;
+        // counter is cumulative since activation
+        drops += stat.ps_drop - capture->drops;
+        capture->drops = stat.ps_drop;
+    }
+    m_sampler.update(drops);
+}
+
+void NetifPacketCapture::stopNetifMonitorJob()
+{
+    qCInfo(app) << "Stopping packet capture job";
+    go = false;
+    m_timer->stop();
+    m_netifChangeTimer->stop();
+    m_linkWatcher->stop();
+    if (m_matchTableTimer) {
+        m_matchTableTimer->stop();
+    }
+    m_ringCapture.reset();
+    closeCaptures();
+    // monitor drops the ring once drained
+    m_packetRing.reset();
+    // tables are refreshed right away on restart
+    m_lastSockTableRefresh = 0;
+    m_lastIfaddrsRefresh = 0;
 }
 
 bool readNetIfAddrs(NetIFAddrsMap &addrsMap)
@@ -528,6 +480,116 @@ bool readNetIfAddrs(NetIFAddrsMap &addrsMap)
     }
 }
 
+void NetifPacketCapture::readCaptureConfig(int &bufferSize, bool &ring, uint &samplingThreshold)
+{
+    int kbytes = 0;
+    int threshold = PACKET_SAMPLING_DEFAULT_THRESHOLD;
+    ring = true;
+    std::unique_ptr<DTK_CORE_NAMESPACE::DConfig> config(DTK_CORE_NAMESPACE::DConfig::create("deepin-system-monitor", "org.deepin.system-monitor"));
+    if (config && config->isValid()) {
+        kbytes = config->value("packet_capture_buffer_size", 0).toInt();
+        ring = config->value("packet_capture_ring", true).toBool();
+        threshold = config->value("packet_capture_sampling_threshold", PACKET_SAMPLING_DEFAULT_THRESHOLD).toInt();
+    }
+    // 0: keep backend default
+    bufferSize = kbytes > 0 ? kbytes * 1024 : 0;
+    // 0: never sample
+    samplingThreshold = uint(qMax(0, threshold));
+}
+
+bool NetifPacketCapture::startRingCapture(int bufferSize, uint samplingThreshold)
+{
+    if (m_ringCapture) {
+        return true;
+    }
+
+    m_ringCapture.reset(new NetifRingCapture(m_netifMonitor));
+    // workers need socket table before the first packet arrives
+    m_lastIfaddrsRefresh = 0;
+    refreshMatchTable();
+
+    int nworkers = qBound(1, QThread::idealThreadCount() / 2, RING_CAPTURE_MAX_WORKERS);
+    if (!m_ringCapture->start(nworkers, bufferSize, samplingThreshold)) {
+        qCWarning(app) << "Ring capture not available, falling back to pcap";
+        m_ringCapture.reset();
+        return false;
+    }
+
+    if (!m_matchTableTimer) {
+        m_matchTableTimer = new QTimer(this);
+        connect(m_matchTableTimer, &QTimer::timeout, this, &NetifPacketCapture::refreshMatchTable);
+    }
+    m_matchTableTimer->start(SOCKSTAT_REFRESH_INTERVAL * 1000);
+    return true;
+}
+
+void NetifPacketCapture::refreshMatchTable()
+{
+    if (!m_ringCapture) {
+        return;
+    }
+    if (m_quitRequested.load()) {
+        qCInfo(app) << "Quit requested, stopping ring capture";
+        m_matchTableTimer->stop();
+        m_ringCapture->stop();
+        return;
+    }
+
+    // timer already runs at the refresh interval
+    m_lastSockTableRefresh = 0;
+    refreshSockTable();
+
+    // workers keep reading the published snapshot, copying the flat table is a plain slot copy
+    auto table = std::make_shared<packet_match_table_t>();
+    table->sockTable = m_sockTable;
+    table->ifaddrs = m_ifaddrsHashCache;
+    table->mtus = m_ifMtus;
+
+    // workers pick up the new tables with their next block
+    m_ringCapture->setMatchTable(table);
+}
+
+void NetifPacketCapture::refreshSockTable()
+{
+    // refresh socket table every 2 seconds
+    time_t now = time(nullptr);
+    if (!m_lastSockTableRefresh || (now - m_lastSockTableRefresh) >= SOCKSTAT_REFRESH_INTERVAL) {
+        qCDebug(app) << "Refreshing socket table";
+        m_sockDiag.refresh(m_sockTable);
+        m_lastSockTableRefresh = now;
+    }
+
+    // refresh local addresses every 10 seconds in case user change ip address on the fly
+    if (!m_lastIfaddrsRefresh || (now - m_lastIfaddrsRefresh) >= IFADDRS_HASH_CACHE_REFRESH_INTERVAL) {
+        qCDebug(app) << "Refreshing interface address cache";
+        refreshIfAddrsHashCache();
+        readIfMtus(m_ifMtus);
+        for (auto it = m_captures.begin(); it != m_captures.end(); ++it)
+            it.value()->mtu = m_ifMtus.value(it.key(), PACKET_DEFAULT_MTU);
+        m_lastIfaddrsRefresh = now;
+    }
+}
+
+void NetifPacketCapture::readIfMtus(QHash<int, uint> &mtus)
+{
+    mtus.clear();
+    struct if_nameindex *ifs = if_nameindex();
+    if (!ifs)
+        return;
+
+    int sockfd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (sockfd >= 0) {
+        for (auto *it = ifs; it->if_index != 0 && it->if_name; ++it) {
+            struct ifreq ifr {};
+            strncpy(ifr.ifr_name, it->if_name, IFNAMSIZ - 1);
+            if (ioctl(sockfd, SIOCGIFMTU, &ifr) == 0 && ifr.ifr_mtu > 0)
+                mtus.insert(int(it->if_index), uint(ifr.ifr_mtu));
+        }
+        close(sockfd);
+    }
+    if_freenameindex(ifs);
+}
+
 // refresh network interface hash cache
 void NetifPacketCapture::refreshIfAddrsHashCache()
 {
@@ -536,33 +598,18 @@ void NetifPacketCapture::refreshIfAddrsHashCache()
     // get network interface map
     auto ok = readNetIfAddrs(addrsMap);
     if (ok) {
+        QSet<addr_key_t> ifaddrs;
         NetIFAddrsMap::const_iterator it = addrsMap.constBegin();
         // process each address in map
         while (it != addrsMap.constEnd()) {
             auto ifaddr = it.value();
-
-            uint64_t ifaddr_hash[2] {};
-            if (ifaddr->family == AF_INET) {
-                char addr_str[INET_ADDRSTRLEN + 1] {};
-                // convert to ipv4 format string
-                inet_ntop(AF_INET, &ifaddr->addr.in4, addr_str, INET_ADDRSTRLEN);
-
-                // calculate hash
-                util::common::hash(addr_str, int(strlen(addr_str)), util::common::global_seed, ifaddr_hash);
-                m_ifaddrsHashCache[ifaddr_hash[0]] = 0;
-
-            } else if (ifaddr->family == AF_INET6) {
-                char addr6_str[INET6_ADDRSTRLEN + 1] {};
-                // convert to ipv6 format string
-                inet_ntop(AF_INET6, &ifaddr->addr.in6, addr6_str, INET6_ADDRSTRLEN);
-
-                // calculate hash
-                util::common::hash(addr6_str, int(strlen(addr6_str)), util::common::global_seed, ifaddr_hash);
-                m_ifaddrsHashCache[ifaddr_hash[0]] = 0;
-            }
+            if (ifaddr->family == AF_INET || ifaddr->family == AF_INET6)
+                ifaddrs.insert(makeAddrKey(ifaddr->family, &ifaddr->addr));
 
             ++it;
         }
+        // drop addresses removed since last refresh as well
+        m_ifaddrsHashCache.swap(ifaddrs);
     }
 }
 
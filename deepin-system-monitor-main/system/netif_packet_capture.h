@@ -8,19 +8,45 @@
 
 #include <QObject>
 #include "packet.h"
+#include "sock_diag.h"
+#include "netif_packet_parser.h"
+#include "packet_sampler.h"
 #include <QTimer>
 #include <QMap>
+#include <QSet>
 #include <unistd.h>
 
+#include <memory>
+
+#define PACKET_CAPTURE_SNAPLEN 192   // eth + 2 vlan tags + ip/ip6 with extension headers + tcp/udp headers
+// tcp/udp over ip, protochain walks ipv6 extension headers like the parser does
+#define PACKET_CAPTURE_L3L4 "((ip and (tcp or udp)) or ip6 protochain 6 or ip6 protochain 17)"
+// kernel side capture filter, untagged, 802.1Q or QinQ tagged frames
+#define PACKET_CAPTURE_FILTER PACKET_CAPTURE_L3L4 " or (vlan and (" PACKET_CAPTURE_L3L4 " or (vlan and " PACKET_CAPTURE_L3L4 ")))"
 
 namespace core {
 namespace system {
 class NetifMonitor;
+class NetifRingCapture;
+class NetifLinkWatcher;
+class NetifPacketCapture;
+
+// pcap capture of a single interface, all of them feed the same record ring
+struct pcap_capture_t {
+    NetifPacketCapture *capture;
+    pcap_t *handle;
+    QByteArray ifname;
+    uint mtu;
+    uint drops; // kernel drop counter at last sampling update
+};
+using PcapCapture = QSharedPointer<struct pcap_capture_t>;
+
 class NetifPacketCapture : public QObject
 {
     Q_OBJECT
 public:
     explicit NetifPacketCapture(NetifMonitor *netInfmontor, QObject *parent = nullptr);
+    ~NetifPacketCapture() override;
     inline void requestQuit()
     {
         m_quitRequested.store(true);
@@ -29,19 +55,40 @@ public:
      * @brief Packet dispatch handler
      */
     void dispatchPackets();
-    pcap_t  *getHandle() { return m_handle;}
-
-
-protected:
 
     /**
-     * @brief 获取当前网卡名
+     * @brief Parse packet & match it against local addresses and socket table
+     * @return true if packet belongs to a local socket, payload carries its inode & direction
+     */
+    static bool classifyPacket(const SockTable &sockTable,
+                               const QSet<addr_key_t> &ifaddrs,
+                               const struct pcap_pkthdr *hdr,
+                               const u_char *packet,
+                               struct packet_payload_t &payload,
+                               uint mtu);
+    /**
+     * @brief Classify packet & push its record to ring, packet is dropped if ring is full
+     * @param weight Packets the record stands for, sampling rate of the capture
+     * @return true if a record was pushed
      */
-    bool getCurrentDevName();
+    static bool recordPacket(const SockTable &sockTable,
+                             const QSet<addr_key_t> &ifaddrs,
+                             const struct pcap_pkthdr *hdr,
+                             const u_char *packet,
+                             uint mtu,
+                             PacketRecordRing &ring,
+                             uint weight = 1);
     /**
-     * @brief 判断当前网卡是否被分配可用网络IP(IPv4)
+     * @brief Read mtu of every link
+     * @param mtus ifindex => mtu
      */
-    bool hasDevIP();
+    static void readIfMtus(QHash<int, uint> &mtus);
+    /**
+     * @brief Read links packets are captured on: up & not loopback
+     * @param links ifindex => interface name
+     */
+    static void readCaptureLinks(QMap<int, QByteArray> &links);
+
 signals:
 
 public slots:
@@ -49,32 +96,82 @@ public slots:
      * @brief Start monitor job
      */
     void startNetifMonitorJob();
+    /**
+     * @brief Stop capture & release capture handles, startNetifMonitorJob starts it again
+     */
+    void stopNetifMonitorJob();
 
     /**
-     * @brief 判断使用网卡是否变更,变更则重启startNetifMonitorJob槽函数;
+     * @brief Links or addresses changed, refresh tables & capture set
      */
-    void whetherDevChanged();
+    void onNetifChanged();
 
 private:
 
+    /**
+     * @brief Read capture settings from config
+     * @param bufferSize Kernel capture buffer size in bytes, 0 to keep default
+     * @param ring Use TPACKET_V3 ring backend instead of libpcap
+     * @param samplingThreshold Packets per second & capture thread before sampling starts, 0 never samples
+     */
+    static void readCaptureConfig(int &bufferSize, bool &ring, uint &samplingThreshold);
+
+    /**
+     * @brief Start TPACKET_V3 ring backend on all interfaces
+     * @return false if ring backend is not available
+     */
+    bool startRingCapture(int bufferSize, uint samplingThreshold);
+    /**
+     * @brief Refresh socket & address tables used by ring backend workers
+     */
+    void refreshMatchTable();
+
+    /**
+     * @brief Refresh socket table & interface addresses if their refresh interval passed
+     */
+    void refreshSockTable();
     /**
      * @brief Refresh network interface address hash cache
      */
     void refreshIfAddrsHashCache();
 
+    /**
+     * @brief Open a pcap handle for every capture link not captured yet, close the ones gone
+     */
+    void updateCaptureLinks();
+    /**
+     * @brief Create & activate pcap handle on an interface
+     * @return nullptr if interface can not be captured on
+     */
+    PcapCapture openCapture(int ifindex, const QByteArray &ifname);
+    void closeCaptures();
+    /**
+     * @brief Feed kernel drops of all handles to the sampler
+     */
+    void updateSampling();
+
 
 private:
-    // socket io stat cache
-    SockStatMap     m_sockStats {};
-    // network interface name hash cache
-    QMap<uint64_t, int> m_ifaddrsHashCache; // key: hash code generated from ifaddr; value: not used
+    // flow to socket inode table, refreshed in place
+    SockTable       m_sockTable {};
+    // socket table dumper
+    SockDiag        m_sockDiag {};
+    time_t m_lastSockTableRefresh {};
+    // local network interface address cache
+    QSet<addr_key_t> m_ifaddrsHashCache;
 
     // network interface monitor
     NetifMonitor       *m_netifMonitor         {};
-    // pcap handler instance
-    pcap_t             *m_handle               {};
-    // local pending packet queue
-    PacketPayloadQueue  m_localPendingPackets  {};
+    // pcap captures by ifindex
+    QMap<int, PcapCapture> m_captures          {};
+    // kernel capture buffer size of pcap handles, 0 for default
+    int                 m_bufferSize           {};
+    // overload protection of pcap dispatch
+    PacketSampler       m_sampler              {};
+    // ifindex => mtu
+    QHash<int, uint>    m_ifMtus               {};
+    // packet records handed to monitor, owned by capture thread
+    std::shared_ptr<PacketRecordRing> m_packetRing;
 
     // request quit atomic flag
     std::atomic_bool m_quitRequested {false};
@@ -82,14 +179,17 @@ private:
     // packet dispatch timer
     QTimer *m_timer {};
 
-    //是否变更网卡
-    bool m_changedDev {false}; 
-    //当前使用网卡名
-    QString m_devName {};
-    //当前系统所有网卡设备链表
-    pcap_if_t *m_alldevs {};
-    //判断网卡是否变更定时器
-    QTimer *m_timerChangeDev {};
+    // rtnetlink link & address events
+    NetifLinkWatcher *m_linkWatcher {};
+    // coalesces bursts of link events
+    QTimer *m_netifChangeTimer {};
+
+    // TPACKET_V3 ring backend, captures on all interfaces so only its tables follow link changes
+    std::unique_ptr<NetifRingCapture> m_ringCapture;
+    // socket & address tables refresh timer for ring backend
+    QTimer *m_matchTableTimer {};
+    // last local address refresh
+    time_t m_lastIfaddrsRefresh {};
     friend void pcap_callback(u_char *, const struct pcap_pkthdr *, const u_char *);
 
 };
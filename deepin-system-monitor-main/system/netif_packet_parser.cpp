@@ -4,7 +4,6 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "netif_packet_parser.h"
-#include "ddlog.h"
 
 #include <netinet/in.h>
 #include <net/ethernet.h>
@@ -16,218 +15,192 @@
 #include <sys/ioctl.h>
 #include <net/if.h>
 
-#define IP6_NEXT_HEADER_HBH 0
-#define IP6_NEXT_HEADER_TCP 6
-#define IP6_NEXT_HEADER_UDP 17
-#define IP6_NEXT_HEADER_EIP6 41
-#define IP6_NEXT_HEADER_ROUTING 43
-#define IP6_NEXT_HEADER_FRAGMENT 44
-#define IP6_NEXT_HEADER_RRSVP 46
-#define IP6_NEXT_HEADER_ESP 50 // skip (TODO: ipsec packets)
-#define IP6_NEXT_HEADER_AUTH 51 // skip (TODO: ipsec packets)
-#define IP6_NEXT_HEADER_ICMP6 58 // skip (TODO: icmpv6 packets)
-#define IP6_NEXT_HEADER_NNH 59
-#define IP6_NEXT_HEADER_DESOPT 60
-
-using namespace DDLog;
+#define ETH_TYPE_OFFSET 12
+#define ETHERTYPE_8021AD 0x88a8 // service tag of QinQ
+#define ETHERTYPE_QINQ 0x9100 // pre 802.1ad double tagging
+#define VLAN_TAG_LEN 4
+#define IP4_MIN_HDR_LEN 20
+#define IP4_FRAG_OFFSET_MASK 0x1fff
+#define IP6_HDR_LEN 40
+#define IP6_FRAG_OFFSET_MASK 0xfff8
+#define IP6_EXT_MIN_LEN 8
+#define TCP_MIN_HDR_LEN 20
+#define UDP_HDR_LEN 8
 
 namespace core {
 namespace system {
 
-bool NetifPacketParser::parsePacket(const pcap_pkthdr *pkt_hdr,
-                                    const u_char *packet,
-                                    PacketPayload &payload)
+namespace {
+
+// frame fields are big endian & unaligned
+inline uint16_t load16(const u_char *p)
 {
-    // qCDebug(app) << "Parsing packet, captured length:" << pkt_hdr->caplen;
-    if (!payload) {
-        payload = QSharedPointer<struct packet_payload_t>::create();
-    }
-    payload->ts = pkt_hdr->ts;
-    const u_char *hdr = packet;
-    // parse hdr&packet
-    auto *eth_hdr = reinterpret_cast<const struct ether_header *>(packet);
-    auto type = ntohs(eth_hdr->ether_type);
-    auto eth_hdr_len = sizeof(struct ether_header);
-    uint proto {};
-    ulong ip_hdr_len {};
+    return uint16_t((p[0] << 8) | p[1]);
+}
 
-    if (type == ETHERTYPE_IP) {
-        qCDebug(app) << "Packet is ETHERTYPE_IP (IPv4)";
-        auto *ip_hdr = reinterpret_cast<const struct ip *>(packet + eth_hdr_len);
-        // ip header length
-        ip_hdr_len = ulong((ip_hdr->ip_hl & 0x0f) * 4);
-        // ip payload
-        hdr = packet + eth_hdr_len + ip_hdr_len;
-        // protocol
-        proto = ip_hdr->ip_p;
-
-        // truncated packets
-        if (pkt_hdr->caplen <= eth_hdr_len + ip_hdr_len) {
-            qCWarning(app) << "Truncated IPv4 packet, captured length" << pkt_hdr->caplen << "is less than or equal to header length" << eth_hdr_len + ip_hdr_len;
-            return false;
-        }
+inline bool isVlanType(uint16_t type)
+{
+    return type == ETHERTYPE_VLAN || type == ETHERTYPE_8021AD || type == ETHERTYPE_QINQ;
+}
+
+} // namespace
 
-        payload->sa_family = AF_INET;
-        payload->proto = proto;
-        payload->s_addr.in4 = ip_hdr->ip_src;
-        payload->d_addr.in4 = ip_hdr->ip_dst;
+packet_headers_t NetifPacketParser::parseHeaders(const u_char *packet, uint32_t caplen, uint32_t len)
+{
+    packet_headers_t headers;
+    uint32_t off = sizeof(struct ether_header);
+    if (caplen < off)
+        return headers;
+
+    uint16_t type = load16(packet + ETH_TYPE_OFFSET);
+    // the tag's own ethertype follows its tci
+    while (isVlanType(type) && headers.vlans < kMaxVlanTags) {
+        if (caplen < off + VLAN_TAG_LEN)
+            return headers;
+        type = load16(packet + off + 2);
+        off += VLAN_TAG_LEN;
+        ++headers.vlans;
+    }
 
+    int family {};
+    uint8_t proto {};
+    const u_char *saddr {};
+    const u_char *daddr {};
+    if (type == ETHERTYPE_IP) {
+        if (caplen < off + IP4_MIN_HDR_LEN || (packet[off] >> 4) != 4)
+            return headers;
+        uint32_t ihl = uint32_t(packet[off] & 0x0f) * 4;
+        // later fragments carry no l4 header
+        if (ihl < IP4_MIN_HDR_LEN || (load16(packet + off + 6) & IP4_FRAG_OFFSET_MASK) != 0)
+            return headers;
+        family = AF_INET;
+        proto = packet[off + 9];
+        saddr = packet + off + 12;
+        daddr = packet + off + 16;
+        off += ihl;
     } else if (type == ETHERTYPE_IPV6) {
-        qCDebug(app) << "Packet is ETHERTYPE_IPV6";
-        auto *ip6_hdr = reinterpret_cast<const struct ip6_hdr *>(packet + eth_hdr_len);
-
-        // next header field in ip6 header
-        uint8_t nhtype = ip6_hdr->ip6_nxt;
-        // find upper-layer protocol header (the last extension header)
-        hdr = packet + eth_hdr_len + sizeof(struct ip6_hdr);
-        bool stop {false};
-        while (!stop) {
-            qCDebug(app) << "Parsing IPv6 next header, type:" << nhtype;
-            switch (nhtype) {
-            case  IP6_NEXT_HEADER_HBH: {
-                // Hop-by-Hop Options Header
-                auto *hbh = reinterpret_cast<const struct ip6_hbh *>(hdr);
-                hdr = hdr + hbh->ip6h_len * 8 + 8;
-                nhtype = hbh->ip6h_nxt;
-                qCDebug(app) << "Parsed Hop-by-Hop header, next header type:" << nhtype;
+        if (caplen < off + IP6_HDR_LEN)
+            return headers;
+        family = AF_INET6;
+        proto = packet[off + 6];
+        saddr = packet + off + 8;
+        daddr = packet + off + 24;
+        off += IP6_HDR_LEN;
+
+        // every extension header starts with its next header, esp can't be looked into
+        for (int i = 0; proto != IPPROTO_TCP && proto != IPPROTO_UDP; ++i) {
+            if (i == kMaxExtensionHeaders || caplen < off + IP6_EXT_MIN_LEN)
+                return headers;
+            uint32_t extLen;
+            switch (proto) {
+            case IPPROTO_HOPOPTS:
+            case IPPROTO_ROUTING:
+            case IPPROTO_DSTOPTS:
+                extLen = (uint32_t(packet[off + 1]) + 1) * 8;
                 break;
-            }
-            case IP6_NEXT_HEADER_TCP: { // UPPER-LAYER protocol header
-                // TCP
-                proto = IPPROTO_TCP;
-                stop = true;
-                qCDebug(app) << "Found TCP header in IPv6";
+            case IPPROTO_FRAGMENT:
+                if ((load16(packet + off + 2) & IP6_FRAG_OFFSET_MASK) != 0)
+                    return headers;
+                extLen = IP6_EXT_MIN_LEN;
                 break;
-            }
-            case IP6_NEXT_HEADER_UDP: { // UPPER-LAYER protocol header
-                // UDP
-                proto = IPPROTO_UDP;
-                stop = true;
-                qCDebug(app) << "Found UDP header in IPv6";
-                break;
-            }
-            case IP6_NEXT_HEADER_EIP6: {
-                // Encapsulated IPv6 Header: IPv6 Tunneling
-                qCWarning(app) << "Ignoring encapsulated IPv6 header";
-                return false;
-            }
-            case IP6_NEXT_HEADER_ROUTING: {
-                // Routing Header
-                auto *rh = reinterpret_cast<const struct ip6_rthdr *>(hdr);
-                hdr = hdr + rh->ip6r_len * 8 + 8;
-                nhtype = rh->ip6r_nxt;
-                qCDebug(app) << "Parsed Routing header, next header type:" << nhtype;
-                break;
-            }
-            case IP6_NEXT_HEADER_FRAGMENT: {
-                // Fragment Header
-                auto *fh = reinterpret_cast<const struct ip6_frag *>(hdr);
-                hdr = hdr + sizeof(struct ip6_frag);
-                nhtype = fh->ip6f_nxt;
-                qCDebug(app) << "Parsed Fragment header, next header type:" << nhtype;
-                break;
-            }
-            case IP6_NEXT_HEADER_RRSVP: {
-                // Resource ReSerVation Protocol
-                qCWarning(app) << "Ignoring RRSVP header";
-                return false;
-            }
-            case IP6_NEXT_HEADER_ESP: {
-                // Encapsulating Security Payload: ignored for now
-                qCWarning(app) << "Ignoring ESP header";
-                return false;
-            }
-            case IP6_NEXT_HEADER_AUTH: {
-                // Authentication Header: ignored for now
-                qCWarning(app) << "Ignoring Auth header";
-                return false;
-            }
-            case IP6_NEXT_HEADER_ICMP6: { // UPPER-LAYER protocol header
-                // ICMPv6: ignored for now
-                qCWarning(app) << "Ignoring ICMPv6 header";
-                return false;
-            }
-            case IP6_NEXT_HEADER_NNH: {
-                // No next header: empty payload
-                qCWarning(app) << "Ignoring packet with no next header";
-                return false;
-            }
-            case IP6_NEXT_HEADER_DESOPT: {
-                // Destination Options Header
-                auto *dh = reinterpret_cast<const struct ip6_dest *>(hdr);
-                hdr = hdr + dh->ip6d_len * 8 + 8;
-                nhtype = dh->ip6d_nxt;
-                qCDebug(app) << "Parsed Destination Options header, next header type:" << nhtype;
+            case IPPROTO_AH:
+                extLen = (uint32_t(packet[off + 1]) + 2) * 4;
                 break;
-            }
             default:
-                // unknown next header type found, stop parsing
-                qCWarning(app) << "Unknown IPv6 next header type:" << nhtype;
-                return false;
-            } // !switch
-        } // !while
-
-        payload->sa_family = AF_INET6;
-        payload->proto = proto;
-        payload->s_addr.in6 = ip6_hdr->ip6_src;
-        payload->d_addr.in6 = ip6_hdr->ip6_dst;
-
+                // esp, icmpv6, tunnels, no next header
+                return headers;
+            }
+            proto = packet[off];
+            off += extLen;
+        }
     } else {
-        // ignore non ip4 & ip6 packets
-        qCDebug(app) << "Ignoring non-IPv4/IPv6 packet, ethertype:" << type;
-        return false;
+        return headers;
     }
 
+    // payload size is taken from the wire length, the capture itself may be cut by snaplen
+    uint32_t l4HdrLen;
     if (proto == IPPROTO_TCP) {
-        qCDebug(app) << "Parsing TCP header";
-        auto *tcp_hdr = reinterpret_cast<const struct tcphdr *>(hdr);
-        auto tcp_hdr_len = ulong(((tcp_hdr->th_off & 0xf0) >> 4) * 4);
-        // no payload data
-        if (pkt_hdr->caplen <= eth_hdr_len + ip_hdr_len + tcp_hdr_len) {
-            qCWarning(app) << "Truncated TCP packet, captured length" << pkt_hdr->caplen << "is less than or equal to header length" << eth_hdr_len + ip_hdr_len + tcp_hdr_len;
-            return false;
-        }
-        payload->payload = pkt_hdr->caplen - eth_hdr_len - ip_hdr_len - tcp_hdr_len;
-        payload->s_port = ntohs(tcp_hdr->th_sport);
-        payload->d_port = ntohs(tcp_hdr->th_dport);
-        qCDebug(app) << "Parsed TCP packet: src port" << payload->s_port << "dst port" << payload->d_port << "payload size" << payload->payload;
-
+        if (caplen < off + TCP_MIN_HDR_LEN)
+            return headers;
+        l4HdrLen = uint32_t(packet[off + 12] >> 4) * 4;
+        if (l4HdrLen < TCP_MIN_HDR_LEN)
+            return headers;
     } else if (proto == IPPROTO_UDP) {
-        qCDebug(app) << "Parsing UDP header";
-        auto *udp_hdr = reinterpret_cast<const struct udphdr *>(hdr);
-        auto udp_len = ulong(ntohs(udp_hdr->uh_ulen));
-        auto udp_hdr_len = sizeof(struct udphdr);
-        ulong ulen {};
-        if (udp_len == 0) {
-            // rfc#2675:
-            // the length field is set to zero if the length of the UDP header plus
-            // UDP data is greater than 65,535
-            ulen = udp_hdr_len;
-            qCDebug(app) << "UDP length is 0, using header length:" << ulen;
-        } else if (udp_len <= udp_hdr_len) {
-            ulen = udp_len;
-        } else {
-            ulen = udp_hdr_len;
-        }
-        // truncated, no payload data
-        if (pkt_hdr->caplen <= eth_hdr_len + ip_hdr_len + ulen) {
-            qCWarning(app) << "Truncated UDP packet, captured length" << pkt_hdr->caplen << "is less than or equal to header length" << eth_hdr_len + ip_hdr_len + ulen;
-            return false;
-        }
-        payload->payload = pkt_hdr->caplen - eth_hdr_len - ip_hdr_len - ulen;
-        payload->s_port = ntohs(udp_hdr->uh_sport);
-        payload->d_port = ntohs(udp_hdr->uh_dport);
-        qCDebug(app) << "Parsed UDP packet: src port" << payload->s_port << "dst port" << payload->d_port << "payload size" << payload->payload;
-
+        if (caplen < off + UDP_HDR_LEN)
+            return headers;
+        l4HdrLen = UDP_HDR_LEN;
     } else {
-        // unexpected case, unknown proto type
-        qCWarning(app) << "Unknown transport protocol:" << proto;
-        return false;
+        return headers;
+    }
+
+    headers.sa_family = family;
+    headers.proto = proto;
+    headers.s_addr = saddr;
+    headers.d_addr = daddr;
+    headers.s_port = load16(packet + off);
+    headers.d_port = load16(packet + off + 2);
+    headers.l4_off = uint16_t(off);
+    headers.l4_hdr_len = uint16_t(l4HdrLen);
+    // pure acks carry no payload but still take wire bytes
+    headers.payload = len > off + l4HdrLen ? len - off - l4HdrLen : 0;
+    return headers;
+}
+
+bool NetifPacketParser::parsePacket(const pcap_pkthdr *pkt_hdr,
+                                    const u_char *packet,
+                                    PacketPayload &payload)
+{
+    if (!payload) {
+        payload = QSharedPointer<struct packet_payload_t>::create();
     }
+    return parsePacket(pkt_hdr, packet, *payload);
+}
 
-    // qCInfo(app) << "Successfully parsed packet.";
+bool NetifPacketParser::parsePacket(const pcap_pkthdr *pkt_hdr,
+                                    const u_char *packet,
+                                    packet_payload_t &payload,
+                                    uint mtu)
+{
+    const packet_headers_t headers = parseHeaders(packet, pkt_hdr->caplen, pkt_hdr->len);
+    if (!headers.valid())
+        return false;
+    fillPayload(pkt_hdr, headers, payload, mtu);
     return true;
 }
 
+void NetifPacketParser::fillPayload(const pcap_pkthdr *pkt_hdr, const packet_headers_t &headers,
+                                    packet_payload_t &payload, uint mtu)
+{
+    payload.ts = pkt_hdr->ts;
+    payload.sa_family = headers.sa_family;
+    payload.proto = headers.proto;
+    if (headers.sa_family == AF_INET6) {
+        memcpy(&payload.s_addr.in6, headers.s_addr, sizeof(in6_addr));
+        memcpy(&payload.d_addr.in6, headers.d_addr, sizeof(in6_addr));
+    } else {
+        memcpy(&payload.s_addr.in4, headers.s_addr, sizeof(in_addr));
+        memcpy(&payload.d_addr.in4, headers.d_addr, sizeof(in_addr));
+    }
+    payload.s_port = headers.s_port;
+    payload.d_port = headers.d_port;
+    payload.payload = headers.payload;
+    // tags make a full sized frame longer than mtu, it's not an offload super frame
+    payload.wire_len = wireLength(pkt_hdr->len, ulong(headers.l4_off) + headers.l4_hdr_len, headers.payload,
+                                  mtu + uint(headers.vlans) * VLAN_TAG_LEN);
+}
+
+unsigned long long NetifPacketParser::wireLength(unsigned long long len, ulong hdrLen,
+                                                 unsigned long long payload, uint mtu)
+{
+    auto mtuFrame = ulong(mtu) + sizeof(struct ether_header);
+    if (len <= mtuFrame || payload == 0 || hdrLen >= mtuFrame)
+        return len;
+
+    // payload per segment, headers are repeated in each one
+    auto segPayload = mtuFrame - hdrLen;
+    auto segs = (payload + segPayload - 1) / segPayload;
+    return payload + segs * hdrLen;
+}
+
 } // namespace system
 } // namespace core
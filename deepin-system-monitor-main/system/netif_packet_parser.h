@@ -8,15 +8,61 @@
 
 #include "packet.h"
 
+#define PACKET_DEFAULT_MTU 1500   // link mtu if not known
+
 namespace core {
 namespace system {
 
+/**
+ * @brief Parses l2-l4 headers of captured ethernet frames
+ *
+ * Headers are walked by offset over the frame bytes, bounds checked against the captured
+ * length. Up to two vlan tags (802.1Q, 802.1ad QinQ) & a bounded chain of ipv6 extension
+ * headers are skipped. Per packet, no allocation & no logging.
+ */
 class NetifPacketParser
 {
 public:
+    /**
+     * @brief Headers of a frame, a view into \a packet
+     * @param caplen Bytes captured
+     * @param len Wire length, payload sizes are taken from it
+     * @return Invalid if the frame isn't tcp/udp over ip, is a later fragment or cut too short
+     */
+    static packet_headers_t parseHeaders(const u_char *packet, uint32_t caplen, uint32_t len);
+    /**
+     * @brief Copy parsed headers into \a payload, with the wire length of an offload super frame
+     */
+    static void fillPayload(const struct pcap_pkthdr *pkt_hdr, const packet_headers_t &headers,
+                            struct packet_payload_t &payload, uint mtu = PACKET_DEFAULT_MTU);
+
     static bool parsePacket(const struct pcap_pkthdr *pkt_hdr,
                             const u_char *packet,
                             PacketPayload &payload);
+    /**
+     * @brief Parse packet into caller provided storage, no allocation
+     * @param mtu Mtu of capturing link, frames above it are segmentation offload super frames
+     */
+    static bool parsePacket(const struct pcap_pkthdr *pkt_hdr,
+                            const u_char *packet,
+                            struct packet_payload_t &payload,
+                            uint mtu = PACKET_DEFAULT_MTU);
+    /**
+     * @brief Bytes a frame takes on the wire
+     *
+     * TSO/GSO (outbound) & GRO (inbound) hand one frame larger than the link mtu to the
+     * capture, on the wire it's split into mtu sized segments each repeating the headers.
+     * @param len Captured frame wire length
+     * @param hdrLen L2-L4 header length
+     * @param payload L4 payload bytes
+     */
+    static unsigned long long wireLength(unsigned long long len, ulong hdrLen,
+                                         unsigned long long payload, uint mtu);
+
+    // vlan tags skipped, an outer service tag & an inner customer tag
+    static constexpr int kMaxVlanTags = 2;
+    // ipv6 extension headers skipped before giving up on a frame
+    static constexpr int kMaxExtensionHeaders = 8;
 
 
 private:
@@ -0,0 +1,253 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "netif_queues.h"
+#include "ddlog.h"
+#include "process/process_scheduling.h"
+
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
+
+#include <linux/ethtool.h>
+#include <linux/sockios.h>
+#include <net/if.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <vector>
+
+using namespace DDLog;
+
+namespace core {
+namespace system {
+
+namespace {
+
+// vectors of a device that serve no queue, mlx5_async0, i40e-0000:3b:00.0:misc, virtio0-config
+const char *const kNonQueueIrqs[] = {"async", "misc", "config", "ctrl", "mbox", "mgmt", "fw"};
+
+inline bool isNameChar(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+// interface name as a word of an irq name, eth1 isn't in eth10-rx-0
+bool containsIfname(const QByteArray &name, const QByteArray &ifname)
+{
+    for (int pos = name.indexOf(ifname); pos >= 0; pos = name.indexOf(ifname, pos + 1)) {
+        const int end = pos + ifname.size();
+        if ((pos == 0 || !isNameChar(name.at(pos - 1))) && (end == name.size() || !isNameChar(name.at(end))))
+            return true;
+    }
+    return false;
+}
+
+QSet<int> msiIrqs(const QByteArray &ifname)
+{
+    QSet<int> irqs;
+    // virtio devices have their vectors on the pci device above them
+    for (const char *dir : {"device/msi_irqs", "device/../msi_irqs"}) {
+        const QStringList entries = QDir(QString("/sys/class/net/%1/%2").arg(QString::fromLocal8Bit(ifname)).arg(dir))
+                                        .entryList(QDir::Files | QDir::NoDotAndDotDot);
+        for (const QString &entry : entries) {
+            bool ok = false;
+            const int irq = entry.toInt(&ok);
+            if (ok)
+                irqs.insert(irq);
+        }
+        if (!irqs.isEmpty())
+            break;
+    }
+    return irqs;
+}
+
+QVector<int> irqAffinity(int irq)
+{
+    // effective is where it lands, the configured mask may be wider
+    for (const char *file : {"effective_affinity_list", "smp_affinity_list"}) {
+        QFile list(QString("/proc/irq/%1/%2").arg(irq).arg(file));
+        if (!list.open(QIODevice::ReadOnly))
+            continue;
+        const QVector<int> cpus = core::process::ProcessScheduling::parseCpuList(QString::fromLatin1(list.readAll().trimmed()));
+        if (!cpus.isEmpty())
+            return cpus;
+    }
+    return {};
+}
+
+} // namespace
+
+QList<NetifQueues::irq_t> NetifQueues::readIrqs(const QByteArray &ifname)
+{
+    QFile file("/proc/interrupts");
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(app) << "Failed to open /proc/interrupts";
+        return {};
+    }
+    QList<irq_t> irqs = parseInterrupts(file.readAll(), msiIrqs(ifname), ifname);
+    for (irq_t &irq : irqs)
+        irq.affinity = irqAffinity(irq.irq);
+    return irqs;
+}
+
+QList<NetifQueues::irq_t> NetifQueues::parseInterrupts(const QByteArray &text, const QSet<int> &irqs, const QByteArray &ifname)
+{
+    QList<irq_t> result;
+    const QList<QByteArray> lines = text.split('\n');
+    if (lines.isEmpty())
+        return result;
+
+    // columns are the online cpus only
+    QVector<int> cpus;
+    int maxCpu = -1;
+    for (const QByteArray &column : lines.first().simplified().split(' ')) {
+        bool ok = false;
+        const int cpu = column.startsWith("CPU") ? column.mid(3).toInt(&ok) : -1;
+        if (!ok)
+            continue;
+        cpus << cpu;
+        maxCpu = qMax(maxCpu, cpu);
+    }
+
+    for (int i = 1; i < lines.size(); ++i) {
+        const QList<QByteArray> fields = lines[i].simplified().split(' ');
+        // "24:", a count per cpu, chip, hw irq, trigger & the action
+        if (fields.size() < cpus.size() + 2 || !fields.first().endsWith(':'))
+            continue;
+        bool ok = false;
+        irq_t irq;
+        irq.irq = fields.first().chopped(1).toInt(&ok);
+        if (!ok)
+            continue;
+        // shared irqs list their actions comma separated, the last is enough to tell
+        irq.name = fields.last();
+        if (irqs.isEmpty() ? !containsIfname(irq.name, ifname) : !irqs.contains(irq.irq))
+            continue;
+        irq.queue = queueOf(irq.name, ifname);
+        if (irq.queue < 0)
+            continue;
+        irq.direction = directionOf(irq.name);
+        irq.counts.fill(0, maxCpu + 1);
+        for (int c = 0; c < cpus.size(); ++c)
+            irq.counts[cpus[c]] = fields[c + 1].toULongLong();
+        result << irq;
+    }
+    return result;
+}
+
+int NetifQueues::queueOf(const QByteArray &name, const QByteArray &ifname)
+{
+    QByteArray action = name.left(name.indexOf('@'));
+    // single vector of e1000e & the like, named after the interface
+    if (action == ifname)
+        return 0;
+    const QByteArray lower = action.toLower();
+    for (const char *marker : kNonQueueIrqs) {
+        if (lower.contains(marker))
+            return -1;
+    }
+    // digits of the interface name aren't the queue's
+    const int pos = action.indexOf(ifname);
+    if (!ifname.isEmpty() && pos >= 0)
+        action = action.mid(pos + ifname.size());
+
+    int start = action.size();
+    while (start > 0 && action.at(start - 1) >= '0' && action.at(start - 1) <= '9')
+        --start;
+    if (start == action.size() || start == 0)
+        return -1;
+    return action.mid(start).toInt();
+}
+
+int NetifQueues::directionOf(const QByteArray &name)
+{
+    const QByteArray lower = name.toLower();
+    const bool rx = lower.contains("rx") || lower.contains("input");
+    const bool tx = lower.contains("tx") || lower.contains("output");
+    if (rx && !tx)
+        return kQueueRx;
+    if (tx && !rx)
+        return kQueueTx;
+    return kQueueRxTx;
+}
+
+bool NetifQueues::parseStatName(const QByteArray &name, int &queue, int &direction, bool &bytes)
+{
+    // rx_queue_0_packets: virtio_net & intel, rx-0.packets: i40e & ice, rx0_packets: mlx5
+    static const QRegularExpression kQueueStat("^\\s*([rt]x)(?:_queue_|-|_)?(\\d+)[_.](packets|bytes)$");
+    const QRegularExpressionMatch match = kQueueStat.match(QString::fromLatin1(name));
+    if (!match.hasMatch())
+        return false;
+    direction = match.captured(1) == "rx" ? kQueueRx : kQueueTx;
+    queue = match.captured(2).toInt();
+    bytes = match.captured(3) == "bytes";
+    return true;
+}
+
+QMap<int, NetifQueues::queue_stat_t> NetifQueues::readStats(const QByteArray &ifname)
+{
+    QMap<int, queue_stat_t> stats;
+    if (ifname.isEmpty() || ifname.size() >= IFNAMSIZ)
+        return stats;
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return stats;
+
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, ifname.constData(), IFNAMSIZ - 1);
+
+    // number of counters, then their names & values in the same order
+    struct {
+        struct ethtool_sset_info info;
+        __u32 count;
+    } sset {};
+    sset.info.cmd = ETHTOOL_GSSET_INFO;
+    sset.info.sset_mask = 1ULL << ETH_SS_STATS;
+    ifr.ifr_data = reinterpret_cast<char *>(&sset);
+    if (ioctl(fd, SIOCETHTOOL, &ifr) != 0 || !(sset.info.sset_mask & (1ULL << ETH_SS_STATS)) || sset.count == 0) {
+        close(fd);
+        return stats;
+    }
+    const __u32 count = sset.count;
+
+    std::vector<char> names(sizeof(struct ethtool_gstrings) + size_t(count) * ETH_GSTRING_LEN);
+    auto *strings = reinterpret_cast<struct ethtool_gstrings *>(names.data());
+    strings->cmd = ETHTOOL_GSTRINGS;
+    strings->string_set = ETH_SS_STATS;
+    strings->len = count;
+    ifr.ifr_data = names.data();
+    const bool named = ioctl(fd, SIOCETHTOOL, &ifr) == 0;
+
+    std::vector<char> values(sizeof(struct ethtool_stats) + size_t(count) * sizeof(__u64));
+    auto *counters = reinterpret_cast<struct ethtool_stats *>(values.data());
+    counters->cmd = ETHTOOL_GSTATS;
+    counters->n_stats = count;
+    ifr.ifr_data = values.data();
+    const bool read = named && ioctl(fd, SIOCETHTOOL, &ifr) == 0;
+    close(fd);
+    if (!read)
+        return stats;
+
+    for (__u32 i = 0; i < qMin(count, qMin(strings->len, counters->n_stats)); ++i) {
+        const char *data = reinterpret_cast<const char *>(strings->data) + size_t(i) * ETH_GSTRING_LEN;
+        int queue = -1;
+        int direction = 0;
+        bool bytes = false;
+        if (!parseStatName(QByteArray(data, int(strnlen(data, ETH_GSTRING_LEN))), queue, direction, bytes))
+            continue;
+        queue_stat_t &stat = stats[queue];
+        if (direction == kQueueRx)
+            (bytes ? stat.rxBytes : stat.rxPackets) = counters->data[i];
+        else
+            (bytes ? stat.txBytes : stat.txPackets) = counters->data[i];
+    }
+    return stats;
+}
+
+} // namespace system
+} // namespace core
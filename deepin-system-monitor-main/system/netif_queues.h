@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NETIF_QUEUES_H
+#define NETIF_QUEUES_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QVector>
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Queue irqs of a network interface & the per queue counters of its driver
+ *
+ * Irqs are the msi vectors of the device of the interface, taken from /proc/interrupts with
+ * the cpus they're delivered to. Per queue packets & bytes come from the driver statistics of
+ * SIOCETHTOOL, what ethtool -S prints, which needs no privilege; drivers name them their own
+ * way, the usual rx_queue_0_packets, rx-0.packets & rx0_packets styles are understood.
+ * Everything is cumulative since boot, see NetifQueueModel for rates.
+ */
+class NetifQueues
+{
+public:
+    enum Direction {
+        kQueueRx = 0x1,
+        kQueueTx = 0x2,
+        kQueueRxTx = kQueueRx | kQueueTx
+    };
+
+    struct irq_t {
+        int irq {-1};
+        QByteArray name; // action of /proc/interrupts, e.g. eth0-TxRx-3
+        int queue {-1}; // queue served, -1 if the name has none
+        int direction {kQueueRxTx};
+        QVector<quint64> counts; // interrupts by cpu id
+        QVector<int> affinity; // cpus it's delivered to, sorted
+    };
+
+    struct queue_stat_t {
+        quint64 rxPackets {0};
+        quint64 rxBytes {0};
+        quint64 txPackets {0};
+        quint64 txBytes {0};
+    };
+
+    /**
+     * @brief Queue irqs of an interface, by irq number
+     * @return Empty for virtual interfaces & devices without msi vectors
+     */
+    static QList<irq_t> readIrqs(const QByteArray &ifname);
+    /**
+     * @brief Per queue driver counters of an interface, by queue number
+     * @return Empty if the driver reports none per queue
+     */
+    static QMap<int, queue_stat_t> readStats(const QByteArray &ifname);
+
+    /**
+     * @brief Lines of /proc/interrupts of the irqs \a irqs, or named after \a ifname without them
+     */
+    static QList<irq_t> parseInterrupts(const QByteArray &text, const QSet<int> &irqs, const QByteArray &ifname);
+    /**
+     * @brief Queue number of an irq name, e.g. 3 of eth0-TxRx-3 & of mlx5_comp3@pci:0000:01:00.0
+     * @return -1 if it serves no queue, like eth0-misc
+     */
+    static int queueOf(const QByteArray &name, const QByteArray &ifname);
+    /**
+     * @brief Direction of an irq name, rx & tx unless it says input, output, rx or tx only
+     */
+    static int directionOf(const QByteArray &name);
+    /**
+     * @brief Split a per queue driver counter name, e.g. rx_queue_0_packets
+     * @return false if it isn't the packets or bytes of one queue
+     */
+    static bool parseStatName(const QByteArray &name, int &queue, int &direction, bool &bytes);
+};
+
+} // namespace system
+} // namespace core
+
+#endif // NETIF_QUEUES_H
@@ -0,0 +1,286 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "netif_ring_capture.h"
+#include "netif_packet_capture.h"
+#include "netif_monitor.h"
+#include "netif_packet_parser.h"
+#include "ddlog.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <net/if_arp.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+
+#define RING_DEFAULT_SIZE (4 << 20)   // total ring size if not configured (4MiB)
+#define RING_BLOCK_SIZE (256 << 10)   // ring block size, multiple of page size
+#define RING_MIN_BLOCKS 2   // minimum blocks per ring
+#define RING_FRAME_SIZE 2048   // nominal frame size, V3 packs variable sized frames into blocks
+#define RING_BLOCK_TIMEOUT 64   // block retire timeout (ms), bounds latency on quiet links
+#define RING_POLL_TIMEOUT 200   // poll timeout (ms), bounds quit latency
+
+using namespace DDLog;
+
+namespace core {
+namespace system {
+
+NetifRingCapture::NetifRingCapture(NetifMonitor *netifMonitor)
+    : m_netifMonitor(netifMonitor)
+    , m_table(std::make_shared<const packet_match_table_t>())
+{
+}
+
+NetifRingCapture::~NetifRingCapture()
+{
+    stop();
+}
+
+bool NetifRingCapture::start(int nworkers, int bufferSize, uint samplingThreshold)
+{
+    if (isRunning())
+        return true;
+
+    m_samplingThreshold = samplingThreshold;
+    nworkers = qMax(1, nworkers);
+    if (bufferSize <= 0)
+        bufferSize = RING_DEFAULT_SIZE;
+    int blockCount = qMax(RING_MIN_BLOCKS, bufferSize / nworkers / RING_BLOCK_SIZE);
+    // fanout group ids are global, pid keeps ours apart from other capturing processes
+    int fanoutGroup = nworkers > 1 ? int(getpid() & 0xffff) : -1;
+
+    auto *first = new NetifRingCaptureWorker(this);
+    if (!first->open(RING_BLOCK_SIZE, blockCount, fanoutGroup)) {
+        // a single ring is still fine if fanout is not supported
+        if (fanoutGroup < 0 || !first->open(RING_BLOCK_SIZE, blockCount, -1)) {
+            qCWarning(app) << "Failed to open TPACKET_V3 capture ring";
+            delete first;
+            return false;
+        }
+        nworkers = 1;
+    }
+    m_workers << first;
+
+    for (int i = 1; i < nworkers; ++i) {
+        auto *worker = new NetifRingCaptureWorker(this);
+        if (!worker->open(RING_BLOCK_SIZE, blockCount, fanoutGroup)) {
+            delete worker;
+            break;
+        }
+        m_workers << worker;
+    }
+
+    for (auto *worker : m_workers)
+        worker->start();
+    qCInfo(app) << "TPACKET_V3 capture started with" << m_workers.size() << "workers," << blockCount << "blocks each";
+    return true;
+}
+
+void NetifRingCapture::stop()
+{
+    for (auto *worker : m_workers)
+        worker->requestQuit();
+    for (auto *worker : m_workers) {
+        worker->wait();
+        delete worker;
+    }
+    m_workers.clear();
+}
+
+int NetifRingCapture::parseBlock(const tpacket_block_desc *block,
+                                 const packet_match_table_t &table,
+                                 PacketRecordRing &ring,
+                                 PacketSampler &sampler)
+{
+    int nr = 0;
+    auto *base = reinterpret_cast<const uint8_t *>(block);
+    auto *frame = reinterpret_cast<const tpacket3_hdr *>(base + block->hdr.bh1.offset_to_first_pkt);
+
+    for (uint32_t i = 0; i < block->hdr.bh1.num_pkts; ++i) {
+        auto *sll = reinterpret_cast<const sockaddr_ll *>(reinterpret_cast<const uint8_t *>(frame) + TPACKET_ALIGN(sizeof(tpacket3_hdr)));
+        // parser expects ethernet frames, this skips loopback & tunnels as well
+        // overloaded, only 1 in rate packets is classified
+        if (sll->sll_hatype == ARPHRD_ETHER && sampler.take()) {
+            struct pcap_pkthdr hdr;
+            hdr.ts.tv_sec = time_t(frame->tp_sec);
+            hdr.ts.tv_usec = suseconds_t(frame->tp_nsec / 1000);
+            hdr.caplen = frame->tp_snaplen;
+            hdr.len = frame->tp_len;
+
+            auto *packet = reinterpret_cast<const u_char *>(frame) + frame->tp_mac;
+            uint mtu = table.mtus.value(sll->sll_ifindex, PACKET_DEFAULT_MTU);
+            if (NetifPacketCapture::recordPacket(table.sockTable, table.ifaddrs, &hdr, packet, mtu, ring, sampler.rate()))
+                ++nr;
+        }
+
+        frame = reinterpret_cast<const tpacket3_hdr *>(reinterpret_cast<const uint8_t *>(frame) + frame->tp_next_offset);
+    }
+    return nr;
+}
+
+NetifRingCaptureWorker::NetifRingCaptureWorker(NetifRingCapture *capture)
+    : QThread()
+    , m_capture(capture)
+    , m_records(capture->m_netifMonitor->createPacketRing())
+    , m_sampler(capture->m_samplingThreshold)
+{
+    setObjectName("RingCapture");
+}
+
+NetifRingCaptureWorker::~NetifRingCaptureWorker()
+{
+    close();
+}
+
+bool NetifRingCaptureWorker::open(int blockSize, int blockCount, int fanoutGroup)
+{
+    errno = 0;
+    m_fd = socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, htons(ETH_P_ALL));
+    if (m_fd < 0) {
+        qCWarning(app) << "Failed to create packet socket:" << strerror(errno);
+        return false;
+    }
+
+    int version = TPACKET_V3;
+    if (setsockopt(m_fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
+        qCWarning(app) << "TPACKET_V3 not supported:" << strerror(errno);
+        close();
+        return false;
+    }
+
+    // same filter as the pcap backend, its return value also cuts frames to snaplen
+    pcap_t *dead = pcap_open_dead(DLT_EN10MB, PACKET_CAPTURE_SNAPLEN);
+    if (dead) {
+        struct bpf_program pgm;
+        if (pcap_compile(dead, &pgm, PACKET_CAPTURE_FILTER, 1, PCAP_NETMASK_UNKNOWN) == 0) {
+            struct sock_fprog fprog;
+            fprog.len = static_cast<unsigned short>(pgm.bf_len);
+            fprog.filter = reinterpret_cast<struct sock_filter *>(pgm.bf_insns);
+            if (setsockopt(m_fd, SOL_SOCKET, SO_ATTACH_FILTER, &fprog, sizeof(fprog)) < 0)
+                qCWarning(app) << "Failed to attach capture filter:" << strerror(errno);
+            pcap_freecode(&pgm);
+        } else {
+            qCWarning(app) << "pcap_compile failed:" << pcap_geterr(dead);
+        }
+        pcap_close(dead);
+    }
+
+    struct tpacket_req3 req;
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size = uint(blockSize);
+    req.tp_block_nr = uint(blockCount);
+    req.tp_frame_size = RING_FRAME_SIZE;
+    req.tp_frame_nr = uint(blockSize / RING_FRAME_SIZE * blockCount);
+    req.tp_retire_blk_tov = RING_BLOCK_TIMEOUT;
+    if (setsockopt(m_fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
+        qCWarning(app) << "Failed to setup rx ring:" << strerror(errno);
+        close();
+        return false;
+    }
+
+    m_ringSize = size_t(blockSize) * size_t(blockCount);
+    void *ring = mmap(nullptr, m_ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED, m_fd, 0);
+    if (ring == MAP_FAILED) {
+        // locking may be refused by RLIMIT_MEMLOCK, rx ring works without it
+        ring = mmap(nullptr, m_ringSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    }
+    if (ring == MAP_FAILED) {
+        qCWarning(app) << "Failed to map rx ring:" << strerror(errno);
+        m_ringSize = 0;
+        close();
+        return false;
+    }
+    m_ring = static_cast<uint8_t *>(ring);
+    m_blockSize = blockSize;
+    m_blockCount = blockCount;
+
+    // ifindex 0: all interfaces
+    struct sockaddr_ll sll;
+    memset(&sll, 0, sizeof(sll));
+    sll.sll_family = AF_PACKET;
+    sll.sll_protocol = htons(ETH_P_ALL);
+    sll.sll_ifindex = 0;
+    if (bind(m_fd, reinterpret_cast<struct sockaddr *>(&sll), sizeof(sll)) < 0) {
+        qCWarning(app) << "Failed to bind packet socket:" << strerror(errno);
+        close();
+        return false;
+    }
+
+    if (fanoutGroup >= 0) {
+        // hash by flow, defrag so fragments of one datagram hash alike
+        int fanout = fanoutGroup | ((PACKET_FANOUT_HASH | PACKET_FANOUT_FLAG_DEFRAG) << 16);
+        if (setsockopt(m_fd, SOL_PACKET, PACKET_FANOUT, &fanout, sizeof(fanout)) < 0) {
+            qCWarning(app) << "Failed to join fanout group:" << strerror(errno);
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void NetifRingCaptureWorker::close()
+{
+    if (m_ring) {
+        munmap(m_ring, m_ringSize);
+        m_ring = nullptr;
+        m_ringSize = 0;
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+void NetifRingCaptureWorker::run()
+{
+    struct pollfd pfd;
+    pfd.fd = m_fd;
+    pfd.events = POLLIN | POLLERR;
+    pfd.revents = 0;
+    int current = 0;
+
+    while (!m_quitRequested.load()) {
+        auto *block = reinterpret_cast<tpacket_block_desc *>(m_ring + size_t(current) * size_t(m_blockSize));
+        if (m_sampler.due())
+            updateSampling();
+
+        if (!(__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER)) {
+            poll(&pfd, 1, RING_POLL_TIMEOUT);
+            continue;
+        }
+
+        // one table lookup per block instead of per packet
+        auto table = m_capture->matchTable();
+        int nr = NetifRingCapture::parseBlock(block, *table, *m_records, m_sampler);
+
+        // give block back to kernel
+        __atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+        current = (current + 1) % m_blockCount;
+
+        // one wakeup per block
+        if (nr > 0)
+            m_capture->m_netifMonitor->notifyPackets();
+    }
+}
+
+void NetifRingCaptureWorker::updateSampling()
+{
+    // counters are reset by the kernel on every read
+    struct tpacket_stats_v3 stats;
+    memset(&stats, 0, sizeof(stats));
+    socklen_t len = sizeof(stats);
+    if (getsockopt(m_fd, SOL_PACKET, PACKET_STATISTICS, &stats, &len) < 0)
+        stats.tp_drops = 0;
+    m_sampler.update(stats.tp_drops);
+}
+
+} // namespace system
+} // namespace core
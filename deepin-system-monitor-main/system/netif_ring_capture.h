@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NETIF_RING_CAPTURE_H
+#define NETIF_RING_CAPTURE_H
+
+#include "packet.h"
+#include "sock_diag.h"
+#include "packet_sampler.h"
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QThread>
+
+#include <atomic>
+#include <memory>
+
+struct tpacket_block_desc;
+
+namespace core {
+namespace system {
+
+class NetifMonitor;
+
+// socket & local address tables packets are matched against, replaced as a whole on refresh
+struct packet_match_table_t {
+    SockTable sockTable;
+    QSet<addr_key_t> ifaddrs;
+    QHash<int, uint> mtus; // ifindex => mtu
+};
+using PacketMatchTable = std::shared_ptr<const packet_match_table_t>;
+
+class NetifRingCaptureWorker;
+
+/**
+ * @brief AF_PACKET TPACKET_V3 capture backend
+ *
+ * Each worker owns a packet socket bound to all interfaces with a memory mapped rx ring,
+ * sockets join one PACKET_FANOUT hash group so a flow always lands on the same worker.
+ * Workers block in poll() until the kernel retires a ring block (either full or after the
+ * block timeout), so there is no sleep polling. Frames are cut to headers & non tcp/udp
+ * traffic is dropped by a bpf filter in kernel, loopback & non ethernet links are skipped.
+ * Each worker samples on its own once it falls behind, see PacketSampler.
+ */
+class NetifRingCapture
+{
+public:
+    explicit NetifRingCapture(NetifMonitor *netifMonitor);
+    ~NetifRingCapture();
+
+    NetifRingCapture(const NetifRingCapture &) = delete;
+    NetifRingCapture &operator=(const NetifRingCapture &) = delete;
+
+    /**
+     * @brief Open rings & start workers
+     * @param nworkers Number of capture threads
+     * @param bufferSize Total ring size in bytes shared by all workers, 0 for default
+     * @param samplingThreshold Packets per second & worker before sampling starts, 0 never samples
+     * @return false if packet sockets or rings are not available (e.g. no CAP_NET_RAW)
+     */
+    bool start(int nworkers, int bufferSize, uint samplingThreshold = 0);
+    /**
+     * @brief Stop & join workers, close rings
+     */
+    void stop();
+
+    inline bool isRunning() const { return !m_workers.isEmpty(); }
+
+    inline PacketMatchTable matchTable() const { return std::atomic_load(&m_table); }
+    inline void setMatchTable(const PacketMatchTable &table) { std::atomic_store(&m_table, table); }
+
+    /**
+     * @brief Classify packets of a retired ring block
+     * @return Number of packet records pushed
+     */
+    static int parseBlock(const struct tpacket_block_desc *block,
+                          const packet_match_table_t &table,
+                          PacketRecordRing &ring,
+                          PacketSampler &sampler);
+
+private:
+    NetifMonitor *m_netifMonitor;
+    uint m_samplingThreshold {};
+    PacketMatchTable m_table;
+    QList<NetifRingCaptureWorker *> m_workers;
+
+    friend class NetifRingCaptureWorker;
+};
+
+class NetifRingCaptureWorker : public QThread
+{
+public:
+    explicit NetifRingCaptureWorker(NetifRingCapture *capture);
+    ~NetifRingCaptureWorker() override;
+
+    /**
+     * @brief Create packet socket, attach filter, map rx ring & bind to all interfaces
+     * @param fanoutGroup Fanout group id, -1 to not join any group
+     */
+    bool open(int blockSize, int blockCount, int fanoutGroup);
+    void close();
+
+    inline void requestQuit() { m_quitRequested.store(true); }
+
+protected:
+    void run() override;
+
+private:
+    /**
+     * @brief Feed kernel drops since last call to the sampler
+     */
+    void updateSampling();
+
+    NetifRingCapture *m_capture;
+    int m_fd {-1};
+    uint8_t *m_ring {};
+    size_t m_ringSize {};
+    int m_blockSize {};
+    int m_blockCount {};
+    // packet records handed to monitor
+    std::shared_ptr<PacketRecordRing> m_records;
+    PacketSampler m_sampler;
+    std::atomic_bool m_quitRequested {false};
+};
+
+} // namespace system
+} // namespace core
+
+#endif // NETIF_RING_CAPTURE_H
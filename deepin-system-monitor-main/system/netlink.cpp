@@ -11,14 +11,53 @@
 #include <QDebug>
 
 #include <netlink/netlink.h>
+#include <netlink/msg.h>
+#include <netlink/attr.h>
 #include <netlink/route/link.h>
 #include <netlink/route/addr.h>
 #include <netlink/cache.h>
+
+#include <linux/rtnetlink.h>
+
+#include <stdlib.h>
+#include <string.h>
 using namespace DDLog;
 namespace core {
 namespace system {
 
+namespace {
+
+// RTM_NEWSTATS reply => ifindex & 64bit link counters
+int parseLinkStats(struct nl_msg *msg, void *arg)
+{
+    auto *stats = static_cast<LinkStatsMap *>(arg);
+    struct nlmsghdr *nlh = nlmsg_hdr(msg);
+    if (nlh->nlmsg_type != RTM_NEWSTATS)
+        return NL_SKIP;
+
+    struct nlattr *tb[IFLA_STATS_MAX + 1];
+    if (nlmsg_parse(nlh, sizeof(struct if_stats_msg), tb, IFLA_STATS_MAX, nullptr) < 0)
+        return NL_SKIP;
+
+    auto *ifsm = static_cast<struct if_stats_msg *>(nlmsg_data(nlh));
+    struct nlattr *attr = tb[IFLA_STATS_LINK_64];
+    if (attr && nla_len(attr) >= int(sizeof(struct rtnl_link_stats64))) {
+        struct rtnl_link_stats64 link64;
+        memcpy(&link64, nla_data(attr), sizeof(link64));
+        stats->insert(int(ifsm->ifindex), link64);
+    }
+    return NL_OK;
+}
+
+} // namespace
+
 Netlink::Netlink()
+    : m_sock(nullptr)
+    , m_linkCache(nullptr)
+    , m_addrCache(nullptr)
+    , m_eventSock(nullptr)
+    , m_statsCb(nullptr)
+    , m_statsSupported(true)
 {
     qCDebug(app) << "Creating Netlink object";
     int rc = 0;
@@ -54,8 +93,29 @@ Netlink::Netlink()
         m_linkCache = nullptr;
         nl_socket_free(m_sock);
         m_sock = nullptr;
+        return;
     }
     qCDebug(app) << "Netlink address cache allocated";
+
+    m_statsCb = nl_cb_alloc(NL_CB_DEFAULT);
+    if (!m_statsCb)
+        qCWarning(app) << "Failed to allocate netlink callback, link stats from link cache";
+
+    // notifications only tell us something changed, the caches are refilled on demand
+    m_eventSock = nl_socket_alloc();
+    if (m_eventSock) {
+        nl_socket_disable_seq_check(m_eventSock);
+        rc = nl_connect(m_eventSock, NETLINK_ROUTE);
+        if (!rc)
+            rc = nl_socket_add_memberships(m_eventSock, RTNLGRP_LINK, RTNLGRP_IPV4_IFADDR, RTNLGRP_IPV6_IFADDR, 0);
+        if (!rc)
+            rc = nl_socket_set_nonblocking(m_eventSock);
+        if (rc) {
+            qCWarning(app) << "Failed to subscribe link & address notifications:" << nl_geterror(rc);
+            nl_socket_free(m_eventSock);
+            m_eventSock = nullptr;
+        }
+    }
 }
 
 Netlink::~Netlink()
@@ -67,6 +127,10 @@ Netlink::~Netlink()
         nl_cache_free(m_addrCache);
     if (m_sock)
         nl_socket_free(m_sock);
+    if (m_eventSock)
+        nl_socket_free(m_eventSock);
+    if (m_statsCb)
+        nl_cb_put(m_statsCb);
     qCDebug(app) << "Netlink resources freed";
 }
 
@@ -84,5 +148,86 @@ AddrIterator Netlink::addrIterator()
     return it;
 }
 
+bool Netlink::readEvents()
+{
+    if (!m_eventSock)
+        return false;
+
+    bool changed = false;
+    struct sockaddr_nl peer;
+    unsigned char *buf = nullptr;
+    int n;
+    while ((n = nl_recv(m_eventSock, &peer, &buf, nullptr)) > 0) {
+        free(buf);
+        buf = nullptr;
+        changed = true;
+    }
+    // socket buffer overrun, notifications are lost
+    if (n < 0 && n != -NLE_AGAIN) {
+        qCDebug(app) << "Reading netlink notifications failed:" << nl_geterror(n);
+        changed = true;
+    }
+    return changed;
+}
+
+bool Netlink::linkStats(LinkStatsMap &stats)
+{
+    stats.clear();
+    if (m_statsSupported && m_statsCb) {
+        if (dumpLinkStats(stats))
+            return true;
+
+        qCInfo(app) << "RTM_GETSTATS not available, read link stats from link cache";
+        m_statsSupported = false;
+        stats.clear();
+    }
+
+    LinkIterator iter = linkIterator();
+    while (iter.hasNext()) {
+        auto link = iter.next();
+        struct rtnl_link_stats64 link64 {};
+        link64.rx_packets = link->rx_packets();
+        link64.rx_bytes = link->rx_bytes();
+        link64.rx_errors = link->rx_errors();
+        link64.rx_dropped = link->rx_dropped();
+        link64.rx_fifo_errors = link->rx_fifo();
+        link64.rx_frame_errors = link->rx_frame();
+        link64.tx_packets = link->tx_packets();
+        link64.tx_bytes = link->tx_bytes();
+        link64.tx_errors = link->tx_errors();
+        link64.tx_dropped = link->tx_dropped();
+        link64.tx_fifo_errors = link->tx_fifo();
+        link64.tx_carrier_errors = link->tx_carrier();
+        link64.collisions = link->collisions();
+        stats.insert(link->ifindex(), link64);
+    }
+    return !stats.isEmpty();
+}
+
+bool Netlink::dumpLinkStats(LinkStatsMap &stats)
+{
+    if (!m_sock)
+        return false;
+
+    struct if_stats_msg ifsm;
+    memset(&ifsm, 0, sizeof(ifsm));
+    ifsm.family = AF_UNSPEC;
+    ifsm.filter_mask = IFLA_STATS_FILTER_BIT(IFLA_STATS_LINK_64);
+
+    int rc = nl_send_simple(m_sock, RTM_GETSTATS, NLM_F_DUMP, &ifsm, sizeof(ifsm));
+    if (rc < 0) {
+        qCWarning(app) << "Failed to request link stats:" << nl_geterror(rc);
+        return false;
+    }
+
+    nl_cb_set(m_statsCb, NL_CB_VALID, NL_CB_CUSTOM, parseLinkStats, &stats);
+    rc = nl_recvmsgs(m_sock, m_statsCb);
+    if (rc < 0) {
+        qCWarning(app) << "Failed to receive link stats:" << nl_geterror(rc);
+        return false;
+    }
+    return true;
+}
+
 }   // namespace system
 }   // namespace core
@@ -11,14 +11,18 @@
 
 #include <QtGlobal>
 #include <QList>
+#include <QHash>
 
 #include <netlink/socket.h>
 #include <netlink/cache.h>
 
+#include <linux/if_link.h>
+
 #include <memory>
 
 struct nl_cache;
 struct nl_link;
+struct nl_cb;
 
 namespace core {
 namespace system {
@@ -85,6 +89,8 @@ private:
 using LinkIterator = CacheIterator<NLLink, struct rtnl_link>;
 using AddrIterator = CacheIterator<NLAddr, struct rtnl_addr>;
 
+using LinkStatsMap = QHash<int, struct rtnl_link_stats64>;
+
 class Netlink
 {
 public:
@@ -94,12 +100,44 @@ public:
     LinkIterator linkIterator();
     AddrIterator addrIterator();
 
+    /**
+     * @brief Drain pending link & address notifications without blocking
+     * @return true if links or addresses changed since last call (or notifications were lost)
+     */
+    bool readEvents();
+    /**
+     * @brief Whether link & address changes are notified, otherwise caller has to poll
+     */
+    bool hasEventSocket() const;
+
+    /**
+     * @brief Counters of all links, keyed by ifindex
+     *
+     * Fetched with a single RTM_GETSTATS dump, falls back to refilling the link cache on
+     * kernels without RTM_GETSTATS (< 4.7).
+     * @return false if counters can't be read
+     */
+    bool linkStats(LinkStatsMap &stats);
+
+private:
+    bool dumpLinkStats(LinkStatsMap &stats);
+
 private:
     nl_sock *m_sock;
     nl_cache *m_linkCache;
     nl_cache *m_addrCache;
+
+    // subscribed to RTNLGRP_LINK, RTNLGRP_IPV4_IFADDR & RTNLGRP_IPV6_IFADDR
+    nl_sock *m_eventSock;
+    nl_cb *m_statsCb;
+    bool m_statsSupported;
 };
 
+inline bool Netlink::hasEventSocket() const
+{
+    return m_eventSock != nullptr;
+}
+
 } // namespace system
 } // namespace core
 
@@ -6,12 +6,16 @@
 #ifndef PACKET_H
 #define PACKET_H
 
+#include <QHash>
 #include <QQueue>
 #include <QSharedPointer>
 
+#include "common/spsc_ring.h"
+
 #include <memory>
 
 #include <pcap.h>
+#include <string.h>
 #include <time.h>
 #include <netinet/in.h>
 
@@ -41,7 +45,33 @@ struct packet_payload_t {
     } d_addr;
 
     uint16_t d_port;
-    unsigned long long payload;
+    unsigned long long payload; // l4 payload bytes
+    unsigned long long wire_len; // bytes on the wire incl. l2-l4 headers of every segment
+};
+// l2-l4 headers of a captured frame, a view into its bytes returned on the stack
+struct packet_headers_t {
+    const u_char *s_addr {}; // in_addr or in6_addr by sa_family, inside the frame & unaligned
+    const u_char *d_addr {};
+    int sa_family {}; // 0 if the frame isn't tcp/udp over ip or not captured far enough
+    uint8_t proto {};
+    uint8_t vlans {}; // 802.1Q/802.1ad tags in front of the ip header
+    uint16_t s_port {};
+    uint16_t d_port {};
+    uint16_t l4_off {}; // from the start of the frame, past vlan tags & ipv6 extension headers
+    uint16_t l4_hdr_len {};
+    unsigned long long payload {}; // l4 payload bytes, from the wire length
+
+    inline bool valid() const
+    {
+        return sa_family != 0;
+    }
+};
+// fixed size record handed from capture threads to the monitor, no allocation per packet
+struct packet_record_t {
+    ino_t ino;
+    unsigned long long bytes; // wire bytes
+    packet_direction direction;
+    uint weight {1}; // packets this record stands for, above 1 while capture is sampling
 };
 struct net_ifaddr_t {
     char iface[16]; // interface name
@@ -73,10 +103,97 @@ struct sock_stat_t {
     uid_t   uid;              // socket uid
 };
 
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+using qhash_result_t = uint;
+#else
+using qhash_result_t = size_t;
+#endif
+
+// binary address key, ipv4 address lives in addr[0] & the rest words are zero
+struct addr_key_t {
+    uint32_t family;
+    uint32_t addr[4];
+};
+
+// binary src:sport-dest:dport key that matches kernel sock stat table,
+// laid out without padding so it can be compared & hashed word by word
+struct flow_key_t {
+    uint16_t family;
+    uint16_t s_port;
+    uint16_t d_port;
+    uint16_t reserved; // always 0
+    uint32_t s_addr[4];
+    uint32_t d_addr[4];
+};
+
+inline void fillAddrWords(int family, const void *addr, uint32_t words[4])
+{
+    words[0] = words[1] = words[2] = words[3] = 0;
+    memcpy(words, addr, family == AF_INET6 ? sizeof(in6_addr) : sizeof(in_addr));
+}
+
+inline addr_key_t makeAddrKey(int family, const void *addr)
+{
+    addr_key_t key;
+    key.family = uint32_t(family);
+    fillAddrWords(family, addr, key.addr);
+    return key;
+}
+
+inline flow_key_t makeFlowKey(int family, const void *saddr, uint sport, const void *daddr, uint dport)
+{
+    flow_key_t key;
+    key.family = uint16_t(family);
+    key.s_port = uint16_t(sport);
+    key.d_port = uint16_t(dport);
+    key.reserved = 0;
+    fillAddrWords(family, saddr, key.s_addr);
+    fillAddrWords(family, daddr, key.d_addr);
+    return key;
+}
+
+inline bool operator==(const addr_key_t &a, const addr_key_t &b)
+{
+    return memcmp(&a, &b, sizeof(addr_key_t)) == 0;
+}
+
+inline bool operator==(const flow_key_t &a, const flow_key_t &b)
+{
+    return memcmp(&a, &b, sizeof(flow_key_t)) == 0;
+}
+
+// murmur3 64bit finalizer
+inline uint64_t mix64(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+inline qhash_result_t qHash(const addr_key_t &key, qhash_result_t seed = 0)
+{
+    uint64_t h = seed ^ key.family;
+    h = mix64(h ^ ((uint64_t(key.addr[0]) << 32) | key.addr[1]));
+    h = mix64(h ^ ((uint64_t(key.addr[2]) << 32) | key.addr[3]));
+    return qhash_result_t(h);
+}
+
+inline qhash_result_t qHash(const flow_key_t &key, qhash_result_t seed = 0)
+{
+    uint64_t h = seed ^ ((uint64_t(key.family) << 32) | (uint64_t(key.s_port) << 16) | key.d_port);
+    for (int i = 0; i < 4; ++i)
+        h = mix64(h ^ ((uint64_t(key.s_addr[i]) << 32) | key.d_addr[i]));
+    return qhash_result_t(h);
+}
+
 using PacketPayload      = QSharedPointer<struct packet_payload_t>;
 using PacketPayloadQueue = QQueue<PacketPayload>;
+using PacketRecordRing   = common::core::SPSCRing<struct packet_record_t>; // one per capture thread
 using SockStat      = QSharedPointer<struct sock_stat_t>;
-using SockStatMap   = QMultiMap<uint64_t, SockStat>; // [hash, SockStat]
+using SockStatMap   = QMultiHash<flow_key_t, SockStat>; // [flow key, SockStat]
 using NetIFAddr     = QSharedPointer<struct net_ifaddr_t>;
 using NetIFAddrsMap = QMultiMap<QString, NetIFAddr>;
 
@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "packet_sampler.h"
+#include "ddlog.h"
+
+using namespace DDLog;
+
+namespace core {
+namespace system {
+
+PacketSampler::PacketSampler(uint threshold)
+    : m_threshold(threshold)
+{
+    m_clock.start();
+}
+
+bool PacketSampler::update(qulonglong drops, qint64 msecs)
+{
+    if (msecs <= 0)
+        return false;
+
+    qulonglong pps = m_packets * 1000 / qulonglong(msecs);
+    m_packets = 0;
+    if (m_threshold == 0)
+        return false;
+
+    // smallest power of two rate keeping classified packets under threshold
+    uint target = 1;
+    while (target < PACKET_SAMPLING_MAX_RATE && pps / target > m_threshold)
+        target <<= 1;
+    // kernel dropped packets, classifying is still too slow at current rate
+    if (drops > 0)
+        target = qMax(target, qMin(m_rate << 1, uint(PACKET_SAMPLING_MAX_RATE)));
+
+    uint rate = m_rate;
+    if (target > m_rate) {
+        rate = target;
+    } else if (target < m_rate && pps * 4 <= qulonglong(m_threshold) * (m_rate >> 1) * 3) {
+        // step down only with headroom left at the lower rate, so rate does not flap at threshold
+        rate = m_rate >> 1;
+    }
+    if (rate == m_rate)
+        return false;
+
+    qCInfo(app) << "Packet sampling rate changed from" << m_rate << "to" << rate
+                << "packets per second:" << pps << "drops:" << drops;
+    m_rate = rate;
+    m_skipped = 0;
+    return true;
+}
+
+} // namespace system
+} // namespace core
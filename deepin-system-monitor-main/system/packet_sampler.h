@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PACKET_SAMPLER_H
+#define PACKET_SAMPLER_H
+
+#include <QElapsedTimer>
+
+#define PACKET_SAMPLING_WINDOW 1000   // rate measurement window (ms)
+#define PACKET_SAMPLING_MAX_RATE 64   // sample at least 1 in 64 packets
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Adaptive 1-in-N packet sampler of a single capture thread
+ *
+ * Every captured packet is counted, only 1 in rate() packets is classified, the record of a
+ * sampled packet stands for rate() packets. Once per window the arrival rate & kernel drops
+ * decide the rate: it goes up right away when the thread falls behind (packets per second
+ * above threshold or drops), it goes down one step at a time once traffic calmed down.
+ */
+class PacketSampler
+{
+public:
+    /**
+     * @param threshold Packets per second classified before sampling starts, 0 never samples
+     */
+    explicit PacketSampler(uint threshold = 0);
+
+    /**
+     * @brief Count a captured packet
+     * @return true if packet should be classified
+     */
+    inline bool take()
+    {
+        ++m_packets;
+        if (m_rate == 1)
+            return true;
+        if (++m_skipped < m_rate)
+            return false;
+        m_skipped = 0;
+        return true;
+    }
+
+    /**
+     * @brief Measurement window passed, call update() then
+     */
+    inline bool due() const { return m_clock.hasExpired(PACKET_SAMPLING_WINDOW); }
+    /**
+     * @brief Close measurement window
+     * @param drops Packets dropped by kernel during window
+     * @return true if sampling rate changed
+     */
+    inline bool update(qulonglong drops) { return update(drops, m_clock.restart()); }
+    bool update(qulonglong drops, qint64 msecs);
+
+    inline uint rate() const { return m_rate; }
+    inline uint threshold() const { return m_threshold; }
+
+private:
+    uint m_threshold;
+    uint m_rate {1};
+    uint m_skipped {};
+    qulonglong m_packets {};
+    QElapsedTimer m_clock;
+};
+
+} // namespace system
+} // namespace core
+
+#endif // PACKET_SAMPLER_H
@@ -43,6 +43,19 @@ public:
         , read_merged{0}
         , write_merged{0}
         , discard_sector{0}
+        , read_ticks {0}
+        , write_ticks {0}
+        , discard_ios {0}
+        , discard_ticks {0}
+        , io_ticks {0}
+        , time_in_queue {0}
+        , r_await {.0}
+        , w_await {.0}
+        , await {.0}
+        , svctm {.0}
+        , aqu_sz {.0}
+        , in_flight {0}
+        , discard_speed {0}
         , _time_Sec{ QDateTime::currentSecsSinceEpoch() }
     {
     }
@@ -72,6 +85,19 @@ public:
         , read_merged{other.read_merged}
         , write_merged{other.write_merged}
         , discard_sector{other.discard_sector}
+        , read_ticks {other.read_ticks}
+        , write_ticks {other.write_ticks}
+        , discard_ios {other.discard_ios}
+        , discard_ticks {other.discard_ticks}
+        , io_ticks {other.io_ticks}
+        , time_in_queue {other.time_in_queue}
+        , r_await {other.r_await}
+        , w_await {other.w_await}
+        , await {other.await}
+        , svctm {other.svctm}
+        , aqu_sz {other.aqu_sz}
+        , in_flight {other.in_flight}
+        , discard_speed {other.discard_speed}
         , _time_Sec{other._time_Sec}
     {
     }
@@ -89,7 +115,7 @@ private:
     double rrqm_ps; // read requests merged per second 3合并读完成次数/ 时间间隔                   1
     double p_rrqm; // percentage of read requests merged together  4-合并读完成次数/读完成次数 % ?
 
-    double p_util; // bandwidth utilization for the device 5- ??????   ?
+    double p_util; // percentage of time the device was busy, io_ticks / interval
     unsigned long long tps; // transfers per second 读完成的次数 + 写完成次数
     unsigned long long blk_wrtn; // total number of blocks written  写扇区此数                   1
     unsigned long long bytes_wrtn; // total number of bytes read 写扇区此数 *512
@@ -104,6 +130,21 @@ private:
     unsigned long long write_merged; // 合并写完成次数
     quint64            discard_sector; // 放弃的扇区
 
+    unsigned long long read_ticks; // time spent reading (ms)
+    unsigned long long write_ticks; // time spent writing (ms)
+    unsigned long long discard_ios; // discards completed
+    unsigned long long discard_ticks; // time spent discarding (ms)
+    unsigned long long io_ticks; // time the device had io in flight (ms)
+    unsigned long long time_in_queue; // weighted time spent doing io (ms)
+
+    double r_await; // average read request time, incl. queueing (ms)
+    double w_await; // average write request time, incl. queueing (ms)
+    double await; // average request time of reads, writes & discards (ms)
+    double svctm; // average service time (ms)
+    double aqu_sz; // average queue depth
+    unsigned long long in_flight; // requests in flight right now
+    unsigned long long discard_speed; // discarded bytes per second
+
     qint64 _time_Sec;   //记录的时间
 
     friend class BlockDevice;
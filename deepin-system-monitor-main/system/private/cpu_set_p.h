@@ -7,9 +7,15 @@
 #define CPU_SET_P_H
 
 #include "system/cpu.h"
+#include "common/core_usage.h"
+#include "common/core_freq_reader.h"
 
 #include <QSharedData>
 #include <QMap>
+#include <QVector>
+
+#include <memory>
+#include <vector>
 
 namespace core {
 namespace system {
@@ -39,10 +45,21 @@ public:
         , m_virtualization {}
         , m_stat {std::make_shared<cpu_stat_t>()}
         , m_usage {std::make_shared<cpu_usage_t>()}
-        , m_statDB {}
-        , m_usageDB {}
+        , m_cpuIds {}
+        , m_cpuNames {}
+        , m_cpuJiffies {}
+        , m_coreUsage {}
+        , m_schedStat {}
+        , m_schedTime {0, 0}
+        , m_coreRunQueue {}
         , m_info {}
         , m_infos {}
+        , m_freqCpus {}
+        , m_numaNodes {}
+        , m_freqReader {}
+        , m_coreFreq {}
+        , m_throttleCount {}
+        , m_hasThrottleCounters {false}
     {
 
     }
@@ -61,20 +78,22 @@ public:
         , m_virtualization(other.m_virtualization)
         , m_stat(std::make_shared<cpu_stat_t>(*(other.m_stat)))
         , m_usage(std::make_shared<cpu_usage_t>(*(other.m_usage)))
+        , m_cpuIds(other.m_cpuIds)
+        , m_cpuNames(other.m_cpuNames)
+        , m_cpuJiffies {other.m_cpuJiffies[kLastStat], other.m_cpuJiffies[kCurrentStat]}
+        , m_coreUsage(other.m_coreUsage)
+        , cpusageTotal {other.cpusageTotal[kLastStat], other.cpusageTotal[kCurrentStat]}
+        , m_schedStat {other.m_schedStat[kLastStat], other.m_schedStat[kCurrentStat]}
+        , m_schedTime {other.m_schedTime[kLastStat], other.m_schedTime[kCurrentStat]}
+        , m_coreRunQueue(other.m_coreRunQueue)
         , m_info(other.m_info)
+        , m_freqCpus(other.m_freqCpus)
+        , m_numaNodes(other.m_numaNodes)
+        , m_freqReader(other.m_freqReader)
+        , m_coreFreq(other.m_coreFreq)
+        , m_throttleCount {other.m_throttleCount[kLastStat], other.m_throttleCount[kCurrentStat]}
+        , m_hasThrottleCounters(other.m_hasThrottleCounters)
     {
-        for (auto &stat : other.m_statDB) {
-            if (stat) {
-                auto cp = std::make_shared<cpu_stat_t>(*stat);
-                m_statDB[stat->cpu] = cp;
-            }
-        }
-        for (auto &usage : other.m_usageDB) {
-            if (usage) {
-                auto cp = std::make_shared<cpu_usage_t>(*usage);
-                m_usageDB[usage->cpu] = cp;
-            }
-        }
         for (auto &info : other.m_infos) {
             CPUInfo cp(info);
             m_infos << cp;
@@ -97,14 +116,31 @@ private:
     CPUStat m_stat; // overall stat
     CPUUsage m_usage; // overall usage
 
-    QMap<QByteArray, CPUStat> m_statDB; // per cpu stat
-    QMap<QByteArray, CPUUsage> m_usageDB; // per cpu usage
+    // per cpu stat & usage as struct of arrays indexed by cpu id, jiffies double buffered for deltas
+    QVector<int> m_cpuIds; // ids of cpus in last stat read, ascending
+    QVector<QByteArray> m_cpuNames;
+    common::usage::CoreJiffies m_cpuJiffies[kStatCount];
+    common::usage::CoreUsage m_coreUsage;
 
     qulonglong cpusageTotal[kStatCount] = {0, 0};
+
+    // per core schedstat counters double buffered like the jiffies, monotonic ns of each read
+    common::usage::CoreSchedStat m_schedStat[kStatCount];
+    qint64 m_schedTime[kStatCount];
+    common::usage::CoreRunQueue m_coreRunQueue;
     friend class CPUSet;
 
     QMap<QString, QString> m_info;   //overall info
     QList<CPUInfo> m_infos;         //per cpu info
+    QVector<int> m_freqCpus;        //logical ids of cpus with a sampled scaling_cur_freq
+    QMap<int, QVector<int>> m_numaNodes; //logical ids of cpus by numa node, from lscpu
+
+    // per core frequency & throttle counters indexed by cpu id, files are kept open by the
+    // sampling instance, snapshot copies only share the reader
+    std::shared_ptr<common::parser::CoreFreqReader> m_freqReader;
+    std::vector<unsigned long long> m_coreFreq; // kHz, 0 if unknown
+    std::vector<unsigned long long> m_throttleCount[kStatCount];
+    bool m_hasThrottleCounters;
 };
 
 } // namespace system
@@ -35,6 +35,9 @@ public:
         , uptime {timeval {0, 0}}
         , btime {timeval {0, 0}}
         , loadAvg {}
+        , runDelay {0}
+        , runDelayTime {0}
+        , runQueueWait {-1}
         , user_name {}
         , group_name {}
         , effective_user_name {}
@@ -56,6 +59,9 @@ public:
         , uptime(other.uptime)
         , btime(other.btime)
         , loadAvg(other.loadAvg)
+        , runDelay(other.runDelay)
+        , runDelayTime(other.runDelayTime)
+        , runQueueWait(other.runQueueWait)
         , user_name(other.user_name)
         , group_name(other.group_name)
         , effective_user_name(other.effective_user_name)
@@ -80,6 +86,9 @@ private:
     struct timeval uptime; // up time
     struct timeval btime; // boot time
     LoadAvg loadAvg; // load avg.
+    qulonglong runDelay; // run queue wait of all cpus, ns
+    qint64 runDelayTime; // monotonic time runDelay was read at, ns
+    qreal runQueueWait; // run queue wait of the last interval in % of cpu time, -1 if unknown
 
     QByteArray user_name; // real user name
     QByteArray group_name; // real group name
@@ -0,0 +1,176 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "proc_connector.h"
+#include "ddlog.h"
+
+#include <QDebug>
+
+#include <netlink/netlink.h>
+#include <netlink/socket.h>
+#include <netlink/msg.h>
+
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+
+#include <stdlib.h>
+
+using namespace DDLog;
+
+// bursts of fork/exit between two ticks must fit, lost events force a full rescan
+const int kRecvBufferSize = 1024 * 1024;
+
+// proc_event::what values, the enum moved out of proc_event in newer kernel headers
+const unsigned int kProcEventNone = 0x00000000;
+const unsigned int kProcEventFork = 0x00000001;
+const unsigned int kProcEventExit = 0x80000000;
+
+namespace core {
+namespace system {
+
+ProcConnector::ProcConnector()
+    : m_sock(nullptr)
+    , m_active(false)
+{
+    qCDebug(app) << "Creating proc connector";
+    int rc = 0;
+    m_sock = nl_socket_alloc();
+    if (!m_sock) {
+        qCWarning(app) << "Failed to allocate proc connector socket";
+        return;
+    }
+    // events are unsolicited multicast messages
+    nl_socket_disable_seq_check(m_sock);
+
+    rc = nl_connect(m_sock, NETLINK_CONNECTOR);
+    if (rc) {
+        qCWarning(app) << "Failed to connect proc connector socket:" << nl_geterror(rc);
+        nl_socket_free(m_sock);
+        m_sock = nullptr;
+        return;
+    }
+
+    // joining proc connector group requires CAP_NET_ADMIN
+    rc = nl_socket_add_membership(m_sock, CN_IDX_PROC);
+    if (rc) {
+        qCInfo(app) << "Proc connector not available, fall back to /proc scanning:" << nl_geterror(rc);
+        nl_socket_free(m_sock);
+        m_sock = nullptr;
+        return;
+    }
+    nl_socket_set_nonblocking(m_sock);
+    nl_socket_set_buffer_size(m_sock, kRecvBufferSize, 0);
+
+    if (!subscribe(true)) {
+        nl_socket_free(m_sock);
+        m_sock = nullptr;
+        return;
+    }
+    m_active = true;
+
+    // kernel acks subscription synchronously, pick up the verdict right away,
+    // events received before the first full scan don't matter
+    QSet<pid_t> pids;
+    poll(pids);
+    qCInfo(app) << "Proc connector active:" << m_active;
+}
+
+ProcConnector::~ProcConnector()
+{
+    if (m_active)
+        subscribe(false);
+    if (m_sock)
+        nl_socket_free(m_sock);
+}
+
+bool ProcConnector::subscribe(bool enable)
+{
+    alignas(struct cn_msg) char buf[sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op)] {};
+    auto *msg = reinterpret_cast<struct cn_msg *>(buf);
+    msg->id.idx = CN_IDX_PROC;
+    msg->id.val = CN_VAL_PROC;
+    msg->len = sizeof(enum proc_cn_mcast_op);
+    auto *op = reinterpret_cast<enum proc_cn_mcast_op *>(buf + sizeof(struct cn_msg));
+    *op = enable ? PROC_CN_MCAST_LISTEN : PROC_CN_MCAST_IGNORE;
+
+    int rc = nl_send_simple(m_sock, NLMSG_DONE, 0, buf, sizeof(buf));
+    if (rc < 0) {
+        qCWarning(app) << "Failed to send proc connector subscription:" << nl_geterror(rc);
+        return false;
+    }
+    return true;
+}
+
+bool ProcConnector::poll(QSet<pid_t> &pids)
+{
+    if (!m_active)
+        return false;
+
+    bool intact = true;
+    struct sockaddr_nl nla {};
+    unsigned char *buf = nullptr;
+    int n;
+
+    while ((n = nl_recv(m_sock, &nla, &buf, nullptr)) > 0) {
+        // only trust messages from kernel
+        if (nla.nl_pid == 0) {
+            int len = n;
+            auto *hdr = reinterpret_cast<struct nlmsghdr *>(buf);
+            for (; nlmsg_ok(hdr, len); hdr = nlmsg_next(hdr, &len)) {
+                if (!handleMessage(hdr, pids))
+                    intact = false;
+            }
+        }
+        free(buf);
+        buf = nullptr;
+    }
+
+    if (n < 0 && n != -NLE_AGAIN) {
+        // NLE_NOMEM here means the receive buffer overflowed (ENOBUFS) & events were dropped
+        qCWarning(app) << "Proc connector receive failed:" << nl_geterror(n);
+        intact = false;
+    }
+
+    return intact && m_active;
+}
+
+bool ProcConnector::handleMessage(const struct nlmsghdr *hdr, QSet<pid_t> &pids)
+{
+    if (hdr->nlmsg_type != NLMSG_DONE)
+        return true;
+    if (nlmsg_datalen(hdr) < int(sizeof(struct cn_msg) + sizeof(struct proc_event)))
+        return true;
+
+    auto *msg = static_cast<const struct cn_msg *>(nlmsg_data(hdr));
+    if (msg->id.idx != CN_IDX_PROC || msg->id.val != CN_VAL_PROC)
+        return true;
+
+    auto *ev = reinterpret_cast<const struct proc_event *>(msg->data);
+    switch (static_cast<unsigned int>(ev->what)) {
+    case kProcEventNone:
+        // subscription ack
+        if (ev->event_data.ack.err != 0) {
+            qCInfo(app) << "Proc connector subscription rejected, error:" << ev->event_data.ack.err;
+            m_active = false;
+            return false;
+        }
+        break;
+    case kProcEventFork:
+        // threads share tgid with their group leader, only new processes matter
+        if (ev->event_data.fork.child_pid == ev->event_data.fork.child_tgid)
+            pids.insert(ev->event_data.fork.child_tgid);
+        break;
+    case kProcEventExit:
+        if (ev->event_data.exit.process_pid == ev->event_data.exit.process_tgid)
+            pids.remove(ev->event_data.exit.process_tgid);
+        break;
+    default:
+        break;
+    }
+
+    return true;
+}
+
+} // namespace system
+} // namespace core
@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROC_CONNECTOR_H
+#define PROC_CONNECTOR_H
+
+#include <QSet>
+
+#include <sys/types.h>
+
+struct nl_sock;
+struct nlmsghdr;
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Process lifecycle events from kernel proc connector (cn_proc)
+ *
+ * Subscribing needs CAP_NET_ADMIN, the source stays inactive otherwise and
+ * callers are expected to fall back to scanning /proc.
+ */
+class ProcConnector
+{
+public:
+    explicit ProcConnector();
+    ~ProcConnector();
+
+    /**
+     * @brief Whether kernel accepted our subscription
+     */
+    inline bool isActive() const
+    {
+        return m_active;
+    }
+
+    /**
+     * @brief Apply pending fork & exit events to pid set, never blocks
+     * @param pids Live process (thread group leader) set to be updated in place
+     * @return false if some events were lost (receive buffer overflow) or socket failed,
+     * pids must be rebuilt from a full /proc scan then
+     */
+    bool poll(QSet<pid_t> &pids);
+
+private:
+    Q_DISABLE_COPY(ProcConnector)
+
+    bool subscribe(bool enable);
+    // @return false if kernel rejected subscription
+    bool handleMessage(const struct nlmsghdr *hdr, QSet<pid_t> &pids);
+
+    struct nl_sock *m_sock;
+    bool m_active;
+};
+
+} // namespace system
+} // namespace core
+
+#endif // PROC_CONNECTOR_H
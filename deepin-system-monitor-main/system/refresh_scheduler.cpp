@@ -0,0 +1,196 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "refresh_scheduler.h"
+#include "ddlog.h"
+#include "common/scratch_arena.h"
+
+#include <QElapsedTimer>
+
+using namespace DDLog;
+
+namespace core {
+namespace system {
+
+RefreshScheduler::RefreshScheduler()
+    : m_producers {}
+    , m_throttled(false)
+{
+}
+
+int RefreshScheduler::addProducer(const QString &name, int periodMs, int budgetMs, const Job &job)
+{
+    m_producers.append({name, qMax(0, periodMs), qMax(0, budgetMs), job, {}, 0, 0, false, true});
+    return m_producers.size() - 1;
+}
+
+void RefreshScheduler::addDependency(int id, int dependency)
+{
+    if (id < 0 || id >= m_producers.size() || dependency < 0 || dependency >= id)
+        return;
+    m_producers[id].deps << dependency;
+}
+
+void RefreshScheduler::setPeriod(int id, int periodMs)
+{
+    if (id < 0 || id >= m_producers.size() || m_producers[id].period == 0 || periodMs <= 0)
+        return;
+
+    qCInfo(app) << "Producer" << m_producers[id].name << "period set to" << periodMs << "ms";
+    m_producers[id].period = periodMs;
+    m_producers[id].nextDue = 0;
+}
+
+void RefreshScheduler::setEnabled(int id, bool enabled)
+{
+    if (id < 0 || id >= m_producers.size() || m_producers[id].enabled == enabled)
+        return;
+
+    qCInfo(app) << "Producer" << m_producers[id].name << (enabled ? "enabled" : "disabled");
+    m_producers[id].enabled = enabled;
+    if (enabled)
+        m_producers[id].nextDue = 0;
+}
+
+bool RefreshScheduler::isEnabled(int id) const
+{
+    return m_producers[id].enabled;
+}
+
+void RefreshScheduler::wake(int id)
+{
+    if (id < 0 || id >= m_producers.size() || m_producers[id].period == 0)
+        return;
+    m_producers[id].nextDue = 0;
+}
+
+void RefreshScheduler::setThrottled(bool throttled)
+{
+    if (m_throttled == throttled)
+        return;
+
+    qCInfo(app) << "Refresh scheduler throttled:" << throttled;
+    m_throttled = throttled;
+    // refresh right away when coming back to foreground
+    if (!throttled) {
+        for (auto &producer : m_producers)
+            producer.nextDue = 0;
+    }
+}
+
+void RefreshScheduler::setPeriodScale(qreal scale)
+{
+    if (!(scale > 0) || qFuzzyCompare(scale, m_scale))
+        return;
+
+    qCInfo(app) << "Refresh periods scaled by" << scale;
+    m_scale = scale;
+    for (auto &producer : m_producers)
+        producer.nextDue = 0;
+}
+
+bool RefreshScheduler::isDue(int id, qint64 now) const
+{
+    const Producer &producer = m_producers[id];
+    if (!producer.enabled)
+        return false;
+    if (producer.period == 0)
+        return !producer.done;
+    return now + qRound(kDueSlack * m_scale) >= producer.nextDue;
+}
+
+int RefreshScheduler::effectivePeriod(int id) const
+{
+    return scaledPeriod(m_producers[id]);
+}
+
+int RefreshScheduler::scaledPeriod(const Producer &producer) const
+{
+    if (producer.period == 0)
+        return 0;
+    int period = qMax(1, qRound(producer.period * m_scale)) << producer.backoff;
+    return m_throttled ? period * kBackgroundFactor : period;
+}
+
+int RefreshScheduler::backoffLevel(int id) const
+{
+    return m_producers[id].backoff;
+}
+
+int RefreshScheduler::runDue(qint64 now)
+{
+    QVector<bool> due(m_producers.size());
+    for (int i = 0; i < m_producers.size(); ++i)
+        due[i] = isDue(i, now);
+    // dependencies are registered before their dependents
+    for (int i = m_producers.size() - 1; i >= 0; --i) {
+        if (!due[i])
+            continue;
+        for (int dep : m_producers[i].deps)
+            due[dep] = true;
+    }
+
+    int n = 0;
+    for (int i = 0; i < m_producers.size(); ++i) {
+        if (due[i]) {
+            run(m_producers[i], now);
+            ++n;
+        }
+    }
+    return n;
+}
+
+int RefreshScheduler::runAll(qint64 now)
+{
+    int n = 0;
+    for (auto &producer : m_producers) {
+        if (producer.enabled) {
+            run(producer, now);
+            ++n;
+        }
+    }
+    return n;
+}
+
+int RefreshScheduler::runPeriodic(qint64 now)
+{
+    int n = 0;
+    for (auto &producer : m_producers) {
+        if (producer.period > 0 && producer.enabled) {
+            run(producer, now);
+            ++n;
+        }
+    }
+    return n;
+}
+
+void RefreshScheduler::run(Producer &producer, qint64 now)
+{
+    QElapsedTimer timer;
+    timer.start();
+    producer.job();
+    qint64 cost = timer.elapsed();
+    // scratch of a producer never outlives its run
+    common::alloc::ScratchArena::local().reset();
+
+    producer.done = true;
+    if (producer.period == 0)
+        return;
+
+    if (cost > producer.budget) {
+        if (producer.backoff < kMaxBackoffLevel) {
+            ++producer.backoff;
+            qCInfo(app) << "Producer" << producer.name << "took" << cost << "ms, over budget of"
+                        << producer.budget << "ms, backing off to level" << producer.backoff;
+        }
+    } else if (producer.backoff > 0 && cost * 2 <= producer.budget) {
+        --producer.backoff;
+        qCDebug(app) << "Producer" << producer.name << "back within budget, level" << producer.backoff;
+    }
+
+    producer.nextDue = now + scaledPeriod(producer);
+}
+
+} // namespace system
+} // namespace core
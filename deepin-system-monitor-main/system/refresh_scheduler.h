@@ -0,0 +1,132 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef REFRESH_SCHEDULER_H
+#define REFRESH_SCHEDULER_H
+
+#include <QList>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Runs each metric producer on its own cadence off a shared base tick
+ *
+ * A producer that overran its cost budget gets its period doubled, up to kMaxBackoffLevel
+ * times, and recovers once it runs well within budget again. While throttled (e.g. main
+ * window minimized) every period is stretched by kBackgroundFactor. A disabled producer, e.g.
+ * one nothing on screen needs, is skipped until enabled again. Not thread safe, driven by the
+ * system monitor thread.
+ */
+class RefreshScheduler
+{
+public:
+    using Job = std::function<void()>;
+
+    explicit RefreshScheduler();
+
+    /**
+     * @brief Register a producer, producers due in the same cycle run in registration order
+     * @param name Producer name for logging
+     * @param periodMs Refresh period, 0 to run only once
+     * @param budgetMs Cost budget of a single run
+     * @param job Refresh job
+     * @return Producer id
+     */
+    int addProducer(const QString &name, int periodMs, int budgetMs, const Job &job);
+    /**
+     * @brief Run dependency in every cycle producer runs in, dependency must be registered first
+     */
+    void addDependency(int id, int dependency);
+    /**
+     * @brief Change the refresh period of a producer, it runs on the next tick with the new period
+     */
+    void setPeriod(int id, int periodMs);
+    /**
+     * @brief Skip a producer until enabled again, it is still run as a dependency of others
+     *
+     * An enabled producer is due at once, so data asked for again is fresh on the next tick.
+     */
+    void setEnabled(int id, bool enabled);
+    bool isEnabled(int id) const;
+    /**
+     * @brief Make a producer due now, it keeps its period from its next run
+     */
+    void wake(int id);
+
+    void setThrottled(bool throttled);
+    bool isThrottled() const;
+    /**
+     * @brief Stretch or shrink every period, e.g. 0.25 to run every 0.5s what is registered at 2s
+     *
+     * The due slack scales along with the base tick, which the caller is expected to scale the same.
+     * Every periodic producer is due at once & keeps the new period from there.
+     */
+    void setPeriodScale(qreal scale);
+    inline qreal periodScale() const { return m_scale; }
+
+    /**
+     * @brief Run producers due at now
+     * @param now Monotonic time in ms
+     * @return Number of producers run
+     */
+    int runDue(qint64 now);
+    /**
+     * @brief Run all enabled producers regardless of their schedule, once-only producers included
+     */
+    int runAll(qint64 now);
+    /**
+     * @brief Run enabled periodic producers now regardless of their schedule, they keep their period from here
+     */
+    int runPeriodic(qint64 now);
+
+    bool isDue(int id, qint64 now) const;
+    int effectivePeriod(int id) const;
+    int backoffLevel(int id) const;
+    int count() const;
+
+    static constexpr int kMaxBackoffLevel = 3;
+    static constexpr int kBackgroundFactor = 4;
+    // base tick timer is coarse, a producer within this much of its due time runs this tick
+    static constexpr int kDueSlack = 500;
+
+private:
+    struct Producer {
+        QString name;
+        int period;
+        int budget;
+        Job job;
+        QList<int> deps;
+        qint64 nextDue;
+        int backoff;
+        bool done;
+        bool enabled;
+    };
+
+    void run(Producer &producer, qint64 now);
+    int scaledPeriod(const Producer &producer) const;
+
+    QVector<Producer> m_producers;
+    bool m_throttled;
+    qreal m_scale {1.};
+};
+
+inline bool RefreshScheduler::isThrottled() const
+{
+    return m_throttled;
+}
+
+inline int RefreshScheduler::count() const
+{
+    return m_producers.size();
+}
+
+} // namespace system
+} // namespace core
+
+#endif // REFRESH_SCHEDULER_H
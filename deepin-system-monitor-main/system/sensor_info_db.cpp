@@ -0,0 +1,259 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "sensor_info_db.h"
+#include "ddlog.h"
+
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <libudev.h>
+
+using namespace DDLog;
+
+namespace core {
+namespace system {
+
+static int openAttribute(const QString &path)
+{
+    return open(path.toLocal8Bit().constData(), O_RDONLY | O_CLOEXEC);
+}
+
+// temperatures are signed millidegrees
+static bool readAttribute(int fd, qlonglong &value)
+{
+    if (fd < 0)
+        return false;
+    char buf[32];
+    ssize_t n;
+    errno = 0;
+    do {
+        n = pread(fd, buf, sizeof(buf) - 1, 0);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0)
+        return false;
+    buf[n] = '\0';
+    char *end = nullptr;
+    errno = 0;
+    long long v = strtoll(buf, &end, 10);
+    if (end == buf || errno != 0)
+        return false;
+    value = v;
+    return true;
+}
+
+static QString readText(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return QString::fromUtf8(file.readAll()).trimmed();
+}
+
+static qreal readOnce(const QString &path, qreal scale)
+{
+    int fd = openAttribute(path);
+    qlonglong value = 0;
+    bool ok = readAttribute(fd, value);
+    if (fd >= 0)
+        close(fd);
+    return ok ? value * scale : 0;
+}
+
+SensorInfoDB::SensorInfoDB(const QString &hwmonRoot, const QString &thermalRoot)
+    : m_hwmonRoot(hwmonRoot)
+    , m_thermalRoot(thermalRoot)
+    , m_enumerated(false)
+    , m_updates(0)
+    , m_udev()
+    , m_monitor(nullptr)
+{
+    if (m_udev.handle()) {
+        m_monitor = udev_monitor_new_from_netlink(m_udev.handle(), "udev");
+        if (m_monitor
+                && (udev_monitor_filter_add_match_subsystem_devtype(m_monitor, "hwmon", nullptr) < 0
+                    || udev_monitor_filter_add_match_subsystem_devtype(m_monitor, "thermal", nullptr) < 0
+                    || udev_monitor_enable_receiving(m_monitor) < 0)) {
+            udev_monitor_unref(m_monitor);
+            m_monitor = nullptr;
+        }
+    }
+    if (!m_monitor)
+        qCInfo(app) << "udev monitor not available, sensors are enumerated again every" << kRescanInterval << "updates";
+}
+
+SensorInfoDB::~SensorInfoDB()
+{
+    closeInputs();
+    if (m_monitor)
+        udev_monitor_unref(m_monitor);
+}
+
+bool SensorInfoDB::isCpuChip(const QString &chip)
+{
+    static const QStringList kCpuChips {"coretemp", "k10temp", "k8temp", "zenpower", "cpu_thermal", "x86_pkg_temp"};
+    return kCpuChips.contains(chip);
+}
+
+void SensorInfoDB::closeInputs()
+{
+    for (const input_t &input : m_inputs) {
+        if (input.fd >= 0)
+            close(input.fd);
+    }
+    m_inputs.clear();
+}
+
+void SensorInfoDB::enumerate()
+{
+    closeInputs();
+    m_enumerated = true;
+    m_updates = 0;
+
+    // hwmon0, hwmon1 ...
+    QStringList chips;
+    const QStringList hwmons = QDir(m_hwmonRoot).entryList({"hwmon*"}, QDir::Dirs | QDir::NoDotAndDotDot | QDir::System, QDir::Name);
+    for (const QString &name : hwmons) {
+        const QString dir = m_hwmonRoot + "/" + name;
+        // attributes of old drivers are below the device
+        const QString chip = readText(dir + "/name");
+        if (chip.isEmpty() && QFile::exists(dir + "/device/name"))
+            enumerateHwmon(dir + "/device");
+        else
+            enumerateHwmon(dir);
+        chips << (chip.isEmpty() ? readText(dir + "/device/name") : chip);
+    }
+
+    // zones of thermal drivers without a hwmon chip, e.g. on arm boards
+    const QStringList zones = QDir(m_thermalRoot).entryList({"thermal_zone*"}, QDir::Dirs | QDir::NoDotAndDotDot | QDir::System, QDir::Name);
+    for (const QString &name : zones)
+        enumerateThermal(m_thermalRoot + "/" + name, chips);
+
+    qCInfo(app) << "Sensors enumerated:" << m_inputs.size() << "inputs of" << chips.size() << "hwmon chips";
+}
+
+void SensorInfoDB::enumerateHwmon(const QString &dir)
+{
+    static const QRegularExpression kInput("^(temp|fan|power)(\\d+)_(input|average)$");
+    const QString chip = readText(dir + "/name");
+    const QStringList files = QDir(dir).entryList(QDir::Files | QDir::System, QDir::Name);
+    for (const QString &file : files) {
+        const QRegularExpressionMatch match = kInput.match(file);
+        if (!match.hasMatch())
+            continue;
+        const QString type = match.captured(1);
+        const QString prefix = type + match.captured(2);
+        // power*_average only where a driver has no power*_input
+        if (match.captured(3) == "average" && files.contains(prefix + "_input"))
+            continue;
+
+        input_t input {};
+        input.sensor.chip = chip;
+        input.sensor.label = readText(dir + "/" + prefix + "_label");
+        if (input.sensor.label.isEmpty())
+            input.sensor.label = prefix;
+        if (type == "temp") {
+            input.sensor.kind = sensor_t::kTemperature;
+            input.scale = 0.001;
+            input.sensor.critical = readOnce(dir + "/" + prefix + "_crit", input.scale);
+            if (input.sensor.critical <= 0)
+                input.sensor.critical = readOnce(dir + "/" + prefix + "_max", input.scale);
+            input.sensor.cpu = isCpuChip(chip);
+        } else if (type == "fan") {
+            input.sensor.kind = sensor_t::kFan;
+            input.scale = 1;
+        } else {
+            // microwatts
+            input.sensor.kind = sensor_t::kPower;
+            input.scale = 0.000001;
+        }
+        input.fd = openAttribute(dir + "/" + file);
+        if (input.fd < 0) {
+            qCDebug(app) << "Sensor input can't be opened:" << dir + "/" + file;
+            continue;
+        }
+        m_inputs << input;
+    }
+}
+
+void SensorInfoDB::enumerateThermal(const QString &dir, const QStringList &chips)
+{
+    const QString type = readText(dir + "/type");
+    if (type.isEmpty() || chips.contains(type))
+        return;
+
+    input_t input {};
+    input.sensor.chip = type;
+    input.sensor.label = QDir(dir).dirName();
+    input.sensor.kind = sensor_t::kTemperature;
+    input.sensor.cpu = isCpuChip(type);
+    input.scale = 0.001;
+    // temperature of the critical trip point
+    for (int i = 0; QFile::exists(dir + QString("/trip_point_%1_type").arg(i)); ++i) {
+        if (readText(dir + QString("/trip_point_%1_type").arg(i)) == "critical") {
+            input.sensor.critical = readOnce(dir + QString("/trip_point_%1_temp").arg(i), input.scale);
+            break;
+        }
+    }
+    input.fd = openAttribute(dir + "/temp");
+    if (input.fd >= 0)
+        m_inputs << input;
+}
+
+bool SensorInfoDB::pollMonitor()
+{
+    if (!m_monitor)
+        return false;
+
+    // monitor socket is non-blocking, receive returns null once drained
+    bool changed = false;
+    struct udev_device *dev;
+    while ((dev = udev_monitor_receive_device(m_monitor))) {
+        qCDebug(app) << "sensor udev event:" << udev_device_get_action(dev) << udev_device_get_sysname(dev);
+        udev_device_unref(dev);
+        changed = true;
+    }
+    return changed;
+}
+
+void SensorInfoDB::update()
+{
+    if (pollMonitor() || (!m_monitor && ++m_updates >= kRescanInterval))
+        m_enumerated = false;
+    if (!m_enumerated)
+        enumerate();
+
+    bool gone = false;
+    for (input_t &input : m_inputs) {
+        qlonglong value = 0;
+        input.valid = readAttribute(input.fd, value);
+        if (input.valid)
+            input.sensor.value = value * input.scale;
+        // device removed, powered down ones (e.g. a sleeping gpu) fail with other errors
+        else if (errno == ENODEV || errno == ENXIO)
+            gone = true;
+    }
+    // picked up on the next update
+    if (gone && !m_monitor)
+        m_enumerated = false;
+}
+
+QList<sensor_t> SensorInfoDB::sensors() const
+{
+    QList<sensor_t> sensors;
+    for (const input_t &input : m_inputs) {
+        if (input.valid)
+            sensors << input.sensor;
+    }
+    return sensors;
+}
+
+} // namespace system
+} // namespace core
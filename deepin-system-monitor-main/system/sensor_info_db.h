@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SENSOR_INFO_DB_H
+#define SENSOR_INFO_DB_H
+
+#include "udev.h"
+
+#include <QList>
+#include <QString>
+
+#define SYSFS_HWMON_PATH "/sys/class/hwmon"
+#define SYSFS_THERMAL_PATH "/sys/class/thermal"
+
+struct udev_monitor;
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Reading of a hardware sensor
+ */
+struct sensor_t {
+    enum Kind {
+        kTemperature = 0, // °C
+        kFan, // rpm
+        kPower, // W
+    };
+
+    QString chip; // hwmon name or thermal zone type, e.g. coretemp, acpitz
+    QString label; // e.g. Package id 0, temp1 without a label file
+    Kind kind {kTemperature};
+    qreal value {0};
+    qreal critical {0}; // crit or max temperature, 0 if unknown
+    bool cpu {false}; // sensor of the cpu, e.g. of coretemp or k10temp
+};
+
+/**
+ * @brief Temperatures, fans & power sensors of /sys/class/hwmon & thermal zones
+ *
+ * Sensors are enumerated once & their *_input files kept open & re-read with pread. Thermal
+ * zones also exported by a hwmon chip of the same name are skipped. Sensors are enumerated
+ * again on udev events of the hwmon & thermal subsystems, without a udev monitor (e.g. in a
+ * container) when a read fails & every kRescanInterval updates. Monitor thread only.
+ */
+class SensorInfoDB
+{
+public:
+    // updates between rescans without a udev monitor
+    static constexpr int kRescanInterval = 60;
+
+    explicit SensorInfoDB(const QString &hwmonRoot = SYSFS_HWMON_PATH, const QString &thermalRoot = SYSFS_THERMAL_PATH);
+    ~SensorInfoDB();
+
+    void update();
+    /**
+     * @brief Enumerate the sensors again on the next update
+     */
+    inline void rescan() { m_enumerated = false; }
+    QList<sensor_t> sensors() const;
+
+    /**
+     * @brief Whether \a chip is a cpu temperature driver
+     */
+    static bool isCpuChip(const QString &chip);
+
+private:
+    Q_DISABLE_COPY(SensorInfoDB)
+
+    struct input_t {
+        sensor_t sensor;
+        int fd; // *_input or thermal zone temp
+        qreal scale; // raw value to the unit of the kind
+        bool valid; // last read succeeded
+    };
+
+    void enumerate();
+    void enumerateHwmon(const QString &dir);
+    void enumerateThermal(const QString &dir, const QStringList &chips);
+    bool pollMonitor();
+    void closeInputs();
+
+    QString m_hwmonRoot;
+    QString m_thermalRoot;
+    bool m_enumerated;
+    int m_updates; // since the last enumeration
+    QList<input_t> m_inputs;
+    UDev m_udev;
+    struct udev_monitor *m_monitor;
+};
+
+} // namespace system
+} // namespace core
+
+#endif // SENSOR_INFO_DB_H
@@ -0,0 +1,511 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "sock_diag.h"
+#include "sys_info.h"
+#include "ddlog.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <linux/inet_diag.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/sock_diag.h>
+
+#define SOCK_TABLE_MIN_CAPACITY 1024   // initial slot count, power of two
+#define SOCK_DIAG_BUFFER_SIZE (32 << 10)   // netlink receive buffer
+
+// tcp states a socket with an inode can carry traffic in, listening sockets never match a flow
+#define SOCK_DIAG_TCP_STATES ((1u << TCP_ESTABLISHED) | (1u << TCP_SYN_SENT) | (1u << TCP_FIN_WAIT1) \
+                              | (1u << TCP_FIN_WAIT2) | (1u << TCP_CLOSE_WAIT) | (1u << TCP_LAST_ACK) \
+                              | (1u << TCP_CLOSING))
+// connected udp sockets are reported as established, unconnected ones have no remote end to match
+#define SOCK_DIAG_UDP_STATES (1u << TCP_ESTABLISHED)
+// listening, time wait & request sockets too, for the socket list
+#define SOCK_DIAG_ALL_STATES (~0u)
+// tcpi_segs_out of the kernel's tcp_info, past the end of the glibc struct
+#define TCP_INFO_SEGS_OUT_OFFSET 136
+
+using namespace DDLog;
+
+namespace core {
+namespace system {
+
+namespace {
+
+// attribute of a sock_diag message, nullptr if missing
+const struct rtattr *findDiagAttr(const struct nlmsghdr *nlh, unsigned short type)
+{
+    auto *diag = reinterpret_cast<const inet_diag_msg *>(NLMSG_DATA(nlh));
+    int len = int(nlh->nlmsg_len) - int(NLMSG_LENGTH(sizeof(*diag)));
+    auto *attr = reinterpret_cast<struct rtattr *>(const_cast<inet_diag_msg *>(diag) + 1);
+    for (; RTA_OK(attr, len); attr = RTA_NEXT(attr, len)) {
+        if (attr->rta_type == type)
+            return attr;
+    }
+    return nullptr;
+}
+
+// older kernels send a shorter tcp_info, newer ones a longer one
+size_t readTcpInfo(const struct rtattr *attr, struct tcp_info &info)
+{
+    size_t size = RTA_PAYLOAD(attr);
+    memset(&info, 0, sizeof(info));
+    memcpy(&info, RTA_DATA(attr), qMin(size, sizeof(info)));
+    return size;
+}
+
+} // namespace
+
+SockTable::SockTable()
+{
+    rehash(SOCK_TABLE_MIN_CAPACITY);
+}
+
+bool SockTable::find(const flow_key_t &key, ino_t &ino) const
+{
+    size_t mask = m_slots.size() - 1;
+    for (size_t i = size_t(qHash(key)) & mask;; i = (i + 1) & mask) {
+        const slot_t &slot = m_slots[i];
+        if (slot.state == kEmptySlot)
+            return false;
+        if (slot.state == kUsedSlot && slot.key == key) {
+            ino = slot.ino;
+            return true;
+        }
+    }
+}
+
+void SockTable::insert(const flow_key_t &key, ino_t ino)
+{
+    size_t mask = m_slots.size() - 1;
+    slot_t *target = nullptr;
+    for (size_t i = size_t(qHash(key)) & mask;; i = (i + 1) & mask) {
+        slot_t &slot = m_slots[i];
+        if (slot.state == kEmptySlot) {
+            if (!target)
+                target = &slot;
+            break;
+        }
+        if (slot.state == kDeletedSlot) {
+            // reuse first tombstone, keep probing in case key lives further on
+            if (!target)
+                target = &slot;
+        } else if (slot.key == key) {
+            slot.ino = ino;
+            slot.generation = m_generation;
+            return;
+        }
+    }
+
+    if (target->state == kDeletedSlot)
+        --m_deleted;
+    target->key = key;
+    target->ino = ino;
+    target->generation = m_generation;
+    target->state = kUsedSlot;
+    ++m_size;
+
+    // keep load (tombstones included) under 3/4 so probing always ends on an empty slot
+    if ((m_size + m_deleted) * 4 > m_slots.size() * 3) {
+        size_t capacity = m_slots.size();
+        while (m_size * 2 > capacity)
+            capacity <<= 1;
+        rehash(capacity);
+    }
+}
+
+size_t SockTable::evictStale()
+{
+    size_t nr = 0;
+    for (auto &slot : m_slots) {
+        if (slot.state == kUsedSlot && slot.generation != m_generation) {
+            slot.state = kDeletedSlot;
+            ++nr;
+        }
+    }
+    m_size -= nr;
+    m_deleted += nr;
+
+    // drop tombstones once they make up a quarter of the table, shrink if mostly empty
+    if (m_deleted * 4 > m_slots.size()) {
+        size_t capacity = m_slots.size();
+        while (capacity > SOCK_TABLE_MIN_CAPACITY && m_size * 8 < capacity)
+            capacity >>= 1;
+        rehash(capacity);
+    }
+    return nr;
+}
+
+void SockTable::clear()
+{
+    m_slots.assign(m_slots.size(), slot_t {});
+    m_size = 0;
+    m_deleted = 0;
+}
+
+void SockTable::rehash(size_t capacity)
+{
+    std::vector<slot_t> slots(capacity, slot_t {});
+    m_slots.swap(slots);
+    m_size = 0;
+    m_deleted = 0;
+
+    size_t mask = capacity - 1;
+    for (const auto &slot : slots) {
+        if (slot.state != kUsedSlot)
+            continue;
+        size_t i = size_t(qHash(slot.key)) & mask;
+        while (m_slots[i].state != kEmptySlot)
+            i = (i + 1) & mask;
+        m_slots[i] = slot;
+        ++m_size;
+    }
+}
+
+int SocketTable::update(const socket_t &sock)
+{
+    int row = m_index.value(sock.cookie, -1);
+    if (row < 0) {
+        if (!m_free.empty()) {
+            row = m_free.back();
+            m_free.pop_back();
+        } else {
+            row = rows();
+            const size_t size = size_t(row) + 1;
+            m_cookie.resize(size);
+            m_laddr.resize(size);
+            m_raddr.resize(size);
+            m_lport.resize(size);
+            m_rport.resize(size);
+            m_family.resize(size);
+            m_proto.resize(size);
+            m_state.resize(size);
+            m_ino.resize(size);
+            m_uid.resize(size);
+            m_rxQueue.resize(size);
+            m_txQueue.resize(size);
+            m_rtt.resize(size);
+            m_pid.resize(size);
+            m_seen.resize(size);
+            m_changed.resize(size);
+        }
+        m_index.insert(sock.cookie, row);
+        set(row, sock);
+    } else {
+        // the tuple of a socket may still change, e.g. bound then connected
+        const size_t i = size_t(row);
+        if (m_state[i] != sock.state || m_rxQueue[i] != sock.rxQueue || m_txQueue[i] != sock.txQueue
+                || m_rtt[i] != sock.rtt || m_pid[i] != sock.pid || m_ino[i] != sock.ino
+                || m_lport[i] != sock.lport || m_rport[i] != sock.rport || m_uid[i] != sock.uid
+                || memcmp(&m_laddr[i], &sock.laddr, sizeof(in6_addr)) != 0
+                || memcmp(&m_raddr[i], &sock.raddr, sizeof(in6_addr)) != 0)
+            set(row, sock);
+    }
+    m_seen[size_t(row)] = m_generation;
+    return row;
+}
+
+size_t SocketTable::evictStale()
+{
+    size_t nr = 0;
+    for (int row = 0; row < rows(); ++row) {
+        if (!isUsed(row) || m_seen[size_t(row)] == m_generation)
+            continue;
+        m_index.remove(m_cookie[size_t(row)]);
+        m_seen[size_t(row)] = 0;
+        m_changed[size_t(row)] = m_generation;
+        m_free.push_back(row);
+        ++nr;
+    }
+    return nr;
+}
+
+void SocketTable::clear()
+{
+    m_index.clear();
+    m_free.clear();
+    m_seen.assign(m_seen.size(), 0);
+    for (int row = rows() - 1; row >= 0; --row)
+        m_free.push_back(row);
+}
+
+SocketTable::socket_t SocketTable::at(int row) const
+{
+    const size_t i = size_t(row);
+    return {m_cookie[i], m_laddr[i], m_raddr[i], m_lport[i], m_rport[i], m_family[i], m_proto[i], m_state[i],
+            m_ino[i], m_uid[i], m_rxQueue[i], m_txQueue[i], m_rtt[i], m_pid[i]};
+}
+
+void SocketTable::set(int row, const socket_t &sock)
+{
+    const size_t i = size_t(row);
+    m_cookie[i] = sock.cookie;
+    m_laddr[i] = sock.laddr;
+    m_raddr[i] = sock.raddr;
+    m_lport[i] = sock.lport;
+    m_rport[i] = sock.rport;
+    m_family[i] = sock.family;
+    m_proto[i] = sock.proto;
+    m_state[i] = sock.state;
+    m_ino[i] = sock.ino;
+    m_uid[i] = sock.uid;
+    m_rxQueue[i] = sock.rxQueue;
+    m_txQueue[i] = sock.txQueue;
+    m_rtt[i] = sock.rtt;
+    m_pid[i] = sock.pid;
+    m_changed[i] = m_generation;
+}
+
+SockDiag::SockDiag()
+    : m_buffer(SOCK_DIAG_BUFFER_SIZE)
+{
+}
+
+SockDiag::~SockDiag()
+{
+    close();
+}
+
+bool SockDiag::open()
+{
+    if (m_fd >= 0)
+        return true;
+
+    errno = 0;
+    m_fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+    if (m_fd < 0) {
+        qCWarning(app) << "Failed to create sock_diag socket:" << strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+void SockDiag::close()
+{
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+bool SockDiag::refresh(SockTable &table)
+{
+    table.beginGeneration();
+
+    bool ok = open();
+    ok = ok && dump(AF_INET, IPPROTO_TCP, SOCK_DIAG_TCP_STATES, &table, nullptr);
+    ok = ok && dump(AF_INET6, IPPROTO_TCP, SOCK_DIAG_TCP_STATES, &table, nullptr);
+    ok = ok && dump(AF_INET, IPPROTO_UDP, SOCK_DIAG_UDP_STATES, &table, nullptr);
+    ok = ok && dump(AF_INET6, IPPROTO_UDP, SOCK_DIAG_UDP_STATES, &table, nullptr);
+    if (!ok) {
+        // e.g. inet_diag module not available, socket is reopened on next refresh
+        close();
+        ok = readProcSockStat(table);
+    }
+
+    auto nr = table.evictStale();
+    qCDebug(app) << "Socket table refreshed:" << table.size() << "flows," << nr << "evicted";
+    return ok;
+}
+
+bool SockDiag::refreshTcpHealth(TcpHealthTable &health)
+{
+    health.clear();
+
+    bool ok = open();
+    ok = ok && dump(AF_INET, IPPROTO_TCP, SOCK_DIAG_TCP_STATES, nullptr, &health);
+    ok = ok && dump(AF_INET6, IPPROTO_TCP, SOCK_DIAG_TCP_STATES, nullptr, &health);
+    if (!ok)
+        close();
+
+    qCDebug(app) << "Tcp health refreshed:" << health.size() << "connections";
+    return ok;
+}
+
+bool SockDiag::dumpSockets(std::vector<SocketTable::socket_t> &sockets)
+{
+    sockets.clear();
+
+    bool ok = open();
+    ok = ok && dump(AF_INET, IPPROTO_TCP, SOCK_DIAG_ALL_STATES, nullptr, nullptr, &sockets);
+    ok = ok && dump(AF_INET6, IPPROTO_TCP, SOCK_DIAG_ALL_STATES, nullptr, nullptr, &sockets);
+    ok = ok && dump(AF_INET, IPPROTO_UDP, SOCK_DIAG_ALL_STATES, nullptr, nullptr, &sockets);
+    ok = ok && dump(AF_INET6, IPPROTO_UDP, SOCK_DIAG_ALL_STATES, nullptr, nullptr, &sockets);
+    if (!ok)
+        close();
+
+    qCDebug(app) << "Sockets dumped:" << sockets.size();
+    return ok;
+}
+
+bool SockDiag::dump(int family, int proto, uint32_t states, SockTable *table, TcpHealthTable *health,
+                    std::vector<SocketTable::socket_t> *sockets)
+{
+    struct {
+        struct nlmsghdr nlh;
+        struct inet_diag_req_v2 req;
+    } msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.nlh.nlmsg_len = sizeof(msg);
+    msg.nlh.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+    msg.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    msg.nlh.nlmsg_seq = ++m_seq;
+    msg.req.sdiag_family = uint8_t(family);
+    msg.req.sdiag_protocol = uint8_t(proto);
+    msg.req.idiag_states = states;
+    // the base message already carries tuple & inode, tcp_info only when health or rtt is wanted
+    if (health || (sockets && proto == IPPROTO_TCP))
+        msg.req.idiag_ext = uint8_t(1 << (INET_DIAG_INFO - 1));
+
+    struct sockaddr_nl nladdr;
+    memset(&nladdr, 0, sizeof(nladdr));
+    nladdr.nl_family = AF_NETLINK;
+
+    errno = 0;
+    if (sendto(m_fd, &msg, sizeof(msg), 0, reinterpret_cast<struct sockaddr *>(&nladdr), sizeof(nladdr)) < 0) {
+        qCWarning(app) << "sock_diag request failed:" << strerror(errno);
+        return false;
+    }
+
+    while (true) {
+        int len = int(recv(m_fd, m_buffer.data(), m_buffer.size(), 0));
+        if (len < 0) {
+            if (errno == EINTR)
+                continue;
+            qCWarning(app) << "sock_diag receive failed:" << strerror(errno);
+            return false;
+        }
+        if (len == 0)
+            return false;
+
+        for (auto *nlh = reinterpret_cast<struct nlmsghdr *>(m_buffer.data()); NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+            if (nlh->nlmsg_seq != m_seq)
+                continue;
+            if (nlh->nlmsg_type == NLMSG_DONE)
+                return true;
+            if (nlh->nlmsg_type == NLMSG_ERROR) {
+                auto *err = reinterpret_cast<const struct nlmsgerr *>(NLMSG_DATA(nlh));
+                qCWarning(app) << "sock_diag dump error:" << strerror(-err->error);
+                return false;
+            }
+            if (nlh->nlmsg_type != SOCK_DIAG_BY_FAMILY || nlh->nlmsg_len < NLMSG_LENGTH(sizeof(struct inet_diag_msg)))
+                continue;
+
+            if (table)
+                addSocket(reinterpret_cast<const struct inet_diag_msg *>(NLMSG_DATA(nlh)), proto, *table);
+            if (health)
+                addTcpHealth(nlh, *health);
+            if (sockets)
+                addSocketRow(nlh, proto, *sockets);
+        }
+    }
+}
+
+void SockDiag::addSocket(const inet_diag_msg *diag, int proto, SockTable &table)
+{
+    ino_t ino = diag->idiag_inode;
+    // socket being torn down
+    if (ino == 0)
+        return;
+
+    int family = diag->idiag_family;
+    const void *saddr = diag->id.idiag_src;
+    const void *daddr = diag->id.idiag_dst;
+    in_addr s4 {}, d4 {};
+    // convert ipv4 mapped ipv6 address to ipv4
+    if (family == AF_INET6
+            && diag->id.idiag_src[0] == 0 && diag->id.idiag_src[1] == 0
+            && diag->id.idiag_src[2] == htonl(0xffff)) {
+        family = AF_INET;
+        s4.s_addr = diag->id.idiag_src[3];
+        d4.s_addr = diag->id.idiag_dst[3];
+        saddr = &s4;
+        daddr = &d4;
+    }
+    uint sport = ntohs(diag->id.idiag_sport);
+    uint dport = ntohs(diag->id.idiag_dport);
+
+    table.insert(makeFlowKey(family, saddr, sport, daddr, dport), ino);
+    // tcp is matched in both directions, see SysInfo::readSockStat
+    if (proto == IPPROTO_TCP)
+        table.insert(makeFlowKey(family, daddr, dport, saddr, sport), ino);
+}
+
+void SockDiag::addTcpHealth(const nlmsghdr *nlh, TcpHealthTable &health)
+{
+    auto *diag = reinterpret_cast<const inet_diag_msg *>(NLMSG_DATA(nlh));
+    if (diag->idiag_inode == 0)
+        return;
+
+    const struct rtattr *attr = findDiagAttr(nlh, INET_DIAG_INFO);
+    if (!attr)
+        return;
+
+    struct tcp_info info;
+    size_t size = readTcpInfo(attr, info);
+
+    tcp_health_t &entry = health[diag->idiag_inode];
+    entry.rtt = info.tcpi_rtt;
+    entry.rttvar = info.tcpi_rttvar;
+    entry.cwnd = info.tcpi_snd_cwnd;
+    entry.unacked = info.tcpi_unacked;
+    entry.retrans = info.tcpi_total_retrans;
+    entry.segsOut = 0;
+    if (size >= TCP_INFO_SEGS_OUT_OFFSET + sizeof(entry.segsOut))
+        memcpy(&entry.segsOut, reinterpret_cast<const char *>(RTA_DATA(attr)) + TCP_INFO_SEGS_OUT_OFFSET, sizeof(entry.segsOut));
+}
+
+void SockDiag::addSocketRow(const nlmsghdr *nlh, int proto, std::vector<SocketTable::socket_t> &sockets)
+{
+    auto *diag = reinterpret_cast<const inet_diag_msg *>(NLMSG_DATA(nlh));
+    SocketTable::socket_t sock {};
+    sock.cookie = uint64_t(diag->id.idiag_cookie[0]) | (uint64_t(diag->id.idiag_cookie[1]) << 32);
+    sock.family = diag->idiag_family;
+    memcpy(&sock.laddr, diag->id.idiag_src, sizeof(sock.laddr));
+    memcpy(&sock.raddr, diag->id.idiag_dst, sizeof(sock.raddr));
+    // ipv4 mapped ipv6 sockets are listed as ipv4, as ss does
+    if (sock.family == AF_INET6 && IN6_IS_ADDR_V4MAPPED(&sock.laddr)) {
+        sock.family = AF_INET;
+        const uint32_t local = diag->id.idiag_src[3];
+        const uint32_t remote = IN6_IS_ADDR_V4MAPPED(&sock.raddr) ? diag->id.idiag_dst[3] : 0;
+        memset(&sock.laddr, 0, sizeof(sock.laddr));
+        memset(&sock.raddr, 0, sizeof(sock.raddr));
+        memcpy(&sock.laddr, &local, sizeof(local));
+        memcpy(&sock.raddr, &remote, sizeof(remote));
+    }
+    sock.lport = ntohs(diag->id.idiag_sport);
+    sock.rport = ntohs(diag->id.idiag_dport);
+    sock.proto = uint8_t(proto);
+    sock.state = diag->idiag_state;
+    sock.ino = diag->idiag_inode;
+    sock.uid = diag->idiag_uid;
+    sock.rxQueue = diag->idiag_rqueue;
+    sock.txQueue = diag->idiag_wqueue;
+
+    // time wait & request sockets carry no tcp_info
+    const struct rtattr *attr = proto == IPPROTO_TCP ? findDiagAttr(nlh, INET_DIAG_INFO) : nullptr;
+    if (attr) {
+        struct tcp_info info;
+        readTcpInfo(attr, info);
+        sock.rtt = info.tcpi_rtt;
+    }
+    sockets.push_back(sock);
+}
+
+bool SockDiag::readProcSockStat(SockTable &table)
+{
+    SockStatMap statMap;
+    bool ok = SysInfo::readSockStat(statMap);
+    for (auto it = statMap.cbegin(); it != statMap.cend(); ++it)
+        table.insert(it.key(), it.value()->ino);
+    return ok;
+}
+
+} // namespace system
+} // namespace core
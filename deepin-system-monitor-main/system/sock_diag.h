@@ -0,0 +1,256 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SOCK_DIAG_H
+#define SOCK_DIAG_H
+
+#include "packet.h"
+
+#include <QHash>
+
+#include <vector>
+
+struct inet_diag_msg;
+struct nlmsghdr;
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Flat open addressed flow key to socket inode table
+ *
+ * Linear probing over a single slot array, no allocation per socket. Refresh keeps the table
+ * in place: sockets seen again are restamped with the current generation, whatever was not
+ * seen in a generation is evicted afterwards.
+ */
+class SockTable
+{
+public:
+    SockTable();
+
+    /**
+     * @brief Look up socket inode of a flow
+     */
+    bool find(const flow_key_t &key, ino_t &ino) const;
+    /**
+     * @brief Insert or update flow, entry is stamped with current generation
+     */
+    void insert(const flow_key_t &key, ino_t ino);
+
+    /**
+     * @brief Start a new generation, call before inserting a fresh socket dump
+     */
+    inline void beginGeneration() { ++m_generation; }
+    /**
+     * @brief Remove entries not inserted during current generation
+     * @return Number of entries removed
+     */
+    size_t evictStale();
+
+    void clear();
+
+    inline size_t size() const { return m_size; }
+    inline size_t capacity() const { return m_slots.size(); }
+    inline uint32_t generation() const { return m_generation; }
+
+private:
+    enum slot_state_t : uint8_t {
+        kEmptySlot,
+        kUsedSlot,
+        kDeletedSlot,
+    };
+    struct slot_t {
+        flow_key_t key;
+        ino_t ino;
+        uint32_t generation;
+        uint8_t state;
+    };
+
+    void rehash(size_t capacity);
+
+    std::vector<slot_t> m_slots;
+    size_t m_size {};
+    size_t m_deleted {};
+    uint32_t m_generation {1};
+};
+
+/**
+ * @brief Every tcp/udp socket of a full sock_diag dump, one array per field
+ *
+ * Rows are keyed by socket cookie & keep their index while the socket lives, rows of closed
+ * sockets are reused by later ones. Like SockTable a refresh restamps the sockets seen again
+ * with the current generation & evicts the others, a row whose fields changed is also stamped
+ * as changed in it, so views patch only those.
+ */
+class SocketTable
+{
+public:
+    /**
+     * @brief Socket of a dump, ipv4 addresses (v4 mapped ones too) are kept in the first word
+     */
+    struct socket_t {
+        uint64_t cookie;
+        in6_addr laddr;
+        in6_addr raddr;
+        uint16_t lport;
+        uint16_t rport;
+        uint8_t family;
+        uint8_t proto; // IPPROTO_TCP or IPPROTO_UDP
+        uint8_t state; // TCP_ESTABLISHED..., udp sockets are TCP_ESTABLISHED or TCP_CLOSE
+        ino_t ino; // 0 for time wait & orphaned sockets
+        uint32_t uid;
+        uint32_t rxQueue; // accept queue of listening sockets
+        uint32_t txQueue; // backlog of listening sockets
+        uint32_t rtt; // smoothed round trip time in us, 0 if unknown
+        pid_t pid; // owner, 0 if unknown
+    };
+
+    inline void beginGeneration() { ++m_generation; }
+    /**
+     * @brief Insert or update a socket, its row is stamped with the current generation
+     * @return Row of the socket
+     */
+    int update(const socket_t &sock);
+    /**
+     * @brief Free the rows of sockets not updated during current generation
+     * @return Number of rows freed
+     */
+    size_t evictStale();
+    void clear();
+
+    /**
+     * @brief Row count including free rows, see isUsed
+     */
+    inline int rows() const { return int(m_cookie.size()); }
+    inline size_t size() const { return m_index.size(); }
+    inline uint32_t generation() const { return m_generation; }
+
+    inline bool isUsed(int row) const { return m_seen[size_t(row)] != 0; }
+    /**
+     * @brief Generation the fields of a row last changed in, its insertion included
+     */
+    inline uint32_t changed(int row) const { return m_changed[size_t(row)]; }
+    inline int find(uint64_t cookie) const { return m_index.value(cookie, -1); }
+    socket_t at(int row) const;
+
+    inline uint64_t cookie(int row) const { return m_cookie[size_t(row)]; }
+    inline const in6_addr &laddr(int row) const { return m_laddr[size_t(row)]; }
+    inline const in6_addr &raddr(int row) const { return m_raddr[size_t(row)]; }
+    inline uint16_t lport(int row) const { return m_lport[size_t(row)]; }
+    inline uint16_t rport(int row) const { return m_rport[size_t(row)]; }
+    inline uint8_t family(int row) const { return m_family[size_t(row)]; }
+    inline uint8_t proto(int row) const { return m_proto[size_t(row)]; }
+    inline uint8_t state(int row) const { return m_state[size_t(row)]; }
+    inline ino_t ino(int row) const { return m_ino[size_t(row)]; }
+    inline uint32_t uid(int row) const { return m_uid[size_t(row)]; }
+    inline uint32_t rxQueue(int row) const { return m_rxQueue[size_t(row)]; }
+    inline uint32_t txQueue(int row) const { return m_txQueue[size_t(row)]; }
+    inline uint32_t rtt(int row) const { return m_rtt[size_t(row)]; }
+    inline pid_t pid(int row) const { return m_pid[size_t(row)]; }
+
+private:
+    void set(int row, const socket_t &sock);
+
+    std::vector<uint64_t> m_cookie;
+    std::vector<in6_addr> m_laddr;
+    std::vector<in6_addr> m_raddr;
+    std::vector<uint16_t> m_lport;
+    std::vector<uint16_t> m_rport;
+    std::vector<uint8_t> m_family;
+    std::vector<uint8_t> m_proto;
+    std::vector<uint8_t> m_state;
+    std::vector<ino_t> m_ino;
+    std::vector<uint32_t> m_uid;
+    std::vector<uint32_t> m_rxQueue;
+    std::vector<uint32_t> m_txQueue;
+    std::vector<uint32_t> m_rtt;
+    std::vector<pid_t> m_pid;
+    // generation a row was last seen in, 0 for free rows
+    std::vector<uint32_t> m_seen;
+    std::vector<uint32_t> m_changed;
+
+    QHash<uint64_t, int> m_index;
+    std::vector<int> m_free;
+    uint32_t m_generation {1};
+};
+
+/**
+ * @brief Health of a tcp connection, from the tcp_info sock_diag reports with INET_DIAG_INFO
+ */
+struct tcp_health_t {
+    uint32_t rtt; // smoothed round trip time, us
+    uint32_t rttvar; // us
+    uint32_t cwnd; // congestion window, segments
+    uint32_t unacked; // segments sent & not acked yet
+    uint32_t retrans; // segments retransmitted over the connection lifetime
+    uint32_t segsOut; // segments sent over the connection lifetime, 0 before kernel 4.2
+};
+
+// socket inode to tcp health mapping
+using TcpHealthTable = QHash<ino_t, tcp_health_t>;
+
+/**
+ * @brief NETLINK_SOCK_DIAG socket table dumper
+ *
+ * Dumps tcp/udp sockets of both families through inet_diag, the kernel filters out sockets
+ * packets can never be matched against (listening & unconnected sockets), so there is no text
+ * parsing & the dump only carries flows. Falls back to /proc/net tables if sock_diag is not
+ * available.
+ */
+class SockDiag
+{
+public:
+    SockDiag();
+    ~SockDiag();
+
+    SockDiag(const SockDiag &) = delete;
+    SockDiag &operator=(const SockDiag &) = delete;
+
+    /**
+     * @brief Refresh table in place with current sockets
+     * @return false if neither sock_diag nor /proc/net tables could be read
+     */
+    bool refresh(SockTable &table);
+    /**
+     * @brief Dump tcp_info of connected tcp sockets of both families
+     * @return false if sock_diag is not available, tcp_info has no /proc/net fallback
+     */
+    bool refreshTcpHealth(TcpHealthTable &health);
+    /**
+     * @brief Dump all tcp/udp sockets of both families, listening & time wait ones included
+     * @param sockets Cleared & filled with the sockets, owner pids are left 0
+     * @return false if sock_diag is not available
+     */
+    bool dumpSockets(std::vector<SocketTable::socket_t> &sockets);
+
+    /**
+     * @brief Add flow keys of a sock_diag message to table
+     * @param proto IPPROTO_TCP or IPPROTO_UDP
+     */
+    static void addSocket(const struct inet_diag_msg *diag, int proto, SockTable &table);
+    /**
+     * @brief Add tcp health of a sock_diag message carrying an INET_DIAG_INFO attribute to health
+     */
+    static void addTcpHealth(const struct nlmsghdr *nlh, TcpHealthTable &health);
+    /**
+     * @brief Add the socket of a sock_diag message to sockets, with the rtt of its INET_DIAG_INFO if any
+     */
+    static void addSocketRow(const struct nlmsghdr *nlh, int proto, std::vector<SocketTable::socket_t> &sockets);
+
+private:
+    bool open();
+    void close();
+    bool dump(int family, int proto, uint32_t states, SockTable *table, TcpHealthTable *health,
+              std::vector<SocketTable::socket_t> *sockets = nullptr);
+    static bool readProcSockStat(SockTable &table);
+
+    int m_fd {-1};
+    uint32_t m_seq {};
+    std::vector<char> m_buffer;
+};
+
+} // namespace system
+} // namespace core
+
+#endif // SOCK_DIAG_H
@@ -11,16 +11,17 @@
 #include "common/common.h"
 #include "system/system_monitor.h"
 #include "common/thread_manager.h"
+#include "common/proc_parser.h"
+#include "common/scratch_arena.h"
 #include "system/system_monitor_thread.h"
 #include "packet.h"
 #include <DSysInfo>
 
 #include <QString>
 #include <QtDBus>
-#include <QFileInfo>
-#include <QDir>
 
 #include <sys/time.h>
+#include <time.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/utsname.h>
@@ -28,7 +29,6 @@
 #include <stdio.h>
 #include <sys/sysinfo.h>
 #include <arpa/inet.h>
-#include "common/hash.h"
 
 #define PROC_PATH_SOCK_TCP  "/proc/net/tcp"
 #define PROC_PATH_SOCK_TCP6 "/proc/net/tcp6"
@@ -46,6 +46,7 @@ DCORE_USE_NAMESPACE
 #define PROC_PATH_UPTIME "/proc/uptime"
 #define PROC_PATH_STAT "/proc/stat"
 #define PROC_PATH_LOADAVG "/proc/loadavg"
+#define PROC_PATH_SCHEDSTAT "/proc/schedstat"
 
 namespace core {
 namespace system {
@@ -92,14 +93,10 @@ bool SysInfo::readSockStat(SockStatMap &statMap)
         bool ok {true};
         FILE *fp {};
         const size_t BLEN = 4096;
-        QByteArray buffer {BLEN, 0};
+        char buffer[BLEN];
         int nr {};
         ino_t ino {};
         char s_addr[128] {}, d_addr[128] {};
-        uint64_t hash {};
-        QByteArray fmtbuf {};
-        uint64_t cchash[2] {};
-        QString patternA {}, patternB {};
         int count = 0;
 
         errno = 0;
@@ -109,17 +106,18 @@ bool SysInfo::readSockStat(SockStatMap &statMap)
             return !ok;
         }
 
-        while (fgets(buffer.data(), BLEN, fp))
+        while (fgets(buffer, BLEN, fp))
         {
-            auto stat = QSharedPointer<struct sock_stat_t>::create();
+            // parsed on the stack, only sockets kept are allocated
+            struct sock_stat_t entry {};
 
             //*****************************************************************
-            nr = sscanf(buffer.data(), "%*s %64[0-9A-Fa-f]:%x %64[0-9A-Fa-f]:%x %*x %*s %*s %*s %u %*u %ld",
+            nr = sscanf(buffer, "%*s %64[0-9A-Fa-f]:%x %64[0-9A-Fa-f]:%x %*x %*s %*s %*s %u %*u %ld",
                         s_addr,
-                        &stat->s_port,
+                        &entry.s_port,
                         d_addr,
-                        &stat->d_port,
-                        &stat->uid,
+                        &entry.d_port,
+                        &entry.uid,
                         &ino);
 
             // ignore first line
@@ -132,6 +130,7 @@ bool SysInfo::readSockStat(SockStatMap &statMap)
             }
             count++;
 
+            auto stat = QSharedPointer<struct sock_stat_t>::create(entry);
             stat->ino = ino;
             stat->sa_family = family;
             stat->proto = proto;
@@ -161,43 +160,12 @@ bool SysInfo::readSockStat(SockStatMap &statMap)
                 sscanf(d_addr, "%x", &stat->d_addr.in4.s_addr);
             }
 
-            if (stat->sa_family == AF_INET) {
-                char saddr_str[INET_ADDRSTRLEN + 1] {}, daddr_str[INET_ADDRSTRLEN + 1] {};
-                inet_ntop(AF_INET, &stat->s_addr.in4, saddr_str, INET_ADDRSTRLEN);
-                inet_ntop(AF_INET, &stat->d_addr.in4, daddr_str, INET_ADDRSTRLEN);
-
-                patternA = QString("%1:%2-%3:%4").arg(saddr_str).arg(stat->s_port).arg(daddr_str).arg(stat->d_port);
-                if (proto == IPPROTO_TCP) {
-                    patternB = QString("%1:%2-%3:%4").arg(daddr_str).arg(stat->d_port).arg(saddr_str).arg(stat->s_port);
-                }
-
-            } else if (stat->sa_family == AF_INET6) {
-                char saddr6_str[INET6_ADDRSTRLEN + 1] {}, daddr6_str[INET6_ADDRSTRLEN + 1] {};
-                inet_ntop(AF_INET6, &stat->s_addr.in6, saddr6_str, INET6_ADDRSTRLEN);
-                inet_ntop(AF_INET6, &stat->d_addr.in6, daddr6_str, INET6_ADDRSTRLEN);
-
-                patternA = QString("%1:%2-%3:%4").arg(saddr6_str).arg(stat->s_port).arg(daddr6_str).arg(stat->d_port);
-                if (proto == IPPROTO_TCP) {
-                    patternB = QString("%1:%2-%3:%4").arg(daddr6_str).arg(stat->d_port).arg(saddr6_str).arg(stat->s_port);
-                }
-
-            } else {
-                qCWarning(app) << "Unexpected socket family:" << stat->sa_family;
-            }
-
-            fmtbuf = patternA.toLocal8Bit();
-            util::common::hash(fmtbuf.constData(), fmtbuf.length(), util::common::global_seed, cchash);
-            hash = cchash[0];
-            statMap.insert(hash, stat);
+            statMap.insert(makeFlowKey(stat->sa_family, &stat->s_addr, stat->s_port, &stat->d_addr, stat->d_port), stat);
 
             // if it's TCP, we need add reverse mapping due to its bidirectional piping feature,
             // otherwise we wont be able to get the inode
-            if (proto == IPPROTO_TCP) {
-                fmtbuf = patternB.toLocal8Bit();
-                util::common::hash(fmtbuf.constData(), fmtbuf.length(), util::common::global_seed, cchash);
-                hash = cchash[0];
-                statMap.insert(hash, stat);
-            }
+            if (proto == IPPROTO_TCP)
+                statMap.insert(makeFlowKey(stat->sa_family, &stat->d_addr, stat->d_port, &stat->s_addr, stat->s_port), stat);
         }
         if (ferror(fp))
         {
@@ -225,12 +193,14 @@ void SysInfo::readSysInfo()
 {
     qCDebug(app) << "Reading dynamic system info...";
     d->nfds = read_file_nr();
-    d->nprocs = read_processes();
-    d->nthrs = read_threads();
-    
+
     read_uptime(d->uptime);
     read_btime(d->btime);
     read_loadavg(d->loadAvg);
+    read_schedstat();
+    // until the first process scan reports its counts
+    if (d->nthrs == 0)
+        d->nthrs = d->loadAvg->nr_tasks;
     qCDebug(app) << "Dynamic system info read:" << "nfds=" << d->nfds << "nprocs=" << d->nprocs << "nthrs=" << d->nthrs;
 }
 
@@ -282,35 +252,6 @@ quint32 SysInfo::read_file_nr()
     return 0;
 }
 
-quint32 SysInfo::read_threads()
-{
-    QDir dir("/proc");
-    QFileInfoList infoList = dir.entryInfoList();
-    quint32 threads = 0;
-    for (QFileInfo info : infoList) {
-        if (info.isDir() && info.fileName().toInt() > 0) {
-            QDir taskDir("/proc/" + info.fileName() + "/task");
-            threads += taskDir.entryInfoList().count();
-        }
-    }
-
-    return threads;
-}
-
-quint32 SysInfo::read_processes()
-{
-    QDir dir("/proc");
-    QFileInfoList infoList = dir.entryInfoList();
-    quint32 processes = 0;
-    for (QFileInfo info : infoList) {
-        if (info.isDir() && info.fileName().toInt() > 0) {
-            processes++;
-        }
-    }
-
-    return processes;
-}
-
 QString SysInfo::read_hostname()
 {
     QDBusInterface busIf("org.freedesktop.hostname1",
@@ -405,27 +346,25 @@ void SysInfo::read_btime(struct timeval &btime)
 
 void SysInfo::read_loadavg(LoadAvg &loadAvg)
 {
-    QFile file("/proc/loadavg");
-    if (file.exists() && file.open(QFile::ReadOnly)) {
-        // 只需要读取第一行数据
-        QByteArray lineData = file.readLine();
-        file.close();
+    size_t len = 0;
+    const char *buf = ScratchArena::local().readFile(PROC_PATH_LOADAVG, len);
+    if (buf) {
         /*样例数据:
             $ cat /proc/loadavg
             0.41 0.46 0.36 2/2646 20183
         */
-
-        // 分割数据 取前3
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        QStringList cpuStatus = QString(lineData).split(" ", QString::SkipEmptyParts);
-#else
-        QStringList cpuStatus = QString(lineData).split(" ", Qt::SkipEmptyParts);
-#endif
-
-        if (cpuStatus.size() > 3) {
-            loadAvg->lavg_1m = cpuStatus[0].toFloat();
-            loadAvg->lavg_5m = cpuStatus[1].toFloat();
-            loadAvg->lavg_15m = cpuStatus[2].toFloat();
+        float lavg[3] {};
+        quint32 running = 0, tasks = 0;
+        // running/total is left as is when missing
+        int nm = sscanf(buf, "%f %f %f %u/%u", &lavg[0], &lavg[1], &lavg[2], &running, &tasks);
+        if (nm >= 3) {
+            loadAvg->lavg_1m = lavg[0];
+            loadAvg->lavg_5m = lavg[1];
+            loadAvg->lavg_15m = lavg[2];
+            if (nm == 5) {
+                loadAvg->nr_running = running;
+                loadAvg->nr_tasks = tasks;
+            }
 
             return ;
         }
@@ -434,5 +373,61 @@ void SysInfo::read_loadavg(LoadAvg &loadAvg)
     qCWarning(app) << "Failed to read load average:" << strerror(errno);
 }
 
+bool SysInfo::parseSchedStat(const char *buf, size_t len, qulonglong &runDelay, int &ncpus)
+{
+    using namespace common::parser;
+
+    /*样例数据:
+        version 15
+        timestamp 4295589574
+        cpu0 0 0 0 0 0 0 1458462335907 41795022842 2440593
+        domain0 00000003 ...
+    */
+    runDelay = 0;
+    ncpus = 0;
+    Tokenizer tok(buf, len);
+    do {
+        const char *name = nullptr;
+        size_t nameLen = 0;
+        if (!tok.readToken(name, nameLen) || nameLen < 4 || strncmp(name, "cpu", 3) || !isDigit(name[3]))
+            continue;
+        // yld_count, legacy, sched_count, sched_goidle, ttwu_count, ttwu_local, rq_cpu_time, run_delay
+        unsigned long long delay = 0;
+        if (tok.skipTokens(7) && tok.readU64(delay)) {
+            runDelay += delay;
+            ++ncpus;
+        }
+    } while (tok.nextLine());
+    return ncpus > 0;
+}
+
+void SysInfo::read_schedstat()
+{
+    // missing without CONFIG_SCHEDSTATS, a line per cpu & sched domain so it's read into scratch
+    size_t len = 0;
+    const char *buf = ScratchArena::local().readFile(PROC_PATH_SCHEDSTAT, len);
+    if (!buf) {
+        d->runQueueWait = -1;
+        return;
+    }
+
+    qulonglong runDelay = 0;
+    int ncpus = 0;
+    if (!parseSchedStat(buf, len, runDelay, ncpus)) {
+        qCWarning(app) << "Failed to parse" << PROC_PATH_SCHEDSTAT;
+        d->runQueueWait = -1;
+        return;
+    }
+
+    struct timespec ts {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    qint64 now = qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    // same base as the cpu wait of processes, all cpus' time of the interval
+    if (d->runDelayTime > 0 && now > d->runDelayTime && runDelay >= d->runDelay)
+        d->runQueueWait = qreal(runDelay - d->runDelay) * 100. / ncpus / qreal(now - d->runDelayTime);
+    d->runDelay = runDelay;
+    d->runDelayTime = now;
+}
+
 } // namespace system
 } // namespace core
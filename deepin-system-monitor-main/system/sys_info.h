@@ -35,6 +35,8 @@ struct load_avg_t {
     float lavg_1m {0};
     float lavg_5m {0};
     float lavg_15m {0};
+    quint32 nr_running {0}; // runnable scheduling entities
+    quint32 nr_tasks {0}; // scheduling entities (threads) in the system
 };
 using LoadAvg = std::shared_ptr<struct load_avg_t>;
 
@@ -61,6 +63,11 @@ public:
     LoadAvg loadAvg() const;
     struct timeval btime() const;
     struct timeval uptime() const;
+    /**
+     * @brief Time tasks were runnable but waiting for a cpu in the last interval
+     * @return % of the time of all cpus, may exceed 100 when several tasks wait on a cpu, -1 if unknown
+     */
+    qreal runQueueWait() const;
 
     uid_t uid() const;
     gid_t gid() const;
@@ -78,18 +85,24 @@ public:
     void readSysInfo();
     void readSysInfoStatic();
     static bool readSockStat(SockStatMap &statMap);
+    /**
+     * @brief Sum run_delay (field 8) of the cpu lines of /proc/schedstat
+     * @param runDelay Run queue wait of all cpus, ns
+     * @param ncpus Number of cpu lines
+     */
+    static bool parseSchedStat(const char *buf, size_t len, qulonglong &runDelay, int &ncpus);
 
 private:
     quint32 read_file_nr();
-    quint32 read_threads();
-    quint32 read_processes();
     QString read_hostname();
     QString read_arch();
     QString read_version();
     void read_uptime(struct timeval &uptime);
     void read_btime(struct timeval &btime);
     void read_loadavg(LoadAvg &loadAvg);
+    void read_schedstat();
 
+    // process & thread counts come from the process scan, see ProcessSet::scanProcess
     inline void set_nprocesses(quint32 nprocs);
     inline void set_nthreads(quint32 nthrs);
     inline void set_btime(struct timeval &btime);
@@ -146,6 +159,11 @@ inline timeval SysInfo::uptime() const
     return d->uptime;
 }
 
+inline qreal SysInfo::runQueueWait() const
+{
+    return d->runQueueWait;
+}
+
 inline uid_t SysInfo::uid() const
 {
     return d->uid;
@@ -11,12 +11,25 @@
 #include "process/desktop_entry_cache_updater.h"
 #include "wm/wm_window_list.h"
 #include "sys_info.h"
-
+#include "cpu_set.h"
+#include "mem.h"
+#include "block_device_info_db.h"
+#include "diskio_info.h"
+#include "net_info.h"
+#include "cpu_hotplug_monitor.h"
+#include "demand_tracker.h"
+
+#include <QTimer>
 #include <QTimerEvent>
 
 using namespace common::core;
 using namespace DDLog;
 
+// ms after startup the cached cpu info is checked against sysfs
+const int kCPUInfoRevalidateDelay = 60 * 1000;
+// ms between the baseline sample at start & the second one, rates & usage need both
+const int kWarmupSampleDelay = 200;
+
 namespace core {
 namespace system {
 
@@ -25,9 +38,16 @@ SystemMonitor::SystemMonitor(QObject *parent)
     , m_sysInfo(new SysInfo())
     , m_deviceDB(new DeviceDB())
     , m_processDB(new ProcessDB(this))
+    , m_cpuHotplugMonitor(new CPUHotplugMonitor())
+    , m_backgroundMode(false)
 {
     qCDebug(app) << "SystemMonitor created";
-    m_sysInfo->readSysInfoStatic();
+    m_clock.start();
+    initProducers();
+    // queued, views report their visibility on the gui thread
+    connect(DemandTracker::instance(), &DemandTracker::demandsChanged, this,
+            [this](int, int gained) { applyDemands(gained); });
+    applyDemands(0);
 }
 
 SystemMonitor::~SystemMonitor()
@@ -72,42 +92,146 @@ void SystemMonitor::startMonitorJob()
 {
     qCDebug(app) << "Starting monitor job";
     common::init::global_init();
+    // user names may take a nss lookup, read once the window is up instead of before its first frame
+    m_sysInfo->readSysInfoStatic();
 
     m_basictimer.stop();
-    m_basictimer.start(1000, Qt::VeryCoarseTimer, this);
+    startBaseTimer();
     updateSystemMonitorInfo();
+    // first cpu % & rates shortly after launch instead of one process table period later
+    QTimer::singleShot(kWarmupSampleDelay, this, [this]() {
+        m_scheduler.runPeriodic(m_clock.elapsed());
+    });
 }
-static uint cnt = 0 ;
-void SystemMonitor::timerEvent(QTimerEvent *event)
+
+void SystemMonitor::setBackgroundMode(bool background)
+{
+    qCDebug(app) << "Set background mode:" << background;
+    m_backgroundMode = background;
+}
+
+void SystemMonitor::setPaused(bool paused)
+{
+    qCDebug(app) << "Set paused:" << paused;
+    // the base timer belongs to the monitor thread
+    QMetaObject::invokeMethod(this, [this, paused]() {
+        if (paused != m_basictimer.isActive())
+            return;
+        if (paused) {
+            m_basictimer.stop();
+            return;
+        }
+        startBaseTimer();
+        // everything periodic is due after a long pause, once-only producers are not run again
+        m_scheduler.runDue(m_clock.elapsed());
+    }, Qt::QueuedConnection);
+}
+
+void SystemMonitor::setProcessRefreshPeriod(int periodMs)
+{
+    qCDebug(app) << "Set process refresh period:" << periodMs;
+    QMetaObject::invokeMethod(this, [this, periodMs]() {
+        m_scheduler.setPeriod(m_processTableProducer, periodMs);
+    }, Qt::QueuedConnection);
+}
+
+void SystemMonitor::setRefreshInterval(int intervalMs)
 {
+    qCDebug(app) << "Set refresh interval:" << intervalMs;
+    if (intervalMs <= 0)
+        return;
+    QMetaObject::invokeMethod(this, [this, intervalMs]() {
+        m_scheduler.setPeriodScale(qreal(intervalMs) / kDefaultRefreshInterval);
+        m_tick = qMax(1, intervalMs / 2);
+        // a paused or not yet started monitor picks the tick up when its timer starts
+        if (m_basictimer.isActive()) {
+            startBaseTimer();
+            m_scheduler.runDue(m_clock.elapsed());
+        }
+    }, Qt::QueuedConnection);
+}
+
+void SystemMonitor::startBaseTimer()
+{
+    // very coarse timers fire on whole seconds, too late for sub second ticks
+    m_basictimer.start(m_tick, m_tick < 1000 ? Qt::CoarseTimer : Qt::VeryCoarseTimer, this);
+}
+
+void SystemMonitor::initProducers()
+{
+    CPUSet *cpuSet = m_deviceDB->cpuSet();
+    MemInfo *memInfo = m_deviceDB->memInfo();
+    BlockDeviceInfoDB *blkDevInfoDB = m_deviceDB->blockDeviceInfoDB();
+    DiskIOInfo *diskIoInfo = m_deviceDB->diskIoInfo();
+    NetInfo *netInfo = m_deviceDB->netInfo();
+
+    // period & cost budget in ms, period 0 runs once
+    int sysInfo = m_scheduler.addProducer("sysinfo", 1000, 20, [this]() { m_sysInfo->readSysInfo(); });
+    int cpuStat = m_scheduler.addProducer("cpu stat", 1000, 20, [cpuSet]() { cpuSet->updateStats(); });
+    m_scheduler.addProducer("cpu info", 0, 200, [this, cpuSet]() {
+        // info of the last run shows at once, lscpu is read again once startup settled
+        if (cpuSet->updateOverallInfoCached())
+            QTimer::singleShot(kCPUInfoRevalidateDelay, this, [cpuSet]() { cpuSet->updateOverallInfo(); });
+    });
+    m_scheduler.addProducer("cpu hotplug", 2000, 20, [this, cpuSet]() {
+        if (m_cpuHotplugMonitor->poll())
+            cpuSet->updateOverallInfo();
+    });
+    m_cpuFreqProducer = m_scheduler.addProducer("cpu freq", 1000, 20, [cpuSet]() { cpuSet->updateFreq(); });
+    m_runQueueProducer = m_scheduler.addProducer("cpu run queue", 2000, 20, [cpuSet]() { cpuSet->updateRunQueue(); });
+    m_scheduler.addProducer("memory", 2000, 20, [memInfo]() { memInfo->readMemInfo(); });
+    m_netifProducer = m_scheduler.addProducer("netif", 2000, 50, [this]() { m_deviceDB->updateNetifInfo(); });
+    m_scheduler.addProducer("block device stat", 2000, 50, [blkDevInfoDB]() { blkDevInfoDB->updateDeviceStats(); });
+    m_scheduler.addProducer("block device", 2000, 20, [blkDevInfoDB]() { blkDevInfoDB->update(); });
+    m_scheduler.addProducer("disk io", 2000, 20, [diskIoInfo]() { diskIoInfo->update(); });
+    m_scheduler.addProducer("net", 2000, 20, [netInfo]() { netInfo->resdNetInfo(); });
+    m_scheduler.addProducer("pressure", 2000, 20, [this]() { m_deviceDB->updatePressure(); });
+    m_scheduler.addProducer("gpu", 2000, 20, [this]() { m_deviceDB->updateGpuInfo(); });
+    // temperatures change slowly, sampled even unseen so their history has no gaps
+    m_scheduler.addProducer("sensors", 5000, 20, [this]() { m_deviceDB->updateSensorInfo(); });
+    // huge page & compressed swap efficiency only drifts, a slow look is enough
+    m_scheduler.addProducer("memory tuning", 10000, 20, [this]() { m_deviceDB->updateMemTuningInfo(); });
+    // views pull everything on statInfoUpdated, so it follows the process table cadence,
+    // device state is handed to them as one snapshot published right before
+    m_processTableProducer = m_scheduler.addProducer("process table", 2000, 500, [this]() {
+        m_processDB->update();
+        m_deviceDB->publishSnapshot();
+        emit statInfoUpdated();
+        recountAppAndProcess();
+    });
+    // process cpu usage & uptime based rates need fresh totals at scan time
+    m_scheduler.addDependency(m_processTableProducer, sysInfo);
+    m_scheduler.addDependency(m_processTableProducer, cpuStat);
+}
 
+void SystemMonitor::applyDemands(int gained)
+{
+    DemandTracker *tracker = DemandTracker::instance();
+    m_scheduler.setEnabled(m_cpuFreqProducer, tracker->isDemanded(DemandTracker::kCpuCoreDemand));
+    m_scheduler.setEnabled(m_runQueueProducer, tracker->isDemanded(DemandTracker::kCpuCoreDemand));
+    m_scheduler.setEnabled(m_netifProducer, tracker->isDemanded(DemandTracker::kNetifDemand));
+    // fds & sockets are read by the process scan, a scan now baselines rates for the next one
+    if (gained & DemandTracker::kProcessNetDemand)
+        m_scheduler.wake(m_processTableProducer);
+
+    // nothing runs before the monitor job starts, it refreshes everything itself
+    if (gained && m_basictimer.isActive())
+        m_scheduler.runDue(m_clock.elapsed());
+}
+
+void SystemMonitor::timerEvent(QTimerEvent *event)
+{
     QObject::timerEvent(event);
     if (event->timerId() == m_basictimer.timerId()) {
-        // qCDebug(app) << "Timer event triggered, cnt =" << cnt;
-        if(cnt & 0x0001){
-            // qCDebug(app) << "Updating system info, device DB, and process DB";
-            m_sysInfo->readSysInfo();
-            m_deviceDB->update();
-            m_processDB->update();
-        } else {
-            // qCDebug(app) << "Emitting statInfoUpdated and recounting apps/processes";
-            emit statInfoUpdated();
-            recountAppAndProcess();
-        }
-        if(cnt++ >250)
-            cnt = 0;
+        m_scheduler.setThrottled(m_backgroundMode);
+        m_scheduler.runDue(m_clock.elapsed());
     }
 }
 
 void SystemMonitor::updateSystemMonitorInfo()
 {
     qCDebug(app) << "Forcing update of system monitor info";
-    m_sysInfo->readSysInfo();
-    m_deviceDB->update();
-    m_processDB->update();
-
-    emit statInfoUpdated();
-    recountAppAndProcess();
+    m_scheduler.runAll(m_clock.elapsed());
 }
 
 /**
@@ -116,18 +240,12 @@ void SystemMonitor::updateSystemMonitorInfo()
 void SystemMonitor::recountAppAndProcess()
 {
     qCDebug(app) << "Recounting apps and processes";
-    ProcessSet *processSet = m_processDB->processSet();
-    // count all app
-    const QList<pid_t> &newpidlst = processSet->getPIDList();
-    int appCount = 0;
-    for (const auto &pid : newpidlst) {
-        auto process = processSet->getProcessById(pid);
-        if (process.appType() == kFilterApps)
-            appCount++;
-    }
+    // tabs are partitioned by the scan, nothing is counted here
+    const ProcessColumnsPtr columns = m_processDB->processSet()->columns();
+    int appCount = columns->members(kFilterApps).size();
 
-    qCDebug(app) << "App count:" << appCount << "Process count:" << newpidlst.size();
-    emit appAndProcCountUpdate(appCount, newpidlst.size());
+    qCDebug(app) << "App count:" << appCount << "Process count:" << columns->size();
+    emit appAndProcCountUpdate(appCount, columns->size());
 }
 
 } // namespace system
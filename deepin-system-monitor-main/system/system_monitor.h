@@ -6,8 +6,14 @@
 #ifndef SYSTEM_MONITOR_H
 #define SYSTEM_MONITOR_H
 
+#include "refresh_scheduler.h"
+
 #include <QObject>
 #include <QBasicTimer>
+#include <QElapsedTimer>
+
+#include <atomic>
+#include <memory>
 
 namespace core {
 namespace process {
@@ -22,6 +28,7 @@ namespace system {
 
 class DeviceDB;
 class SysInfo;
+class CPUHotplugMonitor;
 
 class SystemMonitor : public QObject
 {
@@ -43,20 +50,58 @@ public:
     ProcessDB *processDB();
 
     void startMonitorJob();
+    /**
+     * @brief Stretch refresh periods while nobody is watching, e.g. main window minimized.
+     * Safe to call from any thread.
+     */
+    void setBackgroundMode(bool background);
+    /**
+     * @brief Stop sampling altogether while nothing is shown, e.g. popup hidden, resuming
+     * refreshes whatever got due meanwhile. Safe to call from any thread.
+     */
+    void setPaused(bool paused);
+    /**
+     * @brief Refresh the process table, and everything views pull with it, every periodMs
+     * instead of the default 2s, e.g. for the headless exporter. Safe to call from any thread.
+     */
+    void setProcessRefreshPeriod(int periodMs);
+    /**
+     * @brief Refresh the views every intervalMs instead of kDefaultRefreshInterval, device producers
+     * & the base tick are scaled in proportion. Safe to call from any thread.
+     */
+    void setRefreshInterval(int intervalMs);
+
+    // refresh interval of the process table & the views the producer periods are registered for
+    static constexpr int kDefaultRefreshInterval = 2000;
 
 protected:
     void timerEvent(QTimerEvent *event);
 
 private:
+    void initProducers();
+    /**
+     * @brief Enable the producers of what visible views ask for, those gained run right away
+     */
+    void applyDemands(int gained);
     void updateSystemMonitorInfo();
     void recountAppAndProcess();
+    void startBaseTimer();
 
 private:
     SysInfo      *m_sysInfo;
     DeviceDB     *m_deviceDB;
     ProcessDB    *m_processDB;
+    std::unique_ptr<CPUHotplugMonitor> m_cpuHotplugMonitor;
 
     QBasicTimer m_basictimer;
+    int m_tick {kDefaultRefreshInterval / 2}; // ms, half the refresh interval
+    QElapsedTimer m_clock;
+    RefreshScheduler m_scheduler;
+    int m_processTableProducer {-1};
+    int m_cpuFreqProducer {-1};
+    int m_runQueueProducer {-1};
+    int m_netifProducer {-1};
+    std::atomic<bool> m_backgroundMode;
 };
 
 } // namespace system
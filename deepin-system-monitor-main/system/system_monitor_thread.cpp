@@ -8,6 +8,7 @@
 
 #include "system/system_monitor.h"
 #include "process/process_db.h"
+#include "common/thread_priority.h"
 
 #include <QReadLocker>
 #include <QWriteLocker>
@@ -23,8 +24,13 @@ SystemMonitorThread::SystemMonitorThread(QObject *parent)
     , m_monitor(new SystemMonitor())
 {
     qCDebug(app) << "SystemMonitorThread created";
+    // os thread name, shown by --self-stats & top -H
+    setObjectName("SystemMonitor");
     m_monitor->moveToThread(this);
     connect(this, &QThread::finished, this, &QObject::deleteLater);
+    // runs on the new thread before the monitor job is queued
+    const common::core::ThreadPriority &policy = common::core::ThreadPriority::sampling();
+    connect(this, &QThread::started, this, [&policy]() { policy.apply(); }, Qt::DirectConnection);
     connect(this, &QThread::started, m_monitor, &SystemMonitor::startMonitorJob);
 }
 
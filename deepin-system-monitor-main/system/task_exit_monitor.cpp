@@ -0,0 +1,178 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "task_exit_monitor.h"
+#include "ddlog.h"
+
+#include <QFile>
+
+#include <netlink/netlink.h>
+#include <netlink/socket.h>
+#include <netlink/msg.h>
+#include <netlink/genl/genl.h>
+#include <netlink/genl/ctrl.h>
+
+#include <linux/taskstats.h>
+
+#include <string.h>
+#include <unistd.h>
+
+#define SYSFS_CPU_POSSIBLE_PATH "/sys/devices/system/cpu/possible"
+
+using namespace DDLog;
+
+// exit storms between two ticks must fit, a record is a few hundred bytes
+const int kRecvBufferSize = 2 * 1024 * 1024;
+// first version with ac_tgid
+const int kTaskStatsTgidVersion = 11;
+
+namespace core {
+namespace system {
+
+TaskExitMonitor::TaskExitMonitor()
+    : m_sock(nullptr)
+    , m_cb(nullptr)
+    , m_family(-1)
+    , m_active(false)
+{
+    m_sock = nl_socket_alloc();
+    m_cb = nl_cb_alloc(NL_CB_DEFAULT);
+    if (!m_sock || !m_cb || genl_connect(m_sock) < 0) {
+        qCWarning(app) << "Failed to open taskstats exit netlink socket";
+        return;
+    }
+    m_family = genl_ctrl_resolve(m_sock, TASKSTATS_GENL_NAME);
+    if (m_family < 0) {
+        qCInfo(app) << "Taskstats not available, short lived processes are not recorded";
+        return;
+    }
+
+    // the kernel refuses masks beyond the possible cpus
+    QFile possible(SYSFS_CPU_POSSIBLE_PATH);
+    if (possible.open(QIODevice::ReadOnly))
+        m_cpumask = QString::fromLatin1(possible.readAll()).trimmed();
+    if (m_cpumask.isEmpty())
+        m_cpumask = QString("0-%1").arg(qMax(1L, sysconf(_SC_NPROCESSORS_CONF)) - 1);
+
+    nl_socket_set_buffer_size(m_sock, 0, kRecvBufferSize);
+    // exit records are unsolicited & may already arrive ahead of the ack, don't match sequences
+    nl_socket_disable_seq_check(m_sock);
+    // registering needs CAP_NET_ADMIN, the verdict is acked right away
+    if (!registerCpus(true))
+        return;
+    m_active = true;
+
+    nl_socket_disable_auto_ack(m_sock);
+    nl_socket_set_nonblocking(m_sock);
+    nl_cb_set(m_cb, NL_CB_VALID, NL_CB_CUSTOM, handleExit, nullptr);
+    qCInfo(app) << "Taskstats exit records active for cpus" << m_cpumask;
+}
+
+TaskExitMonitor::~TaskExitMonitor()
+{
+    if (m_active)
+        registerCpus(false);
+    if (m_cb)
+        nl_cb_put(m_cb);
+    if (m_sock)
+        nl_socket_free(m_sock);
+}
+
+bool TaskExitMonitor::registerCpus(bool enable)
+{
+    struct nl_msg *msg = nlmsg_alloc();
+    if (!msg)
+        return false;
+    const QByteArray mask = m_cpumask.toLatin1();
+    const int attr = enable ? TASKSTATS_CMD_ATTR_REGISTER_CPUMASK : TASKSTATS_CMD_ATTR_DEREGISTER_CPUMASK;
+    if (!genlmsg_put(msg, NL_AUTO_PORT, NL_AUTO_SEQ, m_family, 0, 0, TASKSTATS_CMD_GET, TASKSTATS_GENL_VERSION)
+            || nla_put_string(msg, attr, mask.constData()) < 0) {
+        nlmsg_free(msg);
+        return false;
+    }
+
+    int rc = nl_send_auto(m_sock, msg);
+    nlmsg_free(msg);
+    if (rc < 0) {
+        qCWarning(app) << "Failed to send taskstats listener registration:" << nl_geterror(rc);
+        return false;
+    }
+    // deregistering is best effort, the kernel drops listeners of closed sockets anyway
+    if (!enable)
+        return true;
+
+    rc = nl_wait_for_ack(m_sock);
+    if (rc < 0) {
+        qCInfo(app) << "Taskstats exit records not permitted, short lived processes are not recorded:" << nl_geterror(rc);
+        return false;
+    }
+    return true;
+}
+
+bool TaskExitMonitor::poll(QList<task_exit_t> &exits)
+{
+    if (!m_active)
+        return false;
+
+    bool intact = true;
+    nl_cb_set(m_cb, NL_CB_VALID, NL_CB_CUSTOM, handleExit, &exits);
+    for (;;) {
+        int rc = nl_recvmsgs(m_sock, m_cb);
+        if (rc >= 0)
+            continue;
+        if (rc == -NLE_AGAIN)
+            break;
+        // NLE_NOMEM here means the receive buffer overflowed (ENOBUFS) & records were dropped,
+        // the socket keeps working, read what's still queued
+        intact = false;
+        if (rc != -NLE_NOMEM) {
+            qCWarning(app) << "Taskstats exit receive failed:" << nl_geterror(rc);
+            break;
+        }
+    }
+    nl_cb_set(m_cb, NL_CB_VALID, NL_CB_CUSTOM, handleExit, nullptr);
+    return intact;
+}
+
+int TaskExitMonitor::handleExit(struct nl_msg *msg, void *arg)
+{
+    auto *exits = static_cast<QList<task_exit_t> *>(arg);
+    if (!exits)
+        return NL_SKIP;
+
+    task_exit_t exit;
+    if (parseExit(nlmsg_hdr(msg), exit))
+        exits->append(exit);
+    return NL_SKIP;
+}
+
+bool TaskExitMonitor::parseExit(const struct nlmsghdr *hdr, task_exit_t &exit)
+{
+    struct nlattr *tb[TASKSTATS_TYPE_MAX + 1];
+    struct nlattr *aggr[TASKSTATS_TYPE_MAX + 1];
+    auto *nlh = const_cast<struct nlmsghdr *>(hdr);
+    // the thread group aggregate of the last thread only sums delays, times come per task
+    if (nlmsg_parse(nlh, GENL_HDRLEN, tb, TASKSTATS_TYPE_MAX, nullptr) < 0 || !tb[TASKSTATS_TYPE_AGGR_PID])
+        return false;
+    if (nla_parse_nested(aggr, TASKSTATS_TYPE_MAX, tb[TASKSTATS_TYPE_AGGR_PID], nullptr) < 0
+            || !aggr[TASKSTATS_TYPE_PID] || !aggr[TASKSTATS_TYPE_STATS])
+        return false;
+
+    // older kernels send a shorter struct, missing fields stay 0
+    struct taskstats stats {};
+    memcpy(&stats, nla_data(aggr[TASKSTATS_TYPE_STATS]), qMin(size_t(nla_len(aggr[TASKSTATS_TYPE_STATS])), sizeof(stats)));
+    exit.pid = pid_t(nla_get_u32(aggr[TASKSTATS_TYPE_PID]));
+    exit.tgid = stats.version >= kTaskStatsTgidVersion && stats.ac_tgid ? pid_t(stats.ac_tgid) : exit.pid;
+    exit.ppid = pid_t(stats.ac_ppid);
+    exit.uid = uid_t(stats.ac_uid);
+    exit.name = QString::fromLocal8Bit(stats.ac_comm, int(strnlen(stats.ac_comm, sizeof(stats.ac_comm))));
+    exit.cpuTime = stats.ac_utime + stats.ac_stime;
+    exit.maxRss = stats.hiwater_rss;
+    exit.elapsed = stats.ac_etime;
+    exit.exitCode = int(stats.ac_exitcode);
+    return true;
+}
+
+} // namespace system
+} // namespace core
@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef TASK_EXIT_MONITOR_H
+#define TASK_EXIT_MONITOR_H
+
+#include <QList>
+#include <QString>
+
+#include <sys/types.h>
+
+struct nl_sock;
+struct nl_cb;
+struct nl_msg;
+struct nlmsghdr;
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Final accounting of an exited task (thread), from its taskstats exit record
+ */
+struct task_exit_t {
+    pid_t pid {0};
+    pid_t tgid {0}; // thread group, pid itself on kernels without ac_tgid (before linux 5.18)
+    pid_t ppid {0};
+    uid_t uid {0};
+    QString name; // comm at exit, set by the last exec
+    qulonglong cpuTime {0}; // utime + stime of the task, us
+    qulonglong maxRss {0}; // high watermark of the mm's rss, kB
+    qulonglong elapsed {0}; // lifetime, us
+    int exitCode {0};
+
+    // the group leader's record stands for the process, the others only add their cpu time
+    inline bool isProcess() const
+    {
+        return pid == tgid;
+    }
+};
+
+/**
+ * @brief Exit records of every task, pushed by the taskstats family to registered listeners
+ *
+ * Catches processes that start & exit between two scans, as compilers & cron jobs do. Records
+ * queue up on the socket & are read back by poll() without blocking. Listening needs
+ * CAP_NET_ADMIN, the source stays inactive otherwise. Sampling thread only.
+ */
+class TaskExitMonitor
+{
+public:
+    explicit TaskExitMonitor();
+    ~TaskExitMonitor();
+
+    /**
+     * @brief Whether the kernel accepted our registration for all cpus
+     */
+    inline bool isActive() const
+    {
+        return m_active;
+    }
+
+    /**
+     * @brief Take queued exit records, never blocks
+     * @param exits Records are appended in exit order
+     * @return false if some records were lost (receive buffer overflow) or the socket failed
+     */
+    bool poll(QList<task_exit_t> &exits);
+
+    /**
+     * @brief Parse a TASKSTATS_CMD_NEW exit record
+     * @return false if it carries no per task stats
+     */
+    static bool parseExit(const struct nlmsghdr *hdr, task_exit_t &exit);
+
+private:
+    Q_DISABLE_COPY(TaskExitMonitor)
+
+    bool registerCpus(bool enable);
+    static int handleExit(struct nl_msg *msg, void *arg);
+
+    struct nl_sock *m_sock;
+    struct nl_cb *m_cb;
+    int m_family;
+    bool m_active;
+    QString m_cpumask; // cpus registered for, e.g. "0-7"
+};
+
+} // namespace system
+} // namespace core
+
+#endif // TASK_EXIT_MONITOR_H
@@ -0,0 +1,192 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "task_stats.h"
+#include "ddlog.h"
+
+#include <netlink/netlink.h>
+#include <netlink/socket.h>
+#include <netlink/msg.h>
+#include <netlink/genl/genl.h>
+#include <netlink/genl/ctrl.h>
+
+#include <linux/taskstats.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PROC_TASK_DELAYACCT_PATH "/proc/sys/kernel/task_delayacct"
+
+using namespace DDLog;
+
+// a reply is a few hundred bytes, a whole batch stays queued until read back
+const int kRecvBufferSize = 256 * 1024;
+
+namespace core {
+namespace system {
+
+namespace {
+
+struct reply_context_t {
+    QHash<pid_t, task_io_t> *stats;
+    int replies;
+    int answered;
+    int error; // last error reply, negative errno
+};
+
+int errorHandler(struct sockaddr_nl *, struct nlmsgerr *err, void *arg)
+{
+    auto *context = static_cast<reply_context_t *>(arg);
+    // exited processes answer ESRCH
+    ++context->replies;
+    if (err->error != -ESRCH)
+        context->error = err->error;
+    return NL_SKIP;
+}
+
+} // namespace
+
+TaskStats::TaskStats()
+    : m_sock(nullptr)
+    , m_cb(nullptr)
+    , m_family(-1)
+    , m_active(false)
+{
+    m_sock = nl_socket_alloc();
+    m_cb = nl_cb_alloc(NL_CB_DEFAULT);
+    if (!m_sock || !m_cb || genl_connect(m_sock) < 0) {
+        qCWarning(app) << "Failed to open taskstats netlink socket";
+        return;
+    }
+    m_family = genl_ctrl_resolve(m_sock, TASKSTATS_GENL_NAME);
+    if (m_family < 0) {
+        qCInfo(app) << "Taskstats not available, fall back to /proc delay accounting";
+        return;
+    }
+    // replies are matched by tgid, not by sequence, nothing to ack
+    nl_socket_disable_seq_check(m_sock);
+    nl_socket_disable_auto_ack(m_sock);
+    nl_socket_set_nonblocking(m_sock);
+    nl_socket_set_buffer_size(m_sock, 0, kRecvBufferSize);
+    nl_cb_set(m_cb, NL_CB_VALID, NL_CB_CUSTOM, handleReply, nullptr);
+
+    // queries need CAP_NET_ADMIN, find out right away with our own pid
+    m_active = true;
+    QHash<pid_t, task_io_t> stats;
+    m_active = query({getpid()}, stats) == 1;
+    qCInfo(app) << "Taskstats active:" << m_active << "delay accounting:" << isDelayAccountingEnabled();
+}
+
+TaskStats::~TaskStats()
+{
+    if (m_cb)
+        nl_cb_put(m_cb);
+    if (m_sock)
+        nl_socket_free(m_sock);
+}
+
+int TaskStats::query(const QList<pid_t> &tgids, QHash<pid_t, task_io_t> &stats)
+{
+    if (!m_active)
+        return 0;
+
+    reply_context_t context {&stats, 0, 0, 0};
+    nl_cb_set(m_cb, NL_CB_VALID, NL_CB_CUSTOM, handleReply, &context);
+    nl_cb_err(m_cb, NL_CB_CUSTOM, errorHandler, &context);
+
+    for (int begin = 0; begin < tgids.size(); begin += kBatchSize) {
+        const int end = qMin(begin + kBatchSize, tgids.size());
+        int sent = 0;
+        for (int i = begin; i < end; ++i) {
+            struct nl_msg *msg = nlmsg_alloc();
+            if (!msg)
+                break;
+            if (!genlmsg_put(msg, NL_AUTO_PORT, NL_AUTO_SEQ, m_family, 0, 0, TASKSTATS_CMD_GET, TASKSTATS_GENL_VERSION)
+                    || nla_put_u32(msg, TASKSTATS_CMD_ATTR_TGID, uint32_t(tgids[i])) < 0) {
+                nlmsg_free(msg);
+                continue;
+            }
+            int rc = nl_send_auto(m_sock, msg);
+            nlmsg_free(msg);
+            if (rc < 0) {
+                qCWarning(app) << "Failed to send taskstats request:" << nl_geterror(rc);
+                break;
+            }
+            ++sent;
+        }
+
+        // the kernel answers each request while it's sent, read the batch back
+        context.replies = 0;
+        while (context.replies < sent) {
+            int rc = nl_recvmsgs(m_sock, m_cb);
+            if (rc < 0) {
+                if (rc != -NLE_AGAIN)
+                    qCWarning(app) << "Taskstats receive failed:" << nl_geterror(rc);
+                break;
+            }
+        }
+
+        if (context.error == -EPERM || context.error == -EACCES) {
+            qCInfo(app) << "Taskstats queries not permitted, fall back to /proc delay accounting";
+            m_active = false;
+            break;
+        }
+    }
+    return context.answered;
+}
+
+int TaskStats::handleReply(struct nl_msg *msg, void *arg)
+{
+    auto *context = static_cast<reply_context_t *>(arg);
+    if (!context)
+        return NL_SKIP;
+
+    ++context->replies;
+    pid_t tgid = 0;
+    task_io_t io;
+    if (parseReply(nlmsg_hdr(msg), tgid, io)) {
+        context->stats->insert(tgid, io);
+        ++context->answered;
+    }
+    return NL_SKIP;
+}
+
+bool TaskStats::parseReply(const struct nlmsghdr *hdr, pid_t &tgid, task_io_t &io)
+{
+    struct nlattr *tb[TASKSTATS_TYPE_MAX + 1];
+    struct nlattr *aggr[TASKSTATS_TYPE_MAX + 1];
+    auto *nlh = const_cast<struct nlmsghdr *>(hdr);
+    if (nlmsg_parse(nlh, GENL_HDRLEN, tb, TASKSTATS_TYPE_MAX, nullptr) < 0 || !tb[TASKSTATS_TYPE_AGGR_TGID])
+        return false;
+    if (nla_parse_nested(aggr, TASKSTATS_TYPE_MAX, tb[TASKSTATS_TYPE_AGGR_TGID], nullptr) < 0
+            || !aggr[TASKSTATS_TYPE_TGID] || !aggr[TASKSTATS_TYPE_STATS])
+        return false;
+
+    // older kernels send a shorter struct, missing fields stay 0
+    struct taskstats stats {};
+    memcpy(&stats, nla_data(aggr[TASKSTATS_TYPE_STATS]), qMin(size_t(nla_len(aggr[TASKSTATS_TYPE_STATS])), sizeof(stats)));
+    tgid = pid_t(nla_get_u32(aggr[TASKSTATS_TYPE_TGID]));
+    io.blkioDelay = stats.blkio_delay_total;
+    io.swapinDelay = stats.swapin_delay_total;
+    io.syscalls = stats.read_syscalls + stats.write_syscalls;
+    return true;
+}
+
+bool TaskStats::isDelayAccountingEnabled()
+{
+    int fd = open(PROC_TASK_DELAYACCT_PATH, O_RDONLY | O_CLOEXEC);
+    // before linux 5.14 delay accounting is on whenever it's built in
+    if (fd < 0)
+        return errno == ENOENT;
+
+    char c = '0';
+    ssize_t n = read(fd, &c, 1);
+    close(fd);
+    return n == 1 && c != '0';
+}
+
+} // namespace system
+} // namespace core
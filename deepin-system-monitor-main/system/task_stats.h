@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef TASK_STATS_H
+#define TASK_STATS_H
+
+#include <QHash>
+#include <QList>
+
+#include <sys/types.h>
+
+struct nl_sock;
+struct nl_cb;
+struct nl_msg;
+struct nlmsghdr;
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Delay accounting & io syscall counters of a thread group, cumulative
+ */
+struct task_io_t {
+    qulonglong blkioDelay {0}; // ns waited for block io
+    qulonglong swapinDelay {0}; // ns waited for pages to be swapped in
+    qulonglong syscalls {0}; // read & write syscalls
+};
+
+/**
+ * @brief Per process delay accounting from the taskstats generic netlink family
+ *
+ * Requests are sent in batches & the replies matched by tgid, the kernel answers them while
+ * they're sent, so a batch is read back without blocking. Queries need CAP_NET_ADMIN, the
+ * source stays inactive otherwise & callers fall back to delayacct_blkio_ticks of
+ * /proc/[pid]/stat with the syscall counts of /proc/[pid]/io. Delays stay 0 unless the
+ * kernel accounts them, see isDelayAccountingEnabled(). Sampling thread only.
+ */
+class TaskStats
+{
+public:
+    explicit TaskStats();
+    ~TaskStats();
+
+    /**
+     * @brief Whether the taskstats family was found & queries are permitted
+     */
+    inline bool isActive() const
+    {
+        return m_active;
+    }
+
+    /**
+     * @brief Query counters of many thread groups
+     * @param stats Counters by tgid, processes gone meanwhile are left out
+     * @return Number of thread groups answered
+     */
+    int query(const QList<pid_t> &tgids, QHash<pid_t, task_io_t> &stats);
+
+    /**
+     * @brief Parse a TASKSTATS_CMD_NEW reply
+     * @return false if it carries no thread group stats
+     */
+    static bool parseReply(const struct nlmsghdr *hdr, pid_t &tgid, task_io_t &io);
+
+    /**
+     * @brief Whether block io & swapin delays are accounted, kernel.task_delayacct since linux 5.14
+     */
+    static bool isDelayAccountingEnabled();
+
+    // requests in flight, their replies must fit the receive buffer
+    static constexpr int kBatchSize = 64;
+
+private:
+    Q_DISABLE_COPY(TaskStats)
+
+    static int handleReply(struct nl_msg *msg, void *arg);
+
+    struct nl_sock *m_sock;
+    struct nl_cb *m_cb;
+    int m_family;
+    bool m_active;
+};
+
+} // namespace system
+} // namespace core
+
+#endif // TASK_STATS_H
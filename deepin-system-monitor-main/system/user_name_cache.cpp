@@ -0,0 +1,244 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "user_name_cache.h"
+#include "ddlog.h"
+#include "common/task_executor.h"
+
+#include <QFile>
+
+#include <errno.h>
+#include <grp.h>
+#include <pwd.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+using namespace DDLog;
+using common::core::TaskExecutor;
+
+namespace core {
+namespace system {
+
+#define NSSWITCH_PATH "/etc/nsswitch.conf"
+#define ETC_PATH "/etc"
+
+Q_GLOBAL_STATIC(UserNameCache, theInstance)
+
+UserNameCache::UserNameCache()
+{
+    m_clock.start();
+    watchFiles();
+}
+
+UserNameCache::~UserNameCache()
+{
+    // lookups write to the cache, they can't outlive it
+    waitForLookups();
+    if (m_inotifyFd >= 0)
+        close(m_inotifyFd);
+}
+
+UserNameCache *UserNameCache::instance()
+{
+    return theInstance();
+}
+
+QByteArray UserNameCache::userName(uid_t uid)
+{
+    return name(kUserId, uid);
+}
+
+QByteArray UserNameCache::groupName(gid_t gid)
+{
+    return name(kGroupId, gid);
+}
+
+QByteArray UserNameCache::name(IdKind kind, quint32 id)
+{
+    QMutexLocker locker(&m_mutex);
+    drainFileEvents();
+
+    auto it = m_names[kind].find(id);
+    if (it == m_names[kind].end())
+        it = m_names[kind].insert(id, {{}, 0, false});
+    name_entry_t &entry = it.value();
+    if (!entry.pending && m_clock.elapsed() >= entry.expiresAt) {
+        entry.pending = true;
+        m_queued[kind] << id;
+        if (!m_lookupRunning) {
+            m_lookupRunning = true;
+            // nss may block on ldap or sssd, io pool threads are meant to wait
+            m_lookups = TaskExecutor::instance()->run(TaskExecutor::kIOTask, [this]() { resolveQueued(); });
+        }
+    }
+
+    return entry.name.isEmpty() ? QByteArray::number(id) : entry.name;
+}
+
+void UserNameCache::waitForLookups()
+{
+    forever {
+        QFuture<void> lookups;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (!m_lookupRunning)
+                return;
+            lookups = m_lookups;
+        }
+        lookups.waitForFinished();
+    }
+}
+
+void UserNameCache::resolveQueued()
+{
+    forever {
+        QVector<quint32> ids[kIdKindCount];
+        {
+            QMutexLocker locker(&m_mutex);
+            bool empty = true;
+            for (int kind = 0; kind < kIdKindCount; ++kind) {
+                ids[kind].swap(m_queued[kind]);
+                empty = empty && ids[kind].isEmpty();
+            }
+            if (empty) {
+                m_lookupRunning = false;
+                return;
+            }
+        }
+
+        // looked up without the lock, callers keep getting the names cached so far
+        QVector<QByteArray> names[kIdKindCount];
+        QVector<bool> resolved[kIdKindCount];
+        for (int kind = 0; kind < kIdKindCount; ++kind) {
+            for (quint32 id : ids[kind]) {
+                QByteArray name;
+                resolved[kind] << lookup(IdKind(kind), id, name);
+                names[kind] << name;
+            }
+        }
+
+        QMutexLocker locker(&m_mutex);
+        qint64 now = m_clock.elapsed();
+        for (int kind = 0; kind < kIdKindCount; ++kind) {
+            for (int i = 0; i < ids[kind].size(); ++i) {
+                name_entry_t &entry = m_names[kind][ids[kind][i]];
+                entry.pending = false;
+                // on lookup errors the previous name is kept & asked for again later
+                if (resolved[kind][i])
+                    entry.name = names[kind][i];
+                entry.expiresAt = now + (resolved[kind][i] && !entry.name.isEmpty() ? kNameTTL : kMissingTTL);
+            }
+        }
+    }
+}
+
+bool UserNameCache::lookup(IdKind kind, quint32 id, QByteArray &name)
+{
+    long size = sysconf(kind == kUserId ? _SC_GETPW_R_SIZE_MAX : _SC_GETGR_R_SIZE_MAX);
+    QByteArray buf(size > 0 ? int(size) : 1024, Qt::Uninitialized);
+
+    forever {
+        int rc;
+        if (kind == kUserId) {
+            struct passwd pwd;
+            struct passwd *result = nullptr;
+            rc = getpwuid_r(uid_t(id), &pwd, buf.data(), size_t(buf.size()), &result);
+            if (rc == 0)
+                name = result ? QByteArray(result->pw_name) : QByteArray();
+        } else {
+            struct group grp;
+            struct group *result = nullptr;
+            rc = getgrgid_r(gid_t(id), &grp, buf.data(), size_t(buf.size()), &result);
+            if (rc == 0)
+                name = result ? QByteArray(result->gr_name) : QByteArray();
+        }
+
+        if (rc == 0)
+            return true;
+        // large groups need more room for their member list
+        if (rc == ERANGE && buf.size() < (1 << 20)) {
+            buf.resize(buf.size() * 2);
+            continue;
+        }
+        qCWarning(app) << "Failed to look up" << (kind == kUserId ? "uid" : "gid") << id << strerror(rc);
+        return false;
+    }
+}
+
+bool UserNameCache::usesFiles(const QByteArray &nsswitch, const QByteArray &database)
+{
+    for (QByteArray line : nsswitch.split('\n')) {
+        int comment = line.indexOf('#');
+        if (comment >= 0)
+            line.truncate(comment);
+        int colon = line.indexOf(':');
+        if (colon < 0 || line.left(colon).trimmed() != database)
+            continue;
+
+        for (const QByteArray &source : line.mid(colon + 1).simplified().split(' ')) {
+            if (source == "files" || source == "compat")
+                return true;
+        }
+        return false;
+    }
+    return true;
+}
+
+void UserNameCache::watchFiles()
+{
+    QFile file(NSSWITCH_PATH);
+    QByteArray nsswitch = file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    if (!usesFiles(nsswitch, "passwd") && !usesFiles(nsswitch, "group")) {
+        qCDebug(app) << "Names don't come from files, they expire by ttl only";
+        return;
+    }
+
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd < 0) {
+        qCWarning(app) << "inotify unavailable, user names expire by ttl only:" << strerror(errno);
+        return;
+    }
+    // the dir is watched, passwd & group are replaced by rename when edited
+    if (inotify_add_watch(m_inotifyFd, ETC_PATH, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE) < 0) {
+        qCWarning(app) << "Failed to watch" << ETC_PATH << strerror(errno);
+        close(m_inotifyFd);
+        m_inotifyFd = -1;
+    }
+}
+
+void UserNameCache::drainFileEvents()
+{
+    if (m_inotifyFd < 0)
+        return;
+
+    bool changed[kIdKindCount] {};
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t len;
+    while ((len = read(m_inotifyFd, buf, sizeof(buf))) > 0) {
+        for (char *p = buf; p < buf + len;) {
+            auto *event = reinterpret_cast<struct inotify_event *>(p);
+            if (event->len > 0) {
+                if (strcmp(event->name, "passwd") == 0)
+                    changed[kUserId] = true;
+                else if (strcmp(event->name, "group") == 0)
+                    changed[kGroupId] = true;
+            }
+            p += sizeof(struct inotify_event) + event->len;
+        }
+    }
+
+    for (int kind = 0; kind < kIdKindCount; ++kind) {
+        if (!changed[kind])
+            continue;
+        qCDebug(app) << (kind == kUserId ? "passwd" : "group") << "changed, names expired";
+        for (auto &entry : m_names[kind]) {
+            if (!entry.pending)
+                entry.expiresAt = 0;
+        }
+    }
+}
+
+} // namespace system
+} // namespace core
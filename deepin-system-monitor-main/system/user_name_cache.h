@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef USER_NAME_CACHE_H
+#define USER_NAME_CACHE_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+
+#include <sys/types.h>
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Process wide cache of user & group names, resolved off the calling thread
+ *
+ * NSS lookups may block on LDAP or SSSD hosts, so a miss queues the id & returns it in decimal, ids
+ * queued meanwhile are resolved in one batch on the thread pool. Names are kept for kNameTTL, ids
+ * without an entry for kMissingTTL, expired names are still returned while they're resolved again.
+ * When passwd or group comes from files, changes of /etc/passwd & /etc/group expire their names at
+ * once. Thread safe.
+ */
+class UserNameCache
+{
+public:
+    UserNameCache();
+    ~UserNameCache();
+
+    static UserNameCache *instance();
+
+    /**
+     * @brief Name of uid, uid in decimal until it's resolved or if it has no passwd entry
+     */
+    QByteArray userName(uid_t uid);
+    /**
+     * @brief Name of gid, gid in decimal until it's resolved or if it has no group entry
+     */
+    QByteArray groupName(gid_t gid);
+    /**
+     * @brief Wait for queued lookups to finish
+     */
+    void waitForLookups();
+
+    /**
+     * @brief Whether \a database of nsswitch.conf content is looked up in /etc files
+     * @param database passwd or group, files are assumed when it isn't listed
+     */
+    static bool usesFiles(const QByteArray &nsswitch, const QByteArray &database);
+
+    static const qint64 kNameTTL = 10 * 60 * 1000; // ms
+    static const qint64 kMissingTTL = 60 * 1000; // ms
+
+private:
+    UserNameCache(const UserNameCache &) = delete;
+    UserNameCache &operator=(const UserNameCache &) = delete;
+
+    enum IdKind {
+        kUserId,
+        kGroupId,
+
+        kIdKindCount
+    };
+
+    struct name_entry_t {
+        QByteArray name; // empty when the id has no entry or isn't resolved yet
+        qint64 expiresAt; // m_clock msecs, 0 before the first lookup finished
+        bool pending; // queued for lookup
+    };
+
+    QByteArray name(IdKind kind, quint32 id);
+    /**
+     * @brief Resolve queued ids until none is left, runs on the thread pool
+     */
+    void resolveQueued();
+    static QByteArray lookup(IdKind kind, quint32 id, bool &found);
+    void watchFiles();
+    /**
+     * @brief Read queued inotify events without blocking, names of changed files are expired
+     */
+    void drainFileEvents();
+
+private:
+    QMutex m_mutex;
+    QHash<quint32, name_entry_t> m_names[kIdKindCount];
+    QVector<quint32> m_queued[kIdKindCount];
+    QFuture<void> m_lookups;
+    bool m_lookupRunning {false};
+    QElapsedTimer m_clock;
+    int m_inotifyFd {-1};
+};
+
+} // namespace system
+} // namespace core
+
+#endif // USER_NAME_CACHE_H
@@ -9,6 +9,14 @@
 #include<unistd.h>
 #include<sys/ioctl.h>
 #include <linux/wireless.h>
+#include <linux/nl80211.h>
+
+#include <netlink/genl/genl.h>
+#include <netlink/genl/ctrl.h>
+
+#include <QtGlobal>
+
+#include <utility>
 
 using namespace DDLog;
 namespace core{
@@ -19,6 +27,11 @@ wireless::wireless()
     , m_link_quality(0)
     , m_signal_levle(0)
     , m_noise_level(0)
+    , m_bitrate(0)
+    , m_nlsock(nullptr)
+    , m_nlcb(nullptr)
+    , m_nl80211_id(-1)
+    , m_nl80211_probed(false)
 {
     qCDebug(app) << "wireless object created with default constructor";
 }
@@ -29,6 +42,11 @@ wireless::wireless(QByteArray ifname)
     , m_link_quality(0)
     , m_signal_levle(0)
     , m_noise_level(0)
+    , m_bitrate(0)
+    , m_nlsock(nullptr)
+    , m_nlcb(nullptr)
+    , m_nl80211_id(-1)
+    , m_nl80211_probed(false)
 {
     qCDebug(app) << "wireless object created for interface:" << ifname;
     read_wireless_info();
@@ -36,6 +54,10 @@ wireless::wireless(QByteArray ifname)
 
 wireless::~wireless()
 {
+    if (m_nlcb)
+        nl_cb_put(m_nlcb);
+    if (m_nlsock)
+        nl_socket_free(m_nlsock);
     qCDebug(app) << "wireless object destroyed";
 }
 
@@ -59,11 +81,27 @@ unsigned char wireless::noise_level()
     return  m_noise_level;
 }
 
+unsigned int wireless::bitrate()
+{
+    return m_bitrate;
+}
+
 bool wireless::is_wireless()
 {
     return m_bwireless;
 }
 
+bool wireless::is_wireless_iface(const QByteArray &ifname)
+{
+    if (ifname.isEmpty())
+        return false;
+
+    // cfg80211 drivers expose phy80211, wext only ones the wireless directory
+    QByteArray path = "/sys/class/net/" + ifname;
+    return access((path + "/phy80211").constData(), F_OK) == 0
+           || access((path + "/wireless").constData(), F_OK) == 0;
+}
+
 bool wireless::read_wireless_info()
 {
     qCDebug(app) << "Reading wireless info for interface:" << m_ifname;
@@ -108,6 +146,11 @@ bool wireless::read_wireless_info()
     if(wrq.u.essid.flags != 0){
       m_essid = buffer;
     }
+    // optional, bitrate in b/s
+    memset(&wrq.u, 0, sizeof(wrq.u));
+    if (ioctl(sock, SIOCGIWRATE, &wrq) == 0) {
+        m_bitrate = wrq.u.bitrate.value > 0 ? unsigned(wrq.u.bitrate.value / 1000000) : 0;
+    }
     m_link_quality = stats.qual.qual;
     m_signal_levle = stats.qual.level;
     m_noise_level = stats.qual.noise;
@@ -117,5 +160,170 @@ bool wireless::read_wireless_info()
     return true;
 }
 
+namespace {
+
+int nl80211_error_handler(struct sockaddr_nl *, struct nlmsgerr *err, void *arg)
+{
+    *static_cast<int *>(arg) = err->error;
+    return NL_STOP;
+}
+
+int nl80211_finish_handler(struct nl_msg *, void *arg)
+{
+    *static_cast<int *>(arg) = 0;
+    return NL_SKIP;
+}
+
+int nl80211_ack_handler(struct nl_msg *, void *arg)
+{
+    *static_cast<int *>(arg) = 0;
+    return NL_STOP;
+}
+
+struct nlattr **parse_attrs(struct nl_msg *msg, struct nlattr **tb)
+{
+    struct genlmsghdr *gnlh = static_cast<struct genlmsghdr *>(nlmsg_data(nlmsg_hdr(msg)));
+    if (nla_parse(tb, NL80211_ATTR_MAX, genlmsg_attrdata(gnlh, 0), genlmsg_attrlen(gnlh, 0), nullptr) < 0)
+        return nullptr;
+    return tb;
+}
+
+// NL80211_CMD_GET_STATION, managed mode only has the station of the access point
+int parse_station(struct nl_msg *msg, void *arg)
+{
+    auto *stat = static_cast<std::pair<wireless_stat *, bool> *>(arg);
+    struct nlattr *tb[NL80211_ATTR_MAX + 1];
+    struct nlattr *sinfo[NL80211_STA_INFO_MAX + 1];
+    struct nlattr *rinfo[NL80211_RATE_INFO_MAX + 1];
+
+    if (!parse_attrs(msg, tb) || !tb[NL80211_ATTR_STA_INFO]
+            || nla_parse_nested(sinfo, NL80211_STA_INFO_MAX, tb[NL80211_ATTR_STA_INFO], nullptr) < 0)
+        return NL_SKIP;
+
+    if (sinfo[NL80211_STA_INFO_SIGNAL])
+        stat->first->signal_level = nla_get_u8(sinfo[NL80211_STA_INFO_SIGNAL]);
+    if (sinfo[NL80211_STA_INFO_TX_BITRATE]
+            && nla_parse_nested(rinfo, NL80211_RATE_INFO_MAX, sinfo[NL80211_STA_INFO_TX_BITRATE], nullptr) == 0) {
+        // in 100kb/s
+        if (rinfo[NL80211_RATE_INFO_BITRATE32])
+            stat->first->bitrate = nla_get_u32(rinfo[NL80211_RATE_INFO_BITRATE32]) / 10;
+        else if (rinfo[NL80211_RATE_INFO_BITRATE])
+            stat->first->bitrate = nla_get_u16(rinfo[NL80211_RATE_INFO_BITRATE]) / 10;
+    }
+    stat->second = true;
+    return NL_SKIP;
+}
+
+// NL80211_CMD_GET_INTERFACE
+int parse_interface(struct nl_msg *msg, void *arg)
+{
+    auto *stat = static_cast<wireless_stat *>(arg);
+    struct nlattr *tb[NL80211_ATTR_MAX + 1];
+
+    if (parse_attrs(msg, tb) && tb[NL80211_ATTR_SSID])
+        stat->essid = QByteArray(static_cast<const char *>(nla_data(tb[NL80211_ATTR_SSID])), nla_len(tb[NL80211_ATTR_SSID]));
+    return NL_SKIP;
+}
+
+// NL80211_CMD_GET_SURVEY, noise of the channel in use
+int parse_survey(struct nl_msg *msg, void *arg)
+{
+    auto *stat = static_cast<wireless_stat *>(arg);
+    struct nlattr *tb[NL80211_ATTR_MAX + 1];
+    struct nlattr *sinfo[NL80211_SURVEY_INFO_MAX + 1];
+
+    if (!parse_attrs(msg, tb) || !tb[NL80211_ATTR_SURVEY_INFO]
+            || nla_parse_nested(sinfo, NL80211_SURVEY_INFO_MAX, tb[NL80211_ATTR_SURVEY_INFO], nullptr) < 0)
+        return NL_SKIP;
+
+    if (sinfo[NL80211_SURVEY_INFO_IN_USE] && sinfo[NL80211_SURVEY_INFO_NOISE])
+        stat->noise_level = nla_get_u8(sinfo[NL80211_SURVEY_INFO_NOISE]);
+    return NL_SKIP;
+}
+
+} // namespace
+
+bool wireless::open_nl80211()
+{
+    if (m_nlsock)
+        return true;
+    if (m_nl80211_probed)
+        return false;
+    m_nl80211_probed = true;
+
+    m_nlsock = nl_socket_alloc();
+    m_nlcb = nl_cb_alloc(NL_CB_DEFAULT);
+    if (!m_nlsock || !m_nlcb || genl_connect(m_nlsock) < 0) {
+        qCWarning(app) << "Failed to open generic netlink socket";
+    } else if ((m_nl80211_id = genl_ctrl_resolve(m_nlsock, NL80211_GENL_NAME)) < 0) {
+        qCInfo(app) << "nl80211 not available, fallback to wireless extensions";
+    } else {
+        return true;
+    }
+
+    if (m_nlcb)
+        nl_cb_put(m_nlcb);
+    if (m_nlsock)
+        nl_socket_free(m_nlsock);
+    m_nlcb = nullptr;
+    m_nlsock = nullptr;
+    return false;
+}
+
+bool wireless::has_nl80211()
+{
+    return open_nl80211();
+}
+
+bool wireless::nl80211_request(int cmd, int flags, int ifindex, int (*handler)(struct nl_msg *, void *), void *arg)
+{
+    struct nl_msg *msg = nlmsg_alloc();
+    if (!msg)
+        return false;
+
+    if (!genlmsg_put(msg, NL_AUTO_PORT, NL_AUTO_SEQ, m_nl80211_id, 0, flags, uint8_t(cmd), 0)
+            || nla_put_u32(msg, NL80211_ATTR_IFINDEX, uint32_t(ifindex)) < 0) {
+        nlmsg_free(msg);
+        return false;
+    }
+    int rc = nl_send_auto(m_nlsock, msg);
+    nlmsg_free(msg);
+    if (rc < 0)
+        return false;
+
+    int err = 1;
+    nl_cb_err(m_nlcb, NL_CB_CUSTOM, nl80211_error_handler, &err);
+    nl_cb_set(m_nlcb, NL_CB_FINISH, NL_CB_CUSTOM, nl80211_finish_handler, &err);
+    nl_cb_set(m_nlcb, NL_CB_ACK, NL_CB_CUSTOM, nl80211_ack_handler, &err);
+    nl_cb_set(m_nlcb, NL_CB_VALID, NL_CB_CUSTOM, handler, arg);
+    while (err > 0) {
+        rc = nl_recvmsgs(m_nlsock, m_nlcb);
+        if (rc < 0) {
+            err = rc;
+            break;
+        }
+    }
+    return err == 0;
+}
+
+bool wireless::query(int ifindex, wireless_stat &stat)
+{
+    stat = wireless_stat();
+    if (ifindex <= 0 || !open_nl80211())
+        return false;
+
+    std::pair<wireless_stat *, bool> station {&stat, false};
+    if (!nl80211_request(NL80211_CMD_GET_STATION, NLM_F_DUMP, ifindex, parse_station, &station) || !station.second)
+        return false;
+
+    nl80211_request(NL80211_CMD_GET_INTERFACE, 0, ifindex, parse_interface, &stat);
+    nl80211_request(NL80211_CMD_GET_SURVEY, NLM_F_DUMP, ifindex, parse_survey, &stat);
+
+    // map -100 ~ -50 dBm to 0 ~ 100
+    int dbm = static_cast<signed char>(stat.signal_level);
+    stat.link_quality = static_cast<unsigned char>(qBound(0, 2 * (dbm + 100), 100));
+    return true;
+}
+
 }
 }
@@ -7,25 +7,65 @@
 #define WIRELESS_H
 #include <QByteArray>
 #include <netlink/route/link.h>
+
+struct nl_sock;
+struct nl_cb;
+struct nl_msg;
+
 namespace core {
 namespace system {
 
+struct wireless_stat {
+    QByteArray essid; // ssid of the associated network
+    unsigned char link_quality {0}; // 0 ~ 100
+    unsigned char signal_level {0}; // dBm, stored as u8 like wireless extensions do
+    unsigned char noise_level {0}; // dBm, stored as u8
+    unsigned int bitrate {0}; // tx bitrate, Mb/s
+};
+
+/**
+ * @brief Wireless link info
+ *
+ * wireless(ifname) probes one interface through wireless extension ioctls. A default
+ * constructed object keeps an nl80211 generic netlink socket open (created on first
+ * query, family id resolved once) & is meant to be long lived, see query().
+ */
 class wireless
 {
 public:
     wireless();
     explicit wireless(QByteArray ifname);
     ~wireless();
+
+    wireless(const wireless &) = delete;
+    wireless &operator=(const wireless &) = delete;
+
     // 服务器别号
     QByteArray essid();
     unsigned char link_quality();
     unsigned char signal_levle();
     unsigned char noise_level();
+    unsigned int bitrate();
 
     bool is_wireless();
+
+    /**
+     * @brief Check if interface is a wireless one from sysfs, no socket involved
+     */
+    static bool is_wireless_iface(const QByteArray &ifname);
+
+    /**
+     * @brief Read ssid, signal, noise & tx bitrate of interface through nl80211
+     * @return false if nl80211 is not available or interface is not associated
+     */
+    bool query(int ifindex, wireless_stat &stat);
+    bool has_nl80211();
+
 protected:
     bool read_wireless_info();
 
+    bool open_nl80211();
+    bool nl80211_request(int cmd, int flags, int ifindex, int (*handler)(struct nl_msg *, void *), void *arg);
 
 private:
     bool m_bwireless;
@@ -35,6 +75,13 @@ private:
     unsigned char m_link_quality;
     unsigned char m_signal_levle;
     unsigned char m_noise_level;
+    unsigned int m_bitrate;
+
+    struct nl_sock *m_nlsock;
+    struct nl_cb *m_nlcb;
+    int m_nl80211_id;
+    // socket open attempted, don't retry each query when nl80211 is missing
+    bool m_nl80211_probed;
 };
 
 
@@ -7,13 +7,38 @@
 #include "ddlog.h"
 
 #include <QByteArrayList>
+#include <QMutex>
+#include <QMutexLocker>
 
 #include "xcb/xcb.h"
 
+#include <memory>
+
 using namespace DDLog;
 namespace core {
 namespace wm {
 
+namespace {
+struct XReplyDeleter {
+    void operator()(void *p)
+    {
+        free(p);
+    }
+};
+
+// atom names by id, shared by all connections, atoms live as long as the x server
+struct AtomNames {
+    QMutex mutex;
+    QHash<xcb_atom_t, QByteArray> names;
+};
+
+AtomNames &sharedAtomNames()
+{
+    static AtomNames names;
+    return names;
+}
+} // namespace
+
 WMAtom::WMAtom()
     : m_atoms(ATOM_MAX)
 {
@@ -89,8 +114,45 @@ void WMAtom::initialize(xcb_connection_t *connection)
             m_atoms[i] = XCB_ATOM_NONE;
         }
     }
+
+    // reverse lookups, window types & states are classified by id
+    m_types.clear();
+    auto &shared = sharedAtomNames();
+    QMutexLocker locker(&shared.mutex);
+    for (i = 0; i < ATOM_MAX; i++) {
+        if (m_atoms[i] == XCB_ATOM_NONE)
+            continue;
+        m_types.insert(m_atoms[i], atom_t(i));
+        shared.names.insert(m_atoms[i], QByteArray(atomNames[i]));
+    }
     qCDebug(app) << "XCB atom initialization complete";
 }
 
+QByteArray WMAtom::atomName(xcb_connection_t *connection, xcb_atom_t atom)
+{
+    auto &shared = sharedAtomNames();
+    {
+        QMutexLocker locker(&shared.mutex);
+        auto it = shared.names.constFind(atom);
+        if (it != shared.names.constEnd())
+            return *it;
+    }
+
+    qCDebug(app) << "Looking up name for atom:" << atom;
+    QByteArray name;
+    std::unique_ptr<xcb_get_atom_name_reply_t, XReplyDeleter> reply(
+        xcb_get_atom_name_reply(connection, xcb_get_atom_name(connection, atom), nullptr));
+    if (reply) {
+        name = QByteArray(xcb_get_atom_name_name(reply.get()), xcb_get_atom_name_name_length(reply.get()));
+    } else {
+        qCWarning(app) << "Failed to get name for atom:" << atom;
+    }
+
+    // failures are kept too, so that bad ids aren't asked for again
+    QMutexLocker locker(&shared.mutex);
+    shared.names.insert(atom, name);
+    return name;
+}
+
 } // namespace wm
 } // namespace core
@@ -6,6 +6,8 @@
 #ifndef WM_ATOM_H
 #define WM_ATOM_H
 
+#include <QByteArray>
+#include <QHash>
 #include <QVector>
 
 #include <xcb/xcb.h>
@@ -81,11 +83,26 @@ public:
     };
 
     WMAtom();
+    /**
+     * @brief Intern all known atoms, requests are sent in one batch before any reply is waited for
+     */
     void initialize(xcb_connection_t *connection);
     inline xcb_atom_t atom(WMAtom::atom_t atom) const { return m_atoms[atom]; }
+    /**
+     * @brief Known atom an interned id stands for, ATOM_MAX if it's none of them
+     */
+    inline WMAtom::atom_t type(xcb_atom_t atom) const { return m_types.value(atom, ATOM_MAX); }
+
+    /**
+     * @brief Name of an atom of the session's x server
+     *
+     * Names are kept process wide, known atoms & ones asked before never round trip to the x server.
+     */
+    static QByteArray atomName(xcb_connection_t *connection, xcb_atom_t atom);
 
 private:
     QVector<xcb_atom_t> m_atoms;
+    QHash<xcb_atom_t, WMAtom::atom_t> m_types;
 };
 
 } // namespace wm
@@ -123,8 +123,6 @@ using XGetGeometryReply = std::unique_ptr<xcb_get_geometry_reply_t, XReplyDelete
 using XGetWindowAttributeReply = std::unique_ptr<xcb_get_window_attributes_reply_t, XReplyDeleter>;
 using XQueryTreeReply = std::unique_ptr<xcb_query_tree_reply_t, XReplyDeleter>;
 using XTransCoordsReply = std::unique_ptr<xcb_translate_coordinates_reply_t, XReplyDeleter>;
-using XGetAtomNameReply = std::unique_ptr<xcb_get_atom_name_reply_t, XReplyDeleter>;
-using XInternAtomReply = std::unique_ptr<xcb_intern_atom_reply_t, XReplyDeleter>;
 
 struct XDisconnector
 {
@@ -147,79 +145,95 @@ WMInfo::~WMInfo()
     qCDebug(app) << "WMInfo destroyed";
 }
 
+// side of grid cells windows are indexed by, in pixels
+const int kStackCellSize = 256;
+
+static inline int stackCell(int coord)
+{
+    // floor division, windows may reach out to negative coordinates
+    return coord >= 0 ? coord / kStackCellSize : -((-coord + kStackCellSize - 1) / kStackCellSize);
+}
+
 std::list<WMWindowArea> WMInfo::selectWindow(const QPoint &pos) const
 {
-    qCDebug(app) << "Selecting window at position:" << pos;
+    buildWindowStack();
     std::list<WMWindowArea> walist;
 
+    auto cell = m_stackCells.constFind(stackCellKey(stackCell(pos.x()), stackCell(pos.y())));
+    if (cell == m_stackCells.constEnd())
+        return walist;
+
+    for (int index : *cell) {
+        const auto &window = m_stack[size_t(index)];
+        if (!window.selectable || !window.rect.contains(pos))
+            continue;
+
+        WMWindowArea warea(new struct wm_window_area_t());
+        // window adjusted rect (including bounding frame)
+        warea->rect = window.rect;
+        warea->pid = window.pid;
+        warea->wid = window.wid;
+        walist.push_back(std::move(warea));
+    }
+
+    return walist;
+}
+
+void WMInfo::buildWindowStack() const
+{
+    if (m_stackBuilt || !m_tree || !m_tree->root)
+        return;
+    m_stackBuilt = true;
+
     std::function<void(const struct wm_window_ext_t *)> scan_tree;
     scan_tree = [&](const struct wm_window_ext_t *parent) {
         for (auto &childWindowId : parent->children) {
-            auto &child = m_tree->cache[childWindowId];
+            auto it = m_tree->cache.find(childWindowId);
+            if (it == m_tree->cache.end() || !it->second)
+                continue;
+            const auto &child = it->second;
 
             // check child first (top => bottom)
             if (child->children.length() > 0)
                 scan_tree(child.get());
 
-            // map state
-            if (child->map_state != kViewableState) {
-                qCDebug(app) << "Skipping window" << childWindowId << "due to non-viewable state";
+            // map state, window class, pid & window state
+            if (child->map_state != kViewableState
+                    || child->wclass != kInputOutputClass
+                    || child->pid == -1
+                    || child->states.contains(kHiddenState))
                 continue;
-            }
-
-            // window class
-            if (child->wclass != kInputOutputClass) {
-                qCDebug(app) << "Skipping window" << childWindowId << "due to non-input-output class";
-                continue;
-            }
-
-            if (child->pid == -1) {
-                qCDebug(app) << "Skipping window" << childWindowId << "due to missing PID";
-                continue;
-            }
 
             // window type
-            if (child->types.startsWith(kDockWindowType)
-                || child->types.startsWith(kDesktopWindowType)) {
-                qCDebug(app) << "Skipping window" << childWindowId << "due to dock/desktop type";
+            if (child->types.startsWith(kDesktopWindowType))
                 continue;
-            }
-
-            // window state
-            if (child->states.contains(kHiddenState)) {
-                qCDebug(app) << "Skipping window" << childWindowId << "due to hidden state";
-                continue;
-            }
-
-            WMWindowArea warea(new struct wm_window_area_t());
+            bool dock = child->types.startsWith(kDockWindowType);
 
             // rect & extents
-            QRect rect { child->rect };
-            rect = rect.marginsAdded({ int(child->extents.left),
-                                       int(child->extents.top),
-                                       int(child->extents.right),
-                                       int(child->extents.bottom) });
-
-            if (!rect.contains(pos)) {
-                qCDebug(app) << "Skipping window" << childWindowId << "as position is outside its bounds";
-                continue;
-            }
-
-            // window adjusted rect (including bounding frame)
-            warea->rect = rect;
-            // pid
-            warea->pid = child->pid;
-            warea->wid = child->windowId;
-
-            qCDebug(app) << "Selected window" << childWindowId << "with PID" << child->pid;
-            walist.push_back(std::move(warea));
+            QRect rect = child->rect.marginsAdded({ int(child->extents.left),
+                                                    int(child->extents.top),
+                                                    int(child->extents.right),
+                                                    int(child->extents.bottom) });
+            m_stackIndex.insert(child->windowId, int(m_stack.size()));
+            m_stack.push_back({ child->windowId, child->pid, rect, !dock });
         }
     };
-
     scan_tree(m_tree->root);
 
-    qCDebug(app) << "Window selection scan complete, found" << walist.size() << "matching windows";
-    return walist;
+    // parts off screen are never hovered, don't let bogus geometry spread over countless cells
+    const QRect screen = m_tree->root->rect;
+    for (int index = 0; index < int(m_stack.size()); ++index) {
+        QRect rect = m_stack[size_t(index)].rect;
+        if (screen.isValid())
+            rect = rect.intersected(screen);
+        if (rect.isEmpty())
+            continue;
+        for (int y = stackCell(rect.top()); y <= stackCell(rect.bottom()); ++y) {
+            for (int x = stackCell(rect.left()); x <= stackCell(rect.right()); ++x)
+                m_stackCells[stackCellKey(x, y)].push_back(index);
+        }
+    }
+    qCDebug(app) << "Window stack built with" << m_stack.size() << "windows in" << m_stackCells.size() << "cells";
 }
 
 WMWId WMInfo::getRootWindow() const
@@ -246,81 +260,23 @@ bool WMInfo::isCursorHoveringDocks(const QPoint &pos) const
 
 std::list<WMWindowArea> WMInfo::getHoveredByWindowList(WMWId wid, QRect &area) const
 {
+    buildWindowStack();
     std::list<WMWindowArea> list {};
-    bool done { false };
-
-    std::function<void(const struct wm_window_ext_t *, const QRect &)> scan_tree;
-    scan_tree = [&](const struct wm_window_ext_t *parent, const QRect &area) {
-        for (auto &childWindowId : parent->children) {
-            if (childWindowId == wid) {
-                done = true;
-            }
-
-            if (done) {
-                return;
-            }
 
-            auto &child = m_tree->cache[childWindowId];
-
-            // check child first (top => bottom)
-            if (child->children.length() > 0)
-                scan_tree(child.get(), area);
-
-            // map state
-            if (child->map_state != kViewableState) {
-                qCDebug(app) << "Skipping window" << childWindowId << "due to non-viewable state";
-                continue;
-            }
-
-            // window class
-            if (child->wclass != kInputOutputClass) {
-                qCDebug(app) << "Skipping window" << childWindowId << "due to non-input-output class";
-                continue;
-            }
-
-            if (child->pid == -1) {
-                qCDebug(app) << "Skipping window" << childWindowId << "due to missing PID";
-                continue;
-            }
-
-            // window type (dock type should exclude from this)
-            if (child->types.startsWith(kDesktopWindowType)) {
-                qCDebug(app) << "Skipping window" << childWindowId << "due to desktop type";
-                continue;
-            }
-
-            // window state
-            if (child->states.contains(kHiddenState)) {
-                qCDebug(app) << "Skipping window" << childWindowId << "due to hidden state";
-                continue;
-            }
-
-            // adjust child rect with frame extents
-            auto adjusted = child->rect;
-            adjusted = adjusted.marginsAdded(QMargins {
-                    int(child->extents.left),
-                    int(child->extents.top),
-                    int(child->extents.right),
-                    int(child->extents.bottom) });
-
-            // translate child geom
-            if (!adjusted.intersects(area)) {
-                qCDebug(app) << "Skipping window" << childWindowId << "as it doesn't intersect with area";
-                continue;
-            }
-
-            WMWindowArea warea(new struct wm_window_area_t());
-            warea->rect = adjusted;
-            warea->pid = child->pid;
-            warea->wid = child->windowId;
-
-            qCDebug(app) << "Added window" << childWindowId << "with PID" << child->pid << "to hover list";
-            list.push_back(std::move(warea));
-        }
-    };
-
-    Q_ASSERT(m_tree->root != nullptr);
-    scan_tree(m_tree->root, area);
+    // windows above wid come first in the stack, all of them when wid isn't picked from it
+    int above = m_stackIndex.value(wid, int(m_stack.size()));
+    for (int index = 0; index < above; ++index) {
+        const auto &window = m_stack[size_t(index)];
+        // dock windows hide picked ones too
+        if (!window.rect.intersects(area))
+            continue;
+
+        WMWindowArea warea(new struct wm_window_area_t());
+        warea->rect = window.rect;
+        warea->pid = window.pid;
+        warea->wid = window.wid;
+        list.push_back(std::move(warea));
+    }
 
     return list;
 }
@@ -435,116 +391,83 @@ void WMInfo::findDockWindows()
 
 void WMInfo::initAtomCache(xcb_connection_t *conn)
 {
-    QByteArray buffer {};
-
-    // _NET_WM_NAME
-    AtomMeta nameAtomMeta(new atom_meta {});
-    nameAtomMeta->name = "_NET_WM_NAME";
-    buffer = nameAtomMeta->name;
-    auto nameAtomCookie = xcb_intern_atom(conn, false, uint16_t(buffer.length()), buffer.data());
-
-    // UTF8_STRING
-    AtomMeta utf8StringAtomMeta(new atom_meta {});
-    utf8StringAtomMeta->name = "UTF8_STRING";
-    buffer = utf8StringAtomMeta->name;
-    auto utf8StringAtomCookie = xcb_intern_atom(conn, false, uint16_t(buffer.length()), buffer.data());
-
-    // _NET_WM_DESKTOP
-    AtomMeta desktopAtomMeta(new atom_meta {});
-    desktopAtomMeta->name = "_NET_WM_DESKTOP";
-    buffer = desktopAtomMeta->name;
-    auto desktopAtomCookie = xcb_intern_atom(conn, false, uint16_t(buffer.length()), buffer.data());
-
-    // _NET_WM_WINDOW_TYPE
-    AtomMeta windowTypeAtomMeta(new atom_meta {});
-    windowTypeAtomMeta->name = "_NET_WM_WINDOW_TYPE";
-    buffer = windowTypeAtomMeta->name;
-    auto windowTypeAtomCookie = xcb_intern_atom(conn, false, uint16_t(buffer.length()), buffer.data());
-
-    // _NET_WM_STATE
-    AtomMeta stateAtomMeta(new atom_meta {});
-    stateAtomMeta->name = "_NET_WM_STATE";
-    buffer = stateAtomMeta->name;
-    auto stateAtomCookie = xcb_intern_atom(conn, false, uint16_t(buffer.length()), buffer.data());
-
-    // _NET_WM_PID
-    AtomMeta pidAtomMeta(new atom_meta {});
-    pidAtomMeta->name = "_NET_WM_PID";
-    buffer = pidAtomMeta->name;
-    auto pidAtomCookie = xcb_intern_atom(conn, false, uint16_t(buffer.length()), buffer.data());
-
-    // _NET_FRAME_EXTENTS
-    AtomMeta frameExtentsAtomMeta(new atom_meta {});
-    frameExtentsAtomMeta->name = "_NET_FRAME_EXTENTS";
-    buffer = frameExtentsAtomMeta->name;
-    auto frameExtentsAtomCookie = xcb_intern_atom(conn, false, uint16_t(buffer.length()), buffer.data());
-
-    auto nameAtom = getAtom(conn, nameAtomCookie);
-    nameAtomMeta->atom = nameAtom;
-    auto utf8StringAtom = getAtom(conn, utf8StringAtomCookie);
-    utf8StringAtomMeta->atom = utf8StringAtom;
-    auto desktopAtom = getAtom(conn, desktopAtomCookie);
-    desktopAtomMeta->atom = desktopAtom;
-    auto windowTypeAtom = getAtom(conn, windowTypeAtomCookie);
-    windowTypeAtomMeta->atom = windowTypeAtom;
-    auto stateAtom = getAtom(conn, stateAtomCookie);
-    stateAtomMeta->atom = stateAtom;
-    auto pidAtom = getAtom(conn, pidAtomCookie);
-    pidAtomMeta->atom = pidAtom;
-    auto frameExtentsAtom = getAtom(conn, frameExtentsAtomCookie);
-    frameExtentsAtomMeta->atom = frameExtentsAtom;
-
-    m_internAtomCache[kNetNameAtom] = nameAtom;
-    m_internAtomCache[kUTF8StringAtom] = utf8StringAtom;
-    m_internAtomCache[kNetDesktopAtom] = desktopAtom;
-    m_internAtomCache[kNetWindowTypeAtom] = windowTypeAtom;
-    m_internAtomCache[kNetStateAtom] = stateAtom;
-    m_internAtomCache[kNetPIDAtom] = pidAtom;
-    m_internAtomCache[kNetFrameExtentsAtom] = frameExtentsAtom;
-
-    m_atomCache[nameAtom] = std::move(nameAtomMeta);
-    m_atomCache[utf8StringAtom] = std::move(utf8StringAtomMeta);
-    m_atomCache[desktopAtom] = std::move(desktopAtomMeta);
-    m_atomCache[windowTypeAtom] = std::move(windowTypeAtomMeta);
-    m_atomCache[stateAtom] = std::move(stateAtomMeta);
-    m_atomCache[pidAtom] = std::move(pidAtomMeta);
-    m_atomCache[frameExtentsAtom] = std::move(frameExtentsAtomMeta);
+    // all known atoms in one batch, types & states are then told apart without asking for names
+    m_atoms.initialize(conn);
 }
 
-xcb_atom_t WMInfo::getAtom(xcb_connection_t *conn, xcb_intern_atom_cookie_t &cookie)
+QByteArray WMInfo::getAtomName(xcb_connection_t *conn, xcb_atom_t atom)
 {
-    xcb_atom_t atom = XCB_ATOM_NONE;
-    XInternAtomReply reply(xcb_intern_atom_reply(conn, cookie, nullptr));
-    if (reply) {
-        atom = reply->atom;
-        qCDebug(app) << "Got atom:" << atom;
-    } else {
-        qCWarning(app) << "Failed to get atom";
-    }
-    return atom;
+    return WMAtom::atomName(conn, atom);
 }
 
-QByteArray WMInfo::getAtomName(xcb_connection_t *conn, xcb_atom_t atom)
+// window type an atom of _NET_WM_WINDOW_TYPE stands for
+static enum wm_window_type_t windowTypeOf(WMAtom::atom_t atom)
 {
-    if (m_atomCache.find(atom) == m_atomCache.end()) {
-        qCDebug(app) << "Looking up name for atom:" << atom;
-        AtomMeta meta(new struct atom_meta());
-        meta->atom = atom;
-
-        auto cookie = xcb_get_atom_name(conn, atom);
-        XGetAtomNameReply reply(xcb_get_atom_name_reply(conn, cookie, nullptr));
-        if (reply) {
-            auto len = xcb_get_atom_name_name_length(reply.get());
-            auto name = xcb_get_atom_name_name(reply.get());
-            meta->name = QByteArray { name, len };
-            qCDebug(app) << "Atom" << atom << "name:" << meta->name;
-        } else {
-            qCWarning(app) << "Failed to get name for atom:" << atom;
-        }
-        m_atomCache[atom] = std::move(meta);
+    switch (atom) {
+    case WMAtom::_NET_WM_WINDOW_TYPE_NORMAL:
+        return kNormalWindowType;
+    case WMAtom::_NET_WM_WINDOW_TYPE_DESKTOP:
+        return kDesktopWindowType;
+    case WMAtom::_NET_WM_WINDOW_TYPE_DOCK:
+        return kDockWindowType;
+    case WMAtom::_NET_WM_WINDOW_TYPE_TOOLBAR:
+        return kToolbarWindowType;
+    case WMAtom::_NET_WM_WINDOW_TYPE_MENU:
+        return kMenuWindowType;
+    case WMAtom::_NET_WM_WINDOW_TYPE_UTILITY:
+        return kUtilityWindowType;
+    case WMAtom::_NET_WM_WINDOW_TYPE_SPLASH:
+        return kSplashWindowType;
+    case WMAtom::_NET_WM_WINDOW_TYPE_DIALOG:
+        return kDialogWindowType;
+    case WMAtom::_NET_WM_WINDOW_TYPE_DROPDOWN_MENU:
+        return kDropdownMenuWindowType;
+    case WMAtom::_NET_WM_WINDOW_TYPE_POPUP_MENU:
+        return kPopupMenuWindowType;
+    case WMAtom::_NET_WM_WINDOW_TYPE_TOOLTIP:
+        return kTooltipWindowType;
+    case WMAtom::_NET_WM_WINDOW_TYPE_NOTIFICATION:
+        return kNotificationWindowType;
+    case WMAtom::_NET_WM_WINDOW_TYPE_COMBO:
+        return kComboWindowType;
+    case WMAtom::_NET_WM_WINDOW_TYPE_DND:
+        return kDNDWindowType;
+    default:
+        return kUnknownWindowType;
     }
+}
 
-    return m_atomCache[atom]->name;
+// window state an atom of _NET_WM_STATE stands for
+static enum wm_state_t windowStateOf(WMAtom::atom_t atom)
+{
+    switch (atom) {
+    case WMAtom::_NET_WM_STATE_MODAL:
+        return kModalState;
+    case WMAtom::_NET_WM_STATE_STICKY:
+        return kStickyState;
+    case WMAtom::_NET_WM_STATE_MAXIMIZED_VERT:
+        return kMaximizedVertState;
+    case WMAtom::_NET_WM_STATE_MAXIMIZED_HORZ:
+        return kMaximizedHorzState;
+    case WMAtom::_NET_WM_STATE_SHADED:
+        return kShadedState;
+    case WMAtom::_NET_WM_STATE_SKIP_TASKBAR:
+        return kSkipTaskbarState;
+    case WMAtom::_NET_WM_STATE_SKIP_PAGER:
+        return kSkipPagerState;
+    case WMAtom::_NET_WM_STATE_HIDDEN:
+        return kHiddenState;
+    case WMAtom::_NET_WM_STATE_FULLSCREEN:
+        return kFullScreenState;
+    case WMAtom::_NET_WM_STATE_ABOVE:
+        return kAboveState;
+    case WMAtom::_NET_WM_STATE_BELOW:
+        return kBelowState;
+    case WMAtom::_NET_WM_STATE_DEMANDS_ATTENTION:
+        return kDemandsAttentionState;
+    default:
+        return kUnknownState;
+    }
 }
 
 WMWindowExt WMInfo::requestWindowExtInfo(xcb_connection_t *conn, xcb_window_t window)
@@ -553,13 +476,13 @@ WMWindowExt WMInfo::requestWindowExtInfo(xcb_connection_t *conn, xcb_window_t wi
     std::unique_ptr<struct wm_request_t> req(new wm_request_t {});
     winfo->request = std::move(req);
 
-    auto nameAtom = m_internAtomCache[kNetNameAtom];
-    auto utf8StringAtom = m_internAtomCache[kUTF8StringAtom];
-    auto desktopAtom = m_internAtomCache[kNetDesktopAtom];
-    auto windowTypeAtom = m_internAtomCache[kNetWindowTypeAtom];
-    auto stateAtom = m_internAtomCache[kNetStateAtom];
-    auto pidAtom = m_internAtomCache[kNetPIDAtom];
-    auto frameExtentsAtom = m_internAtomCache[kNetFrameExtentsAtom];
+    auto nameAtom = m_atoms.atom(WMAtom::_NET_WM_NAME);
+    auto utf8StringAtom = m_atoms.atom(WMAtom::UTF8_STRING);
+    auto desktopAtom = m_atoms.atom(WMAtom::_NET_WM_DESKTOP);
+    auto windowTypeAtom = m_atoms.atom(WMAtom::_NET_WM_WINDOW_TYPE);
+    auto stateAtom = m_atoms.atom(WMAtom::_NET_WM_STATE);
+    auto pidAtom = m_atoms.atom(WMAtom::_NET_WM_PID);
+    auto frameExtentsAtom = m_atoms.atom(WMAtom::_NET_FRAME_EXTENTS);
 
     auto discard_reply = [&conn, &winfo]() {
         unsigned int seq {};
@@ -714,76 +637,17 @@ WMWindowExt WMInfo::requestWindowExtInfo(xcb_connection_t *conn, xcb_window_t wi
     if (windowTypeReply && windowTypeReply->type != XCB_NONE && windowTypeReply->value_len > 0) {
         auto *atoms = reinterpret_cast<xcb_atom_t *>(xcb_get_property_value(windowTypeReply.get()));
         Q_ASSERT(atoms != nullptr);
-        for (uint32_t i = 0; i < windowTypeReply->value_len; ++i) {
-            auto atomName = getAtomName(conn, atoms[i]);
-            if (atomName == "_NET_WM_WINDOW_TYPE_NORMAL") {
-                winfo->types << kNormalWindowType;
-            } else if (atomName == "_NET_WM_WINDOW_TYPE_DESKTOP") {
-                winfo->types << kDesktopWindowType;
-            } else if (atomName == "_NET_WM_WINDOW_TYPE_DOCK") {
-                winfo->types << kDockWindowType;
-            } else if (atomName == "_NET_WM_WINDOW_TYPE_TOOLBAR") {
-                winfo->types << kToolbarWindowType;
-            } else if (atomName == "_NET_WM_WINDOW_TYPE_MENU") {
-                winfo->types << kMenuWindowType;
-            } else if (atomName == "_NET_WM_WINDOW_TYPE_UTILITY") {
-                winfo->types << kUtilityWindowType;
-            } else if (atomName == "_NET_WM_WINDOW_TYPE_SPLASH") {
-                winfo->types << kSplashWindowType;
-            } else if (atomName == "_NET_WM_WINDOW_TYPE_DIALOG") {
-                winfo->types << kDialogWindowType;
-            } else if (atomName == "_NET_WM_WINDOW_TYPE_DROPDOWN_MENU") {
-                winfo->types << kDropdownMenuWindowType;
-            } else if (atomName == "_NET_WM_WINDOW_TYPE_POPUP_MENU") {
-                winfo->types << kPopupMenuWindowType;
-            } else if (atomName == "_NET_WM_WINDOW_TYPE_TOOLTIP") {
-                winfo->types << kTooltipWindowType;
-            } else if (atomName == "_NET_WM_WINDOW_TYPE_NOTIFICATION") {
-                winfo->types << kNotificationWindowType;
-            } else if (atomName == "_NET_WM_WINDOW_TYPE_COMBO") {
-                winfo->types << kComboWindowType;
-            } else if (atomName == "_NET_WM_WINDOW_TYPE_DND") {
-                winfo->types << kDNDWindowType;
-            } else {
-                winfo->types << kUnknownWindowType;
-            }   // !if
-        }   // !for
+        // atoms are interned once per connection, compare ids instead of asking for their names
+        for (uint32_t i = 0; i < windowTypeReply->value_len; ++i)
+            winfo->types << windowTypeOf(m_atoms.type(atoms[i]));
     }
     // state
     XGetPropertyReply stateReply(xcb_get_property_reply(conn, stateCookie, nullptr));
     if (stateReply && stateReply->type != XCB_NONE && stateReply->value_len > 0) {
         auto *atoms = reinterpret_cast<xcb_atom_t *>(xcb_get_property_value(stateReply.get()));
         Q_ASSERT(atoms != nullptr);
-        for (uint32_t i = 0; i < stateReply->value_len; ++i) {
-            auto atomName = getAtomName(conn, atoms[i]);
-            if (atomName == "_NET_WM_STATE_MODAL") {
-                winfo->states << kModalState;
-            } else if (atomName == "_NET_WM_STATE_STICKY") {
-                winfo->states << kStickyState;
-            } else if (atomName == "_NET_WM_STATE_MAXIMIZED_VERT") {
-                winfo->states << kMaximizedVertState;
-            } else if (atomName == "_NET_WM_STATE_MAXIMIZED_HORZ") {
-                winfo->states << kMaximizedHorzState;
-            } else if (atomName == "_NET_WM_STATE_SHADED") {
-                winfo->states << kShadedState;
-            } else if (atomName == "_NET_WM_STATE_SKIP_TASKBAR") {
-                winfo->states << kSkipTaskbarState;
-            } else if (atomName == "_NET_WM_STATE_SKIP_PAGER") {
-                winfo->states << kSkipPagerState;
-            } else if (atomName == "_NET_WM_STATE_HIDDEN") {
-                winfo->states << kHiddenState;
-            } else if (atomName == "_NET_WM_STATE_FULLSCREEN") {
-                winfo->states << kFullScreenState;
-            } else if (atomName == "_NET_WM_STATE_ABOVE") {
-                winfo->states << kAboveState;
-            } else if (atomName == "_NET_WM_STATE_BELOW") {
-                winfo->states << kBelowState;
-            } else if (atomName == "_NET_WM_STATE_DEMANDS_ATTENTION") {
-                winfo->states << kDemandsAttentionState;
-            } else {
-                winfo->states << kUnknownState;
-            }   // !if
-        }   // !for
+        for (uint32_t i = 0; i < stateReply->value_len; ++i)
+            winfo->states << windowStateOf(m_atoms.type(atoms[i]));
     }
     // PID
     XGetPropertyReply pidReply(xcb_get_property_reply(conn, pidCookie, nullptr));
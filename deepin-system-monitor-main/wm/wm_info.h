@@ -5,6 +5,9 @@
 #ifndef WM_INFO_H
 #define WM_INFO_H
 
+#include "wm_atom.h"
+
+#include <QHash>
 #include <QList>
 #include <QRect>
 #include <QPixmap>
@@ -20,6 +23,7 @@
 #include <memory>
 #include <map>
 #include <list>
+#include <vector>
 
 namespace core {
 // x11/xcb stuff
@@ -30,11 +34,9 @@ struct wm_window_ext_t;
 struct wm_request_t;
 struct wm_frame_extents_t;
 struct wm_tree_t;
-struct atom_meta;
 
 using WMWindow = std::unique_ptr<struct wm_window_t>;
 using WMWindowExt = std::unique_ptr<struct core::wm::wm_window_ext_t>;
-using AtomMeta      = std::unique_ptr<struct atom_meta>;
 using WMWindowArea  = std::unique_ptr<struct wm_window_area_t>;
 using WMWId         = xcb_window_t;
 using WMTree = std::unique_ptr<struct core::wm::wm_tree_t>;
@@ -45,11 +47,6 @@ struct wm_window_t {
     QString title {}; // _NET_WM_NAME && UTF8_STRING || WM_NAME
 };
 
-struct atom_meta {
-    QByteArray name;
-    xcb_atom_t atom;
-};
-
 struct wm_window_area_t {
     WMWId wid;
     pid_t pid;
@@ -58,20 +55,6 @@ struct wm_window_area_t {
 
 class WMInfo
 {
-    enum intern_atom_type {
-        kOtherAtom = -1,
-        kNetNameAtom = 0,
-        kUTF8StringAtom,
-        kNetDesktopAtom,
-        kNetWindowTypeAtom,
-        kNetStateAtom,
-        kNetPIDAtom,
-        kNetFrameExtentsAtom,
-        kNetVirtualRootsAtom,
-        kStateAtom,
-        kIconAtom
-    };
-
 public:
     WMInfo();
     ~WMInfo();
@@ -79,15 +62,36 @@ public:
     // top level window (including wm frame) in top to bottom order that contains cursor
     std::list<WMWindowArea> selectWindow(const QPoint &pos) const;
     WMWId getRootWindow() const;
+    // windows stacked above wid that intersect area, in top to bottom order
     std::list<WMWindowArea> getHoveredByWindowList(WMWId wid, QRect &area) const;
     bool isCursorHoveringDocks(const QPoint &pos) const;
 
 private:
+    /**
+     * @brief Window that can be picked or hide a picked one, desktop windows are left out
+     */
+    struct stacked_window_t {
+        WMWId wid;
+        pid_t pid;
+        QRect rect; // frame extents included
+        bool selectable; // not a dock, docks only hide windows below
+    };
+
     void buildWindowTreeSchema();
     void findDockWindows();
+    /**
+     * @brief Flatten the window tree once in top to bottom order & index it in a grid of screen cells
+     *
+     * The tree is a snapshot taken with the screenshot the picker shows, so it's built on first
+     * hit test & kept, mouse moves then only look at the windows of the cell under cursor.
+     */
+    void buildWindowStack() const;
+    static inline quint64 stackCellKey(int x, int y)
+    {
+        return (quint64(quint32(x)) << 32) | quint32(y);
+    }
 
     void initAtomCache(xcb_connection_t *conn);
-    inline xcb_atom_t getAtom(xcb_connection_t *conn, xcb_intern_atom_cookie_t &cookie);
     QByteArray getAtomName(xcb_connection_t *conn, xcb_atom_t atom);
 
     WMWindowExt requestWindowExtInfo(xcb_connection_t *conn, xcb_window_t window);
@@ -95,9 +99,14 @@ private:
 private:
     WMTree m_tree;
 
-    std::map<intern_atom_type, xcb_atom_t>  m_internAtomCache;
-    std::map<xcb_atom_t, AtomMeta>          m_atomCache;
+    WMAtom m_atoms;
     std::list<WMWindowArea> m_dockWindowList;
+
+    // filled on first hit test
+    mutable bool m_stackBuilt {false};
+    mutable std::vector<stacked_window_t> m_stack; // top to bottom
+    mutable QHash<WMWId, int> m_stackIndex;
+    mutable QHash<quint64, std::vector<int>> m_stackCells; // stack indexes by cell, in stacking order
 };
 
 } // !wm
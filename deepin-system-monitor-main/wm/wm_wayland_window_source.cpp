@@ -0,0 +1,157 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "wm_wayland_window_source.h"
+#include "ddlog.h"
+
+#include <QtDBus>
+
+#include <algorithm>
+
+using namespace DDLog;
+
+namespace core {
+namespace wm {
+
+const QString StatusNotifierWatcherService = "org.kde.StatusNotifierWatcher";
+const QString StatusNotifierWatcherPath = "/StatusNotifierWatcher";
+const QString StatusNotifierWatcherInterface = "org.kde.StatusNotifierWatcher";
+
+WMWaylandWindowSource::WMWaylandWindowSource(QObject *parent)
+    : WMWindowSource(parent)
+    , m_library("libdtkwmjack.so")
+{
+    qCDebug(app) << "WMWaylandWindowSource created";
+    auto init = reinterpret_cast<InitDtkWmDisplayPtr>(m_library.resolve("InitDtkWmDisplay"));
+    m_destroyDisplay = reinterpret_cast<DestoryDtkWmDisplayPtr>(m_library.resolve("DestoryDtkWmDisplay"));
+    m_getWindowStates = reinterpret_cast<GetAllWindowStatesListPtr>(m_library.resolve("GetAllWindowStatesList"));
+    if (!init || !m_getWindowStates) {
+        qCWarning(app) << "Failed to resolve window states of" << m_library.fileName() << m_library.errorString();
+        m_getWindowStates = nullptr;
+        return;
+    }
+    init();
+
+    // tray items register with the watcher, it tells when they come & go
+    auto bus = QDBusConnection::sessionBus();
+    bool registerWatched = bus.connect(StatusNotifierWatcherService, StatusNotifierWatcherPath, StatusNotifierWatcherInterface,
+                                       "StatusNotifierItemRegistered", this, SLOT(onTrayItemsChanged()));
+    bool unregisterWatched = bus.connect(StatusNotifierWatcherService, StatusNotifierWatcherPath, StatusNotifierWatcherInterface,
+                                         "StatusNotifierItemUnregistered", this, SLOT(onTrayItemsChanged()));
+    m_trayWatched = registerWatched && unregisterWatched;
+    if (!m_trayWatched)
+        qCWarning(app) << "Tray item changes can't be watched, tray items are listed on every refresh";
+}
+
+WMWaylandWindowSource::~WMWaylandWindowSource()
+{
+    if (m_getWindowStates && m_destroyDisplay)
+        m_destroyDisplay();
+}
+
+void WMWaylandWindowSource::onTrayItemsChanged()
+{
+    m_trayDirty = true;
+}
+
+bool WMWaylandWindowSource::refresh()
+{
+    if (!m_getWindowStates)
+        return false;
+
+    WindowState *states = nullptr;
+    int count = m_getWindowStates(&states);
+    bool changed = applyWindowStates(states, count);
+    // the list is allocated by the library for each call
+    free(states);
+
+    if (m_trayDirty.exchange(false) || !m_trayWatched)
+        changed = applyTrayItems(getTrayItems()) || changed;
+
+    if (changed)
+        rebuildAppCaches();
+    return changed;
+}
+
+bool WMWaylandWindowSource::applyWindowStates(const WindowState *states, int count)
+{
+    QVector<wm_window_t> windows;
+    windows.reserve(qMax(count, 0));
+    for (int i = 0; states && i < count; ++i) {
+        if (states[i].pid <= 0)
+            continue;
+        wm_window_t window {};
+        window.winId = WMWId(states[i].windowId);
+        window.pid = states[i].pid;
+        // no title is told, the app id names the window instead
+        window.title = QString::fromUtf8(states[i].resourceName, int(qstrnlen(states[i].resourceName, sizeof(states[i].resourceName))));
+        windows << window;
+    }
+
+    auto same = [](const wm_window_t &a, const wm_window_t &b) {
+        return a.winId == b.winId && a.pid == b.pid && a.title == b.title;
+    };
+    if (windows.size() == m_windows.size() && std::equal(windows.cbegin(), windows.cend(), m_windows.cbegin(), same))
+        return false;
+
+    m_windows = windows;
+    return true;
+}
+
+bool WMWaylandWindowSource::applyTrayItems(const QStringList &items)
+{
+    if (items == m_trayItems)
+        return false;
+
+    std::map<QString, pid_t> pids;
+    auto *busInterface = QDBusConnection::sessionBus().interface();
+    for (const auto &item : items) {
+        auto it = m_trayPids.find(item);
+        if (it != m_trayPids.end()) {
+            pids.insert(*it);
+            continue;
+        }
+        // items are named by their bus service, optionally followed by an object path
+        pid_t pid = -1;
+        if (busInterface) {
+            QDBusReply<uint> reply = busInterface->servicePid(item.section('/', 0, 0));
+            if (reply.isValid())
+                pid = pid_t(reply.value());
+        }
+        pids[item] = pid;
+    }
+    m_trayPids.swap(pids);
+    m_trayItems = items;
+    return true;
+}
+
+QStringList WMWaylandWindowSource::getTrayItems() const
+{
+    QDBusInterface busInterface(StatusNotifierWatcherService, StatusNotifierWatcherPath,
+                                "org.freedesktop.DBus.Properties", QDBusConnection::sessionBus());
+    QDBusReply<QDBusVariant> reply = busInterface.call("Get", StatusNotifierWatcherInterface, "RegisteredStatusNotifierItems");
+    if (!reply.isValid()) {
+        qCDebug(app) << "Failed to list tray items:" << reply.error().message();
+        return {};
+    }
+    return reply.value().variant().toStringList();
+}
+
+void WMWaylandWindowSource::rebuildAppCaches()
+{
+    // later windows in compositor order win, as the tray's first ones do
+    m_guiApps.clear();
+    for (const auto &window : m_windows)
+        m_guiApps[window.pid] = WMWindow(new struct wm_window_t(window));
+
+    m_trayApps.clear();
+    for (const auto &item : m_trayItems) {
+        auto it = m_trayPids.find(item);
+        if (it != m_trayPids.end() && it->second > 0)
+            m_trayApps.insert({it->second, WMWindow(new struct wm_window_t {0, it->second, {}})});
+    }
+}
+
+} // namespace wm
+} // namespace core
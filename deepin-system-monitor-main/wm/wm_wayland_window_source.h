@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef WM_WAYLAND_WINDOW_SOURCE_H
+#define WM_WAYLAND_WINDOW_SOURCE_H
+
+#include "wm_window_source.h"
+#include "3rdparty/displayjack/wayland_client.h"
+
+#include <QLibrary>
+#include <QStringList>
+#include <QVector>
+
+#include <atomic>
+
+namespace core {
+namespace wm {
+
+/**
+ * @brief Windows followed through the compositor's window states & status notifier tray items
+ *
+ * Window states are kept up to date by libdtkwmjack's own wayland connection, reading them is a local
+ * copy. Tray items are announced by the status notifier watcher.
+ */
+class WMWaylandWindowSource : public WMWindowSource
+{
+    Q_OBJECT
+
+public:
+    explicit WMWaylandWindowSource(QObject *parent = nullptr);
+    ~WMWaylandWindowSource() override;
+
+    /**
+     * @brief Whether window states of the compositor can be read
+     */
+    inline bool isValid() const { return m_getWindowStates != nullptr; }
+
+    bool refresh() override;
+
+private Q_SLOTS:
+    void onTrayItemsChanged();
+
+private:
+    typedef int (*InitDtkWmDisplayPtr)();
+    typedef void (*DestoryDtkWmDisplayPtr)();
+    typedef int (*GetAllWindowStatesListPtr)(WindowState **states);
+
+    /**
+     * @brief Keep window states of this refresh in compositor order
+     * @return true if windows opened, closed or changed pid or title
+     */
+    bool applyWindowStates(const WindowState *states, int count);
+    /**
+     * @brief Keep tray items registered, pids are asked for new items only
+     * @return true if items were registered or unregistered
+     */
+    bool applyTrayItems(const QStringList &items);
+    QStringList getTrayItems() const;
+    void rebuildAppCaches();
+
+private:
+    QLibrary m_library;
+    DestoryDtkWmDisplayPtr m_destroyDisplay {};
+    GetAllWindowStatesListPtr m_getWindowStates {};
+
+    QVector<wm_window_t> m_windows; // compositor order, topmost last
+    QStringList m_trayItems;
+    std::map<QString, pid_t> m_trayPids; // by tray item
+    // set from the dbus connection's thread
+    std::atomic_bool m_trayDirty {true};
+    bool m_trayWatched {false};
+};
+
+} // namespace wm
+} // namespace core
+
+#endif // WM_WAYLAND_WINDOW_SOURCE_H
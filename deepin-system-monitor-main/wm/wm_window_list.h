@@ -6,10 +6,9 @@
 #ifndef WM_WINDOW_LIST_H
 #define WM_WINDOW_LIST_H
 
-#include "wm_connection.h"
-#include "wm_atom.h"
 #include "wm_info.h"
 
+#include <QList>
 #include <QObject>
 
 namespace core {
@@ -21,6 +20,8 @@ class Process;
 namespace core {
 namespace wm {
 
+class WMWindowSource;
+
 union size_u {
     struct size_t {
         uint w;
@@ -42,7 +43,11 @@ public:
 
     int getAppCount();
 
-    QImage getWindowIcon(pid_t pid) const;
+    /**
+     * @brief Icon of the topmost window of a pid
+     * @param size Preferred side in pixels, the nearest embedded icon not smaller than it is picked
+     */
+    QImage getWindowIcon(pid_t pid, int size = 64) const;
     QString getWindowTitle(pid_t pid) const;
 
     bool isTrayApp(pid_t pid) const;
@@ -51,21 +56,19 @@ public:
     void addDesktopEntryApp(core::process::Process *proc);
 
     void removeDesktopEntryApp(pid_t pid);
+    /**
+     * @brief Follow window changes since the last refresh, as told by the session's window source
+     */
     void updateWindowListCache();
+    /**
+     * @brief Whether the last refresh changed the gui or tray app windows
+     */
+    inline bool windowsChanged() const { return m_windowsChanged; }
 
 private:
-    QList<WMWId> getTrayWindows() const;
-    WMWindow getWindowInfo(WMWId winId);
-    pid_t getWindowPid(WMWId window) const;
-    QStringList getWindowType(WMWId winId) const;
-    QByteArray getAtomName(xcb_connection_t *conn, xcb_atom_t atom) const;
-
-private:
-    std::map<pid_t, WMWindow> m_guiAppcache;
-    std::map<pid_t, WMWindow> m_trayAppcache;
-
     QList<pid_t> m_desktopEntryCache;
-    WMConnection m_conn;
+    WMWindowSource *m_source;
+    bool m_windowsChanged {false};
 };
 
 } // namespace wm
@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "wm_window_source.h"
+#include "wm_x11_window_source.h"
+#include "wm_wayland_window_source.h"
+#include "helper.hpp"
+#include "ddlog.h"
+
+using namespace DDLog;
+
+namespace core {
+namespace wm {
+
+WMWindowSource::WMWindowSource(QObject *parent)
+    : QObject(parent)
+{
+}
+
+WMWindowSource *WMWindowSource::create(QObject *parent)
+{
+    if (qEnvironmentVariable("XDG_SESSION_TYPE") == "wayland" || common::systemInfo().isTreeLand()) {
+        auto *source = new WMWaylandWindowSource(parent);
+        if (source->isValid()) {
+            qCDebug(app) << "Windows are followed through compositor window states";
+            return source;
+        }
+        qCWarning(app) << "Compositor window states unavailable, windows are followed through x11";
+        delete source;
+    }
+    return new WMX11WindowSource(parent);
+}
+
+QImage WMWindowSource::windowIcon(pid_t pid, int size) const
+{
+    Q_UNUSED(pid);
+    Q_UNUSED(size);
+    return {};
+}
+
+} // namespace wm
+} // namespace core
@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef WM_WINDOW_SOURCE_H
+#define WM_WINDOW_SOURCE_H
+
+#include "wm_info.h"
+
+#include <QImage>
+#include <QObject>
+
+#include <map>
+
+namespace core {
+namespace wm {
+
+/**
+ * @brief Where windows of gui & tray apps are learnt from, one backend per display server
+ */
+class WMWindowSource : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit WMWindowSource(QObject *parent = nullptr);
+    ~WMWindowSource() override = default;
+
+    /**
+     * @brief Backend of the running session, compositor window states are used on wayland when available
+     */
+    static WMWindowSource *create(QObject *parent = nullptr);
+
+    /**
+     * @brief Pick up window changes announced since the last refresh
+     * @return true if gui or tray app windows changed
+     */
+    virtual bool refresh() = 0;
+    /**
+     * @brief Icon of the topmost window of a pid, null when the backend can't tell
+     * @param size Preferred side in pixels
+     */
+    virtual QImage windowIcon(pid_t pid, int size) const;
+
+    // pid keyed, one window per pid
+    inline const std::map<pid_t, WMWindow> &guiApps() const { return m_guiApps; }
+    inline const std::map<pid_t, WMWindow> &trayApps() const { return m_trayApps; }
+
+protected:
+    std::map<pid_t, WMWindow> m_guiApps;
+    std::map<pid_t, WMWindow> m_trayApps;
+};
+
+} // namespace wm
+} // namespace core
+
+#endif // WM_WINDOW_SOURCE_H
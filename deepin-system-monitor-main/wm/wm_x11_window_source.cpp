@@ -0,0 +1,417 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "wm_x11_window_source.h"
+#include "helper.hpp"
+#include "ddlog.h"
+
+#include <QtDBus>
+
+#include <xcb/xcb.h>
+
+#include <string.h>
+
+using namespace DDLog;
+
+namespace core {
+namespace wm {
+
+struct XReplyDeleter {
+    void operator()(void *p)
+    {
+        free(p);
+    }
+};
+using XGetPropertyReply = std::unique_ptr<xcb_get_property_reply_t, XReplyDeleter>;
+
+const int maxImageW = 1024;
+const int maxImageH = 1024;
+const int offsetImagePointerWH = 2;
+
+WMX11WindowSource::WMX11WindowSource(QObject *parent)
+    : WMWindowSource(parent)
+{
+    qCDebug(app) << "WMX11WindowSource created";
+    // client list changes are announced as property changes of the root window
+    watchWindow(m_conn.rootWindow());
+    xcb_flush(m_conn.xcb_connection());
+
+    // tray icons are listed by the dock, it tells when they change
+    auto bus = QDBusConnection::sessionBus();
+    bool propsWatched = bus.connect(common::systemInfo().TrayManagerService, common::systemInfo().TrayManagerPath,
+                                    common::systemInfo().TrayManagerInterface, "PropertiesChanged",
+                                    this, SLOT(onTrayIconsChanged()));
+    bool addWatched = bus.connect(common::systemInfo().TrayManagerService, common::systemInfo().TrayManagerPath,
+                                  common::systemInfo().TrayManagerService, "Added", this, SLOT(onTrayIconsChanged()));
+    bool removeWatched = bus.connect(common::systemInfo().TrayManagerService, common::systemInfo().TrayManagerPath,
+                                     common::systemInfo().TrayManagerService, "Removed", this, SLOT(onTrayIconsChanged()));
+    m_trayWatched = propsWatched || (addWatched && removeWatched);
+    if (!m_trayWatched)
+        qCWarning(app) << "Tray icon changes can't be watched, tray windows are listed on every refresh";
+}
+
+void WMX11WindowSource::onTrayIconsChanged()
+{
+    m_trayDirty = true;
+}
+
+QImage WMX11WindowSource::windowIcon(pid_t pid, int size) const
+{
+    qCDebug(app) << "Getting window icon for pid:" << pid;
+    auto search = m_guiApps.find(pid);
+    if (search == m_guiApps.end())
+        return {};
+
+    WMWId winId = search->second->winId;
+    auto cached = m_windowIcons.find(winId);
+    if (cached != m_windowIcons.end() && cached->second.size == size)
+        return cached->second.image;
+
+    QImage image = fetchWindowIcon(winId, size);
+    if (image.isNull())
+        qCDebug(app) << "Failed to get/parse window icon for pid:" << pid;
+    m_windowIcons[winId] = {size, image};
+    return image;
+}
+
+QImage WMX11WindowSource::fetchWindowIcon(WMWId winId, int size) const
+{
+    auto *conn = m_conn.xcb_connection();
+    const xcb_atom_t iconAtom = m_conn.atom(WMAtom::_NET_WM_ICON);
+
+    // property is a list of width, height & width * height ARGB pixels, in 32 bit units
+    uint32_t offset = 0;
+    uint32_t bestOffset = 0;
+    int bestW = 0;
+    int bestH = 0;
+    forever {
+        auto cookie = xcb_get_property(conn, false, winId, iconAtom, XCB_ATOM_ANY, offset, offsetImagePointerWH);
+        XGetPropertyReply reply(xcb_get_property_reply(conn, cookie, nullptr));
+        if (!reply || reply->format != 32 || reply->value_len < uint32_t(offsetImagePointerWH))
+            break;
+
+        const uint32_t *header = reinterpret_cast<const uint32_t *>(xcb_get_property_value(reply.get()));
+        int w = static_cast<int>(header[0]);
+        int h = static_cast<int>(header[1]);
+        if (w <= 0 || h <= 0 || w > maxImageW || h > maxImageH)
+            break;
+
+        // bytes left after the header must hold the pixels
+        uint32_t pixels = uint32_t(w * h);
+        if (reply->bytes_after / 4 < pixels)
+            break;
+
+        if (preferIconSize(w, h, bestW, bestH, size)) {
+            bestOffset = offset + offsetImagePointerWH;
+            bestW = w;
+            bestH = h;
+        }
+
+        offset += offsetImagePointerWH + pixels;
+        if (reply->bytes_after / 4 == pixels)
+            break;
+    }
+    if (!bestW)
+        return {};
+
+    auto cookie = xcb_get_property(conn, false, winId, iconAtom, XCB_ATOM_ANY, bestOffset, uint32_t(bestW * bestH));
+    XGetPropertyReply reply(xcb_get_property_reply(conn, cookie, nullptr));
+    if (!reply || reply->format != 32 || int(reply->value_len) < bestW * bestH)
+        return {};
+
+    QImage img(bestW, bestH, QImage::Format_ARGB32);
+    const uint32_t *pixels = reinterpret_cast<const uint32_t *>(xcb_get_property_value(reply.get()));
+    for (int y = 0; y < bestH; ++y)
+        memcpy(img.scanLine(y), pixels + y * bestW, size_t(bestW) * sizeof(uint32_t));
+    return img;
+}
+
+bool WMX11WindowSource::preferIconSize(int w, int h, int bestW, int bestH, int size)
+{
+    if (!bestW || !bestH)
+        return true;
+
+    int side = qMax(w, h);
+    int bestSide = qMax(bestW, bestH);
+    if (bestSide < size)
+        return side > bestSide;
+    return side >= size && side < bestSide;
+}
+
+QList<WMWId> WMX11WindowSource::getTrayWindows() const
+{
+    QDBusInterface busInterface(common::systemInfo().TrayManagerService, common::systemInfo().TrayManagerPath,
+                                common::systemInfo().TrayManagerInterface, QDBusConnection::sessionBus());
+    QDBusMessage reply = busInterface.call("Get", common::systemInfo().TrayManagerService, "TrayIcons");
+    QVariant v = reply.arguments().first();
+    const QDBusArgument &argument = v.value<QDBusVariant>().variant().value<QDBusArgument>();
+
+    argument.beginArray();
+    QList<WMWId> winIds;
+    while (!argument.atEnd()) {
+        WMWId winId;
+
+        argument >> winId;
+        winIds << winId;
+    }
+    argument.endArray();
+
+    return winIds;
+}
+
+bool WMX11WindowSource::refresh()
+{
+    bool changed = false;
+    drainEvents();
+
+    bool trayDirty = m_trayDirty.exchange(false) || !m_trayWatched;
+    if (!m_clientsDirty && !trayDirty && m_staleWindows.isEmpty())
+        return false;
+
+    auto *conn = m_conn.xcb_connection();
+    xcb_get_property_cookie_t listCookie {};
+    if (m_clientsDirty) {
+        listCookie = xcb_get_property(conn, 0, m_conn.rootWindow(), m_conn.atom(WMAtom::_NET_CLIENT_LIST_STACKING), XCB_ATOM_WINDOW, 0, UINT_MAX);
+        xcb_flush(conn);
+    }
+    // tray windows are asked from the dock while the x server replies
+    QList<WMWId> trayWndList = trayDirty ? getTrayWindows() : m_trayList;
+
+    // requests of all new or changed windows go out first & replies are collected after, so a refresh
+    // waits for about one round trip instead of several per window
+    std::vector<WindowRequest> clientRequests;
+    if (listCookie.sequence) {
+        XGetPropertyReply reply(xcb_get_property_reply(conn, listCookie, nullptr));
+        if (reply) {
+            m_clientsDirty = false;
+            const xcb_get_property_reply_t *R = reply.get();
+            xcb_window_t *clientList = reinterpret_cast<xcb_window_t *>(xcb_get_property_value(R));
+            int count = xcb_get_property_value_length(R) / int(sizeof(xcb_window_t));
+            m_clientList.clear();
+            for (int i = 0; i < count; i++)
+                m_clientList << clientList[i];
+
+            // forget closed windows
+            QSet<WMWId> current(m_clientList.begin(), m_clientList.end());
+            for (auto it = m_clientWindows.begin(); it != m_clientWindows.end();) {
+                if (current.contains(it->first)) {
+                    ++it;
+                    continue;
+                }
+                m_windowIcons.erase(it->first);
+                it = m_clientWindows.erase(it);
+                changed = true;
+            }
+            m_otherWindows.intersect(current);
+            m_staleWindows.intersect(current);
+
+            for (auto wid : m_clientList) {
+                if (m_clientWindows.count(wid) || m_otherWindows.contains(wid))
+                    continue;
+                watchWindow(wid);
+                clientRequests.push_back(sendWindowRequest(wid, true));
+                // asked in full already
+                m_staleWindows.remove(wid);
+            }
+        }
+    }
+
+    std::vector<WindowRequest> staleRequests;
+    for (auto wid : m_staleWindows) {
+        if (m_clientWindows.count(wid))
+            staleRequests.push_back(sendWindowRequest(wid, false));
+    }
+    m_staleWindows.clear();
+
+    std::vector<WindowRequest> trayRequests;
+    if (trayDirty) {
+        QSet<WMWId> current(trayWndList.begin(), trayWndList.end());
+        for (auto it = m_trayWindows.begin(); it != m_trayWindows.end();) {
+            if (current.contains(it->first)) {
+                ++it;
+                continue;
+            }
+            it = m_trayWindows.erase(it);
+            changed = true;
+        }
+        for (auto wid : trayWndList) {
+            if (!m_trayWindows.count(wid))
+                trayRequests.push_back(sendWindowRequest(wid, false));
+        }
+        m_trayList = trayWndList;
+    }
+    xcb_flush(conn);
+    qCDebug(app) << "Requested info of" << clientRequests.size() << "new client," << staleRequests.size()
+                 << "changed client &" << trayRequests.size() << "new tray windows";
+
+    for (const auto &request : clientRequests) {
+        auto winfo = takeWindowInfo(request);
+        bool appWindow = takeAppWindowType(request);
+        if (winfo && appWindow) {
+            m_clientWindows[request.winId] = *winfo;
+            changed = true;
+        } else {
+            m_otherWindows.insert(request.winId);
+        }
+    }
+    for (const auto &request : staleRequests) {
+        auto winfo = takeWindowInfo(request);
+        auto &window = m_clientWindows[request.winId];
+        changed = changed || window.pid != winfo->pid;
+        window.pid = winfo->pid;
+        window.title = winfo->title;
+    }
+    for (const auto &request : trayRequests) {
+        auto winfo = takeWindowInfo(request);
+        m_trayWindows[request.winId] = *winfo;
+        changed = true;
+    }
+
+    rebuildAppCaches();
+    return changed;
+}
+
+void WMX11WindowSource::rebuildAppCaches()
+{
+    // later windows in stacking order win, as the tray's first ones do
+    m_guiApps.clear();
+    for (auto wid : m_clientList) {
+        auto it = m_clientWindows.find(wid);
+        if (it != m_clientWindows.end())
+            m_guiApps[it->second.pid] = WMWindow(new struct wm_window_t(it->second));
+    }
+
+    m_trayApps.clear();
+    for (auto wid : m_trayList) {
+        auto it = m_trayWindows.find(wid);
+        if (it != m_trayWindows.end() && it->second.pid > 0)
+            m_trayApps.insert({it->second.pid, WMWindow(new struct wm_window_t(it->second))});
+    }
+}
+
+void WMX11WindowSource::watchWindow(WMWId winId) const
+{
+    uint32_t mask = XCB_EVENT_MASK_PROPERTY_CHANGE;
+    xcb_change_window_attributes(m_conn.xcb_connection(), winId, XCB_CW_EVENT_MASK, &mask);
+}
+
+void WMX11WindowSource::drainEvents()
+{
+    auto *conn = m_conn.xcb_connection();
+    xcb_generic_event_t *event;
+    // errors of requests on windows closed meanwhile land here too & are dropped
+    while ((event = xcb_poll_for_event(conn))) {
+        if ((event->response_type & ~0x80) == XCB_PROPERTY_NOTIFY) {
+            auto *notify = reinterpret_cast<xcb_property_notify_event_t *>(event);
+            if (notify->window == m_conn.rootWindow()) {
+                if (notify->atom == m_conn.atom(WMAtom::_NET_CLIENT_LIST_STACKING))
+                    m_clientsDirty = true;
+            } else if (notify->atom == m_conn.atom(WMAtom::_NET_WM_WINDOW_TYPE)) {
+                // asked again in full with the client list
+                m_clientWindows.erase(notify->window);
+                m_otherWindows.remove(notify->window);
+                m_clientsDirty = true;
+            } else if (notify->atom == m_conn.atom(WMAtom::_NET_WM_ICON)) {
+                // fetched again on next request
+                m_windowIcons.erase(notify->window);
+            } else if (notify->atom == m_conn.atom(WMAtom::_NET_WM_PID)
+                       || notify->atom == m_conn.atom(WMAtom::_NET_WM_NAME)
+                       || notify->atom == XCB_ATOM_WM_NAME) {
+                m_staleWindows.insert(notify->window);
+            }
+        }
+        free(event);
+    }
+}
+
+pid_t WMX11WindowSource::getWindowPid(WMWId winId) const
+{
+    qCDebug(app) << "Getting PID for window ID:" << winId;
+    auto *conn = m_conn.xcb_connection();
+    auto pidCookie = xcb_get_property(conn, 0, winId, m_conn.atom(WMAtom::_NET_WM_PID), XCB_ATOM_CARDINAL, 0, 4);
+
+    XGetPropertyReply pidReply(xcb_get_property_reply(conn, pidCookie, nullptr));
+    if (pidReply && pidReply->type == XCB_ATOM_CARDINAL) {
+        auto *pid = reinterpret_cast<pid_t *>(xcb_get_property_value(pidReply.get()));
+        return *pid;
+    } else
+        return -1;
+}
+
+WMX11WindowSource::WindowRequest WMX11WindowSource::sendWindowRequest(WMWId winId, bool withType) const
+{
+    auto *conn = m_conn.xcb_connection();
+    WindowRequest request {};
+    request.winId = winId;
+    // pid
+    request.pidCookie = xcb_get_property(conn, 0, winId, m_conn.atom(WMAtom::_NET_WM_PID), XCB_ATOM_CARDINAL, 0, 4);
+    // title, WM_NAME is asked along so the fallback costs no extra round trip
+    request.netNameCookie = xcb_get_property(conn, 0, winId, m_conn.atom(WMAtom::_NET_WM_NAME), m_conn.atom(WMAtom::UTF8_STRING), 0, BUFSIZ);
+    request.nameCookie = xcb_icccm_get_wm_name(conn, winId);
+    // window type
+    if (withType)
+        request.windowTypeCookie = xcb_get_property(conn, 0, winId, m_conn.atom(WMAtom::_NET_WM_WINDOW_TYPE), XCB_ATOM_ATOM, 0, BUFSIZ);
+    return request;
+}
+
+bool WMX11WindowSource::takeAppWindowType(const WindowRequest &request) const
+{
+    if (!request.windowTypeCookie.sequence)
+        return false;
+
+    auto *conn = m_conn.xcb_connection();
+    XGetPropertyReply windowTypeReply(xcb_get_property_reply(conn, request.windowTypeCookie, nullptr));
+    if (windowTypeReply && windowTypeReply->type != XCB_NONE && windowTypeReply->value_len > 0) {
+        auto *atoms = reinterpret_cast<xcb_atom_t *>(xcb_get_property_value(windowTypeReply.get()));
+        Q_ASSERT(atoms != nullptr);
+        // atoms are interned once per connection, compare ids instead of asking for their names
+        for (uint32_t i = 0; i < windowTypeReply->value_len; ++i) {
+            if (atoms[i] == m_conn.atom(WMAtom::_NET_WM_WINDOW_TYPE_NORMAL)
+                    || atoms[i] == m_conn.atom(WMAtom::_NET_WM_WINDOW_TYPE_DIALOG))
+                return true;
+        } // !for
+    }
+    return false;
+}
+
+WMWindow WMX11WindowSource::takeWindowInfo(const WindowRequest &request) const
+{
+    qCDebug(app) << "Getting window info for window ID:" << request.winId;
+    WMWindow window(new struct wm_window_t());
+    window->winId = request.winId;
+
+    auto *conn = m_conn.xcb_connection();
+    XGetPropertyReply pidReply(xcb_get_property_reply(conn, request.pidCookie, nullptr));
+    if (pidReply && pidReply->type == XCB_ATOM_CARDINAL) {
+        auto *pid = reinterpret_cast<pid_t *>(xcb_get_property_value(pidReply.get()));
+        window->pid = *pid;
+    } else
+        window->pid = -1;
+
+    XGetPropertyReply nameReply(xcb_get_property_reply(conn, request.netNameCookie, nullptr));
+    if (nameReply && nameReply->type != XCB_NONE) {
+        xcb_discard_reply(conn, request.nameCookie.sequence);
+    } else {
+        nameReply.reset(xcb_get_property_reply(conn, request.nameCookie, nullptr));
+    }
+
+    if (nameReply && nameReply->type != XCB_NONE) {
+        const char *name = reinterpret_cast<const char *>(xcb_get_property_value(nameReply.get()));
+        int len = xcb_get_property_value_length(nameReply.get());
+        xcb_atom_t encoding = nameReply->type;
+        if (len != 0) {
+            qCDebug(app) << "Window name length:" << len << "Encoding:" << encoding;
+            if (encoding == XCB_ATOM_STRING) {
+                window->title = QString::fromLocal8Bit(name, len);
+            } else if (encoding == m_conn.atom(WMAtom::UTF8_STRING)) {
+                window->title = QString::fromUtf8(name, len);
+            }
+        }
+    }
+
+    return window;
+}
+
+} // namespace wm
+} // namespace core
@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef WM_X11_WINDOW_SOURCE_H
+#define WM_X11_WINDOW_SOURCE_H
+
+#include "wm_window_source.h"
+#include "wm_connection.h"
+#include "wm_atom.h"
+
+#include <QList>
+#include <QSet>
+
+#include <atomic>
+
+namespace core {
+namespace wm {
+
+/**
+ * @brief Windows followed through the x server's client list & the dock's tray icons
+ */
+class WMX11WindowSource : public WMWindowSource
+{
+    Q_OBJECT
+
+public:
+    explicit WMX11WindowSource(QObject *parent = nullptr);
+    ~WMX11WindowSource() override = default;
+
+    /**
+     * @brief Follow window changes since the last refresh
+     *
+     * Property changes of the root & client windows are drained without waiting, only windows that
+     * appeared or changed are asked for, so quiet refreshes cost no round trip to the x server.
+     */
+    bool refresh() override;
+    /**
+     * @brief Icon of the topmost window of a pid, cached per window until _NET_WM_ICON changes
+     */
+    QImage windowIcon(pid_t pid, int size) const override;
+
+private Q_SLOTS:
+    void onTrayIconsChanged();
+
+private:
+    /**
+     * @brief Property requests of one window, sent for all windows before any reply is waited for
+     */
+    struct WindowRequest {
+        WMWId winId;
+        xcb_get_property_cookie_t pidCookie;
+        xcb_get_property_cookie_t netNameCookie;
+        xcb_get_property_cookie_t nameCookie; // WM_NAME, discarded when _NET_WM_NAME is set
+        xcb_get_property_cookie_t windowTypeCookie; // sequence 0 when not requested
+    };
+
+    QList<WMWId> getTrayWindows() const;
+    /**
+     * @brief Queue pid, name & optionally window type requests of a window, nothing is flushed
+     */
+    WindowRequest sendWindowRequest(WMWId winId, bool withType) const;
+    /**
+     * @brief Wait for pid & name replies of a sent request
+     */
+    WMWindow takeWindowInfo(const WindowRequest &request) const;
+    /**
+     * @brief Wait for the window type reply of a sent request
+     * @return true if it's a normal or dialog window
+     */
+    bool takeAppWindowType(const WindowRequest &request) const;
+    pid_t getWindowPid(WMWId window) const;
+    /**
+     * @brief Read the pixels of one embedded icon of _NET_WM_ICON
+     *
+     * Width & height headers of embedded icons are walked first, then pixels of the picked icon
+     * only are asked for, instead of downloading every size the client put in.
+     */
+    QImage fetchWindowIcon(WMWId winId, int size) const;
+    /**
+     * @brief Whether a w x h icon is nearer to size than the best one so far
+     *
+     * The smallest icon not smaller than size wins, the largest one when all are smaller.
+     */
+    static bool preferIconSize(int w, int h, int bestW, int bestH, int size);
+    /**
+     * @brief Ask the x server for property change events of a window, nothing is flushed
+     */
+    void watchWindow(WMWId winId) const;
+    /**
+     * @brief Read queued events without blocking & mark what needs asking again
+     */
+    void drainEvents();
+    /**
+     * @brief Remake pid keyed caches from the windows followed, in stacking & tray order
+     */
+    void rebuildAppCaches();
+
+private:
+    WMConnection m_conn;
+
+    QList<WMWId> m_clientList; // _NET_CLIENT_LIST_STACKING of last refresh
+    std::map<WMWId, wm_window_t> m_clientWindows; // normal & dialog client windows
+    QSet<WMWId> m_otherWindows; // client windows of other types
+    QSet<WMWId> m_staleWindows; // client windows with pid or title changed
+    QList<WMWId> m_trayList;
+    std::map<WMWId, wm_window_t> m_trayWindows;
+    struct window_icon_t {
+        int size; // preferred size asked for
+        QImage image; // null when the window has no icon
+    };
+    mutable std::map<WMWId, window_icon_t> m_windowIcons;
+    bool m_clientsDirty {true};
+    // set from the dbus connection's thread
+    std::atomic_bool m_trayDirty {true};
+    bool m_trayWatched {false};
+};
+
+} // namespace wm
+} // namespace core
+
+#endif // WM_X11_WINDOW_SOURCE_H
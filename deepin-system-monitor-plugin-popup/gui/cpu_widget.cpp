@@ -68,6 +68,7 @@ void CpuWidget::initConnection()
             this, &CpuWidget::changeFont);
 
     connect(&DataDealSingleton::getInstance(), &DataDealSingleton::sigDataUpdate, this, &CpuWidget::updateStatus);
+    connect(&DataDealSingleton::getInstance(), &DataDealSingleton::sigHistoryUpdate, this, &CpuWidget::loadHistory);
 }
 
 void CpuWidget::getPainterPathByData(QList<double> *listData, QPainterPath &path, qreal maxVlaue)
@@ -94,6 +95,19 @@ void CpuWidget::getPainterPathByData(QList<double> *listData, QPainterPath &path
     }
 }
 
+void CpuWidget::loadHistory()
+{
+    QList<common::metrics::MetricsHistoryPoint> history;
+    if (!DataDealSingleton::getInstance().readHistory(history, pointsNumber))
+        return;
+
+    downloadSpeeds->clear();
+    for (const common::metrics::MetricsHistoryPoint &point : history)
+        downloadSpeeds->append(point.cpuUsage);
+    // latest point & path
+    updateStatus();
+}
+
 void CpuWidget::updateStatus()
 {
     if (!DataDealSingleton::getInstance().readCpuPer(m_cpuPer))
@@ -29,6 +29,10 @@ public slots:
 //    void updateStatus(qreal totalCpuPercent, const QList<qreal> cPercents);
 //    void slot_onCpuPer(QString cpuPer);
     void updateStatus();
+    //!
+    //! \brief loadHistory 以守护进程快照中的历史数据填充图表
+    //!
+    void loadHistory();
 
 protected:
     void paintEvent(QPaintEvent *event) override;
@@ -10,6 +10,7 @@
 #include "system/net_info.h"
 #include "system/system_monitor.h"
 #include "system/device_db.h"
+#include "system/device_snapshot.h"
 #include "model/cpu_info_model.h"
 #include "system/block_device_info_db.h"
 #include "common/datacommon.h"
@@ -28,6 +29,10 @@
 #else
 #    define POPUP_WAITING_TIME 500
 #endif
+// 守护进程每秒采样，更早的快照说明其已退出
+#define METRICS_MAX_AGE 2500
+// 图表每次statInfoUpdated追加一个点，与进程表刷新周期一致
+#define CHART_STEP 2000
 using namespace DDLog;
 
 QMutex DataDealSingleton::mutex;
@@ -43,8 +48,64 @@ DataDealSingleton &DataDealSingleton::getInstance()
     return *instance;
 }
 
+bool DataDealSingleton::readMetrics(common::metrics::MetricsSample &sample)
+{
+    QMutexLocker locker(&m_metricsMutex);
+    return m_metrics.read(sample, METRICS_MAX_AGE);
+}
+
+bool DataDealSingleton::readHistory(QList<common::metrics::MetricsHistoryPoint> &points, int count)
+{
+    common::metrics::MetricsHistoryPoint history[common::metrics::kMetricsHistoryLength];
+    int n = 0;
+    {
+        QMutexLocker locker(&m_metricsMutex);
+        n = m_metrics.readHistory(history, common::metrics::kMetricsHistoryLength);
+    }
+    if (n == 0)
+        return false;
+
+    // one point per chart step ending now, the sampler skips periods nobody asked for
+    // & those are left 0
+    qint64 now = common::metrics::monotonicNow();
+    bool found = false;
+    points.clear();
+    points.reserve(count);
+    int j = 0;
+    for (int i = count - 1; i >= 0; --i) {
+        qint64 slot = now - qint64(i) * CHART_STEP;
+        while (j + 1 < n && history[j + 1].sampledAt <= slot)
+            ++j;
+        common::metrics::MetricsHistoryPoint point;
+        if (history[j].sampledAt <= slot && slot - history[j].sampledAt < CHART_STEP) {
+            point = history[j];
+            found = true;
+        }
+        points.append(point);
+    }
+    return found;
+}
+
+void DataDealSingleton::setActive(bool active)
+{
+    SystemMonitor::instance()->setPaused(!active);
+    if (active)
+        Q_EMIT sigHistoryUpdate();
+}
+
+double DataDealSingleton::netChartValue(double bps)
+{
+    return formatUnit_net(bps * 8, B, 1, true).split(" ").value(0).toDouble();
+}
+
 bool DataDealSingleton::readCpuPer(qreal &cpuPer)
 {
+    common::metrics::MetricsSample sample;
+    if (readMetrics(sample)) {
+        cpuPer = sample.cpuUsage;
+        return true;
+    }
+
     internalMutex.lockForRead();
     cpuPer = CPUInfoModel::instance()->cpuAllPercent();
     internalMutex.unlock();
@@ -53,8 +114,21 @@ bool DataDealSingleton::readCpuPer(qreal &cpuPer)
 
 bool DataDealSingleton::readMemInfo(QString &memUsage, QString &memTotal, QString &memPercent, QString &swapUsage, QString &swapTotal, QString &swapPercent)
 {
+    common::metrics::MetricsSample sample;
+    if (readMetrics(sample)) {
+        memUsage = formatUnit_memory_disk(qulonglong(sample.memTotal - sample.memAvailable) << 10, B, 1);
+        memTotal = formatUnit_memory_disk(qulonglong(sample.memTotal) << 10, B, 1);
+        memPercent = QString::number((sample.memTotal - sample.memAvailable) * 1. / sample.memTotal * 100, 'f', 1);
+
+        swapUsage = formatUnit_memory_disk(qulonglong(sample.swapTotal - sample.swapFree) << 10, B, 1);
+        swapTotal = formatUnit_memory_disk(qulonglong(sample.swapTotal) << 10, B, 1);
+        swapPercent = QString::number((sample.swapTotal - sample.swapFree) * 1. / sample.swapTotal * 100, 'f', 1);
+        return true;
+    }
+
     internalMutex.lockForRead();
-    MemInfo *curMemInfo = core::system::DeviceDB::instance()->memInfo();
+    core::system::DeviceSnapshotPtr snapshot = core::system::DeviceDB::instance()->snapshot();
+    const MemInfo *curMemInfo = &snapshot->memInfo;
     memUsage = formatUnit_memory_disk((curMemInfo->memTotal() - curMemInfo->memAvailable()) << 10, B, 1);
     memTotal = formatUnit_memory_disk(curMemInfo->memTotal() << 10, B, 1);
     memPercent = QString::number((curMemInfo->memTotal() - curMemInfo->memAvailable()) * 1. / curMemInfo->memTotal() * 100, 'f', 1);
@@ -69,12 +143,21 @@ bool DataDealSingleton::readMemInfo(QString &memUsage, QString &memTotal, QStrin
 
 bool DataDealSingleton::readNetInfo(QString &netReceive, QString &netTotalReceive, QString &netSend, QString &totalSend)
 {
+    common::metrics::MetricsSample sample;
+    if (readMetrics(sample)) {
+        netReceive = formatUnit_net(sample.netRecvBps * 8, B, 1, true);
+        netSend = formatUnit_net(sample.netSentBps * 8, B, 1, true);
+        netTotalReceive = formatUnit_net(qulonglong(sample.netRecvBytes) * 8, B, 1);
+        totalSend = formatUnit_net(qulonglong(sample.netSentBytes) * 8, B, 1);
+        return true;
+    }
+
     internalMutex.lockForRead();
-    NetInfo *netInfo = core::system::DeviceDB::instance()->netInfo();
-    netReceive = formatUnit_net(netInfo->recvBps() * 8, B, 1, true);
-    netSend = formatUnit_net(netInfo->sentBps() * 8, B, 1, true);
-    netTotalReceive = formatUnit_net(netInfo->totalRecvBytes() * 8, B, 1);
-    totalSend = formatUnit_net(netInfo->totalSentBytes() * 8, B, 1);
+    core::system::DeviceSnapshotPtr snapshot = core::system::DeviceDB::instance()->snapshot();
+    netReceive = formatUnit_net(snapshot->netRecvBps * 8, B, 1, true);
+    netSend = formatUnit_net(snapshot->netSentBps * 8, B, 1, true);
+    netTotalReceive = formatUnit_net(snapshot->netTotalRecvBytes * 8, B, 1);
+    totalSend = formatUnit_net(snapshot->netTotalSentBytes * 8, B, 1);
     internalMutex.unlock();
 
     return true;
@@ -83,12 +166,12 @@ bool DataDealSingleton::readNetInfo(QString &netReceive, QString &netTotalReceiv
 bool DataDealSingleton::readDiskInfo(QString &diskRead, QString &diskTotalSize, QString &diskWrite, QString &diskAvailable)
 {
     internalMutex.lockForRead();
-    core::system::DiskIOInfo *diskIOInfo = core::system::DeviceDB::instance()->diskIoInfo();
+    core::system::DeviceSnapshotPtr snapshot = core::system::DeviceDB::instance()->snapshot();
 
-    diskRead = formatUnit_memory_disk(diskIOInfo->diskIoReadBps(), B, 1, true);
-    diskWrite = formatUnit_memory_disk(diskIOInfo->diskIoWriteBps(), B, 1, true);
+    diskRead = formatUnit_memory_disk(snapshot->diskReadBps, B, 1, true);
+    diskWrite = formatUnit_memory_disk(snapshot->diskWriteBps, B, 1, true);
 
-    const QList<BlockDevice> &infoDB = DeviceDB::instance()->blockDeviceInfoDB()->deviceList();
+    const QList<BlockDevice> &infoDB = snapshot->blockDevices;
     QMap<QString, BlockDevice> mapInfo;
     qulonglong totalDiskAva = 0;
     for (int i = 0; i < infoDB.size(); ++i) {
@@ -10,6 +10,8 @@
 #include <QObject>
 #include <QTimer>
 
+#include "common/metrics_snapshot.h"
+
 class CPUInfoModel;
 
 class DataDealSingleton : public QObject
@@ -65,8 +67,32 @@ public:
     //!
     bool sendJumpWidgetMessage(const QString &dbusMessage);
 
+    //!
+    //! \brief readHistory 读取守护进程快照中的历史数据，用于弹窗显示时立即绘制图表
+    //! \param points 按图表刷新间隔排列的数据，由旧到新，缺失的点为0
+    //! \param count 图表点数
+    //! \return 守护进程未运行或快照过期时返回false
+    //!
+    bool readHistory(QList<common::metrics::MetricsHistoryPoint> &points, int count);
+
+    //!
+    //! \brief setActive 弹窗显示时恢复采样并以快照历史填充图表，隐藏时停止全部采样
+    //! \param active 弹窗是否显示
+    //!
+    void setActive(bool active);
+
+    //!
+    //! \brief netChartValue 网速在图表中的数值，与readNetInfo显示的数值部分一致
+    //! \param bps 每秒字节数
+    //!
+    static double netChartValue(double bps);
+
 signals:
     void sigDataUpdate();
+    //!
+    //! \brief sigHistoryUpdate 弹窗显示，图表需按历史数据重新填充
+    //!
+    void sigHistoryUpdate();
 
 private:
     DataDealSingleton(QObject *parent = nullptr);
@@ -74,11 +100,19 @@ private:
     DataDealSingleton(const DataDealSingleton &) = delete;
     DataDealSingleton &operator=(const DataDealSingleton &) = delete;
     bool launchMainProcessByAM() const;
+    //!
+    //! \brief readMetrics 读取守护进程发布的会话快照
+    //! \param sample 快照数据
+    //! \return 守护进程未运行或快照过期时返回false
+    //!
+    bool readMetrics(common::metrics::MetricsSample &sample);
 
     QReadWriteLock internalMutex;
 
     static QMutex mutex;
     static QAtomicPointer<DataDealSingleton> instance;
+    common::metrics::MetricsSnapshotReader m_metrics;
+    QMutex m_metricsMutex;
 
     //防止300ms内重复按键
     QTimer* m_popupTrickTimer;
@@ -7,6 +7,7 @@
 #include "common/datacommon.h"
 //#include "itemwidget.h"
 #include "dbus/dbusayatanainterface.h"
+#include "datadealsingleton.h"
 #include "helper.hpp"
 
 #include <DApplication>
@@ -42,10 +43,6 @@
 #define DOCK_LEFT 3
 
 #define SCREEN_HEIGHT_MAX 1080
-#define NOT_USE_QUIT_TIME_INTERVAL 5 * 60 * 1000
-
-const QString KILL_DBUS_COMMAND = "killall deepin-system-monitor-plugin-popup";
-
 using namespace DDLog;
 
 MainWindow::MainWindow(QWidget *parent)
@@ -69,14 +66,13 @@ MainWindow::MainWindow(QWidget *parent)
       m_xAni(new QPropertyAnimation(this, "x")),
       m_widthAni(new QPropertyAnimation(this, "width")),
       m_aniGroup(new QSequentialAnimationGroup(this)),
-      m_trickTimer(new QTimer(this)),
-      m_processEndTimer(new QTimer(this))
+      m_trickTimer(new QTimer(this))
 {
     m_trickTimer->setInterval(300);
     m_trickTimer->setSingleShot(true);
 
-    m_processEndTimer->setInterval(NOT_USE_QUIT_TIME_INTERVAL);
-    m_processEndTimer->start();
+    // 常驻但不采样，显示时以守护进程快照立即绘制
+    DataDealSingleton::getInstance().setActive(false);
 
     //在构造函数中存储m_displayInter->monitor()中的内容，解决内存泄漏的问题
     if (m_displayInter->isValid()) {
@@ -153,8 +149,6 @@ void MainWindow::showAni()
         qCDebug(app) << "Trick timer is active, ignoring show request";
         return;
     }
-    //停止计时
-    m_processEndTimer->stop();
     qreal scale = qApp->primaryScreen()->devicePixelRatio();
     m_trickTimer->start();
     qCDebug(app) << "Starting show animation with scale:" << scale;
@@ -200,8 +194,6 @@ void MainWindow::hideAni()
     }
 
     m_trickTimer->start();
-    //不再使用开始计时
-    m_processEndTimer->start();
     qCDebug(app) << "Starting hide animation";
 
     if (!m_hasComposite) {
@@ -410,12 +402,6 @@ void MainWindow::initConnect()
 
     // 去除通过智能语音助手唤醒时关闭系统监视器窗口
     //    connect(DBusAyatanaInterface::getInstance(), &DBusAyatanaInterface::sigSendCloseWidget, this, [=]() { QTimer::singleShot(0, this, &MainWindow::hideAni); });
-
-    //5分钟没人使用，结束popup进程
-    connect(m_processEndTimer, &QTimer::timeout, this, []() {
-        qCInfo(app) << "Process end timer triggered, ending process";
-        QProcess::startDetached(KILL_DBUS_COMMAND);
-    });
 }
 
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -666,11 +652,13 @@ void MainWindow::slotShowOrHideSystemMonitorPluginPopupWidget()
 void MainWindow::showEvent(QShowEvent *event)
 {
     Q_EMIT sysMonPopVisibleChanged(true);
+    DataDealSingleton::getInstance().setActive(true);
     QWidget::showEvent(event);
 }
 
 void MainWindow::hideEvent(QHideEvent *event)
 {
     Q_EMIT sysMonPopVisibleChanged(false);
+    DataDealSingleton::getInstance().setActive(false);
     QWidget::hideEvent(event);
 }
@@ -209,10 +209,6 @@ private:
     int m_last_time_move = 0;
 
 
-    // 5分钟计时，自动结束进程
-    QTimer *m_processEndTimer;
-
-
 };
 
 #endif // MAINWINDOW_H
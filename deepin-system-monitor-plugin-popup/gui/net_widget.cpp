@@ -72,6 +72,7 @@ NetWidget::~NetWidget() {
 void NetWidget::initConnection()
 {
     connect(&DataDealSingleton::getInstance(), &DataDealSingleton::sigDataUpdate, this, &NetWidget::updateStatus);
+    connect(&DataDealSingleton::getInstance(), &DataDealSingleton::sigHistoryUpdate, this, &NetWidget::loadHistory);
 }
 
 
@@ -93,6 +94,22 @@ void NetWidget::getPainterPathByData(QList<double> *listData, QPainterPath &path
     }
 }
 
+void NetWidget::loadHistory()
+{
+    QList<common::metrics::MetricsHistoryPoint> history;
+    if (!DataDealSingleton::getInstance().readHistory(history, pointsNumber))
+        return;
+
+    downloadSpeeds->clear();
+    uploadSpeeds->clear();
+    for (const common::metrics::MetricsHistoryPoint &point : history) {
+        downloadSpeeds->append(DataDealSingleton::netChartValue(point.netRecvBps));
+        uploadSpeeds->append(DataDealSingleton::netChartValue(point.netSentBps));
+    }
+    // latest point, paths, rates & totals
+    updateStatus();
+}
+
 void NetWidget::updateStatus()
 {
     QString netReceive, netTotalReceive, netSend, totalSend;
@@ -27,6 +27,10 @@ public:
 
 public slots:
     void updateStatus();
+    //!
+    //! \brief loadHistory 以守护进程快照中的历史数据填充图表
+    //!
+    void loadHistory();
 
 protected:
     void paintEvent(QPaintEvent *event) override;
@@ -61,6 +61,8 @@ ProcessTableView::ProcessTableView(DWidget *parent)
     m_model = new ProcessTableModel(this);
     m_proxyModel = new ProcessSortFilterProxyModel(this);
     m_proxyModel->setSourceModel(m_model);
+    // the table shows the top rows only, the model doesn't hold the rest
+    m_model->setTopCount(kTopProcessCount);
     // setModel must be called before calling loadSettings();
     setModel(m_proxyModel);
 
@@ -119,6 +121,8 @@ bool ProcessTableView::eventFilter(QObject *obj, QEvent *event)
 void ProcessTableView::search(const QString &text)
 {
     qCDebug(app) << "Searching with text:" << text;
+    // a pattern may match processes out of the top ranks
+    m_model->setTopCount(text.isEmpty() ? kTopProcessCount : 0);
     m_proxyModel->setSortFilterString(text);
     // adjust search result tip label's visibility & position if needed
     adjustInfoLabelVisibility();
@@ -129,6 +133,7 @@ void ProcessTableView::search(const QString &text)
 void ProcessTableView::switchDisplayMode(FilterType type)
 {
     qCDebug(app) << "Switching display mode to:" << type;
+    m_model->setFilterType(type);
     m_proxyModel->setFilterType(type);
 }
 
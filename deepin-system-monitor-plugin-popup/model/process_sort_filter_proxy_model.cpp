@@ -49,7 +49,7 @@ void ProcessSortFilterProxyModel::setFilterType(int type)
 
 int ProcessSortFilterProxyModel::rowCount(const QModelIndex &parent) const
 {
-    return 5;
+    return qMin(kTopProcessCount, QSortFilterProxyModel::rowCount(parent));
 }
 
 // filters the row of specified parent with given pattern
@@ -14,6 +14,8 @@
 #include <DPlatformTheme>
 #include <QPointer>
 
+#include <algorithm>
+
 using namespace common;
 using namespace common::format;
 DGUI_USE_NAMESPACE // using namespace Dtk::Gui;
@@ -73,24 +75,101 @@ void ProcessTableModel::updateProcessList()
     QTimer::singleShot(0, this, SLOT(updateProcessListDelay()));
 }
 
+void ProcessTableModel::setTopCount(int count)
+{
+    if (m_topCount == count)
+        return;
+    m_topCount = count;
+    updateProcessList();
+}
+
+void ProcessTableModel::setFilterType(int type)
+{
+    if (m_filterType == type)
+        return;
+    m_filterType = type;
+    if (m_topCount > 0)
+        updateProcessList();
+}
+
+bool ProcessTableModel::acceptsAppType(int appType) const
+{
+    if (m_filterType == kFilterCurrentUser)
+        return appType == kFilterApps || appType == kFilterCurrentUser;
+    if (m_filterType == kFilterApps)
+        return appType == kFilterApps;
+    return true;
+}
+
+void ProcessTableModel::updateTopProcessList()
+{
+    // ranking & rows come from the same scan
+    const ProcessSnapshotPtr snapshot = ProcessDB::instance()->processSet()->snapshot();
+    const QMap<pid_t, Process> &processes = snapshot->processes;
+
+    m_ranking.clear();
+    m_ranking.reserve(processes.size());
+    for (auto it = processes.cbegin(); it != processes.cend(); ++it) {
+        if (acceptsAppType(it->appType()))
+            m_ranking.append({it->cpu(), it.key()});
+    }
+
+    // only the shown ranks get ordered, O(n log k)
+    int count = std::min(m_topCount, int(m_ranking.size()));
+    std::partial_sort(m_ranking.begin(), m_ranking.begin() + count, m_ranking.end(),
+    [](const RankEntry &lhs, const RankEntry &rhs) {
+        return lhs.cpu > rhs.cpu || (lhs.cpu == rhs.cpu && lhs.pid < rhs.pid);
+    });
+
+    int rows = m_procIdList.size();
+    if (count < rows) {
+        beginRemoveRows({}, count, rows - 1);
+        m_procIdList.erase(m_procIdList.begin() + count, m_procIdList.end());
+        m_processList.erase(m_processList.begin() + count, m_processList.end());
+        endRemoveRows();
+        rows = count;
+    }
+    // ranks are rows, a process moving up or down only changes row data
+    for (int row = 0; row < rows; ++row) {
+        m_procIdList[row] = m_ranking[row].pid;
+        m_processList[row] = processes.value(m_ranking[row].pid);
+    }
+    if (rows > 0)
+        Q_EMIT dataChanged(index(0, 0), index(rows - 1, columnCount() - 1));
+    if (count > rows) {
+        beginInsertRows({}, rows, count - 1);
+        for (int row = rows; row < count; ++row) {
+            m_procIdList << m_ranking[row].pid;
+            m_processList << processes.value(m_ranking[row].pid);
+        }
+        endInsertRows();
+    }
+}
+
 void ProcessTableModel::updateProcessListDelay()
 {
-    ProcessSet *processSet = ProcessDB::instance()->processSet();
-    const QList<pid_t> &newpidlst = processSet->getPIDList();
+    if (m_topCount > 0) {
+        updateTopProcessList();
+        Q_EMIT modelUpdated();
+        return;
+    }
+
+    const ProcessSnapshotPtr snapshot = ProcessDB::instance()->processSet()->snapshot();
+    const QList<pid_t> &newpidlst = snapshot->pids;
     QList<pid_t> oldpidlst = m_procIdList;
 
     for (const auto &pid : newpidlst) {
         int row = m_procIdList.indexOf(pid);
         if (row >= 0) {
             // update
-            m_processList[row] = processSet->getProcessById(pid);
+            m_processList[row] = snapshot->processes.value(pid);
             Q_EMIT dataChanged(index(row, 0), index(row, columnCount() - 1));
         } else {
             // insert
             row = m_procIdList.size();
             beginInsertRows({}, row, row);
             m_procIdList << pid;
-            m_processList << processSet->getProcessById(pid);
+            m_processList << snapshot->processes.value(pid);
             endInsertRows();
         }
     }
@@ -283,6 +362,8 @@ void ProcessTableModel::updateProcessState(pid_t pid, char state)
 {
     int row = m_procIdList.indexOf(pid);
     if (row >= 0) {
+        // rows share their processes with the published snapshot
+        m_processList[row] = m_processList[row].detached();
         m_processList[row].setState(state);
         Q_EMIT dataChanged(index(row, 0), index(row, columnCount() - 1));
     }
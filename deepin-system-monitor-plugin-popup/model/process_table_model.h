@@ -11,6 +11,7 @@
 #include <QAbstractTableModel>
 #include <QList>
 #include <QMap>
+#include <QVector>
 
 // name column display
 constexpr const char *kProcessName = QT_TRANSLATE_NOOP("Process.Table.Header", "Name");
@@ -39,6 +40,9 @@ constexpr const char *kProcessPriority = QT_TRANSLATE_NOOP("Process.Table.Header
 
 using namespace core::process;
 
+// rows shown in the popup process table
+constexpr int kTopProcessCount = 5;
+
 /**
  * @brief Process table model class
  */
@@ -80,6 +84,19 @@ public:
      */
     void updateProcessList();
 
+    /**
+     * @brief Keep only the processes ranked top by cpu in the model
+     *
+     * Ranks are selected with a partial sort over a flat cpu array & written to rows in place,
+     * rows are only inserted or removed when fewer processes are left.
+     * @param count Rows kept, 0 keeps every process
+     */
+    void setTopCount(int count);
+    /**
+     * @brief Filter type processes are ranked within, see FilterType
+     */
+    void setFilterType(int type);
+
     /**
      * @brief Returns the number of rows under the given parent
      * @param parent Parent index
@@ -156,6 +173,21 @@ private Q_SLOTS:
     void updateProcessListDelay();
 
 private:
+    /**
+     * @brief Rank processes & write the top ones to rows
+     */
+    void updateTopProcessList();
+    bool acceptsAppType(int appType) const;
+
+private:
+    struct RankEntry {
+        qreal cpu;
+        pid_t pid;
+    };
+    QVector<RankEntry> m_ranking; // reused between ticks
+    int m_topCount {0};
+    int m_filterType {kNoFilter};
+
     QList<pid_t> m_procIdList; // pid list
     QList<Process> m_processList; // pid list
 };
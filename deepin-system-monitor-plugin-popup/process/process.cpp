@@ -8,10 +8,14 @@
 #include "process/private/process_p.h"
 #include "system/device_db.h"
 #include "process/process_db.h"
+#include "process/process_environ_cache.h"
 #include "system/sys_info.h"
+#include "system/user_name_cache.h"
 #include "system/cpu_set.h"
+#include "system/task_stats.h"
 //#include "system/netif_info_db.h"
 #include "wm/wm_window_list.h"
+#include "process_info_record.h"
 
 #include <QMap>
 #include <QList>
@@ -33,7 +37,6 @@
 #define PROC_STATUS_PATH "/proc/%u/status"
 #define PROC_STATM_PATH "/proc/%u/statm"
 #define PROC_CMDLINE_PATH "/proc/%u/cmdline"
-#define PROC_ENVIRON_PATH "/proc/%u/environ"
 #define PROC_IO_PATH "/proc/%u/io"
 #define PROC_FD_PATH "/proc/%u/fd"
 #define PROC_FD_NAME_PATH "/proc/%u/fd/%s"
@@ -114,63 +117,97 @@ Process::~Process()
 {
 }
 
+Process Process::detached() const
+{
+    Process proc;
+    proc.d = QExplicitlySharedDataPointer<ProcessPrivate>(new ProcessPrivate(*d));
+    return proc;
+}
+
 time_t Process::startTime() const
 {
     auto *monitor = ThreadManager::instance()->thread<SystemMonitorThread>(BaseThread::kSystemMonitorThread)->systemMonitorInstance();
     return monitor->sysInfo()->btime().tv_sec + time_t(d->start_time / HZ);
 }
 
+qulonglong Process::startTimeTicks() const
+{
+    return d->start_time;
+}
+
 timeval Process::procuptime() const
 {
     return d->uptime;
 }
 
-void Process::readProcessVariableInfo()
+void Process::readProcessVariableInfo(ProcFdCache *fdCache)
 {
-    readProcessInfo();
+    readProcessVariableStats(fdCache);
+    updateProcessVariableMetrics();
 }
 
-void Process::readProcessSimpleInfo(bool skipStatReading)
+bool Process::readProcessVariableStats(ProcFdCache *fdCache, bool readFds)
 {
-    d->valid = true;
-    bool ok = true;
+    // popup doesn't keep fds open nor walk them, both are only taken to match ProcessSet
+    Q_UNUSED(fdCache);
+    Q_UNUSED(readFds);
 
-    ok = ok && readCmdline();      // 两种模式都需要cmdline
+    bool ok = true;
+    ok = ok && readStat();
+    readSchedStat();
+    ok = ok && readStatm();
 
-    // 根据skipStatReading决定是否跳过stat、statm和status读取
-    if (!skipStatReading) {
-        ok = ok && readStat();     // 传统模式读取stat
-        readSchedStat();           // 传统模式读取schedstat
-        ok = ok && readStatm();    // 传统模式读取statm
-        ok = ok && readStatus();   // 传统模式读取status
-    }
+    d->valid = ok;
+    return ok;
+}
 
-    d->usrerName = SysInfo::userName(d->uid);
+void Process::updateProcessVariableMetrics()
+{
     d->proc_name.refreashProcessName(this);
-    d->proc_icon.refreashProcessIcon(this);
     d->uptime = SysInfo::instance()->uptime();
 
-    CPUSet *cpuset = DeviceDB::instance()->cpuSet();
     ProcessSet *procset =  ProcessDB::instance()->processSet();
 
-    auto recentProcptr = procset->getRecentProcStage(d->pid);
+    auto recentProcptr = procset->getRecentProcStage(d->pid, d->start_time);
     auto validrecentPtr = recentProcptr.lock();
+    ProcessSamples &samples = d->mutableSamples();
     qreal timedelta = d->stime + d->utime;
     if (validrecentPtr) {
         timedelta = timedelta - validrecentPtr->ptime;
         struct DiskIO io = {validrecentPtr->read_bytes, validrecentPtr->write_bytes, validrecentPtr->cancelled_write_bytes};
-        d->diskIOSample->addSample(new DISKIOSampleFrame(validrecentPtr->uptime, io));
+        samples.diskIOSample.addSample(DISKIOSampleFrame(validrecentPtr->uptime, io));
 
-        d->networkIOSample->addSample(new IOSampleFrame(validrecentPtr->uptime, {0, 0}));
+        samples.networkIOSample.addSample(IOSampleFrame(validrecentPtr->uptime, {0, 0}));
     }
-    d->cpuUsageSample->addSample(new CPUUsageSampleFrame(qMax(0., timedelta) / cpuset->getUsageTotalDelta() * 100));
+    samples.cpuUsageSample.addSample(CPUUsageSampleFrame(qMax(0., timedelta) / procset->cpuUsageTotalDelta() * 100));
 
     struct DiskIO io = {d->read_bytes, d->write_bytes, d->cancelled_write_bytes};
-    d->diskIOSample->addSample(new DISKIOSampleFrame(d->uptime, io));
+    samples.diskIOSample.addSample(DISKIOSampleFrame(d->uptime, io));
 
-    auto pair = d->diskIOSample->recentSamplePair();
+    auto pair = samples.diskIOSample.recentSamplePair();
     struct IOPS iops = DISKIOSampleFrame::diskiops(pair.first, pair.second);
-    d->diskIOSpeedSample->addSample(new IOPSSampleFrame(iops));
+    samples.diskIOSpeedSample.addSample(IOPSSampleFrame(iops));
+}
+
+void Process::readProcessSimpleInfo(bool skipStatReading)
+{
+    d->valid = true;
+    bool ok = true;
+
+    ok = ok && readCmdline();      // 两种模式都需要cmdline
+
+    // 根据skipStatReading决定是否跳过stat、statm和status读取
+    if (!skipStatReading) {
+        ok = ok && readStat();     // 传统模式读取stat
+        readSchedStat();           // 传统模式读取schedstat
+        ok = ok && readStatm();    // 传统模式读取statm
+        ok = ok && readStatus();   // 传统模式读取status
+    }
+
+    d->usrerName = UserNameCache::instance()->userName(d->uid);
+    d->proc_name.refreashProcessName(this);
+    d->proc_icon.refreashProcessIcon(this);
+    d->uptime = SysInfo::instance()->uptime();
 
     d->apptype = kNoFilter;
     const QVariant &euid = ProcessDB::instance()->processEuid();
@@ -189,8 +226,9 @@ void Process::readProcessSimpleInfo(bool skipStatReading)
 
 void Process::readProcessInfo()
 {
-    // 传统模式：调用完整的readProcessSimpleInfo，不跳过stat读取
+    // 传统模式：完整读取一次，再采样一次
     readProcessSimpleInfo(false);
+    updateProcessVariableMetrics();
 }
 
 // read /proc/[pid]/stat
@@ -315,53 +353,11 @@ bool Process::readCmdline()
         QByteArray buf(begin);
         d->cmdline << buf;
     }
+    d->bare_shell = d->cmdline.join(' ') == "/bin/bash";
 
     return ok;
 }
 
-// read /proc/[pid]/environ
-void Process::readEnviron()
-{
-    const size_t sz = 1024;
-    char path[128] {};
-    ssize_t nb;
-    QByteArray sbuf {};
-    char buf[sz + 1] {};
-    int fd;
-
-    sprintf(path, PROC_ENVIRON_PATH, d->pid);
-
-    errno = 0;
-    // open /proc/[pid]/environ
-    fd = open(path, O_RDONLY);
-    if (fd < 0) {
-        qCWarning(app) << "Failed to open" << path << ":" << strerror(errno);
-        return;
-    }
-
-    while ((nb = read(fd, buf, sz))) {
-        buf[nb] = '\0';
-        sbuf.append(buf, int(nb));
-    }
-    close(fd);
-
-    if (nb == 0 && errno != 0) {
-        qCWarning(app) << "Failed to read" << path << ":" << strerror(errno);
-        return;
-    }
-
-    if (sbuf.size() > 0) {
-        auto elist = sbuf.split('\0');
-        for (auto it : elist) {
-            // it: name=value pair
-            auto kvp = it.split('=');
-            if (kvp.size() == 2) {
-                d->environ[kvp[0]] = kvp[1];
-            }
-        }
-    } // ::if(sbuf)
-}
-
 // read /proc/[pid]/schedstat
 void Process::readSchedStat()
 {
@@ -562,6 +558,11 @@ bool Process::isValid() const
     return d && d->isValid();
 }
 
+bool Process::vanished() const
+{
+    return d && d->vanished;
+}
+
 pid_t Process::ppid() const
 {
     return d->ppid;
@@ -604,7 +605,7 @@ QIcon Process::icon() const
 
 qreal Process::cpu() const
 {
-    auto *sample = d->cpuUsageSample->recentSample();
+    auto *sample = d->samples->cpuUsageSample.recentSample();
     if (sample)
         return sample->data;
     else
@@ -613,14 +614,194 @@ qreal Process::cpu() const
 
 void Process::setCpu(qreal cpu)
 {
-    d->cpuUsageSample->addSample(new CPUUsageSampleFrame(cpu));
+    d->mutableSamples().cpuUsageSample.addSample(CPUUsageSampleFrame(cpu));
+}
+
+qulonglong Process::wtime() const
+{
+    return d->wtime;
+}
+
+// popup doesn't show guest cpu, kept for the shared process set
+qulonglong Process::guestTime() const
+{
+    return d->guest_time;
+}
+
+// popup doesn't read fault & switch counters, kept for the shared process set
+qulonglong Process::minorFaults() const
+{
+    return d->minflt;
+}
+
+qulonglong Process::majorFaults() const
+{
+    return d->majflt;
+}
+
+qulonglong Process::voluntarySwitches() const
+{
+    return d->nvcsw;
+}
+
+qulonglong Process::involuntarySwitches() const
+{
+    return d->nivcsw;
+}
+
+// popup doesn't show io delays, kept for the shared process set
+qulonglong Process::blkioDelay() const
+{
+    return d->blkio_delay;
+}
+
+qulonglong Process::swapinDelay() const
+{
+    return d->swapin_delay;
+}
+
+qulonglong Process::ioSyscalls() const
+{
+    return d->io_syscalls;
+}
+
+void Process::setTaskStats(const task_io_t &io)
+{
+    d->blkio_delay = io.blkioDelay;
+    d->swapin_delay = io.swapinDelay;
+    d->io_syscalls = io.syscalls;
+}
+
+// popup doesn't show tcp health, kept for the shared process set
+qulonglong Process::tcpRetrans() const
+{
+    return d->tcp_retrans;
+}
+
+qulonglong Process::tcpSegsOut() const
+{
+    return d->tcp_segs_out;
+}
+
+void Process::setSmaps(qulonglong pss, qulonglong uss, qulonglong swap)
+{
+    d->has_smaps = true;
+    d->pss = pss;
+    d->uss = uss;
+    d->swap = swap;
+}
+
+// popup doesn't track fd counts, kept for the shared process set
+int Process::fdCount() const
+{
+    return d->fd_count;
+}
+
+qreal Process::fdGrowthSince() const
+{
+    return d->fd_growth_since;
+}
+
+int Process::fdGrowthBase() const
+{
+    return d->fd_growth_base;
+}
+
+// popup doesn't show memory trends, kept for the shared process set
+qreal Process::memoryTrend() const
+{
+    return d->memory_trend;
+}
+
+qreal Process::memoryLeakSince() const
+{
+    return d->memory_leak_since;
+}
+
+qulonglong Process::memoryLeakBase() const
+{
+    return d->memory_leak_base;
+}
+
+void Process::setMemoryTrend(qreal trend, qreal leakSince, qulonglong leakBase)
+{
+    d->memory_trend = trend;
+    d->memory_leak_since = leakSince;
+    d->memory_leak_base = leakBase;
+}
+
+void Process::setMemoryExhaustion(qreal seconds, bool leak)
+{
+    d->memory_exhaustion = seconds;
+    d->memory_leak = leak;
+}
+
+// popup doesn't show power, kept for the shared process set
+qreal Process::power() const
+{
+    return d->power;
+}
+
+void Process::setPower(qreal watts)
+{
+    d->power = watts;
+}
+
+// popup doesn't show wakeups, kept for the shared process set
+void Process::setWakeups(qreal rate, qreal timerRate)
+{
+    d->wakeup_rate = rate;
+    d->timer_wakeup_rate = timerRate;
+}
+
+// popup doesn't show hung tasks, kept for the shared process set
+qreal Process::blockedSince() const
+{
+    return d->blocked_since;
+}
+
+void Process::setBlocked(qreal since, bool hung)
+{
+    d->blocked_since = since;
+    d->hung = hung;
+}
+
+void Process::setBlockingFunction(const QByteArray &function, int wait)
+{
+    d->blocking_function = function;
+    d->blocking_wait = wait;
+}
+
+QList<int> Process::drmFds() const
+{
+    // popup doesn't walk drm fds
+    return d->drmFds;
+}
+
+void Process::setGpu(qreal usage, qulonglong memory)
+{
+    d->has_gpu = true;
+    d->gpu_usage = usage;
+    d->gpu_memory = memory;
 }
 
 qulonglong Process::memory() const
 {
+    if (d->group_memory)
+        return d->group_memory;
     return d->rss - d->shm;
 }
 
+void Process::setGroupMemory(qulonglong memory)
+{
+    d->group_memory = memory;
+    // last scan kept memory() of this app, the group's one as long as it stays grouped
+    ProcessSet *procset = ProcessDB::instance()->processSet();
+    auto recent = procset->getRecentProcStage(d->pid, d->start_time).lock();
+    if (recent)
+        d->memory_growth = memoryGrowthSince(*recent, memory, d->uptime);
+}
+
 qulonglong Process::vtrmemory() const
 {
     return d->vmsize;
@@ -646,6 +827,11 @@ char Process::state() const
     return d->state;
 }
 
+unsigned int Process::nthreads() const
+{
+    return d->nthreads;
+}
+
 void Process::setState(char state)
 {
     d->state = state;
@@ -661,9 +847,15 @@ QString Process::cmdlineString() const
     return QUrl::fromPercentEncoding(d->cmdline.join(' '));
 }
 
+bool Process::isBareShell() const
+{
+    return d->bare_shell;
+}
+
 QHash<QString, QString> Process::environ() const
 {
-    return d->environ;
+    // loaded on first request, bounded by ProcessEnvironCache
+    return ProcessEnvironCache::instance()->environ(d->pid, d->start_time);
 }
 
 uid_t Process::uid() const
@@ -688,7 +880,7 @@ QString Process::groupName() const
 
 qreal Process::readBps() const
 {
-    auto *sample = d->diskIOSpeedSample->recentSample();
+    auto *sample = d->samples->diskIOSpeedSample.recentSample();
     if (sample)
         return sample->data.inBps;
     else
@@ -697,7 +889,7 @@ qreal Process::readBps() const
 
 qreal Process::writeBps() const
 {
-    auto *sample = d->diskIOSpeedSample->recentSample();
+    auto *sample = d->samples->diskIOSpeedSample.recentSample();
     if (sample)
         return sample->data.outBps;
     else
@@ -719,9 +911,24 @@ qulonglong Process::cancelledWriteBytes() const
     return d->cancelled_write_bytes;
 }
 
+bool Process::hasNetCounters() const
+{
+    return d->has_net_counters;
+}
+
+qulonglong Process::netRxBytes() const
+{
+    return d->net_rx_bytes;
+}
+
+qulonglong Process::netTxBytes() const
+{
+    return d->net_tx_bytes;
+}
+
 qreal Process::recvBps() const
 {
-    auto *sample = d->networkBandwidthSample->recentSample();
+    auto *sample = d->samples->networkBandwidthSample.recentSample();
     if (sample)
         return sample->data.inBps;
     else
@@ -730,7 +937,7 @@ qreal Process::recvBps() const
 
 qreal Process::sentBps() const
 {
-    auto *sample = d->networkBandwidthSample->recentSample();
+    auto *sample = d->samples->networkBandwidthSample.recentSample();
     if (sample)
         return sample->data.outBps;
     else
@@ -740,12 +947,12 @@ qreal Process::sentBps() const
 void Process::setNetIoBps(qreal recvBps, qreal sendBps)
 {
     struct IOPS netIo = {recvBps, sendBps};
-    d->networkBandwidthSample->addSample(new IOPSSampleFrame(netIo));
+    d->mutableSamples().networkBandwidthSample.addSample(IOPSSampleFrame(netIo));
 }
 
 qulonglong Process::recvBytes() const
 {
-    auto *sample = d->networkIOSample->recentSample();
+    auto *sample = d->samples->networkIOSample.recentSample();
     if (sample)
         return sample->data.inBytes;
     else
@@ -754,7 +961,7 @@ qulonglong Process::recvBytes() const
 
 qulonglong Process::sentBytes() const
 {
-    auto *sample = d->networkIOSample->recentSample();
+    auto *sample = d->samples->networkIOSample.recentSample();
     if (sample)
         return sample->data.outBytes;
     else
@@ -870,19 +1077,66 @@ void Process::applyDKaptureData(const QVariantMap &pidData)
                     << "- rq_wait_time_ns:" << rq_wait_time_ns << "-> wtime:" << d->wtime;
     }
     
+    applyDKaptureDerived();
+}
+
+void Process::applyDKaptureRecord(const process_info_record_t &rec)
+{
+    // 与 applyDKaptureData 的转换一致，只是字段直接取自定长记录
+    setName(QString::fromUtf8(rec.comm, int(qstrnlen(rec.comm, sizeof(rec.comm)))));
+    if (rec.sections & kProcessInfoStat) {
+        if (rec.state)
+            setState(rec.state);
+        setPriority(rec.priority);
+        d->utime = rec.utime;
+        d->stime = rec.stime;
+        d->cutime = rec.cutime;
+        d->cstime = rec.cstime;
+        d->rss = rec.rss >> 10; // 字节转KB
+        d->vmsize = rec.vsize >> 10; // 字节转KB
+        d->ppid = rec.ppid;
+        d->nthreads = rec.num_threads;
+        d->nice = rec.nice;
+        d->start_time = rec.start_time;
+    }
+    if (rec.sections & kProcessInfoStatm) {
+        // 页数转KB，与readStatm()一致
+        d->rss = rec.memory_resident << kb_shift;
+        d->vmsize = rec.memory_size << kb_shift;
+        d->shm = rec.memory_shared << kb_shift;
+    }
+    if (rec.sections & kProcessInfoStatus) {
+        d->uid = rec.uid;
+        d->gid = rec.gid;
+        d->euid = rec.euid;
+        d->egid = rec.egid;
+    }
+    if (rec.sections & kProcessInfoIO) {
+        d->read_bytes = rec.read_bytes;
+        d->write_bytes = rec.write_bytes;
+        d->cancelled_write_bytes = rec.cancelled_write_bytes;
+    }
+    if (rec.sections & kProcessInfoSchedStat) {
+        d->wtime = rec.rq_wait_time * HZ / 1000000000;  // 纳秒转时钟滴答数
+    }
+
+    applyDKaptureDerived();
+}
+
+void Process::applyDKaptureDerived()
+{
     // 标记进程为有效，但需要检查关键数据读取是否成功
     d->valid = true;
     bool ok = true;
     
     // 读取关键信息并检查成功性
     ok = ok && readCmdline();    // cmdline是必需的，失败则进程无效
-    readEnviron();             // environ失败可以容忍
     // readSockInodes();        // plugin-popup 不需要网络流量计算
     
     // 只有关键操作都成功才保持进程有效
     d->valid = d->valid && ok;
     
-    d->usrerName = SysInfo::userName(d->uid);
+    d->usrerName = UserNameCache::instance()->userName(d->uid);
     d->proc_name.refreashProcessName(this);
     d->proc_icon.refreashProcessIcon(this);
     d->uptime = SysInfo::instance()->uptime();
@@ -904,9 +1158,10 @@ void Process::applyDKaptureData(const QVariantMap &pidData)
     // plugin-popup 是轻量级组件，网络数据由calculateProcessMetrics统一处理
     // 避免重复网络计算
 
-    auto netpair = d->networkIOSample->recentSamplePair();
+    ProcessSamples &samples = d->mutableSamples();
+    auto netpair = samples.networkIOSample.recentSamplePair();
     struct IOPS netiops = IOSampleFrame::iops(netpair.first, netpair.second);
-    d->networkBandwidthSample->addSample(new IOPSSampleFrame(netiops));
+    samples.networkBandwidthSample.addSample(IOPSSampleFrame(netiops));
     
     // qCInfo(app) << "Applied DKapture data to process" << pid() 
     //             << "- rss:" << (d->rss / 1024) << "KB"
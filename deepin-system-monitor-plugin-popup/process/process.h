@@ -16,11 +16,21 @@
 
 #include <sys/types.h>
 
+struct process_info_record_t;
+
+namespace core {
+namespace system {
+struct task_io_t;
+}
+}
+
 using namespace core::system;
 
 namespace core {
 namespace process {
 
+class ProcFdCache;
+
 enum ProcessPriority {
     kInvalidPriority = INT_MAX,
     kVeryHighPriority = -20, // default veryhigh priority
@@ -57,6 +67,11 @@ public:
     ~Process();
 
     bool isValid() const;
+    bool vanished() const;
+    /**
+     * @brief Deep copy, copies share their data otherwise
+     */
+    Process detached() const;
 
     pid_t pid() const;
     pid_t ppid() const;
@@ -75,6 +90,35 @@ public:
 
     qreal cpu() const;
     void setCpu(qreal cpu);
+    qulonglong wtime() const;
+    qulonglong guestTime() const;
+    qulonglong minorFaults() const;
+    qulonglong majorFaults() const;
+    qulonglong voluntarySwitches() const;
+    qulonglong involuntarySwitches() const;
+    qulonglong blkioDelay() const;
+    qulonglong swapinDelay() const;
+    qulonglong ioSyscalls() const;
+    void setTaskStats(const core::system::task_io_t &io);
+    qulonglong tcpRetrans() const;
+    qulonglong tcpSegsOut() const;
+    void setSmaps(qulonglong pss, qulonglong uss, qulonglong swap);
+    int fdCount() const;
+    qreal fdGrowthSince() const;
+    int fdGrowthBase() const;
+    qreal memoryTrend() const;
+    qreal memoryLeakSince() const;
+    qulonglong memoryLeakBase() const;
+    void setMemoryTrend(qreal trend, qreal leakSince, qulonglong leakBase);
+    void setMemoryExhaustion(qreal seconds, bool leak);
+    qreal power() const;
+    void setPower(qreal watts);
+    void setWakeups(qreal rate, qreal timerRate);
+    qreal blockedSince() const;
+    void setBlocked(qreal since, bool hung);
+    void setBlockingFunction(const QByteArray &function, int wait);
+    QList<int> drmFds() const;
+    void setGpu(qreal usage, qulonglong memory);
 
     qulonglong memory() const;
     qulonglong vtrmemory() const;
@@ -86,8 +130,11 @@ public:
     char state() const;
     void setState(char state);
 
+    unsigned int nthreads() const;
+
     QByteArrayList cmdline() const;
     QString cmdlineString() const;
+    bool isBareShell() const;
 
     QHash<QString, QString> environ() const;
 
@@ -115,13 +162,31 @@ public:
     qulonglong sentBytes() const;
 
     void readProcessInfo();
-    void readProcessVariableInfo();
     void readProcessSimpleInfo(bool skipStatReading = false);
+    /**
+     * @brief Read frequently changing info, fdCache is unused in popup
+     */
+    void readProcessVariableInfo(ProcFdCache *fdCache = nullptr);
+    /**
+     * @brief Raw /proc reads part of readProcessVariableInfo, safe to run in worker threads
+     * @return true: success; false: failure
+     */
+    bool readProcessVariableStats(ProcFdCache *fdCache = nullptr, bool readFds = true);
+    /**
+     * @brief Name & sample updates part of readProcessVariableInfo, must run on sampling thread
+     */
+    void updateProcessVariableMetrics();
     
     // DKapture data application method
     void applyDKaptureData(const QVariantMap &pidData);
+    // same as applyDKaptureData, from a fixed layout record of getProcessInfoRecords
+    void applyDKaptureRecord(const process_info_record_t &rec);
 
 private:
+    /**
+     * @brief Validity, cmdline, user, name & app type updates after DKapture data is applied
+     */
+    void applyDKaptureDerived();
     /**
      * @brief Read /proc/[pid]/stat
      * @return true: success; false: failure
@@ -132,10 +197,6 @@ private:
      * @return true: success; false: failure
      */
     bool readCmdline();
-    /**
-     * @brief Read /proc/[pid]/environ
-     */
-    void readEnviron();
     /**
      * @brief Read /proc/[pid]/schedstat
      */
@@ -162,7 +223,7 @@ private:
     void readSockInodes();
 
 private:
-    QSharedDataPointer<ProcessPrivate> d;
+    QExplicitlySharedDataPointer<ProcessPrivate> d;
 };
 
 } // namespace process
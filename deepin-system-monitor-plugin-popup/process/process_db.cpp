@@ -116,6 +116,9 @@ void ProcessDB::update()
     if (m_desktopEntryTimeCount++ && m_desktopEntryTimeCount >= DesktopEntryTimeCount) {
         m_desktopEntryTimeCount = 0;
         m_desktopEntryCache->updateCache();
+    } else {
+        // desktop files changed in between are picked up through inotify
+        m_desktopEntryCache->updateChanged();
     }
 
     m_windowList->updateWindowListCache();
@@ -22,9 +22,12 @@
 #include <ctype.h>
 #include <errno.h>
 #include <sched.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #define PROC_PATH_STAT "/proc/stat"
 #define PROC_PATH_CPUINFO "/proc/cpuinfo"
+#define SYSFS_PATH_SCALING_CUR_FREQ "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_cur_freq"
 
 using namespace common::error;
 using namespace common::alloc;
@@ -305,29 +308,143 @@ const CPUStat CPUSet::stat() const
 
 QList<QByteArray> CPUSet::cpuLogicName() const
 {
-    return d->m_usageDB.keys();
+    QList<QByteArray> names;
+    for (int cpu : d->m_cpuIds)
+        names << d->m_cpuNames[cpu];
+    return names;
+}
+
+static int cpuIdOf(const QByteArray &cpu)
+{
+    bool ok = false;
+    int id = cpu.startsWith("cpu") ? cpu.mid(3).toInt(&ok) : -1;
+    return ok ? id : -1;
 }
 
 const CPUStat CPUSet::statDB(const QByteArray &cpu) const
 {
-    return d->m_statDB[cpu];
+    int id = cpuIdOf(cpu);
+    if (id < 0 || id >= d->m_cpuNames.size())
+        return {};
+    return std::make_shared<cpu_stat_t>(cpuStat(id));
 }
 
 const CPUUsage CPUSet::usageDB(const QByteArray &cpu) const
 {
-    return d->m_usageDB[cpu];
+    int id = cpuIdOf(cpu);
+    if (id < 0 || id >= d->m_cpuNames.size())
+        return {};
+    return std::make_shared<cpu_usage_t>(cpuUsage(id));
+}
+
+QVector<int> CPUSet::cpuIds() const
+{
+    return d->m_cpuIds;
 }
 
+cpu_stat_t CPUSet::cpuStat(int cpu) const
+{
+    if (cpu < 0 || cpu >= d->m_cpuNames.size())
+        return {};
+
+    const common::usage::CoreJiffies &jiffies = d->m_cpuJiffies[kCurrentStat];
+    cpu_stat_t stat {};
+    stat.cpu = d->m_cpuNames[cpu];
+    stat.user = jiffies.user[size_t(cpu)];
+    stat.nice = jiffies.nice[size_t(cpu)];
+    stat.sys = jiffies.sys[size_t(cpu)];
+    stat.idle = jiffies.idle[size_t(cpu)];
+    stat.iowait = jiffies.iowait[size_t(cpu)];
+    stat.hardirq = jiffies.hardirq[size_t(cpu)];
+    stat.softirq = jiffies.softirq[size_t(cpu)];
+    stat.steal = jiffies.steal[size_t(cpu)];
+    stat.guest = jiffies.guest[size_t(cpu)];
+    stat.guest_nice = jiffies.guest_nice[size_t(cpu)];
+    return stat;
+}
+
+cpu_usage_t CPUSet::cpuUsage(int cpu) const
+{
+    if (cpu < 0 || cpu >= d->m_coreUsage.size())
+        return {};
+    return {d->m_cpuNames[cpu], d->m_coreUsage.total[size_t(cpu)], d->m_coreUsage.idle[size_t(cpu)]};
+}
+
+qreal CPUSet::cpuUsagePercent(int cpu) const
+{
+    if (cpu < 0 || cpu >= d->m_coreUsage.size())
+        return 0;
+    return d->m_coreUsage.usage[size_t(cpu)];
+}
+
+const common::usage::CoreUsage &CPUSet::coreUsage() const
+{
+    return d->m_coreUsage;
+}
 
 void CPUSet::update()
+{
+    updateStats();
+    // cpuinfo & lscpu are expensive, read them on first update only
+    if (d->m_infos.isEmpty())
+        updateOverallInfo();
+    else
+        updateFreq();
+}
+
+void CPUSet::updateStats()
 {
     read_stats();
-    read_overall_info();
+    common::usage::computeCoreUsage(d->m_cpuJiffies[kLastStat], d->m_cpuJiffies[kCurrentStat], d->m_coreUsage);
 
     d->cpusageTotal[kLastStat] = d->cpusageTotal[kCurrentStat];
     d->cpusageTotal[kCurrentStat] = d->m_usage->total;
 }
 
+void CPUSet::updateOverallInfo()
+{
+    read_overall_info();
+}
+
+void CPUSet::updateFreq()
+{
+    char path[128];
+    char buf[32];
+    unsigned long long maxKHz = 0;
+
+    for (int cpu : d->m_cpuIds) {
+        sprintf(path, SYSFS_PATH_SCALING_CUR_FREQ, cpu);
+        int fd = open(path, O_RDONLY);
+        if (fd < 0)
+            continue;
+        ssize_t n = read(fd, buf, sizeof(buf) - 1);
+        close(fd);
+        if (n <= 0)
+            continue;
+        buf[n] = '\0';
+
+        unsigned long long khz = 0;
+        if (sscanf(buf, "%llu", &khz) == 1)
+            maxKHz = qMax(maxKHz, khz);
+    }
+    // no cpufreq, keep lscpu snapshot
+    if (maxKHz == 0)
+        return;
+
+    d->m_info.insert("CPU MHz", QString::number(static_cast<double>(maxKHz) / 1000, 'f', 4));
+}
+
+void CPUSet::resizeCpuArrays(int size)
+{
+    int old = d->m_cpuNames.size();
+    d->m_cpuNames.resize(size);
+    d->m_cpuJiffies[kLastStat].resize(size);
+    d->m_cpuJiffies[kCurrentStat].resize(size);
+    d->m_coreUsage.resize(size);
+    for (int i = old; i < size; ++i)
+        d->m_cpuNames[i] = "cpu" + QByteArray::number(i);
+}
+
 void CPUSet::read_stats()
 {
     FILE *fp;
@@ -342,6 +459,10 @@ void CPUSet::read_stats()
     } // ::if(fopen)
     fPtr.reset(fp);
 
+    // current usage becomes previous, buffers keep their capacity across ticks
+    std::swap(d->m_cpuJiffies[kLastStat], d->m_cpuJiffies[kCurrentStat]);
+    d->m_cpuIds.clear();
+
     while (fgets(line.data(), BUFSIZ, fp)) {
         if (!strncmp(line.data(), "cpu ", 4)) {
             if (!d->m_stat) {
@@ -383,43 +504,31 @@ void CPUSet::read_stats()
             } // ::if(m_stat)
         } else if (!strncmp(line.data(), "cpu", 3)) {
             // per cpu stat in jiffies
-            auto stat = std::make_shared<struct cpu_stat_t>();
-            if (stat) {
-                *stat = {};
-
-                nr = sscanf(line.data() + 3, "%d %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
-                            &ncpu,
-                            &stat->user,
-                            &stat->nice,
-                            &stat->sys,
-                            &stat->idle,
-                            &stat->iowait,
-                            &stat->hardirq,
-                            &stat->softirq,
-                            &stat->steal,
-                            &stat->guest,
-                            &stat->guest_nice);
-
-                if (nr == 11) {
-                    QByteArray cpu {"cpu"};
-                    cpu.append(QByteArray::number(ncpu));
-                    stat->cpu = cpu;
-
-                    // usage calc
-                    auto usage = std::make_shared<struct cpu_usage_t>();
-                    if (usage) {
-                        *usage = {};
-                        usage->cpu = cpu;
-                        usage->total = stat->user + stat->nice + stat->sys + stat->idle + stat->iowait + stat->hardirq + stat->softirq + stat->steal;
-                        usage->idle = stat->idle + stat->iowait;
-
-                        d->m_statDB[stat->cpu] = stat;
-                        d->m_usageDB[usage->cpu] = usage;
-                    } //::if(usage)
-
-                } else
-                    print_errno(errno, QString("read %1 failed, cpu%2").arg(PROC_PATH_STAT).arg(ncpu));
-            } // ::if(stat)
+            if (sscanf(line.data() + 3, "%d", &ncpu) != 1 || ncpu < 0) {
+                print_errno(errno, QString("read %1 failed, cpu id").arg(PROC_PATH_STAT));
+                continue;
+            }
+            if (ncpu >= d->m_cpuNames.size())
+                resizeCpuArrays(ncpu + 1);
+
+            common::usage::CoreJiffies &jiffies = d->m_cpuJiffies[kCurrentStat];
+            size_t i = size_t(ncpu);
+            nr = sscanf(line.data() + 3, "%*d %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
+                        &jiffies.user[i],
+                        &jiffies.nice[i],
+                        &jiffies.sys[i],
+                        &jiffies.idle[i],
+                        &jiffies.iowait[i],
+                        &jiffies.hardirq[i],
+                        &jiffies.softirq[i],
+                        &jiffies.steal[i],
+                        &jiffies.guest[i],
+                        &jiffies.guest_nice[i]);
+
+            if (nr == 10)
+                d->m_cpuIds << ncpu;
+            else
+                print_errno(errno, QString("read %1 failed, cpu%2").arg(PROC_PATH_STAT).arg(ncpu));
         } else if (!strncmp(line.data(), "btime", 5)) {
             // read boot time in seconds since epoch
             struct timeval btime {
@@ -6,9 +6,11 @@
 #define CPUSET_H
 
 #include "system/cpu.h"
+#include "common/core_usage.h"
 
 #include <QList>
 #include <QSharedDataPointer>
+#include <QVector>
 
 namespace core {
 namespace system {
@@ -25,7 +27,7 @@ public:
 
     CPUSet &operator=(const CPUSet &rhs);
 
-    ~CPUSet();
+    virtual ~CPUSet();
 
 public://info
     QString modelName() const;
@@ -66,18 +68,57 @@ public://usage
 
     const CPUUsage usageDB(const QByteArray &cpu) const;
 
+    /**
+     * @brief Ids of cpus in the most recent stat read, ascending
+     */
+    QVector<int> cpuIds() const;
+
+    cpu_stat_t cpuStat(int cpu) const;
+
+    cpu_usage_t cpuUsage(int cpu) const;
+
+    /**
+     * @brief Usage percent of cpu between the last two stat reads
+     */
+    qreal cpuUsagePercent(int cpu) const;
+
+    /**
+     * @brief Usage of all cores between the last two stat reads, indexed by cpu id
+     */
+    const common::usage::CoreUsage &coreUsage() const;
+
     qulonglong getUsageTotalDelta() const;
+    /**
+     * @brief Total cpu time of the most recent stat read, in jiffies
+     */
+    qulonglong usageTotal() const;
 
 public:
     void update();
+    /**
+     * @brief Refresh /proc/stat based usage only
+     */
+    void updateStats();
+    /**
+     * @brief Refresh cpuinfo & lscpu snapshot, only needed once & on cpu hotplug
+     */
+    void updateOverallInfo();
+    /**
+     * @brief Sample current frequency from cpufreq sysfs
+     */
+    void updateFreq();
 
 private:
     void read_stats();
+    void resizeCpuArrays(int size);
 
     void read_overall_info();
 
 private:
     QSharedDataPointer<CPUSetPrivate> d;
+
+    // unused here, keeps the layout of main CPUSet, shared sources see that header
+    bool mIsEmptyModelName = false;
 };
 
 } // namespace system
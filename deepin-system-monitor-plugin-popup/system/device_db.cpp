@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "device_db.h"
+#include "system/device_snapshot.h"
 
 #include "cpu_set.h"
 #include "system/mem.h"
@@ -19,10 +20,13 @@
 #include <QReadLocker>
 #include <QWriteLocker>
 
+#include <atomic>
+
 namespace core {
 namespace system {
 
 DeviceDB::DeviceDB()
+    : m_snapshot(std::make_shared<DeviceSnapshot>())
 {
     m_cpuSet = new CPUSet();
     m_memInfo = new MemInfo();
@@ -62,6 +66,54 @@ void DeviceDB::update()
     m_diskIoInfo->update();
     m_blkDevInfoDB->update();
     m_netInfo->resdNetInfo();
+    publishSnapshot();
+}
+
+void DeviceDB::updateNetifInfo()
+{
+    // popup doesn't show per netif stats
+}
+
+void DeviceDB::updatePressure()
+{
+    // popup doesn't show pressure stall information
+}
+
+void DeviceDB::updateGpuInfo()
+{
+    // popup doesn't show gpu usage
+}
+
+void DeviceDB::updateSensorInfo()
+{
+    // popup doesn't show sensors
+}
+
+void DeviceDB::updateMemTuningInfo()
+{
+    // popup doesn't show huge page & compressed swap state
+}
+
+DeviceSnapshotPtr DeviceDB::snapshot() const
+{
+    return std::atomic_load(&m_snapshot);
+}
+
+void DeviceDB::publishSnapshot()
+{
+    std::shared_ptr<DeviceSnapshot> snapshot = std::make_shared<DeviceSnapshot>();
+    snapshot->cpuSet = *m_cpuSet;
+    snapshot->memInfo = *m_memInfo;
+    snapshot->blockDevices = m_blkDevInfoDB->deviceList();
+    snapshot->diskReadBps = m_diskIoInfo->diskIoReadBps();
+    snapshot->diskWriteBps = m_diskIoInfo->diskIoWriteBps();
+    snapshot->netRecvBps = m_netInfo->recvBps();
+    snapshot->netSentBps = m_netInfo->sentBps();
+    snapshot->netTotalRecvBytes = m_netInfo->totalRecvBytes();
+    snapshot->netTotalSentBytes = m_netInfo->totalSentBytes();
+
+    // readers holding the previous snapshot keep it alive until they drop it
+    std::atomic_store(&m_snapshot, DeviceSnapshotPtr(std::move(snapshot)));
 }
 
 DeviceDB *DeviceDB::instance()
@@ -6,17 +6,25 @@
 #ifndef DEVICE_DB_H
 #define DEVICE_DB_H
 
+#include <memory>
+
 namespace core {
 namespace system {
 
 class MemInfo;
 class CPUSet;
 class NetInfo;
+struct DeviceSnapshot;
+
+using DeviceSnapshotPtr = std::shared_ptr<const DeviceSnapshot>;
 class DiskIOInfo;
 class BlockDeviceInfoDB;
 
 /**
  * @brief The DeviceDB class
+ *
+ * Device objects are owned & updated by the monitor thread. Other threads read the
+ * state through snapshot(), the monitor publishes a new one after each refresh.
  */
 class DeviceDB
 {
@@ -33,6 +41,32 @@ public:
     NetInfo *netInfo();
 
     void update();
+    void updateNetifInfo();
+    /**
+     * @brief Sample pressure stall information of the system & of the user session
+     */
+    void updatePressure();
+    /**
+     * @brief Sample device level gpu utilization from sysfs
+     */
+    void updateGpuInfo();
+    /**
+     * @brief Read hwmon & thermal zone sensors
+     */
+    void updateSensorInfo();
+    /**
+     * @brief Read huge page, zswap & zram state
+     */
+    void updateMemTuningInfo();
+
+    /**
+     * @brief Latest published device state, never null, safe to call from any thread
+     */
+    DeviceSnapshotPtr snapshot() const;
+    /**
+     * @brief Copy current device state into a new snapshot & publish it, monitor thread only
+     */
+    void publishSnapshot();
 
 private:
     CPUSet *m_cpuSet;
@@ -40,6 +74,9 @@ private:
     NetInfo *m_netInfo;
     BlockDeviceInfoDB *m_blkDevInfoDB;
     DiskIOInfo *m_diskIoInfo;
+
+    // swapped with std::atomic_store, read with std::atomic_load
+    DeviceSnapshotPtr m_snapshot;
 };
 
 } // namespace system
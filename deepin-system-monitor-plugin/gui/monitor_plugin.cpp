@@ -18,6 +18,11 @@
 #include <QRegularExpression>
 namespace constantVal {
 const QString PLUGIN_STATE_KEY = "enable";
+// daemon samples every second, older snapshots mean it's gone
+const qint64 METRICS_MAX_AGE = 2500;
+const int SAMPLE_INTERVAL = 1000;
+// read a little after the daemon published
+const int SAMPLE_SLACK = 50;
 }
 
 DWIDGET_USE_NAMESPACE
@@ -30,6 +35,7 @@ MonitorPlugin::MonitorPlugin(QObject *parent)
       m_messageCallback(nullptr)
 #endif
 {
+    m_refershTimer->setSingleShot(true);
     connect(m_refershTimer, &QTimer::timeout, this, &MonitorPlugin::udpateTipsInfo);
     qCInfo(app) << "MonitorPlugin initialized";
 }
@@ -69,6 +75,9 @@ void MonitorPlugin::init(PluginProxyInterface *proxyInter)
     qCInfo(app) << "Quick panel widget setup completed - QUICKPANEL20";
     QDBusConnection::sessionBus().connect("com.deepin.SystemMonitorPluginPopup", "/com/deepin/SystemMonitorPluginPopup", "com.deepin.SystemMonitorPluginPopup", "sysMonPopVisibleChanged", this, SLOT(onSysMonPopVisibleChanged(bool)));
 #endif
+    QDBusConnection::sessionBus().connect(common::systemInfo().SessionManagerService, common::systemInfo().SessionManagerPath,
+                                          "org.freedesktop.DBus.Properties", "PropertiesChanged",
+                                          this, SLOT(onSessionPropertiesChanged(QString, QVariantMap, QStringList)));
 
     calcCpuRate(m_totalCPU, m_availableCPU);
     calcNetRate(m_down, m_upload);
@@ -130,6 +139,7 @@ bool MonitorPlugin::pluginIsDisable()
 QWidget *MonitorPlugin::itemTipsWidget(const QString &itemKey)
 {
     m_dataTipsLabel->setObjectName(itemKey);
+    updateDisplayText();
     m_dataTipsLabel->setSystemMonitorTipsText(QStringList() << m_cpuStr << m_memStr << m_downloadStr << m_uploadStr);
     return m_dataTipsLabel.data();
 }
@@ -238,50 +248,112 @@ QIcon MonitorPlugin::icon(const DockPart &dockPart, DGuiApplicationHelper::Color
 }
 #endif
 
-void MonitorPlugin::udpateInfo()
+int MonitorPlugin::udpateInfo()
 {
+    // figures sampled once for the session by the daemon, /proc is parsed here only without it
+    common::metrics::MetricsSample sample;
+    if (m_metrics.read(sample, constantVal::METRICS_MAX_AGE)) {
+        if (sample.sampledAt != m_lastSampledAt) {
+            m_lastSampledAt = sample.sampledAt;
+            updateInfoFromSnapshot(sample);
+        }
+        // wake when the next sample is out instead of polling in between
+        qint64 due = sample.sampledAt + constantVal::SAMPLE_INTERVAL + constantVal::SAMPLE_SLACK - common::metrics::monotonicNow();
+        return int(qBound<qint64>(constantVal::SAMPLE_SLACK * 2, due, constantVal::SAMPLE_INTERVAL + constantVal::SAMPLE_SLACK));
+    }
+    m_lastSampledAt = 0;
+
     // memory
     qlonglong memory = 0;
     qlonglong memoryAll = 0;
     calcMemRate(memory, memoryAll);
-    m_memStr = QString("%1").arg(memory * 100.0 / memoryAll, 1, 'f', 1, QLatin1Char(' ')) + QString("%");
+    m_memPercent = memoryAll ? memory * 100.0 / memoryAll : 0;
 
     // CPU
     qlonglong totalCPU = 0;
     qlonglong availableCPU = 0;
     calcCpuRate(totalCPU, availableCPU);
+    // first local sample, e.g. right after the daemon went away, only sets the baseline
+    bool primed = m_totalCPU != 0;
     double cpuPercent = 0.0;
-    if (totalCPU != m_totalCPU) {
+    if (primed && totalCPU != m_totalCPU) {
         cpuPercent = ((totalCPU - m_totalCPU) - (availableCPU - m_availableCPU)) * 100.0 / (totalCPU - m_totalCPU);
     }
-    m_cpuStr = QString("%1").arg(cpuPercent, 1, 'f', 1, QLatin1Char(' ')) + QString("%");
+    m_cpuPercent = cpuPercent;
     m_totalCPU = totalCPU;
     m_availableCPU = availableCPU;
 
-    // net
+    // net, rates over the measured interval, ticks of a busy dock come late
     qlonglong netUpload = 0;
     qlonglong netDownload = 0;
-    double downRate = 0.0;
-    double upRate = 0.0;
-
-    RateUnit unit = RateByte;
     calcNetRate(netDownload, netUpload);
-    downRate = autoRateUnits((netDownload - m_down) / (m_refershTimer->interval() / 1000), unit);
-    QString downUnit = setRateUnitSensitive(unit);
-    unit = RateByte;
-    upRate = autoRateUnits((netUpload - m_upload) / (m_refershTimer->interval() / 1000), unit);
-    QString uploadUnit = setRateUnitSensitive(unit);
-    m_downloadStr = QString("%1").arg(downRate, 1, 'f', 1, QLatin1Char(' ')) + downUnit;
-    m_uploadStr = QString("%1").arg(upRate, 1, 'f', 1, QLatin1Char(' ')) + uploadUnit;
+    double secs = primed && m_netClock.isValid() ? m_netClock.elapsed() / 1000.0 : 0;
+    m_netClock.start();
+    m_downBps = secs > 0 && netDownload >= m_down ? (netDownload - m_down) / secs : 0;
+    m_upBps = secs > 0 && netUpload >= m_upload ? (netUpload - m_upload) / secs : 0;
 
     m_down = netDownload;
     m_upload = netUpload;
+    return constantVal::SAMPLE_INTERVAL;
+}
+
+void MonitorPlugin::updateInfoFromSnapshot(const common::metrics::MetricsSample &sample)
+{
+    // rates are taken by the daemon over its measured interval
+    m_memPercent = sample.memTotal ? (sample.memTotal - sample.memAvailable) * 100.0 / sample.memTotal : 0;
+    m_cpuPercent = sample.cpuUsage;
+    m_downBps = sample.netRecvBps;
+    m_upBps = sample.netSentBps;
+
+    // local counters start over if the daemon goes away
+    m_totalCPU = m_availableCPU = 0;
+}
+
+bool MonitorPlugin::updateDisplayText()
+{
+    DisplayKey key;
+    key.cpu = qRound64(m_cpuPercent * 10);
+    key.mem = qRound64(m_memPercent * 10);
+    key.downUnit = RateByte;
+    double downRate = autoRateUnits(qlonglong(m_downBps), key.downUnit);
+    key.down = qRound64(downRate * 10);
+    key.uploadUnit = RateByte;
+    double upRate = autoRateUnits(qlonglong(m_upBps), key.uploadUnit);
+    key.upload = qRound64(upRate * 10);
+    if (key == m_displayKey)
+        return false;
+    m_displayKey = key;
+
+    m_cpuStr = QString("%1").arg(m_cpuPercent, 1, 'f', 1, QLatin1Char(' ')) + QString("%");
+    m_memStr = QString("%1").arg(m_memPercent, 1, 'f', 1, QLatin1Char(' ')) + QString("%");
+    m_downloadStr = QString("%1").arg(downRate, 1, 'f', 1, QLatin1Char(' ')) + setRateUnitSensitive(key.downUnit);
+    m_uploadStr = QString("%1").arg(upRate, 1, 'f', 1, QLatin1Char(' ')) + setRateUnitSensitive(key.uploadUnit);
+    return true;
 }
 
 void MonitorPlugin::udpateTipsInfo()
 {
-    udpateInfo();
-    m_dataTipsLabel->setSystemMonitorTipsText(QStringList() << m_cpuStr << m_memStr << m_downloadStr << m_uploadStr);
+    int next = udpateInfo();
+    // the tips relayout on each text change, unchanged figures are not set again
+    if (updateDisplayText())
+        m_dataTipsLabel->setSystemMonitorTipsText(QStringList() << m_cpuStr << m_memStr << m_downloadStr << m_uploadStr);
+    if (!m_sessionLocked && m_dataTipsLabel->isVisible())
+        m_refershTimer->start(next);
+}
+
+void MonitorPlugin::onSessionPropertiesChanged(const QString &interface, const QVariantMap &changed, const QStringList &invalidated)
+{
+    Q_UNUSED(interface);
+    Q_UNUSED(invalidated);
+    if (!changed.contains("Locked"))
+        return;
+
+    m_sessionLocked = changed.value("Locked").toBool();
+    qCDebug(app) << "Session locked changed:" << m_sessionLocked;
+    if (m_sessionLocked)
+        m_refershTimer->stop();
+    else if (m_pluginLoaded && m_dataTipsLabel->isVisible())
+        udpateTipsInfo();
 }
 
 void MonitorPlugin::loadPlugin()
@@ -296,21 +368,21 @@ void MonitorPlugin::loadPlugin()
     m_dataTipsLabel.reset(new SystemMonitorTipsWidget);
     m_dataTipsLabel->setObjectName("systemmonitorpluginlabel");
 
-    m_refershTimer->setInterval(1000);
-    //    m_refershTimer->start();
-
     connect(m_dataTipsLabel.get(), &SystemMonitorTipsWidget::visibleChanged, this, [=](bool visible) {
         if (!visible) {
             qCDebug(app) << "Tips widget hidden, stopping refresh timer";
             m_refershTimer->stop();
         } else {
             qCDebug(app) << "Tips widget shown, starting refresh timer";
-            udpateInfo();
+            int next = udpateInfo();
             m_dataTipsLabel->setSystemMonitorTipsText(QStringList() << "..."
                                                                     << "..."
                                                                     << "..."
                                                                     << "...");
-            m_refershTimer->start();
+            // placeholders shown, next figures are set whatever they are
+            m_displayKey = DisplayKey();
+            if (!m_sessionLocked)
+                m_refershTimer->start(next);
         }
     });
 
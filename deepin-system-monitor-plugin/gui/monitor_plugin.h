@@ -31,6 +31,7 @@
 
 #include "dbus/dbusinterface.h"
 #include "systemmonitortipswidget.h"
+#include "metrics_snapshot.h"
 
 // Qt
 #include <QDBusInterface>
@@ -41,6 +42,7 @@
 #include <QJsonDocument>
 #include <DGuiApplicationHelper>
 #include <QScopedPointer>
+#include <QElapsedTimer>
 
 #ifdef USE_API_QUICKPANEL20
 using namespace Dock;
@@ -195,8 +197,9 @@ public:
 private slots:
     //!
     //! \brief udpateInfo 更新CPU MEM NET信息
+    //! \return 距下次有新数据的时间(ms)，守护进程发布快照时按其采样时刻对齐
     //!
-    void udpateInfo();
+    int udpateInfo();
 
     //!
     //! \brief udpateTipsInfo 更新CPU MEM NET信息
@@ -215,6 +218,11 @@ private slots:
     void onSysMonPopVisibleChanged(bool);
 #endif
 
+    //!
+    //! \brief onSessionPropertiesChanged 锁屏时停止刷新，解锁后悬浮窗仍显示则恢复
+    //!
+    void onSessionPropertiesChanged(const QString &interface, const QVariantMap &changed, const QStringList &invalidated);
+
 private:
     //!
     //! \brief loadPlugin 加载插件
@@ -259,6 +267,18 @@ private:
     //!
     double autoRateUnits(qlonglong speed, RateUnit &unit);
 
+    //!
+    //! \brief updateInfoFromSnapshot 以守护进程发布的快照更新CPU MEM NET信息
+    //! \param sample 快照数据
+    //!
+    void updateInfoFromSnapshot(const common::metrics::MetricsSample &sample);
+
+    //!
+    //! \brief updateDisplayText 按显示精度(0.1)比较，数值变化时才重新生成显示字符串
+    //! \return 显示字符串是否变化
+    //!
+    bool updateDisplayText();
+
     //!
     //! \brief openSystemMonitor 打开系统监视器主界面
     //!
@@ -279,8 +299,37 @@ private:
     qlonglong m_upload = 0;
     qlonglong m_totalCPU = 0;
     qlonglong m_availableCPU = 0;
+    QElapsedTimer m_netClock;   //本地采样网络计数的间隔
+
+    //! 最近一次采样的数值
+    double m_cpuPercent = 0;
+    double m_memPercent = 0;
+    double m_downBps = 0;
+    double m_upBps = 0;
+
+    //!
+    //! \brief The DisplayKey struct 显示精度下的数值，相同则显示字符串不变
+    //!
+    struct DisplayKey {
+        qint64 cpu = -1;
+        qint64 mem = -1;
+        qint64 down = -1;
+        qint64 upload = -1;
+        RateUnit downUnit = RateUnknow;
+        RateUnit uploadUnit = RateUnknow;
+
+        bool operator==(const DisplayKey &other) const
+        {
+            return cpu == other.cpu && mem == other.mem && down == other.down && upload == other.upload
+                    && downUnit == other.downUnit && uploadUnit == other.uploadUnit;
+        }
+    };
+    DisplayKey m_displayKey;
 
-    QTimer *m_refershTimer;
+    QTimer *m_refershTimer;   //单次定时，每次按下次采样时刻重新启动
+    common::metrics::MetricsSnapshotReader m_metrics;
+    qint64 m_lastSampledAt = 0;   //上次读取的快照采样时刻，未变化则数值不变
+    bool m_sessionLocked = false;
 
     QString startup;
 
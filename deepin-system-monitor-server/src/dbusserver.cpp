@@ -7,13 +7,23 @@
 
 #include <QDBusMessage>
 #include <QDBusConnection>
-#include <QProcess>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDateTime>
 #include <QDebug>
 #include <QTimer>
 #include <QCoreApplication>
 
 using namespace DDLog;
 
+#define NotifyService "org.freedesktop.Notifications"
+#define NotifyPath "/org/freedesktop/Notifications"
+#define NotifyInterface "org.freedesktop.Notifications"
+// 与主程序alarm命令一致
+#define AlarmMessageTimeOut 10000
+// 点击按钮的动作key
+#define AlarmActionKey "_open1"
+
 DBusServer::DBusServer(QObject *parent)
     : QObject(parent)
 {
@@ -28,6 +38,10 @@ DBusServer::DBusServer(QObject *parent)
     } else {
         qCWarning(app) << "Failed to register service com.deepin.SystemMonitorServer";
     }
+    dbus.connect(NotifyService, NotifyPath, NotifyInterface, "ActionInvoked",
+                 this, SLOT(onActionInvoked(uint, QString)));
+    dbus.connect(NotifyService, NotifyPath, NotifyInterface, "NotificationClosed",
+                 this, SLOT(onNotificationClosed(uint, uint)));
     m_timer.setSingleShot(true);
     connect(&m_timer, &QTimer::timeout, this, [ = ]() {
         qCDebug(app) << "Exit timer timed out, quitting application";
@@ -44,21 +58,116 @@ void DBusServer::exitDBusServer(int msec)
 
 void DBusServer::showCpuAlarmNotify(const QString &argument)
 {
-    qCDebug(app) << "showCpuAlarmNotify called with argument:" << argument;
-    QProcess::startDetached("/usr/bin/deepin-system-monitor", QStringList() << "alarm" << "cpu" << argument);
-    exitDBusServer(8000);
+    showCpuAlarmNotify(argument, {});
+}
+
+void DBusServer::showCpuAlarmNotify(const QString &argument, const QString &offenders)
+{
+    qCDebug(app) << "showCpuAlarmNotify called with argument:" << argument << offenders;
+    bool isok = false;
+    int cpuUsage = argument.toInt(&isok);
+    if (!isok) {
+        qCWarning(app) << "Invalid CPU usage value:" << argument;
+        exitDBusServer(8000);
+        return;
+    }
+    // 译文沿用主程序alarm命令的翻译
+    showAlarmNotify(QCoreApplication::translate("DBusAlarmNotify", "Your CPU usage is higher than %1%!").arg(cpuUsage), offenders);
 }
 
 void DBusServer::showMemoryAlarmNotify(const QString &argument)
 {
-    qCDebug(app) << "showMemoryAlarmNotify called with argument:" << argument;
-    QProcess::startDetached("/usr/bin/deepin-system-monitor", QStringList() << "alarm" << "memory" << argument);
-    exitDBusServer(8000);
+    showMemoryAlarmNotify(argument, {});
+}
+
+void DBusServer::showMemoryAlarmNotify(const QString &argument, const QString &offenders)
+{
+    qCDebug(app) << "showMemoryAlarmNotify called with argument:" << argument << offenders;
+    bool isok = false;
+    int memoryUsage = argument.toInt(&isok);
+    if (!isok) {
+        qCWarning(app) << "Invalid memory usage value:" << argument;
+        exitDBusServer(8000);
+        return;
+    }
+    showAlarmNotify(QCoreApplication::translate("DBusAlarmNotify", "Your memory usage is higher than %1%!").arg(memoryUsage), offenders);
+}
+
+void DBusServer::showAlarmNotify(const QString &msg, const QString &offenders)
+{
+    qCDebug(app) << "Sending alarm notification:" << msg << offenders;
+    QDBusMessage notify = QDBusMessage::createMethodCall(NotifyService, NotifyPath, NotifyInterface, "Notify");
+    QStringList actions;
+    actions << AlarmActionKey << QCoreApplication::translate("DBusAlarmNotify", "View");
+    // 通知中心里的历史通知在服务退出后点击，由通知服务经守护进程打开系统监视器
+    QVariantMap hints;
+    hints.insert(QString("x-deepin-action-") + AlarmActionKey,
+                 QString("qdbus,org.deepin.SystemMonitorDaemon,"
+                         "/org/deepin/SystemMonitorDaemon,"
+                         "org.deepin.SystemMonitorDaemon.showDeepinSystemMoniter"));
+    notify << QString("deepin-system-monitor")   // app name
+           << uint(0)   // replaces id
+           << QString("deepin-system-monitor")   // icon
+           << QCoreApplication::translate("DBusAlarmNotify", "Warning")   // summary
+           << (offenders.isEmpty() ? msg : msg + "\n" + offenders)   // body
+           << actions
+           << hints
+           << int(AlarmMessageTimeOut);
+
+    auto *watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(notify), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, &DBusServer::onNotifyFinished);
+    // 等待按钮点击，通知关闭后提前退出
+    exitDBusServer(AlarmMessageTimeOut + 2000);
+}
+
+void DBusServer::onNotifyFinished(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<uint> reply = *watcher;
+    watcher->deleteLater();
+
+    qint64 lastAlarmTimeStamp = 0;
+    if (reply.isError()) {
+        qCWarning(app) << "Failed to send notification - Error:" << reply.error().name()
+                       << "Message:" << reply.error().message();
+        exitDBusServer(1000);
+    } else {
+        m_notifyIds << reply.value();
+        lastAlarmTimeStamp = QDateTime::currentDateTime().toMSecsSinceEpoch();
+    }
+    QDBusMessage setTime = QDBusMessage::createMethodCall("org.deepin.SystemMonitorDaemon",
+                                                          "/org/deepin/SystemMonitorDaemon",
+                                                          "org.deepin.SystemMonitorDaemon",
+                                                          "setAlaramLastTimeInterval");
+    setTime << lastAlarmTimeStamp;
+    QDBusConnection::sessionBus().asyncCall(setTime);
+    qCDebug(app) << "Alarm timestamp set to:" << lastAlarmTimeStamp;
+}
+
+void DBusServer::onActionInvoked(uint id, const QString &actionKey)
+{
+    if (!m_notifyIds.contains(id) || actionKey != AlarmActionKey)
+        return;
+    qCDebug(app) << "Alarm notification" << id << "clicked";
+    showDeepinSystemMoniter();
+}
+
+void DBusServer::onNotificationClosed(uint id, uint reason)
+{
+    if (!m_notifyIds.removeOne(id))
+        return;
+    qCDebug(app) << "Alarm notification" << id << "closed, reason:" << reason;
+    if (m_notifyIds.isEmpty())
+        exitDBusServer(1000);
 }
 
 void DBusServer::showDeepinSystemMoniter()
 {
     qCDebug(app) << "showDeepinSystemMoniter called";
+    if (m_lastShown.isValid() && m_lastShown.elapsed() < 2000) {
+        qCDebug(app) << "Main window was just shown, skip";
+        return;
+    }
+    m_lastShown.start();
     // 显示系统监视器
     auto launchProcessByAM = [](){
         qCDebug(app) << "Launching main window via ApplicationManager D-Bus call";
@@ -77,12 +186,13 @@ void DBusServer::showDeepinSystemMoniter()
         }
     };
     launchProcessByAM();
-    // QString cmd("qdbus com.deepin.SystemMonitorMain /com/deepin/SystemMonitorMain com.deepin.SystemMonitorMain.slotRaiseWindow");
-    QString cmd("gdbus call -e -d  com.deepin.SystemMonitorMain -o /com/deepin/SystemMonitorMain -m com.deepin.SystemMonitorMain.slotRaiseWindow");
-    qCDebug(app) << "Executing command to raise window:" << cmd;
     QTimer::singleShot(100, this, [ = ]() {
-        QProcess::startDetached(cmd);
-        qApp->processEvents();
+        qCDebug(app) << "Raising main window";
+        QDBusMessage raise = QDBusMessage::createMethodCall("com.deepin.SystemMonitorMain",
+                                                            "/com/deepin/SystemMonitorMain",
+                                                            "com.deepin.SystemMonitorMain",
+                                                            "slotRaiseWindow");
+        QDBusConnection::sessionBus().asyncCall(raise);
         exitDBusServer(8000);
     });
 }
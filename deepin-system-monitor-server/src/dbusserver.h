@@ -7,8 +7,11 @@
 
 #include <QObject>
 #include <QDBusContext>
+#include <QElapsedTimer>
 #include <QTimer>
 
+class QDBusPendingCallWatcher;
+
 class DBusServer : public QObject, protected QDBusContext
 {
     Q_OBJECT
@@ -24,20 +27,51 @@ public slots:
      * @param allArguments 警告提示信息
      */
     void showCpuAlarmNotify(const QString &argument);
+    /**
+     * @brief showCpuAlarmNotify 显示CPU警告提示及占用最高的进程
+     * @param offenders 报警时占用最高的进程
+     */
+    void showCpuAlarmNotify(const QString &argument, const QString &offenders);
 
     /**
      * @brief showMemoryAlarmNotify 显示Memory警告提示
      * @param allArguments 警告提示信息
      */
     void showMemoryAlarmNotify(const QString &argument);
+    void showMemoryAlarmNotify(const QString &argument, const QString &offenders);
 
     /**
      * @brief showDeepinSystemMoniter 显示系统监视器主页面
      */
     void showDeepinSystemMoniter();
 
+private slots:
+    /**
+     * @brief onActionInvoked 通知按钮点击，打开系统监视器
+     */
+    void onActionInvoked(uint id, const QString &actionKey);
+    /**
+     * @brief onNotificationClosed 通知关闭后退出服务
+     */
+    void onNotificationClosed(uint id, uint reason);
+
+private:
+    /**
+     * @brief showAlarmNotify 通过org.freedesktop.Notifications发送警告提示，不启动主程序
+     * @param msg 警告提示内容
+     */
+    void showAlarmNotify(const QString &msg, const QString &offenders);
+    /**
+     * @brief onNotifyFinished 记录告警时间，发送失败时重置以便下次重新告警
+     */
+    void onNotifyFinished(QDBusPendingCallWatcher *watcher);
+
 private:
     QTimer  m_timer;
+    // 已发送的通知id，只响应自己的通知
+    QList<uint> m_notifyIds;
+    // 通知服务和守护进程都可能转发按钮点击，避免重复打开
+    QElapsedTimer m_lastShown;
 };
 
 #endif // DBUS_OBJECT_H
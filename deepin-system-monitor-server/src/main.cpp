@@ -3,7 +3,9 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include <QCoreApplication>
+#include <QLocale>
 #include <QTimer>
+#include <QTranslator>
 #include <DConfig>
 #include <DLog>
 
@@ -31,6 +33,11 @@ int main(int argc, char *argv[])
     QCoreApplication a(argc, argv);
     qCDebug(app) << "QCoreApplication created";
 
+    // 告警提示沿用主程序的翻译
+    QTranslator translator;
+    if (translator.load(QLocale(), "deepin-system-monitor", "_", "/usr/share/deepin-system-monitor/translations"))
+        a.installTranslator(&translator);
+
     DBusServer dbusServer;
     dbusServer.exitDBusServer(10000);
 
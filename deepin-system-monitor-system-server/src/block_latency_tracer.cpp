@@ -0,0 +1,263 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "block_latency_tracer.h"
+#include "bpf_program.h"
+#include "ddlog.h"
+
+#include <QHash>
+
+#include <errno.h>
+#include <string.h>
+
+using namespace DDLog;
+using namespace bpf;
+
+namespace {
+
+// key of the in flight map, a request is known by its disk & first sector
+struct inflight_key_t {
+    uint32_t dev;
+    uint32_t pad;
+    uint64_t sector;
+};
+
+// key of the histogram map, slot is direction << 8 | bucket
+struct histogram_key_t {
+    uint32_t dev;
+    uint32_t slot;
+};
+
+struct tracepoint_t {
+    int id {-1};
+    int devOffset {-1};
+    int sectorOffset {-1};
+    int rwbsOffset {-1};
+};
+
+/**
+ * @brief Id & field offsets of block/<name>, the record layout differs between kernels
+ */
+bool readTracepoint(const char *name, tracepoint_t &tp)
+{
+    QString format;
+    tp.id = tracepointFormat("block", name, format);
+    if (tp.id < 0)
+        return false;
+    tp.devOffset = fieldOffset(format, "dev_t dev", 4);
+    tp.sectorOffset = fieldOffset(format, "sector_t sector", 8);
+    tp.rwbsOffset = fieldOffset(format, "char rwbs[]", 2);
+    return tp.devOffset >= 0 && tp.sectorOffset >= 0 && tp.rwbsOffset >= 0;
+}
+
+// on issue, in flight[dev, sector] = now
+std::vector<bpf_insn> issueProgram(const tracepoint_t &tp, int inflightMap)
+{
+    Program p;
+    p.movReg(BPF_REG_6, BPF_REG_1);
+    p.load(BPF_W, BPF_REG_2, BPF_REG_6, int16_t(tp.devOffset));
+    p.store(BPF_W, BPF_REG_10, -16, BPF_REG_2);
+    p.storeImm(BPF_W, BPF_REG_10, -12, 0);
+    p.load(BPF_DW, BPF_REG_2, BPF_REG_6, int16_t(tp.sectorOffset));
+    p.store(BPF_DW, BPF_REG_10, -8, BPF_REG_2);
+    p.call(BPF_FUNC_ktime_get_ns);
+    p.store(BPF_DW, BPF_REG_10, -24, BPF_REG_0);
+    p.loadMap(BPF_REG_1, inflightMap);
+    p.stackPointer(BPF_REG_2, -16);
+    p.stackPointer(BPF_REG_3, -24);
+    p.movImm(BPF_REG_4, BPF_ANY);
+    p.call(BPF_FUNC_map_update_elem);
+    p.movImm(BPF_REG_0, 0);
+    p.exit();
+    return p.finish();
+}
+
+// on completion, histogram[dev, direction, log2(now - in flight[dev, sector])] += 1
+std::vector<bpf_insn> completeProgram(const tracepoint_t &tp, int inflightMap, int histogramMap)
+{
+    enum { kOut, kDirection, kKey, kBucketed, kAdd };
+    Program p;
+    // r6 context, r7 issue time, r8 bucket, r9 disk, kept over calls
+    p.movReg(BPF_REG_6, BPF_REG_1);
+    p.load(BPF_W, BPF_REG_9, BPF_REG_6, int16_t(tp.devOffset));
+    p.store(BPF_W, BPF_REG_10, -16, BPF_REG_9);
+    p.storeImm(BPF_W, BPF_REG_10, -12, 0);
+    p.load(BPF_DW, BPF_REG_2, BPF_REG_6, int16_t(tp.sectorOffset));
+    p.store(BPF_DW, BPF_REG_10, -8, BPF_REG_2);
+    p.loadMap(BPF_REG_1, inflightMap);
+    p.stackPointer(BPF_REG_2, -16);
+    p.call(BPF_FUNC_map_lookup_elem);
+    // issued before tracing started
+    p.jumpImm(BPF_JEQ, BPF_REG_0, 0, kOut);
+    p.load(BPF_DW, BPF_REG_7, BPF_REG_0, 0);
+    p.loadMap(BPF_REG_1, inflightMap);
+    p.stackPointer(BPF_REG_2, -16);
+    p.call(BPF_FUNC_map_delete_elem);
+    p.call(BPF_FUNC_ktime_get_ns);
+    p.aluReg(BPF_SUB, BPF_REG_0, BPF_REG_7);
+    p.aluImm(BPF_DIV, BPF_REG_0, 1000);
+
+    // log2 of the latency in us by halving, no loops for old verifiers
+    p.movImm(BPF_REG_8, 0);
+    for (int shift : {32, 16, 8, 4, 2, 1}) {
+        const int skip = 100 + shift;
+        p.movReg(BPF_REG_1, BPF_REG_0);
+        p.aluImm(BPF_RSH, BPF_REG_1, shift);
+        p.jumpImm(BPF_JEQ, BPF_REG_1, 0, skip);
+        p.movReg(BPF_REG_0, BPF_REG_1);
+        p.aluImm(BPF_ADD, BPF_REG_8, shift);
+        p.label(skip);
+    }
+    p.jumpImm(BPF_JGT, BPF_REG_8, BLOCK_LATENCY_BUCKETS - 1, kBucketed);
+    p.jump(kDirection);
+    p.label(kBucketed);
+    p.movImm(BPF_REG_8, BLOCK_LATENCY_BUCKETS - 1);
+
+    // direction from rwbs, a preflush 'F' comes before it, discards & flushes aren't counted
+    p.label(kDirection);
+    p.load(BPF_B, BPF_REG_2, BPF_REG_6, int16_t(tp.rwbsOffset));
+    p.jumpImm(BPF_JNE, BPF_REG_2, 'F', kKey);
+    p.load(BPF_B, BPF_REG_2, BPF_REG_6, int16_t(tp.rwbsOffset + 1));
+    p.label(kKey);
+    p.movImm(BPF_REG_3, BLOCK_LATENCY_WRITE);
+    p.jumpImm(BPF_JEQ, BPF_REG_2, 'W', kAdd);
+    p.movImm(BPF_REG_3, BLOCK_LATENCY_READ);
+    p.jumpImm(BPF_JEQ, BPF_REG_2, 'R', kAdd);
+    p.jump(kOut);
+
+    p.label(kAdd);
+    p.aluImm(BPF_LSH, BPF_REG_3, 8);
+    p.aluReg(BPF_OR, BPF_REG_3, BPF_REG_8);
+    p.store(BPF_W, BPF_REG_10, -32, BPF_REG_9);
+    p.store(BPF_W, BPF_REG_10, -28, BPF_REG_3);
+    p.loadMap(BPF_REG_1, histogramMap);
+    p.stackPointer(BPF_REG_2, -32);
+    p.call(BPF_FUNC_map_lookup_elem);
+    const int kIncrement = 200;
+    p.jumpImm(BPF_JNE, BPF_REG_0, 0, kIncrement);
+    // first request of the slot, another cpu may insert it meanwhile
+    p.storeImm(BPF_DW, BPF_REG_10, -40, 0);
+    p.loadMap(BPF_REG_1, histogramMap);
+    p.stackPointer(BPF_REG_2, -32);
+    p.stackPointer(BPF_REG_3, -40);
+    p.movImm(BPF_REG_4, BPF_NOEXIST);
+    p.call(BPF_FUNC_map_update_elem);
+    p.loadMap(BPF_REG_1, histogramMap);
+    p.stackPointer(BPF_REG_2, -32);
+    p.call(BPF_FUNC_map_lookup_elem);
+    p.jumpImm(BPF_JEQ, BPF_REG_0, 0, kOut);
+    p.label(kIncrement);
+    p.movImm(BPF_REG_1, 1);
+    p.atomicAdd(BPF_REG_0, 0, BPF_REG_1);
+
+    p.label(kOut);
+    p.movImm(BPF_REG_0, 0);
+    p.exit();
+    return p.finish();
+}
+
+} // namespace
+
+BlockLatencyTracer::~BlockLatencyTracer()
+{
+    stop();
+}
+
+bool BlockLatencyTracer::start()
+{
+    if (isRunning())
+        return true;
+
+    tracepoint_t issue, complete;
+    if (!readTracepoint("block_rq_issue", issue) || !readTracepoint("block_rq_complete", complete)) {
+        qCWarning(app) << "Block request tracepoints not found, is tracefs mounted?";
+        return false;
+    }
+
+    m_inflightMap = createMap(BPF_MAP_TYPE_LRU_HASH, sizeof(inflight_key_t), sizeof(uint64_t), kMaxInflight);
+    m_histogramMap = createMap(BPF_MAP_TYPE_HASH, sizeof(histogram_key_t), sizeof(uint64_t), kMaxHistogramEntries);
+    if (m_inflightMap < 0 || m_histogramMap < 0) {
+        qCWarning(app) << "Failed to create block latency maps:" << strerror(errno);
+        stop();
+        return false;
+    }
+
+    m_issueProg = loadProgram(issueProgram(issue, m_inflightMap), "block_rq_issue");
+    m_completeProg = loadProgram(completeProgram(complete, m_inflightMap, m_histogramMap), "block_rq_complete");
+    if (m_issueProg < 0 || m_completeProg < 0) {
+        stop();
+        return false;
+    }
+
+    // completion first, so no request is stamped without being counted
+    m_completeEvent = attachProgram(complete.id, m_completeProg);
+    if (m_completeEvent >= 0)
+        m_issueEvent = attachProgram(issue.id, m_issueProg);
+    if (m_issueEvent < 0) {
+        qCWarning(app) << "Failed to attach block latency programs:" << strerror(errno);
+        stop();
+        return false;
+    }
+    qCInfo(app) << "Block request latency tracing started";
+    return true;
+}
+
+void BlockLatencyTracer::stop()
+{
+    closeFd(m_issueEvent);
+    closeFd(m_completeEvent);
+    closeFd(m_issueProg);
+    closeFd(m_completeProg);
+    closeFd(m_inflightMap);
+    closeFd(m_histogramMap);
+}
+
+bool BlockLatencyTracer::read(std::vector<block_latency_record_t> &records) const
+{
+    records.clear();
+    if (!isRunning())
+        return false;
+
+    QHash<quint64, size_t> index; // dev << 32 | direction
+    histogram_key_t key {};
+    histogram_key_t next {};
+    union bpf_attr attr;
+    bool first = true;
+    for (;;) {
+        memset(&attr, 0, sizeof(attr));
+        attr.map_fd = uint32_t(m_histogramMap);
+        attr.key = first ? 0 : uint64_t(uintptr_t(&key));
+        attr.next_key = uint64_t(uintptr_t(&next));
+        if (sysBpf(BPF_MAP_GET_NEXT_KEY, &attr) < 0)
+            break;
+        first = false;
+        key = next;
+
+        uint64_t count = 0;
+        memset(&attr, 0, sizeof(attr));
+        attr.map_fd = uint32_t(m_histogramMap);
+        attr.key = uint64_t(uintptr_t(&key));
+        attr.value = uint64_t(uintptr_t(&count));
+        const uint32_t dir = key.slot >> 8;
+        const uint32_t bucket = key.slot & 0xff;
+        if (sysBpf(BPF_MAP_LOOKUP_ELEM, &attr) < 0 || bucket >= BLOCK_LATENCY_BUCKETS)
+            continue;
+
+        const quint64 id = (quint64(key.dev) << 32) | dir;
+        auto it = index.constFind(id);
+        if (it == index.constEnd()) {
+            block_latency_record_t rec {};
+            rec.dev = key.dev;
+            rec.dir = dir;
+            records.push_back(rec);
+            it = index.insert(id, records.size() - 1);
+        }
+        records[*it].buckets[bucket] = count;
+    }
+    if (errno != ENOENT) {
+        qCWarning(app) << "Failed to read block latency histogram:" << strerror(errno);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef BLOCK_LATENCY_TRACER_H
+#define BLOCK_LATENCY_TRACER_H
+
+#include "process_info_record.h"
+
+#include <vector>
+
+/**
+ * @brief Latency histograms of block requests, aggregated in the kernel
+ *
+ * DKapture has no block layer events, so two small tracepoint programs are loaded with bpf(2)
+ * directly: block_rq_issue stamps each request by disk & sector, block_rq_complete counts its
+ * latency in the log2 bucket of its disk & direction. Nothing reaches user space per request,
+ * read() walks the histogram map, one entry per disk, direction & bucket in use.
+ *
+ * Tracepoint field offsets are taken from tracefs, which must be mounted.
+ */
+class BlockLatencyTracer
+{
+public:
+    BlockLatencyTracer() = default;
+    ~BlockLatencyTracer();
+
+    /**
+     * @brief Load & attach the programs, counts start from zero
+     * @return false if the kernel lacks bpf, the block tracepoints or tracefs
+     */
+    bool start();
+    void stop();
+    inline bool isRunning() const { return m_issueEvent >= 0; }
+
+    /**
+     * @brief Counts since start, one record per disk & direction
+     */
+    bool read(std::vector<block_latency_record_t> &records) const;
+
+    // requests in flight tracked at once, the oldest are evicted past it, e.g. requeued ones
+    static constexpr int kMaxInflight = 16384;
+    // disk, direction & bucket entries of the histogram
+    static constexpr int kMaxHistogramEntries = 8192;
+
+private:
+    BlockLatencyTracer(const BlockLatencyTracer &) = delete;
+    BlockLatencyTracer &operator=(const BlockLatencyTracer &) = delete;
+
+    int m_inflightMap {-1};
+    int m_histogramMap {-1};
+    int m_issueProg {-1};
+    int m_completeProg {-1};
+    int m_issueEvent {-1};
+    int m_completeEvent {-1};
+};
+
+#endif // BLOCK_LATENCY_TRACER_H
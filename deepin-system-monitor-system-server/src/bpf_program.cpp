@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bpf_program.h"
+#include "ddlog.h"
+
+#include <QFile>
+#include <QRegularExpression>
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+
+#include <linux/perf_event.h>
+
+using namespace DDLog;
+
+namespace {
+
+const char *const kTracefsRoots[] = {"/sys/kernel/tracing", "/sys/kernel/debug/tracing"};
+
+} // namespace
+
+namespace bpf {
+
+long sysBpf(int cmd, union bpf_attr *attr)
+{
+    return syscall(__NR_bpf, cmd, attr, sizeof(*attr));
+}
+
+int tracepointFormat(const char *category, const char *name, QString &format)
+{
+    for (const char *root : kTracefsRoots) {
+        QFile file(QString("%1/events/%2/%3/format").arg(root).arg(category).arg(name));
+        if (!file.open(QIODevice::ReadOnly))
+            continue;
+
+        static const QRegularExpression kId("^ID:\\s*(\\d+)", QRegularExpression::MultilineOption);
+        format = QString::fromLatin1(file.readAll());
+        QRegularExpressionMatch match = kId.match(format);
+        return match.hasMatch() ? match.captured(1).toInt() : -1;
+    }
+    return -1;
+}
+
+int fieldOffset(const QString &format, const QString &decl, int size)
+{
+    static const QRegularExpression kField("field:([^;]*);\\s*offset:(\\d+);\\s*size:(\\d+);");
+    const bool array = decl.endsWith("[]");
+    const QString prefix = array ? decl.chopped(1) : decl;
+    auto fields = kField.globalMatch(format);
+    while (fields.hasNext()) {
+        QRegularExpressionMatch match = fields.next();
+        const QString field = match.captured(1).simplified();
+        const int fieldSize = match.captured(3).toInt();
+        if (array ? field.startsWith(prefix) && fieldSize >= size : field == decl && fieldSize == size)
+            return match.captured(2).toInt();
+    }
+    return -1;
+}
+
+int createMap(bpf_map_type type, uint32_t keySize, uint32_t valueSize, uint32_t maxEntries)
+{
+    union bpf_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.map_type = type;
+    attr.key_size = keySize;
+    attr.value_size = valueSize;
+    attr.max_entries = maxEntries;
+    return int(sysBpf(BPF_MAP_CREATE, &attr));
+}
+
+void Program::emit(uint8_t code, uint8_t dst, uint8_t src, int16_t off, int32_t imm)
+{
+    bpf_insn insn;
+    memset(&insn, 0, sizeof(insn));
+    insn.code = code;
+    insn.dst_reg = dst;
+    insn.src_reg = src;
+    insn.off = off;
+    insn.imm = imm;
+    m_insns.push_back(insn);
+}
+
+void Program::loadMap(uint8_t dst, int fd)
+{
+    emit(BPF_LD | BPF_DW | BPF_IMM, dst, BPF_PSEUDO_MAP_FD, 0, fd);
+    emit(0, 0, 0, 0, 0);
+}
+
+void Program::stackPointer(uint8_t dst, int16_t off)
+{
+    movReg(dst, BPF_REG_10);
+    aluImm(BPF_ADD, dst, off);
+}
+
+void Program::jumpImm(uint8_t op, uint8_t dst, int32_t imm, int label)
+{
+    m_fixups.push_back({int(m_insns.size()), label});
+    emit(BPF_JMP | op | BPF_K, dst, 0, 0, imm);
+}
+
+const std::vector<bpf_insn> &Program::finish()
+{
+    for (const auto &fixup : m_fixups)
+        m_insns[size_t(fixup.first)].off = int16_t(m_labels.value(fixup.second) - fixup.first - 1);
+    return m_insns;
+}
+
+int loadProgram(const std::vector<bpf_insn> &insns, const char *name)
+{
+    static char license[] = "GPL";
+    union bpf_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.prog_type = BPF_PROG_TYPE_TRACEPOINT;
+    attr.insns = uint64_t(uintptr_t(insns.data()));
+    attr.insn_cnt = uint32_t(insns.size());
+    attr.license = uint64_t(uintptr_t(license));
+    int fd = int(sysBpf(BPF_PROG_LOAD, &attr));
+    if (fd >= 0)
+        return fd;
+
+    // load again for the verifier's reason
+    std::vector<char> log(16384);
+    attr.log_buf = uint64_t(uintptr_t(log.data()));
+    attr.log_size = uint32_t(log.size());
+    attr.log_level = 1;
+    int err = errno;
+    fd = int(sysBpf(BPF_PROG_LOAD, &attr));
+    if (fd >= 0)
+        return fd;
+    qCWarning(app) << "Failed to load" << name << "program:" << strerror(err) << log.data();
+    return -1;
+}
+
+int attachProgram(int id, int prog)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_TRACEPOINT;
+    attr.size = sizeof(attr);
+    attr.config = uint64_t(id);
+    attr.sample_period = 1;
+    attr.wakeup_events = 1;
+    // the program runs for the tracepoint on every cpu, the event of one cpu holds it
+    int fd = int(syscall(__NR_perf_event_open, &attr, -1, 0, -1, PERF_FLAG_FD_CLOEXEC));
+    if (fd < 0)
+        return -1;
+    if (ioctl(fd, PERF_EVENT_IOC_SET_BPF, prog) < 0 || ioctl(fd, PERF_EVENT_IOC_ENABLE, 0) < 0) {
+        int err = errno;
+        close(fd);
+        errno = err;
+        return -1;
+    }
+    return fd;
+}
+
+void closeFd(int &fd)
+{
+    if (fd >= 0)
+        close(fd);
+    fd = -1;
+}
+
+} // namespace bpf
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef BPF_PROGRAM_H
+#define BPF_PROGRAM_H
+
+#include <QHash>
+#include <QString>
+
+#include <vector>
+
+#include <linux/bpf.h>
+
+/**
+ * @brief Helpers of the tracepoint programs the server loads with bpf(2) directly
+ *
+ * The programs are small & assembled at runtime, no compiler or BTF is needed on the target.
+ * Tracepoint field offsets are taken from tracefs, which must be mounted.
+ */
+namespace bpf {
+
+long sysBpf(int cmd, union bpf_attr *attr);
+
+/**
+ * @brief Id & record format of the tracepoint <category>/<name>
+ * @return -1 if tracefs or the tracepoint is missing
+ */
+int tracepointFormat(const char *category, const char *name, QString &format);
+/**
+ * @brief Offset of a field in a tracepoint record, the layout differs between kernels
+ * @param decl Declaration as in the format, e.g. "dev_t dev", arrays of any length as "char rwbs[]"
+ * @param size Field size in bytes, the minimum for arrays
+ * @return -1 if missing
+ */
+int fieldOffset(const QString &format, const QString &decl, int size);
+
+int createMap(bpf_map_type type, uint32_t keySize, uint32_t valueSize, uint32_t maxEntries);
+
+/**
+ * @brief Minimal assembler of tracepoint programs, jumps are resolved by label
+ */
+class Program
+{
+public:
+    void emit(uint8_t code, uint8_t dst, uint8_t src, int16_t off, int32_t imm);
+    void movReg(uint8_t dst, uint8_t src) { emit(BPF_ALU64 | BPF_MOV | BPF_X, dst, src, 0, 0); }
+    void movImm(uint8_t dst, int32_t imm) { emit(BPF_ALU64 | BPF_MOV | BPF_K, dst, 0, 0, imm); }
+    void aluImm(uint8_t op, uint8_t dst, int32_t imm) { emit(BPF_ALU64 | op | BPF_K, dst, 0, 0, imm); }
+    void aluReg(uint8_t op, uint8_t dst, uint8_t src) { emit(BPF_ALU64 | op | BPF_X, dst, src, 0, 0); }
+    void load(uint8_t size, uint8_t dst, uint8_t src, int16_t off) { emit(BPF_LDX | size | BPF_MEM, dst, src, off, 0); }
+    void store(uint8_t size, uint8_t dst, int16_t off, uint8_t src) { emit(BPF_STX | size | BPF_MEM, dst, src, off, 0); }
+    void storeImm(uint8_t size, uint8_t dst, int16_t off, int32_t imm) { emit(BPF_ST | size | BPF_MEM, dst, 0, off, imm); }
+    // *(u64 *)(dst + off) += src, atomic
+    void atomicAdd(uint8_t dst, int16_t off, uint8_t src) { emit(BPF_STX | BPF_DW | BPF_XADD, dst, src, off, 0); }
+    void loadMap(uint8_t dst, int fd);
+    void stackPointer(uint8_t dst, int16_t off);
+    void call(int32_t func) { emit(BPF_JMP | BPF_CALL, 0, 0, 0, func); }
+    void jumpImm(uint8_t op, uint8_t dst, int32_t imm, int label);
+    void jump(int label) { jumpImm(BPF_JA, 0, 0, label); }
+    void label(int label) { m_labels[label] = int(m_insns.size()); }
+    void exit() { emit(BPF_JMP | BPF_EXIT, 0, 0, 0, 0); }
+
+    const std::vector<bpf_insn> &finish();
+
+private:
+    std::vector<bpf_insn> m_insns;
+    std::vector<std::pair<int, int>> m_fixups; // jump index, label
+    QHash<int, int> m_labels;
+};
+
+/**
+ * @brief Load a tracepoint program, the verifier's log is reported on failure
+ */
+int loadProgram(const std::vector<bpf_insn> &insns, const char *name);
+/**
+ * @brief Attach a program to the tracepoint of \a id on every cpu
+ * @return Perf event fd, the program runs until it's closed
+ */
+int attachProgram(int id, int prog);
+void closeFd(int &fd);
+
+} // namespace bpf
+
+#endif // BPF_PROGRAM_H
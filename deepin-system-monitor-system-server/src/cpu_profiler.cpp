@@ -0,0 +1,379 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "cpu_profiler.h"
+#include "ddlog.h"
+
+#include <QFile>
+#include <QSet>
+
+#include <algorithm>
+
+#include <dirent.h>
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+using namespace DDLog;
+
+namespace {
+
+// data pages of each ring, a power of two, 32k holds a few seconds of samples at the maximum rate
+const size_t kRingPages = 8;
+// threads started meanwhile are looked for at this interval, ms
+const qint64 kRescanInterval = 1000;
+
+struct kernel_symbol_t {
+    uint64_t addr;
+    const char *name; // into the kallsyms buffer, "name" or "name\t[module]"
+    size_t len;
+};
+
+void copyRing(const char *data, uint64_t size, uint64_t pos, void *dest, size_t len)
+{
+    const uint64_t offset = pos & (size - 1);
+    const size_t first = size_t(std::min<uint64_t>(len, size - offset));
+    memcpy(dest, data + offset, first);
+    if (first < len)
+        memcpy(static_cast<char *>(dest) + first, data, len - first);
+}
+
+/**
+ * @brief Text symbols of kallsyms, sorted by address
+ * @return false if kallsyms is unreadable or its addresses hidden
+ */
+bool readKernelSymbols(QByteArray &buf, std::vector<kernel_symbol_t> &symbols)
+{
+    QFile file("/proc/kallsyms");
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    buf = file.readAll();
+
+    // "ffffffffc0a01000 t nfs_wait_bit_killable\t[nfs]"
+    const char *p = buf.constData();
+    const char *end = p + buf.size();
+    while (p < end) {
+        const char *eol = static_cast<const char *>(memchr(p, '\n', size_t(end - p)));
+        if (!eol)
+            eol = end;
+        char *typePos = nullptr;
+        const uint64_t addr = strtoull(p, &typePos, 16);
+        if (typePos && typePos + 3 < eol && typePos[0] == ' ' && (typePos[1] == 't' || typePos[1] == 'T') && addr)
+            symbols.push_back({addr, typePos + 3, size_t(eol - typePos - 3)});
+        p = eol + 1;
+    }
+    std::sort(symbols.begin(), symbols.end(), [](const kernel_symbol_t &a, const kernel_symbol_t &b) {
+        return a.addr < b.addr;
+    });
+    return !symbols.empty();
+}
+
+const kernel_symbol_t *findKernelSymbol(const std::vector<kernel_symbol_t> &symbols, uint64_t ip)
+{
+    auto it = std::upper_bound(symbols.begin(), symbols.end(), ip, [](uint64_t ip, const kernel_symbol_t &sym) {
+        return ip < sym.addr;
+    });
+    if (it == symbols.begin())
+        return nullptr;
+    return &*(it - 1);
+}
+
+} // namespace
+
+CpuProfiler::~CpuProfiler()
+{
+    close();
+}
+
+bool CpuProfiler::open(int pid, int frequency)
+{
+    close();
+    m_pid = pid;
+    m_frequency = frequency;
+    m_pageSize = size_t(sysconf(_SC_PAGESIZE));
+    m_stacks.clear();
+    m_samples = 0;
+    m_lost = 0;
+    m_sampledThreads = 0;
+
+    // the process may be gone when the profile ends
+    m_mappings.clear();
+    readMappings(pid, m_mappings);
+    rescanThreads();
+    if (m_threads.isEmpty()) {
+        qCWarning(app) << "Failed to open cpu profile events of" << pid << strerror(errno);
+        return false;
+    }
+    qCInfo(app) << "Cpu profile of" << pid << "opened on" << m_threads.size() << "threads at" << frequency << "Hz";
+    return true;
+}
+
+void CpuProfiler::close()
+{
+    for (thread_t &thread : m_threads)
+        closeThread(thread);
+    m_threads.clear();
+}
+
+bool CpuProfiler::openThread(int tid)
+{
+    perf_event_attr attr {};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_SOFTWARE;
+    // runs only while the thread is on cpu
+    attr.config = PERF_COUNT_SW_CPU_CLOCK;
+    attr.freq = 1;
+    attr.sample_freq = uint64_t(m_frequency);
+    attr.sample_type = PERF_SAMPLE_CALLCHAIN;
+    attr.exclude_hv = 1;
+    int fd = int(syscall(__NR_perf_event_open, &attr, tid, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    if (fd < 0)
+        return false;
+
+    void *ring = mmap(nullptr, (kRingPages + 1) * m_pageSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ring == MAP_FAILED) {
+        int err = errno;
+        ::close(fd);
+        errno = err;
+        return false;
+    }
+    m_threads.insert(tid, {fd, ring});
+    ++m_sampledThreads;
+    return true;
+}
+
+void CpuProfiler::closeThread(thread_t &thread)
+{
+    if (thread.ring)
+        munmap(thread.ring, (kRingPages + 1) * m_pageSize);
+    if (thread.fd >= 0)
+        ::close(thread.fd);
+    thread.ring = nullptr;
+    thread.fd = -1;
+}
+
+void CpuProfiler::rescanThreads()
+{
+    m_rescan.start();
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/task", m_pid);
+    DIR *dir = opendir(path);
+    if (!dir)
+        return;
+    while (struct dirent *entry = readdir(dir)) {
+        const int tid = atoi(entry->d_name);
+        if (tid <= 0 || m_threads.contains(tid))
+            continue;
+        if (m_threads.size() >= kMaxThreads)
+            break;
+        openThread(tid);
+    }
+    closedir(dir);
+}
+
+bool CpuProfiler::poll(int timeout)
+{
+    if (m_threads.isEmpty())
+        return false;
+
+    std::vector<pollfd> fds;
+    std::vector<int> tids;
+    fds.reserve(size_t(m_threads.size()));
+    tids.reserve(size_t(m_threads.size()));
+    for (auto it = m_threads.cbegin(); it != m_threads.cend(); ++it) {
+        fds.push_back({it->fd, POLLIN, 0});
+        tids.push_back(it.key());
+    }
+    if (::poll(fds.data(), nfds_t(fds.size()), timeout) < 0 && errno != EINTR)
+        return false;
+
+    // rings are drained each call, a thread's ring wakes poll only once it's half full
+    for (size_t i = 0; i < fds.size(); ++i) {
+        auto it = m_threads.find(tids[i]);
+        drain(it.value());
+        // the thread exited, its last samples were just drained
+        if (fds[i].revents & POLLHUP) {
+            closeThread(it.value());
+            m_threads.erase(it);
+        }
+    }
+
+    if (m_rescan.elapsed() >= kRescanInterval)
+        rescanThreads();
+    return !m_threads.isEmpty();
+}
+
+void CpuProfiler::drain(thread_t &thread)
+{
+    auto *meta = static_cast<perf_event_mmap_page *>(thread.ring);
+    const char *data = static_cast<const char *>(thread.ring) + m_pageSize;
+    const uint64_t size = kRingPages * m_pageSize;
+    const uint64_t head = __atomic_load_n(&meta->data_head, __ATOMIC_ACQUIRE);
+    uint64_t tail = meta->data_tail;
+
+    while (head - tail >= sizeof(perf_event_header)) {
+        perf_event_header hdr;
+        copyRing(data, size, tail, &hdr, sizeof(hdr));
+        if (hdr.size < sizeof(hdr) || head - tail < hdr.size) {
+            tail = head;
+            break;
+        }
+        if (hdr.type == PERF_RECORD_SAMPLE || hdr.type == PERF_RECORD_LOST) {
+            m_record.resize(hdr.size);
+            copyRing(data, size, tail, m_record.data(), hdr.size);
+            const uint64_t *body = reinterpret_cast<const uint64_t *>(m_record.data() + sizeof(hdr));
+            const size_t words = (hdr.size - sizeof(hdr)) / sizeof(uint64_t);
+            if (hdr.type == PERF_RECORD_SAMPLE && words >= 1 && body[0] <= words - 1) {
+                countSample(body + 1, body[0]);
+            } else if (hdr.type == PERF_RECORD_LOST && words >= 2) {
+                // id, lost
+                m_samples += body[1];
+                m_lost += body[1];
+            }
+        }
+        tail += hdr.size;
+    }
+    __atomic_store_n(&meta->data_tail, tail, __ATOMIC_RELEASE);
+}
+
+void CpuProfiler::countSample(const uint64_t *ips, uint64_t nr)
+{
+    ++m_samples;
+
+    // the kernel frames come first, each part after its context marker
+    uint64_t chain[1 + CPU_PROFILE_MAX_DEPTH];
+    uint64_t *frames = chain + 1;
+    uint32_t depth = 0;
+    uint32_t kernelDepth = 0;
+    uint64_t context = PERF_CONTEXT_USER;
+    for (uint64_t i = 0; i < nr && depth < CPU_PROFILE_MAX_DEPTH; ++i) {
+        const uint64_t ip = ips[i];
+        if (ip >= uint64_t(PERF_CONTEXT_MAX)) {
+            context = ip;
+            continue;
+        }
+        if (context == PERF_CONTEXT_KERNEL) {
+            if (depth != kernelDepth)
+                continue;
+            ++kernelDepth;
+        } else if (context != PERF_CONTEXT_USER) {
+            continue;
+        }
+        frames[depth++] = ip;
+    }
+    if (!depth) {
+        ++m_lost;
+        return;
+    }
+
+    chain[0] = kernelDepth;
+    const QByteArray key(reinterpret_cast<const char *>(chain), int((1 + depth) * sizeof(uint64_t)));
+    auto it = m_stacks.find(key);
+    if (it == m_stacks.end()) {
+        if (m_stacks.size() >= CPU_PROFILE_MAX_STACKS) {
+            ++m_lost;
+            return;
+        }
+        it = m_stacks.insert(key, 0);
+    }
+    ++it.value();
+}
+
+void CpuProfiler::profile(std::vector<cpu_profile_stack_t> &stacks, std::vector<cpu_profile_symbol_t> &symbols,
+                          std::vector<cpu_profile_mapping_t> &mappings)
+{
+    stacks.clear();
+    symbols.clear();
+    stacks.reserve(size_t(m_stacks.size()));
+    for (auto it = m_stacks.cbegin(); it != m_stacks.cend(); ++it) {
+        cpu_profile_stack_t rec;
+        memset(&rec, 0, sizeof(rec));
+        const QByteArray &key = it.key();
+        uint64_t kernelDepth;
+        memcpy(&kernelDepth, key.constData(), sizeof(kernelDepth));
+        rec.count = it.value();
+        rec.kernel_depth = uint32_t(kernelDepth);
+        rec.depth = uint32_t(size_t(key.size()) / sizeof(uint64_t) - 1);
+        memcpy(rec.ips, key.constData() + sizeof(uint64_t), rec.depth * sizeof(uint64_t));
+        stacks.push_back(rec);
+    }
+    std::sort(stacks.begin(), stacks.end(), [](const cpu_profile_stack_t &a, const cpu_profile_stack_t &b) {
+        return a.count > b.count;
+    });
+
+    // kernel frames point at their function, so the client needs one name per function
+    QByteArray kallsyms;
+    std::vector<kernel_symbol_t> kernelSymbols;
+    if (readKernelSymbols(kallsyms, kernelSymbols)) {
+        QSet<uint64_t> added;
+        for (cpu_profile_stack_t &rec : stacks) {
+            for (uint32_t i = 0; i < rec.kernel_depth; ++i) {
+                // return addresses of the callers may be past the end of their call
+                const kernel_symbol_t *sym = findKernelSymbol(kernelSymbols, i ? rec.ips[i] - 1 : rec.ips[i]);
+                if (!sym)
+                    continue;
+                rec.ips[i] = sym->addr;
+                if (added.contains(sym->addr) || symbols.size() >= CPU_PROFILE_MAX_SYMBOLS)
+                    continue;
+                added.insert(sym->addr);
+                cpu_profile_symbol_t symbol;
+                memset(&symbol, 0, sizeof(symbol));
+                symbol.addr = sym->addr;
+                // "name\t[module]" becomes "name [module]"
+                const size_t len = std::min(sym->len, sizeof(symbol.name) - 1);
+                memcpy(symbol.name, sym->name, len);
+                for (size_t c = 0; c < len; ++c) {
+                    if (symbol.name[c] == '\t')
+                        symbol.name[c] = ' ';
+                }
+                symbols.push_back(symbol);
+            }
+        }
+        std::sort(symbols.begin(), symbols.end(), [](const cpu_profile_symbol_t &a, const cpu_profile_symbol_t &b) {
+            return a.addr < b.addr;
+        });
+    }
+
+    // libraries loaded meanwhile are only in the maps read now
+    mappings.clear();
+    if (!readMappings(m_pid, mappings))
+        mappings = m_mappings;
+}
+
+bool CpuProfiler::readMappings(int pid, std::vector<cpu_profile_mapping_t> &mappings)
+{
+    QFile file(QString("/proc/%1/maps").arg(pid));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    // "7f2c1a400000-7f2c1a5a2000 r-xp 00028000 fd:01 1835039 /usr/lib/x86_64-linux-gnu/libc.so.6"
+    const QList<QByteArray> lines = file.readAll().split('\n');
+    std::vector<cpu_profile_mapping_t> result;
+    for (const QByteArray &line : lines) {
+        unsigned long long start, end, offset;
+        char perms[5];
+        int pathPos = 0;
+        if (sscanf(line.constData(), "%llx-%llx %4s %llx %*s %*s %n", &start, &end, perms, &offset, &pathPos) < 4
+                || !pathPos || perms[2] != 'x' || line.size() <= pathPos || line.at(pathPos) != '/')
+            continue;
+        if (result.size() >= CPU_PROFILE_MAX_MAPPINGS)
+            break;
+        cpu_profile_mapping_t mapping;
+        memset(&mapping, 0, sizeof(mapping));
+        mapping.start = start;
+        mapping.end = end;
+        mapping.offset = offset;
+        const QByteArray path = line.mid(pathPos).trimmed();
+        memcpy(mapping.path, path.constData(), std::min(size_t(path.size()), sizeof(mapping.path) - 1));
+        result.push_back(mapping);
+    }
+    mappings.swap(result);
+    return true;
+}
@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CPU_PROFILER_H
+#define CPU_PROFILER_H
+
+#include "process_info_record.h"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+
+#include <vector>
+
+/**
+ * @brief Call chains of a process sampled on cpu, counted per chain
+ *
+ * A cpu-clock perf event is opened on each thread of the process, so nothing else of the system
+ * is sampled & the threads are only sampled while they run. Threads started meanwhile are found
+ * by rescanning /proc/[pid]/task about once a second. Samples are drained from the ring buffer
+ * of each event by poll(), the kernel keeps the user & kernel frames of a sample together.
+ */
+class CpuProfiler
+{
+public:
+    CpuProfiler() = default;
+    ~CpuProfiler();
+
+    /**
+     * @brief Open a sampling event on each thread of \a pid, counts start from zero
+     * @param frequency Samples per second of each thread
+     * @return false if the process is gone or perf events are not available
+     */
+    bool open(int pid, int frequency);
+    void close();
+
+    /**
+     * @brief Wait up to \a timeout ms for samples & count them
+     * @return false once every thread exited
+     */
+    bool poll(int timeout);
+
+    inline quint64 samples() const { return m_samples; }
+    inline quint64 lost() const { return m_lost; }
+    // threads sampled since open, including the exited ones
+    inline int threads() const { return m_sampledThreads; }
+
+    /**
+     * @brief Stacks most sampled first, kernel frames resolved from kallsyms
+     * @param mappings Executable mappings of the process, as read at open if it's gone by now
+     */
+    void profile(std::vector<cpu_profile_stack_t> &stacks, std::vector<cpu_profile_symbol_t> &symbols,
+                 std::vector<cpu_profile_mapping_t> &mappings);
+
+    /**
+     * @brief Executable mappings of files in /proc/[pid]/maps, at most CPU_PROFILE_MAX_MAPPINGS
+     */
+    static bool readMappings(int pid, std::vector<cpu_profile_mapping_t> &mappings);
+
+    // threads sampled at once, a ring buffer each
+    static constexpr int kMaxThreads = 256;
+
+private:
+    CpuProfiler(const CpuProfiler &) = delete;
+    CpuProfiler &operator=(const CpuProfiler &) = delete;
+
+    struct thread_t {
+        int fd;
+        void *ring;
+    };
+
+    bool openThread(int tid);
+    void closeThread(thread_t &thread);
+    void rescanThreads();
+    void drain(thread_t &thread);
+    void countSample(const uint64_t *ips, uint64_t nr);
+
+    int m_pid {-1};
+    int m_frequency {0};
+    size_t m_pageSize {0};
+    QHash<int, thread_t> m_threads;
+    // samples by call chain, the kernel depth followed by the ips, 64 bits each
+    QHash<QByteArray, quint64> m_stacks;
+    std::vector<cpu_profile_mapping_t> m_mappings;
+    quint64 m_samples {0};
+    quint64 m_lost {0};
+    int m_sampledThreads {0};
+    QElapsedTimer m_rescan;
+    // a record wrapping around the end of a ring
+    std::vector<char> m_record;
+};
+
+#endif // CPU_PROFILER_H
@@ -0,0 +1,434 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "disk_health_sampler.h"
+#include "ddlog.h"
+
+#include <QDir>
+#include <QFile>
+#include <QMutexLocker>
+#include <QThread>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#include <linux/nvme_ioctl.h>
+#include <scsi/sg.h>
+
+using namespace DDLog;
+
+namespace {
+
+const int kSectorSize = 512;
+
+// virtual & removable devices have no SMART worth asking for
+const char *const kSkippedPrefixes[] = {"loop", "ram", "zram", "dm-", "md", "sr", "fd", "nbd"};
+
+// NVMe admin Get Log Page of the SMART / health log, for all namespaces
+const uint8_t kNvmeGetLogPage = 0x02;
+const uint32_t kNvmeSmartLog = 0x02;
+const uint32_t kNvmeAllNamespaces = 0xffffffff;
+
+// ATA commands, sent through SCSI ATA PASS-THROUGH (16)
+const uint8_t kAtaPassThrough16 = 0x85;
+const uint8_t kAtaCheckPowerMode = 0xe5;
+const uint8_t kAtaSmart = 0xb0;
+const uint8_t kAtaSmartReadData = 0xd0;
+const uint8_t kAtaSmartReadThresholds = 0xd1;
+// CHECK POWER MODE count of a drive in standby, its platters are stopped
+const uint8_t kAtaStandby = 0x00;
+
+// ATA SMART attributes
+const uint8_t kAttrReallocated = 5;
+const uint8_t kAttrPowerOnHours = 9;
+const uint8_t kAttrAirflowTemperature = 190;
+const uint8_t kAttrPowerOffRetract = 192;
+const uint8_t kAttrTemperature = 194;
+const uint8_t kAttrPending = 197;
+const uint8_t kAttrUncorrectable = 198;
+const int kAttrCount = 30;
+const int kAttrSize = 12;
+
+// NVMe critical warning bits of reliability degraded, read only & volatile backup failed
+const uint32_t kNvmeFailingWarnings = 0x1c;
+
+uint64_t readLe(const uint8_t *p, int bytes)
+{
+    uint64_t value = 0;
+    for (int i = bytes - 1; i >= 0; --i)
+        value = (value << 8) | p[i];
+    return value;
+}
+
+uint64_t monotonicNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ULL + uint64_t(ts.tv_nsec);
+}
+
+bool isSkipped(const QString &name)
+{
+    for (const char *prefix : kSkippedPrefixes) {
+        if (name.startsWith(QLatin1String(prefix)))
+            return true;
+    }
+    // no device behind it, or media that comes & goes
+    if (!QFile::exists(QString("/sys/block/%1/device").arg(name)))
+        return true;
+    QFile removable(QString("/sys/block/%1/removable").arg(name));
+    return removable.open(QIODevice::ReadOnly) && removable.readAll().trimmed() == "1";
+}
+
+/**
+ * @brief Whether runtime PM put the disk or its controller to sleep, opening it would resume it
+ */
+bool isRuntimeSuspended(const QString &name)
+{
+    for (const char *path : {"device/power/runtime_status", "device/device/power/runtime_status"}) {
+        QFile status(QString("/sys/block/%1/%2").arg(name).arg(path));
+        if (status.open(QIODevice::ReadOnly) && status.readAll().trimmed() == "suspended")
+            return true;
+    }
+    return false;
+}
+
+bool nvmeSmartLog(int fd, uint8_t *log)
+{
+    struct nvme_admin_cmd cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.opcode = kNvmeGetLogPage;
+    cmd.nsid = kNvmeAllNamespaces;
+    cmd.addr = uint64_t(uintptr_t(log));
+    cmd.data_len = kSectorSize;
+    // dwords to read - 1 in the upper half
+    cmd.cdw10 = kNvmeSmartLog | ((kSectorSize / 4 - 1) << 16);
+    cmd.timeout_ms = DiskHealthSampler::kCommandTimeout;
+    return ioctl(fd, NVME_IOCTL_ADMIN_CMD, &cmd) == 0;
+}
+
+/**
+ * @brief Send an ATA command through SG_IO
+ * @param data 512 bytes read in, non-data command if null
+ * @param count Count register returned by the drive, non-data commands only
+ */
+bool ataCommand(int fd, uint8_t command, uint8_t feature, uint8_t *data, uint8_t *count)
+{
+    uint8_t cdb[16] = {};
+    uint8_t sense[32] = {};
+    cdb[0] = kAtaPassThrough16;
+    if (data) {
+        // PIO data-in, length in sectors from the count field
+        cdb[1] = 4 << 1;
+        cdb[2] = 0x0e;
+        cdb[6] = 1;
+    } else {
+        // non-data, CK_COND returns the registers in the sense data
+        cdb[1] = 3 << 1;
+        cdb[2] = 0x20;
+    }
+    cdb[4] = feature;
+    if (command == kAtaSmart) {
+        cdb[10] = 0x4f;
+        cdb[12] = 0xc2;
+    }
+    cdb[14] = command;
+
+    sg_io_hdr_t io;
+    memset(&io, 0, sizeof(io));
+    io.interface_id = 'S';
+    io.cmd_len = sizeof(cdb);
+    io.cmdp = cdb;
+    io.mx_sb_len = sizeof(sense);
+    io.sbp = sense;
+    io.dxfer_direction = data ? SG_DXFER_FROM_DEV : SG_DXFER_NONE;
+    io.dxferp = data;
+    io.dxfer_len = data ? kSectorSize : 0;
+    io.timeout = DiskHealthSampler::kCommandTimeout;
+    if (ioctl(fd, SG_IO, &io) < 0 || io.host_status || (io.driver_status & ~0x08))
+        return false;
+    if (data)
+        return io.status == 0;
+
+    // ATA status return, descriptor or fixed format, error bit set when the command was aborted
+    uint8_t status = 0;
+    if ((sense[0] & 0x7f) == 0x72 && sense[8] == 0x09) {
+        status = sense[8 + 13];
+        *count = sense[8 + 5];
+    } else if ((sense[0] & 0x7f) == 0x70) {
+        status = sense[4];
+        *count = sense[6];
+    } else {
+        return false;
+    }
+    return !(status & 0x01);
+}
+
+} // namespace
+
+DiskHealthSampler::~DiskHealthSampler()
+{
+    QThread *thread = nullptr;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stop = true;
+        thread = m_thread;
+        m_wake.wakeAll();
+    }
+    // commands time out on their own, the worker is gone within kCommandTimeout
+    if (thread)
+        thread->wait();
+}
+
+void DiskHealthSampler::start()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stop = false;
+    // a stopped worker that hasn't exited yet goes on
+    if (m_thread)
+        return;
+
+    m_thread = QThread::create([this]() { run(); });
+    QObject::connect(m_thread, &QThread::finished, m_thread, &QObject::deleteLater);
+    m_thread->start(QThread::LowPriority);
+    qCInfo(app) << "Disk health sampling started";
+}
+
+void DiskHealthSampler::stop()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stop = true;
+    m_wake.wakeAll();
+}
+
+bool DiskHealthSampler::isRunning() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_thread && !m_stop;
+}
+
+QByteArray DiskHealthSampler::snapshot() const
+{
+    QMutexLocker locker(&m_mutex);
+    disk_health_header_t hdr {};
+    hdr.magic = DISK_HEALTH_MAGIC;
+    hdr.version = DISK_HEALTH_VERSION;
+    hdr.record_size = sizeof(disk_health_record_t);
+    hdr.count = uint32_t(m_records.size());
+    hdr.interval = DISK_HEALTH_INTERVAL;
+    hdr.timestamp = monotonicNs();
+
+    QByteArray result(int(sizeof(hdr) + size_t(m_records.size()) * sizeof(disk_health_record_t)), Qt::Uninitialized);
+    memcpy(result.data(), &hdr, sizeof(hdr));
+    char *out = result.data() + sizeof(hdr);
+    for (const disk_health_record_t &rec : m_records) {
+        memcpy(out, &rec, sizeof(rec));
+        out += sizeof(rec);
+    }
+    return result;
+}
+
+void DiskHealthSampler::run()
+{
+    for (;;) {
+        sampleAll();
+
+        QMutexLocker locker(&m_mutex);
+        if (!m_stop)
+            m_wake.wait(&m_mutex, DISK_HEALTH_INTERVAL);
+        // decided under the lock start() takes, so a restart either sees the worker or none
+        if (m_stop) {
+            m_thread = nullptr;
+            qCInfo(app) << "Disk health sampling stopped";
+            return;
+        }
+    }
+}
+
+void DiskHealthSampler::sampleAll()
+{
+    const QStringList names = QDir("/sys/block").entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::System);
+    QMap<QString, disk_health_record_t> records;
+    {
+        QMutexLocker locker(&m_mutex);
+        records = m_records;
+    }
+
+    QMap<QString, disk_health_record_t> sampled;
+    for (const QString &name : names) {
+        const QByteArray local = name.toLocal8Bit();
+        if (isSkipped(name) || local.size() >= DISK_HEALTH_NAME_LEN)
+            continue;
+
+        disk_health_record_t rec {};
+        auto it = records.constFind(name);
+        if (it != records.constEnd()) {
+            rec = *it;
+        } else {
+            memcpy(rec.name, local.constData(), size_t(local.size()));
+            rec.kind = name.startsWith("nvme") ? DISK_HEALTH_NVME : DISK_HEALTH_ATA;
+            rec.state = DISK_HEALTH_PENDING;
+            rec.temperature = DISK_HEALTH_NO_TEMPERATURE;
+        }
+        sampleDisk(name, rec);
+        sampled.insert(name, rec);
+
+        QMutexLocker locker(&m_mutex);
+        if (m_stop)
+            break;
+    }
+
+    // disks gone since are dropped
+    QMutexLocker locker(&m_mutex);
+    m_records = sampled;
+}
+
+void DiskHealthSampler::sampleDisk(const QString &name, disk_health_record_t &rec) const
+{
+    // asked once, not again until the disk reappears
+    if (rec.state == DISK_HEALTH_UNSUPPORTED)
+        return;
+    if (isRuntimeSuspended(name)) {
+        rec.state = DISK_HEALTH_SLEEPING;
+        return;
+    }
+
+    const int fd = open(QString("/dev/%1").arg(name).toLocal8Bit().constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        qCDebug(app) << "Disk health: failed to open" << name << strerror(errno);
+        rec.state = DISK_HEALTH_ERROR;
+        return;
+    }
+
+    uint8_t data[kSectorSize] = {};
+    if (rec.kind == DISK_HEALTH_NVME) {
+        if (nvmeSmartLog(fd, data)) {
+            parseNvmeLog(data, rec);
+            rec.sampled_at = monotonicNs();
+        } else {
+            const int err = errno;
+            rec.state = (err == ENOTTY || err == EINVAL) ? DISK_HEALTH_UNSUPPORTED : DISK_HEALTH_ERROR;
+            qCDebug(app) << "Disk health: no NVMe log of" << name << strerror(err);
+        }
+        close(fd);
+        return;
+    }
+
+    // asking the power mode doesn't spin the disk up, reading SMART would
+    uint8_t mode = 0;
+    if (!ataCommand(fd, kAtaCheckPowerMode, 0, nullptr, &mode)) {
+        qCDebug(app) << "Disk health: no ATA pass-through to" << name;
+        rec.state = DISK_HEALTH_UNSUPPORTED;
+    } else if (mode == kAtaStandby) {
+        rec.state = DISK_HEALTH_SLEEPING;
+    } else {
+        uint8_t thresholds[kSectorSize] = {};
+        if (ataCommand(fd, kAtaSmart, kAtaSmartReadData, data, nullptr)
+                && ataCommand(fd, kAtaSmart, kAtaSmartReadThresholds, thresholds, nullptr)) {
+            parseAtaSmart(data, thresholds, rec);
+            rec.sampled_at = monotonicNs();
+        } else {
+            qCDebug(app) << "Disk health: SMART read of" << name << "failed";
+            rec.state = DISK_HEALTH_ERROR;
+        }
+    }
+    close(fd);
+}
+
+void DiskHealthSampler::parseNvmeLog(const uint8_t *log, disk_health_record_t &rec)
+{
+    rec.critical_warning = log[0];
+    const int kelvin = int(readLe(log + 1, 2));
+    rec.temperature = kelvin > 0 ? kelvin - 273 : DISK_HEALTH_NO_TEMPERATURE;
+    rec.available_spare = log[3];
+    rec.percent_used = log[5];
+    // 128 bit counters, the upper half is never reached
+    rec.power_on_hours = readLe(log + 128, 8);
+    rec.unsafe_shutdowns = readLe(log + 144, 8);
+    rec.media_errors = readLe(log + 160, 8);
+    rec.warning_temp_minutes = uint32_t(readLe(log + 192, 4));
+    rec.critical_temp_minutes = uint32_t(readLe(log + 196, 4));
+
+    if (rec.critical_warning & kNvmeFailingWarnings)
+        rec.state = DISK_HEALTH_FAILING;
+    else if (rec.critical_warning || rec.media_errors || rec.percent_used >= 100)
+        rec.state = DISK_HEALTH_WARNING;
+    else
+        rec.state = DISK_HEALTH_OK;
+}
+
+void DiskHealthSampler::parseAtaSmart(const uint8_t *data, const uint8_t *thresholds, disk_health_record_t &rec)
+{
+    rec.temperature = DISK_HEALTH_NO_TEMPERATURE;
+    rec.critical_warning = 0;
+    rec.percent_used = DISK_HEALTH_UNKNOWN;
+    rec.available_spare = DISK_HEALTH_UNKNOWN;
+    rec.warning_temp_minutes = DISK_HEALTH_UNKNOWN;
+    rec.critical_temp_minutes = DISK_HEALTH_UNKNOWN;
+    rec.power_on_hours = 0;
+    rec.media_errors = 0;
+    rec.unsafe_shutdowns = 0;
+
+    int airflow = DISK_HEALTH_NO_TEMPERATURE;
+    for (int i = 0; i < kAttrCount; ++i) {
+        const uint8_t *attr = data + 2 + i * kAttrSize;
+        const uint8_t id = attr[0];
+        if (!id)
+            continue;
+        const uint16_t flags = uint16_t(readLe(attr + 1, 2));
+        const uint8_t value = attr[3];
+        const uint64_t raw = readLe(attr + 5, 6);
+
+        // thresholds are usually in the same slot, vendors may order them otherwise
+        uint8_t threshold = 0;
+        for (int j = 0; j < kAttrCount; ++j) {
+            const uint8_t *entry = thresholds + 2 + ((i + j) % kAttrCount) * kAttrSize;
+            if (entry[0] == id) {
+                threshold = entry[1];
+                break;
+            }
+        }
+        // prefail attribute at or below its threshold, the drive predicts its own failure
+        if ((flags & 0x1) && threshold && value <= threshold && !rec.critical_warning)
+            rec.critical_warning = id;
+
+        // raw values pack vendor fields above the low bytes
+        switch (id) {
+        case kAttrTemperature:
+            rec.temperature = int(raw & 0xff);
+            break;
+        case kAttrAirflowTemperature:
+            airflow = int(raw & 0xff);
+            break;
+        case kAttrPowerOnHours:
+            rec.power_on_hours = raw & 0xffffffff;
+            break;
+        case kAttrPowerOffRetract:
+            rec.unsafe_shutdowns = raw & 0xffffffff;
+            break;
+        case kAttrReallocated:
+        case kAttrPending:
+        case kAttrUncorrectable:
+            rec.media_errors += raw & 0xffffffff;
+            break;
+        default:
+            break;
+        }
+    }
+    if (rec.temperature == DISK_HEALTH_NO_TEMPERATURE)
+        rec.temperature = airflow;
+    if (rec.temperature != DISK_HEALTH_NO_TEMPERATURE && (rec.temperature <= 0 || rec.temperature >= 150))
+        rec.temperature = DISK_HEALTH_NO_TEMPERATURE;
+
+    if (rec.critical_warning)
+        rec.state = DISK_HEALTH_FAILING;
+    else if (rec.media_errors)
+        rec.state = DISK_HEALTH_WARNING;
+    else
+        rec.state = DISK_HEALTH_OK;
+}
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DISK_HEALTH_SAMPLER_H
+#define DISK_HEALTH_SAMPLER_H
+
+#include "process_info_record.h"
+
+#include <QByteArray>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+
+class QThread;
+
+/**
+ * @brief SMART & NVMe health of every disk, read on a worker thread every DISK_HEALTH_INTERVAL
+ *
+ * NVMe disks are read with a Get Log Page admin command, ATA disks with SMART READ DATA &
+ * THRESHOLDS through SCSI ATA pass-through, every command with a timeout. Disks in standby or
+ * runtime suspended are skipped & keep their last values, checking so doesn't spin them up.
+ * snapshot() only copies the cached records, callers never wait for a disk.
+ */
+class DiskHealthSampler
+{
+public:
+    DiskHealthSampler() = default;
+    ~DiskHealthSampler();
+
+    /**
+     * @brief Start the worker, disks are read right away then every interval
+     */
+    void start();
+    /**
+     * @brief Ask the worker to stop, doesn't wait for a read in progress
+     */
+    void stop();
+    bool isRunning() const;
+
+    /**
+     * @brief Records of all disks seen, format see process_info_record.h
+     */
+    QByteArray snapshot() const;
+
+    /**
+     * @brief Fill rec from an NVMe SMART / health log page, 512 bytes
+     */
+    static void parseNvmeLog(const uint8_t *log, disk_health_record_t &rec);
+    /**
+     * @brief Fill rec from ATA SMART READ DATA & READ THRESHOLDS sectors, 512 bytes each
+     */
+    static void parseAtaSmart(const uint8_t *data, const uint8_t *thresholds, disk_health_record_t &rec);
+
+    // ms a command may take before the disk counts as failing to answer
+    static constexpr int kCommandTimeout = 3000;
+
+private:
+    DiskHealthSampler(const DiskHealthSampler &) = delete;
+    DiskHealthSampler &operator=(const DiskHealthSampler &) = delete;
+
+    void run();
+    void sampleAll();
+    void sampleDisk(const QString &name, disk_health_record_t &rec) const;
+
+    mutable QMutex m_mutex; // guards the members below, never held during a command
+    QWaitCondition m_wake;
+    QThread *m_thread {nullptr};
+    bool m_stop {false};
+    QMap<QString, disk_health_record_t> m_records;
+};
+
+#endif // DISK_HEALTH_SAMPLER_H
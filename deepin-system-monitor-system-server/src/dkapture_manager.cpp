@@ -118,6 +118,36 @@ ssize_t DKaptureManager::read(std::vector<DKapture::DataType> &dts, DKapture::DK
     return m_dk_instance->read(dts, cb, ctx);
 }
 
+ssize_t DKaptureManager::read(DKapture::DataType dt, std::vector<pid_t> &pids, DKapture::DataHdr *buf, size_t bsz)
+{
+    if (!isAvailable()) return -1;
+    return m_dk_instance->read(dt, pids, buf, bsz);
+}
+
+int DKaptureManager::fileWatch(const char *path, DKapture::DKCallback cb, void *ctx)
+{
+    if (!isAvailable()) return -1;
+    return m_dk_instance->file_watch(path, cb, ctx);
+}
+
+int DKaptureManager::irqWatch(DKapture::DKCallback cb, void *ctx)
+{
+    if (!isAvailable()) return -1;
+    return m_dk_instance->irq_watch(cb, ctx);
+}
+
+int DKaptureManager::kmemleakScanStart(pid_t pid, DKapture::DKCallback cb, void *ctx)
+{
+    if (!isAvailable()) return -1;
+    return m_dk_instance->kmemleak_scan_start(pid, cb, ctx);
+}
+
+int DKaptureManager::kmemleakScanStop()
+{
+    if (!isAvailable()) return -1;
+    return m_dk_instance->kmemleak_scan_stop();
+}
+
 int DKaptureManager::close()
 {
     if (!m_dk_instance) return -1;
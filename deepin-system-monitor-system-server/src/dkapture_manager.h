@@ -29,6 +29,11 @@ public:
     int open(FILE *fp = stdout, DKapture::LogLevel lvl = DKapture::DEBUG);
     unsigned long long lifetime(unsigned long long ms);
     ssize_t read(std::vector<DKapture::DataType> &dts, DKapture::DKCallback cb, void *ctx);
+    ssize_t read(DKapture::DataType dt, std::vector<pid_t> &pids, DKapture::DataHdr *buf, size_t bsz);
+    int fileWatch(const char *path, DKapture::DKCallback cb, void *ctx);
+    int irqWatch(DKapture::DKCallback cb, void *ctx);
+    int kmemleakScanStart(pid_t pid, DKapture::DKCallback cb, void *ctx);
+    int kmemleakScanStop();
     int close();
 
 private:
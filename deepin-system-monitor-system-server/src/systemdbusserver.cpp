@@ -1,560 +1,2893 @@
-// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
-//
-// SPDX-License-Identifier: GPL-3.0-or-later
-
-#include "systemdbusserver.h"
-#include "ddlog.h"
-
-#ifdef ENABLE_DKAPTURE
-#include "dkapture_manager.h"
-#include <QSet>
-#endif
-
-#include <QCoreApplication>
-#include <QDBusMessage>
-#include <QDBusConnection>
-#include <QDBusConnectionInterface>
-#include <QStandardPaths>
-#include <QProcess>
-#include <QTimer>
-#include <QFile>
-
-#include <sys/sysinfo.h>
-#include <unistd.h>
-#include <QStringList>
-#include <QDebug>
-#include <QRegularExpression>
-#include <unistd.h>
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-#include <polkit-qt5-1/PolkitQt1/Authority>
-#include <polkit-qt5-1/PolkitQt1/Subject>
-#else
-#include <polkit-qt6-1/PolkitQt1/Authority>
-#include <polkit-qt6-1/PolkitQt1/Subject>
-#endif
-
-using namespace DDLog;
-
-const QString s_PolkitActionSet = "org.deepin.systemmonitor.systemserver.set";
-
-/**
-   @brief polkit 鉴权，通过配置文件处理
- */
-bool checkAuthorization(const QString &appBusName, const QString &action)
-{
-    PolkitQt1::Authority::Result ret = PolkitQt1::Authority::instance()->checkAuthorizationSync(
-            action, PolkitQt1::SystemBusNameSubject(appBusName), PolkitQt1::Authority::AllowUserInteraction);
-    if (PolkitQt1::Authority::Yes == ret) {
-        qCDebug(app) << "Authorization check passed";
-        return true;
-    } else {
-        qCWarning(app) << "Policy authorization check failed for bus:" << appBusName;
-        return false;
-    }
-}
-
-/**
-   @return 返回PID对应的可执行程序名称
- */
-static QString getProcIdExe(qint64 id)
-{
-    qCDebug(app) << "Getting executable for PID:" << id;
-    QString execName;
-    if (id > 0) {
-        // Read contents of virtual /proc/{pid}/cmdline file
-        QString exeSymlinkPath = QString("/proc/%1/exe").arg(id);
-        char *actualpath = realpath(exeSymlinkPath.toStdString().c_str(), nullptr);
-        execName = QString(actualpath);
-        free(actualpath); // free the memory allocated by realpath
-    }
-    qCDebug(app) << "Executable for PID" << id << "is:" << execName;
-    return execName;
-}
-
-SystemDBusServer::SystemDBusServer(QObject *parent)
-    : QObject(parent)
-#ifdef ENABLE_DKAPTURE
-    , m_dkaptureManager(nullptr)
-    , m_dkaptureInitialized(false)
-#endif
-{
-    qCDebug(app) << "SystemDBusServer created";
-    
-    // 初始化 DKapture
-    initializeDKapture();
-    // name: 配置文件中的服务名称 org.deepin.SystemMonitorSystemServer
-    QDBusConnection dbus = QDBusConnection::systemBus();
-    if (dbus.registerService("org.deepin.SystemMonitorSystemServer")) {
-        qCDebug(app) << "Successfully registered service org.deepin.SystemMonitorSystemServer";
-        QDBusConnection::RegisterOptions opts =
-                QDBusConnection::ExportAllSlots | QDBusConnection::ExportAllSignals | QDBusConnection::ExportAllProperties;
-        if (!dbus.registerObject("/org/deepin/SystemMonitorSystemServer", this, opts)) {
-            qCWarning(app) << "Failed to register DBus object:" << dbus.lastError().message();
-        }
-    } else {
-        qCWarning(app) << "Failed to register DBus service:" << dbus.lastError().message();
-    }
-    m_timer.setSingleShot(true);
-    connect(&m_timer, &QTimer::timeout, this, [=]() { 
-        qCDebug(app) << "Timer timeout, exiting application";
-        qApp->exit(0); 
-    });
-}
-
-/**
-   @brief 延时退出执行服务
- */
-void SystemDBusServer::exitDBusServer(int msec)
-{
-    qCDebug(app) << "Scheduling exit in" << msec << "ms";
-    qApp->processEvents();
-    m_timer.start(msec);
-}
-
-/**
-   @brief 重置退出定时器（当有新的D-Bus调用时）
- */
-void SystemDBusServer::resetExitTimer()
-{
-    static const int EXIT_TIMEOUT = 5000; // 5秒无活动后退出
-    qCDebug(app) << "Resetting exit timer to" << EXIT_TIMEOUT << "ms";
-    m_timer.start(EXIT_TIMEOUT);
-}
-
-/**
-   @brief 设置 systemctl 服务 \a serviceName 的启动方式为 \b enable ，仅用于非开发者模式
- */
-QString SystemDBusServer::setServiceEnable(const QString &serviceName, bool enable)
-{
-    qCDebug(app) << "setServiceEnable called for service:" << serviceName << "enable:" << enable;
-
-    // 重置退出定时器
-    resetExitTimer();
-
-    QString ret = setServiceEnableImpl(serviceName, enable);
-    return ret;
-}
-
-/**
-   @brief 执行设置 systemctl 服务 \a serviceName 启动方式 \a enable ，将返回详细处理结果
- */
-QString SystemDBusServer::setServiceEnableImpl(const QString &serviceName, bool enable)
-{
-    qCDebug(app) << "setServiceEnableImpl called for service:" << serviceName << "enable:" << enable;
-    // 调用者限制前台系统监视器程序
-    if (!checkCaller()) {
-        qCWarning(app) << "Unauthorized caller attempt to modify service:" << serviceName;
-        return QString(strerror(EPERM));
-    }
-
-    // 不允许包含';' ' '字符，服务名称长度同样限制
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    if (serviceName.isEmpty() || (serviceName.size() > SHRT_MAX) || serviceName.contains(QRegExp("[; ]"))) {
-#else
-    if (serviceName.isEmpty() || (serviceName.size() > SHRT_MAX) || serviceName.contains(QRegularExpression("[; ]"))) {
-#endif
-        qCWarning(app) << "Invalid service name:" << serviceName;
-        return QString(strerror(EINVAL));
-    }
-
-    // 判断服务是否存在
-    QProcess listPorcess;
-    listPorcess.start("systemctl", { "list-unit-files", "--type=service", "--no-pager" });
-    listPorcess.waitForFinished();
-    QByteArray serviceList = listPorcess.readAll();
-    qCDebug(app) << "Checking for service existence...";
-    if (!serviceList.contains(serviceName.toUtf8())) {
-        qCWarning(app) << "Service does not exist:" << serviceName;
-        return QString(strerror(EINVAL));
-    }
-    qCDebug(app) << "Service" << serviceName << "exists.";
-
-    // 鉴权处理
-    if (!checkAuthorization(message().service(), s_PolkitActionSet)) {
-        qCWarning(app) << "Polkit authorization failed for service:" << serviceName;
-        return QString(strerror(EPERM));
-    }
-
-    // 执行设置
-    QProcess process;
-    qCDebug(app) << "Executing 'systemctl" << (enable ? "enable" : "disable") << serviceName << "'";
-    process.start("systemctl", { enable ? "enable" : "disable", serviceName });
-    process.waitForFinished();
-    QString errorRet = process.readAll();
-
-    // 检测是否执行成功
-    qCDebug(app) << "Checking service status after operation...";
-    process.start("systemctl", { "is-enabled", serviceName });
-    process.waitForFinished();
-    QString checkRet = process.readAll();
-    if (enable && ("enabled" == checkRet)) {
-        qCDebug(app) << "Service successfully enabled:" << serviceName;
-        return {};
-    } else if (!enable && ("disabled" == checkRet)) {
-        qCDebug(app) << "Service successfully disabled:" << serviceName;
-        return {};
-    }
-
-    // 返回命令执行结果
-    qCWarning(app) << "Service state change failed:" << errorRet;
-    return errorRet;
-}
-
-/**
-   @return DBus 调用者的PID
- */
-qint64 SystemDBusServer::dbusCallerPid() const
-{
-    if (!calledFromDBus()) {
-        qCDebug(app) << "Not called from DBus";
-        return 0;
-    }
-
-    auto interface = connection().interface();
-    if (interface) {
-        return static_cast<qint64>(interface->servicePid(message().service()).value());
-    }
-
-    qCDebug(app) << "Failed to get DBus caller PID";
-    return 0;
-}
-
-/**
-   @return 返回调用者是否为前台的系统监视器程序
- */
-bool SystemDBusServer::checkCaller() const
-{
-    if (!calledFromDBus()) {
-        qCDebug(app) << "Not called from DBus";
-        return false;
-    }
-
-    qint64 callerPid = dbusCallerPid();
-    QString callerExe = getProcIdExe(callerPid);
-    QString dbmExe = QStandardPaths::findExecutable("deepin-system-monitor", { "/usr/bin" });
-
-    qCDebug(app) << "Checking caller authorization - PID:" << callerPid << "Executable:" << callerExe;
-    if (callerExe != dbmExe) {
-        qCWarning(app) << "Unauthorized caller:" << callerExe;
-        return false;
-    }
-
-    qCDebug(app) << "Caller authorized:" << callerExe;
-    return true;
-}
-
-// ================== DKapture 相关实现 ==================
-
-void SystemDBusServer::initializeDKapture()
-{
-#ifdef ENABLE_DKAPTURE
-    qCInfo(app) << "SystemServer: Initializing DKapture...";
-    
-    m_dkaptureManager = DKaptureManager::instance();
-    if (m_dkaptureManager && m_dkaptureManager->isAvailable()) {
-        m_dkaptureInitialized = true;
-        qCInfo(app) << "SystemServer: DKapture initialized successfully";
-    } else {
-        qCWarning(app) << "SystemServer: DKapture initialization failed";
-        m_dkaptureInitialized = false;
-    }
-#else
-    qCDebug(app) << "SystemServer: DKapture support not compiled";
-#endif
-}
-
-void SystemDBusServer::cleanupDKapture()
-{
-#ifdef ENABLE_DKAPTURE
-    if (m_dkaptureManager) {
-        delete m_dkaptureManager;
-        m_dkaptureManager = nullptr;
-    }
-    m_dkaptureInitialized = false;
-    qCDebug(app) << "SystemServer: DKapture cleaned up";
-#endif
-}
-
-bool SystemDBusServer::isDKaptureAvailable()
-{
-    qCDebug(app) << "SystemServer: isDKaptureAvailable called";
-
-    // 重置退出定时器
-    resetExitTimer();
-    
-    // 检查调用者授权
-    if (!checkCaller()) {
-        qCWarning(app) << "SystemServer: Unauthorized caller for isDKaptureAvailable";
-        return false;
-    }
-
-#ifdef ENABLE_DKAPTURE
-    bool available = m_dkaptureInitialized && m_dkaptureManager && m_dkaptureManager->isAvailable();
-    qCDebug(app) << "SystemServer: DKapture availability:" << available;
-    return available;
-#else
-    qCDebug(app) << "SystemServer: DKapture not compiled, returning false";
-    return false;
-#endif
-}
-
-QVariantMap SystemDBusServer::getProcessInfoBatch(const QList<int> &pids)
-{
-    qCDebug(app) << "SystemServer: getProcessInfoBatch called for" << pids.size() << "PIDs";
-
-    // 重置退出定时器
-    resetExitTimer();
-    
-    QVariantMap result;
-    result["success"] = false;
-    result["error"] = "Unknown error";
-    
-    // 检查调用者授权
-    if (!checkCaller()) {
-        qCWarning(app) << "SystemServer: Unauthorized caller for getProcessInfoBatch";
-        result["error"] = "Unauthorized";
-        return result;
-    }
-
-#ifdef ENABLE_DKAPTURE
-    if (!isDKaptureAvailable()) {
-        result["error"] = "DKapture not available";
-        return result;
-    }
-
-    try {
-        QVariantMap processData;
-        
-        // 使用 DKapture 获取进程信息
-        if (m_dkaptureManager) {
-            // 准备要获取的数据类型 - 禁用网络数据监听，前端使用传统方式
-            std::vector<DKapture::DataType> dataTypes = {
-                DKapture::PROC_PID_STAT,    // 基本进程信息
-                DKapture::PROC_PID_IO,      // I/O 信息
-                DKapture::PROC_PID_STATM,   // 内存信息
-                DKapture::PROC_PID_STATUS,  // 进程状态信息（UID/GID等）
-                DKapture::PROC_PID_SCHEDSTAT // 调度统计信息（cpu_time, rq_wait_time, timeslices）
-                // DKapture::PROC_PID_traffic  // 网络流量信息 - 已禁用，前端使用传统方式
-            };
-            
-            // 创建一个结构体来传递上下文
-            struct DKaptureContext {
-                QSet<int> targetPids;
-                QVariantMap *processData;
-                SystemDBusServer *server;
-            } context;
-            
-            context.targetPids = QSet<int>(pids.begin(), pids.end());
-            context.processData = &processData;
-            context.server = this;
-            
-            // 设置回调函数来处理 DKapture 数据
-            auto callback = [](void *ctx, const void *data, size_t /*data_sz*/) -> int {
-                DKaptureContext *context = static_cast<DKaptureContext *>(ctx);
-                const DKapture::DataHdr *hdr = static_cast<const DKapture::DataHdr *>(data);
-                
-                // qCDebug(app) << "SystemServer: DKapture callback called for PID" << hdr->pid << "type" << hdr->type;
-                
-                // 检查是否为目标PID
-                bool isTargetPid = context->targetPids.contains(hdr->pid);
-                if (!isTargetPid) {
-                    // 对于子线程或子程序，记录基本信息但不立即打印详细数据
-                    // 详细数据将在处理完成后统一格式化输出
-                }
-                
-                QString pidKey = QString::number(hdr->pid);
-                QVariantMap pidData;
-                
-                // 如果已有此 PID 的数据，则获取它
-                if (context->processData->contains(pidKey)) {
-                    pidData = context->processData->value(pidKey).toMap();
-                } else {
-                    pidData["pid"] = hdr->pid;
-                    pidData["tgid"] = hdr->tgid;
-                    pidData["comm"] = QString::fromUtf8(hdr->comm, TASK_COMM_LEN);
-                }
-                
-
-                
-                // 根据数据类型解析数据
-                const char *payload = hdr->data;
-                switch (hdr->type) {
-                    case DKapture::PROC_PID_STAT: {
-                        // qCDebug(app) << "SystemServer: Processing STAT for PID" << hdr->pid << "existing keys:" << pidData.keys();
-                        const ProcPidStat *stat = reinterpret_cast<const ProcPidStat *>(payload);
-                        // qCDebug(app) << "SystemServer: STAT raw data - vsize:" << stat->vsize << "rss:" << stat->rss;
-    
-
-                        pidData["state"] = stat->state;
-                        pidData["ppid"] = stat->ppid;
-                        
-                        // CPU时间处理：不做增量计算，直接转换（除以10^7）
-                        static const qulonglong DK_CONVERSION_FACTOR = 10000000ULL; // 10^7
-                        
-                        qulonglong dk_utime = stat->utime / DK_CONVERSION_FACTOR;
-                        qulonglong dk_stime = stat->stime / DK_CONVERSION_FACTOR;
-                        qulonglong dk_cutime = stat->cutime / DK_CONVERSION_FACTOR;
-                        qulonglong dk_cstime = stat->cstime / DK_CONVERSION_FACTOR;
-
-                        // Convert back to jiffies for frontend compatibility
-                        // Frontend expects utime/stime in jiffies, not seconds
-                        long hz = sysconf(_SC_CLK_TCK);  // Get system HZ value
-                        qulonglong dk_utime_jiffies = dk_utime * hz;  // Convert seconds back to jiffies
-                        qulonglong dk_stime_jiffies = dk_stime * hz;
-                        qulonglong dk_cutime_jiffies = dk_cutime * hz;
-                        qulonglong dk_cstime_jiffies = dk_cstime * hz;
-                        
-                        // Check for abnormal CPU time values that could cause overflow
-                        // Use system uptime as a reasonable upper bound
-                        struct sysinfo si;
-                        if (sysinfo(&si) == 0) {
-                            qulonglong system_uptime_jiffies = si.uptime * hz;
-                            qulonglong total_cpu_jiffies = dk_utime_jiffies + dk_stime_jiffies;
-                            
-                            if (total_cpu_jiffies > system_uptime_jiffies * 2) { // Allow 2x system uptime as buffer
-                                qCWarning(app) << "SystemServer: Abnormally large DKapture CPU time for PID" << hdr->pid
-                                              << "- total CPU jiffies:" << total_cpu_jiffies 
-                                              << "system uptime jiffies:" << system_uptime_jiffies
-                                              << ". Data may be corrupted, setting to safe values.";
-                                
-                                // Set to very small values to prevent frontend calculation issues
-                                // This ensures CPU usage will be close to 0% rather than astronomical values
-                                dk_utime_jiffies = hz;  // 1 second worth of jiffies
-                                dk_stime_jiffies = hz;  // 1 second worth of jiffies  
-                                dk_cutime_jiffies = 0;
-                                dk_cstime_jiffies = 0;
-                            }
-                        }
-
-                        // Store in jiffies for frontend compatibility
-                        pidData["utime"] = dk_utime_jiffies;
-                        pidData["stime"] = dk_stime_jiffies;
-                        pidData["cutime"] = dk_cutime_jiffies;
-                        pidData["cstime"] = dk_cstime_jiffies;
-                        pidData["cpu_time"] = dk_utime + dk_stime; // Keep original seconds for reference
-                        
-
-                        pidData["priority"] = stat->priority;
-                        pidData["nice"] = stat->nice;
-                        pidData["num_threads"] = stat->num_threads;
-                        pidData["start_time"] = static_cast<qulonglong>(stat->start_time);
-                        pidData["vsize"] = static_cast<qulonglong>(stat->vsize);
-                        pidData["rss"] = static_cast<qulonglong>(stat->rss);
-                        break;
-                    }
-                    case DKapture::PROC_PID_IO: {
-                        // qCDebug(app) << "SystemServer: Processing IO for PID" << hdr->pid << "existing keys:" << pidData.keys();
-                        const ProcPidIo *io = reinterpret_cast<const ProcPidIo *>(payload);
-                        
-                        pidData["rchar"] = static_cast<qulonglong>(io->rchar);
-                        pidData["wchar"] = static_cast<qulonglong>(io->wchar);
-                        pidData["syscr"] = static_cast<qulonglong>(io->syscr);
-                        pidData["syscw"] = static_cast<qulonglong>(io->syscw);
-                        pidData["read_bytes"] = static_cast<qulonglong>(io->read_bytes);
-                        pidData["write_bytes"] = static_cast<qulonglong>(io->write_bytes);
-                        pidData["cancelled_write_bytes"] = static_cast<qulonglong>(io->cancelled_write_bytes);
-                        break;
-                    }
-                    case DKapture::PROC_PID_STATM: {
-                        // qCDebug(app) << "SystemServer: Processing STATM for PID" << hdr->pid << "existing keys:" << pidData.keys();
-                        const ProcPidStatm *statm = reinterpret_cast<const ProcPidStatm *>(payload);
-                        // qCDebug(app) << "SystemServer: STATM raw data - size:" << statm->size << "resident:" << statm->resident << "shared:" << statm->shared;
-    
-
-                        pidData["memory_size"] = static_cast<qulonglong>(statm->size);
-                        pidData["memory_resident"] = static_cast<qulonglong>(statm->resident);
-                        pidData["memory_shared"] = static_cast<qulonglong>(statm->shared);
-                        pidData["memory_text"] = static_cast<qulonglong>(statm->text);
-                        pidData["memory_data"] = static_cast<qulonglong>(statm->data);
-                        break;
-                    }
-                    case DKapture::PROC_PID_STATUS: {
-                        // qCDebug(app) << "SystemServer: 🔍 Processing STATUS for PID" << hdr->pid << "existing keys:" << pidData.keys();
-                        const ProcPidStatus *status = reinterpret_cast<const ProcPidStatus *>(payload);
-                        
-                        // // 调试：输出原始STATUS数据
-                        // qCDebug(app) << "SystemServer: 📊 Raw STATUS data for PID" << hdr->pid 
-                        //             << "- uid[0-3]:" << status->uid[0] << status->uid[1] << status->uid[2] << status->uid[3]
-                        //             << "- gid[0-3]:" << status->gid[0] << status->gid[1] << status->gid[2] << status->gid[3]
-                        //             << "- state:" << (char)status->state << "- tracer_pid:" << status->tracer_pid;
-                        
-                        // UID/GID信息 - 前端主要使用real uid/gid
-                        pidData["uid"] = status->uid[0];        // real uid
-                        pidData["euid"] = status->uid[1];       // effective uid  
-                        pidData["suid"] = status->uid[2];       // saved uid
-                        pidData["fsuid"] = status->uid[3];      // filesystem uid
-                        pidData["gid"] = status->gid[0];        // real gid
-                        pidData["egid"] = status->gid[1];       // effective gid
-                        pidData["sgid"] = status->gid[2];       // saved gid
-                        pidData["fsgid"] = status->gid[3];      // filesystem gid
-                        
-                        // 进程状态和调试信息
-                        pidData["state_from_status"] = status->state;
-                        pidData["tracer_pid"] = status->tracer_pid;
-                        pidData["umask"] = status->umask;
-                        
-                        // qCDebug(app) << "SystemServer: ✅ STATUS data processed for PID" << hdr->pid 
-                        //             << "- final uid:" << pidData["uid"].toUInt() << "gid:" << pidData["gid"].toUInt();
-                        break;
-                    }
-                    case DKapture::PROC_PID_traffic: {
-                        // 网络流量信息处理已禁用 - 前端将使用传统方式获取网络数据
-                        // 这样可以避免DKapture系统级流量vs传统用户态socket流量的数据量差异问题
-                        qCDebug(app) << "SystemServer: Skipping traffic data for PID" << hdr->pid << "- using traditional network monitoring";
-                        break;
-                    }
-                    case DKapture::PROC_PID_SCHEDSTAT: {
-                        // qCDebug(app) << "SystemServer: 🔍 Processing SCHEDSTAT for PID" << hdr->pid;
-                        const ProcPidSchedstat *schedstat = reinterpret_cast<const ProcPidSchedstat *>(payload);
-                        
-                        // SchedStat数据：只传递rq_wait_time，与原有实现保持一致
-                        pidData["rq_wait_time"] = static_cast<qulonglong>(schedstat->rq_wait_time);
-                        
-                        // qCDebug(app) << "SystemServer: ✅ SCHEDSTAT data processed for PID" << hdr->pid 
-                        //             << "- rq_wait_time:" << pidData["rq_wait_time"].toULongLong();
-                        break;
-                    }
-                    default:
-                        break;
-                }
-                
-                // 只有目标PID的数据才添加到结果中返回给前端
-                if (isTargetPid) {
-                    context->processData->insert(pidKey, pidData);
-                    // qCDebug(app) << "SystemServer: Updated target PID" << hdr->pid << "final keys:" << pidData.keys();
-                }
-                return 0;
-            };
-            
-            // 读取 DKapture 数据
-            qCDebug(app) << "SystemServer: About to read DKapture data for" << pids.size() << "PIDs";
-            // qCDebug(app) << "SystemServer: Target PIDs:" << pids;
-            
-            ssize_t bytesRead = m_dkaptureManager->read(dataTypes, callback, &context);
-            
-            // qCDebug(app) << "SystemServer: DKapture read returned" << bytesRead << "bytes";
-            qCDebug(app) << "SystemServer: Process data collected for" << processData.size() << "processes";
-            
-            if (bytesRead >= 0) {
-                result["success"] = true;
-                result["data"] = processData;
-                result.remove("error");
-                qCInfo(app) << "SystemServer: Successfully read" << bytesRead << "bytes of DKapture data for" << processData.size() << "processes";
-            } else {
-                result["error"] = QString("Failed to read DKapture data: %1").arg(bytesRead);
-                qCWarning(app) << "SystemServer: Failed to read DKapture data:" << bytesRead;
-            }
-        } else {
-            result["error"] = "DKapture manager not initialized";
-        }
-        
-    } catch (const std::exception &e) {
-        qCWarning(app) << "SystemServer: Exception in getProcessInfoBatch:" << e.what();
-        result["error"] = QString("Exception: %1").arg(e.what());
-    }
-#else
-    result["error"] = "DKapture support not compiled";
-#endif
-
-    return result;
-}
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "systemdbusserver.h"
+#include "cpu_profiler.h"
+#include "ddlog.h"
+
+#ifdef ENABLE_DKAPTURE
+#include "dkapture_manager.h"
+#include <QSet>
+#include <QHash>
+#include <QThread>
+
+#include <algorithm>
+#include <vector>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "process_info_record.h"
+
+#include <QCoreApplication>
+#include <QDBusMessage>
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDBusServiceWatcher>
+#include <QStandardPaths>
+#include <QThread>
+#include <QProcess>
+#include <QTimer>
+#include <QFile>
+#include <QDir>
+#include <QVector>
+
+#include <sched.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/stat.h>
+#include <sys/sysinfo.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <QStringList>
+#include <QDebug>
+#include <QRegularExpression>
+#include <unistd.h>
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+#include <polkit-qt5-1/PolkitQt1/Authority>
+#include <polkit-qt5-1/PolkitQt1/Subject>
+#else
+#include <polkit-qt6-1/PolkitQt1/Authority>
+#include <polkit-qt6-1/PolkitQt1/Subject>
+#endif
+
+using namespace DDLog;
+
+const QString s_PolkitActionSet = "org.deepin.systemmonitor.systemserver.set";
+const QString s_PolkitActionProcess = "org.deepin.systemmonitor.systemserver.process";
+// CPU 采样线程读取环形缓冲区的间隔，毫秒
+const int CPU_PROFILE_POLL_INTERVAL = 100;
+
+#ifdef ENABLE_DKAPTURE
+// 共享内存快照写入间隔范围，毫秒
+const int SNAPSHOT_MIN_INTERVAL = 500;
+const int SNAPSHOT_MAX_INTERVAL = 10000;
+// 目标进程不超过该数量时按pid读取
+const int TARGETED_READ_MAX_PIDS = 256;
+// 每个进程最多统计的文件数，超出后的事件只计入丢弃数
+const int FILE_ACTIVITY_MAX_FILES = 4096;
+// 每次返回的最繁忙文件数
+const int FILE_ACTIVITY_TOP_FILES = 64;
+// 同一订阅者两次统计的最小间隔，毫秒
+const int FILE_ACTIVITY_MIN_INTERVAL = 1000;
+// 最多统计的中断线与软中断向量数
+const int IRQ_STATS_MAX_ENTRIES = 1024;
+// 同一订阅者两次统计的最小间隔，毫秒
+const int IRQ_STATS_MIN_INTERVAL = 1000;
+// 同一订阅者两次读取块请求延迟的最小间隔，毫秒
+const int BLOCK_LATENCY_MIN_INTERVAL = 1000;
+// 同一订阅者两次读取唤醒次数的最小间隔，毫秒
+const int WAKEUPS_MIN_INTERVAL = 1000;
+// 内存泄漏扫描窗口范围与最长扫描时间，毫秒
+const int MEMLEAK_MIN_WINDOW = 2000;
+const int MEMLEAK_MAX_WINDOW = 60000;
+const qint64 MEMLEAK_MAX_DURATION = 10 * 60 * 1000;
+// 最多统计的泄漏点数，超出后的新调用栈不再统计
+const int MEMLEAK_MAX_SITES = 4096;
+// 每次返回的最大泄漏点数
+const int MEMLEAK_TOP_SITES = 64;
+// 两次计算进程速率的最小间隔，更短的间隔沿用上次的速率，毫秒
+const qint64 PROCESS_RATE_MIN_INTERVAL = 500;
+// 超过该时间未出现的进程丢弃速率基准，毫秒
+const qint64 PROCESS_RATE_STALE_INTERVAL = 30000;
+#endif
+
+/**
+   @brief polkit 鉴权，通过配置文件处理
+ */
+bool checkAuthorization(const QString &appBusName, const QString &action)
+{
+    PolkitQt1::Authority::Result ret = PolkitQt1::Authority::instance()->checkAuthorizationSync(
+            action, PolkitQt1::SystemBusNameSubject(appBusName), PolkitQt1::Authority::AllowUserInteraction);
+    if (PolkitQt1::Authority::Yes == ret) {
+        qCDebug(app) << "Authorization check passed";
+        return true;
+    } else {
+        qCWarning(app) << "Policy authorization check failed for bus:" << appBusName;
+        return false;
+    }
+}
+
+/**
+   @brief 设置进程 \a pid 全部线程的亲和性，sched_setaffinity 只作用于单个线程
+   @return 第一个失败线程的 errno，期间退出的线程忽略
+ */
+static int setProcessAffinity(int pid, const QByteArray &cpus)
+{
+    const cpu_set_t *set = reinterpret_cast<const cpu_set_t *>(cpus.constData());
+    DIR *dir = opendir(QString("/proc/%1/task").arg(pid).toLocal8Bit().constData());
+    if (!dir)
+        return errno == ENOENT ? ESRCH : errno;
+
+    int err = 0;
+    int threads = 0;
+    while (struct dirent *entry = readdir(dir)) {
+        const int tid = atoi(entry->d_name);
+        if (tid <= 0)
+            continue;
+        ++threads;
+        if (sched_setaffinity(tid, size_t(cpus.size()), set) == -1 && errno != ESRCH && !err)
+            err = errno;
+    }
+    closedir(dir);
+    return threads ? err : ESRCH;
+}
+
+/**
+   @return 返回PID对应的可执行程序名称
+ */
+static QString getProcIdExe(qint64 id)
+{
+    qCDebug(app) << "Getting executable for PID:" << id;
+    QString execName;
+    if (id > 0) {
+        // Read contents of virtual /proc/{pid}/cmdline file
+        QString exeSymlinkPath = QString("/proc/%1/exe").arg(id);
+        char *actualpath = realpath(exeSymlinkPath.toStdString().c_str(), nullptr);
+        execName = QString(actualpath);
+        free(actualpath); // free the memory allocated by realpath
+    }
+    qCDebug(app) << "Executable for PID" << id << "is:" << execName;
+    return execName;
+}
+
+SystemDBusServer::SystemDBusServer(QObject *parent)
+    : QObject(parent)
+    , m_subscriberWatcher(nullptr)
+    , m_cpuProfileThread(nullptr)
+    , m_cpuProfileCancel(false)
+    , m_cpuProfileHeader()
+#ifdef ENABLE_DKAPTURE
+    , m_dkaptureManager(nullptr)
+    , m_dkaptureInitialized(false)
+    , m_snapshotFd(-1)
+    , m_snapshot(nullptr)
+    , m_fileWatchActive(false)
+    , m_irqEvents(0)
+    , m_irqWatchActive(false)
+    , m_memleakThread(nullptr)
+    , m_memleakPid(0)
+    , m_memleakCancel(false)
+    , m_memleakState(MEMLEAK_SCAN_CANCELLED)
+    , m_memleakWindows(0)
+    , m_memleakGeneration(0)
+#endif
+{
+    qCDebug(app) << "SystemDBusServer created";
+    
+    // 初始化 DKapture
+    initializeDKapture();
+    // name: 配置文件中的服务名称 org.deepin.SystemMonitorSystemServer
+    QDBusConnection dbus = QDBusConnection::systemBus();
+    if (dbus.registerService("org.deepin.SystemMonitorSystemServer")) {
+        qCDebug(app) << "Successfully registered service org.deepin.SystemMonitorSystemServer";
+        QDBusConnection::RegisterOptions opts =
+                QDBusConnection::ExportAllSlots | QDBusConnection::ExportAllSignals | QDBusConnection::ExportAllProperties;
+        if (!dbus.registerObject("/org/deepin/SystemMonitorSystemServer", this, opts)) {
+            qCWarning(app) << "Failed to register DBus object:" << dbus.lastError().message();
+        }
+    } else {
+        qCWarning(app) << "Failed to register DBus service:" << dbus.lastError().message();
+    }
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, [=]() { 
+        qCDebug(app) << "Timer timeout, exiting application";
+        qApp->exit(0); 
+    });
+
+    // 订阅者退出或断开时释放租约、停止写入快照、丢弃增量状态
+    m_subscriberWatcher = new QDBusServiceWatcher(this);
+    m_subscriberWatcher->setConnection(dbus);
+    m_subscriberWatcher->setWatchMode(QDBusServiceWatcher::WatchForUnregistration);
+    connect(m_subscriberWatcher, &QDBusServiceWatcher::serviceUnregistered,
+            this, &SystemDBusServer::removeSubscriber);
+#ifdef ENABLE_DKAPTURE
+    connect(&m_snapshotTimer, &QTimer::timeout, this, &SystemDBusServer::writeSnapshot);
+    m_processRateClock.start();
+#endif
+}
+
+SystemDBusServer::~SystemDBusServer()
+{
+    if (m_cpuProfileThread) {
+        cancelCpuProfile();
+        m_cpuProfileThread->wait();
+        delete m_cpuProfileThread;
+    }
+#ifdef ENABLE_DKAPTURE
+    if (m_fileWatchActive)
+        m_dkaptureManager->fileWatch(nullptr, nullptr, nullptr);
+    if (m_irqWatchActive)
+        m_dkaptureManager->irqWatch(nullptr, nullptr);
+    if (m_memleakThread) {
+        cancelMemleakScan();
+        m_memleakThread->wait();
+        delete m_memleakThread;
+    }
+    destroySnapshotSegment();
+#endif
+}
+
+/**
+   @brief 延时退出执行服务
+ */
+void SystemDBusServer::exitDBusServer(int msec)
+{
+    qCDebug(app) << "Scheduling exit in" << msec << "ms";
+    qApp->processEvents();
+    m_timer.start(msec);
+}
+
+/**
+   @brief 重置退出定时器（当有新的D-Bus调用时）
+ */
+void SystemDBusServer::resetExitTimer()
+{
+    static const int EXIT_TIMEOUT = 5000; // 5秒无活动后退出
+    // 前台程序持有租约时保持运行，避免再次激活服务、加载 DKapture
+    if (!m_leaseHolders.isEmpty()) {
+        m_timer.stop();
+        return;
+    }
+    // CPU 采样进行中时保持运行，结果在采样结束后才取走
+    if (m_cpuProfileThread) {
+        m_timer.stop();
+        return;
+    }
+#ifdef ENABLE_DKAPTURE
+    // 共享内存快照有订阅者或内存泄漏扫描进行中时保持运行，订阅者无需再发起调用
+    if (!m_snapshotSubscribers.isEmpty() || m_memleakThread) {
+        m_timer.stop();
+        return;
+    }
+#endif
+    qCDebug(app) << "Resetting exit timer to" << EXIT_TIMEOUT << "ms";
+    m_timer.start(EXIT_TIMEOUT);
+}
+
+/**
+   @brief 设置 systemctl 服务 \a serviceName 的启动方式为 \b enable ，仅用于非开发者模式
+ */
+QString SystemDBusServer::setServiceEnable(const QString &serviceName, bool enable)
+{
+    qCDebug(app) << "setServiceEnable called for service:" << serviceName << "enable:" << enable;
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    QString ret = setServiceEnableImpl(serviceName, enable);
+    return ret;
+}
+
+/**
+   @brief 执行设置 systemctl 服务 \a serviceName 启动方式 \a enable ，将返回详细处理结果
+ */
+QString SystemDBusServer::setServiceEnableImpl(const QString &serviceName, bool enable)
+{
+    qCDebug(app) << "setServiceEnableImpl called for service:" << serviceName << "enable:" << enable;
+    // 调用者限制前台系统监视器程序
+    if (!checkCaller()) {
+        qCWarning(app) << "Unauthorized caller attempt to modify service:" << serviceName;
+        return QString(strerror(EPERM));
+    }
+
+    // 不允许包含';' ' '字符，服务名称长度同样限制
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    if (serviceName.isEmpty() || (serviceName.size() > SHRT_MAX) || serviceName.contains(QRegExp("[; ]"))) {
+#else
+    if (serviceName.isEmpty() || (serviceName.size() > SHRT_MAX) || serviceName.contains(QRegularExpression("[; ]"))) {
+#endif
+        qCWarning(app) << "Invalid service name:" << serviceName;
+        return QString(strerror(EINVAL));
+    }
+
+    // 判断服务是否存在
+    QProcess listPorcess;
+    listPorcess.start("systemctl", { "list-unit-files", "--type=service", "--no-pager" });
+    listPorcess.waitForFinished();
+    QByteArray serviceList = listPorcess.readAll();
+    qCDebug(app) << "Checking for service existence...";
+    if (!serviceList.contains(serviceName.toUtf8())) {
+        qCWarning(app) << "Service does not exist:" << serviceName;
+        return QString(strerror(EINVAL));
+    }
+    qCDebug(app) << "Service" << serviceName << "exists.";
+
+    // 鉴权处理
+    if (!checkAuthorization(message().service(), s_PolkitActionSet)) {
+        qCWarning(app) << "Polkit authorization failed for service:" << serviceName;
+        return QString(strerror(EPERM));
+    }
+
+    // 执行设置
+    QProcess process;
+    qCDebug(app) << "Executing 'systemctl" << (enable ? "enable" : "disable") << serviceName << "'";
+    process.start("systemctl", { enable ? "enable" : "disable", serviceName });
+    process.waitForFinished();
+    QString errorRet = process.readAll();
+
+    // 检测是否执行成功
+    qCDebug(app) << "Checking service status after operation...";
+    process.start("systemctl", { "is-enabled", serviceName });
+    process.waitForFinished();
+    QString checkRet = process.readAll();
+    if (enable && ("enabled" == checkRet)) {
+        qCDebug(app) << "Service successfully enabled:" << serviceName;
+        return {};
+    } else if (!enable && ("disabled" == checkRet)) {
+        qCDebug(app) << "Service successfully disabled:" << serviceName;
+        return {};
+    }
+
+    // 返回命令执行结果
+    qCWarning(app) << "Service state change failed:" << errorRet;
+    return errorRet;
+}
+
+/**
+   @brief 对 \a pids 逐个执行进程控制 \a action ，整批只鉴权一次，返回每个进程的 errno，0 为成功
+ */
+QList<int> SystemDBusServer::controlProcesses(const QList<int> &pids, int action, int value)
+{
+    qCDebug(app) << "SystemServer: controlProcesses called," << pids.size() << "pids, action" << action << "value" << value;
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for controlProcesses";
+        return {};
+    }
+    // 亲和性的位图只能通过 setProcessesAffinity 传递
+    return controlProcessesImpl(pids, action, value, {});
+}
+
+/**
+   @brief 将 \a pids 的全部线程绑定到 \a cpus ，整批只鉴权一次，返回每个进程的 errno，0 为成功
+ */
+QList<int> SystemDBusServer::setProcessesAffinity(const QList<int> &pids, const QByteArray &cpus)
+{
+    qCDebug(app) << "SystemServer: setProcessesAffinity called," << pids.size() << "pids," << cpus.size() << "bytes";
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for setProcessesAffinity";
+        return {};
+    }
+    return controlProcessesImpl(pids, PROCESS_CONTROL_AFFINITY, processAffinityCpus(cpus.constData(), size_t(cpus.size())), cpus);
+}
+
+/**
+   @brief 将进程 \a pid 移入独立的临时 scope 并设置资源限制，已在其中的进程重新设置，返回错误信息，成功时为空
+ */
+QString SystemDBusServer::limitProcess(int pid, qulonglong cpuQuota, qulonglong memoryHigh, qulonglong ioWeight)
+{
+    qCDebug(app) << "SystemServer: limitProcess called for pid" << pid << "cpu" << cpuQuota << "memory" << memoryHigh << "io" << ioWeight;
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for limitProcess";
+        return QString(strerror(EPERM));
+    }
+    const resource_limits_t limits {cpuQuota, memoryHigh, ioWeight};
+    if (pid <= 1 || pid == getpid() || !resourceLimitsValid(limits)) {
+        qCWarning(app) << "SystemServer: Invalid limits of pid" << pid;
+        return QString(strerror(EINVAL));
+    }
+    if (!checkProcessControlAuthorization(message().service()))
+        return QString(strerror(EPERM));
+    return UnitLimits::limitProcess(pid, limits);
+}
+
+/**
+   @brief 运行时设置服务 \a serviceName 的资源限制，返回错误信息，成功时为空
+ */
+QString SystemDBusServer::limitService(const QString &serviceName, qulonglong cpuQuota, qulonglong memoryHigh, qulonglong ioWeight)
+{
+    qCDebug(app) << "SystemServer: limitService called for" << serviceName << "cpu" << cpuQuota << "memory" << memoryHigh << "io" << ioWeight;
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for limitService";
+        return QString(strerror(EPERM));
+    }
+    // 只允许 systemd 单元名称中的字符
+    static const QRegularExpression kServiceName("^[A-Za-z0-9:_.\\\\@-]+\\.service$");
+    const resource_limits_t limits {cpuQuota, memoryHigh, ioWeight};
+    if (serviceName.size() > 255 || !kServiceName.match(serviceName).hasMatch() || !resourceLimitsValid(limits)) {
+        qCWarning(app) << "SystemServer: Invalid limits of service" << serviceName;
+        return QString(strerror(EINVAL));
+    }
+    // 与修改服务启动方式相同的鉴权
+    if (!checkAuthorization(message().service(), s_PolkitActionSet)) {
+        qCWarning(app) << "SystemServer: Polkit authorization failed for service:" << serviceName;
+        return QString(strerror(EPERM));
+    }
+    return UnitLimits::limitService(serviceName, limits);
+}
+
+QList<int> SystemDBusServer::controlProcessesImpl(const QList<int> &pids, int action, int value, const QByteArray &cpus)
+{
+    QList<int> results;
+    if (pids.isEmpty() || pids.size() > PROCESS_CONTROL_MAX_PIDS || !processControlValid(action, value)) {
+        qCWarning(app) << "SystemServer: Invalid process control request, action" << action << "value" << value;
+        return results;
+    }
+
+    const QString busName = message().service();
+    if (!checkProcessControlAuthorization(busName)) {
+        for (int i = 0; i < pids.size(); ++i)
+            results << EPERM;
+        return results;
+    }
+
+    int failed = 0;
+    results.reserve(pids.size());
+    for (int pid : pids) {
+        // 不允许控制 init 与服务自身
+        int err = (pid <= 1 || pid == getpid()) ? EPERM : controlProcess(pid, action, value, cpus);
+        if (err)
+            ++failed;
+        results << err;
+    }
+    qCInfo(app) << "SystemServer: Process control by" << busName << "action" << action << "value" << value
+                << "done," << pids.size() - failed << "of" << pids.size() << "succeeded";
+    return results;
+}
+
+bool SystemDBusServer::checkProcessControlAuthorization(const QString &busName)
+{
+    // 与 auth_admin_keep 的保持时间一致
+    static const qint64 AUTHORIZATION_TTL = 5 * 60 * 1000;
+    auto it = m_processControlAuthorized.find(busName);
+    if (it != m_processControlAuthorized.end() && it->elapsed() < AUTHORIZATION_TTL)
+        return true;
+
+    if (!checkAuthorization(busName, s_PolkitActionProcess)) {
+        m_processControlAuthorized.remove(busName);
+        updateSubscriberWatch(busName);
+        return false;
+    }
+    m_processControlAuthorized[busName].start();
+    // 调用者退出后丢弃鉴权，同一总线名称不会被其他进程复用
+    updateSubscriberWatch(busName);
+    return true;
+}
+
+int SystemDBusServer::controlProcess(int pid, int action, int value, const QByteArray &cpus)
+{
+    errno = 0;
+    switch (action) {
+    case PROCESS_CONTROL_SIGNAL:
+        // 先发送 SIGCONT，否则已暂停的进程无法处理结束信号
+        if ((value == SIGTERM || value == SIGKILL) && kill(pid, SIGCONT) == -1)
+            return errno;
+        return kill(pid, value) == -1 ? errno : 0;
+    case PROCESS_CONTROL_RENICE:
+        return setpriority(PRIO_PROCESS, id_t(pid), value) == -1 ? errno : 0;
+    case PROCESS_CONTROL_IONICE:
+        // IOPRIO_WHO_PROCESS
+        return syscall(SYS_ioprio_set, 1, pid, value) == -1 ? errno : 0;
+    case PROCESS_CONTROL_AFFINITY:
+        return cpus.isEmpty() ? EINVAL : setProcessAffinity(pid, cpus);
+    default:
+        return EINVAL;
+    }
+}
+
+/**
+   @return DBus 调用者的PID
+ */
+qint64 SystemDBusServer::dbusCallerPid() const
+{
+    if (!calledFromDBus()) {
+        qCDebug(app) << "Not called from DBus";
+        return 0;
+    }
+
+    auto interface = connection().interface();
+    if (interface) {
+        return static_cast<qint64>(interface->servicePid(message().service()).value());
+    }
+
+    qCDebug(app) << "Failed to get DBus caller PID";
+    return 0;
+}
+
+/**
+   @return 返回调用者是否为前台的系统监视器程序
+ */
+bool SystemDBusServer::checkCaller() const
+{
+    if (!calledFromDBus()) {
+        qCDebug(app) << "Not called from DBus";
+        return false;
+    }
+
+    qint64 callerPid = dbusCallerPid();
+    QString callerExe = getProcIdExe(callerPid);
+    QString dbmExe = QStandardPaths::findExecutable("deepin-system-monitor", { "/usr/bin" });
+
+    qCDebug(app) << "Checking caller authorization - PID:" << callerPid << "Executable:" << callerExe;
+    if (callerExe != dbmExe) {
+        qCWarning(app) << "Unauthorized caller:" << callerExe;
+        return false;
+    }
+
+    qCDebug(app) << "Caller authorized:" << callerExe;
+    return true;
+}
+
+// ================== DKapture 相关实现 ==================
+
+void SystemDBusServer::initializeDKapture()
+{
+#ifdef ENABLE_DKAPTURE
+    qCInfo(app) << "SystemServer: Initializing DKapture...";
+    
+    m_dkaptureManager = DKaptureManager::instance();
+    if (m_dkaptureManager && m_dkaptureManager->isAvailable()) {
+        m_dkaptureInitialized = true;
+        qCInfo(app) << "SystemServer: DKapture initialized successfully";
+    } else {
+        qCWarning(app) << "SystemServer: DKapture initialization failed";
+        m_dkaptureInitialized = false;
+    }
+#else
+    qCDebug(app) << "SystemServer: DKapture support not compiled";
+#endif
+}
+
+void SystemDBusServer::cleanupDKapture()
+{
+#ifdef ENABLE_DKAPTURE
+    if (m_dkaptureManager) {
+        delete m_dkaptureManager;
+        m_dkaptureManager = nullptr;
+    }
+    m_dkaptureInitialized = false;
+    qCDebug(app) << "SystemServer: DKapture cleaned up";
+#endif
+}
+
+bool SystemDBusServer::isDKaptureAvailable()
+{
+    qCDebug(app) << "SystemServer: isDKaptureAvailable called";
+
+    // 重置退出定时器
+    resetExitTimer();
+    
+    // 检查调用者授权
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for isDKaptureAvailable";
+        return false;
+    }
+
+#ifdef ENABLE_DKAPTURE
+    bool available = m_dkaptureInitialized && m_dkaptureManager && m_dkaptureManager->isAvailable();
+    qCDebug(app) << "SystemServer: DKapture availability:" << available;
+    return available;
+#else
+    qCDebug(app) << "SystemServer: DKapture not compiled, returning false";
+    return false;
+#endif
+}
+
+#ifdef ENABLE_DKAPTURE
+namespace {
+
+struct DKaptureCpuTime {
+    qulonglong utime;
+    qulonglong stime;
+    qulonglong cutime;
+    qulonglong cstime;
+    qulonglong seconds;
+};
+
+// DKapture 累计 CPU 时间转换为前端使用的 jiffies，uptimeJiffies 为本批次的系统运行时间
+DKaptureCpuTime dkaptureCpuTime(const ProcPidStat *stat, int pid, long hz, qulonglong uptimeJiffies)
+{
+    static const qulonglong DK_CONVERSION_FACTOR = 10000000ULL; // 10^7
+
+    qulonglong dk_utime = stat->utime / DK_CONVERSION_FACTOR;
+    qulonglong dk_stime = stat->stime / DK_CONVERSION_FACTOR;
+    qulonglong dk_cutime = stat->cutime / DK_CONVERSION_FACTOR;
+    qulonglong dk_cstime = stat->cstime / DK_CONVERSION_FACTOR;
+
+    // Convert back to jiffies for frontend compatibility
+    // Frontend expects utime/stime in jiffies, not seconds
+    DKaptureCpuTime cpu {dk_utime * hz, dk_stime * hz, dk_cutime * hz, dk_cstime * hz, dk_utime + dk_stime};
+
+    // Check for abnormal CPU time values that could cause overflow
+    // Use system uptime as a reasonable upper bound
+    if (uptimeJiffies) {
+        qulonglong total_cpu_jiffies = cpu.utime + cpu.stime;
+
+        if (total_cpu_jiffies > uptimeJiffies * 2) { // Allow 2x system uptime as buffer
+            qCWarning(app) << "SystemServer: Abnormally large DKapture CPU time for PID" << pid
+                          << "- total CPU jiffies:" << total_cpu_jiffies
+                          << "system uptime jiffies:" << uptimeJiffies
+                          << ". Data may be corrupted, setting to safe values.";
+
+            // Set to very small values, the rate stage takes a decreasing CPU time as a new baseline
+            cpu.utime = hz;  // 1 second worth of jiffies
+            cpu.stime = hz;  // 1 second worth of jiffies
+            cpu.cutime = 0;
+            cpu.cstime = 0;
+        }
+    }
+    return cpu;
+}
+
+// 累计值的每秒增量，计数器回退（进程重用或数据被校正）时以本次为新基准
+double counterRate(qulonglong current, qulonglong previous, double secs)
+{
+    return current >= previous ? (current - previous) / secs : 0.;
+}
+
+// 按pid读取时每种数据的大小，未知类型返回 0
+size_t dkaptureDataSize(DKapture::DataType dt)
+{
+    switch (dt) {
+    case DKapture::PROC_PID_STAT:
+        return sizeof(ProcPidStat);
+    case DKapture::PROC_PID_IO:
+        return sizeof(ProcPidIo);
+    case DKapture::PROC_PID_STATM:
+        return sizeof(ProcPidStatm);
+    case DKapture::PROC_PID_STATUS:
+        return sizeof(ProcPidStatus);
+    case DKapture::PROC_PID_SCHEDSTAT:
+        return sizeof(ProcPidSchedstat);
+    case DKapture::PROC_PID_traffic:
+        return sizeof(ProcPidTraffic);
+    default:
+        return 0;
+    }
+}
+
+// 通过 /proc/<pid>/fd 为仍打开的文件补全路径，返回是否有新补全的路径
+bool resolveFileActivityPaths(int pid, std::vector<file_activity_record_t> &records)
+{
+    QHash<quint64, file_activity_record_t *> unresolved;
+    for (file_activity_record_t &rec : records) {
+        if (!rec.path[0])
+            unresolved.insert(rec.ino, &rec);
+    }
+    if (unresolved.isEmpty())
+        return false;
+
+    char fdPath[32];
+    snprintf(fdPath, sizeof(fdPath), "/proc/%d/fd", pid);
+    DIR *dir = opendir(fdPath);
+    if (!dir)
+        return false;
+
+    bool resolved = false;
+    const int dfd = dirfd(dir);
+    struct dirent *entry;
+    while (!unresolved.isEmpty() && (entry = readdir(dir))) {
+        if (entry->d_name[0] == '.')
+            continue;
+        struct stat st;
+        if (fstatat(dfd, entry->d_name, &st, 0) < 0)
+            continue;
+        file_activity_record_t *rec = unresolved.take(quint64(st.st_ino));
+        if (!rec)
+            continue;
+        ssize_t len = readlinkat(dfd, entry->d_name, rec->path, sizeof(rec->path) - 1);
+        rec->path[len > 0 ? len : 0] = '\0';
+        resolved = resolved || len > 0;
+    }
+    closedir(dir);
+    return resolved;
+}
+
+// 软中断向量名称，与 /proc/softirqs 一致
+const char *softIrqName(int vec)
+{
+    static const char *const names[NR_SOFTIRQS] = {
+        "HI", "TIMER", "NET_TX", "NET_RX", "BLOCK", "IRQ_POLL", "TASKLET", "SCHED", "HRTIMER", "RCU"
+    };
+    return vec >= 0 && vec < NR_SOFTIRQS ? names[vec] : "";
+}
+
+// 解析一条 DKapture kmemleak 报告："<bytes> bytes in <n> allocations from stack"，
+// 之后每行一帧 "<i> [<addr>] symbol+off"，stack 为每帧的 symbol+off，每行一帧
+bool parseMemleakReport(const char *report, size_t size, quint64 &bytes, quint64 &allocations,
+                        QByteArray &stack, quint32 &depth)
+{
+    const QByteArray text(report, int(strnlen(report, size)));
+    const QList<QByteArray> lines = text.split('\n');
+    unsigned long long b = 0, n = 0;
+    if (lines.isEmpty() || sscanf(lines.first().constData(), " %llu bytes in %llu allocations", &b, &n) != 2)
+        return false;
+
+    bytes = b;
+    allocations = n;
+    stack.clear();
+    depth = 0;
+    for (int i = 1; i < lines.size(); ++i) {
+        int pos = lines[i].indexOf("] ");
+        if (pos < 0)
+            continue;
+        const QByteArray frame = lines[i].mid(pos + 2).trimmed();
+        if (frame.isEmpty())
+            continue;
+        stack += frame;
+        stack += '\n';
+        ++depth;
+    }
+    return depth > 0;
+}
+
+} // namespace
+#endif
+
+QVariantMap SystemDBusServer::getProcessInfoBatch(const QList<int> &pids)
+{
+    qCDebug(app) << "SystemServer: getProcessInfoBatch called for" << pids.size() << "PIDs";
+
+    // 重置退出定时器
+    resetExitTimer();
+    
+    QVariantMap result;
+    result["success"] = false;
+    result["error"] = "Unknown error";
+    
+    // 检查调用者授权
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for getProcessInfoBatch";
+        result["error"] = "Unauthorized";
+        return result;
+    }
+
+#ifdef ENABLE_DKAPTURE
+    if (!isDKaptureAvailable()) {
+        result["error"] = "DKapture not available";
+        return result;
+    }
+
+    try {
+        QVariantMap processData;
+        
+        // 使用 DKapture 获取进程信息
+        if (m_dkaptureManager) {
+            // 准备要获取的数据类型
+            std::vector<DKapture::DataType> dataTypes = {
+                DKapture::PROC_PID_STAT,    // 基本进程信息
+                DKapture::PROC_PID_IO,      // I/O 信息
+                DKapture::PROC_PID_STATM,   // 内存信息
+                DKapture::PROC_PID_STATUS,  // 进程状态信息（UID/GID等）
+                DKapture::PROC_PID_SCHEDSTAT, // 调度统计信息（cpu_time, rq_wait_time, timeslices）
+                DKapture::PROC_PID_traffic  // 网络流量信息，内核按进程统计，前端据此跳过抓包
+            };
+            
+            // 创建一个结构体来传递上下文
+            struct DKaptureContext {
+                QSet<int> targetPids;
+                QVariantMap *processData;
+                SystemDBusServer *server;
+                ProcessRateBatch batch;
+            } context;
+            
+            context.targetPids = QSet<int>(pids.begin(), pids.end());
+            context.processData = &processData;
+            context.server = this;
+            context.batch = beginProcessRates();
+            
+            // 设置回调函数来处理 DKapture 数据
+            auto callback = [](void *ctx, const void *data, size_t /*data_sz*/) -> int {
+                DKaptureContext *context = static_cast<DKaptureContext *>(ctx);
+                const DKapture::DataHdr *hdr = static_cast<const DKapture::DataHdr *>(data);
+                
+                // qCDebug(app) << "SystemServer: DKapture callback called for PID" << hdr->pid << "type" << hdr->type;
+                
+                // 检查是否为目标PID
+                bool isTargetPid = context->targetPids.contains(hdr->pid);
+                if (!isTargetPid) {
+                    // 对于子线程或子程序，记录基本信息但不立即打印详细数据
+                    // 详细数据将在处理完成后统一格式化输出
+                }
+                
+                QString pidKey = QString::number(hdr->pid);
+                QVariantMap pidData;
+                
+                // 如果已有此 PID 的数据，则获取它
+                if (context->processData->contains(pidKey)) {
+                    pidData = context->processData->value(pidKey).toMap();
+                } else {
+                    pidData["pid"] = hdr->pid;
+                    pidData["tgid"] = hdr->tgid;
+                    pidData["comm"] = QString::fromUtf8(hdr->comm, TASK_COMM_LEN);
+                }
+                
+
+                
+                // 根据数据类型解析数据
+                const char *payload = hdr->data;
+                switch (hdr->type) {
+                    case DKapture::PROC_PID_STAT: {
+                        // qCDebug(app) << "SystemServer: Processing STAT for PID" << hdr->pid << "existing keys:" << pidData.keys();
+                        const ProcPidStat *stat = reinterpret_cast<const ProcPidStat *>(payload);
+                        // qCDebug(app) << "SystemServer: STAT raw data - vsize:" << stat->vsize << "rss:" << stat->rss;
+    
+
+                        pidData["state"] = stat->state;
+                        pidData["ppid"] = stat->ppid;
+                        
+                        // CPU时间处理：转换为jiffies，增量由速率阶段统一计算
+                        const DKaptureCpuTime cpu = dkaptureCpuTime(stat, hdr->pid, context->batch.hz, context->batch.uptimeJiffies);
+
+                        // Store in jiffies for frontend compatibility
+                        pidData["utime"] = cpu.utime;
+                        pidData["stime"] = cpu.stime;
+                        pidData["cutime"] = cpu.cutime;
+                        pidData["cstime"] = cpu.cstime;
+                        pidData["cpu_time"] = cpu.seconds; // Keep original seconds for reference
+                        
+
+                        pidData["priority"] = stat->priority;
+                        pidData["nice"] = stat->nice;
+                        pidData["num_threads"] = stat->num_threads;
+                        pidData["start_time"] = static_cast<qulonglong>(stat->start_time);
+                        pidData["vsize"] = static_cast<qulonglong>(stat->vsize);
+                        pidData["rss"] = static_cast<qulonglong>(stat->rss);
+                        break;
+                    }
+                    case DKapture::PROC_PID_IO: {
+                        // qCDebug(app) << "SystemServer: Processing IO for PID" << hdr->pid << "existing keys:" << pidData.keys();
+                        const ProcPidIo *io = reinterpret_cast<const ProcPidIo *>(payload);
+                        
+                        pidData["rchar"] = static_cast<qulonglong>(io->rchar);
+                        pidData["wchar"] = static_cast<qulonglong>(io->wchar);
+                        pidData["syscr"] = static_cast<qulonglong>(io->syscr);
+                        pidData["syscw"] = static_cast<qulonglong>(io->syscw);
+                        pidData["read_bytes"] = static_cast<qulonglong>(io->read_bytes);
+                        pidData["write_bytes"] = static_cast<qulonglong>(io->write_bytes);
+                        pidData["cancelled_write_bytes"] = static_cast<qulonglong>(io->cancelled_write_bytes);
+                        break;
+                    }
+                    case DKapture::PROC_PID_STATM: {
+                        // qCDebug(app) << "SystemServer: Processing STATM for PID" << hdr->pid << "existing keys:" << pidData.keys();
+                        const ProcPidStatm *statm = reinterpret_cast<const ProcPidStatm *>(payload);
+                        // qCDebug(app) << "SystemServer: STATM raw data - size:" << statm->size << "resident:" << statm->resident << "shared:" << statm->shared;
+    
+
+                        pidData["memory_size"] = static_cast<qulonglong>(statm->size);
+                        pidData["memory_resident"] = static_cast<qulonglong>(statm->resident);
+                        pidData["memory_shared"] = static_cast<qulonglong>(statm->shared);
+                        pidData["memory_text"] = static_cast<qulonglong>(statm->text);
+                        pidData["memory_data"] = static_cast<qulonglong>(statm->data);
+                        break;
+                    }
+                    case DKapture::PROC_PID_STATUS: {
+                        // qCDebug(app) << "SystemServer: 🔍 Processing STATUS for PID" << hdr->pid << "existing keys:" << pidData.keys();
+                        const ProcPidStatus *status = reinterpret_cast<const ProcPidStatus *>(payload);
+                        
+                        // // 调试：输出原始STATUS数据
+                        // qCDebug(app) << "SystemServer: 📊 Raw STATUS data for PID" << hdr->pid 
+                        //             << "- uid[0-3]:" << status->uid[0] << status->uid[1] << status->uid[2] << status->uid[3]
+                        //             << "- gid[0-3]:" << status->gid[0] << status->gid[1] << status->gid[2] << status->gid[3]
+                        //             << "- state:" << (char)status->state << "- tracer_pid:" << status->tracer_pid;
+                        
+                        // UID/GID信息 - 前端主要使用real uid/gid
+                        pidData["uid"] = status->uid[0];        // real uid
+                        pidData["euid"] = status->uid[1];       // effective uid  
+                        pidData["suid"] = status->uid[2];       // saved uid
+                        pidData["fsuid"] = status->uid[3];      // filesystem uid
+                        pidData["gid"] = status->gid[0];        // real gid
+                        pidData["egid"] = status->gid[1];       // effective gid
+                        pidData["sgid"] = status->gid[2];       // saved gid
+                        pidData["fsgid"] = status->gid[3];      // filesystem gid
+                        
+                        // 进程状态和调试信息
+                        pidData["state_from_status"] = status->state;
+                        pidData["tracer_pid"] = status->tracer_pid;
+                        pidData["umask"] = status->umask;
+                        
+                        // qCDebug(app) << "SystemServer: ✅ STATUS data processed for PID" << hdr->pid 
+                        //             << "- final uid:" << pidData["uid"].toUInt() << "gid:" << pidData["gid"].toUInt();
+                        break;
+                    }
+                    case DKapture::PROC_PID_traffic: {
+                        // 累计收发字节数，起点为dkapture启动时，前端按两次采样差值计算速率
+                        const ProcPidTraffic *traffic = reinterpret_cast<const ProcPidTraffic *>(payload);
+                        pidData["network_rx_bytes"] = static_cast<qulonglong>(traffic->rbytes);
+                        pidData["network_tx_bytes"] = static_cast<qulonglong>(traffic->wbytes);
+                        break;
+                    }
+                    case DKapture::PROC_PID_SCHEDSTAT: {
+                        // qCDebug(app) << "SystemServer: 🔍 Processing SCHEDSTAT for PID" << hdr->pid;
+                        const ProcPidSchedstat *schedstat = reinterpret_cast<const ProcPidSchedstat *>(payload);
+                        
+                        // SchedStat数据：只传递rq_wait_time，与原有实现保持一致
+                        pidData["rq_wait_time"] = static_cast<qulonglong>(schedstat->rq_wait_time);
+                        
+                        // qCDebug(app) << "SystemServer: ✅ SCHEDSTAT data processed for PID" << hdr->pid 
+                        //             << "- rq_wait_time:" << pidData["rq_wait_time"].toULongLong();
+                        break;
+                    }
+                    default:
+                        break;
+                }
+                
+                // 只有目标PID的数据才添加到结果中返回给前端
+                if (isTargetPid) {
+                    context->processData->insert(pidKey, pidData);
+                    // qCDebug(app) << "SystemServer: Updated target PID" << hdr->pid << "final keys:" << pidData.keys();
+                }
+                return 0;
+            };
+            
+            // 读取 DKapture 数据
+            qCDebug(app) << "SystemServer: About to read DKapture data for" << pids.size() << "PIDs";
+            // qCDebug(app) << "SystemServer: Target PIDs:" << pids;
+            
+            ssize_t bytesRead = readDKapture(dataTypes, &context.targetPids, callback, &context);
+            
+            // qCDebug(app) << "SystemServer: DKapture read returned" << bytesRead << "bytes";
+            qCDebug(app) << "SystemServer: Process data collected for" << processData.size() << "processes";
+            
+            if (bytesRead >= 0) {
+                // 速率与定长记录使用同一阶段计算
+                for (auto it = processData.begin(); it != processData.end(); ++it) {
+                    QVariantMap pidData = it.value().toMap();
+                    process_info_record_t rec {};
+                    rec.pid = pidData["pid"].toInt();
+                    if (pidData.contains("utime"))
+                        rec.sections |= kProcessInfoStat;
+                    if (pidData.contains("read_bytes"))
+                        rec.sections |= kProcessInfoIO;
+                    if (pidData.contains("network_rx_bytes"))
+                        rec.sections |= kProcessInfoTraffic;
+                    rec.utime = pidData["utime"].toULongLong();
+                    rec.stime = pidData["stime"].toULongLong();
+                    rec.read_bytes = pidData["read_bytes"].toULongLong();
+                    rec.write_bytes = pidData["write_bytes"].toULongLong();
+                    rec.cancelled_write_bytes = pidData["cancelled_write_bytes"].toULongLong();
+                    rec.net_rx_bytes = pidData["network_rx_bytes"].toULongLong();
+                    rec.net_tx_bytes = pidData["network_tx_bytes"].toULongLong();
+                    rateProcessInfo(context.batch, rec);
+                    if (!(rec.sections & kProcessInfoRates))
+                        continue;
+                    pidData["cpu_usage"] = rec.cpu_usage;
+                    pidData["read_bps"] = rec.read_bps;
+                    pidData["write_bps"] = rec.write_bps;
+                    if (rec.sections & kProcessInfoTraffic) {
+                        pidData["network_rx_bps"] = rec.net_rx_bps;
+                        pidData["network_tx_bps"] = rec.net_tx_bps;
+                    }
+                    it.value() = pidData;
+                }
+                endProcessRates(context.batch);
+
+                result["success"] = true;
+                result["data"] = processData;
+                result.remove("error");
+                qCInfo(app) << "SystemServer: Successfully read" << bytesRead << "bytes of DKapture data for" << processData.size() << "processes";
+            } else {
+                result["error"] = QString("Failed to read DKapture data: %1").arg(bytesRead);
+                qCWarning(app) << "SystemServer: Failed to read DKapture data:" << bytesRead;
+            }
+        } else {
+            result["error"] = "DKapture manager not initialized";
+        }
+        
+    } catch (const std::exception &e) {
+        qCWarning(app) << "SystemServer: Exception in getProcessInfoBatch:" << e.what();
+        result["error"] = QString("Exception: %1").arg(e.what());
+    }
+#else
+    result["error"] = "DKapture support not compiled";
+#endif
+
+    return result;
+}
+
+QByteArray SystemDBusServer::getProcessInfoRecords(const QList<int> &pids)
+{
+    qCDebug(app) << "SystemServer: getProcessInfoRecords called for" << pids.size() << "PIDs";
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for getProcessInfoRecords";
+        return {};
+    }
+
+#ifdef ENABLE_DKAPTURE
+    if (!isDKaptureAvailable() || !m_dkaptureManager) {
+        qCWarning(app) << "SystemServer: DKapture not available for getProcessInfoRecords";
+        return {};
+    }
+
+    const QSet<int> targetPids(pids.begin(), pids.end());
+    std::vector<process_info_record_t> records;
+    records.reserve(size_t(pids.size()));
+    ssize_t bytesRead = readProcessInfoRecords(&targetPids, records);
+    if (bytesRead < 0) {
+        qCWarning(app) << "SystemServer: Failed to read DKapture data:" << bytesRead;
+        return {};
+    }
+
+    process_info_records_header_t hdr {};
+    hdr.magic = PROCESS_INFO_RECORDS_MAGIC;
+    hdr.version = PROCESS_INFO_RECORDS_VERSION;
+    hdr.record_size = sizeof(process_info_record_t);
+    hdr.count = uint32_t(records.size());
+
+    QByteArray result;
+    result.reserve(int(sizeof(hdr) + records.size() * sizeof(process_info_record_t)));
+    result.append(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+    result.append(reinterpret_cast<const char *>(records.data()),
+                  int(records.size() * sizeof(process_info_record_t)));
+    qCDebug(app) << "SystemServer: Packed" << hdr.count << "process records," << result.size() << "bytes";
+    return result;
+#else
+    qCDebug(app) << "SystemServer: DKapture not compiled, no process records";
+    return {};
+#endif
+}
+
+QDBusUnixFileDescriptor SystemDBusServer::openProcessInfoSnapshots(int interval)
+{
+    qCDebug(app) << "SystemServer: openProcessInfoSnapshots called, interval" << interval;
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for openProcessInfoSnapshots";
+        return {};
+    }
+
+#ifdef ENABLE_DKAPTURE
+    if (!isDKaptureAvailable() || !m_dkaptureManager) {
+        qCWarning(app) << "SystemServer: DKapture not available for openProcessInfoSnapshots";
+        return {};
+    }
+    if (!(connection().connectionCapabilities() & QDBusConnection::UnixFileDescriptorPassing)) {
+        qCWarning(app) << "SystemServer: D-Bus connection can not pass file descriptors";
+        return {};
+    }
+    if (!m_snapshot && !createSnapshotSegment())
+        return {};
+
+    const QString busName = message().service();
+    m_snapshotSubscribers.insert(busName, qBound(SNAPSHOT_MIN_INTERVAL, interval, SNAPSHOT_MAX_INTERVAL));
+    updateSubscriberWatch(busName);
+    qCInfo(app) << "SystemServer: Process snapshots opened by" << busName;
+
+    // 有订阅者时不再自动退出
+    m_timer.stop();
+    updateSnapshotTimer();
+    // 第一份快照立即写入，客户端下次采样即可使用
+    if (m_snapshot->seq == 0)
+        writeSnapshot();
+
+    return QDBusUnixFileDescriptor(m_snapshotFd);
+#else
+    qCDebug(app) << "SystemServer: DKapture not compiled, no process snapshots";
+    return {};
+#endif
+}
+
+bool SystemDBusServer::acquireLease()
+{
+    qCDebug(app) << "SystemServer: acquireLease called";
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for acquireLease";
+        resetExitTimer();
+        return false;
+    }
+    if (!calledFromDBus())
+        return false;
+
+    const QString busName = message().service();
+    if (++m_leaseHolders[busName] == 1) {
+        updateSubscriberWatch(busName);
+        qCInfo(app) << "SystemServer: Lease acquired by" << busName;
+    }
+    resetExitTimer();
+    return true;
+}
+
+void SystemDBusServer::releaseLease()
+{
+    qCDebug(app) << "SystemServer: releaseLease called";
+    if (calledFromDBus()) {
+        const QString busName = message().service();
+        auto it = m_leaseHolders.find(busName);
+        if (it != m_leaseHolders.end() && --it.value() == 0) {
+            m_leaseHolders.erase(it);
+            updateSubscriberWatch(busName);
+            qCInfo(app) << "SystemServer: Lease released by" << busName;
+        }
+    }
+    // 最后一个租约释放后按空闲超时退出
+    resetExitTimer();
+}
+
+bool SystemDBusServer::openFileActivity(int pid)
+{
+    qCDebug(app) << "SystemServer: openFileActivity called, pid" << pid;
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for openFileActivity";
+        return false;
+    }
+
+#ifdef ENABLE_DKAPTURE
+    if (!isDKaptureAvailable() || !m_dkaptureManager || pid <= 0) {
+        qCWarning(app) << "SystemServer: DKapture not available for openFileActivity";
+        return false;
+    }
+
+    const QString busName = message().service();
+    {
+        QMutexLocker locker(&m_fileActivityMutex);
+        m_fileActivity[pid];
+    }
+    // 整个系统的文件事件只注册一次，回调中只统计被订阅的进程
+    if (!m_fileWatchActive) {
+        int ret = m_dkaptureManager->fileWatch(nullptr, &SystemDBusServer::fileActivityCallback, this);
+        if (ret < 0) {
+            qCWarning(app) << "SystemServer: Failed to watch file events:" << ret;
+            QMutexLocker locker(&m_fileActivityMutex);
+            m_fileActivity.remove(pid);
+            return false;
+        }
+        m_fileWatchActive = true;
+        qCInfo(app) << "SystemServer: File event watch started";
+    }
+
+    ++m_fileActivitySubscribers[busName][pid].refs;
+    updateSubscriberWatch(busName);
+    qCInfo(app) << "SystemServer: File activity of" << pid << "opened by" << busName;
+    return true;
+#else
+    qCDebug(app) << "SystemServer: DKapture not compiled, no file activity";
+    return false;
+#endif
+}
+
+QByteArray SystemDBusServer::getFileActivity(int pid)
+{
+    qCDebug(app) << "SystemServer: getFileActivity called, pid" << pid;
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for getFileActivity";
+        return {};
+    }
+
+#ifdef ENABLE_DKAPTURE
+    auto it = m_fileActivitySubscribers.find(message().service());
+    if (it == m_fileActivitySubscribers.end() || !it->contains(pid))
+        return {};
+
+    FileActivitySubscriber &subscriber = (*it)[pid];
+    if (subscriber.updated.isValid() && subscriber.updated.elapsed() < FILE_ACTIVITY_MIN_INTERVAL)
+        return subscriber.last;
+
+    subscriber.last = fileActivitySnapshot(pid);
+    subscriber.updated.start();
+    return subscriber.last;
+#else
+    return {};
+#endif
+}
+
+void SystemDBusServer::closeFileActivity(int pid)
+{
+    qCDebug(app) << "SystemServer: closeFileActivity called, pid" << pid;
+#ifdef ENABLE_DKAPTURE
+    if (calledFromDBus())
+        releaseFileActivity(message().service(), pid);
+#endif
+    resetExitTimer();
+}
+
+bool SystemDBusServer::openIrqStats()
+{
+    qCDebug(app) << "SystemServer: openIrqStats called";
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for openIrqStats";
+        return false;
+    }
+
+#ifdef ENABLE_DKAPTURE
+    if (!isDKaptureAvailable() || !m_dkaptureManager) {
+        qCWarning(app) << "SystemServer: DKapture not available for openIrqStats";
+        return false;
+    }
+
+    // 中断事件只注册一次，所有订阅者共享统计
+    if (!m_irqWatchActive) {
+        {
+            QMutexLocker locker(&m_irqStatMutex);
+            m_irqStats.clear();
+            m_irqEvents = 0;
+        }
+        int ret = m_dkaptureManager->irqWatch(&SystemDBusServer::irqStatCallback, this);
+        if (ret < 0) {
+            qCWarning(app) << "SystemServer: Failed to watch irq events:" << ret;
+            return false;
+        }
+        m_irqWatchActive = true;
+        qCInfo(app) << "SystemServer: Irq event watch started";
+    }
+
+    const QString busName = message().service();
+    ++m_irqStatsSubscribers[busName].refs;
+    updateSubscriberWatch(busName);
+    qCInfo(app) << "SystemServer: Irq stats opened by" << busName;
+    return true;
+#else
+    qCDebug(app) << "SystemServer: DKapture not compiled, no irq stats";
+    return false;
+#endif
+}
+
+QByteArray SystemDBusServer::getIrqStats()
+{
+    qCDebug(app) << "SystemServer: getIrqStats called";
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for getIrqStats";
+        return {};
+    }
+
+#ifdef ENABLE_DKAPTURE
+    auto it = m_irqStatsSubscribers.find(message().service());
+    if (it == m_irqStatsSubscribers.end())
+        return {};
+
+    if (it->updated.isValid() && it->updated.elapsed() < IRQ_STATS_MIN_INTERVAL)
+        return it->last;
+
+    it->last = irqStatsSnapshot();
+    it->updated.start();
+    return it->last;
+#else
+    return {};
+#endif
+}
+
+void SystemDBusServer::closeIrqStats()
+{
+    qCDebug(app) << "SystemServer: closeIrqStats called";
+#ifdef ENABLE_DKAPTURE
+    if (calledFromDBus())
+        releaseIrqStats(message().service());
+#endif
+    resetExitTimer();
+}
+
+bool SystemDBusServer::openBlockLatency()
+{
+    qCDebug(app) << "SystemServer: openBlockLatency called";
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for openBlockLatency";
+        return false;
+    }
+
+#ifdef ENABLE_DKAPTURE
+    // 跟踪程序只加载一次，所有订阅者共享直方图
+    if (!m_blockLatency.start())
+        return false;
+
+    const QString busName = message().service();
+    ++m_blockLatencySubscribers[busName].refs;
+    updateSubscriberWatch(busName);
+    qCInfo(app) << "SystemServer: Block latency opened by" << busName;
+    return true;
+#else
+    qCDebug(app) << "SystemServer: eBPF support not compiled, no block latency";
+    return false;
+#endif
+}
+
+QByteArray SystemDBusServer::getBlockLatency()
+{
+    qCDebug(app) << "SystemServer: getBlockLatency called";
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for getBlockLatency";
+        return {};
+    }
+
+#ifdef ENABLE_DKAPTURE
+    auto it = m_blockLatencySubscribers.find(message().service());
+    if (it == m_blockLatencySubscribers.end())
+        return {};
+
+    if (it->updated.isValid() && it->updated.elapsed() < BLOCK_LATENCY_MIN_INTERVAL)
+        return it->last;
+
+    it->last = blockLatencySnapshot();
+    it->updated.start();
+    return it->last;
+#else
+    return {};
+#endif
+}
+
+void SystemDBusServer::closeBlockLatency()
+{
+    qCDebug(app) << "SystemServer: closeBlockLatency called";
+#ifdef ENABLE_DKAPTURE
+    if (calledFromDBus())
+        releaseBlockLatency(message().service());
+#endif
+    resetExitTimer();
+}
+
+bool SystemDBusServer::openWakeups()
+{
+    qCDebug(app) << "SystemServer: openWakeups called";
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for openWakeups";
+        return false;
+    }
+
+#ifdef ENABLE_DKAPTURE
+    // 跟踪程序只加载一次，所有订阅者共享计数
+    if (!m_wakeups.start())
+        return false;
+
+    const QString busName = message().service();
+    ++m_wakeupsSubscribers[busName].refs;
+    updateSubscriberWatch(busName);
+    qCInfo(app) << "SystemServer: Wakeups opened by" << busName;
+    return true;
+#else
+    qCDebug(app) << "SystemServer: eBPF support not compiled, no wakeups";
+    return false;
+#endif
+}
+
+QByteArray SystemDBusServer::getWakeups()
+{
+    qCDebug(app) << "SystemServer: getWakeups called";
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for getWakeups";
+        return {};
+    }
+
+#ifdef ENABLE_DKAPTURE
+    auto it = m_wakeupsSubscribers.find(message().service());
+    if (it == m_wakeupsSubscribers.end())
+        return {};
+
+    if (it->updated.isValid() && it->updated.elapsed() < WAKEUPS_MIN_INTERVAL)
+        return it->last;
+
+    it->last = wakeupsSnapshot();
+    it->updated.start();
+    return it->last;
+#else
+    return {};
+#endif
+}
+
+void SystemDBusServer::closeWakeups()
+{
+    qCDebug(app) << "SystemServer: closeWakeups called";
+#ifdef ENABLE_DKAPTURE
+    if (calledFromDBus())
+        releaseWakeups(message().service());
+#endif
+    resetExitTimer();
+}
+
+bool SystemDBusServer::openDiskHealth()
+{
+    qCDebug(app) << "SystemServer: openDiskHealth called";
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for openDiskHealth";
+        return false;
+    }
+
+    // 所有订阅者共享同一个读取线程与结果
+    const QString busName = message().service();
+    ++m_diskHealthSubscribers[busName];
+    updateSubscriberWatch(busName);
+    m_diskHealth.start();
+    qCInfo(app) << "SystemServer: Disk health opened by" << busName;
+    return true;
+}
+
+QByteArray SystemDBusServer::getDiskHealth()
+{
+    qCDebug(app) << "SystemServer: getDiskHealth called";
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for getDiskHealth";
+        return {};
+    }
+
+    if (!m_diskHealthSubscribers.contains(message().service()))
+        return {};
+    return m_diskHealth.snapshot();
+}
+
+void SystemDBusServer::closeDiskHealth()
+{
+    qCDebug(app) << "SystemServer: closeDiskHealth called";
+    if (calledFromDBus())
+        releaseDiskHealth(message().service());
+    resetExitTimer();
+}
+
+QByteArray SystemDBusServer::getEnergyCounters()
+{
+    qCDebug(app) << "SystemServer: getEnergyCounters called";
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for getEnergyCounters";
+        return {};
+    }
+
+    // 高频率的能耗读数可被用作侧信道，所有调用者共享同一份缓存
+    if (m_energyCountersRead.isValid() && m_energyCountersRead.elapsed() < ENERGY_COUNTERS_MIN_INTERVAL)
+        return m_energyCounters;
+
+    m_energyCounters = readEnergyCounters();
+    m_energyCountersRead.start();
+    return m_energyCounters;
+}
+
+QByteArray SystemDBusServer::readEnergyCounters()
+{
+    // 顶层 intel-rapl:N 为 CPU 封装，其名为 core 的子域为核心，AMD 同样通过 intel-rapl 提供
+    const QString root = "/sys/class/powercap";
+    const QStringList zones = QDir(root).entryList({"intel-rapl:*"}, QDir::Dirs | QDir::System);
+    QVector<energy_counter_record_t> records;
+    for (const QString &zone : zones) {
+        const int depth = zone.count(':');
+        QFile nameFile(QString("%1/%2/name").arg(root).arg(zone));
+        if ((depth != 1 && depth != 2) || zone.toLatin1().size() >= ENERGY_ZONE_NAME_LEN
+                || !nameFile.open(QIODevice::ReadOnly))
+            continue;
+        const QByteArray name = nameFile.readAll().trimmed();
+        if (depth == 1 ? !name.startsWith("package") : name != "core")
+            continue;
+
+        QFile energyFile(QString("%1/%2/energy_uj").arg(root).arg(zone));
+        if (!energyFile.open(QIODevice::ReadOnly))
+            continue;
+        bool ok = false;
+        energy_counter_record_t rec {};
+        rec.energy = energyFile.readAll().trimmed().toULongLong(&ok);
+        if (!ok)
+            continue;
+        QFile rangeFile(QString("%1/%2/max_energy_range_uj").arg(root).arg(zone));
+        if (rangeFile.open(QIODevice::ReadOnly))
+            rec.range = rangeFile.readAll().trimmed().toULongLong();
+        const QByteArray dir = zone.toLatin1();
+        memcpy(rec.name, dir.constData(), size_t(dir.size()));
+        rec.core = depth == 2 ? 1 : 0;
+        records << rec;
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    energy_counters_header_t hdr {};
+    hdr.magic = ENERGY_COUNTERS_MAGIC;
+    hdr.version = ENERGY_COUNTERS_VERSION;
+    hdr.record_size = sizeof(energy_counter_record_t);
+    hdr.count = uint32_t(records.size());
+    hdr.timestamp = uint64_t(ts.tv_sec) * 1000000000ULL + uint64_t(ts.tv_nsec);
+
+    QByteArray result(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+    result.append(reinterpret_cast<const char *>(records.constData()), int(records.size() * sizeof(energy_counter_record_t)));
+    return result;
+}
+
+QByteArray SystemDBusServer::getKernelStacks(const QList<int> &pids)
+{
+    qCDebug(app) << "SystemServer: getKernelStacks called for" << pids.size() << "PIDs";
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for getKernelStacks";
+        return {};
+    }
+
+    if (pids.size() > KERNEL_STACKS_MAX_PIDS) {
+        qCWarning(app) << "SystemServer: Too many PIDs for getKernelStacks:" << pids.size();
+        return {};
+    }
+
+    QVector<kernel_stack_record_t> records;
+    for (int pid : pids) {
+        kernel_stack_record_t rec {};
+        if (pid > 0 && readKernelStack(pid, rec))
+            records << rec;
+    }
+
+    kernel_stacks_header_t hdr {};
+    hdr.magic = KERNEL_STACKS_MAGIC;
+    hdr.version = KERNEL_STACKS_VERSION;
+    hdr.record_size = sizeof(kernel_stack_record_t);
+    hdr.count = uint32_t(records.size());
+
+    QByteArray result(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+    result.append(reinterpret_cast<const char *>(records.constData()), int(records.size() * sizeof(kernel_stack_record_t)));
+    return result;
+}
+
+bool SystemDBusServer::readKernelStack(int pid, kernel_stack_record_t &rec)
+{
+    // 只返回不可中断睡眠中的进程，运行中进程的调用栈随时变化，也不应暴露
+    QFile statFile(QString("/proc/%1/stat").arg(pid));
+    if (!statFile.open(QIODevice::ReadOnly))
+        return false;
+    const QByteArray stat = statFile.read(512);
+    const int comm = stat.lastIndexOf(')');
+    if (comm < 0 || comm + 2 >= stat.size() || stat.at(comm + 2) != 'D')
+        return false;
+
+    QFile stackFile(QString("/proc/%1/stack").arg(pid));
+    if (!stackFile.open(QIODevice::ReadOnly))
+        return false;
+
+    // 每行形如 "[<0>] nfs_wait_bit_killable+0x1e/0x90 [nfs]"，只保留函数名
+    size_t used = 0;
+    uint32_t depth = 0;
+    const QList<QByteArray> lines = stackFile.readAll().split('\n');
+    for (const QByteArray &line : lines) {
+        int begin = line.indexOf("] ");
+        begin = begin < 0 ? 0 : begin + 2;
+        int end = begin;
+        while (end < line.size() && line.at(end) != '+' && line.at(end) != ' ')
+            ++end;
+        const size_t len = size_t(end - begin);
+        if (!len)
+            continue;
+        if (used + len + 1 >= KERNEL_STACK_LEN)
+            break;
+        memcpy(rec.stack + used, line.constData() + begin, len);
+        used += len;
+        rec.stack[used++] = '\n';
+        ++depth;
+    }
+    // 读取期间进程已被唤醒
+    if (!depth)
+        return false;
+
+    rec.pid = pid;
+    rec.depth = depth;
+    return true;
+}
+
+bool SystemDBusServer::startMemleakScan(int pid, int window)
+{
+    qCDebug(app) << "SystemServer: startMemleakScan called, pid" << pid << "window" << window;
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for startMemleakScan";
+        return false;
+    }
+
+#ifdef ENABLE_DKAPTURE
+    if (!isDKaptureAvailable() || !m_dkaptureManager || pid < 0) {
+        qCWarning(app) << "SystemServer: DKapture not available for startMemleakScan";
+        return false;
+    }
+    // kmemleak 扫描是全局的，同一时间只能有一个
+    if (m_memleakThread && m_memleakThread->isRunning()) {
+        qCWarning(app) << "SystemServer: Memleak scan already running for" << m_memleakOwner;
+        return false;
+    }
+
+    window = qBound(MEMLEAK_MIN_WINDOW, window, MEMLEAK_MAX_WINDOW);
+    const QString busName = message().service();
+    const QString previousOwner = m_memleakOwner;
+    {
+        QMutexLocker locker(&m_memleakMutex);
+        m_memleakSites.clear();
+        m_memleakPid = pid;
+        m_memleakCancel = false;
+        m_memleakState = MEMLEAK_SCAN_RUNNING;
+        m_memleakWindows = 0;
+        ++m_memleakGeneration;
+    }
+    m_memleakOwner = busName;
+    if (previousOwner != busName)
+        updateSubscriberWatch(previousOwner);
+    updateSubscriberWatch(busName);
+
+    QThread *thread = QThread::create([this, pid, window]() { runMemleakScan(pid, window); });
+    connect(thread, &QThread::finished, this, [this, thread]() {
+        thread->deleteLater();
+        if (m_memleakThread == thread)
+            m_memleakThread = nullptr;
+        qCInfo(app) << "SystemServer: Memleak scan ended";
+        resetExitTimer();
+    });
+    m_memleakThread = thread;
+    thread->start();
+    resetExitTimer();
+    qCInfo(app) << "SystemServer: Memleak scan of" << pid << "started by" << busName;
+    return true;
+#else
+    qCDebug(app) << "SystemServer: DKapture not compiled, no memleak scan";
+    return false;
+#endif
+}
+
+QByteArray SystemDBusServer::getMemleakScan()
+{
+    qCDebug(app) << "SystemServer: getMemleakScan called";
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for getMemleakScan";
+        return {};
+    }
+
+#ifdef ENABLE_DKAPTURE
+    if (m_memleakOwner.isEmpty() || message().service() != m_memleakOwner)
+        return {};
+    return memleakScanSnapshot();
+#else
+    return {};
+#endif
+}
+
+void SystemDBusServer::stopMemleakScan()
+{
+    qCDebug(app) << "SystemServer: stopMemleakScan called";
+#ifdef ENABLE_DKAPTURE
+    if (calledFromDBus() && message().service() == m_memleakOwner)
+        cancelMemleakScan();
+#endif
+    resetExitTimer();
+}
+
+bool SystemDBusServer::startCpuProfile(int pid, int duration, int frequency)
+{
+    qCDebug(app) << "SystemServer: startCpuProfile called, pid" << pid << "duration" << duration << "frequency" << frequency;
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for startCpuProfile";
+        return false;
+    }
+    if (pid <= 0 || pid == getpid() || duration <= 0) {
+        qCWarning(app) << "SystemServer: Invalid cpu profile request of pid" << pid;
+        return false;
+    }
+    if (m_cpuProfileThread && m_cpuProfileThread->isRunning()) {
+        qCWarning(app) << "SystemServer: Cpu profile already running for" << m_cpuProfileOwner;
+        return false;
+    }
+
+    // 其他用户进程的调用栈与进程控制同样需要鉴权
+    const QString busName = message().service();
+    struct stat st;
+    if (stat(QString("/proc/%1").arg(pid).toLocal8Bit().constData(), &st) != 0) {
+        qCWarning(app) << "SystemServer: No process" << pid << "to profile";
+        return false;
+    }
+    auto interface = connection().interface();
+    if ((!interface || st.st_uid != interface->serviceUid(busName).value())
+            && !checkProcessControlAuthorization(busName))
+        return false;
+
+    duration = qMin(duration, CPU_PROFILE_MAX_DURATION);
+    frequency = qBound(CPU_PROFILE_MIN_FREQUENCY, frequency, CPU_PROFILE_MAX_FREQUENCY);
+    const QString previousOwner = m_cpuProfileOwner;
+    {
+        QMutexLocker locker(&m_cpuProfileMutex);
+        m_cpuProfileHeader = cpu_profile_header_t();
+        m_cpuProfileHeader.pid = pid;
+        m_cpuProfileHeader.state = CPU_PROFILE_RUNNING;
+        m_cpuProfileHeader.frequency = uint32_t(frequency);
+        m_cpuProfileHeader.duration = uint32_t(duration);
+        m_cpuProfileRecords.clear();
+        m_cpuProfileCancel = false;
+    }
+    m_cpuProfileOwner = busName;
+    if (previousOwner != busName)
+        updateSubscriberWatch(previousOwner);
+    updateSubscriberWatch(busName);
+
+    QThread *thread = QThread::create([this, pid, duration, frequency]() { runCpuProfile(pid, duration, frequency); });
+    connect(thread, &QThread::finished, this, [this, thread]() {
+        thread->deleteLater();
+        if (m_cpuProfileThread == thread)
+            m_cpuProfileThread = nullptr;
+        qCInfo(app) << "SystemServer: Cpu profile ended";
+        resetExitTimer();
+    });
+    m_cpuProfileThread = thread;
+    thread->start();
+    resetExitTimer();
+    qCInfo(app) << "SystemServer: Cpu profile of" << pid << "started by" << busName;
+    return true;
+}
+
+QByteArray SystemDBusServer::getCpuProfile()
+{
+    qCDebug(app) << "SystemServer: getCpuProfile called";
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for getCpuProfile";
+        return {};
+    }
+    if (m_cpuProfileOwner.isEmpty() || message().service() != m_cpuProfileOwner)
+        return {};
+
+    QMutexLocker locker(&m_cpuProfileMutex);
+    cpu_profile_header_t hdr = m_cpuProfileHeader;
+    hdr.magic = CPU_PROFILE_MAGIC;
+    hdr.version = CPU_PROFILE_VERSION;
+    hdr.stack_size = sizeof(cpu_profile_stack_t);
+    hdr.symbol_size = sizeof(cpu_profile_symbol_t);
+    hdr.mapping_size = sizeof(cpu_profile_mapping_t);
+    QByteArray result(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+    // 采样进行中只返回状态
+    if (hdr.state != CPU_PROFILE_RUNNING)
+        result.append(m_cpuProfileRecords);
+    return result;
+}
+
+void SystemDBusServer::stopCpuProfile()
+{
+    qCDebug(app) << "SystemServer: stopCpuProfile called";
+    if (calledFromDBus() && message().service() == m_cpuProfileOwner)
+        cancelCpuProfile();
+    resetExitTimer();
+}
+
+void SystemDBusServer::runCpuProfile(int pid, int duration, int frequency)
+{
+    CpuProfiler profiler;
+    if (!profiler.open(pid, frequency)) {
+        QMutexLocker locker(&m_cpuProfileMutex);
+        m_cpuProfileHeader.state = CPU_PROFILE_FAILED;
+        return;
+    }
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    bool running = true;
+    bool cancelled = false;
+    while (running && !cancelled && elapsed.elapsed() < duration) {
+        running = profiler.poll(int(qMin<qint64>(CPU_PROFILE_POLL_INTERVAL, duration - elapsed.elapsed())));
+        QMutexLocker locker(&m_cpuProfileMutex);
+        m_cpuProfileHeader.elapsed = uint32_t(qMin<qint64>(elapsed.elapsed(), duration));
+        m_cpuProfileHeader.samples = profiler.samples();
+        m_cpuProfileHeader.lost = profiler.lost();
+        m_cpuProfileHeader.threads = uint32_t(profiler.threads());
+        cancelled = m_cpuProfileCancel;
+    }
+    // 先关闭事件，整理结果期间不再采样
+    profiler.close();
+
+    std::vector<cpu_profile_stack_t> stacks;
+    std::vector<cpu_profile_symbol_t> symbols;
+    std::vector<cpu_profile_mapping_t> mappings;
+    profiler.profile(stacks, symbols, mappings);
+    QByteArray records;
+    records.reserve(int(stacks.size() * sizeof(cpu_profile_stack_t) + symbols.size() * sizeof(cpu_profile_symbol_t)
+                        + mappings.size() * sizeof(cpu_profile_mapping_t)));
+    records.append(reinterpret_cast<const char *>(stacks.data()), int(stacks.size() * sizeof(cpu_profile_stack_t)));
+    records.append(reinterpret_cast<const char *>(symbols.data()), int(symbols.size() * sizeof(cpu_profile_symbol_t)));
+    records.append(reinterpret_cast<const char *>(mappings.data()), int(mappings.size() * sizeof(cpu_profile_mapping_t)));
+
+    QMutexLocker locker(&m_cpuProfileMutex);
+    m_cpuProfileHeader.stacks = uint32_t(stacks.size());
+    m_cpuProfileHeader.symbols = uint32_t(symbols.size());
+    m_cpuProfileHeader.mappings = uint32_t(mappings.size());
+    m_cpuProfileRecords = records;
+    m_cpuProfileHeader.state = cancelled ? CPU_PROFILE_CANCELLED : CPU_PROFILE_FINISHED;
+    qCInfo(app) << "SystemServer: Cpu profile of" << pid << "took" << profiler.samples() << "samples in"
+                << stacks.size() << "stacks," << profiler.lost() << "lost";
+}
+
+void SystemDBusServer::cancelCpuProfile()
+{
+    QMutexLocker locker(&m_cpuProfileMutex);
+    m_cpuProfileCancel = true;
+}
+
+void SystemDBusServer::closeProcessInfoSnapshots()
+{
+    qCDebug(app) << "SystemServer: closeProcessInfoSnapshots called";
+#ifdef ENABLE_DKAPTURE
+    if (calledFromDBus())
+        removeSnapshotSubscriber(message().service());
+#endif
+    resetExitTimer();
+}
+
+QByteArray SystemDBusServer::getProcessInfoDelta(qulonglong generation)
+{
+    qCDebug(app) << "SystemServer: getProcessInfoDelta called, generation" << generation;
+
+    // 重置退出定时器
+    resetExitTimer();
+
+    if (!checkCaller()) {
+        qCWarning(app) << "SystemServer: Unauthorized caller for getProcessInfoDelta";
+        return {};
+    }
+
+#ifdef ENABLE_DKAPTURE
+    if (!isDKaptureAvailable() || !m_dkaptureManager) {
+        qCWarning(app) << "SystemServer: DKapture not available for getProcessInfoDelta";
+        return {};
+    }
+
+    std::vector<process_info_record_t> records;
+    ssize_t bytesRead = readProcessInfoRecords(nullptr, records);
+    if (bytesRead < 0) {
+        qCWarning(app) << "SystemServer: Failed to read DKapture data:" << bytesRead;
+        return {};
+    }
+
+    const QString busName = message().service();
+    DeltaSubscriber &subscriber = m_deltaSubscribers[busName];
+    updateSubscriberWatch(busName);
+
+    // 客户端丢失过回复或刚订阅时重发全部进程
+    const bool baseline = generation == 0 || generation != subscriber.generation;
+    if (baseline)
+        subscriber.records.clear();
+
+    std::vector<const process_info_record_t *> changed;
+    changed.reserve(baseline ? records.size() : records.size() / 4);
+    QHash<int, process_info_record_t> current;
+    current.reserve(int(records.size()));
+    for (const process_info_record_t &rec : records) {
+        auto it = subscriber.records.constFind(rec.pid);
+        if (it == subscriber.records.constEnd() || memcmp(&it.value(), &rec, sizeof(rec)) != 0)
+            changed.push_back(&rec);
+        current.insert(rec.pid, rec);
+    }
+    std::vector<int32_t> exited;
+    for (auto it = subscriber.records.constBegin(); it != subscriber.records.constEnd(); ++it) {
+        if (!current.contains(it.key()))
+            exited.push_back(it.key());
+    }
+    subscriber.records.swap(current);
+    subscriber.generation = subscriber.generation + 1;
+
+    process_info_delta_header_t hdr {};
+    hdr.magic = PROCESS_INFO_DELTA_MAGIC;
+    hdr.version = PROCESS_INFO_DELTA_VERSION;
+    hdr.record_size = sizeof(process_info_record_t);
+    hdr.generation = subscriber.generation;
+    hdr.flags = baseline ? kProcessInfoDeltaBaseline : 0;
+    hdr.count = uint32_t(changed.size());
+    hdr.exited = uint32_t(exited.size());
+
+    QByteArray result;
+    result.reserve(int(processInfoDeltaSize(hdr.count, hdr.exited)));
+    result.append(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+    for (const process_info_record_t *rec : changed)
+        result.append(reinterpret_cast<const char *>(rec), sizeof(*rec));
+    result.append(reinterpret_cast<const char *>(exited.data()), int(exited.size() * sizeof(int32_t)));
+    qCDebug(app) << "SystemServer: Delta generation" << hdr.generation << "-" << hdr.count << "changed,"
+                 << hdr.exited << "exited of" << records.size() << "processes";
+    return result;
+#else
+    Q_UNUSED(generation);
+    qCDebug(app) << "SystemServer: DKapture not compiled, no process delta";
+    return {};
+#endif
+}
+
+#ifdef ENABLE_DKAPTURE
+ssize_t SystemDBusServer::readProcessInfoRecords(const QSet<int> *targetPids, std::vector<process_info_record_t> &records)
+{
+    std::vector<DKapture::DataType> dataTypes = {
+        DKapture::PROC_PID_STAT,
+        DKapture::PROC_PID_IO,
+        DKapture::PROC_PID_STATM,
+        DKapture::PROC_PID_STATUS,
+        DKapture::PROC_PID_SCHEDSTAT,
+        DKapture::PROC_PID_traffic
+    };
+
+    struct RecordContext {
+        const QSet<int> *targetPids;
+        // pid -> index of record
+        QHash<int, int> index;
+        std::vector<process_info_record_t> *records;
+        ProcessRateBatch batch;
+    } context;
+    context.targetPids = targetPids;
+    context.records = &records;
+    context.batch = beginProcessRates();
+    context.index.reserve(targetPids ? targetPids->size() : int(records.capacity()));
+
+    auto callback = [](void *ctx, const void *data, size_t /*data_sz*/) -> int {
+        RecordContext *context = static_cast<RecordContext *>(ctx);
+        const DKapture::DataHdr *hdr = static_cast<const DKapture::DataHdr *>(data);
+
+        // 只返回目标PID的数据
+        if (context->targetPids && !context->targetPids->contains(hdr->pid))
+            return 0;
+
+        auto it = context->index.find(hdr->pid);
+        if (it == context->index.end()) {
+            process_info_record_t rec {};
+            rec.pid = hdr->pid;
+            rec.tgid = hdr->tgid;
+            memcpy(rec.comm, hdr->comm, qMin(sizeof(rec.comm), sizeof(hdr->comm)));
+            rec.comm[sizeof(rec.comm) - 1] = '\0';
+            it = context->index.insert(hdr->pid, int(context->records->size()));
+            context->records->push_back(rec);
+        }
+        process_info_record_t &rec = (*context->records)[size_t(it.value())];
+
+        const char *payload = hdr->data;
+        switch (hdr->type) {
+        case DKapture::PROC_PID_STAT: {
+            const ProcPidStat *stat = reinterpret_cast<const ProcPidStat *>(payload);
+            const DKaptureCpuTime cpu = dkaptureCpuTime(stat, hdr->pid, context->batch.hz, context->batch.uptimeJiffies);
+            rec.state = stat->state;
+            rec.ppid = stat->ppid;
+            rec.utime = cpu.utime;
+            rec.stime = cpu.stime;
+            rec.cutime = cpu.cutime;
+            rec.cstime = cpu.cstime;
+            rec.priority = stat->priority;
+            rec.nice = stat->nice;
+            rec.num_threads = stat->num_threads;
+            rec.start_time = stat->start_time;
+            rec.vsize = stat->vsize;
+            rec.rss = stat->rss;
+            rec.sections |= kProcessInfoStat;
+            break;
+        }
+        case DKapture::PROC_PID_IO: {
+            const ProcPidIo *io = reinterpret_cast<const ProcPidIo *>(payload);
+            rec.read_bytes = io->read_bytes;
+            rec.write_bytes = io->write_bytes;
+            rec.cancelled_write_bytes = io->cancelled_write_bytes;
+            rec.sections |= kProcessInfoIO;
+            break;
+        }
+        case DKapture::PROC_PID_STATM: {
+            const ProcPidStatm *statm = reinterpret_cast<const ProcPidStatm *>(payload);
+            rec.memory_size = statm->size;
+            rec.memory_resident = statm->resident;
+            rec.memory_shared = statm->shared;
+            rec.sections |= kProcessInfoStatm;
+            break;
+        }
+        case DKapture::PROC_PID_STATUS: {
+            const ProcPidStatus *status = reinterpret_cast<const ProcPidStatus *>(payload);
+            rec.uid = status->uid[0];
+            rec.euid = status->uid[1];
+            rec.gid = status->gid[0];
+            rec.egid = status->gid[1];
+            rec.sections |= kProcessInfoStatus;
+            break;
+        }
+        case DKapture::PROC_PID_SCHEDSTAT: {
+            const ProcPidSchedstat *schedstat = reinterpret_cast<const ProcPidSchedstat *>(payload);
+            rec.rq_wait_time = schedstat->rq_wait_time;
+            rec.sections |= kProcessInfoSchedStat;
+            break;
+        }
+        case DKapture::PROC_PID_traffic: {
+            const ProcPidTraffic *traffic = reinterpret_cast<const ProcPidTraffic *>(payload);
+            rec.net_rx_bytes = traffic->rbytes;
+            rec.net_tx_bytes = traffic->wbytes;
+            rec.sections |= kProcessInfoTraffic;
+            break;
+        }
+        default:
+            break;
+        }
+        return 0;
+    };
+
+    try {
+        ssize_t bytesRead = readDKapture(dataTypes, targetPids, callback, &context);
+        if (bytesRead >= 0) {
+            for (process_info_record_t &rec : records)
+                rateProcessInfo(context.batch, rec);
+            endProcessRates(context.batch);
+        }
+        return bytesRead;
+    } catch (const std::exception &e) {
+        qCWarning(app) << "SystemServer: Exception in readProcessInfoRecords:" << e.what();
+        return -1;
+    }
+}
+
+SystemDBusServer::ProcessRateBatch SystemDBusServer::beginProcessRates()
+{
+    ProcessRateBatch batch;
+    batch.msecs = m_processRateClock.elapsed();
+    batch.hz = qMax(1L, sysconf(_SC_CLK_TCK));
+    batch.cpus = int(qMax(1L, sysconf(_SC_NPROCESSORS_ONLN)));
+    struct sysinfo si;
+    if (sysinfo(&si) == 0)
+        batch.uptimeJiffies = qulonglong(si.uptime) * qulonglong(batch.hz);
+    return batch;
+}
+
+void SystemDBusServer::rateProcessInfo(const ProcessRateBatch &batch, process_info_record_t &rec)
+{
+    // CPU 占用需要 stat 数据
+    if (!(rec.sections & kProcessInfoStat))
+        return;
+
+    const qulonglong cpu = rec.utime + rec.stime;
+    auto it = m_processRates.find(rec.pid);
+    if (it == m_processRates.end()) {
+        // 第一次出现的进程以本次为基准，速率为 0
+        ProcessRateStage stage;
+        stage.msecs = batch.msecs;
+        stage.cpu = cpu;
+        stage.read_bytes = rec.read_bytes;
+        stage.write_bytes = rec.write_bytes;
+        stage.cancelled_write_bytes = rec.cancelled_write_bytes;
+        stage.net_rx_bytes = rec.net_rx_bytes;
+        stage.net_tx_bytes = rec.net_tx_bytes;
+        it = m_processRates.insert(rec.pid, stage);
+    } else if (batch.msecs - it->msecs >= PROCESS_RATE_MIN_INTERVAL) {
+        ProcessRateStage &stage = it.value();
+        const double secs = (batch.msecs - stage.msecs) / 1000.;
+        if (cpu < stage.cpu)
+            qCDebug(app) << "SystemServer: CPU time of PID" << rec.pid << "went back from" << stage.cpu
+                         << "to" << cpu << ", using it as new baseline";
+        stage.cpu_usage = counterRate(cpu, stage.cpu, secs) / (batch.hz * batch.cpus) * 100;
+        stage.read_bps = counterRate(rec.read_bytes, stage.read_bytes, secs);
+        // 与 /proc 方式一致，写入速率扣除被取消的写入
+        const double cancelled_bps = counterRate(rec.cancelled_write_bytes, stage.cancelled_write_bytes, secs);
+        stage.write_bps = qMax(0., counterRate(rec.write_bytes, stage.write_bytes, secs) - cancelled_bps);
+        stage.net_rx_bps = counterRate(rec.net_rx_bytes, stage.net_rx_bytes, secs);
+        stage.net_tx_bps = counterRate(rec.net_tx_bytes, stage.net_tx_bytes, secs);
+        stage.msecs = batch.msecs;
+        stage.cpu = cpu;
+        stage.read_bytes = rec.read_bytes;
+        stage.write_bytes = rec.write_bytes;
+        stage.cancelled_write_bytes = rec.cancelled_write_bytes;
+        stage.net_rx_bytes = rec.net_rx_bytes;
+        stage.net_tx_bytes = rec.net_tx_bytes;
+    }
+    it->seen = batch.msecs;
+
+    rec.cpu_usage = it->cpu_usage;
+    rec.read_bps = (rec.sections & kProcessInfoIO) ? it->read_bps : 0.;
+    rec.write_bps = (rec.sections & kProcessInfoIO) ? it->write_bps : 0.;
+    rec.net_rx_bps = (rec.sections & kProcessInfoTraffic) ? it->net_rx_bps : 0.;
+    rec.net_tx_bps = (rec.sections & kProcessInfoTraffic) ? it->net_tx_bps : 0.;
+    rec.sections |= kProcessInfoRates;
+}
+
+void SystemDBusServer::endProcessRates(const ProcessRateBatch &batch)
+{
+    for (auto it = m_processRates.begin(); it != m_processRates.end();) {
+        if (batch.msecs - it->seen > PROCESS_RATE_STALE_INTERVAL)
+            it = m_processRates.erase(it);
+        else
+            ++it;
+    }
+}
+
+ssize_t SystemDBusServer::readDKapture(std::vector<DKapture::DataType> &dataTypes, const QSet<int> *targetPids,
+                                       DKapture::DKCallback cb, void *ctx)
+{
+    size_t entrySize = 0;
+    for (DKapture::DataType dt : dataTypes)
+        entrySize = qMax(entrySize, dkaptureDataSize(dt));
+
+    // 目标进程较少时按pid读取，否则遍历全部进程更划算
+    if (!targetPids || targetPids->isEmpty() || targetPids->size() > TARGETED_READ_MAX_PIDS || entrySize == 0)
+        return m_dkaptureManager->read(dataTypes, cb, ctx);
+
+    std::vector<pid_t> pids(targetPids->begin(), targetPids->end());
+    entrySize += sizeof(DKapture::DataHdr);
+    const size_t bsz = pids.size() * entrySize;
+    if (m_readBuffer.size() * sizeof(uint64_t) < bsz)
+        m_readBuffer.resize((bsz + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    auto *buf = reinterpret_cast<DKapture::DataHdr *>(m_readBuffer.data());
+
+    ssize_t total = 0;
+    for (DKapture::DataType dt : dataTypes) {
+        ssize_t bytesRead = m_dkaptureManager->read(dt, pids, buf, bsz);
+        if (bytesRead < 0) {
+            qCDebug(app) << "SystemServer: Targeted DKapture read failed:" << bytesRead << ", reading all processes";
+            return m_dkaptureManager->read(dataTypes, cb, ctx);
+        }
+
+        // 数据依次存放，每项为 DataHdr 加 dsz 字节数据
+        const char *pos = reinterpret_cast<const char *>(buf);
+        const char *end = pos + qMin(size_t(bytesRead), bsz);
+        while (size_t(end - pos) >= sizeof(DKapture::DataHdr)) {
+            const auto *hdr = reinterpret_cast<const DKapture::DataHdr *>(pos);
+            const size_t size = sizeof(DKapture::DataHdr) + hdr->dsz;
+            if (size > size_t(end - pos))
+                break;
+            cb(ctx, hdr, size);
+            pos += size;
+        }
+        total += bytesRead;
+    }
+    return total;
+}
+
+bool SystemDBusServer::createSnapshotSegment()
+{
+    const size_t size = processInfoShmSize(PROCESS_INFO_SHM_CAPACITY);
+    int fd = memfd_create("deepin-system-monitor-procinfo", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+        qCWarning(app) << "SystemServer: memfd_create failed:" << strerror(errno);
+        return false;
+    }
+    if (ftruncate(fd, off_t(size)) < 0) {
+        qCWarning(app) << "SystemServer: Failed to size snapshot segment:" << strerror(errno);
+        close(fd);
+        return false;
+    }
+    void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        qCWarning(app) << "SystemServer: Failed to map snapshot segment:" << strerror(errno);
+        close(fd);
+        return false;
+    }
+
+    // 客户端映射期间大小不会变化，也无法再获得可写映射
+    const int seals = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL;
+    int ret = -1;
+#ifdef F_SEAL_FUTURE_WRITE
+    ret = fcntl(fd, F_ADD_SEALS, seals | F_SEAL_FUTURE_WRITE);
+#endif
+    if (ret < 0)
+        ret = fcntl(fd, F_ADD_SEALS, seals);
+    if (ret < 0) {
+        qCWarning(app) << "SystemServer: Failed to seal snapshot segment:" << strerror(errno);
+        munmap(addr, size);
+        close(fd);
+        return false;
+    }
+
+    // memfd 初始内容为零，seq 为零表示尚无快照
+    auto *hdr = static_cast<process_info_shm_header_t *>(addr);
+    hdr->magic = PROCESS_INFO_SHM_MAGIC;
+    hdr->version = PROCESS_INFO_SHM_VERSION;
+    hdr->record_size = sizeof(process_info_record_t);
+    hdr->capacity = PROCESS_INFO_SHM_CAPACITY;
+
+    m_snapshotFd = fd;
+    m_snapshot = hdr;
+    qCInfo(app) << "SystemServer: Created process snapshot segment," << size << "bytes";
+    return true;
+}
+
+void SystemDBusServer::destroySnapshotSegment()
+{
+    m_snapshotTimer.stop();
+    if (m_snapshot) {
+        munmap(m_snapshot, processInfoShmSize(m_snapshot->capacity));
+        m_snapshot = nullptr;
+    }
+    if (m_snapshotFd >= 0) {
+        close(m_snapshotFd);
+        m_snapshotFd = -1;
+    }
+    std::vector<process_info_record_t>().swap(m_snapshotRecords);
+}
+
+void SystemDBusServer::writeSnapshot()
+{
+    if (!m_snapshot)
+        return;
+
+    m_snapshotRecords.clear();
+    ssize_t bytesRead = readProcessInfoRecords(nullptr, m_snapshotRecords);
+    if (bytesRead < 0) {
+        qCWarning(app) << "SystemServer: Failed to read DKapture data for snapshot:" << bytesRead;
+        return;
+    }
+
+    uint32_t count = uint32_t(qMin(m_snapshotRecords.size(), size_t(m_snapshot->capacity)));
+    if (count < m_snapshotRecords.size())
+        qCWarning(app) << "SystemServer: Snapshot truncated to" << count << "of" << m_snapshotRecords.size() << "processes";
+
+    process_info_record_t *buffer = beginProcessInfoSnapshot(m_snapshot);
+    memcpy(buffer, m_snapshotRecords.data(), count * sizeof(process_info_record_t));
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    publishProcessInfoSnapshot(m_snapshot, count, uint64_t(ts.tv_sec) * 1000000000ULL + uint64_t(ts.tv_nsec));
+}
+
+void SystemDBusServer::removeSnapshotSubscriber(const QString &busName)
+{
+    if (!m_snapshotSubscribers.remove(busName))
+        return;
+
+    updateSubscriberWatch(busName);
+    qCInfo(app) << "SystemServer: Process snapshots closed by" << busName;
+    if (m_snapshotSubscribers.isEmpty()) {
+        destroySnapshotSegment();
+        resetExitTimer();
+    } else {
+        updateSnapshotTimer();
+    }
+}
+
+void SystemDBusServer::updateSnapshotTimer()
+{
+    // 多个订阅者时按最短间隔写入
+    int interval = SNAPSHOT_MAX_INTERVAL;
+    for (int value : m_snapshotSubscribers)
+        interval = qMin(interval, value);
+
+    m_snapshot->interval = uint32_t(interval);
+    if (!m_snapshotTimer.isActive() || m_snapshotTimer.interval() != interval)
+        m_snapshotTimer.start(interval);
+}
+
+int SystemDBusServer::fileActivityCallback(void *ctx, const void *data, size_t dataSize)
+{
+    if (data && dataSize >= sizeof(FileLog))
+        static_cast<SystemDBusServer *>(ctx)->recordFileActivity(static_cast<const FileLog *>(data), dataSize);
+    return 0;
+}
+
+void SystemDBusServer::recordFileActivity(const FileLog *log, size_t size)
+{
+    QMutexLocker locker(&m_fileActivityMutex);
+    auto it = m_fileActivity.find(log->pid);
+    if (it == m_fileActivity.end())
+        return;
+
+    FileActivity &activity = it.value();
+    auto entry = [&activity](quint64 ino) -> file_activity_record_t * {
+        auto file = activity.files.find(ino);
+        if (file != activity.files.end())
+            return &file.value();
+        if (activity.files.size() >= FILE_ACTIVITY_MAX_FILES) {
+            ++activity.dropped;
+            return nullptr;
+        }
+        file_activity_record_t rec {};
+        rec.ino = ino;
+        return &activity.files.insert(ino, rec).value();
+    };
+
+    switch (log->log_type) {
+    case DKapture::FILE_LOG_READ:
+    case DKapture::FILE_LOG_WRITE: {
+        if (size < sizeof(RwLog))
+            return;
+        auto *rw = static_cast<const RwLog *>(log);
+        const long ret = rw->ret;
+        if (auto *rec = entry(rw->i_ino)) {
+            if (log->log_type == DKapture::FILE_LOG_READ) {
+                ++rec->reads;
+                rec->read_bytes += ret > 0 ? uint64_t(ret) : 0;
+            } else {
+                ++rec->writes;
+                rec->write_bytes += ret > 0 ? uint64_t(ret) : 0;
+            }
+        }
+        break;
+    }
+    case DKapture::FILE_LOG_READV:
+    case DKapture::FILE_LOG_WRITEV: {
+        if (size < sizeof(RwvLog))
+            return;
+        auto *rw = static_cast<const RwvLog *>(log);
+        const long ret = rw->ret;
+        if (auto *rec = entry(rw->i_ino)) {
+            if (log->log_type == DKapture::FILE_LOG_READV) {
+                ++rec->reads;
+                rec->read_bytes += ret > 0 ? uint64_t(ret) : 0;
+            } else {
+                ++rec->writes;
+                rec->write_bytes += ret > 0 ? uint64_t(ret) : 0;
+            }
+        }
+        break;
+    }
+    case DKapture::FILE_LOG_COPY_FILE_RANGE:
+    case DKapture::FILE_LOG_SENDFILE:
+    case DKapture::FILE_LOG_SPLICE: {
+        if (size < sizeof(CopyLog))
+            return;
+        auto *copy = static_cast<const CopyLog *>(log);
+        const uint64_t bytes = copy->ret > 0 ? uint64_t(copy->ret) : 0;
+        if (auto *rec = entry(copy->from_ino)) {
+            ++rec->reads;
+            rec->read_bytes += bytes;
+        }
+        if (auto *rec = entry(copy->to_ino)) {
+            ++rec->writes;
+            rec->write_bytes += bytes;
+        }
+        break;
+    }
+    case DKapture::FILE_LOG_OPEN:
+    case DKapture::FILE_LOG_CLOSE:
+    case DKapture::FILE_LOG_STAT:
+    case DKapture::FILE_LOG_MMAP:
+    case DKapture::FILE_LOG_FLOCK:
+    case DKapture::FILE_LOG_FCNTL:
+    case DKapture::FILE_LOG_TRUNCATE:
+    case DKapture::FILE_LOG_FALLOCATE:
+    case DKapture::FILE_LOG_IOCTL:
+    case DKapture::FILE_LOG_LSEEK: {
+        // 这些日志的 inode 都紧跟在 FileLog 之后
+        unsigned long ino = 0;
+        if (size < sizeof(FileLog) + sizeof(ino))
+            return;
+        memcpy(&ino, reinterpret_cast<const char *>(log) + sizeof(FileLog), sizeof(ino));
+        if (auto *rec = entry(ino))
+            ++rec->other_ops;
+        break;
+    }
+    default:
+        return;
+    }
+    ++activity.events;
+}
+
+QByteArray SystemDBusServer::fileActivitySnapshot(int pid)
+{
+    std::vector<file_activity_record_t> records;
+    file_activity_header_t hdr {};
+    {
+        QMutexLocker locker(&m_fileActivityMutex);
+        auto it = m_fileActivity.constFind(pid);
+        if (it == m_fileActivity.constEnd())
+            return {};
+
+        // 按读写字节数取最繁忙的文件，锁内只排序指针
+        std::vector<const file_activity_record_t *> files;
+        files.reserve(size_t(it->files.size()));
+        for (auto file = it->files.cbegin(); file != it->files.cend(); ++file)
+            files.push_back(&file.value());
+        const size_t count = qMin(files.size(), size_t(FILE_ACTIVITY_TOP_FILES));
+        std::partial_sort(files.begin(), files.begin() + long(count), files.end(),
+                          [](const file_activity_record_t *a, const file_activity_record_t *b) {
+            const uint64_t abytes = a->read_bytes + a->write_bytes;
+            const uint64_t bbytes = b->read_bytes + b->write_bytes;
+            if (abytes != bbytes)
+                return abytes > bbytes;
+            return a->reads + a->writes + a->other_ops > b->reads + b->writes + b->other_ops;
+        });
+        records.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            records.push_back(*files[i]);
+        hdr.events = it->events;
+        hdr.dropped = it->dropped;
+    }
+
+    // 路径在查询时通过 /proc/<pid>/fd 补全，已关闭的文件保持为空
+    if (resolveFileActivityPaths(pid, records)) {
+        QMutexLocker locker(&m_fileActivityMutex);
+        auto it = m_fileActivity.find(pid);
+        if (it != m_fileActivity.end()) {
+            for (const file_activity_record_t &rec : records) {
+                auto file = it->files.find(rec.ino);
+                if (file != it->files.end() && rec.path[0] && !file->path[0])
+                    memcpy(file->path, rec.path, sizeof(rec.path));
+            }
+        }
+    }
+
+    hdr.magic = FILE_ACTIVITY_MAGIC;
+    hdr.version = FILE_ACTIVITY_VERSION;
+    hdr.record_size = sizeof(file_activity_record_t);
+    hdr.count = uint32_t(records.size());
+    hdr.pid = pid;
+
+    QByteArray result(int(sizeof(hdr) + records.size() * sizeof(file_activity_record_t)), Qt::Uninitialized);
+    memcpy(result.data(), &hdr, sizeof(hdr));
+    if (!records.empty())
+        memcpy(result.data() + sizeof(hdr), records.data(), records.size() * sizeof(file_activity_record_t));
+    return result;
+}
+
+void SystemDBusServer::releaseFileActivity(const QString &busName, int pid)
+{
+    auto it = m_fileActivitySubscribers.find(busName);
+    if (it == m_fileActivitySubscribers.end())
+        return;
+    auto subscriber = it->find(pid);
+    // 同一连接上的多个窗口可统计同一进程
+    if (subscriber == it->end() || --subscriber->refs > 0)
+        return;
+
+    it->erase(subscriber);
+    if (it->isEmpty())
+        m_fileActivitySubscribers.erase(it);
+    updateSubscriberWatch(busName);
+    qCInfo(app) << "SystemServer: File activity of" << pid << "closed by" << busName;
+    updateFileActivityWatch();
+}
+
+int SystemDBusServer::irqStatCallback(void *ctx, const void *data, size_t dataSize)
+{
+    if (ctx && data && dataSize >= sizeof(soft_irq_event_t))
+        static_cast<SystemDBusServer *>(ctx)->recordIrqStat(static_cast<const soft_irq_event_t *>(data), dataSize);
+    return 0;
+}
+
+void SystemDBusServer::recordIrqStat(const soft_irq_event_t *event, size_t size)
+{
+    // irq_event_t 与 soft_irq_event_t 前缀相同，按 type 区分
+    const bool hard = event->type == IRQ;
+    if (hard && size < sizeof(irq_event_t))
+        return;
+
+    const uint32_t type = hard ? IRQ_STAT_HARD : IRQ_STAT_SOFT;
+    const quint64 key = (quint64(type) << 32) | uint32_t(event->vec_nr);
+
+    QMutexLocker locker(&m_irqStatMutex);
+    ++m_irqEvents;
+    auto it = m_irqStats.find(key);
+    if (it == m_irqStats.end()) {
+        if (m_irqStats.size() >= IRQ_STATS_MAX_ENTRIES)
+            return;
+        irq_stat_record_t rec {};
+        rec.type = type;
+        rec.vec = event->vec_nr;
+        const char *name = hard ? reinterpret_cast<const irq_event_t *>(event)->name : softIrqName(event->vec_nr);
+        strncpy(rec.name, name, sizeof(rec.name) - 1);
+        it = m_irqStats.insert(key, rec);
+    }
+    ++it->count;
+    it->time_ns += event->delta;
+}
+
+QByteArray SystemDBusServer::irqStatsSnapshot()
+{
+    std::vector<irq_stat_record_t> records;
+    irq_stats_header_t hdr {};
+    {
+        QMutexLocker locker(&m_irqStatMutex);
+        records.reserve(size_t(m_irqStats.size()));
+        for (const auto &rec : m_irqStats)
+            records.push_back(rec);
+        hdr.events = m_irqEvents;
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    hdr.magic = IRQ_STATS_MAGIC;
+    hdr.version = IRQ_STATS_VERSION;
+    hdr.record_size = sizeof(irq_stat_record_t);
+    hdr.count = uint32_t(records.size());
+    hdr.timestamp = uint64_t(ts.tv_sec) * 1000000000ULL + uint64_t(ts.tv_nsec);
+
+    QByteArray result(int(sizeof(hdr) + records.size() * sizeof(irq_stat_record_t)), Qt::Uninitialized);
+    memcpy(result.data(), &hdr, sizeof(hdr));
+    if (!records.empty())
+        memcpy(result.data() + sizeof(hdr), records.data(), records.size() * sizeof(irq_stat_record_t));
+    return result;
+}
+
+void SystemDBusServer::releaseIrqStats(const QString &busName)
+{
+    auto it = m_irqStatsSubscribers.find(busName);
+    // 同一连接上的多个窗口共享订阅
+    if (it == m_irqStatsSubscribers.end() || --it->refs > 0)
+        return;
+
+    m_irqStatsSubscribers.erase(it);
+    updateSubscriberWatch(busName);
+    qCInfo(app) << "SystemServer: Irq stats closed by" << busName;
+    updateIrqWatch();
+}
+
+void SystemDBusServer::updateIrqWatch()
+{
+    if (m_irqStatsSubscribers.isEmpty() && m_irqWatchActive) {
+        m_dkaptureManager->irqWatch(nullptr, nullptr);
+        m_irqWatchActive = false;
+        qCInfo(app) << "SystemServer: Irq event watch stopped";
+    }
+}
+
+QByteArray SystemDBusServer::blockLatencySnapshot()
+{
+    std::vector<block_latency_record_t> records;
+    if (!m_blockLatency.read(records))
+        return {};
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    block_latency_header_t hdr {};
+    hdr.magic = BLOCK_LATENCY_MAGIC;
+    hdr.version = BLOCK_LATENCY_VERSION;
+    hdr.record_size = sizeof(block_latency_record_t);
+    hdr.count = uint32_t(records.size());
+    hdr.timestamp = uint64_t(ts.tv_sec) * 1000000000ULL + uint64_t(ts.tv_nsec);
+
+    QByteArray result(int(sizeof(hdr) + records.size() * sizeof(block_latency_record_t)), Qt::Uninitialized);
+    memcpy(result.data(), &hdr, sizeof(hdr));
+    if (!records.empty())
+        memcpy(result.data() + sizeof(hdr), records.data(), records.size() * sizeof(block_latency_record_t));
+    return result;
+}
+
+void SystemDBusServer::releaseBlockLatency(const QString &busName)
+{
+    auto it = m_blockLatencySubscribers.find(busName);
+    // 同一连接上的多个窗口共享订阅
+    if (it == m_blockLatencySubscribers.end() || --it->refs > 0)
+        return;
+
+    m_blockLatencySubscribers.erase(it);
+    updateSubscriberWatch(busName);
+    qCInfo(app) << "SystemServer: Block latency closed by" << busName;
+    updateBlockLatencyTrace();
+}
+
+void SystemDBusServer::updateBlockLatencyTrace()
+{
+    if (m_blockLatencySubscribers.isEmpty() && m_blockLatency.isRunning()) {
+        m_blockLatency.stop();
+        qCInfo(app) << "SystemServer: Block request latency tracing stopped";
+    }
+}
+
+QByteArray SystemDBusServer::wakeupsSnapshot()
+{
+    std::vector<wakeup_record_t> records;
+    if (!m_wakeups.read(records))
+        return {};
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    wakeups_header_t hdr {};
+    hdr.magic = WAKEUPS_MAGIC;
+    hdr.version = WAKEUPS_VERSION;
+    hdr.record_size = sizeof(wakeup_record_t);
+    hdr.count = uint32_t(records.size());
+    hdr.timestamp = uint64_t(ts.tv_sec) * 1000000000ULL + uint64_t(ts.tv_nsec);
+
+    QByteArray result(int(sizeof(hdr) + records.size() * sizeof(wakeup_record_t)), Qt::Uninitialized);
+    memcpy(result.data(), &hdr, sizeof(hdr));
+    if (!records.empty())
+        memcpy(result.data() + sizeof(hdr), records.data(), records.size() * sizeof(wakeup_record_t));
+    return result;
+}
+
+void SystemDBusServer::releaseWakeups(const QString &busName)
+{
+    auto it = m_wakeupsSubscribers.find(busName);
+    // 同一连接上的多个窗口共享订阅
+    if (it == m_wakeupsSubscribers.end() || --it->refs > 0)
+        return;
+
+    m_wakeupsSubscribers.erase(it);
+    updateSubscriberWatch(busName);
+    qCInfo(app) << "SystemServer: Wakeups closed by" << busName;
+    updateWakeupTrace();
+}
+
+void SystemDBusServer::updateWakeupTrace()
+{
+    if (m_wakeupsSubscribers.isEmpty() && m_wakeups.isRunning()) {
+        m_wakeups.stop();
+        qCInfo(app) << "SystemServer: Wakeup tracing stopped";
+    }
+}
+
+void SystemDBusServer::runMemleakScan(int pid, int window)
+{
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    QMutexLocker locker(&m_memleakMutex);
+    while (!m_memleakCancel && elapsed.elapsed() < MEMLEAK_MAX_DURATION) {
+        locker.unlock();
+        int ret = m_dkaptureManager->kmemleakScanStart(pid_t(pid), &SystemDBusServer::memleakCallback, this);
+        locker.relock();
+        if (ret < 0) {
+            qCWarning(app) << "SystemServer: Failed to start memleak scan:" << ret;
+            m_memleakState = MEMLEAK_SCAN_FAILED;
+            return;
+        }
+
+        // 取消时提前结束当前窗口
+        if (!m_memleakCancel)
+            m_memleakWake.wait(&m_memleakMutex, ulong(window));
+
+        locker.unlock();
+        // 当前窗口内申请且仍未释放的内存在停止期间逐条回调
+        ret = m_dkaptureManager->kmemleakScanStop();
+        locker.relock();
+        if (ret < 0) {
+            qCWarning(app) << "SystemServer: Failed to stop memleak scan:" << ret;
+            m_memleakState = MEMLEAK_SCAN_FAILED;
+            return;
+        }
+        ++m_memleakWindows;
+        ++m_memleakGeneration;
+    }
+    m_memleakState = m_memleakCancel ? MEMLEAK_SCAN_CANCELLED : MEMLEAK_SCAN_FINISHED;
+}
+
+int SystemDBusServer::memleakCallback(void *ctx, const void *data, size_t dataSize)
+{
+    if (ctx && data && dataSize)
+        static_cast<SystemDBusServer *>(ctx)->recordMemleakSite(static_cast<const char *>(data), dataSize);
+    return 0;
+}
+
+void SystemDBusServer::recordMemleakSite(const char *report, size_t size)
+{
+    quint64 bytes = 0;
+    quint64 allocations = 0;
+    QByteArray stack;
+    quint32 depth = 0;
+    if (!parseMemleakReport(report, size, bytes, allocations, stack, depth))
+        return;
+
+    QMutexLocker locker(&m_memleakMutex);
+    auto it = m_memleakSites.find(stack);
+    if (it == m_memleakSites.end()) {
+        if (m_memleakSites.size() >= MEMLEAK_MAX_SITES)
+            return;
+        it = m_memleakSites.insert(stack, MemleakSite());
+        it->depth = depth;
+    }
+    it->bytes += bytes;
+    it->allocations += allocations;
+    // 回调发生在窗口计数增加之前
+    const quint32 window = m_memleakWindows + 1;
+    if (it->lastWindow != window) {
+        it->lastWindow = window;
+        ++it->windows;
+    }
+}
+
+QByteArray SystemDBusServer::memleakScanSnapshot()
+{
+    std::vector<memleak_site_record_t> records;
+    memleak_scan_header_t hdr {};
+    {
+        QMutexLocker locker(&m_memleakMutex);
+        std::vector<QHash<QByteArray, MemleakSite>::const_iterator> sites;
+        sites.reserve(size_t(m_memleakSites.size()));
+        for (auto it = m_memleakSites.cbegin(); it != m_memleakSites.cend(); ++it) {
+            sites.push_back(it);
+            hdr.bytes += it->bytes;
+            hdr.allocations += it->allocations;
+        }
+        const size_t top = std::min(sites.size(), size_t(MEMLEAK_TOP_SITES));
+        std::partial_sort(sites.begin(), sites.begin() + long(top), sites.end(),
+                          [](const QHash<QByteArray, MemleakSite>::const_iterator &a,
+                             const QHash<QByteArray, MemleakSite>::const_iterator &b) {
+            return a->bytes > b->bytes;
+        });
+
+        records.resize(top);
+        for (size_t i = 0; i < top; ++i) {
+            memleak_site_record_t &rec = records[i];
+            memset(&rec, 0, sizeof(rec));
+            rec.bytes = sites[i]->bytes;
+            rec.allocations = sites[i]->allocations;
+            rec.windows = sites[i]->windows;
+            rec.depth = sites[i]->depth;
+            const QByteArray &stack = sites[i].key();
+            memcpy(rec.stack, stack.constData(), std::min(size_t(stack.size()), sizeof(rec.stack) - 1));
+        }
+        hdr.pid = m_memleakPid;
+        hdr.state = m_memleakState;
+        hdr.windows = m_memleakWindows;
+        hdr.generation = m_memleakGeneration;
+    }
+
+    hdr.magic = MEMLEAK_SCAN_MAGIC;
+    hdr.version = MEMLEAK_SCAN_VERSION;
+    hdr.record_size = sizeof(memleak_site_record_t);
+    hdr.count = uint32_t(records.size());
+
+    QByteArray result(int(sizeof(hdr) + records.size() * sizeof(memleak_site_record_t)), Qt::Uninitialized);
+    memcpy(result.data(), &hdr, sizeof(hdr));
+    if (!records.empty())
+        memcpy(result.data() + sizeof(hdr), records.data(), records.size() * sizeof(memleak_site_record_t));
+    return result;
+}
+
+void SystemDBusServer::cancelMemleakScan()
+{
+    QMutexLocker locker(&m_memleakMutex);
+    m_memleakCancel = true;
+    m_memleakWake.wakeAll();
+}
+
+void SystemDBusServer::updateFileActivityWatch()
+{
+    QSet<int> pids;
+    for (const auto &subscribed : m_fileActivitySubscribers) {
+        for (auto it = subscribed.cbegin(); it != subscribed.cend(); ++it)
+            pids.insert(it.key());
+    }
+    {
+        QMutexLocker locker(&m_fileActivityMutex);
+        for (auto it = m_fileActivity.begin(); it != m_fileActivity.end();) {
+            if (pids.contains(it.key()))
+                ++it;
+            else
+                it = m_fileActivity.erase(it);
+        }
+    }
+    if (pids.isEmpty() && m_fileWatchActive) {
+        m_dkaptureManager->fileWatch(nullptr, nullptr, nullptr);
+        m_fileWatchActive = false;
+        qCInfo(app) << "SystemServer: File event watch stopped";
+    }
+}
+#endif
+
+void SystemDBusServer::removeSubscriber(const QString &busName)
+{
+    if (m_leaseHolders.remove(busName))
+        qCInfo(app) << "SystemServer: Lease of" << busName << "dropped";
+    m_processControlAuthorized.remove(busName);
+    if (m_diskHealthSubscribers.remove(busName)) {
+        qCInfo(app) << "SystemServer: Disk health of" << busName << "dropped";
+        if (m_diskHealthSubscribers.isEmpty())
+            m_diskHealth.stop();
+    }
+    if (!m_cpuProfileOwner.isEmpty() && m_cpuProfileOwner == busName) {
+        qCInfo(app) << "SystemServer: Cpu profile of" << busName << "dropped";
+        cancelCpuProfile();
+        m_cpuProfileOwner.clear();
+    }
+#ifdef ENABLE_DKAPTURE
+    if (m_deltaSubscribers.remove(busName))
+        qCInfo(app) << "SystemServer: Process delta subscription of" << busName << "dropped";
+    removeSnapshotSubscriber(busName);
+    if (m_fileActivitySubscribers.remove(busName)) {
+        qCInfo(app) << "SystemServer: File activity of" << busName << "dropped";
+        updateFileActivityWatch();
+    }
+    if (m_irqStatsSubscribers.remove(busName)) {
+        qCInfo(app) << "SystemServer: Irq stats of" << busName << "dropped";
+        updateIrqWatch();
+    }
+    if (m_blockLatencySubscribers.remove(busName)) {
+        qCInfo(app) << "SystemServer: Block latency of" << busName << "dropped";
+        updateBlockLatencyTrace();
+    }
+    if (m_wakeupsSubscribers.remove(busName)) {
+        qCInfo(app) << "SystemServer: Wakeups of" << busName << "dropped";
+        updateWakeupTrace();
+    }
+    if (!m_memleakOwner.isEmpty() && m_memleakOwner == busName) {
+        qCInfo(app) << "SystemServer: Memleak scan of" << busName << "dropped";
+        cancelMemleakScan();
+        m_memleakOwner.clear();
+    }
+#endif
+    updateSubscriberWatch(busName);
+    resetExitTimer();
+}
+
+void SystemDBusServer::releaseDiskHealth(const QString &busName)
+{
+    auto it = m_diskHealthSubscribers.find(busName);
+    // 同一连接上的其他客户端仍在使用
+    if (it == m_diskHealthSubscribers.end() || --it.value() > 0)
+        return;
+
+    m_diskHealthSubscribers.erase(it);
+    updateSubscriberWatch(busName);
+    if (m_diskHealthSubscribers.isEmpty())
+        m_diskHealth.stop();
+}
+
+void SystemDBusServer::updateSubscriberWatch(const QString &busName)
+{
+    bool subscribed = m_leaseHolders.contains(busName) || m_processControlAuthorized.contains(busName)
+            || m_diskHealthSubscribers.contains(busName)
+            || (!m_cpuProfileOwner.isEmpty() && m_cpuProfileOwner == busName);
+#ifdef ENABLE_DKAPTURE
+    subscribed = subscribed || m_snapshotSubscribers.contains(busName) || m_deltaSubscribers.contains(busName)
+            || m_fileActivitySubscribers.contains(busName) || m_irqStatsSubscribers.contains(busName)
+            || m_blockLatencySubscribers.contains(busName)
+            || m_wakeupsSubscribers.contains(busName)
+            || (!m_memleakOwner.isEmpty() && m_memleakOwner == busName);
+#endif
+    const bool watched = m_subscriberWatcher->watchedServices().contains(busName);
+    if (subscribed && !watched)
+        m_subscriberWatcher->addWatchedService(busName);
+    else if (!subscribed && watched)
+        m_subscriberWatcher->removeWatchedService(busName);
+}
@@ -9,13 +9,30 @@
 #include <QDBusContext>
 #include <QTimer>
 #include <QVariantMap>
+#include <QByteArray>
 #include <QMap>
 #include <QMutex>
+#include <QHash>
+#include <QSet>
+#include <QDBusUnixFileDescriptor>
+#include <QElapsedTimer>
+#include <QWaitCondition>
+
+#include <vector>
+
+#include "process_info_record.h"
+#include "disk_health_sampler.h"
+#include "unit_limits.h"
 
 #ifdef ENABLE_DKAPTURE
 #include "dkapture_manager.h"
+#include "block_latency_tracer.h"
+#include "wakeup_tracer.h"
 #endif
 
+class QDBusServiceWatcher;
+class QThread;
+
 class SystemDBusServer : public QObject, protected QDBusContext
 {
     Q_OBJECT
@@ -23,7 +40,7 @@ class SystemDBusServer : public QObject, protected QDBusContext
 
 public:
     SystemDBusServer(QObject *parent = nullptr);
-    ~SystemDBusServer() override {}
+    ~SystemDBusServer() override;
 
     void exitDBusServer(int msec);
     void resetExitTimer();
@@ -34,50 +51,289 @@ public Q_SLOTS:
     // DKapture 相关方法
     bool isDKaptureAvailable();
     QVariantMap getProcessInfoBatch(const QList<int> &pids);
+    // 批量获取进程信息，定长记录数组，格式见 process_info_record.h，失败时返回空数组
+    QByteArray getProcessInfoRecords(const QList<int> &pids);
+    // 订阅共享内存进程快照，返回密封的 memfd，每 interval 毫秒写入一次全部进程的记录
+    QDBusUnixFileDescriptor openProcessInfoSnapshots(int interval);
+    void closeProcessInfoSnapshots();
+    // 增量获取全部进程信息，格式见 process_info_record.h，generation 为上次收到的代数，首次为 0
+    QByteArray getProcessInfoDelta(qulonglong generation);
+
+    // 持有租约的客户端存在时不因空闲退出，释放或客户端退出后按空闲超时退出
+    bool acquireLease();
+    void releaseLease();
+    // 开始统计进程 pid 的文件读写，按需启用 DKapture 文件事件监控
+    bool openFileActivity(int pid);
+    // 进程 pid 最繁忙的文件，格式见 process_info_record.h，失败时返回空数组
+    QByteArray getFileActivity(int pid);
+    void closeFileActivity(int pid);
+    // 开始统计全系统硬中断与软中断，按需启用 DKapture 中断事件监控
+    bool openIrqStats();
+    // 各中断线与软中断向量的次数与耗时，格式见 process_info_record.h，失败时返回空数组
+    QByteArray getIrqStats();
+    void closeIrqStats();
+    // 开始统计各磁盘块请求的延迟分布，按需加载内核跟踪程序，不依赖 DKapture
+    bool openBlockLatency();
+    // 各磁盘读写请求的延迟直方图，格式见 process_info_record.h，失败时返回空数组
+    QByteArray getBlockLatency();
+    void closeBlockLatency();
+    // 开始统计各进程被唤醒的次数，按需加载内核跟踪程序，不依赖 DKapture
+    bool openWakeups();
+    // 各进程的唤醒次数与其中定时器唤醒的次数，格式见 process_info_record.h，失败时返回空数组
+    QByteArray getWakeups();
+    void closeWakeups();
+    // 开始在后台线程中定期读取各磁盘的 SMART 健康状态与温度，休眠的磁盘不唤醒
+    bool openDiskHealth();
+    // 各磁盘最近一次读取的健康状态，格式见 process_info_record.h，读取不等待磁盘
+    QByteArray getDiskHealth();
+    void closeDiskHealth();
+    // 各 CPU 封装与核心的 RAPL 能耗计数，格式见 process_info_record.h，每 ENERGY_COUNTERS_MIN_INTERVAL 最多读取一次
+    QByteArray getEnergyCounters();
+    // 不可中断睡眠中进程的内核调用栈，格式见 process_info_record.h，不超过 KERNEL_STACKS_MAX_PIDS 个进程，其他状态的进程不返回
+    QByteArray getKernelStacks(const QList<int> &pids);
+    // 在后台线程中扫描进程 pid 的内核内存泄漏，0 为全部进程，每 window 毫秒汇总一次，同一时间只能有一个扫描
+    bool startMemleakScan(int pid, int window);
+    // 扫描状态与目前最大的泄漏点，格式见 process_info_record.h，非扫描发起者返回空数组
+    QByteArray getMemleakScan();
+    // 取消扫描，已汇总的结果保留到下次扫描开始
+    void stopMemleakScan();
+    // 在后台线程中按 frequency 采样进程 pid 的用户与内核调用栈 duration 毫秒，只在该进程的线程上开启 perf 事件，同一时间只能有一个采样，其他用户的进程需要鉴权
+    bool startCpuProfile(int pid, int duration, int frequency);
+    // 采样状态，结束后附带调用栈、内核符号与可执行映射，格式见 process_info_record.h，非采样发起者返回空数组
+    QByteArray getCpuProfile();
+    // 提前结束采样，已采到的结果保留到下次采样开始
+    void stopCpuProfile();
+    // 批量发送信号、修改 nice 或 IO 优先级，鉴权一次，格式见 process_info_record.h，返回每个进程的 errno
+    QList<int> controlProcesses(const QList<int> &pids, int action, int value);
+    // 批量设置进程全部线程的 CPU 亲和性，与 controlProcesses 共用鉴权，cpus 为 cpu_set_t 位图，返回每个进程的 errno
+    QList<int> setProcessesAffinity(const QList<int> &pids, const QByteArray &cpus);
+    // 将进程移入独立的临时 scope 并限制 CPU、内存与 IO 权重，与 controlProcesses 共用鉴权，格式见 process_info_record.h，返回错误信息，成功时为空
+    QString limitProcess(int pid, qulonglong cpuQuota, qulonglong memoryHigh, qulonglong ioWeight);
+    // 运行时设置服务的 CPU、内存与 IO 权重限制，不需要重启服务，系统重启后失效，返回错误信息，成功时为空
+    QString limitService(const QString &serviceName, qulonglong cpuQuota, qulonglong memoryHigh, qulonglong ioWeight);
 
 
 private:
     QString setServiceEnableImpl(const QString &serviceName, bool enable);
     qint64 dbusCallerPid() const;
     bool checkCaller() const;
+    // 进程控制鉴权，通过后同一调用者在有效期内不再询问
+    bool checkProcessControlAuthorization(const QString &busName);
+    QList<int> controlProcessesImpl(const QList<int> &pids, int action, int value, const QByteArray &cpus);
+    static int controlProcess(int pid, int action, int value, const QByteArray &cpus);
 
 private:
     void initializeDKapture();
     void cleanupDKapture();
     QVariantMap processDataToVariant(const void *data, const QString &dataType);
     
+    // 订阅者总线名称消失时释放租约、清理快照与增量订阅
+    void removeSubscriber(const QString &busName);
+    void updateSubscriberWatch(const QString &busName);
+    void releaseDiskHealth(const QString &busName);
+    static QByteArray readEnergyCounters();
+    static bool readKernelStack(int pid, kernel_stack_record_t &rec);
+    // 采样线程主循环，结束时整理结果
+    void runCpuProfile(int pid, int duration, int frequency);
+    void cancelCpuProfile();
+
     QTimer m_timer;
+    QDBusServiceWatcher *m_subscriberWatcher;
+    // 持有租约的客户端总线名称 -> 租约数，同一连接上可有多个客户端
+    QHash<QString, int> m_leaseHolders;
+    // 通过进程控制鉴权的调用者总线名称 -> 鉴权时间
+    QHash<QString, QElapsedTimer> m_processControlAuthorized;
+    // 磁盘健康订阅者总线名称 -> 引用数，无订阅者时停止读取
+    QHash<QString, int> m_diskHealthSubscribers;
+    DiskHealthSampler m_diskHealth;
+    // 最近一次读取的能耗计数，限制读取频率
+    QByteArray m_energyCounters;
+    QElapsedTimer m_energyCountersRead;
+    // 进程 CPU 采样，在后台线程中执行
+    QMutex m_cpuProfileMutex;  // 保护采样状态与结果
+    QThread *m_cpuProfileThread;
+    // 采样发起者总线名称，结果只返回给发起者
+    QString m_cpuProfileOwner;
+    bool m_cpuProfileCancel;
+    // 采样状态与计数，结束后的调用栈、符号与映射在 m_cpuProfileRecords 中
+    cpu_profile_header_t m_cpuProfileHeader;
+    QByteArray m_cpuProfileRecords;
 
 #ifdef ENABLE_DKAPTURE
+    // 一批读取共用的时钟与 CPU 信息
+    struct ProcessRateBatch {
+        qint64 msecs = 0;
+        long hz = 100;
+        int cpus = 1;
+        // 系统运行时间，用于校验 DKapture CPU 时间，0 表示未知
+        qulonglong uptimeJiffies = 0;
+    };
+
+    /**
+     * @brief Read process records of \a targetPids through DKapture, all processes if null
+     * @return bytes read by DKapture, negative on failure
+     */
+    ssize_t readProcessInfoRecords(const QSet<int> *targetPids, std::vector<process_info_record_t> &records);
+    // 每批读取开始时调用一次，sysinfo 与 sysconf 只在这里调用
+    ProcessRateBatch beginProcessRates();
+    // 按上一批次的累计值计算 rec 的速率
+    void rateProcessInfo(const ProcessRateBatch &batch, process_info_record_t &rec);
+    // 丢弃长时间未出现的进程
+    void endProcessRates(const ProcessRateBatch &batch);
+    /**
+     * @brief Read \a dataTypes of \a targetPids, all processes if null, every entry is passed to \a cb
+     *
+     * Small pid sets are read per pid through a preallocated buffer, so that DKapture does not
+     * walk every process of the system for them.
+     */
+    ssize_t readDKapture(std::vector<DKapture::DataType> &dataTypes, const QSet<int> *targetPids,
+                         DKapture::DKCallback cb, void *ctx);
+    bool createSnapshotSegment();
+    void destroySnapshotSegment();
+    void writeSnapshot();
+    void removeSnapshotSubscriber(const QString &busName);
+    void updateSnapshotTimer();
+    // DKapture 文件事件回调，在 DKapture 线程中执行
+    static int fileActivityCallback(void *ctx, const void *data, size_t dataSize);
+    void recordFileActivity(const FileLog *log, size_t size);
+    QByteArray fileActivitySnapshot(int pid);
+    void releaseFileActivity(const QString &busName, int pid);
+    // 丢弃无人订阅的进程统计，没有订阅者时注销文件事件监控
+    void updateFileActivityWatch();
+    // DKapture 中断事件回调，在 DKapture 线程中执行
+    static int irqStatCallback(void *ctx, const void *data, size_t dataSize);
+    void recordIrqStat(const soft_irq_event_t *event, size_t size);
+    QByteArray irqStatsSnapshot();
+    void releaseIrqStats(const QString &busName);
+    // 没有订阅者时注销中断事件监控
+    void updateIrqWatch();
+    QByteArray blockLatencySnapshot();
+    void releaseBlockLatency(const QString &busName);
+    // 没有订阅者时卸载块请求跟踪程序
+    void updateBlockLatencyTrace();
+    QByteArray wakeupsSnapshot();
+    void releaseWakeups(const QString &busName);
+    // 没有订阅者时卸载唤醒跟踪程序
+    void updateWakeupTrace();
+    // 扫描线程主循环，按窗口启停 DKapture kmemleak 扫描
+    void runMemleakScan(int pid, int window);
+    // DKapture 泄漏报告回调，在 kmemleak_scan_stop 期间同步执行
+    static int memleakCallback(void *ctx, const void *data, size_t dataSize);
+    void recordMemleakSite(const char *report, size_t size);
+    QByteArray memleakScanSnapshot();
+    void cancelMemleakScan();
+
     DKaptureManager *m_dkaptureManager;
     bool m_dkaptureInitialized;
+    // reusable DataHdr buffer of targeted reads
+    std::vector<uint64_t> m_readBuffer;
     
-    // 用于增量计算的数据结构
-    struct ProcessDeltaData {
-        qulonglong utime = 0;
-        qulonglong stime = 0; 
-        qulonglong cutime = 0;
-        qulonglong cstime = 0;
-        // 网络字段已禁用 - 前端使用传统方式避免数据量差异
-        // qulonglong rbytes = 0;  // 网络接收字节数
-        // qulonglong wbytes = 0;  // 网络发送字节数
-        qulonglong read_bytes = 0;   // 磁盘读字节数
-        qulonglong write_bytes = 0;  // 磁盘写字节数
+    // 进程速率阶段：每个进程保存上一批次的累计值，CPU 占用与 IO 速率按批次在服务端计算
+    struct ProcessRateStage {
+        // 基准采样时间，间隔过短时沿用上次的速率
+        qint64 msecs = 0;
+        // 最近一次出现的批次时间
+        qint64 seen = 0;
+        qulonglong cpu = 0;  // utime + stime, jiffies
+        qulonglong read_bytes = 0;
+        qulonglong write_bytes = 0;
         qulonglong cancelled_write_bytes = 0;
-        // 每个字段分别跟踪是否为第一次采集
-        bool utimeFirstTime = true;
-        bool stimeFirstTime = true;
-        bool cutimeFirstTime = true;
-        bool cstimeFirstTime = true;
-        // 网络字段标记已禁用 - 前端使用传统方式
-        // bool rbytesFirstTime = true;
-        // bool wbytesFirstTime = true;
-        bool readBytesFirstTime = true;
-        bool writeBytesFirstTime = true;
-        bool cancelledWriteBytesFirstTime = true;
+        qulonglong net_rx_bytes = 0;
+        qulonglong net_tx_bytes = 0;
+        double cpu_usage = 0;
+        double read_bps = 0;
+        double write_bps = 0;
+        double net_rx_bps = 0;
+        double net_tx_bps = 0;
+    };
+    QHash<int, ProcessRateStage> m_processRates;
+    QElapsedTimer m_processRateClock;
+
+    // 共享内存进程快照
+    int m_snapshotFd;
+    process_info_shm_header_t *m_snapshot;
+    QTimer m_snapshotTimer;
+    // 订阅者总线名称 -> 快照间隔
+    QHash<QString, int> m_snapshotSubscribers;
+    std::vector<process_info_record_t> m_snapshotRecords;
+
+    // 增量订阅，记录每个订阅者上次收到的全部进程
+    struct DeltaSubscriber {
+        quint64 generation = 0;
+        QHash<int, process_info_record_t> records;
+    };
+    QHash<QString, DeltaSubscriber> m_deltaSubscribers;
+
+    // 每个被统计进程的文件读写，按 inode 聚合
+    struct FileActivity {
+        QHash<quint64, file_activity_record_t> files;
+        quint64 events = 0;
+        quint64 dropped = 0;
+    };
+    QHash<int, FileActivity> m_fileActivity;
+    QMutex m_fileActivityMutex;  // 保护 m_fileActivity，回调在 DKapture 线程中执行
+    // 订阅者总线名称 -> 统计的进程，过快的查询返回上次结果
+    struct FileActivitySubscriber {
+        int refs = 0;
+        QElapsedTimer updated;
+        QByteArray last;
+    };
+    QHash<QString, QHash<int, FileActivitySubscriber>> m_fileActivitySubscribers;
+    bool m_fileWatchActive;
+
+    // 按类型与中断号聚合的中断统计
+    QHash<quint64, irq_stat_record_t> m_irqStats;
+    quint64 m_irqEvents;
+    QMutex m_irqStatMutex;  // 保护 m_irqStats，回调在 DKapture 线程中执行
+    // 订阅者总线名称 -> 订阅数，过快的查询返回上次结果
+    struct IrqStatsSubscriber {
+        int refs = 0;
+        QElapsedTimer updated;
+        QByteArray last;
+    };
+    QHash<QString, IrqStatsSubscriber> m_irqStatsSubscribers;
+    bool m_irqWatchActive;
+
+    // 块请求延迟直方图，在内核中聚合
+    BlockLatencyTracer m_blockLatency;
+    // 订阅者总线名称 -> 订阅数，过快的查询返回上次结果
+    struct BlockLatencySubscriber {
+        int refs = 0;
+        QElapsedTimer updated;
+        QByteArray last;
+    };
+    QHash<QString, BlockLatencySubscriber> m_blockLatencySubscribers;
+
+    // 各线程的唤醒次数，在内核中计数
+    WakeupTracer m_wakeups;
+    // 订阅者总线名称 -> 订阅数，过快的查询返回上次结果
+    struct WakeupsSubscriber {
+        int refs = 0;
+        QElapsedTimer updated;
+        QByteArray last;
+    };
+    QHash<QString, WakeupsSubscriber> m_wakeupsSubscribers;
+
+    // 按调用栈聚合的泄漏点
+    struct MemleakSite {
+        quint64 bytes = 0;
+        quint64 allocations = 0;
+        quint32 windows = 0;
+        quint32 depth = 0;
+        // 最近一次计入的窗口，用于统计泄漏窗口数
+        quint32 lastWindow = 0;
     };
-    QMap<int, ProcessDeltaData> m_processLastValues;  // 存储每个进程的上一次累积值
-    QMutex m_deltaDataMutex;  // 保护增量数据的互斥锁
+    QHash<QByteArray, MemleakSite> m_memleakSites;
+    QMutex m_memleakMutex;  // 保护扫描状态与 m_memleakSites，扫描在后台线程中执行
+    QWaitCondition m_memleakWake;
+    QThread *m_memleakThread;
+    // 扫描发起者总线名称，结果只返回给发起者
+    QString m_memleakOwner;
+    int m_memleakPid;
+    bool m_memleakCancel;
+    quint32 m_memleakState;
+    quint32 m_memleakWindows;
+    quint64 m_memleakGeneration;
 #endif
 };
 
@@ -0,0 +1,222 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "unit_limits.h"
+#include "ddlog.h"
+
+#include <QDBusArgument>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusMetaType>
+#include <QDBusVariant>
+#include <QFile>
+#include <QList>
+
+#include <errno.h>
+#include <string.h>
+
+using namespace DDLog;
+
+// an entry of systemd's a(sv) unit properties
+struct unit_property_t {
+    QString name;
+    QDBusVariant value;
+};
+typedef QList<unit_property_t> UnitPropertyList;
+
+// an auxiliary unit of StartTransientUnit, a(sa(sv)), none are started
+struct unit_aux_t {
+    QString name;
+    UnitPropertyList properties;
+};
+typedef QList<unit_aux_t> UnitAuxList;
+
+Q_DECLARE_METATYPE(unit_property_t)
+Q_DECLARE_METATYPE(UnitPropertyList)
+Q_DECLARE_METATYPE(unit_aux_t)
+Q_DECLARE_METATYPE(UnitAuxList)
+
+static QDBusArgument &operator<<(QDBusArgument &argument, const unit_property_t &property)
+{
+    argument.beginStructure();
+    argument << property.name << property.value;
+    argument.endStructure();
+    return argument;
+}
+
+static const QDBusArgument &operator>>(const QDBusArgument &argument, unit_property_t &property)
+{
+    argument.beginStructure();
+    argument >> property.name >> property.value;
+    argument.endStructure();
+    return argument;
+}
+
+static QDBusArgument &operator<<(QDBusArgument &argument, const unit_aux_t &aux)
+{
+    argument.beginStructure();
+    argument << aux.name << aux.properties;
+    argument.endStructure();
+    return argument;
+}
+
+static const QDBusArgument &operator>>(const QDBusArgument &argument, unit_aux_t &aux)
+{
+    argument.beginStructure();
+    argument >> aux.name >> aux.properties;
+    argument.endStructure();
+    return argument;
+}
+
+namespace {
+
+const char *const kSystemdService = "org.freedesktop.systemd1";
+const char *const kSystemdPath = "/org/freedesktop/systemd1";
+const char *const kSystemdManager = "org.freedesktop.systemd1.Manager";
+
+void registerTypes()
+{
+    static bool registered = false;
+    if (registered)
+        return;
+    qDBusRegisterMetaType<unit_property_t>();
+    qDBusRegisterMetaType<UnitPropertyList>();
+    qDBusRegisterMetaType<unit_aux_t>();
+    qDBusRegisterMetaType<UnitAuxList>();
+    registered = true;
+}
+
+template<typename T>
+unit_property_t property(const QString &name, const T &value)
+{
+    return {name, QDBusVariant(QVariant::fromValue(value))};
+}
+
+/**
+ * @brief Limits as unit properties, all three when \a lift, so limits set before are lifted
+ */
+UnitPropertyList limitProperties(const resource_limits_t &limits, bool lift)
+{
+    // RESOURCE_LIMIT_NONE is systemd's infinity for the quota & memory, unset for the weight
+    UnitPropertyList properties;
+    if (lift || limits.cpu_quota != RESOURCE_LIMIT_NONE)
+        properties << property("CPUQuotaPerSecUSec", qulonglong(limits.cpu_quota));
+    if (lift || limits.memory_high != RESOURCE_LIMIT_NONE)
+        properties << property("MemoryHigh", qulonglong(limits.memory_high));
+    if (lift || limits.io_weight != RESOURCE_LIMIT_NONE)
+        properties << property("IOWeight", qulonglong(limits.io_weight));
+    return properties;
+}
+
+QString callSystemd(const QDBusMessage &msg)
+{
+    QDBusMessage reply = QDBusConnection::systemBus().call(msg);
+    if (reply.type() == QDBusMessage::ErrorMessage) {
+        qCWarning(app) << "systemd" << msg.member() << "failed:" << reply.errorMessage();
+        return reply.errorMessage().isEmpty() ? reply.errorName() : reply.errorMessage();
+    }
+    return {};
+}
+
+QString setUnitProperties(const QString &unit, const UnitPropertyList &properties)
+{
+    QDBusMessage msg = QDBusMessage::createMethodCall(kSystemdService, kSystemdPath, kSystemdManager, "SetUnitProperties");
+    // runtime only, nothing is written to /etc
+    msg << unit << true << QVariant::fromValue(properties);
+    return callSystemd(msg);
+}
+
+} // namespace
+
+QString UnitLimits::limitProcess(int pid, const resource_limits_t &limits)
+{
+    registerTypes();
+    const QString cgroup = processCgroup(pid);
+    if (cgroup.isEmpty())
+        return QString(strerror(ESRCH));
+
+    const QString leaf = leafUnit(cgroup);
+    const QString scope = QString(RESOURCE_LIMIT_SCOPE_PREFIX "%1.scope").arg(pid);
+    if (leaf == scope) {
+        qCInfo(app) << "Setting limits of" << scope << "again";
+        return setUnitProperties(scope, limitProperties(limits, true));
+    }
+    if (leaf.endsWith(".service")) {
+        qCWarning(app) << "Process" << pid << "belongs to" << leaf << ", not moved";
+        return QString("Process belongs to %1, limit the service instead").arg(leaf);
+    }
+
+    QFile comm(QString("/proc/%1/comm").arg(pid));
+    const QString name = comm.open(QIODevice::ReadOnly) ? QString::fromLocal8Bit(comm.readAll()).trimmed() : QString::number(pid);
+
+    UnitPropertyList properties;
+    properties << property("Description", QString("Limits of %1 (%2) set by deepin-system-monitor").arg(name).arg(pid));
+    // children started before stay where they are, later ones are started in the scope
+    properties << property("PIDs", QList<uint> {uint(pid)});
+    const QString slice = systemSlice(cgroup);
+    if (!slice.isEmpty())
+        properties << property("Slice", slice);
+    // gone once the process & its children exit, failed or not
+    properties << property("CollectMode", QString("inactive-or-failed"));
+    properties << limitProperties(limits, false);
+
+    QDBusMessage msg = QDBusMessage::createMethodCall(kSystemdService, kSystemdPath, kSystemdManager, "StartTransientUnit");
+    msg << scope << QString("fail") << QVariant::fromValue(properties) << QVariant::fromValue(UnitAuxList());
+    const QString error = callSystemd(msg);
+    if (error.isEmpty())
+        qCInfo(app) << "Moved process" << pid << "from" << cgroup << "into" << scope << "of" << slice;
+    return error;
+}
+
+QString UnitLimits::limitService(const QString &unit, const resource_limits_t &limits)
+{
+    registerTypes();
+    return setUnitProperties(unit, limitProperties(limits, true));
+}
+
+QString UnitLimits::systemSlice(const QString &cgroup)
+{
+    // slices nest right below the root, the first unit of another type ends them
+    QString slice;
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    const QStringList parts = cgroup.split('/', QString::SkipEmptyParts);
+#else
+    const QStringList parts = cgroup.split('/', Qt::SkipEmptyParts);
+#endif
+    for (const QString &part : parts) {
+        if (!part.endsWith(".slice"))
+            break;
+        slice = part;
+    }
+    return slice;
+}
+
+QString UnitLimits::leafUnit(const QString &cgroup)
+{
+    // a delegated unit may have cgroups of its own below it, they aren't units
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    const QStringList parts = cgroup.split('/', QString::SkipEmptyParts);
+#else
+    const QStringList parts = cgroup.split('/', Qt::SkipEmptyParts);
+#endif
+    for (auto it = parts.crbegin(); it != parts.crend(); ++it) {
+        if (it->endsWith(".service") || it->endsWith(".scope"))
+            return *it;
+    }
+    return {};
+}
+
+QString UnitLimits::processCgroup(int pid)
+{
+    QFile file(QString("/proc/%1/cgroup").arg(pid));
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    // the unified hierarchy, after the v1 lines on hybrid setups
+    const QList<QByteArray> lines = file.readAll().split('\n');
+    for (const QByteArray &line : lines) {
+        if (line.startsWith("0::"))
+            return QString::fromLocal8Bit(line.mid(3));
+    }
+    return {};
+}
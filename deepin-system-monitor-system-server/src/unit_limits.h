@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef UNIT_LIMITS_H
+#define UNIT_LIMITS_H
+
+#include "process_info_record.h"
+
+#include <QString>
+
+/**
+ * @brief Runtime cgroup limits of processes & services, applied through systemd
+ *
+ * systemd owns the cgroup tree, cpu.max or memory.high written behind its back are undone the
+ * next time it realizes the unit. A process is given a transient scope of its own instead, in the
+ * closest slice of the system manager, so it stays accounted to its user. Services get their
+ * properties set for this boot only. The calls block, systemd answers root without asking polkit.
+ */
+class UnitLimits
+{
+public:
+    /**
+     * @brief Limit \a pid, moving it into RESOURCE_LIMIT_SCOPE_PREFIX<pid>.scope
+     *
+     * A process already in its scope has the limits set again, RESOURCE_LIMIT_NONE lifts one.
+     * Processes of a service are refused, moving them out would break the service's stop & restart.
+     * @return Error message, empty on success
+     */
+    static QString limitProcess(int pid, const resource_limits_t &limits);
+    /**
+     * @brief Set \a limits on \a unit until it's reloaded from disk or the system reboots
+     * @return Error message, empty on success
+     */
+    static QString limitService(const QString &unit, const resource_limits_t &limits);
+
+    /**
+     * @brief Closest slice of the system manager above a cgroup of the unified hierarchy
+     *
+     * Slices below a service, e.g. app.slice in user@1000.service, belong to the user manager.
+     * @return Slice unit name, empty for units right below the root
+     */
+    static QString systemSlice(const QString &cgroup);
+    /**
+     * @brief Innermost service or scope of a cgroup, e.g. cron.service for /system.slice/cron.service/sub
+     */
+    static QString leafUnit(const QString &cgroup);
+
+private:
+    static QString processCgroup(int pid);
+};
+
+#endif // UNIT_LIMITS_H
@@ -0,0 +1,249 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "wakeup_tracer.h"
+#include "bpf_program.h"
+#include "ddlog.h"
+
+#include <QFile>
+#include <QSet>
+
+#include <errno.h>
+#include <string.h>
+
+using namespace DDLog;
+using namespace bpf;
+
+namespace {
+
+// value of the thread map
+struct thread_count_t {
+    uint64_t wakeups;
+    uint64_t timerWakeups;
+};
+
+/**
+ * @brief Process of a thread, threads aren't listed in /proc but can be looked up there
+ * @return 0 if the thread exited
+ */
+uint32_t threadGroup(uint32_t tid)
+{
+    QFile file(QString("/proc/%1/status").arg(tid));
+    if (!file.open(QIODevice::ReadOnly))
+        return 0;
+    const QByteArray status = file.read(1024);
+    const int pos = status.indexOf("\nTgid:");
+    if (pos < 0)
+        return 0;
+    const int end = status.indexOf('\n', pos + 1);
+    return status.mid(pos + 6, end - pos - 6).trimmed().toUInt();
+}
+
+// on waking, count[woken tid].wakeups += 1, .timerWakeups too inside an hrtimer expiry
+std::vector<bpf_insn> wakingProgram(int pidOffset, int timerMap, int countMap)
+{
+    enum { kCount, kIncrement, kOut };
+    Program p;
+    // r6 context, r7 timer flag, kept over calls
+    p.movReg(BPF_REG_6, BPF_REG_1);
+    p.load(BPF_W, BPF_REG_2, BPF_REG_6, int16_t(pidOffset));
+    p.store(BPF_W, BPF_REG_10, -4, BPF_REG_2);
+    p.storeImm(BPF_W, BPF_REG_10, -8, 0);
+    p.movImm(BPF_REG_7, 0);
+    p.loadMap(BPF_REG_1, timerMap);
+    p.stackPointer(BPF_REG_2, -8);
+    p.call(BPF_FUNC_map_lookup_elem);
+    p.jumpImm(BPF_JEQ, BPF_REG_0, 0, kCount);
+    p.load(BPF_DW, BPF_REG_7, BPF_REG_0, 0);
+
+    p.label(kCount);
+    p.loadMap(BPF_REG_1, countMap);
+    p.stackPointer(BPF_REG_2, -4);
+    p.call(BPF_FUNC_map_lookup_elem);
+    p.jumpImm(BPF_JNE, BPF_REG_0, 0, kIncrement);
+    // first wakeup of the thread, another cpu may insert it meanwhile
+    p.storeImm(BPF_DW, BPF_REG_10, -24, 0);
+    p.storeImm(BPF_DW, BPF_REG_10, -16, 0);
+    p.loadMap(BPF_REG_1, countMap);
+    p.stackPointer(BPF_REG_2, -4);
+    p.stackPointer(BPF_REG_3, -24);
+    p.movImm(BPF_REG_4, BPF_NOEXIST);
+    p.call(BPF_FUNC_map_update_elem);
+    p.loadMap(BPF_REG_1, countMap);
+    p.stackPointer(BPF_REG_2, -4);
+    p.call(BPF_FUNC_map_lookup_elem);
+    p.jumpImm(BPF_JEQ, BPF_REG_0, 0, kOut);
+
+    p.label(kIncrement);
+    p.movImm(BPF_REG_1, 1);
+    p.atomicAdd(BPF_REG_0, 0, BPF_REG_1);
+    p.jumpImm(BPF_JEQ, BPF_REG_7, 0, kOut);
+    p.atomicAdd(BPF_REG_0, 8, BPF_REG_1);
+
+    p.label(kOut);
+    p.movImm(BPF_REG_0, 0);
+    p.exit();
+    return p.finish();
+}
+
+// on hrtimer expiry entry & exit, timer flag of this cpu = value
+std::vector<bpf_insn> expireProgram(int timerMap, int value)
+{
+    enum { kOut };
+    Program p;
+    p.storeImm(BPF_W, BPF_REG_10, -4, 0);
+    p.loadMap(BPF_REG_1, timerMap);
+    p.stackPointer(BPF_REG_2, -4);
+    p.call(BPF_FUNC_map_lookup_elem);
+    p.jumpImm(BPF_JEQ, BPF_REG_0, 0, kOut);
+    p.storeImm(BPF_DW, BPF_REG_0, 0, value);
+    p.label(kOut);
+    p.movImm(BPF_REG_0, 0);
+    p.exit();
+    return p.finish();
+}
+
+} // namespace
+
+WakeupTracer::~WakeupTracer()
+{
+    stop();
+}
+
+bool WakeupTracer::start()
+{
+    if (isRunning())
+        return true;
+
+    QString format;
+    const int wakingId = tracepointFormat("sched", "sched_waking", format);
+    const int pidOffset = wakingId >= 0 ? fieldOffset(format, "pid_t pid", 4) : -1;
+    const int entryId = tracepointFormat("timer", "hrtimer_expire_entry", format);
+    const int exitId = tracepointFormat("timer", "hrtimer_expire_exit", format);
+    if (pidOffset < 0 || entryId < 0 || exitId < 0) {
+        qCWarning(app) << "Wakeup tracepoints not found, is tracefs mounted?";
+        return false;
+    }
+
+    m_timerMap = createMap(BPF_MAP_TYPE_PERCPU_ARRAY, sizeof(uint32_t), sizeof(uint64_t), 1);
+    m_countMap = createMap(BPF_MAP_TYPE_LRU_HASH, sizeof(uint32_t), sizeof(thread_count_t), kMaxThreads);
+    if (m_timerMap < 0 || m_countMap < 0) {
+        qCWarning(app) << "Failed to create wakeup maps:" << strerror(errno);
+        stop();
+        return false;
+    }
+
+    m_wakingProg = loadProgram(wakingProgram(pidOffset, m_timerMap, m_countMap), "sched_waking");
+    m_expireEntryProg = loadProgram(expireProgram(m_timerMap, 1), "hrtimer_expire_entry");
+    m_expireExitProg = loadProgram(expireProgram(m_timerMap, 0), "hrtimer_expire_exit");
+    if (m_wakingProg < 0 || m_expireEntryProg < 0 || m_expireExitProg < 0) {
+        stop();
+        return false;
+    }
+
+    // the flag is cleared before it can be set, waking last so every wakeup counted sees it right
+    m_expireExitEvent = attachProgram(exitId, m_expireExitProg);
+    if (m_expireExitEvent >= 0)
+        m_expireEntryEvent = attachProgram(entryId, m_expireEntryProg);
+    if (m_expireEntryEvent >= 0)
+        m_wakingEvent = attachProgram(wakingId, m_wakingProg);
+    if (m_wakingEvent < 0) {
+        qCWarning(app) << "Failed to attach wakeup programs:" << strerror(errno);
+        stop();
+        return false;
+    }
+    qCInfo(app) << "Wakeup tracing started";
+    return true;
+}
+
+void WakeupTracer::stop()
+{
+    closeFd(m_wakingEvent);
+    closeFd(m_expireEntryEvent);
+    closeFd(m_expireExitEvent);
+    closeFd(m_wakingProg);
+    closeFd(m_expireEntryProg);
+    closeFd(m_expireExitProg);
+    closeFd(m_timerMap);
+    closeFd(m_countMap);
+    m_threads.clear();
+    m_processes.clear();
+}
+
+bool WakeupTracer::read(std::vector<wakeup_record_t> &records)
+{
+    records.clear();
+    if (!isRunning())
+        return false;
+
+    QSet<uint32_t> seen;
+    uint32_t key = 0;
+    uint32_t next = 0;
+    union bpf_attr attr;
+    bool first = true;
+    for (;;) {
+        memset(&attr, 0, sizeof(attr));
+        attr.map_fd = uint32_t(m_countMap);
+        attr.key = first ? 0 : uint64_t(uintptr_t(&key));
+        attr.next_key = uint64_t(uintptr_t(&next));
+        if (sysBpf(BPF_MAP_GET_NEXT_KEY, &attr) < 0)
+            break;
+        first = false;
+        key = next;
+
+        thread_count_t count {};
+        memset(&attr, 0, sizeof(attr));
+        attr.map_fd = uint32_t(m_countMap);
+        attr.key = uint64_t(uintptr_t(&key));
+        attr.value = uint64_t(uintptr_t(&count));
+        if (sysBpf(BPF_MAP_LOOKUP_ELEM, &attr) < 0)
+            continue;
+
+        auto it = m_threads.find(key);
+        if (it == m_threads.end()) {
+            const uint32_t tgid = threadGroup(key);
+            // exited before its first read, its wakeups are lost with it
+            if (!tgid)
+                continue;
+            it = m_threads.insert(key, {tgid, 0, 0});
+        }
+        seen.insert(key);
+
+        // evicted & counted again from zero meanwhile
+        const uint64_t wakeups = count.wakeups >= it->wakeups ? count.wakeups - it->wakeups : count.wakeups;
+        const uint64_t timerWakeups = count.timerWakeups >= it->timerWakeups ? count.timerWakeups - it->timerWakeups
+                                                                              : count.timerWakeups;
+        it->wakeups = count.wakeups;
+        it->timerWakeups = count.timerWakeups;
+        wakeup_record_t &process = m_processes[it->tgid];
+        process.pid = it->tgid;
+        process.wakeups += wakeups;
+        process.timer_wakeups += timerWakeups;
+    }
+    if (errno != ENOENT) {
+        qCWarning(app) << "Failed to read wakeup counts:" << strerror(errno);
+        return false;
+    }
+
+    // threads evicted from the map, processes without any thread left
+    QSet<uint32_t> processes;
+    for (auto it = m_threads.begin(); it != m_threads.end();) {
+        if (seen.contains(it.key())) {
+            processes.insert(it->tgid);
+            ++it;
+        } else {
+            it = m_threads.erase(it);
+        }
+    }
+    records.reserve(size_t(processes.size()));
+    for (auto it = m_processes.begin(); it != m_processes.end();) {
+        if (processes.contains(it.key())) {
+            records.push_back(it.value());
+            ++it;
+        } else {
+            it = m_processes.erase(it);
+        }
+    }
+    return true;
+}
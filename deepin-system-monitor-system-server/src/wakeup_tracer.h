@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef WAKEUP_TRACER_H
+#define WAKEUP_TRACER_H
+
+#include "process_info_record.h"
+
+#include <QHash>
+
+#include <vector>
+
+/**
+ * @brief Wakeups of every thread, counted in the kernel
+ *
+ * sched_waking counts each wakeup by the woken thread. It runs in the waker's context, so a
+ * per cpu flag set between hrtimer_expire_entry & _exit tells the wakeups of an expiring
+ * hrtimer apart: sleeps, poll & epoll timeouts, timerfds & posix timers. Nothing reaches user
+ * space per wakeup, read() walks the thread map & sums the threads by process, their tgid is
+ * read once per thread from /proc.
+ */
+class WakeupTracer
+{
+public:
+    WakeupTracer() = default;
+    ~WakeupTracer();
+
+    /**
+     * @brief Load & attach the programs, counts start from zero
+     * @return false if the kernel lacks bpf, the sched & timer tracepoints or tracefs
+     */
+    bool start();
+    void stop();
+    inline bool isRunning() const { return m_wakingEvent >= 0; }
+
+    /**
+     * @brief Counts since start, one record per process woken
+     */
+    bool read(std::vector<wakeup_record_t> &records);
+
+    // threads counted at once, the least recently woken are evicted past it
+    static constexpr int kMaxThreads = 16384;
+
+private:
+    WakeupTracer(const WakeupTracer &) = delete;
+    WakeupTracer &operator=(const WakeupTracer &) = delete;
+
+    // counts of a thread at the last read, evicted threads start again from zero
+    struct thread_t {
+        uint32_t tgid;
+        uint64_t wakeups;
+        uint64_t timerWakeups;
+    };
+
+    int m_timerMap {-1};
+    int m_countMap {-1};
+    int m_wakingProg {-1};
+    int m_expireEntryProg {-1};
+    int m_expireExitProg {-1};
+    int m_wakingEvent {-1};
+    int m_expireEntryEvent {-1};
+    int m_expireExitEvent {-1};
+    QHash<uint32_t, thread_t> m_threads;
+    // threads summed, kept while any of them is in the map so counts never go back
+    QHash<uint32_t, wakeup_record_t> m_processes;
+};
+
+#endif // WAKEUP_TRACER_H
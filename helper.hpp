@@ -36,6 +36,10 @@ public:
     QString NotificationPath;
     QString NotificationInterface;
 
+    QString SessionManagerService;
+    QString SessionManagerPath;
+    QString SessionManagerInterface;
+
     QString MONITOR_SERVICE;
 
     QString DISPLAY_SERVICE;
@@ -92,6 +96,10 @@ public:
         NotificationPath = "/org/deepin/dde/Notification1";
         NotificationInterface = "org.deepin.dde.Notification1";
 
+        SessionManagerService = "org.deepin.dde.SessionManager1";
+        SessionManagerPath = "/org/deepin/dde/SessionManager1";
+        SessionManagerInterface = "org.deepin.dde.SessionManager1";
+
         MONITOR_SERVICE = "org.deepin.dde.XEventMonitor1";
 
         DISPLAY_SERVICE = "org.deepin.dde.Display1";
@@ -134,6 +142,10 @@ public:
         NotificationPath = "/com/deepin/dde/Notification";
         NotificationInterface = "com.deepin.dde.Notification";
 
+        SessionManagerService = "com.deepin.SessionManager";
+        SessionManagerPath = "/com/deepin/SessionManager";
+        SessionManagerInterface = "com.deepin.SessionManager";
+
         MONITOR_SERVICE = "com.deepin.api.XEventMonitor";
 
         DISPLAY_SERVICE = "com.deepin.daemon.Display";
@@ -0,0 +1,1053 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_INFO_RECORD_H
+#define PROCESS_INFO_RECORD_H
+
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Wire format of SystemMonitorSystemServer.getProcessInfoRecords, shared by the system server
+// & its clients. One byte array: a header followed by `count` fixed size records in host byte
+// order, both ends always run on the same host. Bump the version on any layout change, clients
+// fall back to getProcessInfoBatch on a version they do not know.
+
+#define PROCESS_INFO_RECORDS_MAGIC 0x52534d44   // "DMSR"
+#define PROCESS_INFO_RECORDS_VERSION 2
+#define PROCESS_INFO_COMM_LEN 16
+
+// sections of a record filled by the server
+enum ProcessInfoSection : uint32_t {
+    kProcessInfoStat = 1u << 0,
+    kProcessInfoIO = 1u << 1,
+    kProcessInfoStatm = 1u << 2,
+    kProcessInfoStatus = 1u << 3,
+    kProcessInfoSchedStat = 1u << 4,
+    kProcessInfoTraffic = 1u << 5,
+    // rates computed by the server against its previous batch, zero until a process was seen twice
+    kProcessInfoRates = 1u << 6,
+};
+
+struct process_info_records_header_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t count;
+    uint32_t reserved;
+};
+
+struct process_info_record_t {
+    // stat, cpu times are in jiffies
+    uint64_t utime;
+    uint64_t stime;
+    uint64_t cutime;
+    uint64_t cstime;
+    uint64_t start_time;
+    uint64_t vsize;
+    uint64_t rss;
+    // io
+    uint64_t read_bytes;
+    uint64_t write_bytes;
+    uint64_t cancelled_write_bytes;
+    // statm, in pages
+    uint64_t memory_size;
+    uint64_t memory_resident;
+    uint64_t memory_shared;
+    // schedstat, in nanoseconds
+    uint64_t rq_wait_time;
+    // traffic, accumulated since dkapture started
+    uint64_t net_rx_bytes;
+    uint64_t net_tx_bytes;
+
+    int32_t pid;
+    int32_t tgid;
+    int32_t ppid;
+    int32_t priority;
+    int32_t nice;
+    int32_t num_threads;
+    // status, real & effective ids
+    uint32_t uid;
+    uint32_t euid;
+    uint32_t gid;
+    uint32_t egid;
+    // ProcessInfoSection bits
+    uint32_t sections;
+
+    char comm[PROCESS_INFO_COMM_LEN];
+    char state;
+    uint8_t reserved[3];
+
+    // rates, cpu usage in percent of all cpus, disk & network in bytes per second
+    double cpu_usage;
+    double read_bps;
+    double write_bps;
+    double net_rx_bps;
+    double net_tx_bps;
+};
+
+static_assert(sizeof(process_info_records_header_t) == 16, "process info records header layout changed");
+static_assert(sizeof(process_info_record_t) == 232, "process info record layout changed");
+
+/**
+ * @brief Validate a process info records buffer
+ * @param buf Buffer returned by getProcessInfoRecords
+ * @param len Buffer length
+ * @param count Number of records
+ * @return First record, nullptr if the buffer is malformed or of another version
+ */
+inline const process_info_record_t *processInfoRecords(const void *buf, size_t len, uint32_t &count)
+{
+    count = 0;
+    if (!buf || len < sizeof(process_info_records_header_t))
+        return nullptr;
+
+    auto *hdr = static_cast<const process_info_records_header_t *>(buf);
+    if (hdr->magic != PROCESS_INFO_RECORDS_MAGIC
+            || hdr->version != PROCESS_INFO_RECORDS_VERSION
+            || hdr->record_size != sizeof(process_info_record_t)
+            || len != sizeof(*hdr) + size_t(hdr->count) * sizeof(process_info_record_t))
+        return nullptr;
+
+    auto *records = reinterpret_cast<const process_info_record_t *>(hdr + 1);
+    if (reinterpret_cast<uintptr_t>(records) % alignof(process_info_record_t))
+        return nullptr;
+
+    count = hdr->count;
+    return records;
+}
+
+// Shared memory snapshots of SystemMonitorSystemServer.openProcessInfoSnapshots. The server hands
+// out a sealed memfd: a header followed by two buffers of `capacity` records. Snapshots alternate
+// between the buffers, `seq` is odd while a snapshot is being written & snapshot n = seq / 2 is
+// found in buffer n & 1, so readers never block the writer & simply retry when overtaken.
+
+#define PROCESS_INFO_SHM_MAGIC 0x4d534d44   // "DMSM"
+#define PROCESS_INFO_SHM_VERSION 2
+#define PROCESS_INFO_SHM_CAPACITY 16384     // records per buffer
+
+struct process_info_shm_header_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t capacity;
+    // msecs between snapshots
+    uint32_t interval;
+    uint64_t seq;
+    uint32_t count[2];
+    // CLOCK_MONOTONIC nsecs a buffer was published
+    uint64_t timestamp[2];
+    uint8_t reserved[16];
+};
+
+static_assert(sizeof(process_info_shm_header_t) == 64, "process info shm header layout changed");
+
+inline size_t processInfoShmSize(uint32_t capacity)
+{
+    return sizeof(process_info_shm_header_t) + 2 * size_t(capacity) * sizeof(process_info_record_t);
+}
+
+inline process_info_record_t *processInfoShmBuffer(process_info_shm_header_t *hdr, uint64_t index)
+{
+    return reinterpret_cast<process_info_record_t *>(hdr + 1) + (index & 1) * hdr->capacity;
+}
+
+inline const process_info_record_t *processInfoShmBuffer(const process_info_shm_header_t *hdr, uint64_t index)
+{
+    return reinterpret_cast<const process_info_record_t *>(hdr + 1) + (index & 1) * hdr->capacity;
+}
+
+/**
+ * @brief Start writing the next snapshot, writer side
+ * @return Buffer to fill, holds hdr->capacity records
+ */
+inline process_info_record_t *beginProcessInfoSnapshot(process_info_shm_header_t *hdr)
+{
+    uint64_t seq = __atomic_load_n(&hdr->seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&hdr->seq, seq | 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return processInfoShmBuffer(hdr, seq / 2 + 1);
+}
+
+/**
+ * @brief Publish the snapshot started by beginProcessInfoSnapshot, writer side
+ */
+inline void publishProcessInfoSnapshot(process_info_shm_header_t *hdr, uint32_t count, uint64_t timestamp)
+{
+    uint64_t seq = __atomic_load_n(&hdr->seq, __ATOMIC_RELAXED);
+    uint64_t index = (seq / 2 + 1) & 1;
+    __atomic_store_n(&hdr->count[index], count, __ATOMIC_RELAXED);
+    __atomic_store_n(&hdr->timestamp[index], timestamp, __ATOMIC_RELAXED);
+    __atomic_store_n(&hdr->seq, (seq | 1) + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Copy the latest published snapshot, reader side
+ * @param hdr Mapped & validated segment
+ * @param records Receives the records, must hold hdr->capacity records
+ * @param count Number of records copied
+ * @param timestamp CLOCK_MONOTONIC nsecs the snapshot was published
+ * @return false if nothing is published yet or the writer kept overtaking the copy
+ */
+inline bool copyProcessInfoSnapshot(const process_info_shm_header_t *hdr, process_info_record_t *records,
+                                    uint32_t &count, uint64_t &timestamp)
+{
+    for (int retry = 0; retry < 4; ++retry) {
+        uint64_t n = __atomic_load_n(&hdr->seq, __ATOMIC_ACQUIRE) / 2;
+        if (n == 0)
+            break;
+
+        count = __atomic_load_n(&hdr->count[n & 1], __ATOMIC_RELAXED);
+        timestamp = __atomic_load_n(&hdr->timestamp[n & 1], __ATOMIC_RELAXED);
+        if (count > hdr->capacity)
+            break;
+        memcpy(records, processInfoShmBuffer(hdr, n), count * sizeof(process_info_record_t));
+
+        // buffer n & 1 is only rewritten once snapshot n + 2 is started
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&hdr->seq, __ATOMIC_RELAXED) < 2 * n + 3)
+            return true;
+    }
+    count = 0;
+    return false;
+}
+
+// Delta updates of SystemMonitorSystemServer.getProcessInfoDelta. A header followed by `count`
+// records created or changed since `generation` - 1 & `exited` pids. With the baseline flag set
+// the records replace everything the client holds, sent on the first call or whenever the
+// generation the client passed is not the one the server last sent it.
+
+#define PROCESS_INFO_DELTA_MAGIC 0x44534d44   // "DMSD"
+#define PROCESS_INFO_DELTA_VERSION 2
+
+enum ProcessInfoDeltaFlag : uint32_t {
+    kProcessInfoDeltaBaseline = 1u << 0,
+};
+
+struct process_info_delta_header_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint64_t generation;
+    // ProcessInfoDeltaFlag bits
+    uint32_t flags;
+    uint32_t count;
+    uint32_t exited;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(process_info_delta_header_t) == 32, "process info delta header layout changed");
+
+inline size_t processInfoDeltaSize(uint32_t count, uint32_t exited)
+{
+    return sizeof(process_info_delta_header_t) + size_t(count) * sizeof(process_info_record_t) + size_t(exited) * sizeof(int32_t);
+}
+
+/**
+ * @brief Validate a process info delta buffer
+ * @param buf Buffer returned by getProcessInfoDelta
+ * @param len Buffer length
+ * @param records Created or changed records
+ * @param exited Pids of exited processes
+ * @return Delta header, nullptr if the buffer is malformed or of another version
+ */
+inline const process_info_delta_header_t *processInfoDelta(const void *buf, size_t len,
+                                                           const process_info_record_t *&records,
+                                                           const int32_t *&exited)
+{
+    records = nullptr;
+    exited = nullptr;
+    if (!buf || len < sizeof(process_info_delta_header_t)
+            || reinterpret_cast<uintptr_t>(buf) % alignof(process_info_record_t))
+        return nullptr;
+
+    auto *hdr = static_cast<const process_info_delta_header_t *>(buf);
+    if (hdr->magic != PROCESS_INFO_DELTA_MAGIC
+            || hdr->version != PROCESS_INFO_DELTA_VERSION
+            || hdr->record_size != sizeof(process_info_record_t)
+            || len != processInfoDeltaSize(hdr->count, hdr->exited))
+        return nullptr;
+
+    records = reinterpret_cast<const process_info_record_t *>(hdr + 1);
+    exited = reinterpret_cast<const int32_t *>(records + hdr->count);
+    return hdr;
+}
+
+// Streams of `deepin-system-monitor --headless --agent`, read by the GUI to show another host, over
+// ssh stdio or a loopback tcp port. A stream is a sequence of frames, each a header followed by
+// `length` bytes of payload, compressed in the qCompress format when REMOTE_FRAME_COMPRESSED is set.
+// The stream starts with a hello, then every refresh sends a system frame & a processes frame.
+// A processes frame is a process info delta, baseline first, followed by the names of created
+// processes. Unlike the system server formats the two ends may run on different hosts, the hello
+// tells the byte order & record size, clients refuse a stream they can't read as is.
+
+#define REMOTE_AGENT_MAGIC 0x41534d44   // "DMSA"
+#define REMOTE_AGENT_VERSION 1
+#define REMOTE_AGENT_BYTE_ORDER 0x01020304
+#define REMOTE_AGENT_HOSTNAME_LEN 64
+// frames larger than this are refused, a baseline of PROCESS_INFO_SHM_CAPACITY records fits
+#define REMOTE_AGENT_MAX_FRAME (8 * 1024 * 1024)
+
+enum remote_frame_type_t : uint16_t {
+    REMOTE_FRAME_HELLO = 1, // remote_hello_t, followed by the CPUSet info stream
+    REMOTE_FRAME_SYSTEM = 2, // cpu jiffies, memory, disk & network figures as a QDataStream
+    REMOTE_FRAME_PROCESSES = 3, // process info delta, followed by the names of created processes
+};
+
+enum remote_frame_flag_t : uint16_t {
+    REMOTE_FRAME_COMPRESSED = 1u << 0,
+};
+
+struct remote_frame_header_t {
+    uint32_t magic;
+    uint16_t type; // remote_frame_type_t
+    uint16_t flags; // remote_frame_flag_t bits
+    uint32_t length; // payload bytes following the header
+    uint32_t reserved;
+};
+
+struct remote_hello_t {
+    uint32_t version;
+    uint32_t byte_order; // REMOTE_AGENT_BYTE_ORDER as written by the agent
+    uint32_t record_size;
+    uint32_t interval; // msecs between refreshes
+    char hostname[REMOTE_AGENT_HOSTNAME_LEN]; // nul terminated
+};
+
+static_assert(sizeof(remote_frame_header_t) == 16, "remote frame header layout changed");
+static_assert(sizeof(remote_hello_t) == 80, "remote hello layout changed");
+
+/**
+ * @brief Validate the hello of a remote agent stream
+ * @return nullptr if the stream comes from another version or byte order
+ */
+inline const remote_hello_t *remoteHello(const void *buf, size_t len)
+{
+    if (!buf || len < sizeof(remote_hello_t))
+        return nullptr;
+    remote_hello_t hello;
+    memcpy(&hello, buf, sizeof(hello));
+    if (hello.version != REMOTE_AGENT_VERSION
+            || hello.byte_order != REMOTE_AGENT_BYTE_ORDER
+            || hello.record_size != sizeof(process_info_record_t)
+            || !memchr(hello.hostname, 0, sizeof(hello.hostname)))
+        return nullptr;
+    return static_cast<const remote_hello_t *>(buf);
+}
+
+// Per process file activity of SystemMonitorSystemServer.getFileActivity, aggregated by the
+// server from DKapture file events. A header followed by `count` records of the busiest files of
+// the watched process, sorted by bytes, totals are accumulated since openFileActivity.
+
+#define FILE_ACTIVITY_MAGIC 0x41464d44   // "DMFA"
+#define FILE_ACTIVITY_VERSION 1
+#define FILE_ACTIVITY_PATH_LEN 256
+
+struct file_activity_header_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t count;
+    int32_t pid;
+    // events aggregated & events dropped once the per process file limit was reached
+    uint64_t events;
+    uint64_t dropped;
+};
+
+struct file_activity_record_t {
+    uint64_t ino;
+    uint64_t read_bytes;
+    uint64_t write_bytes;
+    uint64_t reads;
+    uint64_t writes;
+    // open, close, stat, mmap, lock, seek & other calls
+    uint64_t other_ops;
+    // empty if the file was not open any more when resolved, nul terminated otherwise
+    char path[FILE_ACTIVITY_PATH_LEN];
+};
+
+static_assert(sizeof(file_activity_header_t) == 32, "file activity header layout changed");
+static_assert(sizeof(file_activity_record_t) == 304, "file activity record layout changed");
+
+/**
+ * @brief Validate a file activity buffer
+ * @param buf Buffer returned by getFileActivity
+ * @param len Buffer length
+ * @param records Busiest files first
+ * @return Header, nullptr if the buffer is malformed or of another version
+ */
+inline const file_activity_header_t *fileActivityRecords(const void *buf, size_t len,
+                                                         const file_activity_record_t *&records)
+{
+    records = nullptr;
+    if (!buf || len < sizeof(file_activity_header_t)
+            || reinterpret_cast<uintptr_t>(buf) % alignof(file_activity_record_t))
+        return nullptr;
+
+    auto *hdr = static_cast<const file_activity_header_t *>(buf);
+    if (hdr->magic != FILE_ACTIVITY_MAGIC
+            || hdr->version != FILE_ACTIVITY_VERSION
+            || hdr->record_size != sizeof(file_activity_record_t)
+            || len != sizeof(*hdr) + size_t(hdr->count) * sizeof(file_activity_record_t))
+        return nullptr;
+
+    records = reinterpret_cast<const file_activity_record_t *>(hdr + 1);
+    return hdr;
+}
+
+// System wide interrupt load of SystemMonitorSystemServer.getIrqStats, aggregated by the server
+// from DKapture irq & softirq events. A header followed by `count` records, one per hard irq
+// line & softirq vector seen, totals are accumulated since openIrqStats. Events carry no cpu,
+// per core irq time comes from /proc/stat.
+
+#define IRQ_STATS_MAGIC 0x51494d44   // "DMIQ"
+#define IRQ_STATS_VERSION 1
+#define IRQ_STATS_NAME_LEN 48
+
+enum irq_stat_type_t : uint32_t {
+    IRQ_STAT_HARD = 0,
+    IRQ_STAT_SOFT = 1,
+};
+
+struct irq_stats_header_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t count;
+    uint32_t reserved;
+    // events aggregated, CLOCK_MONOTONIC time of the snapshot in ns
+    uint64_t events;
+    uint64_t timestamp;
+};
+
+struct irq_stat_record_t {
+    uint32_t type; // irq_stat_type_t
+    int32_t vec; // irq number or softirq vector
+    uint64_t count;
+    uint64_t time_ns; // time spent in the handler
+    // action name of hard irqs, vector name of softirqs, nul terminated
+    char name[IRQ_STATS_NAME_LEN];
+};
+
+static_assert(sizeof(irq_stats_header_t) == 32, "irq stats header layout changed");
+static_assert(sizeof(irq_stat_record_t) == 72, "irq stat record layout changed");
+
+/**
+ * @brief Validate an irq stats buffer
+ * @param buf Buffer returned by getIrqStats
+ * @param len Buffer length
+ * @param records Irq lines & softirq vectors, in no particular order
+ * @return Header, nullptr if the buffer is malformed or of another version
+ */
+inline const irq_stats_header_t *irqStatRecords(const void *buf, size_t len,
+                                                const irq_stat_record_t *&records)
+{
+    records = nullptr;
+    if (!buf || len < sizeof(irq_stats_header_t)
+            || reinterpret_cast<uintptr_t>(buf) % alignof(irq_stat_record_t))
+        return nullptr;
+
+    auto *hdr = static_cast<const irq_stats_header_t *>(buf);
+    if (hdr->magic != IRQ_STATS_MAGIC
+            || hdr->version != IRQ_STATS_VERSION
+            || hdr->record_size != sizeof(irq_stat_record_t)
+            || len != sizeof(*hdr) + size_t(hdr->count) * sizeof(irq_stat_record_t))
+        return nullptr;
+
+    records = reinterpret_cast<const irq_stat_record_t *>(hdr + 1);
+    return hdr;
+}
+
+// Block request latency of SystemMonitorSystemServer.getBlockLatency, from issue to completion
+// of every request, counted per disk & direction in log2 buckets by a tracepoint program the
+// server loads, so tracing costs the same whatever the IOPS. A header followed by `count`
+// records, one per disk & direction seen, counts are accumulated since openBlockLatency.
+
+#define BLOCK_LATENCY_MAGIC 0x4b4c4244   // "DBLK"
+#define BLOCK_LATENCY_VERSION 1
+// bucket b counts latencies of [2^b, 2^(b+1)) us, the first also below 1us, the last all above
+#define BLOCK_LATENCY_BUCKETS 24
+
+enum block_latency_dir_t : uint32_t {
+    BLOCK_LATENCY_READ = 0,
+    BLOCK_LATENCY_WRITE = 1,
+};
+
+struct block_latency_header_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t count;
+    uint32_t reserved;
+    // CLOCK_MONOTONIC time of the snapshot in ns
+    uint64_t timestamp;
+};
+
+struct block_latency_record_t {
+    uint32_t dev; // disk, kernel dev_t: major << 20 | minor
+    uint32_t dir; // block_latency_dir_t
+    uint64_t buckets[BLOCK_LATENCY_BUCKETS]; // completed requests
+};
+
+static_assert(sizeof(block_latency_header_t) == 24, "block latency header layout changed");
+static_assert(sizeof(block_latency_record_t) == 200, "block latency record layout changed");
+
+/**
+ * @brief Validate a block latency buffer
+ * @param buf Buffer returned by getBlockLatency
+ * @param len Buffer length
+ * @param records Disks & directions, in no particular order
+ * @return Header, nullptr if the buffer is malformed or of another version
+ */
+inline const block_latency_header_t *blockLatencyRecords(const void *buf, size_t len,
+                                                         const block_latency_record_t *&records)
+{
+    records = nullptr;
+    if (!buf || len < sizeof(block_latency_header_t)
+            || reinterpret_cast<uintptr_t>(buf) % alignof(block_latency_record_t))
+        return nullptr;
+
+    auto *hdr = static_cast<const block_latency_header_t *>(buf);
+    if (hdr->magic != BLOCK_LATENCY_MAGIC
+            || hdr->version != BLOCK_LATENCY_VERSION
+            || hdr->record_size != sizeof(block_latency_record_t)
+            || len != sizeof(*hdr) + size_t(hdr->count) * sizeof(block_latency_record_t))
+        return nullptr;
+
+    records = reinterpret_cast<const block_latency_record_t *>(hdr + 1);
+    return hdr;
+}
+
+// Wakeups of SystemMonitorSystemServer.getWakeups, every sched_waking of a thread counted in
+// the kernel by a tracepoint program the server loads, those from an expiring hrtimer counted
+// again as timer wakeups, so tracing costs the same however often tasks wake. Threads are summed
+// per process by the server. A header followed by `count` records, one per process woken, counts
+// are accumulated since openWakeups.
+
+#define WAKEUPS_MAGIC 0x4b415744   // "DWAK"
+#define WAKEUPS_VERSION 1
+
+struct wakeups_header_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t count;
+    uint32_t reserved;
+    // CLOCK_MONOTONIC time of the snapshot in ns
+    uint64_t timestamp;
+};
+
+struct wakeup_record_t {
+    uint32_t pid; // tgid
+    uint32_t reserved;
+    uint64_t wakeups; // all wakeups of its threads
+    uint64_t timer_wakeups; // of those, woken by an expiring timer, e.g. sleeps, poll timeouts, timerfds
+};
+
+static_assert(sizeof(wakeups_header_t) == 24, "wakeups header layout changed");
+static_assert(sizeof(wakeup_record_t) == 24, "wakeup record layout changed");
+
+/**
+ * @brief Validate a wakeups buffer
+ * @param buf Buffer returned by getWakeups
+ * @param len Buffer length
+ * @param records Processes, in no particular order
+ * @return Header, nullptr if the buffer is malformed or of another version
+ */
+inline const wakeups_header_t *wakeupRecords(const void *buf, size_t len, const wakeup_record_t *&records)
+{
+    records = nullptr;
+    if (!buf || len < sizeof(wakeups_header_t)
+            || reinterpret_cast<uintptr_t>(buf) % alignof(wakeup_record_t))
+        return nullptr;
+
+    auto *hdr = static_cast<const wakeups_header_t *>(buf);
+    if (hdr->magic != WAKEUPS_MAGIC
+            || hdr->version != WAKEUPS_VERSION
+            || hdr->record_size != sizeof(wakeup_record_t)
+            || len != sizeof(*hdr) + size_t(hdr->count) * sizeof(wakeup_record_t))
+        return nullptr;
+
+    records = reinterpret_cast<const wakeup_record_t *>(hdr + 1);
+    return hdr;
+}
+
+// Disk health of SystemMonitorSystemServer.getDiskHealth, SMART / NVMe health logs the server
+// reads on a worker thread every few minutes, see DISK_HEALTH_INTERVAL. A header followed by
+// `count` records, one per disk, the last values read are kept while a disk sleeps.
+
+#define DISK_HEALTH_MAGIC 0x4c484444   // "DDHL"
+#define DISK_HEALTH_VERSION 1
+#define DISK_HEALTH_NAME_LEN 32
+// ms between two reads of a disk
+#define DISK_HEALTH_INTERVAL (5 * 60 * 1000)
+// temperature not reported
+#define DISK_HEALTH_NO_TEMPERATURE INT32_MIN
+// counter not reported, e.g. percent used of ATA disks
+#define DISK_HEALTH_UNKNOWN UINT32_MAX
+
+enum disk_health_kind_t : uint32_t {
+    DISK_HEALTH_NVME = 0,
+    DISK_HEALTH_ATA = 1,
+};
+
+enum disk_health_state_t : uint32_t {
+    DISK_HEALTH_PENDING = 0,     // not read yet
+    DISK_HEALTH_OK = 1,
+    DISK_HEALTH_WARNING = 2,     // media errors, spare or temperature warnings
+    DISK_HEALTH_FAILING = 3,     // reliability degraded, read only or a prefail attribute past threshold
+    DISK_HEALTH_SLEEPING = 4,    // in standby or runtime suspended, not woken to be read
+    DISK_HEALTH_UNSUPPORTED = 5, // no SMART / NVMe log, e.g. behind a USB bridge
+    DISK_HEALTH_ERROR = 6,       // the last read failed or timed out
+};
+
+struct disk_health_header_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t count;
+    uint32_t interval; // ms, DISK_HEALTH_INTERVAL of the server
+    // CLOCK_MONOTONIC time of the snapshot in ns
+    uint64_t timestamp;
+};
+
+struct disk_health_record_t {
+    char name[DISK_HEALTH_NAME_LEN]; // e.g. nvme0n1, sda
+    uint32_t kind; // disk_health_kind_t
+    uint32_t state; // disk_health_state_t
+    int32_t temperature; // Celsius, DISK_HEALTH_NO_TEMPERATURE if not reported
+    uint32_t critical_warning; // NVMe critical warning bits, ATA id of the failing attribute
+    uint32_t percent_used; // NVMe endurance used, may pass 100
+    uint32_t available_spare; // NVMe, percent
+    uint32_t warning_temp_minutes; // NVMe, time spent above the warning temperature
+    uint32_t critical_temp_minutes; // NVMe, time spent above the critical temperature
+    uint64_t power_on_hours;
+    uint64_t media_errors; // NVMe media errors, ATA reallocated + pending + uncorrectable sectors
+    uint64_t unsafe_shutdowns;
+    // CLOCK_MONOTONIC time of the last successful read in ns, 0 if never read
+    uint64_t sampled_at;
+};
+
+static_assert(sizeof(disk_health_header_t) == 24, "disk health header layout changed");
+static_assert(sizeof(disk_health_record_t) == 96, "disk health record layout changed");
+
+/**
+ * @brief Validate a disk health buffer
+ * @param buf Buffer returned by getDiskHealth
+ * @param len Buffer length
+ * @param records Disks, sorted by name
+ * @return Header, nullptr if the buffer is malformed or of another version
+ */
+inline const disk_health_header_t *diskHealthRecords(const void *buf, size_t len,
+                                                     const disk_health_record_t *&records)
+{
+    records = nullptr;
+    if (!buf || len < sizeof(disk_health_header_t)
+            || reinterpret_cast<uintptr_t>(buf) % alignof(disk_health_record_t))
+        return nullptr;
+
+    auto *hdr = static_cast<const disk_health_header_t *>(buf);
+    if (hdr->magic != DISK_HEALTH_MAGIC
+            || hdr->version != DISK_HEALTH_VERSION
+            || hdr->record_size != sizeof(disk_health_record_t)
+            || len != sizeof(*hdr) + size_t(hdr->count) * sizeof(disk_health_record_t))
+        return nullptr;
+
+    records = reinterpret_cast<const disk_health_record_t *>(hdr + 1);
+    return hdr;
+}
+
+// RAPL energy counters of SystemMonitorSystemServer.getEnergyCounters, for clients that can't
+// read energy_uj themselves, root only since linux 5.10. Read at most every
+// ENERGY_COUNTERS_MIN_INTERVAL, faster callers get the cached values. A header followed by
+// `count` records, one per package & core zone of powercap.
+
+#define ENERGY_COUNTERS_MAGIC 0x474e4544   // "DENG"
+#define ENERGY_COUNTERS_VERSION 1
+#define ENERGY_ZONE_NAME_LEN 24
+// ms, coarse on purpose, fine grained energy readings leak what other processes compute
+#define ENERGY_COUNTERS_MIN_INTERVAL 1000
+
+struct energy_counters_header_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t count;
+    uint32_t reserved;
+    // CLOCK_MONOTONIC time the counters were read in ns
+    uint64_t timestamp;
+};
+
+struct energy_counter_record_t {
+    char name[ENERGY_ZONE_NAME_LEN]; // zone directory, e.g. intel-rapl:0
+    uint32_t core; // 1 for the core subzone of a package, 0 for the package
+    uint32_t reserved;
+    uint64_t energy; // energy_uj
+    uint64_t range; // max_energy_range_uj, energy wraps to 0 past it
+};
+
+static_assert(sizeof(energy_counters_header_t) == 24, "energy counters header layout changed");
+static_assert(sizeof(energy_counter_record_t) == 48, "energy counter record layout changed");
+
+/**
+ * @brief Validate an energy counters buffer
+ * @param buf Buffer returned by getEnergyCounters
+ * @param len Buffer length
+ * @param records Zones
+ * @return Header, nullptr if the buffer is malformed or of another version
+ */
+inline const energy_counters_header_t *energyCounterRecords(const void *buf, size_t len,
+                                                            const energy_counter_record_t *&records)
+{
+    records = nullptr;
+    if (!buf || len < sizeof(energy_counters_header_t)
+            || reinterpret_cast<uintptr_t>(buf) % alignof(energy_counter_record_t))
+        return nullptr;
+
+    auto *hdr = static_cast<const energy_counters_header_t *>(buf);
+    if (hdr->magic != ENERGY_COUNTERS_MAGIC
+            || hdr->version != ENERGY_COUNTERS_VERSION
+            || hdr->record_size != sizeof(energy_counter_record_t)
+            || len != sizeof(*hdr) + size_t(hdr->count) * sizeof(energy_counter_record_t))
+        return nullptr;
+
+    records = reinterpret_cast<const energy_counter_record_t *>(hdr + 1);
+    return hdr;
+}
+
+// Kernel memory leak scan of SystemMonitorSystemServer.getMemleakScan, aggregated by the server
+// from DKapture kmemleak reports. The scan runs in windows, allocations of a window which are
+// still not freed when it ends are reported per allocation stack & summed over windows, so the
+// result grows while the scan runs. A header followed by `count` records of the largest leak
+// sites, sorted by bytes.
+
+#define MEMLEAK_SCAN_MAGIC 0x4b4c4d44   // "DMLK"
+#define MEMLEAK_SCAN_VERSION 1
+#define MEMLEAK_STACK_LEN 512
+
+enum memleak_scan_state_t : uint32_t {
+    MEMLEAK_SCAN_RUNNING = 0,
+    MEMLEAK_SCAN_FINISHED = 1, // maximum scan duration reached
+    MEMLEAK_SCAN_CANCELLED = 2,
+    MEMLEAK_SCAN_FAILED = 3,
+};
+
+struct memleak_scan_header_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t count;
+    int32_t pid; // scanned process, 0 for all processes
+    uint32_t state; // memleak_scan_state_t
+    uint32_t windows; // windows completed
+    // bumped each time a window completes, results only change then
+    uint64_t generation;
+    // totals of all leak sites, including the ones not returned
+    uint64_t bytes;
+    uint64_t allocations;
+};
+
+struct memleak_site_record_t {
+    uint64_t bytes;
+    uint64_t allocations;
+    uint32_t windows; // windows the site leaked in
+    uint32_t depth; // frames of the stack
+    // symbol+offset of each frame innermost first, one per line, nul terminated, may be truncated
+    char stack[MEMLEAK_STACK_LEN];
+};
+
+static_assert(sizeof(memleak_scan_header_t) == 48, "memleak scan header layout changed");
+static_assert(sizeof(memleak_site_record_t) == 536, "memleak site record layout changed");
+
+/**
+ * @brief Validate a memleak scan buffer
+ * @param buf Buffer returned by getMemleakScan
+ * @param len Buffer length
+ * @param records Largest leak sites first
+ * @return Header, nullptr if the buffer is malformed or of another version
+ */
+inline const memleak_scan_header_t *memleakScanRecords(const void *buf, size_t len,
+                                                       const memleak_site_record_t *&records)
+{
+    records = nullptr;
+    if (!buf || len < sizeof(memleak_scan_header_t)
+            || reinterpret_cast<uintptr_t>(buf) % alignof(memleak_site_record_t))
+        return nullptr;
+
+    auto *hdr = static_cast<const memleak_scan_header_t *>(buf);
+    if (hdr->magic != MEMLEAK_SCAN_MAGIC
+            || hdr->version != MEMLEAK_SCAN_VERSION
+            || hdr->record_size != sizeof(memleak_site_record_t)
+            || len != sizeof(*hdr) + size_t(hdr->count) * sizeof(memleak_site_record_t))
+        return nullptr;
+
+    records = reinterpret_cast<const memleak_site_record_t *>(hdr + 1);
+    return hdr;
+}
+
+// Kernel stacks of SystemMonitorSystemServer.getKernelStacks(pids), for telling what processes stuck
+// in uninterruptible sleep wait on, /proc/[pid]/stack is root only. Only processes in D state when
+// read are returned, a running task's stack changes under the reader & tells nothing. A header
+// followed by `count` records, in the order of pids.
+
+#define KERNEL_STACKS_MAGIC 0x4b545344   // "DSTK"
+#define KERNEL_STACKS_VERSION 1
+#define KERNEL_STACKS_MAX_PIDS 32
+#define KERNEL_STACK_LEN 512
+
+struct kernel_stacks_header_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t count;
+    uint32_t reserved;
+};
+
+struct kernel_stack_record_t {
+    int32_t pid;
+    uint32_t depth; // frames of the stack
+    // function of each frame innermost first, one per line, offsets stripped, nul terminated, may be truncated
+    char stack[KERNEL_STACK_LEN];
+};
+
+static_assert(sizeof(kernel_stacks_header_t) == 16, "kernel stacks header layout changed");
+static_assert(sizeof(kernel_stack_record_t) == 520, "kernel stack record layout changed");
+
+/**
+ * @brief Validate a kernel stacks buffer
+ * @param buf Buffer returned by getKernelStacks
+ * @param len Buffer length
+ * @param records Processes found in D state
+ * @return Header, nullptr if the buffer is malformed or of another version
+ */
+inline const kernel_stacks_header_t *kernelStackRecords(const void *buf, size_t len,
+                                                        const kernel_stack_record_t *&records)
+{
+    records = nullptr;
+    if (!buf || len < sizeof(kernel_stacks_header_t)
+            || reinterpret_cast<uintptr_t>(buf) % alignof(kernel_stack_record_t))
+        return nullptr;
+
+    auto *hdr = static_cast<const kernel_stacks_header_t *>(buf);
+    if (hdr->magic != KERNEL_STACKS_MAGIC
+            || hdr->version != KERNEL_STACKS_VERSION
+            || hdr->record_size != sizeof(kernel_stack_record_t)
+            || hdr->count > KERNEL_STACKS_MAX_PIDS
+            || len != sizeof(*hdr) + size_t(hdr->count) * sizeof(kernel_stack_record_t))
+        return nullptr;
+
+    records = reinterpret_cast<const kernel_stack_record_t *>(hdr + 1);
+    return hdr;
+}
+
+// CPU profile of SystemMonitorSystemServer.getCpuProfile, sampled by the server through perf events
+// on each thread of the profiled process for a fixed time. Samples are counted per call chain, user
+// & kernel frames together, the kernel frames are resolved by the server from kallsyms & the user
+// frames left to the client with the executable mappings of the process. While the profile is
+// running only the header is returned, once it ends the header is followed by `stacks` stack
+// records, most sampled first, `symbols` symbol records sorted by address & `mappings` mapping
+// records.
+
+#define CPU_PROFILE_MAGIC 0x46525044   // "DPRF"
+#define CPU_PROFILE_VERSION 1
+#define CPU_PROFILE_MAX_DEPTH 64
+#define CPU_PROFILE_MAX_STACKS 2048
+#define CPU_PROFILE_MAX_SYMBOLS 4096
+#define CPU_PROFILE_MAX_MAPPINGS 512
+#define CPU_PROFILE_SYMBOL_LEN 56
+#define CPU_PROFILE_PATH_LEN 232
+// sampling frequency (Hz) & duration (ms) the server accepts
+#define CPU_PROFILE_MIN_FREQUENCY 10
+#define CPU_PROFILE_MAX_FREQUENCY 999
+#define CPU_PROFILE_MAX_DURATION 60000
+
+enum cpu_profile_state_t : uint32_t {
+    CPU_PROFILE_RUNNING = 0,
+    CPU_PROFILE_FINISHED = 1, // duration reached or the process exited
+    CPU_PROFILE_CANCELLED = 2,
+    CPU_PROFILE_FAILED = 3,
+};
+
+struct cpu_profile_header_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t stack_size; // sizeof(cpu_profile_stack_t)
+    uint16_t symbol_size; // sizeof(cpu_profile_symbol_t)
+    uint16_t mapping_size; // sizeof(cpu_profile_mapping_t)
+    int32_t pid;
+    uint32_t state; // cpu_profile_state_t
+    uint32_t frequency; // Hz
+    uint32_t stacks;
+    uint32_t symbols;
+    uint32_t mappings;
+    uint32_t duration; // requested, ms
+    uint32_t elapsed; // sampled so far, ms
+    uint32_t threads; // threads sampled
+    uint64_t samples; // all samples, including the lost ones
+    // samples not counted, ring buffer overruns & call chains past CPU_PROFILE_MAX_STACKS
+    uint64_t lost;
+};
+
+struct cpu_profile_stack_t {
+    uint64_t count; // samples
+    uint32_t depth; // frames of ips
+    uint32_t kernel_depth; // kernel frames, the first of ips
+    // innermost first, kernel frames rewritten to the start of their function, user frames are
+    // the sampled ip & return addresses
+    uint64_t ips[CPU_PROFILE_MAX_DEPTH];
+};
+
+struct cpu_profile_symbol_t {
+    uint64_t addr; // start of the kernel function, as in the stacks
+    char name[CPU_PROFILE_SYMBOL_LEN]; // "name [module]" for modules, nul terminated, may be truncated
+};
+
+struct cpu_profile_mapping_t {
+    uint64_t start;
+    uint64_t end;
+    uint64_t offset; // file offset of start
+    char path[CPU_PROFILE_PATH_LEN]; // nul terminated, may be truncated
+};
+
+static_assert(sizeof(cpu_profile_header_t) == 64, "cpu profile header layout changed");
+static_assert(sizeof(cpu_profile_stack_t) == 528, "cpu profile stack layout changed");
+static_assert(sizeof(cpu_profile_symbol_t) == 64, "cpu profile symbol layout changed");
+static_assert(sizeof(cpu_profile_mapping_t) == 256, "cpu profile mapping layout changed");
+
+/**
+ * @brief Validate a cpu profile buffer
+ * @param buf Buffer returned by getCpuProfile
+ * @param len Buffer length
+ * @param stacks Most sampled first, none while running
+ * @param symbols Kernel symbols by address
+ * @param mappings Executable mappings of the process
+ * @return Header, nullptr if the buffer is malformed or of another version
+ */
+inline const cpu_profile_header_t *cpuProfileRecords(const void *buf, size_t len,
+                                                     const cpu_profile_stack_t *&stacks,
+                                                     const cpu_profile_symbol_t *&symbols,
+                                                     const cpu_profile_mapping_t *&mappings)
+{
+    stacks = nullptr;
+    symbols = nullptr;
+    mappings = nullptr;
+    if (!buf || len < sizeof(cpu_profile_header_t)
+            || reinterpret_cast<uintptr_t>(buf) % alignof(cpu_profile_stack_t))
+        return nullptr;
+
+    auto *hdr = static_cast<const cpu_profile_header_t *>(buf);
+    if (hdr->magic != CPU_PROFILE_MAGIC
+            || hdr->version != CPU_PROFILE_VERSION
+            || hdr->stack_size != sizeof(cpu_profile_stack_t)
+            || hdr->symbol_size != sizeof(cpu_profile_symbol_t)
+            || hdr->mapping_size != sizeof(cpu_profile_mapping_t)
+            || hdr->stacks > CPU_PROFILE_MAX_STACKS
+            || hdr->symbols > CPU_PROFILE_MAX_SYMBOLS
+            || hdr->mappings > CPU_PROFILE_MAX_MAPPINGS
+            || len != sizeof(*hdr) + size_t(hdr->stacks) * sizeof(cpu_profile_stack_t)
+                    + size_t(hdr->symbols) * sizeof(cpu_profile_symbol_t)
+                    + size_t(hdr->mappings) * sizeof(cpu_profile_mapping_t))
+        return nullptr;
+
+    auto *first = reinterpret_cast<const cpu_profile_stack_t *>(hdr + 1);
+    for (uint32_t i = 0; i < hdr->stacks; ++i) {
+        if (first[i].depth > CPU_PROFILE_MAX_DEPTH || first[i].kernel_depth > first[i].depth)
+            return nullptr;
+    }
+    stacks = first;
+    symbols = reinterpret_cast<const cpu_profile_symbol_t *>(first + hdr->stacks);
+    mappings = reinterpret_cast<const cpu_profile_mapping_t *>(symbols + hdr->symbols);
+    return hdr;
+}
+
+// Batch process control, SystemMonitorSystemServer.controlProcesses(pids, action, value). The reply
+// is one errno per pid in the order of pids, 0 for the ones that succeeded.
+#define PROCESS_CONTROL_MAX_PIDS 4096
+
+enum process_control_action_t : int32_t {
+    PROCESS_CONTROL_SIGNAL = 0, // value: SIGTERM, SIGKILL, SIGSTOP or SIGCONT
+    PROCESS_CONTROL_RENICE = 1, // value: nice, -20 ~ 19
+    PROCESS_CONTROL_IONICE = 2, // value: ioprio, class << 13 | data, as ioprio_set(2) takes it
+    // value: cpus in the mask, which goes as an argument of its own, see setProcessesAffinity
+    PROCESS_CONTROL_AFFINITY = 3,
+};
+
+#define PROCESS_CONTROL_IOPRIO_CLASS_SHIFT 13
+
+// SystemMonitorSystemServer.setProcessesAffinity(pids, cpus) sets every thread of each pid to cpus,
+// a cpu_set_t bit mask as sched_setaffinity(2) takes it, bit n for cpu n, at most 8192 cpus.
+#define PROCESS_AFFINITY_MAX_BYTES 1024
+
+/**
+ * @brief Cpus in an affinity mask, -1 if the server refuses it
+ */
+inline int processAffinityCpus(const void *cpus, size_t len)
+{
+    if (!cpus || len == 0 || len > PROCESS_AFFINITY_MAX_BYTES)
+        return -1;
+    int count = 0;
+    const uint8_t *bytes = static_cast<const uint8_t *>(cpus);
+    for (size_t i = 0; i < len; ++i)
+        count += __builtin_popcount(bytes[i]);
+    return count > 0 ? count : -1;
+}
+
+/**
+ * @brief Whether the system server carries out \a action with \a value
+ */
+inline bool processControlValid(int32_t action, int32_t value)
+{
+    switch (action) {
+    case PROCESS_CONTROL_SIGNAL:
+        return value == SIGTERM || value == SIGKILL || value == SIGSTOP || value == SIGCONT;
+    case PROCESS_CONTROL_RENICE:
+        return value >= -20 && value <= 19;
+    case PROCESS_CONTROL_AFFINITY:
+        return value > 0 && value <= PROCESS_AFFINITY_MAX_BYTES * 8;
+    case PROCESS_CONTROL_IONICE: {
+        // none, realtime, best effort & idle classes, 8 levels each, none & idle have no level
+        const int32_t ioclass = value >> PROCESS_CONTROL_IOPRIO_CLASS_SHIFT;
+        const int32_t data = value & ((1 << PROCESS_CONTROL_IOPRIO_CLASS_SHIFT) - 1);
+        if (value < 0 || ioclass > 3 || data > 7)
+            return false;
+        return (ioclass != 0 && ioclass != 3) || data == 0;
+    }
+    default:
+        return false;
+    }
+}
+
+// Runtime resource limits as the systemd unit properties CPUQuotaPerSecUSec, MemoryHigh & IOWeight.
+// SystemMonitorSystemServer.limitProcess(pid, cpu_quota, memory_high, io_weight) moves the process into
+// a transient scope of its own, limitService(unit, ...) sets them on the running service. The reply is
+// an error message, empty on success. Limits last until the unit stops or the system reboots.
+#define RESOURCE_LIMIT_NONE UINT64_MAX
+// cpu time per second in us, 1% of a cpu at least
+#define RESOURCE_LIMIT_MIN_CPU_QUOTA 10000ULL
+// bytes, less would throttle most processes to a standstill
+#define RESOURCE_LIMIT_MIN_MEMORY_HIGH (16ULL << 20)
+#define RESOURCE_LIMIT_MAX_IO_WEIGHT 10000ULL
+// scope of a process limited by limitProcess, the pid follows
+#define RESOURCE_LIMIT_SCOPE_PREFIX "deepin-system-monitor-limit-"
+
+struct resource_limits_t {
+    uint64_t cpu_quota; // us per s, RESOURCE_LIMIT_NONE for no limit, as the others
+    uint64_t memory_high; // bytes, reclaimed & throttled above it, never killed
+    uint64_t io_weight; // 1 ~ 10000, 100 is the default
+};
+
+/**
+ * @brief Whether the system server applies \a limits
+ */
+inline bool resourceLimitsValid(const resource_limits_t &limits)
+{
+    if (limits.cpu_quota != RESOURCE_LIMIT_NONE && limits.cpu_quota < RESOURCE_LIMIT_MIN_CPU_QUOTA)
+        return false;
+    if (limits.memory_high != RESOURCE_LIMIT_NONE && limits.memory_high < RESOURCE_LIMIT_MIN_MEMORY_HIGH)
+        return false;
+    return limits.io_weight == RESOURCE_LIMIT_NONE || (limits.io_weight >= 1 && limits.io_weight <= RESOURCE_LIMIT_MAX_IO_WEIGHT);
+}
+
+#endif // PROCESS_INFO_RECORD_H
@@ -0,0 +1,27 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Counts heap allocations of the benchmark process. Linking alloc_counter.cpp interposes
+// malloc & friends, operator new included since libstdc++ allocates through malloc.
+
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <stdint.h>
+
+namespace bench {
+
+struct AllocStats {
+    uint64_t count {0};
+    uint64_t bytes {0}; // requested, frees are not subtracted
+};
+
+/**
+ * @brief Allocations since process start, of all threads
+ */
+AllocStats allocStats();
+
+} // namespace bench
+
+#endif // ALLOC_COUNTER_H
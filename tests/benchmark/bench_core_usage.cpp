@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Compare per core usage computation of the field array kernel against the
+// per cpu struct path (sum & diff each cpu_stat_t) it replaced, both producing
+// total/idle jiffies plus busy/user/sys/iowait percent of every core.
+
+#include "common/core_usage.h"
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <stdio.h>
+
+using namespace common::usage;
+
+namespace {
+
+struct CpuStat {
+    unsigned long long user, nice, sys, idle, iowait, hardirq, softirq, steal, guest, guest_nice;
+};
+
+struct CpuUsage {
+    unsigned long long total, idle;
+};
+
+struct CpuPercent {
+    CpuUsage usage;
+    double busy, user, sys, iowait;
+};
+
+const int kRounds = 20000;
+
+void fill(CoreJiffies &prev, CoreJiffies &cur, std::vector<CpuStat> &aosPrev, std::vector<CpuStat> &aosCur, int n)
+{
+    std::mt19937_64 rng(n);
+    std::uniform_int_distribution<unsigned long long> base(1000000, 100000000);
+    std::uniform_int_distribution<unsigned long long> step(0, 200);
+
+    prev.resize(n);
+    cur.resize(n);
+    aosPrev.resize(n);
+    aosCur.resize(n);
+    std::vector<unsigned long long> *fields[] = {&prev.user, &prev.nice, &prev.sys, &prev.idle, &prev.iowait,
+                                                 &prev.hardirq, &prev.softirq, &prev.steal};
+    std::vector<unsigned long long> *curFields[] = {&cur.user, &cur.nice, &cur.sys, &cur.idle, &cur.iowait,
+                                                    &cur.hardirq, &cur.softirq, &cur.steal};
+    for (int i = 0; i < n; ++i) {
+        for (int f = 0; f < 8; ++f) {
+            (*fields[f])[size_t(i)] = base(rng);
+            (*curFields[f])[size_t(i)] = (*fields[f])[size_t(i)] + step(rng);
+        }
+        aosPrev[size_t(i)] = {prev.user[size_t(i)], prev.nice[size_t(i)], prev.sys[size_t(i)], prev.idle[size_t(i)],
+                              prev.iowait[size_t(i)], prev.hardirq[size_t(i)], prev.softirq[size_t(i)],
+                              prev.steal[size_t(i)], 0, 0};
+        aosCur[size_t(i)] = {cur.user[size_t(i)], cur.nice[size_t(i)], cur.sys[size_t(i)], cur.idle[size_t(i)],
+                             cur.iowait[size_t(i)], cur.hardirq[size_t(i)], cur.softirq[size_t(i)],
+                             cur.steal[size_t(i)], 0, 0};
+    }
+}
+
+CpuUsage toUsage(const CpuStat &s)
+{
+    return {s.user + s.nice + s.sys + s.idle + s.iowait + s.hardirq + s.softirq + s.steal, s.idle + s.iowait};
+}
+
+double scalar(const std::vector<CpuStat> &prev, const std::vector<CpuStat> &cur, std::vector<CpuPercent> &out)
+{
+    double sum = 0;
+    for (size_t i = 0; i < cur.size(); ++i) {
+        const CpuStat &ps = prev[i];
+        const CpuStat &cs = cur[i];
+        CpuUsage p = toUsage(ps);
+        CpuUsage c = toUsage(cs);
+        unsigned long long totald = c.total > p.total ? c.total - p.total : 0;
+        unsigned long long idled = c.idle > p.idle ? c.idle - p.idle : 0;
+        unsigned long long userd = cs.user + cs.nice - ps.user - ps.nice;
+        unsigned long long sysd = cs.sys + cs.hardirq + cs.softirq - ps.sys - ps.hardirq - ps.softirq;
+        unsigned long long iowaitd = cs.iowait - ps.iowait;
+        CpuPercent &o = out[i];
+        o.usage = c;
+        if (totald) {
+            o.busy = totald > idled ? double(totald - idled) * 100. / double(totald) : 0.;
+            o.user = double(userd) * 100. / double(totald);
+            o.sys = double(sysd) * 100. / double(totald);
+            o.iowait = double(iowaitd) * 100. / double(totald);
+        } else {
+            o.busy = o.user = o.sys = o.iowait = 0.;
+        }
+        sum += o.busy;
+    }
+    return sum;
+}
+
+template<typename F>
+double timeIt(F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < kRounds; ++r)
+        f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / kRounds;
+}
+
+} // namespace
+
+int main()
+{
+    printf("%8s %14s %14s %8s\n", "cpus", "struct ns", "kernel ns", "speedup");
+    for (int n : {64, 256, 1024}) {
+        CoreJiffies prev, cur;
+        CoreUsage usage;
+        std::vector<CpuStat> aosPrev, aosCur;
+        std::vector<CpuPercent> aosOut(static_cast<size_t>(n));
+        fill(prev, cur, aosPrev, aosCur, n);
+
+        volatile double sink = 0;
+        double aos = timeIt([&]() { sink = sink + scalar(aosPrev, aosCur, aosOut); });
+        double soa = timeIt([&]() {
+            computeCoreUsage(prev, cur, usage);
+            sink = sink + usage.usage[0];
+        });
+
+        // both paths must agree
+        for (int i = 0; i < n; ++i) {
+            double d = usage.usage[size_t(i)] - aosOut[size_t(i)].busy;
+            if (d > 1e-9 || d < -1e-9) {
+                fprintf(stderr, "mismatch at cpu %d: %f vs %f\n", i, usage.usage[size_t(i)], aosOut[size_t(i)].busy);
+                return 1;
+            }
+        }
+        printf("%8d %14.1f %14.1f %7.2fx\n", n, aos, soa, aos / soa);
+    }
+    return 0;
+}
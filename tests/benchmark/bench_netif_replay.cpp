@@ -0,0 +1,374 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Replays a saved capture through pcap_callback -> packet ring -> NetifMonitor::handleNetData
+// against a recorded socket table, without live traffic. Reports packets per second,
+// heap allocations per packet & how close per socket io of the pipeline (ring drops &
+// sampling included) comes to an exact classification of every packet.
+//
+//   netif-replay-bench --record-socks DIR             snapshot /proc/net socket tables to DIR
+//   netif-replay-bench --pcap FILE [--socks DIR]      replay, live socket tables without --socks
+//       [--local ADDR]...                             local addresses besides the ones of sockets
+//       [--loops N] [--mtu N] [--sampling-threshold N]
+
+#include "proc_fixture.h"
+#include "alloc_counter.h"
+
+#include "system/netif_monitor.h"
+#include "system/netif_packet_capture.h"
+#include "system/netif_packet_parser.h"
+#include "system/packet.h"
+#include "system/sock_diag.h"
+#include "system/sys_info.h"
+
+#include <QCoreApplication>
+#include <QHash>
+#include <QSet>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace core {
+namespace system {
+void pcap_callback(u_char *context, const struct pcap_pkthdr *hdr, const u_char *packet);
+}
+}
+
+using namespace core::system;
+
+namespace {
+
+// packets per pcap_dispatch round of the live capture, see NetifPacketCapture
+const int kDispatchBatch = 64;
+const long kSamplingWindowUs = PACKET_SAMPLING_WINDOW * 1000L;
+
+struct Packet {
+    struct pcap_pkthdr hdr;
+    std::vector<u_char> data;
+};
+
+struct Options {
+    std::string pcap;
+    std::string socks; // recorded socket tables, live ones if empty
+    std::string recordSocks;
+    std::vector<std::string> locals;
+    int loops {1};
+    int mtu {PACKET_DEFAULT_MTU};
+    int samplingThreshold {0};
+};
+
+using IOStats = QHash<ino_t, sock_io_stat_t>;
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool readPackets(const std::string &file, std::vector<Packet> &packets)
+{
+    char errbuf[PCAP_ERRBUF_SIZE] {};
+    pcap_t *handle = pcap_open_offline(file.c_str(), errbuf);
+    if (!handle) {
+        fprintf(stderr, "pcap_open_offline: %s\n", errbuf);
+        return false;
+    }
+    // same as the live capture, the parser expects ethernet frames
+    if (pcap_datalink(handle) != DLT_EN10MB) {
+        fprintf(stderr, "%s: not an ethernet capture\n", file.c_str());
+        pcap_close(handle);
+        return false;
+    }
+
+    struct pcap_pkthdr *hdr = nullptr;
+    const u_char *data = nullptr;
+    while (pcap_next_ex(handle, &hdr, &data) == 1) {
+        Packet packet;
+        packet.hdr = *hdr;
+        packet.data.assign(data, data + hdr->caplen);
+        packets.push_back(std::move(packet));
+    }
+    pcap_close(handle);
+    return true;
+}
+
+/**
+ * @brief Socket table & local addresses, from the tables recorded in dir or the live ones
+ */
+bool loadSockets(const Options &options, SockTable &table, QSet<addr_key_t> &ifaddrs)
+{
+    std::string error;
+    SockStatMap stats;
+    if (!options.socks.empty() && !bench::mountFixture(options.socks, error)) {
+        fprintf(stderr, "%s\n", error.c_str());
+        return false;
+    }
+    bool ok = SysInfo::readSockStat(stats);
+    if (!options.socks.empty())
+        bench::unmountFixture();
+    if (!ok) {
+        fprintf(stderr, "failed to read socket tables\n");
+        return false;
+    }
+
+    // the local end of every bound socket is a local address
+    const uint32_t wildcard[4] {};
+    for (auto it = stats.cbegin(); it != stats.cend(); ++it) {
+        table.insert(it.key(), it.value()->ino);
+        if (memcmp(it.key().s_addr, wildcard, sizeof(wildcard)) != 0)
+            ifaddrs.insert(makeAddrKey(it.value()->sa_family, &it.value()->s_addr));
+    }
+    for (const std::string &local : options.locals) {
+        in6_addr addr {};
+        int family = local.find(':') != std::string::npos ? AF_INET6 : AF_INET;
+        if (inet_pton(family, local.c_str(), &addr) != 1) {
+            fprintf(stderr, "bad address %s\n", local.c_str());
+            return false;
+        }
+        ifaddrs.insert(makeAddrKey(family, &addr));
+    }
+    printf("%d sockets, %d local addresses\n", int(table.size()), int(ifaddrs.size()));
+    return true;
+}
+
+/**
+ * @brief Reference: every packet classified, nothing dropped or sampled
+ */
+int classifyAll(const std::vector<Packet> &packets, const SockTable &table, const QSet<addr_key_t> &ifaddrs,
+                uint mtu, IOStats &exact)
+{
+    int matched = 0;
+    for (const Packet &packet : packets) {
+        struct packet_payload_t payload;
+        if (!NetifPacketCapture::classifyPacket(table, ifaddrs, &packet.hdr, packet.data.data(), payload, mtu))
+            continue;
+        auto &stat = exact[payload.ino];
+        stat.ino = payload.ino;
+        if (payload.direction == kInboundPacket) {
+            stat.rx_bytes += payload.wire_len;
+            ++stat.rx_packets;
+        } else {
+            stat.tx_bytes += payload.wire_len;
+            ++stat.tx_packets;
+        }
+        ++matched;
+    }
+    return matched;
+}
+
+/**
+ * @brief Header walk alone, no matching, counts frames parsed & frames behind vlan tags
+ */
+int parseAll(const std::vector<Packet> &packets, int &tagged)
+{
+    int parsed = 0;
+    tagged = 0;
+    for (const Packet &packet : packets) {
+        const packet_headers_t headers = NetifPacketParser::parseHeaders(packet.data.data(), packet.hdr.caplen, packet.hdr.len);
+        if (!headers.valid())
+            continue;
+        ++parsed;
+        if (headers.vlans > 0)
+            ++tagged;
+    }
+    return parsed;
+}
+
+/**
+ * @brief Capture thread side of the live path: callback per packet, consumer woken once per batch
+ */
+void replay(const std::vector<Packet> &packets, const Options &options, NetifMonitor &monitor, pcap_capture_t &context)
+{
+    NetifPacketCapture *capture = monitor.m_netifCapture;
+    for (int loop = 0; loop < options.loops; ++loop) {
+        // sampling windows follow capture time, so the rate reacts to the recorded packet rate
+        struct timeval window = packets.front().hdr.ts;
+        for (size_t i = 0; i < packets.size(); ++i) {
+            const Packet &packet = packets[i];
+            if (options.samplingThreshold > 0) {
+                long us = (packet.hdr.ts.tv_sec - window.tv_sec) * 1000000L + (packet.hdr.ts.tv_usec - window.tv_usec);
+                if (us >= kSamplingWindowUs) {
+                    capture->m_sampler.update(0, us / 1000);
+                    window = packet.hdr.ts;
+                }
+            }
+            pcap_callback(reinterpret_cast<u_char *>(&context), &packet.hdr, packet.data.data());
+            if ((i + 1) % kDispatchBatch == 0)
+                monitor.notifyPackets();
+        }
+        monitor.notifyPackets();
+    }
+}
+
+/**
+ * @brief 1 - sum of per socket byte errors over attributed bytes, 1 is exact
+ */
+double accuracy(const IOStats &exact, const QHash<ino_t, SockIOStat> &measured, int loops)
+{
+    double error = 0;
+    double total = 0;
+    for (auto it = exact.cbegin(); it != exact.cend(); ++it) {
+        double rx = double(it->rx_bytes) * loops;
+        double tx = double(it->tx_bytes) * loops;
+        auto mit = measured.constFind(it.key());
+        double mrx = mit != measured.cend() ? double((*mit)->rx_bytes) : 0;
+        double mtx = mit != measured.cend() ? double((*mit)->tx_bytes) : 0;
+        error += qAbs(mrx - rx) + qAbs(mtx - tx);
+        total += rx + tx;
+    }
+    // sockets the reference never saw are all error
+    for (auto it = measured.cbegin(); it != measured.cend(); ++it) {
+        if (!exact.contains(it.key()))
+            error += double((*it)->rx_bytes + (*it)->tx_bytes);
+    }
+    return total > 0 ? 1. - error / total : 1.;
+}
+
+bool parseInt(const char *arg, int &value)
+{
+    char *end = nullptr;
+    long v = arg ? strtol(arg, &end, 10) : -1;
+    if (!arg || *end || v < 0)
+        return false;
+    value = int(v);
+    return true;
+}
+
+void usage(const char *name)
+{
+    fprintf(stderr, "usage: %s --record-socks DIR\n"
+                    "       %s --pcap FILE [--socks DIR] [--local ADDR]... [--loops N] [--mtu N]"
+                    " [--sampling-threshold N]\n",
+            name, name);
+}
+
+bool parseOptions(int argc, char *argv[], Options &options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        int *number = nullptr;
+        if (!strcmp(arg, "--pcap") && value)
+            options.pcap = value;
+        else if (!strcmp(arg, "--socks") && value)
+            options.socks = value;
+        else if (!strcmp(arg, "--record-socks") && value)
+            options.recordSocks = value;
+        else if (!strcmp(arg, "--local") && value)
+            options.locals.push_back(value);
+        else if (!strcmp(arg, "--loops"))
+            number = &options.loops;
+        else if (!strcmp(arg, "--mtu"))
+            number = &options.mtu;
+        else if (!strcmp(arg, "--sampling-threshold"))
+            number = &options.samplingThreshold;
+        else
+            value = nullptr;
+        if (!value || (number && !parseInt(value, *number))) {
+            usage(argv[0]);
+            return false;
+        }
+        ++i;
+    }
+    if (options.pcap.empty() && options.recordSocks.empty()) {
+        usage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 1;
+
+    std::string error;
+    if (!options.recordSocks.empty()) {
+        if (!bench::recordSockets(options.recordSocks, error)) {
+            fprintf(stderr, "record: %s\n", error.c_str());
+            return 1;
+        }
+        printf("recorded socket tables to %s\n", options.recordSocks.c_str());
+        return 0;
+    }
+
+    // unshare needs a single threaded process, before Qt starts any thread
+    if (!options.socks.empty() && !bench::enterPrivateNamespace(error)) {
+        fprintf(stderr, "enter private namespace: %s\n", error.c_str());
+        return 1;
+    }
+    int appArgc = 1;
+    QCoreApplication app(appArgc, argv);
+
+    std::vector<Packet> packets;
+    if (!readPackets(options.pcap, packets))
+        return 1;
+    if (packets.empty() || options.loops < 1) {
+        fprintf(stderr, "nothing to replay\n");
+        return 1;
+    }
+    SockTable table;
+    QSet<addr_key_t> ifaddrs;
+    if (!loadSockets(options, table, ifaddrs))
+        return 1;
+    uint mtu = uint(options.mtu);
+
+    int tagged = 0;
+    auto start = std::chrono::steady_clock::now();
+    int parsed = parseAll(packets, tagged);
+    double parseMs = elapsedMs(start);
+
+    IOStats exact;
+    start = std::chrono::steady_clock::now();
+    int matched = classifyAll(packets, table, ifaddrs, mtu, exact);
+    double classifyMs = elapsedMs(start);
+
+    NetifMonitor monitor;
+    NetifPacketCapture *capture = monitor.m_netifCapture;
+    capture->m_sockTable = table;
+    capture->m_ifaddrsHashCache = ifaddrs;
+    capture->m_packetRing = monitor.createPacketRing();
+    capture->m_sampler = PacketSampler(uint(options.samplingThreshold));
+    pcap_capture_t context {capture, nullptr, QByteArray("replay"), mtu, 0};
+
+    std::thread consumer([&monitor] { monitor.handleNetData(); });
+    bench::AllocStats before = bench::allocStats();
+    start = std::chrono::steady_clock::now();
+    replay(packets, options, monitor, context);
+    while (!capture->m_packetRing->empty())
+        std::this_thread::yield();
+    // consumer merges its last batch before it sees the quit request
+    monitor.requestQuit();
+    consumer.join();
+    double pipelineMs = elapsedMs(start);
+    bench::AllocStats after = bench::allocStats();
+
+    double total = double(packets.size()) * options.loops;
+    qulonglong attributed = 0;
+    for (const auto &stat : monitor.m_sockIOStatMap)
+        attributed += stat->rx_packets + stat->tx_packets;
+
+    printf("%zu packets x %d loops, %.1f%% matched a local socket\n", packets.size(), options.loops,
+           100. * matched / double(packets.size()));
+    printf("%.1f%% tcp/udp over ip, %d behind vlan tags\n", 100. * parsed / double(packets.size()), tagged);
+    printf("  %-22s %14.0f pkt/s\n", "parse only", double(packets.size()) * 1000. / parseMs);
+    printf("  %-22s %14.0f pkt/s\n", "classify only", double(packets.size()) * 1000. / classifyMs);
+    printf("  %-22s %14.0f pkt/s\n", "callback -> monitor", total * 1000. / pipelineMs);
+    printf("  %-22s %14.3f\n", "allocations/packet", double(after.count - before.count) / total);
+    printf("  %-22s %14.1f\n", "bytes/packet", double(after.bytes - before.bytes) / total);
+    if (matched > 0)
+        printf("  %-22s %14.1f%%\n", "packets attributed", 100. * double(attributed) / (double(matched) * options.loops));
+    printf("  %-22s %14.2f%%\n", "byte accuracy", 100. * accuracy(exact, monitor.m_sockIOStatMap, options.loops));
+    printf("  %-22s %14u\n", "final sampling rate", capture->m_sampler.rate());
+    return 0;
+}
@@ -0,0 +1,661 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Forks process storms & drives the real ProcessSet::scanProcess while they run, with the
+// scan latency of each tick, the memory growth of the scanner & the processes it got wrong.
+// Each storm runs in a private pid namespace whose /proc is bind mounted over /proc during
+// scans, so only storm processes are seen & pids can be reused at will.
+//
+//   process-storm-bench                      every storm, 20 ticks each
+//   process-storm-bench --storm short --rate 5000 --ticks 50 --interval 500
+//
+// Storms:
+//   short   --rate spawns per second, each living up to one interval, most exit unseen
+//   long    --processes staying up, the steady state
+//   tree    --processes in chains --depth deep, chains broken (lower half reparented) & respawned
+//   wrap    --processes started below pid_max so pids wrap around, --rate per second replaced
+//           by a process of the same pid under another name
+
+#include "proc_fixture.h"
+#include "alloc_counter.h"
+
+#include "application.h"
+#include "process/process_icon_cache.h"
+#include "process/process_set.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mount.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace core::process;
+
+namespace {
+
+enum Storm { kShortStorm, kLongStorm, kTreeStorm, kWrapStorm, kStormCount };
+const char *const kStormNames[kStormCount] = {"short", "long", "tree", "wrap"};
+
+struct Options {
+    int ticks {20};
+    int interval {1000}; // ms between scans
+    int rate {1000}; // spawns per second of the short & wrap storms
+    int processes {2000}; // of the long, tree & wrap storms
+    int depth {50}; // of the tree storm chains
+    std::vector<Storm> storms;
+};
+
+/**
+ * @brief Storm driver request, sent to the spawner
+ */
+struct request_t {
+    int storm;
+    char procDir[64]; // where the driver mounts the /proc of its namespace
+};
+
+struct reply_t {
+    pid_t driver; // in our pid namespace
+    char status; // 'R' ready, 'E' failed
+};
+
+struct StormResult {
+    std::vector<double> scanMs;
+    int ticks {0};
+    uint64_t allocs {0};
+    uint64_t bytes {0};
+    uint64_t processes {0}; // summed over ticks
+    uint64_t spawned {0};
+    uint64_t exited {0};
+    long rssStartKiB {0};
+    long rssEndKiB {0};
+    // processes checked against /proc right after each scan
+    uint64_t checked {0};
+    uint64_t stale {0}; // same process, another name or parent than scanned
+    uint64_t reused {0}; // pid of a process started before the scan, reported with the data of an older one
+    uint64_t missed {0}; // process started before the scan & still running, not reported
+};
+
+void sleepMs(int ms)
+{
+    timespec ts {ms / 1000, (ms % 1000) * 1000000L};
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+}
+
+uint64_t bootTicks()
+{
+    // start times in /proc/<pid>/stat are clock ticks of the boot time clock
+    static const long hz = sysconf(_SC_CLK_TCK);
+    timespec ts {};
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    return uint64_t(ts.tv_sec) * uint64_t(hz) + uint64_t(ts.tv_nsec) * uint64_t(hz) / 1000000000u;
+}
+
+bool readFull(int fd, void *data, size_t size)
+{
+    char *p = static_cast<char *>(data);
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        size -= size_t(n);
+    }
+    return true;
+}
+
+long readLong(const std::string &path, long fallback)
+{
+    FILE *fp = fopen(path.c_str(), "r");
+    long value = fallback;
+    if (fp) {
+        if (fscanf(fp, "%ld", &value) != 1)
+            value = fallback;
+        fclose(fp);
+    }
+    return value;
+}
+
+bool writeLong(const std::string &path, long value)
+{
+    int fd = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    char text[24];
+    int size = snprintf(text, sizeof(text), "%ld", value);
+    bool ok = write(fd, text, size_t(size)) == size;
+    close(fd);
+    return ok;
+}
+
+// ---- storm processes, all forked by the single threaded driver ----
+
+/**
+ * @brief Child of the driver named name, living ms milliseconds or until killed if negative
+ */
+pid_t spawn(const char *name, int ms)
+{
+    pid_t pid = fork();
+    if (pid != 0)
+        return pid;
+    prctl(PR_SET_NAME, name, 0, 0, 0);
+    if (ms < 0) {
+        for (;;)
+            pause();
+    }
+    sleepMs(ms);
+    _exit(0);
+}
+
+void runShortStorm(const Options &options)
+{
+    unsigned seed = 1;
+    double due = 0;
+    // spawned every 10 ms
+    for (;;) {
+        for (due += options.rate / 100.; due >= 1; --due)
+            spawn("storm-short", int(rand_r(&seed) % unsigned(options.interval + 1)));
+        sleepMs(10);
+    }
+}
+
+void runLongStorm(const Options &options)
+{
+    for (int i = 0; i < options.processes; ++i)
+        spawn("storm-long", -1);
+    for (;;)
+        pause();
+}
+
+/**
+ * @brief Chain of depth processes in a process group of its own, each the parent of the next,
+ * pids written to fd top down, 0 for levels that failed to fork
+ */
+void spawnChain(int depth, int fd)
+{
+    if (fork() != 0)
+        return;
+    setpgid(0, 0);
+    prctl(PR_SET_NAME, "storm-tree", 0, 0, 0);
+    for (int level = 0; level < depth; ++level) {
+        pid_t self = getpid();
+        if (write(fd, &self, sizeof(self)) != sizeof(self))
+            _exit(1);
+        if (level + 1 == depth)
+            break;
+        pid_t child = fork();
+        if (child > 0)
+            break;
+        if (child < 0) {
+            pid_t none = 0;
+            for (++level; level < depth; ++level) {
+                if (write(fd, &none, sizeof(none)) != sizeof(none))
+                    _exit(1);
+            }
+            break;
+        }
+    }
+    for (;;)
+        pause();
+}
+
+void runTreeStorm(const Options &options)
+{
+    const int depth = std::max(2, std::min(options.depth, options.processes));
+    const int chains = std::max(1, options.processes / depth);
+    int fds[2];
+    if (pipe(fds) != 0)
+        _exit(1);
+
+    std::vector<std::vector<pid_t>> pids(static_cast<size_t>(chains), std::vector<pid_t>(static_cast<size_t>(depth)));
+    auto spawnFull = [&](int chain) {
+        spawnChain(depth, fds[1]);
+        if (!readFull(fds[0], pids[size_t(chain)].data(), sizeof(pid_t) * size_t(depth)))
+            _exit(1);
+    };
+    for (int chain = 0; chain < chains; ++chain)
+        spawnFull(chain);
+
+    // twice a scan interval a chain loses its middle process, its lower half reparented
+    // to the driver, or a broken one is killed & respawned with new pids
+    std::vector<char> broken(size_t(chains), 0);
+    for (int step = 0;; ++step) {
+        sleepMs(std::max(1, options.interval / 2));
+        const size_t chain = size_t(step % chains);
+        if (!broken[chain]) {
+            if (pid_t middle = pids[chain][size_t(depth / 2)])
+                kill(middle, SIGKILL);
+            broken[chain] = 1;
+        } else {
+            killpg(pids[chain][0], SIGKILL);
+            spawnFull(int(chain));
+            broken[chain] = 0;
+        }
+    }
+}
+
+void runWrapStorm(const Options &options, const std::string &procDir)
+{
+    // the storm starts right below pid_max & wraps around at once
+    const std::string lastPid = procDir + "/sys/kernel/ns_last_pid";
+    const long pidMax = readLong(procDir + "/sys/kernel/pid_max", 32768);
+    if (!writeLong(lastPid, std::max(2L, pidMax - options.processes / 2)))
+        fprintf(stderr, "  ns_last_pid is not writable, pids are not reused\n");
+
+    std::vector<pid_t> pids;
+    for (int i = 0; i < options.processes; ++i)
+        pids.push_back(spawn("storm-a", -1));
+
+    // replaced by a process of the same pid, named after its generation
+    char name[16];
+    unsigned generation = 0;
+    double due = 0;
+    for (size_t i = 0;; sleepMs(10)) {
+        for (due += options.rate / 100.; due >= 1; --due, i = (i + 1) % pids.size()) {
+            pid_t pid = pids[i];
+            if (pid > 0) {
+                kill(pid, SIGKILL);
+                // reaped by the kernel, returns once the pid is free
+                waitpid(pid, nullptr, 0);
+                writeLong(lastPid, pid - 1);
+            }
+            snprintf(name, sizeof(name), "storm-%c", 'a' + int(++generation % 26));
+            pids[i] = spawn(name, -1);
+        }
+    }
+}
+
+/**
+ * @brief First process of a new pid namespace, mounts its /proc & runs the storm until killed
+ */
+void runDriver(const request_t &request, const Options &options, int statusFd)
+{
+    prctl(PR_SET_PDEATHSIG, SIGKILL, 0, 0, 0);
+    prctl(PR_SET_NAME, "storm-driver", 0, 0, 0);
+    char status = 'R';
+    if (mount("proc", request.procDir, "proc", MS_NOSUID | MS_NODEV | MS_NOEXEC, nullptr) != 0) {
+        perror("mount proc");
+        status = 'E';
+    }
+    // storm processes are reaped by the kernel
+    signal(SIGCHLD, SIG_IGN);
+    if (write(statusFd, &status, 1) != 1 || status != 'R')
+        _exit(1);
+    close(statusFd);
+
+    switch (request.storm) {
+    case kShortStorm:
+        runShortStorm(options);
+        break;
+    case kLongStorm:
+        runLongStorm(options);
+        break;
+    case kTreeStorm:
+        runTreeStorm(options);
+        break;
+    case kWrapStorm:
+        runWrapStorm(options, request.procDir);
+        break;
+    }
+    _exit(0);
+}
+
+/**
+ * @brief Fork a driver in a new pid namespace for each request, started before Qt so it
+ * stays single threaded, fork is only safe there
+ */
+void runSpawner(const Options &options, int requestFd, int replyFd)
+{
+    prctl(PR_SET_PDEATHSIG, SIGKILL, 0, 0, 0);
+    signal(SIGCHLD, SIG_IGN);
+    request_t request {};
+    while (readFull(requestFd, &request, sizeof(request))) {
+        int status[2];
+        if (pipe(status) != 0)
+            _exit(1);
+        if (fork() != 0) {
+            close(status[1]);
+            close(status[0]);
+            continue;
+        }
+
+        // helper staying in our namespace, tells the driver's pid & waits for it
+        prctl(PR_SET_PDEATHSIG, SIGKILL, 0, 0, 0);
+        signal(SIGCHLD, SIG_DFL);
+        reply_t reply {0, 'E'};
+        if (unshare(CLONE_NEWPID) != 0) {
+            perror("unshare pid namespace");
+        } else if ((reply.driver = fork()) == 0) {
+            close(status[0]);
+            runDriver(request, options, status[1]);
+        }
+        close(status[1]);
+        if (reply.driver > 0 && !readFull(status[0], &reply.status, 1))
+            reply.status = 'E';
+        if (write(replyFd, &reply, sizeof(reply)) != sizeof(reply))
+            _exit(1);
+        if (reply.driver > 0)
+            waitpid(reply.driver, nullptr, 0);
+        _exit(0);
+    }
+    _exit(0);
+}
+
+// ---- scanner side ----
+
+struct proc_stat_t {
+    std::string comm;
+    pid_t ppid {0};
+    unsigned long long startTime {0};
+};
+
+bool readStat(pid_t pid, proc_stat_t &stat)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    char buf[1024];
+    ssize_t n = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (n <= 0)
+        return false;
+    buf[n] = '\0';
+
+    // pid (comm) state ppid ... starttime, field 22
+    const char *commBegin = strchr(buf, '(');
+    const char *commEnd = strrchr(buf, ')');
+    if (!commBegin || !commEnd || commEnd < commBegin)
+        return false;
+    stat.comm.assign(commBegin + 1, size_t(commEnd - commBegin - 1));
+    char state = 0;
+    int ppid = 0;
+    unsigned long long start = 0;
+    if (sscanf(commEnd + 2, "%c %d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d %*d %*d %llu",
+               &state, &ppid, &start)
+        != 3)
+        return false;
+    stat.ppid = ppid;
+    stat.startTime = start;
+    return true;
+}
+
+/**
+ * @brief Compare the processes of the last scan with /proc right after it
+ */
+void checkScan(const ProcessSet &processSet, uint64_t scanStart, StormResult &result)
+{
+    // just forked processes are still named after the driver
+    static const std::string kUnnamed = "storm-driver";
+    std::unordered_map<pid_t, const Process *> scanned;
+    for (auto it = processSet.m_set.cbegin(); it != processSet.m_set.cend(); ++it)
+        scanned.emplace(it.key(), &it.value());
+
+    DIR *dir = opendir("/proc");
+    if (!dir)
+        return;
+    while (dirent *entry = readdir(dir)) {
+        char *end = nullptr;
+        long pid = strtol(entry->d_name, &end, 10);
+        if (*end || pid <= 0)
+            continue;
+        proc_stat_t live;
+        if (!readStat(pid_t(pid), live))
+            continue;
+        // a tick of slack, start times are rounded down
+        const bool startedBefore = live.startTime + 1 < scanStart;
+        auto it = scanned.find(pid_t(pid));
+        if (it == scanned.end()) {
+            result.missed += startedBefore;
+            continue;
+        }
+
+        const Process &proc = *it->second;
+        ++result.checked;
+        if (proc.startTimeTicks() != live.startTime) {
+            result.reused += startedBefore;
+            continue;
+        }
+        const std::string name = proc.name().toStdString();
+        if (name != kUnnamed && live.comm != kUnnamed && (name != live.comm || proc.ppid() != live.ppid))
+            ++result.stale;
+    }
+    closedir(dir);
+}
+
+long rssKiB()
+{
+    FILE *fp = fopen("/proc/self/status", "r");
+    if (!fp)
+        return 0;
+    char line[256];
+    long rss = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        if (sscanf(line, "VmRSS: %ld kB", &rss) == 1)
+            break;
+    }
+    fclose(fp);
+    return rss;
+}
+
+bool runStorm(Storm storm, const Options &options, int requestFd, int replyFd, StormResult &result)
+{
+    request_t request {};
+    request.storm = storm;
+    snprintf(request.procDir, sizeof(request.procDir), "/tmp/process-storm-bench-XXXXXX");
+    if (!mkdtemp(request.procDir)) {
+        perror("mkdtemp");
+        return false;
+    }
+    reply_t reply {};
+    if (write(requestFd, &request, sizeof(request)) != sizeof(request) || !readFull(replyFd, &reply, sizeof(reply))
+        || reply.status != 'R') {
+        fprintf(stderr, "storm driver failed to start\n");
+        if (reply.driver > 0)
+            kill(reply.driver, SIGKILL);
+        rmdir(request.procDir);
+        return false;
+    }
+
+    bool ok = true;
+    std::string error;
+    ProcessSet processSet;
+    auto start = std::chrono::steady_clock::now();
+    // tick 0 fills the caches, not counted
+    for (int tick = 0; tick <= options.ticks && ok; ++tick) {
+        std::this_thread::sleep_until(start + std::chrono::milliseconds(options.interval) * tick);
+        if (!bench::mountFixture(request.procDir, error)) {
+            fprintf(stderr, "%s\n", error.c_str());
+            ok = false;
+            break;
+        }
+        const uint64_t scanStart = bootTicks();
+        bench::AllocStats before = bench::allocStats();
+        auto scanBegin = std::chrono::steady_clock::now();
+        processSet.scanProcess();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - scanBegin).count();
+        bench::AllocStats after = bench::allocStats();
+        if (tick > 0)
+            checkScan(processSet, scanStart, result);
+        bench::unmountFixture();
+
+        const long rss = rssKiB();
+        if (tick == 0) {
+            printf("  first tick: %d processes, scan %.2f ms\n", int(processSet.m_set.size()), ms);
+            result.rssStartKiB = rss;
+            continue;
+        }
+        result.scanMs.push_back(ms);
+        result.allocs += after.count - before.count;
+        result.bytes += after.bytes - before.bytes;
+        result.processes += uint64_t(processSet.m_set.size());
+        result.spawned += uint64_t(processSet.pidSetDiff().spawned.size());
+        result.exited += uint64_t(processSet.pidSetDiff().exited.size());
+        result.rssEndKiB = rss;
+        ++result.ticks;
+    }
+
+    // the namespace ends with its first process
+    kill(reply.driver, SIGKILL);
+    umount2(request.procDir, MNT_DETACH);
+    rmdir(request.procDir);
+
+    const ProcessCacheStats &simple = processSet.m_simpleSet.stats();
+    const ProcessCacheStats &recent = processSet.m_recentProcStage.stats();
+    printf("  caches: processes %d/%d (%llu reused, %llu evicted), counters %d/%d, icons %d\n", simple.count,
+           simple.maxCount, static_cast<unsigned long long>(simple.reused),
+           static_cast<unsigned long long>(simple.evictions), recent.count, recent.maxCount,
+           ProcessIconCache::instance()->m_cache.count());
+    return ok;
+}
+
+void report(const StormResult &result)
+{
+    if (result.ticks == 0)
+        return;
+    std::vector<double> ms = result.scanMs;
+    std::sort(ms.begin(), ms.end());
+    auto percentile = [&ms](double p) {
+        return ms[std::min(ms.size() - 1, size_t(p * double(ms.size() - 1) + 0.5))];
+    };
+    double total = 0;
+    for (double value : ms)
+        total += value;
+
+    const double ticks = result.ticks;
+    printf("  %-12s %10s %10s %10s %10s\n", "scan ms", "avg", "p50", "p99", "max");
+    printf("  %-12s %10.3f %10.3f %10.3f %10.3f\n", "", total / ticks, percentile(0.5), percentile(0.99), ms.back());
+    printf("  per tick: %.0f processes, %.1f spawned, %.1f exited, %.1f allocs, %.1f KiB\n",
+           double(result.processes) / ticks, double(result.spawned) / ticks, double(result.exited) / ticks,
+           double(result.allocs) / ticks, double(result.bytes) / 1024. / ticks);
+    printf("  rss: %.1f -> %.1f MiB (%+.1f)\n", result.rssStartKiB / 1024., result.rssEndKiB / 1024.,
+           (result.rssEndKiB - result.rssStartKiB) / 1024.);
+    printf("  errors: %llu stale, %llu reused, %llu missed of %llu checked\n\n",
+           static_cast<unsigned long long>(result.stale), static_cast<unsigned long long>(result.reused),
+           static_cast<unsigned long long>(result.missed), static_cast<unsigned long long>(result.checked));
+}
+
+bool parseInt(const char *arg, int &value)
+{
+    char *end = nullptr;
+    long v = arg ? strtol(arg, &end, 10) : 0;
+    if (!arg || *end || v <= 0)
+        return false;
+    value = int(v);
+    return true;
+}
+
+bool parseOptions(int argc, char *argv[], Options &options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        int *number = nullptr;
+        bool ok = value != nullptr;
+        if (!strcmp(arg, "--ticks"))
+            number = &options.ticks;
+        else if (!strcmp(arg, "--interval"))
+            number = &options.interval;
+        else if (!strcmp(arg, "--rate"))
+            number = &options.rate;
+        else if (!strcmp(arg, "--processes"))
+            number = &options.processes;
+        else if (!strcmp(arg, "--depth"))
+            number = &options.depth;
+        else if (!strcmp(arg, "--storm") && value) {
+            auto name = std::find_if(std::begin(kStormNames), std::end(kStormNames), [value](const char *storm) {
+                return !strcmp(storm, value);
+            });
+            ok = name != std::end(kStormNames);
+            if (ok)
+                options.storms.push_back(Storm(name - std::begin(kStormNames)));
+        } else {
+            ok = false;
+        }
+        ok = ok && (!number || parseInt(value, *number));
+        if (!ok) {
+            fprintf(stderr, "usage: %s [--storm short|long|tree|wrap] [--ticks N] [--interval MS] [--rate N]"
+                            " [--processes N] [--depth N]\n",
+                    argv[0]);
+            return false;
+        }
+        ++i;
+    }
+    if (options.storms.empty()) {
+        for (int storm = 0; storm < kStormCount; ++storm)
+            options.storms.push_back(Storm(storm));
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 1;
+
+    // unshare & fork need a single threaded process, before Qt starts any thread
+    std::string error;
+    if (!bench::enterPrivateNamespace(error)) {
+        fprintf(stderr, "enter private namespace: %s\n", error.c_str());
+        return 1;
+    }
+    int requests[2];
+    int replies[2];
+    if (pipe(requests) != 0 || pipe(replies) != 0) {
+        perror("pipe");
+        return 1;
+    }
+    pid_t spawner = fork();
+    if (spawner < 0) {
+        perror("fork");
+        return 1;
+    }
+    if (spawner == 0) {
+        close(requests[1]);
+        close(replies[0]);
+        runSpawner(options, requests[0], replies[1]);
+    }
+    close(requests[0]);
+    close(replies[1]);
+
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    int appArgc = 1;
+    Application app(appArgc, argv);
+
+    int rc = 0;
+    for (Storm storm : options.storms) {
+        printf("%s storm: %d processes, %d spawns/s, depth %d, %d ticks of %d ms\n", kStormNames[storm],
+               options.processes, options.rate, options.depth, options.ticks, options.interval);
+        StormResult result;
+        if (!runStorm(storm, options, requests[1], replies[0], result)) {
+            rc = 1;
+            break;
+        }
+        report(result);
+    }
+    close(requests[1]);
+    waitpid(spawner, nullptr, 0);
+    return rc;
+}
@@ -0,0 +1,250 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Times the sampling pipeline tick by tick against synthetic or recorded /proc trees:
+// process scan, cpu stats, socket table & the process model diff, with the heap
+// allocations of each stage.
+//
+//   sampling-bench                          default matrix of synthetic trees
+//   sampling-bench --processes 5000 --cpus 64 --sockets 1000 --ticks 20
+//   sampling-bench --record DIR             snapshot the live /proc to DIR
+//   sampling-bench --fixture DIR            replay a recorded snapshot
+
+#include "proc_fixture.h"
+#include "alloc_counter.h"
+
+#include "application.h"
+#include "model/process_table_model.h"
+#include "process/process_set.h"
+#include "system/cpu_set.h"
+#include "system/packet.h"
+#include "system/sys_info.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace core::process;
+using namespace core::system;
+
+namespace {
+
+enum Stage { kScan, kCpuStats, kSockStat, kModelDiff, kStageCount };
+const char *const kStageNames[kStageCount] = {"scanProcess", "read_stats", "readSockStat", "model diff"};
+
+struct StageResult {
+    double totalMs {0};
+    double maxMs {0};
+    uint64_t allocs {0};
+    uint64_t bytes {0};
+};
+
+struct Options {
+    int ticks {10};
+    std::vector<bench::FixtureSpec> specs;
+    std::string fixture; // replay a recorded tree instead of synthetic ones
+    std::string record;
+};
+
+template<typename Fn>
+void measure(StageResult &result, Fn fn)
+{
+    bench::AllocStats before = bench::allocStats();
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    bench::AllocStats after = bench::allocStats();
+    result.totalMs += ms;
+    result.maxMs = std::max(result.maxMs, ms);
+    result.allocs += after.count - before.count;
+    result.bytes += after.bytes - before.bytes;
+}
+
+/**
+ * @brief Run ticks over the tree at root, mounted over /proc only while the samplers read it,
+ * Qt & DTK need the real /proc/self in between
+ */
+bool run(const std::string &root, const bench::FixtureSpec *spec, int ticks, StageResult (&results)[kStageCount])
+{
+    std::string error;
+    ProcessSet processSet;
+    CPUSet cpuSet;
+    SockStatMap sockStats;
+    ProcessTableModel model(nullptr, QString());
+    QHash<QString, int> nameRanks;
+    QHash<QString, int> userRanks;
+
+    // tick 0 reads everything once per process & fills the caches, not counted
+    for (int tick = 0; tick <= ticks; ++tick) {
+        if (spec && tick > 0 && !bench::advanceFixture(root, *spec, tick, error)) {
+            fprintf(stderr, "advance fixture: %s\n", error.c_str());
+            return false;
+        }
+
+        StageResult tickResults[kStageCount];
+        if (!bench::mountFixture(root, error)) {
+            fprintf(stderr, "%s\n", error.c_str());
+            return false;
+        }
+        measure(tickResults[kScan], [&] { processSet.scanProcess(); });
+        measure(tickResults[kCpuStats], [&] { cpuSet.read_stats(); });
+        measure(tickResults[kSockStat], [&] {
+            sockStats.clear();
+            SysInfo::readSockStat(sockStats);
+        });
+        bench::unmountFixture();
+
+        QList<Process> procs = processSet.m_set.values();
+        measure(tickResults[kModelDiff], [&] {
+            model.applyRowTable(ProcessTableModel::makeRowTable(procs, false, nameRanks, userRanks));
+        });
+
+        if (tick == 0) {
+            printf("  first tick: %zu processes, %d sockets, scan %.2f ms\n", size_t(procs.size()),
+                   int(sockStats.size()), tickResults[kScan].totalMs);
+            continue;
+        }
+        for (int i = 0; i < kStageCount; ++i) {
+            results[i].totalMs += tickResults[i].totalMs;
+            results[i].maxMs = std::max(results[i].maxMs, tickResults[i].maxMs);
+            results[i].allocs += tickResults[i].allocs;
+            results[i].bytes += tickResults[i].bytes;
+        }
+    }
+    return true;
+}
+
+void report(const StageResult (&results)[kStageCount], int ticks)
+{
+    printf("  %-14s %12s %12s %14s %12s\n", "stage", "avg ms/tick", "max ms", "allocs/tick", "KiB/tick");
+    double totalMs = 0;
+    uint64_t totalAllocs = 0;
+    for (int i = 0; i < kStageCount; ++i) {
+        const StageResult &r = results[i];
+        printf("  %-14s %12.3f %12.3f %14.1f %12.1f\n", kStageNames[i], r.totalMs / ticks, r.maxMs,
+               double(r.allocs) / ticks, double(r.bytes) / 1024. / ticks);
+        totalMs += r.totalMs;
+        totalAllocs += r.allocs;
+    }
+    printf("  %-14s %12.3f %12s %14.1f\n\n", "total", totalMs / ticks, "", double(totalAllocs) / ticks);
+}
+
+bool parseInt(const char *arg, int &value)
+{
+    char *end = nullptr;
+    long v = arg ? strtol(arg, &end, 10) : 0;
+    if (!arg || *end || v <= 0)
+        return false;
+    value = int(v);
+    return true;
+}
+
+bool parseOptions(int argc, char *argv[], Options &options)
+{
+    bench::FixtureSpec custom;
+    bool customized = false;
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        int *number = nullptr;
+        if (!strcmp(arg, "--ticks"))
+            number = &options.ticks;
+        else if (!strcmp(arg, "--processes"))
+            number = &custom.processes;
+        else if (!strcmp(arg, "--cpus"))
+            number = &custom.cpus;
+        else if (!strcmp(arg, "--sockets"))
+            number = &custom.sockets;
+        else if (!strcmp(arg, "--churn"))
+            number = &custom.churn;
+        else if (!strcmp(arg, "--fixture") && value)
+            options.fixture = value;
+        else if (!strcmp(arg, "--record") && value)
+            options.record = value;
+        else
+            value = nullptr;
+        bool ok = value && (!number || parseInt(value, *number));
+        customized = customized || (number && number != &options.ticks);
+        if (!ok) {
+            fprintf(stderr, "usage: %s [--ticks N] [--processes N] [--cpus N] [--sockets N] [--churn N]"
+                            " [--fixture DIR | --record DIR]\n",
+                    argv[0]);
+            return false;
+        }
+        ++i;
+    }
+
+    if (customized) {
+        options.specs.push_back(custom);
+    } else {
+        // a desktop, a build box & a large server
+        options.specs.push_back({500, 4, 1000, 5});
+        options.specs.push_back({5000, 64, 1000, 50});
+        options.specs.push_back({50000, 512, 1000, 500});
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 1;
+
+    std::string error;
+    if (!options.record.empty()) {
+        if (!bench::recordFixture(options.record, error)) {
+            fprintf(stderr, "record: %s\n", error.c_str());
+            return 1;
+        }
+        printf("recorded /proc to %s\n", options.record.c_str());
+        return 0;
+    }
+
+    // unshare needs a single threaded process, before Qt starts any thread
+    if (!bench::enterPrivateNamespace(error)) {
+        fprintf(stderr, "enter private namespace: %s\n", error.c_str());
+        return 1;
+    }
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    int appArgc = 1;
+    Application app(appArgc, argv);
+
+    if (!options.fixture.empty()) {
+        StageResult results[kStageCount];
+        printf("%s, %d ticks\n", options.fixture.c_str(), options.ticks);
+        if (!run(options.fixture, nullptr, options.ticks, results))
+            return 1;
+        report(results, options.ticks);
+        return 0;
+    }
+
+    for (const bench::FixtureSpec &spec : options.specs) {
+        char root[] = "/tmp/sampling-bench-XXXXXX";
+        if (!mkdtemp(root)) {
+            perror("mkdtemp");
+            return 1;
+        }
+        printf("%d processes, %d cpus, %d sockets, %d churn, %d ticks\n", spec.processes, spec.cpus, spec.sockets,
+               spec.churn, options.ticks);
+        StageResult results[kStageCount];
+        bool ok = bench::writeFixture(root, spec, error);
+        if (!ok)
+            fprintf(stderr, "write fixture: %s\n", error.c_str());
+        else
+            ok = run(root, &spec, options.ticks, results);
+        bench::removeTree(root);
+        if (!ok)
+            return 1;
+        report(results, options.ticks);
+    }
+    return 0;
+}
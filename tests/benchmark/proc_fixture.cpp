@@ -0,0 +1,340 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "proc_fixture.h"
+
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mount.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace bench {
+
+namespace {
+
+const int kFirstPid = 1000;
+const unsigned long kFirstInode = 100000;
+// per process files the sampler reads, see Process & ProcFdCache
+const char *const kProcessFiles[] = {"stat", "statm", "io", "status", "schedstat", "cmdline", "comm", "environ", "cgroup"};
+// system wide files, see CPUSet, SysInfo & MemInfo
+const char *const kSystemFiles[] = {"stat", "meminfo", "uptime", "loadavg", "cpuinfo", "net/tcp", "net/tcp6",
+                                    "net/udp", "net/udp6", "sys/fs/file-nr"};
+// socket tables, see SysInfo::readSockStat
+const char *const kSocketFiles[] = {"net/tcp", "net/tcp6", "net/udp", "net/udp6"};
+
+bool fail(std::string &error, const std::string &what)
+{
+    error = what + ": " + strerror(errno);
+    return false;
+}
+
+bool makeDir(const std::string &path, std::string &error)
+{
+    if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST)
+        return fail(error, "mkdir " + path);
+    return true;
+}
+
+bool writeFile(const std::string &path, const std::string &content, std::string &error)
+{
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return fail(error, "open " + path);
+    ssize_t nr = write(fd, content.data(), content.size());
+    close(fd);
+    if (nr != ssize_t(content.size()))
+        return fail(error, "write " + path);
+    return true;
+}
+
+bool writeProcFile(const std::string &path, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+bool writeProcFile(const std::string &path, const char *fmt, ...)
+{
+    char buf[2048];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    std::string error;
+    return n >= 0 && writeFile(path, std::string(buf, size_t(n)), error);
+}
+
+std::string cpuLine(const char *name, unsigned long long base, int tick)
+{
+    char buf[256];
+    unsigned long long t = (unsigned long long)tick;
+    snprintf(buf, sizeof(buf), "%s %llu %llu %llu %llu %llu %llu %llu 0 0 0\n", name,
+             base * 4 + t * 40, base / 10 + t, base * 2 + t * 20, base * 20 + t * 100, base / 5 + t * 2,
+             base / 50, base / 40 + t);
+    return buf;
+}
+
+bool writeCpuStat(const std::string &root, const FixtureSpec &spec, int tick, std::string &error)
+{
+    std::string content = cpuLine("cpu", 100000ULL * (unsigned long long)spec.cpus, tick * spec.cpus);
+    char name[16];
+    for (int i = 0; i < spec.cpus; ++i) {
+        snprintf(name, sizeof(name), "cpu%d", i);
+        content += cpuLine(name, 100000ULL + (unsigned long long)i * 37, tick);
+    }
+    content += "intr 123456789 0 0 0\nctxt 987654321\nbtime 1700000000\n";
+    content += "processes " + std::to_string(spec.processes + tick * spec.churn) + "\n";
+    content += "procs_running 2\nprocs_blocked 0\nsoftirq 1234 0 0 0 0 0 0 0 0 0 0\n";
+    return writeFile(root + "/stat", content, error);
+}
+
+bool writeSockets(const std::string &root, const FixtureSpec &spec, std::string &error)
+{
+    const char *const header = "  sl  local_address rem_address   st tx_queue rx_queue tr tm->when retrnsmt"
+                               "   uid  timeout inode\n";
+    std::string tcp = header, tcp6 = header, udp = header, udp6 = header;
+    uid_t uid = getuid();
+    char line[256];
+    for (int i = 0; i < spec.sockets; ++i) {
+        unsigned long ino = kFirstInode + unsigned(i);
+        unsigned port = 1024 + unsigned(i) % 60000;
+        switch (i % 4) {
+        case 0:
+        case 1:
+            snprintf(line, sizeof(line), "%4d: 0100007F:%04X 0A01A8C0:01BB 01 00000000:00000000 00:00000000 00000000 %5u        0 %lu 1 0000000000000000 20 4 30 10 -1\n",
+                     i, port, uid, ino);
+            tcp += line;
+            break;
+        case 2:
+            snprintf(line, sizeof(line), "%4d: 00000000000000000000000001000000:%04X 00000000000000000000000000000000:0000 0A 00000000:00000000 00:00000000 00000000 %5u        0 %lu 1 0000000000000000 100 0 0 10 0\n",
+                     i, port, uid, ino);
+            tcp6 += line;
+            break;
+        default:
+            snprintf(line, sizeof(line), "%4d: 00000000:%04X 00000000:0000 07 00000000:00000000 00:00000000 00000000 %5u        0 %lu 2 0000000000000000 0\n",
+                     i, port, uid, ino);
+            udp += line;
+            break;
+        }
+    }
+    return writeFile(root + "/net/tcp", tcp, error) && writeFile(root + "/net/tcp6", tcp6, error)
+           && writeFile(root + "/net/udp", udp, error) && writeFile(root + "/net/udp6", udp6, error);
+}
+
+bool writeProcess(const std::string &root, const FixtureSpec &spec, int pid, std::string &error)
+{
+    std::string dir = root + "/" + std::to_string(pid);
+    if (!makeDir(dir, error) || !makeDir(dir + "/fd", error))
+        return false;
+
+    uid_t uid = getuid();
+    gid_t gid = getgid();
+    unsigned long long utime = (unsigned long long)(pid % 997) * 13;
+    unsigned long long stime = (unsigned long long)(pid % 389) * 7;
+    unsigned long long rss = 1000 + (unsigned long long)(pid % 5000);
+    int ppid = pid == kFirstPid ? 1 : kFirstPid + (pid - kFirstPid) / 8;
+    bool ok = writeProcFile(dir + "/stat",
+                            "%d (proc-%d) S %d %d %d 0 -1 4194560 %d 0 0 0 %llu %llu 0 0 20 0 %d 0 %d %llu %llu "
+                            "18446744073709551615 1 1 0 0 0 0 0 4096 0 0 0 0 17 %d 0 0 0 0 0\n",
+                            pid, pid % 1000, ppid, pid, pid, pid % 100, utime, stime, 1 + pid % 8, 1000 + pid,
+                            rss * 16384, rss, pid % (spec.cpus > 0 ? spec.cpus : 1))
+              && writeProcFile(dir + "/statm", "%llu %llu %llu 100 0 %llu 0\n", rss * 4, rss, rss / 4, rss / 2)
+              && writeProcFile(dir + "/io",
+                               "rchar: %d\nwchar: %d\nsyscr: 10\nsyscw: 5\nread_bytes: %d\nwrite_bytes: %d\n"
+                               "cancelled_write_bytes: 0\n",
+                               pid * 100, pid * 50, pid * 16, pid * 8)
+              && writeProcFile(dir + "/status",
+                               "Name:\tproc-%d\nUmask:\t0022\nState:\tS (sleeping)\nTgid:\t%d\nNgid:\t0\nPid:\t%d\n"
+                               "PPid:\t%d\nTracerPid:\t0\nUid:\t%u\t%u\t%u\t%u\nGid:\t%u\t%u\t%u\t%u\n"
+                               "voluntary_ctxt_switches:\t%d\nnonvoluntary_ctxt_switches:\t3\n",
+                               pid % 1000, pid, pid, ppid, uid, uid, uid, uid, gid, gid, gid, gid, pid % 300)
+              && writeProcFile(dir + "/schedstat", "%llu %d %d\n", utime * 10000000ULL, pid * 1000, pid % 50)
+              && writeProcFile(dir + "/comm", "proc-%d\n", pid % 1000)
+              && writeProcFile(dir + "/cgroup", "0::/user.slice/user-%u.slice/session-2.scope\n", uid);
+    if (!ok)
+        return fail(error, "write " + dir);
+
+    char cmdline[64];
+    int n = snprintf(cmdline, sizeof(cmdline), "/usr/bin/proc-%d%c--fixture%c", pid % 1000, '\0', '\0');
+    const char env[] = "PATH=/usr/bin\0LANG=C.UTF-8\0";
+    if (!writeFile(dir + "/cmdline", std::string(cmdline, size_t(n)), error)
+        || !writeFile(dir + "/environ", std::string(env, sizeof(env) - 1), error))
+        return false;
+
+    // stdio, then the sockets owned by this process
+    for (int fd = 0; fd < 3; ++fd)
+        symlink("/dev/null", (dir + "/fd/" + std::to_string(fd)).c_str());
+    int index = pid - kFirstPid;
+    int fd = 3;
+    for (int i = index; spec.processes > 0 && i < spec.sockets; i += spec.processes) {
+        std::string target = "socket:[" + std::to_string(kFirstInode + unsigned(i)) + "]";
+        symlink(target.c_str(), (dir + "/fd/" + std::to_string(fd++)).c_str());
+    }
+    return true;
+}
+
+int removeEntry(const char *path, const struct stat *, int, struct FTW *)
+{
+    remove(path);
+    return 0;
+}
+
+bool copyFile(const std::string &from, const std::string &to)
+{
+    int in = open(from.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0)
+        return false;
+    std::string content;
+    char buf[65536];
+    ssize_t nr;
+    while ((nr = read(in, buf, sizeof(buf))) > 0)
+        content.append(buf, size_t(nr));
+    close(in);
+    std::string error;
+    return nr == 0 && writeFile(to, content, error);
+}
+
+bool writeIdMap(const char *file, const std::string &content)
+{
+    std::string error;
+    return writeFile(std::string("/proc/self/") + file, content, error);
+}
+
+} // namespace
+
+bool writeFixture(const std::string &root, const FixtureSpec &spec, std::string &error)
+{
+    if (!makeDir(root, error) || !makeDir(root + "/net", error) || !makeDir(root + "/sys", error)
+        || !makeDir(root + "/sys/fs", error))
+        return false;
+
+    std::string cpuinfo;
+    for (int i = 0; i < spec.cpus; ++i)
+        cpuinfo += "processor\t: " + std::to_string(i) + "\nmodel name\t: Fixture CPU\ncpu MHz\t\t: 2400.000\n\n";
+    bool ok = writeCpuStat(root, spec, 0, error)
+              && writeFile(root + "/meminfo",
+                           "MemTotal:       16384000 kB\nMemFree:         4096000 kB\nMemAvailable:    8192000 kB\n"
+                           "Buffers:          256000 kB\nCached:          2048000 kB\nSwapCached:            0 kB\n"
+                           "SwapTotal:       4096000 kB\nSwapFree:        4096000 kB\nShmem:            128000 kB\n"
+                           "SReclaimable:     256000 kB\n",
+                           error)
+              && writeFile(root + "/uptime", "12345.67 45678.90\n", error)
+              && writeFile(root + "/loadavg", "0.52 0.48 0.40 2/" + std::to_string(spec.processes) + " 4242\n", error)
+              && writeFile(root + "/cpuinfo", cpuinfo, error)
+              && writeFile(root + "/sys/fs/file-nr", "12345\t0\t9223372036854775807\n", error)
+              && writeSockets(root, spec, error);
+    if (!ok)
+        return false;
+
+    for (int i = 0; i < spec.processes; ++i) {
+        if (!writeProcess(root, spec, kFirstPid + i, error))
+            return false;
+    }
+    return true;
+}
+
+bool advanceFixture(const std::string &root, const FixtureSpec &spec, int tick, std::string &error)
+{
+    // live pids at tick t are [first + t * churn, first + t * churn + processes)
+    int gone = kFirstPid + (tick - 1) * spec.churn;
+    for (int i = 0; i < spec.churn; ++i) {
+        removeTree(root + "/" + std::to_string(gone + i));
+        if (!writeProcess(root, spec, gone + spec.processes + i, error))
+            return false;
+    }
+    return writeCpuStat(root, spec, tick, error);
+}
+
+bool recordFixture(const std::string &root, std::string &error)
+{
+    if (!makeDir(root, error) || !makeDir(root + "/net", error) || !makeDir(root + "/sys", error)
+        || !makeDir(root + "/sys/fs", error))
+        return false;
+    for (const char *file : kSystemFiles)
+        copyFile(std::string("/proc/") + file, root + "/" + file);
+
+    DIR *dir = opendir("/proc");
+    if (!dir)
+        return fail(error, "opendir /proc");
+    struct dirent *entry;
+    while ((entry = readdir(dir))) {
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9')
+            continue;
+        std::string from = std::string("/proc/") + entry->d_name;
+        std::string to = root + "/" + entry->d_name;
+        if (!makeDir(to, error) || !makeDir(to + "/fd", error))
+            continue;
+        for (const char *file : kProcessFiles)
+            copyFile(from + "/" + file, to + "/" + file);
+
+        // only socket links matter to the inode index, other fds are dropped
+        DIR *fds = opendir((from + "/fd").c_str());
+        if (!fds)
+            continue;
+        struct dirent *fd;
+        char target[128];
+        while ((fd = readdir(fds))) {
+            ssize_t n = readlink((from + "/fd/" + fd->d_name).c_str(), target, sizeof(target) - 1);
+            if (n <= 0)
+                continue;
+            target[n] = '\0';
+            if (!strncmp(target, "socket:[", 8))
+                symlink(target, (to + "/fd/" + fd->d_name).c_str());
+        }
+        closedir(fds);
+    }
+    closedir(dir);
+    return true;
+}
+
+bool recordSockets(const std::string &root, std::string &error)
+{
+    if (!makeDir(root, error) || !makeDir(root + "/net", error))
+        return false;
+    for (const char *file : kSocketFiles) {
+        if (!copyFile(std::string("/proc/") + file, root + "/" + file))
+            return fail(error, std::string("copy /proc/") + file);
+    }
+    return true;
+}
+
+bool enterPrivateNamespace(std::string &error)
+{
+    uid_t uid = getuid();
+    gid_t gid = getgid();
+    if (unshare(CLONE_NEWUSER | CLONE_NEWNS) != 0)
+        return fail(error, "unshare");
+    // keep our ids, so fixture processes owned by us stay "my processes"
+    if (!writeIdMap("setgroups", "deny") || !writeIdMap("uid_map", std::to_string(uid) + " " + std::to_string(uid) + " 1")
+        || !writeIdMap("gid_map", std::to_string(gid) + " " + std::to_string(gid) + " 1"))
+        return fail(error, "write id map");
+    if (mount(nullptr, "/", nullptr, MS_REC | MS_PRIVATE, nullptr) != 0)
+        return fail(error, "make mounts private");
+    return true;
+}
+
+bool mountFixture(const std::string &root, std::string &error)
+{
+    if (mount(root.c_str(), "/proc", nullptr, MS_BIND | MS_REC, nullptr) != 0)
+        return fail(error, "bind mount " + root);
+    return true;
+}
+
+void unmountFixture()
+{
+    umount2("/proc", MNT_DETACH);
+}
+
+void removeTree(const std::string &root)
+{
+    nftw(root.c_str(), removeEntry, 64, FTW_DEPTH | FTW_PHYS);
+}
+
+} // namespace bench
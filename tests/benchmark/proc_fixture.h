@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Synthetic & recorded /proc trees for the sampling benchmarks. A fixture is a plain
+// directory laid out like procfs, bind mounted over /proc in a private user & mount
+// namespace, so the sampling code runs unmodified against it.
+
+#ifndef PROC_FIXTURE_H
+#define PROC_FIXTURE_H
+
+#include <string>
+
+namespace bench {
+
+struct FixtureSpec {
+    int processes {500};
+    int cpus {4};
+    int sockets {1000};
+    // processes replaced by new pids per tick, exercises spawn & exit paths
+    int churn {5};
+};
+
+/**
+ * @brief Write a synthetic /proc tree of spec under root, root must be empty or missing
+ */
+bool writeFixture(const std::string &root, const FixtureSpec &spec, std::string &error);
+/**
+ * @brief Replace spec.churn processes with new pids & bump cpu counters for the next tick
+ */
+bool advanceFixture(const std::string &root, const FixtureSpec &spec, int tick, std::string &error);
+/**
+ * @brief Copy the files the sampler reads from the live /proc to root, for later replay
+ */
+bool recordFixture(const std::string &root, std::string &error);
+/**
+ * @brief Copy only the socket tables (net/tcp, tcp6, udp & udp6) of the live /proc to root
+ */
+bool recordSockets(const std::string &root, std::string &error);
+
+/**
+ * @brief Enter a private user & mount namespace, must run before any thread is started
+ */
+bool enterPrivateNamespace(std::string &error);
+/**
+ * @brief Bind mount root over /proc, unmountFixture restores the real procfs
+ */
+bool mountFixture(const std::string &root, std::string &error);
+void unmountFixture();
+
+/**
+ * @brief Remove a fixture tree
+ */
+void removeTree(const std::string &root);
+
+} // namespace bench
+
+#endif // PROC_FIXTURE_H
@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/cgroup_stats.h"
+#include "process_info_record.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+using namespace common::cgroup;
+
+class UT_CgroupStats : public ::testing::Test
+{
+protected:
+    CgroupStats m_tester;
+};
+
+TEST_F(UT_CgroupStats, test_parseCpuStat_001)
+{
+    const char *stat = "usage_usec 1234567\nuser_usec 1000000\nsystem_usec 234567\n"
+                       "nr_periods 0\nnr_throttled 0\nthrottled_usec 0\n";
+    quint64 usage = 0;
+    EXPECT_TRUE(CgroupStats::parseCpuStat(stat, strlen(stat), usage));
+    EXPECT_EQ(usage, 1234567u);
+
+    const char *other = "user_usec 10\nsystem_usec 20\n";
+    EXPECT_FALSE(CgroupStats::parseCpuStat(other, strlen(other), usage));
+}
+
+TEST_F(UT_CgroupStats, test_parseIOStat_001)
+{
+    const char *stat = "8:0 rbytes=1000 wbytes=200 rios=5 wios=2 dbytes=0 dios=0\n"
+                       "259:0 rbytes=30 wbytes=4 rios=1 wios=1 dbytes=7 dios=1\n";
+    quint64 bytes = 0;
+    EXPECT_TRUE(CgroupStats::parseIOStat(stat, strlen(stat), bytes));
+    EXPECT_EQ(bytes, 1234u);
+
+    // no io done yet
+    EXPECT_TRUE(CgroupStats::parseIOStat("", 0, bytes));
+    EXPECT_EQ(bytes, 0u);
+}
+
+TEST_F(UT_CgroupStats, test_parseProcessCgroup_001)
+{
+    const char *hybrid = "12:cpu,cpuacct:/user.slice\n1:name=systemd:/user.slice/user-1000.slice/app.scope\n"
+                         "0::/user.slice/user-1000.slice/app.scope\n";
+    QString cgroup;
+    EXPECT_TRUE(CgroupStats::parseProcessCgroup(hybrid, strlen(hybrid), cgroup));
+    EXPECT_EQ(cgroup, "/user.slice/user-1000.slice/app.scope");
+
+    const char *legacy = "1:name=systemd:/init.scope\n";
+    EXPECT_FALSE(CgroupStats::parseProcessCgroup(legacy, strlen(legacy), cgroup));
+}
+
+TEST_F(UT_CgroupStats, test_sample_001)
+{
+    QHash<QString, QString> controlGroups;
+    controlGroups.insert("none", "/system.slice/no-such-unit-for-test.service");
+    controlGroups.insert("stopped", "");
+
+    // unreadable cgroups are left out & not kept
+    auto usages = m_tester.sample(controlGroups);
+    EXPECT_TRUE(usages.isEmpty());
+
+    m_tester.sample({});
+    EXPECT_TRUE(m_tester.m_cgroups.isEmpty());
+    EXPECT_EQ(m_tester.m_persistentCount, 0);
+}
+
+TEST_F(UT_CgroupStats, test_parseMemoryMax_001)
+{
+    quint64 limit = 0;
+    EXPECT_TRUE(CgroupStats::parseMemoryMax("1073741824\n", 11, limit));
+    EXPECT_EQ(limit, 1073741824u);
+
+    // no limit set
+    EXPECT_FALSE(CgroupStats::parseMemoryMax("max\n", 4, limit));
+    EXPECT_FALSE(CgroupStats::parseMemoryMax("", 0, limit));
+}
+
+TEST_F(UT_CgroupStats, test_parseCpuMax_001)
+{
+    quint64 quota = 0;
+    quint64 period = 0;
+    EXPECT_TRUE(CgroupStats::parseCpuMax("50000 100000\n", 13, quota, period));
+    EXPECT_EQ(quota, 50000u);
+    EXPECT_EQ(period, 100000u);
+
+    // no quota set
+    EXPECT_FALSE(CgroupStats::parseCpuMax("max 100000\n", 11, quota, period));
+}
+
+TEST_F(UT_CgroupStats, test_parseIOWeight_001)
+{
+    const char *weight = "default 50\n8:0 200\n";
+    quint64 value = 0;
+    EXPECT_TRUE(CgroupStats::parseIOWeight(weight, strlen(weight), value));
+    EXPECT_EQ(value, 50u);
+
+    const char *devices = "8:0 200\n";
+    EXPECT_FALSE(CgroupStats::parseIOWeight(devices, strlen(devices), value));
+}
+
+TEST_F(UT_CgroupStats, test_readLimits_001)
+{
+    resource_limits_t limits {};
+    EXPECT_FALSE(CgroupStats::readLimits("/system.slice/no-such-unit-for-test.service", limits));
+    EXPECT_EQ(limits.cpu_quota, RESOURCE_LIMIT_NONE);
+    EXPECT_EQ(limits.memory_high, RESOURCE_LIMIT_NONE);
+    EXPECT_EQ(limits.io_weight, RESOURCE_LIMIT_NONE);
+}
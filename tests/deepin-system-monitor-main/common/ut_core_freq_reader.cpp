@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/core_freq_reader.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <string>
+
+using namespace common::parser;
+
+class UT_CoreFreqReader : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        char dir[] = "/tmp/ut_core_freq_XXXXXX";
+        ASSERT_NE(mkdtemp(dir), nullptr);
+        m_root = dir;
+    }
+
+    void TearDown() override
+    {
+        std::string cmd = "rm -rf " + m_root;
+        EXPECT_EQ(system(cmd.c_str()), 0);
+    }
+
+    void writeFile(int cpu, const char *dir, const char *name, const char *content)
+    {
+        std::string path = m_root + "/cpu" + std::to_string(cpu);
+        mkdir(path.c_str(), 0755);
+        path += std::string("/") + dir;
+        mkdir(path.c_str(), 0755);
+        path += std::string("/") + name;
+        FILE *fp = fopen(path.c_str(), "w");
+        ASSERT_NE(fp, nullptr);
+        fputs(content, fp);
+        fclose(fp);
+    }
+
+    std::string m_root;
+};
+
+TEST_F(UT_CoreFreqReader, test_parseValue)
+{
+    unsigned long long value = 0;
+    EXPECT_TRUE(CoreFreqReader::parseValue("2400000\n", 8, value));
+    EXPECT_EQ(value, 2400000ull);
+    EXPECT_FALSE(CoreFreqReader::parseValue("<unknown>\n", 10, value));
+    EXPECT_FALSE(CoreFreqReader::parseValue("", 0, value));
+}
+
+TEST_F(UT_CoreFreqReader, test_read)
+{
+    writeFile(0, "cpufreq", "scaling_cur_freq", "2400000\n");
+    writeFile(0, "thermal_throttle", "core_throttle_count", "3\n");
+    writeFile(0, "thermal_throttle", "package_throttle_count", "4\n");
+    writeFile(2, "cpufreq", "scaling_cur_freq", "800000\n");
+
+    CoreFreqReader reader(m_root.c_str());
+    // cpu1 has no files
+    reader.setCpus({0, 1, 2});
+    EXPECT_TRUE(reader.hasThrottleCounters());
+
+    std::vector<unsigned long long> khz, throttles;
+    EXPECT_EQ(reader.read(khz, throttles), 2);
+    ASSERT_EQ(khz.size(), 3u);
+    EXPECT_EQ(khz[0], 2400000ull);
+    EXPECT_EQ(khz[1], 0ull);
+    EXPECT_EQ(khz[2], 800000ull);
+    EXPECT_EQ(throttles[0], 7ull);
+    EXPECT_EQ(throttles[2], 0ull);
+
+    // files are kept open & re-read from the start
+    writeFile(0, "cpufreq", "scaling_cur_freq", "3100000\n");
+    EXPECT_EQ(reader.read(khz, throttles), 2);
+    EXPECT_EQ(khz[0], 3100000ull);
+}
+
+TEST_F(UT_CoreFreqReader, test_noFiles)
+{
+    CoreFreqReader reader(m_root.c_str());
+    reader.setCpus({0, 1});
+    EXPECT_FALSE(reader.hasThrottleCounters());
+    std::vector<unsigned long long> khz, throttles;
+    EXPECT_EQ(reader.read(khz, throttles), 0);
+    EXPECT_TRUE(khz.empty());
+}
@@ -0,0 +1,129 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/core_usage.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+using namespace common::usage;
+
+class UT_CoreUsage : public ::testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        m_prev.resize(2);
+        m_cur.resize(2);
+    }
+
+    virtual void TearDown() {}
+
+protected:
+    CoreJiffies m_prev;
+    CoreJiffies m_cur;
+    CoreUsage m_usage;
+};
+
+TEST_F(UT_CoreUsage, test_computeCoreUsage_001)
+{
+    // cpu0: 100 jiffies elapsed, 20 user, 10 nice, 10 sys, 5 irq, 5 softirq, 40 idle, 10 iowait
+    m_prev.user[0] = 100;
+    m_prev.idle[0] = 1000;
+    m_cur.user[0] = 120;
+    m_cur.nice[0] = 10;
+    m_cur.sys[0] = 10;
+    m_cur.hardirq[0] = 5;
+    m_cur.softirq[0] = 5;
+    m_cur.idle[0] = 1040;
+    m_cur.iowait[0] = 10;
+
+    computeCoreUsage(m_prev, m_cur, m_usage);
+    ASSERT_EQ(m_usage.size(), 2);
+    EXPECT_EQ(m_usage.total[0], 1200ULL);
+    EXPECT_EQ(m_usage.idle[0], 1050ULL);
+    EXPECT_DOUBLE_EQ(m_usage.usage[0], 50.);
+    EXPECT_DOUBLE_EQ(m_usage.user[0], 30.);
+    EXPECT_DOUBLE_EQ(m_usage.sys[0], 20.);
+    EXPECT_DOUBLE_EQ(m_usage.iowait[0], 10.);
+    EXPECT_DOUBLE_EQ(m_usage.hardirq[0], 5.);
+    EXPECT_DOUBLE_EQ(m_usage.softirq[0], 5.);
+
+    // cpu1: no time elapsed
+    EXPECT_TRUE(std::isnan(m_usage.usage[1]));
+}
+
+TEST_F(UT_CoreUsage, test_computeCoreUsage_002)
+{
+    // all zero previous snapshot gives usage since boot
+    m_cur.user[0] = 30;
+    m_cur.idle[0] = 70;
+    m_cur.user[1] = 10;
+    m_cur.idle[1] = 10;
+
+    computeCoreUsage(m_prev, m_cur, m_usage);
+    EXPECT_DOUBLE_EQ(m_usage.usage[0], 30.);
+    EXPECT_DOUBLE_EQ(m_usage.usage[1], 50.);
+
+    // counters going backwards clamp to zero
+    std::swap(m_prev, m_cur);
+    m_cur.user[0] = 25;
+    m_cur.idle[0] = 80;
+    computeCoreUsage(m_prev, m_cur, m_usage);
+    EXPECT_DOUBLE_EQ(m_usage.user[0], 0.);
+    EXPECT_DOUBLE_EQ(m_usage.usage[0], 0.);
+}
+
+TEST_F(UT_CoreUsage, test_computeCoreUsage_003)
+{
+    // cpu0 of a vm host: 100 jiffies, 60 user of which 40 ran guests, 10 stolen from us, 30 idle
+    m_cur.user[0] = 60;
+    m_cur.guest[0] = 30;
+    m_cur.guest_nice[0] = 10;
+    m_cur.steal[0] = 10;
+    m_cur.idle[0] = 30;
+
+    computeCoreUsage(m_prev, m_cur, m_usage);
+    // guest time is part of user, not counted twice
+    EXPECT_EQ(m_usage.total[0], 100ULL);
+    EXPECT_DOUBLE_EQ(m_usage.usage[0], 70.);
+    EXPECT_DOUBLE_EQ(m_usage.user[0], 60.);
+    EXPECT_DOUBLE_EQ(m_usage.guest[0], 40.);
+    EXPECT_DOUBLE_EQ(m_usage.steal[0], 10.);
+}
+
+TEST(UT_CoreRunQueue, test_computeCoreRunQueue_001)
+{
+    CoreSchedStat prev;
+    CoreSchedStat cur;
+    prev.resize(2);
+    cur.resize(2);
+    // cpu0 busy the whole second with 1.5 tasks waiting on average over 3000 timeslices
+    prev.runTime[0] = 5000000000ULL;
+    prev.runDelay[0] = 1000000000ULL;
+    prev.timeslices[0] = 1000;
+    cur.runTime[0] = 6000000000ULL;
+    cur.runDelay[0] = 2500000000ULL;
+    cur.timeslices[0] = 4000;
+    // cpu1 a quarter busy, never waited
+    cur.runTime[1] = 250000000ULL;
+
+    CoreRunQueue queue;
+    computeCoreRunQueue(prev, cur, 1e9, queue);
+    ASSERT_EQ(queue.size(), 2);
+    EXPECT_DOUBLE_EQ(queue.runnable[0], 2.5);
+    EXPECT_DOUBLE_EQ(queue.waiting[0], 1.5);
+    EXPECT_DOUBLE_EQ(queue.latency[0], 0.5);
+    EXPECT_DOUBLE_EQ(queue.runnable[1], 0.25);
+    EXPECT_DOUBLE_EQ(queue.waiting[1], 0.);
+    EXPECT_DOUBLE_EQ(queue.latency[1], 0.);
+
+    // counters going backwards clamp to zero
+    computeCoreRunQueue(cur, prev, 1e9, queue);
+    EXPECT_DOUBLE_EQ(queue.runnable[0], 0.);
+}
@@ -37,3 +37,12 @@ TEST(UT_HanLatin, test_convHanToLatin_01)
     QString words;
     convHanToLatin(words);
 }
+
+TEST(UT_HanLatin, test_convHanToLatin_02)
+{
+    // second conversion of the same name comes from the cache
+    const QString &latin = convHanToLatin("kworker");
+    EXPECT_EQ(latin, QString("kworker"));
+    EXPECT_EQ(convHanToLatin("kworker"), latin);
+    EXPECT_EQ(convHanToLatin(QString::fromUtf8("中")), convHanToLatin(QString::fromUtf8("中")));
+}
@@ -0,0 +1,253 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/history_store.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//qt
+#include <QTemporaryDir>
+
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+#include <string.h>
+
+using namespace common::history;
+
+// 2024-01-02 03:00:00 UTC
+const int64_t kHour = 1704164400000LL;
+
+class UT_HistoryStore : public ::testing::Test
+{
+protected:
+    std::string dir() const { return m_dir.path().toStdString(); }
+
+    QTemporaryDir m_dir;
+};
+
+TEST_F(UT_HistoryStore, test_codec_roundtrip)
+{
+    std::vector<Sample> samples;
+    int64_t time = kHour;
+    for (int i = 0; i < 200; ++i) {
+        // jittery cadence, repeated, small & large values
+        time += 1000 + (i % 7 == 0 ? 13 : 0) - (i % 11 == 0 ? 9 : 0);
+        double value = i % 5 == 0 ? 42. : i * 0.37 + (i % 3 ? 1e9 : 0);
+        samples.push_back({time, value});
+    }
+    samples.push_back({time + 1000, -0.});
+    samples.push_back({time + 2000, std::numeric_limits<double>::max()});
+
+    std::string payload;
+    encodeSamples(samples, payload);
+    // well under the 16 bytes per sample of a raw layout
+    EXPECT_LT(payload.size(), samples.size() * 10);
+
+    std::vector<Sample> decoded;
+    ASSERT_TRUE(decodeSamples(payload.data(), payload.size(), uint32_t(samples.size()), samples[0].time, decoded));
+    ASSERT_EQ(decoded.size(), samples.size());
+    for (size_t i = 0; i < samples.size(); ++i) {
+        EXPECT_EQ(decoded[i].time, samples[i].time);
+        EXPECT_EQ(memcmp(&decoded[i].value, &samples[i].value, sizeof(double)), 0);
+    }
+
+    // truncated payload
+    EXPECT_FALSE(decodeSamples(payload.data(), payload.size() / 2, uint32_t(samples.size()), samples[0].time, decoded));
+}
+
+TEST_F(UT_HistoryStore, test_codec_steady)
+{
+    std::vector<Sample> samples;
+    for (int i = 0; i < int(kBlockSamples); ++i)
+        samples.push_back({kHour + i * 1000, 0.});
+    std::string payload;
+    encodeSamples(samples, payload);
+    // a byte per timestamp, a bit per unchanged value
+    EXPECT_LE(payload.size(), size_t(2 + kBlockSamples + 8 + kBlockSamples / 8 + 1));
+}
+
+TEST_F(UT_HistoryStore, test_partitionName)
+{
+    EXPECT_EQ(partitionName(kHour + 59 * 60 * 1000), "20240102-03.hist");
+    EXPECT_EQ(partitionStart("20240102-03.hist"), kHour);
+    EXPECT_EQ(partitionStart("20240102-03.tmp"), -1);
+    EXPECT_EQ(partitionStart("notes.txt"), -1);
+
+    EXPECT_EQ(partitionName(kHour, k1mTier), "20240102-03.1m.hist");
+    EXPECT_EQ(partitionStart("20240102-03.10m.hist"), kHour);
+    EXPECT_EQ(partitionStart("20240102-03.5m.hist"), -1);
+}
+
+TEST_F(UT_HistoryStore, test_tierFor)
+{
+    EXPECT_EQ(tierFor(500), kRawTier);
+    EXPECT_EQ(tierFor(19999), kRawTier);
+    EXPECT_EQ(tierFor(20000), k10sTier);
+    // a day on 720 buckets
+    EXPECT_EQ(tierFor(24 * kPartitionSpan / 720), k1mTier);
+    EXPECT_EQ(tierFor(7 * 24 * kPartitionSpan / 360), k10mTier);
+}
+
+TEST_F(UT_HistoryStore, test_rollup_codec)
+{
+    std::vector<Rollup> rollups;
+    for (int i = 0; i < 50; ++i)
+        rollups.push_back({kHour + i * 60000, i * 0.5, i * 2., i * 60., uint32_t(60 - i % 3)});
+
+    std::string payload;
+    encodeRollups(rollups, payload);
+    std::vector<Rollup> decoded;
+    ASSERT_TRUE(decodeRollups(payload.data(), payload.size(), uint32_t(rollups.size()), kHour, decoded));
+    ASSERT_EQ(decoded.size(), rollups.size());
+    for (size_t i = 0; i < rollups.size(); ++i) {
+        EXPECT_EQ(decoded[i].time, rollups[i].time);
+        EXPECT_EQ(decoded[i].min, rollups[i].min);
+        EXPECT_EQ(decoded[i].max, rollups[i].max);
+        EXPECT_EQ(decoded[i].sum, rollups[i].sum);
+        EXPECT_EQ(decoded[i].count, rollups[i].count);
+    }
+    EXPECT_FALSE(decodeRollups(payload.data(), payload.size() / 2, uint32_t(rollups.size()), kHour, decoded));
+}
+
+TEST_F(UT_HistoryStore, test_write_read)
+{
+    {
+        HistoryWriter writer(dir());
+        ASSERT_TRUE(writer.isValid());
+        for (int i = 0; i < 300; ++i) {
+            writer.append(1, "sda", kHour + i * 1000, i);
+            writer.append(2, "", kHour + i * 1000, 1.);
+            writer.commit();
+        }
+        // full blocks are on disk before the writer is gone
+        HistoryReader reader(dir());
+        std::vector<double> values = reader.query(1, "sda", kHour, kHour + 240 * 1000, 1);
+        ASSERT_EQ(values.size(), size_t(1));
+        EXPECT_DOUBLE_EQ(values[0], 239 / 2.);
+    }
+
+    HistoryReader reader(dir());
+    // decoded, blocks span more than a bucket
+    std::vector<double> values = reader.query(1, "sda", kHour, kHour + 300 * 1000, 3);
+    ASSERT_EQ(values.size(), size_t(3));
+    EXPECT_DOUBLE_EQ(values[0], 49.5);
+    EXPECT_DOUBLE_EQ(values[2], 249.5);
+
+    values = reader.query(1, "sda", kHour, kHour + 300 * 1000, 3, HistoryReader::kMaximum);
+    EXPECT_DOUBLE_EQ(values[1], 199.);
+
+    // downsampled from block heads, a bucket spans the whole hour
+    values = reader.query(2, "", kHour, kHour + kPartitionSpan, 1);
+    EXPECT_DOUBLE_EQ(values[0], 1.);
+
+    // other series & empty buckets
+    values = reader.query(1, "sdb", kHour, kHour + 300 * 1000, 2);
+    EXPECT_TRUE(std::isnan(values[0]));
+    values = reader.query(1, "sda", kHour - kPartitionSpan, kHour, 4);
+    EXPECT_TRUE(std::isnan(values[3]));
+}
+
+TEST_F(UT_HistoryStore, test_rollups)
+{
+    {
+        HistoryWriter writer(dir());
+        for (int i = 0; i < 1800; ++i) {
+            writer.append(0, "", kHour + i * 1000, i % 60);
+            writer.commit();
+        }
+    }
+    EXPECT_TRUE(std::ifstream(dir() + "/" + partitionName(kHour, k10sTier)).good());
+    EXPECT_TRUE(std::ifstream(dir() + "/" + partitionName(kHour, k1mTier)).good());
+    EXPECT_TRUE(std::ifstream(dir() + "/" + partitionName(kHour, k10mTier)).good());
+
+    HistoryReader reader(dir());
+    // two minute buckets read the minute rollups, a minute is one sawtooth period
+    std::vector<double> values = reader.query(0, "", kHour, kHour + 30 * 60000, 15);
+    EXPECT_DOUBLE_EQ(values[0], 29.5);
+    EXPECT_DOUBLE_EQ(values[14], 29.5);
+    values = reader.query(0, "", kHour, kHour + 30 * 60000, 15, HistoryReader::kMaximum);
+    EXPECT_DOUBLE_EQ(values[7], 59.);
+
+    // twenty minute buckets read the ten minute rollups
+    values = reader.query(0, "", kHour, kHour + kPartitionSpan, 3, HistoryReader::kMaximum);
+    EXPECT_DOUBLE_EQ(values[1], 59.);
+    EXPECT_TRUE(std::isnan(values[2]));
+
+    // 10s buckets
+    values = reader.query(0, "", kHour, kHour + 60000, 6);
+    EXPECT_DOUBLE_EQ(values[0], 4.5);
+    EXPECT_DOUBLE_EQ(values[5], 54.5);
+}
+
+TEST_F(UT_HistoryStore, test_partitions)
+{
+    HistoryWriter writer(dir(), 2 * kPartitionSpan);
+    for (int hour = 0; hour < 4; ++hour) {
+        writer.append(0, "", kHour + hour * kPartitionSpan, hour);
+        writer.commit();
+    }
+    writer.flush();
+
+    HistoryReader reader(dir());
+    std::vector<double> values = reader.query(0, "", kHour, kHour + 4 * kPartitionSpan, 4);
+    // the first hour fell out of the retention when the fourth began
+    EXPECT_TRUE(std::isnan(values[0]));
+    EXPECT_DOUBLE_EQ(values[1], 1.);
+    EXPECT_DOUBLE_EQ(values[3], 3.);
+}
+
+TEST_F(UT_HistoryStore, test_torn_tail)
+{
+    {
+        HistoryWriter writer(dir());
+        for (int i = 0; i < 10; ++i)
+            writer.append(0, "", kHour + i * 1000, 5.);
+    }
+    // a crash in the middle of appending the next block
+    std::ofstream(dir() + "/" + partitionName(kHour), std::ios::app | std::ios::binary) << "DMH1 torn";
+
+    HistoryReader reader(dir());
+    std::vector<double> values = reader.query(0, "", kHour, kHour + 60 * 1000, 1);
+    EXPECT_DOUBLE_EQ(values[0], 5.);
+}
+
+TEST_F(UT_HistoryStore, test_scan)
+{
+    {
+        HistoryWriter writer(dir());
+        for (int i = 0; i < 300; ++i) {
+            writer.append(1, "sda", kHour - 100 * 1000 + i * 1000, i);
+            writer.append(2, "", kHour - 100 * 1000 + i * 1000, 1.);
+            writer.commit();
+        }
+    }
+
+    HistoryReader reader(dir());
+    std::map<std::pair<int, std::string>, std::vector<Sample>> series;
+    reader.scan(kHour - 50 * 1000, kHour + 150 * 1000, [&](int metric, const std::string &device, const std::vector<Sample> &samples) {
+        std::vector<Sample> &out = series[{metric, device}];
+        out.insert(out.end(), samples.begin(), samples.end());
+    });
+    // across the partition boundary, trimmed to the range
+    ASSERT_EQ(series.size(), size_t(2));
+    const std::vector<Sample> &sda = series[std::make_pair(1, std::string("sda"))];
+    ASSERT_EQ(sda.size(), size_t(200));
+    EXPECT_EQ(sda.front().time, kHour - 50 * 1000);
+    EXPECT_DOUBLE_EQ(sda.front().value, 50.);
+    EXPECT_EQ(sda.back().time, kHour + 149 * 1000);
+    for (size_t i = 1; i < sda.size(); ++i)
+        EXPECT_LT(sda[i - 1].time, sda[i].time);
+    EXPECT_EQ(series[std::make_pair(2, std::string())].size(), size_t(200));
+
+    // nothing recorded
+    int blocks = 0;
+    reader.scan(kHour + kPartitionSpan, kHour + 2 * kPartitionSpan, [&](int, const std::string &, const std::vector<Sample> &) {
+        ++blocks;
+    });
+    EXPECT_EQ(blocks, 0);
+}
@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/meminfo_reader.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+using namespace common::parser;
+
+TEST(UT_MemInfoReader, test_parse_001)
+{
+    const char buf[] = "MemTotal:       16346064 kB\n"
+                       "MemFree:         1455488 kB\n"
+                       "MemAvailable:    5931304 kB\n"
+                       "Buffers:          312400 kB\n"
+                       "Cached:          4491188 kB\n"
+                       "SwapCached:         1024 kB\n"
+                       "Active:          8012344 kB\n"
+                       "Inactive:        5210544 kB\n"
+                       "Active(anon):    6001200 kB\n"
+                       "Inactive(anon):   708960 kB\n"
+                       "SwapTotal:       2097148 kB\n"
+                       "SwapFree:        2096124 kB\n"
+                       "Dirty:               532 kB\n"
+                       "Writeback:            12 kB\n"
+                       "AnonPages:       8389004 kB\n"
+                       "Mapped:          1027708 kB\n"
+                       "Shmem:            498160 kB\n"
+                       "KReclaimable:     260300 kB\n"
+                       "Slab:             512412 kB\n"
+                       "AnonHugePages:     845824 kB\n"
+                       "HugePages_Total:       0\n";
+    MemInfoFields fields;
+    EXPECT_EQ(MemInfoReader::parse(buf, sizeof(buf) - 1, fields), 17);
+    EXPECT_EQ(fields.memTotal, 16346064ull);
+    EXPECT_EQ(fields.memFree, 1455488ull);
+    EXPECT_EQ(fields.memAvailable, 5931304ull);
+    EXPECT_EQ(fields.buffers, 312400ull);
+    EXPECT_EQ(fields.cached, 4491188ull);
+    EXPECT_EQ(fields.swapCached, 1024ull);
+    // Active(anon) must not overwrite Active
+    EXPECT_EQ(fields.active, 8012344ull);
+    EXPECT_EQ(fields.inactive, 5210544ull);
+    EXPECT_EQ(fields.swapTotal, 2097148ull);
+    EXPECT_EQ(fields.swapFree, 2096124ull);
+    EXPECT_EQ(fields.dirty, 532ull);
+    EXPECT_EQ(fields.writeback, 12ull);
+    EXPECT_EQ(fields.mapped, 1027708ull);
+    EXPECT_EQ(fields.shmem, 498160ull);
+    EXPECT_EQ(fields.kReclaimable, 260300ull);
+    EXPECT_EQ(fields.slab, 512412ull);
+    EXPECT_EQ(fields.anonHugePages, 845824ull);
+}
+
+TEST(UT_MemInfoReader, test_parse_002)
+{
+    // missing fields are left untouched, malformed lines skipped
+    MemInfoFields fields;
+    fields.kReclaimable = 7;
+    const char buf[] = "MemTotal: 100 kB\n"
+                       "garbage\n"
+                       ": 5 kB\n"
+                       "Dirty: x kB\n"
+                       "Slab: 3 kB";
+    EXPECT_EQ(MemInfoReader::parse(buf, sizeof(buf) - 1, fields), 2);
+    EXPECT_EQ(fields.memTotal, 100ull);
+    EXPECT_EQ(fields.dirty, 0ull);
+    EXPECT_EQ(fields.slab, 3ull);
+    EXPECT_EQ(fields.kReclaimable, 7ull);
+}
+
+TEST(UT_MemInfoReader, test_parse_003)
+{
+    // per node meminfo prefixes every line with the node
+    MemInfoFields fields;
+    const char buf[] = "Node 0 MemTotal:        4947704 kB\n"
+                       "Node 0 MemFree:          812044 kB\n"
+                       "Node 0 MemUsed:         4135660 kB\n"
+                       "Node 0 Dirty:                20 kB\n";
+    EXPECT_EQ(MemInfoReader::parse(buf, sizeof(buf) - 1, fields), 3);
+    EXPECT_EQ(fields.memTotal, 4947704ull);
+    EXPECT_EQ(fields.memFree, 812044ull);
+    EXPECT_EQ(fields.dirty, 20ull);
+}
+
+TEST(UT_MemInfoReader, test_parse_004)
+{
+    // huge page & zswap levels, Zswap must not take Zswapped
+    MemInfoFields fields;
+    const char buf[] = "Zswap:             81920 kB\n"
+                       "Zswapped:         262144 kB\n"
+                       "AnonHugePages:    845824 kB\n"
+                       "ShmemHugePages:     4096 kB\n"
+                       "ShmemPmdMapped:        0 kB\n"
+                       "FileHugePages:      2048 kB\n"
+                       "FilePmdMapped:         0 kB\n";
+    EXPECT_EQ(MemInfoReader::parse(buf, sizeof(buf) - 1, fields), 5);
+    EXPECT_EQ(fields.zswap, 81920ull);
+    EXPECT_EQ(fields.zswapped, 262144ull);
+    EXPECT_EQ(fields.anonHugePages, 845824ull);
+    EXPECT_EQ(fields.shmemHugePages, 4096ull);
+    EXPECT_EQ(fields.fileHugePages, 2048ull);
+}
+
+TEST(UT_MemInfoReader, test_read_001)
+{
+    MemInfoReader reader;
+    MemInfoFields fields;
+    // fd is kept open & re-read
+    EXPECT_TRUE(reader.read(fields));
+    EXPECT_NE(fields.memTotal, 0ull);
+    fields.memTotal = 0;
+    EXPECT_TRUE(reader.read(fields));
+    EXPECT_NE(fields.memTotal, 0ull);
+}
+
+TEST(UT_MemInfoReader, test_read_002)
+{
+    MemInfoReader reader("/proc/no-such-file");
+    MemInfoFields fields;
+    EXPECT_FALSE(reader.read(fields));
+}
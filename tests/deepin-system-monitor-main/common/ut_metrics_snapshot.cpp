@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/metrics_snapshot.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <QTemporaryDir>
+
+using namespace common::metrics;
+
+class UT_MetricsSnapshot : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_dir.isValid());
+        m_path = m_dir.filePath("metrics").toStdString();
+    }
+
+    QTemporaryDir m_dir;
+    std::string m_path;
+};
+
+TEST_F(UT_MetricsSnapshot, test_publish_001)
+{
+    MetricsSnapshotReader reader(m_path);
+    MetricsSample sample;
+    // no sampler yet
+    EXPECT_FALSE(reader.read(sample, 2000));
+
+    MetricsSnapshotWriter writer(m_path);
+    ASSERT_TRUE(writer.open());
+    EXPECT_FALSE(writer.isDemanded(5000));
+
+    MetricsSample published;
+    published.sampledAt = monotonicNow();
+    published.cpuUsage = 42.5;
+    published.memTotal = 16346064;
+    published.netRecvBytes = 1ull << 40;
+
+    MetricsSnapshotReader other(m_path);
+    // mapped but nothing published
+    EXPECT_FALSE(other.read(sample, 2000));
+    EXPECT_TRUE(writer.isDemanded(5000));
+
+    writer.publish(published);
+    ASSERT_TRUE(other.read(sample, 2000));
+    EXPECT_DOUBLE_EQ(sample.cpuUsage, 42.5);
+    EXPECT_EQ(sample.memTotal, 16346064ull);
+    EXPECT_EQ(sample.netRecvBytes, 1ull << 40);
+}
+
+TEST_F(UT_MetricsSnapshot, test_read_001)
+{
+    MetricsSnapshotWriter writer(m_path);
+    ASSERT_TRUE(writer.open());
+    MetricsSnapshotReader reader(m_path);
+
+    MetricsSample published;
+    published.sampledAt = monotonicNow() - 10000;
+    published.cpuUsage = 10;
+    writer.publish(published);
+
+    // stale, sampler gone
+    MetricsSample sample;
+    sample.cpuUsage = -1;
+    EXPECT_FALSE(reader.read(sample, 2000));
+    EXPECT_DOUBLE_EQ(sample.cpuUsage, -1);
+
+    // writer in the middle of publish
+    writer.m_segment->seq.fetch_add(1);
+    published.sampledAt = monotonicNow();
+    writer.m_segment->sample = published;
+    EXPECT_FALSE(reader.read(sample, 2000));
+
+    // next publish recovers from the odd seq
+    writer.publish(published);
+    EXPECT_EQ(writer.m_segment->seq.load() % 2, 0u);
+    EXPECT_TRUE(reader.read(sample, 2000));
+}
+
+TEST_F(UT_MetricsSnapshot, test_open_001)
+{
+    {
+        MetricsSnapshotWriter writer(m_path);
+        ASSERT_TRUE(writer.open());
+        // segment of an older layout
+        writer.m_segment->version = kMetricsVersion - 1;
+        MetricsSample published;
+        published.sampledAt = monotonicNow();
+        writer.publish(published);
+    }
+    MetricsSnapshotReader reader(m_path);
+    MetricsSample sample;
+    EXPECT_FALSE(reader.read(sample, 2000));
+
+    MetricsSnapshotWriter writer(m_path);
+    ASSERT_TRUE(writer.open());
+    EXPECT_EQ(writer.m_segment->version, kMetricsVersion);
+    EXPECT_EQ(writer.m_segment->seq.load(), 0u);
+}
+
+TEST_F(UT_MetricsSnapshot, test_readHistory_001)
+{
+    MetricsSnapshotWriter writer(m_path);
+    ASSERT_TRUE(writer.open());
+    MetricsSnapshotReader reader(m_path);
+    MetricsHistoryPoint points[kMetricsHistoryLength];
+    EXPECT_EQ(reader.readHistory(points, 10), 0);
+
+    MetricsSample published;
+    for (int i = 0; i < 3; ++i) {
+        published.sampledAt = i;
+        published.cpuUsage = i * 10;
+        writer.publish(published);
+    }
+    ASSERT_EQ(reader.readHistory(points, 10), 3);
+    EXPECT_EQ(points[0].sampledAt, 0);
+    EXPECT_DOUBLE_EQ(points[2].cpuUsage, 20);
+
+    // wrapped around, latest points oldest first
+    for (int i = 3; i < kMetricsHistoryLength + 5; ++i) {
+        published.sampledAt = i;
+        writer.publish(published);
+    }
+    ASSERT_EQ(reader.readHistory(points, 2), 2);
+    EXPECT_EQ(points[0].sampledAt, kMetricsHistoryLength + 3);
+    EXPECT_EQ(points[1].sampledAt, kMetricsHistoryLength + 4);
+    EXPECT_EQ(reader.readHistory(points, kMetricsHistoryLength + 10), kMetricsHistoryLength);
+    EXPECT_EQ(points[0].sampledAt, 5);
+}
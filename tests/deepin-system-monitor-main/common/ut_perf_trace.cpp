@@ -0,0 +1,142 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/perf_trace.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace common::trace;
+
+namespace {
+
+const ThreadStats *statsOf(const std::vector<ThreadStats> &stats, int tid)
+{
+    auto it = std::find_if(stats.begin(), stats.end(), [tid](const ThreadStats &s) { return s.tid == tid; });
+    return it == stats.end() ? nullptr : &*it;
+}
+
+} // namespace
+
+TEST(UT_PerfTrace, test_record_001)
+{
+    ThreadBuffer buffer(1, "worker");
+    buffer.record(kStageDirScan, 1000, 300);
+    buffer.record(kStageDirScan, 2000, 500);
+    buffer.record(kStagePaint, 3000, 100);
+    buffer.count(kCounterOpen, 2);
+    buffer.count(kCounterOpen, 3);
+
+    ThreadStats stats = buffer.stats();
+    EXPECT_EQ(stats.tid, 1);
+    EXPECT_EQ(stats.name, "worker");
+    EXPECT_EQ(stats.stages[kStageDirScan].count, 2u);
+    EXPECT_EQ(stats.stages[kStageDirScan].totalNs, 800u);
+    EXPECT_EQ(stats.stages[kStageDirScan].maxNs, 500u);
+    EXPECT_EQ(stats.stages[kStagePaint].count, 1u);
+    EXPECT_EQ(stats.stages[kStageMerge].count, 0u);
+    EXPECT_EQ(stats.counters[kCounterOpen], 5u);
+    EXPECT_EQ(stats.counters[kCounterRead], 0u);
+
+    std::vector<TraceEvent> events;
+    buffer.copyEvents(events);
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[0].begin, 1000);
+    EXPECT_EQ(events[2].stage, int(kStagePaint));
+    EXPECT_EQ(events[2].tid, 1);
+}
+
+TEST(UT_PerfTrace, test_record_002)
+{
+    // out of range stages are dropped
+    ThreadBuffer buffer(1, "worker");
+    buffer.record(kStageCount, 0, 10);
+    buffer.record(-1, 0, 10);
+
+    std::vector<TraceEvent> events;
+    buffer.copyEvents(events);
+    EXPECT_TRUE(events.empty());
+}
+
+TEST(UT_PerfTrace, test_ring_001)
+{
+    // the ring keeps the newest events once wrapped, totals keep counting
+    std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer(1, "worker"));
+    const int total = ThreadBuffer::kCapacity + 10;
+    for (int i = 0; i < total; ++i)
+        buffer->record(kStagePidRead, i, 1);
+
+    std::vector<TraceEvent> events;
+    buffer->copyEvents(events);
+    ASSERT_EQ(events.size(), size_t(ThreadBuffer::kCapacity));
+    EXPECT_EQ(events.front().begin, 10);
+    EXPECT_EQ(events.back().begin, total - 1);
+    EXPECT_EQ(buffer->stats().stages[kStagePidRead].count, uint64_t(total));
+}
+
+TEST(UT_PerfTrace, test_scoped_timer_001)
+{
+    int tid = int(syscall(SYS_gettid));
+    uint64_t before = 0;
+    if (const ThreadStats *stats = statsOf(collectStats(), tid))
+        before = stats->stages[kStageMerge].count;
+
+    {
+        ScopedTimer timer(kStageMerge);
+    }
+    count(kCounterReadDir, 4);
+
+    std::vector<ThreadStats> all = collectStats();
+    const ThreadStats *stats = statsOf(all, tid);
+    ASSERT_NE(stats, nullptr);
+    EXPECT_EQ(stats->stages[kStageMerge].count, before + 1);
+    EXPECT_GE(stats->counters[kCounterReadDir], 4u);
+}
+
+TEST(UT_PerfTrace, test_threads_001)
+{
+    int workerTid = 0;
+    std::thread worker([&workerTid]() {
+        workerTid = int(syscall(SYS_gettid));
+        record(kStageDKapture, nowNs(), 42);
+    });
+    worker.join();
+
+    // buffer of an exited thread is still exported
+    std::vector<ThreadStats> all = collectStats();
+    const ThreadStats *stats = statsOf(all, workerTid);
+    ASSERT_NE(stats, nullptr);
+    EXPECT_EQ(stats->stages[kStageDKapture].count, 1u);
+    EXPECT_EQ(stats->stages[kStageDKapture].totalNs, 42u);
+}
+
+TEST(UT_PerfTrace, test_chrome_trace_001)
+{
+    record(kStageModelDiff, 1500, 2500);
+
+    std::string json = chromeTraceJson();
+    EXPECT_EQ(json.compare(0, 15, "{\"traceEvents\":"), 0);
+    EXPECT_NE(json.find("\"name\":\"thread_name\""), std::string::npos);
+    EXPECT_NE(json.find("{\"name\":\"model diff\",\"cat\":\"sampling\",\"ph\":\"X\",\"ts\":1.500,\"dur\":2.500"),
+              std::string::npos);
+    EXPECT_NE(json.find("\"readdir\":"), std::string::npos);
+    EXPECT_EQ(json.back(), '}');
+}
+
+TEST(UT_PerfTrace, test_names_001)
+{
+    EXPECT_STREQ(stageName(kStageScan), "scan");
+    EXPECT_STREQ(stageName(kStageCount), "unknown");
+    EXPECT_STREQ(counterName(kCounterRead), "read");
+    EXPECT_STREQ(counterName(kCounterVanished), "vanished");
+    EXPECT_STREQ(counterName(-1), "unknown");
+}
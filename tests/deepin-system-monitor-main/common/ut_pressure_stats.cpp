@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/pressure_stats.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <unistd.h>
+
+using namespace common::pressure;
+
+class UT_PressureStats : public ::testing::Test
+{
+protected:
+    PressureStats m_tester;
+};
+
+TEST_F(UT_PressureStats, test_parsePressure_001)
+{
+    const char *memory = "some avg10=1.25 avg60=0.50 avg300=0.05 total=2184765\n"
+                         "full avg10=0.10 avg60=0.00 avg300=0.00 total=1052283\n";
+    pressure_t pressure;
+    ASSERT_TRUE(PressureStats::parsePressure(memory, strlen(memory), pressure));
+    EXPECT_TRUE(pressure.valid);
+    EXPECT_TRUE(pressure.hasFull);
+    EXPECT_DOUBLE_EQ(pressure.some.avg10, 1.25);
+    EXPECT_DOUBLE_EQ(pressure.some.avg60, 0.5);
+    EXPECT_DOUBLE_EQ(pressure.some.avg300, 0.05);
+    EXPECT_EQ(pressure.some.total, 2184765u);
+    EXPECT_DOUBLE_EQ(pressure.full.avg10, 0.1);
+    EXPECT_EQ(pressure.full.total, 1052283u);
+    EXPECT_FALSE(pressure.hasRates);
+}
+
+TEST_F(UT_PressureStats, test_parsePressure_002)
+{
+    // system wide cpu before linux 5.13
+    const char *cpu = "some avg10=12.00 avg60=8.40 avg300=3.10 total=99\n";
+    pressure_t pressure;
+    ASSERT_TRUE(PressureStats::parsePressure(cpu, strlen(cpu), pressure));
+    EXPECT_FALSE(pressure.hasFull);
+    EXPECT_DOUBLE_EQ(pressure.some.avg10, 12.);
+
+    const char *truncated = "some avg10=12.00 avg60=";
+    EXPECT_FALSE(PressureStats::parsePressure(truncated, strlen(truncated), pressure));
+    EXPECT_FALSE(PressureStats::parsePressure("", 0, pressure));
+}
+
+TEST_F(UT_PressureStats, test_sessionCgroup)
+{
+    EXPECT_EQ(PressureStats::sessionCgroup("/user.slice/user-1000.slice/user@1000.service/app.slice/dde.scope"),
+              QString("/user.slice/user-1000.slice"));
+    EXPECT_EQ(PressureStats::sessionCgroup("/user.slice/user-0.slice"), QString("/user.slice/user-0.slice"));
+    EXPECT_TRUE(PressureStats::sessionCgroup("/system.slice/deepin-system-monitor.service").isEmpty());
+    EXPECT_TRUE(PressureStats::sessionCgroup("/user.slice/user-1000.slicex").isEmpty());
+    EXPECT_TRUE(PressureStats::sessionCgroup({}).isEmpty());
+}
+
+TEST_F(UT_PressureStats, test_update)
+{
+    m_tester.update();
+    EXPECT_FALSE(m_tester.system(kCpuPressure).hasRates);
+    if (!PressureStats::isAvailable()) {
+        EXPECT_FALSE(m_tester.system(kCpuPressure).valid);
+        return;
+    }
+
+    // rates need time between the samples
+    usleep(20 * 1000);
+    m_tester.update();
+    for (int i = 0; i < kPressureResourceCount; ++i) {
+        const pressure_t &pressure = m_tester.system(PressureResource(i));
+        if (!pressure.valid)
+            continue;
+        EXPECT_TRUE(pressure.hasRates);
+        EXPECT_GE(pressure.someRate, 0.);
+        EXPECT_LE(pressure.someRate, 100.);
+    }
+
+    // no cgroup asked for
+    EXPECT_FALSE(m_tester.cgroup(kMemoryPressure).valid);
+    m_tester.clear();
+    EXPECT_FALSE(m_tester.system(kCpuPressure).valid);
+}
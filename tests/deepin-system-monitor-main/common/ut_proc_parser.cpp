@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/proc_parser.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+using namespace common::parser;
+
+TEST(UT_ProcParser, test_splitStatComm_001)
+{
+    const char buf[] = "1234 (tmux: server) (x) S 1 1234 1234 0 -1 4194624 2559 0 0 0 "
+                       "57 21 -3 -4 20 0 1 0 8421 14876672 1203 18446744073709551615 "
+                       "1 1 0 0 0 0 0 3674112 134433283 0 0 0 17 3 0 0 0 5 7\n";
+    const char *comm, *rest;
+    size_t commLen;
+    ASSERT_TRUE(splitStatComm(buf, sizeof(buf) - 1, comm, commLen, rest));
+    EXPECT_EQ(std::string(comm, commLen), "tmux: server) (x");
+
+    Tokenizer tok(rest, size_t(buf + sizeof(buf) - 1 - rest));
+    char state = 0;
+    int ppid = 0, pgid = 0;
+    unsigned long long utime = 0, stime = 0;
+    long long cutime = 0, cstime = 0;
+    EXPECT_TRUE(tok.readChar(state));
+    EXPECT_TRUE(tok.readInt(ppid));
+    EXPECT_TRUE(tok.readInt(pgid));
+    EXPECT_TRUE(tok.skipTokens(8));
+    EXPECT_TRUE(tok.readU64(utime));
+    EXPECT_TRUE(tok.readU64(stime));
+    EXPECT_TRUE(tok.readI64(cutime));
+    EXPECT_TRUE(tok.readI64(cstime));
+    EXPECT_EQ(state, 'S');
+    EXPECT_EQ(ppid, 1);
+    EXPECT_EQ(pgid, 1234);
+    EXPECT_EQ(utime, 57ull);
+    EXPECT_EQ(stime, 21ull);
+    EXPECT_EQ(cutime, -3);
+    EXPECT_EQ(cstime, -4);
+}
+
+TEST(UT_ProcParser, test_splitStatComm_002)
+{
+    const char *comm, *rest;
+    size_t commLen;
+    EXPECT_FALSE(splitStatComm("1234 bash S 1", 13, comm, commLen, rest));
+    EXPECT_FALSE(splitStatComm("1234 (bash S 1", 14, comm, commLen, rest));
+}
+
+TEST(UT_ProcParser, test_readU64_001)
+{
+    // statm
+    Tokenizer tok("5012 1203 812 245 0 1404 0\n");
+    unsigned long long vmsize = 0, rss = 0, shm = 0;
+    EXPECT_TRUE(tok.readU64(vmsize));
+    EXPECT_TRUE(tok.readU64(rss));
+    EXPECT_TRUE(tok.readU64(shm));
+    EXPECT_EQ(vmsize, 5012ull);
+    EXPECT_EQ(rss, 1203ull);
+    EXPECT_EQ(shm, 812ull);
+}
+
+TEST(UT_ProcParser, test_readU64_002)
+{
+    // field reads must not cross line break
+    Tokenizer tok("cpu0 1 2\ncpu1 3 4\n");
+    unsigned long long v = 0;
+    EXPECT_TRUE(tok.consume("cpu", 3));
+    EXPECT_TRUE(tok.skipTokens(1));
+    EXPECT_TRUE(tok.readU64(v));
+    EXPECT_TRUE(tok.readU64(v));
+    EXPECT_EQ(v, 2ull);
+    EXPECT_FALSE(tok.readU64(v));
+    EXPECT_TRUE(tok.nextLine());
+    EXPECT_TRUE(tok.consume("cpu1", 4));
+    EXPECT_TRUE(tok.readU64(v));
+    EXPECT_EQ(v, 3ull);
+}
+
+TEST(UT_ProcParser, test_readKey_001)
+{
+    // /proc/[pid]/io
+    const char buf[] = "rchar: 323934931\n"
+                       "wchar: 323929600\n"
+                       "syscr: 632687\n"
+                       "syscw: 632675\n"
+                       "read_bytes: 4096\n"
+                       "write_bytes: 8192\n"
+                       "cancelled_write_bytes: 1024\n";
+    Tokenizer tok(buf, sizeof(buf) - 1);
+    const char *key;
+    size_t len;
+    unsigned long long rbytes = 0, wbytes = 0, cbytes = 0;
+    int lines = 0;
+    do {
+        if (!tok.readKey(key, len))
+            continue;
+        ++lines;
+        if (keyEquals(key, len, "read_bytes", 10))
+            tok.readU64(rbytes);
+        else if (keyEquals(key, len, "write_bytes", 11))
+            tok.readU64(wbytes);
+        else if (keyEquals(key, len, "cancelled_write_bytes", 21))
+            tok.readU64(cbytes);
+    } while (tok.nextLine());
+
+    EXPECT_EQ(lines, 7);
+    EXPECT_EQ(rbytes, 4096ull);
+    EXPECT_EQ(wbytes, 8192ull);
+    EXPECT_EQ(cbytes, 1024ull);
+}
+
+TEST(UT_ProcParser, test_readKey_002)
+{
+    // /proc/meminfo & diskstats styled lines
+    Tokenizer mem("MemTotal:       16149756 kB\n");
+    const char *key;
+    size_t len;
+    unsigned long long v = 0;
+    ASSERT_TRUE(mem.readKey(key, len));
+    EXPECT_TRUE(keyEquals(key, len, "MemTotal", 8));
+    EXPECT_FALSE(keyEquals(key, len, "MemTot", 6));
+    EXPECT_TRUE(mem.readU64(v));
+    EXPECT_EQ(v, 16149756ull);
+
+    Tokenizer disk("   8       0 sda 85648 24574 5379704 31927 97833 82962 4637258\n");
+    unsigned int major = 0, minor = 0;
+    const char *name;
+    EXPECT_TRUE(disk.readUInt(major));
+    EXPECT_TRUE(disk.readUInt(minor));
+    EXPECT_TRUE(disk.readToken(name, len));
+    EXPECT_EQ(std::string(name, len), "sda");
+    EXPECT_TRUE(disk.readU64(v));
+    EXPECT_EQ(v, 85648ull);
+    EXPECT_TRUE(disk.skipTokens(6));
+    EXPECT_FALSE(disk.skipTokens(1));
+}
@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/rapl_reader.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#include <string>
+
+using namespace common::power;
+
+class UT_RaplReader : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        char dir[] = "/tmp/ut_rapl_reader_XXXXXX";
+        ASSERT_NE(mkdtemp(dir), nullptr);
+        m_root = dir;
+    }
+
+    void TearDown() override
+    {
+        std::string cmd = "rm -rf " + m_root;
+        EXPECT_EQ(system(cmd.c_str()), 0);
+    }
+
+    void writeFile(const char *zone, const char *name, const char *content)
+    {
+        std::string path = m_root + "/" + zone;
+        mkdir(path.c_str(), 0755);
+        path += std::string("/") + name;
+        FILE *fp = fopen(path.c_str(), "w");
+        ASSERT_NE(fp, nullptr);
+        fputs(content, fp);
+        fclose(fp);
+    }
+
+    static rapl_sample_t sample(double time, uint64_t package, uint64_t core)
+    {
+        rapl_sample_t s;
+        s.time = time;
+        s.counters = {{"intel-rapl:0", false, package, 262143328850ull}, {"intel-rapl:0:0", true, core, 0}};
+        return s;
+    }
+
+    std::string m_root;
+};
+
+TEST_F(UT_RaplReader, test_energyDelta)
+{
+    EXPECT_EQ(RaplReader::energyDelta(10, 90, 100), 80u);
+    // wrapped once past the range
+    EXPECT_EQ(RaplReader::energyDelta(90, 10, 100), 20u);
+    // wrapped without a known range
+    EXPECT_EQ(RaplReader::energyDelta(90, 10, 0), 0u);
+}
+
+TEST_F(UT_RaplReader, test_powerBetween)
+{
+    rapl_power_t power;
+    ASSERT_TRUE(RaplReader::powerBetween(sample(1, 1000000, 500000), sample(3, 21000000, 8500000), power));
+    EXPECT_DOUBLE_EQ(power.package, 10.);
+    EXPECT_DOUBLE_EQ(power.core, 4.);
+
+    // no time passed
+    EXPECT_FALSE(RaplReader::powerBetween(sample(3, 0, 0), sample(3, 1, 1), power));
+}
+
+TEST_F(UT_RaplReader, test_zones)
+{
+    writeFile("intel-rapl:0", "name", "package-0\n");
+    writeFile("intel-rapl:0", "energy_uj", "1000000\n");
+    writeFile("intel-rapl:0", "max_energy_range_uj", "262143328850\n");
+    writeFile("intel-rapl:0:0", "name", "core\n");
+    writeFile("intel-rapl:0:0", "energy_uj", "500000\n");
+    // left out, counted in the package or overlapping it
+    writeFile("intel-rapl:0:1", "name", "uncore\n");
+    writeFile("intel-rapl:0:1", "energy_uj", "1\n");
+    writeFile("intel-rapl:1", "name", "psys\n");
+    writeFile("intel-rapl:1", "energy_uj", "1\n");
+    writeFile("intel-rapl-mmio:0", "name", "package-0\n");
+    writeFile("intel-rapl-mmio:0", "energy_uj", "1\n");
+
+    RaplReader reader(m_root.c_str());
+    EXPECT_TRUE(reader.isAvailable());
+    rapl_sample_t counters;
+    ASSERT_TRUE(reader.readCounters(counters));
+    ASSERT_EQ(counters.counters.size(), 2u);
+
+    // the first read has nothing to compare with
+    rapl_power_t power;
+    EXPECT_FALSE(reader.read(power));
+    writeFile("intel-rapl:0", "energy_uj", "3000000\n");
+    EXPECT_TRUE(reader.read(power));
+    EXPECT_GT(power.package, 0);
+}
+
+TEST_F(UT_RaplReader, test_counterSource)
+{
+    RaplReader none("/nonexistent");
+    none.setCounterSource([](rapl_sample_t &) { return true; });
+    // no package zone, the source isn't asked
+    EXPECT_FALSE(none.isAvailable());
+
+    // package zone without a readable energy_uj
+    writeFile("intel-rapl:0", "name", "package-0\n");
+    RaplReader reader(m_root.c_str());
+    EXPECT_FALSE(reader.isAvailable());
+
+    int calls = 0;
+    reader.setCounterSource([&](rapl_sample_t &s) {
+        ++calls;
+        s = calls < 3 ? sample(1, 1000000, 500000) : sample(3, 21000000, 8500000);
+        return true;
+    });
+    EXPECT_TRUE(reader.isAvailable());
+
+    rapl_power_t power;
+    EXPECT_FALSE(reader.read(power));
+    // cached by the source
+    EXPECT_FALSE(reader.read(power));
+    EXPECT_TRUE(reader.read(power));
+    EXPECT_DOUBLE_EQ(power.package, 10.);
+    EXPECT_TRUE(reader.read(power));
+    EXPECT_DOUBLE_EQ(power.package, 10.);
+}
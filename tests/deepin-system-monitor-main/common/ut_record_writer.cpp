@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/record_writer.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//qt
+#include <QBuffer>
+
+#include <cmath>
+
+#include <string.h>
+
+using namespace common::record;
+
+namespace {
+
+QByteArray csv(const char *text)
+{
+    QByteArray out;
+    RecordWriter::appendCsv(out, text, int(strlen(text)));
+    return out;
+}
+
+QByteArray json(const char *text)
+{
+    QByteArray out;
+    RecordWriter::appendJson(out, text, int(strlen(text)));
+    return out;
+}
+
+} // namespace
+
+TEST(UT_RecordWriter, test_appendCsv_001)
+{
+    EXPECT_EQ(csv("bash"), QByteArray("bash"));
+    EXPECT_EQ(csv(""), QByteArray(""));
+    EXPECT_EQ(csv("a,b"), QByteArray("\"a,b\""));
+    EXPECT_EQ(csv("say \"hi\""), QByteArray("\"say \"\"hi\"\"\""));
+    EXPECT_EQ(csv("two\nlines"), QByteArray("\"two\nlines\""));
+    EXPECT_EQ(csv(" padded"), QByteArray("\" padded\""));
+}
+
+TEST(UT_RecordWriter, test_appendJson_001)
+{
+    EXPECT_EQ(json("bash"), QByteArray("\"bash\""));
+    EXPECT_EQ(json("C:\\ \"x\""), QByteArray("\"C:\\\\ \\\"x\\\"\""));
+    EXPECT_EQ(json("a\tb\n\x01"), QByteArray("\"a\\tb\\n\\u0001\""));
+    // utf-8 as is
+    EXPECT_EQ(json("\xe8\xbf\x9b\xe7\xa8\x8b"), QByteArray("\"\xe8\xbf\x9b\xe7\xa8\x8b\""));
+}
+
+TEST(UT_RecordWriter, test_csv_001)
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    {
+        RecordWriter writer(&buffer, RecordWriter::kCsv, {"pid", "name", "cpu"});
+        writer.add(qint64(42));
+        writer.add(QString("web, worker"));
+        writer.add(12.5);
+        EXPECT_TRUE(writer.endRecord());
+        // missing & invalid fields are empty
+        writer.add(qint64(-1));
+        writer.add(QString());
+        writer.add(std::nan(""));
+        EXPECT_TRUE(writer.endRecord());
+        writer.add(qint64(7));
+        EXPECT_TRUE(writer.endRecord());
+        EXPECT_TRUE(writer.finish());
+        EXPECT_EQ(writer.records(), 3);
+    }
+    EXPECT_EQ(buffer.data(), QByteArray("pid,name,cpu\n42,\"web, worker\",12.5\n-1,,\n7,,\n"));
+}
+
+TEST(UT_RecordWriter, test_jsonLines_001)
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    RecordWriter writer(&buffer, RecordWriter::kJsonLines, {"pid", "name", "cpu"});
+    writer.add(qint64(42));
+    writer.add(QString("say \"hi\""));
+    writer.add(0.1 + 0.2);
+    writer.endRecord();
+    writer.add(qint64(7));
+    writer.add(QString());
+    writer.add(std::nan(""));
+    writer.endRecord();
+    ASSERT_TRUE(writer.finish());
+    EXPECT_EQ(buffer.data(), QByteArray("{\"pid\":42,\"name\":\"say \\\"hi\\\"\",\"cpu\":0.3}\n"
+                                        "{\"pid\":7,\"name\":\"\",\"cpu\":null}\n"));
+}
+
+TEST(UT_RecordWriter, test_flush_001)
+{
+    // written in chunks while records come in
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    RecordWriter writer(&buffer, RecordWriter::kCsv, {"value"});
+    const QString text(1000, 'x');
+    for (int i = 0; i < RecordWriter::kFlushSize / 1000 + 10; ++i) {
+        writer.add(text);
+        writer.endRecord();
+    }
+    EXPECT_GE(buffer.size(), RecordWriter::kFlushSize);
+    EXPECT_TRUE(writer.finish());
+
+    // a device that can't be written fails the records
+    QBuffer closed;
+    RecordWriter failing(&closed, RecordWriter::kCsv, {"value"});
+    failing.add(qint64(1));
+    failing.endRecord();
+    EXPECT_FALSE(failing.finish());
+}
+
+TEST(UT_RecordWriter, test_formatOf_001)
+{
+    EXPECT_EQ(RecordWriter::formatOf("/tmp/a.csv"), RecordWriter::kCsv);
+    EXPECT_EQ(RecordWriter::formatOf("/tmp/a.JSONL"), RecordWriter::kJsonLines);
+    EXPECT_EQ(RecordWriter::formatOf("/tmp/a.ndjson"), RecordWriter::kJsonLines);
+    EXPECT_EQ(RecordWriter::formatOf("/tmp/a"), RecordWriter::kCsv);
+}
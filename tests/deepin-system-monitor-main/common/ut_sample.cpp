@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/sample.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+using RealSample = Sample<qreal>;
+using RealSampleFrame = SampleFrame<qreal>;
+
+TEST(UT_Sample, test_addSample_001)
+{
+    // kNoPeriod keeps 2 frames
+    RealSample sample(TimePeriod(TimePeriod::kNoPeriod, {2, 0}));
+    EXPECT_EQ(sample.count(), 0);
+    EXPECT_EQ(sample.recentSample(), nullptr);
+
+    sample.addSample(RealSampleFrame(1.));
+    EXPECT_EQ(sample.count(), 1);
+    EXPECT_EQ(sample.recentSample()->data, 1.);
+
+    sample.addSample(RealSampleFrame(2.));
+    sample.addSample(RealSampleFrame(3.));
+    EXPECT_EQ(sample.count(), 2);
+    EXPECT_EQ(sample.recentSample()->data, 3.);
+
+    auto pair = sample.recentSamplePair();
+    ASSERT_TRUE(pair.first && pair.second);
+    EXPECT_EQ(pair.first->data, 2.);
+    EXPECT_EQ(pair.second->data, 3.);
+    EXPECT_EQ(sample.sample(2), nullptr);
+}
+
+TEST(UT_Sample, test_addSample_002)
+{
+    // 1 minute of 2 seconds interval
+    RealSample sample(TimePeriod(TimePeriod::k1Min, {2, 0}));
+    for (int i = 0; i < 100; ++i)
+        sample.addSample(RealSampleFrame(i));
+
+    EXPECT_EQ(sample.count(), 30);
+    for (int i = 0; i < sample.count(); ++i)
+        EXPECT_EQ(sample.sample(i)->data, qreal(70 + i));
+    EXPECT_EQ(sample.recentSample()->data, 99.);
+}
+
+TEST(UT_Sample, test_updateTimePeriod_001)
+{
+    RealSample sample(TimePeriod(TimePeriod::k1Min, {2, 0}));
+    for (int i = 0; i < 35; ++i)
+        sample.addSample(RealSampleFrame(i));
+
+    // shrink keeps newest frames in order
+    sample.updateTimePeriod(TimePeriod(TimePeriod::kNoPeriod, {2, 0}));
+    EXPECT_EQ(sample.count(), 2);
+    EXPECT_EQ(sample.sample(0)->data, 33.);
+    EXPECT_EQ(sample.sample(1)->data, 34.);
+
+    sample.addSample(RealSampleFrame(35.));
+    EXPECT_EQ(sample.sample(0)->data, 34.);
+    EXPECT_EQ(sample.sample(1)->data, 35.);
+
+    // grow keeps existing frames
+    sample.updateTimePeriod(TimePeriod(TimePeriod::k1Min, {2, 0}));
+    sample.addSample(RealSampleFrame(36.));
+    EXPECT_EQ(sample.count(), 3);
+    EXPECT_EQ(sample.sample(0)->data, 34.);
+
+    // interval change drops history
+    sample.updateTimePeriod(TimePeriod(TimePeriod::k1Min, {1, 0}));
+    EXPECT_EQ(sample.count(), 0);
+}
+
+TEST(UT_Sample, test_copy_001)
+{
+    RealSample sample(TimePeriod(TimePeriod::kNoPeriod, {2, 0}));
+    sample.addSample(RealSampleFrame(1.));
+    sample.addSample(RealSampleFrame(2.));
+    sample.addSample(RealSampleFrame(3.));
+
+    RealSample copy(sample);
+    copy.addSample(RealSampleFrame(4.));
+    EXPECT_EQ(sample.recentSample()->data, 3.);
+    EXPECT_EQ(copy.recentSample()->data, 4.);
+    EXPECT_EQ(copy.sample(0)->data, 3.);
+}
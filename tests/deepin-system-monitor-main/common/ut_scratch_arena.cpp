@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/scratch_arena.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+using namespace common::alloc;
+
+namespace {
+struct record_t {
+    int pid;
+    double value;
+};
+}
+
+TEST(UT_ScratchArena, test_allocate_001)
+{
+    ScratchArena arena;
+    char *buf = arena.buffer(3);
+    record_t *rec = arena.create<record_t>(record_t {42, 1.5});
+    EXPECT_NE(buf, nullptr);
+    EXPECT_EQ(uintptr_t(rec) % alignof(record_t), 0u);
+    EXPECT_EQ(rec->pid, 42);
+    EXPECT_GE(arena.used(), 3 + sizeof(record_t));
+    EXPECT_EQ(arena.capacity(), size_t(ScratchArena::kBlockSize));
+}
+
+TEST(UT_ScratchArena, test_reset_001)
+{
+    ScratchArena arena;
+    arena.buffer(ScratchArena::kBlockSize / 2);
+    arena.buffer(ScratchArena::kBlockSize);
+    size_t capacity = arena.capacity();
+    EXPECT_GT(capacity, size_t(ScratchArena::kBlockSize));
+
+    // merged into one block, the same pass then fits without growing
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0u);
+    EXPECT_EQ(arena.capacity(), capacity);
+    arena.buffer(ScratchArena::kBlockSize / 2);
+    arena.buffer(ScratchArena::kBlockSize);
+    EXPECT_EQ(arena.capacity(), capacity);
+}
+
+TEST(UT_ScratchArena, test_readFile_001)
+{
+    ScratchArena arena;
+    size_t len = 0;
+    // larger than the first read buffer on any host
+    const char *buf = arena.readFile("/proc/self/smaps", len);
+    ASSERT_NE(buf, nullptr);
+    EXPECT_GT(len, 0u);
+    EXPECT_EQ(strlen(buf), len);
+
+    errno = 0;
+    EXPECT_EQ(arena.readFile("/proc/self/no-such-file", len), nullptr);
+    EXPECT_EQ(errno, ENOENT);
+}
@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/self_stats.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <unistd.h>
+
+using namespace common::selfstats;
+using namespace common::trace;
+
+TEST(UT_SelfStats, test_parseTaskStat_001)
+{
+    const char *stat = "4242 (Netif Monitor) S 1 4242 4242 0 -1 4194368 120 0 0 0 "
+                       "75 25 0 0 20 0 9 0 1234 123456789 4321 18446744073709551615\n";
+    std::string name;
+    unsigned long long ticks = 0;
+    EXPECT_TRUE(SelfStatsSampler::parseTaskStat(stat, strlen(stat), name, ticks));
+    EXPECT_EQ(name, "Netif Monitor");
+    EXPECT_EQ(ticks, 100u);
+
+    const char *broken = "4242 (short) S 1 2\n";
+    EXPECT_FALSE(SelfStatsSampler::parseTaskStat(broken, strlen(broken), name, ticks));
+}
+
+TEST(UT_SelfStats, test_parseVoluntarySwitches_001)
+{
+    const char *status = "Name:\tSystemMonitor\nState:\tS (sleeping)\n"
+                         "voluntary_ctxt_switches:\t1500\nnonvoluntary_ctxt_switches:\t30\n";
+    unsigned long long switches = 0;
+    EXPECT_TRUE(SelfStatsSampler::parseVoluntarySwitches(status, strlen(status), switches));
+    EXPECT_EQ(switches, 1500u);
+
+    const char *other = "Name:\tSystemMonitor\nnonvoluntary_ctxt_switches:\t30\n";
+    EXPECT_FALSE(SelfStatsSampler::parseVoluntarySwitches(other, strlen(other), switches));
+}
+
+TEST(UT_SelfStats, test_sample_001)
+{
+    SelfStatsSampler sampler;
+    SelfStatsReport report;
+    ASSERT_TRUE(sampler.sample(report));
+    EXPECT_EQ(report.interval, 0);
+    EXPECT_FALSE(report.threads.empty());
+    EXPECT_GT(report.rss, 0u);
+    EXPECT_GT(report.heapMapped, 0u);
+
+    {
+        ScopedTimer timer(kStageMerge);
+        usleep(2000);
+    }
+    ASSERT_TRUE(sampler.sample(report));
+    EXPECT_GT(report.interval, 0);
+    EXPECT_EQ(report.stages[kStageMerge].count, 1u);
+    EXPECT_GE(report.stages[kStageMerge].avgMs, 1.);
+
+    // stage counts are per sample
+    ASSERT_TRUE(sampler.sample(report));
+    EXPECT_EQ(report.stages[kStageMerge].count, 0u);
+}
+
+TEST(UT_SelfStats, test_sample_002)
+{
+    SelfStatsSampler sampler("/nonexistent");
+    SelfStatsReport report;
+    EXPECT_FALSE(sampler.sample(report));
+}
+
+TEST(UT_SelfStats, test_samplingTimePerRefresh_001)
+{
+    SelfStatsReport report;
+    ThreadUsage sampler;
+    sampler.name = "SystemMonitor";
+    sampler.cpuPercent = 20;
+    report.threads.push_back(sampler);
+
+    // untraced, cpu time of the sampling thread
+    EXPECT_DOUBLE_EQ(samplingTimePerRefresh(report, 1000, "SystemMonitor"), 200.);
+    EXPECT_DOUBLE_EQ(samplingTimePerRefresh(report, 1000, "Other"), 0.);
+
+    report.stages[kStageScan].count = 2;
+    report.stages[kStageScan].avgMs = 35;
+    EXPECT_DOUBLE_EQ(samplingTimePerRefresh(report, 1000, "SystemMonitor"), 35.);
+}
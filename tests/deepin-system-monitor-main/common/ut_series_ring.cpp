@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/series_ring.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+using namespace common::core;
+
+TEST(UT_SeriesRing, test_push)
+{
+    SeriesRing ring(3);
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.max(), 0.);
+
+    for (int i = 1; i <= 4; ++i)
+        ring.push(i);
+    // oldest sample dropped
+    ASSERT_EQ(ring.size(), size_t(3));
+    EXPECT_EQ(ring.at(0), 2.);
+    EXPECT_EQ(ring.last(), 4.);
+    EXPECT_EQ(ring.seq(), uint64_t(4));
+}
+
+TEST(UT_SeriesRing, test_max)
+{
+    SeriesRing ring(3);
+    ring.push(9);
+    ring.push(1);
+    ring.push(5);
+    EXPECT_EQ(ring.max(), 9.);
+    // 9 evicted
+    ring.push(2);
+    EXPECT_EQ(ring.max(), 5.);
+    ring.push(0);
+    ring.push(0);
+    EXPECT_EQ(ring.max(), 2.);
+    ring.push(0);
+    EXPECT_EQ(ring.max(), 0.);
+
+    ring.clear();
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.max(), 0.);
+}
+
+TEST(UT_SeriesRing, test_recent)
+{
+    SeriesRing ring(3);
+    EXPECT_EQ(ring.recent(0), 0.);
+    ring.push(1);
+    ring.push(2);
+    EXPECT_EQ(ring.recent(0), 2.);
+    EXPECT_EQ(ring.recent(1), 1.);
+    // not held
+    EXPECT_EQ(ring.recent(2), 0.);
+}
+
+TEST(UT_SeriesRing, test_resample)
+{
+    // 2s samples 0, 2, 4 ... 20 of a ramp, to 1s
+    SeriesRing ring(31);
+    for (int i = 0; i <= 10; ++i)
+        ring.push(i * 2);
+    uint64_t seq = ring.seq();
+    ring.resample(0.5);
+    ASSERT_EQ(ring.size(), size_t(21));
+    EXPECT_EQ(ring.last(), 20.);
+    EXPECT_EQ(ring.recent(1), 19.);
+    EXPECT_EQ(ring.at(0), 0.);
+    EXPECT_EQ(ring.max(), 20.);
+    // followers rebuild
+    EXPECT_GT(ring.seq(), seq + ring.capacity());
+
+    // to 5s, the span held limits the samples
+    ring.resample(5);
+    ASSERT_EQ(ring.size(), size_t(5));
+    EXPECT_EQ(ring.last(), 20.);
+    EXPECT_EQ(ring.recent(1), 15.);
+    EXPECT_EQ(ring.at(0), 0.);
+
+    // the capacity too
+    SeriesRing small(3);
+    for (int i = 0; i < 3; ++i)
+        small.push(i);
+    small.resample(0.25);
+    ASSERT_EQ(small.size(), size_t(3));
+    EXPECT_DOUBLE_EQ(small.recent(2), 1.5);
+
+    SeriesRing empty(3);
+    empty.resample(2);
+    EXPECT_TRUE(empty.empty());
+}
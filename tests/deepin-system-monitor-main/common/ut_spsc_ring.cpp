@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/spsc_ring.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace common::core;
+
+TEST(UT_SPSCRing, test_capacity)
+{
+    SPSCRing<int> ring(100);
+    EXPECT_EQ(ring.capacity(), size_t(128));
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(UT_SPSCRing, test_push_consume)
+{
+    SPSCRing<int> ring(4);
+    for (int i = 0; i < 4; ++i)
+        EXPECT_TRUE(ring.push(i));
+    // full
+    EXPECT_FALSE(ring.push(4));
+
+    int sum = 0;
+    EXPECT_EQ(ring.consume([&sum](int v) { sum += v; }), size_t(4));
+    EXPECT_EQ(sum, 6);
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.consume([](int) {}), size_t(0));
+
+    // slots are reusable after consume
+    EXPECT_TRUE(ring.push(7));
+    EXPECT_FALSE(ring.empty());
+}
+
+TEST(UT_SPSCRing, test_threads)
+{
+    const int count = 100000;
+    SPSCRing<int> ring(256);
+
+    std::thread producer([&ring]() {
+        for (int i = 0; i < count; ++i) {
+            while (!ring.push(i))
+                std::this_thread::yield();
+        }
+    });
+
+    int expected = 0;
+    bool ordered = true;
+    while (expected < count) {
+        ring.consume([&](int v) {
+            ordered = ordered && v == expected;
+            ++expected;
+        });
+    }
+    producer.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(ring.empty());
+}
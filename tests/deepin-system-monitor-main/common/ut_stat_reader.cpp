@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/stat_reader.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+using namespace common::parser;
+
+TEST(UT_StatReader, test_parse_001)
+{
+    const char buf[] = "cpu  7048360 4246 3733400 801045435 846386 0 929664 12 300 7\n"
+                       "cpu0 881045 530 466675 100130679 105798 0 116208 0 0 0\n"
+                       "intr 1114026553 9 0 0 0";
+    CpuStatFields fields;
+    ASSERT_TRUE(StatReader::parse(buf, sizeof(buf) - 1, fields));
+    EXPECT_EQ(fields.user, 7048360ull);
+    EXPECT_EQ(fields.idle, 801045435ull);
+    EXPECT_EQ(fields.softirq, 929664ull);
+    EXPECT_EQ(fields.steal, 12ull);
+    EXPECT_EQ(fields.guestNice, 7ull);
+    // guest time is part of user & nice already
+    EXPECT_EQ(fields.total(), 7048360ull + 4246 + 3733400 + 801045435 + 846386 + 929664 + 12);
+    EXPECT_EQ(fields.idleTotal(), 801045435ull + 846386);
+
+    // beyond 32 bit on long running many core hosts
+    const char big[] = "cpu  8589934592 0 1 2\n";
+    ASSERT_TRUE(StatReader::parse(big, sizeof(big) - 1, fields));
+    EXPECT_EQ(fields.user, 8589934592ull);
+}
+
+TEST(UT_StatReader, test_parse_002)
+{
+    // old kernels print only the first fields
+    const char old[] = "cpu  100 2 30 4000\n";
+    CpuStatFields fields;
+    ASSERT_TRUE(StatReader::parse(old, sizeof(old) - 1, fields));
+    EXPECT_EQ(fields.idle, 4000ull);
+    EXPECT_EQ(fields.iowait, 0ull);
+    EXPECT_EQ(fields.total(), 4132ull);
+
+    // cut by the buffer end
+    const char cut[] = "cpu  100 2 30 4000";
+    EXPECT_FALSE(StatReader::parse(cut, sizeof(cut) - 1, fields));
+    const char percpu[] = "cpu0 100 2 30 4000\n";
+    EXPECT_FALSE(StatReader::parse(percpu, sizeof(percpu) - 1, fields));
+    const char few[] = "cpu  100 2 30\n";
+    EXPECT_FALSE(StatReader::parse(few, sizeof(few) - 1, fields));
+}
+
+TEST(UT_StatReader, test_read_001)
+{
+    StatReader reader;
+    CpuStatFields first, second;
+    ASSERT_TRUE(reader.read(first));
+    ASSERT_TRUE(reader.read(second));
+    EXPECT_GE(second.total(), first.total());
+
+    StatReader missing("/nonexistent/stat");
+    EXPECT_FALSE(missing.read(first));
+}
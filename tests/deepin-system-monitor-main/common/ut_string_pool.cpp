@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/string_pool.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+using namespace common::intern;
+
+TEST(UT_StringPool, test_fromUtf8_001)
+{
+    StringPool pool;
+    const char comm[] = "kworker/0:1";
+    QString a = pool.fromUtf8(comm, int(sizeof(comm) - 1));
+    QString b = pool.fromUtf8(QByteArray(comm));
+    EXPECT_EQ(a, QString("kworker/0:1"));
+    EXPECT_EQ(a.constData(), b.constData());
+    EXPECT_NE(pool.fromUtf8("chrome", 6).constData(), a.constData());
+    EXPECT_EQ(pool.size(), 2);
+}
+
+TEST(UT_StringPool, test_intern_001)
+{
+    StringPool pool;
+    QString a = pool.intern(QString("dde-shell"));
+    QString b = pool.intern(QString("dde-") + QString("shell"));
+    EXPECT_EQ(a.constData(), b.constData());
+
+    // raw data of the caller is copied when inserted
+    char buf[] = "/usr/bin/python3";
+    QByteArray token = pool.intern(QByteArray::fromRawData(buf, int(sizeof(buf) - 1)));
+    buf[0] = 'x';
+    EXPECT_EQ(token, QByteArray("/usr/bin/python3"));
+    EXPECT_EQ(pool.intern(QByteArray("/usr/bin/python3")).constData(), token.constData());
+}
+
+TEST(UT_StringPool, test_prune_001)
+{
+    StringPool pool;
+    QString kept = pool.intern(QString("bash"));
+    pool.intern(QString("gone"));
+    pool.intern(QByteArray("--gone"));
+    pool.fromUtf8("gone", 4);
+    EXPECT_EQ(pool.size(), 4);
+
+    EXPECT_EQ(pool.prune(), 3);
+    EXPECT_EQ(pool.size(), 1);
+    EXPECT_EQ(pool.intern(QString("bash")).constData(), kept.constData());
+}
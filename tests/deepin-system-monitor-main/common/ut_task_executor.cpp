@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/task_executor.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace common::core;
+
+TEST(UT_TaskExecutor, test_run_001)
+{
+    TaskExecutor executor;
+    QFuture<int> future = executor.run(TaskExecutor::kSamplingTask, []() { return 42; });
+    EXPECT_EQ(future.result(), 42);
+
+    int calls = 0;
+    executor.run(TaskExecutor::kIOTask, [&calls]() { ++calls; }).waitForFinished();
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(UT_TaskExecutor, test_run_002)
+{
+    TaskExecutor executor;
+    errno = 0;
+    int base = getpriority(PRIO_PROCESS, 0);
+    // background threads are niced, never above what the process started at
+    int nice = executor.run(TaskExecutor::kBackgroundTask, []() {
+        return getpriority(PRIO_PROCESS, id_t(syscall(SYS_gettid)));
+    }).result();
+    EXPECT_EQ(nice, qMax(base, TaskExecutor::niceOf(TaskExecutor::kBackgroundTask)));
+}
+
+TEST(UT_TaskExecutor, test_setMaxThreadCount_001)
+{
+    TaskExecutor executor;
+    executor.setMaxThreadCount(TaskExecutor::kSamplingTask, 3);
+    EXPECT_EQ(executor.maxThreadCount(TaskExecutor::kSamplingTask), 3);
+    executor.setMaxThreadCount(TaskExecutor::kSamplingTask, 0);
+    EXPECT_EQ(executor.maxThreadCount(TaskExecutor::kSamplingTask), 1);
+    EXPECT_GE(executor.maxThreadCount(TaskExecutor::kIOTask), 4);
+}
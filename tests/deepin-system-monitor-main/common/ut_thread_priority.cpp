@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/thread_priority.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <errno.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace common::core;
+
+TEST(UT_ThreadPriority, test_parsePriority_001)
+{
+    EXPECT_EQ(ThreadPriority::parsePriority("low"), ThreadPriority::kLowPriority);
+    EXPECT_EQ(ThreadPriority::parsePriority(" Idle "), ThreadPriority::kIdlePriority);
+    EXPECT_EQ(ThreadPriority::parsePriority("normal"), ThreadPriority::kNormalPriority);
+    EXPECT_EQ(ThreadPriority::parsePriority("realtime"), ThreadPriority::kNormalPriority);
+}
+
+TEST(UT_ThreadPriority, test_ioPriorityOf_001)
+{
+    EXPECT_EQ(ThreadPriority::ioPriorityOf(ThreadPriority::kNormalPriority), 0);
+    EXPECT_EQ(ThreadPriority::ioPriorityOf(ThreadPriority::kLowPriority), (2 << 13) | 7);
+    EXPECT_EQ(ThreadPriority::ioPriorityOf(ThreadPriority::kIdlePriority), 3 << 13);
+}
+
+TEST(UT_ThreadPriority, test_apply_001)
+{
+    errno = 0;
+    int base = getpriority(PRIO_PROCESS, 0);
+    int nice = 0;
+    int policy = -1;
+    std::thread worker([&nice, &policy]() {
+        ThreadPriority(ThreadPriority::kLowPriority).apply();
+        nice = getpriority(PRIO_PROCESS, id_t(syscall(SYS_gettid)));
+        ThreadPriority(ThreadPriority::kIdlePriority).apply();
+        policy = sched_getscheduler(0);
+    });
+    worker.join();
+    EXPECT_EQ(nice, qMax(base, 10));
+    EXPECT_EQ(policy, SCHED_IDLE);
+    // the calling thread is left alone
+    EXPECT_EQ(getpriority(PRIO_PROCESS, 0), base);
+    EXPECT_NE(sched_getscheduler(0), SCHED_IDLE);
+}
@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/trace_log.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+using namespace common::log;
+
+namespace {
+
+LogEntry entryOf(int level, const char *message)
+{
+    LogEntry entry;
+    entry.level = level;
+    entry.site = "test.cpp:1";
+    strncpy(entry.message, message, sizeof(entry.message) - 1);
+    return entry;
+}
+
+int g_forwarded = 0;
+void countForwarded(const LogEntry &)
+{
+    ++g_forwarded;
+}
+
+} // namespace
+
+TEST(UT_TraceLog, test_rateLimit_001)
+{
+    RateLimit limit(2, 1000);
+    uint32_t suppressed = 99;
+    EXPECT_TRUE(limit.allow(0, suppressed));
+    EXPECT_EQ(suppressed, 0u);
+    EXPECT_TRUE(limit.allow(10, suppressed));
+    EXPECT_FALSE(limit.allow(20, suppressed));
+    EXPECT_FALSE(limit.allow(999, suppressed));
+
+    // next window reports what was dropped
+    EXPECT_TRUE(limit.allow(1000, suppressed));
+    EXPECT_EQ(suppressed, 2u);
+    EXPECT_TRUE(limit.allow(1001, suppressed));
+    EXPECT_EQ(suppressed, 0u);
+}
+
+TEST(UT_TraceLog, test_logRing_001)
+{
+    LogRing ring(3);
+    EXPECT_TRUE(ring.entries().empty());
+    EXPECT_TRUE(ring.dumpJson().empty());
+
+    ring.append(entryOf(kLevelDebug, "a"));
+    ring.append(entryOf(kLevelDebug, "b"));
+    ring.append(entryOf(kLevelDebug, "c"));
+    ring.append(entryOf(kLevelInfo, "d"));
+
+    // oldest dropped once full
+    auto entries = ring.entries();
+    ASSERT_EQ(entries.size(), 3u);
+    EXPECT_STREQ(entries[0].message, "b");
+    EXPECT_STREQ(entries[2].message, "d");
+}
+
+TEST(UT_TraceLog, test_dumpJson_001)
+{
+    LogRing ring(4);
+    LogEntry entry = entryOf(kLevelInfo, "say \"hi\"\n");
+    entry.time = 1500000000;
+    entry.tid = 7;
+    entry.suppressed = 3;
+    ring.append(entry);
+
+    EXPECT_EQ(ring.dumpJson(), "{\"time\":1500,\"level\":\"info\",\"tid\":7,\"site\":\"test.cpp:1\","
+                               "\"suppressed\":3,\"message\":\"say \\\"hi\\\"\\u000a\"}\n");
+}
+
+TEST(UT_TraceLog, test_write_001)
+{
+    g_forwarded = 0;
+    setForwarder(countForwarded);
+    size_t before = logRing().entries().size();
+
+    RateLimit limit(1, INT64_MAX);
+    write(limit, kLevelDebug, "test.cpp:2", "pid %d", 42);
+    write(limit, kLevelDebug, "test.cpp:2", "pid %d", 43);
+    setForwarder(nullptr);
+
+    auto entries = logRing().entries();
+    ASSERT_EQ(entries.size(), before + 1);
+    EXPECT_STREQ(entries.back().message, "pid 42");
+    EXPECT_NE(entries.back().tid, 0);
+    EXPECT_EQ(g_forwarded, 1);
+}
+
+TEST(UT_TraceLog, test_levels_001)
+{
+    setMinLevel(kLevelInfo);
+    EXPECT_FALSE(isEnabled(kLevelDebug));
+    EXPECT_TRUE(isEnabled(kLevelInfo));
+
+    // arguments aren't evaluated when disabled
+    int evaluated = 0;
+    TRACE_LOG_DEBUG("%d", ++evaluated);
+    EXPECT_EQ(evaluated, 0);
+    // compiled out by default
+    TRACE_LOG_TRACE("%d", ++evaluated);
+    EXPECT_EQ(evaluated, 0);
+
+    setMinLevel(kLevelDebug);
+    TRACE_LOG_DEBUG("%d", ++evaluated);
+    EXPECT_EQ(evaluated, 1);
+    EXPECT_STREQ(levelName(kLevelTrace), "trace");
+    EXPECT_STREQ(levelName(kLevelCount), "unknown");
+}
@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/vmstat_reader.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+using namespace common::parser;
+
+TEST(UT_VmStatReader, test_parse_001)
+{
+    const char buf[] = "nr_free_pages 361897\n"
+                       "nr_zone_inactive_anon 177240\n"
+                       "pswpin 1204\n"
+                       "pswpout 5830\n"
+                       "pgpgin 10387120\n"
+                       "pgfault 31337142\n"
+                       "pgmajfault 310\n"
+                       "pgsteal_kswapd 88213\n"
+                       "pgsteal_direct 1022\n"
+                       "pgsteal_khugepaged 0\n"
+                       "pgscan_kswapd 120455\n"
+                       "pgscan_direct 4096\n"
+                       "pgscan_khugepaged 0\n"
+                       "pgscan_direct_throttle 0\n"
+                       "oom_kill 2\n"
+                       "thp_fault_alloc 12\n";
+    VmStatFields fields;
+    EXPECT_EQ(VmStatReader::parse(buf, sizeof(buf) - 1, fields), 10);
+    EXPECT_EQ(fields.pswpin, 1204ull);
+    EXPECT_EQ(fields.pswpout, 5830ull);
+    EXPECT_EQ(fields.pgfault, 31337142ull);
+    EXPECT_EQ(fields.pgmajfault, 310ull);
+    EXPECT_EQ(fields.pgstealKswapd, 88213ull);
+    EXPECT_EQ(fields.pgstealDirect, 1022ull);
+    EXPECT_EQ(fields.pgscanKswapd, 120455ull);
+    // pgscan_direct_throttle must not overwrite pgscan_direct
+    EXPECT_EQ(fields.pgscanDirect, 4096ull);
+    EXPECT_EQ(fields.oomKill, 2ull);
+    EXPECT_EQ(fields.thpFaultAlloc, 12ull);
+}
+
+TEST(UT_VmStatReader, test_parse_002)
+{
+    // missing fields are left untouched, malformed lines skipped
+    VmStatFields fields;
+    fields.oomKill = 7;
+    const char buf[] = "pgfault 100\n"
+                       "garbage\n"
+                       "\n"
+                       "pgmajfault x\n"
+                       "pswpout 3";
+    EXPECT_EQ(VmStatReader::parse(buf, sizeof(buf) - 1, fields), 2);
+    EXPECT_EQ(fields.pgfault, 100ull);
+    EXPECT_EQ(fields.pgmajfault, 0ull);
+    EXPECT_EQ(fields.pswpout, 3ull);
+    EXPECT_EQ(fields.oomKill, 7ull);
+}
+
+TEST(UT_VmStatReader, test_parse_003)
+{
+    // huge page & zswap counters, thp_collapse_alloc must not take thp_collapse_alloc_failed
+    VmStatFields fields;
+    const char buf[] = "zswpin 41\n"
+                       "zswpout 977\n"
+                       "thp_fault_alloc 3118\n"
+                       "thp_fault_fallback 25\n"
+                       "thp_fault_fallback_charge 0\n"
+                       "thp_collapse_alloc 402\n"
+                       "thp_collapse_alloc_failed 6\n"
+                       "thp_file_alloc 0\n";
+    EXPECT_EQ(VmStatReader::parse(buf, sizeof(buf) - 1, fields), 6);
+    EXPECT_EQ(fields.zswpin, 41ull);
+    EXPECT_EQ(fields.zswpout, 977ull);
+    EXPECT_EQ(fields.thpFaultAlloc, 3118ull);
+    EXPECT_EQ(fields.thpFaultFallback, 25ull);
+    EXPECT_EQ(fields.thpCollapseAlloc, 402ull);
+    EXPECT_EQ(fields.thpCollapseAllocFailed, 6ull);
+}
+
+TEST(UT_VmStatReader, test_read_001)
+{
+    VmStatReader reader;
+    VmStatFields fields;
+    // fd is kept open & re-read
+    EXPECT_TRUE(reader.read(fields));
+    EXPECT_NE(fields.pgfault, 0ull);
+    fields.pgfault = 0;
+    EXPECT_TRUE(reader.read(fields));
+    EXPECT_NE(fields.pgfault, 0ull);
+}
+
+TEST(UT_VmStatReader, test_read_002)
+{
+    VmStatReader reader("/proc/no-such-file");
+    VmStatFields fields;
+    EXPECT_FALSE(reader.read(fields));
+}
@@ -235,3 +235,20 @@ TEST_F(UT_BaseItemDelegate, test_initStyleOption_01)
     static QModelIndex index;
     m_tester->initStyleOption(&option, index);
 }
+
+TEST_F(UT_BaseItemDelegate, test_elidedText_01)
+{
+    QStyleOptionViewItem option;
+    option.text = "a process name long enough to be elided";
+    option.textElideMode = Qt::ElideRight;
+    QFontMetrics fm(option.font);
+
+    const QString &text = m_tester->elidedText(fm, option, 40);
+    EXPECT_EQ(text, fm.elidedText(option.text, Qt::ElideRight, 40));
+    EXPECT_EQ(m_tester->m_elidedTexts.size(), 1);
+    // same text & width comes from the cache
+    EXPECT_EQ(m_tester->elidedText(fm, option, 40), text);
+    EXPECT_EQ(m_tester->m_elidedTexts.size(), 1);
+    m_tester->elidedText(fm, option, 80);
+    EXPECT_EQ(m_tester->m_elidedTexts.size(), 2);
+}
@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//Self
+#include "base/chart_layer_cache.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//Qt
+#include <QPainter>
+#include <QPixmapCache>
+#include <QWidget>
+
+TEST(UT_ChartLayerCache, test_cacheKey_01)
+{
+    QWidget first;
+    QWidget second;
+    first.resize(100, 60);
+    second.resize(100, 60);
+    EXPECT_EQ(ChartLayerCache::cacheKey(&first, "grid"), ChartLayerCache::cacheKey(&second, "grid"));
+    EXPECT_NE(ChartLayerCache::cacheKey(&first, "grid"), ChartLayerCache::cacheKey(&first, "grid:100%"));
+
+    second.resize(100, 61);
+    EXPECT_NE(ChartLayerCache::cacheKey(&first, "grid"), ChartLayerCache::cacheKey(&second, "grid"));
+}
+
+TEST(UT_ChartLayerCache, test_layer_01)
+{
+    QPixmapCache::clear();
+    int drawn = 0;
+    auto draw = [&](QPainter &painter) {
+        ++drawn;
+        painter.fillRect(0, 0, 10, 10, Qt::red);
+    };
+
+    // drawn once, shared afterwards
+    QPixmap first = ChartLayerCache::layer("ut-layer", QSize(20, 10), 2., draw);
+    QPixmap second = ChartLayerCache::layer("ut-layer", QSize(20, 10), 2., draw);
+    EXPECT_EQ(drawn, 1);
+    EXPECT_EQ(first.cacheKey(), second.cacheKey());
+    EXPECT_EQ(first.size(), QSize(40, 20));
+    EXPECT_EQ(first.devicePixelRatio(), 2.);
+
+    ChartLayerCache::layer("ut-layer-other", QSize(20, 10), 1., draw);
+    EXPECT_EQ(drawn, 2);
+}
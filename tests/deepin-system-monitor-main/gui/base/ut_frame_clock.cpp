@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//Self
+#include "base/frame_clock.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//Qt
+#include <QWidget>
+
+class UT_FrameClock : public ::testing::Test
+{
+public:
+    UT_FrameClock() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new FrameClock();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    FrameClock *m_tester;
+};
+
+TEST_F(UT_FrameClock, test_start_hidden)
+{
+    // hidden widgets settle at once, no timer
+    QWidget widget;
+    qreal progress = 0.;
+    int finished = 0;
+    EXPECT_TRUE(m_tester->start(&widget, 1000, QEasingCurve::OutQuad, [&](qreal p) { progress = p; }, [&]() { ++finished; }));
+    EXPECT_EQ(progress, 1.);
+    EXPECT_EQ(finished, 1);
+    EXPECT_FALSE(m_tester->isAnimating(&widget));
+    EXPECT_FALSE(m_tester->isActive());
+
+    m_tester->requestUpdate(&widget);
+    EXPECT_FALSE(m_tester->isActive());
+}
+
+TEST_F(UT_FrameClock, test_tick)
+{
+    QWidget first;
+    QWidget second;
+    first.show();
+    second.show();
+
+    qreal progress = 0.;
+    int finished = 0;
+    EXPECT_TRUE(m_tester->start(&first, 0x7fffffff, QEasingCurve::Linear, [&](qreal p) { progress = p; }));
+    EXPECT_FALSE(m_tester->start(&first, 10, QEasingCurve::Linear, [&](qreal) {}));
+    EXPECT_TRUE(m_tester->start(&second, 1, QEasingCurve::Linear, [](qreal) {}, [&]() { ++finished; }));
+    m_tester->requestUpdate(&first);
+    EXPECT_TRUE(m_tester->isActive());
+
+    // both stepped in one pass, the short one is done
+    m_tester->m_frameTimer.stop();
+    m_tester->m_animations[1].startTime -= 2;
+    m_tester->tick();
+    EXPECT_LT(progress, 1.);
+    EXPECT_EQ(finished, 1);
+    EXPECT_TRUE(m_tester->isAnimating(&first));
+    EXPECT_FALSE(m_tester->isAnimating(&second));
+    EXPECT_TRUE(m_tester->m_dirtyWidgets.isEmpty());
+    EXPECT_TRUE(m_tester->isActive());
+
+    // hiding skips to the end & the clock stops
+    first.hide();
+    m_tester->m_frameTimer.stop();
+    m_tester->tick();
+    EXPECT_EQ(progress, 1.);
+    EXPECT_FALSE(m_tester->isAnimating(&first));
+    EXPECT_FALSE(m_tester->isActive());
+}
+
+TEST_F(UT_FrameClock, test_destroyed_widget)
+{
+    QWidget *widget = new QWidget;
+    widget->show();
+    EXPECT_TRUE(m_tester->start(widget, 1000, QEasingCurve::Linear, [](qreal) {}));
+    m_tester->requestUpdate(widget);
+    delete widget;
+
+    m_tester->m_frameTimer.stop();
+    m_tester->tick();
+    EXPECT_TRUE(m_tester->m_animations.isEmpty());
+    EXPECT_FALSE(m_tester->isActive());
+}
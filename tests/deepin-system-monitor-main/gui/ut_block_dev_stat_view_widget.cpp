@@ -6,6 +6,7 @@
 //Self
 #include "block_dev_stat_view_widget.h"
 #include "system/block_device_info_db.h"
+#include "system/device_db.h"
 #include "block_dev_item_widget.h"
 
 //gtest
@@ -126,6 +127,8 @@ TEST_F(UT_BlockStatViewWidget, test_onUpdateData_01)
 
     Stub stub;
     stub.set(ADDR(BlockDeviceInfoDB, deviceList), stub_onUpdateData_deviceList);
+    // view reads the published snapshot
+    core::system::DeviceDB::instance()->publishSnapshot();
     m_tester->onUpdateData();
 }
 
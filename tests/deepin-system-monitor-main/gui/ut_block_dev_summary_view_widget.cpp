@@ -114,7 +114,7 @@ TEST_F(UT_BlockDevSummaryViewWidget, test_fontChanged_01)
     m_tester->fontChanged(font);
 
     EXPECT_EQ(m_tester->m_font.bold(), font.bold());
-    EXPECT_EQ(m_tester->height(), 260);
+    EXPECT_EQ(m_tester->height(), 286);
 }
 
 TEST_F(UT_BlockDevSummaryViewWidget, test_chageSummaryInfo_01)
@@ -130,7 +130,7 @@ TEST_F(UT_BlockDevSummaryViewWidget, test_paintEvent_01)
 
 TEST_F(UT_BlockDevSummaryViewWidget, test_rowCount_01)
 {
-    EXPECT_EQ(m_tester->model()->rowCount(), 7);
+    EXPECT_EQ(m_tester->model()->rowCount(), 11);
 }
 
 TEST_F(UT_BlockDevSummaryViewWidget, test_columnCount_01)
@@ -161,7 +161,7 @@ public:
 protected:
     int rowCount(const QModelIndex &) const
     {
-        return 7;
+        return 10;
     }
 
     int columnCount(const QModelIndex &) const
@@ -220,6 +220,24 @@ protected:
                 else if (column == 1)
                     return QApplication::translate("DeailTableModelBlock", "Writes merged/s");
                 break;
+            case 7:
+                if (column == 0)
+                    return QApplication::translate("DeailTableModelBlock", "Utilization");
+                else if (column == 1)
+                    return QApplication::translate("DeailTableModelBlock", "Queue depth");
+                break;
+            case 8:
+                if (column == 0)
+                    return QApplication::translate("DeailTableModelBlock", "Await");
+                else if (column == 1)
+                    return QApplication::translate("DeailTableModelBlock", "Service time");
+                break;
+            case 9:
+                if (column == 0)
+                    return QApplication::translate("DeailTableModelBlock", "In flight");
+                else if (column == 1)
+                    return QApplication::translate("DeailTableModelBlock", "Discard speed");
+                break;
 
             }
         } else if (role == Qt::UserRole) {
@@ -266,6 +284,24 @@ protected:
                 else if (column == 1)
                     return m_blockInfo.writeRequestMergedPerSecond();
                 break;
+            case  7:
+                if (column == 0)
+                    return QString("%1%").arg(m_blockInfo.percentUtilization(), 0, 'f', 1);
+                else if (column == 1)
+                    return QString::number(m_blockInfo.queueDepth(), 'f', 2);
+                break;
+            case  8:
+                if (column == 0)
+                    return QString("%1 ms").arg(m_blockInfo.await(), 0, 'f', 2);
+                else if (column == 1)
+                    return QString("%1 ms").arg(m_blockInfo.serviceTime(), 0, 'f', 2);
+                break;
+            case  9:
+                if (column == 0)
+                    return m_blockInfo.inFlight();
+                else if (column == 1)
+                    return formatUnit_memory_disk(m_blockInfo.discardSpeed(), B, 1, true);
+                break;
             }
         } else if (role == Qt::TextColorRole) {
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -333,7 +369,7 @@ TEST_F(UT_DeailTableModelBlock, initTest)
 TEST_F(UT_DeailTableModelBlock, test_rowCount_01)
 {
     QModelIndex index;
-    EXPECT_EQ(m_tester2->rowCount(index), 7);
+    EXPECT_EQ(m_tester2->rowCount(index), 10);
 }
 
 TEST_F(UT_DeailTableModelBlock, test_columnCount_01)
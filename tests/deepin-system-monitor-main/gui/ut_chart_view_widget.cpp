@@ -59,47 +59,47 @@ TEST_F(UT_ChartViewWidget, test_setData1Color_01)
 
 TEST_F(UT_ChartViewWidget, test_addData1_01)
 {
-    QVariant variant(20);
+    qreal variant = 20;
     m_tester->addData1(variant);
 
-    EXPECT_EQ(m_tester->m_maxData1, QVariant(20 * 1.1).toLongLong());
+    EXPECT_EQ(qRound64(m_tester->m_maxData1), QVariant(20 * 1.1).toLongLong());
     EXPECT_EQ(m_tester->m_maxData, QVariant(20 * 1.1).toLongLong());
 }
 
 TEST_F(UT_ChartViewWidget, test_addData1_02)
 {
-    QVariant variant(20);
+    qreal variant = 20;
     for (int i = 0; i < 40; i++) {
-        m_tester->m_listData1.append(i);
+        m_tester->m_data1.push(i);
     }
     m_tester->addData1(variant);
-    EXPECT_EQ(m_tester->m_maxData1.toLongLong(), QVariant(39 * 1.1).toLongLong());
-    EXPECT_EQ(m_tester->m_maxData.toLongLong(), QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(qRound64(m_tester->m_maxData1), QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(m_tester->m_maxData, QVariant(39 * 1.1).toLongLong());
 }
 
 TEST_F(UT_ChartViewWidget, test_addData1_03)
 {
-    QVariant variant(20);
+    qreal variant = 20;
     m_tester->m_speedAxis = true;
     for (int i = 0; i < 40; i++) {
-        m_tester->m_listData1.append(i);
+        m_tester->m_data1.push(i);
     }
     m_tester->addData1(variant);
-    EXPECT_EQ(m_tester->m_maxData1.toLongLong(), QVariant(39 * 1.1).toLongLong());
-    EXPECT_EQ(m_tester->m_maxData.toLongLong(), QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(qRound64(m_tester->m_maxData1), QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(m_tester->m_maxData, QVariant(39 * 1.1).toLongLong());
 }
 
 TEST_F(UT_ChartViewWidget, test_addData1_04)
 {
-    QVariant variant(20);
+    qreal variant = 20;
     m_tester->m_speedAxis = true;
     m_tester->m_maxData1 = 0;
     for (int i = 0; i < 40; i++) {
-        m_tester->m_listData1.append(i);
+        m_tester->m_data1.push(i);
     }
     m_tester->addData1(variant);
-    EXPECT_EQ(m_tester->m_maxData1.toLongLong(), QVariant(39 * 1.1).toLongLong());
-    EXPECT_EQ(m_tester->m_maxData.toLongLong(), QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(qRound64(m_tester->m_maxData1), QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(m_tester->m_maxData, QVariant(39 * 1.1).toLongLong());
 }
 
 TEST_F(UT_ChartViewWidget, test_setData2Color_01)
@@ -112,47 +112,47 @@ TEST_F(UT_ChartViewWidget, test_setData2Color_01)
 
 TEST_F(UT_ChartViewWidget, test_addData2_01)
 {
-    QVariant variant(20);
+    qreal variant = 20;
     m_tester->addData2(variant);
 
-    EXPECT_EQ(m_tester->m_maxData2, QVariant(20 * 1.1).toLongLong());
+    EXPECT_EQ(qRound64(m_tester->m_maxData2), QVariant(20 * 1.1).toLongLong());
     EXPECT_EQ(m_tester->m_maxData, QVariant(20 * 1.1).toLongLong());
 }
 
 TEST_F(UT_ChartViewWidget, test_addData2_02)
 {
-    QVariant variant(20);
+    qreal variant = 20;
     for (int i = 0; i < 40; i++) {
-        m_tester->m_listData2.append(i);
+        m_tester->m_data2.push(i);
     }
     m_tester->addData2(variant);
-    EXPECT_EQ(m_tester->m_maxData2.toLongLong(), QVariant(39 * 1.1).toLongLong());
-    EXPECT_EQ(m_tester->m_maxData.toLongLong(), QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(qRound64(m_tester->m_maxData2), QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(m_tester->m_maxData, QVariant(39 * 1.1).toLongLong());
 }
 
 TEST_F(UT_ChartViewWidget, test_addData2_03)
 {
-    QVariant variant(20);
+    qreal variant = 20;
     m_tester->m_speedAxis = true;
     for (int i = 0; i < 40; i++) {
-        m_tester->m_listData2.append(i);
+        m_tester->m_data2.push(i);
     }
     m_tester->addData2(variant);
-    EXPECT_EQ(m_tester->m_maxData2.toLongLong(), QVariant(39 * 1.1).toLongLong());
-    EXPECT_EQ(m_tester->m_maxData.toLongLong(), QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(qRound64(m_tester->m_maxData2), QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(m_tester->m_maxData, QVariant(39 * 1.1).toLongLong());
 }
 
 TEST_F(UT_ChartViewWidget, test_addData2_04)
 {
-    QVariant variant(20);
+    qreal variant = 20;
     m_tester->m_speedAxis = true;
     m_tester->m_maxData2 = 0;
     for (int i = 0; i < 40; i++) {
-        m_tester->m_listData2.append(i);
+        m_tester->m_data2.push(i);
     }
     m_tester->addData2(variant);
-    EXPECT_EQ(m_tester->m_maxData2.toLongLong(), QVariant(39 * 1.1).toLongLong());
-    EXPECT_EQ(m_tester->m_maxData.toLongLong(), QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(qRound64(m_tester->m_maxData2), QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(m_tester->m_maxData, QVariant(39 * 1.1).toLongLong());
 }
 
 TEST_F(UT_ChartViewWidget, test_setSpeedAxis_01)
@@ -209,14 +209,14 @@ TEST_F(UT_ChartViewWidget, test_drawData1_01)
     QPainter painter(&pixmap);
     m_tester->drawData1(&painter);
 
-    EXPECT_EQ(m_tester->m_listData1.size(), 0);
+    EXPECT_EQ(m_tester->m_data1.size(), 0u);
 }
 
 TEST_F(UT_ChartViewWidget, test_drawData1_02)
 {
     for (int i = 0; i < 2; i++)
     {
-        m_tester->m_listData1.append(i);
+        m_tester->m_data1.push(i);
     }
     QPixmap pixmap(100, 100);
     QPainter painter(&pixmap);
@@ -230,14 +230,14 @@ TEST_F(UT_ChartViewWidget, test_drawData2_01)
     QPainter painter(&pixmap);
     m_tester->drawData2(&painter);
 
-    EXPECT_EQ(m_tester->m_listData2.size(), 0);
+    EXPECT_EQ(m_tester->m_data2.size(), 0u);
 }
 
 TEST_F(UT_ChartViewWidget, test_drawData2_02)
 {
     for (int i = 0; i < 2; i++)
     {
-        m_tester->m_listData2.append(i);
+        m_tester->m_data2.push(i);
     }
     QPixmap pixmap(100, 100);
     QPainter painter(&pixmap);
@@ -259,26 +259,23 @@ TEST_F(UT_ChartViewWidget, test_setAxisTitle_01)
     EXPECT_EQ(m_tester->m_axisTitle, title);
 }
 
-TEST_F(UT_ChartViewWidget, test_getPainterPathByData_01)
+TEST_F(UT_ChartViewWidget, test_appendPathSegment_01)
 {
-    QList<QVariant> listData;
-
-    listData << QVariant(10) << QVariant(20) << QVariant(30);
+    common::core::SeriesRing series(3);
     QPainterPath path;
-    QVariant maxYvalue(10);
-
-
-    m_tester->getPainterPathByData(listData, path, maxYvalue);
+    for (int i = 0; i < 3; i++) {
+        series.push(i * 10);
+        m_tester->appendPathSegment(series, path);
+    }
+    // one move & one cubic segment per following sample
+    EXPECT_EQ(path.elementCount(), 1 + 3 * 2);
+    EXPECT_EQ(path.currentPosition(), QPointF(2, 20));
+
+    // rebuilt from the held samples once twice the capacity scrolled by
+    for (int i = 0; i < 7; i++) {
+        series.push(5);
+        m_tester->appendPathSegment(series, path);
+    }
+    EXPECT_EQ(path.elementAt(0).x, 5.);
+    EXPECT_EQ(path.currentPosition(), QPointF(9, 5));
 }
-
-
-
-
-
-
-
-
-
-
-
-
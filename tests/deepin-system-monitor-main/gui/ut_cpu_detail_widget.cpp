@@ -6,6 +6,8 @@
 //Self
 #include "cpu_detail_widget.h"
 #include "model/cpu_info_model.h"
+#include "model/model_manager.h"
+#include "model/sample_history.h"
 
 //gtest
 #include "stub.h"
@@ -130,7 +132,7 @@ TEST_F(UT_CPUDetailGrapTableItem, test_updateStat_01)
     m_tester->m_isMutliCoreMode = false;
     m_tester->updateStat();
 
-    EXPECT_EQ(m_tester->m_cpuPercents.size(), 1);
+    EXPECT_EQ(m_tester->m_series, &ModelManager::instance()->sampleHistory()->series(SampleHistory::kCpuTotal));
 }
 
 TEST_F(UT_CPUDetailGrapTableItem, test_updateStat_02)
@@ -138,18 +140,22 @@ TEST_F(UT_CPUDetailGrapTableItem, test_updateStat_02)
     m_tester->m_isMutliCoreMode = true;
     m_tester->updateStat();
 
-    EXPECT_EQ(m_tester->m_cpuPercents.size(), 1);
+    int cpu = CPUInfoModel::instance()->cpuSet()->cpuIds().value(0, 0);
+    EXPECT_EQ(m_tester->m_series, &ModelManager::instance()->sampleHistory()->series(SampleHistory::kCpuCore, QString::number(cpu)));
 }
 
 TEST_F(UT_CPUDetailGrapTableItem, test_updateStat_03)
 {
+    m_tester->setMultiCoreMode(true);
+    int cpu = CPUInfoModel::instance()->cpuSet()->cpuIds().value(0, 0);
+    common::core::SeriesRing &ring = ModelManager::instance()->sampleHistory()->ring(SampleHistory::kCpuCore, QString::number(cpu));
     for (int i = 0; i < 33; i++) {
-        m_tester->m_cpuPercents.append(qreal(i));
+        ring.push(qreal(i));
     }
-    m_tester->m_isMutliCoreMode = true;
     m_tester->updateStat();
 
-    EXPECT_EQ(m_tester->m_cpuPercents.size(), 31);
+    EXPECT_EQ(m_tester->m_series->size(), SampleHistory::kHistorySize);
+    EXPECT_EQ(m_tester->m_series->recent(0), 32.);
 }
 
 TEST_F(UT_CPUDetailGrapTableItem, test_paintEvent_01)
@@ -181,9 +187,11 @@ TEST_F(UT_CPUDetailGrapTableItem, test_drawNormalMode_02)
 {
     m_tester->m_isMutliCoreMode = true;
 
-    m_tester->m_cpuPercents.append(0.1);
-    m_tester->m_cpuPercents.append(0.2);
-    m_tester->m_cpuPercents.append(0.3);
+    common::core::SeriesRing series(SampleHistory::kHistorySize);
+    series.push(10);
+    series.push(20);
+    series.push(30);
+    m_tester->m_series = &series;
 
     QPixmap pixmap(100, 100);
     QPainter painter(&pixmap);
@@ -192,9 +200,11 @@ TEST_F(UT_CPUDetailGrapTableItem, test_drawNormalMode_02)
 
 TEST_F(UT_CPUDetailGrapTableItem, test_drawSimpleMode_01)
 {
-    m_tester->m_cpuPercents.append(0.1);
-    m_tester->m_cpuPercents.append(0.2);
-    m_tester->m_cpuPercents.append(0.3);
+    common::core::SeriesRing series(SampleHistory::kHistorySize);
+    series.push(10);
+    series.push(20);
+    series.push(30);
+    m_tester->m_series = &series;
 
     QPixmap pixmap(100, 100);
     QPainter painter(&pixmap);
@@ -210,15 +220,39 @@ TEST_F(UT_CPUDetailGrapTableItem, test_drawTextMode_01)
 
 TEST_F(UT_CPUDetailGrapTableItem, test_drawSingleCoreMode_01)
 {
-    m_tester->m_cpuPercents.append(0.1);
-    m_tester->m_cpuPercents.append(0.2);
-    m_tester->m_cpuPercents.append(0.3);
+    common::core::SeriesRing series(SampleHistory::kHistorySize);
+    series.push(10);
+    series.push(20);
+    series.push(30);
+    m_tester->m_series = &series;
 
     QPixmap pixmap(100, 100);
     QPainter painter(&pixmap);
     m_tester->drawSingleCoreMode(painter);
 }
 
+TEST_F(UT_CPUDetailGrapTableItem, test_updateUsagePath_01)
+{
+    common::core::SeriesRing series(SampleHistory::kHistorySize);
+    series.push(50);
+    series.push(100);
+    m_tester->m_series = &series;
+
+    m_tester->updateUsagePath();
+    // newest sample at x 0, one cubic segment per held sample
+    EXPECT_EQ(m_tester->m_usagePath.elementAt(0), QPointF(0, 1));
+    EXPECT_EQ(m_tester->m_usagePath.elementCount(), 1 + 3 * 2);
+    EXPECT_EQ(m_tester->m_usagePath.currentPosition(), QPointF(-2, 0));
+
+    // kept until the next sample
+    m_tester->m_usagePath = QPainterPath();
+    m_tester->updateUsagePath();
+    EXPECT_TRUE(m_tester->m_usagePath.isEmpty());
+    series.push(0);
+    m_tester->updateUsagePath();
+    EXPECT_EQ(m_tester->m_usagePath.elementCount(), 1 + 3 * 3);
+}
+
 TEST_F(UT_CPUDetailGrapTableItem, test_drawBackground_01)
 {
     QPixmap pixmap(100, 100);
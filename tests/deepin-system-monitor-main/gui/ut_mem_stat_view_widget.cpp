@@ -6,6 +6,8 @@
 //Self
 #include "mem_stat_view_widget.h"
 #include "system/mem.h"
+#include "system/device_db.h"
+#include "system/device_snapshot.h"
 #include "chart_view_widget.h"
 
 //gtest
@@ -57,7 +59,11 @@ TEST_F(UT_MemStatViewWidget, test_paintEvent_01)
 
 TEST_F(UT_MemStatViewWidget, test_paintEvent_02)
 {
-    m_tester->m_memInfo->readMemInfo();
+    // widget reads the published snapshot, not the live MemInfo
+    core::system::DeviceDB::instance()->memInfo()->readMemInfo();
+    core::system::DeviceDB::instance()->publishSnapshot();
+    m_tester->m_snapshot = core::system::DeviceDB::instance()->snapshot();
+    m_tester->m_memInfo = &m_tester->m_snapshot->memInfo;
     EXPECT_TRUE(!m_tester->grab().isNull());
 }
 
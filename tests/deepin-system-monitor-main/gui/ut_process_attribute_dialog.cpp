@@ -124,3 +124,28 @@ TEST_F(UT_ProcessAttributeDialog, test_eventFitler_04)
 
 
 
+
+TEST_F(UT_ProcessAttributeDialog, test_showConnections)
+{
+    m_tester1->showConnections(true);
+    EXPECT_EQ(m_tester1->m_pages->currentIndex(), 1);
+    EXPECT_TRUE(m_tester1->m_connectionTimer->isActive());
+
+    m_tester1->showConnections(false);
+    EXPECT_EQ(m_tester1->m_pages->currentIndex(), 0);
+    EXPECT_FALSE(m_tester1->m_connectionTimer->isActive());
+}
+
+TEST_F(UT_ProcessAttributeDialog, test_schedulingPage)
+{
+    // init's affinity & io priority are readable by anyone
+    m_tester1->showPage(5);
+    EXPECT_EQ(m_tester1->m_pages->currentIndex(), 5);
+    EXPECT_FALSE(m_tester1->m_affinityEdit->text().isEmpty());
+
+    // nothing is sent for a malformed cpu list
+    m_tester1->m_affinityEdit->setText("3-1");
+    m_tester1->applyScheduling();
+    EXPECT_TRUE(m_tester1->m_pendingBatches.isEmpty());
+    EXPECT_TRUE(m_tester1->m_applyBtn->isEnabled());
+}
@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//Self
+#include "resource_limit_dialog.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//Qt
+#include <QMessageBox>
+
+class UT_ResourceLimitDialog : public ::testing::Test
+{
+public:
+    UT_ResourceLimitDialog() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        static QWidget wid;
+        // memory capped at 512 MiB, nothing else set
+        m_tester = new ResourceLimitDialog("test", {RESOURCE_LIMIT_NONE, 512ULL << 20, RESOURCE_LIMIT_NONE}, &wid);
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    ResourceLimitDialog *m_tester;
+};
+
+TEST_F(UT_ResourceLimitDialog, test_limits_001)
+{
+    EXPECT_FALSE(m_tester->m_cpuCheck->isChecked());
+    EXPECT_FALSE(m_tester->m_cpuBox->isEnabled());
+    EXPECT_TRUE(m_tester->m_memoryCheck->isChecked());
+    EXPECT_EQ(m_tester->m_memoryBox->value(), 512);
+
+    resource_limits_t limits = m_tester->limits();
+    EXPECT_EQ(limits.cpu_quota, RESOURCE_LIMIT_NONE);
+    EXPECT_EQ(limits.memory_high, 512ULL << 20);
+    EXPECT_EQ(limits.io_weight, RESOURCE_LIMIT_NONE);
+
+    // a quarter of a cpu is 250ms of cpu time per second
+    m_tester->m_cpuCheck->setChecked(true);
+    m_tester->m_cpuBox->setValue(25);
+    m_tester->m_memoryCheck->setChecked(false);
+    limits = m_tester->limits();
+    EXPECT_TRUE(m_tester->m_cpuBox->isEnabled());
+    EXPECT_EQ(limits.cpu_quota, 250000u);
+    EXPECT_EQ(limits.memory_high, RESOURCE_LIMIT_NONE);
+    EXPECT_TRUE(resourceLimitsValid(limits));
+}
+
+TEST_F(UT_ResourceLimitDialog, test_onButtonClicked_001)
+{
+    m_tester->onButtonClicked(1, "");
+    EXPECT_EQ(m_tester->result(), QMessageBox::Ok);
+    m_tester->onButtonClicked(0, "");
+    EXPECT_EQ(m_tester->result(), QMessageBox::Cancel);
+}
@@ -245,3 +245,16 @@ TEST_F(UT_BlockDevStatModel, test_data_010)
 
     delete index;
 }
+
+TEST_F(UT_BlockDevStatModel, test_addSample_001)
+{
+    TimePeriod period(TimePeriod::k1Min, {2, 0});
+    BlockDevStatModel model(period, nullptr);
+    core::system::BlockDevice device;
+    model.addSample(device);
+    EXPECT_EQ(model.rowCount(), 1);
+    QVariant util = model.data(model.index(0, BlockDevStatModel::kStatUtilization), BlockDevStatModel::kValueRole);
+    EXPECT_TRUE(util.isValid());
+    EXPECT_EQ(util.toDouble(), 0.);
+    EXPECT_FALSE(model.data(model.index(0, BlockDevStatModel::kStatAwait), Qt::DisplayRole).toString().isEmpty());
+}
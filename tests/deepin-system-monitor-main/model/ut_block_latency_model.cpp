@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/block_latency_model.h"
+#include "process_info_record.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+namespace {
+
+struct latency_t {
+    uint32_t dev;
+    uint32_t dir;
+    std::initializer_list<std::pair<int, uint64_t>> buckets;
+};
+
+QByteArray blockLatency(uint64_t timestamp, std::initializer_list<latency_t> latencies)
+{
+    QByteArray buf(int(sizeof(block_latency_header_t) + latencies.size() * sizeof(block_latency_record_t)), '\0');
+    auto *hdr = reinterpret_cast<block_latency_header_t *>(buf.data());
+    hdr->magic = BLOCK_LATENCY_MAGIC;
+    hdr->version = BLOCK_LATENCY_VERSION;
+    hdr->record_size = sizeof(block_latency_record_t);
+    hdr->count = uint32_t(latencies.size());
+    hdr->timestamp = timestamp;
+    auto *rec = reinterpret_cast<block_latency_record_t *>(hdr + 1);
+    for (const auto &latency : latencies) {
+        rec->dev = latency.dev;
+        rec->dir = latency.dir;
+        for (const auto &bucket : latency.buckets)
+            rec->buckets[bucket.first] = bucket.second;
+        ++rec;
+    }
+    return buf;
+}
+
+// not a disk of this machine, named by its numbers
+const uint32_t kDev = (4000u << 20) | 7;
+const QString kDevName = "4000:7";
+
+} // namespace
+
+class UT_BlockLatencyModel : public ::testing::Test
+{
+public:
+    UT_BlockLatencyModel() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new BlockLatencyModel();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    BlockLatencyModel *m_tester;
+};
+
+TEST_F(UT_BlockLatencyModel, initTest)
+{
+    EXPECT_TRUE(m_tester->isAvailable());
+    EXPECT_TRUE(m_tester->history(kDevName, false).isEmpty());
+}
+
+TEST_F(UT_BlockLatencyModel, test_applyLatency)
+{
+    m_tester->applyLatency(blockLatency(1000000000ULL, {{kDev, BLOCK_LATENCY_READ, {{4, 100}}},
+                                                        {kDev, BLOCK_LATENCY_WRITE, {{8, 10}}}}));
+    // the first snapshot is only the base
+    QList<BlockLatencyModel::Column> reads = m_tester->history(kDevName, false);
+    ASSERT_EQ(reads.size(), 1);
+    EXPECT_EQ(reads[0][4], 0ull);
+
+    m_tester->applyLatency(blockLatency(2000000000ULL, {{kDev, BLOCK_LATENCY_READ, {{4, 150}, {12, 2}}},
+                                                        {kDev, BLOCK_LATENCY_WRITE, {{8, 10}}}}));
+    reads = m_tester->history(kDevName, false);
+    ASSERT_EQ(reads.size(), 2);
+    EXPECT_EQ(reads[1][4], 50ull);
+    EXPECT_EQ(reads[1][12], 2ull);
+    const QList<BlockLatencyModel::Column> writes = m_tester->history(kDevName, true);
+    ASSERT_EQ(writes.size(), 2);
+    EXPECT_EQ(writes[1][8], 0ull);
+
+    // cached snapshot, nothing appended
+    m_tester->applyLatency(blockLatency(2000000000ULL, {{kDev, BLOCK_LATENCY_READ, {{4, 150}}}}));
+    EXPECT_EQ(m_tester->history(kDevName, false).size(), 2);
+
+    // no requests on the disk, an empty column still passes
+    m_tester->applyLatency(blockLatency(3000000000ULL, {}));
+    reads = m_tester->history(kDevName, false);
+    ASSERT_EQ(reads.size(), 3);
+    EXPECT_EQ(reads[2][4], 0ull);
+}
+
+TEST_F(UT_BlockLatencyModel, test_applyLatency_restart)
+{
+    m_tester->applyLatency(blockLatency(1000000000ULL, {{kDev, BLOCK_LATENCY_READ, {{4, 100}}}}));
+    // tracing reopened, totals went back
+    m_tester->applyLatency(blockLatency(2000000000ULL, {{kDev, BLOCK_LATENCY_READ, {{4, 5}}}}));
+    const QList<BlockLatencyModel::Column> reads = m_tester->history(kDevName, false);
+    ASSERT_EQ(reads.size(), 2);
+    EXPECT_EQ(reads[1][4], 0ull);
+}
+
+TEST_F(UT_BlockLatencyModel, test_history_limit)
+{
+    for (int i = 1; i <= BlockLatencyModel::kHistorySize + 5; ++i)
+        m_tester->applyLatency(blockLatency(uint64_t(i) * 1000000000ULL, {{kDev, BLOCK_LATENCY_READ, {{0, uint64_t(i)}}}}));
+    EXPECT_EQ(m_tester->history(kDevName, false).size(), BlockLatencyModel::kHistorySize);
+}
+
+TEST_F(UT_BlockLatencyModel, test_percentile)
+{
+    BlockLatencyModel::Column column(BLOCK_LATENCY_BUCKETS);
+    EXPECT_DOUBLE_EQ(BlockLatencyModel::percentile(column, 99), 0.);
+
+    column[4] = 98; // 16 ~ 32us
+    column[10] = 2; // 1 ~ 2ms
+    EXPECT_DOUBLE_EQ(BlockLatencyModel::percentile(column, 50), 32.);
+    EXPECT_DOUBLE_EQ(BlockLatencyModel::percentile(column, 99), 2048.);
+}
+
+TEST_F(UT_BlockLatencyModel, test_deviceName)
+{
+    EXPECT_EQ(BlockLatencyModel::deviceName(kDev), kDevName);
+}
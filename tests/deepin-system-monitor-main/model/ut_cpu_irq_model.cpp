@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/cpu_irq_model.h"
+#include "common/core_usage.h"
+
+#include <cmath>
+
+//gtest
+#include <gtest/gtest.h>
+
+using namespace common::usage;
+
+class UT_CPUIrqModel : public ::testing::Test
+{
+public:
+    UT_CPUIrqModel() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new CPUIrqModel(nullptr);
+        m_usage.resize(4);
+        for (int i = 0; i < 4; ++i) {
+            m_usage.hardirq[size_t(i)] = i;
+            m_usage.softirq[size_t(i)] = 10. * i;
+        }
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    CPUIrqModel *m_tester;
+    CoreUsage m_usage;
+};
+
+TEST_F(UT_CPUIrqModel, initTest)
+{
+    EXPECT_EQ(m_tester->rowCount(), 0);
+    EXPECT_EQ(m_tester->columnCount(), int(CPUIrqModel::kCPUIrqColumnCount));
+}
+
+TEST_F(UT_CPUIrqModel, test_applyUsage)
+{
+    // cpu 1 offline, ids out of range are skipped
+    m_tester->applyUsage({0, 2, 3, 8}, m_usage);
+    ASSERT_EQ(m_tester->rowCount(), 3);
+    EXPECT_EQ(m_tester->index(1, CPUIrqModel::kCPUIrqCoreColumn).data().toString(), QString("CPU2"));
+    EXPECT_DOUBLE_EQ(m_tester->index(1, CPUIrqModel::kCPUIrqHardColumn).data(Qt::UserRole).toDouble(), 2.);
+    EXPECT_EQ(m_tester->index(2, CPUIrqModel::kCPUIrqSoftColumn).data().toString(), QString("30.0%"));
+
+    // no time elapsed between the stat reads
+    m_usage.hardirq[0] = NAN;
+    m_tester->applyUsage({0, 2, 3}, m_usage);
+    EXPECT_EQ(m_tester->index(0, CPUIrqModel::kCPUIrqHardColumn).data().toString(), QString("-"));
+}
@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/data_export.h"
+#include "model/sample_history.h"
+#include "common/history_store.h"
+#include "process/process.h"
+#include "process/private/process_p.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//qt
+#include <QBuffer>
+#include <QTemporaryDir>
+
+using namespace common::history;
+using namespace common::record;
+using namespace core::process;
+
+namespace {
+
+void addProcess(QMap<pid_t, Process> &set, pid_t pid, const QString &name, qreal cpu)
+{
+    Process proc(pid);
+    proc.d->valid = true;
+    proc.d->ppid = 1;
+    proc.d->uid = 1000;
+    proc.d->rss = 2048;
+    proc.d->state = 'S';
+    proc.setName(name);
+    proc.setUserName("user");
+    proc.setCpu(cpu);
+    set.insert(pid, proc);
+}
+
+} // namespace
+
+TEST(UT_DataExport, test_writeProcesses_001)
+{
+    QMap<pid_t, Process> set;
+    addProcess(set, 100, "bash", 1.5);
+    addProcess(set, 200, "web, worker", 50);
+    ProcessColumns columns(set);
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    RecordWriter writer(&buffer, RecordWriter::kCsv, DataExport::processFields());
+    // in view order, pids gone from the snapshot are skipped
+    EXPECT_EQ(DataExport::writeProcesses(writer, columns, {200, 300, 100}), 2);
+    ASSERT_TRUE(writer.finish());
+
+    const QList<QByteArray> lines = buffer.data().split('\n');
+    ASSERT_EQ(lines.size(), 4);
+    EXPECT_TRUE(lines[0].startsWith("pid,ppid,name,user,uid,state,threads,cpu,memory_kb,"));
+    EXPECT_TRUE(lines[1].startsWith("200,1,\"web, worker\",user,1000,S,"));
+    EXPECT_TRUE(lines[2].startsWith("100,1,bash,user,1000,S,"));
+    EXPECT_EQ(lines[2].split(',').size(), DataExport::processFields().size());
+    EXPECT_TRUE(lines[3].isEmpty());
+}
+
+TEST(UT_DataExport, test_writeHistory_001)
+{
+    QTemporaryDir dir;
+    // 2024-01-02 03:00:00 UTC
+    const qint64 hour = 1704164400000LL;
+    {
+        HistoryWriter writer(dir.path().toStdString());
+        for (int i = 0; i < 10; ++i) {
+            writer.append(SampleHistory::kCpuTotal, "", hour + i * 1000, i);
+            writer.append(SampleHistory::kDiskRead, "sda", hour + i * 1000, 4096);
+        }
+    }
+
+    HistoryReader reader(dir.path().toStdString());
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    RecordWriter writer(&buffer, RecordWriter::kJsonLines, DataExport::historyFields());
+    EXPECT_EQ(DataExport::writeHistory(writer, reader, hour + 5000, hour + 3600 * 1000), 10);
+    ASSERT_TRUE(writer.finish());
+
+    const QByteArray &data = buffer.data();
+    EXPECT_EQ(data.count('\n'), 10);
+    EXPECT_TRUE(data.contains("{\"time\":\"2024-01-02T03:00:05.000Z\",\"metric\":\"cpu_total\",\"device\":\"\",\"value\":5}\n"));
+    EXPECT_TRUE(data.contains("{\"time\":\"2024-01-02T03:00:09.000Z\",\"metric\":\"disk_read\",\"device\":\"sda\",\"value\":4096}\n"));
+    EXPECT_FALSE(data.contains("03:00:04"));
+}
+
+TEST(UT_DataExport, test_metricName_001)
+{
+    EXPECT_STREQ(SampleHistory::metricName(SampleHistory::kCpuTotal), "cpu_total");
+    EXPECT_STREQ(SampleHistory::metricName(SampleHistory::kCorePower), "core_power");
+    EXPECT_STREQ(SampleHistory::metricName(SampleHistory::kCpuGuest), "cpu_guest");
+    EXPECT_STREQ(SampleHistory::metricName(SampleHistory::kMetricCount), "");
+}
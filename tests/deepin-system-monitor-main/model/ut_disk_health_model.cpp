@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/disk_health_model.h"
+#include "process_info_record.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//Qt
+#include <QSignalSpy>
+
+#include <string.h>
+
+namespace {
+
+disk_health_record_t diskHealth(const char *name, uint32_t state, int32_t temperature)
+{
+    disk_health_record_t rec {};
+    strncpy(rec.name, name, DISK_HEALTH_NAME_LEN - 1);
+    rec.kind = DISK_HEALTH_NVME;
+    rec.state = state;
+    rec.temperature = temperature;
+    rec.sampled_at = 1000000000ULL;
+    return rec;
+}
+
+QByteArray diskHealthBuffer(uint64_t timestamp, std::initializer_list<disk_health_record_t> records)
+{
+    QByteArray buf(int(sizeof(disk_health_header_t) + records.size() * sizeof(disk_health_record_t)), '\0');
+    auto *hdr = reinterpret_cast<disk_health_header_t *>(buf.data());
+    hdr->magic = DISK_HEALTH_MAGIC;
+    hdr->version = DISK_HEALTH_VERSION;
+    hdr->record_size = sizeof(disk_health_record_t);
+    hdr->count = uint32_t(records.size());
+    hdr->interval = DISK_HEALTH_INTERVAL;
+    hdr->timestamp = timestamp;
+    memcpy(hdr + 1, records.begin(), records.size() * sizeof(disk_health_record_t));
+    return buf;
+}
+
+} // namespace
+
+class UT_DiskHealthModel : public ::testing::Test
+{
+public:
+    UT_DiskHealthModel() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new DiskHealthModel();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    DiskHealthModel *m_tester;
+};
+
+TEST_F(UT_DiskHealthModel, initTest)
+{
+    disk_health_record_t rec {};
+    EXPECT_TRUE(m_tester->isAvailable());
+    EXPECT_FALSE(m_tester->health("nvme0n1", rec));
+}
+
+TEST_F(UT_DiskHealthModel, test_applyHealth)
+{
+    QSignalSpy spy(m_tester, &DiskHealthModel::updated);
+
+    m_tester->applyHealth(diskHealthBuffer(1, {diskHealth("nvme0n1", DISK_HEALTH_OK, 45),
+                                               diskHealth("sda", DISK_HEALTH_FAILING, 38)}));
+    EXPECT_EQ(spy.count(), 1);
+    disk_health_record_t rec {};
+    ASSERT_TRUE(m_tester->health("nvme0n1", rec));
+    EXPECT_EQ(rec.temperature, 45);
+    ASSERT_TRUE(m_tester->health("sda", rec));
+    EXPECT_TRUE(DiskHealthModel::isWarning(rec));
+
+    // same records fetched again, nothing to repaint
+    m_tester->applyHealth(diskHealthBuffer(2, {diskHealth("nvme0n1", DISK_HEALTH_OK, 45),
+                                               diskHealth("sda", DISK_HEALTH_FAILING, 38)}));
+    EXPECT_EQ(spy.count(), 1);
+
+    // a disk gone is dropped
+    m_tester->applyHealth(diskHealthBuffer(3, {diskHealth("nvme0n1", DISK_HEALTH_OK, 46)}));
+    EXPECT_EQ(spy.count(), 2);
+    EXPECT_FALSE(m_tester->health("sda", rec));
+}
+
+TEST_F(UT_DiskHealthModel, test_applyHealth_malformed)
+{
+    m_tester->applyHealth(diskHealthBuffer(1, {diskHealth("nvme0n1", DISK_HEALTH_OK, 45)}));
+
+    QByteArray truncated = diskHealthBuffer(2, {diskHealth("sda", DISK_HEALTH_OK, 30)});
+    truncated.chop(1);
+    m_tester->applyHealth(truncated);
+    QByteArray version = diskHealthBuffer(2, {diskHealth("sda", DISK_HEALTH_OK, 30)});
+    reinterpret_cast<disk_health_header_t *>(version.data())->version = DISK_HEALTH_VERSION + 1;
+    m_tester->applyHealth(version);
+
+    disk_health_record_t rec {};
+    EXPECT_TRUE(m_tester->health("nvme0n1", rec));
+    EXPECT_FALSE(m_tester->health("sda", rec));
+}
+
+TEST_F(UT_DiskHealthModel, test_summaryText)
+{
+    EXPECT_EQ(DiskHealthModel::summaryText(diskHealth("nvme0n1", DISK_HEALTH_PENDING, DISK_HEALTH_NO_TEMPERATURE)), QString());
+    EXPECT_FALSE(DiskHealthModel::summaryText(diskHealth("nvme0n1", DISK_HEALTH_OK, 45)).isEmpty());
+    EXPECT_TRUE(DiskHealthModel::summaryText(diskHealth("nvme0n1", DISK_HEALTH_OK, 45)).startsWith("45"));
+    // a sleeping disk's last temperature is stale
+    EXPECT_TRUE(DiskHealthModel::temperatureText(diskHealth("sda", DISK_HEALTH_SLEEPING, 40)).isEmpty());
+    EXPECT_FALSE(DiskHealthModel::stateText(diskHealth("sda", DISK_HEALTH_SLEEPING, 40)).isEmpty());
+}
@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/fleet_monitor.h"
+#include "remote_agent.h"
+#include "system/device_snapshot.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//system
+#include <string.h>
+
+using namespace core::system;
+
+static QByteArray helloFrame(const char *hostname)
+{
+    remote_hello_t hello {};
+    hello.version = REMOTE_AGENT_VERSION;
+    hello.byte_order = REMOTE_AGENT_BYTE_ORDER;
+    hello.record_size = sizeof(process_info_record_t);
+    hello.interval = 1000;
+    strncpy(hello.hostname, hostname, sizeof(hello.hostname) - 1);
+    QByteArray payload(reinterpret_cast<const char *>(&hello), sizeof(hello));
+    QByteArray info;
+    QDataStream out(&info, QIODevice::WriteOnly);
+    out.setVersion(RemoteAgent::kStreamVersion);
+    CPUSet().saveInfo(out);
+    return RemoteAgent::encodeFrame(REMOTE_FRAME_HELLO, payload + info);
+}
+
+static QByteArray systemFrame(qreal ioPressure)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(RemoteAgent::kStreamVersion);
+    DeviceSnapshot snapshot;
+    snapshot.cpuSet.saveStats(out);
+    snapshot.memInfo.save(out);
+    out << qreal(0) << qreal(0) << qreal(0) << qreal(0) << qulonglong(0) << qulonglong(0);
+    for (int i = 0; i < common::pressure::kPressureResourceCount; ++i)
+        out << true << true << (i == common::pressure::kIOPressure ? ioPressure : qreal(1)) << qreal(0);
+    return RemoteAgent::encodeFrame(REMOTE_FRAME_SYSTEM, payload);
+}
+
+static QByteArray processesFrame(const QHash<pid_t, process_info_record_t> &previous,
+                                 const QHash<pid_t, process_info_record_t> &current, quint64 generation, bool baseline)
+{
+    QList<pid_t> created;
+    QByteArray payload = RemoteAgent::encodeDelta(previous, current, generation, baseline, created);
+    // no names, the fleet only reads the records
+    quint32 count = 0;
+    payload.append(reinterpret_cast<const char *>(&count), sizeof(count));
+    return RemoteAgent::encodeFrame(REMOTE_FRAME_PROCESSES, payload);
+}
+
+static process_info_record_t makeRecord(pid_t pid, const char *comm, qreal cpu)
+{
+    process_info_record_t rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.pid = pid;
+    rec.tgid = pid;
+    rec.ppid = 1;
+    rec.start_time = 100;
+    strncpy(rec.comm, comm, sizeof(rec.comm) - 1);
+    rec.sections = kProcessInfoStat | kProcessInfoRates;
+    rec.cpu_usage = cpu;
+    return rec;
+}
+
+TEST(UT_FleetHostDecoder, test_feed_001)
+{
+    FleetHostDecoder decoder;
+    FleetHostState state;
+    state.target = "root@node1";
+
+    QHash<pid_t, process_info_record_t> first {{10, makeRecord(10, "idle", 0.5)}, {11, makeRecord(11, "make", 40)}};
+    QByteArray stream = helloFrame("node1") + systemFrame(25) + processesFrame({}, first, 1, true);
+    // split anywhere
+    int third = stream.size() / 3;
+    EXPECT_TRUE(decoder.feed(stream.constData(), third, state));
+    EXPECT_TRUE(decoder.feed(stream.constData() + third, stream.size() - third, state));
+    EXPECT_EQ(state.hostName, QString("node1"));
+    EXPECT_EQ(state.status, FleetHostState::kOnline);
+    EXPECT_TRUE(state.hasPressure);
+    EXPECT_DOUBLE_EQ(state.pressure[common::pressure::kIOPressure], 25.);
+    EXPECT_EQ(state.topProcess, QString("make"));
+    EXPECT_DOUBLE_EQ(state.topProcessCpu, 40.);
+
+    // make exits, the delta is applied on the records kept
+    QHash<pid_t, process_info_record_t> second {{10, makeRecord(10, "idle", 0.5)}};
+    QByteArray next = systemFrame(0) + processesFrame(first, second, 2, false);
+    EXPECT_TRUE(decoder.feed(next.constData(), next.size(), state));
+    EXPECT_EQ(state.topProcess, QString("idle"));
+    EXPECT_DOUBLE_EQ(state.pressure[common::pressure::kIOPressure], 0.);
+
+    // a generation gap can't be followed
+    next = systemFrame(0) + processesFrame(second, second, 7, false);
+    EXPECT_FALSE(decoder.feed(next.constData(), next.size(), state));
+}
+
+TEST(UT_FleetHostDecoder, test_feed_002)
+{
+    FleetHostDecoder decoder;
+    FleetHostState state;
+    // system frames ahead of a hello
+    QByteArray stream = systemFrame(0);
+    EXPECT_FALSE(decoder.feed(stream.constData(), stream.size(), state));
+
+    decoder.reset();
+    const char banner[] = "Permission denied (publickey).";
+    EXPECT_FALSE(decoder.feed(banner, int(sizeof(banner)), state));
+    EXPECT_EQ(state.status, FleetHostState::kConnecting);
+}
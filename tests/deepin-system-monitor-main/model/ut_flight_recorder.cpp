@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/flight_recorder.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//qt
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+
+#include <string.h>
+#include <unistd.h>
+
+class UT_FlightRecorder : public ::testing::Test
+{
+public:
+    UT_FlightRecorder() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        // captures are written under ~/.qttest instead of the user's documents
+        QStandardPaths::setTestModeEnabled(true);
+        m_tester = new FlightRecorder();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+        QStandardPaths::setTestModeEnabled(false);
+    }
+
+protected:
+    FlightRecorder *m_tester;
+};
+
+TEST_F(UT_FlightRecorder, test_parseSockStat)
+{
+    const char sockstat[] = "sockets: used 512\n"
+                            "TCP: inuse 12 orphan 1 tw 7 alloc 20 mem 3\n"
+                            "UDP: inuse 4 mem 2\n"
+                            "UDPLITE: inuse 0\n"
+                            "RAW: inuse 1\n"
+                            "FRAG: inuse 0 memory 0\n";
+    const char sockstat6[] = "TCP6: inuse 5\n"
+                             "UDP6: inuse 3\n"
+                             "UDPLITE6: inuse 0\n"
+                             "RAW6: inuse 0\n"
+                             "FRAG6: inuse 0 memory 0\n";
+    FlightRecorder::sockstat_t stat;
+    FlightRecorder::parseSockStat(sockstat, strlen(sockstat), stat);
+    FlightRecorder::parseSockStat(sockstat6, strlen(sockstat6), stat);
+    EXPECT_EQ(stat.sockets, 512u);
+    EXPECT_EQ(stat.tcpInUse, 12u);
+    EXPECT_EQ(stat.tcpOrphan, 1u);
+    EXPECT_EQ(stat.tcpTimeWait, 7u);
+    EXPECT_EQ(stat.tcpAlloc, 20u);
+    EXPECT_EQ(stat.tcpMem, 3u);
+    EXPECT_EQ(stat.udpInUse, 4u);
+    EXPECT_EQ(stat.udpMem, 2u);
+    EXPECT_EQ(stat.rawInUse, 1u);
+    EXPECT_EQ(stat.tcp6InUse, 5u);
+    EXPECT_EQ(stat.udp6InUse, 3u);
+}
+
+TEST_F(UT_FlightRecorder, test_append)
+{
+    m_tester->setWindow(1);
+    const qint64 minute = 60 * 1000;
+    // a key frame every 20s
+    for (int i = 0; i < 12; ++i)
+        m_tester->append({i * 10 * 1000, i % 2 == 0, QByteArray(10, 'x')});
+
+    // the next key frame alone covers the window only from the frame at 80s on, so the ring starts at 40s
+    ASSERT_FALSE(m_tester->m_frames.empty());
+    EXPECT_TRUE(m_tester->m_frames.front().key);
+    EXPECT_EQ(m_tester->m_frames.front().time, 40 * 1000);
+    EXPECT_GE(m_tester->m_frames.back().time - m_tester->m_frames.front().time, minute);
+    EXPECT_EQ(m_tester->m_bytes, qint64(m_tester->m_frames.size()) * 10);
+}
+
+TEST_F(UT_FlightRecorder, test_append_bytes)
+{
+    // frames of the window past the byte bound drop whole groups too, the last one stays
+    const int size = int(FlightRecorder::kMaxBytes) / 3;
+    for (int i = 0; i < 4; ++i)
+        m_tester->append({i * 1000, true, QByteArray(size, 'x')});
+    EXPECT_LE(m_tester->m_bytes, qint64(FlightRecorder::kMaxBytes));
+    EXPECT_EQ(m_tester->m_frames.back().time, 3 * 1000);
+    EXPECT_TRUE(m_tester->m_frames.front().key);
+}
+
+TEST_F(UT_FlightRecorder, test_capture)
+{
+    const QString &path = FlightRecorder::defaultCapturePath();
+    EXPECT_TRUE(path.endsWith(".dsmrec"));
+    // nothing recorded yet
+    EXPECT_FALSE(m_tester->capture(path));
+
+    m_tester->append({1000, true, QByteArray("frame")});
+    ASSERT_TRUE(m_tester->capture(path));
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_11);
+    quint32 magic = 0, version = 0;
+    in >> magic >> version;
+    EXPECT_EQ(magic, 0x464d5344u);
+    EXPECT_EQ(version, 3u);
+    file.close();
+    QFile::remove(path);
+}
+
+TEST_F(UT_FlightRecorder, test_replay_invalid)
+{
+    const QString &path = QDir::temp().filePath("ut_flight_recorder.dsmrec");
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("not a snapshot");
+    file.close();
+    EXPECT_FALSE(m_tester->replay(path));
+    EXPECT_FALSE(m_tester->isReplaying());
+    EXPECT_FALSE(m_tester->replay(path + ".missing"));
+    QFile::remove(path);
+}
+
+TEST_F(UT_FlightRecorder, test_watch)
+{
+    EXPECT_GT(FlightRecorder::countFds(getpid()), 0);
+    EXPECT_EQ(FlightRecorder::countFds(-1), -1);
+
+    ProcessTriggers::ProcessKey key {getpid(), 0};
+    QSet<ProcessTriggers::ProcessKey> scanned {key};
+    m_tester->watch({{key, ProcessTriggers::kCpuRule}}, scanned, QDateTime::currentMSecsSinceEpoch());
+    EXPECT_EQ(m_tester->watchCount(), 1);
+    EXPECT_TRUE(m_tester->m_watchTimer.isActive());
+
+    m_tester->sampleWatches();
+    ASSERT_EQ(m_tester->m_details.size(), size_t(1));
+    EXPECT_GT(m_tester->m_detailBytes, 0);
+
+    // a process gone from the scan is no longer watched
+    m_tester->watch({}, {}, QDateTime::currentMSecsSinceEpoch());
+    EXPECT_EQ(m_tester->watchCount(), 0);
+    EXPECT_FALSE(m_tester->m_watchTimer.isActive());
+}
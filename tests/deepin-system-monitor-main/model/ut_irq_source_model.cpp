@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/irq_source_model.h"
+#include "process_info_record.h"
+
+#include <string.h>
+
+//gtest
+#include <gtest/gtest.h>
+
+namespace {
+
+struct irq_stat_t {
+    uint32_t type;
+    int32_t vec;
+    uint64_t count;
+    uint64_t time_ns;
+    const char *name;
+};
+
+QByteArray irqStats(uint64_t timestamp, std::initializer_list<irq_stat_t> stats)
+{
+    QByteArray buf(int(sizeof(irq_stats_header_t) + stats.size() * sizeof(irq_stat_record_t)), '\0');
+    auto *hdr = reinterpret_cast<irq_stats_header_t *>(buf.data());
+    hdr->magic = IRQ_STATS_MAGIC;
+    hdr->version = IRQ_STATS_VERSION;
+    hdr->record_size = sizeof(irq_stat_record_t);
+    hdr->count = uint32_t(stats.size());
+    hdr->timestamp = timestamp;
+    auto *rec = reinterpret_cast<irq_stat_record_t *>(hdr + 1);
+    for (const auto &stat : stats) {
+        rec->type = stat.type;
+        rec->vec = stat.vec;
+        rec->count = stat.count;
+        rec->time_ns = stat.time_ns;
+        strncpy(rec->name, stat.name, sizeof(rec->name) - 1);
+        ++rec;
+    }
+    return buf;
+}
+
+} // namespace
+
+class UT_IrqSourceModel : public ::testing::Test
+{
+public:
+    UT_IrqSourceModel() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new IrqSourceModel();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    IrqSourceModel *m_tester;
+};
+
+TEST_F(UT_IrqSourceModel, initTest)
+{
+    EXPECT_EQ(m_tester->rowCount(), 0);
+    EXPECT_EQ(m_tester->columnCount(), int(IrqSourceModel::kIrqSourceColumnCount));
+    EXPECT_TRUE(m_tester->isAvailable());
+}
+
+TEST_F(UT_IrqSourceModel, test_applyStats)
+{
+    m_tester->applyStats(irqStats(1000000000ULL, {{IRQ_STAT_HARD, 45, 100, 1000000, "eth0-rx-0"},
+                                                  {IRQ_STAT_SOFT, 3, 200, 0, "NET_RX"}}));
+    ASSERT_EQ(m_tester->rowCount(), 2);
+    // no rate before the second snapshot
+    EXPECT_EQ(m_tester->index(0, IrqSourceModel::kIrqSourceRateColumn).data().toString(), QString("-"));
+
+    // one second later, NET_RX spent 50ms in its handler
+    m_tester->applyStats(irqStats(2000000000ULL, {{IRQ_STAT_HARD, 45, 1100, 11000000, "eth0-rx-0"},
+                                                  {IRQ_STAT_SOFT, 3, 2200, 50000000, "NET_RX"}}));
+    ASSERT_EQ(m_tester->rowCount(), 2);
+    EXPECT_TRUE(m_tester->index(0, IrqSourceModel::kIrqSourceNameColumn).data().toString().contains("NET_RX"));
+    EXPECT_DOUBLE_EQ(m_tester->index(0, IrqSourceModel::kIrqSourceRateColumn).data(Qt::UserRole).toDouble(), 2000.);
+    EXPECT_DOUBLE_EQ(m_tester->index(0, IrqSourceModel::kIrqSourceTimeColumn).data(Qt::UserRole).toDouble(), 5.);
+    EXPECT_DOUBLE_EQ(m_tester->index(1, IrqSourceModel::kIrqSourceTimeColumn).data(Qt::UserRole).toDouble(), 1.);
+
+    // cached snapshot of the server, rates are kept
+    m_tester->applyStats(irqStats(2000000000ULL, {}));
+    EXPECT_EQ(m_tester->rowCount(), 2);
+    // malformed buffers are ignored
+    m_tester->applyStats(QByteArray("garbage"));
+    EXPECT_EQ(m_tester->rowCount(), 2);
+}
+
+TEST_F(UT_IrqSourceModel, test_irqStatRecords)
+{
+    QByteArray buf = irqStats(1, {{IRQ_STAT_SOFT, 1, 5, 10, "TIMER"}});
+    const irq_stat_record_t *records = nullptr;
+    const irq_stats_header_t *hdr = irqStatRecords(buf.constData(), size_t(buf.size()), records);
+    ASSERT_NE(hdr, nullptr);
+    EXPECT_EQ(hdr->count, 1u);
+    EXPECT_EQ(records[0].vec, 1);
+
+    // truncated buffer
+    EXPECT_EQ(irqStatRecords(buf.constData(), size_t(buf.size()) - 1, records), nullptr);
+    EXPECT_EQ(records, nullptr);
+    // server failure
+    EXPECT_EQ(irqStatRecords(nullptr, 0, records), nullptr);
+}
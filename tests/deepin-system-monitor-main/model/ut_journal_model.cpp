@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/journal_model.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//qt
+#include <QDateTime>
+#include <QSignalSpy>
+
+namespace {
+
+QVector<JournalLine> linesOf(int first, int count)
+{
+    QVector<JournalLine> lines;
+    for (int i = first; i < first + count; ++i) {
+        JournalLine line;
+        line.message = QString::number(i);
+        lines << line;
+    }
+    return lines;
+}
+
+} // namespace
+
+TEST(UT_JournalModel, test_append_001)
+{
+    JournalModel model;
+    QSignalSpy inserted(&model, &JournalModel::rowsInserted);
+    model.append(linesOf(0, 3), 0);
+    model.append({}, 5);
+    EXPECT_EQ(model.rowCount(), 3);
+    // one insert per batch, none for an empty one
+    EXPECT_EQ(inserted.count(), 1);
+    EXPECT_EQ(model.droppedCount(), 5);
+    EXPECT_EQ(model.data(model.index(2, 0), Qt::ToolTipRole).toString(), QString("2"));
+
+    model.clear();
+    EXPECT_EQ(model.rowCount(), 0);
+    EXPECT_EQ(model.droppedCount(), 0);
+}
+
+TEST(UT_JournalModel, test_append_002)
+{
+    // the newest lines are kept
+    JournalModel model;
+    model.append(linesOf(0, JournalModel::kMaxLines - 10), 0);
+    model.append(linesOf(JournalModel::kMaxLines - 10, 20), 0);
+    ASSERT_EQ(model.rowCount(), JournalModel::kMaxLines);
+    EXPECT_EQ(model.data(model.index(0, 0), Qt::ToolTipRole).toString(), QString("10"));
+    EXPECT_EQ(model.data(model.index(JournalModel::kMaxLines - 1, 0), Qt::ToolTipRole).toString(),
+              QString::number(JournalModel::kMaxLines + 9));
+
+    model.append(linesOf(0, JournalModel::kMaxLines + 5), 0);
+    ASSERT_EQ(model.rowCount(), JournalModel::kMaxLines);
+    EXPECT_EQ(model.data(model.index(0, 0), Qt::ToolTipRole).toString(), QString("5"));
+}
+
+TEST(UT_JournalModel, test_lineText_001)
+{
+    JournalLine line;
+    line.time = QDateTime(QDate(2025, 3, 4), QTime(5, 6, 7)).toMSecsSinceEpoch() * 1000;
+    line.identifier = "sshd";
+    line.pid = 42;
+    line.message = "Accepted publickey\nsecond line";
+    const QString text = JournalModel::lineText(line);
+    EXPECT_TRUE(text.endsWith("05:06:07 sshd[42]: Accepted publickey …"));
+
+    line.pid = 0;
+    line.message = "Started";
+    EXPECT_TRUE(JournalModel::lineText(line).endsWith(" sshd: Started"));
+}
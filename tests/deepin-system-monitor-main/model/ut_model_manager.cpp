@@ -5,6 +5,7 @@
 
 //self
 #include "model/model_manager.h"
+#include "model/sample_history.h"
 //gtest
 #include "stub.h"
 #include <gtest/gtest.h>
@@ -46,3 +47,9 @@ TEST_F(UT_ModelManager, test_instance_001)
     m_tester->instance();
 
 }
+
+TEST_F(UT_ModelManager, test_sampleHistory_001)
+{
+    EXPECT_NE(m_tester->sampleHistory(), nullptr);
+    EXPECT_EQ(m_tester->sampleHistory()->parent(), m_tester);
+}
@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/netif_queue_model.h"
+#include "common/core_usage.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+using namespace core::system;
+
+namespace {
+
+NetifQueues::irq_t queueIrq(int irq, int queue, std::initializer_list<quint64> counts)
+{
+    NetifQueues::irq_t result;
+    result.irq = irq;
+    result.name = QString("eth0-TxRx-%1").arg(queue).toLatin1();
+    result.queue = queue;
+    result.counts = counts;
+    return result;
+}
+
+common::usage::CoreUsage coreUsage(std::initializer_list<std::pair<double, double>> cores)
+{
+    common::usage::CoreUsage usage;
+    usage.resize(int(cores.size()));
+    size_t cpu = 0;
+    for (const auto &core : cores) {
+        usage.usage[cpu] = core.first;
+        usage.softirq[cpu] = core.second;
+        usage.hardirq[cpu] = 0;
+        ++cpu;
+    }
+    return usage;
+}
+
+} // namespace
+
+class UT_NetifQueueModel : public ::testing::Test
+{
+public:
+    UT_NetifQueueModel() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new NetifQueueModel();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    NetifQueueModel *m_tester;
+};
+
+TEST_F(UT_NetifQueueModel, test_applySample_001)
+{
+    const common::usage::CoreUsage usage = coreUsage({{20., 5.}, {95., 60.}});
+    QMap<int, NetifQueues::queue_stat_t> stats;
+    stats[0].rxPackets = 100;
+    stats[1].rxPackets = 100;
+
+    // the first sample is only the base
+    m_tester->applySample({queueIrq(25, 0, {100, 0}), queueIrq(26, 1, {0, 100})}, stats, 0, {0, 1}, usage);
+    ASSERT_EQ(m_tester->queues().size(), 2);
+    EXPECT_EQ(m_tester->queues()[0].cpu, -1);
+    EXPECT_EQ(m_tester->queues()[0].rxPackets, -1.);
+
+    stats[0].rxPackets = 2100;
+    stats[1].rxPackets = 100;
+    m_tester->applySample({queueIrq(25, 0, {300, 0}), queueIrq(26, 1, {0, 2100})}, stats, 2000, {0, 1}, usage);
+    const QList<NetifQueueModel::queue_t> &queues = m_tester->queues();
+    ASSERT_EQ(queues.size(), 2);
+    EXPECT_EQ(m_tester->cpus(), QVector<int>({0, 1}));
+    EXPECT_DOUBLE_EQ(queues[0].rates[0], 100.);
+    EXPECT_DOUBLE_EQ(queues[0].irqRate, 100.);
+    EXPECT_EQ(queues[0].cpu, 0);
+    EXPECT_FALSE(queues[0].saturated);
+    EXPECT_DOUBLE_EQ(queues[0].rxPackets, 1000.);
+    // its irq lands on the busy core
+    EXPECT_EQ(queues[1].cpu, 1);
+    EXPECT_DOUBLE_EQ(queues[1].rates[1], 1000.);
+    EXPECT_TRUE(queues[1].saturated);
+    EXPECT_DOUBLE_EQ(queues[1].rxPackets, 0.);
+}
+
+TEST_F(UT_NetifQueueModel, test_applySample_002)
+{
+    const common::usage::CoreUsage usage = coreUsage({{10., 0.}});
+    // driver without per queue counters & counters that went back
+    m_tester->applySample({queueIrq(25, 0, {100})}, {}, 0, {0}, usage);
+    m_tester->applySample({queueIrq(25, 0, {50})}, {}, 1000, {0}, usage);
+    ASSERT_EQ(m_tester->queues().size(), 1);
+    EXPECT_DOUBLE_EQ(m_tester->queues()[0].rates[0], 0.);
+    EXPECT_EQ(m_tester->queues()[0].cpu, -1);
+    EXPECT_EQ(m_tester->queues()[0].rxPackets, -1.);
+
+    m_tester->stop();
+    EXPECT_TRUE(m_tester->queues().isEmpty());
+}
+
+TEST_F(UT_NetifQueueModel, test_isSaturated_001)
+{
+    EXPECT_FALSE(NetifQueueModel::isSaturated(50., 10.));
+    EXPECT_TRUE(NetifQueueModel::isSaturated(NetifQueueModel::kSaturatedUsage, 0.));
+    EXPECT_TRUE(NetifQueueModel::isSaturated(60., NetifQueueModel::kSaturatedIrq));
+    EXPECT_FALSE(NetifQueueModel::isSaturated(std::nan(""), std::nan("")));
+}
@@ -0,0 +1,25 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/numa_node_model.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+TEST(UT_NumaNodeModel, test_cpuListText)
+{
+    EXPECT_EQ(NumaNodeModel::cpuListText({0, 1, 2, 3, 8}), QString("0-3,8"));
+    EXPECT_EQ(NumaNodeModel::cpuListText({0, 2, 4}), QString("0,2,4"));
+    EXPECT_EQ(NumaNodeModel::cpuListText({5}), QString("5"));
+    EXPECT_TRUE(NumaNodeModel::cpuListText({}).isEmpty());
+}
+
+TEST(UT_NumaNodeModel, test_noModel)
+{
+    // rows only follow a cpu model
+    NumaNodeModel model(nullptr);
+    EXPECT_EQ(model.rowCount(), 0);
+    EXPECT_EQ(model.columnCount(), int(NumaNodeModel::kNumaNodeColumnCount));
+}
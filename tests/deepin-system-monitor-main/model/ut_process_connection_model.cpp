@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/process_connection_model.h"
+#include "system/netif_monitor.h"
+
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+//gtest
+#include <gtest/gtest.h>
+
+using namespace core::system;
+
+class UT_ProcessConnectionModel : public ::testing::Test
+{
+public:
+    UT_ProcessConnectionModel() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new ProcessConnectionModel(getpid());
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    ProcessConnectionModel *m_tester;
+};
+
+TEST_F(UT_ProcessConnectionModel, initTest)
+{
+    EXPECT_EQ(m_tester->rowCount(), 0);
+    EXPECT_EQ(m_tester->columnCount(), int(ProcessConnectionModel::kConnectionColumnCount));
+}
+
+TEST_F(UT_ProcessConnectionModel, test_refresh)
+{
+    // connected udp socket of our own shows up without any traffic
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(fd, 0);
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(53);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(::connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)), 0);
+
+    m_tester->refresh();
+    bool found = false;
+    for (int row = 0; row < m_tester->rowCount(); ++row) {
+        auto remote = m_tester->index(row, ProcessConnectionModel::kConnectionRemoteAddrColumn).data().toString();
+        found = found || remote == "127.0.0.1:53";
+    }
+    EXPECT_TRUE(found);
+    EXPECT_FALSE(NetifMonitor::instance()->watchedSockIOStats().isEmpty());
+
+    m_tester->stop();
+    EXPECT_TRUE(NetifMonitor::instance()->watchedSockIOStats().isEmpty());
+    ::close(fd);
+}
+
+TEST_F(UT_ProcessConnectionModel, test_formatEndpoint)
+{
+    in_addr a4 {htonl(0x7f000001)};
+    EXPECT_EQ(ProcessConnectionModel::formatEndpoint(AF_INET, &a4, 80), QString("127.0.0.1:80"));
+    in6_addr a6 = IN6ADDR_LOOPBACK_INIT;
+    EXPECT_EQ(ProcessConnectionModel::formatEndpoint(AF_INET6, &a6, 443), QString("[::1]:443"));
+}
@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/process_file_activity_model.h"
+#include "process_info_record.h"
+
+#include <string.h>
+#include <unistd.h>
+
+//gtest
+#include <gtest/gtest.h>
+
+namespace {
+
+struct file_activity_t {
+    uint64_t ino;
+    uint64_t read_bytes;
+    uint64_t write_bytes;
+    const char *path;
+};
+
+QByteArray fileActivity(std::initializer_list<file_activity_t> files)
+{
+    QByteArray buf(int(sizeof(file_activity_header_t) + files.size() * sizeof(file_activity_record_t)), '\0');
+    auto *hdr = reinterpret_cast<file_activity_header_t *>(buf.data());
+    hdr->magic = FILE_ACTIVITY_MAGIC;
+    hdr->version = FILE_ACTIVITY_VERSION;
+    hdr->record_size = sizeof(file_activity_record_t);
+    hdr->count = uint32_t(files.size());
+    auto *rec = reinterpret_cast<file_activity_record_t *>(hdr + 1);
+    for (const auto &file : files) {
+        rec->ino = file.ino;
+        rec->read_bytes = file.read_bytes;
+        rec->write_bytes = file.write_bytes;
+        rec->reads = 1;
+        strncpy(rec->path, file.path, sizeof(rec->path) - 1);
+        ++rec;
+    }
+    return buf;
+}
+
+} // namespace
+
+class UT_ProcessFileActivityModel : public ::testing::Test
+{
+public:
+    UT_ProcessFileActivityModel() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new ProcessFileActivityModel(getpid());
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    ProcessFileActivityModel *m_tester;
+};
+
+TEST_F(UT_ProcessFileActivityModel, initTest)
+{
+    EXPECT_EQ(m_tester->rowCount(), 0);
+    EXPECT_EQ(m_tester->columnCount(), int(ProcessFileActivityModel::kFileActivityColumnCount));
+    EXPECT_TRUE(m_tester->isAvailable());
+}
+
+TEST_F(UT_ProcessFileActivityModel, test_applyActivity)
+{
+    m_tester->applyActivity(fileActivity({{1, 4096, 0, "/tmp/a"}, {2, 0, 1024, ""}}), 1000);
+    ASSERT_EQ(m_tester->rowCount(), 2);
+    // no rate before the second sample
+    EXPECT_EQ(m_tester->index(0, ProcessFileActivityModel::kFileActivityReadColumn).data().toString(), QString("-"));
+
+    // file 2 got busier & its path was resolved in between
+    m_tester->applyActivity(fileActivity({{1, 5120, 0, ""}, {2, 0, 9216, "/tmp/b"}}), 2000);
+    ASSERT_EQ(m_tester->rowCount(), 2);
+    EXPECT_EQ(m_tester->index(0, ProcessFileActivityModel::kFileActivityFileColumn).data().toString(), QString("/tmp/b"));
+    EXPECT_DOUBLE_EQ(m_tester->index(0, ProcessFileActivityModel::kFileActivityWriteColumn).data(Qt::UserRole).toDouble(), 8192.);
+    // path of a closed file is kept
+    EXPECT_EQ(m_tester->index(1, ProcessFileActivityModel::kFileActivityFileColumn).data().toString(), QString("/tmp/a"));
+    EXPECT_DOUBLE_EQ(m_tester->index(1, ProcessFileActivityModel::kFileActivityReadColumn).data(Qt::UserRole).toDouble(), 1024.);
+
+    // malformed buffers are ignored
+    m_tester->applyActivity(QByteArray("garbage"), 3000);
+    EXPECT_EQ(m_tester->rowCount(), 2);
+}
+
+TEST_F(UT_ProcessFileActivityModel, test_fileActivityRecords)
+{
+    QByteArray buf = fileActivity({{7, 1, 2, "/tmp/c"}});
+    const file_activity_record_t *records = nullptr;
+    const file_activity_header_t *hdr = fileActivityRecords(buf.constData(), size_t(buf.size()), records);
+    ASSERT_NE(hdr, nullptr);
+    EXPECT_EQ(hdr->count, 1u);
+    EXPECT_EQ(records[0].ino, 7u);
+
+    // truncated buffer
+    EXPECT_EQ(fileActivityRecords(buf.constData(), size_t(buf.size()) - 1, records), nullptr);
+    EXPECT_EQ(records, nullptr);
+    // server failure
+    EXPECT_EQ(fileActivityRecords(nullptr, 0, records), nullptr);
+}
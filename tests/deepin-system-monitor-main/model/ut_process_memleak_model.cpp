@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/process_memleak_model.h"
+#include "process_info_record.h"
+
+#include <string.h>
+#include <unistd.h>
+
+//gtest
+#include <gtest/gtest.h>
+
+namespace {
+
+struct leak_site_t {
+    uint64_t bytes;
+    uint32_t windows;
+    const char *stack;
+};
+
+QByteArray memleakScan(uint32_t state, uint64_t generation, std::initializer_list<leak_site_t> sites)
+{
+    QByteArray buf(int(sizeof(memleak_scan_header_t) + sites.size() * sizeof(memleak_site_record_t)), '\0');
+    auto *hdr = reinterpret_cast<memleak_scan_header_t *>(buf.data());
+    hdr->magic = MEMLEAK_SCAN_MAGIC;
+    hdr->version = MEMLEAK_SCAN_VERSION;
+    hdr->record_size = sizeof(memleak_site_record_t);
+    hdr->count = uint32_t(sites.size());
+    hdr->pid = getpid();
+    hdr->state = state;
+    hdr->windows = uint32_t(generation);
+    hdr->generation = generation;
+    auto *rec = reinterpret_cast<memleak_site_record_t *>(hdr + 1);
+    for (const auto &site : sites) {
+        rec->bytes = site.bytes;
+        rec->allocations = 1;
+        rec->windows = site.windows;
+        strncpy(rec->stack, site.stack, sizeof(rec->stack) - 1);
+        hdr->bytes += site.bytes;
+        ++hdr->allocations;
+        ++rec;
+    }
+    return buf;
+}
+
+} // namespace
+
+class UT_ProcessMemleakModel : public ::testing::Test
+{
+public:
+    UT_ProcessMemleakModel() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new ProcessMemleakModel(getpid());
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    ProcessMemleakModel *m_tester;
+};
+
+TEST_F(UT_ProcessMemleakModel, initTest)
+{
+    EXPECT_EQ(m_tester->rowCount(), 0);
+    EXPECT_EQ(m_tester->columnCount(), int(ProcessMemleakModel::kMemleakColumnCount));
+    EXPECT_EQ(m_tester->state(), ProcessMemleakModel::kScanIdle);
+    EXPECT_TRUE(m_tester->isAvailable());
+}
+
+TEST_F(UT_ProcessMemleakModel, test_applyScan)
+{
+    m_tester->applyScan(memleakScan(MEMLEAK_SCAN_RUNNING, 1, {{4096, 1, "__kmalloc+0x10\nfoo_open+0x20\n"}}));
+    ASSERT_EQ(m_tester->rowCount(), 1);
+    EXPECT_EQ(m_tester->state(), ProcessMemleakModel::kScanRunning);
+    // allocator frames are skipped
+    EXPECT_EQ(m_tester->index(0, ProcessMemleakModel::kMemleakSiteColumn).data().toString(), QString("foo_open+0x20"));
+    EXPECT_EQ(m_tester->index(0, ProcessMemleakModel::kMemleakSizeColumn).data(Qt::UserRole).toULongLong(), 4096u);
+    EXPECT_EQ(m_tester->leakedBytes(), 4096u);
+
+    // next window found another site
+    m_tester->applyScan(memleakScan(MEMLEAK_SCAN_CANCELLED, 2, {{8192, 2, "foo_open+0x20\n"}, {64, 1, "bar_ioctl+0x8\n"}}));
+    ASSERT_EQ(m_tester->rowCount(), 2);
+    EXPECT_EQ(m_tester->state(), ProcessMemleakModel::kScanCancelled);
+    EXPECT_EQ(m_tester->windows(), 2u);
+    EXPECT_EQ(m_tester->index(0, ProcessMemleakModel::kMemleakWindowsColumn).data().toString(), QString("2/2"));
+
+    // malformed buffers are ignored
+    m_tester->applyScan(QByteArray("garbage"));
+    EXPECT_EQ(m_tester->rowCount(), 2);
+}
+
+TEST_F(UT_ProcessMemleakModel, test_memleakScanRecords)
+{
+    QByteArray buf = memleakScan(MEMLEAK_SCAN_FINISHED, 3, {{128, 3, "baz+0x1\n"}});
+    const memleak_site_record_t *records = nullptr;
+    const memleak_scan_header_t *hdr = memleakScanRecords(buf.constData(), size_t(buf.size()), records);
+    ASSERT_NE(hdr, nullptr);
+    EXPECT_EQ(hdr->count, 1u);
+    EXPECT_EQ(records[0].bytes, 128u);
+
+    // truncated buffer
+    EXPECT_EQ(memleakScanRecords(buf.constData(), size_t(buf.size()) - 1, records), nullptr);
+    EXPECT_EQ(records, nullptr);
+    // server failure
+    EXPECT_EQ(memleakScanRecords(nullptr, 0, records), nullptr);
+}
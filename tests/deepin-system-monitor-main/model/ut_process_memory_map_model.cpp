@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/process_memory_map_model.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <QElapsedTimer>
+#include <QThread>
+
+#include <unistd.h>
+
+using namespace core::process;
+
+class UT_ProcessMemoryMapModel : public ::testing::Test
+{
+public:
+    UT_ProcessMemoryMapModel() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new ProcessMemoryMapModel(getpid());
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    // pick up batches until the scan ends
+    void waitScan()
+    {
+        QElapsedTimer timer;
+        timer.start();
+        while (m_tester->state() == ProcessMemoryMapModel::kScanRunning && timer.elapsed() < 5000) {
+            QThread::msleep(10);
+            m_tester->refresh();
+        }
+    }
+
+    ProcessMemoryMapModel *m_tester;
+};
+
+TEST_F(UT_ProcessMemoryMapModel, test_start_001)
+{
+    m_tester->start(false);
+    EXPECT_EQ(m_tester->state(), ProcessMemoryMapModel::kScanRunning);
+    waitScan();
+    ASSERT_EQ(m_tester->state(), ProcessMemoryMapModel::kScanFinished);
+    EXPECT_FALSE(m_tester->isDetailed());
+    EXPECT_GT(m_tester->mappings(), 0);
+    EXPECT_GT(m_tester->rowCount(), 0);
+    EXPECT_GT(m_tester->totalSize(), 0u);
+    EXPECT_EQ(m_tester->totalRss(), 0u);
+
+    // largest first, rss unknown without smaps
+    for (int row = 1; row < m_tester->rowCount(); ++row)
+        EXPECT_GE(m_tester->index(row - 1, ProcessMemoryMapModel::kMemoryMapSizeColumn).data(Qt::UserRole).toULongLong(),
+                  m_tester->index(row, ProcessMemoryMapModel::kMemoryMapSizeColumn).data(Qt::UserRole).toULongLong());
+    EXPECT_EQ(m_tester->index(0, ProcessMemoryMapModel::kMemoryMapRssColumn).data().toString(), QString("-"));
+}
+
+TEST_F(UT_ProcessMemoryMapModel, test_start_002)
+{
+    m_tester->start(true);
+    waitScan();
+    ASSERT_EQ(m_tester->state(), ProcessMemoryMapModel::kScanFinished);
+    EXPECT_TRUE(m_tester->isDetailed());
+    EXPECT_GT(m_tester->totalRss(), 0u);
+    EXPECT_GE(m_tester->totalSize(), m_tester->totalRss());
+}
+
+TEST_F(UT_ProcessMemoryMapModel, test_start_003)
+{
+    // pid max can never exceed 2^22
+    ProcessMemoryMapModel model(1 << 23);
+    model.start(false);
+    QElapsedTimer timer;
+    timer.start();
+    while (model.state() == ProcessMemoryMapModel::kScanRunning && timer.elapsed() < 5000) {
+        QThread::msleep(10);
+        model.refresh();
+    }
+    EXPECT_EQ(model.state(), ProcessMemoryMapModel::kScanFailed);
+    EXPECT_EQ(model.rowCount(), 0);
+}
+
+TEST_F(UT_ProcessMemoryMapModel, test_cancel_001)
+{
+    m_tester->start(true);
+    m_tester->cancel();
+    EXPECT_EQ(m_tester->state(), ProcessMemoryMapModel::kScanFinished);
+    // nothing of the cancelled scan is merged
+    const int rows = m_tester->rowCount();
+    QThread::msleep(50);
+    m_tester->refresh();
+    EXPECT_EQ(m_tester->rowCount(), rows);
+}
+
+TEST_F(UT_ProcessMemoryMapModel, test_typeName_001)
+{
+    for (int type = 0; type < MemoryMaps::kRegionTypeCount; ++type)
+        EXPECT_FALSE(ProcessMemoryMapModel::typeName(type).isEmpty());
+    EXPECT_TRUE(ProcessMemoryMapModel::typeName(MemoryMaps::kRegionTypeCount).isEmpty());
+}
@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/process_row_preparer.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//qt
+#include <QSignalSpy>
+
+class UT_ProcessRowPreparer : public ::testing::Test
+{
+public:
+    UT_ProcessRowPreparer() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new ProcessRowPreparer();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    ProcessRowPreparer *m_tester;
+};
+
+TEST_F(UT_ProcessRowPreparer, test_rowTable_001)
+{
+    // rows of the current scan are prepared on the monitor thread & published with a queued call
+    QSignalSpy spy(m_tester, &ProcessRowPreparer::rowTableUpdated);
+    ASSERT_TRUE(spy.count() > 0 || spy.wait(5000));
+
+    auto table = m_tester->rowTable();
+    ASSERT_TRUE(table != nullptr);
+    EXPECT_EQ(table->rows.size(), table->procs.size());
+    EXPECT_EQ(table->index.size(), table->procs.size());
+    for (int row = 0; row < table->procs.size(); ++row)
+        EXPECT_EQ(table->index.value(table->procs[row].pid()), row);
+}
@@ -15,6 +15,10 @@
 //gtest
 #include "stub.h"
 #include <gtest/gtest.h>
+
+//qt
+#include <QSignalSpy>
+#include <QStandardItemModel>
 /***************************************STUB begin*********************************************/
 int stub_proclessThan_sortColumn1(){
     return ProcessTableModel::kProcessNameColumn;
@@ -116,10 +120,89 @@ TEST_F(UT_ProcessSortFilterProxyModel, test_filterAcceptsRow_001)
     m_tester->setFilterType(0);
 }
 
+TEST_F(UT_ProcessSortFilterProxyModel, test_filterAcceptsRow_002)
+{
+    ProcessTableModel model;
+    Process root(1), user(2);
+    root.setUserName("root");
+    user.setUserName("deepin");
+    QHash<QString, int> nameRanks, userRanks;
+    model.applyRowTable(ProcessTableModel::makeRowTable({root, user}, false, nameRanks, userRanks));
+    m_tester->setSourceModel(&model);
+    m_tester->setFilterType(0);
+
+    // plain pattern goes through the search index, case insensitive
+    m_tester->setSortFilterString("DEEP");
+    EXPECT_TRUE(m_tester->m_plainSearch);
+    EXPECT_EQ(m_tester->rowCount(), 1);
+
+    // regex pattern is still matched field by field
+    m_tester->setSortFilterString("^ro+t$");
+    EXPECT_FALSE(m_tester->m_plainSearch);
+    EXPECT_EQ(m_tester->rowCount(), 1);
+
+    m_tester->setSourceModel(nullptr);
+}
+
+TEST_F(UT_ProcessSortFilterProxyModel, test_resort_001)
+{
+    // rows keyed by cpu in the source order 0..19
+    QStandardItemModel model(0, ProcessTableModel::kProcessColumnCount);
+    auto setCpu = [&model](int row, int cpu) {
+        model.setData(model.index(row, ProcessTableModel::kProcessCPUColumn), cpu, ProcessTableModel::kSortKeyRole);
+    };
+    model.insertRows(0, 20);
+    for (int row = 0; row < 20; ++row)
+        setCpu(row, row);
+    m_tester->setSourceModel(&model);
+    m_tester->sort(ProcessTableModel::kProcessCPUColumn, Qt::DescendingOrder);
+    ASSERT_EQ(m_tester->rowCount(), 20);
+    EXPECT_EQ(m_tester->mapToSource(m_tester->index(0, 0)).row(), 19);
+    EXPECT_EQ(m_tester->mapToSource(m_tester->index(19, 0)).row(), 0);
+
+    // one busier process is moved alone & stays selected
+    QSignalSpy moved(m_tester, &QAbstractItemModel::rowsMoved);
+    QSignalSpy layouts(m_tester, &QAbstractItemModel::layoutChanged);
+    QPersistentModelIndex current(m_tester->index(19, 0));
+    setCpu(0, 100);
+    EXPECT_EQ(moved.count(), 1);
+    EXPECT_EQ(layouts.count(), 0);
+    EXPECT_EQ(current.row(), 0);
+    EXPECT_EQ(m_tester->mapToSource(m_tester->index(1, 0)).row(), 19);
+
+    // a key changing in place keeps the order
+    setCpu(0, 99);
+    EXPECT_EQ(moved.count(), 1);
+
+    // reversing every row relayouts at once
+    model.blockSignals(true);
+    for (int row = 0; row < 20; ++row)
+        setCpu(row, -row);
+    model.blockSignals(false);
+    Q_EMIT model.dataChanged(model.index(0, 0), model.index(19, ProcessTableModel::kProcessColumnCount - 1));
+    EXPECT_EQ(moved.count(), 1);
+    EXPECT_EQ(layouts.count(), 1);
+    for (int row = 0; row < 20; ++row)
+        EXPECT_EQ(m_tester->mapToSource(m_tester->index(row, 0)).row(), row);
+    EXPECT_EQ(current.row(), 0);
+
+    // inserted & removed rows land in order without relayout
+    model.insertRows(20, 1);
+    setCpu(20, -5);
+    EXPECT_EQ(m_tester->rowCount(), 21);
+    EXPECT_EQ(m_tester->mapToSource(m_tester->index(6, 0)).row(), 20);
+    model.removeRows(0, 2);
+    EXPECT_EQ(m_tester->rowCount(), 19);
+    EXPECT_EQ(m_tester->mapToSource(m_tester->index(0, 0)).row(), 0);
+    EXPECT_EQ(layouts.count(), 1);
+
+    m_tester->setSourceModel(nullptr);
+}
+
 TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_001)
 {
     Stub b;
-    b.set(ADDR(QSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn1);
+    b.set(ADDR(ProcessSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn1);
     QModelIndex *lindex = new QModelIndex;
     QModelIndex *rindex = new QModelIndex;
 
@@ -132,7 +215,7 @@ TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_001)
 TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_002)
 {
     Stub b;
-    b.set(ADDR(QSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn2);
+    b.set(ADDR(ProcessSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn2);
     QModelIndex *lindex = new QModelIndex;
     QModelIndex *rindex = new QModelIndex;
 
@@ -145,7 +228,7 @@ TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_002)
 TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_003)
 {
     Stub b;
-    b.set(ADDR(QSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn3);
+    b.set(ADDR(ProcessSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn3);
     QModelIndex *lindex = new QModelIndex;
     QModelIndex *rindex = new QModelIndex;
 
@@ -158,7 +241,7 @@ TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_003)
 TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_004)
 {
     Stub b;
-    b.set(ADDR(QSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn4);
+    b.set(ADDR(ProcessSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn4);
     QModelIndex *lindex = new QModelIndex;
     QModelIndex *rindex = new QModelIndex;
 
@@ -171,7 +254,7 @@ TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_004)
 TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_005)
 {
     Stub b;
-    b.set(ADDR(QSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn5);
+    b.set(ADDR(ProcessSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn5);
     QModelIndex *lindex = new QModelIndex;
     QModelIndex *rindex = new QModelIndex;
 
@@ -184,7 +267,7 @@ TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_005)
 TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_006)
 {
     Stub b;
-    b.set(ADDR(QSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn6);
+    b.set(ADDR(ProcessSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn6);
     QModelIndex *lindex = new QModelIndex;
     QModelIndex *rindex = new QModelIndex;
 
@@ -197,7 +280,7 @@ TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_006)
 TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_007)
 {
     Stub b;
-    b.set(ADDR(QSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn7);
+    b.set(ADDR(ProcessSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn7);
     QModelIndex *lindex = new QModelIndex;
     QModelIndex *rindex = new QModelIndex;
 
@@ -210,7 +293,7 @@ TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_007)
 TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_008)
 {
     Stub b;
-    b.set(ADDR(QSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn8);
+    b.set(ADDR(ProcessSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn8);
     QModelIndex *lindex = new QModelIndex;
     QModelIndex *rindex = new QModelIndex;
 
@@ -223,7 +306,7 @@ TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_008)
 TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_009)
 {
     Stub b;
-    b.set(ADDR(QSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn9);
+    b.set(ADDR(ProcessSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn9);
     QModelIndex *lindex = new QModelIndex;
     QModelIndex *rindex = new QModelIndex;
 
@@ -236,7 +319,7 @@ TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_009)
 TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_010)
 {
     Stub b;
-    b.set(ADDR(QSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn10);
+    b.set(ADDR(ProcessSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn10);
     QModelIndex *lindex = new QModelIndex;
     QModelIndex *rindex = new QModelIndex;
 
@@ -249,7 +332,7 @@ TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_010)
 TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_011)
 {
     Stub b;
-    b.set(ADDR(QSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn11);
+    b.set(ADDR(ProcessSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn11);
     QModelIndex *lindex = new QModelIndex;
     QModelIndex *rindex = new QModelIndex;
 
@@ -262,7 +345,7 @@ TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_011)
 TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_012)
 {
     Stub b;
-    b.set(ADDR(QSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn12);
+    b.set(ADDR(ProcessSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn12);
     QModelIndex *lindex = new QModelIndex;
     QModelIndex *rindex = new QModelIndex;
 
@@ -275,7 +358,7 @@ TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_012)
 TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_013)
 {
     Stub b;
-    b.set(ADDR(QSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn13);
+    b.set(ADDR(ProcessSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn13);
     QModelIndex *lindex = new QModelIndex;
     QModelIndex *rindex = new QModelIndex;
 
@@ -288,7 +371,7 @@ TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_013)
 TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_014)
 {
     Stub b;
-    b.set(ADDR(QSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn14);
+    b.set(ADDR(ProcessSortFilterProxyModel,sortColumn),stub_proclessThan_sortColumn14);
     QModelIndex *lindex = new QModelIndex;
     QModelIndex *rindex = new QModelIndex;
 
@@ -6,12 +6,15 @@
 //self
 #include "model/process_table_model.h"
 #include "process/process_db.h"
+#include "process/private/process_p.h"
 #include "common/common.h"
+#include "process_info_record.h"
 //gtest
 #include "stub.h"
 #include <gtest/gtest.h>
 //Qt
 #include <QTimer>
+#include <QSignalSpy>
 #include <DApplication>
 
 static QString m_Sresult;
@@ -111,6 +114,12 @@ char stub_process_data_state1(){
 char stub_process_data_state2(){
     return 'T';
 }
+
+static std::shared_ptr<const ProcessTableModel::RowTable> makeTable(const QList<Process> &procs)
+{
+    QHash<QString, int> nameRanks, userRanks;
+    return ProcessTableModel::makeRowTable(procs, false, nameRanks, userRanks);
+}
 /***************************************STUB end**********************************************/
 class UT_ProcessTableModel: public ::testing::Test
 {
@@ -173,26 +182,114 @@ TEST_F(UT_ProcessTableModel, test_updateProcessList_001)
 }
 
 
-TEST_F(UT_ProcessTableModel, test_updateProcessListDelay_001)
-{
-    m_tester->updateProcessListDelay();
-}
-
-TEST_F(UT_ProcessTableModel, test_updateProcessListDelay_002)
+TEST_F(UT_ProcessTableModel, test_updateProcessList_002)
 {
     Stub stub;
     stub.set(ADDR(ProcessSet, getPIDList), stub_getPIDList);
-    m_tester->updateProcessListDelay();
+    m_tester->updateProcessList();
 }
 
-TEST_F(UT_ProcessTableModel, test_updateProcessListDelay_003)
+TEST_F(UT_ProcessTableModel, test_updateProcessList_003)
 {
     Stub stub;
     stub.set(ADDR(ProcessSet, getPIDList), stub_getPIDList);
     m_tester->m_procIdList.append(1);
     Process proc;
     m_tester->m_processList.append(proc);
-    m_tester->updateProcessListDelay();
+    m_tester->m_rowIndex.insert(1, 0);
+    m_tester->updateProcessList();
+}
+
+TEST_F(UT_ProcessTableModel, test_applyRowTable_001)
+{
+    QList<Process> procs;
+    for (pid_t pid = 1; pid <= 6; ++pid)
+        procs << Process(pid);
+    m_tester->applyRowTable(makeTable(procs));
+    ASSERT_EQ(m_tester->rowCount(), 6);
+
+    QSignalSpy removed(m_tester, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy inserted(m_tester, &QAbstractItemModel::rowsInserted);
+    QSignalSpy changed(m_tester, &QAbstractItemModel::dataChanged);
+    // 2 & 3 end, 5 ends, 7 & 8 start
+    procs = {Process(1), Process(4), Process(6), Process(7), Process(8)};
+    m_tester->applyRowTable(makeTable(procs));
+
+    EXPECT_EQ(removed.count(), 2);
+    EXPECT_EQ(inserted.count(), 1);
+    EXPECT_EQ(changed.count(), 1);
+    EXPECT_EQ(m_tester->m_procIdList, QList<pid_t>({1, 4, 6, 7, 8}));
+    for (int row = 0; row < m_tester->m_procIdList.size(); ++row)
+        EXPECT_EQ(m_tester->rowOf(m_tester->m_procIdList[row]), row);
+    EXPECT_EQ(m_tester->rowOf(5), -1);
+}
+
+TEST_F(UT_ProcessTableModel, test_applyRowTable_002)
+{
+    Process root(1), user(2);
+    root.setUserName("root");
+    root.setCpu(12.5);
+    user.setUserName("deepin");
+    m_tester->applyRowTable(makeTable({root, user}));
+    ASSERT_EQ(m_tester->m_rows.size(), 2);
+
+    // texts & keys come from the rows cached by the refresh
+    QModelIndex cpu = m_tester->index(0, ProcessTableModel::kProcessCPUColumn);
+    EXPECT_EQ(cpu.data(Qt::DisplayRole).toString(), QString("12.5%"));
+    EXPECT_DOUBLE_EQ(cpu.data(ProcessTableModel::kSortKeyRole).toDouble(), 12.5);
+    qreal rootRank = m_tester->index(0, ProcessTableModel::kProcessUserColumn).data(ProcessTableModel::kSortKeyRole).toDouble();
+    qreal userRank = m_tester->index(1, ProcessTableModel::kProcessUserColumn).data(ProcessTableModel::kSortKeyRole).toDouble();
+    EXPECT_LT(userRank, rootRank);
+
+    // row removed, remaining ranks kept
+    m_tester->applyRowTable(makeTable({user}));
+    ASSERT_EQ(m_tester->m_rows.size(), 1);
+    EXPECT_EQ(m_tester->index(0, ProcessTableModel::kProcessUserColumn).data().toString(), QString("deepin"));
+}
+
+TEST_F(UT_ProcessTableModel, test_applyRowTable_003)
+{
+    Process root(1), user(2);
+    root.setUserName("root");
+    user.setUserName("deepin");
+    user.d->uid = 1000;
+    auto table = makeTable({root, user});
+    EXPECT_EQ(table->uidRows.value(1000), QVector<int>({1}));
+    EXPECT_EQ(table->index.value(2), 1);
+
+    // rows of other users are filtered out by the prepared per user rows
+    m_tester->m_userModeName = "deepin";
+    m_tester->m_userModeUid = 1000;
+    m_tester->applyRowTable(table);
+    EXPECT_EQ(m_tester->m_procIdList, QList<pid_t>({2}));
+
+    // state changes write to a detached copy, the published table is left untouched
+    m_tester->updateProcessState(2, 'T');
+    EXPECT_EQ(m_tester->getProcessState(2), 'T');
+    EXPECT_NE(table->procs[1].state(), 'T');
+}
+
+TEST_F(UT_ProcessTableModel, test_applyRowTable_004)
+{
+    Process root(1), user(2), other(3);
+    root.d->uid = 0;
+    root.setCpu(10);
+    user.d->uid = 1000;
+    user.setCpu(2.5);
+    other.d->uid = 1000;
+    other.setCpu(5);
+    auto table = makeTable({root, user, other});
+    EXPECT_EQ(table->userUsages.value(1000).processes, 2);
+    EXPECT_DOUBLE_EQ(table->userUsages.value(1000).cpu, 7.5);
+    EXPECT_DOUBLE_EQ(table->totalUsage.cpu, 17.5);
+
+    // summary follows the shown user without summing the rows again
+    m_tester->applyRowTable(table);
+    EXPECT_DOUBLE_EQ(m_tester->getTotalCPUUsage(), 17.5);
+    m_tester->m_userModeName = "deepin";
+    m_tester->m_userModeUid = 1000;
+    m_tester->applyRowTable(table);
+    EXPECT_DOUBLE_EQ(m_tester->getTotalCPUUsage(), 7.5);
 }
 
 TEST_F(UT_ProcessTableModel, test_rowCount_001)
@@ -341,6 +438,16 @@ TEST_F(UT_ProcessTableModel, test_headerData_015)
     EXPECT_EQ(expect,QVariant::fromValue(Qt::DescendingOrder));
 }
 
+TEST_F(UT_ProcessTableModel, test_headerData_cpuWait)
+{
+    int section = ProcessTableModel::kProcessCPUWaitColumn;
+    Qt::Orientation orientation = Qt::Horizontal;
+    EXPECT_EQ(m_tester->headerData(section, orientation, Qt::DisplayRole).toString(),
+              QApplication::translate("Process.Table.Header", kProcessCPUWait));
+    EXPECT_EQ(m_tester->headerData(section, orientation, Qt::ToolTipRole),
+              QApplication::translate("Process.Table.Header", kProcessCPUWaitTip));
+}
+
 TEST_F(UT_ProcessTableModel, test_data_001)
 {
      QModelIndex *index = new QModelIndex();
@@ -1056,6 +1163,7 @@ TEST_F(UT_ProcessTableModel, test_getProcessPriority_001)
 {
      pid_t pid = getpid();
      m_tester->m_procIdList << pid;
+     m_tester->m_rowIndex.insert(pid, 0);
      m_tester->getProcessPriority(pid);
 }
 
@@ -1070,7 +1178,11 @@ TEST_F(UT_ProcessTableModel, test_removeProcess_001)
 {
      pid_t pid = getpid();
      m_tester->m_procIdList << pid;
+     m_tester->m_processList << Process(pid);
+     m_tester->m_rowIndex.insert(pid, 0);
      m_tester->removeProcess(pid);
+     EXPECT_EQ(m_tester->rowCount(), 0);
+     EXPECT_TRUE(m_tester->m_rowIndex.isEmpty());
 }
 
 TEST_F(UT_ProcessTableModel, test_updateProcessState_001)
@@ -1080,6 +1192,7 @@ TEST_F(UT_ProcessTableModel, test_updateProcessState_001)
      char state = 'Z';
      m_tester->m_procIdList << pid;
      m_tester->m_processList << proc;
+     m_tester->m_rowIndex.insert(pid, 0);
 
      m_tester->updateProcessState(pid,state);
 
@@ -1092,7 +1205,146 @@ TEST_F(UT_ProcessTableModel, test_updateProcessPriority_001)
      int priority = 0;
      m_tester->m_procIdList << pid;
      m_tester->m_processList << proc;
+     m_tester->m_rowIndex.insert(pid, 0);
 
      m_tester->updateProcessPriority(pid,priority);
 
 }
+
+TEST_F(UT_ProcessTableModel, test_applyControlResult_001)
+{
+    m_tester->applyRowTable(makeTable({Process(1), Process(2), Process(3), Process(4), Process(5)}));
+    ASSERT_EQ(m_tester->rowCount(), 5);
+
+    // failed processes stay, the others are removed in one pass
+    QSignalSpy removed(m_tester, &QAbstractItemModel::rowsRemoved);
+    m_tester->applyControlResult({1, 2, 4, 5}, PROCESS_CONTROL_SIGNAL, SIGKILL, {0, 0, EPERM, 0});
+    EXPECT_EQ(m_tester->m_procIdList, QList<pid_t>({3, 4}));
+    EXPECT_EQ(m_tester->rowOf(4), 1);
+    EXPECT_EQ(removed.count(), 2);
+
+    QSignalSpy changed(m_tester, &QAbstractItemModel::dataChanged);
+    m_tester->applyControlResult({3, 4}, PROCESS_CONTROL_SIGNAL, SIGSTOP, {0, 0});
+    EXPECT_EQ(m_tester->getProcessState(3), 'T');
+    EXPECT_EQ(m_tester->getProcessState(4), 'T');
+    EXPECT_EQ(changed.count(), 1);
+}
+
+TEST_F(UT_ProcessTableModel, test_setTreeMode_001)
+{
+    Process init(1), shell(2), child(3), other(4);
+    shell.d->ppid = 1;
+    child.d->ppid = 2;
+    other.d->ppid = 1;
+    m_tester->applyRowTable(makeTable({init, shell, child, other}));
+    m_tester->setTreeMode(true);
+
+    // rows nested under their parent process
+    ASSERT_EQ(m_tester->rowCount(), 1);
+    QModelIndex top = m_tester->index(0, 0);
+    ASSERT_EQ(m_tester->rowCount(top), 2);
+    QModelIndex nested = m_tester->index(0, 0, m_tester->index(0, 0, top));
+    EXPECT_EQ(m_tester->flatRow(nested.row(), nested.parent()), 2);
+    EXPECT_EQ(m_tester->parent(nested).parent(), top);
+    EXPECT_EQ(m_tester->rowCount(m_tester->index(0, 1, top)), 0);
+
+    // the layout changes instead of rows being inserted
+    QSignalSpy layout(m_tester, &QAbstractItemModel::layoutChanged);
+    QSignalSpy inserted(m_tester, &QAbstractItemModel::rowsInserted);
+    QPersistentModelIndex kept(nested);
+    child.d->ppid = 4;
+    m_tester->applyRowTable(makeTable({init, shell, child, other}));
+    EXPECT_EQ(layout.count(), 1);
+    EXPECT_EQ(inserted.count(), 0);
+    EXPECT_EQ(m_tester->parent(kept).row(), 1);
+
+    m_tester->setTreeMode(false);
+    EXPECT_EQ(m_tester->rowCount(), 4);
+    EXPECT_EQ(m_tester->rowCount(m_tester->index(0, 0)), 0);
+}
+
+TEST_F(UT_ProcessTableModel, test_headerData_netTrafficSampled)
+{
+    int section = ProcessTableModel::kProcessDownloadColumn;
+    Qt::Orientation orientation = Qt::Horizontal;
+    EXPECT_FALSE(m_tester->headerData(section, orientation, Qt::ToolTipRole).isValid());
+
+    m_tester->m_netTrafficSampled = true;
+    EXPECT_EQ(m_tester->headerData(section, orientation, Qt::DisplayRole).toString(),
+              QApplication::translate("Process.Table.Header", kProcessDownload) + "*");
+    EXPECT_EQ(m_tester->headerData(section, orientation, Qt::ToolTipRole),
+              QApplication::translate("Process.Table.Header", kProcessNetSampled));
+}
+
+TEST_F(UT_ProcessTableModel, test_exhaustionText_001)
+{
+    EXPECT_EQ(ProcessTableModel::exhaustionText(-1), "-");
+    EXPECT_EQ(ProcessTableModel::exhaustionText(30), QApplication::translate("Process.Table.Header", "< 1 min"));
+    EXPECT_EQ(ProcessTableModel::exhaustionText(600), QApplication::translate("Process.Table.Header", "%1 min").arg(10));
+    EXPECT_EQ(ProcessTableModel::exhaustionText(5400), QApplication::translate("Process.Table.Header", "%1 h").arg(1.5, 0, 'f', 1));
+}
+
+TEST_F(UT_ProcessTableModel, test_powerColumn_001)
+{
+    EXPECT_EQ(m_tester->headerData(ProcessTableModel::kProcessPowerColumn, Qt::Horizontal, Qt::DisplayRole).toString(),
+              QApplication::translate("Process.Table.Header", kProcessPower));
+
+    // unknown without RAPL
+    Process proc;
+    EXPECT_EQ(ProcessTableModel::processText(proc, ProcessTableModel::kProcessPowerColumn), "-");
+    EXPECT_EQ(ProcessTableModel::processSortKey(proc, ProcessTableModel::kProcessPowerColumn), -1);
+
+    proc.setPower(2.34);
+    EXPECT_EQ(ProcessTableModel::processText(proc, ProcessTableModel::kProcessPowerColumn), "2.3 W");
+    EXPECT_DOUBLE_EQ(ProcessTableModel::processSortKey(proc, ProcessTableModel::kProcessPowerColumn), 2.34);
+}
+
+TEST_F(UT_ProcessTableModel, test_wakeupsColumn_001)
+{
+    EXPECT_EQ(m_tester->headerData(ProcessTableModel::kProcessWakeupsColumn, Qt::Horizontal, Qt::DisplayRole).toString(),
+              QApplication::translate("Process.Table.Header", kProcessWakeups));
+
+    // estimated from voluntary switches until traced
+    Process proc;
+    EXPECT_FALSE(proc.hasTracedWakeups());
+    EXPECT_EQ(ProcessTableModel::processText(proc, ProcessTableModel::kProcessWakeupsColumn), "0/s");
+
+    proc.setWakeups(12.4, 3.6);
+    EXPECT_TRUE(proc.hasTracedWakeups());
+    EXPECT_EQ(ProcessTableModel::processText(proc, ProcessTableModel::kProcessWakeupsColumn),
+              QApplication::translate("Process.Table.Header", "%1/s, %2 timer").arg(12).arg(4));
+    EXPECT_DOUBLE_EQ(ProcessTableModel::processSortKey(proc, ProcessTableModel::kProcessWakeupsColumn), 12.4);
+}
+
+TEST_F(UT_ProcessTableModel, test_guestCpuColumn_001)
+{
+    EXPECT_EQ(m_tester->headerData(ProcessTableModel::kProcessGuestCPUColumn, Qt::Horizontal, Qt::DisplayRole).toString(),
+              QApplication::translate("Process.Table.Header", kProcessGuestCPU));
+    EXPECT_EQ(m_tester->headerData(ProcessTableModel::kProcessGuestCPUColumn, Qt::Horizontal, Qt::ToolTipRole).toString(),
+              QApplication::translate("Process.Table.Header", kProcessGuestCPUTip));
+
+    // processes that run no guest
+    Process proc;
+    EXPECT_EQ(ProcessTableModel::processText(proc, ProcessTableModel::kProcessGuestCPUColumn), "0.0%");
+    EXPECT_DOUBLE_EQ(ProcessTableModel::processSortKey(proc, ProcessTableModel::kProcessGuestCPUColumn), 0.);
+}
+
+TEST_F(UT_ProcessTableModel, test_commandLineColumn_001)
+{
+    EXPECT_EQ(m_tester->headerData(ProcessTableModel::kProcessCommandLineColumn, Qt::Horizontal, Qt::DisplayRole).toString(),
+              QApplication::translate("Process.Table.Header", kProcessCommandLine));
+
+    Process proc;
+    proc.d->cmdline = QByteArrayList {"/usr/bin/deepin-terminal", "-w", "/tmp"};
+    proc.digestCmdline();
+    EXPECT_EQ(ProcessTableModel::processText(proc, ProcessTableModel::kProcessCommandLineColumn), "/usr/bin/deepin-terminal -w /tmp");
+    // shown whole, nothing is read again
+    EXPECT_EQ(ProcessTableModel::commandLineText(proc), "/usr/bin/deepin-terminal -w /tmp");
+
+    // ordered by their first bytes
+    Process other;
+    other.d->cmdline = QByteArrayList {"/usr/lib/deepin-daemon/dde-system-daemon"};
+    other.digestCmdline();
+    EXPECT_LT(ProcessTableModel::processSortKey(proc, ProcessTableModel::kProcessCommandLineColumn),
+              ProcessTableModel::processSortKey(other, ProcessTableModel::kProcessCommandLineColumn));
+}
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/process_thread_model.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <unistd.h>
+
+class UT_ProcessThreadModel : public ::testing::Test
+{
+public:
+    UT_ProcessThreadModel() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new ProcessThreadModel(getpid());
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    ProcessThreadModel *m_tester;
+};
+
+TEST_F(UT_ProcessThreadModel, test_parseTaskStat)
+{
+    const char stat[] = "4242 (C2 Compiler) R 4200 4200 4200 0 -1 4194368 5207 0 0 0 1234 56 0 0 20 0 48 0 "
+                        "1916 8413184000 120000 18446744073709551615 1 1 0 0 0 0 0 4096 0 0 0 0 -1 7 0 0 0 0 0\n";
+    ProcessThreadModel::task_stat_t task;
+    ASSERT_TRUE(ProcessThreadModel::parseTaskStat(stat, strlen(stat), task));
+    EXPECT_EQ(task.name, QString("C2 Compiler"));
+    EXPECT_EQ(task.state, 'R');
+    EXPECT_EQ(task.ticks, 1234u + 56u);
+    EXPECT_EQ(task.processor, 7);
+
+    const char truncated[] = "4242 (java) S 4200 4200";
+    EXPECT_FALSE(ProcessThreadModel::parseTaskStat(truncated, strlen(truncated), task));
+}
+
+TEST_F(UT_ProcessThreadModel, test_parseSchedStat)
+{
+    const char schedstat[] = "123456789 987654 321\n";
+    unsigned long long wtime = 0;
+    ASSERT_TRUE(ProcessThreadModel::parseSchedStat(schedstat, strlen(schedstat), wtime));
+    EXPECT_EQ(wtime, 987654u);
+    EXPECT_FALSE(ProcessThreadModel::parseSchedStat("", 0, wtime));
+}
+
+TEST_F(UT_ProcessThreadModel, test_refresh)
+{
+    m_tester->refresh();
+    ASSERT_GE(m_tester->rowCount(), 1);
+    EXPECT_EQ(m_tester->columnCount(), int(ProcessThreadModel::kThreadColumnCount));
+    // no rate before a second sample
+    EXPECT_EQ(m_tester->index(0, ProcessThreadModel::kThreadCPUColumn).data().toString(), QString("-"));
+
+    // rates need time between the samples
+    usleep(20 * 1000);
+    m_tester->refresh();
+    bool found = false;
+    for (int row = 0; row < m_tester->rowCount(); ++row) {
+        if (m_tester->index(row, ProcessThreadModel::kThreadIdColumn).data(Qt::UserRole).toInt() == getpid()) {
+            found = true;
+            EXPECT_NE(m_tester->index(row, ProcessThreadModel::kThreadCPUColumn).data().toString(), QString("-"));
+        }
+    }
+    EXPECT_TRUE(found);
+
+    m_tester->stop();
+    EXPECT_EQ(m_tester->m_fdCache.count(), 0);
+    EXPECT_TRUE(m_tester->m_samples.isEmpty());
+}
+
+TEST_F(UT_ProcessThreadModel, test_stateText)
+{
+    EXPECT_FALSE(ProcessThreadModel::stateText('R').isEmpty());
+    EXPECT_EQ(ProcessThreadModel::stateText('X'), QString("X"));
+}
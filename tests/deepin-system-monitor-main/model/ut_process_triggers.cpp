@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/process_triggers.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+class UT_ProcessTriggers : public ::testing::Test
+{
+public:
+    UT_ProcessTriggers() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new ProcessTriggers();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    // one row per pid, cpu in % & memory in kB
+    static ProcessTableModel::RowTable makeTable(const QList<pid_t> &pids, const QList<qreal> &cpus,
+                                                 const QList<qreal> &memories)
+    {
+        ProcessTableModel::RowTable table;
+        for (int i = 0; i < pids.size(); ++i) {
+            table.procs << Process(pids[i]);
+            ProcessTableModel::ProcessRow row;
+            row.key[ProcessTableModel::kProcessCPUColumn] = cpus[i];
+            row.key[ProcessTableModel::kProcessMemoryColumn] = memories[i];
+            table.rows << row;
+        }
+        return table;
+    }
+
+    ProcessTriggers *m_tester;
+};
+
+TEST_F(UT_ProcessTriggers, test_cpu_rule)
+{
+    // 95% from the first scan on, matched once it lasted 30s, until it drops
+    qint64 now = 0;
+    for (; now < 30 * 1000; now += 2000)
+        EXPECT_TRUE(m_tester->evaluate(makeTable({10, 11}, {95, 10}, {1000, 1000}), now).isEmpty());
+    QVector<ProcessTriggers::match_t> matches = m_tester->evaluate(makeTable({10, 11}, {95, 10}, {1000, 1000}), now);
+    ASSERT_EQ(matches.size(), 1);
+    EXPECT_EQ(matches[0].key.first, 10);
+    EXPECT_EQ(matches[0].rules, int(ProcessTriggers::kCpuRule));
+
+    // a dip starts the run over
+    now += 2000;
+    EXPECT_TRUE(m_tester->evaluate(makeTable({10}, {50}, {1000}), now).isEmpty());
+    now += 2000;
+    EXPECT_TRUE(m_tester->evaluate(makeTable({10}, {95}, {1000}), now).isEmpty());
+}
+
+TEST_F(UT_ProcessTriggers, test_memory_rule)
+{
+    const qreal gb = 1024 * 1024;
+    EXPECT_TRUE(m_tester->evaluate(makeTable({10}, {0}, {gb}), 0).isEmpty());
+    EXPECT_TRUE(m_tester->evaluate(makeTable({10}, {0}, {gb * 1.5}), 20 * 1000).isEmpty());
+    QVector<ProcessTriggers::match_t> matches = m_tester->evaluate(makeTable({10}, {0}, {gb * 2.1}), 40 * 1000);
+    ASSERT_EQ(matches.size(), 1);
+    EXPECT_EQ(matches[0].rules, int(ProcessTriggers::kMemoryGrowthRule));
+
+    // the next window starts from the memory reached
+    EXPECT_TRUE(m_tester->evaluate(makeTable({10}, {0}, {gb * 2.2}), 60 * 1000).isEmpty());
+    EXPECT_TRUE(m_tester->evaluate(makeTable({10}, {0}, {gb * 2.5}), 80 * 1000).isEmpty());
+}
+
+TEST_F(UT_ProcessTriggers, test_gone_process)
+{
+    qint64 now = 0;
+    for (; now <= 30 * 1000; now += 2000)
+        m_tester->evaluate(makeTable({10}, {95}, {1000}), now);
+    EXPECT_EQ(m_tester->m_states.size(), 1);
+
+    // state of a process missing from a scan is dropped, it starts over when seen again
+    m_tester->evaluate(makeTable({11}, {0}, {1000}), now);
+    EXPECT_FALSE(m_tester->m_states.contains(qMakePair(pid_t(10), qulonglong(0))));
+    now += 2000;
+    EXPECT_TRUE(m_tester->evaluate(makeTable({10}, {95}, {1000}), now).isEmpty());
+}
+
+TEST_F(UT_ProcessTriggers, test_setRules)
+{
+    ProcessTriggers::rules_t rules;
+    rules.cpuPercent = 50;
+    rules.cpuDuration = 0;
+    m_tester->setRules(rules);
+    QVector<ProcessTriggers::match_t> matches = m_tester->evaluate(makeTable({10}, {60}, {1000}), 0);
+    ASSERT_EQ(matches.size(), 1);
+    EXPECT_EQ(matches[0].rules, int(ProcessTriggers::kCpuRule));
+}
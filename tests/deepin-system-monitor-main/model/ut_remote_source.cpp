@@ -0,0 +1,191 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/remote_source.h"
+#include "remote_agent.h"
+#include "system/device_snapshot.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//qt
+#include <QSignalSpy>
+
+//system
+#include <string.h>
+
+using namespace core::process;
+using namespace core::system;
+
+static QByteArray helloFrame(const char *hostname)
+{
+    remote_hello_t hello {};
+    hello.version = REMOTE_AGENT_VERSION;
+    hello.byte_order = REMOTE_AGENT_BYTE_ORDER;
+    hello.record_size = sizeof(process_info_record_t);
+    hello.interval = 2000;
+    strncpy(hello.hostname, hostname, sizeof(hello.hostname) - 1);
+    QByteArray payload(reinterpret_cast<const char *>(&hello), sizeof(hello));
+    QByteArray info;
+    QDataStream out(&info, QIODevice::WriteOnly);
+    out.setVersion(RemoteAgent::kStreamVersion);
+    CPUSet().saveInfo(out);
+    return RemoteAgent::encodeFrame(REMOTE_FRAME_HELLO, payload + info);
+}
+
+static QByteArray systemFrame()
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(RemoteAgent::kStreamVersion);
+    DeviceSnapshot snapshot;
+    snapshot.cpuSet.saveStats(out);
+    snapshot.memInfo.save(out);
+    out << qreal(1) << qreal(2) << qreal(3) << qreal(4) << qulonglong(5) << qulonglong(6);
+    return RemoteAgent::encodeFrame(REMOTE_FRAME_SYSTEM, payload);
+}
+
+static QByteArray processesFrame(const QHash<pid_t, process_info_record_t> &previous,
+                                 const QHash<pid_t, process_info_record_t> &current, quint64 generation, bool baseline)
+{
+    QList<pid_t> created;
+    QByteArray payload = RemoteAgent::encodeDelta(previous, current, generation, baseline, created);
+    QByteArray names;
+    QDataStream out(&names, QIODevice::WriteOnly);
+    out.setVersion(RemoteAgent::kStreamVersion);
+    for (pid_t pid : created) {
+        // as written by Process::saveNames
+        out << qint32(pid) << qint32(0) << true;
+        out << pid << pid_t(1) << uid_t(1000) << gid_t(1000) << uid_t(1000) << gid_t(1000) << qulonglong(100);
+        out << QString("proc%1").arg(pid) << QString("proc%1").arg(pid) << QString("Proc %1").arg(pid) << QString("user")
+            << QByteArrayList {"proc"};
+    }
+    quint32 count = quint32(created.size());
+    payload.append(reinterpret_cast<const char *>(&count), sizeof(count));
+    payload.append(names);
+    return RemoteAgent::encodeFrame(REMOTE_FRAME_PROCESSES, payload);
+}
+
+static process_info_record_t makeRecord(pid_t pid, qreal cpu)
+{
+    process_info_record_t rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.pid = pid;
+    rec.tgid = pid;
+    rec.ppid = 1;
+    rec.start_time = 100;
+    rec.rss = 4096 << 10;
+    rec.state = 'S';
+    rec.sections = kProcessInfoStat | kProcessInfoIO | kProcessInfoStatus | kProcessInfoRates;
+    rec.cpu_usage = cpu;
+    return rec;
+}
+
+TEST(UT_RemoteSource, test_parseTarget_001)
+{
+    QString destination, address;
+    int port = 0;
+    EXPECT_TRUE(RemoteSource::parseTarget("user@host", destination, address, port));
+    EXPECT_EQ(destination, QString("user@host"));
+    EXPECT_TRUE(address.isEmpty());
+
+    EXPECT_TRUE(RemoteSource::parseTarget("ssh://host:2222", destination, address, port));
+    EXPECT_EQ(destination, QString("ssh://host:2222"));
+
+    EXPECT_TRUE(RemoteSource::parseTarget("tcp://127.0.0.1:9102", destination, address, port));
+    EXPECT_TRUE(destination.isEmpty());
+    EXPECT_EQ(address, QString("127.0.0.1"));
+    EXPECT_EQ(port, 9102);
+
+    // ssh options & missing ports
+    EXPECT_FALSE(RemoteSource::parseTarget("-oProxyCommand=true", destination, address, port));
+    EXPECT_FALSE(RemoteSource::parseTarget("host name", destination, address, port));
+    EXPECT_FALSE(RemoteSource::parseTarget("tcp://127.0.0.1", destination, address, port));
+    EXPECT_FALSE(RemoteSource::parseTarget("", destination, address, port));
+}
+
+TEST(UT_RemoteSource, test_decodeSystem_001)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(RemoteAgent::kStreamVersion);
+    DeviceSnapshot sent;
+    sent.cpuSet.saveStats(out);
+    sent.memInfo.save(out);
+    out << qreal(1) << qreal(2) << qreal(3) << qreal(4) << qulonglong(5) << qulonglong(6);
+
+    // agents before pressure was streamed
+    CPUSet cpuSet;
+    DeviceSnapshot snapshot;
+    EXPECT_TRUE(RemoteSource::decodeSystem(payload, cpuSet, snapshot));
+    EXPECT_DOUBLE_EQ(snapshot.netSentBps, 4.);
+    EXPECT_EQ(snapshot.netTotalSentBytes, 6ULL);
+    EXPECT_FALSE(snapshot.pressure[common::pressure::kMemoryPressure].valid);
+
+    for (int i = 0; i < common::pressure::kPressureResourceCount; ++i)
+        out << true << true << qreal(10 * (i + 1)) << qreal(i);
+    EXPECT_TRUE(RemoteSource::decodeSystem(payload, cpuSet, snapshot));
+    EXPECT_TRUE(snapshot.pressure[common::pressure::kMemoryPressure].valid);
+    EXPECT_DOUBLE_EQ(snapshot.pressure[common::pressure::kMemoryPressure].someRate, 20.);
+    EXPECT_DOUBLE_EQ(snapshot.pressure[common::pressure::kIOPressure].fullRate, 2.);
+
+    // cut short
+    EXPECT_FALSE(RemoteSource::decodeSystem(payload.left(8), cpuSet, snapshot));
+}
+
+TEST(UT_RemoteSource, test_feed_001)
+{
+    RemoteSource source("user@host");
+    QSignalSpy connectedSpy(&source, &RemoteSource::connected);
+    QSignalSpy updatedSpy(&source, &RemoteSource::updated);
+
+    QHash<pid_t, process_info_record_t> first {{10, makeRecord(10, 1.5)}, {11, makeRecord(11, 0)}};
+    QByteArray stream = helloFrame("node1") + systemFrame() + processesFrame({}, first, 1, true);
+    // frames split anywhere are put back together
+    int half = stream.size() / 2;
+    EXPECT_TRUE(source.feed(stream.left(half)));
+    EXPECT_TRUE(source.feed(stream.mid(half)));
+    EXPECT_EQ(connectedSpy.count(), 1);
+    EXPECT_EQ(source.hostName(), QString("node1"));
+    ASSERT_EQ(updatedSpy.count(), 1);
+    ASSERT_EQ(source.processes().size(), 2);
+    EXPECT_EQ(source.processes()[10].name(), QString("proc10"));
+    EXPECT_DOUBLE_EQ(source.processes()[10].cpu(), 1.5);
+    EXPECT_EQ(source.processes()[10].memory(), 4096ULL);
+    ASSERT_TRUE(source.deviceSnapshot());
+    EXPECT_DOUBLE_EQ(source.deviceSnapshot()->diskReadBps, 1.);
+
+    // 11 exits, 10 changes & keeps its names
+    QHash<pid_t, process_info_record_t> second {{10, makeRecord(10, 3)}};
+    EXPECT_TRUE(source.feed(systemFrame() + processesFrame(first, second, 2, false)));
+    EXPECT_EQ(updatedSpy.count(), 2);
+    ASSERT_EQ(source.processes().size(), 1);
+    EXPECT_EQ(source.processes()[10].name(), QString("proc10"));
+    EXPECT_DOUBLE_EQ(source.processes()[10].cpu(), 3.);
+    EXPECT_GT(source.bytesReceived(), quint64(stream.size()));
+}
+
+TEST(UT_RemoteSource, test_feed_002)
+{
+    RemoteSource source("user@host");
+    QSignalSpy failedSpy(&source, &RemoteSource::failed);
+    QHash<pid_t, process_info_record_t> first {{10, makeRecord(10, 0)}};
+    EXPECT_TRUE(source.feed(helloFrame("node1") + systemFrame() + processesFrame({}, first, 1, true)));
+
+    // a generation gap can't be followed
+    EXPECT_FALSE(source.feed(systemFrame() + processesFrame(first, first, 5, false)));
+    EXPECT_EQ(failedSpy.count(), 1);
+    // nor anything after
+    EXPECT_FALSE(source.feed(systemFrame()));
+    EXPECT_EQ(failedSpy.count(), 1);
+}
+
+TEST(UT_RemoteSource, test_feed_003)
+{
+    RemoteSource source("user@host");
+    QSignalSpy failedSpy(&source, &RemoteSource::failed);
+    EXPECT_FALSE(source.feed(QByteArray("SSH-2.0-OpenSSH banner, not an agent stream")));
+    EXPECT_EQ(failedSpy.count(), 1);
+}
@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/sample_history.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//qt
+#include <QDateTime>
+#include <QDir>
+#include <QSignalSpy>
+#include <QStandardPaths>
+
+#include <cmath>
+
+class UT_SampleHistory : public ::testing::Test
+{
+public:
+    UT_SampleHistory() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        // history is written under ~/.qttest instead of the user's data
+        QStandardPaths::setTestModeEnabled(true);
+        m_tester = new SampleHistory();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+        QStandardPaths::setTestModeEnabled(false);
+    }
+
+protected:
+    SampleHistory *m_tester;
+};
+
+TEST_F(UT_SampleHistory, test_series)
+{
+    const common::core::SeriesRing &series = m_tester->series(SampleHistory::kNetRecv, "00:11:22:33:44:55");
+    EXPECT_TRUE(series.empty());
+    EXPECT_EQ(series.capacity(), SampleHistory::kHistorySize);
+    // same view on every lookup, other devices get their own
+    EXPECT_EQ(&m_tester->series(SampleHistory::kNetRecv, "00:11:22:33:44:55"), &series);
+    EXPECT_NE(&m_tester->series(SampleHistory::kNetRecv), &series);
+    EXPECT_NE(&m_tester->series(SampleHistory::kNetSent, "00:11:22:33:44:55"), &series);
+}
+
+TEST_F(UT_SampleHistory, test_push)
+{
+    m_tester->push(SampleHistory::kCpuTotal, {}, 12.5);
+    m_tester->push(SampleHistory::kCpuTotal, {}, std::nan(""));
+    const common::core::SeriesRing &series = m_tester->series(SampleHistory::kCpuTotal);
+    ASSERT_EQ(series.size(), size_t(2));
+    EXPECT_EQ(series.at(0), 12.5);
+    // invalid sample reads as idle
+    EXPECT_EQ(series.last(), 0.);
+}
+
+TEST_F(UT_SampleHistory, test_record)
+{
+    // series of a removed device keeps following the ticks
+    const common::core::SeriesRing &gone = m_tester->series(SampleHistory::kDiskRead, "sdz");
+    QSignalSpy spy(m_tester, &SampleHistory::updated);
+    m_tester->record();
+    m_tester->record();
+
+    EXPECT_EQ(spy.count(), 2);
+    EXPECT_EQ(gone.size(), size_t(2));
+    EXPECT_EQ(gone.max(), 0.);
+    EXPECT_EQ(m_tester->series(SampleHistory::kCpuTotal).size(), size_t(2));
+    EXPECT_EQ(m_tester->series(SampleHistory::kNetSent).size(), size_t(2));
+}
+
+TEST_F(UT_SampleHistory, test_stored)
+{
+    m_tester->record();
+    qint64 to = QDateTime::currentMSecsSinceEpoch() + 1;
+    // pending samples are written when the history goes away
+    delete m_tester;
+    m_tester = new SampleHistory();
+
+    std::vector<double> values = m_tester->stored(SampleHistory::kNetRecv, {}, to - 60 * 1000, to, 2);
+    ASSERT_EQ(values.size(), size_t(2));
+    EXPECT_FALSE(std::isnan(values[1]));
+    EXPECT_TRUE(m_tester->stored(SampleHistory::kNetRecv, {}, to - 60 * 1000, to, 0).empty());
+
+    QDir(QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + "/deepin/deepin-system-monitor/history")
+        .removeRecursively();
+}
+
+TEST_F(UT_SampleHistory, test_setInterval)
+{
+    for (int i = 0; i < 5; ++i)
+        m_tester->push(SampleHistory::kCpuTotal, {}, i * 10.);
+    const common::core::SeriesRing &series = m_tester->series(SampleHistory::kCpuTotal);
+    EXPECT_EQ(m_tester->spanText(), QString("60 seconds"));
+
+    // half the interval, twice the samples over the same span, newest kept
+    m_tester->setInterval(1000);
+    EXPECT_EQ(m_tester->interval(), 1000);
+    ASSERT_EQ(series.size(), size_t(9));
+    EXPECT_EQ(series.last(), 40.);
+    EXPECT_EQ(series.at(0), 0.);
+    EXPECT_EQ(series.recent(1), 35.);
+    EXPECT_EQ(m_tester->spanText(), QString("30 seconds"));
+
+    m_tester->setInterval(10000);
+    EXPECT_EQ(m_tester->spanText(), QString("5 minutes"));
+}
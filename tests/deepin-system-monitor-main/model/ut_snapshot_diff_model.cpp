@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/snapshot_diff_model.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+using namespace core::process;
+
+class UT_SnapshotDiffModel : public ::testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        auto before = std::make_shared<DiffSnapshot>(1000);
+        auto after = std::make_shared<DiffSnapshot>(2000);
+        diff_row_t idle;
+        idle.pid = 1;
+        idle.name = "systemd";
+        idle.memory = 4000;
+        before->append(idle);
+        after->append(idle);
+
+        diff_row_t busy;
+        busy.pid = 2;
+        busy.name = "make";
+        busy.unit = "build.service";
+        busy.cpuTicks = 100;
+        before->append(busy);
+        busy.cpuTicks = 400;
+        after->append(busy);
+
+        diff_row_t started;
+        started.pid = 3;
+        started.name = "cc1";
+        started.unit = "build.service";
+        started.memory = 2048;
+        after->append(started);
+
+        before->finish();
+        after->finish();
+        m_diff = SnapshotDiff::compute(before, after);
+    }
+
+protected:
+    SnapshotDiff m_diff;
+};
+
+TEST_F(UT_SnapshotDiffModel, test_rows)
+{
+    SnapshotDiffModel model;
+    EXPECT_EQ(model.rowCount(), 0);
+    model.setDiff(m_diff);
+    EXPECT_EQ(model.columnCount(), int(SnapshotDiffModel::kDiffColumnCount));
+    // the idle process didn't change
+    ASSERT_EQ(model.rowCount(), 2);
+    model.setShowUnchanged(true);
+    EXPECT_EQ(model.rowCount(), 3);
+
+    // most cpu time first by default
+    model.setShowUnchanged(false);
+    EXPECT_EQ(model.data(model.index(0, SnapshotDiffModel::kDiffNameColumn)).toString(), QString("make"));
+    model.sort(SnapshotDiffModel::kDiffMemoryColumn, Qt::DescendingOrder);
+    EXPECT_EQ(model.data(model.index(0, SnapshotDiffModel::kDiffNameColumn)).toString(), QString("cc1"));
+    EXPECT_FALSE(model.data(model.index(0, SnapshotDiffModel::kDiffChangeColumn)).toString().isEmpty());
+}
+
+TEST_F(UT_SnapshotDiffModel, test_services)
+{
+    SnapshotDiffModel model;
+    model.setDiff(m_diff);
+    model.setMode(SnapshotDiffModel::kServiceMode);
+    ASSERT_EQ(model.rowCount(), 1);
+    EXPECT_EQ(model.data(model.index(0, SnapshotDiffModel::kDiffNameColumn)).toString(), QString("build.service"));
+    EXPECT_EQ(model.data(model.index(0, SnapshotDiffModel::kDiffPidColumn)).toString(), QString("1 → 2"));
+}
+
+TEST_F(UT_SnapshotDiffModel, test_signedText)
+{
+    EXPECT_TRUE(SnapshotDiffModel::signedText(0, "0").isEmpty());
+    EXPECT_EQ(SnapshotDiffModel::signedText(3, "3"), QString("+3"));
+    EXPECT_EQ(SnapshotDiffModel::signedText(-3, "3"), QString("-3"));
+}
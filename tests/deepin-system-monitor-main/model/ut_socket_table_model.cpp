@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/socket_table_model.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//qt
+#include <QSignalSpy>
+
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+using namespace core::system;
+
+namespace {
+
+SocketTable::socket_t tcpSocket(uint64_t cookie, uint16_t lport, uint8_t state, pid_t pid = 0)
+{
+    SocketTable::socket_t sock {};
+    sock.cookie = cookie;
+    sock.family = AF_INET;
+    sock.proto = IPPROTO_TCP;
+    sock.lport = lport;
+    sock.rport = state == TCP_LISTEN ? 0 : 443;
+    sock.state = state;
+    sock.pid = pid;
+    return sock;
+}
+
+} // namespace
+
+class UT_SocketTableModel : public ::testing::Test
+{
+public:
+    UT_SocketTableModel() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new SocketTableModel();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    SocketTableModel *m_tester;
+};
+
+TEST_F(UT_SocketTableModel, test_merge_001)
+{
+    m_tester->sort(SocketTableModel::kSocketLocalAddrColumn, Qt::AscendingOrder);
+    m_tester->merge({tcpSocket(1, 80, TCP_LISTEN, 10), tcpSocket(2, 40000, TCP_ESTABLISHED, 10),
+                     tcpSocket(3, 40001, TCP_ESTABLISHED)},
+                    {{10, "nginx"}});
+    ASSERT_EQ(m_tester->rowCount(), 3);
+    EXPECT_EQ(m_tester->total(), 3);
+    EXPECT_EQ(m_tester->index(0, SocketTableModel::kSocketStateColumn).data().toString(), QString("LISTEN"));
+    EXPECT_EQ(m_tester->index(0, SocketTableModel::kSocketRemoteAddrColumn).data().toString(), QString("*"));
+    EXPECT_EQ(m_tester->index(1, SocketTableModel::kSocketLocalAddrColumn).data().toString(), QString("0.0.0.0:40000"));
+    EXPECT_EQ(m_tester->index(1, SocketTableModel::kSocketProcessColumn).data().toString(), QString("nginx (10)"));
+    EXPECT_EQ(m_tester->index(2, SocketTableModel::kSocketProcessColumn).data().toString(), QString());
+
+    // one socket closed, one opened & one changed: patched, not reset
+    QSignalSpy resets(m_tester, &SocketTableModel::modelReset);
+    QSignalSpy removed(m_tester, &SocketTableModel::rowsRemoved);
+    QSignalSpy inserted(m_tester, &SocketTableModel::rowsInserted);
+    QSignalSpy changed(m_tester, &SocketTableModel::dataChanged);
+    SocketTable::socket_t sock = tcpSocket(2, 40000, TCP_ESTABLISHED, 10);
+    sock.rtt = 1500;
+    m_tester->merge({tcpSocket(1, 80, TCP_LISTEN, 10), sock, tcpSocket(4, 40002, TCP_SYN_SENT)}, {{10, "nginx"}});
+    EXPECT_EQ(resets.count(), 0);
+    EXPECT_EQ(removed.count(), 1);
+    EXPECT_EQ(inserted.count(), 1);
+    ASSERT_EQ(m_tester->rowCount(), 3);
+    EXPECT_EQ(m_tester->index(1, SocketTableModel::kSocketRttColumn).data().toString(), QString("1.5 ms"));
+    EXPECT_EQ(m_tester->index(2, SocketTableModel::kSocketStateColumn).data().toString(), QString("SYN-SENT"));
+
+    // nothing changed, nothing signalled
+    changed.clear();
+    m_tester->merge({tcpSocket(1, 80, TCP_LISTEN, 10), sock, tcpSocket(4, 40002, TCP_SYN_SENT)}, {{10, "nginx"}});
+    EXPECT_EQ(changed.count(), 0);
+    EXPECT_EQ(removed.count(), 1);
+}
+
+TEST_F(UT_SocketTableModel, test_merge_002)
+{
+    // sorted by rtt, a changed rtt moves its row & the persistent index follows the socket
+    m_tester->sort(SocketTableModel::kSocketRttColumn, Qt::DescendingOrder);
+    SocketTable::socket_t slow = tcpSocket(1, 40000, TCP_ESTABLISHED);
+    slow.rtt = 90000;
+    SocketTable::socket_t fast = tcpSocket(2, 40001, TCP_ESTABLISHED);
+    fast.rtt = 100;
+    m_tester->merge({slow, fast}, {});
+    QPersistentModelIndex current(m_tester->index(1, 0));
+
+    fast.rtt = 200000;
+    m_tester->merge({slow, fast}, {});
+    EXPECT_EQ(current.row(), 0);
+    EXPECT_EQ(m_tester->index(0, SocketTableModel::kSocketLocalAddrColumn).data().toString(), QString("0.0.0.0:40001"));
+}
+
+TEST_F(UT_SocketTableModel, test_setFilter_001)
+{
+    m_tester->merge({tcpSocket(1, 80, TCP_LISTEN, 10), tcpSocket(2, 40000, TCP_ESTABLISHED, 10),
+                     tcpSocket(3, 40001, TCP_ESTABLISHED, 20)},
+                    {{10, "nginx"}, {20, "curl"}});
+    m_tester->setFilter(SocketTableModel::parseFilter("state:estab NGINX"));
+    ASSERT_EQ(m_tester->rowCount(), 1);
+    EXPECT_EQ(m_tester->index(0, SocketTableModel::kSocketLocalAddrColumn).data().toString(), QString("0.0.0.0:40000"));
+
+    // a bare number is a local or remote port
+    m_tester->setFilter(SocketTableModel::parseFilter("443"));
+    EXPECT_EQ(m_tester->rowCount(), 2);
+    m_tester->setFilter({});
+    EXPECT_EQ(m_tester->rowCount(), 3);
+    EXPECT_EQ(m_tester->total(), 3);
+}
+
+TEST_F(UT_SocketTableModel, test_parseFilter_001)
+{
+    SocketTableModel::filter_t filter = SocketTableModel::parseFilter("state:estab,syn_sent,time-wait port:8080 rtt>50 pid:42 ssh");
+    EXPECT_EQ(filter.states, (1u << TCP_ESTABLISHED) | (1u << TCP_SYN_SENT) | (1u << TCP_TIME_WAIT));
+    EXPECT_EQ(filter.port, 8080);
+    EXPECT_EQ(filter.minRtt, 50000u);
+    EXPECT_EQ(filter.pid, 42);
+    EXPECT_EQ(filter.names, QStringList({"ssh"}));
+
+    // an unknown state shows nothing rather than everything
+    EXPECT_EQ(SocketTableModel::parseFilter("state:bogus").states, 0u);
+    EXPECT_TRUE(SocketTableModel::parseFilter("  ").isEmpty());
+}
+
+TEST_F(UT_SocketTableModel, test_stateName_001)
+{
+    EXPECT_EQ(SocketTableModel::stateName(IPPROTO_TCP, TCP_ESTABLISHED), QString("ESTAB"));
+    EXPECT_EQ(SocketTableModel::stateName(IPPROTO_TCP, TCP_LISTEN), QString("LISTEN"));
+    EXPECT_EQ(SocketTableModel::stateName(IPPROTO_UDP, TCP_CLOSE), QString("UNCONN"));
+    EXPECT_EQ(SocketTableModel::stateName(IPPROTO_TCP, 99), QString("UNKNOWN"));
+}
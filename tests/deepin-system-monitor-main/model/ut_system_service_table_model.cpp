@@ -531,3 +531,30 @@ TEST_F(UT_SystemServiceTableModel, test_updateServiceList_001)
     QList<SystemServiceEntry> List {};
     m_tester->updateServiceList(List);
 }
+
+TEST_F(UT_SystemServiceTableModel, test_removeServiceEntry_001)
+{
+    SystemServiceEntry withFile {};
+    withFile.setSName("test1");
+    withFile.setState("enabled");
+    withFile.setActiveState("active");
+    withFile.setMainPID(42);
+    SystemServiceEntry transient {};
+    transient.setSName("test2");
+    transient.setActiveState("active");
+    m_tester->updateServiceEntry(withFile);
+    m_tester->updateServiceEntry(transient);
+    EXPECT_EQ(m_tester->rowCount(), 2);
+
+    // unit file still there, listed as not running
+    m_tester->removeServiceEntry("test1");
+    EXPECT_EQ(m_tester->rowCount(), 2);
+    EXPECT_EQ(m_tester->m_svcMap["test1"].getActiveState(), "inactive");
+    EXPECT_EQ(m_tester->m_svcMap["test1"].getMainPID(), 0u);
+
+    m_tester->removeServiceEntry("test2");
+    EXPECT_EQ(m_tester->rowCount(), 1);
+    EXPECT_FALSE(m_tester->m_svcMap.contains("test2"));
+    m_tester->removeServiceEntry("test3");
+    EXPECT_EQ(m_tester->rowCount(), 1);
+}
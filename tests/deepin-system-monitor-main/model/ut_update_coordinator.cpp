@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "model/update_coordinator.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//qt
+#include <QSignalSpy>
+#include <QStringList>
+
+class UT_UpdateCoordinator : public ::testing::Test
+{
+public:
+    UT_UpdateCoordinator() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new UpdateCoordinator();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    UpdateCoordinator *m_tester;
+};
+
+TEST_F(UT_UpdateCoordinator, test_flush_order)
+{
+    QStringList order;
+    QObject::connect(m_tester, &UpdateCoordinator::updateModels, [&]() { order << "models"; });
+    QObject::connect(m_tester, &UpdateCoordinator::updateHistory, [&]() { order << "history"; });
+    QObject::connect(m_tester, &UpdateCoordinator::updateViews, [&]() { order << "views"; });
+
+    // marked several times within a frame, flushed once in stage order
+    m_tester->markDirty(UpdateCoordinator::kViewStage);
+    m_tester->markDirty();
+    m_tester->markDirty(UpdateCoordinator::kModelStage);
+    EXPECT_TRUE(m_tester->m_frameTimer.isActive());
+    m_tester->m_frameTimer.stop();
+    m_tester->flush();
+    EXPECT_EQ(order, QStringList({"models", "history", "views"}));
+    EXPECT_EQ(m_tester->m_dirty, 0);
+    EXPECT_FALSE(m_tester->m_frameTimer.isActive());
+}
+
+TEST_F(UT_UpdateCoordinator, test_setPaused)
+{
+    QSignalSpy spy(m_tester, &UpdateCoordinator::updateViews);
+    m_tester->setPaused(true);
+    m_tester->markDirty(UpdateCoordinator::kViewStage);
+    EXPECT_FALSE(m_tester->m_frameTimer.isActive());
+    EXPECT_EQ(spy.count(), 0);
+
+    // pending stages flushed once resumed
+    m_tester->setPaused(false);
+    EXPECT_TRUE(m_tester->m_frameTimer.isActive());
+    EXPECT_TRUE(spy.wait(1000));
+    EXPECT_EQ(spy.count(), 1);
+}
@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/container_identity.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+using namespace core::process;
+
+TEST(UT_ContainerIdentity, test_fromCgroup_runtime_001)
+{
+    ContainerIdentity docker = ContainerIdentity::fromCgroup(
+        "/system.slice/docker-4f1c2a9b8e7d6c5b4a3f2e1d0c9b8a7f6e5d4c3b2a1f0e9d8c7b6a5f4e3d2c1b.scope");
+    EXPECT_EQ(docker.kind, ContainerIdentity::kDocker);
+    EXPECT_EQ(docker.id, QString("4f1c2a9b8e7d"));
+
+    ContainerIdentity podman = ContainerIdentity::fromCgroup(
+        "/user.slice/user-1000.slice/user@1000.service/user.slice/libpod-0123456789abcdef0123.scope/container");
+    EXPECT_EQ(podman.kind, ContainerIdentity::kPodman);
+    EXPECT_EQ(podman.id, QString("0123456789ab"));
+
+    // cgroupfs driver
+    ContainerIdentity cgroupfs = ContainerIdentity::fromCgroup(
+        "/docker/4f1c2a9b8e7d6c5b4a3f2e1d0c9b8a7f6e5d4c3b2a1f0e9d8c7b6a5f4e3d2c1b");
+    EXPECT_EQ(cgroupfs.kind, ContainerIdentity::kDocker);
+    EXPECT_TRUE(cgroupfs.isSandboxed());
+
+    ContainerIdentity lxc = ContainerIdentity::fromCgroup("/lxc.payload.web/system.slice/nginx.service");
+    EXPECT_EQ(lxc.kind, ContainerIdentity::kLxc);
+    EXPECT_EQ(lxc.id, QString("web"));
+}
+
+TEST(UT_ContainerIdentity, test_fromCgroup_machine_001)
+{
+    // vcpu threads of a libvirt guest, the name has an escaped dash of its own
+    ContainerIdentity vm = ContainerIdentity::fromCgroup("/machine.slice/machine-qemu\\x2d3\\x2dwin\\x2d10.scope/libvirt/vcpu0");
+    EXPECT_EQ(vm.kind, ContainerIdentity::kVirtualMachine);
+    EXPECT_EQ(vm.id, QString("win-10"));
+    EXPECT_FALSE(vm.isSandboxed());
+
+    ContainerIdentity lxc = ContainerIdentity::fromCgroup("/machine.slice/machine-lxc\\x2d4211\\x2dweb.scope");
+    EXPECT_EQ(lxc.kind, ContainerIdentity::kLxc);
+    EXPECT_EQ(lxc.id, QString("web"));
+
+    // systemd-nspawn, found by its pid namespace instead
+    EXPECT_TRUE(ContainerIdentity::fromCgroup("/machine.slice/machine-debian.scope/payload").isHost());
+}
+
+TEST(UT_ContainerIdentity, test_fromCgroup_app_001)
+{
+    ContainerIdentity flatpak = ContainerIdentity::fromCgroup(
+        "/user.slice/user-1000.slice/user@1000.service/app.slice/app-flatpak-org.gnome.Foo-1234.scope");
+    EXPECT_EQ(flatpak.kind, ContainerIdentity::kFlatpak);
+    EXPECT_EQ(flatpak.id, QString("org.gnome.Foo"));
+    EXPECT_TRUE(flatpak.isSandboxed());
+
+    ContainerIdentity linglong = ContainerIdentity::fromCgroup(
+        "/user.slice/user-1000.slice/user@1000.service/app.slice/app-linglong-org.deepin.music-5678.scope");
+    EXPECT_EQ(linglong.kind, ContainerIdentity::kLinglong);
+    EXPECT_EQ(linglong.id, QString("org.deepin.music"));
+
+    // escaped dashes & instance names, a plain app unit isn't sandboxed
+    ContainerIdentity app = ContainerIdentity::fromCgroup(
+        "/user.slice/user-1000.slice/user@1000.service/app.slice/app-DDE-org.deepin.system\\x2dmonitor@abc.service");
+    EXPECT_EQ(app.kind, ContainerIdentity::kApp);
+    EXPECT_EQ(app.id, QString("org.deepin.system-monitor"));
+    EXPECT_FALSE(app.isSandboxed());
+
+    ContainerIdentity snap = ContainerIdentity::fromCgroup(
+        "/user.slice/user-1000.slice/user@1000.service/app.slice/snap.firefox.firefox-1a2b.scope");
+    EXPECT_EQ(snap.kind, ContainerIdentity::kSnap);
+    EXPECT_EQ(snap.id, QString("firefox"));
+}
+
+TEST(UT_ContainerIdentity, test_fromCgroup_host_001)
+{
+    EXPECT_TRUE(ContainerIdentity::fromCgroup("/user.slice/user-1000.slice/session-2.scope").isHost());
+    EXPECT_TRUE(ContainerIdentity::fromCgroup("/system.slice/NetworkManager.service").isHost());
+    EXPECT_TRUE(ContainerIdentity::fromCgroup("").isHost());
+    EXPECT_EQ(ContainerIdentity::fromCgroup("/init.scope"), ContainerIdentity());
+}
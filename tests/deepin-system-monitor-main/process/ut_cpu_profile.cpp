@@ -0,0 +1,182 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/cpu_profile.h"
+#include "process/symbolizer.h"
+#include "process_info_record.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <QFile>
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace core::process;
+
+__attribute__((noinline)) int utCpuProfileTarget(int value)
+{
+    return value * 3 + 1;
+}
+
+namespace {
+
+int child(const CpuProfile &profile, int node, const QString &function)
+{
+    for (int index : profile.nodes()[node].children) {
+        if (profile.nodes()[index].function == function)
+            return index;
+    }
+    return -1;
+}
+
+QByteArray profileBuffer(uint32_t state, const QVector<cpu_profile_stack_t> &stacks, const QVector<cpu_profile_symbol_t> &symbols)
+{
+    cpu_profile_header_t hdr {};
+    hdr.magic = CPU_PROFILE_MAGIC;
+    hdr.version = CPU_PROFILE_VERSION;
+    hdr.stack_size = sizeof(cpu_profile_stack_t);
+    hdr.symbol_size = sizeof(cpu_profile_symbol_t);
+    hdr.mapping_size = sizeof(cpu_profile_mapping_t);
+    hdr.state = state;
+    hdr.stacks = uint32_t(stacks.size());
+    hdr.symbols = uint32_t(symbols.size());
+    QByteArray buf(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+    for (const cpu_profile_stack_t &stack : stacks)
+        buf.append(reinterpret_cast<const char *>(&stack), sizeof(stack));
+    for (const cpu_profile_symbol_t &symbol : symbols)
+        buf.append(reinterpret_cast<const char *>(&symbol), sizeof(symbol));
+    return buf;
+}
+
+} // namespace
+
+TEST(UT_CpuProfile, test_addStack_001)
+{
+    CpuProfile profile;
+    profile.addStack({{"main", "app", false}, {"run", "app", false}, {"work", "app", false}}, 3);
+    profile.addStack({{"main", "app", false}, {"run", "app", false}}, 2);
+    profile.addStack({{"main", "app", false}, {"idle", "app", false}}, 1);
+    // same name in the kernel isn't the same frame
+    profile.addStack({{"main", "app", false}, {"run", "[kernel]", true}}, 4);
+    profile.finish();
+
+    EXPECT_EQ(profile.samples(), 10u);
+    const int top = child(profile, 0, "main");
+    ASSERT_GE(top, 0);
+    EXPECT_EQ(profile.nodes()[top].samples, 10u);
+    EXPECT_EQ(profile.nodes()[top].self, 0u);
+    ASSERT_EQ(profile.nodes()[top].children.size(), 3);
+    // by function
+    EXPECT_EQ(profile.nodes()[profile.nodes()[top].children[0]].function, QString("idle"));
+
+    int run = -1;
+    for (int index : profile.nodes()[top].children) {
+        if (profile.nodes()[index].function == "run" && !profile.nodes()[index].kernel)
+            run = index;
+    }
+    ASSERT_GE(run, 0);
+    EXPECT_EQ(profile.nodes()[run].samples, 5u);
+    EXPECT_EQ(profile.nodes()[run].self, 2u);
+    EXPECT_EQ(profile.nodes()[run].parent, top);
+    const int work = child(profile, run, "work");
+    ASSERT_GE(work, 0);
+    EXPECT_EQ(profile.nodes()[work].self, 3u);
+}
+
+TEST(UT_CpuProfile, test_fold_001)
+{
+    cpu_profile_stack_t stack {};
+    stack.count = 7;
+    stack.depth = 3;
+    stack.kernel_depth = 1;
+    stack.ips[0] = 0xffffffff81000100ULL;
+    stack.ips[1] = 0x1234;
+    stack.ips[2] = 0x5678;
+    cpu_profile_stack_t module {};
+    module.count = 2;
+    module.depth = 2;
+    module.kernel_depth = 2;
+    module.ips[0] = 0xffffffffc0000000ULL;
+    module.ips[1] = 0xffffffff81000100ULL;
+    cpu_profile_symbol_t syscall {0xffffffff81000100ULL, "do_syscall_64"};
+    cpu_profile_symbol_t nvPoll {0xffffffffc0000000ULL, "nv_poll [nvidia]"};
+
+    CpuProfile profile;
+    // no mappings, user frames stay addresses
+    ASSERT_TRUE(profile.fold(profileBuffer(CPU_PROFILE_FINISHED, {stack, module}, {syscall, nvPoll}), 0));
+    EXPECT_EQ(profile.samples(), 9u);
+    const int outer = child(profile, 0, "0x5678");
+    ASSERT_GE(outer, 0);
+    EXPECT_EQ(profile.nodes()[outer].module, QString("[unknown]"));
+    const int inner = child(profile, outer, "0x1234");
+    ASSERT_GE(inner, 0);
+    const int kernel = child(profile, inner, "do_syscall_64");
+    ASSERT_GE(kernel, 0);
+    EXPECT_TRUE(profile.nodes()[kernel].kernel);
+    EXPECT_EQ(profile.nodes()[kernel].module, QString("[kernel]"));
+    EXPECT_EQ(profile.nodes()[kernel].self, 7u);
+
+    // a kernel thread, kernel frames only
+    const int entry = child(profile, 0, "do_syscall_64");
+    ASSERT_GE(entry, 0);
+    const int driver = child(profile, entry, "nv_poll");
+    ASSERT_GE(driver, 0);
+    EXPECT_EQ(profile.nodes()[driver].module, QString("nvidia"));
+}
+
+TEST(UT_CpuProfile, test_fold_002)
+{
+    cpu_profile_stack_t stack {};
+    stack.count = 1;
+    stack.depth = 1;
+
+    CpuProfile profile;
+    EXPECT_FALSE(profile.fold(profileBuffer(CPU_PROFILE_RUNNING, {}, {}), 0));
+    QByteArray truncated = profileBuffer(CPU_PROFILE_FINISHED, {stack}, {});
+    truncated.chop(8);
+    EXPECT_FALSE(profile.fold(truncated, 0));
+    stack.kernel_depth = 2;
+    EXPECT_FALSE(profile.fold(profileBuffer(CPU_PROFILE_FINISHED, {stack}, {}), 0));
+    EXPECT_EQ(profile.samples(), 0u);
+}
+
+TEST(UT_Symbolizer, test_symbolize_001)
+{
+    const quint64 ip = quint64(reinterpret_cast<uintptr_t>(&utCpuProfileTarget)) + 1;
+    ASSERT_EQ(utCpuProfileTarget(1), 4);
+
+    // mapping of the test itself
+    Symbolizer symbolizer(getpid());
+    QFile maps("/proc/self/maps");
+    ASSERT_TRUE(maps.open(QIODevice::ReadOnly));
+    for (const QByteArray &line : maps.readAll().split('\n')) {
+        unsigned long long start = 0, end = 0, offset = 0;
+        char perms[5] {};
+        int pathPos = 0;
+        if (sscanf(line.constData(), "%llx-%llx %4s %llx %*s %*s %n", &start, &end, perms, &offset, &pathPos) < 4
+                || perms[2] != 'x' || !line.mid(pathPos).startsWith('/'))
+            continue;
+        symbolizer.addMapping({start, end, offset, QString::fromLocal8Bit(line.mid(pathPos))});
+    }
+
+    QString module;
+    EXPECT_EQ(symbolizer.symbolize(ip, &module), QString("utCpuProfileTarget(int)"));
+    EXPECT_FALSE(module.isEmpty());
+    // not mapped
+    EXPECT_TRUE(symbolizer.symbolize(0x10, &module).isEmpty());
+    EXPECT_TRUE(module.isEmpty());
+}
+
+TEST(UT_Symbolizer, test_demangle_001)
+{
+    EXPECT_EQ(Symbolizer::demangle("_ZN4core7process10Symbolizer8demangleEPKc"),
+              QString("core::process::Symbolizer::demangle(char const*)"));
+    EXPECT_EQ(Symbolizer::demangle("main"), QString("main"));
+    // not a valid mangled name, left as is
+    EXPECT_EQ(Symbolizer::demangle("_Zbogus"), QString("_Zbogus"));
+}
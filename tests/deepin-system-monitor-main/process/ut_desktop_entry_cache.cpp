@@ -11,6 +11,7 @@
 #include <gtest/gtest.h>
 //Qt
 #include <QFileInfo>
+#include <QStandardPaths>
 
 using namespace core::process;
 
@@ -47,7 +48,7 @@ TEST_F(UT_DesktopEntryCache, test_contains_001)
     DesktopEntry entry;
     QString key("test");
 
-    m_tester->m_cache.insert(key, entry);
+    m_tester->insertEntry(key, entry);
 
     EXPECT_EQ(m_tester->contains(key), true);
 }
@@ -82,7 +83,7 @@ TEST_F(UT_DesktopEntryCache, test_entry_001)
     QFileInfo info(filePath);
     DesktopEntry entry = DesktopEntryCacheUpdater::createEntry(info);
 
-    m_tester->m_cache.insert(key, entry);
+    m_tester->insertEntry(key, entry);
 
     EXPECT_EQ(m_tester->entry(key)->name, name);
 
@@ -121,7 +122,7 @@ TEST_F(UT_DesktopEntryCache, test_entryWithDesktopFile_001)
     QFileInfo info(filePath);
     DesktopEntry entry = DesktopEntryCacheUpdater::createEntry(info);
 
-    m_tester->m_cache.insert(key, entry);
+    m_tester->insertEntry(key, entry);
 
     EXPECT_EQ(m_tester->entryWithDesktopFile(filePath)->name, name);
 
@@ -160,7 +161,7 @@ TEST_F(UT_DesktopEntryCache, test_entryWithSubName_001)
     QFileInfo info(filePath);
     DesktopEntry entry = DesktopEntryCacheUpdater::createEntry(info);
 
-    m_tester->m_cache.insert(key, entry);
+    m_tester->insertEntry(key, entry);
 
     EXPECT_EQ(m_tester->entryWithSubName(key)->name, name);
 
@@ -175,3 +176,89 @@ TEST_F(UT_DesktopEntryCache, test_updateCache_001)
     EXPECT_GT(m_tester->m_cache.size(), 0);
 
 }
+
+TEST_F(UT_DesktopEntryCache, test_fileEntry_001)
+{
+    const QString filePath("test.desktop");
+    QFile file(filePath);
+    if(file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        file.write("[Desktop Entry]\n");
+        file.write("Name=test1\n");
+        file.write("Type=Application\n");
+        file.write("Exec=/usr/bin/test1\n");
+        file.close();
+    }
+
+    // parsed once per mtime
+    QFileInfo info(filePath);
+    auto entry = m_tester->fileEntry(info);
+    ASSERT_TRUE(entry != nullptr);
+    EXPECT_EQ(m_tester->fileEntry(QFileInfo(filePath)), entry);
+    EXPECT_TRUE(m_tester->m_filesDirty);
+
+    m_tester->m_files[info.filePath()].mtime -= 1000;
+    EXPECT_NE(m_tester->fileEntry(QFileInfo(filePath)), entry);
+
+    if(file.exists()) {
+        file.remove();
+    }
+}
+
+TEST_F(UT_DesktopEntryCache, test_saveDiskCache_001)
+{
+    QStandardPaths::setTestModeEnabled(true);
+
+    DesktopEntry entry = std::make_shared<struct desktop_entry_t>();
+    entry->name = "test1";
+    entry->exec = QStringList({"/usr/bin/test1", "%U"});
+    m_tester->m_files["/tmp/test1.desktop"] = {1000, entry, {}};
+    m_tester->m_files["/tmp/none.desktop"] = {2000, {}, {}};
+    m_tester->m_filesDirty = true;
+    m_tester->saveDiskCache();
+    EXPECT_FALSE(m_tester->m_filesDirty);
+
+    // read back as a cold start does
+    DesktopEntryCache cache;
+    ASSERT_EQ(cache.m_files.size(), 2);
+    EXPECT_EQ(cache.m_files["/tmp/test1.desktop"].mtime, 1000);
+    ASSERT_TRUE(cache.m_files["/tmp/test1.desktop"].entry != nullptr);
+    EXPECT_EQ(cache.m_files["/tmp/test1.desktop"].entry->exec, entry->exec);
+    EXPECT_TRUE(cache.m_files["/tmp/none.desktop"].entry == nullptr);
+
+    QFile::remove(DesktopEntryCache::diskCachePath());
+    QStandardPaths::setTestModeEnabled(false);
+}
+
+TEST_F(UT_DesktopEntryCache, test_updateChanged_001)
+{
+    // nothing changed, nothing rescanned
+    m_tester->updateChanged();
+    EXPECT_TRUE(m_tester->m_cache.isEmpty());
+}
+
+TEST_F(UT_DesktopEntryCache, test_insertEntry_001)
+{
+    DesktopEntry entry = std::make_shared<struct desktop_entry_t>();
+    entry->name = "test1";
+    entry->exec = QStringList({"/opt/apps/test1/bin/Test1", "%U"});
+    entry->startup_wm_class = "test1-window";
+    entry->app_id = "org.deepin.test1";
+    m_tester->insertEntry("Test1.desktop", entry);
+
+    EXPECT_EQ(m_tester->entry("test1.DESKTOP"), entry);
+    EXPECT_EQ(m_tester->entryWithExec("/usr/bin/test1"), entry);
+    EXPECT_EQ(m_tester->entryWithSubName("test1"), entry);
+    EXPECT_EQ(m_tester->entryWithWMClass("Test1-Window"), entry);
+    EXPECT_EQ(m_tester->entryWithAppId("org.deepin.test1"), entry);
+
+    // launchers run many apps, they name none
+    DesktopEntry sandboxed = std::make_shared<struct desktop_entry_t>();
+    sandboxed->exec = QStringList({"/usr/bin/flatpak", "run", "org.deepin.test2"});
+    m_tester->insertEntry("org.deepin.test2.desktop", sandboxed);
+    EXPECT_TRUE(m_tester->entryWithExec("flatpak") == nullptr);
+
+    m_tester->clearEntries();
+    EXPECT_FALSE(m_tester->contains("test1"));
+    EXPECT_TRUE(m_tester->entryWithExec("test1") == nullptr);
+    EXPECT_TRUE(m_tester->entryWithAppId("org.deepin.test1") == nullptr);
+}
@@ -80,3 +80,29 @@ TEST_F(UT_DesktopEntryCacheUpdater, test_createEntry_001)
     }
 
 }
+
+TEST_F(UT_DesktopEntryCacheUpdater, test_createEntry_002)
+{
+    const QString filePath("test.desktop");
+    QFile file(filePath);
+    if(file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        file.write("[Desktop Entry]\n");
+        file.write("Name=test1\n");
+        file.write("Type=Application\n");
+        file.write("TryExec=/usr/bin/ll-cli\n");
+        file.write("Exec=/usr/bin/ll-cli run org.test.app\n");
+        file.write("X-linglong=org.test.app\n");
+        file.close();
+    }
+
+    // name is left to the caller to ask ll-cli for
+    QString linglongId;
+    DesktopEntry entry = m_tester->createEntry(QFileInfo(filePath), &linglongId);
+    ASSERT_TRUE(entry != nullptr);
+    EXPECT_EQ(linglongId, QString("org.test.app"));
+    EXPECT_TRUE(entry->name.isEmpty());
+
+    if(file.exists()) {
+        file.remove();
+    }
+}
@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/exited_process_log.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+using namespace core::process;
+using namespace core::system;
+
+static task_exit_t makeExit(const QString &name, pid_t pid, pid_t tgid, qulonglong cpuTime, qulonglong maxRss = 0)
+{
+    task_exit_t exit;
+    exit.name = name;
+    exit.pid = pid;
+    exit.tgid = tgid;
+    exit.cpuTime = cpuTime;
+    exit.maxRss = maxRss;
+    return exit;
+}
+
+TEST(UT_ExitedProcessLog, test_add_001)
+{
+    ExitedProcessLog log;
+    log.add(makeExit("cc1", 100, 100, 3000, 2048), 1000);
+    log.add(makeExit("cc1", 101, 101, 5000, 1024), 1001);
+    // a thread adds its cpu time, not a process
+    log.add(makeExit("make", 201, 200, 200), 1002);
+    log.add(makeExit("make", 200, 200, 100), 1003);
+
+    ExitedProcessRollups rollups = log.rollups();
+    ASSERT_EQ(rollups.size(), 2);
+    EXPECT_EQ(rollups[0].name, QString("cc1"));
+    EXPECT_EQ(rollups[0].processes, 2);
+    EXPECT_EQ(rollups[0].cpuTime, 8000ULL);
+    EXPECT_EQ(rollups[0].maxRss, 2048ULL);
+    EXPECT_EQ(rollups[0].lastPid, 101);
+    EXPECT_EQ(rollups[1].processes, 1);
+    EXPECT_EQ(rollups[1].tasks, 2);
+    EXPECT_EQ(rollups[1].cpuTime, 300ULL);
+}
+
+TEST(UT_ExitedProcessLog, test_add_002)
+{
+    // an exec storm only ever keeps the latest records
+    ExitedProcessLog log(4);
+    for (int i = 0; i < 1000; ++i)
+        log.add(makeExit(QString("sh%1").arg(i % 8), 1000 + i, 1000 + i, 10), i);
+    EXPECT_EQ(log.size(), 4);
+    ExitedProcessRollups rollups = log.rollups();
+    EXPECT_EQ(rollups.size(), 4);
+    int processes = 0;
+    for (const auto &rollup : rollups)
+        processes += rollup.processes;
+    EXPECT_EQ(processes, 4);
+}
+
+TEST(UT_ExitedProcessLog, test_expire_001)
+{
+    ExitedProcessLog log(16, 1000);
+    log.add(makeExit("cron", 10, 10, 50), 0);
+    log.add(makeExit("cron", 11, 11, 70), 800);
+    quint64 generation = log.generation();
+
+    log.expire(1500);
+    EXPECT_NE(log.generation(), generation);
+    ExitedProcessRollups rollups = log.rollups();
+    ASSERT_EQ(rollups.size(), 1);
+    EXPECT_EQ(rollups[0].processes, 1);
+    EXPECT_EQ(rollups[0].cpuTime, 70ULL);
+
+    log.expire(2000);
+    EXPECT_EQ(log.size(), 0);
+    EXPECT_TRUE(log.rollups().isEmpty());
+}
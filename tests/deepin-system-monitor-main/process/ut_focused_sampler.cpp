@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/focused_sampler.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+#include <QSignalSpy>
+
+#include <string.h>
+#include <unistd.h>
+
+using namespace core::process;
+
+class UT_FocusedSampler : public ::testing::Test
+{
+public:
+    UT_FocusedSampler() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new FocusedSampler(getpid());
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    FocusedSampler *m_tester;
+};
+
+TEST_F(UT_FocusedSampler, test_parseStat_001)
+{
+    // comm with spaces & parentheses
+    const char *stat = "1234 (a (b) c) S 1 1234 1234 0 -1 4194560 100 0 0 0 25 75 0 0 20 0 1 0 4242 1000 50 "
+                       "18446744073709551615 0 0 0 0 0 0 0 0 0 0 0 0 17 3 0 0 0 0 0\n";
+    FocusedSampler::counters_t counters;
+    EXPECT_TRUE(FocusedSampler::parseStat(stat, strlen(stat), counters));
+    EXPECT_EQ(counters.cpuTicks, 100u);
+    EXPECT_EQ(counters.startTime, 4242u);
+
+    const char *truncated = "1234 (a) S 1 1234";
+    EXPECT_FALSE(FocusedSampler::parseStat(truncated, strlen(truncated), counters));
+}
+
+TEST_F(UT_FocusedSampler, test_parseStatm_001)
+{
+    const char *statm = "5000 1200 300 10 0 800 0\n";
+    FocusedSampler::counters_t counters;
+    EXPECT_TRUE(FocusedSampler::parseStatm(statm, strlen(statm), counters));
+    EXPECT_EQ(counters.residentPages, 1200u);
+}
+
+TEST_F(UT_FocusedSampler, test_parseIO_001)
+{
+    const char *io = "rchar: 100\nwchar: 200\nsyscr: 3\nsyscw: 4\nread_bytes: 4096\nwrite_bytes: 8192\n"
+                     "cancelled_write_bytes: 0\n";
+    FocusedSampler::counters_t counters;
+    EXPECT_TRUE(FocusedSampler::parseIO(io, strlen(io), counters));
+    EXPECT_EQ(counters.readBytes, 4096u);
+    EXPECT_EQ(counters.writeBytes, 8192u);
+
+    const char *partial = "rchar: 100\nwchar: 200\n";
+    EXPECT_FALSE(FocusedSampler::parseIO(partial, strlen(partial), counters));
+}
+
+TEST_F(UT_FocusedSampler, test_parseSchedStat_001)
+{
+    const char *schedstat = "123456789 987654 42\n";
+    FocusedSampler::counters_t counters;
+    EXPECT_TRUE(FocusedSampler::parseSchedStat(schedstat, strlen(schedstat), counters));
+    EXPECT_EQ(counters.runTime, 123456789u);
+    EXPECT_EQ(counters.waitTime, 987654u);
+}
+
+TEST_F(UT_FocusedSampler, test_sample_001)
+{
+    QSignalSpy spy(m_tester, &FocusedSampler::sampled);
+    // the first read only takes the counters
+    m_tester->start(FocusedSampler::kInterval100ms);
+    EXPECT_TRUE(m_tester->isActive());
+    EXPECT_EQ(m_tester->interval(), int(FocusedSampler::kInterval100ms));
+    EXPECT_TRUE(m_tester->cpuSeries().empty());
+
+    usleep(10000);
+    m_tester->sample();
+    EXPECT_EQ(spy.count(), 1);
+    EXPECT_EQ(m_tester->cpuSeries().size(), 1u);
+    EXPECT_EQ(m_tester->memorySeries().size(), 1u);
+    EXPECT_GT(m_tester->memorySeries().last(), 0.);
+    EXPECT_GT(m_tester->residentBytes(), 0u);
+    EXPECT_FALSE(m_tester->hasExited());
+
+    m_tester->stop();
+    EXPECT_FALSE(m_tester->isActive());
+}
+
+TEST_F(UT_FocusedSampler, test_sample_002)
+{
+    // pid max can never exceed 2^22
+    FocusedSampler sampler(1 << 23);
+    QSignalSpy spy(&sampler, &FocusedSampler::exited);
+    sampler.start();
+    EXPECT_EQ(spy.count(), 1);
+    EXPECT_TRUE(sampler.hasExited());
+    EXPECT_FALSE(sampler.isActive());
+}
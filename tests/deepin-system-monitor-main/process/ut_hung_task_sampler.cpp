@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/hung_task_sampler.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace core::process;
+
+class UT_HungTaskSampler : public ::testing::Test
+{
+public:
+    UT_HungTaskSampler() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new HungTaskSampler();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    HungTaskSampler *m_tester;
+};
+
+TEST_F(UT_HungTaskSampler, test_blockingFunction_001)
+{
+    // scheduler & wait frames on top are skipped
+    QByteArrayList frames = {"io_schedule", "bit_wait_io", "__wait_on_bit", "out_of_line_wait_on_bit",
+                             "nfs_wait_on_request", "nfs_writepage_locked", "do_writepages"};
+    EXPECT_EQ(HungTaskSampler::blockingFunction(frames), QByteArray("nfs_wait_on_request"));
+    EXPECT_EQ(HungTaskSampler::waitKind(frames), HungTaskSampler::kWaitNfs);
+
+    // wchan alone
+    EXPECT_EQ(HungTaskSampler::blockingFunction({"io_schedule"}), QByteArray("io_schedule"));
+    EXPECT_EQ(HungTaskSampler::waitKind({"io_schedule"}), HungTaskSampler::kWaitDisk);
+    EXPECT_TRUE(HungTaskSampler::blockingFunction({}).isEmpty());
+}
+
+TEST_F(UT_HungTaskSampler, test_waitKind_001)
+{
+    EXPECT_EQ(HungTaskSampler::waitKind({"io_schedule", "__wait_on_buffer", "jbd2_journal_commit_transaction"}),
+              HungTaskSampler::kWaitDisk);
+    EXPECT_EQ(HungTaskSampler::waitKind({"request_wait_answer", "fuse_simple_request", "fuse_lookup_name"}),
+              HungTaskSampler::kWaitFuse);
+    EXPECT_EQ(HungTaskSampler::waitKind({"rwsem_down_write_slowpath", "down_write", "do_truncate"}),
+              HungTaskSampler::kWaitLock);
+    EXPECT_EQ(HungTaskSampler::waitKind({"shrink_node", "do_try_to_free_pages", "__alloc_pages_slowpath"}),
+              HungTaskSampler::kWaitMemory);
+    EXPECT_EQ(HungTaskSampler::waitKind({"usb_kill_urb"}), HungTaskSampler::kWaitUnknown);
+}
+
+TEST_F(UT_HungTaskSampler, test_sample_001)
+{
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        pause();
+        _exit(0);
+    }
+    usleep(20000);
+
+    // sleeping, not blocked, but wchan reads the same way
+    const HungTaskSampler::task_t task {child, 42};
+    const bool readable = !HungTaskSampler::readWchan(child).isEmpty();
+    m_tester->sample({task});
+    m_tester->sample({task});
+    HungTaskSampler::hint_t hint;
+    EXPECT_EQ(m_tester->lookup(child, 42, hint), readable);
+    if (readable) {
+        EXPECT_FALSE(hint.function.isEmpty());
+        EXPECT_EQ(hint.samples, 2);
+        EXPECT_EQ(hint.total, 2);
+    }
+    // reused pid
+    EXPECT_FALSE(m_tester->lookup(child, 43, hint));
+
+    // dropped once it's no longer hung
+    m_tester->sample({});
+    EXPECT_FALSE(m_tester->lookup(child, 42, hint));
+
+    kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+}
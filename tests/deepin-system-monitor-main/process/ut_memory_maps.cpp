@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/memory_maps.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace core::process;
+
+TEST(UT_MemoryMaps, test_parseMapping_001)
+{
+    MemoryMaps::mapping_t mapping;
+    const char heap[] = "55d4c3a00000-55d4c3a21000 rw-p 00000000 00:00 0                          [heap]";
+    ASSERT_TRUE(MemoryMaps::parseMapping(heap, strlen(heap), mapping));
+    EXPECT_EQ(mapping.end - mapping.start, 0x21000u);
+    EXPECT_EQ(QString::fromLatin1(mapping.path, int(mapping.pathLen)), QString("[heap]"));
+    EXPECT_EQ(MemoryMaps::regionType(mapping), MemoryMaps::kRegionHeap);
+
+    const char file[] = "7f2b5c000000-7f2b5c021000 r-xp 00002000 08:02 1234   /usr/lib/libc.so.6";
+    ASSERT_TRUE(MemoryMaps::parseMapping(file, strlen(file), mapping));
+    EXPECT_EQ(mapping.inode, 1234u);
+    EXPECT_EQ(MemoryMaps::regionType(mapping), MemoryMaps::kRegionFile);
+
+    // no path, shared
+    const char shm[] = "7f0000000000-7f0000001000 rw-s 00000000 00:01 9 ";
+    ASSERT_TRUE(MemoryMaps::parseMapping(shm, strlen(shm), mapping));
+    EXPECT_EQ(mapping.pathLen, 0u);
+    EXPECT_EQ(MemoryMaps::regionType(mapping), MemoryMaps::kRegionShm);
+
+    const char memfd[] = "7f0000001000-7f0000002000 rw-s 00000000 00:01 10   /memfd:wayland (deleted)";
+    ASSERT_TRUE(MemoryMaps::parseMapping(memfd, strlen(memfd), mapping));
+    EXPECT_EQ(QString::fromLatin1(mapping.path, int(mapping.pathLen)), QString("/memfd:wayland (deleted)"));
+    EXPECT_EQ(MemoryMaps::regionType(mapping), MemoryMaps::kRegionShm);
+
+    const char vdso[] = "7ffc1e5f0000-7ffc1e5f2000 r-xp 00000000 00:00 0   [vdso]";
+    ASSERT_TRUE(MemoryMaps::parseMapping(vdso, strlen(vdso), mapping));
+    EXPECT_EQ(MemoryMaps::regionType(mapping), MemoryMaps::kRegionKernel);
+}
+
+TEST(UT_MemoryMaps, test_parseMapping_002)
+{
+    // Key: value lines of smaps, some start with hex digits
+    MemoryMaps::mapping_t mapping;
+    const char rss[] = "Rss:                 132 kB";
+    EXPECT_FALSE(MemoryMaps::parseMapping(rss, strlen(rss), mapping));
+    const char anon[] = "AnonHugePages:         0 kB";
+    EXPECT_FALSE(MemoryMaps::parseMapping(anon, strlen(anon), mapping));
+    const char truncated[] = "7f2b5c000000-7f2b5c021000 r-xp";
+    EXPECT_FALSE(MemoryMaps::parseMapping(truncated, strlen(truncated), mapping));
+}
+
+TEST(UT_MemoryMaps, test_next_001)
+{
+    for (bool detailed : {false, true}) {
+        MemoryMaps maps(getpid(), detailed);
+        ASSERT_TRUE(maps.open());
+
+        // regions come back in batches, added up they cover every mapping
+        int mappings = 0;
+        qulonglong rss = 0;
+        bool file = false;
+        bool more = true;
+        while (more) {
+            MemoryMaps::RegionList regions;
+            more = maps.next(regions, 2);
+            for (const MemoryMaps::region_t &region : regions) {
+                mappings += region.mappings;
+                rss += region.rss;
+                file = file || region.type == MemoryMaps::kRegionFile;
+            }
+        }
+        EXPECT_EQ(maps.error(), 0);
+        EXPECT_GT(maps.mappings(), 0);
+        EXPECT_EQ(mappings, maps.mappings());
+        EXPECT_TRUE(file);
+        // maps has no page counts
+        EXPECT_EQ(rss > 0, detailed);
+    }
+}
+
+TEST(UT_MemoryMaps, test_open_001)
+{
+    // pid max can never exceed 2^22
+    MemoryMaps maps(1 << 23, false);
+    EXPECT_FALSE(maps.open());
+    EXPECT_EQ(maps.error(), ENOENT);
+    MemoryMaps::RegionList regions;
+    EXPECT_FALSE(maps.next(regions, 1));
+}
@@ -0,0 +1,46 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/numa_maps.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <unistd.h>
+
+using namespace core::process;
+
+TEST(UT_NumaMaps, test_parse_001)
+{
+    const char *buf = "55d4c2a00000 default file=/usr/bin/bash mapped=44 mapcount=3 N0=40 N1=4 kernelpagesize_kB=4\n"
+                      "7f2b5c000000 default anon=1536 dirty=1536 active=0 N1=1536 kernelpagesize_kB=4\n"
+                      "7f2b60000000 default file=/dev/hugepages/x huge dirty=2 N0=2 kernelpagesize_kB=2048\n"
+                      "7ffd1c5e1000 default\n";
+    QMap<int, qulonglong> nodes;
+    ASSERT_TRUE(NumaMaps::parse(buf, strlen(buf), nodes));
+    EXPECT_EQ(nodes.size(), 2);
+    EXPECT_EQ(nodes.value(0), 40ull * 4 + 2 * 2048);
+    EXPECT_EQ(nodes.value(1), 4ull * 4 + 1536 * 4);
+}
+
+TEST(UT_NumaMaps, test_parse_002)
+{
+    QMap<int, qulonglong> nodes;
+    EXPECT_FALSE(NumaMaps::parse("", 0, nodes));
+    EXPECT_TRUE(nodes.isEmpty());
+}
+
+TEST(UT_NumaMaps, test_read)
+{
+    QMap<int, qulonglong> nodes;
+    // kernels without CONFIG_NUMA have no numa_maps
+    if (access("/proc/self/numa_maps", R_OK) != 0) {
+        EXPECT_FALSE(NumaMaps::read(getpid(), nodes));
+        return;
+    }
+    EXPECT_TRUE(NumaMaps::read(getpid(), nodes));
+    EXPECT_FALSE(nodes.isEmpty());
+}
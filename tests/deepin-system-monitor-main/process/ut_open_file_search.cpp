@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/open_file_search.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//qt
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include <algorithm>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace core::process;
+
+namespace {
+
+bool holds(const QVector<OpenFileSearch::match_t> &matches, int fd)
+{
+    return std::any_of(matches.cbegin(), matches.cend(), [fd](const OpenFileSearch::match_t &match) {
+        return match.pid == getpid() && match.fd == fd;
+    });
+}
+
+} // namespace
+
+TEST(UT_OpenFileSearch, test_parseQuery_001)
+{
+    EXPECT_EQ(OpenFileSearch::parseQuery("443").port, 443);
+    EXPECT_EQ(OpenFileSearch::parseQuery(":8080").port, 8080);
+    EXPECT_EQ(OpenFileSearch::parseQuery(" port:22 ").port, 22);
+    EXPECT_TRUE(OpenFileSearch::parseQuery("  ").isEmpty());
+
+    // out of range numbers & paths are paths
+    OpenFileSearch::query_t query = OpenFileSearch::parseQuery("70000");
+    EXPECT_EQ(query.port, -1);
+    query = OpenFileSearch::parseQuery("/var/log/");
+    EXPECT_EQ(query.port, -1);
+    EXPECT_EQ(query.path, QString("/var/log"));
+    EXPECT_EQ(OpenFileSearch::parseQuery("~/x").path, QDir::homePath() + "/x");
+}
+
+TEST(UT_OpenFileSearch, test_searchProcess_001)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath("held");
+    const QByteArray name = QFile::encodeName(path);
+    int fd = open(name.constData(), O_CREAT | O_RDWR | O_CLOEXEC, 0600);
+    ASSERT_GE(fd, 0);
+
+    // by its path, by the directory it is in & through another name
+    OpenFileSearch::query_t query = OpenFileSearch::parseQuery(path);
+    EXPECT_TRUE(holds(OpenFileSearch::searchProcess(getpid(), query), fd));
+    EXPECT_TRUE(holds(OpenFileSearch::searchProcess(getpid(), OpenFileSearch::parseQuery(dir.path())), fd));
+    const QString link = dir.filePath("link");
+    ASSERT_EQ(::link(name.constData(), QFile::encodeName(link).constData()), 0);
+    EXPECT_TRUE(holds(OpenFileSearch::searchProcess(getpid(), OpenFileSearch::parseQuery(link)), fd));
+
+    // still held once deleted
+    ASSERT_EQ(unlink(name.constData()), 0);
+    EXPECT_TRUE(holds(OpenFileSearch::searchProcess(getpid(), query), fd));
+
+    EXPECT_FALSE(holds(OpenFileSearch::searchProcess(getpid(), OpenFileSearch::parseQuery(dir.filePath("other"))), fd));
+    close(fd);
+    EXPECT_FALSE(holds(OpenFileSearch::searchProcess(getpid(), query), fd));
+}
+
+TEST(UT_OpenFileSearch, test_searchProcess_002)
+{
+    char cwd[PATH_MAX];
+    ASSERT_TRUE(getcwd(cwd, sizeof(cwd)) != nullptr);
+    auto matches = OpenFileSearch::searchProcess(getpid(), OpenFileSearch::parseQuery(QFile::decodeName(cwd)));
+    EXPECT_TRUE(holds(matches, OpenFileSearch::kCwdFd));
+    for (const auto &match : matches)
+        EXPECT_FALSE(match.name.isEmpty());
+}
+
+TEST(UT_OpenFileSearch, test_searchProcess_003)
+{
+    int server = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    ASSERT_GE(server, 0);
+    sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrLen = sizeof(addr);
+    ASSERT_EQ(bind(server, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)), 0);
+    ASSERT_EQ(listen(server, 1), 0);
+    ASSERT_EQ(getsockname(server, reinterpret_cast<sockaddr *>(&addr), &addrLen), 0);
+
+    // sock_diag may be missing in the build environment
+    auto matches = OpenFileSearch::searchProcess(getpid(), OpenFileSearch::parseQuery(QString::number(ntohs(addr.sin_port))));
+    for (const auto &match : matches) {
+        EXPECT_EQ(match.fd, server);
+        EXPECT_NE(match.socket, ino_t(0));
+    }
+    close(server);
+}
+
+TEST(UT_OpenFileSearch, test_start_001)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    int fd = open(QFile::encodeName(dir.filePath("held")).constData(), O_CREAT | O_RDWR | O_CLOEXEC, 0600);
+    ASSERT_GE(fd, 0);
+
+    OpenFileSearch search;
+    QVector<OpenFileSearch::match_t> matches;
+    QObject::connect(&search, &OpenFileSearch::matchesFound, [&matches](const QVector<OpenFileSearch::match_t> &found) {
+        matches += found;
+    });
+    QSignalSpy spy(&search, &OpenFileSearch::finished);
+    search.start(OpenFileSearch::parseQuery(dir.path()));
+    EXPECT_TRUE(search.isRunning());
+    ASSERT_TRUE(spy.wait(10000));
+    EXPECT_FALSE(search.isRunning());
+    EXPECT_EQ(search.scanned(), search.total());
+    EXPECT_TRUE(holds(matches, fd));
+
+    // cancelled searches are never finished
+    search.start(OpenFileSearch::parseQuery("/"));
+    search.cancel();
+    EXPECT_FALSE(search.isRunning());
+    EXPECT_FALSE(spy.wait(2 * OpenFileSearch::kDeliverInterval));
+    close(fd);
+}
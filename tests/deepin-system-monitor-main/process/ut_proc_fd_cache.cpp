@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/proc_fd_cache.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <unistd.h>
+
+using namespace core::process;
+
+class UT_ProcFdCache : public ::testing::Test
+{
+public:
+    UT_ProcFdCache() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new ProcFdCache();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    ProcFdCache *m_tester;
+};
+
+TEST_F(UT_ProcFdCache, test_read_001)
+{
+    char buf[1024];
+    ssize_t nr = m_tester->read(getpid(), ProcFdCache::kStatFile, buf, sizeof(buf));
+    EXPECT_GT(nr, 0);
+    EXPECT_EQ(strlen(buf), size_t(nr));
+    EXPECT_EQ(m_tester->count(), 1);
+
+    // re-read from the cached fd
+    nr = m_tester->read(getpid(), ProcFdCache::kStatFile, buf, sizeof(buf));
+    EXPECT_GT(nr, 0);
+    EXPECT_EQ(m_tester->count(), 1);
+}
+
+TEST_F(UT_ProcFdCache, test_read_002)
+{
+    char buf[64];
+    // pid max can never exceed 2^22
+    ssize_t nr = m_tester->read(1 << 23, ProcFdCache::kStatmFile, buf, sizeof(buf));
+    EXPECT_EQ(nr, -1);
+}
+
+TEST_F(UT_ProcFdCache, test_release_001)
+{
+    char buf[256];
+    m_tester->read(getpid(), ProcFdCache::kStatmFile, buf, sizeof(buf));
+    m_tester->release(getpid());
+    EXPECT_EQ(m_tester->count(), 0);
+}
+
+TEST_F(UT_ProcFdCache, test_readOnce_001)
+{
+    char buf[256];
+    ssize_t nr = ProcFdCache::readOnce(getpid(), ProcFdCache::kStatmFile, buf, sizeof(buf));
+    EXPECT_GT(nr, 0);
+}
+
+TEST_F(UT_ProcFdCache, test_read_task_001)
+{
+    // the main thread's tid is the pid
+    ProcFdCache tasks(getpid());
+    char buf[1024];
+    ssize_t nr = tasks.read(getpid(), ProcFdCache::kStatFile, buf, sizeof(buf));
+    EXPECT_GT(nr, 0);
+    EXPECT_EQ(tasks.count(), 1);
+    // threads of a process that can't exist, pid max is at most 2^22
+    EXPECT_EQ(ProcFdCache(1 << 23).read(getpid(), ProcFdCache::kStatFile, buf, sizeof(buf)), -1);
+}
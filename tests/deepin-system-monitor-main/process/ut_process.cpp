@@ -7,6 +7,8 @@
 #include "process/process.h"
 #include "common/common.h"
 #include "process/private/process_p.h"
+#include "process/process_environ_cache.h"
+#include "process_info_record.h"
 //gtest
 #include "stub.h"
 #include <gtest/gtest.h>
@@ -16,6 +18,9 @@
 //system
 #include <fcntl.h>
 #include <unistd.h>
+#include <string.h>
+
+#include <vector>
 
 using namespace core::process;
 using namespace common::alloc;
@@ -149,13 +154,32 @@ TEST_F(UT_Process, test_cpu_001)
         }
     };
 
-    auto *sample = m_tester->d->cpuUsageSample->recentSample();
+    auto *sample = m_tester->d->samples->cpuUsageSample.recentSample();
     if (sample)
         EXPECT_EQ(cpu, sample->data);
     else
         EXPECT_EQ(cpu, {});
 }
 
+TEST_F(UT_Process, test_mutableSamples_001)
+{
+    ProcessPrivate first;
+    EXPECT_EQ(first.samples, ProcessPrivate::emptySamples());
+
+    first.mutableSamples().cpuUsageSample.addSample(CPUUsageSampleFrame(1.));
+    EXPECT_NE(first.samples, ProcessPrivate::emptySamples());
+    EXPECT_EQ(ProcessPrivate::emptySamples()->cpuUsageSample.count(), 0);
+
+    // copies share history until one of them writes
+    ProcessPrivate second(first);
+    EXPECT_EQ(second.samples, first.samples);
+
+    second.mutableSamples().cpuUsageSample.addSample(CPUUsageSampleFrame(2.));
+    EXPECT_NE(second.samples, first.samples);
+    EXPECT_EQ(first.samples->cpuUsageSample.count(), 1);
+    EXPECT_EQ(second.samples->cpuUsageSample.count(), 2);
+}
+
 TEST_F(UT_Process, test_memory_001)
 {
     qulonglong memory = m_tester->memory();
@@ -214,11 +238,53 @@ TEST_F(UT_Process, test_cmdlineString_001)
     EXPECT_EQ(cmdlineString, expect);
 }
 
+TEST_F(UT_Process, test_cmdlineText_001)
+{
+    m_tester->d->cmdline = QByteArrayList {"/bin/bash"};
+    m_tester->digestCmdline();
+    EXPECT_EQ(m_tester->cmdlineText(), QString("/bin/bash"));
+    EXPECT_TRUE(m_tester->isBareShell());
+
+    m_tester->d->cmdline = QByteArrayList {"/bin/bash", "/usr/bin/run%20me.sh"};
+    m_tester->digestCmdline();
+    EXPECT_EQ(m_tester->cmdlineText(), QString("/bin/bash /usr/bin/run me.sh"));
+    EXPECT_FALSE(m_tester->isBareShell());
+
+    m_tester->d->cmdline = QByteArrayList {"/usr/bin/java", QByteArray(1000, 'x')};
+    m_tester->digestCmdline();
+    EXPECT_EQ(m_tester->cmdlineText().size(), kCmdlineTextBytes + 1);
+    EXPECT_TRUE(m_tester->cmdlineText().startsWith("/usr/bin/java xxx"));
+}
+
+TEST_F(UT_Process, test_truncatedCmdline_001)
+{
+    const QString ellipsis(QChar(0x2026));
+    EXPECT_EQ(Process::truncatedCmdline("abc", 8), QString("abc"));
+    EXPECT_EQ(Process::truncatedCmdline("abcdef", 4), "abcd" + ellipsis);
+    // a two byte sequence, e acute, isn't cut in half
+    EXPECT_EQ(Process::truncatedCmdline("ab\xc3\xa9z", 3), "ab" + ellipsis);
+    EXPECT_EQ(Process::truncatedCmdline("ab\xc3\xa9z", 4), QString::fromUtf8("ab\xc3\xa9") + ellipsis);
+    // nor an escape
+    EXPECT_EQ(Process::truncatedCmdline("ab%20cd", 3), "ab" + ellipsis);
+    EXPECT_EQ(Process::truncatedCmdline("ab%20cd", 4), "ab" + ellipsis);
+    EXPECT_EQ(Process::truncatedCmdline("ab%20cd", 5), "ab " + ellipsis);
+}
+
+TEST_F(UT_Process, test_readFullCmdline_001)
+{
+    EXPECT_FALSE(Process::readFullCmdline(getpid()).isEmpty());
+    EXPECT_TRUE(Process::readFullCmdline(-1).isEmpty());
+}
+
 TEST_F(UT_Process, test_environ_001)
 {
+    ProcessEnvironCache::Environ env;
+    env.insert("LANG", "C");
+    ProcessEnvironCache::instance()->insert(m_tester->pid(), m_tester->d->start_time, env);
     QHash<QString, QString> environ = m_tester->environ();
 
-    EXPECT_EQ(environ, m_tester->d->environ);
+    EXPECT_EQ(environ, env);
+    ProcessEnvironCache::instance()->remove(m_tester->pid());
 }
 
 TEST_F(UT_Process, test_uid_001)
@@ -252,7 +318,7 @@ TEST_F(UT_Process, test_groupName_001)
 TEST_F(UT_Process, test_readBps_001)
 {
     qreal readBps = m_tester->readBps();
-    auto *sample = m_tester->d->diskIOSpeedSample->recentSample();
+    auto *sample = m_tester->d->samples->diskIOSpeedSample.recentSample();
     if (sample)
         EXPECT_EQ(readBps, sample->data.inBps);
     else
@@ -263,7 +329,7 @@ TEST_F(UT_Process, test_readBps_001)
 TEST_F(UT_Process, test_writeBps_001)
 {
     qreal writeBps = m_tester->writeBps();
-    auto *sample = m_tester->d->diskIOSpeedSample->recentSample();
+    auto *sample = m_tester->d->samples->diskIOSpeedSample.recentSample();
     if (sample)
         EXPECT_EQ(writeBps, sample->data.outBps);
     else
@@ -279,7 +345,7 @@ TEST_F(UT_Process, test_cancelledWriteBytes_001)
 TEST_F(UT_Process, test_recvBps_001)
 {
     qreal recvBps = m_tester->recvBps();
-    auto *sample = m_tester->d->networkBandwidthSample->recentSample();
+    auto *sample = m_tester->d->samples->networkBandwidthSample.recentSample();
     if (sample)
         EXPECT_EQ(recvBps, sample->data.inBps);
     else
@@ -289,7 +355,7 @@ TEST_F(UT_Process, test_recvBps_001)
 TEST_F(UT_Process, test_sentBps_001)
 {
     qreal sentBps = m_tester->sentBps();
-    auto *sample = m_tester->d->networkBandwidthSample->recentSample();
+    auto *sample = m_tester->d->samples->networkBandwidthSample.recentSample();
     if (sample)
         EXPECT_EQ(sentBps, sample->data.outBps);
     else
@@ -299,7 +365,7 @@ TEST_F(UT_Process, test_sentBps_001)
 TEST_F(UT_Process, test_recvBytes_001)
 {
     qreal recvBytes = m_tester->recvBytes();
-    auto *sample = m_tester->d->networkIOSample->recentSample();
+    auto *sample = m_tester->d->samples->networkIOSample.recentSample();
     if (sample)
         EXPECT_EQ(recvBytes, sample->data.inBytes);
     else
@@ -309,7 +375,7 @@ TEST_F(UT_Process, test_recvBytes_001)
 TEST_F(UT_Process, test_sentBytes_001)
 {
     qreal sentBytes = m_tester->sentBytes();
-    auto *sample = m_tester->d->networkIOSample->recentSample();
+    auto *sample = m_tester->d->samples->networkIOSample.recentSample();
     if (sample)
         EXPECT_EQ(sentBytes, sample->data.outBytes);
     else
@@ -479,6 +545,19 @@ TEST_F(UT_Process, test_readStat_004)
 //    EXPECT_TRUE(m_Sresult=="close");
 }
 
+TEST_F(UT_Process, test_readProcessVariableStats_001)
+{
+    // pid gone, first failed read stops the rest
+    Process proc(INT_MAX);
+    EXPECT_FALSE(proc.readProcessVariableStats(nullptr, true));
+    EXPECT_FALSE(proc.isValid());
+    EXPECT_TRUE(proc.vanished());
+
+    Process self(getpid());
+    EXPECT_TRUE(self.readProcessVariableStats(nullptr, false));
+    EXPECT_FALSE(self.vanished());
+}
+
 TEST_F(UT_Process, test_readCmdline_001)
 {
     Stub b1;
@@ -501,7 +580,7 @@ TEST_F(UT_Process, test_readEnviron_001)
 {
     Stub b1;
     b1.set(open, stub_readStat_open2);
-    m_tester->readEnviron();
+    ProcessEnvironCache::readEnviron(m_tester->d->pid);
 
     EXPECT_TRUE(m_Sresult == "open failed");
 }
@@ -510,7 +589,7 @@ TEST_F(UT_Process, test_readEnviron_002)
 {
     pid_t pid = getpid();
     m_tester->d->pid = pid;
-    m_tester->readEnviron();
+    ProcessEnvironCache::readEnviron(m_tester->d->pid);
 
     EXPECT_TRUE(m_Sresult == "open failed");
 }
@@ -577,6 +656,20 @@ TEST_F(UT_Process, test_readStatus_002)
     EXPECT_TRUE(m_Sresult == "fopen failed");
 }
 
+TEST_F(UT_Process, test_readStatus_003)
+{
+    // sleeping is a voluntary switch
+    usleep(1000);
+    pid_t pid = getpid();
+    m_tester->d->pid = pid;
+    EXPECT_TRUE(m_tester->readStatus());
+    EXPECT_GT(m_tester->voluntarySwitches(), 0u);
+
+    // running process has touched pages
+    EXPECT_TRUE(m_tester->readStat());
+    EXPECT_GT(m_tester->minorFaults(), 0u);
+}
+
 TEST_F(UT_Process, test_readStatm_001)
 {
     Stub b1;
@@ -664,3 +757,144 @@ TEST_F(UT_Process, test_readProcessInfo_001)
     m_tester->readProcessInfo();
 
 }
+
+TEST_F(UT_Process, test_applyDKaptureData_001)
+{
+    QVariantMap data;
+    data["pid"] = getpid();
+    data["network_rx_bytes"] = 1000ull;
+    data["network_tx_bytes"] = 500ull;
+    m_tester->applyDKaptureData(data);
+
+    EXPECT_TRUE(m_tester->hasNetCounters());
+    EXPECT_EQ(m_tester->netRxBytes(), 1000ull);
+    EXPECT_EQ(m_tester->netTxBytes(), 500ull);
+    // kernel accounted traffic needs no socket inodes
+    EXPECT_TRUE(m_tester->d->sockInodes.isEmpty());
+}
+
+TEST_F(UT_Process, test_applyDKaptureData_002)
+{
+    QVariantMap data;
+    data["pid"] = getpid();
+    m_tester->applyDKaptureData(data);
+
+    EXPECT_FALSE(m_tester->hasNetCounters());
+}
+
+TEST_F(UT_Process, test_applyDKaptureRecord_001)
+{
+    process_info_record_t rec {};
+    rec.pid = getpid();
+    strcpy(rec.comm, "tester");
+    rec.memory_resident = 4;
+    rec.memory_shared = 2;
+    rec.net_rx_bytes = 1000;
+    rec.net_tx_bytes = 500;
+    rec.sections = kProcessInfoStatm | kProcessInfoTraffic;
+    m_tester->applyDKaptureRecord(rec);
+
+    EXPECT_EQ(m_tester->name(), QString("tester"));
+    EXPECT_EQ(m_tester->d->rss, 4ull << kb_shift);
+    EXPECT_EQ(m_tester->d->shm, 2ull << kb_shift);
+    EXPECT_TRUE(m_tester->hasNetCounters());
+    EXPECT_EQ(m_tester->netRxBytes(), 1000ull);
+    EXPECT_EQ(m_tester->netTxBytes(), 500ull);
+    EXPECT_TRUE(m_tester->d->sockInodes.isEmpty());
+}
+
+TEST_F(UT_Process, test_applyDKaptureRecord_002)
+{
+    process_info_record_t rec {};
+    rec.pid = getpid();
+    // fields of missing sections are not applied
+    rec.net_rx_bytes = 1000;
+    rec.utime = 100;
+    m_tester->d->utime = 7;
+    m_tester->applyDKaptureRecord(rec);
+
+    EXPECT_FALSE(m_tester->hasNetCounters());
+    EXPECT_EQ(m_tester->d->utime, 7ull);
+}
+
+TEST_F(UT_Process, test_applyDKaptureRecord_003)
+{
+    process_info_record_t rec {};
+    rec.pid = getpid();
+    // rates computed by the server are used as is
+    rec.utime = 100;
+    rec.cpu_usage = 12.5;
+    rec.read_bps = 4096;
+    rec.write_bps = 1024;
+    rec.net_rx_bps = 300;
+    rec.net_tx_bps = 200;
+    rec.sections = kProcessInfoStat | kProcessInfoIO | kProcessInfoTraffic | kProcessInfoRates;
+    m_tester->applyDKaptureRecord(rec);
+
+    EXPECT_DOUBLE_EQ(m_tester->cpu(), 12.5);
+    EXPECT_DOUBLE_EQ(m_tester->readBps(), 4096.);
+    EXPECT_DOUBLE_EQ(m_tester->writeBps(), 1024.);
+    EXPECT_DOUBLE_EQ(m_tester->recvBps(), 300.);
+    EXPECT_DOUBLE_EQ(m_tester->sentBps(), 200.);
+}
+
+TEST(UT_ProcessInfoRecord, test_processInfoRecords)
+{
+    std::vector<uint64_t> buf((sizeof(process_info_records_header_t) + 2 * sizeof(process_info_record_t)) / sizeof(uint64_t));
+    auto *hdr = reinterpret_cast<process_info_records_header_t *>(buf.data());
+    hdr->magic = PROCESS_INFO_RECORDS_MAGIC;
+    hdr->version = PROCESS_INFO_RECORDS_VERSION;
+    hdr->record_size = sizeof(process_info_record_t);
+    hdr->count = 2;
+    auto *records = reinterpret_cast<process_info_record_t *>(hdr + 1);
+    records[1].pid = 42;
+
+    uint32_t count = 0;
+    size_t len = buf.size() * sizeof(uint64_t);
+    const process_info_record_t *rec = processInfoRecords(buf.data(), len, count);
+    ASSERT_NE(rec, nullptr);
+    EXPECT_EQ(count, 2u);
+    EXPECT_EQ(rec[1].pid, 42);
+
+    // truncated buffer
+    EXPECT_EQ(processInfoRecords(buf.data(), len - 1, count), nullptr);
+    EXPECT_EQ(count, 0u);
+    // unknown version
+    hdr->version = PROCESS_INFO_RECORDS_VERSION + 1;
+    EXPECT_EQ(processInfoRecords(buf.data(), len, count), nullptr);
+    // server failure
+    EXPECT_EQ(processInfoRecords(nullptr, 0, count), nullptr);
+}
+
+TEST(UT_ProcessInfoRecord, test_processInfoSnapshot)
+{
+    const uint32_t capacity = 4;
+    std::vector<uint64_t> seg(processInfoShmSize(capacity) / sizeof(uint64_t));
+    auto *hdr = reinterpret_cast<process_info_shm_header_t *>(seg.data());
+    hdr->capacity = capacity;
+
+    std::vector<process_info_record_t> records(capacity);
+    uint32_t count = 0;
+    uint64_t timestamp = 0;
+    // nothing published yet
+    EXPECT_FALSE(copyProcessInfoSnapshot(hdr, records.data(), count, timestamp));
+
+    for (uint32_t n = 1; n <= 3; ++n) {
+        process_info_record_t *buffer = beginProcessInfoSnapshot(hdr);
+        for (uint32_t i = 0; i < n; ++i)
+            buffer[i].pid = int32_t(n * 10 + i);
+        if (n > 1) {
+            // previous snapshot is still readable while the next one is written
+            ASSERT_TRUE(copyProcessInfoSnapshot(hdr, records.data(), count, timestamp));
+            EXPECT_EQ(count, n - 1);
+            EXPECT_EQ(records[0].pid, int32_t((n - 1) * 10));
+        }
+        publishProcessInfoSnapshot(hdr, n, n * 100);
+
+        ASSERT_TRUE(copyProcessInfoSnapshot(hdr, records.data(), count, timestamp));
+        EXPECT_EQ(count, n);
+        EXPECT_EQ(timestamp, uint64_t(n * 100));
+        EXPECT_EQ(records[n - 1].pid, int32_t(n * 10 + n - 1));
+    }
+    EXPECT_EQ(hdr->seq, uint64_t(6));
+}
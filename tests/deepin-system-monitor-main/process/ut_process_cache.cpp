@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/process_cache.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <QString>
+
+using namespace core::process;
+
+class UT_ProcessCache : public ::testing::Test
+{
+public:
+    UT_ProcessCache() : m_tester(4) {}
+
+protected:
+    ProcessCache<QString> m_tester;
+};
+
+TEST_F(UT_ProcessCache, test_object_001)
+{
+    m_tester.insert(100, 42, "a", 10);
+    ASSERT_NE(m_tester.object(100, 42), nullptr);
+    EXPECT_EQ(*m_tester.object(100, 42), "a");
+    EXPECT_EQ(m_tester.peek(100, 42), m_tester.object(100));
+
+    // pid reused by another process, entry of the exited one is dropped
+    EXPECT_EQ(m_tester.object(100, 43), nullptr);
+    EXPECT_FALSE(m_tester.contains(100));
+    EXPECT_EQ(m_tester.stats().reused, 1u);
+    EXPECT_EQ(m_tester.stats().bytes, 0);
+}
+
+TEST_F(UT_ProcessCache, test_object_002)
+{
+    // start time not read yet, the first known one is adopted
+    m_tester.insert(100, 0, "a");
+    EXPECT_NE(m_tester.object(100, 42), nullptr);
+    EXPECT_NE(m_tester.peek(100, 42), nullptr);
+    EXPECT_EQ(m_tester.peek(100, 43), nullptr);
+}
+
+TEST_F(UT_ProcessCache, test_insert_001)
+{
+    for (pid_t pid = 1; pid <= 4; ++pid)
+        m_tester.insert(pid, 0, QString::number(pid), 10);
+    // used recently, survives eviction
+    m_tester.object(1);
+    m_tester.insert(5, 0, "5", 10);
+
+    ProcessCacheStats stats = m_tester.stats();
+    EXPECT_EQ(stats.count, 4);
+    EXPECT_EQ(stats.bytes, 40);
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_TRUE(m_tester.contains(1));
+    EXPECT_FALSE(m_tester.contains(2));
+
+    // replacing keeps one entry per pid
+    m_tester.insert(5, 0, "five", 20);
+    EXPECT_EQ(m_tester.count(), 4);
+    EXPECT_EQ(m_tester.stats().bytes, 50);
+}
+
+TEST_F(UT_ProcessCache, test_remove_001)
+{
+    m_tester.insert(100, 0, "a", 10);
+    EXPECT_TRUE(m_tester.remove(100));
+    EXPECT_FALSE(m_tester.remove(100));
+    EXPECT_EQ(m_tester.stats().bytes, 0);
+
+    m_tester.insert(100, 0, "a", 10);
+    m_tester.clear();
+    EXPECT_EQ(m_tester.count(), 0);
+    EXPECT_EQ(m_tester.stats().bytes, 0);
+}
+
+TEST_F(UT_ProcessCache, test_setMaxCount_001)
+{
+    for (pid_t pid = 1; pid <= 4; ++pid)
+        m_tester.insert(pid, 0, QString::number(pid));
+    m_tester.setMaxCount(2);
+    EXPECT_EQ(m_tester.count(), 2);
+    EXPECT_TRUE(m_tester.contains(4));
+    EXPECT_TRUE(m_tester.contains(3));
+}
+
+TEST_F(UT_ProcessCache, test_copy_001)
+{
+    m_tester.insert(1, 0, "1");
+    m_tester.insert(2, 0, "2");
+
+    ProcessCache<QString> copy(m_tester);
+    m_tester.clear();
+    // copies index their own entries
+    ASSERT_NE(copy.object(1), nullptr);
+    EXPECT_EQ(*copy.object(1), "1");
+    EXPECT_TRUE(copy.remove(2));
+    EXPECT_EQ(copy.count(), 1);
+}
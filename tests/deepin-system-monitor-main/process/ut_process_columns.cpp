@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/process_columns.h"
+#include "process/process.h"
+#include "process/process_set.h"
+#include "process/private/process_p.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+using namespace core::process;
+
+class UT_ProcessColumns : public ::testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        add(1, 0, 0, "systemd", "root", 0.5, 4000, kNoFilter);
+        add(200, 1, 1000, "dde-shell", "user", 7.25, 90000, kFilterApps);
+        add(300, 200, 1000, "bash", "user", 0, 3000, kFilterCurrentUser);
+        add(400, 200, 1000, "bash", "user", 12.5, 5000, kFilterApps);
+        // left out of the snapshot
+        Process invalid(500);
+        m_set.insert(500, invalid);
+    }
+
+protected:
+    void add(pid_t pid, pid_t ppid, uid_t uid, const QString &name, const QString &user, qreal cpu, qulonglong rss, int appType)
+    {
+        Process proc(pid);
+        proc.d->valid = true;
+        proc.d->ppid = ppid;
+        proc.d->uid = uid;
+        proc.d->rss = rss;
+        proc.d->shm = 1000;
+        proc.setName(name);
+        proc.setUserName(user);
+        proc.setCpu(cpu);
+        proc.setAppType(appType);
+        m_set.insert(pid, proc);
+    }
+
+    QMap<pid_t, Process> m_set;
+};
+
+TEST_F(UT_ProcessColumns, test_build_001)
+{
+    ProcessColumns columns(m_set);
+    ASSERT_EQ(columns.size(), 4);
+    EXPECT_EQ(columns.pid(0), 1);
+    EXPECT_EQ(columns.ppid(3), 200);
+    EXPECT_EQ(columns.uid(1), uid_t(1000));
+    EXPECT_EQ(columns.name(3), QString("bash"));
+    EXPECT_EQ(columns.userName(0), QString("root"));
+    EXPECT_EQ(columns.counter(ProcessColumns::kMemory, 1), qulonglong(89000));
+    // systemd, root, dde-shell, user, bash
+    EXPECT_EQ(columns.internedCount(), 5);
+}
+
+TEST_F(UT_ProcessColumns, test_slotOf_001)
+{
+    ProcessColumns columns(m_set);
+    EXPECT_EQ(columns.slotOf(1), 0);
+    EXPECT_EQ(columns.slotOf(400), 3);
+    EXPECT_EQ(columns.slotOf(500), -1);
+    EXPECT_EQ(columns.slotOf(2), -1);
+    EXPECT_EQ(ProcessColumns().slotOf(1), -1);
+}
+
+TEST_F(UT_ProcessColumns, test_aggregate_001)
+{
+    ProcessColumns columns(m_set);
+    EXPECT_DOUBLE_EQ(columns.sum(ProcessColumns::kCpuRate), 20.25);
+    EXPECT_EQ(columns.sum(ProcessColumns::kMemory), qulonglong(3000 + 89000 + 2000 + 4000));
+    EXPECT_EQ(columns.countOf(kFilterApps), 2);
+    EXPECT_EQ(columns.countOf(kFilterCurrentUser), 1);
+
+    QVector<int> users = columns.filter([](const ProcessColumns &c, int slot) { return c.uid(slot) == 1000; });
+    EXPECT_EQ(users, QVector<int>({1, 2, 3}));
+}
+
+TEST_F(UT_ProcessColumns, test_members_001)
+{
+    ProcessColumns columns(m_set);
+    EXPECT_EQ(columns.members(kFilterApps), QVector<pid_t>({200, 400}));
+    // my processes include the applications
+    EXPECT_EQ(columns.members(kFilterCurrentUser), QVector<pid_t>({200, 300, 400}));
+    EXPECT_EQ(columns.members(kNoFilter), QVector<pid_t>({1, 200, 300, 400}));
+    EXPECT_TRUE(columns.isMember(kFilterApps, 400));
+    EXPECT_FALSE(columns.isMember(kFilterApps, 300));
+    EXPECT_FALSE(columns.isMember(kNoFilter, 500));
+    EXPECT_EQ(columns.countOf(kNoFilter), 1);
+    EXPECT_TRUE(ProcessColumns().members(kFilterApps).isEmpty());
+
+    EXPECT_TRUE(isShownIn(kFilterCurrentUser, kFilterApps));
+    EXPECT_FALSE(isShownIn(kFilterApps, kFilterCurrentUser));
+    EXPECT_TRUE(isShownIn(kNoFilter, kNoFilter));
+}
+
+TEST_F(UT_ProcessColumns, test_topK_001)
+{
+    ProcessColumns columns(m_set);
+    EXPECT_EQ(columns.topK(ProcessColumns::kCpuRate, 2), QVector<int>({3, 1}));
+    EXPECT_EQ(columns.topK(ProcessColumns::kCpuRate, 10).size(), 4);
+    EXPECT_TRUE(columns.topK(ProcessColumns::kCpuRate, -1).isEmpty());
+    EXPECT_TRUE(ProcessColumns().topK(ProcessColumns::kCpuRate, 3).isEmpty());
+}
+
+TEST_F(UT_ProcessColumns, test_sorted_001)
+{
+    ProcessColumns columns(m_set);
+    EXPECT_EQ(columns.sorted(ProcessColumns::kCpuRate, Qt::AscendingOrder), QVector<int>({2, 0, 1, 3}));
+    EXPECT_EQ(columns.sorted(ProcessColumns::kCpuRate, Qt::DescendingOrder), QVector<int>({3, 1, 0, 2}));
+}
@@ -9,10 +9,15 @@
 #include "process/private/process_p.h"
 #include "process/desktop_entry_cache.h"
 #include "wm/wm_window_list.h"
+#include "process_info_record.h"
 //gtest
 #include "stub.h"
 #include <gtest/gtest.h>
 
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
 using namespace core::process;
 static QString m_Sresult;
 /***************************************STUB begin*********************************************/
@@ -210,3 +215,62 @@ TEST_F(UT_ProcessDB, test_sendSignalToProcess_001)
     m_tester->sendSignalToProcess(100000,SIGCONT);
 }
 
+
+TEST_F(UT_ProcessDB, test_controlProcesses_001)
+{
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        pause();
+        _exit(0);
+    }
+
+    QList<pid_t> controlled;
+    QList<int> errors;
+    QObject::connect(m_tester, &ProcessDB::processesControlled, m_tester,
+                     [&](const QList<pid_t> &pids, int, int, const QList<int> &errs) {
+                         controlled = pids;
+                         errors = errs;
+                     });
+
+    // own processes need no privileges, answered at once
+    m_tester->controlProcesses({child, 999999}, PROCESS_CONTROL_SIGNAL, SIGSTOP);
+    EXPECT_EQ(controlled, QList<pid_t>({child, 999999}));
+    EXPECT_EQ(errors, QList<int>({0, ESRCH}));
+
+    m_tester->controlProcesses({child}, PROCESS_CONTROL_SIGNAL, SIGHUP);
+    EXPECT_EQ(errors, QList<int>({EINVAL}));
+
+    m_tester->controlProcesses({child}, PROCESS_CONTROL_RENICE, 5);
+    EXPECT_EQ(errors, QList<int>({0}));
+    EXPECT_EQ(getpriority(PRIO_PROCESS, id_t(child)), 5);
+
+    // the mask goes along, the process may run on each of these cpus already
+    cpu_set_t set;
+    ASSERT_EQ(sched_getaffinity(child, sizeof(set), &set), 0);
+    m_tester->setProcessesAffinity({child}, QByteArray(reinterpret_cast<const char *>(&set), sizeof(set)));
+    EXPECT_EQ(errors, QList<int>({0}));
+    m_tester->controlProcesses({child}, PROCESS_CONTROL_AFFINITY, CPU_COUNT(&set));
+    EXPECT_EQ(errors, QList<int>({EINVAL}));
+
+    m_tester->controlProcesses({child}, PROCESS_CONTROL_SIGNAL, SIGKILL);
+    EXPECT_EQ(errors, QList<int>({0}));
+    waitpid(child, nullptr, 0);
+    EXPECT_TRUE(m_tester->m_controlBatches.isEmpty());
+}
+
+TEST(UT_ProcessControl, test_processControlValid_001)
+{
+    EXPECT_TRUE(processControlValid(PROCESS_CONTROL_SIGNAL, SIGCONT));
+    EXPECT_FALSE(processControlValid(PROCESS_CONTROL_SIGNAL, SIGUSR1));
+    EXPECT_TRUE(processControlValid(PROCESS_CONTROL_RENICE, -20));
+    EXPECT_FALSE(processControlValid(PROCESS_CONTROL_RENICE, 20));
+    // best effort level 4, idle
+    EXPECT_TRUE(processControlValid(PROCESS_CONTROL_IONICE, 2 << PROCESS_CONTROL_IOPRIO_CLASS_SHIFT | 4));
+    EXPECT_TRUE(processControlValid(PROCESS_CONTROL_IONICE, 3 << PROCESS_CONTROL_IOPRIO_CLASS_SHIFT));
+    EXPECT_FALSE(processControlValid(PROCESS_CONTROL_IONICE, 3 << PROCESS_CONTROL_IOPRIO_CLASS_SHIFT | 1));
+    EXPECT_FALSE(processControlValid(PROCESS_CONTROL_IONICE, 2 << PROCESS_CONTROL_IOPRIO_CLASS_SHIFT | 8));
+    EXPECT_TRUE(processControlValid(PROCESS_CONTROL_AFFINITY, 4));
+    EXPECT_FALSE(processControlValid(PROCESS_CONTROL_AFFINITY, 0));
+    EXPECT_FALSE(processControlValid(4, 0));
+}
@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/process_diff.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+using namespace core::process;
+
+class UT_ProcessDiff : public ::testing::Test
+{
+protected:
+    static diff_row_t row(pid_t pid, qulonglong start, const QString &name, const QString &unit, qulonglong ticks,
+                          qulonglong memory, qulonglong read, int sockets)
+    {
+        diff_row_t r;
+        r.pid = pid;
+        r.startTicks = start;
+        r.name = name;
+        r.unit = unit;
+        r.cpu = ticks / 10.;
+        r.cpuTicks = ticks;
+        r.memory = memory;
+        r.readBytes = read;
+        r.writeBytes = read / 2;
+        r.sockets = sockets;
+        return r;
+    }
+};
+
+TEST_F(UT_ProcessDiff, test_unitOfCgroup)
+{
+    EXPECT_EQ(DiffSnapshot::unitOfCgroup("/system.slice/cron.service"), QString("cron.service"));
+    EXPECT_EQ(DiffSnapshot::unitOfCgroup("/user.slice/user-1000.slice/user@1000.service/app.slice/dbus.service"),
+              QString("dbus.service"));
+    // apps of a session are in the user manager's service
+    EXPECT_EQ(DiffSnapshot::unitOfCgroup("/user.slice/user-1000.slice/user@1000.service/app.slice/app-dde-term.scope"),
+              QString("user@1000.service"));
+    EXPECT_TRUE(DiffSnapshot::unitOfCgroup("/user.slice/user-1000.slice/session-2.scope").isEmpty());
+    EXPECT_TRUE(DiffSnapshot::unitOfCgroup("/init.scope").isEmpty());
+    EXPECT_TRUE(DiffSnapshot::unitOfCgroup(QString()).isEmpty());
+}
+
+TEST_F(UT_ProcessDiff, test_finish_sorts)
+{
+    DiffSnapshot snapshot(1000);
+    snapshot.append(row(30, 5, "c", "", 0, 0, 0, -1));
+    snapshot.append(row(10, 9, "b", "x.service", 0, 0, 0, -1));
+    snapshot.append(row(10, 2, "a", "x.service", 0, 0, 0, -1));
+    snapshot.finish();
+    ASSERT_EQ(snapshot.size(), 3);
+    EXPECT_EQ(snapshot.time(), 1000);
+    EXPECT_EQ(snapshot.name(0), QString("a"));
+    EXPECT_EQ(snapshot.name(1), QString("b"));
+    EXPECT_EQ(snapshot.name(2), QString("c"));
+    EXPECT_EQ(snapshot.unitIndex(0), snapshot.unitIndex(1));
+    EXPECT_TRUE(snapshot.unit(2).isEmpty());
+}
+
+TEST_F(UT_ProcessDiff, test_compute)
+{
+    auto before = std::make_shared<DiffSnapshot>(1000);
+    before->append(row(1, 1, "systemd", "", 100, 4000, 1000, 50));
+    before->append(row(200, 10, "nginx", "nginx.service", 500, 20000, 4096, 10));
+    before->append(row(201, 11, "nginx", "nginx.service", 300, 10000, 0, 4));
+    before->append(row(300, 20, "old", "app.service", 10, 2000, 0, -1));
+    before->finish();
+
+    auto after = std::make_shared<DiffSnapshot>(2000);
+    after->append(row(1, 1, "systemd", "", 100, 4000, 1000, 50));
+    after->append(row(200, 10, "nginx", "nginx.service", 800, 25000, 8192, 12));
+    after->append(row(202, 30, "nginx", "nginx.service", 40, 9000, 512, 3));
+    // pid 300 reused
+    after->append(row(300, 40, "new", "app.service", 5, 1000, 0, -1));
+    after->finish();
+
+    const SnapshotDiff diff = SnapshotDiff::compute(before, after);
+    ASSERT_TRUE(diff.isValid());
+    EXPECT_EQ(diff.startedCount(), 2);
+    EXPECT_EQ(diff.exitedCount(), 2);
+    const QVector<process_delta_t> &processes = diff.processes();
+    ASSERT_EQ(processes.size(), 6);
+
+    // pid order, the exited process of a reused pid first
+    EXPECT_EQ(processes[0].change, process_delta_t::kKept);
+    EXPECT_EQ(processes[0].cpuTicks, 0);
+    EXPECT_EQ(processes[1].change, process_delta_t::kKept);
+    EXPECT_EQ(diff.pid(processes[1]), 200);
+    EXPECT_EQ(processes[1].cpuTicks, 300);
+    EXPECT_EQ(processes[1].memory, 5000);
+    EXPECT_EQ(processes[1].readBytes, 4096);
+    EXPECT_EQ(processes[1].sockets, 2);
+    EXPECT_EQ(processes[2].change, process_delta_t::kExited);
+    EXPECT_EQ(diff.pid(processes[2]), 201);
+    EXPECT_EQ(processes[2].memory, -10000);
+    EXPECT_EQ(processes[2].sockets, -4);
+    EXPECT_EQ(processes[3].change, process_delta_t::kStarted);
+    EXPECT_EQ(processes[3].cpuTicks, 40);
+    EXPECT_EQ(processes[3].readBytes, 512);
+    EXPECT_EQ(processes[4].change, process_delta_t::kExited);
+    EXPECT_EQ(diff.name(processes[4]), QString("old"));
+    EXPECT_EQ(processes[5].change, process_delta_t::kStarted);
+    EXPECT_EQ(diff.name(processes[5]), QString("new"));
+    // no socket count in either
+    EXPECT_EQ(processes[5].sockets, 0);
+
+    // units in name order, processes of no service left out
+    const QVector<service_delta_t> &services = diff.services();
+    ASSERT_EQ(services.size(), 2);
+    EXPECT_EQ(services[0].unit, QString("app.service"));
+    EXPECT_EQ(services[0].started, 1);
+    EXPECT_EQ(services[0].exited, 1);
+    EXPECT_EQ(services[0].memory, -1000);
+    const service_delta_t &nginx = services[1];
+    EXPECT_EQ(nginx.unit, QString("nginx.service"));
+    EXPECT_EQ(nginx.processesBefore, 2);
+    EXPECT_EQ(nginx.processesAfter, 2);
+    EXPECT_EQ(nginx.started, 1);
+    EXPECT_EQ(nginx.exited, 1);
+    EXPECT_EQ(nginx.cpuTicks, 340);
+    EXPECT_EQ(nginx.memory, 5000 - 10000 + 9000);
+    EXPECT_EQ(nginx.readBytes, 4096 + 512);
+    EXPECT_EQ(nginx.sockets, 2 - 4 + 3);
+    EXPECT_DOUBLE_EQ(nginx.cpuBefore, 80.);
+    EXPECT_DOUBLE_EQ(nginx.cpuAfter, 84.);
+}
+
+TEST_F(UT_ProcessDiff, test_compute_invalid)
+{
+    auto snapshot = std::make_shared<DiffSnapshot>();
+    snapshot->finish();
+    EXPECT_FALSE(SnapshotDiff::compute(nullptr, snapshot).isValid());
+    EXPECT_FALSE(SnapshotDiff::compute(snapshot, nullptr).isValid());
+
+    const SnapshotDiff empty = SnapshotDiff::compute(snapshot, snapshot);
+    EXPECT_TRUE(empty.isValid());
+    EXPECT_TRUE(empty.processes().isEmpty());
+}
+
+TEST_F(UT_ProcessDiff, test_compute_large)
+{
+    // 50k processes each, a tenth exited & as many started in between
+    const int count = 50000;
+    auto before = std::make_shared<DiffSnapshot>(0);
+    auto after = std::make_shared<DiffSnapshot>(1);
+    before->reserve(count);
+    after->reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const QString unit = QString("unit-%1.service").arg(i % 100);
+        before->append(row(pid_t(i + 1), 1, "worker", unit, qulonglong(i), 1000, 0, 1));
+        after->append(row(pid_t(i + 1 + count / 10), 1, "worker", unit, qulonglong(i) + 1, 1000, 0, 1));
+    }
+    before->finish();
+    after->finish();
+
+    const SnapshotDiff diff = SnapshotDiff::compute(before, after);
+    EXPECT_EQ(diff.exitedCount(), count / 10);
+    EXPECT_EQ(diff.startedCount(), count / 10);
+    EXPECT_EQ(diff.processes().size(), count + count / 10);
+    EXPECT_EQ(diff.services().size(), 100);
+}
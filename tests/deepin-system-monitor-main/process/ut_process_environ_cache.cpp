@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/process_environ_cache.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace core::process;
+
+class UT_ProcessEnvironCache : public ::testing::Test
+{
+public:
+    UT_ProcessEnvironCache() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = ProcessEnvironCache::instance();
+        m_tester->clear();
+    }
+
+    virtual void TearDown()
+    {
+        m_tester->clear();
+    }
+
+protected:
+    ProcessEnvironCache *m_tester;
+};
+
+TEST_F(UT_ProcessEnvironCache, test_readEnviron_001)
+{
+    // environ of our own process is a snapshot at exec time
+    ProcessEnvironCache::Environ env = ProcessEnvironCache::readEnviron(getpid());
+    if (getenv("PATH"))
+        EXPECT_TRUE(env.contains("PATH"));
+    // reading never touches the cache
+    EXPECT_EQ(m_tester->count(), 0);
+}
+
+TEST_F(UT_ProcessEnvironCache, test_lookup_001)
+{
+    ProcessEnvironCache::Environ env;
+    env.insert("LANG", "C");
+    m_tester->insert(100, 42, env);
+
+    ProcessEnvironCache::Environ out;
+    EXPECT_TRUE(m_tester->lookup(100, 42, out));
+    EXPECT_EQ(out, env);
+    // pid reused by another process
+    EXPECT_FALSE(m_tester->lookup(100, 43, out));
+
+    m_tester->remove(100);
+    EXPECT_FALSE(m_tester->lookup(100, 42, out));
+}
+
+TEST_F(UT_ProcessEnvironCache, test_insert_001)
+{
+    ProcessEnvironCache::Environ env;
+    for (int i = 0; i < ProcessEnvironCache::kMaxCacheSize * 2; ++i)
+        m_tester->insert(i + 1, 0, env);
+
+    EXPECT_EQ(m_tester->count(), ProcessEnvironCache::kMaxCacheSize);
+}
+
+TEST_F(UT_ProcessEnvironCache, test_environ_001)
+{
+    pid_t pid = getpid();
+    ProcessEnvironCache::Environ env = m_tester->environ(pid, 0);
+    EXPECT_EQ(m_tester->count(), 1);
+
+    ProcessEnvironCache::Environ out;
+    EXPECT_TRUE(m_tester->lookup(pid, 0, out));
+    EXPECT_EQ(out, env);
+}
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/process_gpu_cache.h"
+#include "process/process.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <unistd.h>
+
+using namespace core::process;
+
+class UT_ProcessGpuCache : public ::testing::Test
+{
+public:
+    UT_ProcessGpuCache() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = ProcessGpuCache::instance();
+        m_tester->clear();
+        m_tester->setEnabled(true);
+    }
+
+    virtual void TearDown()
+    {
+        m_tester->setEnabled(false);
+        m_tester->clear();
+    }
+
+protected:
+    ProcessGpuCache *m_tester;
+};
+
+TEST_F(UT_ProcessGpuCache, test_parseFdInfo_001)
+{
+    const char fdinfo[] = "pos:\t0\n"
+                          "flags:\t02100002\n"
+                          "mnt_id:\t24\n"
+                          "drm-driver:\tamdgpu\n"
+                          "drm-client-id:\t15\n"
+                          "drm-pdev:\t0000:03:00.0\n"
+                          "pasid:\t32789\n"
+                          "drm-memory-vram:\t114064 KiB\n"
+                          "drm-memory-gtt: \t4848 KiB\n"
+                          "drm-memory-cpu: \t0 KiB\n"
+                          "amd-memory-visible-vram:\t17324 KiB\n"
+                          "drm-engine-gfx:\t1704185088 ns\n"
+                          "drm-engine-compute:\t0 ns\n"
+                          "drm-engine-capacity-gfx:\t2\n";
+    drm_client_t client;
+    ASSERT_TRUE(ProcessGpuCache::parseFdInfo(fdinfo, strlen(fdinfo), client));
+    EXPECT_EQ(client.id, QByteArray("0000:03:00.0/15"));
+    EXPECT_EQ(client.memory, 114064ull + 4848);
+    EXPECT_EQ(client.engines.size(), 2);
+    EXPECT_EQ(client.engines.value("0000:03:00.0/gfx"), 1704185088ull);
+    EXPECT_EQ(client.capacity.value("0000:03:00.0/gfx"), 2ull);
+    EXPECT_EQ(client.capacity.value("0000:03:00.0/compute"), 1ull);
+}
+
+TEST_F(UT_ProcessGpuCache, test_parseFdInfo_002)
+{
+    // i915 tells total & resident, resident is what's counted, sizes without unit are bytes
+    const char fdinfo[] = "drm-driver:\ti915\n"
+                          "drm-client-id:\t5\n"
+                          "drm-pdev:\t0000:00:02.0\n"
+                          "drm-total-system0:\t8192 KiB\n"
+                          "drm-resident-system0:\t4096 KiB\n"
+                          "drm-resident-stolen-system0:\t1048576\n"
+                          "drm-engine-render:\t25662044495 ns\n"
+                          "drm-engine-video:\t0 ns\n"
+                          "drm-engine-capacity-video:\t2\n";
+    drm_client_t client;
+    ASSERT_TRUE(ProcessGpuCache::parseFdInfo(fdinfo, strlen(fdinfo), client));
+    EXPECT_EQ(client.memory, 4096ull + 1024);
+    EXPECT_EQ(client.engines.value("0000:00:02.0/render"), 25662044495ull);
+    EXPECT_EQ(client.capacity.value("0000:00:02.0/video"), 2ull);
+}
+
+TEST_F(UT_ProcessGpuCache, test_parseFdInfo_003)
+{
+    // plain files & drivers without usage stats
+    const char fdinfo[] = "pos:\t0\nflags:\t0100002\nmnt_id:\t26\nino:\t1051\n";
+    drm_client_t client;
+    EXPECT_FALSE(ProcessGpuCache::parseFdInfo(fdinfo, strlen(fdinfo), client));
+    EXPECT_FALSE(ProcessGpuCache::parseFdInfo("", 0, client));
+}
+
+TEST_F(UT_ProcessGpuCache, test_refresh)
+{
+    QMap<pid_t, Process> set;
+    set.insert(getpid(), Process(getpid()));
+    // no drm fds, nothing read
+    EXPECT_EQ(m_tester->refresh(set, 1000), 0);
+    gpu_usage_t usage;
+    EXPECT_FALSE(m_tester->lookup(getpid(), set.first().startTimeTicks(), usage));
+
+    m_tester->setEnabled(false);
+    EXPECT_EQ(m_tester->refresh(set, 2000), 0);
+}
@@ -6,6 +6,7 @@
 //self
 #include "process/process_icon.h"
 #include "process/private/process_p.h"
+#include "process/process_environ_cache.h"
 #include "process/process.h"
 #include "process/desktop_entry_cache.h"
 #include "wm/wm_window_list.h"
@@ -123,7 +124,9 @@ TEST_F(UT_ProcessIcon, test_getIcon_004)
     b.set(ADDR(QByteArrayList,isEmpty),stub_getIcon_isEmpty);
     Stub b1;
     b1.set(ADDR(WMWindowList,isTrayApp),stub_getIcon_isTrayApp);
-    proc->d->environ.insert("GIO_LAUNCHED_DESKTOP_FILE","1");
+    ProcessEnvironCache::Environ env;
+    env.insert("GIO_LAUNCHED_DESKTOP_FILE","1");
+    ProcessEnvironCache::instance()->insert(proc->pid(), proc->d->start_time, env);
     QByteArrayList cmdline;
     cmdline << "/opt/null";
     proc->d->cmdline = cmdline;
@@ -138,7 +141,9 @@ TEST_F(UT_ProcessIcon, test_getIcon_005)
     b.set(ADDR(QByteArrayList,isEmpty),stub_getIcon_isEmpty);
     Stub b1;
     b1.set(ADDR(WMWindowList,isGuiApp),stub_getIcon_isTrayApp);
-    proc->d->environ.insert("GIO_LAUNCHED_DESKTOP_FILE","1");
+    ProcessEnvironCache::Environ env;
+    env.insert("GIO_LAUNCHED_DESKTOP_FILE","1");
+    ProcessEnvironCache::instance()->insert(proc->pid(), proc->d->start_time, env);
     QByteArrayList cmdline;
     cmdline << "/opt/null";
     proc->d->cmdline = cmdline;
@@ -154,7 +159,9 @@ TEST_F(UT_ProcessIcon, test_getIcon_006)
     b.set(ADDR(QByteArrayList,isEmpty),stub_getIcon_isEmpty);
     Stub b1;
     b1.set(ADDR(DesktopEntryCache,contains),stub_getIcon_isTrayApp);
-    proc->d->environ.insert("GIO_LAUNCHED_DESKTOP_FILE","1");
+    ProcessEnvironCache::Environ env;
+    env.insert("GIO_LAUNCHED_DESKTOP_FILE","1");
+    ProcessEnvironCache::instance()->insert(proc->pid(), proc->d->start_time, env);
     QByteArrayList cmdline;
     cmdline << "/opt/null";
     proc->d->cmdline = cmdline;
@@ -169,9 +176,11 @@ TEST_F(UT_ProcessIcon, test_getIcon_007)
     b.set(ADDR(QByteArrayList,isEmpty),stub_getIcon_isEmpty);
     Stub b1;
     b1.set(ADDR(DesktopEntryCache,contains),stub_getIcon_isTrayApp);
-    proc->d->environ.insert("GIO_LAUNCHED_DESKTOP_FILE","1");
-     proc->d->environ.insert("GIO_LAUNCHED_DESKTOP_FILE_PID","1000");
-     proc->d->pid = 1000;
+    proc->d->pid = 1000;
+    ProcessEnvironCache::Environ env;
+    env.insert("GIO_LAUNCHED_DESKTOP_FILE","1");
+    env.insert("GIO_LAUNCHED_DESKTOP_FILE_PID","1000");
+    ProcessEnvironCache::instance()->insert(proc->pid(), proc->d->start_time, env);
     QByteArrayList cmdline;
     cmdline << "/opt/null";
     proc->d->cmdline = cmdline;
@@ -189,3 +198,19 @@ TEST_F(UT_ProcessIcon, test_getIcon_008)
     m_tester->getIcon(proc);
     delete proc;
 }
+
+TEST_F(UT_ProcessIcon, test_refreashProcessIcon_002)
+{
+    Process *proc = new Process();
+    QByteArrayList cmdline;
+    cmdline << "/usr/bin/null";
+    proc->d->cmdline = cmdline;
+    m_tester->refreashProcessIcon(proc);
+
+    // another pid of the same binary shares the resolved icon
+    ProcessIcon other;
+    other.refreashProcessIcon(proc);
+    EXPECT_EQ(other.m_data, m_tester->m_data);
+    EXPECT_EQ(other.pixmapKey(), m_tester->pixmapKey());
+    delete proc;
+}
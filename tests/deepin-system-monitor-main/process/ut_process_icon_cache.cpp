@@ -10,6 +10,8 @@
 //gtest
 #include "stub.h"
 #include <gtest/gtest.h>
+//Qt
+#include <QSignalSpy>
 
 using namespace core::process;
 
@@ -50,15 +52,46 @@ TEST_F(UT_ProcessIconCache, test_instance_001)
 
 TEST_F(UT_ProcessIconCache, test_getProcessIcon_001)
 {
-    pid_t pid =1000;
-    m_tester->getProcessIcon(pid);
+    QString identity("test");
+    m_tester->getProcessIcon(identity);
 
 }
 
 TEST_F(UT_ProcessIconCache, test_addProcessIcon_001)
 {
-    pid_t pid =1000;
+    QString identity("test");
     ProcessIcon *icon = new ProcessIcon();
-    m_tester->addProcessIcon(pid,icon);
+    m_tester->addProcessIcon(identity,icon);
+    EXPECT_EQ(m_tester->getProcessIcon(identity), icon);
 
 }
+
+TEST_F(UT_ProcessIconCache, test_pixmap_001)
+{
+    QSignalSpy spy(m_tester, &ProcessIconCache::iconsRendered);
+    QPixmap image(16, 16);
+    image.fill(Qt::red);
+    QIcon icon(image);
+
+    // placeholder until rendered after the paint
+    m_tester->pixmap("image:test", icon, QSize(16, 16));
+    m_tester->pixmap("image:test", icon, QSize(16, 16));
+    EXPECT_EQ(m_tester->m_pending.size(), 1);
+    m_tester->renderPending();
+    EXPECT_EQ(spy.count(), 1);
+    EXPECT_TRUE(m_tester->m_pending.isEmpty());
+    EXPECT_EQ(m_tester->pixmap("image:test", icon, QSize(16, 16)).toImage().pixelColor(0, 0), QColor(Qt::red));
+}
+
+TEST_F(UT_ProcessIconCache, test_onIconThemeChanged_001)
+{
+    m_tester->m_pixmaps.insert("image:test@16x16", new ProcessIconCache::rendered_icon_t {QPixmap(16, 16), false, false});
+    m_tester->m_pixmaps.insert("theme:test@16x16", new ProcessIconCache::rendered_icon_t {QPixmap(16, 16), true, false});
+    m_tester->onIconThemeChanged();
+
+    // only themed icons are rendered again
+    EXPECT_FALSE(m_tester->m_pixmaps.object("image:test@16x16")->stale);
+    EXPECT_TRUE(m_tester->m_pixmaps.object("theme:test@16x16")->stale);
+    m_tester->pixmap("theme:test", QIcon(), QSize(16, 16));
+    EXPECT_EQ(m_tester->m_pending.size(), 1);
+}
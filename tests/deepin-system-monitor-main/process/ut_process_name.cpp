@@ -152,3 +152,21 @@ TEST_F(UT_ProcessName, test_getDisplayName_005)
 
     delete proc;
 }
+
+TEST_F(UT_ProcessName, test_identityKey_001)
+{
+    Process first(INT_MAX);
+    first.setName("python3");
+    first.d->cmdline = QByteArrayList({"/usr/bin/python3", "a.py"});
+    Process second(INT_MAX - 1);
+    second.setName("python3");
+    second.d->cmdline = QByteArrayList({"/usr/bin/python3", "a.py"});
+    // another program launched the same way shares the name
+    EXPECT_EQ(m_tester->identityKey(&first), m_tester->identityKey(&second));
+
+    second.d->cmdline = QByteArrayList({"/usr/bin/python3", "b.py"});
+    EXPECT_NE(m_tester->identityKey(&first), m_tester->identityKey(&second));
+    // args aren't merged
+    second.d->cmdline = QByteArrayList({"/usr/bin/python3a", ".py"});
+    EXPECT_NE(m_tester->identityKey(&first), m_tester->identityKey(&second));
+}
@@ -11,15 +11,8 @@
 //Qt
 #include <QFileInfo>
 #include <QApplication>
-#include <QCache>
 using namespace core::process;
 
-typedef QCache<pid_t, ProcessName> myCache;
-/***************************************STUB begin*********************************************/
-void stub_insert_insert(){
-    return;
-}
-/***************************************STUB end**********************************************/
 class UT_ProcessNameCache : public ::testing::Test
 {
 public:
@@ -55,11 +48,36 @@ TEST_F(UT_ProcessNameCache, test_instance_001)
 
 TEST_F(UT_ProcessNameCache, test_insert_001)
 {
-    ProcessName *name = new ProcessName;
-    Stub b;
-    b.set(ADDR(myCache,insert),stub_insert_insert);
-    m_tester->insert(1000,name);
-    delete name;
+    ProcessName name;
+    m_tester->insert(1000, 42, name);
+    EXPECT_TRUE(m_tester->contains(1000));
+    EXPECT_NE(m_tester->processName(1000, 42), nullptr);
+    // pid reused by another process
+    EXPECT_EQ(m_tester->processName(1000, 43), nullptr);
+}
+
+TEST_F(UT_ProcessNameCache, test_insert_002)
+{
+    ProcessName name;
+    for (int i = 0; i < ProcessNameCache::kMaxCacheSize * 2; ++i)
+        m_tester->insert(i + 1, 0, name);
+
+    EXPECT_EQ(m_tester->stats().count, ProcessNameCache::kMaxCacheSize);
+    EXPECT_EQ(m_tester->stats().evictions, quint64(ProcessNameCache::kMaxCacheSize));
+    // least recently used are evicted first
+    EXPECT_FALSE(m_tester->contains(1));
+    EXPECT_TRUE(m_tester->contains(ProcessNameCache::kMaxCacheSize * 2));
+}
+
+TEST_F(UT_ProcessNameCache, test_displayName_001)
+{
+    EXPECT_EQ(m_tester->displayName(7), nullptr);
+    m_tester->insertDisplayName(7, "Terminal");
+    ASSERT_NE(m_tester->displayName(7), nullptr);
+    EXPECT_EQ(*m_tester->displayName(7), "Terminal");
+
+    m_tester->clear();
+    EXPECT_EQ(m_tester->displayName(7), nullptr);
 }
 
 TEST_F(UT_ProcessNameCache, test_remove_001)
@@ -75,7 +93,7 @@ TEST_F(UT_ProcessNameCache, test_clear_001)
 
 TEST_F(UT_ProcessNameCache, test_processName_001)
 {
-    m_tester->processName(1000);
+    m_tester->processName(1000, 0);
 }
 
 TEST_F(UT_ProcessNameCache, test_contains_001)
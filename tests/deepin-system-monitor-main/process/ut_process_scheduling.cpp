@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/process_scheduling.h"
+#include "process_info_record.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+
+using namespace core::process;
+
+class UT_ProcessSchedulingCpuset : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        char dir[] = "/tmp/ut_process_scheduling_XXXXXX";
+        ASSERT_NE(mkdtemp(dir), nullptr);
+        m_root = dir;
+    }
+
+    void TearDown() override
+    {
+        std::string cmd = "rm -rf " + m_root.toStdString();
+        EXPECT_EQ(system(cmd.c_str()), 0);
+    }
+
+    void writeFile(const QString &name, const QByteArray &content)
+    {
+        const QString path = m_root + name;
+        QDir().mkpath(QFileInfo(path).path());
+        QFile file(path);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(content);
+    }
+
+    QString m_root;
+};
+
+TEST(UT_ProcessScheduling, test_parseCpuList)
+{
+    EXPECT_EQ(ProcessScheduling::parseCpuList("0-3,8\n"), QVector<int>({0, 1, 2, 3, 8}));
+    EXPECT_EQ(ProcessScheduling::parseCpuList("5, 1"), QVector<int>({1, 5}));
+    EXPECT_EQ(ProcessScheduling::parseCpuList("2-2,1-3"), QVector<int>({1, 2, 3}));
+    EXPECT_TRUE(ProcessScheduling::parseCpuList("").isEmpty());
+    EXPECT_TRUE(ProcessScheduling::parseCpuList("3-1").isEmpty());
+    EXPECT_TRUE(ProcessScheduling::parseCpuList("0-1-2").isEmpty());
+    EXPECT_TRUE(ProcessScheduling::parseCpuList("a").isEmpty());
+    EXPECT_TRUE(ProcessScheduling::parseCpuList("-1").isEmpty());
+}
+
+TEST(UT_ProcessScheduling, test_cpuMask)
+{
+    // whole longs
+    const QByteArray mask = ProcessScheduling::cpuMask({0, 3, 9});
+    ASSERT_EQ(mask.size(), int(sizeof(unsigned long)));
+    EXPECT_EQ(uchar(mask[0]), 0x09);
+    EXPECT_EQ(uchar(mask[1]), 0x02);
+    EXPECT_EQ(processAffinityCpus(mask.constData(), size_t(mask.size())), 3);
+
+    EXPECT_EQ(ProcessScheduling::cpuMask({64}).size(), int(sizeof(unsigned long)) * (64 / 8 / int(sizeof(unsigned long)) + 1));
+    EXPECT_TRUE(ProcessScheduling::cpuMask({}).isEmpty());
+    EXPECT_EQ(processAffinityCpus(nullptr, 0), -1);
+}
+
+TEST(UT_ProcessScheduling, test_ioPriority)
+{
+    const int ioprio = ProcessScheduling::ioPriority(ProcessScheduling::kIOClassBestEffort, 4);
+    EXPECT_EQ(ioprio, 2 << PROCESS_CONTROL_IOPRIO_CLASS_SHIFT | 4);
+    EXPECT_TRUE(processControlValid(PROCESS_CONTROL_IONICE, ioprio));
+    // no level for idle
+    EXPECT_TRUE(processControlValid(PROCESS_CONTROL_IONICE, ProcessScheduling::ioPriority(ProcessScheduling::kIOClassIdle, 4)));
+    EXPECT_EQ(ProcessScheduling::ioPriority(ProcessScheduling::kIOClassRealtime, 9) & 7, 7);
+}
+
+TEST_F(UT_ProcessSchedulingCpuset, test_readCpuset_v2)
+{
+    // the controller isn't enabled for the leaf, its parent gives the cpus
+    writeFile("/cpuset.cpus.effective", "0-7\n");
+    writeFile("/pinned.slice/cpuset.cpus.effective", "2-3\n");
+    QDir().mkpath(m_root + "/pinned.slice/app.scope");
+
+    QString path;
+    QVector<int> cpus;
+    ASSERT_TRUE(ProcessScheduling::readCpuset("0::/pinned.slice/app.scope\n", m_root, path, cpus));
+    EXPECT_EQ(path, QString("/pinned.slice"));
+    EXPECT_EQ(cpus, QVector<int>({2, 3}));
+
+    ASSERT_TRUE(ProcessScheduling::readCpuset("0::/other.slice\n", m_root, path, cpus));
+    EXPECT_TRUE(path.isEmpty());
+    EXPECT_EQ(cpus.size(), 8);
+}
+
+TEST_F(UT_ProcessSchedulingCpuset, test_readCpuset_v1)
+{
+    writeFile("/cpuset/rt/cpuset.effective_cpus", "1\n");
+
+    QString path;
+    QVector<int> cpus;
+    ASSERT_TRUE(ProcessScheduling::readCpuset("12:memory:/x\n4:cpuset,cpu:/rt\n", m_root, path, cpus));
+    EXPECT_EQ(path, QString("/rt"));
+    EXPECT_EQ(cpus, QVector<int>({1}));
+    EXPECT_FALSE(ProcessScheduling::readCpuset("12:memory:/x\n", m_root, path, cpus));
+}
+
+TEST(UT_ProcessScheduling, test_read)
+{
+    ProcessScheduling::scheduling_t sched;
+    ASSERT_TRUE(ProcessScheduling::read(getpid(), sched));
+    EXPECT_FALSE(sched.affinity.isEmpty());
+    EXPECT_GE(sched.ioClass, 0);
+}
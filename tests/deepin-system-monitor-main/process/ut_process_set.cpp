@@ -101,7 +101,7 @@ TEST_F(UT_ProcessSet, test_advance_001)
 TEST_F(UT_ProcessSet, test_getRecentProcStage_001)
 {
     pid_t pid = getpid();
-    m_tester->getRecentProcStage(pid);
+    m_tester->getRecentProcStage(pid, 0);
 
 }
 
@@ -118,6 +118,64 @@ TEST_F(UT_ProcessSet, test_getPIDList_001)
 
 }
 
+TEST_F(UT_ProcessSet, test_getProcessTree_001)
+{
+    m_tester->m_tree = ProcessTree();
+    m_tester->m_tree.insert(11, 10);
+    m_tester->m_tree.insert(12, 10);
+    m_tester->m_tree.insert(13, 11);
+    // reused pid pointing back at the root
+    m_tester->m_tree.insert(10, 13);
+    m_tester->m_tree.insert(21, 20);
+    m_tester->publishSnapshot();
+
+    QList<pid_t> tree = m_tester->getProcessTree(10);
+    ASSERT_EQ(tree.size(), 4);
+    EXPECT_EQ(tree.first(), 10);
+    EXPECT_EQ(tree.last(), 13);
+    EXPECT_FALSE(tree.contains(21));
+
+    EXPECT_EQ(m_tester->getProcessTree(21), QList<pid_t>({21}));
+}
+
+TEST_F(UT_ProcessSet, test_publishSnapshot_001)
+{
+    quint64 generation = m_tester->snapshot()->generation;
+    m_tester->m_set.clear();
+    m_tester->m_set.insert(20, Process(20));
+    m_tester->m_set.insert(10, Process(10));
+    Process scanned = m_tester->m_set.value(10);
+    m_tester->publishSnapshot();
+
+    const ProcessSnapshotPtr snapshot = m_tester->snapshot();
+    EXPECT_EQ(snapshot->generation, generation + 1);
+    EXPECT_EQ(snapshot->pids, QList<pid_t>({10, 20}));
+    EXPECT_EQ(m_tester->getPIDList(), snapshot->pids);
+
+    // writes of the next scan don't reach published processes
+    scanned.setState('Z');
+    EXPECT_NE(snapshot->processes.value(10).state(), 'Z');
+}
+
+TEST_F(UT_ProcessSet, test_updateSnapshot_001)
+{
+    m_tester->m_set.clear();
+    m_tester->m_set.insert(10, Process(10));
+    m_tester->m_set.insert(20, Process(20));
+    m_tester->publishSnapshot();
+    const ProcessSnapshotPtr held = m_tester->snapshot();
+
+    m_tester->updateProcessState(10, 'T');
+    m_tester->removeProcess(20);
+    EXPECT_EQ(m_tester->getProcessById(10).state(), 'T');
+    EXPECT_EQ(m_tester->getPIDList(), QList<pid_t>({10}));
+
+    // readers keep the generation they hold
+    EXPECT_NE(held->processes.value(10).state(), 'T');
+    EXPECT_EQ(held->pids, QList<pid_t>({10, 20}));
+    EXPECT_EQ(m_tester->snapshot()->generation, held->generation);
+}
+
 TEST_F(UT_ProcessSet, test_removeProcess_001)
 {
     pid_t pid = getpid();
@@ -135,3 +193,118 @@ TEST_F(UT_ProcessSet, test_updateProcessPriority_001)
     pid_t pid = getpid();
     m_tester->updateProcessPriority(pid,0);
 }
+
+TEST_F(UT_ProcessSet, test_nextPid_001)
+{
+    ProcessSet::Iterator *it = new ProcessSet::Iterator();
+    if (it->hasNext())
+        EXPECT_GT(it->nextPid(), 0);
+    delete it;
+}
+
+TEST_F(UT_ProcessSet, test_diffPidSets_001)
+{
+    QSet<pid_t> prev {100, 101, 102};
+    QList<pid_t> cur {101, 102, 103, 104};
+
+    PidSetDiff diff = ProcessSet::diffPidSets(prev, cur);
+    EXPECT_TRUE(diff.changed());
+    EXPECT_EQ(diff.spawned, QList<pid_t>({103, 104}));
+    EXPECT_EQ(diff.exited, QList<pid_t>({100}));
+    EXPECT_EQ(diff.survived, QList<pid_t>({101, 102}));
+}
+
+TEST_F(UT_ProcessSet, test_diffPidSets_002)
+{
+    QSet<pid_t> prev {100, 101};
+    QList<pid_t> cur {100, 101};
+
+    PidSetDiff diff = ProcessSet::diffPidSets(prev, cur);
+    EXPECT_FALSE(diff.changed());
+    EXPECT_EQ(diff.survived.size(), 2);
+}
+
+TEST_F(UT_ProcessSet, test_isAppCgroup_001)
+{
+    EXPECT_TRUE(ProcessSet::isAppCgroup("/user.slice/user-1000.slice/user@1000.service/app.slice/app-dde-deepin\\x2dterminal-1234.scope"));
+    EXPECT_TRUE(ProcessSet::isAppCgroup("/system.slice/docker-0123abcd.scope"));
+    EXPECT_TRUE(ProcessSet::isAppCgroup("/system.slice/cups.service"));
+    EXPECT_FALSE(ProcessSet::isAppCgroup("/user.slice/user-1000.slice/session-2.scope"));
+    EXPECT_FALSE(ProcessSet::isAppCgroup("/user.slice/user-1000.slice/user@1000.service/init.scope"));
+    EXPECT_FALSE(ProcessSet::isAppCgroup("/user.slice"));
+    EXPECT_FALSE(ProcessSet::isAppCgroup(""));
+}
+
+TEST_F(UT_ProcessSet, test_mergeAppCgroups_001)
+{
+    // process tree grouping unless asked for
+    m_tester->m_grouping = kGroupByProcessTree;
+    EXPECT_TRUE(m_tester->mergeAppCgroups().isEmpty());
+}
+
+namespace {
+
+QByteArray processInfoDelta(quint64 generation, uint32_t flags, const QList<int32_t> &changed, const QList<int32_t> &exited)
+{
+    process_info_delta_header_t hdr {};
+    hdr.magic = PROCESS_INFO_DELTA_MAGIC;
+    hdr.version = PROCESS_INFO_DELTA_VERSION;
+    hdr.record_size = sizeof(process_info_record_t);
+    hdr.generation = generation;
+    hdr.flags = flags;
+    hdr.count = uint32_t(changed.size());
+    hdr.exited = uint32_t(exited.size());
+
+    QByteArray delta(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+    for (int32_t pid : changed) {
+        process_info_record_t rec {};
+        rec.pid = pid;
+        rec.utime = quint64(pid) * generation;
+        delta.append(reinterpret_cast<const char *>(&rec), sizeof(rec));
+    }
+    for (int32_t pid : exited)
+        delta.append(reinterpret_cast<const char *>(&pid), sizeof(pid));
+    return delta;
+}
+
+} // namespace
+
+TEST_F(UT_ProcessSet, test_applyProcessInfoDelta_001)
+{
+    QHash<pid_t, process_info_record_t> records;
+    quint64 generation = 0;
+
+    ASSERT_TRUE(ProcessSet::applyProcessInfoDelta(processInfoDelta(1, kProcessInfoDeltaBaseline, {100, 101, 102}, {}), records, generation));
+    EXPECT_EQ(generation, 1u);
+    EXPECT_EQ(records.size(), 3);
+
+    // changed record replaced in place, exited one dropped, new one added
+    ASSERT_TRUE(ProcessSet::applyProcessInfoDelta(processInfoDelta(2, 0, {101, 103}, {100}), records, generation));
+    EXPECT_EQ(generation, 2u);
+    EXPECT_EQ(records.size(), 3);
+    EXPECT_FALSE(records.contains(100));
+    EXPECT_EQ(records[101].utime, 202u);
+    EXPECT_EQ(records[102].utime, 102u);
+    EXPECT_TRUE(records.contains(103));
+
+    // a baseline replaces everything
+    ASSERT_TRUE(ProcessSet::applyProcessInfoDelta(processInfoDelta(7, kProcessInfoDeltaBaseline, {200}, {}), records, generation));
+    EXPECT_EQ(generation, 7u);
+    EXPECT_EQ(records.size(), 1);
+}
+
+TEST_F(UT_ProcessSet, test_applyProcessInfoDelta_002)
+{
+    QHash<pid_t, process_info_record_t> records;
+    quint64 generation = 0;
+    ASSERT_TRUE(ProcessSet::applyProcessInfoDelta(processInfoDelta(1, kProcessInfoDeltaBaseline, {100}, {}), records, generation));
+
+    // a lost delta resets state so that the next request gets a baseline
+    EXPECT_FALSE(ProcessSet::applyProcessInfoDelta(processInfoDelta(3, 0, {101}, {}), records, generation));
+    EXPECT_EQ(generation, 0u);
+    EXPECT_TRUE(records.isEmpty());
+
+    QByteArray truncated = processInfoDelta(1, kProcessInfoDeltaBaseline, {100}, {});
+    truncated.chop(1);
+    EXPECT_FALSE(ProcessSet::applyProcessInfoDelta(truncated, records, generation));
+}
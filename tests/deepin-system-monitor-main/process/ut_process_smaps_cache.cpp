@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/process_smaps_cache.h"
+#include "process/process.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//qt
+#include <QFile>
+
+#include <string.h>
+#include <unistd.h>
+
+using namespace core::process;
+
+class UT_ProcessSmapsCache : public ::testing::Test
+{
+public:
+    UT_ProcessSmapsCache() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = ProcessSmapsCache::instance();
+        m_tester->clear();
+        m_tester->setEnabled(true);
+    }
+
+    virtual void TearDown()
+    {
+        m_tester->setEnabled(false);
+        m_tester->setVisiblePids({});
+        m_tester->clear();
+    }
+
+protected:
+    // pids past pid_max, never read successfully
+    static QMap<pid_t, Process> makeSet(int count)
+    {
+        QMap<pid_t, Process> set;
+        for (int i = 0; i < count; ++i) {
+            pid_t pid = (1 << 22) + i;
+            set.insert(pid, Process(pid));
+        }
+        return set;
+    }
+
+    ProcessSmapsCache *m_tester;
+};
+
+TEST_F(UT_ProcessSmapsCache, test_parseSmapsRollup)
+{
+    const char rollup[] = "55a2af68a000-7ffcb55e7000 ---p 00000000 00:00 0                          [rollup]\n"
+                          "Rss:                1412 kB\n"
+                          "Pss:                 475 kB\n"
+                          "Pss_Anon:            104 kB\n"
+                          "Shared_Clean:       1268 kB\n"
+                          "Private_Clean:        40 kB\n"
+                          "Private_Dirty:       104 kB\n"
+                          "Private_Hugetlb:       0 kB\n"
+                          "Swap:                 12 kB\n"
+                          "SwapPss:               6 kB\n";
+    smaps_t smaps;
+    ASSERT_TRUE(ProcessSmapsCache::parseSmapsRollup(rollup, strlen(rollup), smaps));
+    EXPECT_EQ(smaps.pss, 475u);
+    EXPECT_EQ(smaps.uss, 144u);
+    EXPECT_EQ(smaps.swap, 12u);
+
+    const char header[] = "55a2af68a000-7ffcb55e7000 ---p 00000000 00:00 0 [rollup]\n";
+    EXPECT_FALSE(ProcessSmapsCache::parseSmapsRollup(header, strlen(header), smaps));
+}
+
+TEST_F(UT_ProcessSmapsCache, test_refresh_disabled)
+{
+    m_tester->setEnabled(false);
+    EXPECT_EQ(m_tester->refresh(makeSet(4), 0), 0);
+    EXPECT_EQ(m_tester->count(), 0);
+}
+
+TEST_F(UT_ProcessSmapsCache, test_refresh_round_robin)
+{
+    const QMap<pid_t, Process> set = makeSet(20);
+    const pid_t last = set.lastKey();
+    m_tester->setVisiblePids({last});
+
+    // a few processes per refresh, the visible one first
+    EXPECT_EQ(m_tester->refresh(set, 0), int(ProcessSmapsCache::kRefreshPerScan));
+    EXPECT_FALSE(m_tester->isDue(last, 0, 0, ProcessSmapsCache::kRefreshAge));
+    EXPECT_EQ(m_tester->refresh(set, 0), int(ProcessSmapsCache::kRefreshPerScan));
+    EXPECT_EQ(m_tester->refresh(set, 0), 20 - 2 * int(ProcessSmapsCache::kRefreshPerScan));
+    EXPECT_EQ(m_tester->count(), 20);
+
+    // everything read until the figures get old
+    EXPECT_EQ(m_tester->refresh(set, 1000), 0);
+    EXPECT_EQ(m_tester->refresh(set, ProcessSmapsCache::kRefreshAge), int(ProcessSmapsCache::kRefreshPerScan));
+
+    // failed reads are not reported
+    smaps_t smaps;
+    EXPECT_FALSE(m_tester->lookup(last, 0, smaps));
+    m_tester->remove(last);
+    EXPECT_EQ(m_tester->count(), 19);
+}
+
+TEST_F(UT_ProcessSmapsCache, test_refresh_self)
+{
+    QMap<pid_t, Process> set;
+    set.insert(getpid(), Process(getpid()));
+    EXPECT_EQ(m_tester->refresh(set, 0), 1);
+
+    smaps_t smaps;
+    if (QFile::exists("/proc/self/smaps_rollup")) {
+        ASSERT_TRUE(m_tester->lookup(getpid(), 0, smaps));
+        EXPECT_GT(smaps.pss, 0u);
+    }
+}
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/process_tree.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+using namespace core::process;
+
+TEST(UT_ProcessTree, test_insert_001)
+{
+    ProcessTree tree;
+    tree.insert(10, 1);
+    tree.insert(11, 10);
+    tree.insert(12, 10);
+    EXPECT_EQ(tree.size(), 3);
+    EXPECT_EQ(tree.parentOf(11), 10);
+    EXPECT_EQ(tree.children(10), QVector<pid_t>({11, 12}));
+    // children of processes not scanned are linked too
+    EXPECT_EQ(tree.children(1), QVector<pid_t>({10}));
+
+    // reparented to a subreaper
+    tree.insert(12, 1);
+    EXPECT_EQ(tree.children(10), QVector<pid_t>({11}));
+    EXPECT_EQ(tree.children(1), QVector<pid_t>({10, 12}));
+
+    tree.remove(10);
+    EXPECT_FALSE(tree.contains(10));
+    EXPECT_EQ(tree.children(1), QVector<pid_t>({12}));
+    EXPECT_EQ(tree.parentOf(11), 10);
+}
+
+TEST(UT_ProcessTree, test_accumulate_001)
+{
+    ProcessTree tree;
+    tree.insert(10, 1);
+    tree.insert(11, 10);
+    tree.insert(13, 11);
+    tree.insert(20, 1);
+    tree.setUsage(10, {1., 100, 0., 0., 1});
+    tree.setUsage(11, {2., 200, 10., 20., 1});
+    tree.setUsage(13, {4., 400, 0., 0., 1});
+    tree.setUsage(20, {8., 800, 0., 0., 1});
+    tree.accumulate();
+
+    ProcessTreeUsage usage = tree.subtreeUsage(10);
+    EXPECT_DOUBLE_EQ(usage.cpu, 7.);
+    EXPECT_EQ(usage.memory, 700u);
+    EXPECT_DOUBLE_EQ(usage.sentBps, 20.);
+    EXPECT_EQ(usage.processes, 3);
+    EXPECT_EQ(tree.subtreeUsage(20).processes, 1);
+
+    // totals follow own usage of the next scan, links unchanged
+    tree.setUsage(13, {0., 400, 0., 0., 1});
+    tree.remove(20);
+    tree.accumulate();
+    EXPECT_DOUBLE_EQ(tree.subtreeUsage(10).cpu, 3.);
+    EXPECT_EQ(tree.subtreeUsage(20).processes, 0);
+}
+
+TEST(UT_ProcessTree, test_accumulate_002)
+{
+    ProcessTree tree;
+    // reused pids pointing at each other
+    tree.insert(10, 11);
+    tree.insert(11, 10);
+    tree.setUsage(10, {1., 0, 0., 0., 1});
+    tree.setUsage(11, {2., 0, 0., 0., 1});
+    tree.accumulate();
+    EXPECT_DOUBLE_EQ(tree.subtreeUsage(10).cpu, 1.);
+    EXPECT_EQ(tree.subtree(10), QList<pid_t>({10, 11}));
+}
+
+TEST(UT_ProcessTree, test_anyAncestor_001)
+{
+    ProcessTree tree;
+    tree.insert(10, 1);
+    tree.insert(11, 10);
+    tree.insert(12, 11);
+    EXPECT_TRUE(tree.anyAncestor(12, [](pid_t pid) { return pid == 10; }));
+    EXPECT_FALSE(tree.anyAncestor(10, [](pid_t pid) { return pid == 11; }));
+}
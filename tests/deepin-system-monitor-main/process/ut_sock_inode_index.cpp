@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/sock_inode_index.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace core::process;
+
+class UT_SockInodeIndex : public ::testing::Test
+{
+public:
+    UT_SockInodeIndex() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new SockInodeIndex();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    SockInodeIndex *m_tester;
+};
+
+TEST_F(UT_SockInodeIndex, test_scanSockInodes_001)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    struct stat sbuf {};
+    ASSERT_EQ(fstat(fd, &sbuf), 0);
+
+    QList<ino_t> inodes;
+    EXPECT_TRUE(SockInodeIndex::scanSockInodes(getpid(), inodes));
+    EXPECT_TRUE(inodes.contains(sbuf.st_ino));
+
+    // dup'ed fd shares inode
+    int dupfd = dup(fd);
+    inodes.clear();
+    EXPECT_TRUE(SockInodeIndex::scanSockInodes(getpid(), inodes));
+    EXPECT_EQ(inodes.count(sbuf.st_ino), 1);
+
+    close(dupfd);
+    close(fd);
+}
+
+TEST_F(UT_SockInodeIndex, test_scanSockInodes_002)
+{
+    QList<ino_t> inodes;
+    // no such pid
+    EXPECT_FALSE(SockInodeIndex::scanSockInodes(-1, inodes));
+    EXPECT_TRUE(inodes.isEmpty());
+}
+
+TEST_F(UT_SockInodeIndex, test_sockInodes_001)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    struct stat sbuf {};
+    ASSERT_EQ(fstat(fd, &sbuf), 0);
+
+    QList<ino_t> inodes = m_tester->sockInodes(getpid());
+    EXPECT_TRUE(inodes.contains(sbuf.st_ino));
+    EXPECT_EQ(m_tester->count(), 1);
+
+    m_tester->release(getpid());
+    EXPECT_EQ(m_tester->count(), 0);
+
+    EXPECT_TRUE(m_tester->sockInodes(-1).isEmpty());
+    EXPECT_EQ(m_tester->count(), 0);
+    close(fd);
+}
+
+TEST_F(UT_SockInodeIndex, test_scanSockInodes_003)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+
+    QList<ino_t> inodes;
+    fd_stats_t stats;
+    ASSERT_TRUE(SockInodeIndex::scanSockInodes(getpid(), inodes, &stats));
+    EXPECT_GE(stats.fds, 4);
+    EXPECT_GE(stats.sockets, 1);
+
+    // dup'ed fds are counted each, unlike inodes
+    int dupfd = dup(fd);
+    fd_stats_t dupStats;
+    inodes.clear();
+    ASSERT_TRUE(SockInodeIndex::scanSockInodes(getpid(), inodes, &dupStats));
+    EXPECT_EQ(dupStats.fds, stats.fds + 1);
+    EXPECT_EQ(dupStats.sockets, stats.sockets + 1);
+
+    // unreadable fd dir
+    EXPECT_TRUE(m_tester->sockInodes(-1, &stats).isEmpty());
+    EXPECT_EQ(stats.fds, -1);
+    EXPECT_EQ(stats.sockets, 0);
+
+    close(dupfd);
+    close(fd);
+}
@@ -0,0 +1,39 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "service/journal_tail.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//qt
+#include <QSignalSpy>
+
+TEST(UT_JournalTail, test_matchesOf_001)
+{
+    const QList<QByteArray> matches = JournalTail::matchesOf("dbus.service");
+    ASSERT_EQ(matches.size(), 4);
+    EXPECT_EQ(matches[0], QByteArray("_SYSTEMD_UNIT=dbus.service"));
+    // disjunction, then the messages of systemd about the unit
+    EXPECT_TRUE(matches[1].isEmpty());
+    EXPECT_EQ(matches[2], QByteArray("_PID=1"));
+    EXPECT_EQ(matches[3], QByteArray("UNIT=dbus.service"));
+}
+
+TEST(UT_JournalTail, test_follow_001)
+{
+    // the build environment may have no journal, nothing must come of a unit that doesn't exist
+    JournalTail tail;
+    QSignalSpy spy(&tail, &JournalTail::linesAppended);
+    tail.follow("ut-journal-tail-missing.service");
+    EXPECT_TRUE(tail.isFollowing());
+    EXPECT_EQ(tail.unit(), QString("ut-journal-tail-missing.service"));
+    spy.wait(3 * JournalTail::kDeliverInterval);
+    EXPECT_EQ(spy.count(), 0);
+
+    tail.follow("ut-journal-tail-other.service");
+    tail.stop();
+    EXPECT_FALSE(tail.isFollowing());
+}
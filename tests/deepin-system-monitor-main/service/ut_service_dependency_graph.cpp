@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "service/service_dependency_graph.h"
+#include "gui/service_dependency_dialog.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+class UT_ServiceDependencyGraph : public ::testing::Test
+{
+protected:
+    ServiceDependencyGraph m_tester;
+};
+
+TEST_F(UT_ServiceDependencyGraph, test_nodeFromProperties_001)
+{
+    QVariantMap unitProps {
+        {"Description", "D-Bus System Message Bus"},
+        {"ActiveState", "active"},
+        {"Requires", QStringList {"dbus.socket", "sysinit.target"}},
+        {"Wants", QStringList {}},
+        {"After", QStringList {"dbus.socket", "basic.target"}},
+        {"InactiveExitTimestampMonotonic", qulonglong(1000000)},
+        {"ActiveEnterTimestampMonotonic", qulonglong(1250000)},
+    };
+    QVariantMap serviceProps {{"ExecMainStartTimestampMonotonic", qulonglong(1100000)}};
+
+    DependencyNode node = ServiceDependencyGraph::nodeFromProperties("dbus.service", unitProps, serviceProps);
+    EXPECT_EQ(node.unit, QString("dbus.service"));
+    EXPECT_EQ(node.activeState, QString("active"));
+    EXPECT_EQ(node.requires, QStringList({"dbus.socket", "sysinit.target"}));
+    EXPECT_TRUE(node.wants.isEmpty());
+    EXPECT_EQ(node.after.size(), 2);
+    // measured from exec of the main process
+    EXPECT_EQ(node.startupUsec, 150000);
+
+    // units other than services start at leaving the inactive state
+    node = ServiceDependencyGraph::nodeFromProperties("dbus.socket", unitProps, {});
+    EXPECT_EQ(node.startupUsec, 250000);
+}
+
+TEST_F(UT_ServiceDependencyGraph, test_startupDuration_001)
+{
+    EXPECT_EQ(ServiceDependencyGraph::startupDuration(0, 0, 0), -1);
+    // restarted & not active yet
+    EXPECT_EQ(ServiceDependencyGraph::startupDuration(0, 2000, 1000), -1);
+    EXPECT_EQ(ServiceDependencyGraph::startupDuration(0, 1000, 3000), 2000);
+}
+
+TEST_F(UT_ServiceDependencyGraph, test_invalidate_001)
+{
+    m_tester.m_nodes.insert("dbus.service", DependencyNode {});
+    ASSERT_NE(m_tester.node("dbus.service"), nullptr);
+    m_tester.invalidate("dbus.service");
+    EXPECT_EQ(m_tester.node("dbus.service"), nullptr);
+
+    // changed while asked for, asked again once answered
+    m_tester.m_pendingUnits << "foo.service";
+    m_tester.invalidate("foo.service");
+    EXPECT_TRUE(m_tester.m_staleUnits.contains("foo.service"));
+}
+
+TEST_F(UT_ServiceDependencyGraph, test_formatStartup_001)
+{
+    EXPECT_TRUE(ServiceDependencyDialog::formatStartup(-1).isEmpty());
+    EXPECT_EQ(ServiceDependencyDialog::formatStartup(150000), QString("150ms"));
+    EXPECT_EQ(ServiceDependencyDialog::formatStartup(2500000), QString("2.500s"));
+}
@@ -5,6 +5,7 @@
 
 //self
 #include "service/service_manager_worker.h"
+#include "service/system_service_entry.h"
 
 //gtest
 #include "stub.h"
@@ -72,3 +73,41 @@ TEST_F(UT_ServiceManagerWorker, test_startJob_01)
 {
     m_tester->startJob();
 }
+
+TEST_F(UT_ServiceManagerWorker, test_applyUnitProperties_01)
+{
+    QVariantMap unitProps {{"Id", "test.service"}, {"CanStart", true}, {"CanStop", false},
+                           {"CanReload", true}, {"ActiveState", "active"}, {"Description", "Test"}};
+    QVariantMap serviceProps {{"MainPID", 42u}};
+
+    SystemServiceEntry entry {};
+    entry.setActiveState("inactive");
+    ServiceManagerWorker::applyUnitProperties(entry, unitProps, serviceProps, false);
+    EXPECT_EQ(entry.getId(), "test.service");
+    EXPECT_TRUE(entry.getCanStart());
+    EXPECT_FALSE(entry.getCanStop());
+    EXPECT_TRUE(entry.getCanReload());
+    EXPECT_EQ(entry.getMainPID(), 42u);
+    // states of listed units are kept
+    EXPECT_EQ(entry.getActiveState(), "inactive");
+
+    ServiceManagerWorker::applyUnitProperties(entry, unitProps, {}, true);
+    EXPECT_EQ(entry.getActiveState(), "active");
+    EXPECT_EQ(entry.getDescription(), "Test");
+    EXPECT_EQ(entry.getMainPID(), 42u);
+}
+
+TEST_F(UT_ServiceManagerWorker, test_prioritize_01)
+{
+    m_tester->m_requests.clear();
+    for (const auto &sname : {"a", "b", "c", "d"})
+        m_tester->m_requests << ServiceManagerWorker::UnitPropertiesRequest {sname, {}, {}, false};
+
+    // asked ones first, in list order, the others behind
+    m_tester->prioritize({"d", "b"});
+    ASSERT_EQ(m_tester->m_requests.size(), 4);
+    EXPECT_EQ(m_tester->m_requests[0].sname, "b");
+    EXPECT_EQ(m_tester->m_requests[1].sname, "d");
+    EXPECT_EQ(m_tester->m_requests[2].sname, "a");
+    EXPECT_EQ(m_tester->m_requests[3].sname, "c");
+}
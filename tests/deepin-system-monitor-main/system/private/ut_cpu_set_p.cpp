@@ -84,8 +84,14 @@ TEST_F(UT_CPUSetPrivate, test_cpoy)
                                 usage->total = stat->user + stat->nice + stat->sys + stat->idle + stat->iowait + stat->hardirq + stat->softirq + stat->steal;
                                 usage->idle = stat->idle + stat->iowait;
 
-                                m_tester->m_statDB[stat->cpu] = stat;
-                                m_tester->m_usageDB[usage->cpu] = usage;
+                                if (ncpu >= m_tester->m_cpuNames.size()) {
+                                    m_tester->m_cpuNames.resize(ncpu + 1);
+                                    m_tester->m_cpuJiffies[kCurrentStat].resize(ncpu + 1);
+                                }
+                                m_tester->m_cpuNames[ncpu] = stat->cpu;
+                                m_tester->m_cpuJiffies[kCurrentStat].user[size_t(ncpu)] = stat->user;
+                                m_tester->m_cpuJiffies[kCurrentStat].idle[size_t(ncpu)] = stat->idle;
+                                m_tester->m_cpuIds << ncpu;
 
                                 QList<CPUInfo> infos{};
                                 CPUInfo info{};
@@ -99,6 +105,9 @@ TEST_F(UT_CPUSetPrivate, test_cpoy)
     }
 
     CPUSetPrivate copy(*m_tester);
+    EXPECT_EQ(copy.m_cpuIds, m_tester->m_cpuIds);
+    EXPECT_EQ(copy.m_cpuNames, m_tester->m_cpuNames);
+    EXPECT_EQ(copy.m_cpuJiffies[kCurrentStat].user, m_tester->m_cpuJiffies[kCurrentStat].user);
 }
 
 
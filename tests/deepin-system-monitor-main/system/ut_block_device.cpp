@@ -149,6 +149,63 @@ TEST_F(UT_BlockDevice, test_calcDiskIoStates)
      }
 }
 
+TEST_F(UT_BlockDevice, test_updateStat_01)
+{
+    // read ios, read merges, read sectors, read ticks, write ios, write merges, write sectors, ...
+    quint64 stat[15] = {100, 10, 2000, 0, 50, 5, 1000, 0, 0, 0, 0, 0, 0, 400, 0};
+    m_tester->updateStat(stat, 15);
+    EXPECT_EQ(m_tester->readIssuer(), 100ull);
+    EXPECT_EQ(m_tester->readMerged(), 10ull);
+    EXPECT_EQ(m_tester->blocksRead(), 2000ull);
+    EXPECT_EQ(m_tester->writeComplete(), 50ull);
+    EXPECT_EQ(m_tester->writeMerged(), 5ull);
+    EXPECT_EQ(m_tester->blocksWritten(), 1000ull);
+    EXPECT_EQ(m_tester->transferPerSecond(), 150ull);
+    EXPECT_EQ(m_tester->d->discard_sector, 400ull);
+}
+
+TEST_F(UT_BlockDevice, test_updateStat_02)
+{
+    // kernels before 4.18 have no discard stats
+    quint64 stat[11] = {100, 10, 2000, 0, 50, 5, 1000, 0, 0, 0, 0};
+    m_tester->updateStat(stat, 11);
+    EXPECT_EQ(m_tester->readIssuer(), 100ull);
+    EXPECT_EQ(m_tester->d->discard_sector, 0ull);
+
+    // too few fields are ignored
+    quint64 shortStat[4] = {1, 1, 1, 1};
+    m_tester->updateStat(shortStat, 4);
+    EXPECT_EQ(m_tester->readIssuer(), 100ull);
+}
+
+TEST_F(UT_BlockDevice, test_calcIoLatency)
+{
+    // baseline
+    quint64 stat1[15] = {100, 0, 2000, 500, 100, 0, 1000, 300, 2, 400, 900, 10, 0, 800, 100};
+    m_tester->timevalList[1] = timeval{10, 0};
+    m_tester->calcIoLatency(stat1, 15);
+    EXPECT_EQ(m_tester->inFlight(), 2ull);
+    EXPECT_EQ(m_tester->percentUtilization(), 0.);
+
+    m_tester->d->read_iss = stat1[0];
+    m_tester->d->write_com = stat1[4];
+    m_tester->d->discard_sector = stat1[13];
+
+    // 1s later: 100 reads in 200ms, 50 writes in 400ms, 10 discards in 100ms, busy 500ms
+    quint64 stat2[15] = {200, 0, 2000, 700, 150, 0, 1000, 700, 1, 900, 1900, 20, 0, 1000, 200};
+    m_tester->timevalList[0] = timeval{10, 0};
+    m_tester->timevalList[1] = timeval{11, 0};
+    m_tester->calcIoLatency(stat2, 15);
+    EXPECT_DOUBLE_EQ(m_tester->readAwait(), 2.);
+    EXPECT_DOUBLE_EQ(m_tester->writeAwait(), 8.);
+    EXPECT_DOUBLE_EQ(m_tester->await(), 700. / 160);
+    EXPECT_DOUBLE_EQ(m_tester->serviceTime(), 500. / 160);
+    EXPECT_DOUBLE_EQ(m_tester->percentUtilization(), 50.);
+    EXPECT_DOUBLE_EQ(m_tester->queueDepth(), 1.);
+    EXPECT_EQ(m_tester->inFlight(), 1ull);
+    EXPECT_EQ(m_tester->discardSpeed(), 200ull * 512);
+}
+
 TEST_F(UT_BlockDevice, test_deviceName)
 {
     m_tester->deviceName();
@@ -64,3 +64,36 @@ TEST_F(UT_BlockDeviceInfoDB, test_update)
     m_tester->readDiskInfo();
     EXPECT_NE(m_tester->m_deviceList.size(), 0);
 }
+
+TEST_F(UT_BlockDeviceInfoDB, test_update_02)
+{
+    // first update scans inventory, later ones only on udev events
+    m_tester->update();
+    EXPECT_NE(m_tester->m_deviceList.size(), 0);
+    EXPECT_EQ(m_tester->m_pollsSinceScan, 0);
+    m_tester->update();
+    EXPECT_NE(m_tester->m_deviceList.size(), 0);
+}
+
+TEST_F(UT_BlockDeviceInfoDB, test_updateDeviceStats)
+{
+    m_tester->readDiskInfo();
+    // stat fds are opened on scan & kept across refreshes
+    EXPECT_EQ(m_tester->m_statFds.size(), m_tester->m_deviceList.size());
+    QHash<QByteArray, int> fds = m_tester->m_statFds;
+    m_tester->updateDeviceStats();
+    EXPECT_EQ(m_tester->m_statFds, fds);
+}
+
+TEST_F(UT_BlockDeviceInfoDB, test_closeStatFd)
+{
+    m_tester->readDiskInfo();
+    if (m_tester->m_deviceList.isEmpty())
+        return;
+    QByteArray name = m_tester->m_deviceList.first().deviceName();
+    m_tester->closeStatFd(name);
+    EXPECT_FALSE(m_tester->m_statFds.contains(name));
+    // reopened on next read
+    m_tester->updateDeviceStats();
+    EXPECT_TRUE(m_tester->m_statFds.contains(name));
+}
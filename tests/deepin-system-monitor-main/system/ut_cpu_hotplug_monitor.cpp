@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/cpu_hotplug_monitor.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+using namespace core::system;
+
+class UT_CPUHotplugMonitor : public ::testing::Test
+{
+public:
+    UT_CPUHotplugMonitor() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new CPUHotplugMonitor();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    CPUHotplugMonitor *m_tester;
+};
+
+TEST_F(UT_CPUHotplugMonitor, initTest)
+{
+}
+
+TEST_F(UT_CPUHotplugMonitor, test_readOnlineMask)
+{
+    // at least cpu0 is online, e.g. "0-7"
+    EXPECT_FALSE(CPUHotplugMonitor::readOnlineMask().isEmpty());
+}
+
+TEST_F(UT_CPUHotplugMonitor, test_poll_001)
+{
+    if (m_tester->hasUDevMonitor())
+        return;
+
+    // online mask fallback reports a change only once
+    m_tester->m_online = "0";
+    if (CPUHotplugMonitor::readOnlineMask() != "0")
+        EXPECT_TRUE(m_tester->poll());
+    EXPECT_FALSE(m_tester->poll());
+}
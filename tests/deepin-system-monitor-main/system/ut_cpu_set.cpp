@@ -12,10 +12,16 @@
 #include "stub.h"
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+
+#include <string.h>
+
 //qt
 #include <QString>
 #include <QFile>
 #include <QMap>
+#include <QStandardPaths>
 
 using namespace core::system;
 
@@ -243,6 +249,27 @@ TEST_F(UT_CPUSet, test_usageDB)
     EXPECT_NE(cPUUsage->total, 0);
 }
 
+TEST_F(UT_CPUSet, test_cpuUsagePercent)
+{
+    m_tester->update();
+    m_tester->update();
+    QVector<int> ids = m_tester->cpuIds();
+    ASSERT_FALSE(ids.isEmpty());
+    // ascending cpu id order, names stable per id
+    EXPECT_TRUE(std::is_sorted(ids.begin(), ids.end()));
+    EXPECT_EQ(m_tester->cpuStat(ids[0]).cpu, "cpu" + QByteArray::number(ids[0]));
+    EXPECT_NE(m_tester->cpuUsage(ids[0]).total, 0);
+
+    for (int cpu : ids) {
+        qreal percent = m_tester->cpuUsagePercent(cpu);
+        if (!std::isnan(percent)) {
+            EXPECT_GE(percent, 0);
+            EXPECT_LE(percent, 100);
+        }
+    }
+    EXPECT_EQ(m_tester->cpuUsagePercent(-1), 0);
+}
+
 TEST_F(UT_CPUSet, test_update)
 {
     m_tester->update();
@@ -277,11 +304,39 @@ TEST_F(UT_CPUSet, test_read_stats_03)
 
 TEST_F(UT_CPUSet, test_read_overall_info)
 {
-    m_tester->read_overall_info();
+    m_tester->updateOverallInfo();
     QString retString = m_tester->l1iCache();
     EXPECT_NE(retString, "");
 }
 
+TEST_F(UT_CPUSet, test_updateFreq)
+{
+    m_tester->updateOverallInfo();
+    QString snapshot = m_tester->curFreq();
+    m_tester->updateFreq();
+    // sampled from sysfs when cpufreq is available, snapshot kept otherwise
+    if (m_tester->d->m_freqCpus.isEmpty())
+        EXPECT_EQ(m_tester->curFreq(), snapshot);
+    else
+        EXPECT_NE(m_tester->curFreq(), "");
+}
+
+TEST_F(UT_CPUSet, test_coreThrottleEvents)
+{
+    m_tester->d->m_throttleCount[kLastStat] = {10, 5, 7};
+    m_tester->d->m_throttleCount[kCurrentStat] = {12, 5, 3};
+    EXPECT_EQ(m_tester->coreThrottleEvents(0), 2ull);
+    EXPECT_EQ(m_tester->coreThrottleEvents(1), 0ull);
+    // counters reset across suspend
+    EXPECT_EQ(m_tester->coreThrottleEvents(2), 0ull);
+    EXPECT_EQ(m_tester->coreThrottleEvents(3), 0ull);
+    EXPECT_EQ(m_tester->coreThrottleEvents(-1), 0ull);
+
+    m_tester->d->m_coreFreq = {0, 2400000};
+    EXPECT_EQ(m_tester->coreFreq(1), 2400000ull);
+    EXPECT_EQ(m_tester->coreFreq(0), 0ull);
+    EXPECT_EQ(m_tester->coreFreq(5), 0ull);
+}
 
 TEST_F(UT_CPUSet, test_read_lscpu_01)
 {
@@ -324,3 +379,71 @@ TEST_F(UT_CPUSet, test_getUsageTotalDelta_02)
     qulonglong totalDelta = m_tester->getUsageTotalDelta();
     EXPECT_NE(totalDelta, 0);
 }
+
+TEST_F(UT_CPUSet, test_infoCache_001)
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QFile::remove(CPUSet::infoCachePath());
+    EXPECT_FALSE(m_tester->loadInfoCache());
+
+    m_tester->d->m_info.insert("Model name", "Test CPU");
+    m_tester->d->m_info.insert("L2 cache", "4 MiB");
+    m_tester->d->m_numaNodes[0] = {0, 1};
+    m_tester->d->m_freqCpus = {0, 1};
+    m_tester->saveInfoCache();
+
+    CPUSet cpuSet;
+    EXPECT_TRUE(cpuSet.loadInfoCache());
+    EXPECT_EQ(cpuSet.modelName(), "Test CPU");
+    EXPECT_EQ(cpuSet.l2Cache(), "4 MiB");
+    EXPECT_EQ(cpuSet.numaNodes().value(0), QVector<int>({0, 1}));
+    EXPECT_EQ(cpuSet.d->m_freqCpus, QVector<int>({0, 1}));
+
+    QFile::remove(CPUSet::infoCachePath());
+    QStandardPaths::setTestModeEnabled(false);
+}
+
+TEST_F(UT_CPUSet, test_infoCache_002)
+{
+    QStandardPaths::setTestModeEnabled(true);
+    m_tester->d->m_info.insert("Model name", "Test CPU");
+    m_tester->saveInfoCache();
+
+    // written on another boot or kernel
+    QFile file(CPUSet::infoCachePath());
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    QByteArray raw = file.readAll();
+    int at = raw.indexOf(CPUSet::infoCacheKey());
+    ASSERT_GT(at, 0);
+    raw[at] = raw[at] == 'x' ? 'y' : 'x';
+    file.seek(0);
+    file.write(raw);
+    file.close();
+
+    CPUSet cpuSet;
+    EXPECT_FALSE(cpuSet.loadInfoCache());
+
+    QFile::remove(CPUSet::infoCachePath());
+    QStandardPaths::setTestModeEnabled(false);
+}
+
+TEST_F(UT_CPUSet, test_parseSchedStat)
+{
+    const char schedstat[] = "version 15\n"
+                             "timestamp 4295589574\n"
+                             "cpu0 0 0 0 0 0 0 1458462335907 41795022842 2440593\n"
+                             "domain0 00000003 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n"
+                             "cpu2 0 0 0 0 0 0 1392936694404 38204977158 2347914\n";
+    common::usage::CoreSchedStat stat;
+    ASSERT_TRUE(CPUSet::parseSchedStat(schedstat, strlen(schedstat), stat));
+    // indexed by cpu id, the offline cpu1 reads as idle
+    ASSERT_EQ(stat.size(), 3);
+    EXPECT_EQ(stat.runTime[0], 1458462335907ull);
+    EXPECT_EQ(stat.runDelay[0], 41795022842ull);
+    EXPECT_EQ(stat.timeslices[0], 2440593ull);
+    EXPECT_EQ(stat.runDelay[1], 0ull);
+    EXPECT_EQ(stat.runDelay[2], 38204977158ull);
+
+    const char version[] = "version 15\ntimestamp 4295589574\n";
+    EXPECT_FALSE(CPUSet::parseSchedStat(version, strlen(version), stat));
+}
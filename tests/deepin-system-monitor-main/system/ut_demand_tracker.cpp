@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/demand_tracker.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <QObject>
+
+using namespace core::system;
+
+TEST(UT_DemandTracker, test_declare_001)
+{
+    DemandTracker tracker;
+    QObject subscriber;
+    // untracked, e.g. the popup, everything is sampled
+    tracker.declare(&subscriber, DemandTracker::kServiceDemand);
+    EXPECT_EQ(tracker.demands(), int(DemandTracker::kAllDemands));
+
+    tracker.setTracking(true);
+    EXPECT_EQ(tracker.demands(), 0);
+    tracker.setVisible(&subscriber, true);
+    EXPECT_EQ(tracker.demands(), int(DemandTracker::kServiceDemand));
+    EXPECT_TRUE(tracker.isDemanded(DemandTracker::kServiceDemand));
+    EXPECT_FALSE(tracker.isDemanded(DemandTracker::kNetifDemand));
+
+    tracker.setSuspended(true);
+    EXPECT_EQ(tracker.demands(), 0);
+    tracker.setSuspended(false);
+    EXPECT_EQ(tracker.demands(), int(DemandTracker::kServiceDemand));
+}
+
+TEST(UT_DemandTracker, test_declare_002)
+{
+    DemandTracker tracker;
+    tracker.setTracking(true);
+    QObject *subscriber = new QObject;
+    tracker.declare(subscriber, DemandTracker::kCpuCoreDemand);
+    tracker.setVisible(subscriber, true);
+    EXPECT_EQ(tracker.demands(), int(DemandTracker::kCpuCoreDemand));
+
+    // destroyed subscribers stop asking
+    delete subscriber;
+    EXPECT_EQ(tracker.demands(), 0);
+}
+
+TEST(UT_DemandTracker, test_demandsChanged_001)
+{
+    DemandTracker tracker;
+    tracker.setTracking(true);
+    QObject table, detail;
+    tracker.declare(&table, DemandTracker::kProcessNetDemand);
+    tracker.declare(&detail, DemandTracker::kProcessNetDemand | DemandTracker::kNetifDemand);
+    tracker.setVisible(&table, true);
+
+    int changes = 0;
+    int gained = -1;
+    QObject::connect(&tracker, &DemandTracker::demandsChanged, [&](int, int g) {
+        ++changes;
+        gained = g;
+    });
+    tracker.setVisible(&detail, true);
+    EXPECT_EQ(changes, 1);
+    EXPECT_EQ(gained, int(DemandTracker::kNetifDemand));
+
+    // still asked for by the table
+    tracker.setVisible(&detail, false);
+    EXPECT_EQ(changes, 2);
+    EXPECT_EQ(gained, 0);
+    EXPECT_TRUE(tracker.isDemanded(DemandTracker::kProcessNetDemand));
+}
@@ -5,6 +5,7 @@
 
 //self
 #include "system/device_db.h"
+#include "system/device_snapshot.h"
 #include "system/netif_info_db.h"
 #include "system/block_device_info_db.h"
 #include "system/mem.h"
@@ -95,3 +96,24 @@ TEST_F(UT_DeviceDB, test_netInfo)
 }
 
 
+
+TEST_F(UT_DeviceDB, test_snapshot)
+{
+    // never null, even before first publish
+    DeviceSnapshotPtr empty = m_tester->snapshot();
+    ASSERT_NE(empty, nullptr);
+    EXPECT_EQ(empty->memInfo.memTotal(), 0ull);
+
+    m_tester->memInfo()->readMemInfo();
+    m_tester->publishSnapshot();
+    DeviceSnapshotPtr snapshot = m_tester->snapshot();
+    EXPECT_NE(snapshot, empty);
+    EXPECT_EQ(snapshot->memInfo.memTotal(), m_tester->memInfo()->memTotal());
+    EXPECT_EQ(snapshot->blockDevices.size(), m_tester->blockDeviceInfoDB()->deviceList().size());
+
+    // published state is not touched by later updates
+    qulonglong usageTotal = snapshot->cpuSet.usageTotal();
+    m_tester->cpuSet()->updateStats();
+    EXPECT_EQ(snapshot->cpuSet.usageTotal(), usageTotal);
+    EXPECT_EQ(m_tester->snapshot(), snapshot);
+}
@@ -69,3 +69,16 @@ TEST_F(UT_DiskIOInfo, test_update)
     EXPECT_TRUE(m_tester->diskIoReadBps() != 0 || m_tester->diskIoWriteBps() != 0);
 }
 
+
+TEST_F(UT_DiskIOInfo, test_isBlockDevice)
+{
+    m_tester->update();
+    EXPECT_FALSE(m_tester->m_blockDevCache.isEmpty());
+
+    // cached per device number
+    m_tester->m_blockDevCache.insert((quint64(1) << 32) | 2, qMakePair(QByteArray("no-such-dev"), true));
+    EXPECT_TRUE(m_tester->isBlockDevice(1, 2, "no-such-dev"));
+    // device number reused by another device
+    EXPECT_FALSE(m_tester->isBlockDevice(1, 2, "no-such-dev-2"));
+    EXPECT_EQ(m_tester->m_blockDevCache.value((quint64(1) << 32) | 2).first, QByteArray("no-such-dev-2"));
+}
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/filesystem_info_db.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//qt
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+
+using namespace core::system;
+
+static const QByteArray kMountInfo =
+    "22 1 259:2 / / rw,relatime shared:1 - ext4 /dev/nvme0n1p2 rw\n"
+    "23 22 0:21 / /proc rw,nosuid,nodev,noexec,relatime shared:12 - proc proc rw\n"
+    "24 22 0:22 / /sys rw,nosuid,nodev,noexec,relatime shared:2 - sysfs sysfs rw\n"
+    "25 24 0:23 / /sys/fs/cgroup rw,nosuid shared:4 - cgroup2 cgroup2 rw\n"
+    "26 22 0:5 / /dev rw,nosuid shared:8 - devtmpfs udev rw,size=8000000k\n"
+    "27 26 0:24 / /dev/shm rw,nosuid,nodev shared:9 - tmpfs tmpfs rw\n"
+    "28 22 259:1 / /boot/efi rw,relatime shared:10 - vfat /dev/nvme0n1p1 rw\n"
+    "29 22 259:3 / /mnt/My\\040Disk ro,relatime shared:11 - ext4 /dev/nvme0n1p3 ro\n"
+    "30 22 0:50 / /mnt/share rw,relatime shared:13 master:5 - nfs4 server:/export rw,vers=4.2\n"
+    "31 22 259:2 / /srv/bind rw,relatime shared:1 - ext4 /dev/nvme0n1p2 rw\n"
+    "32 22 259:2 /home /home rw,relatime shared:1 - ext4 /dev/nvme0n1p2 rw\n"
+    "33 22 7:0 / /snap/core/1 ro,nodev shared:14 - squashfs /dev/loop0 ro\n"
+    "garbage\n";
+
+TEST(UT_FilesystemInfoDB, test_parseMountInfo)
+{
+    const QList<filesystem_t> filesystems = FilesystemInfoDB::parseMountInfo(kMountInfo);
+    ASSERT_EQ(filesystems.size(), 6);
+
+    EXPECT_EQ(filesystems[0].mountPoint, QString("/"));
+    EXPECT_EQ(filesystems[0].source, QString("/dev/nvme0n1p2"));
+    EXPECT_EQ(filesystems[0].fsType, QString("ext4"));
+    EXPECT_FALSE(filesystems[0].remote);
+    EXPECT_FALSE(filesystems[0].readOnly);
+    EXPECT_FALSE(filesystems[0].hasUsage);
+
+    // the one tmpfs under /dev kept
+    EXPECT_EQ(filesystems[1].mountPoint, QString("/dev/shm"));
+    EXPECT_EQ(filesystems[2].mountPoint, QString("/boot/efi"));
+
+    EXPECT_EQ(filesystems[3].mountPoint, QString("/mnt/My Disk"));
+    EXPECT_TRUE(filesystems[3].readOnly);
+
+    EXPECT_EQ(filesystems[4].mountPoint, QString("/mnt/share"));
+    EXPECT_EQ(filesystems[4].source, QString("server:/export"));
+    EXPECT_TRUE(filesystems[4].remote);
+
+    // a bind mount of the root is left out, a bind mount of a subtree is not
+    EXPECT_EQ(filesystems[5].mountPoint, QString("/home"));
+}
+
+TEST(UT_FilesystemInfoDB, test_unescape)
+{
+    EXPECT_EQ(FilesystemInfoDB::unescape("/plain"), QByteArray("/plain"));
+    EXPECT_EQ(FilesystemInfoDB::unescape("/a\\040b\\011c\\012d\\134e"), QByteArray("/a b\tc\nd\\e"));
+    // not an escape, kept as is
+    EXPECT_EQ(FilesystemInfoDB::unescape("/a\\9b\\04"), QByteArray("/a\\9b\\04"));
+}
+
+TEST(UT_FilesystemInfoDB, test_update)
+{
+    QTemporaryDir dir;
+    QFile file(dir.path() + "/mountinfo");
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("22 1 259:2 / / rw,relatime shared:1 - ext4 /dev/root rw\n"
+               "23 22 0:21 / /proc rw - proc proc rw\n");
+    file.close();
+
+    FilesystemInfoDB db(file.fileName());
+    QList<filesystem_t> filesystems;
+    QElapsedTimer timer;
+    timer.start();
+    // the root is stat'ed in the background, picked up by a later update
+    do {
+        db.update();
+        filesystems = db.filesystems();
+        if (!filesystems.isEmpty() && filesystems[0].hasUsage)
+            break;
+        QThread::msleep(10);
+    } while (timer.elapsed() < FilesystemInfoDB::kStatTimeout);
+
+    ASSERT_EQ(filesystems.size(), 1);
+    EXPECT_EQ(filesystems[0].mountPoint, QString("/"));
+    EXPECT_TRUE(filesystems[0].hasUsage);
+    EXPECT_FALSE(filesystems[0].hung);
+    EXPECT_GT(filesystems[0].total, 0ull);
+    EXPECT_GE(filesystems[0].total, filesystems[0].used);
+}
+
+TEST(UT_FilesystemInfoDB, test_missingMountInfo)
+{
+    FilesystemInfoDB db("/nonexistent/mountinfo");
+    db.update();
+    EXPECT_TRUE(db.filesystems().isEmpty());
+}
@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/gpu_info_db.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//qt
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+using namespace core::system;
+
+class UT_GpuInfoDB : public ::testing::Test
+{
+protected:
+    void writeFile(const QString &path, const QByteArray &content)
+    {
+        QDir().mkpath(QFileInfo(m_dir.path() + "/" + path).path());
+        QFile file(m_dir.path() + "/" + path);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write(content);
+    }
+
+    QTemporaryDir m_dir;
+};
+
+TEST_F(UT_GpuInfoDB, test_update_amdgpu)
+{
+    writeFile("card0/device/gpu_busy_percent", "35\n");
+    writeFile("card0/device/mem_info_vram_used", "1073741824\n");
+    writeFile("card0/device/mem_info_vram_total", "8589934592\n");
+    // connectors are not cards
+    writeFile("card0-DP-1/status", "connected\n");
+
+    GpuInfoDB db(m_dir.path());
+    db.update();
+    const QList<gpu_device_t> devices = db.devices();
+    ASSERT_EQ(devices.size(), 1);
+    EXPECT_EQ(devices[0].name, QString("card0"));
+    EXPECT_TRUE(devices[0].hasUsage);
+    EXPECT_DOUBLE_EQ(devices[0].usage, 35.);
+    EXPECT_TRUE(devices[0].hasMemory);
+    EXPECT_EQ(devices[0].memUsed, 1024ull * 1024);
+    EXPECT_EQ(devices[0].memTotal, 8ull * 1024 * 1024);
+
+    // files are kept open & re-read
+    writeFile("card0/device/gpu_busy_percent", "80\n");
+    db.update();
+    EXPECT_DOUBLE_EQ(db.devices()[0].usage, 80.);
+}
+
+TEST_F(UT_GpuInfoDB, test_update_noUsage)
+{
+    QDir().mkpath(m_dir.path() + "/card1/device");
+    GpuInfoDB db(m_dir.path());
+    db.update();
+    ASSERT_EQ(db.devices().size(), 1);
+    EXPECT_FALSE(db.devices()[0].hasUsage);
+    EXPECT_FALSE(db.devices()[0].hasMemory);
+}
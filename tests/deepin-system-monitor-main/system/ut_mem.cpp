@@ -10,6 +10,9 @@
 #include "stub.h"
 #include <gtest/gtest.h>
 
+#include <errno.h>
+#include <unistd.h>
+
 using namespace core::system;
 
 /***************************************STUB begin*********************************************/
@@ -19,10 +22,10 @@ int stub_sscanf (const char *__restrict __s, const char *__restrict __format, ..
     return 0;
 }
 
-FILE *stub_fopen_mem (const char *__restrict __filename,
- const char *__restrict __modes)
+ssize_t stub_pread_mem(int, void *, size_t, off_t)
 {
-    return nullptr;
+    errno = EIO;
+    return -1;
 }
 
 /***************************************STUB end**********************************************/
@@ -166,6 +169,19 @@ TEST_F(UT_MemInfo, test_readMemInfo_02)
 TEST_F(UT_MemInfo, test_readMemInfo_03)
 {
     Stub stub;
-    stub.set(fopen, stub_fopen_mem);
+    stub.set(pread, stub_pread_mem);
+    m_tester->readMemInfo();
+    EXPECT_EQ(m_tester->memTotal(), 0);
+}
+
+TEST_F(UT_MemInfo, test_readMemInfo_04)
+{
+    m_tester->readMemInfo();
+    qulonglong total = m_tester->memTotal();
+    // reader keeps meminfo open across reads
     m_tester->readMemInfo();
+    EXPECT_EQ(m_tester->memTotal(), total);
+    EXPECT_LE(m_tester->kReclaimable(), m_tester->slab());
+    EXPECT_LE(m_tester->anonHugePages(), total);
+    EXPECT_LE(m_tester->writeback(), total);
 }
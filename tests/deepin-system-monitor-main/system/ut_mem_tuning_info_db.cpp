@@ -0,0 +1,157 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/mem_tuning_info_db.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//qt
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include <string.h>
+
+using namespace core::system;
+
+class UT_MemTuningInfoDB : public ::testing::Test
+{
+protected:
+    void writeFile(const QString &path, const QByteArray &content)
+    {
+        QDir().mkpath(QFileInfo(m_dir.path() + "/" + path).path());
+        QFile file(m_dir.path() + "/" + path);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write(content);
+    }
+
+    QTemporaryDir m_dir;
+};
+
+TEST_F(UT_MemTuningInfoDB, test_selected_mode)
+{
+    EXPECT_EQ(MemTuningInfoDB::selectedMode("always [madvise] never\n"), QString("madvise"));
+    EXPECT_EQ(MemTuningInfoDB::selectedMode("always defer defer+madvise [madvise] never"), QString("madvise"));
+    EXPECT_EQ(MemTuningInfoDB::selectedMode("lzo lzo-rle [zstd]"), QString("zstd"));
+    EXPECT_EQ(MemTuningInfoDB::selectedMode("zstd\n"), QString("zstd"));
+    EXPECT_EQ(MemTuningInfoDB::selectedMode("lzo zstd"), QString());
+    EXPECT_EQ(MemTuningInfoDB::selectedMode(""), QString());
+}
+
+TEST_F(UT_MemTuningInfoDB, test_parse_mm_stat)
+{
+    zram_device_t device;
+    const char line[] = "  8192000  2048000  2150400        0  2150400      120       0      12      0\n";
+    ASSERT_TRUE(MemTuningInfoDB::parseMmStat(line, strlen(line), device));
+    EXPECT_EQ(device.origDataSize, 8192000ull);
+    EXPECT_EQ(device.comprDataSize, 2048000ull);
+    EXPECT_EQ(device.memUsedTotal, 2150400ull);
+    EXPECT_EQ(device.memLimit, 0ull);
+    EXPECT_EQ(device.samePages, 120ull);
+    EXPECT_EQ(device.hugePages, 12ull);
+    EXPECT_NEAR(device.ratio(), 3.81, 0.01);
+
+    // kernels before 4.19 lack huge_pages
+    const char old[] = "4096 1024 2048 0 2048 3 0\n";
+    ASSERT_TRUE(MemTuningInfoDB::parseMmStat(old, strlen(old), device));
+    EXPECT_EQ(device.hugePages, 0ull);
+
+    const char truncated[] = "4096 1024 2048\n";
+    EXPECT_FALSE(MemTuningInfoDB::parseMmStat(truncated, strlen(truncated), device));
+}
+
+TEST_F(UT_MemTuningInfoDB, test_update)
+{
+    writeFile("proc/meminfo", "MemTotal:       16346064 kB\n"
+                              "Zswap:             81920 kB\n"
+                              "Zswapped:         262144 kB\n"
+                              "AnonHugePages:    845824 kB\n"
+                              "ShmemHugePages:     4096 kB\n");
+    writeFile("proc/vmstat", "thp_fault_alloc 100\n"
+                             "thp_fault_fallback 10\n"
+                             "zswpin 5\n"
+                             "zswpout 50\n");
+    writeFile("sys/kernel/mm/transparent_hugepage/enabled", "always [madvise] never\n");
+    writeFile("sys/kernel/mm/transparent_hugepage/defrag", "always defer defer+madvise [madvise] never\n");
+    writeFile("sys/module/zswap/parameters/enabled", "Y\n");
+    writeFile("sys/module/zswap/parameters/compressor", "zstd\n");
+    writeFile("sys/module/zswap/parameters/max_pool_percent", "20\n");
+    writeFile("sys/block/zram0/disksize", "4294967296\n");
+    writeFile("sys/block/zram0/mm_stat", "8192000 2048000 2150400 0 2150400 120 0 12 0\n");
+    writeFile("sys/block/zram0/comp_algorithm", "lzo lzo-rle [zstd]\n");
+    // not set up, left out
+    writeFile("sys/block/zram1/disksize", "0\n");
+    writeFile("sys/block/zram1/mm_stat", "0 0 0 0 0 0 0 0 0\n");
+
+    MemTuningInfoDB db(m_dir.path() + "/sys", m_dir.path() + "/proc");
+    EXPECT_FALSE(db.info().valid);
+    db.update();
+    const mem_tuning_t &info = db.info();
+    ASSERT_TRUE(info.valid);
+    // rates need two reads
+    EXPECT_FALSE(info.ratesValid);
+    EXPECT_EQ(info.thpEnabled, QString("madvise"));
+    EXPECT_EQ(info.thpDefrag, QString("madvise"));
+    EXPECT_EQ(info.anonHugePages, 845824ull);
+    EXPECT_EQ(info.shmemHugePages, 4096ull);
+    EXPECT_TRUE(info.zswapAvailable);
+    EXPECT_TRUE(info.zswapEnabled);
+    EXPECT_EQ(info.zswapCompressor, QString("zstd"));
+    EXPECT_EQ(info.zswapMaxPoolPercent, 20);
+    EXPECT_TRUE(info.zswapSizesKnown);
+    EXPECT_EQ(info.zswapPool, 81920ull);
+    EXPECT_EQ(info.zswapStored, 262144ull);
+    ASSERT_EQ(info.zram.size(), 1);
+    EXPECT_EQ(info.zram[0].name, QString("zram0"));
+    EXPECT_EQ(info.zram[0].algorithm, QString("zstd"));
+    EXPECT_EQ(info.zram[0].diskSize, 4294967296ull);
+
+    writeFile("proc/vmstat", "thp_fault_alloc 200\n"
+                             "thp_fault_fallback 10\n"
+                             "zswpin 5\n"
+                             "zswpout 80\n");
+    db.update();
+    EXPECT_TRUE(db.info().ratesValid);
+    EXPECT_GT(db.info().thpFaultAlloc, 0.);
+    EXPECT_DOUBLE_EQ(db.info().thpFaultFallback, 0.);
+    EXPECT_DOUBLE_EQ(db.info().zswapIn, 0.);
+    EXPECT_GT(db.info().zswapOut, 0.);
+}
+
+TEST_F(UT_MemTuningInfoDB, test_update_without_features)
+{
+    // an old kernel without meminfo sizes, a debugfs we can't read & no zram
+    writeFile("proc/meminfo", "MemTotal:       16346064 kB\n"
+                              "AnonHugePages:         0 kB\n");
+    writeFile("proc/vmstat", "pgfault 1\n");
+    writeFile("sys/module/zswap/parameters/enabled", "N\n");
+
+    MemTuningInfoDB db(m_dir.path() + "/sys", m_dir.path() + "/proc");
+    db.update();
+    const mem_tuning_t &info = db.info();
+    ASSERT_TRUE(info.valid);
+    EXPECT_TRUE(info.thpEnabled.isEmpty());
+    EXPECT_TRUE(info.zswapAvailable);
+    EXPECT_FALSE(info.zswapEnabled);
+    EXPECT_FALSE(info.zswapSizesKnown);
+    EXPECT_TRUE(info.zram.isEmpty());
+
+    // sizes of debugfs once readable
+    writeFile("sys/kernel/debug/zswap/pool_total_size", "1048576\n");
+    writeFile("sys/kernel/debug/zswap/stored_pages", "1024\n");
+    db.update();
+    EXPECT_TRUE(db.info().zswapSizesKnown);
+    EXPECT_EQ(db.info().zswapPool, 1024ull);
+    EXPECT_GT(db.info().zswapStored, 0ull);
+}
+
+TEST_F(UT_MemTuningInfoDB, test_update_no_meminfo)
+{
+    MemTuningInfoDB db(m_dir.path() + "/sys", m_dir.path() + "/proc");
+    db.update();
+    EXPECT_FALSE(db.info().valid);
+}
@@ -55,3 +55,51 @@ TEST_F(UT_NetifInfoDB, test_update)
     m_tester->update();
 
 }
+
+TEST_F(UT_NetifInfoDB, test_update_netif_stats)
+{
+    m_tester->update_addr();
+    m_tester->update_netif_info();
+    auto before = m_tester->infoDB();
+    m_tester->update_netif_stats();
+    EXPECT_EQ(m_tester->infoDB().keys(), before.keys());
+    // published items are not modified in place
+    for (auto it = before.cbegin(); it != before.cend(); ++it)
+        EXPECT_NE(m_tester->infoDB().value(it.key()).get(), it.value().get());
+    EXPECT_EQ(m_tester->m_lastBytes.size(), before.size());
+}
+
+TEST_F(UT_NetifInfoDB, test_update_02)
+{
+    // link & address info is read on first update only
+    m_tester->update();
+    EXPECT_TRUE(m_tester->m_infoValid);
+    EXPECT_EQ(m_tester->m_pollsSinceScan, 0);
+    m_tester->update();
+}
+
+TEST_F(UT_NetifInfoDB, test_update_wireless_info)
+{
+    m_tester->update_addr();
+    m_tester->update_netif_info();
+    EXPECT_EQ(m_tester->m_wirelessIfaces.size(), m_tester->infoDB().size());
+
+    // only interfaces flagged wireless are queried
+    for (auto it = m_tester->m_wirelessIfaces.begin(); it != m_tester->m_wirelessIfaces.end(); ++it)
+        it.value() = false;
+    m_tester->update_wireless_info();
+    EXPECT_TRUE(m_tester->m_wirelessStats.isEmpty());
+
+    wireless_stat stat;
+    stat.essid = "ssid";
+    stat.signal_level = static_cast<unsigned char>(-60);
+    stat.bitrate = 144;
+    for (auto &item : m_tester->infoDB())
+        m_tester->m_wirelessStats.insert(item->index(), stat);
+    m_tester->update_netif_stats();
+    for (auto &item : m_tester->infoDB()) {
+        EXPECT_TRUE(item->isWireless());
+        EXPECT_EQ(item->essid(), QByteArray("ssid"));
+        EXPECT_EQ(item->speed(), 144u);
+    }
+}
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/netif_link_watcher.h"
+
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+//gtest
+#include <gtest/gtest.h>
+
+using namespace core::system;
+
+namespace {
+
+// append an empty rtnetlink message of type to buffer
+int appendMessage(char *buf, int offset, uint16_t type, size_t payload)
+{
+    auto *nlh = reinterpret_cast<struct nlmsghdr *>(buf + offset);
+    nlh->nlmsg_len = NLMSG_LENGTH(payload);
+    nlh->nlmsg_type = type;
+    return offset + int(NLMSG_ALIGN(nlh->nlmsg_len));
+}
+
+} // namespace
+
+class UT_NetifLinkWatcher: public ::testing::Test
+{
+public:
+    UT_NetifLinkWatcher() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new NetifLinkWatcher();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    NetifLinkWatcher *m_tester;
+};
+
+TEST_F(UT_NetifLinkWatcher, initTest)
+{
+}
+
+TEST_F(UT_NetifLinkWatcher, test_parseEvents)
+{
+    alignas(NLMSG_ALIGNTO) char buf[256] = {0};
+    int len = appendMessage(buf, 0, RTM_NEWLINK, sizeof(struct ifinfomsg));
+    EXPECT_EQ(NetifLinkWatcher::parseEvents(buf, len), int(NetifLinkWatcher::kLinkEvent));
+
+    len = appendMessage(buf, len, RTM_DELADDR, sizeof(struct ifaddrmsg));
+    EXPECT_EQ(NetifLinkWatcher::parseEvents(buf, len),
+              NetifLinkWatcher::kLinkEvent | NetifLinkWatcher::kAddressEvent);
+
+    // routes are not of interest
+    len = appendMessage(buf, 0, RTM_NEWROUTE, sizeof(struct rtmsg));
+    EXPECT_EQ(NetifLinkWatcher::parseEvents(buf, len), 0);
+    EXPECT_EQ(NetifLinkWatcher::parseEvents(buf, 0), 0);
+}
+
+TEST_F(UT_NetifLinkWatcher, test_start_stop)
+{
+    EXPECT_TRUE(m_tester->start());
+    EXPECT_TRUE(m_tester->isRunning());
+    // already listening
+    EXPECT_TRUE(m_tester->start());
+    m_tester->stop();
+    EXPECT_FALSE(m_tester->isRunning());
+}
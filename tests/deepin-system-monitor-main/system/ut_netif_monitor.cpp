@@ -104,3 +104,65 @@ TEST_F(UT_NetifMonitor, test_handleNetData)
 //    qulonglong totalDelta = m_tester->getSockIOStatByInode(ino,stat);
 //    EXPECT_NE(totalDelta, 0);
 //}
+
+TEST_F(UT_NetifMonitor, test_setPacketCaptureEnabled)
+{
+    m_tester->setPacketCaptureEnabled(false);
+    EXPECT_FALSE(m_tester->m_captureEnabled.load());
+    m_tester->setPacketCaptureEnabled(true);
+    EXPECT_TRUE(m_tester->m_captureEnabled.load());
+}
+
+TEST_F(UT_NetifMonitor, test_drainPacketRings)
+{
+    auto ring = m_tester->createPacketRing();
+    ring->push({1, 100, kOutboundPacket});
+    ring->push({1, 50, kOutboundPacket});
+    ring->push({1, 10, kInboundPacket});
+    ring->push({2, 20, kInboundPacket});
+    EXPECT_EQ(m_tester->drainPacketRings(), 4);
+
+    SockIOStat stat;
+    ASSERT_TRUE(m_tester->getSockIOStatByInode(1, stat));
+    EXPECT_EQ(stat->tx_bytes, 150ull);
+    EXPECT_EQ(stat->tx_packets, 2ull);
+    EXPECT_EQ(stat->rx_bytes, 10ull);
+    ASSERT_TRUE(m_tester->getSockIOStatByInode(2, stat));
+    EXPECT_EQ(stat->rx_bytes, 20ull);
+    EXPECT_EQ(stat->tx_bytes, 0ull);
+
+    EXPECT_FALSE(m_tester->packetSampling());
+
+    // sampled record stands for weight packets
+    ring->push({3, 100, kInboundPacket, 4});
+    EXPECT_EQ(m_tester->drainPacketRings(), 1);
+    ASSERT_TRUE(m_tester->getSockIOStatByInode(3, stat));
+    EXPECT_EQ(stat->rx_bytes, 400ull);
+    EXPECT_EQ(stat->rx_packets, 4ull);
+    EXPECT_TRUE(m_tester->packetSampling());
+
+    // released & drained ring is dropped
+    ring.reset();
+    EXPECT_EQ(m_tester->drainPacketRings(), 0);
+    EXPECT_TRUE(m_tester->m_packetRings.isEmpty());
+}
+
+TEST_F(UT_NetifMonitor, test_watchedSockets)
+{
+    m_tester->setWatchedSockets({1});
+    auto ring = m_tester->createPacketRing();
+    ring->push({1, 10, kInboundPacket});
+    ring->push({2, 20, kInboundPacket});
+    m_tester->drainPacketRings();
+
+    SockIOStat stat;
+    EXPECT_TRUE(m_tester->getSockIOStatByInode(1, stat));
+    EXPECT_TRUE(m_tester->getSockIOStatByInode(2, stat));
+    // totals survive the stat being taken, only watched sockets are kept
+    auto watched = m_tester->watchedSockIOStats();
+    ASSERT_EQ(watched.size(), 1);
+    EXPECT_EQ(watched.value(1).rx_bytes, 10ull);
+
+    m_tester->setWatchedSockets({});
+    EXPECT_TRUE(m_tester->watchedSockIOStats().isEmpty());
+}
@@ -31,11 +31,6 @@ size_t stub_strlen()
     return IFNAMSIZ+1;
 }
 
-void stub_whetherDevChanged()
-{
-    return;
-}
-
 int stub_ioctl (int num, unsigned long int __request, ...)
 {
     return -1;
@@ -57,26 +52,6 @@ int stub_socket (int __domain, int __type, int __protocol)
     return -1;
 }
 
-bool stub_getCurrentDevName_true()
-{
-    return true;
-}
-
-bool stub_getCurrentDevName_false()
-{
-    return false;
-}
-
-bool stub_hasDevIP_false()
-{
-    return false;
-}
-
-bool stub_hasDevIP_true()
-{
-    return true;
-}
-
 bool stub_parsePacket_false(const pcap_pkthdr *pkt_hdr,
                                     const u_char *packet,
                                     PacketPayload &payload)
@@ -133,132 +108,50 @@ TEST_F(UT_NetifPacketCapture, initTest)
 {
 }
 
-TEST_F(UT_NetifPacketCapture, test_hasDevIP_01)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, whetherDevChanged), stub_whetherDevChanged);
-    m_tester->m_devName = nullptr;
-    bool ok = m_tester->hasDevIP();
-    EXPECT_EQ(ok, false);
-}
-
-TEST_F(UT_NetifPacketCapture, test_hasDevIP_02)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, whetherDevChanged), stub_whetherDevChanged);
-    m_tester->m_devName = "123456789";
-    auto ok = m_tester->hasDevIP();
-    EXPECT_EQ(ok, false);
-}
-
-TEST_F(UT_NetifPacketCapture, test_hasDevIP_03)
+TEST_F(UT_NetifPacketCapture, test_readCaptureLinks)
 {
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, whetherDevChanged), stub_whetherDevChanged);
-    auto ok = m_tester->hasDevIP();
-    EXPECT_EQ(ok, false);
+    QMap<int, QByteArray> links;
+    m_tester->readCaptureLinks(links);
+    // loopback is never captured on
+    EXPECT_FALSE(links.values().contains("lo"));
 }
 
-TEST_F(UT_NetifPacketCapture, test_hasDevIP_04)
+TEST_F(UT_NetifPacketCapture, test_readCaptureLinks_02)
 {
     Stub stub;
     stub.set(ioctl, stub_ioctl);
-    auto ok = m_tester->hasDevIP();
-    EXPECT_EQ(ok, false);
-}
-
-TEST_F(UT_NetifPacketCapture, test_hasDevIP_05)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, whetherDevChanged), stub_whetherDevChanged);
-
-    stub.set(inet_ntoa, stub_inet_ntoa);
-    auto ok = m_tester->hasDevIP();
-    EXPECT_EQ(ok, false);
+    QMap<int, QByteArray> links;
+    m_tester->readCaptureLinks(links);
+    EXPECT_TRUE(links.isEmpty());
 }
 
-TEST_F(UT_NetifPacketCapture, test_hasDevIP_06)
+TEST_F(UT_NetifPacketCapture, test_updateCaptureLinks)
 {
     Stub stub;
-    stub.set(ADDR(NetifPacketCapture, whetherDevChanged), stub_whetherDevChanged);
-
-    stub.set(inet_ntoa, stub_inet_ntoa);
-    m_tester->m_devName = "12345678901234567";
-    auto ok = m_tester->hasDevIP();
-    EXPECT_EQ(ok, false);
-}
-
-TEST_F(UT_NetifPacketCapture, test_getCurrentDevName_01)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, whetherDevChanged), stub_whetherDevChanged);
-    stub.set(socket, stub_socket);
-    auto ok = m_tester->getCurrentDevName();
-}
-
-TEST_F(UT_NetifPacketCapture, test_getCurrentDevName_02)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, whetherDevChanged), stub_whetherDevChanged);
-    stub.set(pcap_findalldevs, stub_pcap_findalldevs);
-    auto ok = m_tester->getCurrentDevName();
-}
-
-TEST_F(UT_NetifPacketCapture, test_getCurrentDevName_03)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, whetherDevChanged), stub_whetherDevChanged);
-    stub.set(pcap_findalldevs, stub_pcap_findalldevs);
-    auto ok = m_tester->getCurrentDevName();
-}
-
-//TEST_F(UT_NetifPacketCapture, test_getCurrentDevName_06)
-//{
-//    Stub stub;
-//    auto ok = m_tester->getCurrentDevName();
-//    EXPECT_EQ(ok, true);
-//}
-
-TEST_F(UT_NetifPacketCapture, test_whetherDevChanged_01)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, whetherDevChanged), stub_whetherDevChanged);
-    m_tester->m_devName = nullptr;
-    m_tester->whetherDevChanged();
-}
-
-TEST_F(UT_NetifPacketCapture, test_whetherDevChanged_02)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, hasDevIP), stub_hasDevIP_false);
-    stub.set(ADDR(NetifPacketCapture, getCurrentDevName), stub_getCurrentDevName_false);
-    m_tester->whetherDevChanged();
-    EXPECT_TRUE(m_tester->m_changedDev);
-}
-
-TEST_F(UT_NetifPacketCapture, test_whetherDevChanged_03)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, hasDevIP), stub_hasDevIP_false);
-    stub.set(ADDR(NetifPacketCapture, getCurrentDevName), stub_getCurrentDevName_true);
-    m_tester->whetherDevChanged();
-    EXPECT_TRUE(m_tester->m_changedDev);
+    stub.set(pcap_create, stub_pcap_create);
+    m_tester->updateCaptureLinks();
+    EXPECT_TRUE(m_tester->m_captures.isEmpty());
+    EXPECT_FALSE(m_tester->m_timer->isActive());
 }
 
-TEST_F(UT_NetifPacketCapture, test_whetherDevChanged_04)
+TEST_F(UT_NetifPacketCapture, test_onNetifChanged)
 {
     Stub stub;
-    stub.set(ADDR(NetifPacketCapture, hasDevIP), stub_hasDevIP_true);
-    m_tester->whetherDevChanged();
-    EXPECT_TRUE(m_tester->m_changedDev);
+    stub.set(pcap_create, stub_pcap_create);
+    m_tester->go = true;
+    m_tester->m_lastIfaddrsRefresh = 1;
+    m_tester->onNetifChanged();
+    // addresses are read again on next refresh
+    EXPECT_EQ(m_tester->m_lastIfaddrsRefresh, 0);
 }
 
 TEST_F(UT_NetifPacketCapture, test_startNetifMonitorJob_01)
 {
     Stub stub;
-    stub.set(ADDR(NetifPacketCapture, whetherDevChanged), stub_whetherDevChanged);
-    m_tester->m_devName = nullptr;
+    stub.set(pcap_create, stub_pcap_create_false);
     m_tester->startNetifMonitorJob();
+    m_tester->stopNetifMonitorJob();
+    EXPECT_FALSE(m_tester->m_linkWatcher->isRunning());
 }
 
 
@@ -285,21 +178,18 @@ TEST_F(UT_NetifPacketCapture, test_startNetifMonitorJob_04)
 TEST_F(UT_NetifPacketCapture, test_dispatchPackets_01)
 {
     m_tester->go = true;
-    m_tester->m_devName = nullptr;
     m_tester->dispatchPackets();
 }
 
 TEST_F(UT_NetifPacketCapture, test_dispatchPackets_02)
 {
     m_tester->go = true;
-    m_tester->m_devName = nullptr;
     m_tester->dispatchPackets();
 }
 
 TEST_F(UT_NetifPacketCapture, test_dispatchPackets_03)
 {
     m_tester->go = true;
-    m_tester->m_devName = nullptr;
     Stub stub;
     stub.set(ADDR(PacketPayloadQueue, size), stub_localPendingPackets_64);
     m_tester->dispatchPackets();
@@ -327,6 +217,15 @@ TEST_F(UT_NetifPacketCapture, test_dispatchPackets_06)
     m_tester->dispatchPackets();
 }
 
+TEST_F(UT_NetifPacketCapture, test_readCaptureConfig)
+{
+    int bufferSize = -1;
+    bool ring = false;
+    uint samplingThreshold = 0;
+    m_tester->readCaptureConfig(bufferSize, ring, samplingThreshold);
+    EXPECT_GE(bufferSize, 0);
+}
+
 TEST_F(UT_NetifPacketCapture, test_refreshIfAddrsHashCache)
 {
     m_tester->refreshIfAddrsHashCache();
@@ -124,3 +124,142 @@ TEST_F(UT_NetifPacketParser, test_parsePacket_05)
 //    stub.set(ntohs, stub_ntohs_IPV6);
 //    EXPECT_EQ(m_tester->parsePacket(&hdr, packet1, payload), false);
 }
+
+TEST_F(UT_NetifPacketParser, test_parsePacket_06)
+{
+    // ipv4 tcp frame cut by snaplen right after the tcp header
+    u_char packet[54] = {0};
+    packet[12] = 0x08; // ETHERTYPE_IP
+    packet[14] = 0x45; // version 4, ihl 5
+    packet[14 + 9] = IPPROTO_TCP;
+    packet[34] = 0x00; packet[35] = 0x50; // sport 80
+    packet[36] = 0xd4; packet[37] = 0x31; // dport 54321
+    packet[34 + 12] = 0x50; // data offset 5
+
+    pcap_pkthdr hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.caplen = sizeof(packet);
+    hdr.len = sizeof(packet) + 1000;
+    PacketPayload payload = nullptr;
+    EXPECT_TRUE(m_tester->parsePacket(&hdr, packet, payload));
+    EXPECT_EQ(payload->payload, 1000u);
+    EXPECT_EQ(payload->s_port, 80);
+    EXPECT_EQ(payload->d_port, 54321);
+    EXPECT_EQ(payload->wire_len, 1054ull);
+
+    // headers not fully captured
+    hdr.caplen = 40;
+    EXPECT_FALSE(m_tester->parsePacket(&hdr, packet, payload));
+}
+
+TEST_F(UT_NetifPacketParser, test_parsePacket_07)
+{
+    // pure tcp ack, no payload but still on the wire
+    u_char packet[54] = {0};
+    packet[12] = 0x08; // ETHERTYPE_IP
+    packet[14] = 0x45; // version 4, ihl 5
+    packet[14 + 9] = IPPROTO_TCP;
+    packet[34 + 12] = 0x50; // data offset 5
+
+    pcap_pkthdr hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.caplen = hdr.len = sizeof(packet);
+    packet_payload_t payload {};
+    EXPECT_TRUE(m_tester->parsePacket(&hdr, packet, payload));
+    EXPECT_EQ(payload.payload, 0u);
+    EXPECT_EQ(payload.wire_len, 54ull);
+}
+
+TEST_F(UT_NetifPacketParser, test_wireLength)
+{
+    // frame within mtu is taken as is
+    EXPECT_EQ(NetifPacketParser::wireLength(1054, 54, 1000, 1500), 1054ull);
+    // tso frame of 4000 bytes payload goes out as 3 segments of at most 1460 bytes
+    EXPECT_EQ(NetifPacketParser::wireLength(4054, 54, 4000, 1500), 4000ull + 3 * 54);
+    // oversized frame without payload is left alone
+    EXPECT_EQ(NetifPacketParser::wireLength(4054, 54, 0, 1500), 4054ull);
+}
+
+TEST_F(UT_NetifPacketParser, test_parseHeaders_01)
+{
+    // QinQ, 802.1ad service tag then 802.1Q customer tag, ipv4 udp
+    u_char packet[50] = {0};
+    packet[12] = 0x88; packet[13] = 0xa8;
+    packet[16] = 0x81; packet[17] = 0x00;
+    packet[20] = 0x08; // ETHERTYPE_IP
+    packet[22] = 0x45;
+    packet[22 + 9] = IPPROTO_UDP;
+    packet[22 + 12] = 10; // saddr 10.0.0.1
+    packet[22 + 15] = 1;
+    packet[42] = 0x00; packet[43] = 0x35; // sport 53
+    packet[44] = 0x30; packet[45] = 0x39; // dport 12345
+
+    packet_headers_t headers = NetifPacketParser::parseHeaders(packet, sizeof(packet), 1518);
+    ASSERT_TRUE(headers.valid());
+    EXPECT_EQ(headers.sa_family, AF_INET);
+    EXPECT_EQ(int(headers.vlans), 2);
+    EXPECT_EQ(int(headers.l4_off), 42);
+    EXPECT_EQ(headers.s_port, 53);
+    EXPECT_EQ(headers.d_port, 12345);
+    EXPECT_EQ(headers.s_addr, packet + 34);
+    EXPECT_EQ(headers.payload, 1518ull - 50);
+
+    // a full sized tagged frame is no offload super frame
+    pcap_pkthdr hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.caplen = sizeof(packet);
+    hdr.len = 1518 + 4;
+    packet_payload_t payload {};
+    EXPECT_TRUE(m_tester->parsePacket(&hdr, packet, payload, 1500));
+    EXPECT_EQ(payload.wire_len, 1522ull);
+    EXPECT_EQ(payload.s_addr.in4.s_addr, htonl(0x0a000001));
+
+    // cut inside the tags
+    EXPECT_FALSE(NetifPacketParser::parseHeaders(packet, 18, 1518).valid());
+}
+
+TEST_F(UT_NetifPacketParser, test_parseHeaders_02)
+{
+    // ipv6, hop-by-hop & destination options then tcp
+    u_char packet[14 + 40 + 8 + 16 + 20] = {0};
+    packet[12] = 0x86; packet[13] = 0xdd;
+    packet[14] = 0x60;
+    packet[14 + 6] = IPPROTO_HOPOPTS;
+    int off = 14 + 40;
+    packet[off] = IPPROTO_DSTOPTS; // 8 bytes
+    off += 8;
+    packet[off] = IPPROTO_TCP;
+    packet[off + 1] = 1; // 16 bytes
+    off += 16;
+    packet[off + 1] = 22; // sport 22
+    packet[off + 12] = 0x50;
+
+    packet_headers_t headers = NetifPacketParser::parseHeaders(packet, sizeof(packet), sizeof(packet));
+    ASSERT_TRUE(headers.valid());
+    EXPECT_EQ(headers.sa_family, AF_INET6);
+    EXPECT_EQ(int(headers.l4_off), off);
+    EXPECT_EQ(headers.s_port, 22);
+    EXPECT_EQ(headers.payload, 0ull);
+
+    // esp can't be looked into
+    packet[14 + 6] = IPPROTO_ESP;
+    EXPECT_FALSE(NetifPacketParser::parseHeaders(packet, sizeof(packet), sizeof(packet)).valid());
+
+    // later fragments carry no tcp header
+    packet[14 + 6] = IPPROTO_FRAGMENT;
+    packet[14 + 40] = IPPROTO_TCP;
+    packet[14 + 40 + 3] = 0x08; // offset 1
+    EXPECT_FALSE(NetifPacketParser::parseHeaders(packet, sizeof(packet), sizeof(packet)).valid());
+}
+
+TEST_F(UT_NetifPacketParser, test_parseHeaders_03)
+{
+    // a loop of extension headers is given up on
+    u_char packet[14 + 40 + 8 * (NetifPacketParser::kMaxExtensionHeaders + 1) + 20] = {0};
+    packet[12] = 0x86; packet[13] = 0xdd;
+    packet[14] = 0x60;
+    packet[14 + 6] = IPPROTO_DSTOPTS;
+    for (int i = 0; i <= NetifPacketParser::kMaxExtensionHeaders; ++i)
+        packet[14 + 40 + 8 * i] = IPPROTO_DSTOPTS;
+    EXPECT_FALSE(NetifPacketParser::parseHeaders(packet, sizeof(packet), sizeof(packet)).valid());
+}
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/netif_queues.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+using namespace core::system;
+
+namespace {
+
+// cpu 1 offline, its column is left out
+const char kInterrupts[] =
+    "            CPU0       CPU2       CPU3\n"
+    "   0:         35          0          0  IR-IO-APIC    2-edge      timer\n"
+    "  24:          0          0          0  IR-PCI-MSI 524288-edge      eth0\n"
+    "  25:       1000         20          0  IR-PCI-MSI 524289-edge      eth0-TxRx-0\n"
+    "  26:          3       5000          7  IR-PCI-MSI 524290-edge      eth0-TxRx-1\n"
+    "  27:          1          0          0  IR-PCI-MSI 524291-edge      i40e-0000:3b:00.0:misc\n"
+    "  30:          0          9          0  IR-PCI-MSI 524300-edge      eth10-TxRx-0\n"
+    " NMI:          0          0          0   Non-maskable interrupts\n"
+    " LOC:     123456     123456     123456   Local timer interrupts\n";
+
+} // namespace
+
+TEST(UT_NetifQueues, test_parseInterrupts_001)
+{
+    // irqs of the device
+    const QList<NetifQueues::irq_t> irqs = NetifQueues::parseInterrupts(kInterrupts, {25, 26, 27}, "eth0");
+    ASSERT_EQ(irqs.size(), 2);
+    EXPECT_EQ(irqs[0].irq, 25);
+    EXPECT_EQ(irqs[0].name, QByteArray("eth0-TxRx-0"));
+    EXPECT_EQ(irqs[0].queue, 0);
+    EXPECT_EQ(irqs[0].direction, int(NetifQueues::kQueueRxTx));
+    ASSERT_EQ(irqs[1].counts.size(), 4);
+    EXPECT_EQ(irqs[1].queue, 1);
+    EXPECT_EQ(irqs[1].counts[0], 3u);
+    EXPECT_EQ(irqs[1].counts[1], 0u);
+    EXPECT_EQ(irqs[1].counts[2], 5000u);
+    EXPECT_EQ(irqs[1].counts[3], 7u);
+}
+
+TEST(UT_NetifQueues, test_parseInterrupts_002)
+{
+    // no msi vectors known, by name, eth10 isn't eth1
+    QList<NetifQueues::irq_t> irqs = NetifQueues::parseInterrupts(kInterrupts, {}, "eth0");
+    ASSERT_EQ(irqs.size(), 3);
+    EXPECT_EQ(irqs[0].irq, 24);
+    EXPECT_EQ(irqs[0].queue, 0);
+    irqs = NetifQueues::parseInterrupts(kInterrupts, {}, "eth1");
+    EXPECT_TRUE(irqs.isEmpty());
+    EXPECT_TRUE(NetifQueues::parseInterrupts(QByteArray(), {}, "eth0").isEmpty());
+}
+
+TEST(UT_NetifQueues, test_queueOf_001)
+{
+    EXPECT_EQ(NetifQueues::queueOf("eth0-TxRx-3", "eth0"), 3);
+    EXPECT_EQ(NetifQueues::queueOf("enp3s0-rx-12", "enp3s0"), 12);
+    EXPECT_EQ(NetifQueues::queueOf("mlx5_comp7@pci:0000:01:00.0", "enp1s0f0"), 7);
+    EXPECT_EQ(NetifQueues::queueOf("virtio0-input.2", "ens3"), 2);
+    EXPECT_EQ(NetifQueues::queueOf("iwlwifi:queue_1", "wlp2s0"), 1);
+    // digits of the interface name only
+    EXPECT_EQ(NetifQueues::queueOf("enp0s31f6", "enp0s31f6"), 0);
+    EXPECT_EQ(NetifQueues::queueOf("enp0s31f6-misc", "enp0s31f6"), -1);
+    EXPECT_EQ(NetifQueues::queueOf("mlx5_async0@pci:0000:01:00.0", "enp1s0f0"), -1);
+    EXPECT_EQ(NetifQueues::queueOf("virtio0-config", "ens3"), -1);
+    EXPECT_EQ(NetifQueues::queueOf("iwlwifi:default_queue", "wlp2s0"), -1);
+}
+
+TEST(UT_NetifQueues, test_directionOf_001)
+{
+    EXPECT_EQ(NetifQueues::directionOf("eth0-TxRx-0"), int(NetifQueues::kQueueRxTx));
+    EXPECT_EQ(NetifQueues::directionOf("eth0-rx-0"), int(NetifQueues::kQueueRx));
+    EXPECT_EQ(NetifQueues::directionOf("eth0-tx-0"), int(NetifQueues::kQueueTx));
+    EXPECT_EQ(NetifQueues::directionOf("virtio0-input.0"), int(NetifQueues::kQueueRx));
+    EXPECT_EQ(NetifQueues::directionOf("virtio0-output.0"), int(NetifQueues::kQueueTx));
+    EXPECT_EQ(NetifQueues::directionOf("mlx5_comp0@pci:0000:01:00.0"), int(NetifQueues::kQueueRxTx));
+}
+
+TEST(UT_NetifQueues, test_parseStatName_001)
+{
+    int queue = -1;
+    int direction = 0;
+    bool bytes = true;
+    ASSERT_TRUE(NetifQueues::parseStatName("rx_queue_3_packets", queue, direction, bytes));
+    EXPECT_EQ(queue, 3);
+    EXPECT_EQ(direction, int(NetifQueues::kQueueRx));
+    EXPECT_FALSE(bytes);
+    ASSERT_TRUE(NetifQueues::parseStatName("     tx-12.bytes", queue, direction, bytes));
+    EXPECT_EQ(queue, 12);
+    EXPECT_EQ(direction, int(NetifQueues::kQueueTx));
+    EXPECT_TRUE(bytes);
+    ASSERT_TRUE(NetifQueues::parseStatName("rx0_packets", queue, direction, bytes));
+    EXPECT_EQ(queue, 0);
+
+    // totals & other per queue counters
+    EXPECT_FALSE(NetifQueues::parseStatName("rx_packets", queue, direction, bytes));
+    EXPECT_FALSE(NetifQueues::parseStatName("rx_queue_0_drops", queue, direction, bytes));
+    EXPECT_FALSE(NetifQueues::parseStatName("rx0_xdp_drop", queue, direction, bytes));
+}
@@ -10,6 +10,8 @@
 #include "stub.h"
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 using namespace core::system;
 
 class UT_Netlink: public ::testing::Test
@@ -50,3 +52,29 @@ TEST_F(UT_Netlink, test_addrIterator)
 }
 
 
+
+TEST_F(UT_Netlink, test_linkStats)
+{
+    LinkStatsMap stats;
+    EXPECT_TRUE(m_tester->linkStats(stats));
+    // loopback is always there
+    EXPECT_FALSE(stats.isEmpty());
+
+    // fallback to link cache gives the same interfaces
+    m_tester->m_statsSupported = false;
+    LinkStatsMap cacheStats;
+    EXPECT_TRUE(m_tester->linkStats(cacheStats));
+    QList<int> keys = stats.keys();
+    QList<int> cacheKeys = cacheStats.keys();
+    std::sort(keys.begin(), keys.end());
+    std::sort(cacheKeys.begin(), cacheKeys.end());
+    EXPECT_EQ(cacheKeys, keys);
+}
+
+TEST_F(UT_Netlink, test_readEvents)
+{
+    // nothing blocks when there is no notification
+    m_tester->readEvents();
+    if (m_tester->hasEventSocket())
+        EXPECT_FALSE(m_tester->readEvents());
+}
@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/packet_sampler.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+using namespace core::system;
+
+namespace {
+
+// count n packets, return how many would be classified
+int take(PacketSampler &sampler, int n)
+{
+    int taken = 0;
+    for (int i = 0; i < n; ++i)
+        taken += sampler.take() ? 1 : 0;
+    return taken;
+}
+
+} // namespace
+
+TEST(UT_PacketSampler, test_disabled)
+{
+    PacketSampler sampler;
+    EXPECT_EQ(take(sampler, 100000), 100000);
+    EXPECT_FALSE(sampler.update(100, 1000));
+    EXPECT_EQ(sampler.rate(), 1u);
+}
+
+TEST(UT_PacketSampler, test_rate_up)
+{
+    PacketSampler sampler(1000);
+    // 3000 pps needs 1 in 4 to stay under threshold
+    take(sampler, 3000);
+    EXPECT_TRUE(sampler.update(0, 1000));
+    EXPECT_EQ(sampler.rate(), 4u);
+    EXPECT_EQ(take(sampler, 400), 100);
+
+    // flood is capped
+    take(sampler, 10000000);
+    sampler.update(0, 1000);
+    EXPECT_EQ(sampler.rate(), uint(PACKET_SAMPLING_MAX_RATE));
+}
+
+TEST(UT_PacketSampler, test_drops)
+{
+    PacketSampler sampler(1000);
+    // kernel drops start sampling even below threshold
+    take(sampler, 100);
+    EXPECT_TRUE(sampler.update(10, 1000));
+    EXPECT_EQ(sampler.rate(), 2u);
+    EXPECT_TRUE(sampler.update(10, 1000));
+    EXPECT_EQ(sampler.rate(), 4u);
+}
+
+TEST(UT_PacketSampler, test_rate_down)
+{
+    PacketSampler sampler(1000);
+    take(sampler, 3000);
+    sampler.update(0, 1000);
+    ASSERT_EQ(sampler.rate(), 4u);
+
+    // no headroom at 1 in 2 yet
+    take(sampler, 1600);
+    EXPECT_FALSE(sampler.update(0, 1000));
+    EXPECT_EQ(sampler.rate(), 4u);
+
+    // one step at a time
+    EXPECT_TRUE(sampler.update(0, 1000));
+    EXPECT_EQ(sampler.rate(), 2u);
+    EXPECT_TRUE(sampler.update(0, 1000));
+    EXPECT_EQ(sampler.rate(), 1u);
+    EXPECT_EQ(take(sampler, 10), 10);
+}
@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/proc_connector.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace core::system;
+
+class UT_ProcConnector: public ::testing::Test
+{
+public:
+    UT_ProcConnector() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new ProcConnector();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    ProcConnector *m_tester;
+};
+
+TEST_F(UT_ProcConnector, initTest)
+{
+}
+
+TEST_F(UT_ProcConnector, test_poll_001)
+{
+    QSet<pid_t> pids;
+    pids << 1;
+
+    // without CAP_NET_ADMIN source stays inactive & pid set untouched
+    if (!m_tester->isActive()) {
+        EXPECT_FALSE(m_tester->poll(pids));
+        EXPECT_EQ(pids.size(), 1);
+        return;
+    }
+
+    pid_t child = fork();
+    if (child == 0)
+        _exit(0);
+    waitpid(child, nullptr, 0);
+
+    // fork & exit of the child cancel out
+    EXPECT_TRUE(m_tester->poll(pids));
+    EXPECT_FALSE(pids.contains(child));
+    EXPECT_TRUE(pids.contains(1));
+}
@@ -0,0 +1,216 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/refresh_scheduler.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+using namespace core::system;
+
+class UT_RefreshScheduler : public ::testing::Test
+{
+public:
+    UT_RefreshScheduler() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new RefreshScheduler();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    RefreshScheduler *m_tester;
+};
+
+TEST_F(UT_RefreshScheduler, test_runDue_001)
+{
+    int fast = 0, slow = 0, once = 0;
+    m_tester->addProducer("fast", 1000, 1000, [&]() { ++fast; });
+    m_tester->addProducer("slow", 2000, 1000, [&]() { ++slow; });
+    m_tester->addProducer("once", 0, 1000, [&]() { ++once; });
+    EXPECT_EQ(m_tester->count(), 3);
+
+    // everything is due on first cycle
+    EXPECT_EQ(m_tester->runDue(0), 3);
+    // timer jitter within slack still counts as due
+    EXPECT_EQ(m_tester->runDue(980), 1);
+    EXPECT_EQ(m_tester->runDue(2000), 2);
+    EXPECT_EQ(m_tester->runDue(3000), 1);
+    EXPECT_EQ(fast, 4);
+    EXPECT_EQ(slow, 2);
+    EXPECT_EQ(once, 1);
+}
+
+TEST_F(UT_RefreshScheduler, test_runPeriodic_001)
+{
+    int fast = 0, slow = 0, once = 0;
+    m_tester->addProducer("fast", 1000, 1000, [&]() { ++fast; });
+    m_tester->addProducer("slow", 2000, 1000, [&]() { ++slow; });
+    m_tester->addProducer("once", 0, 1000, [&]() { ++once; });
+
+    EXPECT_EQ(m_tester->runAll(0), 3);
+    // second sample right after the baseline, once-only producers are left alone
+    EXPECT_EQ(m_tester->runPeriodic(200), 2);
+    EXPECT_EQ(once, 1);
+    // normal cadence from the second sample on
+    EXPECT_FALSE(m_tester->isDue(1, 1000));
+    EXPECT_TRUE(m_tester->isDue(1, 2200));
+    EXPECT_EQ(fast, 2);
+    EXPECT_EQ(slow, 2);
+}
+
+TEST_F(UT_RefreshScheduler, test_runDue_002)
+{
+    QList<int> order;
+    int base = m_tester->addProducer("base", 10000, 1000, [&]() { order << 0; });
+    int dependent = m_tester->addProducer("dependent", 1000, 1000, [&]() { order << 1; });
+    m_tester->addDependency(dependent, base);
+
+    m_tester->runDue(0);
+    order.clear();
+    // base isn't due by itself, but runs before its dependent
+    m_tester->runDue(1000);
+    EXPECT_EQ(order, QList<int>({0, 1}));
+}
+
+TEST_F(UT_RefreshScheduler, test_backoff_001)
+{
+    bool slow = true;
+    int id = m_tester->addProducer("slow", 1000, 1, [&]() {
+        if (slow)
+            usleep(5000);
+    });
+
+    m_tester->runDue(0);
+    EXPECT_EQ(m_tester->backoffLevel(id), 1);
+    EXPECT_EQ(m_tester->effectivePeriod(id), 2000);
+    EXPECT_FALSE(m_tester->isDue(id, 1000));
+
+    for (int i = 0; i < 10; ++i)
+        m_tester->runAll(0);
+    EXPECT_EQ(m_tester->backoffLevel(id), RefreshScheduler::kMaxBackoffLevel);
+
+    // recovers one level per run well within budget
+    slow = false;
+    m_tester->runAll(0);
+    EXPECT_EQ(m_tester->backoffLevel(id), RefreshScheduler::kMaxBackoffLevel - 1);
+}
+
+TEST_F(UT_RefreshScheduler, test_setThrottled_001)
+{
+    int id = m_tester->addProducer("producer", 1000, 1000, []() {});
+    m_tester->runDue(0);
+
+    m_tester->setThrottled(true);
+    EXPECT_TRUE(m_tester->isThrottled());
+    EXPECT_EQ(m_tester->effectivePeriod(id), 1000 * RefreshScheduler::kBackgroundFactor);
+    m_tester->runDue(1000);
+    EXPECT_FALSE(m_tester->isDue(id, 2000));
+
+    // back to foreground refreshes right away
+    m_tester->setThrottled(false);
+    EXPECT_TRUE(m_tester->isDue(id, 2000));
+    EXPECT_EQ(m_tester->effectivePeriod(id), 1000);
+}
+
+TEST_F(UT_RefreshScheduler, test_setPeriod_001)
+{
+    int id = m_tester->addProducer("producer", 2000, 1000, []() {});
+    int once = m_tester->addProducer("once", 0, 1000, []() {});
+    m_tester->runDue(0);
+    EXPECT_FALSE(m_tester->isDue(id, 1000));
+
+    // new period applies right away
+    m_tester->setPeriod(id, 1000);
+    EXPECT_EQ(m_tester->effectivePeriod(id), 1000);
+    EXPECT_TRUE(m_tester->isDue(id, 1000));
+    m_tester->runDue(1000);
+    EXPECT_TRUE(m_tester->isDue(id, 2000));
+
+    // once-only producers & bad periods are left alone
+    m_tester->setPeriod(once, 1000);
+    EXPECT_EQ(m_tester->effectivePeriod(once), 0);
+    m_tester->setPeriod(id, 0);
+    EXPECT_EQ(m_tester->effectivePeriod(id), 1000);
+}
+
+TEST_F(UT_RefreshScheduler, test_setEnabled_001)
+{
+    int runs = 0, deps = 0;
+    int dep = m_tester->addProducer("dependency", 2000, 1000, [&]() { ++deps; });
+    int id = m_tester->addProducer("producer", 2000, 1000, [&]() { ++runs; });
+    m_tester->addDependency(id, dep);
+
+    m_tester->setEnabled(dep, false);
+    EXPECT_FALSE(m_tester->isEnabled(dep));
+    EXPECT_FALSE(m_tester->isDue(dep, 0));
+    // still run for its dependent
+    EXPECT_EQ(m_tester->runDue(0), 2);
+    EXPECT_EQ(deps, 1);
+
+    m_tester->setEnabled(id, false);
+    EXPECT_EQ(m_tester->runDue(2000), 0);
+    EXPECT_EQ(m_tester->runAll(2000), 0);
+    EXPECT_EQ(m_tester->runPeriodic(2000), 0);
+
+    // due at once when asked for again
+    m_tester->setEnabled(id, true);
+    EXPECT_TRUE(m_tester->isDue(id, 2100));
+    EXPECT_EQ(m_tester->runDue(2100), 2);
+    EXPECT_EQ(runs, 2);
+}
+
+TEST_F(UT_RefreshScheduler, test_wake_001)
+{
+    int id = m_tester->addProducer("producer", 2000, 1000, []() {});
+    m_tester->runDue(0);
+    EXPECT_FALSE(m_tester->isDue(id, 1000));
+
+    m_tester->wake(id);
+    EXPECT_TRUE(m_tester->isDue(id, 1000));
+    m_tester->runDue(1000);
+    EXPECT_FALSE(m_tester->isDue(id, 2000));
+    EXPECT_TRUE(m_tester->isDue(id, 3000));
+}
+
+TEST_F(UT_RefreshScheduler, test_setPeriodScale_001)
+{
+    int fast = 0, slow = 0;
+    int id = m_tester->addProducer("fast", 1000, 1000, [&]() { ++fast; });
+    m_tester->addProducer("slow", 2000, 1000, [&]() { ++slow; });
+    int once = m_tester->addProducer("once", 0, 1000, []() {});
+    m_tester->runDue(0);
+
+    // 0.5s instead of 2s, due at once, ticks every 250ms with a slack of half a tick
+    m_tester->setPeriodScale(0.25);
+    EXPECT_EQ(m_tester->periodScale(), 0.25);
+    EXPECT_EQ(m_tester->effectivePeriod(id), 250);
+    EXPECT_EQ(m_tester->effectivePeriod(once), 0);
+    EXPECT_EQ(m_tester->runDue(100), 2);
+    EXPECT_EQ(m_tester->runDue(200), 0);
+    EXPECT_EQ(m_tester->runDue(350), 1);
+    EXPECT_EQ(m_tester->runDue(600), 2);
+    EXPECT_EQ(fast, 4);
+    EXPECT_EQ(slow, 3);
+
+    // 10s, throttling stretches the scaled period
+    m_tester->setPeriodScale(5);
+    m_tester->setThrottled(true);
+    EXPECT_EQ(m_tester->effectivePeriod(id), 5000 * RefreshScheduler::kBackgroundFactor);
+    m_tester->setPeriodScale(0);
+    EXPECT_EQ(m_tester->periodScale(), 5.);
+}
@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/sensor_info_db.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//qt
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+using namespace core::system;
+
+class UT_SensorInfoDB : public ::testing::Test
+{
+protected:
+    void writeFile(const QString &path, const QByteArray &content)
+    {
+        QDir().mkpath(QFileInfo(m_dir.path() + "/" + path).path());
+        QFile file(m_dir.path() + "/" + path);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write(content);
+    }
+
+    QTemporaryDir m_dir;
+};
+
+TEST_F(UT_SensorInfoDB, test_update_hwmon)
+{
+    writeFile("hwmon/hwmon0/name", "coretemp\n");
+    writeFile("hwmon/hwmon0/temp1_input", "52000\n");
+    writeFile("hwmon/hwmon0/temp1_label", "Package id 0\n");
+    writeFile("hwmon/hwmon0/temp1_crit", "100000\n");
+    writeFile("hwmon/hwmon1/name", "thinkpad\n");
+    writeFile("hwmon/hwmon1/fan1_input", "2400\n");
+    writeFile("hwmon/hwmon1/temp1_input", "-5000\n");
+    writeFile("hwmon/hwmon2/name", "amdgpu\n");
+    writeFile("hwmon/hwmon2/power1_average", "15000000\n");
+
+    SensorInfoDB db(m_dir.path() + "/hwmon", m_dir.path() + "/thermal");
+    db.update();
+    const QList<sensor_t> sensors = db.sensors();
+    ASSERT_EQ(sensors.size(), 4);
+    EXPECT_EQ(sensors[0].chip, QString("coretemp"));
+    EXPECT_EQ(sensors[0].label, QString("Package id 0"));
+    EXPECT_EQ(sensors[0].kind, sensor_t::kTemperature);
+    EXPECT_DOUBLE_EQ(sensors[0].value, 52.);
+    EXPECT_DOUBLE_EQ(sensors[0].critical, 100.);
+    EXPECT_TRUE(sensors[0].cpu);
+    EXPECT_EQ(sensors[1].kind, sensor_t::kFan);
+    EXPECT_DOUBLE_EQ(sensors[1].value, 2400.);
+    // signed, labelled by the attribute without a label file
+    EXPECT_EQ(sensors[2].label, QString("temp1"));
+    EXPECT_DOUBLE_EQ(sensors[2].value, -5.);
+    EXPECT_FALSE(sensors[2].cpu);
+    EXPECT_EQ(sensors[3].kind, sensor_t::kPower);
+    EXPECT_DOUBLE_EQ(sensors[3].value, 15.);
+
+    // inputs are kept open & re-read
+    writeFile("hwmon/hwmon0/temp1_input", "87000\n");
+    db.update();
+    EXPECT_DOUBLE_EQ(db.sensors()[0].value, 87.);
+}
+
+TEST_F(UT_SensorInfoDB, test_update_thermal)
+{
+    writeFile("hwmon/hwmon0/name", "acpitz\n");
+    writeFile("hwmon/hwmon0/temp1_input", "40000\n");
+    // exported by hwmon already
+    writeFile("thermal/thermal_zone0/type", "acpitz\n");
+    writeFile("thermal/thermal_zone0/temp", "40000\n");
+    writeFile("thermal/thermal_zone1/type", "cpu_thermal\n");
+    writeFile("thermal/thermal_zone1/temp", "61500\n");
+    writeFile("thermal/thermal_zone1/trip_point_0_type", "passive\n");
+    writeFile("thermal/thermal_zone1/trip_point_0_temp", "80000\n");
+    writeFile("thermal/thermal_zone1/trip_point_1_type", "critical\n");
+    writeFile("thermal/thermal_zone1/trip_point_1_temp", "95000\n");
+
+    SensorInfoDB db(m_dir.path() + "/hwmon", m_dir.path() + "/thermal");
+    db.update();
+    const QList<sensor_t> sensors = db.sensors();
+    ASSERT_EQ(sensors.size(), 2);
+    EXPECT_EQ(sensors[1].chip, QString("cpu_thermal"));
+    EXPECT_EQ(sensors[1].label, QString("thermal_zone1"));
+    EXPECT_DOUBLE_EQ(sensors[1].value, 61.5);
+    EXPECT_DOUBLE_EQ(sensors[1].critical, 95.);
+    EXPECT_TRUE(sensors[1].cpu);
+}
+
+TEST_F(UT_SensorInfoDB, test_rescan)
+{
+    writeFile("hwmon/hwmon0/name", "nvme\n");
+    writeFile("hwmon/hwmon0/temp1_input", "35000\n");
+    SensorInfoDB db(m_dir.path() + "/hwmon", m_dir.path() + "/thermal");
+    db.update();
+    ASSERT_EQ(db.sensors().size(), 1);
+
+    // unreadable inputs are left out
+    writeFile("hwmon/hwmon0/temp1_input", "\n");
+    db.update();
+    EXPECT_TRUE(db.sensors().isEmpty());
+
+    writeFile("hwmon/hwmon0/temp1_input", "36000\n");
+    writeFile("hwmon/hwmon1/name", "k10temp\n");
+    writeFile("hwmon/hwmon1/temp1_input", "45000\n");
+    db.rescan();
+    db.update();
+    EXPECT_EQ(db.sensors().size(), 2);
+}
@@ -0,0 +1,337 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/sock_diag.h"
+
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <linux/inet_diag.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#include <algorithm>
+
+//gtest
+#include <gtest/gtest.h>
+
+using namespace core::system;
+
+namespace {
+
+flow_key_t flowKey(uint sport)
+{
+    in_addr local {htonl(0x0a000002)}, remote {htonl(0x0a000001)};
+    return makeFlowKey(AF_INET, &local, sport, &remote, 443);
+}
+
+SocketTable::socket_t tcpSocket(uint64_t cookie, uint16_t lport, uint8_t state)
+{
+    SocketTable::socket_t sock {};
+    sock.cookie = cookie;
+    sock.family = AF_INET;
+    sock.proto = IPPROTO_TCP;
+    sock.lport = lport;
+    sock.state = state;
+    return sock;
+}
+
+} // namespace
+
+TEST(UT_SockTable, test_insert_find)
+{
+    SockTable table;
+    ino_t ino {};
+    EXPECT_FALSE(table.find(flowKey(1), ino));
+
+    table.insert(flowKey(1), 100);
+    table.insert(flowKey(2), 200);
+    EXPECT_EQ(table.size(), size_t(2));
+    ASSERT_TRUE(table.find(flowKey(2), ino));
+    EXPECT_EQ(ino, ino_t(200));
+
+    // same flow is updated in place
+    table.insert(flowKey(2), 300);
+    EXPECT_EQ(table.size(), size_t(2));
+    ASSERT_TRUE(table.find(flowKey(2), ino));
+    EXPECT_EQ(ino, ino_t(300));
+
+    table.clear();
+    EXPECT_EQ(table.size(), size_t(0));
+    EXPECT_FALSE(table.find(flowKey(1), ino));
+}
+
+TEST(UT_SockTable, test_grow)
+{
+    SockTable table;
+    auto capacity = table.capacity();
+    for (uint i = 0; i < capacity; ++i)
+        table.insert(flowKey(i), i + 1);
+    EXPECT_GT(table.capacity(), capacity);
+
+    ino_t ino {};
+    for (uint i = 0; i < capacity; ++i) {
+        ASSERT_TRUE(table.find(flowKey(i), ino));
+        EXPECT_EQ(ino, ino_t(i + 1));
+    }
+}
+
+TEST(UT_SockTable, test_evictStale)
+{
+    SockTable table;
+    for (uint i = 0; i < 100; ++i)
+        table.insert(flowKey(i), i + 1);
+
+    // only even flows are seen again
+    table.beginGeneration();
+    for (uint i = 0; i < 100; i += 2)
+        table.insert(flowKey(i), i + 1);
+    EXPECT_EQ(table.evictStale(), size_t(50));
+    EXPECT_EQ(table.size(), size_t(50));
+
+    ino_t ino {};
+    EXPECT_TRUE(table.find(flowKey(10), ino));
+    EXPECT_FALSE(table.find(flowKey(11), ino));
+
+    // evicted slot is reused
+    table.insert(flowKey(11), 12);
+    ASSERT_TRUE(table.find(flowKey(11), ino));
+    EXPECT_EQ(ino, ino_t(12));
+}
+
+TEST(UT_SocketTable, test_update)
+{
+    SocketTable table;
+    const int first = table.update(tcpSocket(1, 80, TCP_LISTEN));
+    const int second = table.update(tcpSocket(2, 40000, TCP_ESTABLISHED));
+    EXPECT_EQ(table.size(), size_t(2));
+    EXPECT_EQ(table.find(2), second);
+    EXPECT_EQ(table.lport(second), 40000);
+    EXPECT_EQ(table.changed(first), table.generation());
+
+    // unchanged socket keeps its stamp, a changed one is restamped in place
+    table.beginGeneration();
+    EXPECT_EQ(table.update(tcpSocket(1, 80, TCP_LISTEN)), first);
+    SocketTable::socket_t sock = tcpSocket(2, 40000, TCP_ESTABLISHED);
+    sock.rtt = 1500;
+    EXPECT_EQ(table.update(sock), second);
+    EXPECT_NE(table.changed(first), table.generation());
+    EXPECT_EQ(table.changed(second), table.generation());
+    EXPECT_EQ(table.rtt(second), 1500u);
+    EXPECT_EQ(table.evictStale(), size_t(0));
+}
+
+TEST(UT_SocketTable, test_evictStale)
+{
+    SocketTable table;
+    for (uint64_t cookie = 1; cookie <= 10; ++cookie)
+        table.update(tcpSocket(cookie, uint16_t(cookie), TCP_ESTABLISHED));
+    const int closed = table.find(3);
+
+    table.beginGeneration();
+    for (uint64_t cookie = 1; cookie <= 10; ++cookie) {
+        if (cookie != 3)
+            table.update(tcpSocket(cookie, uint16_t(cookie), TCP_ESTABLISHED));
+    }
+    EXPECT_EQ(table.evictStale(), size_t(1));
+    EXPECT_EQ(table.size(), size_t(9));
+    EXPECT_FALSE(table.isUsed(closed));
+    EXPECT_EQ(table.find(3), -1);
+
+    // the row of the closed socket is reused, others keep theirs
+    const int rows = table.rows();
+    table.beginGeneration();
+    EXPECT_EQ(table.update(tcpSocket(11, 11, TCP_SYN_SENT)), closed);
+    EXPECT_EQ(table.rows(), rows);
+    EXPECT_EQ(table.state(closed), TCP_SYN_SENT);
+
+    table.clear();
+    EXPECT_EQ(table.size(), size_t(0));
+    EXPECT_FALSE(table.isUsed(closed));
+}
+
+TEST(UT_SockDiag, test_addSocket)
+{
+    SockTable table;
+    struct inet_diag_msg diag;
+    memset(&diag, 0, sizeof(diag));
+    diag.idiag_family = AF_INET6;
+    diag.idiag_inode = 1234;
+    // ipv4 mapped addresses are matched as ipv4
+    diag.id.idiag_src[2] = diag.id.idiag_dst[2] = htonl(0xffff);
+    diag.id.idiag_src[3] = htonl(0x0a000002);
+    diag.id.idiag_dst[3] = htonl(0x0a000001);
+    diag.id.idiag_sport = htons(40000);
+    diag.id.idiag_dport = htons(443);
+
+    SockDiag::addSocket(&diag, IPPROTO_TCP, table);
+    EXPECT_EQ(table.size(), size_t(2));
+    ino_t ino {};
+    ASSERT_TRUE(table.find(flowKey(40000), ino));
+    EXPECT_EQ(ino, ino_t(1234));
+
+    // sockets without inode are skipped
+    table.clear();
+    diag.idiag_inode = 0;
+    SockDiag::addSocket(&diag, IPPROTO_UDP, table);
+    EXPECT_EQ(table.size(), size_t(0));
+}
+
+TEST(UT_SockDiag, test_refresh)
+{
+    SockTable table;
+    SockDiag diag;
+    auto generation = table.generation();
+    diag.refresh(table);
+    EXPECT_EQ(table.generation(), generation + 1);
+}
+
+TEST(UT_SockDiag, test_addTcpHealth)
+{
+    // kernel tcp_info is longer than the glibc one, segs out sits past its end
+    const size_t infoSize = 160;
+    alignas(NLMSG_ALIGNTO) char buf[NLMSG_SPACE(sizeof(inet_diag_msg) + RTA_SPACE(infoSize))];
+    memset(buf, 0, sizeof(buf));
+    auto *nlh = reinterpret_cast<struct nlmsghdr *>(buf);
+    nlh->nlmsg_len = NLMSG_LENGTH(sizeof(inet_diag_msg) + RTA_SPACE(infoSize));
+    auto *diag = reinterpret_cast<inet_diag_msg *>(NLMSG_DATA(nlh));
+    diag->idiag_inode = 4321;
+    auto *attr = reinterpret_cast<struct rtattr *>(diag + 1);
+    attr->rta_type = INET_DIAG_INFO;
+    attr->rta_len = RTA_LENGTH(infoSize);
+    auto *info = reinterpret_cast<struct tcp_info *>(RTA_DATA(attr));
+    info->tcpi_rtt = 12500;
+    info->tcpi_snd_cwnd = 10;
+    info->tcpi_unacked = 3;
+    info->tcpi_total_retrans = 7;
+    uint32_t segsOut = 700;
+    memcpy(reinterpret_cast<char *>(RTA_DATA(attr)) + 136, &segsOut, sizeof(segsOut));
+
+    TcpHealthTable health;
+    SockDiag::addTcpHealth(nlh, health);
+    ASSERT_TRUE(health.contains(4321));
+    EXPECT_EQ(health[4321].rtt, 12500u);
+    EXPECT_EQ(health[4321].cwnd, 10u);
+    EXPECT_EQ(health[4321].unacked, 3u);
+    EXPECT_EQ(health[4321].retrans, 7u);
+    EXPECT_EQ(health[4321].segsOut, 700u);
+
+    // a short tcp_info of an old kernel has no segs out
+    health.clear();
+    attr->rta_len = RTA_LENGTH(104);
+    nlh->nlmsg_len = NLMSG_LENGTH(sizeof(inet_diag_msg) + RTA_SPACE(104));
+    SockDiag::addTcpHealth(nlh, health);
+    ASSERT_TRUE(health.contains(4321));
+    EXPECT_EQ(health[4321].retrans, 7u);
+    EXPECT_EQ(health[4321].segsOut, 0u);
+
+    // no info attribute, nothing to add
+    health.clear();
+    nlh->nlmsg_len = NLMSG_LENGTH(sizeof(inet_diag_msg));
+    SockDiag::addTcpHealth(nlh, health);
+    EXPECT_TRUE(health.isEmpty());
+}
+
+TEST(UT_SockDiag, test_refreshTcpHealth)
+{
+    // a connected loopback socket of our own shows up with its inode
+    int server = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(server, 0);
+    sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrLen = sizeof(addr);
+    ASSERT_EQ(bind(server, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)), 0);
+    ASSERT_EQ(listen(server, 1), 0);
+    ASSERT_EQ(getsockname(server, reinterpret_cast<sockaddr *>(&addr), &addrLen), 0);
+    int client = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(client, 0);
+    ASSERT_EQ(connect(client, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)), 0);
+
+    struct stat st {};
+    fstat(client, &st);
+
+    TcpHealthTable health;
+    SockDiag diag;
+    if (diag.refreshTcpHealth(health))
+        EXPECT_TRUE(health.contains(st.st_ino));
+
+    close(client);
+    close(server);
+}
+
+TEST(UT_SockDiag, test_addSocketRow)
+{
+    alignas(NLMSG_ALIGNTO) char buf[NLMSG_SPACE(sizeof(inet_diag_msg) + RTA_SPACE(sizeof(tcp_info)))];
+    memset(buf, 0, sizeof(buf));
+    auto *nlh = reinterpret_cast<struct nlmsghdr *>(buf);
+    nlh->nlmsg_len = NLMSG_LENGTH(sizeof(inet_diag_msg) + RTA_SPACE(sizeof(tcp_info)));
+    auto *diag = reinterpret_cast<inet_diag_msg *>(NLMSG_DATA(nlh));
+    diag->idiag_family = AF_INET6;
+    diag->idiag_state = TCP_ESTABLISHED;
+    diag->idiag_inode = 1234;
+    diag->idiag_rqueue = 5;
+    diag->id.idiag_cookie[0] = 7;
+    diag->id.idiag_cookie[1] = 1;
+    diag->id.idiag_src[2] = diag->id.idiag_dst[2] = htonl(0xffff);
+    diag->id.idiag_src[3] = htonl(0x0a000002);
+    diag->id.idiag_dst[3] = htonl(0x0a000001);
+    diag->id.idiag_sport = htons(40000);
+    diag->id.idiag_dport = htons(443);
+    auto *attr = reinterpret_cast<struct rtattr *>(diag + 1);
+    attr->rta_type = INET_DIAG_INFO;
+    attr->rta_len = RTA_LENGTH(sizeof(tcp_info));
+    reinterpret_cast<struct tcp_info *>(RTA_DATA(attr))->tcpi_rtt = 2500;
+
+    std::vector<SocketTable::socket_t> sockets;
+    SockDiag::addSocketRow(nlh, IPPROTO_TCP, sockets);
+    ASSERT_EQ(sockets.size(), size_t(1));
+    const SocketTable::socket_t &sock = sockets[0];
+    EXPECT_EQ(sock.cookie, (uint64_t(1) << 32) | 7);
+    // ipv4 mapped addresses are listed as ipv4
+    EXPECT_EQ(sock.family, AF_INET);
+    uint32_t local;
+    memcpy(&local, &sock.laddr, sizeof(local));
+    EXPECT_EQ(local, htonl(0x0a000002));
+    EXPECT_EQ(sock.lport, 40000);
+    EXPECT_EQ(sock.rport, 443);
+    EXPECT_EQ(sock.state, TCP_ESTABLISHED);
+    EXPECT_EQ(sock.ino, ino_t(1234));
+    EXPECT_EQ(sock.rxQueue, 5u);
+    EXPECT_EQ(sock.rtt, 2500u);
+
+    // udp carries no tcp_info
+    SockDiag::addSocketRow(nlh, IPPROTO_UDP, sockets);
+    ASSERT_EQ(sockets.size(), size_t(2));
+    EXPECT_EQ(sockets[1].rtt, 0u);
+}
+
+TEST(UT_SockDiag, test_dumpSockets)
+{
+    // a listening loopback socket of our own is listed, unlike in the flow table
+    int server = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(server, 0);
+    sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrLen = sizeof(addr);
+    ASSERT_EQ(bind(server, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)), 0);
+    ASSERT_EQ(listen(server, 1), 0);
+    ASSERT_EQ(getsockname(server, reinterpret_cast<sockaddr *>(&addr), &addrLen), 0);
+
+    std::vector<SocketTable::socket_t> sockets;
+    SockDiag diag;
+    if (diag.dumpSockets(sockets)) {
+        auto it = std::find_if(sockets.cbegin(), sockets.cend(), [&](const SocketTable::socket_t &sock) {
+            return sock.proto == IPPROTO_TCP && sock.lport == ntohs(addr.sin_port);
+        });
+        ASSERT_NE(it, sockets.cend());
+        EXPECT_EQ(it->state, TCP_LISTEN);
+    }
+
+    close(server);
+}
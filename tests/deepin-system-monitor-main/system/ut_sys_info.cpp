@@ -11,6 +11,11 @@
 #include "stub.h"
 #include <gtest/gtest.h>
 
+//qt
+#include <QFile>
+
+#include <string.h>
+
 using namespace core::system;
 
 class UT_SysInfo: public ::testing::Test
@@ -58,6 +63,35 @@ TEST_F(UT_SysInfo, test_readSockStat)
 //    EXPECT_TRUE(m_tester->readSockStat(m_sockStats) != true);
 }
 
+TEST_F(UT_SysInfo, test_readSockStat_02)
+{
+    SockStatMap sockStats {};
+    m_tester->readSockStat(sockStats);
+    // every socket can be looked up with the key built from its own tuple
+    for (auto it = sockStats.cbegin(); it != sockStats.cend(); ++it) {
+        const SockStat &stat = it.value();
+        auto key = makeFlowKey(stat->sa_family, &stat->s_addr, stat->s_port, &stat->d_addr, stat->d_port);
+        EXPECT_TRUE(sockStats.contains(key));
+    }
+}
+
+TEST_F(UT_SysInfo, test_flowKey)
+{
+    in_addr a {htonl(0x7f000001)}, b {htonl(0xc0a80001)};
+    auto k1 = makeFlowKey(AF_INET, &a, 80, &b, 54321);
+    auto k2 = makeFlowKey(AF_INET, &a, 80, &b, 54321);
+    auto k3 = makeFlowKey(AF_INET, &b, 54321, &a, 80);
+    EXPECT_TRUE(k1 == k2);
+    EXPECT_EQ(qHash(k1), qHash(k2));
+    EXPECT_FALSE(k1 == k3);
+
+    in6_addr a6 {};
+    a6.s6_addr32[0] = a.s_addr;
+    // same words but different family
+    EXPECT_FALSE(makeAddrKey(AF_INET, &a) == makeAddrKey(AF_INET6, &a6));
+    EXPECT_TRUE(makeAddrKey(AF_INET, &a) == makeAddrKey(AF_INET, &a));
+}
+
 TEST_F(UT_SysInfo, test_readSysInfo)
 {
     EXPECT_TRUE(m_tester->d->version  != true);
@@ -74,9 +108,17 @@ TEST_F(UT_SysInfo, test_read_file_nr_02)
     EXPECT_NE(m_tester->read_file_nr(), 0);
 }
 
-TEST_F(UT_SysInfo, test_read_threads)
+TEST_F(UT_SysInfo, test_readSysInfo_threads)
 {
-    EXPECT_TRUE(m_tester->read_threads()  != 0);
+    // before any process scan thread count falls back to /proc/loadavg
+    m_tester->readSysInfo();
+    EXPECT_TRUE(m_tester->nthreads() != 0);
+
+    m_tester->set_nprocesses(10);
+    m_tester->set_nthreads(20);
+    m_tester->readSysInfo();
+    EXPECT_EQ(m_tester->nprocesses(), 10);
+    EXPECT_EQ(m_tester->nthreads(), 20);
 }
 
 TEST_F(UT_SysInfo, test_read_hostname)
@@ -120,4 +162,34 @@ TEST_F(UT_SysInfo, test_hostname)
 TEST_F(UT_SysInfo, test_read_loadavg)
 {
     m_tester->read_loadavg(m_tester->d->loadAvg);
+    EXPECT_TRUE(m_tester->d->loadAvg->nr_tasks != 0);
+    EXPECT_TRUE(m_tester->d->loadAvg->nr_running <= m_tester->d->loadAvg->nr_tasks);
+}
+
+TEST_F(UT_SysInfo, test_parseSchedStat)
+{
+    const char schedstat[] = "version 15\n"
+                             "timestamp 4295589574\n"
+                             "cpu0 0 0 0 0 0 0 1458462335907 41795022842 2440593\n"
+                             "domain0 00000003 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n"
+                             "cpu1 0 0 0 0 0 0 1392936694404 38204977158 2347914\n"
+                             "domain0 00000003 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n";
+    qulonglong runDelay = 0;
+    int ncpus = 0;
+    ASSERT_TRUE(SysInfo::parseSchedStat(schedstat, strlen(schedstat), runDelay, ncpus));
+    EXPECT_EQ(ncpus, 2);
+    EXPECT_EQ(runDelay, 41795022842ull + 38204977158ull);
+
+    const char version[] = "version 15\ntimestamp 4295589574\n";
+    EXPECT_FALSE(SysInfo::parseSchedStat(version, strlen(version), runDelay, ncpus));
+}
+
+TEST_F(UT_SysInfo, test_runQueueWait)
+{
+    // no rate before a second read
+    EXPECT_LT(m_tester->runQueueWait(), 0);
+    m_tester->read_schedstat();
+    m_tester->read_schedstat();
+    if (QFile::exists("/proc/schedstat"))
+        EXPECT_GE(m_tester->runQueueWait(), 0);
 }
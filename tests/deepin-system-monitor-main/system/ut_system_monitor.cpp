@@ -73,3 +73,11 @@ TEST_F(UT_SystemMonitor, test_timerEvent)
     QTimerEvent event(1);
     m_tester->timerEvent(&event);
 }
+
+TEST_F(UT_SystemMonitor, test_setBackgroundMode)
+{
+    m_tester->setBackgroundMode(true);
+    EXPECT_TRUE(m_tester->m_backgroundMode);
+    m_tester->setBackgroundMode(false);
+    EXPECT_FALSE(m_tester->m_backgroundMode);
+}
@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/task_exit_monitor.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <netlink/msg.h>
+#include <netlink/attr.h>
+#include <netlink/genl/genl.h>
+#include <linux/taskstats.h>
+
+#include <string.h>
+
+using namespace core::system;
+
+TEST(UT_TaskExitMonitor, test_poll_001)
+{
+    TaskExitMonitor monitor;
+    QList<task_exit_t> exits;
+    // without CAP_NET_ADMIN the source stays inactive & nothing is recorded
+    if (!monitor.isActive()) {
+        EXPECT_FALSE(monitor.poll(exits));
+        EXPECT_TRUE(exits.isEmpty());
+        return;
+    }
+    EXPECT_TRUE(monitor.poll(exits));
+}
+
+TEST(UT_TaskExitMonitor, test_parseExit_001)
+{
+    struct taskstats ts {};
+    ts.version = TASKSTATS_VERSION;
+    ts.ac_tgid = 1234;
+    ts.ac_ppid = 1;
+    ts.ac_utime = 3000;
+    ts.ac_stime = 500;
+    ts.hiwater_rss = 4096;
+    strncpy(ts.ac_comm, "cc1plus", sizeof(ts.ac_comm) - 1);
+
+    struct nl_msg *msg = nlmsg_alloc();
+    ASSERT_TRUE(msg);
+    ASSERT_TRUE(genlmsg_put(msg, NL_AUTO_PORT, NL_AUTO_SEQ, 1, 0, 0, TASKSTATS_CMD_NEW, TASKSTATS_GENL_VERSION));
+    struct nlattr *aggr = nla_nest_start(msg, TASKSTATS_TYPE_AGGR_PID);
+    nla_put_u32(msg, TASKSTATS_TYPE_PID, 1235);
+    nla_put(msg, TASKSTATS_TYPE_STATS, sizeof(ts), &ts);
+    nla_nest_end(msg, aggr);
+
+    task_exit_t exit;
+    EXPECT_TRUE(TaskExitMonitor::parseExit(nlmsg_hdr(msg), exit));
+    EXPECT_EQ(exit.pid, 1235);
+    EXPECT_EQ(exit.tgid, 1234);
+    // a thread of 1234
+    EXPECT_FALSE(exit.isProcess());
+    EXPECT_EQ(exit.name, QString("cc1plus"));
+    EXPECT_EQ(exit.cpuTime, 3500ULL);
+    EXPECT_EQ(exit.maxRss, 4096ULL);
+    nlmsg_free(msg);
+}
+
+TEST(UT_TaskExitMonitor, test_parseExit_002)
+{
+    // thread group aggregates carry no times
+    struct taskstats ts {};
+    struct nl_msg *msg = nlmsg_alloc();
+    ASSERT_TRUE(msg);
+    ASSERT_TRUE(genlmsg_put(msg, NL_AUTO_PORT, NL_AUTO_SEQ, 1, 0, 0, TASKSTATS_CMD_NEW, TASKSTATS_GENL_VERSION));
+    struct nlattr *aggr = nla_nest_start(msg, TASKSTATS_TYPE_AGGR_TGID);
+    nla_put_u32(msg, TASKSTATS_TYPE_TGID, 1234);
+    nla_put(msg, TASKSTATS_TYPE_STATS, sizeof(ts), &ts);
+    nla_nest_end(msg, aggr);
+
+    task_exit_t exit;
+    EXPECT_FALSE(TaskExitMonitor::parseExit(nlmsg_hdr(msg), exit));
+    nlmsg_free(msg);
+}
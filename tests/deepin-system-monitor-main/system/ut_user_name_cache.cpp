@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/user_name_cache.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <pwd.h>
+#include <unistd.h>
+
+using namespace core::system;
+
+class UT_UserNameCache : public ::testing::Test
+{
+protected:
+    UserNameCache m_tester;
+};
+
+TEST_F(UT_UserNameCache, test_userName_001)
+{
+    uid_t uid = getuid();
+    struct passwd *pwd = getpwuid(uid);
+
+    // decimal uid until the lookup finished
+    EXPECT_EQ(m_tester.userName(uid), QByteArray::number(uid));
+    m_tester.waitForLookups();
+    EXPECT_EQ(m_tester.userName(uid), pwd ? QByteArray(pwd->pw_name) : QByteArray::number(uid));
+    EXPECT_FALSE(m_tester.m_names[UserNameCache::kUserId][uid].pending);
+}
+
+TEST_F(UT_UserNameCache, test_userName_002)
+{
+    // ids without an entry are cached too, for a shorter time
+    const uid_t missing = 4000000123u;
+    m_tester.userName(missing);
+    m_tester.waitForLookups();
+    EXPECT_EQ(m_tester.userName(missing), QByteArray::number(missing));
+    EXPECT_TRUE(m_tester.m_queued[UserNameCache::kUserId].isEmpty());
+    EXPECT_LE(m_tester.m_names[UserNameCache::kUserId][missing].expiresAt,
+              m_tester.m_clock.elapsed() + UserNameCache::kMissingTTL);
+}
+
+TEST_F(UT_UserNameCache, test_usesFiles_001)
+{
+    QByteArray nsswitch = "# comment\n"
+                          "passwd:   files systemd   # local first\n"
+                          "group:    sss [NOTFOUND=return] ldap\n"
+                          "shadow:   compat\n";
+    EXPECT_TRUE(UserNameCache::usesFiles(nsswitch, "passwd"));
+    EXPECT_FALSE(UserNameCache::usesFiles(nsswitch, "group"));
+    EXPECT_TRUE(UserNameCache::usesFiles(nsswitch, "shadow"));
+    // databases not listed fall back to files
+    EXPECT_TRUE(UserNameCache::usesFiles(nsswitch, "hosts"));
+    EXPECT_TRUE(UserNameCache::usesFiles({}, "passwd"));
+}
@@ -113,3 +113,29 @@ TEST_F(UT_wireless, test_read_wireless_info_04)
     m_tester->m_ifname = "enp3s0";
     m_tester->read_wireless_info();
 }
+
+TEST_F(UT_wireless, test_is_wireless_iface)
+{
+    EXPECT_FALSE(wireless::is_wireless_iface(""));
+    EXPECT_FALSE(wireless::is_wireless_iface("lo"));
+}
+
+TEST_F(UT_wireless, test_query)
+{
+    wireless_stat stat;
+    stat.bitrate = 1;
+    // invalid ifindex, stat is reset
+    EXPECT_FALSE(m_tester->query(0, stat));
+    EXPECT_EQ(stat.bitrate, 0u);
+    // loopback has no station
+    EXPECT_FALSE(m_tester->query(1, stat));
+}
+
+TEST_F(UT_wireless, test_open_nl80211)
+{
+    // probed once
+    bool available = m_tester->has_nl80211();
+    EXPECT_TRUE(m_tester->m_nl80211_probed);
+    EXPECT_EQ(m_tester->has_nl80211(), available);
+    EXPECT_EQ(m_tester->m_nlsock != nullptr, available);
+}
@@ -6,6 +6,8 @@
 //self
 #include "cpu_monitor.h"
 #include "model/cpu_info_model.h"
+#include "model/model_manager.h"
+#include "model/sample_history.h"
 
 //gtest
 #include "stub.h"
@@ -98,11 +100,9 @@ TEST_F(UT_CpuMonitor, test_updateStatus_01)
 
 TEST_F(UT_CpuMonitor, test_updateStatus_02)
 {
-    m_tester->cpuPercents->append(0.1);
-    m_tester->cpuPercents->append(0.2);
-    m_tester->cpuPercents->append(0.3);
-    m_tester->cpuPercents->append(0.4);
-    m_tester->cpuPercents->append(0.5);
+    common::core::SeriesRing &ring = ModelManager::instance()->sampleHistory()->ring(SampleHistory::kCpuTotal, {});
+    for (int i = 1; i <= 5; i++)
+        ring.push(i / 10.);
     m_tester->updateStatus();
 }
 
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "headless_exporter.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//qt
+#include <QDir>
+
+//system
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+class UT_HeadlessExporter : public ::testing::Test
+{
+public:
+    UT_HeadlessExporter() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new HeadlessExporter(HeadlessExporter::Options());
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    HeadlessExporter *m_tester;
+};
+
+TEST_F(UT_HeadlessExporter, test_cpuPercent_001)
+{
+    EXPECT_DOUBLE_EQ(HeadlessExporter::cpuPercent(0, 0, 200, 50), 75.);
+    EXPECT_DOUBLE_EQ(HeadlessExporter::cpuPercent(200, 50, 300, 150), 0.);
+    // counters not moved or reset
+    EXPECT_DOUBLE_EQ(HeadlessExporter::cpuPercent(300, 150, 300, 150), 0.);
+    EXPECT_DOUBLE_EQ(HeadlessExporter::cpuPercent(300, 150, 100, 50), 0.);
+}
+
+TEST_F(UT_HeadlessExporter, test_isDue_001)
+{
+    // first line right away
+    EXPECT_TRUE(m_tester->isDue(0));
+
+    m_tester->m_lastLine = 10000;
+    EXPECT_FALSE(m_tester->isDue(11000));
+    // a tick slightly early still counts
+    EXPECT_TRUE(m_tester->isDue(11600));
+    EXPECT_TRUE(m_tester->isDue(12000));
+}
+
+TEST_F(UT_HeadlessExporter, test_writeLine_socket_001)
+{
+    HeadlessExporter::Options options;
+    options.socketPath = QDir::temp().filePath(QString("ut-headless-%1.sock").arg(getpid()));
+    HeadlessExporter exporter(options);
+    ASSERT_TRUE(exporter.listen());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    struct sockaddr_un addr {};
+    addr.sun_family = AF_UNIX;
+    QByteArray path = options.socketPath.toLocal8Bit();
+    memcpy(addr.sun_path, path.constData(), size_t(path.size()));
+    ASSERT_EQ(::connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)), 0);
+
+    exporter.acceptClients();
+    EXPECT_EQ(exporter.m_clients.size(), 1);
+    EXPECT_TRUE(exporter.writeLine("{}\n"));
+
+    char buf[8] {};
+    EXPECT_EQ(read(fd, buf, sizeof(buf)), 3);
+    EXPECT_STREQ(buf, "{}\n");
+
+    // a client gone is dropped on the next line
+    close(fd);
+    exporter.writeLine("{}\n");
+    EXPECT_TRUE(exporter.m_clients.isEmpty());
+}
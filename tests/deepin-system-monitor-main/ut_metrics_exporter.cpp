@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "metrics_exporter.h"
+#include "system/sys_info.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//qt
+#include <QtMath>
+
+using namespace core::system;
+
+class UT_MetricsExporter : public ::testing::Test
+{
+public:
+    UT_MetricsExporter() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new MetricsExporter(MetricsExporter::Options());
+        // services of the host running the test are not sampled
+        m_tester->m_cgroupStats.reset();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    MetricsExporter *m_tester;
+};
+
+TEST_F(UT_MetricsExporter, test_appendNumber_001)
+{
+    QByteArray out;
+    MetricsExporter::appendNumber(out, quint64(0));
+    out.append(' ');
+    MetricsExporter::appendNumber(out, quint64(18446744073709551615ull));
+    out.append(' ');
+    MetricsExporter::appendNumber(out, qreal(12.5));
+    out.append(' ');
+    MetricsExporter::appendNumber(out, qQNaN());
+    out.append(' ');
+    MetricsExporter::appendNumber(out, -qInf());
+    EXPECT_EQ(out, QByteArray("0 18446744073709551615 12.5 NaN -Inf"));
+}
+
+TEST_F(UT_MetricsExporter, test_appendEscaped_001)
+{
+    QByteArray out;
+    MetricsExporter::appendEscaped(out, QString("a\"b\\c\nd"));
+    EXPECT_EQ(out, QByteArray("a\\\"b\\\\c\\nd"));
+}
+
+TEST_F(UT_MetricsExporter, test_parseRequest_001)
+{
+    bool isMetrics = false;
+    EXPECT_FALSE(MetricsExporter::parseRequest("GET /metrics HTTP/1.1\r\nHost: x\r\n", isMetrics));
+
+    EXPECT_TRUE(MetricsExporter::parseRequest("GET /metrics HTTP/1.1\r\nHost: x\r\n\r\n", isMetrics));
+    EXPECT_TRUE(isMetrics);
+    EXPECT_TRUE(MetricsExporter::parseRequest("GET /metrics?name[]=x HTTP/1.0\n\n", isMetrics));
+    EXPECT_TRUE(isMetrics);
+
+    EXPECT_TRUE(MetricsExporter::parseRequest("GET /metricsx HTTP/1.1\r\n\r\n", isMetrics));
+    EXPECT_FALSE(isMetrics);
+    EXPECT_TRUE(MetricsExporter::parseRequest("POST /metrics HTTP/1.1\r\n\r\n", isMetrics));
+    EXPECT_FALSE(isMetrics);
+}
+
+TEST_F(UT_MetricsExporter, test_encode_001)
+{
+    load_avg_t loadAvg;
+    loadAvg.lavg_1m = 0.5f;
+    loadAvg.lavg_5m = 1.f;
+    loadAvg.lavg_15m = 2.f;
+    m_tester->encode(nullptr, &loadAvg, nullptr);
+
+    const QByteArray &page = m_tester->m_buffer;
+    EXPECT_TRUE(page.startsWith("# HELP dsm_load_average "));
+    EXPECT_TRUE(page.contains("# TYPE dsm_load_average gauge\n"));
+    EXPECT_TRUE(page.contains("dsm_load_average{period=\"1m\"} 0.5\n"));
+    EXPECT_TRUE(page.contains("dsm_load_average{period=\"15m\"} 2\n"));
+    EXPECT_TRUE(page.endsWith('\n'));
+
+    // the buffer is reused, not appended to
+    int size = page.size();
+    m_tester->encode(nullptr, &loadAvg, nullptr);
+    EXPECT_EQ(m_tester->m_buffer.size(), size);
+}
+
+TEST_F(UT_MetricsExporter, test_label_001)
+{
+    m_tester->m_generation = 1;
+    const QByteArray &text = m_tester->label(MetricsExporter::kInterfaceLabel, "eth\"0");
+    EXPECT_EQ(text, QByteArray("{interface=\"eth\\\"0\"}"));
+
+    // labels not used by an encode are dropped
+    m_tester->m_generation = 2;
+    m_tester->label(MetricsExporter::kDeviceLabel, "sda");
+    m_tester->pruneLabels();
+    EXPECT_TRUE(m_tester->m_labels[MetricsExporter::kInterfaceLabel].isEmpty());
+    EXPECT_EQ(m_tester->m_labels[MetricsExporter::kDeviceLabel].size(), 1);
+}
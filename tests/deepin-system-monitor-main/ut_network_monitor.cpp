@@ -6,6 +6,8 @@
 //self
 #include "network_monitor.h"
 #include "model/cpu_info_model.h"
+#include "model/model_manager.h"
+#include "model/sample_history.h"
 
 //gtest
 #include "stub.h"
@@ -51,22 +53,18 @@ TEST_F(UT_NetworkMonitor, initTest)
 
 TEST_F(UT_NetworkMonitor, test_getPainterPathByData)
 {
-    m_tester->uploadSpeeds->append(0.1);
-    m_tester->uploadSpeeds->append(0.2);
-    m_tester->uploadSpeeds->append(0.3);
-    m_tester->uploadSpeeds->append(0.4);
-    m_tester->uploadSpeeds->append(0.5);
+    common::core::SeriesRing &ring = ModelManager::instance()->sampleHistory()->ring(SampleHistory::kNetSent, {});
+    for (int i = 1; i <= 5; i++)
+        ring.push(i / 10.);
     double maxHeight =20;
     QPainterPath tmpUploadpath;
     m_tester->getPainterPathByData(m_tester->uploadSpeeds, tmpUploadpath, maxHeight);
 }
 TEST_F(UT_NetworkMonitor, test_updateStatus_01)
 {
-    m_tester->downloadSpeeds->append(0.1);
-    m_tester->downloadSpeeds->append(0.2);
-    m_tester->downloadSpeeds->append(0.3);
-    m_tester->downloadSpeeds->append(0.4);
-    m_tester->downloadSpeeds->append(0.5);
+    common::core::SeriesRing &ring = ModelManager::instance()->sampleHistory()->ring(SampleHistory::kNetRecv, {});
+    for (int i = 1; i <= 5; i++)
+        ring.push(i / 10.);
     m_tester->updateStatus();
 }
 
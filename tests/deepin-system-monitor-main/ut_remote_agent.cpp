@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "remote_agent.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//qt
+#include <QSet>
+
+//system
+#include <string.h>
+
+static process_info_record_t makeRecord(pid_t pid, quint64 utime)
+{
+    process_info_record_t rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.pid = pid;
+    rec.tgid = pid;
+    rec.utime = utime;
+    rec.start_time = 100;
+    return rec;
+}
+
+TEST(UT_RemoteAgent, test_encodeDelta_001)
+{
+    QHash<pid_t, process_info_record_t> previous {{1, makeRecord(1, 10)}, {2, makeRecord(2, 20)}, {4, makeRecord(4, 40)}};
+    QHash<pid_t, process_info_record_t> current {{1, makeRecord(1, 10)}, {2, makeRecord(2, 21)}, {3, makeRecord(3, 30)}};
+    QList<pid_t> created;
+    QByteArray delta = RemoteAgent::encodeDelta(previous, current, 7, false, created);
+
+    const process_info_record_t *records = nullptr;
+    const int32_t *exited = nullptr;
+    const process_info_delta_header_t *hdr = processInfoDelta(delta.constData(), size_t(delta.size()), records, exited);
+    ASSERT_NE(hdr, nullptr);
+    EXPECT_EQ(hdr->generation, 7ULL);
+    EXPECT_FALSE(hdr->flags & kProcessInfoDeltaBaseline);
+    // the unchanged record isn't sent again
+    ASSERT_EQ(hdr->count, 2U);
+    QSet<pid_t> changed {records[0].pid, records[1].pid};
+    EXPECT_EQ(changed, (QSet<pid_t> {2, 3}));
+    ASSERT_EQ(hdr->exited, 1U);
+    EXPECT_EQ(exited[0], 4);
+    EXPECT_EQ(created, QList<pid_t> {3});
+
+    // a reused pid is a new process
+    current[1].start_time = 200;
+    RemoteAgent::encodeDelta(previous, current, 8, false, created);
+    EXPECT_TRUE(created.contains(1));
+}
+
+TEST(UT_RemoteAgent, test_encodeDelta_002)
+{
+    QHash<pid_t, process_info_record_t> previous {{1, makeRecord(1, 10)}};
+    QHash<pid_t, process_info_record_t> current {{1, makeRecord(1, 10)}, {2, makeRecord(2, 20)}};
+    QList<pid_t> created;
+    QByteArray delta = RemoteAgent::encodeDelta(previous, current, 3, true, created);
+
+    const process_info_record_t *records = nullptr;
+    const int32_t *exited = nullptr;
+    const process_info_delta_header_t *hdr = processInfoDelta(delta.constData(), size_t(delta.size()), records, exited);
+    ASSERT_NE(hdr, nullptr);
+    // a baseline carries everything
+    EXPECT_TRUE(hdr->flags & kProcessInfoDeltaBaseline);
+    EXPECT_EQ(hdr->count, 2U);
+    EXPECT_EQ(hdr->exited, 0U);
+    EXPECT_EQ(created.size(), 2);
+}
+
+TEST(UT_RemoteAgent, test_encodeFrame_001)
+{
+    QByteArray small("abc");
+    QByteArray frame = RemoteAgent::encodeFrame(REMOTE_FRAME_SYSTEM, small);
+    ASSERT_EQ(frame.size(), int(sizeof(remote_frame_header_t)) + small.size());
+    remote_frame_header_t hdr;
+    memcpy(&hdr, frame.constData(), sizeof(hdr));
+    EXPECT_EQ(hdr.magic, uint32_t(REMOTE_AGENT_MAGIC));
+    EXPECT_EQ(hdr.type, uint16_t(REMOTE_FRAME_SYSTEM));
+    EXPECT_FALSE(hdr.flags & REMOTE_FRAME_COMPRESSED);
+    EXPECT_EQ(frame.mid(int(sizeof(hdr))), small);
+
+    // idle records compress well
+    QByteArray large(4096, '\0');
+    frame = RemoteAgent::encodeFrame(REMOTE_FRAME_PROCESSES, large);
+    memcpy(&hdr, frame.constData(), sizeof(hdr));
+    EXPECT_TRUE(hdr.flags & REMOTE_FRAME_COMPRESSED);
+    EXPECT_EQ(int(hdr.length), frame.size() - int(sizeof(hdr)));
+    EXPECT_LT(frame.size(), large.size());
+    EXPECT_EQ(qUncompress(frame.mid(int(sizeof(hdr)))), large);
+}
@@ -72,3 +72,11 @@ TEST_F(UT_WMAtom, test_atom_001)
 
     EXPECT_EQ(atom_t,m_tester->m_atoms[iatom]);
 }
+
+TEST_F(UT_WMAtom, test_type_001)
+{
+    m_tester->m_types.insert(300, WMAtom::_NET_WM_WINDOW_TYPE_DOCK);
+    EXPECT_EQ(m_tester->type(300), WMAtom::_NET_WM_WINDOW_TYPE_DOCK);
+    // not interned here
+    EXPECT_EQ(m_tester->type(301), WMAtom::ATOM_MAX);
+}
@@ -266,6 +266,38 @@ TEST_F(UT_WMInfo, test_selectWindow_005)
 }
 
 
+TEST_F(UT_WMInfo, test_selectWindow_006)
+{
+    auto makeWindow = [](WMWId wid, pid_t pid, const QRect &rect) {
+        WMWindowExt window(new struct wm_window_ext_t());
+        window->windowId = wid;
+        window->parent = 1000;
+        window->pid = pid;
+        window->rect = rect;
+        window->map_state = kViewableState;
+        window->wclass = kInputOutputClass;
+        return window;
+    };
+    // children are kept in top to bottom order
+    m_tester->m_tree->root->children = {2000, 3000, 4000};
+    m_tester->m_tree->cache[2000] = makeWindow(2000, 100001, QRect(100, 100, 200, 200));
+    m_tester->m_tree->cache[3000] = makeWindow(3000, 100002, QRect(0, 0, 600, 400));
+    m_tester->m_tree->cache[4000] = makeWindow(4000, 100003, QRect(0, 0, 600, 400));
+    m_tester->m_tree->cache[4000]->types << kDesktopWindowType;
+
+    auto list = m_tester->selectWindow(QPoint(150, 150));
+    ASSERT_EQ(list.size(), 2u);
+    EXPECT_EQ(list.front()->wid, 2000u);
+    EXPECT_EQ(list.back()->wid, 3000u);
+    EXPECT_TRUE(m_tester->selectWindow(QPoint(700, 150)).empty());
+
+    QRect area(0, 0, 600, 400);
+    auto hoveredBy = m_tester->getHoveredByWindowList(3000, area);
+    ASSERT_EQ(hoveredBy.size(), 1u);
+    EXPECT_EQ(hoveredBy.front()->wid, 2000u);
+    EXPECT_TRUE(m_tester->getHoveredByWindowList(2000, area).empty());
+}
+
 TEST_F(UT_WMInfo, test_getRootWindow_001)
 {
     m_tester->getRootWindow();
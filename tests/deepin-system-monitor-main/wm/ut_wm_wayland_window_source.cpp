@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "wm/wm_wayland_window_source.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+using namespace core::wm;
+
+class UT_WMWaylandWindowSource : public ::testing::Test
+{
+public:
+    UT_WMWaylandWindowSource() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new WMWaylandWindowSource();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    WMWaylandWindowSource *m_tester;
+};
+
+static WindowState makeState(int32_t windowId, int32_t pid, const char *name)
+{
+    WindowState state {};
+    state.windowId = windowId;
+    state.pid = pid;
+    strncpy(state.resourceName, name, sizeof(state.resourceName) - 1);
+    return state;
+}
+
+TEST_F(UT_WMWaylandWindowSource, test_refresh_001)
+{
+    // no compositor window states without libdtkwmjack
+    if (!m_tester->isValid())
+        EXPECT_FALSE(m_tester->refresh());
+}
+
+TEST_F(UT_WMWaylandWindowSource, test_applyWindowStates_001)
+{
+    WindowState states[] = {makeState(1, 10, "first"), makeState(2, 10, "second"), makeState(3, 0, "desktop")};
+    EXPECT_TRUE(m_tester->applyWindowStates(states, 3));
+    // windows without pid are left out
+    EXPECT_EQ(m_tester->m_windows.size(), 2);
+
+    // unchanged states are no change
+    EXPECT_FALSE(m_tester->applyWindowStates(states, 3));
+
+    m_tester->rebuildAppCaches();
+    ASSERT_EQ(m_tester->guiApps().count(10), 1u);
+    EXPECT_EQ(m_tester->guiApps().at(10)->title, QString("second"));
+
+    EXPECT_TRUE(m_tester->applyWindowStates(states, 1));
+    EXPECT_TRUE(m_tester->applyWindowStates(nullptr, 0));
+    EXPECT_TRUE(m_tester->m_windows.isEmpty());
+}
+
+TEST_F(UT_WMWaylandWindowSource, test_applyTrayItems_001)
+{
+    // pids are only asked for new items
+    m_tester->m_trayItems = {"org.kde.StatusNotifierItem-100-1"};
+    m_tester->m_trayPids = {{"org.kde.StatusNotifierItem-100-1", 100}};
+    EXPECT_FALSE(m_tester->applyTrayItems({"org.kde.StatusNotifierItem-100-1"}));
+    EXPECT_TRUE(m_tester->applyTrayItems({}));
+    EXPECT_TRUE(m_tester->m_trayPids.empty());
+
+    m_tester->m_trayItems = {"org.kde.StatusNotifierItem-100-1"};
+    m_tester->m_trayPids = {{"org.kde.StatusNotifierItem-100-1", 100}};
+    m_tester->rebuildAppCaches();
+    EXPECT_EQ(m_tester->trayApps().count(100), 1u);
+}
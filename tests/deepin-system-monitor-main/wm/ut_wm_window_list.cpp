@@ -68,7 +68,7 @@ TEST_F(UT_WMWindowList, test_getWindowIcon_001)
     m_tester->getWindowIcon(100000);
 }
 
-TEST_F(UT_WMWindowList, test_getWindowPid_001)
+TEST_F(UT_WMWindowList, test_updateWindowListCache_001)
 {
-    m_tester->getWindowPid(1000);
+    m_tester->updateWindowListCache();
 }
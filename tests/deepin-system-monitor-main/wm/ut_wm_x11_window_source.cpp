@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "wm/wm_x11_window_source.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+using namespace core::wm;
+
+class UT_WMX11WindowSource : public ::testing::Test
+{
+public:
+    UT_WMX11WindowSource() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new WMX11WindowSource();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    WMX11WindowSource *m_tester;
+};
+
+TEST_F(UT_WMX11WindowSource, test_getWindowPid_001)
+{
+    m_tester->getWindowPid(1000);
+}
+
+TEST_F(UT_WMX11WindowSource, test_takeAppWindowType_001)
+{
+    // type is only waited for when it was requested
+    WMX11WindowSource::WindowRequest request {};
+    EXPECT_FALSE(m_tester->takeAppWindowType(request));
+}
+
+TEST_F(UT_WMX11WindowSource, test_refresh_001)
+{
+    m_tester->refresh();
+}
+
+TEST_F(UT_WMX11WindowSource, test_rebuildAppCaches_001)
+{
+    wm_window_t first {1, 10, "first"};
+    wm_window_t second {2, 10, "second"};
+    wm_window_t tray {3, -1, {}};
+    m_tester->m_clientList = {1, 2};
+    m_tester->m_clientWindows = {{1, first}, {2, second}};
+    m_tester->m_trayList = {3};
+    m_tester->m_trayWindows = {{3, tray}};
+    m_tester->rebuildAppCaches();
+
+    // topmost window of a pid is kept, tray windows without pid are left out
+    ASSERT_EQ(m_tester->guiApps().count(10), 1u);
+    EXPECT_EQ(m_tester->guiApps().at(10)->title, QString("second"));
+    EXPECT_TRUE(m_tester->trayApps().empty());
+}
+
+TEST_F(UT_WMX11WindowSource, test_preferIconSize_001)
+{
+    // first icon is always taken
+    EXPECT_TRUE(WMX11WindowSource::preferIconSize(16, 16, 0, 0, 64));
+    // smaller ones give way to bigger ones up to the preferred size
+    EXPECT_TRUE(WMX11WindowSource::preferIconSize(32, 32, 16, 16, 64));
+    EXPECT_TRUE(WMX11WindowSource::preferIconSize(256, 256, 32, 32, 64));
+    // the nearest not smaller than the preferred size wins
+    EXPECT_TRUE(WMX11WindowSource::preferIconSize(64, 64, 256, 256, 64));
+    EXPECT_FALSE(WMX11WindowSource::preferIconSize(256, 256, 64, 64, 64));
+    EXPECT_FALSE(WMX11WindowSource::preferIconSize(48, 48, 128, 128, 64));
+}
+
+TEST_F(UT_WMX11WindowSource, test_windowIcon_001)
+{
+    wm_window_t window {1, 10, "first"};
+    m_tester->m_guiApps[10] = WMWindow(new wm_window_t(window));
+    QImage icon(4, 4, QImage::Format_ARGB32);
+    m_tester->m_windowIcons[1] = {64, icon};
+
+    // cached per window, no request to the x server
+    EXPECT_EQ(m_tester->windowIcon(10, 64), icon);
+    EXPECT_TRUE(m_tester->windowIcon(11, 64).isNull());
+}